@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "jni.h"
+
+#include "class_linker.h"
+#include "dex/art_dex_file_loader.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "nativehelper/scoped_utf_chars.h"
+#include "oat_file_assistant.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace {
+
+// Method lookup through JNI, including the hidden API access check for the caller.
+extern "C" JNIEXPORT void JNICALL Java_ClassLoadingBenchmark_timeGetMethodIdBootClass(
+    JNIEnv* env, jobject, jint reps) {
+  jclass string_class = env->FindClass("java/lang/String");
+  CHECK(string_class != nullptr);
+  for (jint i = 0; i < reps; ++i) {
+    jmethodID method = env->GetMethodID(string_class, "length", "()I");
+    CHECK(method != nullptr);
+  }
+  env->DeleteLocalRef(string_class);
+}
+
+// Class table lookup of an already loaded class in its defining class loader.
+extern "C" JNIEXPORT void JNICALL Java_ClassLoadingBenchmark_timeLookupLoadedClass(
+    JNIEnv* env, jobject, jint reps, jclass jklass) {
+  ScopedObjectAccess soa(env);
+  ObjPtr<mirror::Class> klass = soa.Decode<mirror::Class>(jklass);
+  CHECK(klass != nullptr);
+  std::string temp;
+  std::string descriptor = klass->GetDescriptor(&temp);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  for (jint i = 0; i < reps; ++i) {
+    ObjPtr<mirror::Class> found =
+        class_linker->LookupClass(soa.Self(), descriptor.c_str(), klass->GetClassLoader());
+    CHECK_EQ(found, klass);
+  }
+}
+
+// Opening the dex files of an apk or jar, without verification.
+extern "C" JNIEXPORT void JNICALL Java_ClassLoadingBenchmark_timeOpenDexFiles(
+    JNIEnv* env, jobject, jint reps, jstring jpath) {
+  ScopedUtfChars path(env, jpath);
+  CHECK(path.c_str() != nullptr);
+  const ArtDexFileLoader dex_file_loader;
+  for (jint i = 0; i < reps; ++i) {
+    std::string error_msg;
+    std::vector<std::unique_ptr<const DexFile>> dex_files;
+    bool success = dex_file_loader.Open(path.c_str(),
+                                        path.c_str(),
+                                        /* verify= */ false,
+                                        /* verify_checksum= */ true,
+                                        &error_msg,
+                                        &dex_files);
+    CHECK(success) << error_msg;
+  }
+}
+
+// Finding and validating the oat and vdex files of an apk or jar, as done for each
+// element of the class path at startup.
+extern "C" JNIEXPORT void JNICALL Java_ClassLoadingBenchmark_timeCheckOatFileUpToDate(
+    JNIEnv* env, jobject, jint reps, jstring jpath) {
+  ScopedUtfChars path(env, jpath);
+  CHECK(path.c_str() != nullptr);
+  for (jint i = 0; i < reps; ++i) {
+    OatFileAssistant oat_file_assistant(path.c_str(), kRuntimeISA, /* load_executable= */ false);
+    oat_file_assistant.IsUpToDate();
+  }
+}
+
+}  // namespace
+}  // namespace art
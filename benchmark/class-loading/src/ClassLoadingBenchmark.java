@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.system.DexClassLoader;
+import dalvik.system.PathClassLoader;
+
+import java.io.File;
+import java.lang.reflect.Method;
+
+public class ClassLoadingBenchmark {
+    private static final String TARGET_CLASS = "ClassLoadingBenchmark$Target";
+    private static final String RESOLUTION_TARGET_CLASS = "ClassLoadingBenchmark$ResolutionTarget";
+
+    public static class Target {
+        public static int target(int value) {
+            return value + 1;
+        }
+    }
+
+    // Loaded in a fresh class loader for each repetition, so that every string and method
+    // it references goes through the slow resolution path on the first call.
+    public static class ResolutionTarget {
+        public static int run() {
+            int sum = 0;
+            sum += "first".length();
+            sum += "second".length();
+            sum += "third".length();
+            sum += Integer.parseInt("4");
+            sum += Math.abs(-5);
+            sum += String.valueOf(6).length();
+            sum += new StringBuilder().append(7).toString().length();
+            sum += Target.target(8);
+            return sum;
+        }
+    }
+
+    public static Object sink;
+
+    // The apk or jar containing this benchmark.
+    private final String location;
+    // The class loader which defined this class.
+    private final ClassLoader applicationLoader;
+    // Empty class loaders chained below the application class loader, so that a lookup
+    // of `TARGET_CLASS` from `loaderAtDepth[n]` delegates through `n` parents.
+    private final ClassLoader[] loaderAtDepth = new ClassLoader[9];
+
+    public ClassLoadingBenchmark() {
+        // Make sure to link methods before benchmark starts.
+        System.loadLibrary("artbenchmark");
+        applicationLoader = ClassLoadingBenchmark.class.getClassLoader();
+        location = System.getProperty("java.class.path").split(File.pathSeparator)[0];
+        loaderAtDepth[0] = applicationLoader;
+        for (int i = 1; i < loaderAtDepth.length; ++i) {
+            loaderAtDepth[i] = new PathClassLoader("", loaderAtDepth[i - 1]);
+        }
+        timeGetMethodIdBootClass(1);
+        timeLookupLoadedClass(1, Target.class);
+        timeOpenDexFiles(1, location);
+        timeCheckOatFileUpToDate(1, location);
+    }
+
+    private void forName(int count, ClassLoader loader) throws Exception {
+        Class<?> last = null;
+        for (int i = 0; i < count; ++i) {
+            last = Class.forName(TARGET_CLASS, /* initialize= */ false, loader);
+        }
+        sink = last;
+    }
+
+    public void timeClassForNameBootClass(int count) throws Exception {
+        Class<?> last = null;
+        for (int i = 0; i < count; ++i) {
+            last = Class.forName("java.util.ArrayList", /* initialize= */ false, applicationLoader);
+        }
+        sink = last;
+    }
+
+    public void timeClassForNameDepth0(int count) throws Exception {
+        forName(count, loaderAtDepth[0]);
+    }
+
+    public void timeClassForNameDepth1(int count) throws Exception {
+        forName(count, loaderAtDepth[1]);
+    }
+
+    public void timeClassForNameDepth4(int count) throws Exception {
+        forName(count, loaderAtDepth[4]);
+    }
+
+    public void timeClassForNameDepth8(int count) throws Exception {
+        forName(count, loaderAtDepth[8]);
+    }
+
+    public void timeGetDeclaredMethod(int count) throws Exception {
+        Method last = null;
+        for (int i = 0; i < count; ++i) {
+            last = Target.class.getDeclaredMethod("target", int.class);
+        }
+        sink = last;
+    }
+
+    public void timeGetDeclaredMethodBootClass(int count) throws Exception {
+        Method last = null;
+        for (int i = 0; i < count; ++i) {
+            last = String.class.getDeclaredMethod("indexOf", String.class, int.class);
+        }
+        sink = last;
+    }
+
+    private ClassLoader newDexClassLoader() {
+        // Use the boot class loader as the parent so that classes of this benchmark
+        // are defined again by the new class loader.
+        return new DexClassLoader(location, null, null, Object.class.getClassLoader());
+    }
+
+    public void timeCreateDexClassLoader(int count) {
+        ClassLoader last = null;
+        for (int i = 0; i < count; ++i) {
+            last = newDexClassLoader();
+        }
+        sink = last;
+    }
+
+    // Includes the class loader creation measured by timeCreateDexClassLoader.
+    public void timeLoadClassInNewDexClassLoader(int count) throws Exception {
+        Class<?> last = null;
+        for (int i = 0; i < count; ++i) {
+            last = newDexClassLoader().loadClass(RESOLUTION_TARGET_CLASS);
+        }
+        sink = last;
+    }
+
+    // Includes the class loading measured by timeLoadClassInNewDexClassLoader.
+    public void timeFirstCallResolution(int count) throws Exception {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            Class<?> klass = newDexClassLoader().loadClass(RESOLUTION_TARGET_CLASS);
+            sum += (Integer) klass.getDeclaredMethod("run").invoke(null);
+        }
+        sink = sum;
+    }
+
+    public native void timeGetMethodIdBootClass(int reps);
+    public native void timeLookupLoadedClass(int reps, Class<?> klass);
+    public native void timeOpenDexFiles(int reps, String location);
+    public native void timeCheckOatFileUpToDate(int reps, String location);
+}
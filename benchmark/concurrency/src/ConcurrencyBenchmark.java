@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Field;
+import java.util.concurrent.CyclicBarrier;
+import java.util.concurrent.locks.LockSupport;
+import java.util.concurrent.locks.ReentrantLock;
+
+import sun.misc.Unsafe;
+
+public class ConcurrencyBenchmark {
+    // Iterations of `work()` done while holding a lock. The short hold makes the lock word
+    // itself the bottleneck, the long hold makes threads block and exercises inflation.
+    private static final int SHORT_HOLD = 0;
+    private static final int LONG_HOLD = 256;
+
+    private static final Unsafe UNSAFE = getUnsafe();
+    private static final long COUNTER_VALUE_OFFSET = getValueOffset();
+
+    static class Counter {
+        volatile int value;
+        // Written under a lock only, so that the work done while holding it is not dead.
+        int sum;
+    }
+
+    interface Worker {
+        void run(int iterations) throws Exception;
+    }
+
+    public static Object sink;
+
+    private final Object thinLock = new Object();
+    private final Object inflatedLock = new Object();
+
+    public ConcurrencyBenchmark() {
+        // Taking the identity hash code while holding the lock inflates it, and the monitor
+        // stays attached to the object afterwards.
+        synchronized (inflatedLock) {
+            sink = inflatedLock.hashCode();
+        }
+    }
+
+    private static Unsafe getUnsafe() {
+        try {
+            Field f;
+            try {
+                f = Unsafe.class.getDeclaredField("THE_ONE");
+            } catch (NoSuchFieldException e) {
+                f = Unsafe.class.getDeclaredField("theUnsafe");
+            }
+            f.setAccessible(true);
+            return (Unsafe) f.get(null);
+        } catch (Exception e) {
+            throw new Error(e);
+        }
+    }
+
+    private static long getValueOffset() {
+        try {
+            return UNSAFE.objectFieldOffset(Counter.class.getDeclaredField("value"));
+        } catch (NoSuchFieldException e) {
+            throw new Error(e);
+        }
+    }
+
+    // A fixed amount of computation, independent of the clock speed of the device.
+    private static int work(int iterations, int seed) {
+        int x = seed;
+        for (int i = 0; i < iterations; ++i) {
+            x = x * 31 + i;
+        }
+        return x;
+    }
+
+    // Splits `count` operations between `threads` threads, which start together.
+    private static void runThreads(int count, int threads, final Worker worker)
+            throws Exception {
+        final int perThread = (count + threads - 1) / threads;
+        final CyclicBarrier barrier = new CyclicBarrier(threads);
+        final Throwable[] failure = new Throwable[1];
+        Thread[] workers = new Thread[threads];
+        for (int t = 0; t < threads; ++t) {
+            workers[t] = new Thread() {
+                public void run() {
+                    try {
+                        barrier.await();
+                        worker.run(perThread);
+                    } catch (Throwable e) {
+                        synchronized (failure) {
+                            failure[0] = e;
+                        }
+                    }
+                }
+            };
+            workers[t].start();
+        }
+        for (Thread t : workers) {
+            t.join();
+        }
+        synchronized (failure) {
+            if (failure[0] != null) {
+                throw new Exception(failure[0]);
+            }
+        }
+    }
+
+    private static void expectCount(int expected, Counter counter) {
+        if (counter.value != expected) {
+            throw new AssertionError("Expected " + expected + ", got " + counter.value);
+        }
+    }
+
+    // Thin lock acquire and release by the owning thread.
+    public void timeSynchronizedUncontended(int count) {
+        Counter counter = new Counter();
+        for (int i = 0; i < count; ++i) {
+            synchronized (thinLock) {
+                counter.sum += i;
+            }
+        }
+        sink = counter;
+    }
+
+    // Recursive thin locking, which only updates the count in the lock word.
+    public void timeSynchronizedRecursive(int count) {
+        Counter counter = new Counter();
+        synchronized (thinLock) {
+            for (int i = 0; i < count; ++i) {
+                synchronized (thinLock) {
+                    counter.sum += i;
+                }
+            }
+        }
+        sink = counter;
+    }
+
+    // Uncontended locking of an object that already has a Monitor.
+    public void timeSynchronizedInflated(int count) {
+        Counter counter = new Counter();
+        for (int i = 0; i < count; ++i) {
+            synchronized (inflatedLock) {
+                counter.sum += i;
+            }
+        }
+        sink = counter;
+    }
+
+    // Inflation of a held thin lock, including allocating the Monitor from the MonitorPool.
+    public void timeInflateThinLock(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            Object lock = new Object();
+            synchronized (lock) {
+                sink = lock.hashCode();
+            }
+            last = lock;
+        }
+        sink = last;
+    }
+
+    private static void contendedSynchronized(int count, int threads, final int hold)
+            throws Exception {
+        final Object lock = new Object();
+        final Counter counter = new Counter();
+        runThreads(count, threads, new Worker() {
+            public void run(int iterations) {
+                for (int i = 0; i < iterations; ++i) {
+                    synchronized (lock) {
+                        counter.sum += work(hold, i);
+                        counter.value++;
+                    }
+                }
+            }
+        });
+        expectCount(((count + threads - 1) / threads) * threads, counter);
+        sink = counter;
+    }
+
+    public void timeSynchronized2ThreadsShortHold(int count) throws Exception {
+        contendedSynchronized(count, 2, SHORT_HOLD);
+    }
+
+    public void timeSynchronized4ThreadsShortHold(int count) throws Exception {
+        contendedSynchronized(count, 4, SHORT_HOLD);
+    }
+
+    public void timeSynchronized8ThreadsShortHold(int count) throws Exception {
+        contendedSynchronized(count, 8, SHORT_HOLD);
+    }
+
+    public void timeSynchronized2ThreadsLongHold(int count) throws Exception {
+        contendedSynchronized(count, 2, LONG_HOLD);
+    }
+
+    public void timeSynchronized4ThreadsLongHold(int count) throws Exception {
+        contendedSynchronized(count, 4, LONG_HOLD);
+    }
+
+    public void timeSynchronized8ThreadsLongHold(int count) throws Exception {
+        contendedSynchronized(count, 8, LONG_HOLD);
+    }
+
+    // java.util.concurrent locking, built on Unsafe CAS and Thread.park.
+    private static void contendedReentrantLock(int count, int threads, final int hold)
+            throws Exception {
+        final ReentrantLock lock = new ReentrantLock();
+        final Counter counter = new Counter();
+        runThreads(count, threads, new Worker() {
+            public void run(int iterations) {
+                for (int i = 0; i < iterations; ++i) {
+                    lock.lock();
+                    try {
+                        counter.sum += work(hold, i);
+                        counter.value++;
+                    } finally {
+                        lock.unlock();
+                    }
+                }
+            }
+        });
+        expectCount(((count + threads - 1) / threads) * threads, counter);
+        sink = counter;
+    }
+
+    public void timeReentrantLock2ThreadsShortHold(int count) throws Exception {
+        contendedReentrantLock(count, 2, SHORT_HOLD);
+    }
+
+    public void timeReentrantLock4ThreadsShortHold(int count) throws Exception {
+        contendedReentrantLock(count, 4, SHORT_HOLD);
+    }
+
+    public void timeReentrantLock8ThreadsShortHold(int count) throws Exception {
+        contendedReentrantLock(count, 8, SHORT_HOLD);
+    }
+
+    public void timeReentrantLock4ThreadsLongHold(int count) throws Exception {
+        contendedReentrantLock(count, 4, LONG_HOLD);
+    }
+
+    private static void casIncrement(Counter counter, int iterations) {
+        for (int i = 0; i < iterations; ++i) {
+            int value;
+            do {
+                value = counter.value;
+            } while (!UNSAFE.compareAndSwapInt(counter, COUNTER_VALUE_OFFSET, value, value + 1));
+        }
+    }
+
+    public void timeUnsafeCasUncontended(int count) {
+        Counter counter = new Counter();
+        casIncrement(counter, count);
+        expectCount(count, counter);
+        sink = counter;
+    }
+
+    private static void contendedUnsafeCas(int count, int threads) throws Exception {
+        final Counter counter = new Counter();
+        runThreads(count, threads, new Worker() {
+            public void run(int iterations) {
+                casIncrement(counter, iterations);
+            }
+        });
+        expectCount(((count + threads - 1) / threads) * threads, counter);
+        sink = counter;
+    }
+
+    public void timeUnsafeCas2Threads(int count) throws Exception {
+        contendedUnsafeCas(count, 2);
+    }
+
+    public void timeUnsafeCas4Threads(int count) throws Exception {
+        contendedUnsafeCas(count, 4);
+    }
+
+    public void timeUnsafeCas8Threads(int count) throws Exception {
+        contendedUnsafeCas(count, 8);
+    }
+
+    // Round trips between two threads handing a monitor back and forth with wait/notify.
+    public void timeWaitNotifyPingPong(final int count) throws Exception {
+        final Object lock = new Object();
+        final Counter turn = new Counter();
+        Thread partner = new Thread() {
+            public void run() {
+                try {
+                    for (int i = 0; i < count; ++i) {
+                        synchronized (lock) {
+                            while (turn.value != 1) {
+                                lock.wait();
+                            }
+                            turn.value = 0;
+                            lock.notify();
+                        }
+                    }
+                } catch (InterruptedException e) {
+                    throw new Error(e);
+                }
+            }
+        };
+        partner.start();
+        for (int i = 0; i < count; ++i) {
+            synchronized (lock) {
+                turn.value = 1;
+                lock.notify();
+                while (turn.value != 0) {
+                    lock.wait();
+                }
+            }
+        }
+        partner.join();
+    }
+
+    // Round trips between two threads waking each other with LockSupport.park/unpark.
+    public void timeParkUnparkPingPong(final int count) throws Exception {
+        final Counter turn = new Counter();
+        final Thread main = Thread.currentThread();
+        Thread partner = new Thread() {
+            public void run() {
+                for (int i = 0; i < count; ++i) {
+                    while (turn.value != 1) {
+                        LockSupport.park();
+                    }
+                    turn.value = 0;
+                    LockSupport.unpark(main);
+                }
+            }
+        };
+        partner.start();
+        for (int i = 0; i < count; ++i) {
+            turn.value = 1;
+            LockSupport.unpark(partner);
+            while (turn.value != 0) {
+                LockSupport.park();
+            }
+        }
+        partner.join();
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.system.VMRuntime;
+
+import java.lang.ref.ReferenceQueue;
+import java.lang.ref.SoftReference;
+import java.lang.ref.WeakReference;
+import java.util.concurrent.atomic.AtomicInteger;
+
+public class GcBenchmark {
+    // Above the default large object threshold (3 pages), so these go to the large object space.
+    private static final int LARGE_ARRAY_SIZE = 64 * 1024;
+    // Number of nodes kept alive by the live set benchmarks, about 8 MB.
+    private static final int LIVE_SET_NODES = 256 * 1024;
+    private static final int CHURN_PER_ITERATION = 1024;
+
+    static class Node {
+        Node next;
+        Object payload;
+        int value;
+    }
+
+    static class Finalizable {
+        static final AtomicInteger finalized = new AtomicInteger();
+        int value;
+
+        @Override
+        protected void finalize() {
+            finalized.incrementAndGet();
+        }
+    }
+
+    public static Object sink;
+
+    private static Node makeLiveSet(int nodes) {
+        Node head = null;
+        for (int i = 0; i < nodes; ++i) {
+            Node n = new Node();
+            n.next = head;
+            n.value = i;
+            head = n;
+        }
+        return head;
+    }
+
+    // Allocation throughput of the main allocator (TLABs in the region space with CC, RosAlloc
+    // runs with CMS).
+    public void timeAllocSmallObjects(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new Node();
+        }
+        sink = last;
+    }
+
+    public void timeAllocMediumArrays(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new int[256];
+        }
+        sink = last;
+    }
+
+    // Allocation throughput of the large object space.
+    public void timeAllocLargeArrays(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new byte[LARGE_ARRAY_SIZE];
+        }
+        sink = last;
+    }
+
+    // Allocation throughput of the non moving space.
+    public void timeAllocNonMovableArrays(int count) {
+        VMRuntime runtime = VMRuntime.getRuntime();
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = runtime.newNonMovableArray(int.class, 256);
+        }
+        sink = last;
+    }
+
+    // Short lived garbage next to a large live set, collected by young (sticky) GCs.
+    public void timeYoungGcChurnWithLiveSet(int count) {
+        Node live = makeLiveSet(LIVE_SET_NODES);
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            for (int j = 0; j < CHURN_PER_ITERATION; ++j) {
+                last = new Node();
+            }
+        }
+        sink = last;
+        if (live.value != LIVE_SET_NODES - 1) {
+            throw new AssertionError();
+        }
+    }
+
+    // Full GCs traversing a large live set.
+    public void timeFullGcWithLiveSet(int count) {
+        Node live = makeLiveSet(LIVE_SET_NODES);
+        for (int i = 0; i < count; ++i) {
+            Runtime.getRuntime().gc();
+        }
+        if (live.value != LIVE_SET_NODES - 1) {
+            throw new AssertionError();
+        }
+    }
+
+    // Large objects with a short lifetime, so that the large object space keeps allocating and
+    // freeing (or reusing) mappings.
+    public void timeLargeObjectChurn(int count) {
+        Object[] window = new Object[16];
+        for (int i = 0; i < count; ++i) {
+            window[i & 15] = new byte[LARGE_ARRAY_SIZE + (i & 7) * 4096];
+        }
+        sink = window;
+    }
+
+    // A heap with many weak and soft references whose referents mostly die.
+    public void timeReferenceHeavyHeap(int count) {
+        ReferenceQueue<Object> queue = new ReferenceQueue<>();
+        Object[] refs = new Object[CHURN_PER_ITERATION];
+        Node live = makeLiveSet(CHURN_PER_ITERATION);
+        for (int i = 0; i < count; ++i) {
+            Node n = live;
+            for (int j = 0; j < CHURN_PER_ITERATION; ++j) {
+                // Every fourth referent stays reachable through the live set.
+                Object referent = ((j & 3) == 0) ? n : new Node();
+                refs[j] = ((j & 1) == 0)
+                        ? new WeakReference<Object>(referent, queue)
+                        : new SoftReference<Object>(referent, queue);
+                n = n.next;
+            }
+            while (queue.poll() != null) {
+            }
+        }
+        sink = refs;
+    }
+
+    // Objects with finalizers, which the GC has to keep alive until the finalizer daemon ran.
+    public void timeFinalizerPressure(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            Finalizable f = new Finalizable();
+            f.value = i;
+            last = f;
+        }
+        sink = last;
+        System.runFinalization();
+    }
+}
@@ -34,6 +34,50 @@ extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfSOAUncheckedCall(JNI
   ScopedObjectAccessUnchecked soa(Thread::Current());
 }
 
+// Empty calls for each calling convention and a few common argument shapes. The work done
+// by the JNI stubs and transitions dominates, so the results track the transition cost.
+extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfJniEmptyCallFast(JNIEnv*, jobject) {}
+
+extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfJniEmptyStaticCall(JNIEnv*, jclass) {}
+
+extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfJniEmptyStaticCallFast(JNIEnv*,
+                                                                                  jclass) {}
+
+extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfJniEmptyStaticCallCritical() {}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfJniIntArgsCall(
+    JNIEnv*, jclass, jint a, jint b, jint c, jint d) {
+  return a + b + c + d;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfJniIntArgsCallFast(
+    JNIEnv*, jclass, jint a, jint b, jint c, jint d) {
+  return a + b + c + d;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfJniIntArgsCallCritical(
+    jint a, jint b, jint c, jint d) {
+  return a + b + c + d;
+}
+
+extern "C" JNIEXPORT jdouble JNICALL Java_JniPerfBenchmark_perfJniMixedArgsCallCritical(
+    jint a, jlong b, jfloat c, jdouble d) {
+  return a + b + c + d;
+}
+
+extern "C" JNIEXPORT jobject JNICALL Java_JniPerfBenchmark_perfJniObjectArgsCall(
+    JNIEnv*, jobject, jobject a, jobject b) {
+  return (a != nullptr) ? a : b;
+}
+
+extern "C" JNIEXPORT jobject JNICALL Java_JniPerfBenchmark_perfJniObjectArgsCallFast(
+    JNIEnv*, jobject, jobject a, jobject b) {
+  return (a != nullptr) ? a : b;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfJniSynchronizedCall(JNIEnv*,
+                                                                               jobject) {}
+
 }  // namespace
 
 }  // namespace art
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+import dalvik.annotation.optimization.CriticalNative;
+import dalvik.annotation.optimization.FastNative;
+
 public class JniPerfBenchmark {
   private static final String MSG = "ABCDE";
 
@@ -21,6 +24,20 @@ public class JniPerfBenchmark {
   native void perfSOACall();
   native void perfSOAUncheckedCall();
 
+  // One method per calling convention and argument shape.
+  @FastNative native void perfJniEmptyCallFast();
+  static native void perfJniEmptyStaticCall();
+  @FastNative static native void perfJniEmptyStaticCallFast();
+  @CriticalNative static native void perfJniEmptyStaticCallCritical();
+  static native int perfJniIntArgsCall(int a, int b, int c, int d);
+  @FastNative static native int perfJniIntArgsCallFast(int a, int b, int c, int d);
+  @CriticalNative static native int perfJniIntArgsCallCritical(int a, int b, int c, int d);
+  @CriticalNative
+  static native double perfJniMixedArgsCallCritical(int a, long b, float c, double d);
+  native Object perfJniObjectArgsCall(Object a, Object b);
+  @FastNative native Object perfJniObjectArgsCallFast(Object a, Object b);
+  synchronized native void perfJniSynchronizedCall();
+
   public void timeFastJNI(int N) {
     // TODO: This might be an intrinsic.
     for (long i = 0; i < N; i++) {
@@ -46,6 +63,72 @@ public class JniPerfBenchmark {
     }
   }
 
+  public void timeEmptyCallFast(int N) {
+    for (long i = 0; i < N; i++) {
+      perfJniEmptyCallFast();
+    }
+  }
+
+  public void timeEmptyStaticCall(int N) {
+    for (long i = 0; i < N; i++) {
+      perfJniEmptyStaticCall();
+    }
+  }
+
+  public void timeEmptyStaticCallFast(int N) {
+    for (long i = 0; i < N; i++) {
+      perfJniEmptyStaticCallFast();
+    }
+  }
+
+  public void timeEmptyStaticCallCritical(int N) {
+    for (long i = 0; i < N; i++) {
+      perfJniEmptyStaticCallCritical();
+    }
+  }
+
+  public void timeIntArgsCall(int N) {
+    for (int i = 0; i < N; i++) {
+      perfJniIntArgsCall(i, 1, 2, 3);
+    }
+  }
+
+  public void timeIntArgsCallFast(int N) {
+    for (int i = 0; i < N; i++) {
+      perfJniIntArgsCallFast(i, 1, 2, 3);
+    }
+  }
+
+  public void timeIntArgsCallCritical(int N) {
+    for (int i = 0; i < N; i++) {
+      perfJniIntArgsCallCritical(i, 1, 2, 3);
+    }
+  }
+
+  public void timeMixedArgsCallCritical(int N) {
+    for (int i = 0; i < N; i++) {
+      perfJniMixedArgsCallCritical(i, 1L, 2.0f, 3.0);
+    }
+  }
+
+  public void timeObjectArgsCall(int N) {
+    for (long i = 0; i < N; i++) {
+      perfJniObjectArgsCall(this, MSG);
+    }
+  }
+
+  public void timeObjectArgsCallFast(int N) {
+    for (long i = 0; i < N; i++) {
+      perfJniObjectArgsCallFast(this, MSG);
+    }
+  }
+
+  public void timeSynchronizedCall(int N) {
+    for (long i = 0; i < N; i++) {
+      perfJniSynchronizedCall();
+    }
+  }
+
   {
     System.loadLibrary("artbenchmark");
   }
@@ -59,4 +59,33 @@ public class StringBuilderAppendBenchmark {
             throw new AssertionError();
         }
     }
+
+    public void timeAppendTenArgs(int count) {
+        String s1 = string1;
+        String s2 = string2;
+        int i1 = int1;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            String result = s1 + i1 + s2 + i1 + s1 + i1 + s2 + i1 + s1 + i1;
+            sum += result.length();  // Make sure the append is not optimized away.
+        }
+        if (sum != count * (3 * s1.length() + 2 * s2.length() +
+                            5 * Integer.toString(i1).length())) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeAppendStringsAsCharSequence(int count) {
+        String s1 = string1;
+        String s2 = string2;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            String result =
+                new StringBuilder().append((CharSequence) s1).append((CharSequence) s2).toString();
+            sum += result.length();  // Make sure the append is not optimized away.
+        }
+        if (sum != count * (s1.length() + s2.length())) {
+            throw new AssertionError();
+        }
+    }
 }
@@ -463,6 +463,11 @@ struct XGcOption {
   // Do no measurements for kUseTableLookupReadBarrier to avoid test timeouts. b/31679493
   bool measure_ = kIsDebugBuild && !kUseTableLookupReadBarrier;
   bool gcstress_ = false;
+  // Drain the concurrent copying mark stacks with the heap thread pool.
+  bool parallel_marking_ = false;
+  // Start concurrent GCs based on the measured allocation rate and slow down allocating threads
+  // when the heap fills up faster than the GC can keep up with.
+  bool pacing_ = false;
 };
 
 template <>
@@ -520,6 +525,14 @@ struct CmdlineType<XGcOption> : CmdlineTypeParser<XGcOption> {
         xgc.gcstress_ = false;
       } else if (gc_option == "measure") {
         xgc.measure_ = true;
+      } else if (gc_option == "parallel_marking") {
+        xgc.parallel_marking_ = true;
+      } else if (gc_option == "noparallel_marking") {
+        xgc.parallel_marking_ = false;
+      } else if (gc_option == "pacing") {
+        xgc.pacing_ = true;
+      } else if (gc_option == "nopacing") {
+        xgc.pacing_ = false;
       } else if ((gc_option == "precise") ||
                  (gc_option == "noprecise") ||
                  (gc_option == "verifycardtable") ||
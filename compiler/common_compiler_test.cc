@@ -45,13 +45,19 @@
 namespace art {
 
 std::unique_ptr<CompilerOptions> CommonCompilerTest::CreateCompilerOptions(
-    InstructionSet instruction_set, const std::string& variant) {
+    InstructionSet instruction_set, const std::string& variant, const std::string& extra_features) {
   std::unique_ptr<CompilerOptions> compiler_options = std::make_unique<CompilerOptions>();
   compiler_options->instruction_set_ = instruction_set;
   std::string error_msg;
   compiler_options->instruction_set_features_ =
       InstructionSetFeatures::FromVariant(instruction_set, variant, &error_msg);
   CHECK(compiler_options->instruction_set_features_ != nullptr) << error_msg;
+  if (!extra_features.empty()) {
+    compiler_options->instruction_set_features_ =
+        compiler_options->instruction_set_features_->AddFeaturesFromString(extra_features,
+                                                                           &error_msg);
+    CHECK(compiler_options->instruction_set_features_ != nullptr) << error_msg;
+  }
   return compiler_options;
 }
 
@@ -44,8 +44,12 @@ template<class T> class Handle;
 
 class CommonCompilerTest : public CommonRuntimeTest {
  public:
-  static std::unique_ptr<CompilerOptions> CreateCompilerOptions(InstructionSet instruction_set,
-                                                                const std::string& variant);
+  // Create compiler options for the given ISA variant, with its features optionally extended
+  // by `extra_features` (e.g. "sve"), in the format of --instruction-set-features.
+  static std::unique_ptr<CompilerOptions> CreateCompilerOptions(
+      InstructionSet instruction_set,
+      const std::string& variant,
+      const std::string& extra_features = "");
 
   CommonCompilerTest();
   ~CommonCompilerTest();
@@ -49,14 +49,27 @@ class ElfDebugLineWriter {
   // Write line table for given set of methods.
   // Returns the number of bytes written.
   size_t WriteCompilationUnit(ElfCompilationUnit& compilation_unit) {
+    return WriteEncodedCompilationUnit(compilation_unit, EncodeCompilationUnit(compilation_unit));
+  }
+
+  // Write a line table returned by EncodeCompilationUnit() for the same compilation unit.
+  // Returns the number of bytes written.
+  size_t WriteEncodedCompilationUnit(ElfCompilationUnit& compilation_unit,
+                                     const std::vector<uint8_t>& buffer) {
+    compilation_unit.debug_line_offset = builder_->GetDebugLine()->GetPosition();
+    builder_->GetDebugLine()->WriteFully(buffer.data(), buffer.size());
+    return buffer.size();
+  }
+
+  // Encode the line table for given set of methods. The line table does not depend on its
+  // offset in the section, so this may be called concurrently for different compilation units.
+  std::vector<uint8_t> EncodeCompilationUnit(const ElfCompilationUnit& compilation_unit) const {
     const InstructionSet isa = builder_->GetIsa();
     const bool is64bit = Is64BitInstructionSet(isa);
     const Elf_Addr base_address = compilation_unit.is_code_address_text_relative
         ? builder_->GetText()->GetAddress()
         : 0;
 
-    compilation_unit.debug_line_offset = builder_->GetDebugLine()->GetPosition();
-
     std::vector<dwarf::FileEntry> files;
     std::unordered_map<std::string, size_t> files_map;
     std::vector<std::string> directories;
@@ -262,8 +275,7 @@ class ElfDebugLineWriter {
     std::vector<uint8_t> buffer;
     buffer.reserve(opcodes.data()->size() + KB);
     WriteDebugLineTable(directories, files, opcodes, &buffer);
-    builder_->GetDebugLine()->WriteFully(buffer.data(), buffer.size());
-    return buffer.size();
+    return buffer;
   }
 
   void End() {
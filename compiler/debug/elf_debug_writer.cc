@@ -16,6 +16,9 @@
 
 #include "elf_debug_writer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -43,9 +46,58 @@ namespace debug {
 
 using ElfRuntimeTypes = std::conditional<sizeof(void*) == 4, ElfTypes32, ElfTypes64>::type;
 
+// Number of compilation units whose line tables are encoded in parallel before they are
+// written out. This bounds the memory used by the encoded tables.
+static constexpr size_t kDebugLineBatchSize = 1024u;
+
+template <typename ElfTypes>
+static void WriteDebugLineSection(ElfBuilder<ElfTypes>* builder,
+                                  std::vector<ElfCompilationUnit>& compilation_units,
+                                  size_t thread_count) {
+  ElfDebugLineWriter<ElfTypes> line_writer(builder);
+  line_writer.Start();
+  if (thread_count <= 1u || compilation_units.size() <= 1u) {
+    for (auto& compilation_unit : compilation_units) {
+      line_writer.WriteCompilationUnit(compilation_unit);
+    }
+  } else {
+    std::vector<std::vector<uint8_t>> buffers;
+    for (size_t batch_begin = 0; batch_begin < compilation_units.size();
+         batch_begin += kDebugLineBatchSize) {
+      size_t batch_size = std::min(kDebugLineBatchSize, compilation_units.size() - batch_begin);
+      buffers.resize(batch_size);
+      std::atomic<size_t> next_index(0u);
+      auto encode = [&]() {
+        for (size_t i = next_index.fetch_add(1u, std::memory_order_relaxed);
+             i < batch_size;
+             i = next_index.fetch_add(1u, std::memory_order_relaxed)) {
+          buffers[i] = line_writer.EncodeCompilationUnit(compilation_units[batch_begin + i]);
+        }
+      };
+      std::vector<std::thread> threads;
+      size_t num_threads = std::min(thread_count, batch_size);
+      threads.reserve(num_threads - 1u);
+      for (size_t t = 1u; t < num_threads; ++t) {
+        threads.emplace_back(encode);
+      }
+      encode();
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+      // Write the tables in order, which assigns their offsets in the section.
+      for (size_t i = 0; i != batch_size; ++i) {
+        line_writer.WriteEncodedCompilationUnit(compilation_units[batch_begin + i], buffers[i]);
+        std::vector<uint8_t>().swap(buffers[i]);
+      }
+    }
+  }
+  line_writer.End();
+}
+
 template <typename ElfTypes>
 void WriteDebugInfo(ElfBuilder<ElfTypes>* builder,
-                    const DebugInfo& debug_info) {
+                    const DebugInfo& debug_info,
+                    size_t thread_count) {
   // Write .strtab and .symtab.
   WriteDebugSymbols(builder, /* mini-debug-info= */ false, debug_info);
 
@@ -90,12 +142,7 @@ void WriteDebugInfo(ElfBuilder<ElfTypes>* builder,
 
   // Write .debug_line section.
   if (!compilation_units.empty()) {
-    ElfDebugLineWriter<ElfTypes> line_writer(builder);
-    line_writer.Start();
-    for (auto& compilation_unit : compilation_units) {
-      line_writer.WriteCompilationUnit(compilation_unit);
-    }
-    line_writer.End();
+    WriteDebugLineSection(builder, compilation_units, thread_count);
   }
 
   // Write .debug_info section.
@@ -372,10 +419,12 @@ std::vector<uint8_t> WriteDebugElfFileForClasses(
 // Explicit instantiations
 template void WriteDebugInfo<ElfTypes32>(
     ElfBuilder<ElfTypes32>* builder,
-    const DebugInfo& debug_info);
+    const DebugInfo& debug_info,
+    size_t thread_count);
 template void WriteDebugInfo<ElfTypes64>(
     ElfBuilder<ElfTypes64>* builder,
-    const DebugInfo& debug_info);
+    const DebugInfo& debug_info,
+    size_t thread_count);
 
 }  // namespace debug
 }  // namespace art
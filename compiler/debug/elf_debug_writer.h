@@ -36,10 +36,12 @@ class Class;
 namespace debug {
 struct MethodDebugInfo;
 
+// The line tables of the compilation units are encoded on `thread_count` threads.
 template <typename ElfTypes>
 void WriteDebugInfo(
     ElfBuilder<ElfTypes>* builder,
-    const DebugInfo& debug_info);
+    const DebugInfo& debug_info,
+    size_t thread_count = 1u);
 
 std::vector<uint8_t> MakeMiniDebugInfo(
     InstructionSet isa,
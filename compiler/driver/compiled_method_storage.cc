@@ -76,12 +76,9 @@ inline void CompiledMethodStorage::ReleaseArrayIfNotDeduplicated(
 
 template <typename ContentType>
 class CompiledMethodStorage::DedupeHashFunc {
- private:
-  static constexpr bool kUseMurmur3Hash = true;
-
  public:
   size_t operator()(const ArrayRef<ContentType>& array) const {
-    return DataHash()(array);
+    return WideDataHash()(array);
   }
 };
 
@@ -144,15 +141,29 @@ class CompiledMethodStorage::ThunkMapValue {
   std::string debug_name_;
 };
 
-CompiledMethodStorage::CompiledMethodStorage(int swap_fd)
+// Use at least as many shards as before the shard count depended on the thread count.
+static constexpr size_t kMinDedupeShards = 4u;
+
+static size_t GetNumberOfDedupeShards(size_t thread_count) {
+  // Twice as many shards as threads keeps the probability of lock contention low.
+  return std::max(kMinDedupeShards, 2u * thread_count);
+}
+
+CompiledMethodStorage::CompiledMethodStorage(int swap_fd, size_t thread_count)
     : swap_space_(swap_fd == -1 ? nullptr : new SwapSpace(swap_fd, 10 * MB)),
       dedupe_enabled_(true),
-      dedupe_code_("dedupe code", LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
+      dedupe_code_("dedupe code",
+                   LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get()),
+                   GetNumberOfDedupeShards(thread_count)),
       dedupe_vmap_table_("dedupe vmap table",
-                         LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
-      dedupe_cfi_info_("dedupe cfi info", LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
-      dedupe_linker_patches_("dedupe cfi info",
-                             LengthPrefixedArrayAlloc<linker::LinkerPatch>(swap_space_.get())),
+                         LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get()),
+                         GetNumberOfDedupeShards(thread_count)),
+      dedupe_cfi_info_("dedupe cfi info",
+                       LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get()),
+                       GetNumberOfDedupeShards(thread_count)),
+      dedupe_linker_patches_("dedupe linker patches",
+                             LengthPrefixedArrayAlloc<linker::LinkerPatch>(swap_space_.get()),
+                             GetNumberOfDedupeShards(thread_count)),
       thunk_map_lock_("thunk_map_lock"),
       thunk_map_(std::less<ThunkMapKey>(), SwapAllocator<ThunkMapValueType>(swap_space_.get())) {
 }
@@ -171,6 +182,7 @@ void CompiledMethodStorage::DumpMemoryUsage(std::ostream& os, bool extended) con
     os << "\nCode dedupe: " << dedupe_code_.DumpStats(self);
     os << "\nVmap table dedupe: " << dedupe_vmap_table_.DumpStats(self);
     os << "\nCFI info dedupe: " << dedupe_cfi_info_.DumpStats(self);
+    os << "\nLinker patches dedupe: " << dedupe_linker_patches_.DumpStats(self);
   }
 }
 
@@ -218,6 +230,7 @@ CompiledMethodStorage::ThunkMapKey CompiledMethodStorage::GetThunkMapKey(
   switch (linker_patch.GetType()) {
     case linker::LinkerPatch::Type::kCallEntrypoint:
       custom_value1 = linker_patch.EntrypointOffset();
+      custom_value2 = linker_patch.EntrypointArguments();
       break;
     case linker::LinkerPatch::Type::kBakerReadBarrierBranch:
       custom_value1 = linker_patch.GetBakerCustomValue1();
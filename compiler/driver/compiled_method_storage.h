@@ -35,7 +35,8 @@ class LinkerPatch;
 
 class CompiledMethodStorage {
  public:
-  explicit CompiledMethodStorage(int swap_fd);
+  // The dedupe sets are sharded according to the number of threads adding to them.
+  explicit CompiledMethodStorage(int swap_fd, size_t thread_count = 1u);
   ~CompiledMethodStorage();
 
   void DumpMemoryUsage(std::ostream& os, bool extended) const;
@@ -106,8 +107,7 @@ class CompiledMethodStorage {
                                    LengthPrefixedArray<T>,
                                    LengthPrefixedArrayAlloc<T>,
                                    size_t,
-                                   DedupeHashFunc<const T>,
-                                   4>;
+                                   DedupeHashFunc<const T>>;
 
   // Swap pool and allocator used for native allocations. May be file-backed. Needs to be first
   // as other fields rely on this.
@@ -16,10 +16,13 @@
 
 #include "compiler_options.h"
 
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <string_view>
 
 #include "android-base/stringprintf.h"
+#include "android-base/strings.h"
 
 #include "arch/instruction_set.h"
 #include "arch/instruction_set_features.h"
@@ -32,6 +35,8 @@
 #include "dex/dex_file-inl.h"
 #include "dex/verification_results.h"
 #include "dex/verified_method.h"
+#include "oat.h"
+#include "profile/profile_compilation_info.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "simple_compiler_options_map.h"
@@ -44,6 +49,7 @@ CompilerOptions::CompilerOptions()
       large_method_threshold_(kDefaultLargeMethodThreshold),
       num_dex_methods_threshold_(kDefaultNumDexMethodsThreshold),
       inline_max_code_units_(kUnsetInlineMaxCodeUnits),
+      optimizing_time_budget_ms_(kDefaultOptimizingTimeBudgetMs),
       instruction_set_(kRuntimeISA == InstructionSet::kArm ? InstructionSet::kThumb2 : kRuntimeISA),
       instruction_set_features_(nullptr),
       no_inline_from_(),
@@ -58,12 +64,15 @@ CompilerOptions::CompilerOptions()
       generate_debug_info_(kDefaultGenerateDebugInfo),
       generate_mini_debug_info_(kDefaultGenerateMiniDebugInfo),
       generate_build_id_(false),
+      generate_frame_pointers_(false),
+      split_cold_code_(false),
       implicit_null_checks_(true),
       implicit_so_checks_(true),
       implicit_suspend_checks_(false),
       compile_pic_(false),
       dump_timings_(false),
       dump_pass_timings_(false),
+      dump_pass_stats_(false),
       dump_stats_(false),
       top_k_profile_threshold_(kDefaultTopKProfileThreshold),
       profile_compilation_info_(nullptr),
@@ -73,6 +82,7 @@ CompilerOptions::CompilerOptions()
       init_failure_output_(nullptr),
       dump_cfg_file_name_(""),
       dump_cfg_append_(false),
+      compiled_method_cache_directory_(""),
       force_determinism_(false),
       deduplicate_code_(true),
       count_hotness_in_compiled_code_(false),
@@ -121,8 +131,11 @@ bool CompilerOptions::ParseRegisterAllocationStrategy(const std::string& option,
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
   } else if (option == "graph-color") {
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorGraphColor;
+  } else if (option == "profile-guided") {
+    register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorProfileGuided;
   } else {
-    *error_msg = "Unrecognized register allocation strategy. Try linear-scan, or graph-color.";
+    *error_msg = "Unrecognized register allocation strategy. "
+                 "Try linear-scan, graph-color, or profile-guided.";
     return false;
   }
   return true;
@@ -149,6 +162,17 @@ bool CompilerOptions::IsImageClass(const char* descriptor) const {
   return image_classes_.find(std::string_view(descriptor)) != image_classes_.end();
 }
 
+bool CompilerOptions::IsBaselineMethod(const MethodReference& method_ref) const {
+  if (baseline_) {
+    return true;
+  }
+  if (compiler_filter_ != CompilerFilter::kSpeedProfileBaseline) {
+    return false;
+  }
+  return profile_compilation_info_ == nullptr ||
+         !profile_compilation_info_->GetMethodHotness(method_ref).IsHot();
+}
+
 const VerificationResults* CompilerOptions::GetVerificationResults() const {
   DCHECK(Runtime::Current()->IsAotCompiler());
   return verification_results_;
@@ -185,4 +209,45 @@ bool CompilerOptions::IsMethodVerifiedWithoutFailures(uint32_t method_idx,
   return is_system_class;
 }
 
+std::string CompilerOptions::GetCompiledMethodCacheFingerprint() const {
+  std::ostringstream oss;
+  oss << "oat-version=" << reinterpret_cast<const char*>(OatHeader::kOatVersion.data())
+      << "\nfilter=" << CompilerFilter::NameOfFilter(compiler_filter_)
+      << "\nisa=" << GetInstructionSetString(instruction_set_)
+      << "\nisa-features=" << instruction_set_features_->GetFeatureString()
+      << "\nimage-type=" << static_cast<uint32_t>(image_type_)
+      << "\nhuge-method-threshold=" << huge_method_threshold_
+      << "\nlarge-method-threshold=" << large_method_threshold_
+      << "\ninline-max-code-units=" << inline_max_code_units_
+      << "\noptimizing-time-budget=" << optimizing_time_budget_ms_
+      << "\nregister-allocation-strategy=" << static_cast<uint32_t>(register_allocation_strategy_)
+      << "\ncompile-art-test=" << compile_art_test_
+      << "\nbaseline=" << baseline_
+      << "\ndebuggable=" << debuggable_
+      << "\ngenerate-debug-info=" << generate_debug_info_
+      << "\ngenerate-mini-debug-info=" << generate_mini_debug_info_
+      << "\ngenerate-frame-pointers=" << generate_frame_pointers_
+      << "\nsplit-cold-code=" << split_cold_code_
+      << "\nimplicit-checks=" << implicit_null_checks_ << implicit_so_checks_
+      << implicit_suspend_checks_
+      << "\npic=" << compile_pic_
+      << "\ncount-hotness-in-compiled-code=" << count_hotness_in_compiled_code_
+      << "\nresolve-startup-const-strings=" << resolve_startup_const_strings_
+      << "\ninitialize-app-image-classes=" << initialize_app_image_classes_
+      << "\nrun-time-checks=" << EmitRunTimeChecksInDebugMode();
+  if (passes_to_run_ != nullptr) {
+    oss << "\npasses=" << android::base::Join(*passes_to_run_, ',');
+  }
+  for (const DexFile* dex_file : no_inline_from_) {
+    oss << "\nno-inline-from=" << dex_file->GetLocation();
+  }
+  // The image classes decide which classes may be assumed initialized in a boot image.
+  std::vector<std::string> image_classes(image_classes_.begin(), image_classes_.end());
+  std::sort(image_classes.begin(), image_classes.end());
+  for (const std::string& descriptor : image_classes) {
+    oss << "\nimage-class=" << descriptor;
+  }
+  return oss.str();
+}
+
 }  // namespace art
@@ -46,6 +46,7 @@ class Arm64RelativePatcherTest;
 class DexFile;
 enum class InstructionSet;
 class InstructionSetFeatures;
+class MethodReference;
 class ProfileCompilationInfo;
 class VerificationResults;
 class VerifiedMethod;
@@ -68,6 +69,8 @@ class CompilerOptions final {
   static const bool kDefaultGenerateMiniDebugInfo = false;
   static const size_t kDefaultInlineMaxCodeUnits = 32;
   static constexpr size_t kUnsetInlineMaxCodeUnits = -1;
+  // No time budget for the optimizing passes of a method.
+  static const size_t kDefaultOptimizingTimeBudgetMs = 0;
 
   enum class CompilerType : uint8_t {
     kAotCompiler,             // AOT compiler.
@@ -153,6 +156,12 @@ class CompilerOptions final {
     inline_max_code_units_ = units;
   }
 
+  // Returns the wall time in milliseconds that the optimizing compiler may spend on
+  // a method before it falls back to cheaper passes. Zero means no budget.
+  size_t GetOptimizingTimeBudgetMs() const {
+    return optimizing_time_budget_ms_;
+  }
+
   double GetTopKProfileThreshold() const {
     return top_k_profile_threshold_;
   }
@@ -183,6 +192,11 @@ class CompilerOptions final {
     return generate_mini_debug_info_;
   }
 
+  // Should blocks that throw be laid out with the slow paths at the end of the method?
+  bool GetSplitColdCode() const {
+    return split_cold_code_;
+  }
+
   // Should run-time checks be emitted in debug mode?
   bool EmitRunTimeChecksInDebugMode() const;
 
@@ -190,6 +204,11 @@ class CompilerOptions final {
     return generate_build_id_;
   }
 
+  // Should compiled code keep a frame pointer chain for fast unwinding by samplers?
+  bool GetGenerateFramePointers() const {
+    return generate_frame_pointers_;
+  }
+
   bool GetImplicitNullChecks() const {
     return implicit_null_checks_;
   }
@@ -211,6 +230,9 @@ class CompilerOptions final {
     return compiler_type_ == CompilerType::kSharedCodeJitCompiler;
   }
 
+  // Whether suspend checks load from the thread's suspend trigger, which faults when the
+  // thread is asked to suspend, instead of testing the thread flags and branching to a slow
+  // path. Only honored by the ARM64 and x86-64 code generators.
   bool GetImplicitSuspendChecks() const {
     return implicit_suspend_checks_;
   }
@@ -233,6 +255,11 @@ class CompilerOptions final {
     return baseline_;
   }
 
+  // Returns whether the given method should be compiled with the baseline tier. With the
+  // speed-profile-baseline filter, only the hot methods of the profile are fully optimized;
+  // the other methods selected for compilation get baseline code.
+  bool IsBaselineMethod(const MethodReference& method_ref) const;
+
   // Are we compiling an app image?
   bool IsAppImage() const {
     return image_type_ == ImageType::kAppImage;
@@ -350,6 +377,10 @@ class CompilerOptions final {
     return dump_pass_timings_;
   }
 
+  bool GetDumpPassStats() const {
+    return dump_pass_stats_;
+  }
+
   bool GetDumpStats() const {
     return dump_stats_;
   }
@@ -378,6 +409,14 @@ class CompilerOptions final {
     return initialize_app_image_classes_;
   }
 
+  const std::string& GetCompiledMethodCacheDirectory() const {
+    return compiled_method_cache_directory_;
+  }
+
+  // Returns a description of all options that can change the code generated for a method,
+  // for use as part of the key of the compiled method cache.
+  std::string GetCompiledMethodCacheFingerprint() const;
+
  private:
   bool ParseDumpInitFailures(const std::string& option, std::string* error_msg);
   bool ParseRegisterAllocationStrategy(const std::string& option, std::string* error_msg);
@@ -387,6 +426,7 @@ class CompilerOptions final {
   size_t large_method_threshold_;
   size_t num_dex_methods_threshold_;
   size_t inline_max_code_units_;
+  size_t optimizing_time_budget_ms_;
 
   InstructionSet instruction_set_;
   std::unique_ptr<const InstructionSetFeatures> instruction_set_features_;
@@ -414,12 +454,15 @@ class CompilerOptions final {
   bool generate_debug_info_;
   bool generate_mini_debug_info_;
   bool generate_build_id_;
+  bool generate_frame_pointers_;
+  bool split_cold_code_;
   bool implicit_null_checks_;
   bool implicit_so_checks_;
   bool implicit_suspend_checks_;
   bool compile_pic_;
   bool dump_timings_;
   bool dump_pass_timings_;
+  bool dump_pass_stats_;
   bool dump_stats_;
 
   // When using a profile file only the top K% of the profiled samples will be compiled.
@@ -443,6 +486,9 @@ class CompilerOptions final {
   std::string dump_cfg_file_name_;
   bool dump_cfg_append_;
 
+  // Directory of the content-addressed cache of compiled methods. Empty if disabled.
+  std::string compiled_method_cache_directory_;
+
   // Whether the compiler should trade performance for determinism to guarantee exactly reproducible
   // outcomes.
   bool force_determinism_;
@@ -48,9 +48,13 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   map.AssignIfExists(Base::LargeMethodMaxThreshold, &options->large_method_threshold_);
   map.AssignIfExists(Base::NumDexMethodsThreshold, &options->num_dex_methods_threshold_);
   map.AssignIfExists(Base::InlineMaxCodeUnitsThreshold, &options->inline_max_code_units_);
+  map.AssignIfExists(Base::OptimizingTimeBudget, &options->optimizing_time_budget_ms_);
   map.AssignIfExists(Base::GenerateDebugInfo, &options->generate_debug_info_);
   map.AssignIfExists(Base::GenerateMiniDebugInfo, &options->generate_mini_debug_info_);
   map.AssignIfExists(Base::GenerateBuildID, &options->generate_build_id_);
+  map.AssignIfExists(Base::GenerateFramePointers, &options->generate_frame_pointers_);
+  map.AssignIfExists(Base::SplitColdCode, &options->split_cold_code_);
+  map.AssignIfExists(Base::ImplicitSuspendChecks, &options->implicit_suspend_checks_);
   if (map.Exists(Base::Debuggable)) {
     options->debuggable_ = true;
   }
@@ -69,8 +73,10 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   if (map.Exists(Base::DumpCFGAppend)) {
     options->dump_cfg_append_ = true;
   }
+  map.AssignIfExists(Base::CompiledMethodCache, &options->compiled_method_cache_directory_);
   if (map.Exists(Base::RegisterAllocationStrategy)) {
-    if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::DumpInitFailures), error_msg)) {
+    if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::RegisterAllocationStrategy),
+                                                  error_msg)) {
       return false;
     }
   }
@@ -94,6 +100,10 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->dump_pass_timings_ = true;
   }
 
+  if (map.Exists(Base::DumpPassStats)) {
+    options->dump_pass_stats_ = true;
+  }
+
   if (map.Exists(Base::DumpStats)) {
     options->dump_stats_ = true;
   }
@@ -126,6 +136,9 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Define("--inline-max-code-units=_")
           .template WithType<unsigned int>()
           .IntoKey(Map::InlineMaxCodeUnitsThreshold)
+      .Define("--optimizing-time-budget=_")
+          .template WithType<unsigned int>()
+          .IntoKey(Map::OptimizingTimeBudget)
 
       .Define({"--generate-debug-info", "-g", "--no-generate-debug-info"})
           .WithValues({true, true, false})
@@ -138,6 +151,18 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .WithValues({true, false})
           .IntoKey(Map::GenerateBuildID)
 
+      .Define({"--generate-frame-pointers", "--no-generate-frame-pointers"})
+          .WithValues({true, false})
+          .IntoKey(Map::GenerateFramePointers)
+
+      .Define({"--split-cold-code", "--no-split-cold-code"})
+          .WithValues({true, false})
+          .IntoKey(Map::SplitColdCode)
+
+      .Define({"--implicit-suspend-checks", "--no-implicit-suspend-checks"})
+          .WithValues({true, false})
+          .IntoKey(Map::ImplicitSuspendChecks)
+
       .Define({"--deduplicate-code=_"})
           .template WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -158,6 +183,9 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Define({"--dump-pass-timings"})
           .IntoKey(Map::DumpPassTimings)
 
+      .Define({"--dump-pass-stats"})
+          .IntoKey(Map::DumpPassStats)
+
       .Define({"--dump-stats"})
           .IntoKey(Map::DumpStats)
 
@@ -188,6 +216,10 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Define("--dump-cfg-append")
           .IntoKey(Map::DumpCFGAppend)
 
+      .Define("--compiled-method-cache=_")
+          .template WithType<std::string>()
+          .IntoKey(Map::CompiledMethodCache)
+
       .Define("--register-allocation-strategy=_")
           .template WithType<std::string>()
           .IntoKey(Map::RegisterAllocationStrategy)
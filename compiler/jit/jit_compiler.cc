@@ -62,6 +62,9 @@ void JitCompiler::ParseCompilerOptions() {
   // JIT is never PIC, no matter what the runtime compiler options specify.
   compiler_options_->SetNonPic();
 
+  // Implicit suspend checks need the runtime's SuspensionHandler.
+  compiler_options_->implicit_suspend_checks_ = !runtime->ExplicitSuspendChecks();
+
   // If the options don't provide whether we generate debuggable code, set
   // debuggability based on the runtime value.
   if (!compiler_options_->GetDebuggable()) {
@@ -88,18 +88,16 @@ namespace jit {
 //
 class JitLogger {
  public:
-    JitLogger() : code_index_(0), marker_address_(nullptr) {}
+    JitLogger() : lock_("jit logger lock"), code_index_(0), marker_address_(nullptr) {}
 
     void OpenLog() {
       OpenPerfMapLog();
       OpenJitDumpLog();
     }
 
+    // May be called concurrently by several JIT compiler threads.
     void WriteLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_) {
-      WritePerfMapLog(ptr, code_size, method);
-      WriteJitDumpLog(ptr, code_size, method);
-    }
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
 
     void CloseLog() {
       ClosePerfMapLog();
@@ -124,6 +122,8 @@ class JitLogger {
     void WriteJitDumpHeader();
     void WriteJitDumpDebugInfo();
 
+    // Serializes writes to the log files.
+    Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
     std::unique_ptr<File> perf_file_;
     std::unique_ptr<File> jit_dump_file_;
     uint64_t code_index_;
@@ -143,11 +143,13 @@ class LinkerPatch {
   }
 
   static LinkerPatch CallEntrypointPatch(size_t literal_offset,
-                                         uint32_t entrypoint_offset) {
+                                         uint32_t entrypoint_offset,
+                                         uint32_t entrypoint_arguments = 0u) {
     LinkerPatch patch(literal_offset,
                       Type::kCallEntrypoint,
                       /* target_dex_file= */ nullptr);
     patch.entrypoint_offset_ = entrypoint_offset;
+    patch.entrypoint_arguments_ = entrypoint_arguments;
     return patch;
   }
 
@@ -231,6 +233,13 @@ class LinkerPatch {
     return entrypoint_offset_;
   }
 
+  // Architecture-specific encoding of argument moves done by the entrypoint call thunk,
+  // 0 if the caller sets up the arguments itself.
+  uint32_t EntrypointArguments() const {
+    DCHECK(patch_type_ == Type::kCallEntrypoint);
+    return entrypoint_arguments_;
+  }
+
   uint32_t GetBakerCustomValue1() const {
     DCHECK(patch_type_ == Type::kBakerReadBarrierBranch);
     return baker_custom_value1_;
@@ -279,8 +288,11 @@ class LinkerPatch {
     // Literal offset of the insn loading PC (same as literal_offset if it's the same insn,
     // may be different if the PC-relative addressing needs multiple insns).
     uint32_t pc_insn_offset_;
+    uint32_t entrypoint_arguments_;  // Argument moves done by the entrypoint call thunk.
     uint32_t baker_custom_value2_;
     static_assert(sizeof(pc_insn_offset_) <= sizeof(cmp2_), "needed by relational operators");
+    static_assert(sizeof(entrypoint_arguments_) <= sizeof(cmp2_),
+                  "needed by relational operators");
     static_assert(sizeof(baker_custom_value2_) <= sizeof(cmp2_), "needed by relational operators");
   };
 
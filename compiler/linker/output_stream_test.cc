@@ -92,6 +92,31 @@ TEST_F(OutputStreamTest, Buffered) {
   CheckTestOutput(actual);
 }
 
+TEST_F(OutputStreamTest, BufferedLargeWrite) {
+  ScratchFile tmp;
+  // Larger than the buffer, written together with the buffered prefix.
+  std::vector<uint8_t> large(64 * KB);
+  for (size_t i = 0; i != large.size(); ++i) {
+    large[i] = static_cast<uint8_t>(i * 7u);
+  }
+  uint8_t prefix[] = { 1, 2, 3 };
+  {
+    BufferedOutputStream buffered_output_stream(std::make_unique<FileOutputStream>(tmp.GetFile()));
+    EXPECT_TRUE(buffered_output_stream.WriteFully(prefix, sizeof(prefix)));
+    EXPECT_TRUE(buffered_output_stream.WriteFully(large.data(), large.size()));
+    EXPECT_EQ(static_cast<off_t>(sizeof(prefix) + large.size()),
+              buffered_output_stream.Seek(0, kSeekCurrent));
+    EXPECT_TRUE(buffered_output_stream.Flush());
+  }
+  std::unique_ptr<File> in(OS::OpenFileForReading(tmp.GetFilename().c_str()));
+  ASSERT_TRUE(in.get() != nullptr);
+  std::vector<uint8_t> actual(in->GetLength());
+  ASSERT_EQ(sizeof(prefix) + large.size(), actual.size());
+  ASSERT_TRUE(in->ReadFully(&actual[0], actual.size()));
+  EXPECT_EQ(0, memcmp(prefix, &actual[0], sizeof(prefix)));
+  EXPECT_EQ(0, memcmp(large.data(), &actual[sizeof(prefix)], large.size()));
+}
+
 TEST_F(OutputStreamTest, Vector) {
   std::vector<uint8_t> output;
   VectorOutputStream output_stream("test vector output", &output);
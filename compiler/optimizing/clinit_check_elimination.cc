@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "clinit_check_elimination.h"
+
+#include <optional>
+
+#include "art_method-inl.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "driver/compiler_options.h"
+#include "instruction_builder.h"
+#include "mirror/class-inl.h"
+#include "nodes.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+// The class that is initialized, or being initialized by the current thread, once
+// `instruction` completes normally. Null if `instruction` does not initialize a class,
+// or if the class is not resolved at compile time.
+static ObjPtr<mirror::Class> GetInitializedClass(HInstruction* instruction)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (instruction->IsClinitCheck()) {
+    Handle<mirror::Class> klass = instruction->AsClinitCheck()->GetLoadClass()->GetClass();
+    return (klass == nullptr) ? nullptr : klass.Get();
+  }
+  if (instruction->IsInvokeStaticOrDirect()) {
+    HInvokeStaticOrDirect* invoke = instruction->AsInvokeStaticOrDirect();
+    // A static invoke without an HClinitCheck input initializes the class itself, unless
+    // it is an intrinsic that does not call the method.
+    if (invoke->IsStaticWithImplicitClinitCheck() &&
+        !invoke->IsIntrinsic() &&
+        invoke->GetResolvedMethod() != nullptr) {
+      return invoke->GetResolvedMethod()->GetDeclaringClass();
+    }
+  }
+  return nullptr;
+}
+
+static bool IsSubClass(ObjPtr<mirror::Class> to_test, ObjPtr<mirror::Class> super_class)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  return to_test != nullptr && !to_test->IsInterface() && to_test->IsSubClass(super_class);
+}
+
+bool ClinitCheckElimination::Run() {
+  ScopedObjectAccess soa(Thread::Current());
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  // For each block visited so far, the instructions after which a class is known to be
+  // initialized, in program order.
+  ScopedArenaVector<ScopedArenaVector<HInstruction*>> initializing_instructions(
+      graph_->GetBlocks().size(),
+      ScopedArenaVector<HInstruction*>(allocator.Adapter(kArenaAllocOptimization)),
+      allocator.Adapter(kArenaAllocOptimization));
+
+  // Whether the initialization of `klass` must have completed, or been started by the
+  // current thread, before `check` executes.
+  auto is_known_initialized = [&](HClinitCheck* check, ObjPtr<mirror::Class> klass)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    // Only a trivial initialization can be assumed complete once a subclass started
+    // initializing: otherwise the subclass can be initialized from the `<clinit>` of
+    // `klass` running on another thread. See HInstructionBuilder::IsInitialized().
+    std::optional<bool> trivial_initialization;
+    auto has_trivial_initialization = [&]() REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (!trivial_initialization.has_value()) {
+        trivial_initialization =
+            HInstructionBuilder::HasTrivialInitialization(klass, compiler_options_);
+      }
+      return trivial_initialization.value();
+    };
+
+    // A static method or constructor of `klass` runs after its class initialization check.
+    // Any method of a subclass runs after the subclass started initializing.
+    for (HEnvironment* environment = check->GetEnvironment();
+         environment != nullptr;
+         environment = environment->GetParent()) {
+      ArtMethod* method = environment->GetMethod();
+      if (method == nullptr) {
+        continue;
+      }
+      ObjPtr<mirror::Class> declaring_class = method->GetDeclaringClass();
+      if (declaring_class == klass && (method->IsStatic() || method->IsConstructor())) {
+        return true;
+      }
+      if (IsSubClass(declaring_class, klass) && has_trivial_initialization()) {
+        return true;
+      }
+    }
+
+    for (HBasicBlock* block = check->GetBlock();
+         block != nullptr;
+         block = block->GetDominator()) {
+      for (HInstruction* instruction : initializing_instructions[block->GetBlockId()]) {
+        ObjPtr<mirror::Class> initialized_class = GetInitializedClass(instruction);
+        if (initialized_class == klass ||
+            (IsSubClass(initialized_class, klass) && has_trivial_initialization())) {
+          return true;
+        }
+      }
+      if (block->IsCatchBlock()) {
+        // A catch block can be entered by an exception thrown from a dominating check.
+        break;
+      }
+    }
+    return false;
+  };
+
+  bool removed_check = false;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    ScopedArenaVector<HInstruction*>& block_instructions =
+        initializing_instructions[block->GetBlockId()];
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      ObjPtr<mirror::Class> klass = GetInitializedClass(instruction);
+      if (klass == nullptr) {
+        continue;
+      }
+      if (instruction->IsClinitCheck() &&
+          is_known_initialized(instruction->AsClinitCheck(), klass)) {
+        HClinitCheck* check = instruction->AsClinitCheck();
+        // Static invokes that relied on the check do not need to initialize the class.
+        const HUseList<HInstruction*>& uses = check->GetUses();
+        for (auto use_it = uses.begin(), end = uses.end(); use_it != end; /* ++use_it below */) {
+          HInstruction* user = use_it->GetUser();
+          ++use_it;  // Advance before we remove the node, reference to the next node is preserved.
+          if (user->IsInvokeStaticOrDirect() &&
+              user->AsInvokeStaticOrDirect()->IsStaticWithExplicitClinitCheck()) {
+            user->AsInvokeStaticOrDirect()->RemoveExplicitClinitCheck(
+                HInvokeStaticOrDirect::ClinitCheckRequirement::kNone);
+          }
+        }
+        check->ReplaceWith(check->GetLoadClass());
+        block->RemoveInstruction(check);
+        MaybeRecordStat(stats_, MethodCompilationStat::kRemovedClinitCheck);
+        removed_check = true;
+        continue;
+      }
+      block_instructions.push_back(instruction);
+    }
+  }
+  return removed_check;
+}
+
+}  // namespace art
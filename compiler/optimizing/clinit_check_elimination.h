@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_CLINIT_CHECK_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_CLINIT_CHECK_ELIMINATION_H_
+
+#include "optimization.h"
+
+namespace art {
+
+class CompilerOptions;
+
+/**
+ * Removes HClinitCheck instructions that are known to pass once inlining is done:
+ * - checks dominated by a check or a static invoke for the same class, including checks
+ *   of HLoadClass instructions that GVN cannot merge, such as loads of one class from
+ *   different dex files;
+ * - checks dominated by a check for a subclass, when the initialization of the class is
+ *   trivial and so must have completed before the subclass started initializing;
+ * - checks in code inlined into a static method or constructor of the class, or into any
+ *   method of a subclass when the initialization is trivial, anywhere in the inlining chain.
+ *
+ * This runs before GVN and LICM, so that the remaining checks in loop headers are hoisted.
+ */
+class ClinitCheckElimination : public HOptimization {
+ public:
+  ClinitCheckElimination(HGraph* graph,
+                         const CompilerOptions& compiler_options,
+                         OptimizingCompilerStats* stats,
+                         const char* name = kClinitCheckEliminationPassName)
+      : HOptimization(graph, name, stats),
+        compiler_options_(compiler_options) {}
+
+  bool Run() override;
+
+  static constexpr const char* kClinitCheckEliminationPassName = "clinit_check_elimination";
+
+ private:
+  const CompilerOptions& compiler_options_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClinitCheckElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_CLINIT_CHECK_ELIMINATION_H_
@@ -46,6 +46,7 @@
 #include "gc/space/image_space.h"
 #include "intern_table.h"
 #include "intrinsics.h"
+#include "jit/profiling_info.h"
 #include "mirror/array-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/object_reference.h"
@@ -74,6 +75,8 @@ static bool CheckType(DataType::Type type, Location location) {
     return type == DataType::Type::kInt64;
   } else if (location.IsFpuRegisterPair()) {
     return type == DataType::Type::kFloat64;
+  } else if (location.IsPredicateRegister()) {
+    return type == HVecPredSetOperation::kSIMDPredType;
   } else if (location.IsStackSlot()) {
     return (DataType::IsIntegralType(type) && type != DataType::Type::kInt64)
            || (type == DataType::Type::kFloat32)
@@ -479,6 +482,8 @@ void CodeGenerator::InitializeCodeGeneration(size_t number_of_spill_slots,
     DCHECK_EQ(maximum_safepoint_spill_size, 0u);
     SetFrameSize(CallPushesPC() ? GetWordSize() : 0);
   } else {
+    // Empty frames do not get a frame record, their return address stays in the link register.
+    core_spill_mask_ |= GetFramePointerSpillMask();
     SetFrameSize(RoundUp(
         first_register_slot_in_slow_path_
         + maximum_safepoint_spill_size
@@ -579,12 +584,13 @@ void CodeGenerator::GenerateInvokeUnresolvedRuntimeCall(HInvokeUnresolved* invok
   InvokeRuntime(entrypoint, invoke, invoke->GetDexPc(), nullptr);
 }
 
-void CodeGenerator::GenerateInvokePolymorphicCall(HInvokePolymorphic* invoke) {
+void CodeGenerator::GenerateInvokePolymorphicCall(HInvokePolymorphic* invoke,
+                                                  SlowPathCode* slow_path) {
   // invoke-polymorphic does not use a temporary to convey any additional information (e.g. a
   // method index) since it requires multiple info from the instruction (registers A, B, H). Not
   // using the reservation has no effect on the registers used in the runtime call.
   QuickEntrypointEnum entrypoint = kQuickInvokePolymorphic;
-  InvokeRuntime(entrypoint, invoke, invoke->GetDexPc(), nullptr);
+  InvokeRuntime(entrypoint, invoke, invoke->GetDexPc(), slow_path);
 }
 
 void CodeGenerator::GenerateInvokeCustomCall(HInvokeCustom* invoke) {
@@ -610,6 +616,13 @@ void CodeGenerator::CreateStringBuilderAppendLocations(HStringBuilderAppend* ins
     StringBuilderAppend::Argument arg_type =
         static_cast<StringBuilderAppend::Argument>(f & StringBuilderAppend::kArgMask);
     switch (arg_type) {
+      case StringBuilderAppend::Argument::kNextFormat:
+        // The chained format word is passed on the stack and decoding continues with it.
+        DCHECK_EQ(f, static_cast<uint32_t>(StringBuilderAppend::Argument::kNextFormat));
+        locations->SetInAt(i, Location::StackSlot(stack_offset));
+        stack_offset += sizeof(uint32_t);
+        f = static_cast<uint32_t>(instruction->InputAt(i)->AsIntConstant()->GetValue());
+        continue;
       case StringBuilderAppend::Argument::kStringBuilder:
       case StringBuilderAppend::Argument::kString:
       case StringBuilderAppend::Argument::kCharArray:
@@ -1154,7 +1167,13 @@ void CodeGenerator::RecordPcInfo(HInstruction* instruction,
   LocationSummary* locations = instruction->GetLocations();
   uint32_t register_mask = locations->GetRegisterMask();
   DCHECK_EQ(register_mask & ~locations->GetLiveRegisters()->GetCoreRegisters(), 0u);
-  if (locations->OnlyCallsOnSlowPath()) {
+  if (instruction->IsSuspendCheck() && slow_path == nullptr && !native_debug_info) {
+    // Implicit suspend check. Nothing is spilled: the fault handler enters the runtime through
+    // a save-everything frame, where the stack walker finds all core registers. Keep the
+    // caller-save registers holding objects in the mask so that the GC visits and updates them.
+    DCHECK(UseImplicitSuspendChecks());
+    DCHECK_EQ(GetSlowPathSpills(locations, /* core_registers= */ false), 0u);
+  } else if (locations->OnlyCallsOnSlowPath()) {
     // In case of slow path, we currently set the location of caller-save registers
     // to register (instead of their stack location when pushed before the slow-path
     // call). Therefore register_mask contains both callee-save and caller-save
@@ -1529,6 +1548,12 @@ void CodeGenerator::GenerateNullCheck(HNullCheck* instruction) {
   }
 }
 
+bool CodeGenerator::UseImplicitSuspendChecks() const {
+  return compiler_options_.GetImplicitSuspendChecks() &&
+         !GetGraph()->HasSIMD() &&
+         !GetGraph()->IsCompilingOsr();
+}
+
 void CodeGenerator::ClearSpillSlotsFromLoopPhisInStackMap(HSuspendCheck* suspend_check,
                                                           HParallelMove* spills) const {
   LocationSummary* locations = suspend_check->GetLocations();
@@ -1755,4 +1780,23 @@ QuickEntrypointEnum CodeGenerator::GetArrayAllocationEntrypoint(HNewArray* new_a
   UNREACHABLE();
 }
 
+BranchCache* CodeGenerator::GetBranchCacheFor(HIf* if_instr) const {
+  if (!GetGraph()->IsCompilingBaseline() || Runtime::Current()->IsAotCompiler()) {
+    return nullptr;
+  }
+  // Baseline code does not inline, so the dex pc is one of the outermost method.
+  ScopedObjectAccess soa(Thread::Current());
+  ProfilingInfo* info = GetGraph()->GetArtMethod()->GetProfilingInfo(kRuntimePointerSize);
+  return (info != nullptr) ? info->GetBranchCache(if_instr->GetDexPc()) : nullptr;
+}
+
+TypeCheckCache* CodeGenerator::GetTypeCheckCacheFor(HTypeCheckInstruction* type_check) const {
+  if (!GetGraph()->IsCompilingBaseline() || Runtime::Current()->IsAotCompiler()) {
+    return nullptr;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  ProfilingInfo* info = GetGraph()->GetArtMethod()->GetProfilingInfo(kRuntimePointerSize);
+  return (info != nullptr) ? info->GetTypeCheckCache(type_check->GetDexPc()) : nullptr;
+}
+
 }  // namespace art
@@ -58,10 +58,12 @@ static constexpr ReadBarrierOption kCompilerReadBarrierOption =
     kEmitCompilerReadBarrier ? kWithReadBarrier : kWithoutReadBarrier;
 
 class Assembler;
+class BranchCache;
 class CodeGenerator;
 class CompilerOptions;
 class StackMapStream;
 class ParallelMoveResolver;
+class TypeCheckCache;
 
 namespace linker {
 class LinkerPatch;
@@ -194,6 +196,12 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   // Get the graph. This is the outermost graph, never the graph of a method being inlined.
   HGraph* GetGraph() const { return graph_; }
 
+  // Return the branch cache that baseline code must update for `if_instr`, or null.
+  BranchCache* GetBranchCacheFor(HIf* if_instr) const;
+
+  // Return the type check cache that baseline code must update for `type_check`, or null.
+  TypeCheckCache* GetTypeCheckCacheFor(HTypeCheckInstruction* type_check) const;
+
   HBasicBlock* GetNextBlockToEmit() const;
   HBasicBlock* FirstNonEmptyBlock(HBasicBlock* block) const;
   bool GoesToNextBlock(HBasicBlock* current, HBasicBlock* next) const;
@@ -263,6 +271,11 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
     fpu_spill_mask_ = allocated_registers_.GetFloatingPointRegisters() & fpu_callee_save_mask_;
   }
 
+  // Returns the mask of the frame pointer register when generating frame pointers, or zero if
+  // the code generator does not keep a frame pointer chain. The register is saved in every
+  // non-empty frame right below the return address and made to point at that slot.
+  virtual uint32_t GetFramePointerSpillMask() const { return 0u; }
+
   static uint32_t ComputeRegisterMask(const int* registers, size_t length) {
     uint32_t mask = 0;
     for (size_t i = 0, e = length; i < e; ++i) {
@@ -372,6 +385,13 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   virtual void GenerateImplicitNullCheck(HNullCheck* null_check) = 0;
   virtual void GenerateExplicitNullCheck(HNullCheck* null_check) = 0;
 
+  // Whether suspend checks should load from the suspend trigger, which faults when the thread
+  // is asked to suspend, rather than test the thread flags. The fault handler enters the
+  // runtime without spilling the full vector registers, so graphs with SIMD code keep the
+  // explicit slow path. OSR code also keeps it, so that the OSR entries stay at the loop
+  // back edges on all architectures.
+  bool UseImplicitSuspendChecks() const;
+
   // Records a stack map which the runtime might use to set catch phi values
   // during exception delivery.
   // TODO: Replace with a catch-entering instruction that records the environment.
@@ -575,7 +595,8 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
 
   void GenerateInvokeUnresolvedRuntimeCall(HInvokeUnresolved* invoke);
 
-  void GenerateInvokePolymorphicCall(HInvokePolymorphic* invoke);
+  void GenerateInvokePolymorphicCall(HInvokePolymorphic* invoke,
+                                     SlowPathCode* slow_path = nullptr);
 
   void GenerateInvokeCustomCall(HInvokeCustom* invoke);
 
@@ -258,19 +258,16 @@ class BoundsCheckSlowPathARM64 : public SlowPathCodeARM64 {
       // Live registers will be restored in the catch block if caught.
       SaveLiveRegisters(codegen, instruction_->GetLocations());
     }
-    // We're moving two locations to locations that could overlap, so we need a parallel
-    // move resolver.
-    InvokeRuntimeCallingConvention calling_convention;
-    codegen->EmitParallelMoves(locations->InAt(0),
-                               LocationFrom(calling_convention.GetRegisterAt(0)),
-                               DataType::Type::kInt32,
-                               locations->InAt(1),
-                               LocationFrom(calling_convention.GetRegisterAt(1)),
-                               DataType::Type::kInt32);
     QuickEntrypointEnum entrypoint = instruction_->AsBoundsCheck()->IsStringCharAt()
         ? kQuickThrowStringBounds
         : kQuickThrowArrayBounds;
-    arm64_codegen->InvokeRuntime(entrypoint, instruction_, instruction_->GetDexPc(), this);
+    arm64_codegen->InvokeRuntimeWithArguments(entrypoint,
+                                              instruction_,
+                                              instruction_->GetDexPc(),
+                                              this,
+                                              locations->InAt(0),
+                                              locations->InAt(1),
+                                              DataType::Type::kInt32);
     CheckEntrypointTypes<kQuickThrowStringBounds, void, int32_t, int32_t>();
     CheckEntrypointTypes<kQuickThrowArrayBounds, void, int32_t, int32_t>();
   }
@@ -478,24 +475,28 @@ class TypeCheckSlowPathARM64 : public SlowPathCodeARM64 {
       SaveLiveRegisters(codegen, locations);
     }
 
-    // We're moving two locations to locations that could overlap, so we need a parallel
-    // move resolver.
     InvokeRuntimeCallingConvention calling_convention;
-    codegen->EmitParallelMoves(locations->InAt(0),
-                               LocationFrom(calling_convention.GetRegisterAt(0)),
-                               DataType::Type::kReference,
-                               locations->InAt(1),
-                               LocationFrom(calling_convention.GetRegisterAt(1)),
-                               DataType::Type::kReference);
     if (instruction_->IsInstanceOf()) {
-      arm64_codegen->InvokeRuntime(kQuickInstanceofNonTrivial, instruction_, dex_pc, this);
+      arm64_codegen->InvokeRuntimeWithArguments(kQuickInstanceofNonTrivial,
+                                                instruction_,
+                                                dex_pc,
+                                                this,
+                                                locations->InAt(0),
+                                                locations->InAt(1),
+                                                DataType::Type::kReference);
       CheckEntrypointTypes<kQuickInstanceofNonTrivial, size_t, mirror::Object*, mirror::Class*>();
       DataType::Type ret_type = instruction_->GetType();
       Location ret_loc = calling_convention.GetReturnLocation(ret_type);
       arm64_codegen->MoveLocation(locations->Out(), ret_loc, ret_type);
     } else {
       DCHECK(instruction_->IsCheckCast());
-      arm64_codegen->InvokeRuntime(kQuickCheckInstanceOf, instruction_, dex_pc, this);
+      arm64_codegen->InvokeRuntimeWithArguments(kQuickCheckInstanceOf,
+                                                instruction_,
+                                                dex_pc,
+                                                this,
+                                                locations->InAt(0),
+                                                locations->InAt(1),
+                                                DataType::Type::kReference);
       CheckEntrypointTypes<kQuickCheckInstanceOf, void, mirror::Object*, mirror::Class*>();
     }
 
@@ -884,6 +885,7 @@ CodeGeneratorARM64::CodeGeneratorARM64(HGraph* graph,
                     stats),
       block_labels_(graph->GetAllocator()->Adapter(kArenaAllocCodeGenerator)),
       jump_tables_(graph->GetAllocator()->Adapter(kArenaAllocCodeGenerator)),
+      sve_enabled_for_testing_(false),
       location_builder_neon_(graph, this),
       instruction_visitor_neon_(graph, this),
       location_builder_sve_(graph, this),
@@ -924,7 +926,15 @@ CodeGeneratorARM64::CodeGeneratorARM64(HGraph* graph,
 }
 
 bool CodeGeneratorARM64::ShouldUseSVE() const {
-  return kArm64AllowSVE && GetInstructionSetFeatures().HasSVE();
+  return (kArm64AllowSVE || sve_enabled_for_testing_) && GetInstructionSetFeatures().HasSVE();
+}
+
+void CodeGeneratorARM64::EnableSVEForTesting() {
+  sve_enabled_for_testing_ = true;
+  if (ShouldUseSVE()) {
+    location_builder_ = &location_builder_sve_;
+    instruction_visitor_ = &instruction_visitor_sve_;
+  }
 }
 
 #define __ GetVIXLAssembler()->
@@ -1199,6 +1209,12 @@ void CodeGeneratorARM64::GenerateFrameEntry() {
     GetAssembler()->SpillRegisters(preserved_core_registers, core_spills_offset);
     GetAssembler()->SpillRegisters(preserved_fp_registers, fp_spills_offset);
 
+    if (GetFramePointerSpillMask() != 0u) {
+      // Core registers are spilled in increasing order, so x29 is right below lr and the two
+      // form an AAPCS64 frame record. Point x29 at it to link the frame into the chain.
+      __ Add(x29, sp, frame_size - 2 * kXRegSizeInBytes);
+    }
+
     if (GetGraph()->HasShouldDeoptimizeFlag()) {
       // Initialize should_deoptimize flag to 0.
       Register wzr = Register(VIXLRegCodeFromART(WZR), kWRegSize);
@@ -1305,6 +1321,10 @@ void CodeGeneratorARM64::MarkGCCard(Register object, Register value, bool value_
   }
 }
 
+uint32_t CodeGeneratorARM64::GetFramePointerSpillMask() const {
+  return GetCompilerOptions().GetGenerateFramePointers() ? (1u << X29) : 0u;
+}
+
 void CodeGeneratorARM64::SetupBlockedRegisters() const {
   // Blocked core registers:
   //      lr        : Runtime reserved.
@@ -1322,6 +1342,10 @@ void CodeGeneratorARM64::SetupBlockedRegisters() const {
     blocked_core_registers_[reserved_core_registers.PopLowestIndex().GetCode()] = true;
   }
   blocked_core_registers_[X18] = true;
+  if (GetCompilerOptions().GetGenerateFramePointers()) {
+    // x29 holds the frame pointer, see GetFramePointerSpillMask().
+    blocked_core_registers_[X29] = true;
+  }
 
   CPURegList reserved_fp_registers = vixl_reserved_fp_registers;
   while (!reserved_fp_registers.IsEmpty()) {
@@ -1801,6 +1825,46 @@ void CodeGeneratorARM64::InvokeRuntime(QuickEntrypointEnum entrypoint,
   }
 }
 
+void CodeGeneratorARM64::InvokeRuntimeWithArguments(QuickEntrypointEnum entrypoint,
+                                                    HInstruction* instruction,
+                                                    uint32_t dex_pc,
+                                                    SlowPathCode* slow_path,
+                                                    Location arg0,
+                                                    Location arg1,
+                                                    DataType::Type type) {
+  DCHECK(type == DataType::Type::kInt32 || type == DataType::Type::kReference) << type;
+  DCHECK(slow_path != nullptr);
+  InvokeRuntimeCallingConvention calling_convention;
+  if (GetCompilerOptions().IsJitCompiler() || !arg0.IsRegister() || !arg1.IsRegister()) {
+    // We're moving two locations to locations that could overlap, so we need a parallel
+    // move resolver.
+    EmitParallelMoves(arg0,
+                      LocationFrom(calling_convention.GetRegisterAt(0)),
+                      type,
+                      arg1,
+                      LocationFrom(calling_convention.GetRegisterAt(1)),
+                      type);
+    InvokeRuntime(entrypoint, instruction, dex_pc, slow_path);
+    return;
+  }
+
+  ValidateInvokeRuntime(entrypoint, instruction, slow_path);
+  // Slow paths differ mostly in the registers holding the arguments, so let the
+  // thunk for this entrypoint and pair of registers do the moves for all of them.
+  uint32_t arguments =
+      (arg0.reg() == calling_convention.GetRegisterAt(0).GetCode() &&
+       arg1.reg() == calling_convention.GetRegisterAt(1).GetCode())
+          ? 0u
+          : EncodeEntrypointThunkArguments(arg0.reg(), arg1.reg());
+  ThreadOffset64 entrypoint_offset = GetThreadOffset<kArm64PointerSize>(entrypoint);
+  // Ensure the pc position is recorded immediately after the `bl` instruction.
+  ExactAssemblyScope eas(GetVIXLAssembler(), kInstructionSize, CodeBufferCheckScope::kExactSize);
+  EmitEntrypointThunkCall(entrypoint_offset, arguments);
+  if (EntrypointRequiresStackMap(entrypoint)) {
+    RecordPcInfo(instruction, dex_pc, slow_path);
+  }
+}
+
 void CodeGeneratorARM64::InvokeRuntimeWithoutRecordingPcInfo(int32_t entry_point_offset,
                                                              HInstruction* instruction,
                                                              SlowPathCode* slow_path) {
@@ -1875,6 +1939,29 @@ void CodeGeneratorARM64::GenerateMemoryBarrier(MemBarrierKind kind) {
 
 void InstructionCodeGeneratorARM64::GenerateSuspendCheck(HSuspendCheck* instruction,
                                                          HBasicBlock* successor) {
+  if (codegen_->UseImplicitSuspendChecks()) {
+    // Load the suspend trigger and dereference it. The trigger is null when the thread is
+    // asked to suspend and the SuspensionHandler then calls the runtime. The handler expects
+    // these two loads, see runtime/arch/arm64/fault_handler_arm64.cc.
+    UseScratchRegisterScope temps(codegen_->GetVIXLAssembler());
+    Register temp = temps.AcquireX();
+    {
+      // Ensure that no pools are emitted between the loads and RecordPcInfo.
+      ExactAssemblyScope eas(codegen_->GetVIXLAssembler(),
+                             2 * kInstructionSize,
+                             CodeBufferCheckScope::kExactSize);
+      __ ldr(temp,
+             MemOperand(tr, Thread::ThreadSuspendTriggerOffset<kArm64PointerSize>().Int32Value()));
+      __ ldr(temp, MemOperand(temp));
+      codegen_->RecordPcInfo(instruction, instruction->GetDexPc());
+    }
+    if (successor != nullptr) {
+      DCHECK(successor->IsLoopHeader());
+      __ B(codegen_->GetLabelOf(successor));
+    }
+    return;
+  }
+
   SuspendCheckSlowPathARM64* slow_path =
       down_cast<SuspendCheckSlowPathARM64*>(instruction->GetSlowPath());
   if (slow_path == nullptr) {
@@ -3529,6 +3616,31 @@ void InstructionCodeGeneratorARM64::VisitIf(HIf* if_instr) {
   if (codegen_->GoesToNextBlock(if_instr->GetBlock(), false_successor)) {
     false_target = nullptr;
   }
+  BranchCache* cache = codegen_->GetBranchCacheFor(if_instr);
+  if (cache != nullptr) {
+    // Count the outcomes of the branch for the optimizing compiler.
+    uint64_t address = reinterpret_cast64<uint64_t>(cache);
+    auto increment = [&](MemberOffset offset) {
+      UseScratchRegisterScope temps(GetVIXLAssembler());
+      Register temp = temps.AcquireX();
+      Register counter = temps.AcquireW();
+      __ Mov(temp, address);
+      __ Ldr(counter, MemOperand(temp, offset.Int32Value()));
+      __ Add(counter, counter, 1);
+      __ Str(counter, MemOperand(temp, offset.Int32Value()));
+    };
+    vixl::aarch64::Label taken;
+    GenerateTestAndBranch(
+        if_instr, /* condition_input_index= */ 0, &taken, /* false_target= */ nullptr);
+    increment(BranchCache::NotTakenOffset());
+    __ B(codegen_->GetLabelOf(false_successor));
+    __ Bind(&taken);
+    increment(BranchCache::TakenOffset());
+    if (true_target != nullptr) {
+      __ B(true_target);
+    }
+    return;
+  }
   GenerateTestAndBranch(if_instr, /* condition_input_index= */ 0, true_target, false_target);
 }
 
@@ -3694,6 +3806,56 @@ static size_t NumberOfCheckCastTemps(TypeCheckKind type_check_kind) {
   return 1 + NumberOfInstanceOfTemps(type_check_kind);
 }
 
+void InstructionCodeGeneratorARM64::GenerateTypeCheckCacheUpdate(TypeCheckCache* cache,
+                                                                 Register obj,
+                                                                 Register temp) {
+  // The first class seen is stored in the cache. Objects of that class are then counted
+  // as hits and objects of other classes as misses.
+  UseScratchRegisterScope temps(GetVIXLAssembler());
+  Register address = temps.AcquireX();
+  Register value = temps.AcquireW();
+  auto increment = [&](MemberOffset offset) {
+    __ Ldr(value, MemOperand(address, offset.Int32Value()));
+    __ Add(value, value, 1);
+    __ Str(value, MemOperand(address, offset.Int32Value()));
+  };
+  vixl::aarch64::Label hit, miss, done;
+  // /* HeapReference<Class> */ temp = obj->klass_
+  // Like for inline caches, we do not need a read barrier for a class we only record.
+  __ Ldr(temp, HeapOperand(obj, mirror::Object::ClassOffset()));
+  GetAssembler()->MaybeUnpoisonHeapReference(temp);
+  __ Mov(address, reinterpret_cast64<uint64_t>(cache));
+  __ Ldr(value, MemOperand(address, TypeCheckCache::ClassOffset().Int32Value()));
+  __ Cmp(value, temp);
+  __ B(eq, &hit);
+  __ Cbnz(value, &miss);
+  __ Str(temp, MemOperand(address, TypeCheckCache::ClassOffset().Int32Value()));
+  __ Bind(&hit);
+  increment(TypeCheckCache::HitsOffset());
+  __ B(&done);
+  __ Bind(&miss);
+  increment(TypeCheckCache::MissesOffset());
+  __ Bind(&done);
+}
+
+void InstructionCodeGeneratorARM64::GenerateProfiledClassCompare(HTypeCheckInstruction* check,
+                                                                 Register obj) {
+  // Neither class is loaded with a read barrier. A from-space and a to-space reference to
+  // the same class compare unequal, which only loses the fast path.
+  UseScratchRegisterScope temps(GetVIXLAssembler());
+  Register obj_class = temps.AcquireW();
+  Register profiled_class = temps.AcquireW();
+  // /* HeapReference<Class> */ obj_class = obj->klass_
+  __ Ldr(obj_class, HeapOperand(obj, mirror::Object::ClassOffset()));
+  GetAssembler()->MaybeUnpoisonHeapReference(obj_class);
+  // /* GcRoot<mirror::Class> */ profiled_class = *address
+  __ Ldr(profiled_class, codegen_->DeduplicateJitClassLiteral(check->GetProfiledDexFile(),
+                                                              check->GetProfiledTypeIndex(),
+                                                              check->GetProfiledClass()));
+  __ Ldr(profiled_class, MemOperand(profiled_class.X()));
+  __ Cmp(obj_class, profiled_class);
+}
+
 void LocationsBuilderARM64::VisitInstanceOf(HInstanceOf* instruction) {
   LocationSummary::CallKind call_kind = LocationSummary::kNoCall;
   TypeCheckKind type_check_kind = instruction->GetTypeCheckKind();
@@ -3735,6 +3897,10 @@ void LocationsBuilderARM64::VisitInstanceOf(HInstanceOf* instruction) {
   locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
   // Add temps if necessary for read barriers.
   locations->AddRegisterTemps(NumberOfInstanceOfTemps(type_check_kind));
+  if (codegen_->GetTypeCheckCacheFor(instruction) != nullptr) {
+    // Add a temp for the class recorded in the type check cache.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorARM64::VisitInstanceOf(HInstanceOf* instruction) {
@@ -3764,6 +3930,16 @@ void InstructionCodeGeneratorARM64::VisitInstanceOf(HInstanceOf* instruction) {
     __ Cbz(obj, &zero);
   }
 
+  TypeCheckCache* cache = codegen_->GetTypeCheckCacheFor(instruction);
+  if (cache != nullptr) {
+    GenerateTypeCheckCacheUpdate(cache, obj, WRegisterFrom(locations->GetTemp(num_temps)));
+  }
+  if (instruction->HasProfiledClass()) {
+    GenerateProfiledClassCompare(instruction, obj);
+    __ Mov(out, 1);
+    __ B(eq, &done);
+  }
+
   switch (type_check_kind) {
     case TypeCheckKind::kExactCheck: {
       ReadBarrierOption read_barrier_option =
@@ -3978,6 +4154,10 @@ void LocationsBuilderARM64::VisitCheckCast(HCheckCast* instruction) {
   }
   // Add temps for read barriers and other uses. One is used by TypeCheckSlowPathARM64.
   locations->AddRegisterTemps(NumberOfCheckCastTemps(type_check_kind));
+  if (codegen_->GetTypeCheckCacheFor(instruction) != nullptr) {
+    // Add a temp for the class recorded in the type check cache.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorARM64::VisitCheckCast(HCheckCast* instruction) {
@@ -4016,6 +4196,15 @@ void InstructionCodeGeneratorARM64::VisitCheckCast(HCheckCast* instruction) {
     __ Cbz(obj, &done);
   }
 
+  TypeCheckCache* cache = codegen_->GetTypeCheckCacheFor(instruction);
+  if (cache != nullptr) {
+    GenerateTypeCheckCacheUpdate(cache, obj, WRegisterFrom(locations->GetTemp(num_temps)));
+  }
+  if (instruction->HasProfiledClass()) {
+    GenerateProfiledClassCompare(instruction, obj);
+    __ B(eq, &done);
+  }
+
   switch (type_check_kind) {
     case TypeCheckKind::kExactCheck:
     case TypeCheckKind::kArrayCheck: {
@@ -4242,11 +4431,17 @@ void CodeGeneratorARM64::MaybeGenerateInlineCacheCheck(HInstruction* instruction
       InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
       uint64_t address = reinterpret_cast64<uint64_t>(cache);
       vixl::aarch64::Label done;
+      vixl::aarch64::Label update;
       __ Mov(x8, address);
       __ Ldr(x9, MemOperand(x8, InlineCache::ClassesOffset().Int32Value()));
-      // Fast path for a monomorphic cache.
+      // Fast path for a monomorphic cache, which only needs to count the receiver.
       __ Cmp(klass, x9);
-      __ B(eq, &done);
+      __ B(ne, &update);
+      __ Ldr(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+      __ Add(w9, w9, 1);
+      __ Str(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+      __ B(&done);
+      __ Bind(&update);
       InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
       __ Bind(&done);
     }
@@ -4587,10 +4782,11 @@ vixl::aarch64::Label* CodeGeneratorARM64::NewStringBssEntryPatch(
   return NewPcRelativePatch(&dex_file, string_index.index_, adrp_label, &string_bss_entry_patches_);
 }
 
-void CodeGeneratorARM64::EmitEntrypointThunkCall(ThreadOffset64 entrypoint_offset) {
+void CodeGeneratorARM64::EmitEntrypointThunkCall(ThreadOffset64 entrypoint_offset,
+                                                 uint32_t arguments) {
   DCHECK(!__ AllowMacroInstructions());  // In ExactAssemblyScope.
   DCHECK(!GetCompilerOptions().IsJitCompiler());
-  call_entrypoint_patches_.emplace_back(/*dex_file*/ nullptr, entrypoint_offset.Uint32Value());
+  call_entrypoint_patches_.emplace_back(entrypoint_offset.Uint32Value(), arguments);
   vixl::aarch64::Label* bl_label = &call_entrypoint_patches_.back().label;
   __ bind(bl_label);
   __ bl(static_cast<int64_t>(0));  // Placeholder, patched at link-time.
@@ -4780,10 +4976,9 @@ void CodeGeneratorARM64::EmitLinkerPatches(ArenaVector<linker::LinkerPatch>* lin
       type_bss_entry_patches_, linker_patches);
   EmitPcRelativeLinkerPatches<linker::LinkerPatch::StringBssEntryPatch>(
       string_bss_entry_patches_, linker_patches);
-  for (const PatchInfo<vixl::aarch64::Label>& info : call_entrypoint_patches_) {
-    DCHECK(info.target_dex_file == nullptr);
+  for (const CallEntrypointPatchInfo& info : call_entrypoint_patches_) {
     linker_patches->push_back(linker::LinkerPatch::CallEntrypointPatch(
-        info.label.GetLocation(), info.offset_or_index));
+        info.label.GetLocation(), info.entrypoint_offset, info.arguments));
   }
   for (const BakerReadBarrierPatchInfo& info : baker_read_barrier_patches_) {
     linker_patches->push_back(linker::LinkerPatch::BakerReadBarrierBranchPatch(
@@ -4816,9 +5011,18 @@ void CodeGeneratorARM64::EmitThunkCode(const linker::LinkerPatch& patch,
     }
     case linker::LinkerPatch::Type::kCallEntrypoint: {
       Offset offset(patch.EntrypointOffset());
+      uint32_t arguments = patch.EntrypointArguments();
+      if (arguments != 0u) {
+        CompileEntrypointThunkArgumentMoves(assembler, arguments);
+      }
       assembler.JumpTo(ManagedRegister(arm64::TR), offset, ManagedRegister(arm64::IP0));
       if (GetCompilerOptions().GenerateAnyDebugInfo()) {
         *debug_name = "EntrypointCallThunk_" + std::to_string(offset.Uint32Value());
+        if (arguments != 0u) {
+          uint32_t arg0_reg = EntrypointThunkFirstArgumentField::Decode(arguments);
+          uint32_t arg1_reg = EntrypointThunkSecondArgumentField::Decode(arguments);
+          *debug_name += "_w" + std::to_string(arg0_reg) + "_w" + std::to_string(arg1_reg);
+        }
       }
       break;
     }
@@ -6580,6 +6784,43 @@ MemOperand InstructionCodeGeneratorARM64::VecNeonAddress(
   }
 }
 
+SVEMemOperand InstructionCodeGeneratorARM64::VecSVEAddress(
+    HVecMemoryOperation* instruction,
+    UseScratchRegisterScope* temps_scope,
+    size_t size,
+    /*out*/ Register* scratch) {
+  LocationSummary* locations = instruction->GetLocations();
+  Register base = InputRegisterAt(instruction, 0);
+  *scratch = temps_scope->AcquireX();
+
+  // The SVE immediate offsets are scaled by the vector length, so the data offset is always
+  // added to the base.
+  if (instruction->InputAt(1)->IsIntermediateAddressIndex()) {
+    __ Add(*scratch, base.X(), InputRegisterAt(instruction, 1).X());
+    return SVEMemOperand(*scratch);
+  }
+
+  Location index = locations->InAt(1);
+  uint32_t offset = mirror::Array::DataOffset(size).Uint32Value();
+  size_t shift = ComponentSizeShiftWidth(size);
+
+  // HIntermediateAddress optimization is only applied for scalar ArrayGet and ArraySet.
+  DCHECK(!instruction->InputAt(0)->IsIntermediateAddress());
+
+  if (index.IsConstant()) {
+    __ Add(*scratch, base.X(), offset + (Int64FromLocation(index) << shift));
+    return SVEMemOperand(*scratch);
+  }
+
+  __ Add(*scratch, base.X(), offset);
+  // The index is a non-negative int, and writes to W registers clear the upper bits, so the
+  // X view of the index register holds the same value.
+  Register index_reg = XRegisterFrom(index);
+  return (shift == 0u)
+      ? SVEMemOperand(*scratch, index_reg)
+      : SVEMemOperand(*scratch, index_reg, LSL, shift);
+}
+
 #undef __
 #undef QUICK_ENTRY_POINT
 
@@ -6775,6 +7016,40 @@ void CodeGeneratorARM64::CompileBakerReadBarrierThunk(Arm64Assembler& assembler,
   }
 }
 
+void CodeGeneratorARM64::CompileEntrypointThunkArgumentMoves(Arm64Assembler& assembler,
+                                                             uint32_t encoded_arguments) {
+  DCHECK_EQ(EntrypointThunkArgumentCountField::Decode(encoded_arguments), 2u);
+  uint32_t arg0_reg = EntrypointThunkFirstArgumentField::Decode(encoded_arguments);
+  uint32_t arg1_reg = EntrypointThunkSecondArgumentField::Decode(encoded_arguments);
+  CheckValidReg(arg0_reg);
+  CheckValidReg(arg1_reg);
+  InvokeRuntimeCallingConvention calling_convention;
+  Register dst0 = calling_convention.GetRegisterAt(0).W();
+  Register dst1 = calling_convention.GetRegisterAt(1).W();
+  Register src0 = vixl::aarch64::WRegister(arg0_reg);
+  Register src1 = vixl::aarch64::WRegister(arg1_reg);
+  if (src1.Is(dst0)) {
+    if (src0.Is(dst1)) {
+      // Swap the arguments.
+      UseScratchRegisterScope temps(assembler.GetVIXLAssembler());
+      Register temp = temps.AcquireW();
+      __ Mov(temp, dst0);
+      __ Mov(dst0, dst1);
+      __ Mov(dst1, temp);
+    } else {
+      __ Mov(dst1, src1);
+      __ Mov(dst0, src0);
+    }
+  } else {
+    if (!src0.Is(dst0)) {
+      __ Mov(dst0, src0);
+    }
+    if (!src1.Is(dst1)) {
+      __ Mov(dst1, src1);
+    }
+  }
+}
+
 #undef __
 
 }  // namespace arm64
@@ -292,6 +292,12 @@ class InstructionCodeGeneratorARM64 : public InstructionCodeGenerator {
                                         vixl::aarch64::Register class_reg);
   void GenerateBitstringTypeCheckCompare(HTypeCheckInstruction* check,
                                          vixl::aarch64::Register temp);
+  // Record the class of `obj` in the type check cache of a baseline compiled `check`.
+  void GenerateTypeCheckCacheUpdate(TypeCheckCache* cache,
+                                    vixl::aarch64::Register obj,
+                                    vixl::aarch64::Register temp);
+  // Compare the class of `obj` with the profiled class of `check`, setting the flags.
+  void GenerateProfiledClassCompare(HTypeCheckInstruction* check, vixl::aarch64::Register obj);
   void GenerateSuspendCheck(HSuspendCheck* instruction, HBasicBlock* successor);
   void HandleBinaryOp(HBinaryOperation* instr);
 
@@ -373,6 +379,14 @@ class InstructionCodeGeneratorARM64 : public InstructionCodeGenerator {
       bool is_string_char_at,
       /*out*/ vixl::aarch64::Register* scratch);
 
+  // SVE version, for the predicated vector loops. String compression is not supported.
+  vixl::aarch64::SVEMemOperand VecSVEAddress(
+      HVecMemoryOperation* instruction,
+      // This function may acquire a scratch register.
+      vixl::aarch64::UseScratchRegisterScope* temps_scope,
+      size_t size,
+      /*out*/ vixl::aarch64::Register* scratch);
+
   Arm64Assembler* const assembler_;
   CodeGeneratorARM64* const codegen_;
 
@@ -463,6 +477,11 @@ class InstructionCodeGeneratorARM64Sve : public InstructionCodeGeneratorARM64 {
   void LoadSIMDRegFromStack(Location destination, Location source) override;
   void MoveSIMDRegToSIMDReg(Location destination, Location source) override;
   void MoveToSIMDStackSlot(Location destination, Location source) override;
+
+ private:
+  // Validate that the instruction vector length and packed type are compliant with the SIMD
+  // register size (full SIMD register is used).
+  bool ValidateVectorLength(HVecOperation* instr) const;
 };
 
 class LocationsBuilderARM64Sve : public LocationsBuilderARM64 {
@@ -567,6 +586,7 @@ class CodeGeneratorARM64 : public CodeGenerator {
   // Register allocation.
 
   void SetupBlockedRegisters() const override;
+  uint32_t GetFramePointerSpillMask() const override;
 
   size_t SaveCoreRegister(size_t stack_index, uint32_t reg_id) override;
   size_t RestoreCoreRegister(size_t stack_index, uint32_t reg_id) override;
@@ -635,6 +655,18 @@ class CodeGeneratorARM64 : public CodeGenerator {
                      uint32_t dex_pc,
                      SlowPathCode* slow_path = nullptr) override;
 
+  // Generate code to invoke a runtime entry point from a slow path, moving the 32-bit
+  // values `arg0` and `arg1` to the first two runtime calling convention registers.
+  // For AOT, when both values are in core registers, the moves are done by the shared
+  // entrypoint call thunk instead of being emitted in each slow path.
+  void InvokeRuntimeWithArguments(QuickEntrypointEnum entrypoint,
+                                  HInstruction* instruction,
+                                  uint32_t dex_pc,
+                                  SlowPathCode* slow_path,
+                                  Location arg0,
+                                  Location arg1,
+                                  DataType::Type type);
+
   // Generate code to invoke a runtime entry point, but do not record
   // PC-related information in a stack map.
   void InvokeRuntimeWithoutRecordingPcInfo(int32_t entry_point_offset,
@@ -731,7 +763,9 @@ class CodeGeneratorARM64 : public CodeGenerator {
                                                vixl::aarch64::Label* adrp_label = nullptr);
 
   // Emit the BL instruction for entrypoint thunk call and record the associated patch for AOT.
-  void EmitEntrypointThunkCall(ThreadOffset64 entrypoint_offset);
+  // Non-zero `arguments` describe the argument moves done by the thunk, see
+  // EncodeEntrypointThunkArguments().
+  void EmitEntrypointThunkCall(ThreadOffset64 entrypoint_offset, uint32_t arguments = 0u);
 
   // Emit the CBNZ instruction for baker read barrier and record
   // the associated patch for AOT or slow path for JIT.
@@ -886,6 +920,11 @@ class CodeGeneratorARM64 : public CodeGenerator {
   void MaybeGenerateInlineCacheCheck(HInstruction* instruction, vixl::aarch64::Register klass);
   void MaybeIncrementHotness(bool is_frame_entry);
 
+ protected:
+  // Use SVE if the instruction set features include it, even though kArm64AllowSVE is false.
+  // This lets the tests run the SVE code generator on the simulator.
+  void EnableSVEForTesting();
+
  private:
   // Encoding of thunk type and data for link-time generated thunks for Baker read barriers.
 
@@ -953,6 +992,33 @@ class CodeGeneratorARM64 : public CodeGenerator {
                                     uint32_t encoded_data,
                                     /*out*/ std::string* debug_name);
 
+  // Encoding of the argument moves done by entrypoint call thunks. Each field holds
+  // the core register moved to the corresponding runtime calling convention register.
+
+  static constexpr size_t kEntrypointThunkMaxArguments = 2u;
+  static constexpr size_t kBitsForEntrypointThunkArgumentCount =
+      MinimumBitsToStore(kEntrypointThunkMaxArguments);
+  static constexpr size_t kEntrypointThunkBitsForRegister = MinimumBitsToStore(/* lr */ 30u);
+  using EntrypointThunkArgumentCountField =
+      BitField<uint32_t, 0, kBitsForEntrypointThunkArgumentCount>;
+  using EntrypointThunkFirstArgumentField =
+      BitField<uint32_t, kBitsForEntrypointThunkArgumentCount, kEntrypointThunkBitsForRegister>;
+  using EntrypointThunkSecondArgumentField =
+      BitField<uint32_t,
+               kBitsForEntrypointThunkArgumentCount + kEntrypointThunkBitsForRegister,
+               kEntrypointThunkBitsForRegister>;
+
+  static inline uint32_t EncodeEntrypointThunkArguments(uint32_t arg0_reg, uint32_t arg1_reg) {
+    CheckValidReg(arg0_reg);
+    CheckValidReg(arg1_reg);
+    return EntrypointThunkArgumentCountField::Encode(2u) |
+           EntrypointThunkFirstArgumentField::Encode(arg0_reg) |
+           EntrypointThunkSecondArgumentField::Encode(arg1_reg);
+  }
+
+  void CompileEntrypointThunkArgumentMoves(Arm64Assembler& assembler,
+                                           uint32_t encoded_arguments);
+
   using Uint64ToLiteralMap = ArenaSafeMap<uint64_t, vixl::aarch64::Literal<uint64_t>*>;
   using Uint32ToLiteralMap = ArenaSafeMap<uint32_t, vixl::aarch64::Literal<uint32_t>*>;
   using StringToLiteralMap = ArenaSafeMap<StringReference,
@@ -974,6 +1040,15 @@ class CodeGeneratorARM64 : public CodeGenerator {
     vixl::aarch64::Label* pc_insn_label;
   };
 
+  struct CallEntrypointPatchInfo {
+    CallEntrypointPatchInfo(uint32_t offset, uint32_t args)
+        : label(), entrypoint_offset(offset), arguments(args) { }
+
+    vixl::aarch64::Label label;
+    uint32_t entrypoint_offset;
+    uint32_t arguments;
+  };
+
   struct BakerReadBarrierPatchInfo {
     explicit BakerReadBarrierPatchInfo(uint32_t data) : label(), custom_data(data) { }
 
@@ -1001,6 +1076,9 @@ class CodeGeneratorARM64 : public CodeGenerator {
   vixl::aarch64::Label frame_entry_label_;
   ArenaVector<std::unique_ptr<JumpTableARM64>> jump_tables_;
 
+  // Whether SVE is used regardless of kArm64AllowSVE, see EnableSVEForTesting.
+  bool sve_enabled_for_testing_;
+
   LocationsBuilderARM64Neon location_builder_neon_;
   InstructionCodeGeneratorARM64Neon instruction_visitor_neon_;
   LocationsBuilderARM64Sve location_builder_sve_;
@@ -1027,7 +1105,7 @@ class CodeGeneratorARM64 : public CodeGenerator {
   // and for method/type/string patches for kBootImageRelRo otherwise.
   ArenaDeque<PcRelativePatchInfo> boot_image_other_patches_;
   // Patch info for calls to entrypoint dispatch thunks. Used for slow paths.
-  ArenaDeque<PatchInfo<vixl::aarch64::Label>> call_entrypoint_patches_;
+  ArenaDeque<CallEntrypointPatchInfo> call_entrypoint_patches_;
   // Baker read barrier patch info.
   ArenaDeque<BakerReadBarrierPatchInfo> baker_read_barrier_patches_;
 
@@ -2729,6 +2729,10 @@ void LocationsBuilderARMVIXL::VisitIf(HIf* if_instr) {
   if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
+  if (codegen_->GetBranchCacheFor(if_instr) != nullptr) {
+    // Temporary for the address of the branch cache.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorARMVIXL::VisitIf(HIf* if_instr) {
@@ -2738,6 +2742,31 @@ void InstructionCodeGeneratorARMVIXL::VisitIf(HIf* if_instr) {
       nullptr : codegen_->GetLabelOf(true_successor);
   vixl32::Label* false_target = codegen_->GoesToNextBlock(if_instr->GetBlock(), false_successor) ?
       nullptr : codegen_->GetLabelOf(false_successor);
+  BranchCache* cache = codegen_->GetBranchCacheFor(if_instr);
+  if (cache != nullptr && if_instr->GetLocations()->GetTempCount() == 1u) {
+    // Count the outcomes of the branch for the optimizing compiler.
+    uint32_t address = reinterpret_cast32<uint32_t>(cache);
+    vixl32::Register temp = RegisterFrom(if_instr->GetLocations()->GetTemp(0));
+    auto increment = [&](MemberOffset offset) {
+      UseScratchRegisterScope temps(GetVIXLAssembler());
+      vixl32::Register counter = temps.Acquire();
+      __ Mov(temp, address);
+      __ Ldr(counter, MemOperand(temp, offset.Int32Value()));
+      __ Add(counter, counter, 1);
+      __ Str(counter, MemOperand(temp, offset.Int32Value()));
+    };
+    vixl32::Label taken;
+    GenerateTestAndBranch(
+        if_instr, /* condition_input_index= */ 0, &taken, /* false_target= */ nullptr);
+    increment(BranchCache::NotTakenOffset());
+    __ B(codegen_->GetLabelOf(false_successor));
+    __ Bind(&taken);
+    increment(BranchCache::TakenOffset());
+    if (true_target != nullptr) {
+      __ B(true_target);
+    }
+    return;
+  }
   GenerateTestAndBranch(if_instr, /* condition_input_index= */ 0, true_target, false_target);
 }
 
@@ -3370,13 +3399,19 @@ void CodeGeneratorARMVIXL::MaybeGenerateInlineCacheCheck(HInstruction* instructi
       InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
       uint32_t address = reinterpret_cast32<uint32_t>(cache);
       vixl32::Label done;
+      vixl32::Label update;
       UseScratchRegisterScope temps(GetVIXLAssembler());
       temps.Exclude(ip);
       __ Mov(r4, address);
       __ Ldr(ip, MemOperand(r4, InlineCache::ClassesOffset().Int32Value()));
-      // Fast path for a monomorphic cache.
+      // Fast path for a monomorphic cache, which only needs to count the receiver.
       __ Cmp(klass, ip);
-      __ B(eq, &done, /* is_far_target= */ false);
+      __ B(ne, &update, /* is_far_target= */ false);
+      __ Ldr(ip, MemOperand(r4, InlineCache::CountsOffset().Int32Value()));
+      __ Add(ip, ip, 1);
+      __ Str(ip, MemOperand(r4, InlineCache::CountsOffset().Int32Value()));
+      __ B(&done);
+      __ Bind(&update);
       InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
       __ Bind(&done);
     }
@@ -9358,6 +9393,7 @@ void CodeGeneratorARMVIXL::EmitThunkCode(const linker::LinkerPatch& patch,
       break;
     }
     case linker::LinkerPatch::Type::kCallEntrypoint: {
+      DCHECK_EQ(patch.EntrypointArguments(), 0u);
       assembler.LoadFromOffset(arm::kLoadWord, vixl32::pc, tr, patch.EntrypointOffset());
       assembler.GetVIXLAssembler()->Bkpt(0);
       if (GetCompilerOptions().GenerateAnyDebugInfo()) {
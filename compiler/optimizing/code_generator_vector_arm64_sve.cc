@@ -27,30 +27,74 @@ namespace arm64 {
 
 using helpers::ARM64EncodableConstantOrRegister;
 using helpers::Arm64CanEncodeConstantAsImmediate;
-using helpers::DRegisterFrom;
-using helpers::HeapOperand;
-using helpers::InputRegisterAt;
 using helpers::Int64FromLocation;
+using helpers::InputRegisterAt;
 using helpers::LocationFrom;
 using helpers::OutputRegister;
+using helpers::PRegisterFrom;
 using helpers::QRegisterFrom;
 using helpers::StackOperandFrom;
-using helpers::VRegisterFrom;
 using helpers::XRegisterFrom;
+using helpers::ZRegisterFrom;
 
 #define __ GetVIXLAssembler()->
 
-// Build-time switch for Armv8.4-a dot product instructions.
-// TODO: Enable dot product when there is a device to test it on.
-static constexpr bool kArm64EmitDotProdInstructions = false;
+// All the instructions of a vector loop are governed by the loop predicate, which is set by
+// HVecPredWhile in the loop header. Predicate registers are not allocated: the loop predicate
+// is defined in a fixed one, which its users take as their governing predicate input. It is
+// only live between the header and the end of the loop body, which contain no calls.
+static inline const PRegister LoopPReg() {
+  return p0;
+}
 
-// Returns whether dot product instructions should be emitted.
-static bool ShouldEmitDotProductInstructions(const CodeGeneratorARM64* codegen_) {
-  return kArm64EmitDotProdInstructions && codegen_->GetInstructionSetFeatures().HasDotProd();
+// Predicate with the elements of a vector of the fixed vector length set, see VisitVecPredWhile.
+// It is a scratch register of HVecPredWhile.
+static inline const PRegister VectorLengthPReg() {
+  return p1;
+}
+
+// Sets the location of the governing predicate of a vector operation. A loop predicate is
+// taken in the predicate register defined by HVecPredWhile; an all-true predicate only
+// governs unpredicated code and has no location.
+static void SetGoverningPredicateLocation(HVecOperation* instruction) {
+  DCHECK(instruction->IsPredicated());
+  LocationSummary* locations = instruction->GetLocations();
+  HVecPredSetOperation* predicate = instruction->GetGoverningPredicate();
+  locations->SetInAt(instruction->InputCount() - 1u, predicate->GetLocations()->Out());
+}
+
+// Returns the governing predicate register of a vector operation in a vector loop.
+static inline const PRegister GoverningPRegisterFrom(HVecOperation* instruction) {
+  DCHECK(instruction->GetGoverningPredicate()->IsVecPredWhile());
+  return PRegisterFrom(instruction->GetLocations()->InAt(instruction->InputCount() - 1u));
+}
+
+// Returns whether nothing in the loop of `loop_predicate` can call. The loop predicate is not
+// allocated, so it is neither saved by slow paths nor preserved across calls. The suspend check
+// is emitted on the back edge, after the last use of the loop predicate.
+static bool PredicatedLoopHasNoCalls(HVecPredWhile* loop_predicate) {
+  HLoopInformation* loop_info = loop_predicate->GetBlock()->GetLoopInformation();
+  DCHECK(loop_info != nullptr);
+  for (HBlocksInLoopIterator block_it(*loop_info); !block_it.Done(); block_it.Advance()) {
+    for (HInstructionIterator it(block_it.Current()->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      LocationSummary* locations = instruction->GetLocations();
+      if (!instruction->IsSuspendCheck() && locations != nullptr && locations->CanCall()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool InstructionCodeGeneratorARM64Sve::ValidateVectorLength(HVecOperation* instr) const {
+  return DataType::Size(instr->GetPackedType()) * instr->GetVectorLength() ==
+      codegen_->GetSIMDRegisterWidth();
 }
 
 void LocationsBuilderARM64Sve::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  SetGoverningPredicateLocation(instruction);
   HInstruction* input = instruction->InputAt(0);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
@@ -81,59 +125,57 @@ void LocationsBuilderARM64Sve::VisitVecReplicateScalar(HVecReplicateScalar* inst
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
   Location src_loc = locations->InAt(0);
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  // The governing predicate is all true (see HLoopOptimization::GenerateVecInv), and the
+  // unpredicated DUP is used.
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
       if (src_loc.IsConstant()) {
-        __ Movi(dst.V16B(), Int64FromLocation(src_loc));
+        __ Dup(dst.VnB(), Int64FromLocation(src_loc));
       } else {
-        __ Dup(dst.V16B(), InputRegisterAt(instruction, 0));
+        __ Dup(dst.VnB(), InputRegisterAt(instruction, 0));
       }
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
       if (src_loc.IsConstant()) {
-        __ Movi(dst.V8H(), Int64FromLocation(src_loc));
+        __ Dup(dst.VnH(), Int64FromLocation(src_loc));
       } else {
-        __ Dup(dst.V8H(), InputRegisterAt(instruction, 0));
+        __ Dup(dst.VnH(), InputRegisterAt(instruction, 0));
       }
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       if (src_loc.IsConstant()) {
-        __ Movi(dst.V4S(), Int64FromLocation(src_loc));
+        __ Dup(dst.VnS(), Int64FromLocation(src_loc));
       } else {
-        __ Dup(dst.V4S(), InputRegisterAt(instruction, 0));
+        __ Dup(dst.VnS(), InputRegisterAt(instruction, 0));
       }
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
       if (src_loc.IsConstant()) {
-        __ Movi(dst.V2D(), Int64FromLocation(src_loc));
+        __ Dup(dst.VnD(), Int64FromLocation(src_loc));
       } else {
-        __ Dup(dst.V2D(), XRegisterFrom(src_loc));
+        __ Dup(dst.VnD(), XRegisterFrom(src_loc));
       }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       if (src_loc.IsConstant()) {
-        __ Fmov(dst.V4S(), src_loc.GetConstant()->AsFloatConstant()->GetValue());
+        __ Fdup(dst.VnS(), src_loc.GetConstant()->AsFloatConstant()->GetValue());
       } else {
-        __ Dup(dst.V4S(), VRegisterFrom(src_loc).V4S(), 0);
+        __ Dup(dst.VnS(), ZRegisterFrom(src_loc).VnS(), 0);
       }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
       if (src_loc.IsConstant()) {
-        __ Fmov(dst.V2D(), src_loc.GetConstant()->AsDoubleConstant()->GetValue());
+        __ Fdup(dst.VnD(), src_loc.GetConstant()->AsDoubleConstant()->GetValue());
       } else {
-        __ Dup(dst.V2D(), VRegisterFrom(src_loc).V2D(), 0);
+        __ Dup(dst.VnD(), ZRegisterFrom(src_loc).VnD(), 0);
       }
       break;
     default:
@@ -142,64 +184,25 @@ void InstructionCodeGeneratorARM64Sve::VisitVecReplicateScalar(HVecReplicateScal
   }
 }
 
+// Reductions, and the idioms below that have no direct SVE equivalent, are not vectorized in
+// predicated mode (see HLoopOptimization::TrySetVectorTypeArm64Sve).
+
 void LocationsBuilderARM64Sve::VisitVecExtractScalar(HVecExtractScalar* instruction) {
-  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
-  switch (instruction->GetPackedType()) {
-    case DataType::Type::kBool:
-    case DataType::Type::kUint8:
-    case DataType::Type::kInt8:
-    case DataType::Type::kUint16:
-    case DataType::Type::kInt16:
-    case DataType::Type::kInt32:
-    case DataType::Type::kInt64:
-      locations->SetInAt(0, Location::RequiresFpuRegister());
-      locations->SetOut(Location::RequiresRegister());
-      break;
-    case DataType::Type::kFloat32:
-    case DataType::Type::kFloat64:
-      locations->SetInAt(0, Location::RequiresFpuRegister());
-      locations->SetOut(Location::SameAsFirstInput());
-      break;
-    default:
-      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-      UNREACHABLE();
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecExtractScalar(HVecExtractScalar* instruction) {
-  LocationSummary* locations = instruction->GetLocations();
-  VRegister src = VRegisterFrom(locations->InAt(0));
-  switch (instruction->GetPackedType()) {
-    case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Umov(OutputRegister(instruction), src.V4S(), 0);
-      break;
-    case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Umov(OutputRegister(instruction), src.V2D(), 0);
-      break;
-    case DataType::Type::kFloat32:
-    case DataType::Type::kFloat64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 4u);
-      DCHECK(locations->InAt(0).Equals(locations->Out()));  // no code required
-      break;
-    default:
-      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-      UNREACHABLE();
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 // Helper to set up locations for vector unary operations.
 static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation* instruction) {
   LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  SetGoverningPredicateLocation(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
-      locations->SetInAt(0, Location::RequiresFpuRegister());
-      locations->SetOut(Location::RequiresFpuRegister(),
-                        instruction->IsVecNot() ? Location::kOutputOverlap
-                                                : Location::kNoOutputOverlap);
-      break;
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
     case DataType::Type::kUint16:
@@ -218,43 +221,13 @@ static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation
 }
 
 void LocationsBuilderARM64Sve::VisitVecReduce(HVecReduce* instruction) {
-  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecReduce(HVecReduce* instruction) {
-  LocationSummary* locations = instruction->GetLocations();
-  VRegister src = VRegisterFrom(locations->InAt(0));
-  VRegister dst = DRegisterFrom(locations->Out());
-  switch (instruction->GetPackedType()) {
-    case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      switch (instruction->GetReductionKind()) {
-        case HVecReduce::kSum:
-          __ Addv(dst.S(), src.V4S());
-          break;
-        case HVecReduce::kMin:
-          __ Sminv(dst.S(), src.V4S());
-          break;
-        case HVecReduce::kMax:
-          __ Smaxv(dst.S(), src.V4S());
-          break;
-      }
-      break;
-    case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      switch (instruction->GetReductionKind()) {
-        case HVecReduce::kSum:
-          __ Addp(dst.D(), src.V2D());
-          break;
-        default:
-          LOG(FATAL) << "Unsupported SIMD min/max";
-          UNREACHABLE();
-      }
-      break;
-    default:
-      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-      UNREACHABLE();
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 void LocationsBuilderARM64Sve::VisitVecCnv(HVecCnv* instruction) {
@@ -262,14 +235,16 @@ void LocationsBuilderARM64Sve::VisitVecCnv(HVecCnv* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecCnv(HVecCnv* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister src = VRegisterFrom(locations->InAt(0));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister src = ZRegisterFrom(locations->InAt(0));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   DataType::Type from = instruction->GetInputType();
   DataType::Type to = instruction->GetResultType();
   if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
-    DCHECK_EQ(4u, instruction->GetVectorLength());
-    __ Scvtf(dst.V4S(), src.V4S());
+    __ Scvtf(dst.VnS(), p_reg, src.VnS());
   } else {
     LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
   }
@@ -280,35 +255,32 @@ void LocationsBuilderARM64Sve::VisitVecNeg(HVecNeg* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecNeg(HVecNeg* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister src = VRegisterFrom(locations->InAt(0));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister src = ZRegisterFrom(locations->InAt(0));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Neg(dst.V16B(), src.V16B());
+      __ Neg(dst.VnB(), p_reg, src.VnB());
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Neg(dst.V8H(), src.V8H());
+      __ Neg(dst.VnH(), p_reg, src.VnH());
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Neg(dst.V4S(), src.V4S());
+      __ Neg(dst.VnS(), p_reg, src.VnS());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Neg(dst.V2D(), src.V2D());
+      __ Neg(dst.VnD(), p_reg, src.VnD());
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Fneg(dst.V4S(), src.V4S());
+      __ Fneg(dst.VnS(), p_reg, src.VnS());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Fneg(dst.V2D(), src.V2D());
+      __ Fneg(dst.VnD(), p_reg, src.VnD());
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -321,33 +293,30 @@ void LocationsBuilderARM64Sve::VisitVecAbs(HVecAbs* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecAbs(HVecAbs* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister src = VRegisterFrom(locations->InAt(0));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister src = ZRegisterFrom(locations->InAt(0));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Abs(dst.V16B(), src.V16B());
+      __ Abs(dst.VnB(), p_reg, src.VnB());
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Abs(dst.V8H(), src.V8H());
+      __ Abs(dst.VnH(), p_reg, src.VnH());
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Abs(dst.V4S(), src.V4S());
+      __ Abs(dst.VnS(), p_reg, src.VnS());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Abs(dst.V2D(), src.V2D());
+      __ Abs(dst.VnD(), p_reg, src.VnD());
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Fabs(dst.V4S(), src.V4S());
+      __ Fabs(dst.VnS(), p_reg, src.VnS());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Fabs(dst.V2D(), src.V2D());
+      __ Fabs(dst.VnD(), p_reg, src.VnD());
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -360,22 +329,29 @@ void LocationsBuilderARM64Sve::VisitVecNot(HVecNot* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecNot(HVecNot* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister src = VRegisterFrom(locations->InAt(0));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister src = ZRegisterFrom(locations->InAt(0));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:  // special case boolean-not
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Movi(dst.V16B(), 1);
-      __ Eor(dst.V16B(), dst.V16B(), src.V16B());
+      __ Eor(dst.VnB(), src.VnB(), 1);
       break;
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
+      __ Not(dst.VnB(), p_reg, src.VnB());
+      break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
+      __ Not(dst.VnH(), p_reg, src.VnH());
+      break;
     case DataType::Type::kInt32:
+      __ Not(dst.VnS(), p_reg, src.VnS());
+      break;
     case DataType::Type::kInt64:
-      __ Not(dst.V16B(), src.V16B());  // lanes do not matter
+      __ Not(dst.VnD(), p_reg, src.VnD());
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -386,6 +362,7 @@ void InstructionCodeGeneratorARM64Sve::VisitVecNot(HVecNot* instruction) {
 // Helper to set up locations for vector binary operations.
 static void CreateVecBinOpLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
   LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  SetGoverningPredicateLocation(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -411,36 +388,33 @@ void LocationsBuilderARM64Sve::VisitVecAdd(HVecAdd* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecAdd(HVecAdd* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Add(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Add(dst.VnB(), p_reg, lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Add(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Add(dst.VnH(), p_reg, lhs.VnH(), rhs.VnH());
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Add(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Add(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Add(dst.V2D(), lhs.V2D(), rhs.V2D());
+      __ Add(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD());
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Fadd(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Fadd(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS(), StrictNaNPropagation);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Fadd(dst.V2D(), lhs.V2D(), rhs.V2D());
+      __ Fadd(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD(), StrictNaNPropagation);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -453,26 +427,25 @@ void LocationsBuilderARM64Sve::VisitVecSaturationAdd(HVecSaturationAdd* instruct
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  // SVE only has unpredicated saturating additions; the inactive elements are never stored.
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Uqadd(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Uqadd(dst.VnB(), lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Sqadd(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Sqadd(dst.VnB(), lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Uqadd(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Uqadd(dst.VnH(), lhs.VnH(), rhs.VnH());
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Sqadd(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Sqadd(dst.VnH(), lhs.VnH(), rhs.VnH());
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -481,43 +454,13 @@ void InstructionCodeGeneratorARM64Sve::VisitVecSaturationAdd(HVecSaturationAdd*
 }
 
 void LocationsBuilderARM64Sve::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
-  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
-  LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
-  switch (instruction->GetPackedType()) {
-    case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      instruction->IsRounded()
-          ? __ Urhadd(dst.V16B(), lhs.V16B(), rhs.V16B())
-          : __ Uhadd(dst.V16B(), lhs.V16B(), rhs.V16B());
-      break;
-    case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      instruction->IsRounded()
-          ? __ Srhadd(dst.V16B(), lhs.V16B(), rhs.V16B())
-          : __ Shadd(dst.V16B(), lhs.V16B(), rhs.V16B());
-      break;
-    case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      instruction->IsRounded()
-          ? __ Urhadd(dst.V8H(), lhs.V8H(), rhs.V8H())
-          : __ Uhadd(dst.V8H(), lhs.V8H(), rhs.V8H());
-      break;
-    case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      instruction->IsRounded()
-          ? __ Srhadd(dst.V8H(), lhs.V8H(), rhs.V8H())
-          : __ Shadd(dst.V8H(), lhs.V8H(), rhs.V8H());
-      break;
-    default:
-      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-      UNREACHABLE();
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 void LocationsBuilderARM64Sve::VisitVecSub(HVecSub* instruction) {
@@ -525,36 +468,33 @@ void LocationsBuilderARM64Sve::VisitVecSub(HVecSub* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecSub(HVecSub* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Sub(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Sub(dst.VnB(), p_reg, lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Sub(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Sub(dst.VnH(), p_reg, lhs.VnH(), rhs.VnH());
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Sub(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Sub(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Sub(dst.V2D(), lhs.V2D(), rhs.V2D());
+      __ Sub(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD());
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Fsub(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Fsub(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Fsub(dst.V2D(), lhs.V2D(), rhs.V2D());
+      __ Fsub(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD());
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -567,26 +507,25 @@ void LocationsBuilderARM64Sve::VisitVecSaturationSub(HVecSaturationSub* instruct
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  // SVE only has unpredicated saturating subtractions; the inactive elements are never stored.
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Uqsub(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Uqsub(dst.VnB(), lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Sqsub(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Sqsub(dst.VnB(), lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Uqsub(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Uqsub(dst.VnH(), lhs.VnH(), rhs.VnH());
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Sqsub(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Sqsub(dst.VnH(), lhs.VnH(), rhs.VnH());
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -599,32 +538,33 @@ void LocationsBuilderARM64Sve::VisitVecMul(HVecMul* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecMul(HVecMul* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Mul(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Mul(dst.VnB(), p_reg, lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Mul(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Mul(dst.VnH(), p_reg, lhs.VnH(), rhs.VnH());
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Mul(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Mul(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
+      break;
+    case DataType::Type::kInt64:
+      __ Mul(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD());
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Fmul(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Fmul(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS(), StrictNaNPropagation);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Fmul(dst.V2D(), lhs.V2D(), rhs.V2D());
+      __ Fmul(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD(), StrictNaNPropagation);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -637,18 +577,19 @@ void LocationsBuilderARM64Sve::VisitVecDiv(HVecDiv* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecDiv(HVecDiv* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Fdiv(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Fdiv(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Fdiv(dst.V2D(), lhs.V2D(), rhs.V2D());
+      __ Fdiv(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD());
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -661,42 +602,40 @@ void LocationsBuilderARM64Sve::VisitVecMin(HVecMin* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecMin(HVecMin* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Umin(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Umin(dst.VnB(), p_reg, lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Smin(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Smin(dst.VnB(), p_reg, lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Umin(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Umin(dst.VnH(), p_reg, lhs.VnH(), rhs.VnH());
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Smin(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Smin(dst.VnH(), p_reg, lhs.VnH(), rhs.VnH());
       break;
     case DataType::Type::kUint32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Umin(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Umin(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Smin(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Smin(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
+      break;
+    case DataType::Type::kInt64:
+      __ Smin(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD());
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Fmin(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Fmin(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS(), StrictNaNPropagation);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Fmin(dst.V2D(), lhs.V2D(), rhs.V2D());
+      __ Fmin(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD(), StrictNaNPropagation);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -709,42 +648,40 @@ void LocationsBuilderARM64Sve::VisitVecMax(HVecMax* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecMax(HVecMax* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Umax(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Umax(dst.VnB(), p_reg, lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Smax(dst.V16B(), lhs.V16B(), rhs.V16B());
+      __ Smax(dst.VnB(), p_reg, lhs.VnB(), rhs.VnB());
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Umax(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Umax(dst.VnH(), p_reg, lhs.VnH(), rhs.VnH());
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Smax(dst.V8H(), lhs.V8H(), rhs.V8H());
+      __ Smax(dst.VnH(), p_reg, lhs.VnH(), rhs.VnH());
       break;
     case DataType::Type::kUint32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Umax(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Umax(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Smax(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Smax(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
+      break;
+    case DataType::Type::kInt64:
+      __ Smax(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD());
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Fmax(dst.V4S(), lhs.V4S(), rhs.V4S());
+      __ Fmax(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS(), StrictNaNPropagation);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Fmax(dst.V2D(), lhs.V2D(), rhs.V2D());
+      __ Fmax(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD(), StrictNaNPropagation);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -758,10 +695,12 @@ void LocationsBuilderARM64Sve::VisitVecAnd(HVecAnd* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecAnd(HVecAnd* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -772,7 +711,7 @@ void InstructionCodeGeneratorARM64Sve::VisitVecAnd(HVecAnd* instruction) {
     case DataType::Type::kInt64:
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
-      __ And(dst.V16B(), lhs.V16B(), rhs.V16B());  // lanes do not matter
+      __ And(dst.VnD(), lhs.VnD(), rhs.VnD());  // lanes do not matter
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -794,10 +733,12 @@ void LocationsBuilderARM64Sve::VisitVecOr(HVecOr* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecOr(HVecOr* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -808,7 +749,7 @@ void InstructionCodeGeneratorARM64Sve::VisitVecOr(HVecOr* instruction) {
     case DataType::Type::kInt64:
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
-      __ Orr(dst.V16B(), lhs.V16B(), rhs.V16B());  // lanes do not matter
+      __ Orr(dst.VnD(), lhs.VnD(), rhs.VnD());  // lanes do not matter
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -821,10 +762,12 @@ void LocationsBuilderARM64Sve::VisitVecXor(HVecXor* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecXor(HVecXor* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister rhs = VRegisterFrom(locations->InAt(1));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -835,7 +778,7 @@ void InstructionCodeGeneratorARM64Sve::VisitVecXor(HVecXor* instruction) {
     case DataType::Type::kInt64:
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
-      __ Eor(dst.V16B(), lhs.V16B(), rhs.V16B());  // lanes do not matter
+      __ Eor(dst.VnD(), lhs.VnD(), rhs.VnD());  // lanes do not matter
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -846,6 +789,7 @@ void InstructionCodeGeneratorARM64Sve::VisitVecXor(HVecXor* instruction) {
 // Helper to set up locations for vector shift operations.
 static void CreateVecShiftLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
   LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  SetGoverningPredicateLocation(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -868,28 +812,27 @@ void LocationsBuilderARM64Sve::VisitVecShl(HVecShl* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecShl(HVecShl* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Shl(dst.V16B(), lhs.V16B(), value);
+      __ Lsl(dst.VnB(), p_reg, lhs.VnB(), value);
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Shl(dst.V8H(), lhs.V8H(), value);
+      __ Lsl(dst.VnH(), p_reg, lhs.VnH(), value);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Shl(dst.V4S(), lhs.V4S(), value);
+      __ Lsl(dst.VnS(), p_reg, lhs.VnS(), value);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Shl(dst.V2D(), lhs.V2D(), value);
+      __ Lsl(dst.VnD(), p_reg, lhs.VnD(), value);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -902,28 +845,27 @@ void LocationsBuilderARM64Sve::VisitVecShr(HVecShr* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecShr(HVecShr* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Sshr(dst.V16B(), lhs.V16B(), value);
+      __ Asr(dst.VnB(), p_reg, lhs.VnB(), value);
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Sshr(dst.V8H(), lhs.V8H(), value);
+      __ Asr(dst.VnH(), p_reg, lhs.VnH(), value);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Sshr(dst.V4S(), lhs.V4S(), value);
+      __ Asr(dst.VnS(), p_reg, lhs.VnS(), value);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Sshr(dst.V2D(), lhs.V2D(), value);
+      __ Asr(dst.VnD(), p_reg, lhs.VnD(), value);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -936,28 +878,27 @@ void LocationsBuilderARM64Sve::VisitVecUShr(HVecUShr* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecUShr(HVecUShr* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister lhs = VRegisterFrom(locations->InAt(0));
-  VRegister dst = VRegisterFrom(locations->Out());
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Ushr(dst.V16B(), lhs.V16B(), value);
+      __ Lsr(dst.VnB(), p_reg, lhs.VnB(), value);
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Ushr(dst.V8H(), lhs.V8H(), value);
+      __ Lsr(dst.VnH(), p_reg, lhs.VnH(), value);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Ushr(dst.V4S(), lhs.V4S(), value);
+      __ Lsr(dst.VnS(), p_reg, lhs.VnS(), value);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Ushr(dst.V2D(), lhs.V2D(), value);
+      __ Lsr(dst.VnD(), p_reg, lhs.VnD(), value);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -966,81 +907,19 @@ void InstructionCodeGeneratorARM64Sve::VisitVecUShr(HVecUShr* instruction) {
 }
 
 void LocationsBuilderARM64Sve::VisitVecSetScalars(HVecSetScalars* instruction) {
-  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
-
-  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
-
-  HInstruction* input = instruction->InputAt(0);
-  bool is_zero = IsZeroBitPattern(input);
-
-  switch (instruction->GetPackedType()) {
-    case DataType::Type::kBool:
-    case DataType::Type::kUint8:
-    case DataType::Type::kInt8:
-    case DataType::Type::kUint16:
-    case DataType::Type::kInt16:
-    case DataType::Type::kInt32:
-    case DataType::Type::kInt64:
-      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input->AsConstant())
-                                    : Location::RequiresRegister());
-      locations->SetOut(Location::RequiresFpuRegister());
-      break;
-    case DataType::Type::kFloat32:
-    case DataType::Type::kFloat64:
-      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input->AsConstant())
-                                    : Location::RequiresFpuRegister());
-      locations->SetOut(Location::RequiresFpuRegister());
-      break;
-    default:
-      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-      UNREACHABLE();
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecSetScalars(HVecSetScalars* instruction) {
-  LocationSummary* locations = instruction->GetLocations();
-  VRegister dst = VRegisterFrom(locations->Out());
-
-  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
-
-  // Zero out all other elements first.
-  __ Movi(dst.V16B(), 0);
-
-  // Shorthand for any type of zero.
-  if (IsZeroBitPattern(instruction->InputAt(0))) {
-    return;
-  }
-
-  // Set required elements.
-  switch (instruction->GetPackedType()) {
-    case DataType::Type::kBool:
-    case DataType::Type::kUint8:
-    case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ Mov(dst.V16B(), 0, InputRegisterAt(instruction, 0));
-      break;
-    case DataType::Type::kUint16:
-    case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ Mov(dst.V8H(), 0, InputRegisterAt(instruction, 0));
-      break;
-    case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ Mov(dst.V4S(), 0, InputRegisterAt(instruction, 0));
-      break;
-    case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ Mov(dst.V2D(), 0, InputRegisterAt(instruction, 0));
-      break;
-    default:
-      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-      UNREACHABLE();
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 // Helper to set up locations for vector accumulations.
 static void CreateVecAccumLocations(ArenaAllocator* allocator, HVecOperation* instruction) {
   LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  SetGoverningPredicateLocation(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -1063,42 +942,39 @@ void LocationsBuilderARM64Sve::VisitVecMultiplyAccumulate(HVecMultiplyAccumulate
   CreateVecAccumLocations(GetGraph()->GetAllocator(), instruction);
 }
 
-// Some early revisions of the Cortex-A53 have an erratum (835769) whereby it is possible for a
-// 64-bit scalar multiply-accumulate instruction in AArch64 state to generate an incorrect result.
-// However vector MultiplyAccumulate instruction is not affected.
 void InstructionCodeGeneratorARM64Sve::VisitVecMultiplyAccumulate(HVecMultiplyAccumulate* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
-  VRegister acc = VRegisterFrom(locations->InAt(0));
-  VRegister left = VRegisterFrom(locations->InAt(1));
-  VRegister right = VRegisterFrom(locations->InAt(2));
+  const ZRegister acc = ZRegisterFrom(locations->InAt(0));
+  const ZRegister left = ZRegisterFrom(locations->InAt(1));
+  const ZRegister right = ZRegisterFrom(locations->InAt(2));
+  const PRegisterM p_reg = GoverningPRegisterFrom(instruction).Merging();
 
   DCHECK(locations->InAt(0).Equals(locations->Out()));
 
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
       if (instruction->GetOpKind() == HInstruction::kAdd) {
-        __ Mla(acc.V16B(), left.V16B(), right.V16B());
+        __ Mla(acc.VnB(), p_reg, acc.VnB(), left.VnB(), right.VnB());
       } else {
-        __ Mls(acc.V16B(), left.V16B(), right.V16B());
+        __ Mls(acc.VnB(), p_reg, acc.VnB(), left.VnB(), right.VnB());
       }
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
       if (instruction->GetOpKind() == HInstruction::kAdd) {
-        __ Mla(acc.V8H(), left.V8H(), right.V8H());
+        __ Mla(acc.VnH(), p_reg, acc.VnH(), left.VnH(), right.VnH());
       } else {
-        __ Mls(acc.V8H(), left.V8H(), right.V8H());
+        __ Mls(acc.VnH(), p_reg, acc.VnH(), left.VnH(), right.VnH());
       }
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       if (instruction->GetOpKind() == HInstruction::kAdd) {
-        __ Mla(acc.V4S(), left.V4S(), right.V4S());
+        __ Mla(acc.VnS(), p_reg, acc.VnS(), left.VnS(), right.VnS());
       } else {
-        __ Mls(acc.V4S(), left.V4S(), right.V4S());
+        __ Mls(acc.VnS(), p_reg, acc.VnS(), left.VnS(), right.VnS());
       }
       break;
     default:
@@ -1108,261 +984,23 @@ void InstructionCodeGeneratorARM64Sve::VisitVecMultiplyAccumulate(HVecMultiplyAc
 }
 
 void LocationsBuilderARM64Sve::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
-  CreateVecAccumLocations(GetGraph()->GetAllocator(), instruction);
-  // Some conversions require temporary registers.
-  LocationSummary* locations = instruction->GetLocations();
-  HVecOperation* a = instruction->InputAt(1)->AsVecOperation();
-  HVecOperation* b = instruction->InputAt(2)->AsVecOperation();
-  DCHECK_EQ(HVecOperation::ToSignedType(a->GetPackedType()),
-            HVecOperation::ToSignedType(b->GetPackedType()));
-  switch (a->GetPackedType()) {
-    case DataType::Type::kUint8:
-    case DataType::Type::kInt8:
-      switch (instruction->GetPackedType()) {
-        case DataType::Type::kInt64:
-          locations->AddTemp(Location::RequiresFpuRegister());
-          locations->AddTemp(Location::RequiresFpuRegister());
-          FALLTHROUGH_INTENDED;
-        case DataType::Type::kInt32:
-          locations->AddTemp(Location::RequiresFpuRegister());
-          locations->AddTemp(Location::RequiresFpuRegister());
-          break;
-        default:
-          break;
-      }
-      break;
-    case DataType::Type::kUint16:
-    case DataType::Type::kInt16:
-      if (instruction->GetPackedType() == DataType::Type::kInt64) {
-        locations->AddTemp(Location::RequiresFpuRegister());
-        locations->AddTemp(Location::RequiresFpuRegister());
-      }
-      break;
-    case DataType::Type::kInt32:
-    case DataType::Type::kInt64:
-      if (instruction->GetPackedType() == a->GetPackedType()) {
-        locations->AddTemp(Location::RequiresFpuRegister());
-      }
-      break;
-    default:
-      break;
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
-  LocationSummary* locations = instruction->GetLocations();
-  VRegister acc = VRegisterFrom(locations->InAt(0));
-  VRegister left = VRegisterFrom(locations->InAt(1));
-  VRegister right = VRegisterFrom(locations->InAt(2));
-
-  DCHECK(locations->InAt(0).Equals(locations->Out()));
-
-  // Handle all feasible acc_T += sad(a_S, b_S) type combinations (T x S).
-  HVecOperation* a = instruction->InputAt(1)->AsVecOperation();
-  HVecOperation* b = instruction->InputAt(2)->AsVecOperation();
-  DCHECK_EQ(HVecOperation::ToSignedType(a->GetPackedType()),
-            HVecOperation::ToSignedType(b->GetPackedType()));
-  switch (a->GetPackedType()) {
-    case DataType::Type::kUint8:
-    case DataType::Type::kInt8:
-      DCHECK_EQ(16u, a->GetVectorLength());
-      switch (instruction->GetPackedType()) {
-        case DataType::Type::kInt16:
-          DCHECK_EQ(8u, instruction->GetVectorLength());
-          __ Sabal(acc.V8H(), left.V8B(), right.V8B());
-          __ Sabal2(acc.V8H(), left.V16B(), right.V16B());
-          break;
-        case DataType::Type::kInt32: {
-          DCHECK_EQ(4u, instruction->GetVectorLength());
-          VRegister tmp1 = VRegisterFrom(locations->GetTemp(0));
-          VRegister tmp2 = VRegisterFrom(locations->GetTemp(1));
-          __ Sxtl(tmp1.V8H(), left.V8B());
-          __ Sxtl(tmp2.V8H(), right.V8B());
-          __ Sabal(acc.V4S(), tmp1.V4H(), tmp2.V4H());
-          __ Sabal2(acc.V4S(), tmp1.V8H(), tmp2.V8H());
-          __ Sxtl2(tmp1.V8H(), left.V16B());
-          __ Sxtl2(tmp2.V8H(), right.V16B());
-          __ Sabal(acc.V4S(), tmp1.V4H(), tmp2.V4H());
-          __ Sabal2(acc.V4S(), tmp1.V8H(), tmp2.V8H());
-          break;
-        }
-        case DataType::Type::kInt64: {
-          DCHECK_EQ(2u, instruction->GetVectorLength());
-          VRegister tmp1 = VRegisterFrom(locations->GetTemp(0));
-          VRegister tmp2 = VRegisterFrom(locations->GetTemp(1));
-          VRegister tmp3 = VRegisterFrom(locations->GetTemp(2));
-          VRegister tmp4 = VRegisterFrom(locations->GetTemp(3));
-          __ Sxtl(tmp1.V8H(), left.V8B());
-          __ Sxtl(tmp2.V8H(), right.V8B());
-          __ Sxtl(tmp3.V4S(), tmp1.V4H());
-          __ Sxtl(tmp4.V4S(), tmp2.V4H());
-          __ Sabal(acc.V2D(), tmp3.V2S(), tmp4.V2S());
-          __ Sabal2(acc.V2D(), tmp3.V4S(), tmp4.V4S());
-          __ Sxtl2(tmp3.V4S(), tmp1.V8H());
-          __ Sxtl2(tmp4.V4S(), tmp2.V8H());
-          __ Sabal(acc.V2D(), tmp3.V2S(), tmp4.V2S());
-          __ Sabal2(acc.V2D(), tmp3.V4S(), tmp4.V4S());
-          __ Sxtl2(tmp1.V8H(), left.V16B());
-          __ Sxtl2(tmp2.V8H(), right.V16B());
-          __ Sxtl(tmp3.V4S(), tmp1.V4H());
-          __ Sxtl(tmp4.V4S(), tmp2.V4H());
-          __ Sabal(acc.V2D(), tmp3.V2S(), tmp4.V2S());
-          __ Sabal2(acc.V2D(), tmp3.V4S(), tmp4.V4S());
-          __ Sxtl2(tmp3.V4S(), tmp1.V8H());
-          __ Sxtl2(tmp4.V4S(), tmp2.V8H());
-          __ Sabal(acc.V2D(), tmp3.V2S(), tmp4.V2S());
-          __ Sabal2(acc.V2D(), tmp3.V4S(), tmp4.V4S());
-          break;
-        }
-        default:
-          LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-          UNREACHABLE();
-      }
-      break;
-    case DataType::Type::kUint16:
-    case DataType::Type::kInt16:
-      DCHECK_EQ(8u, a->GetVectorLength());
-      switch (instruction->GetPackedType()) {
-        case DataType::Type::kInt32:
-          DCHECK_EQ(4u, instruction->GetVectorLength());
-          __ Sabal(acc.V4S(), left.V4H(), right.V4H());
-          __ Sabal2(acc.V4S(), left.V8H(), right.V8H());
-          break;
-        case DataType::Type::kInt64: {
-          DCHECK_EQ(2u, instruction->GetVectorLength());
-          VRegister tmp1 = VRegisterFrom(locations->GetTemp(0));
-          VRegister tmp2 = VRegisterFrom(locations->GetTemp(1));
-          __ Sxtl(tmp1.V4S(), left.V4H());
-          __ Sxtl(tmp2.V4S(), right.V4H());
-          __ Sabal(acc.V2D(), tmp1.V2S(), tmp2.V2S());
-          __ Sabal2(acc.V2D(), tmp1.V4S(), tmp2.V4S());
-          __ Sxtl2(tmp1.V4S(), left.V8H());
-          __ Sxtl2(tmp2.V4S(), right.V8H());
-          __ Sabal(acc.V2D(), tmp1.V2S(), tmp2.V2S());
-          __ Sabal2(acc.V2D(), tmp1.V4S(), tmp2.V4S());
-          break;
-        }
-        default:
-          LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-          UNREACHABLE();
-      }
-      break;
-    case DataType::Type::kInt32:
-      DCHECK_EQ(4u, a->GetVectorLength());
-      switch (instruction->GetPackedType()) {
-        case DataType::Type::kInt32: {
-          DCHECK_EQ(4u, instruction->GetVectorLength());
-          VRegister tmp = VRegisterFrom(locations->GetTemp(0));
-          __ Sub(tmp.V4S(), left.V4S(), right.V4S());
-          __ Abs(tmp.V4S(), tmp.V4S());
-          __ Add(acc.V4S(), acc.V4S(), tmp.V4S());
-          break;
-        }
-        case DataType::Type::kInt64:
-          DCHECK_EQ(2u, instruction->GetVectorLength());
-          __ Sabal(acc.V2D(), left.V2S(), right.V2S());
-          __ Sabal2(acc.V2D(), left.V4S(), right.V4S());
-          break;
-        default:
-          LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-          UNREACHABLE();
-      }
-      break;
-    case DataType::Type::kInt64:
-      DCHECK_EQ(2u, a->GetVectorLength());
-      switch (instruction->GetPackedType()) {
-        case DataType::Type::kInt64: {
-          DCHECK_EQ(2u, instruction->GetVectorLength());
-          VRegister tmp = VRegisterFrom(locations->GetTemp(0));
-          __ Sub(tmp.V2D(), left.V2D(), right.V2D());
-          __ Abs(tmp.V2D(), tmp.V2D());
-          __ Add(acc.V2D(), acc.V2D(), tmp.V2D());
-          break;
-        }
-        default:
-          LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-          UNREACHABLE();
-      }
-      break;
-    default:
-      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 void LocationsBuilderARM64Sve::VisitVecDotProd(HVecDotProd* instruction) {
-  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
-  DCHECK(instruction->GetPackedType() == DataType::Type::kInt32);
-  locations->SetInAt(0, Location::RequiresFpuRegister());
-  locations->SetInAt(1, Location::RequiresFpuRegister());
-  locations->SetInAt(2, Location::RequiresFpuRegister());
-  locations->SetOut(Location::SameAsFirstInput());
-
-  // For Int8 and Uint8 general case we need a temp register.
-  if ((DataType::Size(instruction->InputAt(1)->AsVecOperation()->GetPackedType()) == 1) &&
-      !ShouldEmitDotProductInstructions(codegen_)) {
-    locations->AddTemp(Location::RequiresFpuRegister());
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecDotProd(HVecDotProd* instruction) {
-  LocationSummary* locations = instruction->GetLocations();
-  DCHECK(locations->InAt(0).Equals(locations->Out()));
-  VRegister acc = VRegisterFrom(locations->InAt(0));
-  VRegister left = VRegisterFrom(locations->InAt(1));
-  VRegister right = VRegisterFrom(locations->InAt(2));
-  HVecOperation* a = instruction->InputAt(1)->AsVecOperation();
-  HVecOperation* b = instruction->InputAt(2)->AsVecOperation();
-  DCHECK_EQ(HVecOperation::ToSignedType(a->GetPackedType()),
-            HVecOperation::ToSignedType(b->GetPackedType()));
-  DCHECK_EQ(instruction->GetPackedType(), DataType::Type::kInt32);
-  DCHECK_EQ(4u, instruction->GetVectorLength());
-
-  size_t inputs_data_size = DataType::Size(a->GetPackedType());
-  switch (inputs_data_size) {
-    case 1u: {
-      DCHECK_EQ(16u, a->GetVectorLength());
-      if (instruction->IsZeroExtending()) {
-        if (ShouldEmitDotProductInstructions(codegen_)) {
-          __ Udot(acc.V4S(), left.V16B(), right.V16B());
-        } else {
-          VRegister tmp = VRegisterFrom(locations->GetTemp(0));
-          __ Umull(tmp.V8H(), left.V8B(), right.V8B());
-          __ Uaddw(acc.V4S(), acc.V4S(), tmp.V4H());
-          __ Uaddw2(acc.V4S(), acc.V4S(), tmp.V8H());
-
-          __ Umull2(tmp.V8H(), left.V16B(), right.V16B());
-          __ Uaddw(acc.V4S(), acc.V4S(), tmp.V4H());
-          __ Uaddw2(acc.V4S(), acc.V4S(), tmp.V8H());
-        }
-      } else {
-        if (ShouldEmitDotProductInstructions(codegen_)) {
-          __ Sdot(acc.V4S(), left.V16B(), right.V16B());
-        } else {
-          VRegister tmp = VRegisterFrom(locations->GetTemp(0));
-          __ Smull(tmp.V8H(), left.V8B(), right.V8B());
-          __ Saddw(acc.V4S(), acc.V4S(), tmp.V4H());
-          __ Saddw2(acc.V4S(), acc.V4S(), tmp.V8H());
-
-          __ Smull2(tmp.V8H(), left.V16B(), right.V16B());
-          __ Saddw(acc.V4S(), acc.V4S(), tmp.V4H());
-          __ Saddw2(acc.V4S(), acc.V4S(), tmp.V8H());
-        }
-      }
-      break;
-    }
-    case 2u:
-      DCHECK_EQ(8u, a->GetVectorLength());
-      if (instruction->IsZeroExtending()) {
-        __ Umlal(acc.V4S(), left.V4H(), right.V4H());
-        __ Umlal2(acc.V4S(), left.V8H(), right.V8H());
-      } else {
-        __ Smlal(acc.V4S(), left.V4H(), right.V4H());
-        __ Smlal2(acc.V4S(), left.V8H(), right.V8H());
-      }
-      break;
-    default:
-      LOG(FATAL) << "Unsupported SIMD type size: " << inputs_data_size;
-  }
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+  UNREACHABLE();
 }
 
 // Helper to set up locations for vector memory operations.
@@ -1370,6 +1008,7 @@ static void CreateVecMemLocations(ArenaAllocator* allocator,
                                   HVecMemoryOperation* instruction,
                                   bool is_load) {
   LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  SetGoverningPredicateLocation(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -1399,54 +1038,34 @@ void LocationsBuilderARM64Sve::VisitVecLoad(HVecLoad* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecLoad(HVecLoad* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
+  // String compression is not handled by the predicated loads (see kNoStringCharAt).
+  DCHECK(!instruction->IsStringCharAt());
   LocationSummary* locations = instruction->GetLocations();
   size_t size = DataType::Size(instruction->GetPackedType());
-  VRegister reg = VRegisterFrom(locations->Out());
+  const ZRegister reg = ZRegisterFrom(locations->Out());
+  const PRegisterZ p_reg = GoverningPRegisterFrom(instruction).Zeroing();
   UseScratchRegisterScope temps(GetVIXLAssembler());
   Register scratch;
 
   switch (instruction->GetPackedType()) {
-    case DataType::Type::kInt16:  // (short) s.charAt(.) can yield HVecLoad/Int16/StringCharAt.
-    case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      // Special handling of compressed/uncompressed string load.
-      if (mirror::kUseStringCompression && instruction->IsStringCharAt()) {
-        vixl::aarch64::Label uncompressed_load, done;
-        // Test compression bit.
-        static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
-                      "Expecting 0=compressed, 1=uncompressed");
-        uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
-        Register length = temps.AcquireW();
-        __ Ldr(length, HeapOperand(InputRegisterAt(instruction, 0), count_offset));
-        __ Tbnz(length.W(), 0, &uncompressed_load);
-        temps.Release(length);  // no longer needed
-        // Zero extend 8 compressed bytes into 8 chars.
-        __ Ldr(DRegisterFrom(locations->Out()).V8B(),
-               VecNeonAddress(instruction, &temps, 1, /*is_string_char_at*/ true, &scratch));
-        __ Uxtl(reg.V8H(), reg.V8B());
-        __ B(&done);
-        if (scratch.IsValid()) {
-          temps.Release(scratch);  // if used, no longer needed
-        }
-        // Load 8 direct uncompressed chars.
-        __ Bind(&uncompressed_load);
-        __ Ldr(reg,
-               VecNeonAddress(instruction, &temps, size, /*is_string_char_at*/ true, &scratch));
-        __ Bind(&done);
-        return;
-      }
-      FALLTHROUGH_INTENDED;
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
+      __ Ld1b(reg.VnB(), p_reg, VecSVEAddress(instruction, &temps, size, &scratch));
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ Ld1h(reg.VnH(), p_reg, VecSVEAddress(instruction, &temps, size, &scratch));
+      break;
     case DataType::Type::kInt32:
     case DataType::Type::kFloat32:
+      __ Ld1w(reg.VnS(), p_reg, VecSVEAddress(instruction, &temps, size, &scratch));
+      break;
     case DataType::Type::kInt64:
     case DataType::Type::kFloat64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      __ Ldr(reg,
-             VecNeonAddress(instruction, &temps, size, instruction->IsStringCharAt(), &scratch));
+      __ Ld1d(reg.VnD(), p_reg, VecSVEAddress(instruction, &temps, size, &scratch));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -1459,9 +1078,12 @@ void LocationsBuilderARM64Sve::VisitVecStore(HVecStore* instruction) {
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecStore(HVecStore* instruction) {
+  DCHECK(instruction->IsPredicated());
+  DCHECK(ValidateVectorLength(instruction));
   LocationSummary* locations = instruction->GetLocations();
   size_t size = DataType::Size(instruction->GetPackedType());
-  VRegister reg = VRegisterFrom(locations->InAt(2));
+  const ZRegister reg = ZRegisterFrom(locations->InAt(2));
+  const PRegister p_reg = GoverningPRegisterFrom(instruction);
   UseScratchRegisterScope temps(GetVIXLAssembler());
   Register scratch;
 
@@ -1469,16 +1091,19 @@ void InstructionCodeGeneratorARM64Sve::VisitVecStore(HVecStore* instruction) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
+      __ St1b(reg.VnB(), p_reg, VecSVEAddress(instruction, &temps, size, &scratch));
+      break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
+      __ St1h(reg.VnH(), p_reg, VecSVEAddress(instruction, &temps, size, &scratch));
+      break;
     case DataType::Type::kInt32:
     case DataType::Type::kFloat32:
+      __ St1w(reg.VnS(), p_reg, VecSVEAddress(instruction, &temps, size, &scratch));
+      break;
     case DataType::Type::kInt64:
     case DataType::Type::kFloat64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      __ Str(reg,
-             VecNeonAddress(instruction, &temps, size, /*is_string_char_at*/ false, &scratch));
+      __ St1d(reg.VnD(), p_reg, VecSVEAddress(instruction, &temps, size, &scratch));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -1487,33 +1112,80 @@ void InstructionCodeGeneratorARM64Sve::VisitVecStore(HVecStore* instruction) {
 }
 
 void LocationsBuilderARM64Sve::VisitVecPredSetAll(HVecPredSetAll* instruction) {
-  LOG(FATAL) << "No SIMD for " << instruction->GetId();
-  UNREACHABLE();
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  DCHECK(instruction->InputAt(0)->IsIntConstant());
+  locations->SetInAt(0, Location::NoLocation());
+  locations->SetOut(Location::NoLocation());
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecPredSetAll(HVecPredSetAll* instruction) {
-  LOG(FATAL) << "No SIMD for " << instruction->GetId();
-  UNREACHABLE();
+  // An all-true predicate only governs loop invariants, which are computed by unpredicated
+  // instructions, so nothing needs to be materialized.
+  DCHECK(instruction->IsEmittedAtUseSite());
+  DCHECK(instruction->IsSetTrue());
 }
 
 void LocationsBuilderARM64Sve::VisitVecPredWhile(HVecPredWhile* instruction) {
-  LOG(FATAL) << "No SIMD for " << instruction->GetId();
-  UNREACHABLE();
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetOut(LocationFrom(LoopPReg()));
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecPredWhile(HVecPredWhile* instruction) {
-  LOG(FATAL) << "No SIMD for " << instruction->GetId();
-  UNREACHABLE();
+  // Only the loop control of predicated vector loops is supported.
+  DCHECK(instruction->GetCondKind() == HVecPredWhile::CondKind::kLO);
+  DCHECK(PredicatedLoopHasNoCalls(instruction));
+  Register left = InputRegisterAt(instruction, 0);
+  Register right = InputRegisterAt(instruction, 1);
+  const PRegister p_reg = PRegisterFrom(instruction->GetLocations()->Out());
+  const PRegister vl_reg = VectorLengthPReg();
+
+  // The loop steps by the vector length the loop optimizer used, but the hardware vectors
+  // may be wider. The elements past that length are disabled with a fixed-size PTRUE, so
+  // that the generated code is correct for any implemented vector length.
+  DCHECK_EQ(codegen_->GetSIMDRegisterWidth() % instruction->GetVectorLength(), 0u);
+  switch (codegen_->GetSIMDRegisterWidth() / instruction->GetVectorLength()) {
+    case 1u:
+      DCHECK_EQ(instruction->GetVectorLength(), 16u);
+      __ Whilelo(p_reg.VnB(), left, right);
+      __ Ptrue(vl_reg.VnB(), SVE_VL16);
+      break;
+    case 2u:
+      DCHECK_EQ(instruction->GetVectorLength(), 8u);
+      __ Whilelo(p_reg.VnH(), left, right);
+      __ Ptrue(vl_reg.VnH(), SVE_VL8);
+      break;
+    case 4u:
+      DCHECK_EQ(instruction->GetVectorLength(), 4u);
+      __ Whilelo(p_reg.VnS(), left, right);
+      __ Ptrue(vl_reg.VnS(), SVE_VL4);
+      break;
+    case 8u:
+      DCHECK_EQ(instruction->GetVectorLength(), 2u);
+      __ Whilelo(p_reg.VnD(), left, right);
+      __ Ptrue(vl_reg.VnD(), SVE_VL2);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD vector length: " << instruction->GetVectorLength();
+      UNREACHABLE();
+  }
+  // Sets the flags used by the following HVecPredCondition.
+  __ Ands(p_reg.VnB(), vl_reg.Zeroing(), p_reg.VnB(), p_reg.VnB());
 }
 
 void LocationsBuilderARM64Sve::VisitVecPredCondition(HVecPredCondition* instruction) {
-  LOG(FATAL) << "No SIMD for " << instruction->GetId();
-  UNREACHABLE();
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  locations->SetInAt(0, instruction->InputAt(0)->GetLocations()->Out());
+  locations->SetOut(Location::RequiresRegister());
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecPredCondition(HVecPredCondition* instruction) {
-  LOG(FATAL) << "No SIMD for " << instruction->GetId();
-  UNREACHABLE();
+  // Only used for the loop control of predicated vector loops, right after the
+  // HVecPredWhile which set the flags. The N flag is set if the first element is active.
+  DCHECK(instruction->GetPCondKind() == HVecPredCondition::PCondKind::kNFirst);
+  DCHECK(instruction->InputAt(0)->IsVecPredWhile());
+  __ Cset(OutputRegister(instruction), pl);
 }
 
 Location InstructionCodeGeneratorARM64Sve::AllocateSIMDScratchLocation(
@@ -1528,6 +1200,9 @@ void InstructionCodeGeneratorARM64Sve::FreeSIMDScratchLocation(Location loc,
   scope->Release(QRegisterFrom(loc));
 }
 
+// The SIMD values only use the low kQRegSizeInBytes of the Z registers (the other elements are
+// disabled, see VisitVecPredWhile), so they are moved and spilled as Q registers.
+
 void InstructionCodeGeneratorARM64Sve::LoadSIMDRegFromStack(Location destination,
                                                             Location source) {
   DCHECK_EQ(codegen_->GetSIMDRegisterWidth(), kQRegSizeInBytes);
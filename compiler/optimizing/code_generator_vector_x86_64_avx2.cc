@@ -0,0 +1,1204 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_generator_x86_64.h"
+
+#include "mirror/array-inl.h"
+#include "mirror/string.h"
+
+namespace art {
+namespace x86_64 {
+
+// All vector operations below use the VEX.256 forms on full YMM registers, which are named
+// by the XmmRegister sharing their number. Since VEX instructions are non-destructive, the
+// outputs never need to share a register with the inputs.
+
+// NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
+#define __ down_cast<X86_64Assembler*>(GetAssembler())->  // NOLINT
+
+static constexpr bool kIs256 = true;
+
+bool InstructionCodeGeneratorX86_64Avx2::ValidateVectorLength(HVecOperation* instr) const {
+  return DataType::Size(instr->GetPackedType()) * instr->GetVectorLength() ==
+      codegen_->GetSIMDRegisterWidth();
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  HInstruction* input = instruction->InputAt(0);
+  bool is_zero = IsZeroBitPattern(input);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input->AsConstant())
+                                    : Location::RequiresRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input->AsConstant())
+                                    : Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecReplicateScalar(
+    HVecReplicateScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+
+  // Shorthand for any type of zero.
+  if (IsZeroBitPattern(instruction->InputAt(0))) {
+    __ vxorps(dst, dst, dst, kIs256);
+    return;
+  }
+
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      __ vmovd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*is64bit=*/ false);
+      __ vpbroadcastb(dst, dst, kIs256);
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ vmovd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*is64bit=*/ false);
+      __ vpbroadcastw(dst, dst, kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vmovd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*is64bit=*/ false);
+      __ vpbroadcastd(dst, dst, kIs256);
+      break;
+    case DataType::Type::kInt64:
+      __ vmovd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*is64bit=*/ true);
+      __ vpbroadcastq(dst, dst, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vbroadcastss(dst, locations->InAt(0).AsFpuRegister<XmmRegister>(), kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vbroadcastsd(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecExtractScalar(HVecExtractScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecExtractScalar(HVecExtractScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+    case DataType::Type::kInt32:
+      __ vmovd(locations->Out().AsRegister<CpuRegister>(), src, /*is64bit=*/ false);
+      break;
+    case DataType::Type::kInt64:
+      __ vmovd(locations->Out().AsRegister<CpuRegister>(), src, /*is64bit=*/ true);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      DCHECK(locations->InAt(0).Equals(locations->Out()));  // no code required
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector unary operations.
+static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecReduce(HVecReduce* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+  // All reductions first fold the upper 128-bit lane into a temporary.
+  instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  // Fold the upper 128 bits onto the lower 128 bits, then finish with 128-bit operations
+  // (which also clear the upper bits of the result).
+  __ vextracti128(tmp, src, Immediate(1));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+      switch (instruction->GetReductionKind()) {
+        case HVecReduce::kSum:
+          __ vpaddd(dst, src, tmp, /*is_256=*/ false);
+          __ vphaddd(dst, dst, dst, /*is_256=*/ false);
+          __ vphaddd(dst, dst, dst, /*is_256=*/ false);
+          break;
+        case HVecReduce::kMin:
+        case HVecReduce::kMax: {
+          bool is_min = instruction->GetReductionKind() == HVecReduce::kMin;
+          is_min ? __ vpminsd(dst, src, tmp, /*is_256=*/ false)
+                 : __ vpmaxsd(dst, src, tmp, /*is_256=*/ false);
+          __ vpshufd(tmp, dst, Immediate(0x4e), /*is_256=*/ false);  // [x2, x3, x0, x1]
+          is_min ? __ vpminsd(dst, dst, tmp, /*is_256=*/ false)
+                 : __ vpmaxsd(dst, dst, tmp, /*is_256=*/ false);
+          __ vpshufd(tmp, dst, Immediate(0xb1), /*is_256=*/ false);  // [y1, y0, y3, y2]
+          is_min ? __ vpminsd(dst, dst, tmp, /*is_256=*/ false)
+                 : __ vpmaxsd(dst, dst, tmp, /*is_256=*/ false);
+          break;
+        }
+      }
+      break;
+    case DataType::Type::kInt64:
+      switch (instruction->GetReductionKind()) {
+        case HVecReduce::kSum:
+          __ vpaddq(dst, src, tmp, /*is_256=*/ false);
+          __ vpunpckhqdq(tmp, dst, dst, /*is_256=*/ false);
+          __ vpaddq(dst, dst, tmp, /*is_256=*/ false);
+          break;
+        case HVecReduce::kMin:
+        case HVecReduce::kMax:
+          LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecCnv(HVecCnv* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecCnv(HVecCnv* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DataType::Type from = instruction->GetInputType();
+  DataType::Type to = instruction->GetResultType();
+  if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+    DCHECK(ValidateVectorLength(instruction));
+    __ vcvtdq2ps(dst, src, kIs256);
+  } else {
+    LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecNeg(HVecNeg* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecNeg(HVecNeg* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      __ vpxor(dst, dst, dst, kIs256);
+      __ vpsubb(dst, dst, src, kIs256);
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ vpxor(dst, dst, dst, kIs256);
+      __ vpsubw(dst, dst, src, kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vpxor(dst, dst, dst, kIs256);
+      __ vpsubd(dst, dst, src, kIs256);
+      break;
+    case DataType::Type::kInt64:
+      __ vpxor(dst, dst, dst, kIs256);
+      __ vpsubq(dst, dst, src, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vxorps(dst, dst, dst, kIs256);
+      __ vsubps(dst, dst, src, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vxorpd(dst, dst, dst, kIs256);
+      __ vsubpd(dst, dst, src, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecAbs(HVecAbs* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecAbs(HVecAbs* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+      __ vpabsd(dst, src, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vpcmpeqb(dst, dst, dst, kIs256);  // all ones
+      __ vpsrld(dst, dst, Immediate(1), kIs256);
+      __ vandps(dst, dst, src, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vpcmpeqb(dst, dst, dst, kIs256);  // all ones
+      __ vpsrlq(dst, dst, Immediate(1), kIs256);
+      __ vandpd(dst, dst, src, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecNot(HVecNot* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+  // Boolean-not requires a temporary to construct the 32 x one.
+  if (instruction->GetPackedType() == DataType::Type::kBool) {
+    instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
+  }
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecNot(HVecNot* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool: {  // special case boolean-not
+      XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+      __ vpxor(dst, dst, dst, kIs256);
+      __ vpcmpeqb(tmp, tmp, tmp, kIs256);  // all ones
+      __ vpsubb(dst, dst, tmp, kIs256);  // 32 x one
+      __ vpxor(dst, dst, src, kIs256);
+      break;
+    }
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ vpcmpeqb(dst, dst, dst, kIs256);  // all ones
+      __ vpxor(dst, dst, src, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vpcmpeqb(dst, dst, dst, kIs256);  // all ones
+      __ vxorps(dst, dst, src, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vpcmpeqb(dst, dst, dst, kIs256);  // all ones
+      __ vxorpd(dst, dst, src, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector binary operations.
+static void CreateVecBinOpLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kUint32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecAdd(HVecAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecAdd(HVecAdd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      __ vpaddb(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ vpaddw(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vpaddd(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt64:
+      __ vpaddq(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vaddps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vaddpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+      __ vpaddusb(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt8:
+      __ vpaddsb(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kUint16:
+      __ vpaddusw(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt16:
+      __ vpaddsw(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+
+  DCHECK(instruction->IsRounded());
+
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+      __ vpavgb(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kUint16:
+      __ vpavgw(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecSub(HVecSub* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecSub(HVecSub* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      __ vpsubb(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ vpsubw(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vpsubd(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt64:
+      __ vpsubq(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vsubps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vsubpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+      __ vpsubusb(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt8:
+      __ vpsubsb(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kUint16:
+      __ vpsubusw(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt16:
+      __ vpsubsw(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecMul(HVecMul* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecMul(HVecMul* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ vpmullw(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vpmulld(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vmulps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vmulpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecDiv(HVecDiv* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecDiv(HVecDiv* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kFloat32:
+      __ vdivps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vdivpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecMin(HVecMin* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecMin(HVecMin* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+      __ vpminub(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt8:
+      __ vpminsb(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kUint16:
+      __ vpminuw(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt16:
+      __ vpminsw(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kUint32:
+      __ vpminud(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vpminsd(dst, lhs, rhs, kIs256);
+      break;
+    // Next cases are sloppy wrt 0.0 vs -0.0.
+    case DataType::Type::kFloat32:
+      __ vminps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vminpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecMax(HVecMax* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecMax(HVecMax* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+      __ vpmaxub(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt8:
+      __ vpmaxsb(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kUint16:
+      __ vpmaxuw(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt16:
+      __ vpmaxsw(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kUint32:
+      __ vpmaxud(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vpmaxsd(dst, lhs, rhs, kIs256);
+      break;
+    // Next cases are sloppy wrt 0.0 vs -0.0.
+    case DataType::Type::kFloat32:
+      __ vmaxps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vmaxpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecAnd(HVecAnd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecAnd(HVecAnd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ vpand(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vandps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vandpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecAndNot(HVecAndNot* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecAndNot(HVecAndNot* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ vpandn(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vandnps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vandnpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecOr(HVecOr* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecOr(HVecOr* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ vpor(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vorps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vorpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecXor(HVecXor* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecXor(HVecXor* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister lhs = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ vpxor(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      __ vxorps(dst, lhs, rhs, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      __ vxorpd(dst, lhs, rhs, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector shift operations.
+static void CreateVecShiftLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::ConstantLocation(instruction->InputAt(1)->AsConstant()));
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecShl(HVecShl* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecShl(HVecShl* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ vpsllw(dst, src, Immediate(static_cast<int8_t>(value)), kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vpslld(dst, src, Immediate(static_cast<int8_t>(value)), kIs256);
+      break;
+    case DataType::Type::kInt64:
+      __ vpsllq(dst, src, Immediate(static_cast<int8_t>(value)), kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecShr(HVecShr* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecShr(HVecShr* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ vpsraw(dst, src, Immediate(static_cast<int8_t>(value)), kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vpsrad(dst, src, Immediate(static_cast<int8_t>(value)), kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecUShr(HVecUShr* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecUShr(HVecUShr* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ vpsrlw(dst, src, Immediate(static_cast<int8_t>(value)), kIs256);
+      break;
+    case DataType::Type::kInt32:
+      __ vpsrld(dst, src, Immediate(static_cast<int8_t>(value)), kIs256);
+      break;
+    case DataType::Type::kInt64:
+      __ vpsrlq(dst, src, Immediate(static_cast<int8_t>(value)), kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecSetScalars(HVecSetScalars* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+
+  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
+
+  HInstruction* input = instruction->InputAt(0);
+  bool is_zero = IsZeroBitPattern(input);
+
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input->AsConstant())
+                                    : Location::RequiresRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input->AsConstant())
+                                    : Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecSetScalars(HVecSetScalars* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+
+  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
+
+  // Zero out all other elements first.
+  __ vxorps(dst, dst, dst, kIs256);
+
+  // Shorthand for any type of zero.
+  if (IsZeroBitPattern(instruction->InputAt(0))) {
+    return;
+  }
+
+  // Set required elements. The VEX.128 moves below leave the upper 128 bits cleared.
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:  // Only the zero case above is supported.
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+    case DataType::Type::kInt32:
+      __ vmovd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*is64bit=*/ false);
+      break;
+    case DataType::Type::kInt64:
+      __ vmovd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*is64bit=*/ true);
+      break;
+    case DataType::Type::kFloat32:
+      __ vmovss(dst, dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
+      break;
+    case DataType::Type::kFloat64:
+      __ vmovsd(dst, dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector accumulations.
+static void CreateVecAccumLocations(ArenaAllocator* allocator, HVecOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetInAt(2, Location::RequiresFpuRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecMultiplyAccumulate(
+    HVecMultiplyAccumulate* instruction) {
+  CreateVecAccumLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecMultiplyAccumulate(
+    HVecMultiplyAccumulate* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
+  CreateVecAccumLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecDotProd(HVecDotProd* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->SetInAt(2, Location::RequiresFpuRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecDotProd(HVecDotProd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister acc = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister left = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister right = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32: {
+      XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+      __ vpmaddwd(tmp, left, right, kIs256);
+      __ vpaddd(acc, acc, tmp, kIs256);
+      break;
+    }
+    default:
+      LOG(FATAL) << "Unsupported SIMD Type" << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector memory operations.
+static void CreateVecMemLocations(ArenaAllocator* allocator,
+                                  HVecMemoryOperation* instruction,
+                                  bool is_load) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RegisterOrConstant(instruction->InputAt(1)));
+      if (is_load) {
+        locations->SetOut(Location::RequiresFpuRegister());
+      } else {
+        locations->SetInAt(2, Location::RequiresFpuRegister());
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to construct address for vector memory operations.
+static Address VecAddress(LocationSummary* locations, size_t size) {
+  Location base = locations->InAt(0);
+  Location index = locations->InAt(1);
+  ScaleFactor scale = TIMES_1;
+  switch (size) {
+    case 2: scale = TIMES_2; break;
+    case 4: scale = TIMES_4; break;
+    case 8: scale = TIMES_8; break;
+    default: break;
+  }
+  uint32_t offset = mirror::Array::DataOffset(size).Uint32Value();
+  return CodeGeneratorX86_64::ArrayAddress(base.AsRegister<CpuRegister>(), index, scale, offset);
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecLoad(HVecLoad* instruction) {
+  CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ true);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecLoad(HVecLoad* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t size = DataType::Size(instruction->GetPackedType());
+  Address address = VecAddress(locations, size);
+  XmmRegister reg = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_aligned32 = instruction->GetAlignment().IsAlignedAt(32);
+  DCHECK(ValidateVectorLength(instruction));
+  // The loop optimizer does not vectorize String.charAt() for 256-bit vectors.
+  DCHECK(!instruction->IsStringCharAt());
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      is_aligned32 ? __ vmovdqa(reg, address, kIs256) : __ vmovdqu(reg, address, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      is_aligned32 ? __ vmovaps(reg, address, kIs256) : __ vmovups(reg, address, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      is_aligned32 ? __ vmovapd(reg, address, kIs256) : __ vmovupd(reg, address, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecStore(HVecStore* instruction) {
+  CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ false);
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecStore(HVecStore* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t size = DataType::Size(instruction->GetPackedType());
+  Address address = VecAddress(locations, size);
+  XmmRegister reg = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  bool is_aligned32 = instruction->GetAlignment().IsAlignedAt(32);
+  DCHECK(ValidateVectorLength(instruction));
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      is_aligned32 ? __ vmovdqa(address, reg, kIs256) : __ vmovdqu(address, reg, kIs256);
+      break;
+    case DataType::Type::kFloat32:
+      is_aligned32 ? __ vmovaps(address, reg, kIs256) : __ vmovups(address, reg, kIs256);
+      break;
+    case DataType::Type::kFloat64:
+      is_aligned32 ? __ vmovapd(address, reg, kIs256) : __ vmovupd(address, reg, kIs256);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecPredSetAll(HVecPredSetAll* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecPredSetAll(HVecPredSetAll* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecPredWhile(HVecPredWhile* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecPredWhile(HVecPredWhile* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderX86_64Avx2::VisitVecPredCondition(HVecPredCondition* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorX86_64Avx2::VisitVecPredCondition(HVecPredCondition* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+#undef __
+
+}  // namespace x86_64
+}  // namespace art
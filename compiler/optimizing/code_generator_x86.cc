@@ -1782,6 +1782,23 @@ void InstructionCodeGeneratorX86::VisitIf(HIf* if_instr) {
       nullptr : codegen_->GetLabelOf(true_successor);
   Label* false_target = codegen_->GoesToNextBlock(if_instr->GetBlock(), false_successor) ?
       nullptr : codegen_->GetLabelOf(false_successor);
+  BranchCache* cache = codegen_->GetBranchCacheFor(if_instr);
+  if (cache != nullptr) {
+    // Count the outcomes of the branch for the optimizing compiler.
+    uint32_t address = reinterpret_cast32<uint32_t>(cache);
+    NearLabel taken;
+    GenerateTestAndBranch<NearLabel>(
+        if_instr, /* condition_input_index= */ 0, &taken, /* false_target= */ nullptr);
+    __ addl(Address::Absolute(address + BranchCache::NotTakenOffset().Uint32Value()),
+            Immediate(1));
+    __ jmp(codegen_->GetLabelOf(false_successor));
+    __ Bind(&taken);
+    __ addl(Address::Absolute(address + BranchCache::TakenOffset().Uint32Value()), Immediate(1));
+    if (true_target != nullptr) {
+      __ jmp(true_target);
+    }
+    return;
+  }
   GenerateTestAndBranch(if_instr, /* condition_input_index= */ 0, true_target, false_target);
 }
 
@@ -2379,10 +2396,14 @@ void CodeGeneratorX86::MaybeGenerateInlineCacheCheck(HInstruction* instruction,
       }
       Register temp = EBP;
       NearLabel done;
+      NearLabel update;
       __ movl(temp, Immediate(address));
-      // Fast path for a monomorphic cache.
+      // Fast path for a monomorphic cache, which only needs to count the receiver.
       __ cmpl(klass, Address(temp, InlineCache::ClassesOffset().Int32Value()));
-      __ j(kEqual, &done);
+      __ j(kNotEqual, &update);
+      __ addl(Address(temp, InlineCache::CountsOffset().Int32Value()), Immediate(1));
+      __ jmp(&done);
+      __ Bind(&update);
       GenerateInvokeRuntime(GetThreadOffset<kX86PointerSize>(kQuickUpdateInlineCache).Int32Value());
       __ Bind(&done);
     }
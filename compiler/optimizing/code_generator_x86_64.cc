@@ -1030,6 +1030,7 @@ void CodeGeneratorX86_64::GenerateStaticOrDirectCall(
     }
   }
 
+  MaybeEmitVZeroUpper();
   switch (invoke->GetCodePtrLocation()) {
     case HInvokeStaticOrDirect::CodePtrLocation::kCallSelf:
       __ call(&frame_entry_label_);
@@ -1077,6 +1078,7 @@ void CodeGeneratorX86_64::GenerateVirtualCall(
   // temp = temp->GetMethodAt(method_offset);
   __ movq(temp, Address(temp, method_offset));
   // call temp->GetEntryPoint();
+  MaybeEmitVZeroUpper();
   __ call(Address(temp, ArtMethod::EntryPointFromQuickCompiledCodeOffset(
       kX86_64PointerSize).SizeValue()));
   RecordPcInfo(invoke, invoke->GetDexPc(), slow_path);
@@ -1250,7 +1252,9 @@ size_t CodeGeneratorX86_64::RestoreCoreRegister(size_t stack_index, uint32_t reg
 }
 
 size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (GetGraph()->HasSIMD() && ShouldUseAVX2Vectors()) {
+    __ vmovups(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id), /*is_256=*/ true);
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
   } else {
     __ movsd(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
@@ -1259,7 +1263,9 @@ size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32
 }
 
 size_t CodeGeneratorX86_64::RestoreFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (GetGraph()->HasSIMD() && ShouldUseAVX2Vectors()) {
+    __ vmovups(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index), /*is_256=*/ true);
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
   } else {
     __ movsd(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
@@ -1272,6 +1278,7 @@ void CodeGeneratorX86_64::InvokeRuntime(QuickEntrypointEnum entrypoint,
                                         uint32_t dex_pc,
                                         SlowPathCode* slow_path) {
   ValidateInvokeRuntime(entrypoint, instruction, slow_path);
+  MaybeEmitVZeroUpper();
   GenerateInvokeRuntime(GetThreadOffset<kX86_64PointerSize>(entrypoint).Int32Value());
   if (EntrypointRequiresStackMap(entrypoint)) {
     RecordPcInfo(instruction, dex_pc, slow_path);
@@ -1307,10 +1314,13 @@ CodeGeneratorX86_64::CodeGeneratorX86_64(HGraph* graph,
                       compiler_options,
                       stats),
         block_labels_(nullptr),
-        location_builder_(graph, this),
-        instruction_visitor_(graph, this),
+        location_builder_sse_(graph, this),
+        location_builder_avx2_(graph, this),
+        instruction_visitor_sse_(graph, this),
+        instruction_visitor_avx2_(graph, this),
         move_resolver_(graph->GetAllocator(), this),
-        assembler_(graph->GetAllocator()),
+        assembler_(graph->GetAllocator(),
+                   compiler_options.GetInstructionSetFeatures()->AsX86_64InstructionSetFeatures()),
         constant_area_start_(0),
         boot_image_method_patches_(graph->GetAllocator()->Adapter(kArenaAllocCodeGenerator)),
         method_bss_entry_patches_(graph->GetAllocator()->Adapter(kArenaAllocCodeGenerator)),
@@ -1323,6 +1333,24 @@ CodeGeneratorX86_64::CodeGeneratorX86_64(HGraph* graph,
         jit_class_patches_(graph->GetAllocator()->Adapter(kArenaAllocCodeGenerator)),
         fixups_to_jump_tables_(graph->GetAllocator()->Adapter(kArenaAllocCodeGenerator)) {
   AddAllocatedRegister(Location::RegisterLocation(kFakeReturnRegister));
+
+  if (ShouldUseAVX2Vectors()) {
+    location_builder_ = &location_builder_avx2_;
+    instruction_visitor_ = &instruction_visitor_avx2_;
+  } else {
+    location_builder_ = &location_builder_sse_;
+    instruction_visitor_ = &instruction_visitor_sse_;
+  }
+}
+
+bool CodeGeneratorX86_64::ShouldUseAVX2Vectors() const {
+  return kX86_64AllowAVX2Vectors && GetInstructionSetFeatures().HasAVX2();
+}
+
+void CodeGeneratorX86_64::MaybeEmitVZeroUpper() {
+  if (GetGraph()->HasSIMD() && ShouldUseAVX2Vectors()) {
+    __ vzeroupper();
+  }
 }
 
 InstructionCodeGeneratorX86_64::InstructionCodeGeneratorX86_64(HGraph* graph,
@@ -1481,6 +1509,7 @@ void CodeGeneratorX86_64::GenerateFrameExit() {
       }
     }
   }
+  MaybeEmitVZeroUpper();
   __ ret();
   __ cfi().RestoreState();
   __ cfi().DefCFAOffset(GetFrameSize());
@@ -1600,11 +1629,16 @@ void InstructionCodeGeneratorX86_64::HandleGoto(HInstruction* got, HBasicBlock*
   HLoopInformation* info = block->GetLoopInformation();
   if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
     codegen_->MaybeIncrementHotness(/* is_frame_entry= */ false);
-    GenerateSuspendCheck(info->GetSuspendCheck(), successor);
-    return;
+    if (!codegen_->UseImplicitSuspendChecks()) {
+      GenerateSuspendCheck(info->GetSuspendCheck(), successor);
+      return;
+    }
   }
 
-  if (block->IsEntryBlock() && (previous != nullptr) && previous->IsSuspendCheck()) {
+  if (block->IsEntryBlock() &&
+      (previous != nullptr) &&
+      previous->IsSuspendCheck() &&
+      !codegen_->UseImplicitSuspendChecks()) {
     GenerateSuspendCheck(previous->AsSuspendCheck(), nullptr);
   }
   if (!codegen_->GoesToNextBlock(got->GetBlock(), successor)) {
@@ -1852,6 +1886,24 @@ void InstructionCodeGeneratorX86_64::VisitIf(HIf* if_instr) {
       nullptr : codegen_->GetLabelOf(true_successor);
   Label* false_target = codegen_->GoesToNextBlock(if_instr->GetBlock(), false_successor) ?
       nullptr : codegen_->GetLabelOf(false_successor);
+  BranchCache* cache = codegen_->GetBranchCacheFor(if_instr);
+  if (cache != nullptr) {
+    // Count the outcomes of the branch for the optimizing compiler.
+    uint64_t address = reinterpret_cast64<uint64_t>(cache);
+    NearLabel taken;
+    GenerateTestAndBranch<NearLabel>(
+        if_instr, /* condition_input_index= */ 0, &taken, /* false_target= */ nullptr);
+    __ movq(CpuRegister(TMP), Immediate(address));
+    __ addl(Address(CpuRegister(TMP), BranchCache::NotTakenOffset().Int32Value()), Immediate(1));
+    __ jmp(codegen_->GetLabelOf(false_successor));
+    __ Bind(&taken);
+    __ movq(CpuRegister(TMP), Immediate(address));
+    __ addl(Address(CpuRegister(TMP), BranchCache::TakenOffset().Int32Value()), Immediate(1));
+    if (true_target != nullptr) {
+      __ jmp(true_target);
+    }
+    return;
+  }
   GenerateTestAndBranch(if_instr, /* condition_input_index= */ 0, true_target, false_target);
 }
 
@@ -2586,10 +2638,14 @@ void CodeGeneratorX86_64::MaybeGenerateInlineCacheCheck(HInstruction* instructio
       InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
       uint64_t address = reinterpret_cast64<uint64_t>(cache);
       NearLabel done;
+      NearLabel update;
       __ movq(CpuRegister(TMP), Immediate(address));
-      // Fast path for a monomorphic cache.
+      // Fast path for a monomorphic cache, which only needs to count the receiver.
       __ cmpl(Address(CpuRegister(TMP), InlineCache::ClassesOffset().Int32Value()), klass);
-      __ j(kEqual, &done);
+      __ j(kNotEqual, &update);
+      __ addl(Address(CpuRegister(TMP), InlineCache::CountsOffset().Int32Value()), Immediate(1));
+      __ jmp(&done);
+      __ Bind(&update);
       GenerateInvokeRuntime(
           GetThreadOffset<kX86_64PointerSize>(kQuickUpdateInlineCache).Int32Value());
       __ Bind(&done);
@@ -2640,6 +2696,7 @@ void InstructionCodeGeneratorX86_64::VisitInvokeInterface(HInvokeInterface* invo
   // temp = temp->GetImtEntryAt(method_offset);
   __ movq(temp, Address(temp, method_offset));
   // call temp->GetEntryPoint();
+  codegen_->MaybeEmitVZeroUpper();
   __ call(Address(
       temp, ArtMethod::EntryPointFromQuickCompiledCodeOffset(kX86_64PointerSize).SizeValue()));
 
@@ -2648,10 +2705,17 @@ void InstructionCodeGeneratorX86_64::VisitInvokeInterface(HInvokeInterface* invo
 }
 
 void LocationsBuilderX86_64::VisitInvokePolymorphic(HInvokePolymorphic* invoke) {
+  IntrinsicLocationsBuilderX86_64 intrinsic(codegen_);
+  if (intrinsic.TryDispatch(invoke)) {
+    return;
+  }
   HandleInvoke(invoke);
 }
 
 void InstructionCodeGeneratorX86_64::VisitInvokePolymorphic(HInvokePolymorphic* invoke) {
+  if (TryGenerateIntrinsicCode(invoke, codegen_)) {
+    return;
+  }
   codegen_->GenerateInvokePolymorphicCall(invoke);
 }
 
@@ -5623,7 +5687,8 @@ void LocationsBuilderX86_64::VisitParallelMove(HParallelMove* instruction ATTRIB
 
 void InstructionCodeGeneratorX86_64::VisitParallelMove(HParallelMove* instruction) {
   if (instruction->GetNext()->IsSuspendCheck() &&
-      instruction->GetBlock()->GetLoopInformation() != nullptr) {
+      instruction->GetBlock()->GetLoopInformation() != nullptr &&
+      !codegen_->UseImplicitSuspendChecks()) {
     HSuspendCheck* suspend_check = instruction->GetNext()->AsSuspendCheck();
     // The back edge will generate the suspend check.
     codegen_->ClearSpillSlotsFromLoopPhisInStackMap(suspend_check, instruction);
@@ -5640,9 +5705,18 @@ void LocationsBuilderX86_64::VisitSuspendCheck(HSuspendCheck* instruction) {
   // registers in full width (since the runtime only saves/restores lower part).
   locations->SetCustomSlowPathCallerSaves(
       GetGraph()->HasSIMD() ? RegisterSet::AllFpu() : RegisterSet::Empty());
+  if (codegen_->UseImplicitSuspendChecks()) {
+    // Holds the suspend trigger. There is no scratch register on x86-64, so implicit suspend
+    // checks are generated where this temporary is allocated, not at the loop back edges.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorX86_64::VisitSuspendCheck(HSuspendCheck* instruction) {
+  if (codegen_->UseImplicitSuspendChecks()) {
+    GenerateSuspendCheck(instruction, nullptr);
+    return;
+  }
   HBasicBlock* block = instruction->GetBlock();
   if (block->GetLoopInformation() != nullptr) {
     DCHECK(block->GetLoopInformation()->GetSuspendCheck() == instruction);
@@ -5658,6 +5732,20 @@ void InstructionCodeGeneratorX86_64::VisitSuspendCheck(HSuspendCheck* instructio
 
 void InstructionCodeGeneratorX86_64::GenerateSuspendCheck(HSuspendCheck* instruction,
                                                           HBasicBlock* successor) {
+  if (codegen_->UseImplicitSuspendChecks()) {
+    // Load the suspend trigger and dereference it. The trigger is null when the thread is
+    // asked to suspend and the SuspensionHandler then calls the runtime. The handler expects
+    // these two instructions, see runtime/arch/x86/fault_handler_x86.cc.
+    DCHECK(successor == nullptr);
+    CpuRegister temp = instruction->GetLocations()->GetTemp(0).AsRegister<CpuRegister>();
+    __ gs()->movq(temp,
+                  Address::Absolute(Thread::ThreadSuspendTriggerOffset<kX86_64PointerSize>(),
+                                    /* no_rip= */ true));
+    __ testl(temp, Address(temp, 0));
+    codegen_->RecordPcInfo(instruction, instruction->GetDexPc());
+    return;
+  }
+
   SuspendCheckSlowPathX86_64* slow_path =
       down_cast<SuspendCheckSlowPathX86_64*>(instruction->GetSlowPath());
   if (slow_path == nullptr) {
@@ -5730,15 +5818,22 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsSIMDStackSlot()) {
     if (destination.IsFpuRegister()) {
-      __ movups(destination.AsFpuRegister<XmmRegister>(),
-                Address(CpuRegister(RSP), source.GetStackIndex()));
+      if (codegen_->ShouldUseAVX2Vectors()) {
+        __ vmovups(destination.AsFpuRegister<XmmRegister>(),
+                   Address(CpuRegister(RSP), source.GetStackIndex()),
+                   /*is_256=*/ true);
+      } else {
+        __ movups(destination.AsFpuRegister<XmmRegister>(),
+                  Address(CpuRegister(RSP), source.GetStackIndex()));
+      }
     } else {
       DCHECK(destination.IsSIMDStackSlot());
-      size_t high = kX86_64WordSize;
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex()));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + high));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + high), CpuRegister(TMP));
+      size_t num_of_qwords = codegen_->GetSIMDRegisterWidth() / kX86_64WordSize;
+      for (size_t i = 0; i < num_of_qwords; ++i) {
+        size_t offset = i * kX86_64WordSize;
+        __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + offset));
+        __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + offset), CpuRegister(TMP));
+      }
     }
   } else if (source.IsConstant()) {
     HConstant* constant = source.GetConstant();
@@ -5786,7 +5881,13 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsFpuRegister()) {
     if (destination.IsFpuRegister()) {
-      __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      if (codegen_->GetGraph()->HasSIMD() && codegen_->ShouldUseAVX2Vectors()) {
+        __ vmovaps(destination.AsFpuRegister<XmmRegister>(),
+                   source.AsFpuRegister<XmmRegister>(),
+                   /*is_256=*/ true);
+      } else {
+        __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      }
     } else if (destination.IsStackSlot()) {
       __ movss(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
@@ -5794,9 +5895,15 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
       __ movsd(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
     } else {
-       DCHECK(destination.IsSIMDStackSlot());
-      __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
-                source.AsFpuRegister<XmmRegister>());
+      DCHECK(destination.IsSIMDStackSlot());
+      if (codegen_->ShouldUseAVX2Vectors()) {
+        __ vmovups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                   source.AsFpuRegister<XmmRegister>(),
+                   /*is_256=*/ true);
+      } else {
+        __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                  source.AsFpuRegister<XmmRegister>());
+      }
     }
   }
 }
@@ -5831,12 +5938,21 @@ void ParallelMoveResolverX86_64::Exchange64(XmmRegister reg, int mem) {
   __ movd(reg, CpuRegister(TMP));
 }
 
-void ParallelMoveResolverX86_64::Exchange128(XmmRegister reg, int mem) {
-  size_t extra_slot = 2 * kX86_64WordSize;
+void ParallelMoveResolverX86_64::ExchangeSIMD(XmmRegister reg, int mem) {
+  size_t extra_slot = codegen_->GetSIMDRegisterWidth();
+  bool is_256 = codegen_->ShouldUseAVX2Vectors();
   __ subq(CpuRegister(RSP), Immediate(extra_slot));
-  __ movups(Address(CpuRegister(RSP), 0), XmmRegister(reg));
-  ExchangeMemory64(0, mem + extra_slot, 2);
-  __ movups(XmmRegister(reg), Address(CpuRegister(RSP), 0));
+  if (is_256) {
+    __ vmovups(Address(CpuRegister(RSP), 0), XmmRegister(reg), /*is_256=*/ true);
+  } else {
+    __ movups(Address(CpuRegister(RSP), 0), XmmRegister(reg));
+  }
+  ExchangeMemory64(0, mem + extra_slot, extra_slot / kX86_64WordSize);
+  if (is_256) {
+    __ vmovups(XmmRegister(reg), Address(CpuRegister(RSP), 0), /*is_256=*/ true);
+  } else {
+    __ movups(XmmRegister(reg), Address(CpuRegister(RSP), 0));
+  }
   __ addq(CpuRegister(RSP), Immediate(extra_slot));
 }
 
@@ -5892,6 +6008,14 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
     Exchange64(destination.AsRegister<CpuRegister>(), source.GetStackIndex());
   } else if (source.IsDoubleStackSlot() && destination.IsDoubleStackSlot()) {
     ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 1);
+  } else if (source.IsFpuRegister() && destination.IsFpuRegister() &&
+             codegen_->GetGraph()->HasSIMD() && codegen_->ShouldUseAVX2Vectors()) {
+    // Swap the full YMM registers without a scratch register.
+    XmmRegister reg1 = source.AsFpuRegister<XmmRegister>();
+    XmmRegister reg2 = destination.AsFpuRegister<XmmRegister>();
+    __ vxorps(reg1, reg1, reg2, /*is_256=*/ true);
+    __ vxorps(reg2, reg2, reg1, /*is_256=*/ true);
+    __ vxorps(reg1, reg1, reg2, /*is_256=*/ true);
   } else if (source.IsFpuRegister() && destination.IsFpuRegister()) {
     __ movd(CpuRegister(TMP), source.AsFpuRegister<XmmRegister>());
     __ movaps(source.AsFpuRegister<XmmRegister>(), destination.AsFpuRegister<XmmRegister>());
@@ -5905,11 +6029,13 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
   } else if (source.IsDoubleStackSlot() && destination.IsFpuRegister()) {
     Exchange64(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else if (source.IsSIMDStackSlot() && destination.IsSIMDStackSlot()) {
-    ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 2);
+    ExchangeMemory64(destination.GetStackIndex(),
+                     source.GetStackIndex(),
+                     codegen_->GetSIMDRegisterWidth() / kX86_64WordSize);
   } else if (source.IsFpuRegister() && destination.IsSIMDStackSlot()) {
-    Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    ExchangeSIMD(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
   } else if (destination.IsFpuRegister() && source.IsSIMDStackSlot()) {
-    Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    ExchangeSIMD(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else {
     LOG(FATAL) << "Unimplemented swap between " << source << " and " << destination;
   }
@@ -6325,6 +6451,48 @@ static size_t NumberOfCheckCastTemps(TypeCheckKind type_check_kind) {
   return 1 + NumberOfInstanceOfTemps(type_check_kind);
 }
 
+void InstructionCodeGeneratorX86_64::GenerateTypeCheckCacheUpdate(TypeCheckCache* cache,
+                                                                  CpuRegister obj,
+                                                                  CpuRegister temp) {
+  // The first class seen is stored in the cache. Objects of that class are then counted
+  // as hits and objects of other classes as misses.
+  NearLabel hit, miss, done;
+  // /* HeapReference<Class> */ temp = obj->klass_
+  // Like for inline caches, we do not need a read barrier for a class we only record.
+  __ movl(temp, Address(obj, mirror::Object::ClassOffset().Int32Value()));
+  __ MaybeUnpoisonHeapReference(temp);
+  __ movq(CpuRegister(TMP), Immediate(reinterpret_cast64<uint64_t>(cache)));
+  Address class_address(CpuRegister(TMP), TypeCheckCache::ClassOffset().Int32Value());
+  __ cmpl(temp, class_address);
+  __ j(kEqual, &hit);
+  __ cmpl(class_address, Immediate(0));
+  __ j(kNotEqual, &miss);
+  __ movl(class_address, temp);
+  __ Bind(&hit);
+  __ addl(Address(CpuRegister(TMP), TypeCheckCache::HitsOffset().Int32Value()), Immediate(1));
+  __ jmp(&done);
+  __ Bind(&miss);
+  __ addl(Address(CpuRegister(TMP), TypeCheckCache::MissesOffset().Int32Value()), Immediate(1));
+  __ Bind(&done);
+}
+
+void InstructionCodeGeneratorX86_64::GenerateProfiledClassCompare(HTypeCheckInstruction* check,
+                                                                  CpuRegister obj) {
+  // Neither class is loaded with a read barrier. A from-space and a to-space reference to
+  // the same class compare unequal, which only loses the fast path.
+  // /* HeapReference<Class> */ TMP = obj->klass_
+  __ movl(CpuRegister(TMP), Address(obj, mirror::Object::ClassOffset().Int32Value()));
+  __ MaybeUnpoisonHeapReference(CpuRegister(TMP));
+  Address address = Address::Absolute(CodeGeneratorX86_64::kDummy32BitOffset,
+                                      /* no_rip= */ true);
+  Label* fixup_label = codegen_->NewJitRootClassPatch(
+      check->GetProfiledDexFile(), check->GetProfiledTypeIndex(), check->GetProfiledClass());
+  // /* GcRoot<mirror::Class> */ TMP == *address
+  __ cmpl(CpuRegister(TMP), address);
+  // The fixup label is bound right after the instruction, like for a GC root load.
+  __ Bind(fixup_label);
+}
+
 void LocationsBuilderX86_64::VisitInstanceOf(HInstanceOf* instruction) {
   LocationSummary::CallKind call_kind = LocationSummary::kNoCall;
   TypeCheckKind type_check_kind = instruction->GetTypeCheckKind();
@@ -6361,9 +6529,16 @@ void LocationsBuilderX86_64::VisitInstanceOf(HInstanceOf* instruction) {
   } else {
     locations->SetInAt(1, Location::Any());
   }
-  // Note that TypeCheckSlowPathX86_64 uses this "out" register too.
-  locations->SetOut(Location::RequiresRegister());
+  // Note that TypeCheckSlowPathX86_64 uses this "out" register too. The profiled class
+  // check sets "out" before the inputs are used, so it must not overlap with them.
+  locations->SetOut(Location::RequiresRegister(),
+                    instruction->HasProfiledClass() ? Location::kOutputOverlap
+                                                    : Location::kNoOutputOverlap);
   locations->AddRegisterTemps(NumberOfInstanceOfTemps(type_check_kind));
+  if (codegen_->GetTypeCheckCacheFor(instruction) != nullptr) {
+    // Add a temp for the class recorded in the type check cache.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorX86_64::VisitInstanceOf(HInstanceOf* instruction) {
@@ -6391,6 +6566,17 @@ void InstructionCodeGeneratorX86_64::VisitInstanceOf(HInstanceOf* instruction) {
     __ j(kEqual, &zero);
   }
 
+  TypeCheckCache* cache = codegen_->GetTypeCheckCacheFor(instruction);
+  if (cache != nullptr) {
+    GenerateTypeCheckCacheUpdate(
+        cache, obj, locations->GetTemp(num_temps).AsRegister<CpuRegister>());
+  }
+  if (instruction->HasProfiledClass()) {
+    GenerateProfiledClassCompare(instruction, obj);
+    __ movl(out, Immediate(1));
+    __ j(kEqual, &done);
+  }
+
   switch (type_check_kind) {
     case TypeCheckKind::kExactCheck: {
       ReadBarrierOption read_barrier_option =
@@ -6641,6 +6827,10 @@ void LocationsBuilderX86_64::VisitCheckCast(HCheckCast* instruction) {
   }
   // Add temps for read barriers and other uses. One is used by TypeCheckSlowPathX86.
   locations->AddRegisterTemps(NumberOfCheckCastTemps(type_check_kind));
+  if (codegen_->GetTypeCheckCacheFor(instruction) != nullptr) {
+    // Add a temp for the class recorded in the type check cache.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorX86_64::VisitCheckCast(HCheckCast* instruction) {
@@ -6678,6 +6868,16 @@ void InstructionCodeGeneratorX86_64::VisitCheckCast(HCheckCast* instruction) {
     __ j(kEqual, &done);
   }
 
+  TypeCheckCache* cache = codegen_->GetTypeCheckCacheFor(instruction);
+  if (cache != nullptr) {
+    GenerateTypeCheckCacheUpdate(
+        cache, obj, locations->GetTemp(num_temps).AsRegister<CpuRegister>());
+  }
+  if (instruction->HasProfiledClass()) {
+    GenerateProfiledClassCompare(instruction, obj);
+    __ j(kEqual, &done);
+  }
+
   switch (type_check_kind) {
     case TypeCheckKind::kExactCheck:
     case TypeCheckKind::kArrayCheck: {
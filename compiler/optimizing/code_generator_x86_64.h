@@ -33,6 +33,9 @@ static constexpr size_t kX86_64WordSize = static_cast<size_t>(kX86_64PointerSize
 // Some x86_64 instructions require a register to be available as temp.
 static constexpr Register TMP = R11;
 
+// Use 256-bit (YMM) vectors instead of 128-bit SSE vectors on CPUs with AVX2.
+static constexpr bool kX86_64AllowAVX2Vectors = true;
+
 static constexpr Register kParameterCoreRegisters[] = { RSI, RDX, RCX, R8, R9 };
 static constexpr FloatRegister kParameterFloatRegisters[] =
     { XMM0, XMM1, XMM2, XMM3, XMM4, XMM5, XMM6, XMM7 };
@@ -142,7 +145,8 @@ class ParallelMoveResolverX86_64 : public ParallelMoveResolverWithSwap {
   void Exchange64(CpuRegister reg1, CpuRegister reg2);
   void Exchange64(CpuRegister reg, int mem);
   void Exchange64(XmmRegister reg, int mem);
-  void Exchange128(XmmRegister reg, int mem);
+  // Exchanges a full SIMD register with a SIMD stack slot.
+  void ExchangeSIMD(XmmRegister reg, int mem);
   void ExchangeMemory32(int mem1, int mem2);
   void ExchangeMemory64(int mem1, int mem2, int num_of_qwords);
 
@@ -170,7 +174,7 @@ class LocationsBuilderX86_64 : public HGraphVisitor {
                << " (id " << instruction->GetId() << ")";
   }
 
- private:
+ protected:
   void HandleInvoke(HInvoke* invoke);
   void HandleBitwiseOperation(HBinaryOperation* operation);
   void HandleCondition(HCondition* condition);
@@ -206,13 +210,28 @@ class InstructionCodeGeneratorX86_64 : public InstructionCodeGenerator {
 
   X86_64Assembler* GetAssembler() const { return assembler_; }
 
- private:
+  // Generate a GC root reference load:
+  //
+  //   root <- *address
+  //
+  // while honoring read barriers based on read_barrier_option.
+  void GenerateGcRootFieldLoad(HInstruction* instruction,
+                               Location root,
+                               const Address& address,
+                               Label* fixup_label,
+                               ReadBarrierOption read_barrier_option);
+
+ protected:
   // Generate code for the given suspend check. If not null, `successor`
   // is the block to branch to if the suspend check is not needed, and after
   // the suspend call.
   void GenerateSuspendCheck(HSuspendCheck* instruction, HBasicBlock* successor);
   void GenerateClassInitializationCheck(SlowPathCode* slow_path, CpuRegister class_reg);
   void GenerateBitstringTypeCheckCompare(HTypeCheckInstruction* check, CpuRegister temp);
+  // Record the class of `obj` in the type check cache of a baseline compiled `check`.
+  void GenerateTypeCheckCacheUpdate(TypeCheckCache* cache, CpuRegister obj, CpuRegister temp);
+  // Compare the class of `obj` with the profiled class of `check`, setting the flags.
+  void GenerateProfiledClassCompare(HTypeCheckInstruction* check, CpuRegister obj);
   void HandleBitwiseOperation(HBinaryOperation* operation);
   void GenerateRemFP(HRem* rem);
   void DivRemOneOrMinusOne(HBinaryOperation* instruction);
@@ -261,17 +280,6 @@ class InstructionCodeGeneratorX86_64 : public InstructionCodeGenerator {
                                          Location obj,
                                          uint32_t offset,
                                          ReadBarrierOption read_barrier_option);
-  // Generate a GC root reference load:
-  //
-  //   root <- *address
-  //
-  // while honoring read barriers based on read_barrier_option.
-  void GenerateGcRootFieldLoad(HInstruction* instruction,
-                               Location root,
-                               const Address& address,
-                               Label* fixup_label,
-                               ReadBarrierOption read_barrier_option);
-
   void PushOntoFPStack(Location source, uint32_t temp_offset,
                        uint32_t stack_adjustment, bool is_float);
   void GenerateCompareTest(HCondition* condition);
@@ -298,6 +306,39 @@ class InstructionCodeGeneratorX86_64 : public InstructionCodeGenerator {
   DISALLOW_COPY_AND_ASSIGN(InstructionCodeGeneratorX86_64);
 };
 
+// Vector code generation with 256-bit AVX2 (VEX.256) instructions; the scalar part is shared
+// with the SSE code generator.
+class InstructionCodeGeneratorX86_64Avx2 : public InstructionCodeGeneratorX86_64 {
+ public:
+  InstructionCodeGeneratorX86_64Avx2(HGraph* graph, CodeGeneratorX86_64* codegen)
+      : InstructionCodeGeneratorX86_64(graph, codegen) {}
+
+#define DECLARE_VISIT_INSTRUCTION(name, super) \
+  void Visit##name(H##name* instr) override;
+
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR_COMMON(DECLARE_VISIT_INSTRUCTION)
+
+#undef DECLARE_VISIT_INSTRUCTION
+
+ private:
+  // Validate that the instruction vector length and packed type are compliant with the SIMD
+  // register size (full SIMD register is used).
+  bool ValidateVectorLength(HVecOperation* instr) const;
+};
+
+class LocationsBuilderX86_64Avx2 : public LocationsBuilderX86_64 {
+ public:
+  LocationsBuilderX86_64Avx2(HGraph* graph, CodeGeneratorX86_64* codegen)
+      : LocationsBuilderX86_64(graph, codegen) {}
+
+#define DECLARE_VISIT_INSTRUCTION(name, super) \
+  void Visit##name(H##name* instr) override;
+
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR_COMMON(DECLARE_VISIT_INSTRUCTION)
+
+#undef DECLARE_VISIT_INSTRUCTION
+};
+
 // Class for fixups to jump tables.
 class JumpTableRIPFixup;
 
@@ -349,15 +390,15 @@ class CodeGeneratorX86_64 : public CodeGenerator {
   }
 
   size_t GetSIMDRegisterWidth() const override {
-    return 2 * kX86_64WordSize;
+    return ShouldUseAVX2Vectors() ? 4 * kX86_64WordSize : 2 * kX86_64WordSize;
   }
 
   HGraphVisitor* GetLocationBuilder() override {
-    return &location_builder_;
+    return location_builder_;
   }
 
   HGraphVisitor* GetInstructionVisitor() override {
-    return &instruction_visitor_;
+    return instruction_visitor_;
   }
 
   X86_64Assembler* GetAssembler() override {
@@ -387,6 +428,13 @@ class CodeGeneratorX86_64 : public CodeGenerator {
 
   const X86_64InstructionSetFeatures& GetInstructionSetFeatures() const;
 
+  // Whether vector code uses 256-bit YMM registers (see kX86_64AllowAVX2Vectors).
+  bool ShouldUseAVX2Vectors() const;
+
+  // Clears the upper halves of the YMM registers before leaving 256-bit vector code, so
+  // that SSE code in the callee or caller does not pay the AVX-SSE transition penalty.
+  void MaybeEmitVZeroUpper();
+
   // Emit a write barrier.
   void MarkGCCard(CpuRegister temp,
                   CpuRegister card,
@@ -621,8 +669,13 @@ class CodeGeneratorX86_64 : public CodeGenerator {
   // Labels for each block that will be compiled.
   Label* block_labels_;  // Indexed by block id.
   Label frame_entry_label_;
-  LocationsBuilderX86_64 location_builder_;
-  InstructionCodeGeneratorX86_64 instruction_visitor_;
+  LocationsBuilderX86_64 location_builder_sse_;
+  LocationsBuilderX86_64Avx2 location_builder_avx2_;
+  InstructionCodeGeneratorX86_64 instruction_visitor_sse_;
+  InstructionCodeGeneratorX86_64Avx2 instruction_visitor_avx2_;
+  // The visitors in use, selected by ShouldUseAVX2Vectors().
+  LocationsBuilderX86_64* location_builder_;
+  InstructionCodeGeneratorX86_64* instruction_visitor_;
   ParallelMoveResolverX86_64 move_resolver_;
   X86_64Assembler assembler_;
 
@@ -31,8 +31,7 @@ bool CodeSinking::Run() {
     // Infinite loop, just bail.
     return false;
   }
-  // TODO(ngeoffray): we do not profile branches yet, so use throw instructions
-  // as an indicator of an uncommon branch.
+  // Use throw instructions as an indicator of an uncommon branch.
   for (HBasicBlock* exit_predecessor : exit->GetPredecessors()) {
     HInstruction* last = exit_predecessor->GetLastInstruction();
     // Any predecessor of the exit that does not return, throws an exception.
@@ -40,6 +39,26 @@ bool CodeSinking::Run() {
       SinkCodeToUncommonBranch(exit_predecessor);
     }
   }
+  // Also use branches that the JIT profile shows are almost never taken. Collect the
+  // successors first, as sinking code inserts instructions in them.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HBasicBlock*> unlikely_successors(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    HInstruction* last = block->GetLastInstruction();
+    if (!last->IsIf()) {
+      continue;
+    }
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      if (successor->GetPredecessors().size() == 1u &&
+          !successor->IsLoopHeader() &&
+          last->AsIf()->IsUnlikelySuccessor(successor)) {
+        unlikely_successors.push_back(successor);
+      }
+    }
+  }
+  for (HBasicBlock* successor : unlikely_successors) {
+    SinkCodeToUncommonBranch(successor);
+  }
   return true;
 }
 
@@ -17,13 +17,16 @@
 #include <functional>
 #include <memory>
 
+#include "base/casts.h"
 #include "base/macros.h"
+#include "base/mem_map.h"
 #include "base/utils.h"
 #include "builder.h"
 #include "codegen_test_utils.h"
 #include "dex/dex_file.h"
 #include "dex/dex_instruction.h"
 #include "driver/compiler_options.h"
+#include "mirror/array.h"
 #include "nodes.h"
 #include "optimizing_unit_test.h"
 #include "register_allocator_linear_scan.h"
@@ -900,6 +903,167 @@ TEST_F(CodegenTest, ARM64FrameSizeNoSIMD) {
   EXPECT_EQ(codegen.GetFpuSpillSize(), kExpectedFPSpillSize);
 }
 
+
+// Check the predicated vector loop generated by the loop optimizer in SVE mode:
+//
+//   for (int i = 0; i < 13; i += 4) {
+//     a[i : i + 3] += 100;  // Predicated by the loop predicate.
+//   }
+//   return i;
+//
+// The code is run on the simulator for several SVE vector lengths, as it must be correct for
+// any length the hardware implements, see InstructionCodeGeneratorARM64Sve::VisitVecPredWhile.
+TEST_F(CodegenTest, ARM64SvePredicatedLoop) {
+  if (!CodeSimulatorContainer(InstructionSet::kArm64).CanSimulate()) {
+    return;
+  }
+  constexpr int32_t kTripCount = 13;
+  constexpr int32_t kIncrement = 100;
+  constexpr size_t kVectorLength = vixl::aarch64::kQRegSizeInBytes / sizeof(int32_t);
+  // The first multiple of the vector length not below the trip count.
+  constexpr int32_t kExitIndex = 16;
+  // Elements past the trip count, which must not be written by the disabled vector lanes.
+  constexpr size_t kArrayLength = kTripCount + 16u;
+
+  // The array lives in the low 4GB, as the generated code addresses it with a 32-bit reference.
+  MemMap::Init();
+  std::string error_msg;
+  MemMap array_map = MemMap::MapAnonymous("int array",
+                                          kPageSize,
+                                          PROT_READ | PROT_WRITE,
+                                          /*low_4gb=*/ true,
+                                          &error_msg);
+  ASSERT_TRUE(array_map.IsValid()) << error_msg;
+  int32_t* array_data = reinterpret_cast<int32_t*>(
+      array_map.Begin() + mirror::Array::DataOffset(sizeof(int32_t)).Uint32Value());
+
+  for (size_t vector_length_in_bits : {128u, 256u, 384u, 512u}) {
+    ResetPoolAndAllocator();
+    HGraph* graph = CreateGraph();
+    graph->SetHasSIMD(true);
+    ArenaAllocator* allocator = GetAllocator();
+
+    HBasicBlock* entry_block = new (allocator) HBasicBlock(graph);
+    HBasicBlock* preheader = new (allocator) HBasicBlock(graph);
+    HBasicBlock* header = new (allocator) HBasicBlock(graph);
+    HBasicBlock* body = new (allocator) HBasicBlock(graph);
+    HBasicBlock* return_block = new (allocator) HBasicBlock(graph);
+    HBasicBlock* exit_block = new (allocator) HBasicBlock(graph);
+    for (HBasicBlock* block : {entry_block, preheader, header, body, return_block, exit_block}) {
+      graph->AddBlock(block);
+    }
+    graph->SetEntryBlock(entry_block);
+    graph->SetExitBlock(exit_block);
+    entry_block->AddSuccessor(preheader);
+    preheader->AddSuccessor(header);
+    header->AddSuccessor(return_block);
+    header->AddSuccessor(body);
+    body->AddSuccessor(header);
+    return_block->AddSuccessor(exit_block);
+
+    HIntConstant* array = graph->GetIntConstant(
+        static_cast<int32_t>(reinterpret_cast32<uint32_t>(array_map.Begin())));
+    HIntConstant* zero = graph->GetIntConstant(0);
+    HIntConstant* trip_count = graph->GetIntConstant(kTripCount);
+    entry_block->AddInstruction(new (allocator) HGoto());
+
+    HVecPredSetAll* set_all = new (allocator) HVecPredSetAll(
+        allocator, graph->GetIntConstant(1), DataType::Type::kInt32, kVectorLength, kNoDexPc);
+    HVecReplicateScalar* increment = new (allocator) HVecReplicateScalar(
+        allocator, graph->GetIntConstant(kIncrement), DataType::Type::kInt32, kVectorLength,
+        kNoDexPc);
+    increment->SetMergingGoverningPredicate(set_all);
+    preheader->AddInstruction(set_all);
+    preheader->AddInstruction(increment);
+    preheader->AddInstruction(new (allocator) HGoto());
+
+    HPhi* phi = new (allocator) HPhi(allocator, 0, 0, DataType::Type::kInt32);
+    HSuspendCheck* suspend_check = new (allocator) HSuspendCheck();
+    HVecPredWhile* loop_predicate = new (allocator) HVecPredWhile(allocator,
+                                                                  phi,
+                                                                  trip_count,
+                                                                  HVecPredWhile::CondKind::kLO,
+                                                                  DataType::Type::kInt32,
+                                                                  kVectorLength,
+                                                                  kNoDexPc);
+    HVecPredCondition* cond =
+        new (allocator) HVecPredCondition(allocator,
+                                          loop_predicate,
+                                          HVecPredCondition::PCondKind::kNFirst,
+                                          DataType::Type::kInt32,
+                                          kVectorLength,
+                                          kNoDexPc);
+    header->AddPhi(phi);
+    header->AddInstruction(suspend_check);
+    header->AddInstruction(loop_predicate);
+    header->AddInstruction(cond);
+    header->AddInstruction(new (allocator) HIf(cond));
+    ArenaVector<HInstruction*> current_locals({phi}, allocator->Adapter(kArenaAllocInstruction));
+    ManuallyBuildEnvFor(suspend_check, &current_locals);
+
+    HVecLoad* load = new (allocator) HVecLoad(allocator,
+                                              array,
+                                              phi,
+                                              DataType::Type::kInt32,
+                                              SideEffects::ArrayReadOfType(DataType::Type::kInt32),
+                                              kVectorLength,
+                                              /*is_string_char_at=*/ false,
+                                              kNoDexPc);
+    HVecAdd* add = new (allocator) HVecAdd(
+        allocator, load, increment, DataType::Type::kInt32, kVectorLength, kNoDexPc);
+    HVecStore* store =
+        new (allocator) HVecStore(allocator,
+                                  array,
+                                  phi,
+                                  add,
+                                  DataType::Type::kInt32,
+                                  SideEffects::ArrayWriteOfType(DataType::Type::kInt32),
+                                  kVectorLength,
+                                  kNoDexPc);
+    HAdd* next = new (allocator) HAdd(
+        DataType::Type::kInt32, phi, graph->GetIntConstant(static_cast<int32_t>(kVectorLength)));
+    load->SetMergingGoverningPredicate(loop_predicate);
+    add->SetMergingGoverningPredicate(loop_predicate);
+    store->SetMergingGoverningPredicate(loop_predicate);
+    body->AddInstruction(load);
+    body->AddInstruction(add);
+    body->AddInstruction(store);
+    body->AddInstruction(next);
+    body->AddInstruction(new (allocator) HGoto());
+    phi->AddInput(zero);
+    phi->AddInput(next);
+
+    return_block->AddInstruction(new (allocator) HReturn(phi));
+    exit_block->AddInstruction(new (allocator) HExit());
+
+    ASSERT_EQ(graph->BuildDominatorTree(), kAnalysisSuccess);
+    std::unique_ptr<CompilerOptions> compiler_options =
+        CommonCompilerTest::CreateCompilerOptions(InstructionSet::kArm64, "default", "sve");
+    TestCodeGeneratorARM64 codegen(graph, *compiler_options);
+    // SVE is not enabled by default, see kArm64AllowSVE.
+    codegen.EnableSVEForTesting();
+    ASSERT_TRUE(codegen.SupportsPredicatedSIMD());
+    GraphChecker graph_checker(graph, &codegen);
+    graph_checker.Run();
+    ASSERT_TRUE(graph_checker.IsValid());
+    // Remove suspend checks, they cannot be executed in this context.
+    RemoveSuspendChecks(graph);
+
+    for (size_t i = 0; i < kArrayLength; ++i) {
+      array_data[i] = dchecked_integral_cast<int32_t>(i);
+    }
+    RunCodeOnSimulator(&codegen, graph, vector_length_in_bits, kExitIndex);
+    for (size_t i = 0; i < kArrayLength; ++i) {
+      int32_t expected = dchecked_integral_cast<int32_t>(i);
+      if (i < static_cast<size_t>(kTripCount)) {
+        expected += kIncrement;
+      }
+      ASSERT_EQ(array_data[i], expected)
+          << "element " << i << " with a vector length of " << vector_length_in_bits;
+    }
+  }
+}
+
 #endif
 
 }  // namespace art
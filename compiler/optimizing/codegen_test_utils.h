@@ -130,6 +130,8 @@ class TestCodeGeneratorARM64 : public arm64::CodeGeneratorARM64 {
   TestCodeGeneratorARM64(HGraph* graph, const CompilerOptions& compiler_options)
       : arm64::CodeGeneratorARM64(graph, compiler_options) {}
 
+  using arm64::CodeGeneratorARM64::EnableSVEForTesting;
+
   void MaybeGenerateMarkingRegisterCheck(int codem ATTRIBUTE_UNUSED,
                                          Location temp_loc ATTRIBUTE_UNUSED) override {
     // When turned on, the marking register checks in
@@ -269,21 +271,23 @@ static void ValidateGraph(HGraph* graph) {
   ASSERT_TRUE(graph_checker.IsValid());
 }
 
+static void AllocateRegisters(CodeGenerator* codegen, HGraph* graph) {
+  ScopedArenaAllocator local_allocator(graph->GetArenaStack());
+  SsaLivenessAnalysis liveness(graph, codegen, &local_allocator);
+  PrepareForRegisterAllocation(graph, codegen->GetCompilerOptions()).Run();
+  liveness.Analyze();
+  std::unique_ptr<RegisterAllocator> register_allocator =
+      RegisterAllocator::Create(&local_allocator, codegen, liveness);
+  register_allocator->AllocateRegisters();
+}
+
 template <typename Expected>
 static void RunCodeNoCheck(CodeGenerator* codegen,
                            HGraph* graph,
                            const std::function<void(HGraph*)>& hook_before_codegen,
                            bool has_result,
                            Expected expected) {
-  {
-    ScopedArenaAllocator local_allocator(graph->GetArenaStack());
-    SsaLivenessAnalysis liveness(graph, codegen, &local_allocator);
-    PrepareForRegisterAllocation(graph, codegen->GetCompilerOptions()).Run();
-    liveness.Analyze();
-    std::unique_ptr<RegisterAllocator> register_allocator =
-        RegisterAllocator::Create(&local_allocator, codegen, liveness);
-    register_allocator->AllocateRegisters();
-  }
+  AllocateRegisters(codegen, graph);
   hook_before_codegen(graph);
   InternalCodeAllocator allocator;
   codegen->Compile(&allocator);
@@ -312,6 +316,27 @@ static void RunCode(CodegenTargetConfig target_config,
   RunCode(codegen.get(), graph, hook_before_codegen, has_result, expected);
 }
 
+// Run the code only on the simulator, with the given length of the scalable vector registers
+// (e.g. ARM64 SVE). The hardware may not implement the vector extension the code uses.
+template <typename Expected>
+static void RunCodeOnSimulator(CodeGenerator* codegen,
+                               HGraph* graph,
+                               size_t vector_length_in_bits,
+                               Expected expected) {
+  AllocateRegisters(codegen, graph);
+  InternalCodeAllocator allocator;
+  codegen->Compile(&allocator);
+
+  typedef Expected (*fptr)();
+  CommonCompilerTest::MakeExecutable(allocator.GetMemory().data(), allocator.GetMemory().size());
+  fptr f = reinterpret_cast<fptr>(reinterpret_cast<uintptr_t>(allocator.GetMemory().data()));
+  CodeSimulatorContainer simulator(codegen->GetInstructionSet());
+  ASSERT_TRUE(simulator.CanSimulate());
+  simulator.Get()->SetVectorLengthInBits(vector_length_in_bits);
+  Expected result = SimulatorExecute<Expected>(simulator.Get(), f);
+  ASSERT_EQ(expected, result);
+}
+
 #ifdef ART_ENABLE_CODEGEN_arm
 CodeGenerator* create_codegen_arm_vixl32(HGraph* graph, const CompilerOptions& compiler_options) {
   return new (graph->GetAllocator()) TestCodeGeneratorARMVIXL(graph, compiler_options);
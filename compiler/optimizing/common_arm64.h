@@ -102,6 +102,16 @@ inline vixl::aarch64::VRegister VRegisterFrom(Location location) {
   return vixl::aarch64::VRegister(location.reg());
 }
 
+inline vixl::aarch64::ZRegister ZRegisterFrom(Location location) {
+  DCHECK(location.IsFpuRegister()) << location;
+  return vixl::aarch64::ZRegister(location.reg());
+}
+
+inline vixl::aarch64::PRegister PRegisterFrom(Location location) {
+  DCHECK(location.IsPredicateRegister()) << location;
+  return vixl::aarch64::PRegister(location.reg());
+}
+
 inline vixl::aarch64::VRegister SRegisterFrom(Location location) {
   DCHECK(location.IsFpuRegister()) << location;
   return vixl::aarch64::SRegister(location.reg());
@@ -210,6 +220,10 @@ inline Location LocationFrom(const vixl::aarch64::VRegister& fpreg) {
   return Location::FpuRegisterLocation(fpreg.GetCode());
 }
 
+inline Location LocationFrom(const vixl::aarch64::PRegister& preg) {
+  return Location::PredicateRegisterLocation(preg.GetCode());
+}
+
 inline vixl::aarch64::Operand OperandFromMemOperand(
     const vixl::aarch64::MemOperand& mem_op) {
   if (mem_op.IsImmediateOffset()) {
@@ -315,6 +315,8 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
       codegen_.DumpCoreRegister(stream, location.low());
       stream << "|";
       codegen_.DumpCoreRegister(stream, location.high());
+    } else if (location.IsPredicateRegister()) {
+      stream << "p" << location.reg();
     } else if (location.IsUnallocated()) {
       stream << "unallocated";
     } else if (location.IsDoubleStackSlot()) {
@@ -491,6 +493,7 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
   void VisitInvokePolymorphic(HInvokePolymorphic* invoke) override {
     VisitInvoke(invoke);
     StartAttributeStream("invoke_type") << "InvokePolymorphic";
+    StartAttributeStream("intrinsic") << invoke->GetIntrinsic();
   }
 
   void VisitInstanceFieldGet(HInstanceFieldGet* iget) override {
@@ -21,6 +21,7 @@
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "base/utils.h"
+#include "load_store_analysis.h"
 #include "side_effects_analysis.h"
 
 namespace art {
@@ -130,6 +131,16 @@ class ValueSet : public ArenaObject<kArenaAllocGvn> {
     });
   }
 
+  // Removes all instructions in the set affected by the given side effects for
+  // which `may_be_killed` also returns true.
+  template<typename Functor>
+  void Kill(SideEffects side_effects, Functor may_be_killed) {
+    DeleteAllImpureWhich([side_effects, may_be_killed](Node* node) {
+      return node->GetSideEffects().MayDependOn(side_effects) &&
+             may_be_killed(node->GetInstruction());
+    });
+  }
+
   void Clear() {
     num_entries_ = 0;
     for (size_t i = 0; i < num_buckets_; ++i) {
@@ -358,6 +369,8 @@ class GlobalValueNumberer : public ValueObject {
       : graph_(graph),
         allocator_(graph->GetArenaStack()),
         side_effects_(side_effects),
+        heap_alias_info_(graph, &allocator_),
+        has_heap_alias_info_(false),
         sets_(graph->GetBlocks().size(), nullptr, allocator_.Adapter(kArenaAllocGvn)),
         visited_blocks_(
             &allocator_, graph->GetBlocks().size(), /* expandable= */ false, kArenaAllocGvn) {
@@ -375,6 +388,10 @@ class GlobalValueNumberer : public ValueObject {
   ScopedArenaAllocator allocator_;
   const SideEffectsAnalysis& side_effects_;
 
+  // Aliasing of heap locations, used to keep loads across unrelated stores.
+  HeapAliasInfo heap_alias_info_;
+  bool has_heap_alias_info_;
+
   ValueSet* FindSetFor(HBasicBlock* block) const {
     ValueSet* result = sets_[block->GetBlockId()];
     DCHECK(result != nullptr) << "Could not find set for block B" << block->GetBlockId();
@@ -411,6 +428,7 @@ class GlobalValueNumberer : public ValueObject {
 
 bool GlobalValueNumberer::Run() {
   DCHECK(side_effects_.HasRun());
+  has_heap_alias_info_ = heap_alias_info_.Run();
   sets_[graph_->GetEntryBlock()->GetBlockId()] = new (&allocator_) ValueSet(&allocator_);
 
   // Use the reverse post order to ensure the non back-edge predecessors of a block are
@@ -470,7 +488,14 @@ void GlobalValueNumberer::VisitBasicBlock(HBasicBlock* block) {
         } else {
           DCHECK(!block->GetLoopInformation()->IsIrreducible());
           DCHECK_EQ(block->GetDominator(), block->GetLoopInformation()->GetPreHeader());
-          set->Kill(side_effects_.GetLoopEffects(block));
+          HLoopInformation* loop_info = block->GetLoopInformation();
+          if (has_heap_alias_info_) {
+            set->Kill(side_effects_.GetLoopEffects(block), [this, loop_info](HInstruction* load) {
+              return heap_alias_info_.IsKilledByLoop(load, loop_info);
+            });
+          } else {
+            set->Kill(side_effects_.GetLoopEffects(block));
+          }
         }
       } else if (predecessors.size() > 1) {
         for (HBasicBlock* predecessor : predecessors) {
@@ -515,6 +540,10 @@ void GlobalValueNumberer::VisitBasicBlock(HBasicBlock* block) {
         set->Kill(current->GetSideEffects());
         set->Add(current);
       }
+    } else if (has_heap_alias_info_ && current->DoesAnyWrite()) {
+      set->Kill(current->GetSideEffects(), [this, current](HInstruction* load) {
+        return heap_alias_info_.MayAlias(load, current);
+      });
     } else {
       set->Kill(current->GetSideEffects());
     }
@@ -19,6 +19,7 @@
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/logging.h"
+#include "base/scoped_arena_allocator.h"
 #include "builder.h"
 #include "class_linker.h"
 #include "class_root-inl.h"
@@ -68,6 +69,24 @@ static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
+// At megamorphic call sites, the number of receiver types we try to inline, and the
+// percentage of the recorded receivers a type must account for to be inlined.
+static constexpr size_t kMaximumNumberOfMegamorphicTargets = 2;
+static constexpr uint32_t kMegamorphicTargetMinimumPercentage = 30;
+
+// Controls ranking call sites by their profiled hotness: hot call sites get the instruction
+// budget first and may inline more deeply, and call sites the profile shows are not executed
+// are not inlined.
+static constexpr bool kUseCallSiteHotness = true;
+
+// A call site is hot if it was executed at least that many times, and at least that
+// percentage of the number of times the hottest call site of the method was executed.
+static constexpr uint64_t kMinimumHotCallSiteCount = 100u;
+static constexpr uint32_t kHotCallSiteMinimumPercentage = 10;
+
+// Limit of the dex registers accumulated while inlining a chain of hot calls.
+static constexpr size_t kMaximumNumberOfCumulatedDexRegistersForHotCalls = 64;
+
 // We check for line numbers to make sure the DepthString implementation
 // aligns the output nicely.
 #define LOG_INTERNAL(msg) \
@@ -159,44 +178,163 @@ bool HInliner::Run() {
   const bool honor_inline_directives =
       honor_noinline_directives && Runtime::Current()->IsAotCompiler();
 
-  // Keep a copy of all blocks when starting the visit.
-  ArenaVector<HBasicBlock*> blocks = graph_->GetReversePostOrder();
-  DCHECK(!blocks.empty());
-  // Because we are changing the graph when inlining,
-  // we just iterate over the blocks of the outer method.
-  // This avoids doing the inlining work again on the inlined blocks.
-  for (HBasicBlock* block : blocks) {
-    for (HInstruction* instruction = block->GetFirstInstruction(); instruction != nullptr;) {
-      HInstruction* next = instruction->GetNext();
-      HInvoke* call = instruction->AsInvoke();
+  // Collect the calls before inlining any of them. Because we are changing the graph
+  // when inlining, we just collect the calls of the outer method. This avoids doing the
+  // inlining work again on the inlined blocks.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<CallSite> call_sites(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInvoke* call = it.Current()->AsInvoke();
       // As long as the call is not intrinsified, it is worth trying to inline.
       if (call != nullptr && call->GetIntrinsic() == Intrinsics::kNone) {
-        if (honor_noinline_directives) {
-          // Debugging case: directives in method names control or assert on inlining.
-          std::string callee_name = outer_compilation_unit_.GetDexFile()->PrettyMethod(
-              call->GetDexMethodIndex(), /* with_signature= */ false);
-          // Tests prevent inlining by having $noinline$ in their method names.
-          if (callee_name.find("$noinline$") == std::string::npos) {
-            if (TryInline(call)) {
-              didInline = true;
-            } else if (honor_inline_directives) {
-              bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
-              CHECK(!should_have_inlined) << "Could not inline " << callee_name;
-            }
+        call_sites.push_back(CallSite{call, kCallSiteUnknown, /* count= */ 0u});
+      }
+    }
+  }
+  if (kUseCallSiteHotness) {
+    RankCallSites(&call_sites);
+  }
+
+  for (const CallSite& call_site : call_sites) {
+    HInvoke* call = call_site.invoke;
+    if (honor_noinline_directives) {
+      // Debugging case: directives in method names control or assert on inlining.
+      std::string callee_name = outer_compilation_unit_.GetDexFile()->PrettyMethod(
+          call->GetDexMethodIndex(), /* with_signature= */ false);
+      // Tests prevent inlining by having $noinline$ in their method names.
+      if (callee_name.find("$noinline$") == std::string::npos) {
+        bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
+        if (TryInlineCallSite(call_site, /* skip_if_cold= */ !should_have_inlined)) {
+          didInline = true;
+        } else if (honor_inline_directives) {
+          CHECK(!should_have_inlined) << "Could not inline " << callee_name;
+        }
+      }
+    } else {
+      DCHECK(!honor_inline_directives);
+      // Normal case: try to inline.
+      if (TryInlineCallSite(call_site, /* skip_if_cold= */ true)) {
+        didInline = true;
+      }
+    }
+  }
+
+  return didInline;
+}
+
+// Returns whether the profile shows that `block` is (almost) never executed, because
+// it is dominated by an unlikely successor of a branch. Only dominators in the same
+// loop as `block` are considered, as they are executed at least as often as `block`.
+static bool IsInColdRegion(HBasicBlock* block) {
+  HLoopInformation* loop_info = block->GetLoopInformation();
+  for (HBasicBlock* current = block;
+       current != nullptr && current->GetLoopInformation() == loop_info;
+       current = current->GetDominator()) {
+    if (current->GetPredecessors().size() == 1u) {
+      HInstruction* last = current->GetSinglePredecessor()->GetLastInstruction();
+      if (last->IsIf() && last->AsIf()->IsUnlikelySuccessor(current)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void HInliner::RankCallSites(ScopedArenaVector<CallSite>* call_sites) {
+  ScopedObjectAccess soa(Thread::Current());
+  // The Zygote JIT compiles based on a profile, so we shouldn't use runtime inline caches
+  // for it.
+  if (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote()) {
+    // The offline profile only records which call sites saw receiver types, without
+    // counts. Absence is not a sign of a cold call site, as the types may not have been
+    // recordable, so we only use it to rank the recorded call sites first.
+    const ProfileCompilationInfo* pci =
+        codegen_->GetCompilerOptions().GetProfileCompilationInfo();
+    if (pci == nullptr || !kUseAOTInlineCaches) {
+      return;
+    }
+    std::unique_ptr<ProfileCompilationInfo::OfflineProfileMethodInfo> offline_profile =
+        pci->GetHotMethodInfo(MethodReference(caller_compilation_unit_.GetDexFile(),
+                                              caller_compilation_unit_.GetDexMethodIndex()));
+    if (offline_profile == nullptr) {
+      return;
+    }
+    for (CallSite& call_site : *call_sites) {
+      if (offline_profile->inline_caches->find(call_site.invoke->GetDexPc()) !=
+              offline_profile->inline_caches->end()) {
+        call_site.hotness = kCallSiteWarm;
+      }
+    }
+  } else {
+    ArtMethod* caller = graph_->GetArtMethod();
+    // Under JIT, we should always know the caller.
+    DCHECK(caller != nullptr);
+    ScopedProfilingInfoInlineUse spiis(caller, Thread::Current());
+    ProfilingInfo* profiling_info = spiis.GetProfilingInfo();
+    if (profiling_info != nullptr) {
+      // Only trust the counts of the inline caches if the method saw enough calls.
+      uint64_t total_count = 0u;
+      for (CallSite& call_site : *call_sites) {
+        HInvoke* invoke = call_site.invoke;
+        if (invoke->IsInvokeVirtual() || invoke->IsInvokeInterface()) {
+          call_site.count =
+              profiling_info->GetInlineCache(invoke->GetDexPc())->GetApproximateCount();
+          total_count += call_site.count;
+        }
+      }
+      if (total_count >= kMinimumHotCallSiteCount) {
+        uint64_t max_count = 0u;
+        for (const CallSite& call_site : *call_sites) {
+          max_count = std::max(max_count, call_site.count);
+        }
+        for (CallSite& call_site : *call_sites) {
+          HInvoke* invoke = call_site.invoke;
+          if (!invoke->IsInvokeVirtual() && !invoke->IsInvokeInterface()) {
+            continue;
           }
-        } else {
-          DCHECK(!honor_inline_directives);
-          // Normal case: try to inline.
-          if (TryInline(call)) {
-            didInline = true;
+          if (call_site.count == 0u) {
+            call_site.hotness = kCallSiteCold;
+          } else if (call_site.count >= kMinimumHotCallSiteCount &&
+                     call_site.count * 100u >= max_count * kHotCallSiteMinimumPercentage) {
+            call_site.hotness = kCallSiteHot;
+          } else {
+            call_site.hotness = kCallSiteWarm;
           }
         }
       }
-      instruction = next;
+    }
+    // Branch profiles tell us about call sites without inline caches too.
+    for (CallSite& call_site : *call_sites) {
+      if (IsInColdRegion(call_site.invoke->GetBlock())) {
+        call_site.hotness = kCallSiteCold;
+      }
     }
   }
 
-  return didInline;
+  std::stable_sort(call_sites->begin(),
+                   call_sites->end(),
+                   [](const CallSite& lhs, const CallSite& rhs) {
+                     if (lhs.hotness != rhs.hotness) {
+                       return lhs.hotness > rhs.hotness;
+                     }
+                     return lhs.hotness == kCallSiteHot && lhs.count > rhs.count;
+                   });
+}
+
+bool HInliner::TryInlineCallSite(const CallSite& call_site, bool skip_if_cold) {
+  if (skip_if_cold && call_site.hotness == kCallSiteCold) {
+    LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedColdCallSite)
+        << "Call to "
+        << caller_compilation_unit_.GetDexFile()->PrettyMethod(
+               call_site.invoke->GetDexMethodIndex())
+        << " is not inlined because the profile shows it is not executed";
+    return false;
+  }
+  inlining_hot_call_site_ = (call_site.hotness == kCallSiteHot);
+  bool result = TryInline(call_site.invoke);
+  inlining_hot_call_site_ = false;
+  return result;
 }
 
 static bool IsMethodOrDeclaringClassFinal(ArtMethod* method)
@@ -288,37 +426,6 @@ static uint32_t FindMethodIndexIn(ArtMethod* method,
   }
 }
 
-static dex::TypeIndex FindClassIndexIn(ObjPtr<mirror::Class> cls,
-                                       const DexCompilationUnit& compilation_unit)
-    REQUIRES_SHARED(Locks::mutator_lock_) {
-  const DexFile& dex_file = *compilation_unit.GetDexFile();
-  dex::TypeIndex index;
-  if (cls->GetDexCache() == nullptr) {
-    DCHECK(cls->IsArrayClass()) << cls->PrettyClass();
-    index = cls->FindTypeIndexInOtherDexFile(dex_file);
-  } else if (!cls->GetDexTypeIndex().IsValid()) {
-    DCHECK(cls->IsProxyClass()) << cls->PrettyClass();
-    // TODO: deal with proxy classes.
-  } else if (IsSameDexFile(cls->GetDexFile(), dex_file)) {
-    DCHECK_EQ(cls->GetDexCache(), compilation_unit.GetDexCache().Get());
-    index = cls->GetDexTypeIndex();
-  } else {
-    index = cls->FindTypeIndexInOtherDexFile(dex_file);
-    // We cannot guarantee the entry will resolve to the same class,
-    // as there may be different class loaders. So only return the index if it's
-    // the right class already resolved with the class loader.
-    if (index.IsValid()) {
-      ObjPtr<mirror::Class> resolved = compilation_unit.GetClassLinker()->LookupResolvedType(
-          index, compilation_unit.GetDexCache().Get(), compilation_unit.GetClassLoader().Get());
-      if (resolved != cls) {
-        index = dex::TypeIndex::Invalid();
-      }
-    }
-  }
-
-  return index;
-}
-
 class ScopedProfilingInfoInlineUse {
  public:
   explicit ScopedProfilingInfoInlineUse(ArtMethod* method, Thread* self)
@@ -390,6 +497,10 @@ ArtMethod* HInliner::TryCHADevirtualization(ArtMethod* resolved_method) {
     // We do not support HDeoptimize in OSR methods.
     return nullptr;
   }
+  if (!outermost_graph_->CanSpeculate(DeoptimizationKind::kCHA)) {
+    // Previous code for this method was invalidated too often by class loading.
+    return nullptr;
+  }
   PointerSize pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
   ArtMethod* single_impl = resolved_method->GetSingleImplementation(pointer_size);
   if (single_impl == nullptr) {
@@ -591,7 +702,12 @@ bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
   //
   // For OSR:
   //     We may come from the interpreter and it may have seen different receiver types.
-  return Runtime::Current()->IsAotCompiler() || outermost_graph_->IsCompilingOsr();
+  //
+  // For JIT:
+  //     Previous code for this method deoptimized too often on a failed type guard.
+  return Runtime::Current()->IsAotCompiler() ||
+      outermost_graph_->IsCompilingOsr() ||
+      !outermost_graph_->CanSpeculate(DeoptimizationKind::kJitInlineCache);
 }
 bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
                                         HInvoke* invoke_instruction,
@@ -603,12 +719,14 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 
   StackHandleScope<1> hs(Thread::Current());
   Handle<mirror::ObjectArray<mirror::Class>> inline_cache;
+  // Receiver counts, only available from the runtime inline caches.
+  uint32_t counts[InlineCache::kIndividualCacheSize] = {};
   // The Zygote JIT compiles based on a profile, so we shouldn't use runtime inline caches
   // for it.
   InlineCacheType inline_cache_type =
       (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote())
           ? GetInlineCacheAOT(caller_dex_file, invoke_instruction, &hs, &inline_cache)
-          : GetInlineCacheJIT(invoke_instruction, &hs, &inline_cache);
+          : GetInlineCacheJIT(invoke_instruction, &hs, &inline_cache, counts);
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -641,11 +759,18 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
     }
 
     case kInlineCacheMegamorphic: {
+      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
+      if (KeepDominantTargets(inline_cache, counts) &&
+          TryInlinePolymorphicCall(invoke_instruction,
+                                   resolved_method,
+                                   inline_cache,
+                                   /* is_megamorphic= */ true)) {
+        return true;
+      }
       LOG_FAIL_NO_STAT()
           << "Interface or virtual call to "
           << caller_dex_file.PrettyMethod(invoke_instruction->GetDexMethodIndex())
           << " is megamorphic and not inlined";
-      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
       return false;
     }
 
@@ -663,7 +788,8 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
     StackHandleScope<1>* hs,
-    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+    /*out*/uint32_t* counts)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   DCHECK(codegen_->GetCompilerOptions().IsJitCompiler());
 
@@ -684,11 +810,59 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
   } else {
     Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(
         *profiling_info->GetInlineCache(invoke_instruction->GetDexPc()),
-        *inline_cache);
+        *inline_cache,
+        counts);
     return GetInlineCacheType(*inline_cache);
   }
 }
 
+bool HInliner::KeepDominantTargets(Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                   const uint32_t* counts) {
+  uint64_t total = 0u;
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    total += counts[i];
+  }
+  if (total == 0u) {
+    // No counts, for example when the inline cache comes from an offline profile.
+    return false;
+  }
+  // Pick the most frequent receiver types that account for a large enough share of all
+  // the recorded receivers, most frequent first.
+  mirror::Class* dominant[kMaximumNumberOfMegamorphicTargets] = {};
+  uint32_t dominant_counts[kMaximumNumberOfMegamorphicTargets] = {};
+  size_t number_of_dominant = 0u;
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    mirror::Class* cls = classes->Get(i);
+    if (cls == nullptr ||
+        static_cast<uint64_t>(counts[i]) * 100u < total * kMegamorphicTargetMinimumPercentage) {
+      continue;
+    }
+    size_t position = number_of_dominant;
+    while (position != 0u && dominant_counts[position - 1] < counts[i]) {
+      --position;
+    }
+    if (position == kMaximumNumberOfMegamorphicTargets) {
+      continue;
+    }
+    for (size_t j = std::min(number_of_dominant, kMaximumNumberOfMegamorphicTargets - 1);
+         j > position;
+         --j) {
+      dominant[j] = dominant[j - 1];
+      dominant_counts[j] = dominant_counts[j - 1];
+    }
+    dominant[position] = cls;
+    dominant_counts[position] = counts[i];
+    number_of_dominant = std::min(number_of_dominant + 1, kMaximumNumberOfMegamorphicTargets);
+  }
+  if (number_of_dominant == 0u) {
+    return false;
+  }
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    classes->Set(i, i < number_of_dominant ? dominant[i] : nullptr);
+  }
+  return true;
+}
+
 HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
     const DexFile& caller_dex_file,
     HInvoke* invoke_instruction,
@@ -1000,11 +1174,15 @@ HInstruction* HInliner::AddTypeGuard(HInstruction* receiver,
 
 bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
                                         ArtMethod* resolved_method,
-                                        Handle<mirror::ObjectArray<mirror::Class>> classes) {
+                                        Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                        bool is_megamorphic) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, resolved_method, classes)) {
+  // For a megamorphic call, `classes` only contains the dominant receiver types, so we
+  // cannot assume all receivers dispatch to the same target.
+  if (!is_megamorphic &&
+      TryInlinePolymorphicCallToSameTarget(invoke_instruction, resolved_method, classes)) {
     return true;
   }
 
@@ -1050,8 +1228,10 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
                     << " has inlined " << ArtMethod::PrettyMethod(method);
 
       // If we have inlined all targets before, and this receiver is the last seen,
-      // we deoptimize instead of keeping the original invoke instruction.
-      bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+      // we deoptimize instead of keeping the original invoke instruction. Megamorphic
+      // calls always keep the original invoke for the other receiver types.
+      bool deoptimize = !is_megamorphic &&
+          !UseOnlyPolymorphicInliningWithNoDeopt() &&
           all_targets_inlined &&
           (i != InlineCache::kIndividualCacheSize - 1) &&
           (classes->Get(i + 1) == nullptr);
@@ -1085,7 +1265,10 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
     return false;
   }
 
-  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
+  MaybeRecordStat(stats_,
+                  is_megamorphic
+                      ? MethodCompilationStat::kInlinedMegamorphicCall
+                      : MethodCompilationStat::kInlinedPolymorphicCall);
 
   // Run type propagation to get the guards typed.
   ReferenceTypePropagation rtp_fixup(graph_,
@@ -1263,7 +1446,8 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (outermost_graph_->IsCompilingOsr() ||
+      !outermost_graph_->CanSpeculate(DeoptimizationKind::kJitSameTarget)) {
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
@@ -1426,6 +1610,20 @@ size_t HInliner::CountRecursiveCallsOf(ArtMethod* method) const {
   return count;
 }
 
+bool HInliner::IsInliningHotCallChain() const {
+  for (const HInliner* current = this; current != nullptr; current = current->parent_) {
+    if (!current->inlining_hot_call_site_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t HInliner::GetMaximumNumberOfCumulatedDexRegisters() const {
+  return IsInliningHotCallChain() ? kMaximumNumberOfCumulatedDexRegistersForHotCalls
+                                  : kMaximumNumberOfCumulatedDexRegisters;
+}
+
 static inline bool MayInline(const CompilerOptions& compiler_options,
                              const DexFile& inlined_from,
                              const DexFile& inlined_into) {
@@ -1934,7 +2132,7 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
       }
       HInstruction* current = instr_it.Current();
       if (current->NeedsEnvironment() &&
-          (total_number_of_dex_registers_ > kMaximumNumberOfCumulatedDexRegisters)) {
+          (total_number_of_dex_registers_ > GetMaximumNumberOfCumulatedDexRegisters())) {
         LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedEnvironmentBudget)
             << "Method " << callee_dex_file.PrettyMethod(method_index)
             << " is not inlined because its caller has reached"
@@ -2129,7 +2327,7 @@ void HInliner::RunOptimizations(HGraph* callee_graph,
 
   // Bail early for pathological cases on the environment (for example recursive calls,
   // or too large environment).
-  if (total_number_of_dex_registers_ > kMaximumNumberOfCumulatedDexRegisters) {
+  if (total_number_of_dex_registers_ > GetMaximumNumberOfCumulatedDexRegisters()) {
     LOG_NOTE() << "Calls in " << callee_graph->GetArtMethod()->PrettyMethod()
              << " will not be inlined because the outer method has reached"
              << " its environment budget limit.";
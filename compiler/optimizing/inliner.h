@@ -17,6 +17,7 @@
 #ifndef ART_COMPILER_OPTIMIZING_INLINER_H_
 #define ART_COMPILER_OPTIMIZING_INLINER_H_
 
+#include "base/scoped_arena_containers.h"
 #include "dex/dex_file_types.h"
 #include "dex/invoke_type.h"
 #include "optimization.h"
@@ -53,6 +54,7 @@ class HInliner : public HOptimization {
         parent_(parent),
         depth_(depth),
         inlining_budget_(0),
+        inlining_hot_call_site_(false),
         inline_stats_(nullptr) {}
 
   bool Run() override;
@@ -69,6 +71,30 @@ class HInliner : public HOptimization {
     kInlineCacheMissingTypes = 5
   };
 
+  // How often a call site was executed according to the profile. Ordered from the
+  // least to the most worth spending the inlining budget on.
+  enum CallSiteHotness {
+    kCallSiteCold = 0,     // The profile shows the call is (almost) never executed.
+    kCallSiteUnknown = 1,  // No profile information for the call.
+    kCallSiteWarm = 2,     // Executed, but not often enough to be hot.
+    kCallSiteHot = 3
+  };
+
+  struct CallSite {
+    HInvoke* invoke;
+    CallSiteHotness hotness;
+    // Approximate number of executions, zero if unknown.
+    uint64_t count;
+  };
+
+  // Compute the hotness of `call_sites` from the JIT or AOT profile and sort them so
+  // that the hottest ones get the inlining budget first. Call sites of equal hotness
+  // keep their graph order.
+  void RankCallSites(ScopedArenaVector<CallSite>* call_sites);
+
+  // Try to inline the call of `call_site`, unless it is cold and `skip_if_cold`.
+  bool TryInlineCallSite(const CallSite& call_site, bool skip_if_cold);
+
   bool TryInline(HInvoke* invoke_instruction);
 
   // Attempt to resolve the target of the invoke instruction to an acutal call
@@ -178,7 +204,8 @@ class HInliner : public HOptimization {
   InlineCacheType GetInlineCacheJIT(
       HInvoke* invoke_instruction,
       StackHandleScope<1>* hs,
-      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+      /*out*/uint32_t* counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try getting the inline cache from AOT offline profile.
@@ -213,10 +240,18 @@ class HInliner : public HOptimization {
                                 Handle<mirror::ObjectArray<mirror::Class>> classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Keep in `classes` only the receiver types of a megamorphic call that dominate
+  // according to `counts`. Return whether any type was kept.
+  bool KeepDominantTargets(Handle<mirror::ObjectArray<mirror::Class>> classes,
+                           const uint32_t* counts)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Try to inline targets of a polymorphic call. If `is_megamorphic`, `classes` only
+  // holds the dominant receiver types and the original invoke is always kept as fallback.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
                                 ArtMethod* resolved_method,
-                                Handle<mirror::ObjectArray<mirror::Class>> classes)
+                                Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                bool is_megamorphic = false)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(HInvoke* invoke_instruction,
@@ -311,6 +346,13 @@ class HInliner : public HOptimization {
   // Count the number of calls of `method` being inlined recursively.
   size_t CountRecursiveCallsOf(ArtMethod* method) const;
 
+  // Whether the call being inlined, and all the calls it is inlined into, are hot.
+  bool IsInliningHotCallChain() const;
+
+  // The limit of dex registers accumulated by nested environments, which bounds the
+  // inlining depth. Hot call chains get a larger limit.
+  size_t GetMaximumNumberOfCumulatedDexRegisters() const;
+
   // Pretty-print for spaces during logging.
   std::string DepthString(int line) const;
 
@@ -329,6 +371,9 @@ class HInliner : public HOptimization {
   // The budget left for inlining, in number of instructions.
   size_t inlining_budget_;
 
+  // Whether the call currently being inlined is hot, see `RankCallSites`.
+  bool inlining_hot_call_site_;
+
   // Used to record stats about optimizations on the inlined graph.
   // If the inlining is successful, these stats are merged to the caller graph's stats.
   OptimizingCompilerStats* inline_stats_;
@@ -30,6 +30,7 @@
 #include "driver/compiler_options.h"
 #include "imtable-inl.h"
 #include "jit/jit.h"
+#include "jit/profiling_info.h"
 #include "mirror/dex_cache.h"
 #include "oat_file.h"
 #include "optimizing_compiler_stats.h"
@@ -73,7 +74,8 @@ HInstructionBuilder::HInstructionBuilder(HGraph* graph,
       latest_result_(nullptr),
       current_this_parameter_(nullptr),
       loop_headers_(local_allocator->Adapter(kArenaAllocGraphBuilder)),
-      class_cache_(std::less<dex::TypeIndex>(), local_allocator->Adapter(kArenaAllocGraphBuilder)) {
+      class_cache_(std::less<dex::TypeIndex>(), local_allocator->Adapter(kArenaAllocGraphBuilder)),
+      profiling_info_(nullptr) {
   loop_headers_.reserve(kDefaultNumberOfLoops);
 }
 
@@ -326,6 +328,16 @@ bool HInstructionBuilder::Build() {
     native_debug_info_locations = FindNativeDebugInfoLocations();
   }
 
+  // The method being compiled cannot lose its ProfilingInfo during compilation, but inlined
+  // methods could, so only use the branch profile of the outermost method.
+  if (graph_->GetArtMethod() != nullptr &&
+      dex_compilation_unit_ == outer_compilation_unit_ &&
+      !graph_->IsCompilingBaseline() &&
+      !Runtime::Current()->IsAotCompiler()) {
+    ScopedObjectAccess soa(Thread::Current());
+    profiling_info_ = graph_->GetArtMethod()->GetProfilingInfo(kRuntimePointerSize);
+  }
+
   for (HBasicBlock* block : graph_->GetReversePostOrder()) {
     current_block_ = block;
     uint32_t block_dex_pc = current_block_->GetDexPc();
@@ -610,13 +622,25 @@ void HInstructionBuilder::InitializeParameters() {
   }
 }
 
+void HInstructionBuilder::AppendIf(HInstruction* condition, uint32_t dex_pc) {
+  HIf* if_instr = new (allocator_) HIf(condition, dex_pc);
+  if (profiling_info_ != nullptr) {
+    BranchCache* cache = profiling_info_->GetBranchCache(dex_pc);
+    if (cache != nullptr) {
+      // The true successor of the HIf is the branch target of the if-* instruction.
+      if_instr->SetBranchProfile(cache->GetTaken(), cache->GetNotTaken());
+    }
+  }
+  AppendInstruction(if_instr);
+}
+
 template<typename T>
 void HInstructionBuilder::If_22t(const Instruction& instruction, uint32_t dex_pc) {
   HInstruction* first = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
   HInstruction* second = LoadLocal(instruction.VRegB(), DataType::Type::kInt32);
   T* comparison = new (allocator_) T(first, second, dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+  AppendIf(comparison, dex_pc);
   current_block_ = nullptr;
 }
 
@@ -625,7 +649,7 @@ void HInstructionBuilder::If_21t(const Instruction& instruction, uint32_t dex_pc
   HInstruction* value = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
   T* comparison = new (allocator_) T(value, graph_->GetIntConstant(0, dex_pc), dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+  AppendIf(comparison, dex_pc);
   current_block_ = nullptr;
 }
 
@@ -1079,6 +1103,63 @@ bool HInstructionBuilder::BuildInvoke(const Instruction& instruction,
   return HandleInvoke(invoke, operands, shorty, /* is_unresolved= */ false);
 }
 
+ArtMethod* HInstructionBuilder::FindConstantMethodHandleTarget(
+    uint32_t method_idx,
+    dex::ProtoIndex proto_idx,
+    const InstructionOperands& operands,
+    /*out*/ MethodReference* target_method) {
+  const dex::MethodId& method_id = dex_file_->GetMethodId(method_idx);
+  if (strcmp(dex_file_->GetMethodDeclaringClassDescriptor(method_id),
+             "Ljava/lang/invoke/MethodHandle;") != 0) {
+    return nullptr;  // VarHandle accessor.
+  }
+  const char* name = dex_file_->GetMethodName(method_id);
+  if (strcmp(name, "invokeExact") != 0 && strcmp(name, "invoke") != 0) {
+    return nullptr;
+  }
+
+  // The handle must come from a const-method-handle in this method.
+  HInstruction* handle = LoadLocal(operands.GetOperand(0), DataType::Type::kReference);
+  if (!handle->IsLoadMethodHandle() ||
+      !IsSameDexFile(handle->AsLoadMethodHandle()->GetDexFile(), *dex_file_)) {
+    return nullptr;
+  }
+  const dex::MethodHandleItem& method_handle =
+      dex_file_->GetMethodHandle(handle->AsLoadMethodHandle()->GetMethodHandleIndex());
+  if (static_cast<DexFile::MethodHandleType>(method_handle.method_handle_type_) !=
+      DexFile::MethodHandleType::kInvokeStatic) {
+    return nullptr;
+  }
+
+  // The type of a static method handle is the prototype of the method. Prototypes are unique
+  // within a dex file, so the call site type matches exactly iff the indexes are equal. With a
+  // mismatch, invokeExact() throws and invoke() needs an asType() conversion, so leave both to
+  // the runtime.
+  uint32_t target_method_idx = method_handle.field_or_method_idx_;
+  if (dex_file_->GetMethodId(target_method_idx).proto_idx_ != proto_idx) {
+    return nullptr;
+  }
+
+  InvokeType invoke_type = kStatic;
+  bool is_string_constructor = false;
+  ArtMethod* resolved_method = ResolveMethod(target_method_idx,
+                                             graph_->GetArtMethod(),
+                                             *dex_compilation_unit_,
+                                             &invoke_type,
+                                             target_method,
+                                             &is_string_constructor);
+  if (resolved_method == nullptr) {
+    return nullptr;
+  }
+  DCHECK_EQ(invoke_type, kStatic);
+  DCHECK(!is_string_constructor);
+  if (!IsSameDexFile(*target_method->dex_file, *dex_file_)) {
+    // The direct call refers to the method by its index in the dex file of the caller.
+    return nullptr;
+  }
+  return resolved_method;
+}
+
 bool HInstructionBuilder::BuildInvokePolymorphic(uint32_t dex_pc,
                                                  uint32_t method_idx,
                                                  dex::ProtoIndex proto_idx,
@@ -1086,12 +1167,69 @@ bool HInstructionBuilder::BuildInvokePolymorphic(uint32_t dex_pc,
   const char* shorty = dex_file_->GetShorty(proto_idx);
   DCHECK_EQ(1 + ArtMethod::NumArgRegisters(shorty), operands.GetNumberOfOperands());
   DataType::Type return_type = DataType::FromShorty(shorty[0]);
+
+  // A MethodHandle.invoke() or invokeExact() on a constant handle for a static method with
+  // exactly the call site type is equivalent to a direct call to that method. Build the direct
+  // call so that the target can be inlined instead of going through the MethodHandle runtime.
+  MethodReference target_method(nullptr, 0u);
+  ArtMethod* target =
+      FindConstantMethodHandleTarget(method_idx, proto_idx, operands, &target_method);
+  if (target != nullptr) {
+    MaybeRecordStat(compilation_stats_, MethodCompilationStat::kReplacedConstantMethodHandleInvoke);
+    NoReceiverInstructionOperands target_operands(&operands);
+    HInvokeStaticOrDirect::ClinitCheckRequirement clinit_check_requirement =
+        HInvokeStaticOrDirect::ClinitCheckRequirement::kNone;
+    HClinitCheck* clinit_check =
+        ProcessClinitCheckForInvoke(dex_pc, target, &clinit_check_requirement);
+    if (UNLIKELY(target->IsIntrinsic())) {
+      DCHECK_NE(clinit_check_requirement, HInvokeStaticOrDirect::ClinitCheckRequirement::kImplicit);
+      if (BuildSimpleIntrinsic(target, dex_pc, target_operands, shorty)) {
+        return true;
+      }
+    }
+    HInvokeStaticOrDirect::DispatchInfo dispatch_info =
+        HSharpening::SharpenInvokeStaticOrDirect(target, code_generator_);
+    HInvokeStaticOrDirect* invoke = new (allocator_) HInvokeStaticOrDirect(
+        allocator_,
+        strlen(shorty) - 1u,
+        return_type,
+        dex_pc,
+        target_method.index,
+        target,
+        dispatch_info,
+        kStatic,
+        target_method,
+        clinit_check_requirement);
+    if (clinit_check != nullptr) {
+      // Add the class initialization check as last input of `invoke`.
+      DCHECK_EQ(clinit_check_requirement, HInvokeStaticOrDirect::ClinitCheckRequirement::kExplicit);
+      size_t clinit_check_index = invoke->InputCount() - 1u;
+      DCHECK(invoke->InputAt(clinit_check_index) == nullptr);
+      invoke->SetArgumentAt(clinit_check_index, clinit_check);
+    }
+    return HandleInvoke(invoke, target_operands, shorty, /* is_unresolved= */ false);
+  }
+
+  // Resolve the polymorphic method to pass its intrinsic to the HInvokePolymorphic.
+  // The method is a native virtual method of MethodHandle or VarHandle.
+  InvokeType invoke_type = kVirtual;
+  bool is_string_constructor = false;
+  ArtMethod* resolved_method = ResolveMethod(method_idx,
+                                             graph_->GetArtMethod(),
+                                             *dex_compilation_unit_,
+                                             &invoke_type,
+                                             &target_method,
+                                             &is_string_constructor);
+
   size_t number_of_arguments = strlen(shorty);
   HInvoke* invoke = new (allocator_) HInvokePolymorphic(allocator_,
                                                         number_of_arguments,
                                                         return_type,
                                                         dex_pc,
-                                                        method_idx);
+                                                        method_idx,
+                                                        resolved_method,
+                                                        proto_idx,
+                                                        *dex_file_);
   return HandleInvoke(invoke, operands, shorty, /* is_unresolved= */ false);
 }
 
@@ -1317,9 +1455,8 @@ static bool HasTrivialClinit(ObjPtr<mirror::Class> klass, PointerSize pointer_si
   return true;
 }
 
-static bool HasTrivialInitialization(ObjPtr<mirror::Class> cls,
-                                     const CompilerOptions& compiler_options)
-    REQUIRES_SHARED(Locks::mutator_lock_) {
+bool HInstructionBuilder::HasTrivialInitialization(ObjPtr<mirror::Class> cls,
+                                                   const CompilerOptions& compiler_options) {
   Runtime* runtime = Runtime::Current();
   PointerSize pointer_size = runtime->GetClassLinker()->GetImagePointerSize();
 
@@ -2318,6 +2455,44 @@ void HInstructionBuilder::BuildLoadMethodType(dex::ProtoIndex proto_index, uint3
   AppendInstruction(load_method_type);
 }
 
+// Minimum number of objects of the profiled class seen by a type check, and maximum share of
+// objects of other classes, for emitting a fast path for the profiled class.
+static constexpr uint32_t kMinProfiledTypeCheckHits = 16u;
+static constexpr uint32_t kMaxProfiledTypeCheckMissesRatio = 32u;  // 1/32 of the hits.
+
+void HInstructionBuilder::MaybeSetProfiledClass(HTypeCheckInstruction* type_check,
+                                                uint32_t dex_pc) {
+  TypeCheckKind check_kind = type_check->GetTypeCheckKind();
+  Handle<mirror::Class> klass = type_check->GetClass();
+  // The exact and bitstring checks are already a single compare.
+  if (profiling_info_ == nullptr ||
+      klass == nullptr ||
+      check_kind == TypeCheckKind::kExactCheck ||
+      check_kind == TypeCheckKind::kBitstringCheck) {
+    return;
+  }
+  TypeCheckCache* cache = profiling_info_->GetTypeCheckCache(dex_pc);
+  if (cache == nullptr) {
+    return;
+  }
+  uint32_t hits = cache->GetHits();
+  uint32_t misses = cache->GetMisses();
+  ObjPtr<mirror::Class> profiled_class = cache->GetClass();
+  if (profiled_class == nullptr ||
+      hits < kMinProfiledTypeCheckHits ||
+      misses > hits / kMaxProfiledTypeCheckMissesRatio ||
+      !klass->IsAssignableFrom(profiled_class)) {
+    return;
+  }
+  dex::TypeIndex type_index = FindClassIndexIn(profiled_class, *dex_compilation_unit_);
+  if (!type_index.IsValid()) {
+    return;
+  }
+  type_check->SetProfiledClass(graph_->GetHandleCache()->NewHandle(profiled_class),
+                               *dex_compilation_unit_->GetDexFile(),
+                               type_index);
+}
+
 void HInstructionBuilder::BuildTypeCheck(const Instruction& instruction,
                                          uint8_t destination,
                                          uint8_t reference,
@@ -2351,29 +2526,32 @@ void HInstructionBuilder::BuildTypeCheck(const Instruction& instruction,
   DCHECK(class_or_null != nullptr);
 
   if (instruction.Opcode() == Instruction::INSTANCE_OF) {
-    AppendInstruction(new (allocator_) HInstanceOf(object,
-                                                   class_or_null,
-                                                   check_kind,
-                                                   klass,
-                                                   dex_pc,
-                                                   allocator_,
-                                                   bitstring_path_to_root,
-                                                   bitstring_mask));
+    HInstanceOf* instance_of = new (allocator_) HInstanceOf(object,
+                                                            class_or_null,
+                                                            check_kind,
+                                                            klass,
+                                                            dex_pc,
+                                                            allocator_,
+                                                            bitstring_path_to_root,
+                                                            bitstring_mask);
+    MaybeSetProfiledClass(instance_of, dex_pc);
+    AppendInstruction(instance_of);
     UpdateLocal(destination, current_block_->GetLastInstruction());
   } else {
     DCHECK_EQ(instruction.Opcode(), Instruction::CHECK_CAST);
     // We emit a CheckCast followed by a BoundType. CheckCast is a statement
     // which may throw. If it succeeds BoundType sets the new type of `object`
     // for all subsequent uses.
-    AppendInstruction(
-        new (allocator_) HCheckCast(object,
-                                    class_or_null,
-                                    check_kind,
-                                    klass,
-                                    dex_pc,
-                                    allocator_,
-                                    bitstring_path_to_root,
-                                    bitstring_mask));
+    HCheckCast* check_cast = new (allocator_) HCheckCast(object,
+                                                         class_or_null,
+                                                         check_kind,
+                                                         klass,
+                                                         dex_pc,
+                                                         allocator_,
+                                                         bitstring_path_to_root,
+                                                         bitstring_mask);
+    MaybeSetProfiledClass(check_cast, dex_pc);
+    AppendInstruction(check_cast);
     AppendInstruction(new (allocator_) HBoundType(object, dex_pc));
     UpdateLocal(reference, current_block_->GetLastInstruction());
   }
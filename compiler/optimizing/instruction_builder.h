@@ -34,11 +34,13 @@ class ArenaBitVector;
 class ArtField;
 class ArtMethod;
 class CodeGenerator;
+class CompilerOptions;
 class DexCompilationUnit;
 class HBasicBlockBuilder;
 class Instruction;
 class InstructionOperands;
 class OptimizingCompilerStats;
+class ProfilingInfo;
 class ScopedObjectAccess;
 class SsaBuilder;
 
@@ -65,6 +67,13 @@ class HInstructionBuilder : public ValueObject {
   bool Build();
   void BuildIntrinsic(ArtMethod* method);
 
+  // Whether the initialization of `cls`, its superclasses and its superinterfaces with
+  // default methods only stores constants to their own static fields, so that it cannot
+  // observe or leave behind a partially initialized class.
+  static bool HasTrivialInitialization(ObjPtr<mirror::Class> cls,
+                                       const CompilerOptions& compiler_options)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
   void InitializeBlockLocals();
   void PropagateLocalsToCatchBlocks();
@@ -89,6 +98,8 @@ class HInstructionBuilder : public ValueObject {
   void UpdateLocal(uint32_t register_index, HInstruction* instruction);
 
   void AppendInstruction(HInstruction* instruction);
+  // Append an HIf for the if-* instruction at `dex_pc`, with its branch profile if any.
+  void AppendIf(HInstruction* condition, uint32_t dex_pc);
   void InsertInstructionAtTop(HInstruction* instruction);
   void InitializeInstruction(HInstruction* instruction);
 
@@ -169,6 +180,13 @@ class HInstructionBuilder : public ValueObject {
                               dex::ProtoIndex proto_idx,
                               const InstructionOperands& operands);
 
+  // Returns the static method targeted by a MethodHandle.invoke() or invokeExact() of
+  // invoke-polymorphic if the handle is a constant with exactly the call site type, or null.
+  ArtMethod* FindConstantMethodHandleTarget(uint32_t method_idx,
+                                            dex::ProtoIndex proto_idx,
+                                            const InstructionOperands& operands,
+                                            /*out*/ MethodReference* target_method);
+
   // Builds an invocation node for invoke-custom and returns whether the
   // instruction is supported.
   bool BuildInvokeCustom(uint32_t dex_pc,
@@ -209,6 +227,11 @@ class HInstructionBuilder : public ValueObject {
                       dex::TypeIndex type_index,
                       uint32_t dex_pc);
 
+  // Record the dominant class seen by baseline code at the type check `dex_pc` in
+  // `type_check`, if there is one and it passes the check.
+  void MaybeSetProfiledClass(HTypeCheckInstruction* type_check, uint32_t dex_pc)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Builds an instruction sequence for a switch statement.
   void BuildSwitch(const Instruction& instruction, uint32_t dex_pc);
 
@@ -343,6 +366,10 @@ class HInstructionBuilder : public ValueObject {
   // Handle<>s reference entries in the `graph_->GetHandleCache()`.
   ScopedArenaSafeMap<dex::TypeIndex, Handle<mirror::Class>> class_cache_;
 
+  // Profile of the method being JIT compiled, used for the outermost method only. Null if
+  // we have no profile or when compiling baseline code, which records the profile.
+  ProfilingInfo* profiling_info_;
+
   static constexpr int kDefaultNumberOfLoops = 2;
 
   DISALLOW_COPY_AND_ASSIGN(HInstructionBuilder);
@@ -121,6 +121,7 @@ class InstructionSimplifierVisitor : public HGraphDelegateVisitor {
   void SimplifyNPEOnArgN(HInvoke* invoke, size_t);
   void SimplifyReturnThis(HInvoke* invoke);
   void SimplifyAllocationIntrinsic(HInvoke* invoke);
+  void SimplifyUnsignedDivision(HInvoke* invoke, bool is_remainder);
 
   CodeGenerator* codegen_;
   OptimizingCompilerStats* stats_;
@@ -327,6 +328,10 @@ bool InstructionSimplifierVisitor::TryCombineVecMultiplyAccumulate(HVecMul* mul)
                                                    binop->GetPackedType(),
                                                    binop->GetVectorLength(),
                                                    binop->GetDexPc());
+        if (binop->IsPredicated()) {
+          mulacc->SetGoverningPredicate(binop->GetGoverningPredicate(),
+                                        binop->GetPredicationKind());
+        }
 
         binop->GetBlock()->ReplaceAndRemoveInstructionWith(binop, mulacc);
         DCHECK(!mul->HasUses());
@@ -1020,6 +1025,7 @@ void InstructionSimplifierVisitor::VisitIf(HIf* instruction) {
     // Swap successors if input is negated.
     instruction->ReplaceInput(condition->InputAt(0), 0);
     instruction->GetBlock()->SwapSuccessors();
+    instruction->SwapBranchProfile();
     RecordSimplification();
   }
 }
@@ -2460,6 +2466,22 @@ static bool NoEscapeForStringBufferReference(HInstruction* reference, HInstructi
   return false;
 }
 
+// Check whether StringBuilder.append(Object) or append(CharSequence) with the `input`
+// appends the same characters as StringBuilder.append(String).
+static bool IsStringOrNullInput(HInstruction* input) {
+  if (input->IsNullConstant()) {
+    return true;
+  }
+  ReferenceTypeInfo rti = input->GetReferenceTypeInfo();
+  if (!rti.IsValid()) {
+    return false;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  Handle<mirror::Class> input_type = rti.GetTypeHandle();
+  DCHECK(input_type != nullptr);
+  return input_type.Get() == GetClassRoot<mirror::String>();
+}
+
 static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
   DCHECK_EQ(invoke->GetIntrinsic(), Intrinsics::kStringBuilderToString);
   if (invoke->CanThrowIntoCatchBlock()) {
@@ -2493,9 +2515,9 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
   bool seen_constructor = false;
   bool seen_constructor_fence = false;
   bool seen_to_string = false;
-  uint32_t format = 0u;
   uint32_t num_args = 0u;
   HInstruction* args[StringBuilderAppend::kMaxArgs];  // Added in reverse order.
+  StringBuilderAppend::Argument arg_types[StringBuilderAppend::kMaxArgs];  // Ditto.
   for (HBackwardInstructionIterator iter(block->GetInstructions()); !iter.Done(); iter.Advance()) {
     HInstruction* user = iter.Current();
     // Instructions of interest apply to `sb`, skip those that do not involve `sb`.
@@ -2519,8 +2541,14 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
       StringBuilderAppend::Argument arg;
       switch (as_invoke_virtual->GetIntrinsic()) {
         case Intrinsics::kStringBuilderAppendObject:
-          // TODO: Unimplemented, needs to call String.valueOf().
-          return false;
+          // String.valueOf() returns a String argument unchanged and "null" for null.
+          if (IsStringOrNullInput(as_invoke_virtual->InputAt(1u))) {
+            arg = StringBuilderAppend::Argument::kString;
+          } else {
+            // TODO: Unimplemented, needs to call String.valueOf().
+            return false;
+          }
+          break;
         case Intrinsics::kStringBuilderAppendString:
           arg = StringBuilderAppend::Argument::kString;
           break;
@@ -2541,14 +2569,7 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
           arg = StringBuilderAppend::Argument::kLong;
           break;
         case Intrinsics::kStringBuilderAppendCharSequence: {
-          ReferenceTypeInfo rti = user->AsInvokeVirtual()->InputAt(1)->GetReferenceTypeInfo();
-          if (!rti.IsValid()) {
-            return false;
-          }
-          ScopedObjectAccess soa(Thread::Current());
-          Handle<mirror::Class> input_type = rti.GetTypeHandle();
-          DCHECK(input_type != nullptr);
-          if (input_type.Get() == GetClassRoot<mirror::String>()) {
+          if (IsStringOrNullInput(as_invoke_virtual->InputAt(1u))) {
             arg = StringBuilderAppend::Argument::kString;
           } else {
             // TODO: Check and implement for StringBuilder. We could find the StringBuilder's
@@ -2573,7 +2594,7 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
       if (num_args == StringBuilderAppend::kMaxArgs) {
         return false;
       }
-      format = (format << StringBuilderAppend::kBitsPerArg) | static_cast<uint32_t>(arg);
+      arg_types[num_args] = arg;
       args[num_args] = as_invoke_virtual->InputAt(1u);
       ++num_args;
     } else if (user->IsInvokeStaticOrDirect() &&
@@ -2612,14 +2633,47 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
     }
   }
 
+  // Encode the format. When the arguments do not fit into a single format word, the last
+  // slot of a full format word holds kNextFormat and the next format word is passed as
+  // an additional argument in the position where the runtime reads it.
+  HGraph* graph = block->GetGraph();
+  HInstruction* inputs[2u * StringBuilderAppend::kMaxArgs];
+  size_t num_inputs = 0u;
+  uint32_t formats[StringBuilderAppend::kMaxArgs];
+  size_t format_input_indexes[StringBuilderAppend::kMaxArgs];
+  size_t num_formats = 1u;
+  formats[0] = 0u;
+  size_t format_args = 0u;
+  for (size_t i = 0; i != num_args; ++i) {
+    size_t remaining_args = num_args - i;
+    if (format_args == StringBuilderAppend::kMaxArgsPerFormat - 1u && remaining_args != 1u) {
+      uint32_t next_format = static_cast<uint32_t>(StringBuilderAppend::Argument::kNextFormat);
+      formats[num_formats - 1u] |= next_format << (format_args * StringBuilderAppend::kBitsPerArg);
+      formats[num_formats] = 0u;
+      format_input_indexes[num_formats] = num_inputs;
+      ++num_formats;
+      inputs[num_inputs] = nullptr;  // Filled in below.
+      ++num_inputs;
+      format_args = 0u;
+    }
+    formats[num_formats - 1u] |= static_cast<uint32_t>(arg_types[num_args - 1u - i])
+        << (format_args * StringBuilderAppend::kBitsPerArg);
+    ++format_args;
+    inputs[num_inputs] = args[num_args - 1u - i];
+    ++num_inputs;
+  }
+  for (size_t i = 1u; i != num_formats; ++i) {
+    inputs[format_input_indexes[i]] = graph->GetIntConstant(static_cast<int32_t>(formats[i]));
+  }
+
   // Create replacement instruction.
-  HIntConstant* fmt = block->GetGraph()->GetIntConstant(static_cast<int32_t>(format));
-  ArenaAllocator* allocator = block->GetGraph()->GetAllocator();
+  HIntConstant* fmt = graph->GetIntConstant(static_cast<int32_t>(formats[0]));
+  ArenaAllocator* allocator = graph->GetAllocator();
   HStringBuilderAppend* append =
-      new (allocator) HStringBuilderAppend(fmt, num_args, allocator, invoke->GetDexPc());
+      new (allocator) HStringBuilderAppend(fmt, num_inputs, allocator, invoke->GetDexPc());
   append->SetReferenceTypeInfo(invoke->GetReferenceTypeInfo());
-  for (size_t i = 0; i != num_args; ++i) {
-    append->SetArgumentAt(i, args[num_args - 1u - i]);
+  for (size_t i = 0; i != num_inputs; ++i) {
+    append->SetArgumentAt(i, inputs[i]);
   }
   block->InsertInstructionBefore(append, invoke);
   DCHECK(!invoke->CanBeNull());
@@ -2666,6 +2720,36 @@ void InstructionSimplifierVisitor::SimplifyAllocationIntrinsic(HInvoke* invoke)
   }
 }
 
+// Replace an unsigned division or remainder by a power of two with a shift or a mask.
+// The divisor is a non-zero constant, so this also removes the slow path for division by zero.
+void InstructionSimplifierVisitor::SimplifyUnsignedDivision(HInvoke* invoke, bool is_remainder) {
+  HInstruction* divisor = invoke->InputAt(1);
+  if (!divisor->IsIntConstant() && !divisor->IsLongConstant()) {
+    return;
+  }
+  DataType::Type type = invoke->GetType();
+  uint64_t value = (type == DataType::Type::kInt64)
+      ? static_cast<uint64_t>(divisor->AsLongConstant()->GetValue())
+      : static_cast<uint32_t>(divisor->AsIntConstant()->GetValue());
+  if (value == 0u || !IsPowerOfTwo(value)) {
+    return;
+  }
+  ArenaAllocator* allocator = GetGraph()->GetAllocator();
+  HInstruction* dividend = invoke->InputAt(0);
+  HBinaryOperation* replacement;
+  if (is_remainder) {
+    // For example "Integer.remainderUnsigned(x, 8)" -> "x & 7".
+    HConstant* mask = GetGraph()->GetConstant(type, static_cast<int64_t>(value - 1u));
+    replacement = new (allocator) HAnd(type, dividend, mask, invoke->GetDexPc());
+  } else {
+    // For example "Integer.divideUnsigned(x, 8)" -> "x >>> 3".
+    HConstant* shift = GetGraph()->GetIntConstant(WhichPowerOf2(value));
+    replacement = new (allocator) HUShr(type, dividend, shift, invoke->GetDexPc());
+  }
+  invoke->GetBlock()->ReplaceAndRemoveInstructionWith(invoke, replacement);
+  RecordSimplification();
+}
+
 void InstructionSimplifierVisitor::VisitInvoke(HInvoke* instruction) {
   switch (instruction->GetIntrinsic()) {
     case Intrinsics::kStringEquals:
@@ -2713,6 +2797,14 @@ void InstructionSimplifierVisitor::VisitInvoke(HInvoke* instruction) {
     case Intrinsics::kStringBuilderToString:
       SimplifyAllocationIntrinsic(instruction);
       break;
+    case Intrinsics::kIntegerDivideUnsigned:
+    case Intrinsics::kLongDivideUnsigned:
+      SimplifyUnsignedDivision(instruction, /* is_remainder= */ false);
+      break;
+    case Intrinsics::kIntegerRemainderUnsigned:
+    case Intrinsics::kLongRemainderUnsigned:
+      SimplifyUnsignedDivision(instruction, /* is_remainder= */ true);
+      break;
     case Intrinsics::kIntegerRotateRight:
     case Intrinsics::kLongRotateRight:
     case Intrinsics::kIntegerRotateLeft:
@@ -50,6 +50,7 @@ using helpers::DRegisterFrom;
 using helpers::HeapOperand;
 using helpers::LocationFrom;
 using helpers::OperandFrom;
+using helpers::QRegisterFrom;
 using helpers::RegisterFrom;
 using helpers::SRegisterFrom;
 using helpers::WRegisterFrom;
@@ -455,6 +456,74 @@ void IntrinsicCodeGeneratorARM64::VisitLongLowestOneBit(HInvoke* invoke) {
   GenLowestOneBit(invoke, DataType::Type::kInt64, GetVIXLAssembler());
 }
 
+static void CreateUnsignedDivisionLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  // The slow path calls the managed method to throw ArithmeticException for a zero divisor.
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenUnsignedDivision(HInvoke* invoke,
+                                DataType::Type type,
+                                bool is_remainder,
+                                CodeGeneratorARM64* codegen) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register dividend = RegisterFrom(locations->InAt(0), type);
+  Register divisor = RegisterFrom(locations->InAt(1), type);
+  Register out = RegisterFrom(locations->Out(), type);
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ Cbz(divisor, slow_path->GetEntryLabel());
+
+  if (is_remainder) {
+    UseScratchRegisterScope temps(masm);
+    Register quotient = temps.AcquireSameSizeAs(out);
+    __ Udiv(quotient, dividend, divisor);
+    __ Msub(out, quotient, divisor, dividend);
+  } else {
+    __ Udiv(out, dividend, divisor);
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(invoke, DataType::Type::kInt32, /* is_remainder= */ false, codegen_);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitIntegerRemainderUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitIntegerRemainderUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(invoke, DataType::Type::kInt32, /* is_remainder= */ true, codegen_);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitLongDivideUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitLongDivideUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(invoke, DataType::Type::kInt64, /* is_remainder= */ false, codegen_);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitLongRemainderUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitLongRemainderUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(invoke, DataType::Type::kInt64, /* is_remainder= */ true, codegen_);
+}
+
 static void CreateFPToFPLocations(ArenaAllocator* allocator, HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
@@ -2128,6 +2197,52 @@ static void GenSystemArrayCopyAddresses(MacroAssembler* masm,
   }
 }
 
+// Emit a raw copy of the references in [`src_curr_addr`, `src_stop_addr`) to `dst_curr_addr`
+// for the SystemArrayCopy intrinsic. We don't need to poison/unpoison. References are copied
+// four at a time with LD1/ST1 of 32-bit elements, which keeps each reference access
+// single-copy atomic, and the remaining ones are copied one at a time. The copy is done
+// forwards, which is also correct for overlapping arrays with `dst_curr_addr` below
+// `src_curr_addr` since each chunk is loaded before the overlapping store.
+static void GenSystemArrayCopyRawLoop(MacroAssembler* masm,
+                                      const Register& src_curr_addr,
+                                      const Register& dst_curr_addr,
+                                      const Register& src_stop_addr,
+                                      const Register& tmp,
+                                      const VRegister& vtmp) {
+  const int32_t element_size = DataType::Size(DataType::Type::kReference);
+  const int32_t chunk_size = 4 * element_size;
+  vixl::aarch64::Label vector_loop;
+  vixl::aarch64::Label remainder;
+  vixl::aarch64::Label loop;
+  vixl::aarch64::Label done;
+
+  // vector_stop_addr = src_stop_addr - ((src_stop_addr - src_curr_addr) % chunk_size)
+  Register vector_stop_addr = tmp.X();
+  __ Sub(vector_stop_addr, src_stop_addr, src_curr_addr);
+  __ And(vector_stop_addr, vector_stop_addr, chunk_size - 1);
+  __ Sub(vector_stop_addr, src_stop_addr, vector_stop_addr);
+  __ Cmp(src_curr_addr, vector_stop_addr);
+  __ B(&remainder, eq);
+
+  __ Bind(&vector_loop);
+  __ Ld1(vtmp.V4S(), MemOperand(src_curr_addr, chunk_size, PostIndex));
+  __ St1(vtmp.V4S(), MemOperand(dst_curr_addr, chunk_size, PostIndex));
+  __ Cmp(src_curr_addr, vector_stop_addr);
+  __ B(&vector_loop, ne);
+
+  __ Bind(&remainder);
+  __ Cmp(src_curr_addr, src_stop_addr);
+  __ B(&done, eq);
+
+  __ Bind(&loop);
+  __ Ldr(tmp.W(), MemOperand(src_curr_addr, element_size, PostIndex));
+  __ Str(tmp.W(), MemOperand(dst_curr_addr, element_size, PostIndex));
+  __ Cmp(src_curr_addr, src_stop_addr);
+  __ B(&loop, ne);
+
+  __ Bind(&done);
+}
+
 void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   MacroAssembler* masm = GetVIXLAssembler();
   LocationSummary* locations = invoke->GetLocations();
@@ -2618,7 +2733,6 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopy(HInvoke* invoke) {
       Register src_stop_addr = temp3.X();
       vixl::aarch64::Label done;
       const DataType::Type type = DataType::Type::kReference;
-      const int32_t element_size = DataType::Size(type);
 
       if (length.IsRegister()) {
         // Don't enter the copy loop if the length is null.
@@ -2703,14 +2817,11 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopy(HInvoke* invoke) {
         __ Tbnz(tmp, LockWord::kReadBarrierStateShift, read_barrier_slow_path->GetEntryLabel());
 
         // Fast-path copy.
-        // Iterate over the arrays and do a raw copy of the objects. We don't need to
-        // poison/unpoison.
-        vixl::aarch64::Label loop;
-        __ Bind(&loop);
-        __ Ldr(tmp, MemOperand(src_curr_addr, element_size, PostIndex));
-        __ Str(tmp, MemOperand(dst_curr_addr, element_size, PostIndex));
-        __ Cmp(src_curr_addr, src_stop_addr);
-        __ B(&loop, ne);
+        // The source is not gray, so its references need no marking and can be copied in bulk.
+        {
+          VRegister vtmp = temps.AcquireVRegisterOfSize(kQRegSize);
+          GenSystemArrayCopyRawLoop(masm, src_curr_addr, dst_curr_addr, src_stop_addr, tmp, vtmp);
+        }
 
         __ Bind(read_barrier_slow_path->GetExitLabel());
       } else {
@@ -2728,17 +2839,11 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopy(HInvoke* invoke) {
                                     src_curr_addr,
                                     dst_curr_addr,
                                     src_stop_addr);
-        // Iterate over the arrays and do a raw copy of the objects. We don't need to
-        // poison/unpoison.
-        vixl::aarch64::Label loop;
-        __ Bind(&loop);
         {
           Register tmp = temps.AcquireW();
-          __ Ldr(tmp, MemOperand(src_curr_addr, element_size, PostIndex));
-          __ Str(tmp, MemOperand(dst_curr_addr, element_size, PostIndex));
+          VRegister vtmp = temps.AcquireVRegisterOfSize(kQRegSize);
+          GenSystemArrayCopyRawLoop(masm, src_curr_addr, dst_curr_addr, src_stop_addr, tmp, vtmp);
         }
-        __ Cmp(src_curr_addr, src_stop_addr);
-        __ B(&loop, ne);
       }
       __ Bind(&done);
     }
@@ -3466,6 +3571,417 @@ void IntrinsicCodeGeneratorARM64::VisitFP16Max(HInvoke* invoke) {
   __ Bind(&end);
 }
 
+// Compute `out = 31 * out + data[i]` over `length` elements of `type` starting at `ptr`, eight
+// elements per iteration of the vector loop. The vector loop keeps the eight partial hashes in
+// two accumulators which are multiplied by 31^8 on each iteration, with the incoming `out` in
+// the most significant lane, and then folds them with a Horner step over the eight lanes.
+// Clobbers `ptr`, `length` and all the temporaries.
+static void GeneratePolynomialHash(MacroAssembler* masm,
+                                   DataType::Type type,
+                                   Register ptr,
+                                   Register length,
+                                   Register out,
+                                   Register temp,
+                                   Register multiplier,
+                                   VRegister acc0,
+                                   VRegister acc1,
+                                   VRegister vmultiplier,
+                                   VRegister data0,
+                                   VRegister data1) {
+  vixl::aarch64::Label vector_loop;
+  vixl::aarch64::Label scalar_loop;
+  vixl::aarch64::Label scalar_start;
+  vixl::aarch64::Label done;
+
+  __ Mov(multiplier, kPolynomialHashMultiplier);
+  __ Cmp(length, 8);
+  __ B(lt, &scalar_start);
+
+  __ Movi(acc0.V4S(), 0);
+  __ Movi(acc1.V4S(), 0);
+  __ Mov(acc1.V4S(), 3, out);
+  __ Mov(temp, kPolynomialHashMultiplierPow8);
+  __ Dup(vmultiplier.V4S(), temp);
+  __ Sub(length, length, 8);
+
+  __ Bind(&vector_loop);
+  switch (type) {
+    case DataType::Type::kInt32:
+      __ Ldp(data0, data1, MemOperand(ptr.X(), 2 * kQRegSizeInBytes, PostIndex));
+      break;
+    case DataType::Type::kUint16:
+      __ Ldr(data0, MemOperand(ptr.X(), kQRegSizeInBytes, PostIndex));
+      __ Uxtl2(data1.V4S(), data0.V8H());
+      __ Uxtl(data0.V4S(), data0.V4H());
+      break;
+    case DataType::Type::kUint8:
+      __ Ldr(DRegister(data0.GetCode()), MemOperand(ptr.X(), kDRegSizeInBytes, PostIndex));
+      __ Uxtl(data0.V8H(), data0.V8B());
+      __ Uxtl2(data1.V4S(), data0.V8H());
+      __ Uxtl(data0.V4S(), data0.V4H());
+      break;
+    case DataType::Type::kInt8:
+      __ Ldr(DRegister(data0.GetCode()), MemOperand(ptr.X(), kDRegSizeInBytes, PostIndex));
+      __ Sxtl(data0.V8H(), data0.V8B());
+      __ Sxtl2(data1.V4S(), data0.V8H());
+      __ Sxtl(data0.V4S(), data0.V4H());
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+  __ Mul(acc0.V4S(), acc0.V4S(), vmultiplier.V4S());
+  __ Mul(acc1.V4S(), acc1.V4S(), vmultiplier.V4S());
+  __ Add(acc0.V4S(), acc0.V4S(), data0.V4S());
+  __ Add(acc1.V4S(), acc1.V4S(), data1.V4S());
+  __ Subs(length, length, 8);
+  __ B(ge, &vector_loop);
+  __ Add(length, length, 8);
+
+  // Lane 0 of `acc0` holds the most significant partial hash.
+  __ Umov(out, acc0.V4S(), 0);
+  for (int lane = 1; lane != 8; ++lane) {
+    __ Umov(temp, (lane < 4 ? acc0 : acc1).V4S(), lane % 4);
+    __ Madd(out, out, multiplier, temp);
+  }
+
+  __ Bind(&scalar_start);
+  __ Cbz(length, &done);
+  __ Bind(&scalar_loop);
+  switch (type) {
+    case DataType::Type::kInt32:
+      __ Ldr(temp, MemOperand(ptr.X(), sizeof(int32_t), PostIndex));
+      break;
+    case DataType::Type::kUint16:
+      __ Ldrh(temp, MemOperand(ptr.X(), sizeof(uint16_t), PostIndex));
+      break;
+    case DataType::Type::kUint8:
+      __ Ldrb(temp, MemOperand(ptr.X(), sizeof(uint8_t), PostIndex));
+      break;
+    case DataType::Type::kInt8:
+      __ Ldrsb(temp, MemOperand(ptr.X(), sizeof(int8_t), PostIndex));
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+  __ Madd(out, out, multiplier, temp);
+  __ Subs(length, length, 1);
+  __ B(ne, &scalar_loop);
+  __ Bind(&done);
+}
+
+static void CreatePolynomialHashLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  // Pointer and length.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  // Two accumulators, the multiplier and two data registers.
+  for (size_t i = 0; i != 5u; ++i) {
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+}
+
+static void GeneratePolynomialHash(MacroAssembler* masm,
+                                   LocationSummary* locations,
+                                   DataType::Type type) {
+  UseScratchRegisterScope temps(masm);
+  GeneratePolynomialHash(masm,
+                         type,
+                         XRegisterFrom(locations->GetTemp(0)),
+                         WRegisterFrom(locations->GetTemp(1)),
+                         WRegisterFrom(locations->Out()),
+                         temps.AcquireW(),
+                         temps.AcquireW(),
+                         QRegisterFrom(locations->GetTemp(2)),
+                         QRegisterFrom(locations->GetTemp(3)),
+                         QRegisterFrom(locations->GetTemp(4)),
+                         QRegisterFrom(locations->GetTemp(5)),
+                         QRegisterFrom(locations->GetTemp(6)));
+}
+
+static void GenerateArraysHashCode(MacroAssembler* masm, HInvoke* invoke, DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  Register array = WRegisterFrom(locations->InAt(0));
+  Register out = WRegisterFrom(locations->Out());
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  Register length = WRegisterFrom(locations->GetTemp(1));
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  vixl::aarch64::Label done;
+  // Arrays.hashCode(null) is 0, otherwise the hash starts at 1.
+  __ Mov(out, 0);
+  __ Cbz(array, &done);
+  __ Ldr(length, HeapOperand(array, length_offset));
+  __ Add(ptr, array.X(), data_offset);
+  __ Mov(out, 1);
+  GeneratePolynomialHash(masm, locations, type);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  CreatePolynomialHashLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  GenerateArraysHashCode(GetVIXLAssembler(), invoke, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  CreatePolynomialHashLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  GenerateArraysHashCode(GetVIXLAssembler(), invoke, DataType::Type::kInt32);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitStringHashCode(HInvoke* invoke) {
+  CreatePolynomialHashLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitStringHashCode(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register str = WRegisterFrom(locations->InAt(0));
+  Register out = WRegisterFrom(locations->Out());
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  Register length = WRegisterFrom(locations->GetTemp(1));
+  const uint32_t hash_offset = mirror::String::HashCodeOffset().Uint32Value();
+  const uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
+  const uint32_t value_offset = mirror::String::ValueOffset().Uint32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  vixl::aarch64::Label done;
+  // Return the cached hash if it has already been computed. Otherwise `out` is 0 which is the
+  // initial value of the hash.
+  __ Ldr(out, HeapOperand(str, hash_offset));
+  __ Cbnz(out, &done);
+  __ Ldr(length, HeapOperand(str, count_offset));
+  __ Add(ptr, str.X(), value_offset);
+  if (mirror::kUseStringCompression) {
+    vixl::aarch64::Label compressed;
+    vixl::aarch64::Label store;
+    static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                  "Expecting 0=compressed, 1=uncompressed");
+    __ Tbz(length, 0, &compressed);
+    __ Lsr(length, length, 1u);
+    GeneratePolynomialHash(masm, locations, DataType::Type::kUint16);
+    __ B(&store);
+    __ Bind(&compressed);
+    __ Lsr(length, length, 1u);
+    GeneratePolynomialHash(masm, locations, DataType::Type::kUint8);
+    __ Bind(&store);
+  } else {
+    GeneratePolynomialHash(masm, locations, DataType::Type::kUint16);
+  }
+  // Cache the hash. Like String.hashCode(), this is a benign race with other threads.
+  __ Str(out, HeapOperand(str, hash_offset));
+  __ Bind(&done);
+}
+
+static void CreateArraysEqualsLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  // Two pointers and the remaining length in bytes.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  for (size_t i = 0; i != 4u; ++i) {
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+}
+
+static void GenerateArraysEquals(MacroAssembler* masm, HInvoke* invoke, DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  Register array1 = WRegisterFrom(locations->InAt(0));
+  Register array2 = WRegisterFrom(locations->InAt(1));
+  Register out = WRegisterFrom(locations->Out());
+  Register ptr1 = XRegisterFrom(locations->GetTemp(0));
+  Register ptr2 = XRegisterFrom(locations->GetTemp(1));
+  Register length = WRegisterFrom(locations->GetTemp(2));
+  VRegister data0 = QRegisterFrom(locations->GetTemp(3));
+  VRegister data1 = QRegisterFrom(locations->GetTemp(4));
+  VRegister data2 = QRegisterFrom(locations->GetTemp(5));
+  VRegister data3 = QRegisterFrom(locations->GetTemp(6));
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const size_t element_size = DataType::Size(type);
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
+
+  UseScratchRegisterScope temps(masm);
+  Register temp1 = temps.AcquireX();
+  Register temp2 = temps.AcquireX();
+
+  vixl::aarch64::Label vector_loop;
+  vixl::aarch64::Label tail;
+  vixl::aarch64::Label tail8;
+  vixl::aarch64::Label tail4;
+  vixl::aarch64::Label return_true;
+  vixl::aarch64::Label return_false;
+  vixl::aarch64::Label end;
+
+  __ Cmp(array1, array2);
+  __ B(&return_true, eq);
+  __ Cbz(array1, &return_false);
+  __ Cbz(array2, &return_false);
+  __ Ldr(length, HeapOperand(array1, length_offset));
+  __ Ldr(temp1.W(), HeapOperand(array2, length_offset));
+  __ Cmp(length, temp1.W());
+  __ B(&return_false, ne);
+  if (element_size != 1u) {
+    __ Lsl(length, length, WhichPowerOf2(element_size));
+  }
+  __ Add(ptr1, array1.X(), data_offset);
+  __ Add(ptr2, array2.X(), data_offset);
+
+  // Compare 32 bytes per iteration. The low five bits of `length` are unaffected by the
+  // subtractions and give the size of the tail.
+  __ Subs(length, length, 2 * kQRegSizeInBytes);
+  __ B(lt, &tail);
+  __ Bind(&vector_loop);
+  __ Ldp(data0, data1, MemOperand(ptr1, 2 * kQRegSizeInBytes, PostIndex));
+  __ Ldp(data2, data3, MemOperand(ptr2, 2 * kQRegSizeInBytes, PostIndex));
+  __ Eor(data0.V16B(), data0.V16B(), data2.V16B());
+  __ Eor(data1.V16B(), data1.V16B(), data3.V16B());
+  __ Orr(data0.V16B(), data0.V16B(), data1.V16B());
+  __ Umaxp(data0.V4S(), data0.V4S(), data0.V4S());
+  __ Umov(temp1, data0.V2D(), 0);
+  __ Cbnz(temp1, &return_false);
+  __ Subs(length, length, 2 * kQRegSizeInBytes);
+  __ B(ge, &vector_loop);
+
+  __ Bind(&tail);
+  __ Tbz(length, 4, &tail8);
+  __ Ldr(data0, MemOperand(ptr1, kQRegSizeInBytes, PostIndex));
+  __ Ldr(data2, MemOperand(ptr2, kQRegSizeInBytes, PostIndex));
+  __ Eor(data0.V16B(), data0.V16B(), data2.V16B());
+  __ Umaxp(data0.V4S(), data0.V4S(), data0.V4S());
+  __ Umov(temp1, data0.V2D(), 0);
+  __ Cbnz(temp1, &return_false);
+  __ Bind(&tail8);
+  __ Tbz(length, 3, &tail4);
+  __ Ldr(temp1, MemOperand(ptr1, sizeof(uint64_t), PostIndex));
+  __ Ldr(temp2, MemOperand(ptr2, sizeof(uint64_t), PostIndex));
+  __ Cmp(temp1, temp2);
+  __ B(&return_false, ne);
+  __ Bind(&tail4);
+  if (element_size == 1u) {
+    vixl::aarch64::Label tail2;
+    vixl::aarch64::Label tail1;
+    __ Tbz(length, 2, &tail2);
+    __ Ldr(temp1.W(), MemOperand(ptr1, sizeof(uint32_t), PostIndex));
+    __ Ldr(temp2.W(), MemOperand(ptr2, sizeof(uint32_t), PostIndex));
+    __ Cmp(temp1.W(), temp2.W());
+    __ B(&return_false, ne);
+    __ Bind(&tail2);
+    __ Tbz(length, 1, &tail1);
+    __ Ldrh(temp1.W(), MemOperand(ptr1, sizeof(uint16_t), PostIndex));
+    __ Ldrh(temp2.W(), MemOperand(ptr2, sizeof(uint16_t), PostIndex));
+    __ Cmp(temp1.W(), temp2.W());
+    __ B(&return_false, ne);
+    __ Bind(&tail1);
+    __ Tbz(length, 0, &return_true);
+    __ Ldrb(temp1.W(), MemOperand(ptr1));
+    __ Ldrb(temp2.W(), MemOperand(ptr2));
+    __ Cmp(temp1.W(), temp2.W());
+    __ B(&return_false, ne);
+  } else {
+    DCHECK_EQ(element_size, sizeof(int32_t));
+    __ Tbz(length, 2, &return_true);
+    __ Ldr(temp1.W(), MemOperand(ptr1));
+    __ Ldr(temp2.W(), MemOperand(ptr2));
+    __ Cmp(temp1.W(), temp2.W());
+    __ B(&return_false, ne);
+  }
+
+  __ Bind(&return_true);
+  __ Mov(out, 1);
+  __ B(&end);
+  __ Bind(&return_false);
+  __ Mov(out, 0);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateArraysEqualsLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenerateArraysEquals(GetVIXLAssembler(), invoke, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateArraysEqualsLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenerateArraysEquals(GetVIXLAssembler(), invoke, DataType::Type::kInt32);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysFillInt(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // Pointer and the remaining length in bytes.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysFillInt(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register array = WRegisterFrom(locations->InAt(0));
+  Register value = WRegisterFrom(locations->InAt(1));
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  Register length = WRegisterFrom(locations->GetTemp(1));
+  VRegister vvalue = QRegisterFrom(locations->GetTemp(2));
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(sizeof(int32_t)).Uint32Value();
+
+  // Let the Java code throw the NullPointerException.
+  SlowPathCodeARM64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  __ Cbz(array, slow_path->GetEntryLabel());
+
+  vixl::aarch64::Label loop;
+  vixl::aarch64::Label tail;
+  vixl::aarch64::Label tail8;
+  vixl::aarch64::Label tail4;
+  __ Ldr(length, HeapOperand(array, length_offset));
+  __ Lsl(length, length, WhichPowerOf2(sizeof(int32_t)));
+  __ Add(ptr, array.X(), data_offset);
+  __ Dup(vvalue.V4S(), value);
+
+  // Store 32 bytes per iteration, the low five bits of `length` give the size of the tail.
+  __ Subs(length, length, 2 * kQRegSizeInBytes);
+  __ B(lt, &tail);
+  __ Bind(&loop);
+  __ Stp(vvalue, vvalue, MemOperand(ptr, 2 * kQRegSizeInBytes, PostIndex));
+  __ Subs(length, length, 2 * kQRegSizeInBytes);
+  __ B(ge, &loop);
+  __ Bind(&tail);
+  __ Tbz(length, 4, &tail8);
+  __ Str(vvalue, MemOperand(ptr, kQRegSizeInBytes, PostIndex));
+  __ Bind(&tail8);
+  __ Tbz(length, 3, &tail4);
+  __ Str(DRegister(vvalue.GetCode()), MemOperand(ptr, kDRegSizeInBytes, PostIndex));
+  __ Bind(&tail4);
+  __ Tbz(length, 2, slow_path->GetExitLabel());
+  __ Str(value, MemOperand(ptr));
+  __ Bind(slow_path->GetExitLabel());
+}
+
 UNIMPLEMENTED_INTRINSIC(ARM64, ReferenceGetReferent)
 
 UNIMPLEMENTED_INTRINSIC(ARM64, StringStringIndexOf);
@@ -3493,6 +4009,41 @@ UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_INTRINSIC(ARM64, MethodHandleInvokeExact)
+UNIMPLEMENTED_INTRINSIC(ARM64, MethodHandleInvoke)
+
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleCompareAndExchange)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleCompareAndExchangeAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleCompareAndExchangeRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGet)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndAdd)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndAddAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndAddRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseAnd)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseAndAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseAndRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseOr)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseOrAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseOrRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseXor)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseXorAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseXorRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndSet)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndSetRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetOpaque)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetVolatile)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleSet)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleSetOpaque)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleSetRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleSetVolatile)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleWeakCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleWeakCompareAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleWeakCompareAndSetPlain)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleWeakCompareAndSetRelease)
+
 UNREACHABLE_INTRINSICS(ARM64)
 
 #undef __
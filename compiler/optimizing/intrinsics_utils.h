@@ -60,6 +60,8 @@ class IntrinsicSlowPath : public TSlowPathCode {
 
     if (invoke_->IsInvokeStaticOrDirect()) {
       codegen->GenerateStaticOrDirectCall(invoke_->AsInvokeStaticOrDirect(), method_loc, this);
+    } else if (invoke_->IsInvokePolymorphic()) {
+      codegen->GenerateInvokePolymorphicCall(invoke_->AsInvokePolymorphic(), this);
     } else {
       codegen->GenerateVirtualCall(invoke_->AsInvokeVirtual(), method_loc, this);
     }
@@ -67,8 +69,12 @@ class IntrinsicSlowPath : public TSlowPathCode {
     // Copy the result back to the expected output.
     Location out = invoke_->GetLocations()->Out();
     if (out.IsValid()) {
-      DCHECK(out.IsRegister());  // TODO: Replace this when we support output in memory.
-      DCHECK(!invoke_->GetLocations()->GetLiveRegisters()->ContainsCoreRegister(out.reg()));
+      // TODO: Replace this when we support output in memory.
+      DCHECK(out.IsRegister() || out.IsFpuRegister());
+      DCHECK(out.IsFpuRegister() ||
+             !invoke_->GetLocations()->GetLiveRegisters()->ContainsCoreRegister(out.reg()));
+      DCHECK(out.IsRegister() ||
+             !invoke_->GetLocations()->GetLiveRegisters()->ContainsFloatingPointRegister(out.reg()));
       codegen->MoveFromReturnRegister(out, invoke_->GetType());
     }
 
@@ -85,6 +91,16 @@ class IntrinsicSlowPath : public TSlowPathCode {
   DISALLOW_COPY_AND_ASSIGN(IntrinsicSlowPath);
 };
 
+// Returns the type of the call site return value (index 0) or of the argument `index`, not
+// counting the MethodHandle or VarHandle, of an intrinsified invoke-polymorphic.
+static inline DataType::Type GetDataTypeFromShorty(HInvoke* invoke, uint32_t index) {
+  DCHECK(invoke->IsInvokePolymorphic());
+  HInvokePolymorphic* polymorphic = invoke->AsInvokePolymorphic();
+  const char* shorty = polymorphic->GetDexFile().GetShorty(polymorphic->GetProtoIndex());
+  DCHECK_LT(index, strlen(shorty));
+  return DataType::FromShorty(shorty[index]);
+}
+
 }  // namespace art
 
 #endif  // ART_COMPILER_OPTIMIZING_INTRINSICS_UTILS_H_
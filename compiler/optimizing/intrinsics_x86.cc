@@ -762,6 +762,58 @@ void IntrinsicCodeGeneratorX86::VisitLongLowestOneBit(HInvoke* invoke) {
   GenLowestOneBit(GetAssembler(), codegen_, /*is_long=*/ true, invoke);
 }
 
+static void CreateUnsignedDivisionLocations(ArenaAllocator* allocator,
+                                            HInvoke* invoke,
+                                            bool is_remainder) {
+  // The slow path calls the managed method to throw ArithmeticException for a zero divisor.
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  // Intel uses edx:eax as the dividend and puts the quotient in eax and the remainder in edx.
+  locations->SetInAt(0, Location::RegisterLocation(EAX));
+  locations->SetInAt(1, Location::RequiresRegister());
+  if (is_remainder) {
+    locations->SetOut(Location::RegisterLocation(EDX));
+  } else {
+    locations->SetOut(Location::SameAsFirstInput());
+    locations->AddTemp(Location::RegisterLocation(EDX));
+  }
+}
+
+static void GenUnsignedDivision(X86Assembler* assembler,
+                                CodeGeneratorX86* codegen,
+                                HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Register divisor = locations->InAt(1).AsRegister<Register>();
+  DCHECK_EQ(EAX, locations->InAt(0).AsRegister<Register>());
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ testl(divisor, divisor);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  // Zero-extend the dividend into edx:eax.
+  __ xorl(EDX, EDX);
+  __ divl(divisor);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke, /* is_remainder= */ false);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(GetAssembler(), codegen_, invoke);
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerRemainderUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke, /* is_remainder= */ true);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerRemainderUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(GetAssembler(), codegen_, invoke);
+}
+
 static void CreateFPFPToFPCallLocations(ArenaAllocator* allocator, HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator) LocationSummary(invoke, LocationSummary::kCallOnMainOnly, kIntrinsified);
@@ -3078,6 +3130,8 @@ UNIMPLEMENTED_INTRINSIC(X86, FloatIsInfinite)
 UNIMPLEMENTED_INTRINSIC(X86, DoubleIsInfinite)
 UNIMPLEMENTED_INTRINSIC(X86, IntegerHighestOneBit)
 UNIMPLEMENTED_INTRINSIC(X86, LongHighestOneBit)
+UNIMPLEMENTED_INTRINSIC(X86, LongDivideUnsigned)
+UNIMPLEMENTED_INTRINSIC(X86, LongRemainderUnsigned)
 UNIMPLEMENTED_INTRINSIC(X86, CRC32Update)
 UNIMPLEMENTED_INTRINSIC(X86, CRC32UpdateBytes)
 UNIMPLEMENTED_INTRINSIC(X86, CRC32UpdateByteBuffer)
@@ -3093,6 +3147,12 @@ UNIMPLEMENTED_INTRINSIC(X86, FP16LessEquals)
 UNIMPLEMENTED_INTRINSIC(X86, FP16Compare)
 UNIMPLEMENTED_INTRINSIC(X86, FP16Min)
 UNIMPLEMENTED_INTRINSIC(X86, FP16Max)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysFillInt)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysHashCodeByte)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysHashCodeInt)
+UNIMPLEMENTED_INTRINSIC(X86, StringHashCode)
 
 UNIMPLEMENTED_INTRINSIC(X86, StringStringIndexOf);
 UNIMPLEMENTED_INTRINSIC(X86, StringStringIndexOfAfter);
@@ -3119,6 +3179,41 @@ UNIMPLEMENTED_INTRINSIC(X86, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(X86, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(X86, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_INTRINSIC(X86, MethodHandleInvokeExact)
+UNIMPLEMENTED_INTRINSIC(X86, MethodHandleInvoke)
+
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleCompareAndExchange)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleCompareAndExchangeAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleCompareAndExchangeRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndAdd)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndAddAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndAddRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseAnd)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseAndAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseAndRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseOr)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseOrAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseOrRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseXor)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseXorAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseXorRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndSet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndSetRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetOpaque)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetVolatile)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleSet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleSetOpaque)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleSetRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleSetVolatile)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleWeakCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleWeakCompareAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleWeakCompareAndSetPlain)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleWeakCompareAndSetRelease)
+
 UNREACHABLE_INTRINSICS(X86)
 
 #undef __
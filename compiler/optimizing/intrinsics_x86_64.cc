@@ -19,9 +19,13 @@
 #include <limits>
 
 #include "arch/x86_64/instruction_set_features_x86_64.h"
+#include "art_field.h"
 #include "art_method.h"
 #include "base/bit_utils.h"
+#include "base/casts.h"
+#include "class_status.h"
 #include "code_generator_x86_64.h"
+#include "data_type-inl.h"
 #include "entrypoints/quick/quick_entrypoints.h"
 #include "heap_poisoning.h"
 #include "intrinsics.h"
@@ -31,7 +35,9 @@
 #include "mirror/object_array-inl.h"
 #include "mirror/reference.h"
 #include "mirror/string.h"
+#include "mirror/var_handle.h"
 #include "scoped_thread_state_change-inl.h"
+#include "subtype_check_bits.h"
 #include "thread-current-inl.h"
 #include "utils/x86_64/assembler_x86_64.h"
 #include "utils/x86_64/constants_x86_64.h"
@@ -2515,6 +2521,83 @@ void IntrinsicCodeGeneratorX86_64::VisitLongLowestOneBit(HInvoke* invoke) {
   GenOneBit(GetAssembler(), codegen_, invoke, /* is_high= */ false, /* is_long= */ true);
 }
 
+static void CreateUnsignedDivisionLocations(ArenaAllocator* allocator,
+                                            HInvoke* invoke,
+                                            bool is_remainder) {
+  // The slow path calls the managed method to throw ArithmeticException for a zero divisor.
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  // Intel uses rdx:rax as the dividend and puts the quotient in rax and the remainder in rdx.
+  locations->SetInAt(0, Location::RegisterLocation(RAX));
+  locations->SetInAt(1, Location::RequiresRegister());
+  if (is_remainder) {
+    locations->SetOut(Location::RegisterLocation(RDX));
+  } else {
+    locations->SetOut(Location::SameAsFirstInput());
+    locations->AddTemp(Location::RegisterLocation(RDX));
+  }
+}
+
+static void GenUnsignedDivision(X86_64Assembler* assembler,
+                                CodeGeneratorX86_64* codegen,
+                                HInvoke* invoke,
+                                bool is_long) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister divisor = locations->InAt(1).AsRegister<CpuRegister>();
+  DCHECK_EQ(RAX, locations->InAt(0).AsRegister<CpuRegister>().AsRegister());
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  if (is_long) {
+    __ testq(divisor, divisor);
+  } else {
+    __ testl(divisor, divisor);
+  }
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  // Zero-extend the dividend into rdx:rax.
+  __ xorl(CpuRegister(RDX), CpuRegister(RDX));
+  if (is_long) {
+    __ divq(divisor);
+  } else {
+    __ divl(divisor);
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke, /* is_remainder= */ false);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(GetAssembler(), codegen_, invoke, /* is_long= */ false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitIntegerRemainderUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke, /* is_remainder= */ true);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitIntegerRemainderUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(GetAssembler(), codegen_, invoke, /* is_long= */ false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitLongDivideUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke, /* is_remainder= */ false);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitLongDivideUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(GetAssembler(), codegen_, invoke, /* is_long= */ true);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitLongRemainderUnsigned(HInvoke* invoke) {
+  CreateUnsignedDivisionLocations(allocator_, invoke, /* is_remainder= */ true);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitLongRemainderUnsigned(HInvoke* invoke) {
+  GenUnsignedDivision(GetAssembler(), codegen_, invoke, /* is_long= */ true);
+}
+
 static void CreateLeadingZeroLocations(ArenaAllocator* allocator, HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
@@ -2742,6 +2825,748 @@ void IntrinsicLocationsBuilderX86_64::VisitReachabilityFence(HInvoke* invoke) {
 
 void IntrinsicCodeGeneratorX86_64::VisitReachabilityFence(HInvoke* invoke ATTRIBUTE_UNUSED) { }
 
+// Compute `out = 31 * out + data[i]` over `length` elements of `type` starting at `ptr`, eight
+// elements per iteration of the vector loop. The vector loop keeps the eight partial hashes in
+// two accumulators which are multiplied by 31^8 on each iteration, with the incoming `out` in
+// the most significant lane, and then folds them with a Horner step over the eight lanes.
+// Needs SSE4.1 for PMULLD. Clobbers `ptr`, `length` and all the temporaries.
+static void GeneratePolynomialHash(X86_64Assembler* assembler,
+                                   DataType::Type type,
+                                   CpuRegister ptr,
+                                   CpuRegister length,
+                                   CpuRegister out,
+                                   CpuRegister temp,
+                                   XmmRegister acc0,
+                                   XmmRegister acc1,
+                                   XmmRegister vmultiplier,
+                                   XmmRegister data0,
+                                   XmmRegister data1,
+                                   XmmRegister zero) {
+  // The vector loop and the Horner step do not fit in the range of a near jump.
+  Label vector_loop, scalar_start, done;
+  NearLabel scalar_loop;
+
+  __ cmpl(length, Immediate(8));
+  __ j(kLess, &scalar_start);
+
+  __ pxor(acc0, acc0);
+  __ movd(acc1, out, /* is64bit= */ false);
+  __ pshufd(acc1, acc1, Immediate(0x15));  // Move `out` to lane 3, zero the other lanes.
+  __ movl(temp, Immediate(static_cast<int32_t>(kPolynomialHashMultiplierPow8)));
+  __ movd(vmultiplier, temp, /* is64bit= */ false);
+  __ pshufd(vmultiplier, vmultiplier, Immediate(0));
+  __ pxor(zero, zero);
+  __ subl(length, Immediate(8));
+
+  __ Bind(&vector_loop);
+  switch (type) {
+    case DataType::Type::kInt32:
+      __ movdqu(data0, Address(ptr, 0));
+      __ movdqu(data1, Address(ptr, 4 * sizeof(int32_t)));
+      __ addq(ptr, Immediate(8 * sizeof(int32_t)));
+      break;
+    case DataType::Type::kUint16:
+      __ movdqu(data0, Address(ptr, 0));
+      __ movdqa(data1, data0);
+      __ punpcklwd(data0, zero);
+      __ punpckhwd(data1, zero);
+      __ addq(ptr, Immediate(8 * sizeof(uint16_t)));
+      break;
+    case DataType::Type::kUint8:
+      __ movsd(data0, Address(ptr, 0));
+      __ punpcklbw(data0, zero);
+      __ movdqa(data1, data0);
+      __ punpcklwd(data0, zero);
+      __ punpckhwd(data1, zero);
+      __ addq(ptr, Immediate(8 * sizeof(uint8_t)));
+      break;
+    case DataType::Type::kInt8:
+      // Sign-extend by interleaving each element with itself and shifting arithmetically.
+      __ movsd(data0, Address(ptr, 0));
+      __ punpcklbw(data0, data0);
+      __ psraw(data0, Immediate(8));
+      __ movdqa(data1, data0);
+      __ punpcklwd(data0, data0);
+      __ punpckhwd(data1, data1);
+      __ psrad(data0, Immediate(16));
+      __ psrad(data1, Immediate(16));
+      __ addq(ptr, Immediate(8 * sizeof(int8_t)));
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+  __ pmulld(acc0, vmultiplier);
+  __ pmulld(acc1, vmultiplier);
+  __ paddd(acc0, data0);
+  __ paddd(acc1, data1);
+  __ subl(length, Immediate(8));
+  __ j(kGreaterEqual, &vector_loop);
+  __ addl(length, Immediate(8));
+
+  // Lane 0 of `acc0` holds the most significant partial hash.
+  __ movd(out, acc0, /* is64bit= */ false);
+  for (int lane = 1; lane != 8; ++lane) {
+    __ pshufd(data0, lane < 4 ? acc0 : acc1, Immediate(lane % 4));
+    __ movd(temp, data0, /* is64bit= */ false);
+    __ imull(out, out, Immediate(kPolynomialHashMultiplier));
+    __ addl(out, temp);
+  }
+
+  __ Bind(&scalar_start);
+  __ testl(length, length);
+  __ j(kEqual, &done);
+  __ Bind(&scalar_loop);
+  switch (type) {
+    case DataType::Type::kInt32:
+      __ movl(temp, Address(ptr, 0));
+      break;
+    case DataType::Type::kUint16:
+      __ movzxw(temp, Address(ptr, 0));
+      break;
+    case DataType::Type::kUint8:
+      __ movzxb(temp, Address(ptr, 0));
+      break;
+    case DataType::Type::kInt8:
+      __ movsxb(temp, Address(ptr, 0));
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+  __ imull(out, out, Immediate(kPolynomialHashMultiplier));
+  __ addl(out, temp);
+  __ addq(ptr, Immediate(DataType::Size(type)));
+  __ subl(length, Immediate(1));
+  __ j(kNotEqual, &scalar_loop);
+  __ Bind(&done);
+}
+
+static void CreatePolynomialHashLocations(ArenaAllocator* allocator,
+                                          HInvoke* invoke,
+                                          CodeGeneratorX86_64* codegen) {
+  if (!codegen->GetInstructionSetFeatures().HasSSE4_1()) {
+    return;  // Leave the call to the Java code, there is no PMULLD.
+  }
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  // Pointer and length.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  // Two accumulators, the multiplier, two data registers and a zero register.
+  for (size_t i = 0; i != 6u; ++i) {
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+}
+
+static void GeneratePolynomialHash(X86_64Assembler* assembler,
+                                   LocationSummary* locations,
+                                   DataType::Type type) {
+  GeneratePolynomialHash(assembler,
+                         type,
+                         locations->GetTemp(0).AsRegister<CpuRegister>(),
+                         locations->GetTemp(1).AsRegister<CpuRegister>(),
+                         locations->Out().AsRegister<CpuRegister>(),
+                         CpuRegister(TMP),
+                         locations->GetTemp(2).AsFpuRegister<XmmRegister>(),
+                         locations->GetTemp(3).AsFpuRegister<XmmRegister>(),
+                         locations->GetTemp(4).AsFpuRegister<XmmRegister>(),
+                         locations->GetTemp(5).AsFpuRegister<XmmRegister>(),
+                         locations->GetTemp(6).AsFpuRegister<XmmRegister>(),
+                         locations->GetTemp(7).AsFpuRegister<XmmRegister>());
+}
+
+static void GenerateArraysHashCode(X86_64Assembler* assembler,
+                                   HInvoke* invoke,
+                                   DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  Label done;
+  // Arrays.hashCode(null) is 0, otherwise the hash starts at 1.
+  __ xorl(out, out);
+  __ testl(array, array);
+  __ j(kEqual, &done);
+  __ movl(length, Address(array, length_offset));
+  __ leaq(ptr, Address(array, data_offset));
+  __ movl(out, Immediate(1));
+  GeneratePolynomialHash(assembler, locations, type);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  CreatePolynomialHashLocations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  GenerateArraysHashCode(GetAssembler(), invoke, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  CreatePolynomialHashLocations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  GenerateArraysHashCode(GetAssembler(), invoke, DataType::Type::kInt32);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringHashCode(HInvoke* invoke) {
+  CreatePolynomialHashLocations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringHashCode(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  const uint32_t hash_offset = mirror::String::HashCodeOffset().Uint32Value();
+  const uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
+  const uint32_t value_offset = mirror::String::ValueOffset().Uint32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  Label done;
+  // Return the cached hash if it has already been computed. Otherwise `out` is 0 which is the
+  // initial value of the hash.
+  __ movl(out, Address(str, hash_offset));
+  __ testl(out, out);
+  __ j(kNotEqual, &done);
+  __ movl(length, Address(str, count_offset));
+  __ leaq(ptr, Address(str, value_offset));
+  if (mirror::kUseStringCompression) {
+    Label uncompressed, store;
+    static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                  "Expecting 0=compressed, 1=uncompressed");
+    __ shrl(length, Immediate(1));
+    __ j(kCarrySet, &uncompressed);
+    GeneratePolynomialHash(assembler, locations, DataType::Type::kUint8);
+    __ jmp(&store);
+    __ Bind(&uncompressed);
+    GeneratePolynomialHash(assembler, locations, DataType::Type::kUint16);
+    __ Bind(&store);
+  } else {
+    GeneratePolynomialHash(assembler, locations, DataType::Type::kUint16);
+  }
+  // Cache the hash. Like String.hashCode(), this is a benign race with other threads.
+  __ movl(Address(str, hash_offset), out);
+  __ Bind(&done);
+}
+
+static void CreateArraysEqualsLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  // Two pointers, the remaining length in bytes and a temporary for the tail.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+static void GenerateArraysEquals(X86_64Assembler* assembler,
+                                 HInvoke* invoke,
+                                 DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister array1 = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister array2 = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister ptr1 = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister ptr2 = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(3).AsRegister<CpuRegister>();
+  XmmRegister data1 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  XmmRegister data2 = locations->GetTemp(5).AsFpuRegister<XmmRegister>();
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const size_t element_size = DataType::Size(type);
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
+
+  NearLabel vector_loop, tail, tail4, end;
+  Label return_true, return_false;
+
+  __ cmpl(array1, array2);
+  __ j(kEqual, &return_true);
+  __ testl(array1, array1);
+  __ j(kEqual, &return_false);
+  __ testl(array2, array2);
+  __ j(kEqual, &return_false);
+  __ movl(length, Address(array1, length_offset));
+  __ cmpl(length, Address(array2, length_offset));
+  __ j(kNotEqual, &return_false);
+  if (element_size != 1u) {
+    __ shll(length, Immediate(WhichPowerOf2(element_size)));
+  }
+  __ leaq(ptr1, Address(array1, data_offset));
+  __ leaq(ptr2, Address(array2, data_offset));
+
+  // Compare 16 bytes per iteration. The low four bits of `length` are unaffected by the
+  // subtractions and give the size of the tail.
+  __ subl(length, Immediate(16));
+  __ j(kLess, &tail);
+  __ Bind(&vector_loop);
+  __ movdqu(data1, Address(ptr1, 0));
+  __ movdqu(data2, Address(ptr2, 0));
+  __ pcmpeqb(data1, data2);
+  __ pmovmskb(temp, data1);
+  __ cmpl(temp, Immediate(0xffff));
+  __ j(kNotEqual, &return_false);
+  __ addq(ptr1, Immediate(16));
+  __ addq(ptr2, Immediate(16));
+  __ subl(length, Immediate(16));
+  __ j(kGreaterEqual, &vector_loop);
+
+  __ Bind(&tail);
+  __ testl(length, Immediate(8));
+  __ j(kZero, &tail4);
+  __ movq(temp, Address(ptr1, 0));
+  __ cmpq(temp, Address(ptr2, 0));
+  __ j(kNotEqual, &return_false);
+  __ addq(ptr1, Immediate(8));
+  __ addq(ptr2, Immediate(8));
+  __ Bind(&tail4);
+  if (element_size == 1u) {
+    NearLabel tail2, tail1;
+    __ testl(length, Immediate(4));
+    __ j(kZero, &tail2);
+    __ movl(temp, Address(ptr1, 0));
+    __ cmpl(temp, Address(ptr2, 0));
+    __ j(kNotEqual, &return_false);
+    __ addq(ptr1, Immediate(4));
+    __ addq(ptr2, Immediate(4));
+    __ Bind(&tail2);
+    __ testl(length, Immediate(2));
+    __ j(kZero, &tail1);
+    __ movzxw(temp, Address(ptr1, 0));
+    __ movzxw(out, Address(ptr2, 0));
+    __ cmpl(temp, out);
+    __ j(kNotEqual, &return_false);
+    __ addq(ptr1, Immediate(2));
+    __ addq(ptr2, Immediate(2));
+    __ Bind(&tail1);
+    __ testl(length, Immediate(1));
+    __ j(kZero, &return_true);
+    __ movzxb(temp, Address(ptr1, 0));
+    __ movzxb(out, Address(ptr2, 0));
+    __ cmpl(temp, out);
+    __ j(kNotEqual, &return_false);
+  } else {
+    DCHECK_EQ(element_size, sizeof(int32_t));
+    __ testl(length, Immediate(4));
+    __ j(kZero, &return_true);
+    __ movl(temp, Address(ptr1, 0));
+    __ cmpl(temp, Address(ptr2, 0));
+    __ j(kNotEqual, &return_false);
+  }
+
+  __ Bind(&return_true);
+  __ movl(out, Immediate(1));
+  __ jmp(&end);
+  __ Bind(&return_false);
+  __ xorl(out, out);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateArraysEqualsLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenerateArraysEquals(GetAssembler(), invoke, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateArraysEqualsLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenerateArraysEquals(GetAssembler(), invoke, DataType::Type::kInt32);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // Pointer and the remaining length in bytes.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister value = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  XmmRegister vvalue = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(sizeof(int32_t)).Uint32Value();
+
+  // Let the Java code throw the NullPointerException.
+  SlowPathCode* slow_path = new (codegen_->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  __ testl(array, array);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  NearLabel loop, tail, tail4;
+  __ movl(length, Address(array, length_offset));
+  __ shll(length, Immediate(WhichPowerOf2(sizeof(int32_t))));
+  __ leaq(ptr, Address(array, data_offset));
+  __ movd(vvalue, value, /* is64bit= */ false);
+  __ pshufd(vvalue, vvalue, Immediate(0));
+
+  // Store 16 bytes per iteration, the low four bits of `length` give the size of the tail.
+  __ subl(length, Immediate(16));
+  __ j(kLess, &tail);
+  __ Bind(&loop);
+  __ movdqu(Address(ptr, 0), vvalue);
+  __ addq(ptr, Immediate(16));
+  __ subl(length, Immediate(16));
+  __ j(kGreaterEqual, &loop);
+  __ Bind(&tail);
+  __ testl(length, Immediate(8));
+  __ j(kZero, &tail4);
+  __ movsd(Address(ptr, 0), vvalue);
+  __ addq(ptr, Immediate(8));
+  __ Bind(&tail4);
+  __ testl(length, Immediate(4));
+  __ j(kZero, slow_path->GetExitLabel());
+  __ movl(Address(ptr, 0), value);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+// Returns the type of the variable accessed by a get (`value_count` 0) or set (`value_count`
+// 1) access mode as seen by the call site, or kVoid if the intrinsic code does not handle it.
+static DataType::Type GetVarHandleFieldAccessType(HInvoke* invoke, uint32_t value_count) {
+  DCHECK_LE(value_count, 1u);
+  uint32_t number_of_arguments = invoke->GetNumberOfArguments();
+  DataType::Type type;
+  if (value_count == 0u) {
+    type = invoke->GetType();
+  } else if (invoke->GetType() != DataType::Type::kVoid) {
+    return DataType::Type::kVoid;
+  } else {
+    type = GetDataTypeFromShorty(invoke, number_of_arguments - 1u);
+  }
+  // References would need read barriers, write barriers and type checks; leave them to the
+  // runtime for now.
+  if (type == DataType::Type::kReference) {
+    return DataType::Type::kVoid;
+  }
+  // Only field VarHandles: static fields have no coordinates and instance fields have one
+  // reference coordinate for the object holding the field.
+  uint32_t coordinates_count = number_of_arguments - 1u - value_count;
+  if (coordinates_count > 1u) {
+    return DataType::Type::kVoid;
+  }
+  if (coordinates_count == 1u && GetDataTypeFromShorty(invoke, 1u) != DataType::Type::kReference) {
+    return DataType::Type::kVoid;
+  }
+  return type;
+}
+
+// Returns the number of coordinates of a VarHandle access accepted by
+// GetVarHandleFieldAccessType().
+static uint32_t GetVarHandleFieldCoordinatesCount(HInvoke* invoke) {
+  uint32_t value_count = (invoke->GetType() == DataType::Type::kVoid) ? 1u : 0u;
+  return invoke->GetNumberOfArguments() - 1u - value_count;
+}
+
+static void CreateVarHandleFieldLocations(HInvoke* invoke,
+                                          ArenaAllocator* allocator,
+                                          uint32_t value_count) {
+  DataType::Type type = GetVarHandleFieldAccessType(invoke, value_count);
+  if (type == DataType::Type::kVoid) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  uint32_t coordinates_count = GetVarHandleFieldCoordinatesCount(invoke);
+  if (coordinates_count == 1u) {
+    locations->SetInAt(1, Location::RequiresRegister());
+  }
+  Location value_location = DataType::IsFloatingPointType(type)
+      ? Location::RequiresFpuRegister()
+      : Location::RequiresRegister();
+  if (value_count != 0u) {
+    locations->SetInAt(invoke->GetNumberOfArguments() - 1u, value_location);
+  } else {
+    locations->SetOut(value_location);
+  }
+  // Temporaries for the checks and for the ArtField* and the field offset.
+  locations->AddTemp(Location::RequiresRegister());
+  if (coordinates_count == 0u) {
+    // Temporary for the declaring class of a static field.
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+// Checks the access mode, the variable type and the coordinates of the VarHandle against the
+// call site, and branches to `slow_path` if they do not match exactly. On success, returns
+// the register holding the object that contains the field and sets `field_offset` to the
+// offset of the field.
+static CpuRegister GenerateVarHandleFieldChecksAndTarget(HInvoke* invoke,
+                                                         CodeGeneratorX86_64* codegen,
+                                                         SlowPathCode* slow_path,
+                                                         DataType::Type type,
+                                                         CpuRegister field_offset) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister varhandle = locations->InAt(0).AsRegister<CpuRegister>();
+  uint32_t coordinates_count = GetVarHandleFieldCoordinatesCount(invoke);
+  DCHECK_LE(coordinates_count, 1u);
+
+  const MemberOffset access_mode_bit_mask_offset = mirror::VarHandle::AccessModesBitMaskOffset();
+  const MemberOffset var_type_offset = mirror::VarHandle::VarTypeOffset();
+  const MemberOffset coordinate_type0_offset = mirror::VarHandle::CoordinateType0Offset();
+  const MemberOffset coordinate_type1_offset = mirror::VarHandle::CoordinateType1Offset();
+  const MemberOffset primitive_type_offset = mirror::Class::PrimitiveTypeOffset();
+  const uint32_t class_offset = mirror::Object::ClassOffset().Uint32Value();
+
+  // Check that the VarHandle supports the access mode.
+  mirror::VarHandle::AccessMode access_mode =
+      mirror::VarHandle::GetAccessModeByIntrinsic(invoke->GetIntrinsic());
+  __ testl(Address(varhandle, access_mode_bit_mask_offset),
+           Immediate(1u << static_cast<uint32_t>(access_mode)));
+  __ j(kZero, slow_path->GetEntryLabel());
+
+  // Check that the variable has exactly the type used by the call site. Any conversions,
+  // including boxing, are left to the runtime.
+  // The primitive type of a class is immutable, so reading it from a from-space reference
+  // without a read barrier is fine.
+  __ movl(field_offset, Address(varhandle, var_type_offset));
+  __ MaybeUnpoisonHeapReference(field_offset);
+  __ cmpw(Address(field_offset, primitive_type_offset),
+          Immediate(static_cast<uint16_t>(DataTypeToPrimitive(type))));
+  __ j(kNotEqual, slow_path->GetEntryLabel());
+
+  if (coordinates_count == 0u) {
+    // A static field VarHandle is the only kind without coordinates.
+    __ cmpl(Address(varhandle, coordinate_type0_offset), Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+  } else {
+    // An instance field VarHandle is the only kind with exactly one coordinate.
+    CpuRegister receiver = locations->InAt(1).AsRegister<CpuRegister>();
+    __ cmpl(Address(varhandle, coordinate_type1_offset), Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+    __ movl(field_offset, Address(varhandle, coordinate_type0_offset));
+    __ testl(field_offset, field_offset);
+    __ j(kZero, slow_path->GetEntryLabel());
+    // Let the runtime throw the NullPointerException for a null receiver.
+    __ testl(receiver, receiver);
+    __ j(kZero, slow_path->GetEntryLabel());
+    // Check the class of the receiver without read barriers. A false mismatch, as well as a
+    // receiver of a subclass of the coordinate type, only takes the slow path. Both references
+    // are compared as they are stored, so heap poisoning does not matter.
+    __ cmpl(field_offset, Address(receiver, class_offset));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+  }
+
+  // Load the ArtField* and the field offset.
+  __ movq(field_offset, Address(varhandle, mirror::FieldVarHandle::ArtFieldOffset()));
+  CpuRegister object = (coordinates_count == 0u)
+      ? locations->GetTemp(1).AsRegister<CpuRegister>()
+      : locations->InAt(1).AsRegister<CpuRegister>();
+  if (coordinates_count == 0u) {
+    // For static fields, load the declaring class and check that it is initialized.
+    InstructionCodeGeneratorX86_64* instr_codegen =
+        down_cast<InstructionCodeGeneratorX86_64*>(codegen->GetInstructionVisitor());
+    instr_codegen->GenerateGcRootFieldLoad(invoke,
+                                           Location::RegisterLocation(object.AsRegister()),
+                                           Address(field_offset, ArtField::DeclaringClassOffset()),
+                                           /* fixup_label= */ nullptr,
+                                           kCompilerReadBarrierOption);
+    constexpr size_t status_lsb_position = SubtypeCheckBits::BitStructSizeOf();
+    const size_t status_byte_offset =
+        mirror::Class::StatusOffset().SizeValue() + (status_lsb_position / kBitsPerByte);
+    constexpr uint32_t shifted_visibly_initialized_value =
+        enum_cast<uint32_t>(ClassStatus::kVisiblyInitialized) << (status_lsb_position % kBitsPerByte);
+    __ cmpb(Address(object, status_byte_offset), Immediate(shifted_visibly_initialized_value));
+    __ j(kBelow, slow_path->GetEntryLabel());
+  }
+  __ movl(field_offset, Address(field_offset, ArtField::OffsetOffset()));
+  return object;
+}
+
+static void GenerateVarHandleGet(HInvoke* invoke, CodeGeneratorX86_64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  DataType::Type type = invoke->GetType();
+  DCHECK_EQ(type, GetVarHandleFieldAccessType(invoke, /* value_count= */ 0u));
+  Location out = locations->Out();
+  CpuRegister field_offset = locations->GetTemp(0).AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  CpuRegister object =
+      GenerateVarHandleFieldChecksAndTarget(invoke, codegen, slow_path, type, field_offset);
+  Address field_address(object, field_offset, TIMES_1, 0);
+
+  // All the get access modes are plain loads on x86-64.
+  switch (type) {
+    case DataType::Type::kBool:
+      __ movzxb(out.AsRegister<CpuRegister>(), field_address);
+      break;
+    case DataType::Type::kInt8:
+      __ movsxb(out.AsRegister<CpuRegister>(), field_address);
+      break;
+    case DataType::Type::kUint16:
+      __ movzxw(out.AsRegister<CpuRegister>(), field_address);
+      break;
+    case DataType::Type::kInt16:
+      __ movsxw(out.AsRegister<CpuRegister>(), field_address);
+      break;
+    case DataType::Type::kInt32:
+      __ movl(out.AsRegister<CpuRegister>(), field_address);
+      break;
+    case DataType::Type::kInt64:
+      __ movq(out.AsRegister<CpuRegister>(), field_address);
+      break;
+    case DataType::Type::kFloat32:
+      __ movss(out.AsFpuRegister<XmmRegister>(), field_address);
+      break;
+    case DataType::Type::kFloat64:
+      __ movsd(out.AsFpuRegister<XmmRegister>(), field_address);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void GenerateVarHandleSet(HInvoke* invoke,
+                                 CodeGeneratorX86_64* codegen,
+                                 bool is_volatile) {
+  LocationSummary* locations = invoke->GetLocations();
+  uint32_t value_index = invoke->GetNumberOfArguments() - 1u;
+  DataType::Type type = GetDataTypeFromShorty(invoke, value_index);
+  DCHECK_EQ(type, GetVarHandleFieldAccessType(invoke, /* value_count= */ 1u));
+  Location value = locations->InAt(value_index);
+  CpuRegister field_offset = locations->GetTemp(0).AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  CpuRegister object =
+      GenerateVarHandleFieldChecksAndTarget(invoke, codegen, slow_path, type, field_offset);
+  Address field_address(object, field_offset, TIMES_1, 0);
+
+  switch (type) {
+    case DataType::Type::kBool:
+    case DataType::Type::kInt8:
+      __ movb(field_address, value.AsRegister<CpuRegister>());
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      __ movw(field_address, value.AsRegister<CpuRegister>());
+      break;
+    case DataType::Type::kInt32:
+      __ movl(field_address, value.AsRegister<CpuRegister>());
+      break;
+    case DataType::Type::kInt64:
+      __ movq(field_address, value.AsRegister<CpuRegister>());
+      break;
+    case DataType::Type::kFloat32:
+      __ movss(field_address, value.AsFpuRegister<XmmRegister>());
+      break;
+    case DataType::Type::kFloat64:
+      __ movsd(field_address, value.AsFpuRegister<XmmRegister>());
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+
+  // Only the volatile access mode needs a fence; release and opaque stores are plain stores.
+  if (is_volatile) {
+    codegen->MemoryFence();
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleGet(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke, allocator_, /* value_count= */ 0u);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleGet(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke, allocator_, /* value_count= */ 0u);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke, allocator_, /* value_count= */ 0u);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke, allocator_, /* value_count= */ 0u);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleSet(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke, allocator_, /* value_count= */ 1u);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleSet(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* is_volatile= */ false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke, allocator_, /* value_count= */ 1u);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* is_volatile= */ false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke, allocator_, /* value_count= */ 1u);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* is_volatile= */ false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  CreateVarHandleFieldLocations(invoke, allocator_, /* value_count= */ 1u);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* is_volatile= */ true);
+}
+
 UNIMPLEMENTED_INTRINSIC(X86_64, ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(X86_64, FloatIsInfinite)
 UNIMPLEMENTED_INTRINSIC(X86_64, DoubleIsInfinite)
@@ -2786,6 +3611,33 @@ UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_INTRINSIC(X86_64, MethodHandleInvokeExact)
+UNIMPLEMENTED_INTRINSIC(X86_64, MethodHandleInvoke)
+
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleCompareAndExchange)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleCompareAndExchangeAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleCompareAndExchangeRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndAdd)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndAddAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndAddRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseAnd)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseAndAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseAndRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseOr)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseOrAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseOrRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseXor)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseXorAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseXorRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndSet)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndSetRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleWeakCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleWeakCompareAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleWeakCompareAndSetPlain)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleWeakCompareAndSetRelease)
+
 UNREACHABLE_INTRINSICS(X86_64)
 
 #undef __
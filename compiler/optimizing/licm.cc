@@ -16,6 +16,8 @@
 
 #include "licm.h"
 
+#include "base/scoped_arena_allocator.h"
+#include "load_store_analysis.h"
 #include "side_effects_analysis.h"
 
 namespace art {
@@ -78,6 +80,21 @@ static void UpdateLoopPhisIn(HEnvironment* environment, HLoopInformation* info)
   }
 }
 
+/**
+ * Returns whether the value of `instruction` may be changed by an iteration of the loop
+ * described by `info`. If available, `heap_alias_info` refines the loop side effects for
+ * heap loads.
+ */
+static bool MayDependOnLoop(HInstruction* instruction,
+                            SideEffects loop_effects,
+                            HLoopInformation* info,
+                            HeapAliasInfo* heap_alias_info) {
+  if (!instruction->GetSideEffects().MayDependOn(loop_effects)) {
+    return false;
+  }
+  return heap_alias_info == nullptr || heap_alias_info->IsKilledByLoop(instruction, info);
+}
+
 bool LICM::Run() {
   bool didLICM = false;
   DCHECK(side_effects_.HasRun());
@@ -91,6 +108,12 @@ bool LICM::Run() {
                                                           kArenaAllocLICM);
   }
 
+  // Precise heap aliasing lets loads move out of loops that only store to
+  // unrelated heap locations.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  HeapAliasInfo heap_alias_info(graph_, &allocator);
+  bool has_heap_alias_info = graph_->HasLoops() && heap_alias_info.Run();
+
   // Post order visit to visit inner loops before outer loops.
   for (HBasicBlock* block : graph_->GetPostOrder()) {
     if (!block->IsLoopHeader()) {
@@ -140,11 +163,17 @@ bool LICM::Run() {
                 // in the loop header so far have been hoisted out, we can hoist
                 // the clinit check out also.
                 can_move = true;
-              } else if (!instruction->GetSideEffects().MayDependOn(loop_effects)) {
+              } else if (!MayDependOnLoop(instruction,
+                                          loop_effects,
+                                          loop_info,
+                                          has_heap_alias_info ? &heap_alias_info : nullptr)) {
                 can_move = true;
               }
             }
-          } else if (!instruction->GetSideEffects().MayDependOn(loop_effects)) {
+          } else if (!MayDependOnLoop(instruction,
+                                      loop_effects,
+                                      loop_info,
+                                      has_heap_alias_info ? &heap_alias_info : nullptr)) {
             can_move = true;
           }
         }
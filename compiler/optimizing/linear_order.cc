@@ -36,11 +36,53 @@ static bool IsInnerLoop(HLoopInformation* outer, HLoopInformation* inner) {
       && inner->IsIn(*outer);
 }
 
+static bool IsInLoopOrNested(HLoopInformation* loop, HBasicBlock* block) {
+  return !IsLoop(loop) || loop->Contains(*block);
+}
+
+// Return whether `block` ends the method by throwing, i.e. whether it is a predecessor
+// of the exit block that does not return.
+static bool IsThrowingBlock(HBasicBlock* block) {
+  if (block->GetSuccessors().size() != 1u || !block->GetSingleSuccessor()->IsExitBlock()) {
+    return false;
+  }
+  HInstruction* last = block->GetLastInstruction();
+  return !last->IsReturn() && !last->IsReturnVoid();
+}
+
+// Return whether `block` is almost never executed, according to the branch profile or,
+// if `throwing_blocks_are_cold`, because it throws.
+static bool IsColdBlock(HBasicBlock* block, bool throwing_blocks_are_cold) {
+  if (block->IsLoopHeader()) {
+    return false;
+  }
+  if (throwing_blocks_are_cold && IsThrowingBlock(block)) {
+    return true;
+  }
+  if (block->GetPredecessors().size() != 1u) {
+    return false;
+  }
+  HInstruction* last = block->GetSinglePredecessor()->GetLastInstruction();
+  return last->IsIf() && last->AsIf()->IsUnlikelySuccessor(block);
+}
+
 // Helper method to update work list for linear order.
 static void AddToListForLinearization(ScopedArenaVector<HBasicBlock*>* worklist,
-                                      HBasicBlock* block) {
+                                      HBasicBlock* block,
+                                      bool throwing_blocks_are_cold) {
   HLoopInformation* block_loop = block->GetLoopInformation();
   auto insert_pos = worklist->rbegin();  // insert_pos.base() will be the actual position.
+  if (IsColdBlock(block, throwing_blocks_are_cold)) {
+    // Process the block as late as we can without leaving its loop, which moves it, and
+    // the blocks it dominates, out of line.
+    for (auto end = worklist->rend(); insert_pos != end; ++insert_pos) {
+      if (!IsInLoopOrNested(block_loop, *insert_pos)) {
+        break;
+      }
+    }
+    worklist->insert(insert_pos.base(), block);
+    return;
+  }
   for (auto end = worklist->rend(); insert_pos != end; ++insert_pos) {
     HBasicBlock* current = *insert_pos;
     HLoopInformation* current_loop = current->GetLoopInformation();
@@ -83,7 +125,9 @@ static bool IsLinearOrderWellFormed(const HGraph* graph, ArrayRef<HBasicBlock*>
   return true;
 }
 
-void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
+void LinearizeGraphInternal(const HGraph* graph,
+                            ArrayRef<HBasicBlock*> linear_order,
+                            bool throwing_blocks_are_cold) {
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
@@ -120,7 +164,7 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
       int block_id = successor->GetBlockId();
       size_t number_of_remaining_predecessors = forward_predecessors[block_id];
       if (number_of_remaining_predecessors == 1) {
-        AddToListForLinearization(&worklist, successor);
+        AddToListForLinearization(&worklist, successor, throwing_blocks_are_cold);
       }
       forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
     }
@@ -23,12 +23,17 @@
 
 namespace art {
 
-void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order);
+void LinearizeGraphInternal(const HGraph* graph,
+                            ArrayRef<HBasicBlock*> linear_order,
+                            bool throwing_blocks_are_cold);
 
 // Linearizes the 'graph' such that:
 // (1): a block is always after its dominator,
 // (2): blocks of loops are contiguous.
 //
+// If 'throwing_blocks_are_cold', blocks that end the method with a throw are placed
+// as late as their loop allows, like blocks the branch profile reports as unlikely.
+//
 // Storage is obtained through 'allocator' and the linear order it computed
 // into 'linear_order'. Once computed, iteration can be expressed as:
 //
@@ -37,13 +42,15 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
 // for (HBasicBlock* block : ReverseRange(linear_order))     // linear post order
 //
 template <typename Vector>
-void LinearizeGraph(const HGraph* graph, Vector* linear_order) {
+void LinearizeGraph(const HGraph* graph,
+                    Vector* linear_order,
+                    bool throwing_blocks_are_cold = false) {
   static_assert(std::is_same<HBasicBlock*, typename Vector::value_type>::value,
                 "Vector::value_type must be HBasicBlock*.");
   // Resize the vector and pass an ArrayRef<> to internal implementation which is shared
   // for all kinds of vectors, i.e. ArenaVector<> or ScopedArenaVector<>.
   linear_order->resize(graph->GetReversePostOrder().size());
-  LinearizeGraphInternal(graph, ArrayRef<HBasicBlock*>(*linear_order));
+  LinearizeGraphInternal(graph, ArrayRef<HBasicBlock*>(*linear_order), throwing_blocks_are_cold);
 }
 
 }  // namespace art
@@ -175,4 +175,105 @@ bool LoadStoreAnalysis::Run() {
   return true;
 }
 
+static bool IsTrackedHeapStore(HInstruction* instruction) {
+  return instruction->IsInstanceFieldSet() ||
+         instruction->IsStaticFieldSet() ||
+         instruction->IsArraySet() ||
+         instruction->IsVecStore();
+}
+
+bool HeapAliasInfo::Run() {
+  if (!lsa_.Run()) {
+    return false;
+  }
+  const HeapLocationCollector& collector = lsa_.GetHeapLocationCollector();
+  heap_location_of_.resize(graph_->GetCurrentInstructionId(),
+                           HeapLocationCollector::kHeapLocationNotFound);
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      size_t location = HeapLocationCollector::kHeapLocationNotFound;
+      if (instruction->IsInstanceFieldGet()) {
+        location = collector.GetFieldHeapLocation(
+            instruction->InputAt(0), &instruction->AsInstanceFieldGet()->GetFieldInfo());
+      } else if (instruction->IsInstanceFieldSet()) {
+        location = collector.GetFieldHeapLocation(
+            instruction->InputAt(0), &instruction->AsInstanceFieldSet()->GetFieldInfo());
+      } else if (instruction->IsStaticFieldGet()) {
+        location = collector.GetFieldHeapLocation(
+            instruction->InputAt(0), &instruction->AsStaticFieldGet()->GetFieldInfo());
+      } else if (instruction->IsStaticFieldSet()) {
+        location = collector.GetFieldHeapLocation(
+            instruction->InputAt(0), &instruction->AsStaticFieldSet()->GetFieldInfo());
+      } else if (instruction->IsArrayGet() ||
+                 instruction->IsArraySet() ||
+                 instruction->IsVecLoad() ||
+                 instruction->IsVecStore()) {
+        location = collector.GetArrayHeapLocation(instruction);
+      }
+      heap_location_of_[instruction->GetId()] = location;
+    }
+  }
+  loop_stores_.resize(graph_->GetBlocks().size(), nullptr);
+  return true;
+}
+
+bool HeapAliasInfo::MayAlias(HInstruction* load, HInstruction* store) const {
+  size_t load_location = GetHeapLocationOf(load);
+  size_t store_location = GetHeapLocationOf(store);
+  if (load_location == HeapLocationCollector::kHeapLocationNotFound ||
+      store_location == HeapLocationCollector::kHeapLocationNotFound) {
+    return true;
+  }
+  if (load->GetSideEffects().MayDependOn(
+          store->GetSideEffects().Exclusion(SideEffects::AllWrites()))) {
+    // E.g. the load must not live across the GC point of a reference array store.
+    return true;
+  }
+  return load_location == store_location ||
+         lsa_.GetHeapLocationCollector().MayAlias(load_location, store_location);
+}
+
+const HeapAliasInfo::LoopStores* HeapAliasInfo::GetLoopStores(HLoopInformation* loop_info) {
+  size_t header_id = loop_info->GetHeader()->GetBlockId();
+  DCHECK_LT(header_id, loop_stores_.size());
+  if (loop_stores_[header_id] == nullptr) {
+    LoopStores* loop_stores = new (allocator_) LoopStores(allocator_);
+    for (HBlocksInLoopIterator it_loop(*loop_info); !it_loop.Done(); it_loop.Advance()) {
+      HBasicBlock* block = it_loop.Current();
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        HInstruction* instruction = it.Current();
+        SideEffects effects = instruction->GetSideEffects();
+        if (IsTrackedHeapStore(instruction) &&
+            GetHeapLocationOf(instruction) != HeapLocationCollector::kHeapLocationNotFound) {
+          // The write is checked against the aliasing matrix instead; keep the
+          // remaining effects, e.g. the GC side effect of a reference array store.
+          loop_stores->stores.push_back(instruction);
+          effects = effects.Exclusion(SideEffects::AllWrites());
+        }
+        loop_stores->other_effects.Add(effects);
+      }
+    }
+    loop_stores_[header_id] = loop_stores;
+  }
+  return loop_stores_[header_id];
+}
+
+bool HeapAliasInfo::IsKilledByLoop(HInstruction* load, HLoopInformation* loop_info) {
+  if (GetHeapLocationOf(load) == HeapLocationCollector::kHeapLocationNotFound) {
+    return true;
+  }
+  const LoopStores* loop_stores = GetLoopStores(loop_info);
+  SideEffects load_effects = load->GetSideEffects();
+  if (load_effects.MayDependOn(loop_stores->other_effects)) {
+    return true;
+  }
+  for (HInstruction* store : loop_stores->stores) {
+    if (load_effects.MayDependOn(store->GetSideEffects()) && MayAlias(load, store)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace art
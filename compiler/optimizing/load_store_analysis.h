@@ -620,6 +620,64 @@ class LoadStoreAnalysis {
   DISALLOW_COPY_AND_ASSIGN(LoadStoreAnalysis);
 };
 
+// HeapAliasInfo exposes the heap locations and aliasing matrix of a LoadStoreAnalysis
+// to passes which otherwise only reason with SideEffects, such as GVN and LICM. It lets
+// them keep or hoist a load across stores that are known to write unrelated locations.
+class HeapAliasInfo : public ValueObject {
+ public:
+  HeapAliasInfo(HGraph* graph, ScopedArenaAllocator* allocator)
+      : graph_(graph),
+        allocator_(allocator),
+        lsa_(graph, allocator),
+        heap_location_of_(allocator->Adapter(kArenaAllocLSA)),
+        loop_stores_(allocator->Adapter(kArenaAllocLSA)) {}
+
+  // Runs the load/store analysis and records the heap location of each access.
+  // Returns false if no alias information is available, in which case the other
+  // methods must not be called.
+  bool Run();
+
+  // Returns whether `store` may change the value read by `load`. The caller is
+  // expected to have checked that the side effects of `load` depend on `store`.
+  bool MayAlias(HInstruction* load, HInstruction* store) const;
+
+  // Returns whether an iteration of the loop described by `loop_info` may change the
+  // value read by `load`. The caller is expected to have checked that the side effects
+  // of `load` depend on the side effects of the loop.
+  bool IsKilledByLoop(HInstruction* load, HLoopInformation* loop_info);
+
+ private:
+  // The stores to collected heap locations in a loop, and the side effects of all
+  // other instructions of the loop.
+  struct LoopStores : public ArenaObject<kArenaAllocLSA> {
+    explicit LoopStores(ScopedArenaAllocator* allocator)
+        : other_effects(SideEffects::None()),
+          stores(allocator->Adapter(kArenaAllocLSA)) {}
+
+    SideEffects other_effects;
+    ScopedArenaVector<HInstruction*> stores;
+  };
+
+  size_t GetHeapLocationOf(HInstruction* instruction) const {
+    size_t id = static_cast<size_t>(instruction->GetId());
+    return id < heap_location_of_.size()
+        ? heap_location_of_[id]
+        : HeapLocationCollector::kHeapLocationNotFound;
+  }
+
+  const LoopStores* GetLoopStores(HLoopInformation* loop_info);
+
+  HGraph* const graph_;
+  ScopedArenaAllocator* const allocator_;
+  LoadStoreAnalysis lsa_;
+  // Heap location index of each field/array access, indexed by instruction id.
+  ScopedArenaVector<size_t> heap_location_of_;
+  // Lazily computed stores of each loop, indexed by the block id of its header.
+  ScopedArenaVector<LoopStores*> loop_stores_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapAliasInfo);
+};
+
 }  // namespace art
 
 #endif  // ART_COMPILER_OPTIMIZING_LOAD_STORE_ANALYSIS_H_
@@ -97,7 +97,7 @@ Location Location::FpuRegisterOrConstant(HInstruction* instruction) {
 
 std::ostream& operator<<(std::ostream& os, const Location& location) {
   os << location.DebugString();
-  if (location.IsRegister() || location.IsFpuRegister()) {
+  if (location.IsRegister() || location.IsFpuRegister() || location.IsPredicateRegister()) {
     os << location.reg();
   } else if (location.IsPair()) {
     os << location.low() << ":" << location.high();
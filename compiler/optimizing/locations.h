@@ -76,6 +76,10 @@ class Location : public ValueObject {
     // a policy that specifies what kind of location is suitable. Payload
     // contains register allocation policy.
     kUnallocated = 11,
+
+    // SIMD predicate register (e.g. ARM64 SVE). Predicate registers are fixed by the
+    // code generator and are not seen by the register allocator, see PredicateRegisterLocation.
+    kPredicateRegister = 12,
   };
 
   Location() : ValueObject(), value_(kInvalid) {
@@ -89,6 +93,7 @@ class Location : public ValueObject {
     static_assert((kFpuRegister & kLocationConstantMask) != kConstant, "TagError");
     static_assert((kRegisterPair & kLocationConstantMask) != kConstant, "TagError");
     static_assert((kFpuRegisterPair & kLocationConstantMask) != kConstant, "TagError");
+    static_assert((kPredicateRegister & kLocationConstantMask) != kConstant, "TagError");
     static_assert((kConstant & kLocationConstantMask) == kConstant, "TagError");
 
     DCHECK(!IsValid());
@@ -142,6 +147,13 @@ class Location : public ValueObject {
     return Location(kFpuRegisterPair, low << 16 | high);
   }
 
+  // A SIMD predicate register holds the governing predicate of a vector loop. It is live
+  // from its definition in the loop header to its last use in the loop body, which contain
+  // no calls, so its value is never moved or spilled and no interval is allocated for it.
+  static Location PredicateRegisterLocation(int reg) {
+    return Location(kPredicateRegister, reg);
+  }
+
   bool IsRegister() const {
     return GetKind() == kRegister;
   }
@@ -158,12 +170,16 @@ class Location : public ValueObject {
     return GetKind() == kFpuRegisterPair;
   }
 
+  bool IsPredicateRegister() const {
+    return GetKind() == kPredicateRegister;
+  }
+
   bool IsRegisterKind() const {
     return IsRegister() || IsFpuRegister() || IsRegisterPair() || IsFpuRegisterPair();
   }
 
   int reg() const {
-    DCHECK(IsRegister() || IsFpuRegister());
+    DCHECK(IsRegister() || IsFpuRegister() || IsPredicateRegister());
     return GetPayload();
   }
 
@@ -349,6 +365,7 @@ class Location : public ValueObject {
       case kFpuRegister: return "F";
       case kRegisterPair: return "RP";
       case kFpuRegisterPair: return "FP";
+      case kPredicateRegister: return "P";
       case kDoNotUse5:  // fall-through
       case kDoNotUse9:
         LOG(FATAL) << "Should not use this location kind";
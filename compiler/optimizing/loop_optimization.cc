@@ -32,6 +32,19 @@ namespace art {
 // Enables vectorization (SIMDization) in the loop optimizer.
 static constexpr bool kEnableVectorization = true;
 
+// Enables loop versioning to remove bounds checks from vectorized loops.
+static constexpr bool kEnableLoopVersioning = true;
+
+// Maximum number of bounds checks removed by versioning a single loop.
+static constexpr size_t kMaxNumberOfVersionedBoundsChecks = 8;
+
+// Maximum number of a != b runtime tests disambiguating the references of a vector loop.
+static constexpr size_t kMaxNumberOfRuntimeDisambiguationTests = 4;
+
+// Largest SIMD register width (in bytes) of any supported target; bounds the number of
+// distinct static loop peeling factors.
+static constexpr uint32_t kMaxVectorSizeInBytes = 32u;
+
 //
 // Static helpers.
 //
@@ -339,8 +352,10 @@ static bool IsSubConst2(HGraph* graph,
 // Detect reductions of the following forms,
 //   x = x_phi + ..
 //   x = x_phi - ..
+//   x = min(x_phi, ..)
+//   x = max(x_phi, ..)
 static bool HasReductionFormat(HInstruction* reduction, HInstruction* phi) {
-  if (reduction->IsAdd()) {
+  if (reduction->IsAdd() || reduction->IsMin() || reduction->IsMax()) {
     return (reduction->InputAt(0) == phi && reduction->InputAt(1) != phi) ||
            (reduction->InputAt(0) != phi && reduction->InputAt(1) == phi);
   } else if (reduction->IsSub()) {
@@ -356,6 +371,10 @@ static HVecReduce::ReductionKind GetReductionKind(HVecOperation* reduction) {
       reduction->IsVecSADAccumulate() ||
       reduction->IsVecDotProd()) {
     return HVecReduce::kSum;
+  } else if (reduction->IsVecMin()) {
+    return HVecReduce::kMin;
+  } else if (reduction->IsVecMax()) {
+    return HVecReduce::kMax;
   }
   LOG(FATAL) << "Unsupported SIMD reduction " << reduction->GetId();
   UNREACHABLE();
@@ -465,6 +484,7 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
     : HOptimization(graph, name, stats),
       compiler_options_(&codegen.GetCompilerOptions()),
       simd_register_size_(codegen.GetSIMDRegisterWidth()),
+      predicated_vectorization_mode_(codegen.SupportsPredicatedSIMD()),
       induction_range_(induction_analysis),
       loop_allocator_(nullptr),
       global_allocator_(graph_->GetAllocator()),
@@ -477,10 +497,11 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_tests_(nullptr),
+      vector_bounds_checks_(nullptr),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
+      vector_accumulators_(nullptr),
       vector_mode_(kSequential),
       vector_preheader_(nullptr),
       vector_header_(nullptr),
@@ -546,20 +567,32 @@ bool HLoopOptimization::LocalRun() {
         std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
     ScopedArenaSafeMap<HInstruction*, HInstruction*> perm(
         std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+    ScopedArenaSafeMap<HInstruction*, HInstruction*> accs(
+        std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+    ScopedArenaVector<std::pair<HInstruction*, HInstruction*>> tests(
+        loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+    ScopedArenaVector<HBoundsCheck*> checks(
+        loop_allocator_->Adapter(kArenaAllocLoopOptimization));
     // Attach.
     iset_ = &iset;
     reductions_ = &reds;
     vector_refs_ = &refs;
+    vector_runtime_tests_ = &tests;
+    vector_bounds_checks_ = &checks;
     vector_map_ = &map;
     vector_permanent_map_ = &perm;
+    vector_accumulators_ = &accs;
     // Traverse.
     didLoopOpt = TraverseLoopsInnerToOuter(top_loop_);
     // Detach.
     iset_ = nullptr;
     reductions_ = nullptr;
     vector_refs_ = nullptr;
+    vector_runtime_tests_ = nullptr;
+    vector_bounds_checks_ = nullptr;
     vector_map_ = nullptr;
     vector_permanent_map_ = nullptr;
+    vector_accumulators_ = nullptr;
   }
   return didLoopOpt;
 }
@@ -772,6 +805,15 @@ bool HLoopOptimization::TryOptimizeInnerLoopFinite(LoopNode* node) {
       TrySetSimpleLoopHeader(header, &main_phi) &&
       ShouldVectorize(node, body, trip_count) &&
       TryAssignLastValue(node->loop_info, main_phi, preheader, /*collect_loop_uses*/ true)) {
+    if (!vector_bounds_checks_->empty()) {
+      // Vectorization needs the bounds checks out of the way. Version the loop, and
+      // vectorize the version without bounds checks. The last value assigned above is
+      // valid for both versions.
+      if (TryVersioningForVectorization(node)) {
+        TryOptimizeInnerLoopFinite(node);
+      }
+      return true;
+    }
     Vectorize(node, body, exit, trip_count);
     graph_->SetHasSIMD(true);  // flag SIMD usage
     MaybeRecordStat(stats_, MethodCompilationStat::kLoopVectorized);
@@ -914,6 +956,60 @@ bool HLoopOptimization::TryPeelingAndUnrolling(LoopNode* node) {
          TryUnrollingForBranchPenaltyReduction(&analysis_info);
 }
 
+bool HLoopOptimization::TryVersioningForVectorization(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  DCHECK(!vector_bounds_checks_->empty());
+  // Run 'IsLoopClonable' first, so that no code is generated if versioning is not possible.
+  if (!LoopClonerHelper::IsLoopClonable(loop_info)) {
+    return false;
+  }
+
+  // Generate the versioning test in the preheader, viz. for each removed bounds check
+  // with index i+c on array a, and the range [lo, hi] on i+c over the loop:
+  //    test = lo <u a.length && hi <u a.length && ... ;
+  // The unsigned comparisons also reject negative indices. The range is that of the full
+  // loop, so no check of any iteration can fail when the test holds.
+  HBasicBlock* preheader = loop_info->GetPreHeader();
+  HInstruction* test = nullptr;
+  for (HBoundsCheck* bounds_check : *vector_bounds_checks_) {
+    HInstruction* index = bounds_check->InputAt(0);
+    HInstruction* length = bounds_check->InputAt(1);
+    HInstruction* lower = nullptr;
+    HInstruction* upper = nullptr;
+    induction_range_.GenerateRange(bounds_check, index, graph_, preheader, &lower, &upper);
+    for (HInstruction* bound : { lower, upper }) {
+      if (bound == nullptr) {
+        continue;  // loop invariant index, only the upper bound is set
+      }
+      HInstruction* in_bounds = Insert(preheader, new (global_allocator_) HBelow(bound, length));
+      test = (test == nullptr)
+          ? in_bounds
+          : Insert(preheader, new (global_allocator_) HSelect(
+                in_bounds, test, graph_->GetIntConstant(0), kNoDexPc));
+    }
+  }
+  DCHECK(test != nullptr);
+
+  // Clone the loop. The preheader then branches to both the original loop and the copy,
+  // in this order; turn its goto into the versioning test.
+  LoopClonerSimpleHelper helper(loop_info, &induction_range_);
+  helper.DoVersioning();
+  HInstruction* go = preheader->GetLastInstruction();
+  DCHECK(go->IsGoto());
+  DCHECK(preheader->GetSuccessors()[0]->Dominates(loop_info->GetHeader()));
+  preheader->ReplaceAndRemoveInstructionWith(go, new (global_allocator_) HIf(test));
+
+  // Remove the bounds checks from the original loop, which becomes the fast version.
+  for (HBoundsCheck* bounds_check : *vector_bounds_checks_) {
+    bounds_check->ReplaceWith(bounds_check->InputAt(0));
+    bounds_check->GetBlock()->RemoveInstruction(bounds_check);
+  }
+  vector_bounds_checks_->clear();
+  induction_range_.ReVisit(loop_info);
+  MaybeRecordStat(stats_, MethodCompilationStat::kLoopVersionedForVectorization);
+  return true;
+}
+
 //
 // Loop vectorization. The implementation is based on the book by Aart J.C. Bik:
 // "The Software Vectorization Handbook. Applying Multimedia Extensions for Maximum Performance."
@@ -926,8 +1022,8 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  vector_runtime_tests_->clear();
+  vector_bounds_checks_->clear();
 
   // Phis in the loop-body prevent vectorization.
   if (!block->GetPhis().IsEmpty()) {
@@ -949,8 +1045,8 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
   // (3) variable to record how many references share same alignment.
   // (4) variable to record suitable candidate for dynamic loop peeling.
   uint32_t desired_alignment = GetVectorSizeInBytes();
-  DCHECK_LE(desired_alignment, 16u);
-  uint32_t peeling_votes[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  DCHECK_LE(desired_alignment, kMaxVectorSizeInBytes);
+  uint32_t peeling_votes[kMaxVectorSizeInBytes] = {};
   uint32_t max_num_same_alignment = 0;
   const ArrayReference* peeling_candidate = nullptr;
 
@@ -985,16 +1081,8 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
           // Found a[i+x] vs. b[i+y]. Accept if x == y (at worst loop-independent data dependence).
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
-          if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
-            }
+          if (x != y && !TryAddRuntimeDisambiguationTest(a, b)) {
+            return false;  // too many tests would be needed
           }
         }
       }
@@ -1011,7 +1099,7 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
       uint32_t vote = (offset == 0)
           ? 0
           : ((desired_alignment - offset) >> DataType::SizeShift(i->type));
-      DCHECK_LT(vote, 16u);
+      DCHECK_LT(vote, kMaxVectorSizeInBytes);
       ++peeling_votes[vote];
     } else if (BaseAlignment() >= desired_alignment &&
                num_same_alignment > max_num_same_alignment) {
@@ -1024,8 +1112,10 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
     }
   }  // for i
 
-  // Find a suitable alignment strategy.
-  SetAlignmentStrategy(peeling_votes, peeling_candidate);
+  // Find a suitable alignment strategy. Predicated vector loops do not peel for alignment.
+  if (!IsInPredicatedVectorizationMode()) {
+    SetAlignmentStrategy(peeling_votes, peeling_candidate);
+  }
 
   // Does vectorization seem profitable?
   if (!IsVectorizationProfitable(trip_count)) {
@@ -1043,17 +1133,20 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   HBasicBlock* header = node->loop_info->GetHeader();
   HBasicBlock* preheader = node->loop_info->GetPreHeader();
 
-  // Pick a loop unrolling factor for the vector loop.
-  uint32_t unroll = arch_loop_helper_->GetSIMDUnrollingFactor(
-      block, trip_count, MaxNumberPeeled(), vector_length_);
+  // Pick a loop unrolling factor for the vector loop. Predicated loops are not unrolled.
+  uint32_t unroll = IsInPredicatedVectorizationMode()
+      ? LoopAnalysisInfo::kNoUnrollingFactor
+      : arch_loop_helper_->GetSIMDUnrollingFactor(
+            block, trip_count, MaxNumberPeeled(), vector_length_);
   uint32_t chunk = vector_length_ * unroll;
 
   DCHECK(trip_count == 0 || (trip_count >= MaxNumberPeeled() + chunk));
 
   // A cleanup loop is needed, at least, for any unknown trip count or
   // for a known trip count with remainder iterations after vectorization.
-  bool needs_cleanup = trip_count == 0 ||
-      ((trip_count - vector_static_peeling_factor_) % chunk) != 0;
+  // A predicated vector loop executes the remainder iterations itself.
+  bool needs_cleanup = !IsInPredicatedVectorizationMode() &&
+      (trip_count == 0 || ((trip_count - vector_static_peeling_factor_) % chunk) != 0);
 
   // Adjust vector bookkeeping.
   HPhi* main_phi = nullptr;
@@ -1123,12 +1216,12 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests:
   // vtc = a != b ? vtc : 0;
-  if (vector_runtime_test_a_ != nullptr) {
+  for (const std::pair<HInstruction*, HInstruction*>& refs : *vector_runtime_tests_) {
     HInstruction* rt = Insert(
         preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
+        new (global_allocator_) HNotEqual(refs.first, refs.second));
     vtc = Insert(preheader,
                  new (global_allocator_)
                  HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
@@ -1156,6 +1249,9 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   // Generate vector loop, possibly further unrolled:
   // for ( ; i < vtc; i += chunk)
   //    <vectorized-loop-body>
+  // or, in predicated mode, with the elements past vtc disabled in the last iteration:
+  // for ( ; pred = while_lo(i, vtc), first(pred); i += chunk)
+  //    <predicated-vectorized-loop-body>
   vector_mode_ = kVector;
   GenerateNewLoop(node,
                   block,
@@ -1227,8 +1323,29 @@ void HLoopOptimization::GenerateNewLoop(LoopNode* node,
   // Generate header and prepare body.
   // for (i = lo; i < hi; i += step)
   //    <loop-body>
-  HInstruction* cond = new (global_allocator_) HAboveOrEqual(phi, hi);
+  HInstruction* cond = nullptr;
+  HVecPredWhile* loop_predicate = nullptr;
   vector_header_->AddPhi(phi);
+  if (vector_mode_ == kVector && IsInPredicatedVectorizationMode()) {
+    // Exit once the first element is disabled, i.e. when i >= hi.
+    DCHECK_EQ(unroll, 1u);
+    loop_predicate = new (global_allocator_) HVecPredWhile(global_allocator_,
+                                                           phi,
+                                                           hi,
+                                                           HVecPredWhile::CondKind::kLO,
+                                                           DataType::Type::kInt32,
+                                                           vector_length_,
+                                                           kNoDexPc);
+    cond = new (global_allocator_) HVecPredCondition(global_allocator_,
+                                                     loop_predicate,
+                                                     HVecPredCondition::PCondKind::kNFirst,
+                                                     DataType::Type::kInt32,
+                                                     vector_length_,
+                                                     kNoDexPc);
+    vector_header_->AddInstruction(loop_predicate);
+  } else {
+    cond = new (global_allocator_) HAboveOrEqual(phi, hi);
+  }
   vector_header_->AddInstruction(cond);
   vector_header_->AddInstruction(new (global_allocator_) HIf(cond));
   vector_index_ = phi;
@@ -1256,6 +1373,9 @@ void HLoopOptimization::GenerateNewLoop(LoopNode* node,
     vector_index_ = new (global_allocator_) HAdd(induc_type, vector_index_, step);
     Insert(vector_body_, vector_index_);
   }
+  if (loop_predicate != nullptr) {
+    SetPredicatesInVectorLoop(loop_predicate);
+  }
   // Finalize phi inputs for the reductions (if any).
   for (auto i = reductions_->begin(); i != reductions_->end(); ++i) {
     if (!i->first->IsPhi()) {
@@ -1278,6 +1398,13 @@ bool HLoopOptimization::VectorizeDef(LoopNode* node,
   // (3) unit stride index,
   // (4) vectorizable right-hand-side value.
   uint64_t restrictions = kNone;
+  // Accept a bounds check that can be removed by versioning the loop.
+  if (!generate_code &&
+      instruction->IsBoundsCheck() &&
+      CanVersionBoundsCheck(node, instruction->AsBoundsCheck())) {
+    vector_bounds_checks_->push_back(instruction->AsBoundsCheck());
+    return true;
+  }
   // Don't accept expressions that can throw.
   if (instruction->CanThrow()) {
     return false;
@@ -1337,6 +1464,42 @@ bool HLoopOptimization::VectorizeDef(LoopNode* node,
          && !instruction->DoesAnyWrite();
 }
 
+bool HLoopOptimization::CanVersionBoundsCheck(LoopNode* node, HBoundsCheck* bounds_check) {
+  // Versioning for bounds checks is only used when there is no cheaper way to remove them:
+  // bounds check elimination already removed them wherever it could deoptimize instead.
+  // Avoid versioning in OSR methods, where each loop copy would need its own entry.
+  if (!kEnableLoopVersioning ||
+      graph_->IsCompilingOsr() ||
+      vector_bounds_checks_->size() >= kMaxNumberOfVersionedBoundsChecks) {
+    return false;
+  }
+  // The index must vary in the loop (invariant checks are better left to other passes),
+  // the length must be known before the loop, and the full range of the index over the
+  // loop must be computable there.
+  bool needs_finite_test = false;
+  bool needs_taken_test = false;
+  return !node->loop_info->IsDefinedOutOfTheLoop(bounds_check->InputAt(0)) &&
+      node->loop_info->IsDefinedOutOfTheLoop(bounds_check->InputAt(1)) &&
+      !IsUsedOutsideLoop(node->loop_info, bounds_check) &&
+      induction_range_.CanGenerateRange(
+          bounds_check, bounds_check->InputAt(0), &needs_finite_test, &needs_taken_test) &&
+      !needs_finite_test;
+}
+
+bool HLoopOptimization::TryAddRuntimeDisambiguationTest(HInstruction* a, HInstruction* b) {
+  for (const std::pair<HInstruction*, HInstruction*>& refs : *vector_runtime_tests_) {
+    if ((refs.first == a && refs.second == b) || (refs.first == b && refs.second == a)) {
+      return true;  // test already present
+    }
+  }
+  // To avoid excessive overhead, only accept a few a != b tests.
+  if (vector_runtime_tests_->size() >= kMaxNumberOfRuntimeDisambiguationTests) {
+    return false;
+  }
+  vector_runtime_tests_->push_back(std::make_pair(a, b));
+  return true;
+}
+
 bool HLoopOptimization::VectorizeUse(LoopNode* node,
                                      HInstruction* instruction,
                                      bool generate_code,
@@ -1534,6 +1697,35 @@ bool HLoopOptimization::VectorizeUse(LoopNode* node,
       }
       return true;
     }
+  } else if (instruction->IsMin() || instruction->IsMax()) {
+    // Deal with vector restrictions.
+    HInstruction* opa = instruction->InputAt(0);
+    HInstruction* opb = instruction->InputAt(1);
+    HInstruction* r = opa;
+    HInstruction* s = opb;
+    bool is_unsigned = false;
+    if (HasVectorRestrictions(restrictions, kNoMinMax)) {
+      return false;
+    } else if (HasVectorRestrictions(restrictions, kNoHiBits) &&
+               !IsNarrowerOperands(opa, opb, type, &r, &s, &is_unsigned)) {
+      return false;  // reject, unless all operands are same-extension narrower
+    }
+    // Accept MIN/MAX(x, y) for vectorizable operands.
+    DCHECK(r != nullptr && s != nullptr);
+    if (generate_code && vector_mode_ != kVector) {  // de-idiom
+      r = opa;
+      s = opb;
+    }
+    if (VectorizeUse(node, r, generate_code, type, restrictions) &&
+        VectorizeUse(node, s, generate_code, type, restrictions)) {
+      if (generate_code) {
+        GenerateVecOp(instruction,
+                      vector_map_->Get(r),
+                      vector_map_->Get(s),
+                      HVecOperation::ToProperType(type, is_unsigned));
+      }
+      return true;
+    }
   }
   return false;
 }
@@ -1542,9 +1734,12 @@ uint32_t HLoopOptimization::GetVectorSizeInBytes() {
   if (kIsDebugBuild) {
     InstructionSet isa = compiler_options_->GetInstructionSet();
     // TODO: Remove this check when there are no implicit assumptions on the SIMD reg size.
-    DCHECK_EQ(simd_register_size_, (isa == InstructionSet::kArm || isa == InstructionSet::kThumb2)
-                                   ? 8u
-                                   : 16u);
+    uint32_t expected_size =
+        (isa == InstructionSet::kArm || isa == InstructionSet::kThumb2) ? 8u : 16u;
+    // x86-64 uses 256-bit vectors when AVX2 is available.
+    DCHECK(simd_register_size_ == expected_size ||
+           (isa == InstructionSet::kX86_64 && simd_register_size_ == 32u))
+        << simd_register_size_;
   }
 
   return simd_register_size_;
@@ -1575,6 +1770,9 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       }
       return false;
     case InstructionSet::kArm64:
+      if (IsInPredicatedVectorizationMode()) {
+        return TrySetVectorTypeArm64Sve(type, restrictions);
+      }
       // Allow vectorization for all ARM devices, because Android assumes that
       // ARMv8 AArch64 always supports advanced SIMD (128-bit SIMD).
       switch (type) {
@@ -1591,7 +1789,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
           *restrictions |= kNoDiv;
           return TrySetVectorLength(type, 4);
         case DataType::Type::kInt64:
-          *restrictions |= kNoDiv | kNoMul;
+          *restrictions |= kNoDiv | kNoMul | kNoMinMax;
           return TrySetVectorLength(type, 2);
         case DataType::Type::kFloat32:
           *restrictions |= kNoReduction;
@@ -1604,8 +1802,14 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       }
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
-      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD).
+      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD), using
+      // 256-bit SIMD when the code generator selects AVX2 vectors on X86_64.
       if (features->AsX86InstructionSetFeatures()->HasSSE4_1()) {
+        uint32_t vector_size = GetVectorSizeInBytes();
+        if (vector_size > 16u) {
+          // The compressed string load only handles 128-bit vectors.
+          *restrictions |= kNoStringCharAt;
+        }
         switch (type) {
           case DataType::Type::kBool:
           case DataType::Type::kUint8:
@@ -1618,7 +1822,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 16);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kUint16:
             *restrictions |= kNoDiv |
                              kNoAbs |
@@ -1626,26 +1830,26 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kInt16:
             *restrictions |= kNoDiv |
                              kNoAbs |
                              kNoSignedHAdd |
                              kNoUnroundedHAdd |
                              kNoSAD;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kInt32:
             *restrictions |= kNoDiv | kNoSAD;
-            return TrySetVectorLength(type, 4);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kInt64:
-            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD;
-            return TrySetVectorLength(type, 2);
+            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD | kNoMinMax;
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kFloat32:
-            *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 4);
+            *restrictions |= kNoReduction | kNoMinMax;  // minps/maxps differ on NaN and -0.0
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kFloat64:
-            *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 2);
+            *restrictions |= kNoReduction | kNoMinMax;  // minpd/maxpd differ on NaN and -0.0
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           default:
             break;
         }  // switch type
@@ -1656,6 +1860,30 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
   }  // switch instruction set
 }
 
+bool HLoopOptimization::TrySetVectorTypeArm64Sve(DataType::Type type, uint64_t* restrictions) {
+  // Predicated vector loops handle neither reductions (the inactive elements of the last
+  // iteration would need to be masked out of the accumulator) nor idioms without a direct
+  // SVE instruction; such loops stay scalar.
+  *restrictions |= kNoReduction | kNoSAD | kNoDotProd | kNoHAdd | kNoStringCharAt;
+  uint32_t vector_size = GetVectorSizeInBytes();
+  switch (type) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      *restrictions |= kNoDiv;
+      return TrySetVectorLength(type, vector_size / DataType::Size(type));
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      return TrySetVectorLength(type, vector_size / DataType::Size(type));
+    default:
+      return false;
+  }
+}
+
 bool HLoopOptimization::TrySetVectorLengthImpl(uint32_t length) {
   DCHECK(IsPowerOfTwo(length) && length >= 2u);
   // First time set?
@@ -1693,11 +1921,31 @@ void HLoopOptimization::GenerateVecInv(HInstruction* org, DataType::Type type) {
       vector = new (global_allocator_)
           HVecReplicateScalar(global_allocator_, input, type, vector_length_, kNoDexPc);
       vector_permanent_map_->Put(org, Insert(vector_preheader_, vector));
+      if (IsInPredicatedVectorizationMode()) {
+        // Invariants are computed outside the loop, for all the elements.
+        HVecPredSetAll* all_true = new (global_allocator_) HVecPredSetAll(
+            global_allocator_, graph_->GetIntConstant(1), type, vector_length_, kNoDexPc);
+        vector_preheader_->InsertInstructionBefore(all_true, vector);
+        vector->AsVecOperation()->SetMergingGoverningPredicate(all_true);
+      }
     }
     vector_map_->Put(org, vector);
   }
 }
 
+void HLoopOptimization::SetPredicatesInVectorLoop(HVecPredSetOperation* loop_predicate) {
+  DCHECK(IsInPredicatedVectorizationMode());
+  for (HInstructionIterator it(vector_body_->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction->IsVecOperation()) {
+      HVecOperation* operation = instruction->AsVecOperation();
+      if (operation->MustBePredicatedInPredicatedSIMDMode() && !operation->IsPredicated()) {
+        operation->SetMergingGoverningPredicate(loop_predicate);
+      }
+    }
+  }
+}
+
 void HLoopOptimization::GenerateVecSub(HInstruction* org, HInstruction* offset) {
   if (vector_map_->find(org) == vector_map_->end()) {
     HInstruction* subscript = vector_index_;
@@ -1775,16 +2023,23 @@ void HLoopOptimization::GenerateVecReductionPhi(HPhi* phi) {
     vector_header_->AddPhi(new_phi);
     vector = new_phi;
   } else {
-    // Link vector reduction back to prior unrolled update, or a first phi.
+    // Give each unrolled copy its own accumulator, so that the unrolled reductions
+    // do not depend on each other.
+    HPhi* new_phi = new (global_allocator_) HPhi(
+        global_allocator_, kNoRegNumber, 0, HVecOperation::kSIMDType);
+    vector_header_->AddPhi(new_phi);
     auto it = vector_permanent_map_->find(phi);
     if (it != vector_permanent_map_->end()) {
-      vector = it->second;
-    } else {
-      HPhi* new_phi = new (global_allocator_) HPhi(
-          global_allocator_, kNoRegNumber, 0, HVecOperation::kSIMDType);
-      vector_header_->AddPhi(new_phi);
-      vector = new_phi;
+      // Complete the accumulator of the prior unrolled update.
+      HInstruction* prev_red = it->second;
+      HPhi* prev_phi = vector_permanent_map_->Get(prev_red)->AsPhi();
+      bool is_first = vector_accumulators_->find(prev_phi) == vector_accumulators_->end();
+      prev_phi->AddInput(GenerateVecReductionInit(
+          reductions_->Get(phi), prev_red->AsVecOperation(), is_first));
+      prev_phi->AddInput(prev_red);
+      vector_accumulators_->Put(new_phi, prev_phi);
     }
+    vector = new_phi;
   }
   vector_map_->Put(phi, vector);
 }
@@ -1799,28 +2054,8 @@ void HLoopOptimization::GenerateVecReductionPhiInputs(HPhi* phi, HInstruction* r
   }
   // Prepare the new initialization.
   if (vector_mode_ == kVector) {
-    // Generate a [initial, 0, .., 0] vector for add or
-    // a [initial, initial, .., initial] vector for min/max.
-    HVecOperation* red_vector = new_red->AsVecOperation();
-    HVecReduce::ReductionKind kind = GetReductionKind(red_vector);
-    uint32_t vector_length = red_vector->GetVectorLength();
-    DataType::Type type = red_vector->GetPackedType();
-    if (kind == HVecReduce::ReductionKind::kSum) {
-      new_init = Insert(vector_preheader_,
-                        new (global_allocator_) HVecSetScalars(global_allocator_,
-                                                               &new_init,
-                                                               type,
-                                                               vector_length,
-                                                               1,
-                                                               kNoDexPc));
-    } else {
-      new_init = Insert(vector_preheader_,
-                        new (global_allocator_) HVecReplicateScalar(global_allocator_,
-                                                                    new_init,
-                                                                    type,
-                                                                    vector_length,
-                                                                    kNoDexPc));
-    }
+    bool is_first = vector_accumulators_->find(new_phi) == vector_accumulators_->end();
+    new_init = GenerateVecReductionInit(new_init, new_red->AsVecOperation(), is_first);
   } else {
     new_init = ReduceAndExtractIfNeeded(new_init);
   }
@@ -1832,6 +2067,36 @@ void HLoopOptimization::GenerateVecReductionPhiInputs(HPhi* phi, HInstruction* r
   reductions_->find(phi)->second = new_phi;
 }
 
+HInstruction* HLoopOptimization::GenerateVecReductionInit(HInstruction* init,
+                                                          HVecOperation* reduction,
+                                                          bool is_first_accumulator) {
+  // Generate a [initial, 0, .., 0] vector for add or
+  // a [initial, initial, .., initial] vector for min/max.
+  // Other accumulators of an add start from [0, .., 0].
+  HVecReduce::ReductionKind kind = GetReductionKind(reduction);
+  uint32_t vector_length = reduction->GetVectorLength();
+  DataType::Type type = reduction->GetPackedType();
+  if (kind == HVecReduce::ReductionKind::kSum) {
+    if (!is_first_accumulator) {
+      init = graph_->GetConstant(init->GetType(), 0);
+    }
+    return Insert(vector_preheader_,
+                  new (global_allocator_) HVecSetScalars(global_allocator_,
+                                                         &init,
+                                                         type,
+                                                         vector_length,
+                                                         1,
+                                                         kNoDexPc));
+  } else {
+    return Insert(vector_preheader_,
+                  new (global_allocator_) HVecReplicateScalar(global_allocator_,
+                                                              init,
+                                                              type,
+                                                              vector_length,
+                                                              kNoDexPc));
+  }
+}
+
 HInstruction* HLoopOptimization::ReduceAndExtractIfNeeded(HInstruction* instruction) {
   if (instruction->IsPhi()) {
     HInstruction* input = instruction->InputAt(1);
@@ -1842,13 +2107,37 @@ HInstruction* HLoopOptimization::ReduceAndExtractIfNeeded(HInstruction* instruct
       DataType::Type type = input_vector->GetPackedType();
       HVecReduce::ReductionKind kind = GetReductionKind(input_vector);
       HBasicBlock* exit = instruction->GetBlock()->GetSuccessors()[0];
+      HInstruction* insert_pos = exit->GetFirstInstruction();
+      // Combine the accumulators of an unrolled reduction
+      //    x = OP( [a_1, .., a_n], [b_1, .., b_n] )
+      // along the exit of the defining loop.
+      HInstruction* vector = instruction;
+      for (auto it = vector_accumulators_->find(instruction);
+           it != vector_accumulators_->end();
+           it = vector_accumulators_->find(it->second)) {
+        HInstruction* other = it->second;
+        HInstruction* combine = nullptr;
+        if (kind == HVecReduce::kSum) {
+          combine = new (global_allocator_) HVecAdd(
+              global_allocator_, vector, other, type, vector_length, kNoDexPc);
+        } else if (kind == HVecReduce::kMin) {
+          combine = new (global_allocator_) HVecMin(
+              global_allocator_, vector, other, type, vector_length, kNoDexPc);
+        } else {
+          DCHECK_EQ(kind, HVecReduce::kMax);
+          combine = new (global_allocator_) HVecMax(
+              global_allocator_, vector, other, type, vector_length, kNoDexPc);
+        }
+        exit->InsertInstructionBefore(combine, insert_pos);
+        vector = combine;
+      }
       // Generate a vector reduction and scalar extract
       //    x = REDUCE( [x_1, .., x_n] )
       //    y = x_1
       // along the exit of the defining loop.
       HInstruction* reduce = new (global_allocator_) HVecReduce(
-          global_allocator_, instruction, type, vector_length, kind, kNoDexPc);
-      exit->InsertInstructionBefore(reduce, exit->GetFirstInstruction());
+          global_allocator_, vector, type, vector_length, kind, kNoDexPc);
+      exit->InsertInstructionBefore(reduce, insert_pos);
       instruction = new (global_allocator_) HVecExtractScalar(
           global_allocator_, reduce, type, vector_length, 0, kNoDexPc);
       exit->InsertInstructionAfter(instruction, reduce);
@@ -1939,6 +2228,14 @@ void HLoopOptimization::GenerateVecOp(HInstruction* org,
       GENERATE_VEC(
         new (global_allocator_) HVecAbs(global_allocator_, opa, type, vector_length_, dex_pc),
         new (global_allocator_) HAbs(org_type, opa, dex_pc));
+    case HInstruction::kMin:
+      GENERATE_VEC(
+        new (global_allocator_) HVecMin(global_allocator_, opa, opb, type, vector_length_, dex_pc),
+        new (global_allocator_) HMin(org_type, opa, opb, dex_pc));
+    case HInstruction::kMax:
+      GENERATE_VEC(
+        new (global_allocator_) HVecMax(global_allocator_, opa, opb, type, vector_length_, dex_pc),
+        new (global_allocator_) HMax(org_type, opa, opb, dex_pc));
     default:
       break;
   }  // switch
@@ -1991,7 +2288,8 @@ bool HLoopOptimization::VectorizeHalvingAddIdiom(LoopNode* node,
         return false;
       }
       // Deal with vector restrictions.
-      if ((!is_unsigned && HasVectorRestrictions(restrictions, kNoSignedHAdd)) ||
+      if (HasVectorRestrictions(restrictions, kNoHAdd) ||
+          (!is_unsigned && HasVectorRestrictions(restrictions, kNoSignedHAdd)) ||
           (!is_rounded && HasVectorRestrictions(restrictions, kNoUnroundedHAdd))) {
         return false;
       }
@@ -2195,7 +2493,7 @@ void HLoopOptimization::SetAlignmentStrategy(uint32_t peeling_votes[],
   // Current heuristic: pick the best static loop peeling factor, if any,
   // or otherwise use dynamic loop peeling on suggested peeling candidate.
   uint32_t max_vote = 0;
-  for (int32_t i = 0; i < 16; i++) {
+  for (uint32_t i = 0; i < kMaxVectorSizeInBytes; i++) {
     if (peeling_votes[i] > max_vote) {
       max_vote = peeling_votes[i];
       vector_static_peeling_factor_ = i;
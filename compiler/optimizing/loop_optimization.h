@@ -83,6 +83,8 @@ class HLoopOptimization : public HOptimization {
     kNoSAD           = 1 << 10,  // no sum of absolute differences (SAD)
     kNoWideSAD       = 1 << 11,  // no sum of absolute differences (SAD) with operand widening
     kNoDotProd       = 1 << 12,  // no dot product
+    kNoMinMax        = 1 << 13,  // no min/max
+    kNoHAdd          = 1 << 14,  // no halving add at all
   };
 
   /*
@@ -165,6 +167,12 @@ class HLoopOptimization : public HOptimization {
   // Tries to apply scalar loop peeling and unrolling.
   bool TryPeelingAndUnrolling(LoopNode* node);
 
+  // Tries to version the loop so that the bounds checks collected in vector_bounds_checks_
+  // are tested once before the loop: the original loop, with these checks removed, runs
+  // when all indices are within bounds, and a copy of the loop with the checks runs
+  // otherwise. Returns whether transformation happened.
+  bool TryVersioningForVectorization(LoopNode* node);
+
   //
   // Vectorization analysis and synthesis.
   //
@@ -179,6 +187,8 @@ class HLoopOptimization : public HOptimization {
                        HInstruction* step,
                        uint32_t unroll);
   bool VectorizeDef(LoopNode* node, HInstruction* instruction, bool generate_code);
+  bool CanVersionBoundsCheck(LoopNode* node, HBoundsCheck* bounds_check);
+  bool TryAddRuntimeDisambiguationTest(HInstruction* a, HInstruction* b);
   bool VectorizeUse(LoopNode* node,
                     HInstruction* instruction,
                     bool generate_code,
@@ -186,6 +196,7 @@ class HLoopOptimization : public HOptimization {
                     uint64_t restrictions);
   uint32_t GetVectorSizeInBytes();
   bool TrySetVectorType(DataType::Type type, /*out*/ uint64_t* restrictions);
+  bool TrySetVectorTypeArm64Sve(DataType::Type type, /*out*/ uint64_t* restrictions);
   bool TrySetVectorLengthImpl(uint32_t length);
 
   bool TrySetVectorLength(DataType::Type type, uint32_t length) {
@@ -195,6 +206,11 @@ class HLoopOptimization : public HOptimization {
     return res;
   }
 
+  // Whether vector loops are generated as fully predicated loops (e.g. Arm64 SVE), which
+  // handle the remainder iterations themselves instead of using peeling and cleanup loops.
+  bool IsInPredicatedVectorizationMode() const { return predicated_vectorization_mode_; }
+  void SetPredicatesInVectorLoop(HVecPredSetOperation* loop_predicate);
+
   void GenerateVecInv(HInstruction* org, DataType::Type type);
   void GenerateVecSub(HInstruction* org, HInstruction* offset);
   void GenerateVecMem(HInstruction* org,
@@ -204,6 +220,9 @@ class HLoopOptimization : public HOptimization {
                       DataType::Type type);
   void GenerateVecReductionPhi(HPhi* phi);
   void GenerateVecReductionPhiInputs(HPhi* phi, HInstruction* reduction);
+  HInstruction* GenerateVecReductionInit(HInstruction* init,
+                                         HVecOperation* reduction,
+                                         bool is_first_accumulator);
   HInstruction* ReduceAndExtractIfNeeded(HInstruction* instruction);
   void GenerateVecOp(HInstruction* org,
                      HInstruction* opa,
@@ -276,6 +295,9 @@ class HLoopOptimization : public HOptimization {
   // Cached target SIMD vector register size in bytes.
   const size_t simd_register_size_;
 
+  // Whether the target supports predicated SIMD instructions.
+  const bool predicated_vectorization_mode_;
+
   // Range information based on prior induction variable analysis.
   InductionVarRange induction_range_;
 
@@ -316,9 +338,13 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaVector<std::pair<HInstruction*, HInstruction*>>* vector_runtime_tests_;
+
+  // Bounds checks in the loop-body that are removed by loop versioning.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaVector<HBoundsCheck*>* vector_bounds_checks_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
@@ -330,6 +356,12 @@ class HLoopOptimization : public HOptimization {
   // Contents reside in phase-local heap memory.
   ScopedArenaSafeMap<HInstruction*, HInstruction*>* vector_permanent_map_;
 
+  // Links every accumulator phi of an unrolled vector reduction to the accumulator phi of
+  // the previous unrolled copy. Independent accumulators avoid serializing the unrolled
+  // reductions; they are combined along the loop exit.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaSafeMap<HInstruction*, HInstruction*>* vector_accumulators_;
+
   // Temporary vectorization bookkeeping.
   VectorMode vector_mode_;  // synthesis mode
   HBasicBlock* vector_preheader_;  // preheader of the new loop
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_barrier_elimination.h"
+
+namespace art {
+
+// The orderings between earlier and later memory accesses that a barrier provides.
+static constexpr uint32_t kOrderLoadLoad = 1u << 0;
+static constexpr uint32_t kOrderLoadStore = 1u << 1;
+static constexpr uint32_t kOrderStoreLoad = 1u << 2;
+static constexpr uint32_t kOrderStoreStore = 1u << 3;
+
+static uint32_t GetOrderings(MemBarrierKind kind) {
+  switch (kind) {
+    case MemBarrierKind::kAnyStore:
+      return kOrderLoadStore | kOrderStoreStore;
+    case MemBarrierKind::kLoadAny:
+      return kOrderLoadLoad | kOrderLoadStore;
+    case MemBarrierKind::kStoreStore:
+      return kOrderStoreStore;
+    case MemBarrierKind::kAnyAny:
+      return kOrderLoadLoad | kOrderLoadStore | kOrderStoreLoad | kOrderStoreStore;
+    default:
+      LOG(FATAL) << "Unexpected memory barrier " << kind;
+      UNREACHABLE();
+  }
+}
+
+// The weakest barrier kind that provides all of `orderings`.
+static MemBarrierKind GetWeakestKind(uint32_t orderings) {
+  for (MemBarrierKind kind : { MemBarrierKind::kStoreStore,
+                               MemBarrierKind::kAnyStore,
+                               MemBarrierKind::kLoadAny }) {
+    if ((orderings & ~GetOrderings(kind)) == 0u) {
+      return kind;
+    }
+  }
+  return MemBarrierKind::kAnyAny;
+}
+
+static MemBarrierKind GetBarrierKind(HInstruction* barrier) {
+  if (barrier->IsConstructorFence()) {
+    // The code generators emit a StoreStore barrier for constructor fences.
+    return MemBarrierKind::kStoreStore;
+  }
+  return barrier->AsMemoryBarrier()->GetBarrierKind();
+}
+
+// Whether a barrier can be moved across `instruction`.
+static bool IsTransparentToBarriers(HInstruction* instruction) {
+  return !instruction->CanThrow() &&
+         !instruction->IsControlFlow() &&
+         !instruction->IsSuspendCheck() &&
+         !instruction->GetSideEffects().DoesAnyRead() &&
+         !instruction->GetSideEffects().DoesAnyWrite();
+}
+
+bool MemoryBarrierElimination::Run() {
+  bool changed = false;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    // The last barrier seen with only instructions that do not access memory after it.
+    HInstruction* last_barrier = nullptr;
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsMemoryBarrier() || instruction->IsConstructorFence()) {
+        HInstruction* merged =
+            (last_barrier != nullptr) ? TryMerge(last_barrier, instruction) : nullptr;
+        if (merged != nullptr) {
+          changed = true;
+          last_barrier = merged;
+        } else {
+          last_barrier = instruction;
+        }
+      } else if (!IsTransparentToBarriers(instruction)) {
+        last_barrier = nullptr;
+      }
+    }
+  }
+  return changed;
+}
+
+HInstruction* MemoryBarrierElimination::TryMerge(HInstruction* first, HInstruction* second) {
+  DCHECK_EQ(first->GetBlock(), second->GetBlock());
+  if (first->IsConstructorFence() && second->IsConstructorFence()) {
+    // Left to constructor fence redundancy elimination, which keeps the fence targets.
+    return nullptr;
+  }
+  MemBarrierKind first_kind = GetBarrierKind(first);
+  MemBarrierKind second_kind = GetBarrierKind(second);
+  if (first_kind == MemBarrierKind::kNTStoreStore || second_kind == MemBarrierKind::kNTStoreStore) {
+    return nullptr;
+  }
+  MemBarrierKind kind = GetWeakestKind(GetOrderings(first_kind) | GetOrderings(second_kind));
+  if (kind != first_kind &&
+      kind != second_kind &&
+      instruction_set_ != InstructionSet::kArm &&
+      instruction_set_ != InstructionSet::kThumb2 &&
+      instruction_set_ != InstructionSet::kArm64) {
+    // Only ARM and ARM64 use a single DMB for every barrier kind, elsewhere the stronger
+    // barrier may cost more than the two it would replace.
+    return nullptr;
+  }
+
+  // Nothing between the two barriers accesses memory, so either position works. Keep the
+  // memory barrier, a constructor fence cannot express the other kinds.
+  HMemoryBarrier* kept = first->IsMemoryBarrier() ? first->AsMemoryBarrier()
+                                                  : second->AsMemoryBarrier();
+  HInstruction* removed = (kept == first) ? second : first;
+  kept->SetBarrierKind(kind);
+  removed->GetBlock()->RemoveInstruction(removed);
+  MaybeRecordStat(stats_, MethodCompilationStat::kMergedMemoryBarriers);
+  return kept;
+}
+
+}  // namespace art
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_MEMORY_BARRIER_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_MEMORY_BARRIER_ELIMINATION_H_
+
+#include "arch/instruction_set.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Optimization pass to coalesce memory barriers that follow each other.
+ *
+ * Two barriers in the same block with nothing in between that can access memory, throw or
+ * suspend order the same accesses, so they are replaced by a single barrier of the combined
+ * kind. A constructor fence is treated as a StoreStore barrier and is removed when an
+ * adjacent memory barrier already provides that ordering.
+ *
+ * On ARM and ARM64 every barrier kind is a DMB, so two barriers of different kinds are also
+ * combined into one stronger barrier. Elsewhere a barrier is only ever removed, never made
+ * stronger, since the stronger kind can be more expensive than the two original ones (for
+ * example on x86 only AnyAny needs a fence instruction).
+ *
+ * This pass runs after constructor fence redundancy elimination, which already merges
+ * constructor fences with each other.
+ */
+class MemoryBarrierElimination : public HOptimization {
+ public:
+  MemoryBarrierElimination(HGraph* graph,
+                           InstructionSet instruction_set,
+                           OptimizingCompilerStats* stats,
+                           const char* name = kMemoryBarrierEliminationPassName)
+      : HOptimization(graph, name, stats),
+        instruction_set_(instruction_set) {}
+
+  bool Run() override;
+
+  static constexpr const char* kMemoryBarrierEliminationPassName = "memory_barrier_elimination";
+
+ private:
+  // Merge `second` into `first`, which precedes it in the same block. Returns the barrier
+  // that remains, or null if the two barriers cannot be merged.
+  HInstruction* TryMerge(HInstruction* first, HInstruction* second);
+
+  const InstructionSet instruction_set_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryBarrierElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_MEMORY_BARRIER_ELIMINATION_H_
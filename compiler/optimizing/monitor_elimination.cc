@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_elimination.h"
+
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "escape.h"
+#include "nodes.h"
+
+namespace art {
+
+// The object locked by `monitor`, looking through a null check.
+static HInstruction* GetLockedObject(HInstruction* monitor) {
+  DCHECK(monitor->IsMonitorOperation());
+  HInstruction* object = monitor->InputAt(0);
+  return object->IsNullCheck() ? object->InputAt(0) : object;
+}
+
+static bool HasMonitorUses(HInstruction* reference) {
+  for (const HUseListNode<HInstruction*>& use : reference->GetUses()) {
+    if (use.GetUser()->IsMonitorOperation()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MonitorElimination::Run() {
+  if (!graph_->HasMonitorOperations()) {
+    return false;
+  }
+
+  // Local allocator to discard data structures created below at the end of this optimization.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+
+  bool changed = false;
+
+  // Eliding the locks of a thread-local object is not safe if we can switch to the
+  // interpreter in the middle of a synchronized region: the interpreter would then try to
+  // release a monitor that was never acquired. We also keep the locks in debuggable code
+  // where the debugger can inspect them.
+  if (!graph_->IsDebuggable() && !graph_->IsCompilingOsr() && !graph_->HasShouldDeoptimizeFlag()) {
+    ScopedArenaVector<HInstruction*> candidates(allocator.Adapter(kArenaAllocMisc));
+    for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        HInstruction* instruction = it.Current();
+        if ((instruction->IsNewInstance() || instruction->IsNewArray()) &&
+            HasMonitorUses(instruction)) {
+          candidates.push_back(instruction);
+        }
+      }
+    }
+    for (HInstruction* reference : candidates) {
+      if (TryRemoveThreadLocalMonitors(reference)) {
+        changed = true;
+      }
+    }
+  }
+
+  ScopedArenaVector<HMonitorOperation*> monitor_exits(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsMonitorOperation() && !instruction->AsMonitorOperation()->IsEnter()) {
+        monitor_exits.push_back(instruction->AsMonitorOperation());
+      }
+    }
+  }
+  for (HMonitorOperation* monitor_exit : monitor_exits) {
+    if (TryMergeWithNextRegion(monitor_exit)) {
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+bool MonitorElimination::TryRemoveThreadLocalMonitors(HInstruction* reference) {
+  bool is_singleton;
+  bool is_singleton_and_not_returned;
+  bool is_singleton_and_not_deopt_visible;
+  CalculateEscape(reference,
+                  /* no_escape_fn= */ nullptr,
+                  &is_singleton,
+                  &is_singleton_and_not_returned,
+                  &is_singleton_and_not_deopt_visible);
+  // Monitor operations are not escapes, so a singleton is only ever locked by this thread.
+  // Finalizable objects are reported as returned since the finalizer can lock them.
+  if (!is_singleton_and_not_returned || !is_singleton_and_not_deopt_visible) {
+    return false;
+  }
+
+  bool removed = false;
+  const HUseList<HInstruction*>& uses = reference->GetUses();
+  for (auto it = uses.begin(), end = uses.end(); it != end; /* ++it below */) {
+    HInstruction* user = it->GetUser();
+    ++it;  // Increment the iterator before removing the use.
+    if (user->IsMonitorOperation()) {
+      user->GetBlock()->RemoveInstruction(user);
+      MaybeRecordStat(stats_, MethodCompilationStat::kRemovedThreadLocalMonitorOperation);
+      removed = true;
+    }
+  }
+  return removed;
+}
+
+bool MonitorElimination::TryMergeWithNextRegion(HMonitorOperation* monitor_exit) {
+  DCHECK(!monitor_exit->IsEnter());
+  HInstruction* object = GetLockedObject(monitor_exit);
+  HBasicBlock* block = monitor_exit->GetBlock();
+  HInstruction* current = monitor_exit->GetNext();
+  for (size_t distance = 0; distance != kMaximumMergeDistance; ++distance) {
+    DCHECK(current != nullptr);
+    if (current->IsGoto() || current->IsTryBoundary()) {
+      // Follow the normal flow into a block that cannot be entered from elsewhere. A try
+      // boundary does not throw, and the catch handlers of both regions already release
+      // the monitor, which remains held across the boundary.
+      HBasicBlock* successor = current->IsGoto()
+          ? block->GetSingleSuccessor()
+          : current->AsTryBoundary()->GetNormalFlowSuccessor();
+      if (successor->GetPredecessors().size() != 1u ||
+          successor->IsLoopHeader() ||
+          successor->IsCatchBlock()) {
+        return false;
+      }
+      block = successor;
+      current = successor->GetFirstInstruction();
+      continue;
+    }
+    if (current->IsMonitorOperation()) {
+      if (!current->AsMonitorOperation()->IsEnter() || GetLockedObject(current) != object) {
+        return false;
+      }
+      // The monitor is already held, so the monitor-enter cannot throw and both operations
+      // can go. A null check of the object feeding it stays in the graph.
+      current->GetBlock()->RemoveInstruction(current);
+      monitor_exit->GetBlock()->RemoveInstruction(monitor_exit);
+      MaybeRecordStat(stats_, MethodCompilationStat::kMergedMonitorRegions);
+      return true;
+    }
+    // A null check of the locked object cannot throw, the object is known to be non-null.
+    bool is_null_check_of_object = current->IsNullCheck() && current->InputAt(0) == object;
+    if (!is_null_check_of_object &&
+        (current->CanThrow() ||
+         current->IsControlFlow() ||
+         current->IsSuspendCheck() ||
+         current->GetSideEffects().DoesAnyWrite())) {
+      // Extending the region over this instruction could change what other threads observe
+      // or leave the monitor held on an exceptional path.
+      return false;
+    }
+    current = current->GetNext();
+  }
+  return false;
+}
+
+}  // namespace art
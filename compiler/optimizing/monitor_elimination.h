@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_MONITOR_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_MONITOR_ELIMINATION_H_
+
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Optimization pass to remove monitor operations that no other thread can contend for.
+ *
+ * - Monitor operations on an allocation that does not escape the method cannot be observed
+ *   by another thread and are removed. This is common after inlining the synchronized
+ *   methods of a local StringBuffer or Vector.
+ * - A monitor-exit followed by a monitor-enter on the same object, with nothing in between
+ *   that can throw, write to the heap or suspend, is removed so that the two synchronized
+ *   regions become one.
+ *
+ * This pass must run before load-store elimination, which cannot remove an allocation
+ * that is still used by monitor operations.
+ */
+class MonitorElimination : public HOptimization {
+ public:
+  MonitorElimination(HGraph* graph,
+                     OptimizingCompilerStats* stats,
+                     const char* name = kMonitorEliminationPassName)
+      : HOptimization(graph, name, stats) {}
+
+  bool Run() override;
+
+  static constexpr const char* kMonitorEliminationPassName = "monitor_elimination";
+
+ private:
+  // Maximum number of instructions looked at between a monitor-exit and the next
+  // monitor-enter.
+  static constexpr size_t kMaximumMergeDistance = 16;
+
+  // Remove the monitor operations on `reference` if it is an allocation that does not escape.
+  bool TryRemoveThreadLocalMonitors(HInstruction* reference);
+
+  // Remove `monitor_exit` and the next monitor-enter on the same object if nothing between
+  // them needs the monitor to be released.
+  bool TryMergeWithNextRegion(HMonitorOperation* monitor_exit);
+
+  DISALLOW_COPY_AND_ASSIGN(MonitorElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_MONITOR_ELIMINATION_H_
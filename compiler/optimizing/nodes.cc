@@ -26,6 +26,7 @@
 #include "class_root-inl.h"
 #include "code_generator.h"
 #include "common_dominator.h"
+#include "driver/dex_compilation_unit.h"
 #include "intrinsics.h"
 #include "mirror/class-inl.h"
 #include "scoped_thread_state_change-inl.h"
@@ -33,6 +34,36 @@
 
 namespace art {
 
+dex::TypeIndex FindClassIndexIn(ObjPtr<mirror::Class> cls,
+                                const DexCompilationUnit& compilation_unit) {
+  const DexFile& dex_file = *compilation_unit.GetDexFile();
+  dex::TypeIndex index;
+  if (cls->GetDexCache() == nullptr) {
+    DCHECK(cls->IsArrayClass()) << cls->PrettyClass();
+    index = cls->FindTypeIndexInOtherDexFile(dex_file);
+  } else if (!cls->GetDexTypeIndex().IsValid()) {
+    DCHECK(cls->IsProxyClass()) << cls->PrettyClass();
+    // TODO: deal with proxy classes.
+  } else if (IsSameDexFile(cls->GetDexFile(), dex_file)) {
+    DCHECK_EQ(cls->GetDexCache(), compilation_unit.GetDexCache().Get());
+    index = cls->GetDexTypeIndex();
+  } else {
+    index = cls->FindTypeIndexInOtherDexFile(dex_file);
+    // We cannot guarantee the entry will resolve to the same class,
+    // as there may be different class loaders. So only return the index if it's
+    // the right class already resolved with the class loader.
+    if (index.IsValid()) {
+      ObjPtr<mirror::Class> resolved = compilation_unit.GetClassLinker()->LookupResolvedType(
+          index, compilation_unit.GetDexCache().Get(), compilation_unit.GetClassLoader().Get());
+      if (resolved != cls) {
+        index = dex::TypeIndex::Invalid();
+      }
+    }
+  }
+
+  return index;
+}
+
 // Enable floating-point static evaluation during constant folding
 // only if all floating-point operations and constants evaluate in the
 // range and precision of the type used (i.e., 32-bit float, 64-bit
@@ -3159,11 +3190,11 @@ static inline IntrinsicExceptions GetExceptionsIntrinsic(Intrinsics i) {
 }
 
 void HInvoke::SetResolvedMethod(ArtMethod* method) {
-  // TODO: b/65872996 The intent is that polymorphic signature methods should
-  // be compiler intrinsics. At present, they are only interpreter intrinsics.
+  // Polymorphic signature methods are intrinsics only when called with invoke-polymorphic.
+  // Other invokes of these methods call the native stubs that throw.
   if (method != nullptr &&
       method->IsIntrinsic() &&
-      !method->IsPolymorphicSignature()) {
+      (IsInvokePolymorphic() || !method->IsPolymorphicSignature())) {
     Intrinsics intrinsic = static_cast<Intrinsics>(method->GetIntrinsic());
     SetIntrinsic(intrinsic,
                  NeedsEnvironmentOrCacheIntrinsic(intrinsic),
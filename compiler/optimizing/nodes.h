@@ -52,6 +52,7 @@
 namespace art {
 
 class ArenaStack;
+class DexCompilationUnit;
 class GraphChecker;
 class HBasicBlock;
 class HConstructorFence;
@@ -108,6 +109,12 @@ inline bool IsSameDexFile(const DexFile& lhs, const DexFile& rhs) {
   return &lhs == &rhs;
 }
 
+// Return the index of `cls` in the dex file of `compilation_unit`, provided it resolves to
+// `cls` there, or an invalid index.
+dex::TypeIndex FindClassIndexIn(ObjPtr<mirror::Class> cls,
+                                const DexCompilationUnit& compilation_unit)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
 enum IfCondition {
   // All types.
   kCondEQ,  // ==
@@ -407,6 +414,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         invoke_type_(invoke_type),
         in_ssa_form_(false),
         number_of_cha_guards_(0),
+        disabled_speculations_(0u),
         instruction_set_(instruction_set),
         cached_null_constant_(nullptr),
         cached_int_constants_(std::less<int32_t>(), allocator->Adapter(kArenaAllocConstantsMap)),
@@ -648,6 +656,13 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingBaseline() const { return compilation_kind_ == CompilationKind::kBaseline; }
 
+  // Speculations guarded by an HDeoptimize of a given kind are disabled once previously
+  // compiled code of this method deoptimized too often for that kind.
+  void SetDisabledSpeculations(uint32_t kinds) { disabled_speculations_ = kinds; }
+  bool CanSpeculate(DeoptimizationKind kind) const {
+    return (disabled_speculations_ & (1u << static_cast<size_t>(kind))) == 0u;
+  }
+
   CompilationKind GetCompilationKind() const { return compilation_kind_; }
 
   ArenaSet<ArtMethod*>& GetCHASingleImplementationList() {
@@ -822,6 +837,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // CHA guard optimization pass when there is no CHA guard left.
   uint32_t number_of_cha_guards_;
 
+  // Bit mask of the DeoptimizationKinds the compiler must not emit, see CanSpeculate().
+  uint32_t disabled_speculations_;
+
   const InstructionSet instruction_set_;
 
   // Cached constants.
@@ -3224,7 +3242,9 @@ class HDoubleConstant final : public HConstant {
 class HIf final : public HExpression<1> {
  public:
   explicit HIf(HInstruction* input, uint32_t dex_pc = kNoDexPc)
-      : HExpression(kIf, SideEffects::None(), dex_pc) {
+      : HExpression(kIf, SideEffects::None(), dex_pc),
+        true_count_(0u),
+        false_count_(0u) {
     SetRawInputAt(0, input);
   }
 
@@ -3239,10 +3259,41 @@ class HIf final : public HExpression<1> {
     return GetBlock()->GetSuccessors()[1];
   }
 
+  // Number of times each successor was reached, as recorded by baseline compiled code.
+  // Both are zero when there is no profile for this branch.
+  void SetBranchProfile(uint32_t true_count, uint32_t false_count) {
+    true_count_ = true_count;
+    false_count_ = false_count;
+  }
+  uint32_t GetTrueCount() const { return true_count_; }
+  uint32_t GetFalseCount() const { return false_count_; }
+
+  // Must be called when the successors of the block are swapped.
+  void SwapBranchProfile() { std::swap(true_count_, false_count_); }
+
+  // Return whether the profile shows that `successor` is almost never reached.
+  bool IsUnlikelySuccessor(HBasicBlock* successor) const {
+    uint64_t total = static_cast<uint64_t>(true_count_) + false_count_;
+    if (total < kMinimumBranchProfileSamples) {
+      return false;
+    }
+    uint32_t count = (successor == IfTrueSuccessor()) ? true_count_ : false_count_;
+    return count * kUnlikelyBranchRatio < total;
+  }
+
   DECLARE_INSTRUCTION(If);
 
+  // Number of recorded outcomes needed before we trust a branch profile.
+  static constexpr uint64_t kMinimumBranchProfileSamples = 100u;
+  // A successor is unlikely if it is reached less often than once every that many times.
+  static constexpr uint64_t kUnlikelyBranchRatio = 100u;
+
  protected:
   DEFAULT_COPY_CONSTRUCTOR(If);
+
+ private:
+  uint32_t true_count_;
+  uint32_t false_count_;
 };
 
 
@@ -4507,7 +4558,13 @@ class HInvokePolymorphic final : public HInvoke {
                      uint32_t number_of_arguments,
                      DataType::Type return_type,
                      uint32_t dex_pc,
-                     uint32_t dex_method_index)
+                     uint32_t dex_method_index,
+                     // resolved_method is the ArtMethod object corresponding to the polymorphic
+                     // method (e.g. VarHandle.get), resolved using the class linker. It is needed
+                     // to pass intrinsic information to the HInvokePolymorphic node.
+                     ArtMethod* resolved_method,
+                     dex::ProtoIndex proto_idx,
+                     const DexFile& dex_file)
       : HInvoke(kInvokePolymorphic,
                 allocator,
                 number_of_arguments,
@@ -4515,16 +4572,27 @@ class HInvokePolymorphic final : public HInvoke {
                 return_type,
                 dex_pc,
                 dex_method_index,
-                nullptr,
-                kVirtual) {
+                resolved_method,
+                kVirtual),
+        proto_idx_(proto_idx),
+        dex_file_(dex_file) {
   }
 
   bool IsClonable() const override { return true; }
 
+  // The call site type, which may differ from the type of the resolved polymorphic method.
+  dex::ProtoIndex GetProtoIndex() const { return proto_idx_; }
+
+  const DexFile& GetDexFile() const { return dex_file_; }
+
   DECLARE_INSTRUCTION(InvokePolymorphic);
 
  protected:
   DEFAULT_COPY_CONSTRUCTOR(InvokePolymorphic);
+
+ private:
+  const dex::ProtoIndex proto_idx_;
+  const DexFile& dex_file_;
 };
 
 class HInvokeCustom final : public HInvoke {
@@ -6982,7 +7050,8 @@ class HStringBuilderAppend final : public HVariableInputSizeInstruction {
     SetRawInputAt(index, argument);
   }
 
-  // Return the number of arguments, excluding the format.
+  // Return the number of arguments, excluding the format but including the chained
+  // format words for the arguments that do not fit into the first format word.
   size_t GetNumberOfArguments() const {
     DCHECK_GE(InputCount(), 1u);
     return InputCount() - 1u;
@@ -7235,7 +7304,8 @@ class HTypeCheckInstruction : public HVariableInputSizeInstruction {
           allocator,
           /* number_of_inputs= */ check_kind == TypeCheckKind::kBitstringCheck ? 4u : 2u,
           kArenaAllocTypeCheckInputs),
-        klass_(klass) {
+        klass_(klass),
+        profiled_dex_file_(nullptr) {
     SetPackedField<TypeCheckKindField>(check_kind);
     SetPackedFlag<kFlagMustDoNullCheck>(true);
     SetPackedFlag<kFlagValidTargetClassRTI>(false);
@@ -7305,6 +7375,37 @@ class HTypeCheckInstruction : public HVariableInputSizeInstruction {
     return klass_;
   }
 
+  // Record that the JIT profile saw mostly objects of `profiled_class`, which passes the
+  // check. Code generators may compare the object's class with it before the general path.
+  // `type_index` refers to the class in `dex_file`, the dex file of the method that contains
+  // the check, which can differ from the graph's dex file after inlining.
+  void SetProfiledClass(Handle<mirror::Class> profiled_class,
+                        const DexFile& dex_file,
+                        dex::TypeIndex type_index) {
+    DCHECK(profiled_class != nullptr);
+    DCHECK(type_index.IsValid());
+    profiled_class_ = profiled_class;
+    profiled_dex_file_ = &dex_file;
+    profiled_type_index_ = type_index;
+  }
+
+  bool HasProfiledClass() const {
+    return profiled_class_ != nullptr;
+  }
+
+  Handle<mirror::Class> GetProfiledClass() const {
+    return profiled_class_;
+  }
+
+  const DexFile& GetProfiledDexFile() const {
+    DCHECK(HasProfiledClass());
+    return *profiled_dex_file_;
+  }
+
+  dex::TypeIndex GetProfiledTypeIndex() const {
+    return profiled_type_index_;
+  }
+
  protected:
   DEFAULT_COPY_CONSTRUCTOR(TypeCheckInstruction);
 
@@ -7319,6 +7420,9 @@ class HTypeCheckInstruction : public HVariableInputSizeInstruction {
   using TypeCheckKindField = BitField<TypeCheckKind, kFieldTypeCheckKind, kFieldTypeCheckKindSize>;
 
   Handle<mirror::Class> klass_;
+  Handle<mirror::Class> profiled_class_;
+  const DexFile* profiled_dex_file_;
+  dex::TypeIndex profiled_type_index_;
 };
 
 class HInstanceOf final : public HTypeCheckInstruction {
@@ -7486,6 +7590,7 @@ class HMemoryBarrier final : public HExpression<0> {
   bool IsClonable() const override { return true; }
 
   MemBarrierKind GetBarrierKind() { return GetPackedField<BarrierKindField>(); }
+  void SetBarrierKind(MemBarrierKind kind) { SetPackedField<BarrierKindField>(kind); }
 
   DECLARE_INSTRUCTION(MemoryBarrier);
 
@@ -35,6 +35,7 @@
 
 #include "bounds_check_elimination.h"
 #include "cha_guard_optimization.h"
+#include "clinit_check_elimination.h"
 #include "code_sinking.h"
 #include "constant_folding.h"
 #include "constructor_fence_redundancy_elimination.h"
@@ -49,7 +50,10 @@
 #include "intrinsics.h"
 #include "licm.h"
 #include "load_store_elimination.h"
+#include "partial_escape_analysis.h"
 #include "loop_optimization.h"
+#include "memory_barrier_elimination.h"
+#include "monitor_elimination.h"
 #include "scheduler.h"
 #include "select_generator.h"
 #include "sharpening.h"
@@ -75,6 +79,12 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return BoundsCheckElimination::kBoundsCheckEliminationPassName;
     case OptimizationPass::kLoadStoreElimination:
       return LoadStoreElimination::kLoadStoreEliminationPassName;
+    case OptimizationPass::kMemoryBarrierElimination:
+      return MemoryBarrierElimination::kMemoryBarrierEliminationPassName;
+    case OptimizationPass::kMonitorElimination:
+      return MonitorElimination::kMonitorEliminationPassName;
+    case OptimizationPass::kPartialEscapeAnalysis:
+      return PartialEscapeAnalysis::kPartialEscapeAnalysisPassName;
     case OptimizationPass::kConstantFolding:
       return HConstantFolding::kConstantFoldingPassName;
     case OptimizationPass::kDeadCodeElimination:
@@ -88,6 +98,8 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return InstructionSimplifier::kInstructionSimplifierPassName;
     case OptimizationPass::kCHAGuardOptimization:
       return CHAGuardOptimization::kCHAGuardOptimizationPassName;
+    case OptimizationPass::kClinitCheckElimination:
+      return ClinitCheckElimination::kClinitCheckEliminationPassName;
     case OptimizationPass::kCodeSinking:
       return CodeSinking::kCodeSinkingPassName;
     case OptimizationPass::kConstructorFenceRedundancyElimination:
@@ -127,6 +139,7 @@ const char* OptimizationPassName(OptimizationPass pass) {
 OptimizationPass OptimizationPassByName(const std::string& pass_name) {
   X(OptimizationPass::kBoundsCheckElimination);
   X(OptimizationPass::kCHAGuardOptimization);
+  X(OptimizationPass::kClinitCheckElimination);
   X(OptimizationPass::kCodeSinking);
   X(OptimizationPass::kConstantFolding);
   X(OptimizationPass::kConstructorFenceRedundancyElimination);
@@ -138,6 +151,9 @@ OptimizationPass OptimizationPassByName(const std::string& pass_name) {
   X(OptimizationPass::kInvariantCodeMotion);
   X(OptimizationPass::kLoadStoreElimination);
   X(OptimizationPass::kLoopOptimization);
+  X(OptimizationPass::kMemoryBarrierElimination);
+  X(OptimizationPass::kMonitorElimination);
+  X(OptimizationPass::kPartialEscapeAnalysis);
   X(OptimizationPass::kScheduling);
   X(OptimizationPass::kSelectGenerator);
   X(OptimizationPass::kSideEffectsAnalysis);
@@ -259,9 +275,23 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kCHAGuardOptimization:
         opt = new (allocator) CHAGuardOptimization(graph, pass_name);
         break;
+      case OptimizationPass::kClinitCheckElimination:
+        opt = new (allocator) ClinitCheckElimination(
+            graph, codegen->GetCompilerOptions(), stats, pass_name);
+        break;
       case OptimizationPass::kCodeSinking:
         opt = new (allocator) CodeSinking(graph, stats, pass_name);
         break;
+      case OptimizationPass::kMemoryBarrierElimination:
+        opt = new (allocator) MemoryBarrierElimination(
+            graph, codegen->GetCompilerOptions().GetInstructionSet(), stats, pass_name);
+        break;
+      case OptimizationPass::kMonitorElimination:
+        opt = new (allocator) MonitorElimination(graph, stats, pass_name);
+        break;
+      case OptimizationPass::kPartialEscapeAnalysis:
+        opt = new (allocator) PartialEscapeAnalysis(graph, stats, pass_name);
+        break;
       case OptimizationPass::kConstructorFenceRedundancyElimination:
         opt = new (allocator) ConstructorFenceRedundancyElimination(graph, stats, pass_name);
         break;
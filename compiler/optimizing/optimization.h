@@ -69,6 +69,7 @@ enum class OptimizationPass {
   kAggressiveInstructionSimplifier,
   kBoundsCheckElimination,
   kCHAGuardOptimization,
+  kClinitCheckElimination,
   kCodeSinking,
   kConstantFolding,
   kConstructorFenceRedundancyElimination,
@@ -80,6 +81,9 @@ enum class OptimizationPass {
   kInvariantCodeMotion,
   kLoadStoreElimination,
   kLoopOptimization,
+  kMemoryBarrierElimination,
+  kMonitorElimination,
+  kPartialEscapeAnalysis,
   kScheduling,
   kSelectGenerator,
   kSideEffectsAnalysis,
@@ -21,6 +21,7 @@
 #include <sstream>
 
 #include <stdint.h>
+#include <string.h>
 
 #include "art_method-inl.h"
 #include "base/arena_allocator.h"
@@ -30,7 +31,9 @@
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
+#include "base/utils.h"
 #include "builder.h"
 #include "code_generator.h"
 #include "compiled_method.h"
@@ -50,11 +53,14 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/jit_logger.h"
+#include "jit/profiling_info.h"
 #include "jni/quick/jni_compiler.h"
 #include "linker/linker_patch.h"
 #include "nodes.h"
 #include "oat_quick_method_header.h"
+#include "optimizing_pass_stats.h"
 #include "prepare_for_register_allocation.h"
+#include "profile/profile_compilation_info.h"
 #include "reference_type_propagation.h"
 #include "register_allocator_linear_scan.h"
 #include "select_generator.h"
@@ -69,8 +75,58 @@ namespace art {
 
 static constexpr size_t kArenaAllocatorMemoryReportThreshold = 8 * MB;
 
+// Arena memory a single JIT compilation may use before we give up on the method. The JIT
+// compiles on several threads, so this bounds the peak memory used by the compiler.
+static constexpr size_t kJitArenaMemoryBudget = 32 * MB;
+
 static constexpr const char* kPassNameSeparator = "$";
 
+// The code generators expect the instruction simplifier to run last (see the pass list
+// in RunOptimizations), so this pass runs even when the time budget of a method is used up.
+static constexpr const char* kInstructionSimplifierBeforeCodegenPassName =
+    "instruction_simplifier$before_codegen";
+
+/**
+ * Wall time budget for the optimizing passes of one method. Huge generated methods can
+ * take seconds to optimize; once the budget is used up, the remaining optional passes
+ * are skipped so that the method is compiled with cheaper code instead of stalling the
+ * compiler thread.
+ */
+class OptimizingTimeBudget {
+ public:
+  OptimizingTimeBudget(size_t budget_ms, OptimizingCompilerStats* stats)
+      : deadline_ns_(budget_ms != 0u ? NanoTime() + MsToNs(budget_ms) : 0u),
+        stats_(stats),
+        is_exhausted_(false) {}
+
+  // Returns whether the budget is used up. Once it is, it stays so for the method.
+  bool IsExhausted() {
+    if (!is_exhausted_ && deadline_ns_ != 0u && NanoTime() > deadline_ns_) {
+      is_exhausted_ = true;
+      MaybeRecordStat(stats_, MethodCompilationStat::kOverTimeBudget);
+    }
+    return is_exhausted_;
+  }
+
+  // Returns whether the pass described by `definition` may be skipped.
+  static bool IsOptional(const OptimizationDef& definition) {
+#ifdef ART_ENABLE_CODEGEN_x86
+    if (definition.pass == OptimizationPass::kPcRelativeFixupsX86) {
+      return false;
+    }
+#endif
+    return definition.pass_name == nullptr ||
+           strcmp(definition.pass_name, kInstructionSimplifierBeforeCodegenPassName) != 0;
+  }
+
+ private:
+  const uint64_t deadline_ns_;
+  OptimizingCompilerStats* const stats_;
+  bool is_exhausted_;
+
+  DISALLOW_COPY_AND_ASSIGN(OptimizingTimeBudget);
+};
+
 /**
  * Used by the code generator, to allocate the code in a vector.
  */
@@ -107,7 +163,8 @@ class PassObserver : public ValueObject {
                CodeGenerator* codegen,
                std::ostream* visualizer_output,
                const CompilerOptions& compiler_options,
-               Mutex& dump_mutex)
+               Mutex& dump_mutex,
+               OptimizingPassStats* pass_stats)
       : graph_(graph),
         last_seen_graph_size_(0),
         cached_method_name_(),
@@ -120,6 +177,10 @@ class PassObserver : public ValueObject {
         visualizer_(&visualizer_oss_, graph, *codegen),
         codegen_(codegen),
         visualizer_dump_mutex_(dump_mutex),
+        pass_stats_(pass_stats),
+        pass_samples_(),
+        pass_start_ns_(0u),
+        pass_start_bytes_(0u),
         graph_in_bad_state_(false) {
     if (timing_logger_enabled_ || visualizer_enabled_) {
       if (!IsVerboseMethod(compiler_options, GetMethodName())) {
@@ -133,6 +194,9 @@ class PassObserver : public ValueObject {
   }
 
   ~PassObserver() {
+    if (pass_stats_ != nullptr && !pass_samples_.empty()) {
+      pass_stats_->AddSamples(ArrayRef<const OptimizingPassStats::Sample>(pass_samples_));
+    }
     if (timing_logger_enabled_) {
       LOG(INFO) << "TIMINGS " << GetMethodName();
       LOG(INFO) << Dumpable<TimingLogger>(timing_logger_);
@@ -169,6 +233,14 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.StartTiming(pass_name);
     }
+    if (pass_stats_ != nullptr) {
+      pass_start_bytes_ = GetArenaBytes();
+      pass_start_ns_ = NanoTime();
+    }
+  }
+
+  size_t GetArenaBytes() const {
+    return graph_->GetAllocator()->BytesUsed() + graph_->GetArenaStack()->ApproximatePeakBytes();
   }
 
   void FlushVisualizer() REQUIRES(!visualizer_dump_mutex_) {
@@ -181,6 +253,11 @@ class PassObserver : public ValueObject {
 
   void EndPass(const char* pass_name, bool pass_change) {
     // Pause timer first, then dump graph.
+    if (pass_stats_ != nullptr) {
+      uint64_t time_ns = NanoTime() - pass_start_ns_;
+      size_t bytes = GetArenaBytes();
+      pass_samples_.push_back({pass_name, time_ns, bytes, bytes - pass_start_bytes_});
+    }
     if (timing_logger_enabled_) {
       timing_logger_.EndTiming();
     }
@@ -234,6 +311,13 @@ class PassObserver : public ValueObject {
   CodeGenerator* codegen_;
   Mutex& visualizer_dump_mutex_;
 
+  // Aggregated pass stats for --dump-pass-stats, or null. The samples of this method are
+  // merged when the observer is destroyed.
+  OptimizingPassStats* const pass_stats_;
+  std::vector<OptimizingPassStats::Sample> pass_samples_;
+  uint64_t pass_start_ns_;
+  size_t pass_start_bytes_;
+
   // Flag to be set by the compiler if the pass failed and the graph is not
   // expected to validate.
   bool graph_in_bad_state_;
@@ -309,7 +393,8 @@ class OptimizingCompiler final : public Compiler {
                         const DexCompilationUnit& dex_compilation_unit,
                         PassObserver* pass_observer,
                         const OptimizationDef definitions[],
-                        size_t length) const {
+                        size_t length,
+                        OptimizingTimeBudget* time_budget = nullptr) const {
     // Convert definitions to optimization passes.
     ArenaVector<HOptimization*> optimizations = ConstructOptimizations(
         definitions,
@@ -326,7 +411,15 @@ class OptimizingCompiler final : public Compiler {
     pass_changes[static_cast<size_t>(OptimizationPass::kNone)] = true;
     bool change = false;
     for (size_t i = 0; i < length; ++i) {
-      if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
+      if (time_budget != nullptr &&
+          OptimizingTimeBudget::IsOptional(definitions[i]) &&
+          time_budget->IsExhausted()) {
+        // Skip the pass and record that nothing changed. Every later optional pass is
+        // skipped too, so no pass runs after an analysis it depends on was skipped.
+        MaybeRecordStat(compilation_stats_.get(),
+                        MethodCompilationStat::kSkippedPassOverTimeBudget);
+        pass_changes[static_cast<size_t>(definitions[i].pass)] = false;
+      } else if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
         // Execute the pass and record whether it changed anything.
         PassScope scope(optimizations[i]->GetPassName(), pass_observer);
         bool pass_change = optimizations[i]->Run();
@@ -349,15 +442,17 @@ class OptimizingCompiler final : public Compiler {
       CodeGenerator* codegen,
       const DexCompilationUnit& dex_compilation_unit,
       PassObserver* pass_observer,
-      const OptimizationDef (&definitions)[length]) const {
+      const OptimizationDef (&definitions)[length],
+      OptimizingTimeBudget* time_budget = nullptr) const {
     return RunOptimizations(
-        graph, codegen, dex_compilation_unit, pass_observer, definitions, length);
+        graph, codegen, dex_compilation_unit, pass_observer, definitions, length, time_budget);
   }
 
   void RunOptimizations(HGraph* graph,
                         CodeGenerator* codegen,
                         const DexCompilationUnit& dex_compilation_unit,
-                        PassObserver* pass_observer) const;
+                        PassObserver* pass_observer,
+                        OptimizingTimeBudget* time_budget) const;
 
  private:
   // Create a 'CompiledMethod' for an optimized graph.
@@ -391,17 +486,25 @@ class OptimizingCompiler final : public Compiler {
   bool RunArchOptimizations(HGraph* graph,
                             CodeGenerator* codegen,
                             const DexCompilationUnit& dex_compilation_unit,
-                            PassObserver* pass_observer) const;
+                            PassObserver* pass_observer,
+                            OptimizingTimeBudget* time_budget) const;
 
   bool RunBaselineOptimizations(HGraph* graph,
                                 CodeGenerator* codegen,
                                 const DexCompilationUnit& dex_compilation_unit,
                                 PassObserver* pass_observer) const;
 
+  // Returns whether a JIT compilation has used more arena memory than it is allowed to.
+  bool IsOverJitMemoryBudget(const CompilerOptions& compiler_options,
+                             ArenaAllocator* allocator,
+                             ArenaStack* arena_stack) const;
+
   std::vector<uint8_t> GenerateJitDebugInfo(const debug::MethodDebugInfo& method_debug_info);
 
   std::unique_ptr<OptimizingCompilerStats> compilation_stats_;
 
+  std::unique_ptr<OptimizingPassStats> pass_stats_;
+
   std::unique_ptr<std::ostream> visualizer_output_;
 
   mutable Mutex dump_mutex_;  // To synchronize visualizer writing.
@@ -425,12 +528,18 @@ OptimizingCompiler::OptimizingCompiler(const CompilerOptions& compiler_options,
   if (compiler_options.GetDumpStats()) {
     compilation_stats_.reset(new OptimizingCompilerStats());
   }
+  if (compiler_options.GetDumpPassStats()) {
+    pass_stats_.reset(new OptimizingPassStats());
+  }
 }
 
 OptimizingCompiler::~OptimizingCompiler() {
   if (compilation_stats_.get() != nullptr) {
     compilation_stats_->Log();
   }
+  if (pass_stats_ != nullptr) {
+    pass_stats_->Log();
+  }
 }
 
 bool OptimizingCompiler::CanCompileMethod(uint32_t method_idx ATTRIBUTE_UNUSED,
@@ -475,7 +584,8 @@ bool OptimizingCompiler::RunBaselineOptimizations(HGraph* graph,
 bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
                                               CodeGenerator* codegen,
                                               const DexCompilationUnit& dex_compilation_unit,
-                                              PassObserver* pass_observer) const {
+                                              PassObserver* pass_observer,
+                                              OptimizingTimeBudget* time_budget) const {
   switch (codegen->GetCompilerOptions().GetInstructionSet()) {
 #if defined(ART_ENABLE_CODEGEN_arm)
     case InstructionSet::kThumb2:
@@ -490,7 +600,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
                               codegen,
                               dex_compilation_unit,
                               pass_observer,
-                              arm_optimizations);
+                              arm_optimizations,
+                              time_budget);
     }
 #endif
 #ifdef ART_ENABLE_CODEGEN_arm64
@@ -505,7 +616,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
                               codegen,
                               dex_compilation_unit,
                               pass_observer,
-                              arm64_optimizations);
+                              arm64_optimizations,
+                              time_budget);
     }
 #endif
 #ifdef ART_ENABLE_CODEGEN_x86
@@ -521,7 +633,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
                               codegen,
                               dex_compilation_unit,
                               pass_observer,
-                              x86_optimizations);
+                              x86_optimizations,
+                              time_budget);
     }
 #endif
 #ifdef ART_ENABLE_CODEGEN_x86_64
@@ -530,16 +643,21 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
         OptDef(OptimizationPass::kInstructionSimplifierX86_64),
         OptDef(OptimizationPass::kSideEffectsAnalysis),
         OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+        // Scheduling runs before the memory operand generation, which relies on
+        // the bounds check directly following the array length.
+        OptDef(OptimizationPass::kScheduling),
         OptDef(OptimizationPass::kX86MemoryOperandGeneration)
       };
       return RunOptimizations(graph,
                               codegen,
                               dex_compilation_unit,
                               pass_observer,
-                              x86_64_optimizations);
+                              x86_64_optimizations,
+                              time_budget);
     }
 #endif
     default:
+      UNUSED(time_budget);
       return false;
   }
 }
@@ -549,6 +667,7 @@ static void AllocateRegisters(HGraph* graph,
                               CodeGenerator* codegen,
                               PassObserver* pass_observer,
                               RegisterAllocator::Strategy strategy,
+                              bool is_hot_method,
                               OptimizingCompilerStats* stats) {
   {
     PassScope scope(PrepareForRegisterAllocation::kPrepareForRegisterAllocationPassName,
@@ -565,9 +684,19 @@ static void AllocateRegisters(HGraph* graph,
   }
   {
     PassScope scope(RegisterAllocator::kRegisterAllocatorPassName, pass_observer);
+    strategy = RegisterAllocator::SelectStrategy(strategy, codegen, liveness, is_hot_method);
     std::unique_ptr<RegisterAllocator> register_allocator =
         RegisterAllocator::Create(&local_allocator, codegen, liveness, strategy);
     register_allocator->AllocateRegisters();
+    if (stats != nullptr) {
+      size_t spilled_values = RegisterAllocator::CountSpilledValues(liveness);
+      if (strategy == RegisterAllocator::kRegisterAllocatorGraphColor) {
+        MaybeRecordStat(stats, MethodCompilationStat::kGraphColorRegisterAllocation);
+        MaybeRecordStat(stats, MethodCompilationStat::kSpilledValuesGraphColor, spilled_values);
+      } else {
+        MaybeRecordStat(stats, MethodCompilationStat::kSpilledValuesLinearScan, spilled_values);
+      }
+    }
   }
 }
 
@@ -580,7 +709,8 @@ static std::string ConvertPassNameToOptimizationName(const std::string& pass_nam
 void OptimizingCompiler::RunOptimizations(HGraph* graph,
                                           CodeGenerator* codegen,
                                           const DexCompilationUnit& dex_compilation_unit,
-                                          PassObserver* pass_observer) const {
+                                          PassObserver* pass_observer,
+                                          OptimizingTimeBudget* time_budget) const {
   const std::vector<std::string>* pass_names = GetCompilerOptions().GetPassesToRun();
   if (pass_names != nullptr) {
     // If passes were defined on command-line, build the optimization
@@ -619,6 +749,9 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     OptDef(OptimizationPass::kDeadCodeElimination,
            "dead_code_elimination$after_inlining",
            OptimizationPass::kInliner),
+    OptDef(OptimizationPass::kClinitCheckElimination,
+           "clinit_check_elimination$after_inlining",
+           OptimizationPass::kInliner),
     // GVN.
     OptDef(OptimizationPass::kSideEffectsAnalysis,
            "side_effects$before_gvn"),
@@ -644,6 +777,8 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     OptDef(OptimizationPass::kAggressiveInstructionSimplifier,
            "instruction_simplifier$after_bce"),
     // Other high-level optimizations.
+    OptDef(OptimizationPass::kMonitorElimination),
+    OptDef(OptimizationPass::kPartialEscapeAnalysis),
     OptDef(OptimizationPass::kSideEffectsAnalysis,
            "side_effects$before_lse"),
     OptDef(OptimizationPass::kLoadStoreElimination),
@@ -655,18 +790,21 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     // can satisfy. For example, the code generator does not expect to see a
     // HTypeConversion from a type to the same type.
     OptDef(OptimizationPass::kAggressiveInstructionSimplifier,
-           "instruction_simplifier$before_codegen"),
+           kInstructionSimplifierBeforeCodegenPassName),
     // Eliminate constructor fences after code sinking to avoid
     // complicated sinking logic to split a fence with many inputs.
-    OptDef(OptimizationPass::kConstructorFenceRedundancyElimination)
+    OptDef(OptimizationPass::kConstructorFenceRedundancyElimination),
+    // Coalesce the remaining barriers, including constructor fences next to other barriers.
+    OptDef(OptimizationPass::kMemoryBarrierElimination)
   };
   RunOptimizations(graph,
                    codegen,
                    dex_compilation_unit,
                    pass_observer,
-                   optimizations);
+                   optimizations,
+                   time_budget);
 
-  RunArchOptimizations(graph, codegen, dex_compilation_unit, pass_observer);
+  RunArchOptimizations(graph, codegen, dex_compilation_unit, pass_observer, time_budget);
 }
 
 static ArenaVector<linker::LinkerPatch> EmitAndSortLinkerPatches(CodeGenerator* codegen) {
@@ -710,6 +848,22 @@ CompiledMethod* OptimizingCompiler::Emit(ArenaAllocator* allocator,
   return compiled_method;
 }
 
+bool OptimizingCompiler::IsOverJitMemoryBudget(const CompilerOptions& compiler_options,
+                                               ArenaAllocator* allocator,
+                                               ArenaStack* arena_stack) const {
+  if (!compiler_options.IsJitCompiler()) {
+    return false;
+  }
+  size_t bytes_used = allocator->BytesUsed() + arena_stack->ApproximatePeakBytes();
+  if (bytes_used <= kJitArenaMemoryBudget) {
+    return false;
+  }
+  VLOG(jit) << "Giving up on compilation after using " << PrettySize(bytes_used)
+            << " of arena memory";
+  MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kNotCompiledOverMemoryBudget);
+  return true;
+}
+
 CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                                               ArenaStack* arena_stack,
                                               CodeVectorAllocator* code_allocator,
@@ -719,6 +873,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                                               VariableSizedHandleScope* handles) const {
   MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kAttemptBytecodeCompilation);
   const CompilerOptions& compiler_options = GetCompilerOptions();
+  // The budget also covers building the graph, which is slow for huge methods.
+  OptimizingTimeBudget time_budget(compiler_options.GetOptimizingTimeBudgetMs(),
+                                   compilation_stats_.get());
   InstructionSet instruction_set = compiler_options.GetInstructionSet();
   const DexFile& dex_file = *dex_compilation_unit.GetDexFile();
   uint32_t method_idx = dex_compilation_unit.GetDexMethodIndex();
@@ -754,6 +911,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
 
   bool dead_reference_safe;
   ArrayRef<const uint8_t> interpreter_metadata;
+  uint32_t disabled_speculations = 0u;
   // For AOT compilation, we may not get a method, for example if its class is erroneous,
   // possibly due to an unavailable superclass.  JIT should always have a method.
   DCHECK(Runtime::Current()->IsAotCompiler() || method != nullptr);
@@ -763,6 +921,10 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
       ScopedObjectAccess soa(Thread::Current());
       containing_class = &method->GetClassDef();
       interpreter_metadata = method->GetQuickenedInfo();
+      ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+      if (info != nullptr) {
+        disabled_speculations = info->GetDisabledSpeculations();
+      }
     }
     // MethodContainsRSensitiveAccess is currently slow, but HasDeadReferenceSafeAnnotation()
     // is currently rarely true.
@@ -789,6 +951,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   if (method != nullptr) {
     graph->SetArtMethod(method);
   }
+  graph->SetDisabledSpeculations(disabled_speculations);
 
   std::unique_ptr<CodeGenerator> codegen(
       CodeGenerator::Create(graph,
@@ -804,7 +967,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                              codegen.get(),
                              visualizer_output_.get(),
                              compiler_options,
-                             dump_mutex_);
+                             dump_mutex_,
+                             pass_stats_.get());
 
   {
     VLOG(compiler) << "Building " << pass_observer.GetMethodName();
@@ -857,18 +1021,45 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     }
   }
 
+  if (IsOverJitMemoryBudget(compiler_options, allocator, arena_stack)) {
+    return nullptr;
+  }
+
   if (compilation_kind == CompilationKind::kBaseline) {
     RunBaselineOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
+  } else if (time_budget.IsExhausted()) {
+    // Building the graph used up the budget: only run the passes of the baseline tier.
+    VLOG(compiler) << "Time budget used up after building " << pass_observer.GetMethodName();
+    MaybeRecordStat(compilation_stats_.get(),
+                    MethodCompilationStat::kBaselinePassesOverTimeBudget);
+    RunBaselineOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
   } else {
-    RunOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
+    RunOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer, &time_budget);
   }
 
+  // Inlining may have grown the graph a lot, check again before the register allocator.
+  if (IsOverJitMemoryBudget(compiler_options, allocator, arena_stack)) {
+    return nullptr;
+  }
+
+  // The JIT only compiles optimized code for methods its hotness counters found hot.
+  bool is_hot_method = false;
+  if (compilation_kind != CompilationKind::kBaseline) {
+    if (compiler_options.IsJitCompiler()) {
+      is_hot_method = true;
+    } else {
+      const ProfileCompilationInfo* profile = compiler_options.GetProfileCompilationInfo();
+      is_hot_method = (profile != nullptr) &&
+          profile->GetMethodHotness(MethodReference(&dex_file, method_idx)).IsHot();
+    }
+  }
   RegisterAllocator::Strategy regalloc_strategy =
     compiler_options.GetRegisterAllocationStrategy();
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
                     regalloc_strategy,
+                    is_hot_method,
                     compilation_stats_.get());
 
   codegen->Compile(code_allocator);
@@ -929,7 +1120,8 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
                              codegen.get(),
                              visualizer_output_.get(),
                              compiler_options,
-                             dump_mutex_);
+                             dump_mutex_,
+                             pass_stats_.get());
 
   {
     VLOG(compiler) << "Building intrinsic graph " << pass_observer.GetMethodName();
@@ -955,12 +1147,17 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
                    &pass_observer,
                    optimizations);
 
-  RunArchOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
+  RunArchOptimizations(graph,
+                       codegen.get(),
+                       dex_compilation_unit,
+                       &pass_observer,
+                       /* time_budget= */ nullptr);
 
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
                     compiler_options.GetRegisterAllocationStrategy(),
+                    /* is_hot_method= */ false,
                     compilation_stats_.get());
   if (!codegen->IsLeafMethod()) {
     VLOG(compiler) << "Intrinsic method is not leaf: " << method->GetIntrinsic()
@@ -1043,7 +1240,7 @@ CompiledMethod* OptimizingCompiler::Compile(const dex::CodeItem* code_item,
                        &code_allocator,
                        dex_compilation_unit,
                        method,
-                       compiler_options.IsBaseline()
+                       compiler_options.IsBaselineMethod(MethodReference(&dex_file, method_idx))
                           ? CompilationKind::kBaseline
                           : CompilationKind::kOptimized,
                        &handles));
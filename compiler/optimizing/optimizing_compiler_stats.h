@@ -38,6 +38,7 @@ enum class MethodCompilationStat {
   kCHAInline,
   kInlinedInvoke,
   kReplacedInvokeWithSimplePattern,
+  kReplacedConstantMethodHandleInvoke,
   kInstructionSimplifications,
   kInstructionSimplificationsArch,
   kUnresolvedMethod,
@@ -46,6 +47,7 @@ enum class MethodCompilationStat {
   kRemovedCheckedCast,
   kRemovedDeadInstruction,
   kRemovedNullCheck,
+  kRemovedClinitCheck,
   kNotCompiledSkipped,
   kNotCompiledInvalidBytecode,
   kNotCompiledThrowCatchLoop,
@@ -62,8 +64,13 @@ enum class MethodCompilationStat {
   kNotCompiledVerifyAtRuntime,
   kNotCompiledIrreducibleLoopAndStringInit,
   kNotCompiledPhiEquivalentInOsr,
+  kNotCompiledOverMemoryBudget,
+  kOverTimeBudget,
+  kSkippedPassOverTimeBudget,
+  kBaselinePassesOverTimeBudget,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -72,6 +79,7 @@ enum class MethodCompilationStat {
   kLoopInvariantMoved,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kLoopVersionedForVectorization,
   kSelectGenerated,
   kRemovedInstanceOf,
   kInlinedInvokeVirtualOrInterface,
@@ -97,12 +105,20 @@ enum class MethodCompilationStat {
   kNotInlinedWont,
   kNotInlinedRecursiveBudget,
   kNotInlinedProxy,
+  kNotInlinedColdCallSite,
   kConstructorFenceGeneratedNew,
   kConstructorFenceGeneratedFinal,
   kConstructorFenceRemovedLSE,
   kConstructorFenceRemovedPFRA,
   kConstructorFenceRemovedCFRE,
+  kPartialEscapeMaterialization,
+  kRemovedThreadLocalMonitorOperation,
+  kMergedMonitorRegions,
+  kMergedMemoryBarriers,
   kBitstringTypeCheck,
+  kGraphColorRegisterAllocation,
+  kSpilledValuesLinearScan,
+  kSpilledValuesGraphColor,
   kJitOutOfMemoryForCommit,
   kLastStat
 };
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_OPTIMIZING_PASS_STATS_H_
+#define ART_COMPILER_OPTIMIZING_OPTIMIZING_PASS_STATS_H_
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <android-base/logging.h>
+
+#include "base/array_ref.h"
+#include "base/mutex.h"
+#include "thread.h"
+
+namespace art {
+
+// Wall time and arena memory of each optimizing compiler pass, aggregated over all the methods
+// compiled by one OptimizingCompiler, i.e. over a dex2oat run or a JIT session. Unlike
+// --dump-pass-timings, which logs a TimingLogger per method, this keeps only a few counters per
+// pass name so that it can stay enabled for a whole run. Enabled with --dump-pass-stats.
+class OptimizingPassStats {
+ public:
+  // Measurements of one pass run on one method.
+  struct Sample {
+    const char* pass_name;
+    uint64_t time_ns;
+    // Arena bytes in use (graph allocator plus peak of the arena stack) when the pass ended.
+    size_t peak_bytes;
+    // Growth of `peak_bytes` during the pass.
+    size_t bytes_delta;
+  };
+
+  OptimizingPassStats() : lock_("OptimizingPassStats lock") {}
+
+  // Merge the samples of one method compilation. Called once per method to keep the lock cold.
+  void AddSamples(ArrayRef<const Sample> samples) REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    for (const Sample& sample : samples) {
+      auto it = entries_.find(std::string_view(sample.pass_name));
+      if (it == entries_.end()) {
+        it = entries_.emplace(sample.pass_name, Entry()).first;
+      }
+      Entry& entry = it->second;
+      ++entry.runs;
+      entry.total_time_ns += sample.time_ns;
+      entry.max_time_ns = std::max(entry.max_time_ns, sample.time_ns);
+      entry.max_peak_bytes = std::max(entry.max_peak_bytes, sample.peak_bytes);
+      entry.total_bytes_delta += sample.bytes_delta;
+      entry.max_bytes_delta = std::max(entry.max_bytes_delta, sample.bytes_delta);
+    }
+  }
+
+  // Write the aggregated stats as CSV, one line per pass, sorted by the total time.
+  void Dump(std::ostream& os) REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    std::vector<std::pair<const std::string*, const Entry*>> sorted;
+    sorted.reserve(entries_.size());
+    for (const auto& it : entries_) {
+      sorted.emplace_back(&it.first, &it.second);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.second->total_time_ns > rhs.second->total_time_ns;
+    });
+    os << "pass,runs,total_time_ns,max_time_ns,"
+       << "max_peak_arena_bytes,total_arena_bytes_delta,max_arena_bytes_delta\n";
+    for (const auto& [name, entry] : sorted) {
+      os << *name << ',' << entry->runs << ',' << entry->total_time_ns << ','
+         << entry->max_time_ns << ',' << entry->max_peak_bytes << ','
+         << entry->total_bytes_delta << ',' << entry->max_bytes_delta << '\n';
+    }
+  }
+
+  // Log the CSV output of Dump() with a common prefix so that it can be extracted from logcat
+  // or the dex2oat log.
+  void Log() REQUIRES(!lock_) {
+    std::ostringstream oss;
+    Dump(oss);
+    std::istringstream iss(oss.str());
+    for (std::string line; std::getline(iss, line); ) {
+      LOG(INFO) << "PassStats#" << line;
+    }
+  }
+
+ private:
+  struct Entry {
+    uint64_t runs = 0u;
+    uint64_t total_time_ns = 0u;
+    uint64_t max_time_ns = 0u;
+    size_t max_peak_bytes = 0u;
+    uint64_t total_bytes_delta = 0u;
+    size_t max_bytes_delta = 0u;
+  };
+
+  Mutex lock_;
+  std::map<std::string, Entry, std::less<>> entries_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(OptimizingPassStats);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_OPTIMIZING_PASS_STATS_H_
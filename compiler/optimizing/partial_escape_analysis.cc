@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_escape_analysis.h"
+
+#include <algorithm>
+
+#include "base/arena_bit_vector.h"
+#include "base/bit_vector-inl.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "nodes.h"
+
+namespace art {
+
+// Whether `user` lets `reference` escape in a way we can handle by passing a
+// materialized copy of `reference` instead.
+static bool IsMaterializableEscape(HInstruction* reference, HInstruction* user) {
+  return user->IsInvoke() ||
+         user->IsReturn() ||
+         (user->IsInstanceFieldSet() && user->InputAt(1) == reference) ||
+         (user->IsStaticFieldSet() && user->InputAt(1) == reference) ||
+         (user->IsArraySet() && user->InputAt(2) == reference);
+}
+
+bool PartialEscapeAnalysis::Run() {
+  // Materializing changes the identity of the object at the escape, which the debugger
+  // could observe. We also don't want to deal with catch phis.
+  if (graph_->IsDebuggable() || graph_->HasTryCatch() || graph_->GetExitBlock() == nullptr) {
+    return false;
+  }
+
+  // Local allocator to discard data structures created below at the end of this optimization.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+
+  ScopedArenaVector<HNewInstance*> candidates(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (it.Current()->IsNewInstance()) {
+        candidates.push_back(it.Current()->AsNewInstance());
+      }
+    }
+  }
+
+  bool changed = false;
+  for (HNewInstance* new_instance : candidates) {
+    if (TryMaterializeAtEscapes(new_instance, &allocator)) {
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+bool PartialEscapeAnalysis::TryMaterializeAtEscapes(HNewInstance* new_instance,
+                                                    ScopedArenaAllocator* allocator) {
+  // Finalizable objects always escape, and an allocation that needs checks cannot be
+  // removed by load-store elimination.
+  if (new_instance->IsFinalizable() || new_instance->NeedsChecks()) {
+    return false;
+  }
+
+  ScopedArenaVector<HInstruction*> escapes(allocator->Adapter(kArenaAllocMisc));
+  ScopedArenaVector<HInstanceFieldSet*> field_sets(allocator->Adapter(kArenaAllocMisc));
+  ArenaBitVector use_blocks(allocator, graph_->GetBlocks().size(), /* expandable= */ false);
+  use_blocks.ClearAllBits();
+  for (const HUseListNode<HInstruction*>& use : new_instance->GetUses()) {
+    HInstruction* user = use.GetUser();
+    use_blocks.SetBit(user->GetBlock()->GetBlockId());
+    if (user->IsInstanceFieldGet()) {
+      if (user->AsInstanceFieldGet()->IsVolatile()) {
+        return false;
+      }
+    } else if (user->IsInstanceFieldSet() && user->InputAt(1) != new_instance) {
+      HInstanceFieldSet* field_set = user->AsInstanceFieldSet();
+      if (field_set->IsVolatile()) {
+        return false;
+      }
+      MemberOffset offset = field_set->GetFieldOffset();
+      if (std::none_of(field_sets.begin(),
+                       field_sets.end(),
+                       [offset](HInstanceFieldSet* other) {
+                         return other->GetFieldOffset().Uint32Value() == offset.Uint32Value();
+                       })) {
+        field_sets.push_back(field_set);
+      }
+    } else if (user->IsConstructorFence()) {
+      // Removed by load-store elimination together with the allocation.
+    } else if (IsMaterializableEscape(new_instance, user)) {
+      if (std::find(escapes.begin(), escapes.end(), user) == escapes.end()) {
+        escapes.push_back(user);
+      }
+    } else {
+      // Phis, selects, bound types, null checks, type checks, comparisons, monitors and
+      // unresolved accesses observe the object itself.
+      return false;
+    }
+  }
+  if (escapes.empty() || escapes.size() > kMaximumNumberOfMaterializations) {
+    return false;
+  }
+  for (const HUseListNode<HEnvironment*>& use : new_instance->GetEnvUses()) {
+    if (use.GetUser()->GetHolder()->IsDeoptimize()) {
+      // The interpreter would see the original object after deoptimization.
+      return false;
+    }
+  }
+
+  ArenaBitVector escape_blocks(allocator, graph_->GetBlocks().size(), /* expandable= */ false);
+  escape_blocks.ClearAllBits();
+  for (HInstruction* escape : escapes) {
+    if (escape->GetBlock() == new_instance->GetBlock()) {
+      // The escape is on every path out of the allocation.
+      return false;
+    }
+    escape_blocks.SetBit(escape->GetBlock()->GetBlockId());
+  }
+  for (HInstruction* escape : escapes) {
+    if (!IsLastUse(new_instance, escape, use_blocks, allocator)) {
+      return false;
+    }
+  }
+  if (!HasPathToExitWithoutEscape(new_instance, escape_blocks, allocator)) {
+    return false;
+  }
+
+  for (HInstruction* escape : escapes) {
+    Materialize(new_instance, escape, field_sets);
+    MaybeRecordStat(stats_, MethodCompilationStat::kPartialEscapeMaterialization);
+  }
+  return true;
+}
+
+bool PartialEscapeAnalysis::IsLastUse(HNewInstance* new_instance,
+                                      HInstruction* escape,
+                                      const ArenaBitVector& use_blocks,
+                                      ScopedArenaAllocator* allocator) {
+  HBasicBlock* escape_block = escape->GetBlock();
+  for (const HUseListNode<HInstruction*>& use : new_instance->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (user != escape && user->GetBlock() == escape_block && escape->StrictlyDominates(user)) {
+      return false;
+    }
+  }
+
+  ArenaBitVector visited(allocator, graph_->GetBlocks().size(), /* expandable= */ false);
+  visited.ClearAllBits();
+  ScopedArenaVector<HBasicBlock*> worklist(allocator->Adapter(kArenaAllocMisc));
+  worklist.insert(worklist.end(),
+                  escape_block->GetSuccessors().begin(),
+                  escape_block->GetSuccessors().end());
+  while (!worklist.empty()) {
+    HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    if (visited.IsBitSet(block->GetBlockId())) {
+      continue;
+    }
+    visited.SetBit(block->GetBlockId());
+    if (block == new_instance->GetBlock()) {
+      // Uses past this point are for a new allocation.
+      continue;
+    }
+    if (block == escape_block || use_blocks.IsBitSet(block->GetBlockId())) {
+      return false;
+    }
+    worklist.insert(worklist.end(), block->GetSuccessors().begin(), block->GetSuccessors().end());
+  }
+  return true;
+}
+
+bool PartialEscapeAnalysis::HasPathToExitWithoutEscape(HNewInstance* new_instance,
+                                                       const ArenaBitVector& escape_blocks,
+                                                       ScopedArenaAllocator* allocator) {
+  ArenaBitVector visited(allocator, graph_->GetBlocks().size(), /* expandable= */ false);
+  visited.ClearAllBits();
+  visited.SetBit(new_instance->GetBlock()->GetBlockId());
+  ScopedArenaVector<HBasicBlock*> worklist(allocator->Adapter(kArenaAllocMisc));
+  worklist.insert(worklist.end(),
+                  new_instance->GetBlock()->GetSuccessors().begin(),
+                  new_instance->GetBlock()->GetSuccessors().end());
+  while (!worklist.empty()) {
+    HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    if (visited.IsBitSet(block->GetBlockId())) {
+      continue;
+    }
+    visited.SetBit(block->GetBlockId());
+    if (escape_blocks.IsBitSet(block->GetBlockId())) {
+      continue;
+    }
+    if (block->IsExitBlock()) {
+      return true;
+    }
+    worklist.insert(worklist.end(), block->GetSuccessors().begin(), block->GetSuccessors().end());
+  }
+  return false;
+}
+
+void PartialEscapeAnalysis::Materialize(HNewInstance* new_instance,
+                                        HInstruction* escape,
+                                        const ScopedArenaVector<HInstanceFieldSet*>& field_sets) {
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  HBasicBlock* block = escape->GetBlock();
+  uint32_t dex_pc = escape->GetDexPc();
+
+  HNewInstance* materialized = new (allocator) HNewInstance(new_instance->InputAt(0),
+                                                            new_instance->GetDexPc(),
+                                                            new_instance->GetTypeIndex(),
+                                                            new_instance->GetDexFile(),
+                                                            /* finalizable= */ false,
+                                                            new_instance->GetEntrypoint());
+  materialized->SetReferenceTypeInfo(new_instance->GetReferenceTypeInfo());
+  block->InsertInstructionBefore(materialized, escape);
+  if (new_instance->HasEnvironment()) {
+    // Report an out of memory error at the original allocation site.
+    materialized->CopyEnvironmentFrom(new_instance->GetEnvironment());
+  }
+
+  // Copy the current values of the fields. Load-store elimination replaces the loads from
+  // `new_instance` by the values stored on each path.
+  for (HInstanceFieldSet* field_set : field_sets) {
+    const FieldInfo& info = field_set->GetFieldInfo();
+    HInstanceFieldGet* get = new (allocator) HInstanceFieldGet(new_instance,
+                                                               info.GetField(),
+                                                               info.GetFieldType(),
+                                                               info.GetFieldOffset(),
+                                                               /* is_volatile= */ false,
+                                                               info.GetFieldIndex(),
+                                                               info.GetDeclaringClassDefIndex(),
+                                                               info.GetDexFile(),
+                                                               dex_pc);
+    if (get->GetType() == DataType::Type::kReference) {
+      get->SetReferenceTypeInfo(graph_->GetInexactObjectRti());
+    }
+    block->InsertInstructionBefore(get, escape);
+    HInstanceFieldSet* set = new (allocator) HInstanceFieldSet(materialized,
+                                                               get,
+                                                               info.GetField(),
+                                                               info.GetFieldType(),
+                                                               info.GetFieldOffset(),
+                                                               /* is_volatile= */ false,
+                                                               info.GetFieldIndex(),
+                                                               info.GetDeclaringClassDefIndex(),
+                                                               info.GetDexFile(),
+                                                               dex_pc);
+    block->InsertInstructionBefore(set, escape);
+  }
+  // The copy is published by `escape`, so it needs the same fence as a constructed object.
+  block->InsertInstructionBefore(
+      new (allocator) HConstructorFence(materialized, dex_pc, allocator), escape);
+
+  for (size_t i = 0, e = escape->InputCount(); i < e; ++i) {
+    if (escape->InputAt(i) == new_instance) {
+      escape->ReplaceInput(materialized, i);
+    }
+  }
+
+  // Environments at and after the escape now refer to the copy.
+  ScopedArenaAllocator local_allocator(graph_->GetArenaStack());
+  ScopedArenaVector<std::pair<HEnvironment*, size_t>> env_uses(
+      local_allocator.Adapter(kArenaAllocMisc));
+  for (const HUseListNode<HEnvironment*>& use : new_instance->GetEnvUses()) {
+    HInstruction* holder = use.GetUser()->GetHolder();
+    if (holder == escape || escape->StrictlyDominates(holder)) {
+      env_uses.emplace_back(use.GetUser(), use.GetIndex());
+    }
+  }
+  for (const std::pair<HEnvironment*, size_t>& use : env_uses) {
+    use.first->ReplaceInput(materialized, use.second);
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_ANALYSIS_H_
+#define ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_ANALYSIS_H_
+
+#include "base/scoped_arena_containers.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+class ArenaBitVector;
+
+/**
+ * Optimization pass to materialize allocations only on the paths where they escape.
+ *
+ * An allocation that is only read and written through its fields, except at a few
+ * escape points (invokes, stores to the heap, returns) that are each the last use of the
+ * allocation on their path, is copied into a new allocation right before each escape
+ * point. The original allocation then no longer escapes, so that load-store elimination
+ * replaces its fields by their values and removes it, and the paths that do not escape
+ * do not allocate anymore.
+ *
+ * For example:
+ *   Point p = new Point();                  Point p = <virtual>;
+ *   p.x = a;                                p.x = a;
+ *   if (cold) {                      =>     if (cold) {
+ *     log(p);                                 Point m = new Point(); m.x = p.x; log(m);
+ *     return 0;                               return 0;
+ *   }                                       }
+ *   return p.x;                             return p.x;
+ *
+ * This pass must run before load-store elimination.
+ */
+class PartialEscapeAnalysis : public HOptimization {
+ public:
+  PartialEscapeAnalysis(HGraph* graph,
+                        OptimizingCompilerStats* stats,
+                        const char* name = kPartialEscapeAnalysisPassName)
+      : HOptimization(graph, name, stats) {}
+
+  bool Run() override;
+
+  static constexpr const char* kPartialEscapeAnalysisPassName = "partial_escape_analysis";
+
+ private:
+  // Maximum number of escape points an allocation is materialized at.
+  static constexpr size_t kMaximumNumberOfMaterializations = 4;
+
+  // Try to replace the escapes of `new_instance` by materialized copies.
+  bool TryMaterializeAtEscapes(HNewInstance* new_instance, ScopedArenaAllocator* allocator);
+
+  // Return whether no other use of `new_instance` is reachable from `escape`, without
+  // going through the definition of `new_instance` again.
+  bool IsLastUse(HNewInstance* new_instance,
+                 HInstruction* escape,
+                 const ArenaBitVector& use_blocks,
+                 ScopedArenaAllocator* allocator);
+
+  // Return whether the exit can be reached from `new_instance` without going through a
+  // block in `escape_blocks`, which is what makes the transformation worthwhile.
+  bool HasPathToExitWithoutEscape(HNewInstance* new_instance,
+                                  const ArenaBitVector& escape_blocks,
+                                  ScopedArenaAllocator* allocator);
+
+  // Create a copy of `new_instance` right before `escape`, with the fields set by
+  // `field_sets`, and make `escape` and the environments it dominates use the copy.
+  void Materialize(HNewInstance* new_instance,
+                   HInstruction* escape,
+                   const ScopedArenaVector<HInstanceFieldSet*>& field_sets);
+
+  DISALLOW_COPY_AND_ASSIGN(PartialEscapeAnalysis);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_ANALYSIS_H_
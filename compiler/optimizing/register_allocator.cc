@@ -29,6 +29,14 @@
 
 namespace art {
 
+// Graph coloring takes more compile time than linear scan, so the profile guided strategy
+// only uses it for methods with at most that many SSA values.
+static constexpr size_t kMaximumNumberOfSsaValuesForGraphColor = 2000;
+
+// A loop has a high register pressure if the values live at its header leave fewer than
+// that many registers of a kind for the loop body.
+static constexpr size_t kMinimumNumberOfFreeRegistersInLoop = 4;
+
 RegisterAllocator::RegisterAllocator(ScopedArenaAllocator* allocator,
                                      CodeGenerator* codegen,
                                      const SsaLivenessAnalysis& liveness)
@@ -53,6 +61,81 @@ std::unique_ptr<RegisterAllocator> RegisterAllocator::Create(ScopedArenaAllocato
   }
 }
 
+RegisterAllocator::Strategy RegisterAllocator::SelectStrategy(Strategy strategy,
+                                                             CodeGenerator* codegen,
+                                                             const SsaLivenessAnalysis& liveness,
+                                                             bool is_hot_method) {
+  if (strategy != kRegisterAllocatorProfileGuided) {
+    return strategy;
+  }
+  HGraph* graph = codegen->GetGraph();
+  if (!is_hot_method ||
+      !graph->HasLoops() ||
+      liveness.GetNumberOfSsaValues() > kMaximumNumberOfSsaValuesForGraphColor) {
+    return kRegisterAllocatorLinearScan;
+  }
+
+  codegen->SetupBlockedRegisters();
+  size_t available_core_registers = 0;
+  for (size_t i = 0, e = codegen->GetNumberOfCoreRegisters(); i < e; ++i) {
+    if (!codegen->IsBlockedCoreRegister(i)) {
+      ++available_core_registers;
+    }
+  }
+  size_t available_fp_registers = 0;
+  for (size_t i = 0, e = codegen->GetNumberOfFloatingPointRegisters(); i < e; ++i) {
+    if (!codegen->IsBlockedFloatingPointRegister(i)) {
+      ++available_fp_registers;
+    }
+  }
+
+  // Linear scan spills inside the loop body when the values live across the loop take
+  // most of the registers. This is where graph coloring makes a difference.
+  bool needs_register_pairs = !Is64BitInstructionSet(codegen->GetInstructionSet());
+  for (HBasicBlock* block : graph->GetLinearOrder()) {
+    if (!block->IsLoopHeader()) {
+      continue;
+    }
+    size_t live_core_registers = 0;
+    size_t live_fp_registers = 0;
+    auto count_value = [&](HInstruction* instruction) {
+      DataType::Type type = instruction->GetType();
+      size_t registers = (needs_register_pairs && DataType::Is64BitType(type)) ? 2u : 1u;
+      if (DataType::IsFloatingPointType(type)) {
+        live_fp_registers += registers;
+      } else {
+        live_core_registers += registers;
+      }
+    };
+    for (uint32_t index : liveness.GetLiveInSet(*block)->Indexes()) {
+      count_value(liveness.GetInstructionFromSsaIndex(index));
+    }
+    for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+      count_value(it.Current());
+    }
+    if (live_core_registers + kMinimumNumberOfFreeRegistersInLoop > available_core_registers ||
+        live_fp_registers + kMinimumNumberOfFreeRegistersInLoop > available_fp_registers) {
+      return kRegisterAllocatorGraphColor;
+    }
+  }
+  return kRegisterAllocatorLinearScan;
+}
+
+size_t RegisterAllocator::CountSpilledValues(const SsaLivenessAnalysis& liveness) {
+  size_t count = 0;
+  for (size_t i = 0, e = liveness.GetNumberOfSsaValues(); i < e; ++i) {
+    HInstruction* instruction = liveness.GetInstructionFromSsaIndex(i);
+    // Parameters and the current method live in the caller's frame or in a reserved slot.
+    if (instruction->IsParameterValue() || instruction->IsCurrentMethod()) {
+      continue;
+    }
+    if (instruction->GetLiveInterval()->HasSpillSlot()) {
+      ++count;
+    }
+  }
+  return count;
+}
+
 RegisterAllocator::~RegisterAllocator() {
   if (kIsDebugBuild) {
     // Poison live interval pointers with "Error: BAD 71ve1nt3rval."
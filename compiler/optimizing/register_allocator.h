@@ -40,7 +40,11 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
  public:
   enum Strategy {
     kRegisterAllocatorLinearScan,
-    kRegisterAllocatorGraphColor
+    kRegisterAllocatorGraphColor,
+    // Graph coloring for hot methods with loops under high register pressure, and linear
+    // scan for everything else. Resolved per method by `SelectStrategy`. Opt-in with
+    // --register-allocation-strategy=profile-guided.
+    kRegisterAllocatorProfileGuided
   };
 
   static constexpr Strategy kRegisterAllocatorDefault = kRegisterAllocatorLinearScan;
@@ -50,6 +54,16 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
                                                    const SsaLivenessAnalysis& analysis,
                                                    Strategy strategy = kRegisterAllocatorDefault);
 
+  // Resolve kRegisterAllocatorProfileGuided to the strategy to use for the graph of `codegen`,
+  // whose liveness `analysis` has been computed. Other strategies are returned unchanged.
+  static Strategy SelectStrategy(Strategy strategy,
+                                 CodeGenerator* codegen,
+                                 const SsaLivenessAnalysis& analysis,
+                                 bool is_hot_method);
+
+  // Returns the number of values the register allocator had to give a spill slot.
+  static size_t CountSpilledValues(const SsaLivenessAnalysis& analysis);
+
   virtual ~RegisterAllocator();
 
   // Main entry point for the register allocator. Given the liveness analysis,
@@ -48,6 +48,13 @@ static constexpr size_t kSingleJumpBlockWeightMultiplier = 2;
 // be executed on every path through the method.
 static constexpr size_t kDominatesExitBlockWeightMultiplier = 2;
 
+// To improve compile time, we do not try to coalesce two uncolored nodes whose combined
+// degree exceeds that multiple of the number of registers. ARM64 has enough caller-save
+// core and FP registers that the conservative coalescing test still often succeeds for
+// higher degrees, so a larger cap removes more moves from hot loops there.
+static constexpr size_t kCoalesceDegreeCapMultiplier = 2;
+static constexpr size_t kCoalesceDegreeCapMultiplierArm64 = 3;
+
 enum class CoalesceKind {
   kAdjacentSibling,       // Prevents moves at interval split points.
   kFixedOutputSibling,    // Prevents moves from a fixed output location.
@@ -438,6 +445,11 @@ class ColoringIteration {
           allocator_(allocator),
           processing_core_regs_(processing_core_regs),
           num_regs_(num_regs),
+          max_coalesce_degree_(
+              num_regs *
+              (register_allocator->codegen_->GetInstructionSet() == InstructionSet::kArm64
+                   ? kCoalesceDegreeCapMultiplierArm64
+                   : kCoalesceDegreeCapMultiplier)),
           interval_node_map_(allocator->Adapter(kArenaAllocRegisterAllocator)),
           prunable_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
           pruned_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
@@ -527,6 +539,9 @@ class ColoringIteration {
 
   const size_t num_regs_;
 
+  // The maximum combined degree of two uncolored nodes we try to coalesce.
+  const size_t max_coalesce_degree_;
+
   // A map from live intervals to interference nodes.
   ScopedArenaHashMap<LiveInterval*, InterferenceNode*> interval_node_map_;
 
@@ -834,8 +849,9 @@ void RegisterAllocatorGraphColor::ProcessInstruction(HInstruction* instruction)
 
   LiveInterval* interval = instruction->GetLiveInterval();
   if (interval == nullptr) {
-    // Instructions lacking a valid output location do not have a live interval.
-    DCHECK(!locations->Out().IsValid());
+    // Instructions lacking a valid output location do not have a live interval, nor do
+    // instructions defining a predicate register, which is fixed by the code generator.
+    DCHECK(!locations->Out().IsValid() || locations->Out().IsPredicateRegister());
     return;
   }
 
@@ -1170,6 +1186,10 @@ static bool CheckInputOutputCanOverlap(InterferenceNode* in_node, InterferenceNo
 
   HInputsRef inputs = defined_by->GetInputs();
   for (size_t i = 0; i < inputs.size(); ++i) {
+    if (locations->InAt(i).IsPredicateRegister()) {
+      // Not allocated, see SsaLivenessAnalysis::NumberInstructions.
+      continue;
+    }
     if (inputs[i]->GetLiveInterval()->GetSiblingAt(def_position) == input_interval) {
       DCHECK(input_interval->SameRegisterKind(*output_interval));
       return true;
@@ -1401,6 +1421,10 @@ void ColoringIteration::FindCoalesceOpportunities() {
       if (!locations->OutputCanOverlapWithInputs()) {
         HInputsRef inputs = defined_by->GetInputs();
         for (size_t i = 0; i < inputs.size(); ++i) {
+          if (locations->InAt(i).IsPredicateRegister()) {
+            // Not allocated, see SsaLivenessAnalysis::NumberInstructions.
+            continue;
+          }
           size_t def_point = defined_by->GetLifetimePosition();
           // TODO: Getting the sibling at the def_point might not be quite what we want
           //       for fixed inputs, since the use will be *at* the def_point rather than after.
@@ -1646,9 +1670,8 @@ bool ColoringIteration::UncoloredHeuristic(InterferenceNode* from,
     return false;
   }
 
-  // Arbitrary cap to improve compile time. Tests show that this has negligible affect
-  // on generated code.
-  if (from->GetOutDegree() + into->GetOutDegree() > 2 * num_regs_) {
+  // Cap to improve compile time, see kCoalesceDegreeCapMultiplier.
+  if (from->GetOutDegree() + into->GetOutDegree() > max_coalesce_degree_) {
     return false;
   }
 
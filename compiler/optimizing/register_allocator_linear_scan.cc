@@ -637,7 +637,8 @@ bool RegisterAllocatorLinearScan::TryAllocateFreeReg(LiveInterval* current) {
     if (!locations->OutputCanOverlapWithInputs() && locations->Out().IsUnallocated()) {
       HInputsRef inputs = defined_by->GetInputs();
       for (size_t i = 0; i < inputs.size(); ++i) {
-        if (locations->InAt(i).IsValid()) {
+        // Predicate registers are not allocated, see SsaLivenessAnalysis::NumberInstructions.
+        if (locations->InAt(i).IsValid() && !locations->InAt(i).IsPredicateRegister()) {
           // Take the last interval of the input. It is the location of that interval
           // that will be used at `defined_by`.
           LiveInterval* interval = inputs[i]->GetLiveInterval()->GetLastSibling();
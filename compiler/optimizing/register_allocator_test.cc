@@ -239,6 +239,88 @@ void RegisterAllocatorTest::Loop1(Strategy strategy) {
 
 TEST_ALL_STRATEGIES(Loop1);
 
+TEST_F(RegisterAllocatorTest, ProfileGuidedStrategy) {
+  // Same graph as Loop1: a loop with a single live value.
+  const std::vector<uint16_t> data = TWO_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQ, 4,
+    Instruction::CONST_4 | 4 << 12 | 0,
+    Instruction::GOTO | 0xFD00,
+    Instruction::CONST_4 | 5 << 12 | 1 << 8,
+    Instruction::RETURN | 1 << 8);
+
+  HGraph* graph = CreateCFG(data);
+  x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+  liveness.Analyze();
+
+  // Explicit strategies are kept.
+  ASSERT_EQ(Strategy::kRegisterAllocatorGraphColor,
+            RegisterAllocator::SelectStrategy(
+                Strategy::kRegisterAllocatorGraphColor, &codegen, liveness, false));
+  // Cold methods, and hot methods without register pressure, use linear scan.
+  ASSERT_EQ(Strategy::kRegisterAllocatorLinearScan,
+            RegisterAllocator::SelectStrategy(
+                Strategy::kRegisterAllocatorProfileGuided, &codegen, liveness, false));
+  Strategy strategy = RegisterAllocator::SelectStrategy(
+      Strategy::kRegisterAllocatorProfileGuided, &codegen, liveness, true);
+  ASSERT_EQ(Strategy::kRegisterAllocatorLinearScan, strategy);
+
+  std::unique_ptr<RegisterAllocator> register_allocator =
+      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness, strategy);
+  register_allocator->AllocateRegisters();
+  ASSERT_TRUE(register_allocator->Validate(false));
+  ASSERT_EQ(0u, RegisterAllocator::CountSpilledValues(liveness));
+}
+
+TEST_F(RegisterAllocatorTest, ProfileGuidedStrategyHighPressure) {
+  /*
+   * Test the following snippet:
+   *  int a = 1, b = 2, c = 3, d = 4, e = 5, f = 6;
+   *  while (a != b) {
+   *    a += b;
+   *  }
+   *  return a + b + c + d + e + f;
+   *
+   * The loop phi and the five constants are live at the loop header, which leaves fewer
+   * than four of the seven x86 core registers for the loop body.
+   */
+  const std::vector<uint16_t> data = SIX_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 1 << 12 | 0 << 8,
+    Instruction::CONST_4 | 2 << 12 | 1 << 8,
+    Instruction::CONST_4 | 3 << 12 | 2 << 8,
+    Instruction::CONST_4 | 4 << 12 | 3 << 8,
+    Instruction::CONST_4 | 5 << 12 | 4 << 8,
+    Instruction::CONST_4 | 6 << 12 | 5 << 8,
+    Instruction::IF_EQ | 1 << 12 | 0 << 8, 4,
+    Instruction::ADD_INT_2ADDR | 1 << 12 | 0 << 8,
+    Instruction::GOTO | 0xFD00,
+    Instruction::ADD_INT_2ADDR | 1 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 2 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 3 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 4 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 5 << 12 | 0 << 8,
+    Instruction::RETURN | 0 << 8);
+
+  HGraph* graph = CreateCFG(data);
+  x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+  liveness.Analyze();
+
+  // Cold methods use linear scan whatever the register pressure.
+  ASSERT_EQ(Strategy::kRegisterAllocatorLinearScan,
+            RegisterAllocator::SelectStrategy(
+                Strategy::kRegisterAllocatorProfileGuided, &codegen, liveness, false));
+  Strategy strategy = RegisterAllocator::SelectStrategy(
+      Strategy::kRegisterAllocatorProfileGuided, &codegen, liveness, true);
+  ASSERT_EQ(Strategy::kRegisterAllocatorGraphColor, strategy);
+
+  std::unique_ptr<RegisterAllocator> register_allocator =
+      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness, strategy);
+  register_allocator->AllocateRegisters();
+  ASSERT_TRUE(register_allocator->Validate(false));
+}
+
 void RegisterAllocatorTest::Loop2(Strategy strategy) {
   /*
    * Test the following snippet:
@@ -34,6 +34,10 @@
 #include "scheduler_arm.h"
 #endif
 
+#ifdef ART_ENABLE_CODEGEN_x86_64
+#include "scheduler_x86_64.h"
+#endif
+
 namespace art {
 
 // Return all combinations of ISA and code generator that are executable on
@@ -400,6 +404,42 @@ TEST_F(SchedulerTest, ArrayAccessAliasingARM64) {
   arm64::HSchedulerARM64 scheduler(&critical_path_selector);
   TestDependencyGraphOnAliasingArrayAccesses(&scheduler);
 }
+
+TEST_F(SchedulerTest, DependencyGraphAndSchedulerARM64OutOfOrder) {
+  CriticalPathSchedulingNodeSelector critical_path_selector;
+  arm64::HSchedulerARM64 scheduler(&critical_path_selector, arm64::kArm64OutOfOrderLatencies);
+  TestBuildDependencyGraphAndSchedule(&scheduler);
+}
+
+TEST_F(SchedulerTest, LatencyModelSelectionARM64) {
+  std::string error_msg;
+  std::unique_ptr<const InstructionSetFeatures> a53_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kArm64, "cortex-a53", &error_msg));
+  ASSERT_TRUE(a53_features.get() != nullptr) << error_msg;
+  std::unique_ptr<const InstructionSetFeatures> a76_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kArm64, "cortex-a76", &error_msg));
+  ASSERT_TRUE(a76_features.get() != nullptr) << error_msg;
+
+  EXPECT_EQ(&arm64::kArm64InOrderLatencies, &arm64::GetSchedulingLatenciesARM64(nullptr));
+  EXPECT_EQ(&arm64::kArm64InOrderLatencies,
+            &arm64::GetSchedulingLatenciesARM64(a53_features.get()));
+  EXPECT_EQ(&arm64::kArm64OutOfOrderLatencies,
+            &arm64::GetSchedulingLatenciesARM64(a76_features.get()));
+}
+#endif
+
+#if defined(ART_ENABLE_CODEGEN_x86_64)
+TEST_F(SchedulerTest, DependencyGraphAndSchedulerX86_64) {
+  CriticalPathSchedulingNodeSelector critical_path_selector;
+  x86_64::HSchedulerX86_64 scheduler(&critical_path_selector);
+  TestBuildDependencyGraphAndSchedule(&scheduler);
+}
+
+TEST_F(SchedulerTest, ArrayAccessAliasingX86_64) {
+  CriticalPathSchedulingNodeSelector critical_path_selector;
+  x86_64::HSchedulerX86_64 scheduler(&critical_path_selector);
+  TestDependencyGraphOnAliasingArrayAccesses(&scheduler);
+}
 #endif
 
 #if defined(ART_ENABLE_CODEGEN_arm)
@@ -18,6 +18,7 @@
 
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
+#include "driver/compiler_options.h"
 #include "linear_order.h"
 #include "nodes.h"
 
@@ -26,13 +27,23 @@ namespace art {
 void SsaLivenessAnalysis::Analyze() {
   // Compute the linear order directly in the graph's data structure
   // (there are no more following graph mutations).
-  LinearizeGraph(graph_, &graph_->linear_order_);
+  LinearizeGraph(graph_,
+                 &graph_->linear_order_,
+                 codegen_->GetCompilerOptions().GetSplitColdCode());
 
   // Liveness analysis.
   NumberInstructions();
   ComputeLiveness();
 }
 
+// Returns whether the output of an instruction is allocated by the register allocator.
+// Predicate registers are fixed by the code generator, see Location::PredicateRegisterLocation.
+static bool HasAllocatableOutput(LocationSummary* locations) {
+  return locations != nullptr &&
+      locations->Out().IsValid() &&
+      !locations->Out().IsPredicateRegister();
+}
+
 void SsaLivenessAnalysis::NumberInstructions() {
   int ssa_index = 0;
   size_t lifetime_position = 0;
@@ -51,8 +62,7 @@ void SsaLivenessAnalysis::NumberInstructions() {
     for (HInstructionIterator inst_it(block->GetPhis()); !inst_it.Done(); inst_it.Advance()) {
       HInstruction* current = inst_it.Current();
       codegen_->AllocateLocations(current);
-      LocationSummary* locations = current->GetLocations();
-      if (locations != nullptr && locations->Out().IsValid()) {
+      if (HasAllocatableOutput(current->GetLocations())) {
         instructions_from_ssa_index_.push_back(current);
         current->SetSsaIndex(ssa_index++);
         current->SetLiveInterval(
@@ -69,8 +79,7 @@ void SsaLivenessAnalysis::NumberInstructions() {
          inst_it.Advance()) {
       HInstruction* current = inst_it.Current();
       codegen_->AllocateLocations(current);
-      LocationSummary* locations = current->GetLocations();
-      if (locations != nullptr && locations->Out().IsValid()) {
+      if (HasAllocatableOutput(current->GetLocations())) {
         instructions_from_ssa_index_.push_back(current);
         current->SetSsaIndex(ssa_index++);
         current->SetLiveInterval(
@@ -109,7 +118,14 @@ void SsaLivenessAnalysis::RecursivelyProcessInputs(HInstruction* current,
   HInputsRef inputs = current->GetInputs();
   for (size_t i = 0; i < inputs.size(); ++i) {
     HInstruction* input = inputs[i];
-    bool has_in_location = current->GetLocations()->InAt(i).IsValid();
+    Location in_location = current->GetLocations()->InAt(i);
+    if (in_location.IsPredicateRegister()) {
+      // `input` has no live interval and sets the predicate register itself.
+      DCHECK(in_location.Equals(input->GetLocations()->Out()));
+      DCHECK(!input->HasSsaIndex());
+      continue;
+    }
+    bool has_in_location = in_location.IsValid();
     bool has_out_location = input->GetLocations()->Out().IsValid();
 
     if (has_in_location) {
@@ -768,4 +768,55 @@ TEST(StackMapTest, TestDedupeBitTables) {
   ASSERT_GT(memory.size() * 2, out.size());
 }
 
+TEST(StackMapTest, TestDedupeBitTablesWithDictionary) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+
+  // Two methods with the same dex register locations, but in a different catalogue order,
+  // so that only the shared dictionary can deduplicate them.
+  StackMapStream stream1(&allocator, kRuntimeISA);
+  stream1.BeginMethod(32, 0, 0, 2);
+  stream1.BeginStackMapEntry(0, 64 * kPcAlign);
+  stream1.AddDexRegisterEntry(Kind::kInStack, 0);
+  stream1.AddDexRegisterEntry(Kind::kConstant, -2);
+  stream1.EndStackMapEntry();
+  stream1.EndMethod();
+  ScopedArenaVector<uint8_t> memory1 = stream1.Encode();
+
+  StackMapStream stream2(&allocator, kRuntimeISA);
+  stream2.BeginMethod(32, 0, 0, 2);
+  stream2.BeginStackMapEntry(0, 32 * kPcAlign);
+  stream2.AddDexRegisterEntry(Kind::kConstant, -2);
+  stream2.AddDexRegisterEntry(Kind::kInStack, 0);
+  stream2.EndStackMapEntry();
+  stream2.EndMethod();
+  ScopedArenaVector<uint8_t> memory2 = stream2.Encode();
+
+  std::vector<uint8_t> out;
+  CodeInfo::Deduper deduper(&out);
+  deduper.AddToDictionary(memory1.data());
+  deduper.AddToDictionary(memory2.data());
+  size_t deduped1 = deduper.Dedupe(memory1.data());
+  size_t deduped2 = deduper.Dedupe(memory2.data());
+
+  CodeInfo code_info1(out.data() + deduped1);
+  ASSERT_EQ(1u, code_info1.GetNumberOfStackMaps());
+  DexRegisterMap dex_register_map1 = code_info1.GetDexRegisterMapOf(code_info1.GetStackMapAt(0));
+  ASSERT_EQ(Kind::kInStack, dex_register_map1[0].GetKind());
+  ASSERT_EQ(Kind::kConstant, dex_register_map1[1].GetKind());
+  ASSERT_EQ(0, dex_register_map1[0].GetStackOffsetInBytes());
+  ASSERT_EQ(-2, dex_register_map1[1].GetConstant());
+
+  CodeInfo code_info2(out.data() + deduped2);
+  ASSERT_EQ(1u, code_info2.GetNumberOfStackMaps());
+  DexRegisterMap dex_register_map2 = code_info2.GetDexRegisterMapOf(code_info2.GetStackMapAt(0));
+  ASSERT_EQ(Kind::kConstant, dex_register_map2[0].GetKind());
+  ASSERT_EQ(Kind::kInStack, dex_register_map2[1].GetKind());
+  ASSERT_EQ(-2, dex_register_map2[0].GetConstant());
+  ASSERT_EQ(0, dex_register_map2[1].GetStackOffsetInBytes());
+
+  ASSERT_GT(memory1.size() + memory2.size(), out.size());
+}
+
 }  // namespace art
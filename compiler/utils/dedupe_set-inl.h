@@ -26,6 +26,7 @@
 
 #include "android-base/stringprintf.h"
 
+#include "base/bit_utils.h"
 #include "base/hash_set.h"
 #include "base/mutex.h"
 #include "base/stl_util.h"
@@ -37,28 +38,30 @@ template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-struct DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Stats {
+          typename HashFunc>
+struct DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::Stats {
   size_t collision_sum = 0u;
   size_t collision_max = 0u;
   size_t total_probe_distance = 0u;
   size_t total_size = 0u;
+  size_t hits = 0u;
+  size_t misses = 0u;
 };
 
 template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
+          typename HashFunc>
+class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::Shard {
  public:
   Shard(const Alloc& alloc, const std::string& lock_name)
       : alloc_(alloc),
         lock_name_(lock_name),
         lock_(lock_name_.c_str()),
-        keys_() {
+        keys_(),
+        hits_(0u),
+        misses_(0u) {
   }
 
   ~Shard() {
@@ -74,8 +77,10 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
     auto it = keys_.find(hashed_in_key);
     if (it != keys_.end()) {
       DCHECK(it->Key() != nullptr);
+      ++hits_;
       return it->Key();
     }
+    ++misses_;
     const StoreKey* store_key = alloc_.Copy(in_key);
     keys_.insert(HashedKey<StoreKey> { hash, store_key });
     return store_key;
@@ -91,6 +96,8 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
       // It may have been higher before a re-hash.
       global_stats->total_probe_distance += keys_.TotalProbeDistance();
       global_stats->total_size += keys_.size();
+      global_stats->hits += hits_;
+      global_stats->misses += misses_;
       for (const HashedKey<StoreKey>& key : keys_) {
         auto it = stats.find(key.Hash());
         if (it == stats.end()) {
@@ -178,15 +185,16 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
   const std::string lock_name_;
   Mutex lock_;
   HashSet<HashedKey<StoreKey>, ShardEmptyFn, ShardHashFn, ShardPred> keys_ GUARDED_BY(lock_);
+  size_t hits_ GUARDED_BY(lock_);
+  size_t misses_ GUARDED_BY(lock_);
 };
 
 template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Add(
+          typename HashFunc>
+const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::Add(
     Thread* self, const InKey& key) {
   uint64_t hash_start;
   if (kIsDebugBuild) {
@@ -195,10 +203,11 @@ const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::A
   HashType raw_hash = HashFunc()(key);
   if (kIsDebugBuild) {
     uint64_t hash_end = NanoTime();
-    hash_time_ += hash_end - hash_start;
+    hash_time_.fetch_add(hash_end - hash_start, std::memory_order_relaxed);
   }
-  HashType shard_hash = raw_hash / kShard;
-  HashType shard_bin = raw_hash % kShard;
+  // Use the low bits to select the shard and the remaining bits for the hash set in the shard.
+  HashType shard_hash = raw_hash >> shard_bits_;
+  HashType shard_bin = raw_hash & ((static_cast<HashType>(1) << shard_bits_) - 1u);
   return shards_[shard_bin]->Add(self, shard_hash, key);
 }
 
@@ -206,12 +215,15 @@ template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::DedupeSet(const char* set_name,
-                                                                         const Alloc& alloc)
-    : hash_time_(0) {
-  for (HashType i = 0; i < kShard; ++i) {
+          typename HashFunc>
+DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::DedupeSet(const char* set_name,
+                                                                 const Alloc& alloc,
+                                                                 size_t num_shards)
+    : shard_bits_(WhichPowerOf2(RoundUpToPowerOfTwo(std::max<size_t>(num_shards, 1u)))),
+      shards_(new std::unique_ptr<Shard>[static_cast<size_t>(1u) << shard_bits_]),
+      hash_time_(0) {
+  DCHECK_LT(shard_bits_, BitSizeOf<HashType>());
+  for (size_t i = 0, size = static_cast<size_t>(1u) << shard_bits_; i != size; ++i) {
     std::ostringstream oss;
     oss << set_name << " lock " << i;
     shards_[i].reset(new Shard(alloc, oss.str()));
@@ -222,9 +234,8 @@ template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::~DedupeSet() {
+          typename HashFunc>
+DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::~DedupeSet() {
   // Everything done by member destructors.
 }
 
@@ -232,21 +243,25 @@ template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-std::string DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::DumpStats(
+          typename HashFunc>
+std::string DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::DumpStats(
     Thread* self) const {
   Stats stats;
-  for (HashType shard = 0; shard < kShard; ++shard) {
+  size_t num_shards = static_cast<size_t>(1u) << shard_bits_;
+  for (size_t shard = 0; shard < num_shards; ++shard) {
     shards_[shard]->UpdateStats(self, &stats);
   }
-  return android::base::StringPrintf("%zu collisions, %zu max hash collisions, "
+  return android::base::StringPrintf("%zu hits, %zu misses, %zu shards, "
+                                     "%zu collisions, %zu max hash collisions, "
                                      "%zu/%zu probe distance, %" PRIu64 " ns hash time",
+                                     stats.hits,
+                                     stats.misses,
+                                     num_shards,
                                      stats.collision_sum,
                                      stats.collision_max,
                                      stats.total_probe_distance,
                                      stats.total_size,
-                                     hash_time_);
+                                     hash_time_.load(std::memory_order_relaxed));
 }
 
 
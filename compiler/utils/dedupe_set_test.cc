@@ -88,4 +88,26 @@ TEST(DedupeSetTest, Test) {
   }
 }
 
+TEST(DedupeSetTest, Sharded) {
+  Thread* self = Thread::Current();
+  DedupeSetTestAlloc alloc;
+  DedupeSet<ArrayRef<const uint8_t>,
+            std::vector<uint8_t>,
+            DedupeSetTestAlloc,
+            size_t,
+            DedupeSetTestHashFunc> deduplicator("test", alloc, /* num_shards= */ 5u);
+  std::vector<const std::vector<uint8_t>*> arrays;
+  for (uint8_t i = 0u; i != 64u; ++i) {
+    uint8_t raw_test[] = { i, 20u, 30u, 45u };
+    arrays.push_back(deduplicator.Add(self, ArrayRef<const uint8_t>(raw_test)));
+    ASSERT_NE(arrays.back(), nullptr);
+  }
+  for (uint8_t i = 0u; i != 64u; ++i) {
+    uint8_t raw_test[] = { i, 20u, 30u, 45u };
+    ASSERT_EQ(arrays[i], deduplicator.Add(self, ArrayRef<const uint8_t>(raw_test)));
+  }
+  std::string stats = deduplicator.DumpStats(self);
+  EXPECT_NE(stats.find("64 hits, 64 misses, 8 shards"), std::string::npos) << stats;
+}
+
 }  // namespace art
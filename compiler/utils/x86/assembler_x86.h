@@ -724,6 +724,7 @@ class X86Assembler final : public Assembler {
   void cdq();
 
   void idivl(Register reg);
+  void divl(Register reg);
 
   void imull(Register dst, Register src);
   void imull(Register reg, const Immediate& imm);
@@ -3472,6 +3472,15 @@ void X86_64Assembler::pcmpgtq(XmmRegister dst, XmmRegister src) {
   EmitXmmRegisterOperand(dst.LowBits(), src);
 }
 
+void X86_64Assembler::pmovmskb(CpuRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0xD7);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
 void X86_64Assembler::shufpd(XmmRegister dst, XmmRegister src, const Immediate& imm) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x66);
@@ -3691,6 +3700,1068 @@ void X86_64Assembler::psrldq(XmmRegister reg, const Immediate& shift_count) {
   EmitUint8(shift_count.value());
 }
 
+void X86_64Assembler::vmovaps(XmmRegister dst, XmmRegister src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x28,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+}
+
+void X86_64Assembler::vmovaps(XmmRegister dst, const Address& src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x28, SET_VEX_PP_NONE, is_256, dst, src);
+}
+
+void X86_64Assembler::vmovaps(const Address& dst, XmmRegister src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x29, SET_VEX_PP_NONE, is_256, src, dst);
+}
+
+void X86_64Assembler::vmovups(XmmRegister dst, const Address& src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x10, SET_VEX_PP_NONE, is_256, dst, src);
+}
+
+void X86_64Assembler::vmovups(const Address& dst, XmmRegister src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x11, SET_VEX_PP_NONE, is_256, src, dst);
+}
+
+void X86_64Assembler::vmovapd(XmmRegister dst, const Address& src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x28, SET_VEX_PP_66, is_256, dst, src);
+}
+
+void X86_64Assembler::vmovapd(const Address& dst, XmmRegister src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x29, SET_VEX_PP_66, is_256, src, dst);
+}
+
+void X86_64Assembler::vmovupd(XmmRegister dst, const Address& src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x10, SET_VEX_PP_66, is_256, dst, src);
+}
+
+void X86_64Assembler::vmovupd(const Address& dst, XmmRegister src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x11, SET_VEX_PP_66, is_256, src, dst);
+}
+
+void X86_64Assembler::vmovdqa(XmmRegister dst, const Address& src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x6F, SET_VEX_PP_66, is_256, dst, src);
+}
+
+void X86_64Assembler::vmovdqa(const Address& dst, XmmRegister src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x7F, SET_VEX_PP_66, is_256, src, dst);
+}
+
+void X86_64Assembler::vmovdqu(XmmRegister dst, const Address& src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x6F, SET_VEX_PP_F3, is_256, dst, src);
+}
+
+void X86_64Assembler::vmovdqu(const Address& dst, XmmRegister src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexMemoryInstruction(0x7F, SET_VEX_PP_F3, is_256, src, dst);
+}
+
+void X86_64Assembler::vpaddb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xFC,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpaddw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xFD,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpaddd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xFE,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpaddq(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xD4,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpsubb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xF8,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpsubw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xF9,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpsubd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xFA,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpsubq(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xFB,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpmullw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xD5,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpmulld(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x40,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpmaddwd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xF5,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vphaddd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x02,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpaddsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xEC,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpaddsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xED,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpaddusb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xDC,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpaddusw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xDD,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpsubsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xE8,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpsubsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xE9,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpsubusb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xD8,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpsubusw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xD9,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpavgb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xE0,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpavgw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xE3,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpminsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x38,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpmaxsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x3C,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpminsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xEA,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpmaxsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xEE,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpminsd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x39,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpmaxsd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x3D,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpminub(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xDA,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpmaxub(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xDE,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpminuw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x3A,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpmaxuw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x3E,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpminud(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x3B,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpmaxud(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x3F,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vaddps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x58,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vaddpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x58,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vsubps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x5C,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vsubpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x5C,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vmulps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x59,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vmulpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x59,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vdivps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x5E,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vdivpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x5E,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vminps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x5D,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vminpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x5D,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vmaxps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x5F,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vmaxpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x5F,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpand(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xDB,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpandn(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xDF,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpor(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xEB,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpxor(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0xEF,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vandps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x54,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vandpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x54,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vandnps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x55,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vandnpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x55,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vorps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x56,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x56,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vxorps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x57,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vxorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x57,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpcmpeqb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x74,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpcmpgtd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x66,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpunpckhqdq(XmmRegister dst,
+                                  XmmRegister src1,
+                                  XmmRegister src2,
+                                  bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x6D,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vpabsd(XmmRegister dst, XmmRegister src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x1E,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+}
+
+void X86_64Assembler::vcvtdq2ps(XmmRegister dst, XmmRegister src, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x5B,
+                             SET_VEX_PP_NONE,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+}
+
+void X86_64Assembler::vpshufd(XmmRegister dst, XmmRegister src, const Immediate& imm, bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  DCHECK(imm.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x70,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F,
+                             is_256,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+  EmitUint8(imm.value());
+}
+
+void X86_64Assembler::vpsllw(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             bool is_256) {
+  EmitVexShiftImmediate(0x71, /*digit=*/ 6, dst, src, shift_count, is_256);
+}
+
+void X86_64Assembler::vpslld(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             bool is_256) {
+  EmitVexShiftImmediate(0x72, /*digit=*/ 6, dst, src, shift_count, is_256);
+}
+
+void X86_64Assembler::vpsllq(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             bool is_256) {
+  EmitVexShiftImmediate(0x73, /*digit=*/ 6, dst, src, shift_count, is_256);
+}
+
+void X86_64Assembler::vpsraw(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             bool is_256) {
+  EmitVexShiftImmediate(0x71, /*digit=*/ 4, dst, src, shift_count, is_256);
+}
+
+void X86_64Assembler::vpsrad(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             bool is_256) {
+  EmitVexShiftImmediate(0x72, /*digit=*/ 4, dst, src, shift_count, is_256);
+}
+
+void X86_64Assembler::vpsrlw(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             bool is_256) {
+  EmitVexShiftImmediate(0x71, /*digit=*/ 2, dst, src, shift_count, is_256);
+}
+
+void X86_64Assembler::vpsrld(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             bool is_256) {
+  EmitVexShiftImmediate(0x72, /*digit=*/ 2, dst, src, shift_count, is_256);
+}
+
+void X86_64Assembler::vpsrlq(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             bool is_256) {
+  EmitVexShiftImmediate(0x73, /*digit=*/ 2, dst, src, shift_count, is_256);
+}
+
+void X86_64Assembler::vpbroadcastb(XmmRegister dst, XmmRegister src, bool is_256) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x78,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+}
+
+void X86_64Assembler::vpbroadcastw(XmmRegister dst, XmmRegister src, bool is_256) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x79,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+}
+
+void X86_64Assembler::vpbroadcastd(XmmRegister dst, XmmRegister src, bool is_256) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x58,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+}
+
+void X86_64Assembler::vpbroadcastq(XmmRegister dst, XmmRegister src, bool is_256) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x59,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+}
+
+void X86_64Assembler::vbroadcastss(XmmRegister dst, XmmRegister src, bool is_256) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x18,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             is_256,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+}
+
+void X86_64Assembler::vbroadcastsd(XmmRegister dst, XmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x19,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_38,
+                             /*is_256=*/ true,
+                             dst,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             src);
+}
+
+void X86_64Assembler::vextracti128(XmmRegister dst, XmmRegister src, const Immediate& imm) {
+  DCHECK(has_AVX2_);
+  DCHECK(imm.value() == 0 || imm.value() == 1);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The source is encoded in ModRM.reg and the destination in ModRM.rm.
+  EmitVexRegisterInstruction(0x39,
+                             SET_VEX_PP_66,
+                             SET_VEX_M_0F_3A,
+                             /*is_256=*/ true,
+                             src,
+                             ManagedRegister::NoRegister().AsX86_64(),
+                             dst);
+  EmitUint8(imm.value());
+}
+
+void X86_64Assembler::vmovd(XmmRegister dst, CpuRegister src, bool is64bit) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst.NeedsRex(),
+                /*X=*/ false,
+                src.NeedsRex(),
+                /*W=*/ is64bit,
+                ManagedRegister::NoRegister().AsX86_64(),
+                /*is_256=*/ false,
+                SET_VEX_PP_66,
+                SET_VEX_M_0F);
+  EmitUint8(0x6E);
+  EmitOperand(dst.LowBits(), Operand(src));
+}
+
+void X86_64Assembler::vmovd(CpuRegister dst, XmmRegister src, bool is64bit) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(src.NeedsRex(),
+                /*X=*/ false,
+                dst.NeedsRex(),
+                /*W=*/ is64bit,
+                ManagedRegister::NoRegister().AsX86_64(),
+                /*is_256=*/ false,
+                SET_VEX_PP_66,
+                SET_VEX_M_0F);
+  EmitUint8(0x7E);
+  EmitOperand(src.LowBits(), Operand(dst));
+}
+
+void X86_64Assembler::vmovss(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x10,
+                             SET_VEX_PP_F3,
+                             SET_VEX_M_0F,
+                             /*is_256=*/ false,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vmovsd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexRegisterInstruction(0x10,
+                             SET_VEX_PP_F2,
+                             SET_VEX_M_0F,
+                             /*is_256=*/ false,
+                             dst,
+                             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                             src2);
+}
+
+void X86_64Assembler::vzeroupper() {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0xC5);
+  EmitUint8(0xF8);
+  EmitUint8(0x77);
+}
+
 
 void X86_64Assembler::fldl(const Address& src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
@@ -4383,6 +5454,22 @@ void X86_64Assembler::idivq(CpuRegister reg) {
 }
 
 
+void X86_64Assembler::divl(CpuRegister reg) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitOptionalRex32(reg);
+  EmitUint8(0xF7);
+  EmitUint8(0xF0 | reg.LowBits());
+}
+
+
+void X86_64Assembler::divq(CpuRegister reg) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitRex64(reg);
+  EmitUint8(0xF7);
+  EmitUint8(0xF0 | reg.LowBits());
+}
+
+
 void X86_64Assembler::imull(CpuRegister dst, CpuRegister src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitOptionalRex32(dst, src);
@@ -5563,5 +6650,85 @@ uint8_t X86_64Assembler::EmitVexPrefixByteTwo(bool W,
   return vex_prefix;
 }
 
+void X86_64Assembler::EmitVexPrefix(bool R,
+                                    bool X,
+                                    bool B,
+                                    bool W,
+                                    X86_64ManagedRegister vvvv,
+                                    bool is_256,
+                                    int SET_VEX_PP,
+                                    int SET_VEX_M) {
+  int vex_l = is_256 ? SET_VEX_L_256 : SET_VEX_L_128;
+  bool is_twobyte_form = !X && !B && !W && SET_VEX_M == SET_VEX_M_0F;
+  EmitUint8(EmitVexPrefixByteZero(is_twobyte_form));
+  if (is_twobyte_form) {
+    EmitUint8(EmitVexPrefixByteOne(R, vvvv, vex_l, SET_VEX_PP));
+  } else {
+    EmitUint8(EmitVexPrefixByteOne(R, X, B, SET_VEX_M));
+    EmitUint8(vvvv.IsNoRegister() ? EmitVexPrefixByteTwo(W, vex_l, SET_VEX_PP)
+                                  : EmitVexPrefixByteTwo(W, vvvv, vex_l, SET_VEX_PP));
+  }
+}
+
+void X86_64Assembler::EmitVexRegisterInstruction(uint8_t opcode,
+                                                 int SET_VEX_PP,
+                                                 int SET_VEX_M,
+                                                 bool is_256,
+                                                 XmmRegister reg,
+                                                 X86_64ManagedRegister vvvv,
+                                                 XmmRegister rm) {
+  EmitVexPrefix(reg.NeedsRex(),
+                /*X=*/ false,
+                rm.NeedsRex(),
+                /*W=*/ false,
+                vvvv,
+                is_256,
+                SET_VEX_PP,
+                SET_VEX_M);
+  EmitUint8(opcode);
+  EmitXmmRegisterOperand(reg.LowBits(), rm);
+}
+
+void X86_64Assembler::EmitVexMemoryInstruction(uint8_t opcode,
+                                               int SET_VEX_PP,
+                                               bool is_256,
+                                               XmmRegister reg,
+                                               const Address& operand) {
+  uint8_t rex = operand.rex();
+  EmitVexPrefix(reg.NeedsRex(),
+                (rex & GET_REX_X) != 0,
+                (rex & GET_REX_B) != 0,
+                /*W=*/ false,
+                ManagedRegister::NoRegister().AsX86_64(),
+                is_256,
+                SET_VEX_PP,
+                SET_VEX_M_0F);
+  EmitUint8(opcode);
+  EmitOperand(reg.LowBits(), operand);
+}
+
+void X86_64Assembler::EmitVexShiftImmediate(uint8_t opcode,
+                                            uint8_t digit,
+                                            XmmRegister dst,
+                                            XmmRegister src,
+                                            const Immediate& shift_count,
+                                            bool is_256) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in VEX.vvvv, ModRM.reg holds the opcode extension.
+  EmitVexPrefix(/*R=*/ false,
+                /*X=*/ false,
+                src.NeedsRex(),
+                /*W=*/ false,
+                X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+                is_256,
+                SET_VEX_PP_66,
+                SET_VEX_M_0F);
+  EmitUint8(opcode);
+  EmitXmmRegisterOperand(digit, src);
+  EmitUint8(shift_count.value());
+}
+
 }  // namespace x86_64
 }  // namespace art
@@ -654,6 +654,8 @@ class X86_64Assembler final : public Assembler {
   void pcmpgtd(XmmRegister dst, XmmRegister src);
   void pcmpgtq(XmmRegister dst, XmmRegister src);  // SSE4.2
 
+  void pmovmskb(CpuRegister dst, XmmRegister src);
+
   void shufpd(XmmRegister dst, XmmRegister src, const Immediate& imm);
   void shufps(XmmRegister dst, XmmRegister src, const Immediate& imm);
   void pshufd(XmmRegister dst, XmmRegister src, const Immediate& imm);
@@ -681,6 +683,125 @@ class X86_64Assembler final : public Assembler {
   void psrlq(XmmRegister reg, const Immediate& shift_count);
   void psrldq(XmmRegister reg, const Immediate& shift_count);
 
+  //
+  // VEX-encoded vector instructions with a selectable vector length. With `is_256`, the
+  // instruction operates on the 256-bit YMM registers (AVX2 for integer operations) which
+  // share their numbers and low 128 bits with the XmmRegister operands; otherwise it is
+  // the VEX.128 form, which clears the upper bits of the destination.
+  //
+  void vmovaps(XmmRegister dst, XmmRegister src, bool is_256);
+  void vmovaps(XmmRegister dst, const Address& src, bool is_256);
+  void vmovaps(const Address& dst, XmmRegister src, bool is_256);
+  void vmovups(XmmRegister dst, const Address& src, bool is_256);
+  void vmovups(const Address& dst, XmmRegister src, bool is_256);
+  void vmovapd(XmmRegister dst, const Address& src, bool is_256);
+  void vmovapd(const Address& dst, XmmRegister src, bool is_256);
+  void vmovupd(XmmRegister dst, const Address& src, bool is_256);
+  void vmovupd(const Address& dst, XmmRegister src, bool is_256);
+  void vmovdqa(XmmRegister dst, const Address& src, bool is_256);
+  void vmovdqa(const Address& dst, XmmRegister src, bool is_256);
+  void vmovdqu(XmmRegister dst, const Address& src, bool is_256);
+  void vmovdqu(const Address& dst, XmmRegister src, bool is_256);
+
+  void vpaddb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpaddw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpaddd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpaddq(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpsubb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpsubw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpsubd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpsubq(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpmullw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpmulld(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpmaddwd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vphaddd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+
+  void vpaddsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpaddsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpaddusb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpaddusw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpsubsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpsubsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpsubusb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpsubusw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpavgb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpavgw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+
+  void vpminsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpmaxsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpminsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpmaxsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpminsd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpmaxsd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpminub(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpmaxub(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpminuw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpmaxuw(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpminud(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpmaxud(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+
+  void vaddps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vaddpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vsubps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vsubpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vmulps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vmulpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vdivps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vdivpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vminps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vminpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vmaxps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vmaxpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+
+  void vpand(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpandn(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpor(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpxor(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vandps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vandpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vandnps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vandnpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vorps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vxorps(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vxorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+
+  void vpcmpeqb(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpcmpgtd(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+  void vpunpckhqdq(XmmRegister dst, XmmRegister src1, XmmRegister src2, bool is_256);
+
+  void vpabsd(XmmRegister dst, XmmRegister src, bool is_256);
+  void vcvtdq2ps(XmmRegister dst, XmmRegister src, bool is_256);
+  void vpshufd(XmmRegister dst, XmmRegister src, const Immediate& imm, bool is_256);
+
+  void vpsllw(XmmRegister dst, XmmRegister src, const Immediate& shift_count, bool is_256);
+  void vpslld(XmmRegister dst, XmmRegister src, const Immediate& shift_count, bool is_256);
+  void vpsllq(XmmRegister dst, XmmRegister src, const Immediate& shift_count, bool is_256);
+  void vpsraw(XmmRegister dst, XmmRegister src, const Immediate& shift_count, bool is_256);
+  void vpsrad(XmmRegister dst, XmmRegister src, const Immediate& shift_count, bool is_256);
+  void vpsrlw(XmmRegister dst, XmmRegister src, const Immediate& shift_count, bool is_256);
+  void vpsrld(XmmRegister dst, XmmRegister src, const Immediate& shift_count, bool is_256);
+  void vpsrlq(XmmRegister dst, XmmRegister src, const Immediate& shift_count, bool is_256);
+
+  void vpbroadcastb(XmmRegister dst, XmmRegister src, bool is_256);  // AVX2
+  void vpbroadcastw(XmmRegister dst, XmmRegister src, bool is_256);  // AVX2
+  void vpbroadcastd(XmmRegister dst, XmmRegister src, bool is_256);  // AVX2
+  void vpbroadcastq(XmmRegister dst, XmmRegister src, bool is_256);  // AVX2
+  void vbroadcastss(XmmRegister dst, XmmRegister src, bool is_256);  // AVX2
+  void vbroadcastsd(XmmRegister dst, XmmRegister src);  // AVX2, 256-bit only
+
+  // Moves the high (imm = 1) or low (imm = 0) 128 bits of the 256-bit `src` into `dst`. AVX2.
+  void vextracti128(XmmRegister dst, XmmRegister src, const Immediate& imm);
+
+  // VEX.128 scalar moves; these clear the upper bits of the destination register.
+  void vmovd(XmmRegister dst, CpuRegister src, bool is64bit);
+  void vmovd(CpuRegister dst, XmmRegister src, bool is64bit);
+  void vmovss(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vmovsd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+
+  // Clears the upper 128 bits of all YMM registers, avoiding AVX-SSE transition penalties.
+  void vzeroupper();
+
   void flds(const Address& src);
   void fstps(const Address& dst);
   void fsts(const Address& dst);
@@ -783,6 +904,8 @@ class X86_64Assembler final : public Assembler {
 
   void idivl(CpuRegister reg);
   void idivq(CpuRegister reg);
+  void divl(CpuRegister reg);
+  void divq(CpuRegister reg);
 
   void imull(CpuRegister dst, CpuRegister src);
   void imull(CpuRegister reg, const Immediate& imm);
@@ -1032,6 +1155,38 @@ class X86_64Assembler final : public Assembler {
   uint8_t EmitVexPrefixByteTwo(bool W,
                                int SET_VEX_L,
                                int SET_VEX_PP);
+
+  // Emits a two- or three-byte VEX prefix, using the shorter form whenever possible.
+  // `R`, `X` and `B` are the REX extension bits of the ModRM.reg and ModRM.rm operands.
+  void EmitVexPrefix(bool R,
+                     bool X,
+                     bool B,
+                     bool W,
+                     X86_64ManagedRegister vvvv,
+                     bool is_256,
+                     int SET_VEX_PP,
+                     int SET_VEX_M);
+  // Emits a VEX-encoded instruction `opcode reg, vvvv, rm` with register operands.
+  void EmitVexRegisterInstruction(uint8_t opcode,
+                                  int SET_VEX_PP,
+                                  int SET_VEX_M,
+                                  bool is_256,
+                                  XmmRegister reg,
+                                  X86_64ManagedRegister vvvv,
+                                  XmmRegister rm);
+  // Emits a VEX-encoded instruction `opcode reg, operand` (no vvvv operand).
+  void EmitVexMemoryInstruction(uint8_t opcode,
+                                int SET_VEX_PP,
+                                bool is_256,
+                                XmmRegister reg,
+                                const Address& operand);
+  // Emits a VEX-encoded shift by immediate (opcode group with ModRM.reg = `digit`).
+  void EmitVexShiftImmediate(uint8_t opcode,
+                             uint8_t digit,
+                             XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             bool is_256);
   ConstantArea constant_area_;
   bool has_AVX_;     // x86 256bit SIMD AVX.
   bool has_AVX2_;    // x86 256bit SIMD AVX 2.0.
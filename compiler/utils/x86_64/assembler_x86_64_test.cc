@@ -624,6 +624,14 @@ TEST_F(AssemblerX86_64Test, Mull) {
   DriverStr(Repeatr(&x86_64::X86_64Assembler::mull, "mull %{reg}"), "mull");
 }
 
+TEST_F(AssemblerX86_64Test, Divl) {
+  DriverStr(Repeatr(&x86_64::X86_64Assembler::divl, "divl %{reg}"), "divl");
+}
+
+TEST_F(AssemblerX86_64Test, Divq) {
+  DriverStr(Repeatr(&x86_64::X86_64Assembler::divq, "divq %{reg}"), "divq");
+}
+
 TEST_F(AssemblerX86_64Test, SubqRegs) {
   DriverStr(RepeatRR(&x86_64::X86_64Assembler::subq, "subq %{reg2}, %{reg1}"), "subq");
 }
@@ -1750,6 +1758,81 @@ TEST_F(AssemblerX86_64AVXTest, VPmaddwd) {
                       "vpmaddwd %{reg3}, %{reg2}, %{reg1}"), "vpmaddwd");
 }
 
+TEST_F(AssemblerX86_64AVXTest, Avx2Arithmetic256) {
+  x86_64::XmmRegister xmm0(x86_64::XMM0);
+  x86_64::XmmRegister xmm1(x86_64::XMM1);
+  x86_64::XmmRegister xmm9(x86_64::XMM9);
+  x86_64::XmmRegister xmm15(x86_64::XMM15);
+  GetAssembler()->vpaddd(xmm0, xmm1, xmm9, /*is_256=*/ true);
+  GetAssembler()->vpsubq(xmm15, xmm0, xmm1, /*is_256=*/ true);
+  GetAssembler()->vpmulld(xmm9, xmm15, xmm0, /*is_256=*/ true);
+  GetAssembler()->vpmaxsd(xmm1, xmm9, xmm15, /*is_256=*/ true);
+  GetAssembler()->vaddps(xmm0, xmm1, xmm9, /*is_256=*/ true);
+  GetAssembler()->vmulpd(xmm15, xmm0, xmm1, /*is_256=*/ true);
+  GetAssembler()->vpxor(xmm9, xmm9, xmm9, /*is_256=*/ true);
+  GetAssembler()->vpaddd(xmm0, xmm1, xmm9, /*is_256=*/ false);
+  const char* expected =
+      "vpaddd %ymm9, %ymm1, %ymm0\n"
+      "vpsubq %ymm1, %ymm0, %ymm15\n"
+      "vpmulld %ymm0, %ymm15, %ymm9\n"
+      "vpmaxsd %ymm15, %ymm9, %ymm1\n"
+      "vaddps %ymm9, %ymm1, %ymm0\n"
+      "vmulpd %ymm1, %ymm0, %ymm15\n"
+      "vpxor %ymm9, %ymm9, %ymm9\n"
+      "vpaddd %xmm9, %xmm1, %xmm0\n";
+  DriverStr(expected, "avx2_arithmetic_256");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Avx2Moves256) {
+  x86_64::XmmRegister xmm2(x86_64::XMM2);
+  x86_64::XmmRegister xmm11(x86_64::XMM11);
+  x86_64::Address addr(x86_64::CpuRegister(x86_64::RAX), x86_64::CpuRegister(x86_64::R9),
+                       x86_64::TIMES_4, 32);
+  GetAssembler()->vmovdqu(xmm2, addr, /*is_256=*/ true);
+  GetAssembler()->vmovdqa(addr, xmm11, /*is_256=*/ true);
+  GetAssembler()->vmovups(xmm11, addr, /*is_256=*/ true);
+  GetAssembler()->vmovapd(addr, xmm2, /*is_256=*/ true);
+  GetAssembler()->vmovaps(xmm2, xmm11, /*is_256=*/ true);
+  const char* expected =
+      "vmovdqu 0x20(%rax,%r9,4), %ymm2\n"
+      "vmovdqa %ymm11, 0x20(%rax,%r9,4)\n"
+      "vmovups 0x20(%rax,%r9,4), %ymm11\n"
+      "vmovapd %ymm2, 0x20(%rax,%r9,4)\n"
+      "vmovaps %ymm11, %ymm2\n";
+  DriverStr(expected, "avx2_moves_256");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Avx2BroadcastExtract) {
+  x86_64::XmmRegister xmm3(x86_64::XMM3);
+  x86_64::XmmRegister xmm12(x86_64::XMM12);
+  GetAssembler()->vmovd(xmm3, x86_64::CpuRegister(x86_64::R10), /*is64bit=*/ false);
+  GetAssembler()->vpbroadcastd(xmm12, xmm3, /*is_256=*/ true);
+  GetAssembler()->vmovd(xmm12, x86_64::CpuRegister(x86_64::RCX), /*is64bit=*/ true);
+  GetAssembler()->vpbroadcastq(xmm3, xmm12, /*is_256=*/ true);
+  GetAssembler()->vbroadcastss(xmm3, xmm12, /*is_256=*/ true);
+  GetAssembler()->vbroadcastsd(xmm12, xmm3);
+  GetAssembler()->vextracti128(xmm3, xmm12, x86_64::Immediate(1));
+  GetAssembler()->vmovd(x86_64::CpuRegister(x86_64::R11), xmm3, /*is64bit=*/ false);
+  GetAssembler()->vpshufd(xmm12, xmm3, x86_64::Immediate(0x4e), /*is_256=*/ false);
+  GetAssembler()->vpslld(xmm12, xmm3, x86_64::Immediate(3), /*is_256=*/ true);
+  GetAssembler()->vpsrlq(xmm3, xmm12, x86_64::Immediate(1), /*is_256=*/ true);
+  GetAssembler()->vzeroupper();
+  const char* expected =
+      "vmovd %r10d, %xmm3\n"
+      "vpbroadcastd %xmm3, %ymm12\n"
+      "vmovq %rcx, %xmm12\n"
+      "vpbroadcastq %xmm12, %ymm3\n"
+      "vbroadcastss %xmm12, %ymm3\n"
+      "vbroadcastsd %xmm3, %ymm12\n"
+      "vextracti128 $1, %ymm12, %xmm3\n"
+      "vmovd %xmm3, %r11d\n"
+      "vpshufd $0x4e, %xmm3, %xmm12\n"
+      "vpslld $3, %ymm3, %ymm12\n"
+      "vpsrlq $1, %ymm12, %ymm3\n"
+      "vzeroupper\n";
+  DriverStr(expected, "avx2_broadcast_extract");
+}
+
 TEST_F(AssemblerX86_64Test, Phaddw) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::phaddw, "phaddw %{reg2}, %{reg1}"), "phaddw");
 }
@@ -1878,6 +1961,10 @@ TEST_F(AssemblerX86_64Test, PCmpgtq) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::pcmpgtq, "pcmpgtq %{reg2}, %{reg1}"), "pcmpgtq");
 }
 
+TEST_F(AssemblerX86_64Test, PMovmskb) {
+  DriverStr(RepeatrF(&x86_64::X86_64Assembler::pmovmskb, "pmovmskb %{reg2}, %{reg1}"), "pmovmskb");
+}
+
 TEST_F(AssemblerX86_64Test, Shufps) {
   DriverStr(RepeatFFI(&x86_64::X86_64Assembler::shufps, /*imm_bytes*/ 1U,
                       "shufps ${imm}, %{reg2}, %{reg1}"), "shufps");
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compilation_server.h"
+
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "android-base/file.h"
+#include "android-base/stringprintf.h"
+#include "android-base/strings.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+static bool WriteFullyToSocket(int socket_fd, const void* data, size_t size) {
+  const uint8_t* pos = reinterpret_cast<const uint8_t*>(data);
+  while (size != 0u) {
+    ssize_t sent = TEMP_FAILURE_RETRY(send(socket_fd, pos, size, MSG_NOSIGNAL));
+    if (sent <= 0) {
+      return false;
+    }
+    pos += sent;
+    size -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+bool SendCompilationRequest(int socket_fd,
+                            const std::vector<std::string>& args,
+                            const std::vector<int>& fds,
+                            std::string* error_msg) {
+  if (fds.size() > kMaxCompilationRequestFds) {
+    *error_msg = StringPrintf("Too many file descriptors: %zu", fds.size());
+    return false;
+  }
+  std::string payload;
+  for (const std::string& arg : args) {
+    payload += arg;
+    payload += '\0';
+  }
+  if (payload.size() > kMaxCompilationRequestSize) {
+    *error_msg = StringPrintf("Request too large: %zu bytes", payload.size());
+    return false;
+  }
+
+  uint32_t size = static_cast<uint32_t>(payload.size());
+  iovec iov = { &size, sizeof(size) };
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxCompilationRequestFds)];
+  if (!fds.empty()) {
+    msg.msg_control = control;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+  }
+  if (TEMP_FAILURE_RETRY(sendmsg(socket_fd, &msg, MSG_NOSIGNAL)) != sizeof(size)) {
+    *error_msg = StringPrintf("Failed to send request: %s", strerror(errno));
+    return false;
+  }
+  if (!WriteFullyToSocket(socket_fd, payload.data(), payload.size())) {
+    *error_msg = StringPrintf("Failed to send request arguments: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool ReceiveCompilationRequest(int socket_fd,
+                               std::vector<std::string>* args,
+                               std::vector<android::base::unique_fd>* fds,
+                               std::string* error_msg) {
+  args->clear();
+  fds->clear();
+  error_msg->clear();
+
+  uint32_t size;
+  iovec iov = { &size, sizeof(size) };
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxCompilationRequestFds)];
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t received =
+      TEMP_FAILURE_RETRY(recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC | MSG_WAITALL));
+  if (received == 0) {
+    return false;  // Connection closed.
+  }
+  // Take ownership of the received descriptors first, so that they are closed on any error.
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+      const int* received_fds = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+      for (size_t i = 0; i != count; ++i) {
+        fds->emplace_back(received_fds[i]);
+      }
+    }
+  }
+  if (received != sizeof(size)) {
+    *error_msg = StringPrintf("Failed to receive request: %s",
+                              (received < 0) ? strerror(errno) : "truncated");
+    return false;
+  }
+  if ((msg.msg_flags & MSG_CTRUNC) != 0) {
+    *error_msg = StringPrintf("Too many file descriptors, max %zu", kMaxCompilationRequestFds);
+    return false;
+  }
+  if (size > kMaxCompilationRequestSize) {
+    *error_msg = StringPrintf("Request too large: %u bytes", size);
+    return false;
+  }
+
+  std::string payload(size, '\0');
+  if (!android::base::ReadFully(socket_fd, payload.data(), size)) {
+    *error_msg = StringPrintf("Failed to receive request arguments: %s", strerror(errno));
+    return false;
+  }
+  if (!payload.empty() && payload.back() != '\0') {
+    *error_msg = "Request arguments are not NUL terminated";
+    return false;
+  }
+  for (size_t start = 0u; start != payload.size(); ) {
+    size_t end = payload.find('\0', start);
+    std::string arg = payload.substr(start, end - start);
+    for (size_t i = 0; i != fds->size(); ++i) {
+      arg = android::base::StringReplace(arg,
+                                         StringPrintf("{fd%zu}", i),
+                                         std::to_string((*fds)[i].get()),
+                                         /*all=*/ true);
+    }
+    if (arg.find("{fd") != std::string::npos) {
+      *error_msg = "Reference to a file descriptor that was not sent: " + arg;
+      return false;
+    }
+    args->push_back(std::move(arg));
+    start = end + 1u;
+  }
+  return true;
+}
+
+bool SendCompilationResult(int socket_fd, int32_t exit_code, std::string* error_msg) {
+  if (!WriteFullyToSocket(socket_fd, &exit_code, sizeof(exit_code))) {
+    *error_msg = StringPrintf("Failed to send result: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool ReceiveCompilationResult(int socket_fd, int32_t* exit_code, std::string* error_msg) {
+  if (!android::base::ReadFully(socket_fd, exit_code, sizeof(*exit_code))) {
+    *error_msg = StringPrintf("Failed to receive result: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+}  // namespace art
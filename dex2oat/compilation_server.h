@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DEX2OAT_COMPILATION_SERVER_H_
+#define ART_DEX2OAT_COMPILATION_SERVER_H_
+
+#include <string>
+#include <vector>
+
+#include "android-base/unique_fd.h"
+
+#include "base/globals.h"
+
+namespace art {
+
+// Wire format of the requests served by `dex2oat --compilation-server-fd`.
+//
+// A request is a uint32_t byte count followed by that many bytes of dex2oat arguments, each
+// terminated by a NUL. The file descriptors used by the compilation are attached to the byte
+// count as SCM_RIGHTS, and an argument refers to the i-th of them as "{fd<i>}", for example
+// "--zip-fd={fd0}". After the compilation, the server replies with the int32_t exit code of
+// dex2oat, see dex2oat_return_codes.h, or a negative value if the compilation did not exit.
+
+static constexpr size_t kMaxCompilationRequestFds = 16u;
+static constexpr size_t kMaxCompilationRequestSize = 1 * MB;
+
+bool SendCompilationRequest(int socket_fd,
+                            const std::vector<std::string>& args,
+                            const std::vector<int>& fds,
+                            std::string* error_msg);
+
+// Receive a request and replace the "{fd<i>}" references in its arguments with the numbers of
+// the received file descriptors, which stay open in `fds`. Returns false with an empty
+// `error_msg` if the peer closed the connection before sending a request.
+bool ReceiveCompilationRequest(int socket_fd,
+                               std::vector<std::string>* args,
+                               std::vector<android::base::unique_fd>* fds,
+                               std::string* error_msg);
+
+bool SendCompilationResult(int socket_fd, int32_t exit_code, std::string* error_msg);
+
+bool ReceiveCompilationResult(int socket_fd, int32_t* exit_code, std::string* error_msg);
+
+}  // namespace art
+
+#endif  // ART_DEX2OAT_COMPILATION_SERVER_H_
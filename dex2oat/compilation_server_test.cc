@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compilation_server.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "android-base/unique_fd.h"
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+using android::base::unique_fd;
+
+class CompilationServerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds));
+    client_.reset(fds[0]);
+    server_.reset(fds[1]);
+  }
+
+  unique_fd client_;
+  unique_fd server_;
+};
+
+TEST_F(CompilationServerTest, RequestAndResult) {
+  int pipe_fds[2];
+  ASSERT_EQ(0, pipe(pipe_fds));
+  unique_fd read_end(pipe_fds[0]);
+  unique_fd write_end(pipe_fds[1]);
+
+  std::string error_msg;
+  ASSERT_TRUE(SendCompilationRequest(
+      client_.get(),
+      { "--zip-fd={fd0}", "--class-loader-context-fds={fd0}:{fd1}", "--compiler-filter=speed" },
+      { read_end.get(), write_end.get() },
+      &error_msg)) << error_msg;
+
+  std::vector<std::string> args;
+  std::vector<unique_fd> fds;
+  ASSERT_TRUE(ReceiveCompilationRequest(server_.get(), &args, &fds, &error_msg)) << error_msg;
+  ASSERT_EQ(2u, fds.size());
+  std::string fd0 = std::to_string(fds[0].get());
+  std::string fd1 = std::to_string(fds[1].get());
+  ASSERT_EQ(3u, args.size());
+  EXPECT_EQ("--zip-fd=" + fd0, args[0]);
+  EXPECT_EQ("--class-loader-context-fds=" + fd0 + ":" + fd1, args[1]);
+  EXPECT_EQ("--compiler-filter=speed", args[2]);
+
+  // The received descriptors refer to the sent pipe.
+  ASSERT_EQ(1, write(fds[1].get(), "x", 1));
+  char c;
+  ASSERT_EQ(1, read(read_end.get(), &c, 1));
+  EXPECT_EQ('x', c);
+
+  ASSERT_TRUE(SendCompilationResult(server_.get(), 3, &error_msg)) << error_msg;
+  int32_t exit_code;
+  ASSERT_TRUE(ReceiveCompilationResult(client_.get(), &exit_code, &error_msg)) << error_msg;
+  EXPECT_EQ(3, exit_code);
+}
+
+TEST_F(CompilationServerTest, ClosedConnection) {
+  client_.reset();
+  std::vector<std::string> args;
+  std::vector<unique_fd> fds;
+  std::string error_msg;
+  EXPECT_FALSE(ReceiveCompilationRequest(server_.get(), &args, &fds, &error_msg));
+  EXPECT_TRUE(error_msg.empty()) << error_msg;
+}
+
+TEST_F(CompilationServerTest, MissingFd) {
+  std::string error_msg;
+  ASSERT_TRUE(SendCompilationRequest(
+      client_.get(), { "--oat-fd={fd1}" }, { server_.get() }, &error_msg)) << error_msg;
+  std::vector<std::string> args;
+  std::vector<unique_fd> fds;
+  EXPECT_FALSE(ReceiveCompilationRequest(server_.get(), &args, &fds, &error_msg));
+  EXPECT_FALSE(error_msg.empty());
+}
+
+}  // namespace art
@@ -33,13 +33,16 @@
 #include <sched.h>
 #if defined(__arm__)
 #include <sys/personality.h>
+#include <sys/socket.h>
 #include <sys/utsname.h>
+#include <sys/wait.h>
 #endif  // __arm__
 #endif
 
 #include "android-base/parseint.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
+#include "android-base/unique_fd.h"
 
 #include "aot_class_linker.h"
 #include "arch/instruction_set_features.h"
@@ -62,6 +65,7 @@
 #include "class_loader_context.h"
 #include "cmdline_parser.h"
 #include "compiler.h"
+#include "compilation_server.h"
 #include "compiler_callbacks.h"
 #include "debug/elf_debug_writer.h"
 #include "debug/method_debug_info.h"
@@ -336,6 +340,7 @@ NO_RETURN static void Usage(const char* fmt, ...) {
                 "|space-profile"
                 "|space"
                 "|speed-profile"
+                "|speed-profile-baseline"
                 "|speed"
                 "|everything-profile"
                 "|everything):");
@@ -369,11 +374,22 @@ NO_RETURN static void Usage(const char* fmt, ...) {
              CompilerOptions::kDefaultInlineMaxCodeUnits);
   UsageError("      Default: %d", CompilerOptions::kDefaultInlineMaxCodeUnits);
   UsageError("");
+  UsageError("  --optimizing-time-budget=<ms>: the wall time that Optimizing may spend on one");
+  UsageError("      method. Once it is used up, the remaining optional passes are skipped, or");
+  UsageError("      only the baseline passes run if the graph took that long to build.");
+  UsageError("      A zero value disables the budget.");
+  UsageError("      Example: --optimizing-time-budget=500");
+  UsageError("      Default: %zu", CompilerOptions::kDefaultOptimizingTimeBudgetMs);
+  UsageError("");
   UsageError("  --dump-timings: display a breakdown of where time was spent");
   UsageError("");
   UsageError("  --dump-pass-timings: display a breakdown of time spent in optimization");
   UsageError("      passes for each compiled method.");
   UsageError("");
+  UsageError("  --dump-pass-stats: log the wall time and arena memory of each optimization");
+  UsageError("      pass, aggregated over all compiled methods, as CSV lines prefixed with");
+  UsageError("      PassStats#.");
+  UsageError("");
   UsageError("  -g");
   UsageError("  --generate-debug-info: Generate debug information for native debugging,");
   UsageError("      such as stack unwinding information, ELF symbols and DWARF sections.");
@@ -392,6 +408,29 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("");
   UsageError("  --no-generate-build-id: Do not generate the build ID ELF section.");
   UsageError("");
+  UsageError("  --generate-frame-pointers: Keep a frame pointer chain through compiled code");
+  UsageError("      so that samplers can unwind it without stack maps or debug information.");
+  UsageError("      Only supported on arm64. (disabled by default)");
+  UsageError("");
+  UsageError("  --no-generate-frame-pointers: Do not keep a frame pointer chain.");
+  UsageError("");
+  UsageError("  --split-cold-code: Lay out blocks that throw next to the slow paths at the end");
+  UsageError("      of each method, keeping the frequently executed code contiguous.");
+  UsageError("");
+  UsageError("  --no-split-cold-code: Lay out blocks that throw in their usual order (default).");
+  UsageError("");
+  UsageError("  --implicit-suspend-checks: On ARM64 and x86-64, check for suspension requests");
+  UsageError("      with a load that faults when the thread is asked to suspend. The code");
+  UsageError("      must run with -XX:ImplicitSuspendChecks:true.");
+  UsageError("");
+  UsageError("  --no-implicit-suspend-checks: Check for suspension requests by testing the");
+  UsageError("      thread flags (default).");
+  UsageError("");
+  UsageError("  --compiled-method-cache=<directory>: Reuse the compiled code of methods whose");
+  UsageError("      dex code, profile data, compiler options and dex file dependencies match an");
+  UsageError("      entry in the given directory, and add the newly compiled methods to it.");
+  UsageError("      The directory must only be shared by runs of the same dex2oat build.");
+  UsageError("");
   UsageError("  --debuggable: Produce code debuggable with Java debugger.");
   UsageError("");
   UsageError("  --avoid-storing-invocation: Avoid storing the invocation args in the key value");
@@ -426,6 +465,12 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("      Example: --swap-dex-count-threshold=10");
   UsageError("      Default: %zu", kDefaultMinDexFilesForSwap);
   UsageError("");
+  UsageError("  --memory-budget=<size>: specifies the resident set size in bytes that compilation");
+  UsageError("      tries to stay within. When the budget is exceeded, fewer methods are compiled");
+  UsageError("      in parallel. The swap file, if any, is used when the dex files do not fit in");
+  UsageError("      the remaining budget, regardless of the swap thresholds.");
+  UsageError("      Example: --memory-budget=500000000");
+  UsageError("");
   UsageError("  --very-large-app-threshold=<size>: specifies the minimum total dex file size in");
   UsageError("      bytes to consider the input \"very large\" and reduce compilation done.");
   UsageError("      Example: --very-large-app-threshold=100000000");
@@ -516,6 +561,13 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("      the key value store of the oat file.");
   UsageError("      Example: --compilation-reason=install");
   UsageError("");
+  UsageError("  --compilation-server-fd=<number>: serve the compilation requests of the clients");
+  UsageError("      accepted on a listening Unix domain socket, see compilation_server.h. The");
+  UsageError("      runtime and the boot image are loaded once, and each request is compiled in a");
+  UsageError("      forked process with the other arguments given here followed by its own.");
+  UsageError("      Requests cannot change --boot-image, --instruction-set or --runtime-arg.");
+  UsageError("      Example: --compilation-server-fd=5");
+  UsageError("");
   UsageError("  --resolve-startup-const-strings=true|false: If true, the compiler eagerly");
   UsageError("      resolves strings referenced from const-string of startup methods.");
   UsageError("");
@@ -774,6 +826,12 @@ class ThreadLocalHashOverride {
   Handle<mirror::Object> old_field_value_;
 };
 
+class Dex2Oat;
+
+// The compilation server this process was forked from, if any. Its runtime is used for the
+// compilation instead of creating a new one.
+static const Dex2Oat* compilation_server = nullptr;
+
 class Dex2Oat final {
  public:
   explicit Dex2Oat(TimingLogger* timings) :
@@ -793,6 +851,7 @@ class Dex2Oat final {
       dm_fd_(-1),
       zip_fd_(-1),
       image_fd_(-1),
+      compilation_server_fd_(-1),
       have_multi_image_arg_(false),
       multi_image_(false),
       image_base_(0U),
@@ -1325,6 +1384,7 @@ class Dex2Oat final {
     AssignIfExists(args, M::SwapFileFd, &swap_fd_);
     AssignIfExists(args, M::SwapDexSizeThreshold, &min_dex_file_cumulative_size_for_swap_);
     AssignIfExists(args, M::SwapDexCountThreshold, &min_dex_files_for_swap_);
+    AssignIfExists(args, M::MemoryBudget, &memory_budget_);
     AssignIfExists(args, M::VeryLargeAppThreshold, &very_large_threshold_);
     AssignIfExists(args, M::AppImageFile, &app_image_file_name_);
     AssignIfExists(args, M::AppImageFileFd, &app_image_fd_);
@@ -1431,6 +1491,62 @@ class Dex2Oat final {
     InsertCompileOptions(argc, argv);
   }
 
+  // Parse the arguments of a compilation server. Only the arguments that affect the runtime are
+  // used here, all of them are checked again with the arguments of each request.
+  void ParseCompilationServerArgs(int argc, char** argv) {
+    original_argc = argc;
+    original_argv = argv;
+
+    Locks::Init();
+    InitLogging(argv, Runtime::Abort);
+
+    compiler_options_.reset(new CompilerOptions());
+
+    using M = Dex2oatArgumentMap;
+    std::string error_msg;
+    std::unique_ptr<M> args_uptr = M::Parse(argc, const_cast<const char**>(argv), &error_msg);
+    if (args_uptr == nullptr) {
+      Usage("Failed to parse command line: %s", error_msg.c_str());
+      UNREACHABLE();
+    }
+
+    M& args = *args_uptr;
+    AssignIfExists(args, M::CompilationServerFd, &compilation_server_fd_);
+    AssignIfExists(args, M::BootImage, &boot_image_filename_);
+    AssignIfExists(args, M::RuntimeOptions, &runtime_args_);
+    AssignIfExists(args, M::TargetInstructionSet, &compiler_options_->instruction_set_);
+    // arm actually means thumb2.
+    if (compiler_options_->instruction_set_ == InstructionSet::kArm) {
+      compiler_options_->instruction_set_ = InstructionSet::kThumb2;
+    }
+
+    if (boot_image_filename_.empty()) {
+      Usage("--compilation-server-fd requires --boot-image");
+    }
+    if (args.Exists(M::ImageFilename) || args.Exists(M::ImageFd)) {
+      Usage("--compilation-server-fd should not be used with --image or --image-fd");
+    }
+    // Match the boot image location of the requests, see ProcessOptions().
+    size_t profile_separator_pos = boot_image_filename_.find(ImageSpace::kProfileSeparator);
+    if (profile_separator_pos != std::string::npos) {
+      boot_image_filename_.resize(profile_separator_pos);
+    }
+  }
+
+  // Create the runtime that the processes forked for the requests compile with.
+  bool CreateCompilationServerRuntime() {
+    callbacks_.reset(new QuickCompilerCallbacks(CompilerCallbacks::CallbackMode::kCompileApp));
+    RuntimeArgumentMap runtime_options;
+    if (!PrepareRuntimeOptions(&runtime_options, callbacks_.get())) {
+      return false;
+    }
+    return CreateRuntime(std::move(runtime_options));
+  }
+
+  int GetCompilationServerFd() const {
+    return compilation_server_fd_;
+  }
+
   // Check whether the oat output files are writable, and open them for later. Also open a swap
   // file, if a name is given.
   bool OpenFile() {
@@ -2076,6 +2192,7 @@ class Dex2Oat final {
                                      compiler_kind_,
                                      thread_count_,
                                      swap_fd_));
+    driver_->SetMemoryBudget(memory_budget_);
 
     driver_->PrepareDexFilesForOatFile(timings_);
 
@@ -2592,14 +2709,19 @@ class Dex2Oat final {
       // Don't use swap, we know generation should succeed, and we don't want to slow it down.
       return false;
     }
-    if (dex_files.size() < min_dex_files_for_swap_) {
-      // If there are less dex files than the threshold, assume it's gonna be fine.
-      return false;
-    }
     size_t dex_files_size = 0;
     for (const auto* dex_file : dex_files) {
       dex_files_size += dex_file->GetHeader().file_size_;
     }
+    if (memory_budget_ != 0u && GetResidentSetSize() + dex_files_size > memory_budget_) {
+      // The compiled code is expected to be about as large as the dex code, so keep it in
+      // the swap file when it would not fit in the remaining budget.
+      return true;
+    }
+    if (dex_files.size() < min_dex_files_for_swap_) {
+      // If there are less dex files than the threshold, assume it's gonna be fine.
+      return false;
+    }
     return dex_files_size >= min_dex_file_cumulative_size_for_swap_;
   }
 
@@ -2732,6 +2854,7 @@ class Dex2Oat final {
     oat_writers_.reserve(oat_files_.size());
     for (const std::unique_ptr<File>& oat_file : oat_files_) {
       elf_writers_.emplace_back(linker::CreateElfWriterQuick(*compiler_options_, oat_file.get()));
+      elf_writers_.back()->SetDebugInfoThreadCount(thread_count_);
       elf_writers_.back()->Start();
       bool do_oat_writer_layout = DoDexLayoutOptimizations() || DoOatLayoutOptimizations();
       if (profile_compilation_info_ != nullptr && profile_compilation_info_->IsEmpty()) {
@@ -2742,6 +2865,7 @@ class Dex2Oat final {
           timings_,
           do_oat_writer_layout ? profile_compilation_info_.get() : nullptr,
           compact_dex_level_));
+      oat_writers_.back()->SetDexLayoutThreadCount(thread_count_);
     }
   }
 
@@ -2814,6 +2938,10 @@ class Dex2Oat final {
 
   // Create a runtime necessary for compilation.
   bool CreateRuntime(RuntimeArgumentMap&& runtime_options) {
+    if (compilation_server != nullptr) {
+      return UseCompilationServerRuntime(*compilation_server);
+    }
+
     // To make identity hashcode deterministic, set a seed based on the dex file checksums.
     // That makes the seed also most likely different for different inputs, for example
     // for primary boot image and different extensions that could be loaded together.
@@ -2854,6 +2982,33 @@ class Dex2Oat final {
     return true;
   }
 
+  // Use the runtime that the compilation server created before forking this process, if the
+  // request did not ask for a different one.
+  bool UseCompilationServerRuntime(const Dex2Oat& server) {
+    if (IsBootImage() || IsBootImageExtension()) {
+      LOG(ERROR) << "The compilation server does not compile boot images";
+      return false;
+    }
+    if (boot_image_filename_ != server.boot_image_filename_ ||
+        !std::equal(runtime_args_.begin(),
+                    runtime_args_.end(),
+                    server.runtime_args_.begin(),
+                    server.runtime_args_.end(),
+                    [](const char* lhs, const char* rhs) { return strcmp(lhs, rhs) == 0; }) ||
+        compiler_options_->GetInstructionSet() != server.compiler_options_->GetInstructionSet()) {
+      LOG(ERROR) << "The request does not match the runtime of the compilation server";
+      return false;
+    }
+    // See CreateRuntime(). Identity hash codes handed out by the server before the fork are
+    // unaffected, but no app objects exist yet.
+    mirror::Object::SetHashCodeSeed(987654321u ^ GetCombinedChecksums());
+
+    runtime_.reset(Runtime::Current());
+    runtime_->SetCompilerCallbacks(callbacks_.get());
+    WatchDog::SetRuntime(runtime_.get());
+    return true;
+  }
+
   // Let the ImageWriter write the image files. If we do not compile PIC, also fix up the oat files.
   bool CreateImageFile()
       REQUIRES(!Locks::mutator_lock_) {
@@ -2872,7 +3027,8 @@ class Dex2Oat final {
     }
     if (!image_writer_->Write(IsAppImage() ? app_image_fd_ : image_fd_,
                               image_filenames_,
-                              IsAppImage() ? 1u : dex_locations_.size())) {
+                              IsAppImage() ? 1u : dex_locations_.size(),
+                              thread_count_)) {
       LOG(ERROR) << "Failure during image file creation";
       return false;
     }
@@ -2964,7 +3120,9 @@ class Dex2Oat final {
               << " (" << PrettyDuration(ProcessCpuNanoTime() - start_cputime_ns_) << " cpu)"
               << " (threads: " << thread_count_ << ") "
               << ((Runtime::Current() != nullptr && driver_ != nullptr) ?
-                  driver_->GetMemoryUsageString(kIsDebugBuild || VLOG_IS_ON(compiler)) :
+                  driver_->GetMemoryUsageString(kIsDebugBuild ||
+                                                VLOG_IS_ON(compiler) ||
+                                                compiler_options_->GetDumpStats()) :
                   "");
   }
 
@@ -3036,6 +3194,7 @@ class Dex2Oat final {
   std::vector<const char*> runtime_args_;
   std::vector<std::string> image_filenames_;
   int image_fd_;
+  int compilation_server_fd_;
   bool have_multi_image_arg_;
   bool multi_image_;
   uintptr_t image_base_;
@@ -3067,6 +3226,7 @@ class Dex2Oat final {
   size_t min_dex_files_for_swap_ = kDefaultMinDexFilesForSwap;
   size_t min_dex_file_cumulative_size_for_swap_ = kDefaultMinDexFileCumulativeSizeForSwap;
   size_t very_large_threshold_ = std::numeric_limits<size_t>::max();
+  size_t memory_budget_ = 0u;
   std::string app_image_file_name_;
   int app_image_fd_;
   std::string profile_file_;
@@ -3217,9 +3377,24 @@ static dex2oat::ReturnCode CompileApp(Dex2Oat& dex2oat) {
   return dex2oat::ReturnCode::kNoFailure;
 }
 
+static bool IsCompilationServer(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (android::base::StartsWith(argv[i], "--compilation-server-fd=")) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static dex2oat::ReturnCode RunCompilationServer(int argc, char** argv);
+
 static dex2oat::ReturnCode Dex2oat(int argc, char** argv) {
   b13564922();
 
+  if (IsCompilationServer(argc, argv)) {
+    return RunCompilationServer(argc, argv);
+  }
+
   TimingLogger timings("compiler", false, false);
 
   // Allocate `dex2oat` on the heap instead of on the stack, as Clang
@@ -3297,6 +3472,80 @@ static dex2oat::ReturnCode Dex2oat(int argc, char** argv) {
 
   return result;
 }
+
+// Serve the compilation requests of the clients accepted on the --compilation-server-fd socket,
+// one at a time, until accept() fails. Each request is compiled by a process forked after the
+// runtime and the boot image have been loaded, so that a request cannot affect the following
+// ones and runs under the usual limits, such as the watchdog.
+static dex2oat::ReturnCode RunCompilationServer(int argc, char** argv) {
+  TimingLogger timings("compilation server", false, false);
+  std::unique_ptr<Dex2Oat> server = std::make_unique<Dex2Oat>(&timings);
+  server->ParseCompilationServerArgs(argc, argv);
+  art::MemMap::Init();
+  if (!server->CreateCompilationServerRuntime()) {
+    return dex2oat::ReturnCode::kCreateRuntime;
+  }
+
+  // The requests are compiled with the arguments of the server followed by their own.
+  std::vector<std::string> server_args;
+  for (int i = 0; i < argc; ++i) {
+    if (!android::base::StartsWith(argv[i], "--compilation-server-fd=")) {
+      server_args.push_back(argv[i]);
+    }
+  }
+
+  const int server_fd = server->GetCompilationServerFd();
+  LOG(INFO) << "Serving compilation requests on fd " << server_fd;
+  while (true) {
+    android::base::unique_fd connection(
+        TEMP_FAILURE_RETRY(accept4(server_fd, nullptr, nullptr, SOCK_CLOEXEC)));
+    if (connection == -1) {
+      PLOG(INFO) << "Stopping compilation server";
+      return dex2oat::ReturnCode::kNoFailure;
+    }
+    std::vector<std::string> request_args;
+    std::vector<android::base::unique_fd> request_fds;
+    std::string error_msg;
+    if (!ReceiveCompilationRequest(connection.get(), &request_args, &request_fds, &error_msg)) {
+      if (!error_msg.empty()) {
+        LOG(ERROR) << "Invalid compilation request: " << error_msg;
+      }
+      continue;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+      // The received file descriptors stay open until the compilation exits.
+      std::vector<std::string> args = server_args;
+      args.insert(args.end(), request_args.begin(), request_args.end());
+      std::vector<char*> child_argv;
+      for (std::string& arg : args) {
+        child_argv.push_back(arg.data());
+      }
+      child_argv.push_back(nullptr);
+      compilation_server = server.get();
+      _exit(static_cast<int>(Dex2oat(static_cast<int>(args.size()), child_argv.data())));
+    }
+
+    int32_t exit_code = -1;
+    if (pid == -1) {
+      PLOG(ERROR) << "Failed to fork for compilation request";
+    } else {
+      int status;
+      if (TEMP_FAILURE_RETRY(waitpid(pid, &status, 0)) != pid) {
+        PLOG(ERROR) << "Failed to wait for compilation " << pid;
+      } else if (WIFEXITED(status)) {
+        exit_code = WEXITSTATUS(status);
+      } else {
+        LOG(ERROR) << "Compilation " << pid << " did not exit, status " << status;
+      }
+    }
+    request_fds.clear();
+    if (!SendCompilationResult(connection.get(), exit_code, &error_msg)) {
+      LOG(WARNING) << error_msg;
+    }
+  }
+}
 }  // namespace art
 
 int main(int argc, char** argv) {
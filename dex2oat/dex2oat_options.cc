@@ -155,7 +155,10 @@ static void AddSwapMappings(Builder& builder) {
           .IntoKey(M::SwapDexSizeThreshold)
       .Define("--swap-dex-count-threshold=_")
           .WithType<unsigned int>()
-          .IntoKey(M::SwapDexCountThreshold);
+          .IntoKey(M::SwapDexCountThreshold)
+      .Define("--memory-budget=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::MemoryBudget);
 }
 
 static void AddCompilerMappings(Builder& builder) {
@@ -258,7 +261,10 @@ static Parser CreateArgumentParser() {
           .IntoKey(M::RuntimeOptions)
       .Define("--compilation-reason=_")
           .WithType<std::string>()
-          .IntoKey(M::CompilationReason);
+          .IntoKey(M::CompilationReason)
+      .Define("--compilation-server-fd=_")
+          .WithType<int>()
+          .IntoKey(M::CompilationServerFd);
 
   AddCompilerOptionsArgumentParserOptions<Dex2oatArgumentMap>(*parser_builder);
 
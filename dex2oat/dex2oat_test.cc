@@ -310,6 +310,13 @@ TEST_F(Dex2oatSwapTest, DoUseSwapSingleSmall) {
           { "--swap-dex-size-threshold=0", "--swap-dex-count-threshold=0" });
 }
 
+TEST_F(Dex2oatSwapTest, DoUseSwapMemoryBudget) {
+  // A budget below the current resident set size uses swap regardless of the thresholds and
+  // throttles compilation down to a single thread.
+  RunTest(/*use_fd=*/ false, /*expect_use=*/ true, { "--memory-budget=1", "-j4" });
+  RunTest(/*use_fd=*/ true, /*expect_use=*/ true, { "--memory-budget=1", "-j4" });
+}
+
 class Dex2oatSwapUseTest : public Dex2oatSwapTest {
  protected:
   void CheckHostResult(bool expect_use) override {
@@ -0,0 +1,506 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compiled_method_cache.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ostream>
+#include <sstream>
+#include <unordered_set>
+
+#include "android-base/stringprintf.h"
+
+#include "base/array_ref.h"
+#include "base/casts.h"
+#include "base/leb128.h"
+#include "base/logging.h"
+#include "base/os.h"
+#include "base/unix_file/fd_file.h"
+#include "base/utils.h"
+#include "compiled_method.h"
+#include "dex/dex_file-inl.h"
+#include "dex/method_reference.h"
+#include "driver/compiled_method_storage.h"
+#include "driver/compiler_options.h"
+#include "gc/heap.h"
+#include "gc/space/image_space.h"
+#include "linker/linker_patch.h"
+#include "profile/profile_compilation_info.h"
+#include "runtime.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+// Magic and version of the entry files. Bump the version when the entry format changes.
+static constexpr uint8_t kEntryMagic[] = { 'c', 'm', 'c', '\n' };
+static constexpr uint32_t kEntryVersion = 1u;
+
+// Dex file index stored for patches that do not reference a dex file. Other dex file
+// indexes are stored biased by one.
+static constexpr uint32_t kNoDexFile = 0u;
+
+// 64-bit FNV-1a. Used only to name the files, the full keys are compared on lookup.
+static uint64_t HashBytes(ArrayRef<const uint8_t> data) {
+  uint64_t hash = UINT64_C(0xcbf29ce484222325);
+  for (uint8_t value : data) {
+    hash = (hash ^ value) * UINT64_C(0x100000001b3);
+  }
+  return hash;
+}
+
+static void EncodeBytes(std::vector<uint8_t>* out, ArrayRef<const uint8_t> data) {
+  EncodeUnsignedLeb128(out, dchecked_integral_cast<uint32_t>(data.size()));
+  out->insert(out->end(), data.begin(), data.end());
+}
+
+// Reads back the values written with EncodeUnsignedLeb128() and EncodeBytes().
+// All reads fail on truncated data.
+class EntryReader {
+ public:
+  explicit EntryReader(ArrayRef<const uint8_t> data)
+      : ptr_(data.data()), end_(data.data() + data.size()) {}
+
+  bool ReadUint32(/*out*/ uint32_t* value) {
+    return DecodeUnsignedLeb128Checked(&ptr_, end_, value);
+  }
+
+  bool ReadBytes(/*out*/ ArrayRef<const uint8_t>* data) {
+    uint32_t size;
+    if (!ReadUint32(&size) || static_cast<size_t>(end_ - ptr_) < size) {
+      return false;
+    }
+    *data = ArrayRef<const uint8_t>(ptr_, size);
+    ptr_ += size;
+    return true;
+  }
+
+  bool IsAtEnd() const {
+    return ptr_ == end_;
+  }
+
+ private:
+  const uint8_t* ptr_;
+  const uint8_t* const end_;
+};
+
+static bool ReadFile(const std::string& path, /*out*/ std::vector<uint8_t>* data) {
+  std::unique_ptr<File> file(OS::OpenFileForReading(path.c_str()));
+  if (file == nullptr) {
+    return false;
+  }
+  int64_t length = file->GetLength();
+  if (length < 0) {
+    return false;
+  }
+  data->resize(static_cast<size_t>(length));
+  return file->ReadFully(data->data(), data->size());
+}
+
+// Write to a private file and rename it, so that other threads and processes sharing
+// the cache directory only ever see complete files.
+static bool WriteFileAtomically(const std::string& path, ArrayRef<const uint8_t> data) {
+  std::string temp_path = StringPrintf("%s.%d.%d.tmp", path.c_str(), getpid(), GetTid());
+  std::unique_ptr<File> file(OS::CreateEmptyFileWriteOnly(temp_path.c_str()));
+  if (file == nullptr) {
+    return false;
+  }
+  if (!file->WriteFully(data.data(), data.size())) {
+    file->Erase(/*unlink=*/ true);
+    return false;
+  }
+  if (file->FlushCloseOrErase() != 0 || rename(temp_path.c_str(), path.c_str()) != 0) {
+    unlink(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<CompiledMethodCache> CompiledMethodCache::Create(
+    const CompilerOptions& compiler_options,
+    const std::vector<const DexFile*>& dex_files) {
+  const std::string& root = compiler_options.GetCompiledMethodCacheDirectory();
+  DCHECK(!root.empty());
+
+  std::ostringstream oss;
+  oss << compiler_options.GetCompiledMethodCacheFingerprint();
+  for (const DexFile* dex_file : dex_files) {
+    oss << "\ndex-file=" << dex_file->GetLocation()
+        << StringPrintf(":%08x", dex_file->GetLocationChecksum());
+  }
+  for (gc::space::ImageSpace* space : Runtime::Current()->GetHeap()->GetBootImageSpaces()) {
+    oss << StringPrintf("\nboot-image=%08x", space->GetImageHeader().GetImageChecksum());
+  }
+  const std::string fingerprint = oss.str();
+  ArrayRef<const uint8_t> fingerprint_data(
+      reinterpret_cast<const uint8_t*>(fingerprint.data()), fingerprint.size());
+
+  std::string directory =
+      StringPrintf("%s/%016" PRIx64, root.c_str(), HashBytes(fingerprint_data));
+  if ((mkdir(root.c_str(), 0755) != 0 && errno != EEXIST) ||
+      (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)) {
+    PLOG(WARNING) << "Failed to create compiled method cache directory " << directory;
+    return nullptr;
+  }
+  // Keep the full fingerprint next to the entries to detect hash collisions.
+  std::string fingerprint_path = directory + "/fingerprint";
+  std::vector<uint8_t> existing_fingerprint;
+  if (ReadFile(fingerprint_path, &existing_fingerprint)) {
+    if (ArrayRef<const uint8_t>(existing_fingerprint) != fingerprint_data) {
+      LOG(WARNING) << "Fingerprint collision in compiled method cache " << directory;
+      return nullptr;
+    }
+  } else if (!WriteFileAtomically(fingerprint_path, fingerprint_data)) {
+    PLOG(WARNING) << "Failed to write compiled method cache fingerprint " << fingerprint_path;
+    return nullptr;
+  }
+  return std::unique_ptr<CompiledMethodCache>(
+      new CompiledMethodCache(compiler_options, std::move(directory), dex_files));
+}
+
+CompiledMethodCache::CompiledMethodCache(const CompilerOptions& compiler_options,
+                                         std::string directory,
+                                         const std::vector<const DexFile*>& dex_files)
+    : compiler_options_(compiler_options),
+      directory_(std::move(directory)),
+      dex_files_(dex_files),
+      dex_file_indexes_(),
+      num_hits_(0u),
+      num_misses_(0u),
+      num_stores_(0u) {
+  for (size_t i = 0; i != dex_files_.size(); ++i) {
+    dex_file_indexes_.emplace(dex_files_[i], dchecked_integral_cast<uint32_t>(i));
+  }
+}
+
+std::vector<uint8_t> CompiledMethodCache::GetKey(const DexFile& dex_file,
+                                                 const dex::CodeItem* code_item,
+                                                 uint32_t access_flags,
+                                                 InvokeType invoke_type,
+                                                 uint16_t class_def_idx,
+                                                 uint32_t method_idx) const {
+  std::vector<uint8_t> key;
+  auto it = dex_file_indexes_.find(&dex_file);
+  if (it == dex_file_indexes_.end() || code_item == nullptr) {
+    return key;
+  }
+  EncodeUnsignedLeb128(&key, it->second);
+  EncodeUnsignedLeb128(&key, method_idx);
+  EncodeUnsignedLeb128(&key, class_def_idx);
+  EncodeUnsignedLeb128(&key, access_flags);
+  EncodeUnsignedLeb128(&key, static_cast<uint32_t>(invoke_type));
+  EncodeBytes(&key, ArrayRef<const uint8_t>(reinterpret_cast<const uint8_t*>(code_item),
+                                            dex_file.GetCodeItemSize(*code_item)));
+
+  const ProfileCompilationInfo* profile = compiler_options_.GetProfileCompilationInfo();
+  if (profile != nullptr) {
+    MethodReference method_ref(&dex_file, method_idx);
+    ProfileCompilationInfo::MethodHotness hotness = profile->GetMethodHotness(method_ref);
+    EncodeUnsignedLeb128(&key, hotness.GetFlags());
+    std::unique_ptr<ProfileCompilationInfo::OfflineProfileMethodInfo> method_info =
+        hotness.IsHot() ? profile->GetHotMethodInfo(method_ref) : nullptr;
+    if (method_info != nullptr) {
+      // The inline caches decide which call targets are inlined.
+      const ProfileCompilationInfo::InlineCacheMap& inline_caches = *method_info->inline_caches;
+      EncodeUnsignedLeb128(&key, dchecked_integral_cast<uint32_t>(inline_caches.size()));
+      for (const auto& entry : inline_caches) {
+        const ProfileCompilationInfo::DexPcData& dex_pc_data = entry.second;
+        EncodeUnsignedLeb128(&key, entry.first);
+        EncodeUnsignedLeb128(&key, dex_pc_data.is_missing_types ? 1u : 0u);
+        EncodeUnsignedLeb128(&key, dex_pc_data.is_megamorphic ? 1u : 0u);
+        EncodeUnsignedLeb128(&key, dchecked_integral_cast<uint32_t>(dex_pc_data.classes.size()));
+        for (const ProfileCompilationInfo::ClassReference& class_ref : dex_pc_data.classes) {
+          const ProfileCompilationInfo::DexReference& dex_ref =
+              method_info->dex_references[class_ref.dex_profile_index];
+          EncodeUnsignedLeb128(&key, dex_ref.dex_checksum);
+          EncodeUnsignedLeb128(&key, dex_ref.num_method_ids);
+          EncodeUnsignedLeb128(&key, class_ref.type_index.index_);
+        }
+      }
+    } else {
+      EncodeUnsignedLeb128(&key, 0u);
+    }
+  }
+  return key;
+}
+
+std::string CompiledMethodCache::GetEntryPath(const std::vector<uint8_t>& key) const {
+  return StringPrintf(
+      "%s/%016" PRIx64, directory_.c_str(), HashBytes(ArrayRef<const uint8_t>(key)));
+}
+
+CompiledMethod* CompiledMethodCache::Lookup(const std::vector<uint8_t>& key,
+                                            CompiledMethodStorage* storage) {
+  DCHECK(!key.empty());
+  std::vector<uint8_t> data;
+  if (!ReadFile(GetEntryPath(key), &data)) {
+    ++num_misses_;
+    return nullptr;
+  }
+
+  // Decode the whole entry before allocating anything, so that a corrupt or colliding
+  // entry is simply treated as a miss.
+  EntryReader reader{ArrayRef<const uint8_t>(data)};
+  ArrayRef<const uint8_t> magic;
+  uint32_t version;
+  ArrayRef<const uint8_t> entry_key;
+  uint32_t instruction_set;
+  uint32_t is_intrinsic;
+  ArrayRef<const uint8_t> code;
+  ArrayRef<const uint8_t> vmap_table;
+  ArrayRef<const uint8_t> cfi_info;
+  uint32_t num_patches;
+  bool ok = reader.ReadBytes(&magic) &&
+            magic == ArrayRef<const uint8_t>(kEntryMagic) &&
+            reader.ReadUint32(&version) &&
+            version == kEntryVersion &&
+            reader.ReadBytes(&entry_key) &&
+            entry_key == ArrayRef<const uint8_t>(key) &&
+            reader.ReadUint32(&instruction_set) &&
+            instruction_set == static_cast<uint32_t>(compiler_options_.GetInstructionSet()) &&
+            reader.ReadUint32(&is_intrinsic) &&
+            reader.ReadBytes(&code) &&
+            reader.ReadBytes(&vmap_table) &&
+            reader.ReadBytes(&cfi_info) &&
+            reader.ReadUint32(&num_patches);
+  std::vector<linker::LinkerPatch> patches;
+  for (uint32_t i = 0; ok && i != num_patches; ++i) {
+    uint32_t type;
+    uint32_t literal_offset;
+    uint32_t dex_file_index;
+    uint32_t value1;
+    uint32_t value2;
+    ok = reader.ReadUint32(&type) &&
+         reader.ReadUint32(&literal_offset) &&
+         reader.ReadUint32(&dex_file_index) &&
+         reader.ReadUint32(&value1) &&
+         reader.ReadUint32(&value2) &&
+         dex_file_index <= dex_files_.size();
+    if (!ok) {
+      break;
+    }
+    const DexFile* dex_file =
+        (dex_file_index != kNoDexFile) ? dex_files_[dex_file_index - 1u] : nullptr;
+    switch (static_cast<linker::LinkerPatch::Type>(type)) {
+      case linker::LinkerPatch::Type::kIntrinsicReference:
+        patches.push_back(
+            linker::LinkerPatch::IntrinsicReferencePatch(literal_offset, value2, value1));
+        break;
+      case linker::LinkerPatch::Type::kDataBimgRelRo:
+        patches.push_back(
+            linker::LinkerPatch::DataBimgRelRoPatch(literal_offset, value2, value1));
+        break;
+      case linker::LinkerPatch::Type::kMethodRelative:
+        patches.push_back(
+            linker::LinkerPatch::RelativeMethodPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case linker::LinkerPatch::Type::kMethodBssEntry:
+        patches.push_back(
+            linker::LinkerPatch::MethodBssEntryPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case linker::LinkerPatch::Type::kCallRelative:
+        patches.push_back(
+            linker::LinkerPatch::RelativeCodePatch(literal_offset, dex_file, value1));
+        break;
+      case linker::LinkerPatch::Type::kTypeRelative:
+        patches.push_back(
+            linker::LinkerPatch::RelativeTypePatch(literal_offset, dex_file, value2, value1));
+        break;
+      case linker::LinkerPatch::Type::kTypeBssEntry:
+        patches.push_back(
+            linker::LinkerPatch::TypeBssEntryPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case linker::LinkerPatch::Type::kStringRelative:
+        patches.push_back(
+            linker::LinkerPatch::RelativeStringPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case linker::LinkerPatch::Type::kStringBssEntry:
+        patches.push_back(
+            linker::LinkerPatch::StringBssEntryPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case linker::LinkerPatch::Type::kCallEntrypoint:
+        patches.push_back(
+            linker::LinkerPatch::CallEntrypointPatch(literal_offset, value1, value2));
+        break;
+      case linker::LinkerPatch::Type::kBakerReadBarrierBranch:
+        patches.push_back(
+            linker::LinkerPatch::BakerReadBarrierBranchPatch(literal_offset, value1, value2));
+        break;
+      default:
+        ok = false;
+        break;
+    }
+  }
+  uint32_t num_thunks;
+  ok = ok && reader.ReadUint32(&num_thunks);
+  struct Thunk {
+    uint32_t patch_index;
+    ArrayRef<const uint8_t> debug_name;
+    ArrayRef<const uint8_t> code;
+  };
+  std::vector<Thunk> thunks;
+  for (uint32_t i = 0; ok && i != num_thunks; ++i) {
+    Thunk thunk;
+    ok = reader.ReadUint32(&thunk.patch_index) &&
+         thunk.patch_index < patches.size() &&
+         reader.ReadBytes(&thunk.debug_name) &&
+         reader.ReadBytes(&thunk.code) &&
+         !thunk.code.empty();
+    thunks.push_back(thunk);
+  }
+  if (!ok || !reader.IsAtEnd()) {
+    LOG(WARNING) << "Ignoring invalid compiled method cache entry " << GetEntryPath(key);
+    ++num_misses_;
+    return nullptr;
+  }
+
+  CompiledMethod* compiled_method = CompiledMethod::SwapAllocCompiledMethod(
+      storage,
+      compiler_options_.GetInstructionSet(),
+      code,
+      vmap_table,
+      cfi_info,
+      ArrayRef<const linker::LinkerPatch>(patches));
+  if (is_intrinsic != 0u) {
+    compiled_method->MarkAsIntrinsic();
+  }
+  for (const Thunk& thunk : thunks) {
+    const linker::LinkerPatch& patch = patches[thunk.patch_index];
+    if (storage->GetThunkCode(patch).empty()) {
+      std::string debug_name(reinterpret_cast<const char*>(thunk.debug_name.data()),
+                             thunk.debug_name.size());
+      storage->SetThunkCode(patch, thunk.code, debug_name);
+    }
+  }
+  ++num_hits_;
+  return compiled_method;
+}
+
+void CompiledMethodCache::Insert(const std::vector<uint8_t>& key,
+                                 const CompiledMethod* compiled_method,
+                                 CompiledMethodStorage* storage) {
+  DCHECK(!key.empty());
+  DCHECK(compiled_method != nullptr);
+  std::vector<uint8_t> data;
+  EncodeBytes(&data, ArrayRef<const uint8_t>(kEntryMagic));
+  EncodeUnsignedLeb128(&data, kEntryVersion);
+  EncodeBytes(&data, ArrayRef<const uint8_t>(key));
+  EncodeUnsignedLeb128(&data, static_cast<uint32_t>(compiled_method->GetInstructionSet()));
+  EncodeUnsignedLeb128(&data, compiled_method->IsIntrinsic() ? 1u : 0u);
+  EncodeBytes(&data, compiled_method->GetQuickCode());
+  EncodeBytes(&data, compiled_method->GetVmapTable());
+  EncodeBytes(&data, compiled_method->GetCFIInfo());
+
+  ArrayRef<const linker::LinkerPatch> patches = compiled_method->GetPatches();
+  EncodeUnsignedLeb128(&data, dchecked_integral_cast<uint32_t>(patches.size()));
+  for (const linker::LinkerPatch& patch : patches) {
+    const DexFile* dex_file = nullptr;
+    uint32_t value1 = 0u;
+    uint32_t value2 = 0u;
+    switch (patch.GetType()) {
+      case linker::LinkerPatch::Type::kIntrinsicReference:
+        value1 = patch.IntrinsicData();
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kDataBimgRelRo:
+        value1 = patch.BootImageOffset();
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kMethodRelative:
+      case linker::LinkerPatch::Type::kMethodBssEntry:
+        dex_file = patch.TargetMethod().dex_file;
+        value1 = patch.TargetMethod().index;
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kCallRelative:
+        dex_file = patch.TargetMethod().dex_file;
+        value1 = patch.TargetMethod().index;
+        break;
+      case linker::LinkerPatch::Type::kTypeRelative:
+      case linker::LinkerPatch::Type::kTypeBssEntry:
+        dex_file = patch.TargetTypeDexFile();
+        value1 = patch.TargetTypeIndex().index_;
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kStringRelative:
+      case linker::LinkerPatch::Type::kStringBssEntry:
+        dex_file = patch.TargetStringDexFile();
+        value1 = patch.TargetStringIndex().index_;
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kCallEntrypoint:
+        value1 = patch.EntrypointOffset();
+        value2 = patch.EntrypointArguments();
+        break;
+      case linker::LinkerPatch::Type::kBakerReadBarrierBranch:
+        value1 = patch.GetBakerCustomValue1();
+        value2 = patch.GetBakerCustomValue2();
+        break;
+    }
+    uint32_t dex_file_index = kNoDexFile;
+    if (dex_file != nullptr) {
+      auto it = dex_file_indexes_.find(dex_file);
+      if (it == dex_file_indexes_.end()) {
+        // The patch cannot be described by the cache key, do not store the method.
+        return;
+      }
+      dex_file_index = it->second + 1u;
+    }
+    EncodeUnsignedLeb128(&data, static_cast<uint32_t>(patch.GetType()));
+    EncodeUnsignedLeb128(&data, dchecked_integral_cast<uint32_t>(patch.LiteralOffset()));
+    EncodeUnsignedLeb128(&data, dex_file_index);
+    EncodeUnsignedLeb128(&data, value1);
+    EncodeUnsignedLeb128(&data, value2);
+  }
+
+  // Patches of the same kind often share a thunk; store each thunk once.
+  std::vector<uint8_t> thunk_data;
+  uint32_t num_thunks = 0u;
+  std::unordered_set<const uint8_t*> seen_thunks;
+  for (size_t i = 0; i != patches.size(); ++i) {
+    std::string debug_name;
+    ArrayRef<const uint8_t> thunk_code = storage->GetThunkCode(patches[i], &debug_name);
+    if (!thunk_code.empty() && seen_thunks.insert(thunk_code.data()).second) {
+      EncodeUnsignedLeb128(&thunk_data, dchecked_integral_cast<uint32_t>(i));
+      EncodeBytes(&thunk_data, ArrayRef<const uint8_t>(
+          reinterpret_cast<const uint8_t*>(debug_name.data()), debug_name.size()));
+      EncodeBytes(&thunk_data, thunk_code);
+      ++num_thunks;
+    }
+  }
+  EncodeUnsignedLeb128(&data, num_thunks);
+  data.insert(data.end(), thunk_data.begin(), thunk_data.end());
+
+  if (WriteFileAtomically(GetEntryPath(key), ArrayRef<const uint8_t>(data))) {
+    ++num_stores_;
+  } else {
+    VLOG(compiler) << "Failed to write compiled method cache entry " << GetEntryPath(key);
+  }
+}
+
+void CompiledMethodCache::DumpStats(std::ostream& os) const {
+  os << "Compiled method cache " << directory_ << ": "
+     << num_hits_.load(std::memory_order_relaxed) << " hits, "
+     << num_misses_.load(std::memory_order_relaxed) << " misses, "
+     << num_stores_.load(std::memory_order_relaxed) << " stored";
+}
+
+}  // namespace art
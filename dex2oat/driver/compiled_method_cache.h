@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DEX2OAT_DRIVER_COMPILED_METHOD_CACHE_H_
+#define ART_DEX2OAT_DRIVER_COMPILED_METHOD_CACHE_H_
+
+#include <atomic>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "dex/invoke_type.h"
+
+namespace art {
+
+class CompiledMethod;
+class CompiledMethodStorage;
+class CompilerOptions;
+class DexFile;
+
+namespace dex {
+struct CodeItem;
+}  // namespace dex
+
+// A content-addressed cache of compiled methods in a directory shared by dex2oat runs.
+//
+// The key of an entry consists of the dex code and profile data of the method, the compiler
+// options and the checksums of all dex files visible to the compilation. The compiler does not
+// record which facts about other classes the code depends on (field offsets, resolved and
+// inlined methods, initialized classes), so the class hierarchy part of the key conservatively
+// covers every dex file. A method is therefore recompiled when any dex file changes, but not
+// when only the profile data of other methods changes.
+class CompiledMethodCache {
+ public:
+  // Returns null and logs a warning if the cache directory cannot be used.
+  static std::unique_ptr<CompiledMethodCache> Create(const CompilerOptions& compiler_options,
+                                                     const std::vector<const DexFile*>& dex_files);
+
+  // Returns the key of the method, or an empty key if the method cannot be cached.
+  std::vector<uint8_t> GetKey(const DexFile& dex_file,
+                              const dex::CodeItem* code_item,
+                              uint32_t access_flags,
+                              InvokeType invoke_type,
+                              uint16_t class_def_idx,
+                              uint32_t method_idx) const;
+
+  // Returns the cached method allocated in `storage`, or null if there is no matching entry.
+  // The thunks needed by the patches of the method are added to `storage` as well.
+  CompiledMethod* Lookup(const std::vector<uint8_t>& key, CompiledMethodStorage* storage);
+
+  // Stores a newly compiled method, together with the thunks needed by its patches.
+  void Insert(const std::vector<uint8_t>& key,
+              const CompiledMethod* compiled_method,
+              CompiledMethodStorage* storage);
+
+  void DumpStats(std::ostream& os) const;
+
+ private:
+  CompiledMethodCache(const CompilerOptions& compiler_options,
+                      std::string directory,
+                      const std::vector<const DexFile*>& dex_files);
+
+  std::string GetEntryPath(const std::vector<uint8_t>& key) const;
+
+  const CompilerOptions& compiler_options_;
+
+  // Subdirectory holding the entries for one fingerprint of the options and dex files.
+  const std::string directory_;
+
+  // All dex files visible to the compilation. Linker patches refer to them by index.
+  std::vector<const DexFile*> dex_files_;
+  std::unordered_map<const DexFile*, uint32_t> dex_file_indexes_;
+
+  std::atomic<size_t> num_hits_;
+  std::atomic<size_t> num_misses_;
+  std::atomic<size_t> num_stores_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompiledMethodCache);
+};
+
+}  // namespace art
+
+#endif  // ART_DEX2OAT_DRIVER_COMPILED_METHOD_CACHE_H_
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "driver/compiled_method_cache.h"
+
+#include "common_compiler_test.h"
+#include "compiled_method-inl.h"
+#include "dex/class_accessor-inl.h"
+#include "driver/compiled_method_storage.h"
+#include "driver/compiler_options.h"
+#include "linker/linker_patch.h"
+
+namespace art {
+
+class CompiledMethodCacheTest : public CommonCompilerTest {};
+
+TEST_F(CompiledMethodCacheTest, InsertAndLookup) {
+  ScratchDir cache_dir;
+  std::string error_msg;
+  ASSERT_TRUE(compiler_options_->ParseCompilerOptions(
+      { "--compiled-method-cache=" + cache_dir.GetPath() },
+      /*ignore_unrecognized=*/ false,
+      &error_msg)) << error_msg;
+
+  const DexFile* dex_file = java_lang_dex_file_;
+  std::vector<const DexFile*> dex_files = { dex_file };
+  std::unique_ptr<CompiledMethodCache> cache =
+      CompiledMethodCache::Create(*compiler_options_, dex_files);
+  ASSERT_TRUE(cache != nullptr);
+
+  // Get the keys of two methods with code.
+  std::vector<std::vector<uint8_t>> keys;
+  for (ClassAccessor accessor : dex_file->GetClasses()) {
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      if (method.GetCodeItem() != nullptr && keys.size() != 2u) {
+        keys.push_back(cache->GetKey(*dex_file,
+                                     method.GetCodeItem(),
+                                     method.GetAccessFlags(),
+                                     method.GetInvokeType(accessor.GetClassDef().access_flags_),
+                                     accessor.GetClassDefIndex(),
+                                     method.GetIndex()));
+      }
+    }
+  }
+  ASSERT_EQ(2u, keys.size());
+  const std::vector<uint8_t>& key1 = keys[0];
+  const std::vector<uint8_t>& key2 = keys[1];
+  ASSERT_FALSE(key1.empty());
+  ASSERT_FALSE(key2.empty());
+
+  CompiledMethodStorage storage(/* swap_fd= */ -1);
+  EXPECT_TRUE(cache->Lookup(key1, &storage) == nullptr);
+
+  const uint8_t raw_code[] = { 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u, 11u, 12u, 13u, 14u };
+  const uint8_t raw_vmap_table[] = { 2, 4, 6 };
+  const uint8_t raw_cfi_info[] = { 1, 3, 5 };
+  const uint8_t raw_thunk[] = { 9, 8, 7 };
+  const linker::LinkerPatch raw_patches[] = {
+      linker::LinkerPatch::RelativeTypePatch(0u, dex_file, 0u, 1u),
+      linker::LinkerPatch::StringBssEntryPatch(4u, dex_file, 2u, 3u),
+      linker::LinkerPatch::CallEntrypointPatch(8u, 16u),
+      linker::LinkerPatch::BakerReadBarrierBranchPatch(12u, 5u, 6u),
+  };
+  ArrayRef<const linker::LinkerPatch> patches(raw_patches);
+  storage.SetThunkCode(patches[3], ArrayRef<const uint8_t>(raw_thunk), "thunk");
+  CompiledMethod* compiled_method = CompiledMethod::SwapAllocCompiledMethod(
+      &storage,
+      compiler_options_->GetInstructionSet(),
+      ArrayRef<const uint8_t>(raw_code),
+      ArrayRef<const uint8_t>(raw_vmap_table),
+      ArrayRef<const uint8_t>(raw_cfi_info),
+      patches);
+  cache->Insert(key1, compiled_method, &storage);
+  CompiledMethod::ReleaseSwapAllocatedCompiledMethod(&storage, compiled_method);
+
+  // A new cache for the same options and dex files finds the entry.
+  cache = CompiledMethodCache::Create(*compiler_options_, dex_files);
+  ASSERT_TRUE(cache != nullptr);
+  CompiledMethodStorage other_storage(/* swap_fd= */ -1);
+  EXPECT_TRUE(cache->Lookup(key2, &other_storage) == nullptr);
+  CompiledMethod* cached_method = cache->Lookup(key1, &other_storage);
+  ASSERT_TRUE(cached_method != nullptr);
+  EXPECT_EQ(compiler_options_->GetInstructionSet(), cached_method->GetInstructionSet());
+  EXPECT_TRUE(cached_method->GetQuickCode() == ArrayRef<const uint8_t>(raw_code));
+  EXPECT_TRUE(cached_method->GetVmapTable() == ArrayRef<const uint8_t>(raw_vmap_table));
+  EXPECT_TRUE(cached_method->GetCFIInfo() == ArrayRef<const uint8_t>(raw_cfi_info));
+  EXPECT_TRUE(cached_method->GetPatches() == patches);
+  std::string debug_name;
+  EXPECT_TRUE(other_storage.GetThunkCode(patches[3], &debug_name) ==
+              ArrayRef<const uint8_t>(raw_thunk));
+  EXPECT_EQ("thunk", debug_name);
+  CompiledMethod::ReleaseSwapAllocatedCompiledMethod(&other_storage, cached_method);
+}
+
+}  // namespace art
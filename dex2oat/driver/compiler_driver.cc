@@ -22,6 +22,7 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <atomic>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
@@ -42,6 +43,7 @@
 #include "base/systrace.h"
 #include "base/time_utils.h"
 #include "base/timing_logger.h"
+#include "base/utils.h"
 #include "class_linker-inl.h"
 #include "compiled_method-inl.h"
 #include "compiler.h"
@@ -55,6 +57,7 @@
 #include "dex/dex_to_dex_compiler.h"
 #include "dex/verification_results.h"
 #include "dex/verified_method.h"
+#include "driver/compiled_method_cache.h"
 #include "driver/compiler_options.h"
 #include "driver/dex_compilation_unit.h"
 #include "gc/accounting/card_table-inl.h"
@@ -62,6 +65,7 @@
 #include "gc/space/image_space.h"
 #include "gc/space/space.h"
 #include "handle_scope-inl.h"
+#include "interpreter/unstarted_runtime.h"
 #include "intrinsics_enum.h"
 #include "intrinsics_list.h"
 #include "jni/jni_internal.h"
@@ -264,8 +268,9 @@ CompilerDriver::CompilerDriver(
       number_of_soft_verifier_failures_(0),
       had_hard_verifier_failure_(false),
       parallel_thread_count_(thread_count),
+      memory_budget_(0u),
       stats_(new AOTCompilationStats),
-      compiled_method_storage_(swap_fd),
+      compiled_method_storage_(swap_fd, thread_count),
       max_arena_alloc_(0),
       dex_to_dex_compiler_(this) {
   DCHECK(compiler_options_ != nullptr);
@@ -584,15 +589,29 @@ static void CompileMethodQuick(
               driver->ShouldCompileBasedOnProfile(method_ref);
 
       if (compile) {
-        // NOTE: if compiler declines to compile this method, it will return null.
-        compiled_method = driver->GetCompiler()->Compile(code_item,
-                                                         access_flags,
-                                                         invoke_type,
-                                                         class_def_idx,
-                                                         method_idx,
-                                                         class_loader,
-                                                         dex_file,
-                                                         dex_cache);
+        CompiledMethodCache* cache = driver->GetCompiledMethodCache();
+        std::vector<uint8_t> cache_key;
+        if (cache != nullptr) {
+          cache_key = cache->GetKey(
+              dex_file, code_item, access_flags, invoke_type, class_def_idx, method_idx);
+          if (!cache_key.empty()) {
+            compiled_method = cache->Lookup(cache_key, driver->GetCompiledMethodStorage());
+          }
+        }
+        if (compiled_method == nullptr) {
+          // NOTE: if compiler declines to compile this method, it will return null.
+          compiled_method = driver->GetCompiler()->Compile(code_item,
+                                                           access_flags,
+                                                           invoke_type,
+                                                           class_def_idx,
+                                                           method_idx,
+                                                           class_loader,
+                                                           dex_file,
+                                                           dex_cache);
+          if (compiled_method != nullptr && !cache_key.empty()) {
+            cache->Insert(cache_key, compiled_method, driver->GetCompiledMethodStorage());
+          }
+        }
         ProfileMethodsCheck check_type =
             driver->GetCompilerOptions().CheckProfiledMethodsCompiled();
         if (UNLIKELY(check_type != ProfileMethodsCheck::kNone)) {
@@ -955,7 +974,8 @@ bool CompilerDriver::ShouldCompileBasedOnProfile(const MethodReference& method_r
   }
   // Compile only hot methods, it is the profile saver's job to decide what startup methods to mark
   // as hot.
-  bool result = profile_compilation_info->GetMethodHotness(method_ref).IsHot();
+  bool result = profile_compilation_info->GetMethodHotness(method_ref).IsHot() ||
+      baseline_methods_.find(method_ref) != baseline_methods_.end();
 
   if (kDebugProfileGuidedCompilation) {
     LOG(INFO) << "[ProfileGuidedCompilation] "
@@ -1448,7 +1468,10 @@ class ParallelCompilationManager {
       compiler_(compiler),
       dex_file_(dex_file),
       dex_files_(dex_files),
-      thread_pool_(thread_pool) {}
+      thread_pool_(thread_pool),
+      memory_budget_(0u),
+      active_work_units_(0u),
+      allowed_work_units_(0u) {}
 
   ClassLinker* GetClassLinker() const {
     CHECK(class_linker_ != nullptr);
@@ -1473,6 +1496,13 @@ class ParallelCompilationManager {
     return dex_files_;
   }
 
+  // Limit the resident set size of the process while running the work units. When the budget
+  // is exceeded, arena pool memory is reclaimed and work units stop one at a time, so that
+  // fewer methods are compiled concurrently. The last work unit always runs to completion.
+  void SetMemoryBudget(size_t memory_budget) {
+    memory_budget_ = memory_budget;
+  }
+
   void ForAll(size_t begin, size_t end, CompilationVisitor* visitor, size_t work_units)
       REQUIRES(!*Locks::mutator_lock_) {
     ForAllLambda(begin, end, [visitor](size_t index) { visitor->Visit(index); }, work_units);
@@ -1486,6 +1516,8 @@ class ParallelCompilationManager {
     CHECK_GT(work_units, 0U);
 
     index_.store(begin, std::memory_order_relaxed);
+    active_work_units_.store(work_units, std::memory_order_relaxed);
+    allowed_work_units_.store(work_units, std::memory_order_relaxed);
     for (size_t i = 0; i < work_units; ++i) {
       thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn));
     }
@@ -1506,7 +1538,32 @@ class ParallelCompilationManager {
     return index_.fetch_add(1, std::memory_order_seq_cst);
   }
 
+  // Returns whether the calling work unit should stop to stay within the memory budget.
+  bool ShouldStopWorkUnit(size_t index) {
+    if (LIKELY(memory_budget_ == 0u)) {
+      return false;
+    }
+    if (index % kMemoryBudgetCheckInterval == 0u && GetResidentSetSize() > memory_budget_) {
+      Runtime::Current()->ReclaimArenaPoolMemory();
+      size_t allowed = allowed_work_units_.load(std::memory_order_relaxed);
+      if (allowed > 1u &&
+          allowed_work_units_.compare_exchange_strong(allowed, allowed - 1u)) {
+        VLOG(compiler) << "Memory budget exceeded, reducing work units to " << (allowed - 1u);
+      }
+    }
+    size_t active = active_work_units_.load(std::memory_order_relaxed);
+    while (active > allowed_work_units_.load(std::memory_order_relaxed)) {
+      if (active_work_units_.compare_exchange_weak(active, active - 1u)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
  private:
+  // Number of indexes between two reads of the resident set size.
+  static constexpr size_t kMemoryBudgetCheckInterval = 16u;
+
   template <typename Fn>
   class ForAllClosureLambda : public Task {
    public:
@@ -1523,6 +1580,9 @@ class ParallelCompilationManager {
         }
         fn_(index);
         self->AssertNoPendingException();
+        if (UNLIKELY(manager_->ShouldStopWorkUnit(index))) {
+          break;
+        }
       }
     }
 
@@ -1543,6 +1603,9 @@ class ParallelCompilationManager {
   const DexFile* const dex_file_;
   const std::vector<const DexFile*>& dex_files_;
   ThreadPool* const thread_pool_;
+  size_t memory_budget_;
+  std::atomic<size_t> active_work_units_;
+  std::atomic<size_t> allowed_work_units_;
 
   DISALLOW_COPY_AND_ASSIGN(ParallelCompilationManager);
 };
@@ -2647,6 +2710,18 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
     InitializeArrayClassesAndCreateConflictTablesVisitor visitor(hs);
     Runtime::Current()->GetClassLinker()->VisitClassesWithoutClassesLock(&visitor);
     visitor.FillAllIMTAndConflictTables();
+
+    // Report the unsupported native methods that most often prevented initialization.
+    static constexpr size_t kMaxReportedNativeMethods = 10u;
+    std::ostringstream oss;
+    interpreter::UnstartedRuntime::DumpUnsupportedNativeMethods(oss, kMaxReportedNativeMethods);
+    if (!oss.str().empty()) {
+      VLOG(compiler) << "Native methods aborting class initialization:\n" << oss.str();
+      std::ostream* file_log = GetCompilerOptions().GetInitFailureOutput();
+      if (file_log != nullptr) {
+        *file_log << "Native methods aborting class initialization:\n" << oss.str();
+      }
+    }
   }
   if (GetCompilerOptions().IsBootImage() || GetCompilerOptions().IsBootImageExtension()) {
     // Prune garbage objects created during aborted transactions.
@@ -2671,6 +2746,7 @@ static void CompileDexFile(CompilerDriver* driver,
                                      &dex_file,
                                      dex_files,
                                      thread_pool);
+  context.SetMemoryBudget(driver->GetMemoryBudget());
 
   auto compile = [&context, &compile_fn](size_t class_def_index) {
     const DexFile& dex_file = *context.GetDexFile();
@@ -2756,6 +2832,25 @@ void CompilerDriver::Compile(jobject class_loader,
             : profile_compilation_info->DumpInfo(dex_files));
   }
 
+  if (!GetCompilerOptions().GetCompiledMethodCacheDirectory().empty()) {
+    // The compiled code can refer to any dex file visible to the compilation.
+    std::vector<const DexFile*> visible_dex_files;
+    std::unordered_set<const DexFile*> seen_dex_files;
+    auto add_dex_files = [&](const std::vector<const DexFile*>& list) {
+      for (const DexFile* dex_file : list) {
+        if (seen_dex_files.insert(dex_file).second) {
+          visible_dex_files.push_back(dex_file);
+        }
+      }
+    };
+    add_dex_files(Runtime::Current()->GetClassLinker()->GetBootClassPath());
+    add_dex_files(classpath_dex_files_);
+    add_dex_files(dex_files);
+    compiled_method_cache_ = CompiledMethodCache::Create(GetCompilerOptions(), visible_dex_files);
+  }
+
+  CollectBaselineMethods(dex_files, timings);
+
   dex_to_dex_compiler_.ClearState();
   for (const DexFile* dex_file : dex_files) {
     CHECK(dex_file != nullptr);
@@ -2791,9 +2886,58 @@ void CompilerDriver::Compile(jobject class_loader,
     dex_to_dex_compiler_.ClearState();
   }
 
+  if (compiled_method_cache_ != nullptr) {
+    std::ostringstream oss;
+    compiled_method_cache_->DumpStats(oss);
+    LOG(INFO) << oss.str();
+    compiled_method_cache_.reset();
+  }
+
+  baseline_methods_.clear();
+
   VLOG(compiler) << "Compile: " << GetMemoryUsageString(false);
 }
 
+void CompilerDriver::CollectBaselineMethods(const std::vector<const DexFile*>& dex_files,
+                                            TimingLogger* timings) {
+  baseline_methods_.clear();
+  const ProfileCompilationInfo* profile_compilation_info =
+      GetCompilerOptions().GetProfileCompilationInfo();
+  if (GetCompilerOptions().GetCompilerFilter() != CompilerFilter::kSpeedProfileBaseline ||
+      profile_compilation_info == nullptr) {
+    return;
+  }
+  TimingLogger::ScopedTiming t("Collect baseline methods", timings);
+  for (const DexFile* dex_file : dex_files) {
+    for (ClassAccessor accessor : dex_file->GetClasses()) {
+      // Skip classes that failed to verify since they may contain invalid Dex code.
+      if (GetClassStatus(ClassReference(dex_file, accessor.GetClassDefIndex())) <
+          ClassStatus::kRetryVerificationAtRuntime) {
+        continue;
+      }
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        if (!profile_compilation_info->GetMethodHotness(method.GetReference()).IsHot()) {
+          continue;
+        }
+        // Only direct callees are collected. The invoked method ids of the same dex file
+        // match the callee's own reference when it is declared in the referenced class,
+        // which is the common case; other callees are left to the JIT.
+        for (const DexInstructionPcPair& inst : method.GetInstructions()) {
+          if (!inst->IsInvoke() ||
+              Instruction::IndexTypeOf(inst->Opcode()) != Instruction::kIndexMethodRef) {
+            continue;
+          }
+          MethodReference callee(dex_file, inst->VRegB());
+          if (!profile_compilation_info->GetMethodHotness(callee).IsHot()) {
+            baseline_methods_.insert(callee);
+          }
+        }
+      }
+    }
+  }
+  VLOG(compiler) << "Collected " << baseline_methods_.size() << " baseline methods";
+}
+
 void CompilerDriver::AddCompiledMethod(const MethodReference& method_ref,
                                        CompiledMethod* const compiled_method) {
   DCHECK(GetCompiledMethod(method_ref) == nullptr) << method_ref.PrettyMethod();
@@ -2903,10 +3047,17 @@ std::string CompilerDriver::GetMemoryUsageString(bool extended) const {
   return oss.str();
 }
 
+// Above this many workers, the shared task queue of the thread pool becomes contended.
+static constexpr size_t kMinWorkStealingThreadCount = 8u;
+
 void CompilerDriver::InitializeThreadPools() {
   size_t parallel_count = parallel_thread_count_ > 0 ? parallel_thread_count_ - 1 : 0;
   parallel_thread_pool_.reset(
-      new ThreadPool("Compiler driver thread pool", parallel_count));
+      new ThreadPool("Compiler driver thread pool",
+                     parallel_count,
+                     /*create_peers=*/ false,
+                     ThreadPoolWorker::kDefaultStackSize,
+                     /*work_stealing=*/ parallel_count > kMinWorkStealingThreadCount));
   single_thread_pool_.reset(new ThreadPool("Single-threaded Compiler driver thread pool", 0));
 }
 
@@ -2917,6 +3068,7 @@ void CompilerDriver::FreeThreadPools() {
 
 void CompilerDriver::SetClasspathDexFiles(const std::vector<const DexFile*>& dex_files) {
   classpath_classes_.AddDexFiles(dex_files);
+  classpath_dex_files_ = dex_files;
 }
 
 }  // namespace art
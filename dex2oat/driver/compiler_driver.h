@@ -61,6 +61,7 @@ class VerifierDepsTest;
 class ArtField;
 class BitVector;
 class CompiledMethod;
+class CompiledMethodCache;
 class CompilerOptions;
 class DexCompilationUnit;
 class DexFile;
@@ -189,6 +190,16 @@ class CompilerDriver {
     return parallel_thread_count_;
   }
 
+  // Set the resident set size, in bytes, that compilation tries to stay within by running
+  // fewer compilation threads. Zero means no limit.
+  void SetMemoryBudget(size_t memory_budget) {
+    memory_budget_ = memory_budget;
+  }
+
+  size_t GetMemoryBudget() const {
+    return memory_budget_;
+  }
+
   void SetDedupeEnabled(bool dedupe_enabled) {
     compiled_method_storage_.SetDedupeEnabled(dedupe_enabled);
   }
@@ -225,6 +236,11 @@ class CompilerDriver {
     return &compiled_method_storage_;
   }
 
+  // Returns the compiled method cache, or null if disabled. Only valid during CompileAll().
+  CompiledMethodCache* GetCompiledMethodCache() const {
+    return compiled_method_cache_.get();
+  }
+
   optimizer::DexToDexCompiler& GetDexToDexCompiler() {
     return dex_to_dex_compiler_;
   }
@@ -298,6 +314,11 @@ class CompilerDriver {
 
   void CheckThreadPools();
 
+  // For the speed-profile-baseline filter, collect the methods invoked from the hot methods
+  // of the profile. They are compiled with the baseline tier along with the hot methods.
+  void CollectBaselineMethods(const std::vector<const DexFile*>& dex_files,
+                              TimingLogger* timings);
+
   // Resolve const string literals that are loaded from dex code. If only_startup_strings is
   // specified, only methods that are marked startup in the profile are resolved.
   void ResolveConstStrings(const std::vector<const DexFile*>& dex_files,
@@ -331,11 +352,22 @@ class CompilerDriver {
   // A thread pool that guarantees running single-threaded on the main thread.
   std::unique_ptr<ThreadPool> single_thread_pool_;
 
+  // Resident set size limit for the compilation of methods, or zero for no limit.
+  size_t memory_budget_;
+
   class AOTCompilationStats;
   std::unique_ptr<AOTCompilationStats> stats_;
 
   CompiledMethodStorage compiled_method_storage_;
 
+  // Dex files of the class path, see SetClasspathDexFiles().
+  std::vector<const DexFile*> classpath_dex_files_;
+
+  std::unique_ptr<CompiledMethodCache> compiled_method_cache_;
+
+  // Callees of hot methods, see CollectBaselineMethods(). Only written before compilation.
+  std::set<MethodReference> baseline_methods_;
+
   size_t max_arena_alloc_;
 
   // Compiler for dex to dex (quickening).
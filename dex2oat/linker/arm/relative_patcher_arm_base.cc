@@ -389,7 +389,9 @@ ArmBaseRelativePatcher::ThunkKey ArmBaseRelativePatcher::GetMethodCallKey() {
 ArmBaseRelativePatcher::ThunkKey ArmBaseRelativePatcher::GetEntrypointCallKey(
     const LinkerPatch& patch) {
   DCHECK_EQ(patch.GetType(), LinkerPatch::Type::kCallEntrypoint);
-  return ThunkKey(ThunkType::kEntrypointCall, patch.EntrypointOffset());
+  return ThunkKey(ThunkType::kEntrypointCall,
+                  patch.EntrypointOffset(),
+                  patch.EntrypointArguments());
 }
 
 ArmBaseRelativePatcher::ThunkKey ArmBaseRelativePatcher::GetBakerThunkKey(
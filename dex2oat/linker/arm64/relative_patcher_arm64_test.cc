@@ -517,6 +517,10 @@ class Arm64RelativePatcherTest : public RelativePatcherTest {
     TestAdrpInsn2Add(insn2, adrp_offset, has_thunk, string_offset);
   }
 
+  static uint32_t EncodeEntrypointThunkArguments(uint32_t arg0_reg, uint32_t arg1_reg) {
+    return arm64::CodeGeneratorARM64::EncodeEntrypointThunkArguments(arg0_reg, arg1_reg);
+  }
+
   static uint32_t EncodeBakerReadBarrierFieldData(uint32_t base_reg, uint32_t holder_reg) {
     return arm64::CodeGeneratorARM64::EncodeBakerReadBarrierFieldData(base_reg, holder_reg);
   }
@@ -1036,6 +1040,58 @@ TEST_F(Arm64RelativePatcherTestDefault, EntrypointCall) {
   EXPECT_EQ(br_ip0, GetOutputInsn(thunk_offset + 4u));
 }
 
+TEST_F(Arm64RelativePatcherTestDefault, EntrypointCallWithArguments) {
+  constexpr uint32_t kEntrypointOffset = 512;
+  const LinkerPatch patches[] = {
+      LinkerPatch::CallEntrypointPatch(0u, kEntrypointOffset),
+      LinkerPatch::CallEntrypointPatch(
+          4u, kEntrypointOffset, EncodeEntrypointThunkArguments(/* arg0_reg */ 3u, 5u)),
+      LinkerPatch::CallEntrypointPatch(
+          8u, kEntrypointOffset, EncodeEntrypointThunkArguments(/* arg0_reg */ 1u, 0u)),
+      LinkerPatch::CallEntrypointPatch(
+          12u, kEntrypointOffset, EncodeEntrypointThunkArguments(/* arg0_reg */ 3u, 5u)),
+  };
+  const std::vector<uint8_t> raw_code = RawCode({kBlPlus0, kBlPlus0, kBlPlus0, kBlPlus0});
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(raw_code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  // Calls with the same entrypoint and argument registers share a thunk.
+  uint32_t method_offset = GetMethodOffset(1u);
+  uint32_t thunk0 = GetOutputInsn(method_offset) & 0x03ffffffu;
+  uint32_t thunk1 = (GetOutputInsn(method_offset + 4u) & 0x03ffffffu) + 1u;
+  uint32_t thunk2 = (GetOutputInsn(method_offset + 8u) & 0x03ffffffu) + 2u;
+  uint32_t thunk3 = (GetOutputInsn(method_offset + 12u) & 0x03ffffffu) + 3u;
+  EXPECT_NE(thunk0, thunk1);
+  EXPECT_NE(thunk0, thunk2);
+  EXPECT_NE(thunk1, thunk2);
+  EXPECT_EQ(thunk1, thunk3);
+
+  uint32_t ldr_ip0_tr_offset =
+      0xf9400000 |                        // LDR Xt, [Xn, #<simm>]
+      ((kEntrypointOffset >> 3) << 10) |  // imm12 = (simm >> scale), scale = 3
+      (/* tr */ 19 << 5) |                // Xn = TR
+      /* ip0 */ 16;                       // Xt = ip0
+  uint32_t br_ip0 = 0xd61f0000 | (/* ip0 */ 16 << 5);
+  auto mov_w = [](uint32_t rd, uint32_t rm) { return 0x2a0003e0u | (rm << 16) | rd; };
+
+  // Moves w3 to w0 and w5 to w1.
+  uint32_t thunk1_offset = method_offset + thunk1 * 4u;
+  EXPECT_EQ(mov_w(0u, 3u), GetOutputInsn(thunk1_offset));
+  EXPECT_EQ(mov_w(1u, 5u), GetOutputInsn(thunk1_offset + 4u));
+  EXPECT_EQ(ldr_ip0_tr_offset, GetOutputInsn(thunk1_offset + 8u));
+  EXPECT_EQ(br_ip0, GetOutputInsn(thunk1_offset + 12u));
+
+  // Swaps w0 and w1 through ip0, before ip0 is used for the entrypoint.
+  uint32_t thunk2_offset = method_offset + thunk2 * 4u;
+  EXPECT_EQ(mov_w(/* ip0 */ 16u, 0u), GetOutputInsn(thunk2_offset));
+  EXPECT_EQ(mov_w(0u, 1u), GetOutputInsn(thunk2_offset + 4u));
+  EXPECT_EQ(mov_w(1u, /* ip0 */ 16u), GetOutputInsn(thunk2_offset + 8u));
+  EXPECT_EQ(ldr_ip0_tr_offset, GetOutputInsn(thunk2_offset + 12u));
+  EXPECT_EQ(br_ip0, GetOutputInsn(thunk2_offset + 16u));
+}
+
 void Arm64RelativePatcherTest::TestBakerField(uint32_t offset, uint32_t ref_reg) {
   uint32_t valid_regs[] = {
       0,  1,  2,  3,  4,  5,  6,  7,  8,  9,
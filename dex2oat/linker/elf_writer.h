@@ -76,6 +76,8 @@ class ElfWriter {
   virtual void EndDataBimgRelRo(OutputStream* data_bimg_rel_ro) = 0;
   virtual void WriteDynamicSection() = 0;
   virtual void WriteDebugInfo(const debug::DebugInfo& debug_info) = 0;
+  // Sets the number of threads that may be used by WriteDebugInfo().
+  virtual void SetDebugInfoThreadCount(size_t thread_count) = 0;
   virtual bool StripDebugInfo() = 0;
   virtual bool End() = 0;
 
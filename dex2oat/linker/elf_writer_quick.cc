@@ -108,6 +108,7 @@ class ElfWriterQuick final : public ElfWriter {
   void EndDataBimgRelRo(OutputStream* data_bimg_rel_ro) override;
   void WriteDynamicSection() override;
   void WriteDebugInfo(const debug::DebugInfo& debug_info) override;
+  void SetDebugInfoThreadCount(size_t thread_count) override;
   bool StripDebugInfo() override;
   bool End() override;
 
@@ -126,6 +127,7 @@ class ElfWriterQuick final : public ElfWriter {
   size_t data_bimg_rel_ro_size_;
   size_t bss_size_;
   size_t dex_section_size_;
+  size_t debug_info_thread_count_;
   std::unique_ptr<BufferedOutputStream> output_stream_;
   std::unique_ptr<ElfBuilder<ElfTypes>> builder_;
   std::unique_ptr<DebugInfoTask> debug_info_task_;
@@ -155,6 +157,7 @@ ElfWriterQuick<ElfTypes>::ElfWriterQuick(const CompilerOptions& compiler_options
       data_bimg_rel_ro_size_(0u),
       bss_size_(0u),
       dex_section_size_(0u),
+      debug_info_thread_count_(1u),
       output_stream_(
           std::make_unique<BufferedOutputStream>(std::make_unique<FileOutputStream>(elf_file))),
       builder_(new ElfBuilder<ElfTypes>(compiler_options_.GetInstructionSet(),
@@ -271,14 +274,23 @@ void ElfWriterQuick<ElfTypes>::WriteDebugInfo(const debug::DebugInfo& debug_info
     DCHECK(debug_info_thread_pool_ != nullptr);
     debug_info_thread_pool_->Wait(self, true, false);
     builder_->WriteSection(".gnu_debugdata", debug_info_task_->GetResult());
+    // Release the compressed data before generating the full debug info.
+    debug_info_thread_pool_.reset();
+    debug_info_task_.reset();
   }
   // The Strip method expects debug info to be last (mini-debug-info is not stripped).
   if (!debug_info.Empty() && compiler_options_.GetGenerateDebugInfo()) {
     // Generate all the debug information we can.
-    debug::WriteDebugInfo(builder_.get(), debug_info);
+    debug::WriteDebugInfo(builder_.get(), debug_info, debug_info_thread_count_);
   }
 }
 
+template <typename ElfTypes>
+void ElfWriterQuick<ElfTypes>::SetDebugInfoThreadCount(size_t thread_count) {
+  DCHECK_NE(thread_count, 0u);
+  debug_info_thread_count_ = thread_count;
+}
+
 template <typename ElfTypes>
 bool ElfWriterQuick<ElfTypes>::StripDebugInfo() {
   off_t file_size = builder_->Strip();
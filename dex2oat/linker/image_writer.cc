@@ -37,8 +37,10 @@
 #include "class_linker-inl.h"
 #include "class_root-inl.h"
 #include "compiled_method.h"
+#include "dex/class_accessor-inl.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
+#include "dex/dex_instruction-inl.h"
 #include "driver/compiler_options.h"
 #include "elf/elf_utils.h"
 #include "elf_file.h"
@@ -77,9 +79,11 @@
 #include "oat_file.h"
 #include "oat_file_manager.h"
 #include "optimizing/intrinsic_objects.h"
+#include "profile/profile_compilation_info.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "subtype_check.h"
+#include "thread_pool.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
 #include "well_known_classes.h"
 
@@ -402,7 +406,8 @@ class ImageWriter::ImageFileGuard {
 
 bool ImageWriter::Write(int image_fd,
                         const std::vector<std::string>& image_filenames,
-                        size_t component_count) {
+                        size_t component_count,
+                        size_t thread_count) {
   // If image_fd or oat_fd are not kInvalidFd then we may have empty strings in image_filenames or
   // oat_filenames.
   CHECK(!image_filenames.empty());
@@ -425,8 +430,8 @@ bool ImageWriter::Write(int image_fd,
     // TODO: heap validation can't handle these fix up passes.
     ScopedObjectAccess soa(self);
     Runtime::Current()->GetHeap()->DisableObjectValidation();
-    CopyAndFixupObjects();
   }
+  CopyAndFixupObjects(thread_count);
 
   if (compiler_options_.IsAppImage()) {
     CopyMetadata();
@@ -1275,16 +1280,78 @@ void ImageWriter::ClearDexCache(ObjPtr<mirror::DexCache> dex_cache) {
   }
 }
 
+// The methods, fields, types and strings referenced from the code of the startup methods
+// of a dex file according to the profile, indexed by their dex file index.
+struct StartupReferences {
+  std::vector<bool> methods;
+  std::vector<bool> fields;
+  std::vector<bool> types;
+  std::vector<bool> strings;
+};
+
+static StartupReferences CollectStartupReferences(const DexFile& dex_file,
+                                                  const ProfileCompilationInfo* profile) {
+  StartupReferences references;
+  if (profile == nullptr) {
+    return references;
+  }
+  references.methods.resize(dex_file.NumMethodIds(), false);
+  references.fields.resize(dex_file.NumFieldIds(), false);
+  references.types.resize(dex_file.NumTypeIds(), false);
+  references.strings.resize(dex_file.NumStringIds(), false);
+  for (ClassAccessor accessor : dex_file.GetClasses()) {
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      if (!profile->GetMethodHotness(method.GetReference()).IsStartup()) {
+        continue;
+      }
+      for (const DexInstructionPcPair& inst : method.GetInstructions()) {
+        Instruction::IndexType index_type = Instruction::IndexTypeOf(inst->Opcode());
+        uint32_t index = (Instruction::FormatOf(inst->Opcode()) == Instruction::k22c)
+            ? inst->VRegC_22c()
+            : static_cast<uint32_t>(inst->VRegB());
+        switch (index_type) {
+          case Instruction::kIndexMethodRef:
+          case Instruction::kIndexMethodAndProtoRef:
+            references.methods[index] = true;
+            break;
+          case Instruction::kIndexFieldRef:
+            references.fields[index] = true;
+            break;
+          case Instruction::kIndexTypeRef:
+            references.types[index] = true;
+            break;
+          case Instruction::kIndexStringRef:
+            references.strings[index] = true;
+            break;
+          default:
+            break;
+        }
+      }
+    }
+  }
+  return references;
+}
+
 void ImageWriter::PreloadDexCache(ObjPtr<mirror::DexCache> dex_cache,
                                   ObjPtr<mirror::ClassLoader> class_loader) {
-  // To ensure deterministic contents of the hash-based arrays, each slot shall contain
-  // the candidate with the lowest index. As we're processing entries in increasing index
-  // order, this means trying to look up the entry for the current index if the slot is
-  // empty or if it contains a higher index.
+  // To ensure deterministic contents of the hash-based arrays, each slot shall contain the
+  // preferred candidate: an entry referenced by startup methods in the profile over any other,
+  // then the candidate with the lowest index. As we're processing entries in increasing index
+  // order, this means trying to look up the entry for the current index if the slot is empty
+  // or if it contains a candidate that the current index is preferred over.
 
   Runtime* runtime = Runtime::Current();
   ClassLinker* class_linker = runtime->GetClassLinker();
   const DexFile& dex_file = *dex_cache->GetDexFile();
+  const StartupReferences startup =
+      CollectStartupReferences(dex_file, compiler_options_.GetProfileCompilationInfo());
+  // Returns whether the candidate `lhs` is preferred over the candidate `rhs`.
+  auto precedes = [](const std::vector<bool>& startup_indexes, uint32_t lhs, uint32_t rhs) {
+    if (!startup_indexes.empty() && startup_indexes[lhs] != startup_indexes[rhs]) {
+      return static_cast<bool>(startup_indexes[lhs]);
+    }
+    return lhs < rhs;
+  };
   // Preload the methods array and make the contents deterministic.
   mirror::MethodDexCacheType* resolved_methods = dex_cache->GetResolvedMethods();
   dex::TypeIndex last_class_idx;  // Initialized to invalid index.
@@ -1295,7 +1362,7 @@ void ImageWriter::PreloadDexCache(ObjPtr<mirror::DexCache> dex_cache,
         mirror::DexCache::GetNativePairPtrSize(resolved_methods, slot_idx, target_ptr_size_);
     uint32_t stored_index = pair.index;
     ArtMethod* method = pair.object;
-    if (method != nullptr && i > stored_index) {
+    if (method != nullptr && precedes(startup.methods, stored_index, i)) {
       continue;  // Already checked.
     }
     // Check if the referenced class is in the image. Note that we want to check the referenced
@@ -1306,7 +1373,7 @@ void ImageWriter::PreloadDexCache(ObjPtr<mirror::DexCache> dex_cache,
       last_class_idx = method_id.class_idx_;
       last_class = class_linker->LookupResolvedType(last_class_idx, dex_cache, class_loader);
     }
-    if (method == nullptr || i < stored_index) {
+    if (method == nullptr || precedes(startup.methods, i, stored_index)) {
       if (last_class != nullptr) {
         // Try to resolve the method with the class linker, which will insert
         // it into the dex cache if successful.
@@ -1327,7 +1394,7 @@ void ImageWriter::PreloadDexCache(ObjPtr<mirror::DexCache> dex_cache,
     auto pair = mirror::DexCache::GetNativePairPtrSize(resolved_fields, slot_idx, target_ptr_size_);
     uint32_t stored_index = pair.index;
     ArtField* field = pair.object;
-    if (field != nullptr && i > stored_index) {
+    if (field != nullptr && precedes(startup.fields, stored_index, i)) {
       continue;  // Already checked.
     }
     // Check if the referenced class is in the image. Note that we want to check the referenced
@@ -1341,7 +1408,7 @@ void ImageWriter::PreloadDexCache(ObjPtr<mirror::DexCache> dex_cache,
         last_class = nullptr;
       }
     }
-    if (field == nullptr || i < stored_index) {
+    if (field == nullptr || precedes(startup.fields, i, stored_index)) {
       if (last_class != nullptr) {
         // Try to resolve the field with the class linker, which will insert
         // it into the dex cache if successful.
@@ -1362,7 +1429,7 @@ void ImageWriter::PreloadDexCache(ObjPtr<mirror::DexCache> dex_cache,
         dex_cache->GetResolvedTypes()[slot_idx].load(std::memory_order_relaxed);
     uint32_t stored_index = pair.index;
     ObjPtr<mirror::Class> klass = pair.object.Read();
-    if (klass == nullptr || i < stored_index) {
+    if (klass == nullptr || precedes(startup.types, i, stored_index)) {
       klass = class_linker->LookupResolvedType(type_idx, dex_cache, class_loader);
       DCHECK(klass == nullptr || dex_cache->GetResolvedType(type_idx) == klass);
     }
@@ -1375,7 +1442,7 @@ void ImageWriter::PreloadDexCache(ObjPtr<mirror::DexCache> dex_cache,
         dex_cache->GetStrings()[slot_idx].load(std::memory_order_relaxed);
     uint32_t stored_index = pair.index;
     ObjPtr<mirror::String> string = pair.object.Read();
-    if (string == nullptr || i < stored_index) {
+    if (string == nullptr || precedes(startup.strings, i, stored_index)) {
       string = class_linker->LookupString(string_idx, dex_cache);
       DCHECK(string == nullptr || dex_cache->GetResolvedString(string_idx) == string);
     }
@@ -2776,9 +2843,15 @@ void ImageWriter::CopyAndFixupImTable(ImTable* orig, ImTable* copy) {
 }
 
 void ImageWriter::CopyAndFixupImtConflictTable(ImtConflictTable* orig, ImtConflictTable* copy) {
-  const size_t count = orig->NumEntries(target_ptr_size_);
+  // The `copy` has the same layout as `orig`. Hashed tables keep their slots as the
+  // fixed up interface methods have the same dex method indexes.
+  DCHECK_EQ(orig->IsHashed(target_ptr_size_), copy->IsHashed(target_ptr_size_));
+  const size_t count = orig->NumSlots(target_ptr_size_);
   for (size_t i = 0; i < count; ++i) {
     ArtMethod* interface_method = orig->GetInterfaceMethod(i, target_ptr_size_);
+    if (interface_method == nullptr) {
+      continue;  // Empty slot of a hashed table.
+    }
     ArtMethod* implementation_method = orig->GetImplementationMethod(i, target_ptr_size_);
     CopyAndFixupPointer(copy->AddressOfInterfaceMethod(i, target_ptr_size_), interface_method);
     CopyAndFixupPointer(
@@ -2889,8 +2962,8 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
     temp_intern_table.VisitRoots(&root_visitor, kVisitRootFlagAllRoots);
     // Record relocations. (The root visitor does not get to see the slot addresses.)
     MutexLock lock(Thread::Current(), *Locks::intern_table_lock_);
-    DCHECK(!temp_intern_table.strong_interns_.tables_.empty());
-    DCHECK(!temp_intern_table.strong_interns_.tables_[0].Empty());  // Inserted at the beginning.
+    DCHECK(!temp_intern_table.image_interns_.tables_.empty());
+    DCHECK(!temp_intern_table.image_interns_.tables_[0].Empty());  // Inserted at the beginning.
   }
   // Write the class table(s) into the image. class_table_bytes_ may be 0 if there are multiple
   // class loaders. Writing multiple class tables into the image is currently unsupported.
@@ -2918,7 +2991,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
     // but the relocation works fine for these "adjusted" references.
     ReaderMutexLock lock(self, temp_class_table.lock_);
     DCHECK(!temp_class_table.classes_.empty());
-    DCHECK(!temp_class_table.classes_[0].empty());  // The ClassSet was inserted at the beginning.
+    DCHECK(!temp_class_table.classes_[0]->empty());  // The ClassSet was inserted at the beginning.
   }
 }
 
@@ -2966,7 +3039,8 @@ void ImageWriter::CopyAndFixupObject(Object* obj) {
   DCHECK_LT(offset, image_info.image_end_);
   const auto* src = reinterpret_cast<const uint8_t*>(obj);
 
-  image_info.image_bitmap_.Set(dst);  // Mark the obj as live.
+  // Objects of the same image may be copied concurrently, so the bitmap words are shared.
+  image_info.image_bitmap_.AtomicTestAndSet(dst);  // Mark the obj as live.
 
   const size_t n = obj->SizeOf();
 
@@ -3030,12 +3104,84 @@ class ImageWriter::FixupVisitor {
   mirror::Object* const copy_;
 };
 
-void ImageWriter::CopyAndFixupObjects() {
-  auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
-    DCHECK(obj != nullptr);
-    CopyAndFixupObject(obj);
-  };
-  Runtime::Current()->GetHeap()->VisitObjects(visitor);
+class ImageWriter::CopyAndFixupObjectsTask final : public Task {
+ public:
+  CopyAndFixupObjectsTask(ImageWriter* image_writer, ArrayRef<Object* const> objects)
+      : image_writer_(image_writer), objects_(objects) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    for (Object* obj : objects_) {
+      image_writer_->CopyAndFixupObject(obj);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ImageWriter* const image_writer_;
+  const ArrayRef<Object* const> objects_;
+};
+
+void ImageWriter::CopyAndFixupObjects(size_t thread_count) {
+  // Number of objects copied by a single task. Large enough to amortize the task overhead,
+  // small enough to balance the load when one bin dominates the image.
+  static constexpr size_t kObjectsPerTask = 1024u;
+
+  Thread* const self = Thread::Current();
+  // Partition the objects by image and bin. Each object is copied to the slot assigned by
+  // CalculateNewObjectOffsets() and the fix-up writes only to that copy, so the partitions can
+  // be processed in any order, or in parallel, without changing the output.
+  std::vector<std::vector<Object*>> partitions(image_infos_.size() * kNumberOfBins);
+  {
+    ScopedObjectAccess soa(self);
+    for (size_t oat_index = 0; oat_index != image_infos_.size(); ++oat_index) {
+      for (size_t bin = 0; bin != kNumberOfBins; ++bin) {
+        partitions[oat_index * kNumberOfBins + bin].reserve(
+            image_infos_[oat_index].GetBinSlotCount(static_cast<Bin>(bin)));
+      }
+    }
+    auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK(obj != nullptr);
+      if (IsImageBinSlotAssigned(obj)) {
+        size_t oat_index = GetOatIndex(obj);
+        size_t bin = static_cast<size_t>(GetImageBinSlot(obj, oat_index).GetBin());
+        partitions[oat_index * kNumberOfBins + bin].push_back(obj);
+      }
+    };
+    Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  }
+
+  if (thread_count <= 1u) {
+    ScopedObjectAccess soa(self);
+    for (const std::vector<Object*>& partition : partitions) {
+      for (Object* obj : partition) {
+        CopyAndFixupObject(obj);
+      }
+    }
+  } else {
+    // The calling thread takes part in the work, see ThreadPool::Wait() below.
+    ThreadPool thread_pool("Image writer thread pool", thread_count - 1u);
+    for (const std::vector<Object*>& partition : partitions) {
+      ArrayRef<Object* const> objects(partition);
+      for (size_t begin = 0; begin < objects.size(); begin += kObjectsPerTask) {
+        size_t count = std::min(kObjectsPerTask, objects.size() - begin);
+        thread_pool.AddTask(self,
+                            new CopyAndFixupObjectsTask(this, objects.SubArray(begin, count)));
+      }
+    }
+    thread_pool.StartWorkers(self);
+    // Ensure we're suspended while we're blocked waiting for the other threads to finish.
+    CHECK_NE(self->GetState(), kRunnable);
+    thread_pool.Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+    thread_pool.StopWorkers(self);
+  }
+
+  ScopedObjectAccess soa(self);
+  // Every native pointer array has been fixed up exactly once.
+  pointer_arrays_.clear();
   // Fill the padding objects since they are required for in order traversal of the image space.
   for (ImageInfo& image_info : image_infos_) {
     for (const size_t start_offset : image_info.padding_offsets_) {
@@ -3184,9 +3330,9 @@ void ImageWriter::FixupObject(Object* orig, Object* copy) {
     // Is this a native pointer array?
     auto it = pointer_arrays_.find(down_cast<mirror::PointerArray*>(orig));
     if (it != pointer_arrays_.end()) {
-      // Should only need to fixup every pointer array exactly once.
+      // Should only need to fixup every pointer array exactly once. The map is shared by
+      // the CopyAndFixupObjects() tasks, so it is cleared only after all of them are done.
       FixupPointerArray(copy, down_cast<mirror::PointerArray*>(orig), it->second);
-      pointer_arrays_.erase(it);
       return;
     }
   }
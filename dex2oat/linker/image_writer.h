@@ -143,9 +143,11 @@ class ImageWriter final {
   // the names in image_filenames.
   // If oat_fd is not kInvalidFd, then we use that for the oat file. Otherwise we open
   // the names in oat_filenames.
+  // Objects are copied and fixed up by up to thread_count threads, including the caller.
   bool Write(int image_fd,
              const std::vector<std::string>& image_filenames,
-             size_t component_count)
+             size_t component_count,
+             size_t thread_count)
       REQUIRES(!Locks::mutator_lock_);
 
   uintptr_t GetOatDataBegin(size_t oat_index) {
@@ -327,6 +329,11 @@ class ImageWriter final {
       bin_slot_count_[static_cast<size_t>(bin)] += count_to_add;
     }
 
+    size_t GetBinSlotCount(Bin bin) const {
+      DCHECK_LT(static_cast<size_t>(bin), kNumberOfBins);
+      return bin_slot_count_[static_cast<size_t>(bin)];
+    }
+
     // Calculate the sum total of the bin slot sizes in [0, up_to). Defaults to all bins.
     size_t GetBinSizeSum(Bin up_to) const;
 
@@ -484,7 +491,7 @@ class ImageWriter final {
 
   // Creates the contiguous image in memory and adjusts pointers.
   void CopyAndFixupNativeData(size_t oat_index) REQUIRES_SHARED(Locks::mutator_lock_);
-  void CopyAndFixupObjects() REQUIRES_SHARED(Locks::mutator_lock_);
+  void CopyAndFixupObjects(size_t thread_count) REQUIRES(!Locks::mutator_lock_);
   void CopyAndFixupObject(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_);
   void CopyAndFixupMethod(ArtMethod* orig, ArtMethod* copy, size_t oat_index)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -731,6 +738,7 @@ class ImageWriter final {
   // Region alignment bytes wasted.
   size_t region_alignment_wasted_ = 0u;
 
+  class CopyAndFixupObjectsTask;
   class FixupClassVisitor;
   class FixupRootVisitor;
   class FixupVisitor;
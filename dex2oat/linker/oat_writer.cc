@@ -17,7 +17,10 @@
 #include "oat_writer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <unistd.h>
+#include <unordered_set>
 #include <zlib.h>
 
 #include "arch/arm64/instruction_set_features_arm64.h"
@@ -354,6 +357,10 @@ class OatWriter::OatDexFile {
   DexLayoutSections dex_sections_layout_;
 
   ///// End of data to write to vdex/oat file.
+
+  // Input of the dex layout if opened ahead of writing by OpenDexFilesForLayoutInParallel().
+  std::unique_ptr<const DexFile> dex_file_for_layout_;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(OatDexFile);
 };
@@ -457,7 +464,8 @@ OatWriter::OatWriter(const CompilerOptions& compiler_options,
     size_string_bss_mappings_(0u),
     relative_patcher_(nullptr),
     profile_compilation_info_(info),
-    compact_dex_level_(compact_dex_level) {
+    compact_dex_level_(compact_dex_level),
+    dex_layout_thread_count_(1u) {
   // If we have a profile, always use at least the default compact dex level. The reason behind
   // this is that CompactDex conversion is not more expensive than normal dexlayout.
   if (info != nullptr && compact_dex_level_ == CompactDexLevel::kCompactDexLevelNone) {
@@ -1046,19 +1054,19 @@ struct OatWriter::OrderedMethodData {
     return debug_info_idx != kDebugInfoIdxInvalid;
   }
 
-  // Bin each method according to the profile flags.
+  // Bin each method according to the profile flags, in this order:
   //
-  // Groups by e.g.
-  //  -- not hot at all
-  //  -- hot
-  //  -- hot and startup
-  //  -- hot and post-startup
-  //  -- hot and startup and poststartup
   //  -- startup
   //  -- startup and post-startup
+  //  -- hot and startup and post-startup
+  //  -- hot and startup
+  //  -- hot and post-startup
+  //  -- hot
   //  -- post-startup
+  //  -- not hot at all
   //
-  // (See MethodHotness enum definition for up-to-date binning order.)
+  // This keeps all the startup code contiguous, and all the hot code contiguous as well,
+  // so that both the cold start and the steady state touch as few code pages as possible.
   bool operator<(const OrderedMethodData& other) const {
     if (kOatWriterForceOatCodeLayout) {
       // Development flag: Override default behavior by sorting by name.
@@ -1081,23 +1089,9 @@ struct OatWriter::OrderedMethodData {
   // Used to determine relative order for OAT code layout when determining
   // binning.
   size_t GetMethodHotnessOrder() const {
-    bool hotness[] = {
-      method_hotness.IsHot(),
-      method_hotness.IsStartup(),
-      method_hotness.IsPostStartup()
-    };
-
-
-    // Note: Bin-to-bin order does not matter. If the kernel does or does not read-ahead
-    // any memory, it only goes into the buffer cache and does not grow the PSS until the first
-    // time that memory is referenced in the process.
-
-    size_t hotness_bits = 0;
-    for (size_t i = 0; i < arraysize(hotness); ++i) {
-      if (hotness[i]) {
-        hotness_bits |= (1 << i);
-      }
-    }
+    bool hot = method_hotness.IsHot();
+    bool startup = method_hotness.IsStartup();
+    bool post_startup = method_hotness.IsPostStartup();
 
     if (kIsDebugBuild) {
       // Check for bins that are always-empty given a real profile.
@@ -1110,7 +1104,17 @@ struct OatWriter::OrderedMethodData {
       }
     }
 
-    return hotness_bits;
+    // Note: The bins overlap on the startup and hot flags, so that the startup bins are
+    // adjacent and so are the hot ones. The kernel read-ahead of the startup code then
+    // brings in little else, and the hot code shares as few pages as possible with code
+    // that never runs.
+    if (startup) {
+      return hot ? (post_startup ? 2u : 3u) : (post_startup ? 1u : 0u);
+    } else if (hot) {
+      return post_startup ? 4u : 5u;
+    } else {
+      return post_startup ? 6u : 7u;
+    }
   }
 };
 
@@ -1463,11 +1467,40 @@ class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisi
   const bool generate_debug_info_;
 };
 
+class OatWriter::InitMapDictionaryMethodVisitor : public OatDexMethodVisitor {
+ public:
+  InitMapDictionaryMethodVisitor(OatWriter* writer, CodeInfo::Deduper* dedupe_bit_table)
+      : OatDexMethodVisitor(writer, /* offset */ 0u),
+        dedupe_bit_table_(dedupe_bit_table) {
+  }
+
+  bool VisitMethod(size_t class_def_method_index,
+                   const ClassAccessor::Method& method ATTRIBUTE_UNUSED)
+      override REQUIRES_SHARED(Locks::mutator_lock_) {
+    OatClass* oat_class = &writer_->oat_classes_[oat_class_index_];
+    CompiledMethod* compiled_method = oat_class->GetCompiledMethod(class_def_method_index);
+
+    if (HasCompiledCode(compiled_method)) {
+      ArrayRef<const uint8_t> map = compiled_method->GetVmapTable();
+      // Count each CodeInfo once, the same way as InitMapMethodVisitor dedupes them.
+      if (map.size() != 0u && seen_code_infos_.insert(map.data()).second) {
+        dedupe_bit_table_->AddToDictionary(map.data());
+      }
+    }
+
+    return true;
+  }
+
+ private:
+  std::unordered_set<const uint8_t*> seen_code_infos_;
+  CodeInfo::Deduper* const dedupe_bit_table_;
+};
+
 class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
  public:
-  InitMapMethodVisitor(OatWriter* writer, size_t offset)
+  InitMapMethodVisitor(OatWriter* writer, size_t offset, CodeInfo::Deduper* dedupe_bit_table)
       : OatDexMethodVisitor(writer, offset),
-        dedupe_bit_table_(&writer_->code_info_data_) {
+        dedupe_bit_table_(dedupe_bit_table) {
   }
 
   bool VisitMethod(size_t class_def_method_index,
@@ -1484,7 +1517,7 @@ class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
       if (map.size() != 0u) {
         size_t offset = dedupe_code_info_.GetOrCreate(map.data(), [=]() {
           // Deduplicate the inner BitTable<>s within the CodeInfo.
-          return offset_ + dedupe_bit_table_.Dedupe(map.data());
+          return offset_ + dedupe_bit_table_->Dedupe(map.data());
         });
         // Code offset is not initialized yet, so set the map offset to 0u-offset.
         DCHECK_EQ(oat_class->method_offsets_[method_offsets_index_].code_offset_, 0u);
@@ -1503,7 +1536,7 @@ class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
   SafeMap<const uint8_t*, size_t> dedupe_code_info_;
 
   // Deduplicate at BitTable level.
-  CodeInfo::Deduper dedupe_bit_table_;
+  CodeInfo::Deduper* const dedupe_bit_table_;
 };
 
 class OatWriter::InitImageMethodVisitor : public OatDexMethodVisitor {
@@ -2072,8 +2105,13 @@ size_t OatWriter::InitOatMaps(size_t offset) {
     return offset;
   }
   {
-    InitMapMethodVisitor visitor(this, offset);
-    bool success = VisitDexMethods(&visitor);
+    CodeInfo::Deduper dedupe_bit_table(&code_info_data_);
+    // Collect the table rows shared across methods before writing any CodeInfo.
+    InitMapDictionaryMethodVisitor dictionary_visitor(this, &dedupe_bit_table);
+    bool success = VisitDexMethods(&dictionary_visitor);
+    DCHECK(success);
+    InitMapMethodVisitor visitor(this, offset, &dedupe_bit_table);
+    success = VisitDexMethods(&visitor);
     DCHECK(success);
     code_info_data_.shrink_to_fit();
     offset += code_info_data_.size();
@@ -2924,6 +2962,9 @@ size_t OatWriter::WriteMaps(OutputStream* out, size_t file_offset, size_t relati
     relative_offset += code_info_data_.size();
     size_vmap_table_ = code_info_data_.size();
     DCHECK_OFFSET();
+    // The debug info refers to the CodeInfo of the compiled methods, not to this copy,
+    // so release it before the debug info is written.
+    std::vector<uint8_t>().swap(code_info_data_);
   }
 
   return relative_offset;
@@ -3213,6 +3254,13 @@ bool OatWriter::WriteDexFiles(OutputStream* out,
     // Add the dex section header.
     vdex_size_ += sizeof(VdexFile::DexSectionHeader);
     vdex_dex_files_offset_ = vdex_size_;
+    if ((profile_compilation_info_ != nullptr ||
+         compact_dex_level_ != CompactDexLevel::kCompactDexLevelNone) &&
+        !update_input_vdex &&
+        dex_layout_thread_count_ > 1u &&
+        oat_dex_files_.size() > 1u) {
+      OpenDexFilesForLayoutInParallel();
+    }
     // Write dex files.
     for (OatDexFile& oat_dex_file : oat_dex_files_) {
       if (!WriteDexFile(out, file, &oat_dex_file, update_input_vdex)) {
@@ -3415,8 +3463,8 @@ bool OatWriter::SeekToDexFile(OutputStream* out, File* file, OatDexFile* oat_dex
   return true;
 }
 
-bool OatWriter::LayoutAndWriteDexFile(OutputStream* out, OatDexFile* oat_dex_file) {
-  TimingLogger::ScopedTiming split("Dex Layout", timings_);
+std::unique_ptr<const DexFile> OatWriter::OpenDexFileForLayout(OatDexFile* oat_dex_file,
+                                                              TimingLogger* timings) {
   std::string error_msg;
   std::string location(oat_dex_file->GetLocation());
   std::unique_ptr<const DexFile> dex_file;
@@ -3425,14 +3473,14 @@ bool OatWriter::LayoutAndWriteDexFile(OutputStream* out, OatDexFile* oat_dex_fil
     ZipEntry* zip_entry = oat_dex_file->source_.GetZipEntry();
     MemMap mem_map;
     {
-      TimingLogger::ScopedTiming extract("Unzip", timings_);
+      TimingLogger::ScopedTiming extract("Unzip", timings);
       mem_map = zip_entry->ExtractToMemMap(location.c_str(), "classes.dex", &error_msg);
     }
     if (!mem_map.IsValid()) {
       LOG(ERROR) << "Failed to extract dex file to mem map for layout: " << error_msg;
-      return false;
+      return nullptr;
     }
-    TimingLogger::ScopedTiming extract("Open", timings_);
+    TimingLogger::ScopedTiming extract("Open", timings);
     dex_file = dex_file_loader.Open(location,
                                     zip_entry->GetCrc32(),
                                     std::move(mem_map),
@@ -3444,9 +3492,9 @@ bool OatWriter::LayoutAndWriteDexFile(OutputStream* out, OatDexFile* oat_dex_fil
     int dup_fd = DupCloexec(raw_file->Fd());
     if (dup_fd < 0) {
       PLOG(ERROR) << "Failed to dup dex file descriptor (" << raw_file->Fd() << ") at " << location;
-      return false;
+      return nullptr;
     }
-    TimingLogger::ScopedTiming extract("Open", timings_);
+    TimingLogger::ScopedTiming extract("Open", timings);
     dex_file = dex_file_loader.OpenDex(dup_fd, location,
                                        /* verify */ true,
                                        /* verify_checksum */ true,
@@ -3474,7 +3522,89 @@ bool OatWriter::LayoutAndWriteDexFile(OutputStream* out, OatDexFile* oat_dex_fil
   }
   if (dex_file == nullptr) {
     LOG(ERROR) << "Failed to open dex file for layout: " << error_msg;
-    return false;
+  }
+  return dex_file;
+}
+
+// Calls `fn(i)` for each `i` in [0, `count`) on up to `thread_count` threads, including the
+// calling thread.
+template <typename Fn>
+static void ParallelForEach(size_t count, size_t thread_count, const Fn& fn) {
+  std::atomic<size_t> next_index(0u);
+  auto worker = [&]() {
+    for (size_t i = next_index.fetch_add(1u, std::memory_order_relaxed);
+         i < count;
+         i = next_index.fetch_add(1u, std::memory_order_relaxed)) {
+      fn(i);
+    }
+  };
+  size_t num_threads = std::max<size_t>(std::min(thread_count, count), 1u);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1u);
+  for (size_t i = 1u; i != num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+void OatWriter::OpenDexFilesForLayoutInParallel() {
+  TimingLogger::ScopedTiming split("Open dex files for layout", timings_);
+  ParallelForEach(oat_dex_files_.size(), dex_layout_thread_count_, [&](size_t i) {
+    // The timings of the workers would interleave, only the total is recorded.
+    TimingLogger timings("Open dex files for layout", /* precise */ false, /* verbose */ false);
+    OatDexFile* oat_dex_file = &oat_dex_files_[i];
+    oat_dex_file->dex_file_for_layout_ = OpenDexFileForLayout(oat_dex_file, &timings);
+  });
+}
+
+bool OatWriter::OpenDexFilesInParallel(
+    const std::vector<ArrayRef<const uint8_t>>& raw_dex_files,
+    bool verify,
+    /*out*/ std::vector<std::unique_ptr<const DexFile>>* dex_files) {
+  DCHECK_EQ(raw_dex_files.size(), oat_dex_files_.size());
+  // Verifying the dex files and their checksums is the bulk of the work, so do it in parallel.
+  std::vector<std::unique_ptr<const DexFile>> opened_dex_files(raw_dex_files.size());
+  std::vector<std::string> error_msgs(raw_dex_files.size());
+  ParallelForEach(raw_dex_files.size(), dex_layout_thread_count_, [&](size_t i) {
+    const OatDexFile& oat_dex_file = oat_dex_files_[i];
+    const ArtDexFileLoader dex_file_loader;
+    opened_dex_files[i] = dex_file_loader.Open(raw_dex_files[i].data(),
+                                               raw_dex_files[i].size(),
+                                               oat_dex_file.GetLocation(),
+                                               oat_dex_file.dex_file_location_checksum_,
+                                               /* oat_dex_file */ nullptr,
+                                               verify,
+                                               verify,
+                                               &error_msgs[i]);
+  });
+  for (size_t i = 0, size = opened_dex_files.size(); i != size; ++i) {
+    OatDexFile& oat_dex_file = oat_dex_files_[i];
+    if (opened_dex_files[i] == nullptr) {
+      LOG(ERROR) << "Failed to open dex file from oat file. File: " << oat_dex_file.GetLocation()
+                 << " Error: " << error_msgs[i];
+      return false;
+    }
+    // Set the class_offsets size now that we have easy access to the DexFile and
+    // it has been verified in dex_file_loader.Open.
+    oat_dex_file.class_offsets_.resize(opened_dex_files[i]->GetHeader().class_defs_size_);
+  }
+  *dex_files = std::move(opened_dex_files);
+  return true;
+}
+
+bool OatWriter::LayoutAndWriteDexFile(OutputStream* out, OatDexFile* oat_dex_file) {
+  TimingLogger::ScopedTiming split("Dex Layout", timings_);
+  std::string error_msg;
+  std::string location(oat_dex_file->GetLocation());
+  std::unique_ptr<const DexFile> dex_file = std::move(oat_dex_file->dex_file_for_layout_);
+  if (dex_file == nullptr) {
+    dex_file = OpenDexFileForLayout(oat_dex_file, timings_);
+    if (dex_file == nullptr) {
+      return false;
+    }
   }
   Options options;
   options.compact_dex_level_ = compact_dex_level_;
@@ -3695,6 +3825,7 @@ bool OatWriter::OpenDexFiles(
   if (!extract_dex_files_into_vdex_) {
     std::vector<std::unique_ptr<const DexFile>> dex_files;
     std::vector<MemMap> maps;
+    std::vector<ArrayRef<const uint8_t>> raw_dex_files;
     for (OatDexFile& oat_dex_file : oat_dex_files_) {
       std::string error_msg;
       maps.emplace_back(oat_dex_file.source_.GetZipEntry()->MapDirectlyOrExtract(
@@ -3704,22 +3835,11 @@ bool OatWriter::OpenDexFiles(
         LOG(ERROR) << error_msg;
         return false;
       }
-      // Now, open the dex file.
-      const ArtDexFileLoader dex_file_loader;
-      dex_files.emplace_back(dex_file_loader.Open(map->Begin(),
-                                                  map->Size(),
-                                                  oat_dex_file.GetLocation(),
-                                                  oat_dex_file.dex_file_location_checksum_,
-                                                  /* oat_dex_file */ nullptr,
-                                                  verify,
-                                                  verify,
-                                                  &error_msg));
-      if (dex_files.back() == nullptr) {
-        LOG(ERROR) << "Failed to open dex file from oat file. File: " << oat_dex_file.GetLocation()
-                   << " Error: " << error_msg;
-        return false;
-      }
-      oat_dex_file.class_offsets_.resize(dex_files.back()->GetHeader().class_defs_size_);
+      raw_dex_files.emplace_back(map->Begin(), map->Size());
+    }
+    // Now, open the dex files.
+    if (!OpenDexFilesInParallel(raw_dex_files, verify, &dex_files)) {
+      return false;
     }
     *opened_dex_files_map = std::move(maps);
     *opened_dex_files = std::move(dex_files);
@@ -3748,8 +3868,8 @@ bool OatWriter::OpenDexFiles(
                << " error: " << error_msg;
     return false;
   }
-  const ArtDexFileLoader dex_file_loader;
   std::vector<std::unique_ptr<const DexFile>> dex_files;
+  std::vector<ArrayRef<const uint8_t>> raw_dex_files;
   for (OatDexFile& oat_dex_file : oat_dex_files_) {
     const uint8_t* raw_dex_file =
         dex_files_map.Begin() + oat_dex_file.dex_file_offset_ - map_offset;
@@ -3769,24 +3889,12 @@ bool OatWriter::OpenDexFiles(
           << " Output: " << file->GetPath();
     }
 
-    // Now, open the dex file.
-    dex_files.emplace_back(dex_file_loader.Open(raw_dex_file,
-                                                oat_dex_file.dex_file_size_,
-                                                oat_dex_file.GetLocation(),
-                                                oat_dex_file.dex_file_location_checksum_,
-                                                /* oat_dex_file */ nullptr,
-                                                verify,
-                                                verify,
-                                                &error_msg));
-    if (dex_files.back() == nullptr) {
-      LOG(ERROR) << "Failed to open dex file from oat file. File: " << oat_dex_file.GetLocation()
-                 << " Error: " << error_msg;
-      return false;
-    }
+    raw_dex_files.emplace_back(raw_dex_file, oat_dex_file.dex_file_size_);
+  }
 
-    // Set the class_offsets size now that we have easy access to the DexFile and
-    // it has been verified in dex_file_loader.Open.
-    oat_dex_file.class_offsets_.resize(dex_files.back()->GetHeader().class_defs_size_);
+  // Now, open the dex files.
+  if (!OpenDexFilesInParallel(raw_dex_files, verify, &dex_files)) {
+    return false;
   }
 
   opened_dex_files_map->push_back(std::move(dex_files_map));
@@ -4056,7 +4164,8 @@ OatWriter::OatDexFile::OatDexFile(const char* dex_file_location,
       type_bss_mapping_offset_(0u),
       string_bss_mapping_offset_(0u),
       dex_sections_layout_offset_(0u),
-      class_offsets_() {
+      class_offsets_(),
+      dex_file_for_layout_() {
 }
 
 size_t OatWriter::OatDexFile::SizeOf() const {
@@ -166,6 +166,13 @@ class OatWriter {
       CreateTypeLookupTable create_type_lookup_table = CreateTypeLookupTable::kDefault);
   dchecked_vector<std::string> GetSourceLocations() const;
 
+  // Extract, open and verify the inputs of dex layout, and open and verify the written
+  // dex files, on up to `thread_count` threads. Must be called before WriteAndOpenDexFiles().
+  void SetDexLayoutThreadCount(size_t thread_count) {
+    DCHECK_NE(thread_count, 0u);
+    dex_layout_thread_count_ = thread_count;
+  }
+
   // Write raw dex files to the vdex file, mmap the file and open the dex files from it.
   // The `verify` setting dictates whether the dex file verifier should check the dex files.
   // This is generally the case, and should only be false for tests.
@@ -278,6 +285,7 @@ class OatWriter {
   struct OrderedMethodData;
   class OrderedMethodVisitor;
   class InitCodeMethodVisitor;
+  class InitMapDictionaryMethodVisitor;
   class InitMapMethodVisitor;
   class InitImageMethodVisitor;
   class WriteCodeMethodVisitor;
@@ -300,6 +308,12 @@ class OatWriter {
                     OatDexFile* oat_dex_file,
                     bool update_input_vdex);
   bool SeekToDexFile(OutputStream* out, File* file, OatDexFile* oat_dex_file);
+  std::unique_ptr<const DexFile> OpenDexFileForLayout(OatDexFile* oat_dex_file,
+                                                      TimingLogger* timings);
+  void OpenDexFilesForLayoutInParallel();
+  bool OpenDexFilesInParallel(const std::vector<ArrayRef<const uint8_t>>& raw_dex_files,
+                              bool verify,
+                              /*out*/ std::vector<std::unique_ptr<const DexFile>>* dex_files);
   bool LayoutAndWriteDexFile(OutputStream* out, OatDexFile* oat_dex_file);
   bool WriteDexFile(OutputStream* out,
                     File* file,
@@ -544,6 +558,10 @@ class OatWriter {
   // Compact dex level that is generated.
   CompactDexLevel compact_dex_level_;
 
+  // Number of threads used to open the dex files for layout before writing them, and to open
+  // and verify the written dex files.
+  size_t dex_layout_thread_count_;
+
   using OrderedMethodList = std::vector<OrderedMethodData>;
 
   // List of compiled methods, sorted by the order defined in OrderedMethodData.
@@ -130,13 +130,15 @@ class OatTest : public CommonCompilerDriverTest {
                 SafeMap<std::string, std::string>& key_value_store,
                 bool verify,
                 CopyOption copy,
-                ProfileCompilationInfo* profile_compilation_info) {
+                ProfileCompilationInfo* profile_compilation_info,
+                size_t dex_layout_thread_count = 1u) {
     TimingLogger timings("WriteElf", false, false);
     ClearBootImageOption();
     OatWriter oat_writer(*compiler_options_,
                          &timings,
                          profile_compilation_info,
                          CompactDexLevel::kCompactDexLevelNone);
+    oat_writer.SetDexLayoutThreadCount(dex_layout_thread_count);
     for (const char* dex_filename : dex_filenames) {
       if (!oat_writer.AddDexFileSource(dex_filename, dex_filename)) {
         return false;
@@ -313,7 +315,10 @@ class OatTest : public CommonCompilerDriverTest {
               opened_oat_file->GetVdexFile()->GetComputedFileSize());
   }
 
-  void TestDexFileInput(bool verify, bool low_4gb, bool use_profile);
+  void TestDexFileInput(bool verify,
+                        bool low_4gb,
+                        bool use_profile,
+                        size_t dex_layout_thread_count = 1u);
   void TestZipFileInput(bool verify, CopyOption copy);
   void TestZipFileInputWithEmptyDex();
 
@@ -596,7 +601,10 @@ static void MaybeModifyDexFileToFail(bool verify, std::unique_ptr<const DexFile>
   }
 }
 
-void OatTest::TestDexFileInput(bool verify, bool low_4gb, bool use_profile) {
+void OatTest::TestDexFileInput(bool verify,
+                               bool low_4gb,
+                               bool use_profile,
+                               size_t dex_layout_thread_count) {
   TimingLogger timings("OatTest::DexFileInput", false, false);
 
   std::vector<const char*> input_filenames;
@@ -649,7 +657,8 @@ void OatTest::TestDexFileInput(bool verify, bool low_4gb, bool use_profile) {
                        key_value_store,
                        verify,
                        CopyOption::kOnlyIfCompressed,
-                       profile_compilation_info.get());
+                       profile_compilation_info.get(),
+                       dex_layout_thread_count);
 
     // In verify mode, we expect failure.
     if (verify) {
@@ -721,6 +730,11 @@ TEST_F(OatTest, DexFileFailsVerifierWithLayout) {
   TestDexFileInput(/*verify*/true, /*low_4gb*/false, /*use_profile*/true);
 }
 
+TEST_F(OatTest, DexFileFailsVerifierWithParallelLayout) {
+  TestDexFileInput(/*verify*/true, /*low_4gb*/false, /*use_profile*/true,
+                   /*dex_layout_thread_count*/2u);
+}
+
 void OatTest::TestZipFileInput(bool verify, CopyOption copy) {
   TimingLogger timings("OatTest::DexFileInput", false, false);
 
@@ -1176,6 +1176,24 @@ TEST_F(VerifierDepsTest, EncodeDecodeMulti) {
   decoded_deps.Dump(&os);
 }
 
+TEST_F(VerifierDepsTest, ParseVerifiedClassesMulti) {
+  VerifyDexFile("MultiDex");
+
+  ASSERT_GT(NumberOfCompiledDexFiles(), 1u);
+  std::vector<uint8_t> buffer;
+  verifier_deps_->Encode(dex_files_, &buffer);
+  ASSERT_FALSE(buffer.empty());
+
+  // The verified classes read in place must match those of a full decode.
+  VerifierDeps decoded_deps(dex_files_, ArrayRef<const uint8_t>(buffer));
+  std::vector<std::vector<bool>> verified_classes =
+      VerifierDeps::ParseVerifiedClasses(dex_files_, ArrayRef<const uint8_t>(buffer));
+  ASSERT_EQ(dex_files_.size(), verified_classes.size());
+  for (size_t i = 0; i < dex_files_.size(); ++i) {
+    EXPECT_EQ(decoded_deps.GetVerifiedClasses(*dex_files_[i]), verified_classes[i]);
+  }
+}
+
 TEST_F(VerifierDepsTest, UnverifiedClasses) {
   VerifyDexFile();
   ASSERT_FALSE(HasUnverifiedClass("LMyThread;"));
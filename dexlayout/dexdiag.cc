@@ -311,6 +311,77 @@ static void ProcessOneDexMapping(const std::vector<uint64_t>& pagemap,
   DisplayDexStatistics(start_page, end_page, section_resident_pages, sections, printer);
 }
 
+// Compact dex files in a vdex file share one data section, which is not part of the range
+// [Begin(), Begin() + Size()) of any of them. Display it once, together with the number of
+// resident pages that are also mapped by other processes.
+static void ProcessSharedDataMapping(const std::vector<uint64_t>& pagemap,
+                                     uint64_t map_start,
+                                     const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+                                     uint64_t vdex_start,
+                                     Printer* printer) {
+  uint64_t data_start = std::numeric_limits<uint64_t>::max();
+  uint64_t data_end = 0u;
+  size_t num_sharing_dex_files = 0u;
+  for (const auto& dex_file : dex_files) {
+    if (!dex_file->IsCompactDexFile() || dex_file->DataSize() == 0u) {
+      continue;
+    }
+    const uint64_t begin = reinterpret_cast<uint64_t>(dex_file->DataBegin());
+    if (begin < vdex_start) {
+      continue;
+    }
+    data_start = std::min(data_start, begin);
+    data_end = std::max(data_end, begin + dex_file->DataSize());
+    ++num_sharing_dex_files;
+  }
+  if (num_sharing_dex_files == 0u) {
+    return;
+  }
+  const uint64_t start_page = (data_start - vdex_start) / kPageSize;
+  const uint64_t end_page =
+      std::min<uint64_t>(RoundUp(data_end - vdex_start, kPageSize) / kPageSize, pagemap.size());
+  if (start_page >= end_page) {
+    return;
+  }
+  std::cout << "SHARED DATA"
+            << StringPrintf(": %" PRIx64 "-%" PRIx64,
+                            map_start + start_page * kPageSize,
+                            map_start + end_page * kPageSize)
+            << " used by " << num_sharing_dex_files << " dex files" << std::endl;
+  ::android::meminfo::PageAcct& page_acct = ::android::meminfo::PageAcct::Instance();
+  // Reading the map counts needs access to /proc/kpagecount.
+  const bool has_map_counts = page_acct.InitPageAcct();
+  size_t resident_pages = 0u;
+  size_t multi_mapped_pages = 0u;
+  for (uint64_t page = start_page; page < end_page; ++page) {
+    if (!::android::meminfo::page_present(pagemap[page])) {
+      continue;
+    }
+    ++resident_pages;
+    uint64_t map_count = 0u;
+    if (has_map_counts &&
+        page_acct.PageMapCount(::android::meminfo::page_pfn(pagemap[page]), &map_count) &&
+        map_count > 1u) {
+      ++multi_mapped_pages;
+    }
+  }
+  const size_t mapped_pages = end_page - start_page;
+  printer->PrintHeader();
+  printer->PrintOne("SHARED DATA",
+                    resident_pages,
+                    mapped_pages,
+                    100.0 * resident_pages / mapped_pages,
+                    100.0 * resident_pages / mapped_pages);
+  if (has_map_counts) {
+    printer->PrintOne("MULTI-MAPPED",
+                      multi_mapped_pages,
+                      mapped_pages,
+                      resident_pages != 0u ? 100.0 * multi_mapped_pages / resident_pages : 0.0,
+                      100.0 * multi_mapped_pages / mapped_pages);
+  }
+  printer->PrintSkipLine();
+}
+
 static bool IsVdexFileMapping(const std::string& mapped_name) {
   // Confirm that the map is from a vdex file.
   static const char* suffixes[] = { ".vdex" };
@@ -368,6 +439,11 @@ static bool DisplayMappingIfFromVdexFile(ProcMemInfo& proc, const Vma& vma, Prin
                          reinterpret_cast<uint64_t>(vdex->Begin()),
                          printer);
   }
+  ProcessSharedDataMapping(pagemap,
+                           vma.start,
+                           dex_files,
+                           reinterpret_cast<uint64_t>(vdex->Begin()),
+                           printer);
   return true;
 }
 
@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -519,6 +520,15 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
     }
   }
 
+  void CollectDirtyClassDescriptors(std::set<std::string>* descriptors)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (mirror::Object* obj : dirty_objects_) {
+      if (obj->IsClass()) {
+        descriptors->insert(obj->AsClass()->PrettyDescriptor());
+      }
+    }
+  }
+
   void DumpDirtyEntries() REQUIRES_SHARED(Locks::mutator_lock_) {
     // vector of pairs (size_t count, Class*)
     auto dirty_object_class_values =
@@ -1116,11 +1126,13 @@ class ImgDiagDumper {
   explicit ImgDiagDumper(std::ostream* os,
                          pid_t image_diff_pid,
                          pid_t zygote_diff_pid,
-                         bool dump_dirty_objects)
+                         bool dump_dirty_objects,
+                         std::set<std::string>* dirty_class_descriptors)
       : os_(os),
         image_diff_pid_(image_diff_pid),
         zygote_diff_pid_(zygote_diff_pid),
         dump_dirty_objects_(dump_dirty_objects),
+        dirty_class_descriptors_(dirty_class_descriptors),
         zygote_pid_only_(false) {}
 
   bool Init() {
@@ -1599,6 +1611,9 @@ class ImgDiagDumper {
     object_region_data.ProcessRegion(mapping_data,
                                      remotes,
                                      image_begin_unaligned);
+    if (dirty_class_descriptors_ != nullptr) {
+      object_region_data.CollectDirtyClassDescriptors(dirty_class_descriptors_);
+    }
 
     // Check all the ArtMethod entries in the image.
     RegionData<ArtMethod> artmethod_region_data(os_,
@@ -1797,6 +1812,8 @@ class ImgDiagDumper {
   pid_t image_diff_pid_;  // Dump image diff against boot.art if pid is non-negative
   pid_t zygote_diff_pid_;  // Dump image diff against zygote boot.art if pid is non-negative
   bool dump_dirty_objects_;  // Adds dumping of objects that are dirty.
+  // If not null, collects the descriptors of the private dirty classes of all images.
+  std::set<std::string>* dirty_class_descriptors_;
   bool zygote_pid_only_;  // The user only specified a pid for the zygote.
 
   // BacktraceMap used for finding the memory mapping of the image file.
@@ -1823,19 +1840,86 @@ class ImgDiagDumper {
   DISALLOW_COPY_AND_ASSIGN(ImgDiagDumper);
 };
 
+// The dirty objects profile accumulates the private dirty classes over many imgdiag runs, e.g.
+// of different app processes or at different times. Its entries are the lines in the format of
+// the --dirty-image-objects file of dex2oat, each preceded by a comment with the number of
+// samples in which the class was dirty, and the comment with the total number of samples.
+static constexpr const char kDirtyObjectsProfileSamples[] = "# samples: ";
+
+static bool UpdateDirtyObjectsProfile(const char* profile_file,
+                                      const std::set<std::string>& dirty_class_descriptors) {
+  size_t num_samples = 0u;
+  std::map<std::string, size_t> dirty_counts;
+  std::ifstream in(profile_file);
+  if (in.good()) {
+    size_t count = 1u;
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty()) {
+        continue;
+      } else if (StartsWith(line, kDirtyObjectsProfileSamples)) {
+        if (!android::base::ParseUint(line.substr(strlen(kDirtyObjectsProfileSamples)),
+                                      &num_samples)) {
+          fprintf(stderr, "Invalid sample count in %s: %s\n", profile_file, line.c_str());
+          return false;
+        }
+      } else if (StartsWith(line, "#")) {
+        const char* count_str = line.c_str() + 1u;
+        if (!android::base::ParseUint(count_str + strspn(count_str, " "), &count)) {
+          count = 1u;  // Not a count, e.g. a comment added by hand.
+        }
+      } else {
+        dirty_counts[line] += count;
+        count = 1u;
+      }
+    }
+    in.close();
+  }
+  ++num_samples;
+  for (const std::string& descriptor : dirty_class_descriptors) {
+    ++dirty_counts[descriptor];
+  }
+
+  // Write the classes that were dirty in most samples first.
+  std::vector<std::pair<size_t, const std::string*>> entries;
+  entries.reserve(dirty_counts.size());
+  for (const auto& entry : dirty_counts) {
+    entries.emplace_back(entry.second, &entry.first);
+  }
+  std::stable_sort(entries.begin(),
+                   entries.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  std::ofstream out(profile_file, std::ios::out | std::ios::trunc);
+  out << "# Private dirty boot image classes, written by imgdiag.\n";
+  out << kDirtyObjectsProfileSamples << num_samples << "\n";
+  for (const auto& entry : entries) {
+    out << "# " << entry.first << "\n" << *entry.second << "\n";
+  }
+  out.close();
+  if (!out.good()) {
+    fprintf(stderr, "Failed to write dirty objects profile %s\n", profile_file);
+    return false;
+  }
+  return true;
+}
+
 static int DumpImage(Runtime* runtime,
                      std::ostream* os,
                      pid_t image_diff_pid,
                      pid_t zygote_diff_pid,
-                     bool dump_dirty_objects) {
+                     bool dump_dirty_objects,
+                     const char* dirty_objects_profile) {
   ScopedObjectAccess soa(Thread::Current());
   gc::Heap* heap = runtime->GetHeap();
   const std::vector<gc::space::ImageSpace*>& image_spaces = heap->GetBootImageSpaces();
   CHECK(!image_spaces.empty());
+  std::set<std::string> dirty_class_descriptors;
   ImgDiagDumper img_diag_dumper(os,
                                 image_diff_pid,
                                 zygote_diff_pid,
-                                dump_dirty_objects);
+                                dump_dirty_objects || dirty_objects_profile != nullptr,
+                                dirty_objects_profile != nullptr ? &dirty_class_descriptors
+                                                                 : nullptr);
   if (!img_diag_dumper.Init()) {
     return EXIT_FAILURE;
   }
@@ -1850,6 +1934,10 @@ static int DumpImage(Runtime* runtime,
       return EXIT_FAILURE;
     }
   }
+  if (dirty_objects_profile != nullptr &&
+      !UpdateDirtyObjectsProfile(dirty_objects_profile, dirty_class_descriptors)) {
+    return EXIT_FAILURE;
+  }
   return EXIT_SUCCESS;
 }
 
@@ -1885,6 +1973,8 @@ struct ImgDiagArgs : public CmdlineArgs {
       }
     } else if (option == "--dump-dirty-objects") {
       dump_dirty_objects_ = true;
+    } else if (StartsWith(option, "--dirty-objects-profile=")) {
+      dirty_objects_profile_ = raw_option + strlen("--dirty-objects-profile=");
     } else {
       return kParseUnknownArgument;
     }
@@ -1938,6 +2028,11 @@ struct ImgDiagArgs : public CmdlineArgs {
         "against.\n"
         "      Example: --zygote-diff-pid=$(pid zygote)\n"
         "  --dump-dirty-objects: additionally output dirty objects of interest.\n"
+        "  --dirty-objects-profile=<file>: add the private dirty classes to the given profile,\n"
+        "      creating it if needed. Running imgdiag on many processes with the same profile\n"
+        "      counts in how many samples each class was dirty. The profile can be passed\n"
+        "      to dex2oat as --dirty-image-objects.\n"
+        "      Example: --dirty-objects-profile=/data/local/tmp/dirty-image-objects\n"
         "\n";
 
     return usage;
@@ -1947,6 +2042,7 @@ struct ImgDiagArgs : public CmdlineArgs {
   pid_t image_diff_pid_ = -1;
   pid_t zygote_diff_pid_ = -1;
   bool dump_dirty_objects_ = false;
+  const char* dirty_objects_profile_ = nullptr;
 };
 
 struct ImgDiagMain : public CmdlineMain<ImgDiagArgs> {
@@ -1957,7 +2053,8 @@ struct ImgDiagMain : public CmdlineMain<ImgDiagArgs> {
                      args_->os_,
                      args_->image_diff_pid_,
                      args_->zygote_diff_pid_,
-                     args_->dump_dirty_objects_) == EXIT_SUCCESS;
+                     args_->dump_dirty_objects_,
+                     args_->dirty_objects_profile_) == EXIT_SUCCESS;
   }
 };
 
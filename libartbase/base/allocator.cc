@@ -19,9 +19,13 @@
 #include <inttypes.h>
 #include <stdlib.h>
 
+#include <sstream>
+
 #include <android-base/logging.h>
 
 #include "atomic.h"
+#include "globals.h"
+#include "systrace.h"
 
 namespace art {
 
@@ -80,16 +84,32 @@ Atomic<size_t> g_max_bytes_used[kAllocatorTagCount];
 Atomic<uint64_t> g_total_bytes_used[kAllocatorTagCount];
 
 void Dump(std::ostream& os) {
-  if (kEnableTrackingAllocator) {
-    os << "Dumping native memory usage\n";
-    for (size_t i = 0; i < kAllocatorTagCount; ++i) {
-      uint64_t bytes_used = g_bytes_used[i].load(std::memory_order_relaxed);
-      uint64_t max_bytes_used = g_max_bytes_used[i].load(std::memory_order_relaxed);
-      uint64_t total_bytes_used = g_total_bytes_used[i].load(std::memory_order_relaxed);
-      if (total_bytes_used != 0) {
-        os << static_cast<AllocatorTag>(i) << " active=" << bytes_used << " max="
-           << max_bytes_used << " total=" << total_bytes_used << "\n";
-      }
+  os << "Dumping native memory usage\n";
+  for (size_t i = 0; i < kAllocatorTagCount; ++i) {
+    AllocatorTag tag = static_cast<AllocatorTag>(i);
+    if (!kEnableTrackingAllocator && !IsAlwaysTracked(tag)) {
+      continue;
+    }
+    uint64_t bytes_used = g_bytes_used[i].load(std::memory_order_relaxed);
+    uint64_t max_bytes_used = g_max_bytes_used[i].load(std::memory_order_relaxed);
+    uint64_t total_bytes_used = g_total_bytes_used[i].load(std::memory_order_relaxed);
+    if (total_bytes_used != 0) {
+      os << tag << " active=" << bytes_used << " max="
+         << max_bytes_used << " total=" << total_bytes_used << "\n";
+    }
+  }
+}
+
+void TraceCounters() {
+  if (!ATraceEnabled()) {
+    return;
+  }
+  for (size_t i = 0; i < kAllocatorTagCount; ++i) {
+    AllocatorTag tag = static_cast<AllocatorTag>(i);
+    if (IsAlwaysTracked(tag)) {
+      std::ostringstream name;
+      name << "Native " << tag << " (KB)";
+      ATraceIntegerValue(name.str().c_str(), static_cast<int32_t>(GetBytesUsed(tag) / KB));
     }
   }
 }
@@ -65,6 +65,10 @@ enum AllocatorTag {
   kAllocatorTagOatFile,
   kAllocatorTagDexFileVerifier,
   kAllocatorTagRosAlloc,
+  // The following tags are always tracked, see TrackedAllocators::IsAlwaysTracked().
+  kAllocatorTagLinearAlloc,
+  kAllocatorTagArenaPool,
+  kAllocatorTagJitData,
   kAllocatorTagCount,  // Must always be last element.
 };
 std::ostream& operator<<(std::ostream& os, AllocatorTag tag);
@@ -83,8 +87,25 @@ extern Atomic<size_t> g_max_bytes_used[kAllocatorTagCount];
 // Total number of bytes allocated of this kind.
 extern Atomic<uint64_t> g_total_bytes_used[kAllocatorTagCount];
 
+// Tags which are counted in all builds rather than only by TrackingAllocator when
+// kEnableTrackingAllocator is set. They are registered at coarse granularity (arenas of the
+// arena pools, chunks carved out by LinearAlloc, JIT data allocations made with the JIT lock
+// held), so the relaxed atomic updates are cheap enough to leave on. Note that the memory of
+// LinearAlloc comes from an arena pool and is also included in kAllocatorTagArenaPool.
+constexpr bool IsAlwaysTracked(AllocatorTag tag) {
+  return tag >= kAllocatorTagLinearAlloc && tag < kAllocatorTagCount;
+}
+
+inline size_t GetBytesUsed(AllocatorTag tag) {
+  return g_bytes_used[tag].load(std::memory_order_relaxed);
+}
+
+// Print the counters of all tracked tags.
 void Dump(std::ostream& os);
 
+// Publish the bytes used by each always tracked tag as trace counters.
+void TraceCounters();
+
 inline void RegisterAllocation(AllocatorTag tag, size_t bytes) {
   g_total_bytes_used[tag].fetch_add(bytes, std::memory_order_relaxed);
   size_t new_bytes = g_bytes_used[tag].fetch_add(bytes, std::memory_order_relaxed) + bytes;
@@ -18,6 +18,7 @@
 
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <iomanip>
 #include <numeric>
@@ -95,6 +96,7 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
   "Scheduler    ",
   "Profile      ",
   "SBCloner     ",
+  "Transaction  ",
 };
 
 template <bool kCount>
@@ -188,6 +190,70 @@ void ArenaAllocatorMemoryTool::DoMakeInaccessible(void* ptr, size_t size) {
 Arena::Arena() : bytes_allocated_(0), memory_(nullptr), size_(0), next_(nullptr) {
 }
 
+ArenaPool::~ArenaPool() {
+  ReclaimThreadCaches();
+}
+
+ArenaPool::ThreadCache* ArenaPool::GetThreadCache() {
+  // Threads are assigned slots round-robin, so that concurrently running compiler and
+  // verifier threads mostly get a cache of their own.
+  static std::atomic<size_t> next_index(0u);
+  thread_local size_t index = next_index.fetch_add(1u, std::memory_order_relaxed);
+  return &thread_caches_[index % kNumThreadCaches];
+}
+
+Arena* ArenaPool::AllocArenaFromThreadCache(size_t size) {
+  ThreadCache* cache = GetThreadCache();
+  std::lock_guard<std::mutex> lock(cache->lock);
+  Arena* ret = cache->arenas;
+  if (ret != nullptr && LIKELY(ret->Size() >= size)) {
+    cache->arenas = ret->next_;
+    --cache->num_arenas;
+    return ret;
+  }
+  return nullptr;
+}
+
+Arena* ArenaPool::FreeArenaChainToThreadCache(Arena* first) {
+  ThreadCache* cache = GetThreadCache();
+  std::lock_guard<std::mutex> lock(cache->lock);
+  while (first != nullptr && cache->num_arenas != kMaxArenasPerThreadCache) {
+    Arena* next = first->next_;
+    // Only cache default-sized arenas, large ones go back to the shared free list.
+    if (first->Size() > arena_allocator::kArenaDefaultSize) {
+      break;
+    }
+    first->next_ = cache->arenas;
+    cache->arenas = first;
+    ++cache->num_arenas;
+    first = next;
+  }
+  return first;
+}
+
+void ArenaPool::ReclaimThreadCaches() {
+  for (ThreadCache& cache : thread_caches_) {
+    std::lock_guard<std::mutex> lock(cache.lock);
+    while (cache.arenas != nullptr) {
+      Arena* arena = cache.arenas;
+      cache.arenas = arena->next_;
+      delete arena;
+    }
+    cache.num_arenas = 0u;
+  }
+}
+
+size_t ArenaPool::GetThreadCachesBytesAllocated() const {
+  size_t total = 0;
+  for (const ThreadCache& cache : thread_caches_) {
+    std::lock_guard<std::mutex> lock(cache.lock);
+    for (Arena* arena = cache.arenas; arena != nullptr; arena = arena->next_) {
+      total += arena->GetBytesAllocated();
+    }
+  }
+  return total;
+}
+
 size_t ArenaAllocator::BytesAllocated() const {
   return ArenaAllocatorStats::BytesAllocated();
 }
@@ -20,6 +20,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <mutex>
+
 #include "bit_utils.h"
 #include "debug_stack.h"
 #include "dchecked_vector.h"
@@ -104,6 +106,7 @@ enum ArenaAllocKind {
   kArenaAllocScheduler,
   kArenaAllocProfile,
   kArenaAllocSuperblockCloner,
+  kArenaAllocTransaction,
   kNumArenaAllocKinds
 };
 
@@ -212,6 +215,7 @@ class Arena {
   uint8_t* memory_;
   size_t size_;
   Arena* next_;
+  friend class ArenaPool;
   friend class MallocArenaPool;
   friend class MemMapArenaPool;
   friend class ArenaAllocator;
@@ -227,7 +231,7 @@ class Arena {
 
 class ArenaPool {
  public:
-  virtual ~ArenaPool() = default;
+  virtual ~ArenaPool();
 
   virtual Arena* AllocArena(size_t size) = 0;
   virtual void FreeArenaChain(Arena* first) = 0;
@@ -235,12 +239,40 @@ class ArenaPool {
   virtual void ReclaimMemory() = 0;
   virtual void LockReclaimMemory() = 0;
   // Trim the maps in arenas by madvising, used by JIT to reduce memory usage.
+  // Arenas held in the thread caches are not trimmed.
   virtual void TrimMaps() = 0;
 
  protected:
   ArenaPool() = default;
 
+  // Small per-thread caches of free arenas in front of the pool's shared free list, so that
+  // short-lived allocators on different threads do not contend on the pool lock. Each thread
+  // is assigned one of kNumThreadCaches slots, which keeps the retained memory bounded
+  // regardless of the number of threads.
+  static constexpr size_t kNumThreadCaches = 8u;
+  static constexpr size_t kMaxArenasPerThreadCache = 2u;
+
+  // Returns a cached arena of at least `size` bytes, or null if the thread's cache has none.
+  Arena* AllocArenaFromThreadCache(size_t size);
+  // Moves arenas from the chain to the thread's cache while it has room. Returns the rest of
+  // the chain, which the caller must put on its shared free list.
+  Arena* FreeArenaChainToThreadCache(Arena* first);
+  // Deletes all arenas held in the thread caches.
+  void ReclaimThreadCaches();
+  size_t GetThreadCachesBytesAllocated() const;
+
  private:
+  struct ThreadCache {
+    // Arena locks are at the bottom of the lock hierarchy, see MallocArenaPool.
+    mutable std::mutex lock;
+    Arena* arenas = nullptr;
+    size_t num_arenas = 0u;
+  };
+
+  ThreadCache* GetThreadCache();
+
+  ThreadCache thread_caches_[kNumThreadCaches];
+
   DISALLOW_COPY_AND_ASSIGN(ArenaPool);
 };
 
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "allocator.h"
 #include "arena_allocator-inl.h"
 #include "arena_bit_vector.h"
 #include "base/common_art_test.h"
@@ -32,6 +33,10 @@ class ArenaAllocatorTest : public testing::Test {
     }
     return result;
   }
+
+  void SetNext(Arena* arena, Arena* next) {
+    arena->next_ = next;
+  }
 };
 
 TEST_F(ArenaAllocatorTest, Test) {
@@ -349,5 +354,51 @@ TEST_F(ArenaAllocatorTest, ReallocAlignment) {
   }
 }
 
+TEST_F(ArenaAllocatorTest, ThreadCache) {
+  if (arena_allocator::kArenaAllocatorPreciseTracking) {
+    printf("WARNING: TEST DISABLED FOR precise arena tracking\n");
+    return;
+  }
+
+  MallocArenaPool pool;
+  Arena* arena1 = pool.AllocArena(arena_allocator::kArenaDefaultSize);
+  Arena* arena2 = pool.AllocArena(arena_allocator::kArenaDefaultSize);
+  SetNext(arena1, arena2);
+  SetNext(arena2, nullptr);
+  pool.FreeArenaChain(arena1);
+
+  // Freed arenas are reused on the same thread, most recently freed first.
+  EXPECT_EQ(arena2, pool.AllocArena(arena_allocator::kArenaDefaultSize));
+  Arena* arena3 = pool.AllocArena(arena_allocator::kArenaDefaultSize);
+  EXPECT_EQ(arena1, arena3);
+  SetNext(arena2, arena3);
+  SetNext(arena3, nullptr);
+  pool.FreeArenaChain(arena2);
+
+  // Cached arenas are deleted by ReclaimMemory().
+  pool.LockReclaimMemory();
+  Arena* arena4 = pool.AllocArena(arena_allocator::kArenaDefaultSize);
+  ASSERT_TRUE(arena4 != nullptr);
+  SetNext(arena4, nullptr);
+  pool.FreeArenaChain(arena4);
+}
+
+TEST_F(ArenaAllocatorTest, TracksArenaPoolBytes) {
+  size_t bytes_before = TrackedAllocators::GetBytesUsed(kAllocatorTagArenaPool);
+  {
+    MallocArenaPool pool;
+    {
+      ArenaAllocator allocator(&pool);
+      allocator.Alloc(arena_allocator::kArenaDefaultSize * 2u);
+      EXPECT_GE(TrackedAllocators::GetBytesUsed(kAllocatorTagArenaPool) - bytes_before,
+                arena_allocator::kArenaDefaultSize * 2u);
+    }
+    if (!arena_allocator::kArenaAllocatorPreciseTracking) {
+      // Arenas returned to the pool are still held by it.
+      EXPECT_NE(bytes_before, TrackedAllocators::GetBytesUsed(kAllocatorTagArenaPool));
+    }
+  }
+  EXPECT_EQ(bytes_before, TrackedAllocators::GetBytesUsed(kAllocatorTagArenaPool));
+}
 
 }  // namespace art
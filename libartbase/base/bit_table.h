@@ -17,6 +17,7 @@
 #ifndef ART_LIBARTBASE_BASE_BIT_TABLE_H_
 #define ART_LIBARTBASE_BASE_BIT_TABLE_H_
 
+#include <algorithm>
 #include <array>
 #include <initializer_list>
 #include <numeric>
@@ -69,6 +70,53 @@ class BitTableBase {
     return table_data_.LoadBits(offset, NumColumnBits(column)) + kValueBias;
   }
 
+  // Get the values of several columns of the same row. If the bits from the lowest to the
+  // highest requested column fit in 64 bits, they are read with a single wide load and the
+  // values are extracted from it, rather than doing a separate load and shift for each column.
+  template<uint32_t... kColumns>
+  ALWAYS_INLINE std::array<uint32_t, sizeof...(kColumns)> GetColumns(uint32_t row) const {
+    DCHECK(table_data_.IsValid()) << "Table has not been loaded";
+    DCHECK_LT(row, num_rows_);
+    static_assert(sizeof...(kColumns) != 0u, "No columns");
+    static_assert(((kColumns < kNumColumns) && ...), "Column out of range");
+    constexpr uint32_t kFirstColumn = std::min({kColumns...});
+    constexpr uint32_t kLastColumn = std::max({kColumns...});
+    size_t begin = column_offset_[kFirstColumn];
+    size_t end = column_offset_[kLastColumn + 1];
+    std::array<uint32_t, sizeof...(kColumns)> values;
+    if (LIKELY(end - begin <= BitSizeOf<uint64_t>())) {
+      uint64_t bits = table_data_.LoadBits<uint64_t>(row * NumRowBits() + begin, end - begin);
+      values = { static_cast<uint32_t>(BitFieldExtract(
+          bits, column_offset_[kColumns] - begin, NumColumnBits(kColumns))) + kValueBias... };
+    } else {
+      values = { Get(row, kColumns)... };
+    }
+    return values;
+  }
+
+  // Get the values of all columns of the given row.
+  ALWAYS_INLINE std::array<uint32_t, kNumColumns> GetRowValues(uint32_t row) const {
+    return GetRowValuesImpl(row, std::make_index_sequence<kNumColumns>());
+  }
+
+  // Returns the first row at or after `row` with the given value in `column`,
+  // or NumRows() if there is none. Steps through the column without re-deriving
+  // the bit offset of each row.
+  ALWAYS_INLINE uint32_t FindInColumn(uint32_t column, uint32_t row, uint32_t value) const {
+    DCHECK(table_data_.IsValid()) << "Table has not been loaded";
+    DCHECK_LT(column, kNumColumns);
+    size_t row_bits = NumRowBits();
+    size_t column_bits = NumColumnBits(column);
+    uint32_t encoded_value = value - kValueBias;
+    size_t offset = row * row_bits + column_offset_[column];
+    for (; row < num_rows_; ++row, offset += row_bits) {
+      if (table_data_.LoadBits(offset, column_bits) == encoded_value) {
+        return row;
+      }
+    }
+    return num_rows_;
+  }
+
   ALWAYS_INLINE BitMemoryRegion GetBitMemoryRegion(uint32_t row, uint32_t column = 0) const {
     DCHECK(table_data_.IsValid()) << "Table has not been loaded";
     DCHECK_LT(row, num_rows_);
@@ -96,6 +144,12 @@ class BitTableBase {
   }
 
  protected:
+  template<size_t... kColumns>
+  ALWAYS_INLINE std::array<uint32_t, kNumColumns> GetRowValuesImpl(
+      uint32_t row, std::index_sequence<kColumns...>) const {
+    return GetColumns<kColumns...>(row);
+  }
+
   BitMemoryRegion table_data_;
   size_t num_rows_ = 0;
   uint16_t column_offset_[kNumColumns + 1] = {};
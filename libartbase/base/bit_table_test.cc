@@ -119,6 +119,42 @@ TEST(BitTableTest, TestBigTable) {
   EXPECT_EQ(32u, table.NumColumnBits(3));
 }
 
+TEST(BitTableTest, TestGetColumns) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+
+  constexpr uint32_t kNoValue = -1;
+  std::vector<uint8_t> buffer;
+  BitMemoryWriter<std::vector<uint8_t>> writer(&buffer, /* bit_offset= */ 5);
+  BitTableBuilderBase<4> builder(&allocator);
+  builder.Add({42u, kNoValue, static_cast<uint32_t>(-2), static_cast<uint32_t>(-4)});
+  builder.Add({62u, 1u, static_cast<uint32_t>(-3), 7u});
+  builder.Add({3u, kNoValue, 0u, kNoValue});
+  builder.Encode(writer);
+
+  BitMemoryReader reader(buffer.data(), /* bit_offset= */ 5);
+  BitTableBase<4> table(reader);
+  EXPECT_EQ(3u, table.NumRows());
+  // Columns 2 and 3 need 64 bits together, so rows do not fit in a single wide load.
+  EXPECT_EQ(64u, table.NumColumnBits(2) + table.NumColumnBits(3));
+  for (uint32_t row = 0; row < table.NumRows(); row++) {
+    std::array<uint32_t, 2> low = table.GetColumns<0, 1>(row);
+    EXPECT_EQ(table.Get(row, 0), low[0]);
+    EXPECT_EQ(table.Get(row, 1), low[1]);
+    std::array<uint32_t, 2> reversed = table.GetColumns<3, 2>(row);
+    EXPECT_EQ(table.Get(row, 3), reversed[0]);
+    EXPECT_EQ(table.Get(row, 2), reversed[1]);
+    std::array<uint32_t, 4> all = table.GetRowValues(row);
+    for (uint32_t column = 0; column < table.NumColumns(); column++) {
+      EXPECT_EQ(table.Get(row, column), all[column]);
+    }
+  }
+  EXPECT_EQ(1u, table.FindInColumn(1, 0, 1u));
+  EXPECT_EQ(2u, table.FindInColumn(1, 2, kNoValue));
+  EXPECT_EQ(3u, table.FindInColumn(0, 0, 5u));
+}
+
 TEST(BitTableTest, TestDedup) {
   MallocArenaPool pool;
   ArenaStack arena_stack(&pool);
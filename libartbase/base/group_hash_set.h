@@ -0,0 +1,550 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBARTBASE_BASE_GROUP_HASH_SET_H_
+#define ART_LIBARTBASE_BASE_GROUP_HASH_SET_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <android-base/logging.h>
+
+#include "base/hash_set.h"
+#include "bit_utils.h"
+#include "globals.h"
+#include "macros.h"
+
+namespace art {
+
+template <class Elem, class HashSetType>
+class GroupHashSetIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Elem;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Elem*;
+  using reference = Elem&;
+
+  GroupHashSetIterator(const GroupHashSetIterator&) = default;
+  GroupHashSetIterator(GroupHashSetIterator&&) = default;
+  GroupHashSetIterator(HashSetType* hash_set, size_t index) : index_(index), hash_set_(hash_set) {}
+
+  // Conversion from iterator to const_iterator.
+  template <class OtherElem,
+            class OtherHashSetType,
+            typename = typename std::enable_if<
+                std::is_same<Elem, const OtherElem>::value &&
+                std::is_same<HashSetType, const OtherHashSetType>::value>::type>
+  GroupHashSetIterator(const GroupHashSetIterator<OtherElem, OtherHashSetType>& other)
+      : index_(other.index_), hash_set_(other.hash_set_) {}
+
+  GroupHashSetIterator& operator=(const GroupHashSetIterator&) = default;
+  GroupHashSetIterator& operator=(GroupHashSetIterator&&) = default;
+
+  bool operator==(const GroupHashSetIterator& other) const {
+    return hash_set_ == other.hash_set_ && this->index_ == other.index_;
+  }
+
+  bool operator!=(const GroupHashSetIterator& other) const {
+    return !(*this == other);
+  }
+
+  GroupHashSetIterator operator++() {  // Value after modification.
+    this->index_ = hash_set_->NextFullSlot(index_ + 1u);
+    return *this;
+  }
+
+  GroupHashSetIterator operator++(int) {
+    GroupHashSetIterator temp = *this;
+    ++*this;
+    return temp;
+  }
+
+  Elem& operator*() const {
+    DCHECK(hash_set_->IsFullSlot(this->index_));
+    return hash_set_->ElementForIndex(this->index_);
+  }
+
+  Elem* operator->() const {
+    return &**this;
+  }
+
+ private:
+  size_t index_;
+  HashSetType* hash_set_;
+
+  template <class T, class HashFn, class Pred, class Alloc> friend class GroupHashSet;
+  template <class OtherElem, class OtherHashSetType> friend class GroupHashSetIterator;
+};
+
+// An open-addressing hash set in the style of Swiss tables. Each slot has a control byte that
+// holds 7 bits of the element's hash, or marks the slot as empty or deleted. Lookups compare the
+// control bytes of a group of 8 slots at once and only call the predicate for slots whose hash
+// bits match, so unlike HashSet there is no need for an EmptyFn. The group is probed with
+// 64-bit word operations, which works on any little-endian host without SIMD intrinsics.
+//
+// Unlike HashSet, this set cannot be written to or read from an image. Use HashSet for the
+// tables that are serialized, such as the class and intern tables.
+template <class T,
+          class HashFn = DefaultHashFn<T>,
+          class Pred = DefaultPred<T>,
+          class Alloc = std::allocator<T>>
+class GroupHashSet {
+ public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = GroupHashSetIterator<T, GroupHashSet>;
+  using const_iterator = GroupHashSetIterator<const T, const GroupHashSet>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+
+  static constexpr size_t kGroupWidth = 8u;
+
+  GroupHashSet() noexcept : GroupHashSet(allocator_type()) {}
+
+  explicit GroupHashSet(const allocator_type& alloc) noexcept
+      : allocfn_(alloc),
+        hashfn_(),
+        pred_(),
+        num_elements_(0u),
+        num_slots_(0u),
+        growth_left_(0u),
+        ctrl_(nullptr),
+        slots_(nullptr) {}
+
+  GroupHashSet(const GroupHashSet& other) noexcept
+      : allocfn_(other.allocfn_),
+        hashfn_(other.hashfn_),
+        pred_(other.pred_),
+        num_elements_(0u),
+        num_slots_(0u),
+        growth_left_(0u),
+        ctrl_(nullptr),
+        slots_(nullptr) {
+    reserve(other.size());
+    for (const T& element : other) {
+      insert(element);
+    }
+  }
+
+  GroupHashSet(GroupHashSet&& other) noexcept
+      : allocfn_(std::move(other.allocfn_)),
+        hashfn_(std::move(other.hashfn_)),
+        pred_(std::move(other.pred_)),
+        num_elements_(other.num_elements_),
+        num_slots_(other.num_slots_),
+        growth_left_(other.growth_left_),
+        ctrl_(other.ctrl_),
+        slots_(other.slots_) {
+    other.num_elements_ = 0u;
+    other.num_slots_ = 0u;
+    other.growth_left_ = 0u;
+    other.ctrl_ = nullptr;
+    other.slots_ = nullptr;
+  }
+
+  ~GroupHashSet() {
+    DeallocateStorage();
+  }
+
+  GroupHashSet& operator=(GroupHashSet&& other) noexcept {
+    GroupHashSet(std::move(other)).swap(*this);  // NOLINT [runtime/explicit] [5]
+    return *this;
+  }
+
+  GroupHashSet& operator=(const GroupHashSet& other) noexcept {
+    GroupHashSet(other).swap(*this);  // NOLINT(runtime/explicit) - a case of lint gone mad.
+    return *this;
+  }
+
+  void clear() {
+    DeallocateStorage();
+  }
+
+  iterator begin() {
+    return iterator(this, NextFullSlot(0u));
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, NextFullSlot(0u));
+  }
+
+  iterator end() {
+    return iterator(this, num_slots_);
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, num_slots_);
+  }
+
+  size_t size() const {
+    return num_elements_;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  // Erase the element and leave a deleted marker in its slot. Returns the next element.
+  iterator erase(iterator it) {
+    DCHECK(IsFullSlot(it.index_));
+    std::allocator_traits<Alloc>::destroy(allocfn_, &slots_[it.index_]);
+    SetCtrl(it.index_, kDeleted);
+    --num_elements_;
+    ++it;
+    return it;
+  }
+
+  // Find an element, returns end() if not found.
+  // Allows custom key (K) types, example of when this is useful:
+  // Set of Class* indexed by name, want to find a class with a name but can't allocate
+  // a temporary Class object in the heap for performance solution.
+  template <typename K>
+  iterator find(const K& key) {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  iterator FindWithHash(const K& key, size_t hash) {
+    return iterator(this, FindIndex(key, hash));
+  }
+
+  template <typename K>
+  const_iterator FindWithHash(const K& key, size_t hash) const {
+    return const_iterator(this, FindIndex(key, hash));
+  }
+
+  // Insert an element if no equal element is present. Returns the iterator to the equal or
+  // inserted element and whether the element was inserted.
+  std::pair<iterator, bool> insert(const T& element) {
+    return InsertWithHash(element, hashfn_(element));
+  }
+
+  std::pair<iterator, bool> insert(T&& element) {
+    return InsertWithHash(std::move(element), hashfn_(element));
+  }
+
+  template <typename U, typename = typename std::enable_if<std::is_convertible<U, T>::value>::type>
+  std::pair<iterator, bool> InsertWithHash(U&& element, size_t hash) {
+    DCHECK_EQ(hash, hashfn_(element));
+    size_t index = FindIndex(element, hash);
+    if (index != num_slots_) {
+      return std::make_pair(iterator(this, index), false);
+    }
+    index = PrepareInsert(hash);
+    std::allocator_traits<Alloc>::construct(allocfn_, &slots_[index], std::forward<U>(element));
+    return std::make_pair(iterator(this, index), true);
+  }
+
+  void swap(GroupHashSet& other) {
+    // Use argument-dependent lookup with fall-back to std::swap() for function objects.
+    using std::swap;
+    swap(allocfn_, other.allocfn_);
+    swap(hashfn_, other.hashfn_);
+    swap(pred_, other.pred_);
+    std::swap(num_elements_, other.num_elements_);
+    std::swap(num_slots_, other.num_slots_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+  }
+
+  allocator_type get_allocator() const {
+    return allocfn_;
+  }
+
+  // Make sure that `num_elements` elements fit without growing the table.
+  void reserve(size_t num_elements) {
+    if (num_elements > num_elements_ + growth_left_) {
+      Resize(SlotsForElements(num_elements));
+    }
+  }
+
+  size_t NumSlots() const {
+    return num_slots_;
+  }
+
+  // Returns the total number of groups probed by finding each element once. For statistics.
+  size_t TotalProbeDistance() const {
+    size_t total = 0u;
+    for (size_t i = 0; i != num_slots_; ++i) {
+      if (IsFullSlot(i)) {
+        size_t hash = hashfn_(ElementForIndex(i));
+        size_t mask = num_slots_ - 1u;
+        size_t pos = H1(hash) & mask;
+        size_t step = 0u;
+        while (((i - pos) & mask) >= kGroupWidth) {
+          step += kGroupWidth;
+          pos = (pos + step) & mask;
+          ++total;
+        }
+      }
+    }
+    return total;
+  }
+
+  double CalculateLoadFactor() const {
+    return num_slots_ != 0u ? static_cast<double>(size()) / static_cast<double>(num_slots_) : 0.0;
+  }
+
+ private:
+  // Control byte values. Full slots hold the 7 low bits of the hash, so their top bit is clear.
+  static constexpr uint8_t kEmpty = 0x80u;
+  static constexpr uint8_t kDeleted = 0xfeu;
+
+  static constexpr uint64_t kLsbs = UINT64_C(0x0101010101010101);
+  static constexpr uint64_t kMsbs = UINT64_C(0x8080808080808080);
+
+  // Keep at most 7/8 of the slots full.
+  static constexpr size_t kMaxLoadNumerator = 7u;
+  static constexpr size_t kMaxLoadDenominator = 8u;
+
+  static size_t H1(size_t hash) {
+    return hash >> 7;
+  }
+
+  static uint8_t H2(size_t hash) {
+    return static_cast<uint8_t>(hash & 0x7fu);
+  }
+
+  static size_t MaxElementsForSlots(size_t num_slots) {
+    return num_slots / kMaxLoadDenominator * kMaxLoadNumerator;
+  }
+
+  static size_t SlotsForElements(size_t num_elements) {
+    size_t num_slots = kGroupWidth;
+    while (MaxElementsForSlots(num_slots) < num_elements) {
+      num_slots *= 2u;
+    }
+    return num_slots;
+  }
+
+  // Bit masks of a group have the top bit of each matching control byte set.
+  // Matching by hash can have false positives, the predicate decides.
+  static uint64_t MatchHash(uint64_t group, uint8_t h2) {
+    uint64_t x = group ^ (kLsbs * h2);
+    return (x - kLsbs) & ~x & kMsbs;
+  }
+
+  static uint64_t MatchEmpty(uint64_t group) {
+    // kEmpty is the only control byte with the top bit set and bit 1 clear.
+    return group & ~(group << 6) & kMsbs;
+  }
+
+  static uint64_t MatchEmptyOrDeleted(uint64_t group) {
+    return group & kMsbs;
+  }
+
+  // Index within the group of the lowest set bit of a mask.
+  static size_t LowestMatch(uint64_t mask) {
+    DCHECK_NE(mask, 0u);
+    return static_cast<size_t>(CTZ(mask)) / kBitsPerByte;
+  }
+
+  uint64_t LoadGroup(size_t pos) const {
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+                  "Group probing assumes little-endian control words");
+    uint64_t group;
+    memcpy(&group, ctrl_ + pos, sizeof(group));
+    return group;
+  }
+
+  // The control bytes of the first group are mirrored after the last slot, so that a group
+  // loaded at any position does not need to wrap around.
+  void SetCtrl(size_t index, uint8_t value) {
+    DCHECK_LT(index, num_slots_);
+    ctrl_[index] = value;
+    if (index < kGroupWidth) {
+      ctrl_[num_slots_ + index] = value;
+    }
+  }
+
+  bool IsFullSlot(size_t index) const {
+    DCHECK_LT(index, num_slots_);
+    return (ctrl_[index] & 0x80u) == 0u;
+  }
+
+  size_t NextFullSlot(size_t index) const {
+    while (index < num_slots_ && !IsFullSlot(index)) {
+      ++index;
+    }
+    return index;
+  }
+
+  T& ElementForIndex(size_t index) {
+    DCHECK(IsFullSlot(index));
+    return slots_[index];
+  }
+
+  const T& ElementForIndex(size_t index) const {
+    DCHECK(IsFullSlot(index));
+    return slots_[index];
+  }
+
+  // Find the slot of an element, or return NumSlots() if not found.
+  template <typename K>
+  size_t FindIndex(const K& key, size_t hash) const {
+    DCHECK_EQ(hashfn_(key), hash);
+    if (UNLIKELY(num_slots_ == 0u)) {
+      return 0u;
+    }
+    size_t mask = num_slots_ - 1u;
+    uint8_t h2 = H2(hash);
+    size_t pos = H1(hash) & mask;
+    // Probe groups with triangular steps, which visits every group of a power-of-two table.
+    for (size_t step = kGroupWidth; ; step += kGroupWidth) {
+      uint64_t group = LoadGroup(pos);
+      for (uint64_t match = MatchHash(group, h2); match != 0u; match &= match - 1u) {
+        size_t index = (pos + LowestMatch(match)) & mask;
+        if (LIKELY(pred_(slots_[index], key))) {
+          return index;
+        }
+      }
+      if (LIKELY(MatchEmpty(group) != 0u)) {
+        return num_slots_;
+      }
+      pos = (pos + step) & mask;
+    }
+  }
+
+  // Find the first empty or deleted slot for the hash.
+  size_t FindFreeIndex(size_t hash) const {
+    size_t mask = num_slots_ - 1u;
+    size_t pos = H1(hash) & mask;
+    for (size_t step = kGroupWidth; ; step += kGroupWidth) {
+      uint64_t match = MatchEmptyOrDeleted(LoadGroup(pos));
+      if (match != 0u) {
+        return (pos + LowestMatch(match)) & mask;
+      }
+      pos = (pos + step) & mask;
+    }
+  }
+
+  // Mark a free slot for the hash as full and return its index, growing the table if needed.
+  size_t PrepareInsert(size_t hash) {
+    size_t index = (num_slots_ != 0u) ? FindFreeIndex(hash) : 0u;
+    if (UNLIKELY(num_slots_ == 0u || (growth_left_ == 0u && ctrl_[index] == kEmpty))) {
+      // Deleted slots can be reused without growing. Otherwise rehash, which drops the deleted
+      // slots, and double the table only if it is more than half full.
+      size_t num_slots = (num_elements_ + 1u <= MaxElementsForSlots(num_slots_) / 2u)
+          ? num_slots_
+          : SlotsForElements(std::max<size_t>(2u * num_elements_, 1u));
+      Resize(num_slots);
+      index = FindFreeIndex(hash);
+    }
+    if (ctrl_[index] == kEmpty) {
+      DCHECK_NE(growth_left_, 0u);
+      --growth_left_;
+    }
+    SetCtrl(index, H2(hash));
+    ++num_elements_;
+    return index;
+  }
+
+  void AllocateStorage(size_t num_slots) {
+    DCHECK(IsPowerOfTwo(num_slots));
+    DCHECK_GE(num_slots, kGroupWidth);
+    CtrlAlloc ctrl_alloc(allocfn_);
+    ctrl_ = ctrl_alloc.allocate(num_slots + kGroupWidth);
+    memset(ctrl_, kEmpty, num_slots + kGroupWidth);
+    slots_ = allocfn_.allocate(num_slots);
+    num_slots_ = num_slots;
+    num_elements_ = 0u;
+    growth_left_ = MaxElementsForSlots(num_slots);
+  }
+
+  void DeallocateStorage() {
+    if (ctrl_ != nullptr) {
+      for (size_t i = 0; i != num_slots_; ++i) {
+        if (IsFullSlot(i)) {
+          std::allocator_traits<Alloc>::destroy(allocfn_, &slots_[i]);
+        }
+      }
+      allocfn_.deallocate(slots_, num_slots_);
+      CtrlAlloc ctrl_alloc(allocfn_);
+      ctrl_alloc.deallocate(ctrl_, num_slots_ + kGroupWidth);
+    }
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    num_slots_ = 0u;
+    num_elements_ = 0u;
+    growth_left_ = 0u;
+  }
+
+  // Move all elements to a new table with `num_slots` slots.
+  void Resize(size_t num_slots) {
+    DCHECK_GE(MaxElementsForSlots(num_slots), num_elements_);
+    uint8_t* const old_ctrl = ctrl_;
+    T* const old_slots = slots_;
+    const size_t old_num_slots = num_slots_;
+    AllocateStorage(num_slots);
+    for (size_t i = 0; i != old_num_slots; ++i) {
+      if ((old_ctrl[i] & 0x80u) == 0u) {
+        T& element = old_slots[i];
+        size_t hash = hashfn_(element);
+        size_t index = FindFreeIndex(hash);
+        SetCtrl(index, H2(hash));
+        std::allocator_traits<Alloc>::construct(allocfn_, &slots_[index], std::move(element));
+        std::allocator_traits<Alloc>::destroy(allocfn_, &element);
+        ++num_elements_;
+        --growth_left_;
+      }
+    }
+    if (old_ctrl != nullptr) {
+      allocfn_.deallocate(old_slots, old_num_slots);
+      CtrlAlloc ctrl_alloc(allocfn_);
+      ctrl_alloc.deallocate(old_ctrl, old_num_slots + kGroupWidth);
+    }
+  }
+
+  using CtrlAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<uint8_t>;
+
+  Alloc allocfn_;  // Allocator function.
+  HashFn hashfn_;  // Hashing function.
+  Pred pred_;  // Equals function.
+  size_t num_elements_;  // Number of inserted elements.
+  size_t num_slots_;  // Number of slots, a power of two or zero.
+  size_t growth_left_;  // Number of empty slots that can be filled before the table grows.
+  uint8_t* ctrl_;  // Control bytes, `num_slots_ + kGroupWidth` of them.
+  T* slots_;  // Elements, constructed only in full slots.
+
+  friend class GroupHashSetIterator<T, GroupHashSet>;
+  friend class GroupHashSetIterator<const T, const GroupHashSet>;
+};
+
+template <class T, class HashFn, class Pred, class Alloc>
+void swap(GroupHashSet<T, HashFn, Pred, Alloc>& lhs, GroupHashSet<T, HashFn, Pred, Alloc>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace art
+
+#endif  // ART_LIBARTBASE_BASE_GROUP_HASH_SET_H_
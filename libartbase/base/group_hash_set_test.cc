@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "group_hash_set.h"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace art {
+
+class GroupHashSetTest : public testing::Test {
+ public:
+  GroupHashSetTest() : seed_(97421), unique_number_(0) {
+  }
+  std::string RandomString(size_t len) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < len; ++i) {
+      oss << static_cast<char>('A' + PRand() % 64);
+    }
+    static_assert(' ' < 'A', "space must be less than a");
+    oss << " " << unique_number_++;  // Relies on ' ' < 'A'
+    return oss.str();
+  }
+  void SetSeed(size_t seed) {
+    seed_ = seed;
+  }
+  size_t PRand() {  // Pseudo random.
+    seed_ = seed_ * 1103515245 + 12345;
+    return seed_;
+  }
+
+ private:
+  size_t seed_;
+  size_t unique_number_;
+};
+
+TEST_F(GroupHashSetTest, TestSmoke) {
+  GroupHashSet<std::string> hash_set;
+  const std::string test_string = "hello world 1234";
+  ASSERT_TRUE(hash_set.empty());
+  ASSERT_EQ(hash_set.size(), 0U);
+  hash_set.insert(test_string);
+  auto it = hash_set.find(test_string);
+  ASSERT_EQ(*it, test_string);
+  auto after_it = hash_set.erase(it);
+  ASSERT_TRUE(after_it == hash_set.end());
+  ASSERT_TRUE(hash_set.empty());
+  ASSERT_EQ(hash_set.size(), 0U);
+  it = hash_set.find(test_string);
+  ASSERT_TRUE(it == hash_set.end());
+}
+
+TEST_F(GroupHashSetTest, TestInsertAndErase) {
+  GroupHashSet<std::string> hash_set;
+  static constexpr size_t count = 1000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < count; ++i) {
+    // Insert a bunch of elements and make sure we can find them.
+    strings.push_back(RandomString(10));
+    auto result = hash_set.insert(strings[i]);
+    ASSERT_TRUE(result.second);
+    ASSERT_EQ(*result.first, strings[i]);
+    auto it = hash_set.find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    ASSERT_EQ(*it, strings[i]);
+  }
+  ASSERT_EQ(strings.size(), hash_set.size());
+  // Inserting the same elements again does not change the set.
+  for (const std::string& s : strings) {
+    ASSERT_FALSE(hash_set.insert(s).second);
+  }
+  ASSERT_EQ(strings.size(), hash_set.size());
+  // Try to erase the odd strings.
+  for (size_t i = 1; i < count; i += 2) {
+    auto it = hash_set.find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    ASSERT_EQ(*it, strings[i]);
+    hash_set.erase(it);
+  }
+  // Test removed.
+  for (size_t i = 1; i < count; i += 2) {
+    auto it = hash_set.find(strings[i]);
+    ASSERT_TRUE(it == hash_set.end());
+  }
+  for (size_t i = 0; i < count; i += 2) {
+    auto it = hash_set.find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    ASSERT_EQ(*it, strings[i]);
+  }
+  ASSERT_LE(hash_set.CalculateLoadFactor(), 7.0 / 8.0);
+}
+
+TEST_F(GroupHashSetTest, TestIterator) {
+  GroupHashSet<std::string> hash_set;
+  ASSERT_TRUE(hash_set.begin() == hash_set.end());
+  static constexpr size_t count = 1000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < count; ++i) {
+    // Insert a bunch of elements and make sure we can find them.
+    strings.push_back(RandomString(10));
+    hash_set.insert(strings[i]);
+  }
+  // Make sure we visit each string exactly once.
+  std::unordered_set<std::string> found;
+  for (const std::string& s : hash_set) {
+    ASSERT_TRUE(found.insert(s).second);
+  }
+  ASSERT_EQ(found.size(), count);
+  for (const std::string& s : strings) {
+    ASSERT_EQ(found.count(s), 1u);
+  }
+  // Remove all the elements with iterator erase.
+  for (auto it = hash_set.begin(); it != hash_set.end();) {
+    it = hash_set.erase(it);
+  }
+  ASSERT_TRUE(hash_set.empty());
+  ASSERT_TRUE(hash_set.begin() == hash_set.end());
+}
+
+TEST_F(GroupHashSetTest, TestSwap) {
+  GroupHashSet<std::string> hash_seta, hash_setb;
+  std::vector<std::string> strings;
+  static constexpr size_t count = 1000;
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    hash_seta.insert(strings[i]);
+  }
+  std::swap(hash_seta, hash_setb);
+  hash_seta.insert("TEST");
+  hash_setb.insert("TEST2");
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    hash_seta.insert(strings[i]);
+  }
+  ASSERT_EQ(hash_seta.size(), count + 1u);
+  ASSERT_EQ(hash_setb.size(), count + 1u);
+}
+
+TEST_F(GroupHashSetTest, TestCopyAndMove) {
+  GroupHashSet<std::string> hash_set;
+  std::vector<std::string> strings;
+  static constexpr size_t count = 100;
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    hash_set.insert(strings[i]);
+  }
+  GroupHashSet<std::string> copy(hash_set);
+  ASSERT_EQ(copy.size(), count);
+  GroupHashSet<std::string> moved(std::move(copy));
+  ASSERT_EQ(moved.size(), count);
+  for (const std::string& s : strings) {
+    ASSERT_TRUE(hash_set.find(s) != hash_set.end());
+    ASSERT_TRUE(moved.find(s) != moved.end());
+  }
+  // The copy is independent of the original.
+  hash_set.clear();
+  ASSERT_TRUE(hash_set.empty());
+  ASSERT_EQ(moved.size(), count);
+}
+
+TEST_F(GroupHashSetTest, TestReserve) {
+  GroupHashSet<std::string> hash_set;
+  std::vector<size_t> sizes = {1, 10, 100, 1000, 10000};
+  for (size_t size : sizes) {
+    hash_set.reserve(size);
+    const size_t buckets_before = hash_set.NumSlots();
+    // Check that we expanded enough.
+    ASSERT_GE(buckets_before * 7u, size * 8u - 7u);
+    // Try inserting elements until we are at our reserve size and ensure the hash set did not
+    // expand.
+    while (hash_set.size() < size) {
+      hash_set.insert(std::to_string(hash_set.size()));
+    }
+    ASSERT_EQ(hash_set.NumSlots(), buckets_before);
+  }
+}
+
+TEST_F(GroupHashSetTest, TestStress) {
+  GroupHashSet<std::string> hash_set;
+  std::unordered_set<std::string> std_set;
+  std::vector<std::string> strings;
+  static constexpr size_t string_count = 2000;
+  static constexpr size_t operations = 100000;
+  static constexpr size_t target_size = 5000;
+  for (size_t i = 0; i < string_count; ++i) {
+    strings.push_back(RandomString(i % 10 + 1));
+  }
+  const size_t seed = time(nullptr);
+  SetSeed(seed);
+  LOG(INFO) << "Starting stress test with seed " << seed;
+  for (size_t i = 0; i < operations; ++i) {
+    ASSERT_EQ(hash_set.size(), std_set.size());
+    size_t delta = std::abs(static_cast<ssize_t>(target_size) -
+                            static_cast<ssize_t>(hash_set.size()));
+    size_t n = PRand();
+    if (n % target_size == 0) {
+      hash_set.clear();
+      std_set.clear();
+      ASSERT_TRUE(hash_set.empty());
+      ASSERT_TRUE(std_set.empty());
+    } else if (n % target_size < delta) {
+      // Skew towards adding elements until we are at the desired size.
+      const std::string& s = strings[PRand() % string_count];
+      ASSERT_EQ(hash_set.insert(s).second, std_set.insert(s).second);
+    } else {
+      const std::string& s = strings[PRand() % string_count];
+      auto it1 = hash_set.find(s);
+      auto it2 = std_set.find(s);
+      ASSERT_EQ(it1 == hash_set.end(), it2 == std_set.end());
+      if (it1 != hash_set.end()) {
+        ASSERT_EQ(*it1, *it2);
+        hash_set.erase(it1);
+        std_set.erase(it2);
+      }
+    }
+  }
+}
+
+TEST_F(GroupHashSetTest, TestNoEmptyValueNeeded) {
+  // Unlike HashSet, any value can be stored, including the ones HashSet uses as the empty marker.
+  GroupHashSet<const int*> hash_set;
+  int values[16];
+  ASSERT_TRUE(hash_set.insert(nullptr).second);
+  for (const int& value : values) {
+    ASSERT_TRUE(hash_set.insert(&value).second);
+  }
+  ASSERT_EQ(hash_set.size(), 17u);
+  ASSERT_TRUE(hash_set.find(nullptr) != hash_set.end());
+  for (const int& value : values) {
+    ASSERT_TRUE(hash_set.find(&value) != hash_set.end());
+  }
+}
+
+TEST_F(GroupHashSetTest, TestStringViewLookup) {
+  GroupHashSet<std::string> hash_set;
+  hash_set.insert("abc");
+  hash_set.insert("def");
+  std::string_view abc("abc");
+  std::string_view xyz("xyz");
+  ASSERT_TRUE(hash_set.find(abc) != hash_set.end());
+  ASSERT_TRUE(hash_set.find(xyz) == hash_set.end());
+}
+
+}  // namespace art
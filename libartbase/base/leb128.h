@@ -17,6 +17,8 @@
 #ifndef ART_LIBARTBASE_BASE_LEB128_H_
 #define ART_LIBARTBASE_BASE_LEB128_H_
 
+#include <string.h>
+
 #include <vector>
 
 #include <android-base/logging.h>
@@ -55,6 +57,31 @@ static inline uint32_t DecodeUnsignedLeb128(const uint8_t** data) {
   return static_cast<uint32_t>(result);
 }
 
+// Reads `kCount` consecutive unsigned LEB128 values into `out`, updating the given pointer
+// to point just past the end of the last value. Equivalent to calling DecodeUnsignedLeb128()
+// `kCount` times, but small values, which are most of the class data, are decoded together:
+// every value takes at least one byte, so the first `kCount` bytes are read with a single
+// load and the values before the first byte with the continuation bit set are taken as-is.
+template <size_t kCount>
+static inline void DecodeUnsignedLeb128Batch(const uint8_t** data, /*out*/ uint32_t* out) {
+  static_assert(kCount != 0u && kCount <= sizeof(uint64_t), "Unsupported batch size");
+  const uint8_t* ptr = *data;
+  uint64_t bytes = 0u;
+  memcpy(&bytes, ptr, kCount);  // Little-endian: byte `i` is in bits [8 * i, 8 * i + 8).
+  constexpr uint64_t kContinuationBits =
+      UINT64_C(0x8080808080808080) >> (kBitsPerByte * (sizeof(uint64_t) - kCount));
+  uint64_t continuation = bytes & kContinuationBits;
+  size_t num_single_byte = (continuation == 0u) ? kCount : CTZ(continuation) / kBitsPerByte;
+  for (size_t i = 0; i != num_single_byte; ++i) {
+    out[i] = static_cast<uint8_t>(bytes >> (kBitsPerByte * i));
+  }
+  ptr += num_single_byte;
+  for (size_t i = num_single_byte; i != kCount; ++i) {
+    out[i] = DecodeUnsignedLeb128(&ptr);
+  }
+  *data = ptr;
+}
+
 static inline uint32_t DecodeUnsignedLeb128WithoutMovingCursor(const uint8_t* data) {
   return DecodeUnsignedLeb128(&data);
 }
@@ -272,6 +272,37 @@ TEST(Leb128Test, UnsignedUpdate) {
   }
 }
 
+TEST(Leb128Test, UnsignedBatch) {
+  // Mix single-byte and multi-byte values at every position of the batch.
+  std::vector<uint32_t> values;
+  for (const DecodeUnsignedLeb128TestCase& test : uleb128_tests) {
+    values.push_back(test.decoded);
+  }
+  for (uint32_t value : {0u, 1u, 0x7fu, 0x80u, 0x3fffu, 0x4000u, 0xffffffffu, 5u, 6u}) {
+    values.push_back(value);
+  }
+  Leb128EncodingVector<> builder;
+  for (uint32_t value : values) {
+    builder.PushBackUnsigned(value);
+  }
+  const uint8_t* data_end = builder.GetData().data() + builder.GetData().size();
+  for (size_t start = 0; start + 4u <= values.size(); ++start) {
+    const uint8_t* expected_ptr = builder.GetData().data();
+    for (size_t i = 0; i != start; ++i) {
+      DecodeUnsignedLeb128(&expected_ptr);
+    }
+    const uint8_t* batch_ptr = expected_ptr;
+    uint32_t out[4];
+    DecodeUnsignedLeb128Batch<4>(&batch_ptr, out);
+    for (size_t i = 0; i != 4u; ++i) {
+      EXPECT_EQ(values[start + i], out[i]) << start << " " << i;
+      DecodeUnsignedLeb128(&expected_ptr);
+    }
+    EXPECT_EQ(expected_ptr, batch_ptr);
+    EXPECT_LE(batch_ptr, data_end);
+  }
+}
+
 TEST(Leb128Test, Speed) {
   std::unique_ptr<Histogram<uint64_t>> enc_hist(new Histogram<uint64_t>("Leb128EncodeSpeedTest", 5));
   std::unique_ptr<Histogram<uint64_t>> dec_hist(new Histogram<uint64_t>("Leb128DecodeSpeedTest", 5));
@@ -307,4 +338,53 @@ TEST(Leb128Test, Speed) {
   dec_hist->PrintConfidenceIntervals(std::cout, 0.99, dec_data);
 }
 
+TEST(Leb128Test, BatchSpeed) {
+  std::unique_ptr<Histogram<uint64_t>> single_hist(
+      new Histogram<uint64_t>("Leb128SingleDecodeSpeedTest", 5));
+  std::unique_ptr<Histogram<uint64_t>> batch_hist(
+      new Histogram<uint64_t>("Leb128BatchDecodeSpeedTest", 5));
+  // Encode triples shaped like class data methods: a small index delta, access flags
+  // and a code offset.
+  Leb128EncodingVector<> builder;
+  for (size_t i = 0; i < 1024 * 1024; i++) {
+    builder.PushBackUnsigned(i & 3u);
+    builder.PushBackUnsigned((i & 1u) != 0u ? 0x1u : 0x10001u);
+    builder.PushBackUnsigned(0x1000u + 16u * i);
+  }
+  const uint8_t* single_ptr = &builder.GetData()[0];
+  uint64_t last_time = NanoTime();
+  for (size_t i = 0; i < 1024; i++) {
+    for (size_t j = 0; j < 1024; j++) {
+      DecodeUnsignedLeb128(&single_ptr);
+      DecodeUnsignedLeb128(&single_ptr);
+      uint32_t code_off = DecodeUnsignedLeb128(&single_ptr);
+      EXPECT_EQ(0x1000u + 16u * ((i * 1024) + j), code_off);
+    }
+    uint64_t cur_time = NanoTime();
+    single_hist->AddValue(cur_time - last_time);
+    last_time = cur_time;
+  }
+  const uint8_t* batch_ptr = &builder.GetData()[0];
+  last_time = NanoTime();
+  for (size_t i = 0; i < 1024; i++) {
+    for (size_t j = 0; j < 1024; j++) {
+      uint32_t values[3];
+      DecodeUnsignedLeb128Batch<3>(&batch_ptr, values);
+      EXPECT_EQ(0x1000u + 16u * ((i * 1024) + j), values[2]);
+    }
+    uint64_t cur_time = NanoTime();
+    batch_hist->AddValue(cur_time - last_time);
+    last_time = cur_time;
+  }
+  EXPECT_EQ(single_ptr, batch_ptr);
+
+  Histogram<uint64_t>::CumulativeData single_data;
+  single_hist->CreateHistogram(&single_data);
+  single_hist->PrintConfidenceIntervals(std::cout, 0.99, single_data);
+
+  Histogram<uint64_t>::CumulativeData batch_data;
+  batch_hist->CreateHistogram(&batch_data);
+  batch_hist->PrintConfidenceIntervals(std::cout, 0.99, batch_data);
+}
+
 }  // namespace art
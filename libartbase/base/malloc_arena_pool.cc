@@ -23,6 +23,7 @@
 #include <numeric>
 
 #include <android-base/logging.h>
+#include "allocator.h"
 #include "arena_allocator-inl.h"
 #include "mman.h"
 
@@ -62,9 +63,11 @@ MallocArena::MallocArena(size_t size) {
   }
   DCHECK_ALIGNED(memory_, ArenaAllocator::kArenaAlignment);
   size_ = size;
+  TrackedAllocators::RegisterAllocation(kAllocatorTagArenaPool, size_);
 }
 
 MallocArena::~MallocArena() {
+  TrackedAllocators::RegisterFree(kAllocatorTagArenaPool, size_);
   constexpr size_t overallocation = RequiredOverallocation();
   if (overallocation != 0u && kRunningOnMemoryTool) {
     size_t head = memory_ - unaligned_memory_;
@@ -90,6 +93,7 @@ MallocArenaPool::~MallocArenaPool() {
 }
 
 void MallocArenaPool::ReclaimMemory() {
+  ReclaimThreadCaches();
   while (free_arenas_ != nullptr) {
     Arena* arena = free_arenas_;
     free_arenas_ = free_arenas_->next_;
@@ -103,8 +107,8 @@ void MallocArenaPool::LockReclaimMemory() {
 }
 
 Arena* MallocArenaPool::AllocArena(size_t size) {
-  Arena* ret = nullptr;
-  {
+  Arena* ret = AllocArenaFromThreadCache(size);
+  if (ret == nullptr) {
     std::lock_guard<std::mutex> lock(lock_);
     if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
       ret = free_arenas_;
@@ -123,7 +127,7 @@ void MallocArenaPool::TrimMaps() {
 }
 
 size_t MallocArenaPool::GetBytesAllocated() const {
-  size_t total = 0;
+  size_t total = GetThreadCachesBytesAllocated();
   std::lock_guard<std::mutex> lock(lock_);
   for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
     total += arena->GetBytesAllocated();
@@ -148,6 +152,7 @@ void MallocArenaPool::FreeArenaChain(Arena* first) {
     return;
   }
 
+  first = FreeArenaChainToThreadCache(first);
   if (first != nullptr) {
     Arena* last = first;
     while (last->next_ != nullptr) {
@@ -21,6 +21,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#if !defined(_WIN32)
+#include <sys/uio.h>
+#endif
+
 #if defined(__BIONIC__)
 #include <android/fdsan.h>
 #endif
@@ -470,6 +474,31 @@ bool FdFile::WriteFully(const void* buffer, size_t byte_count) {
   return WriteFullyGeneric<false>(buffer, byte_count, 0u);
 }
 
+#if !defined(_WIN32)
+bool FdFile::WritevFully(struct iovec* iov, int iovcnt) {
+  DCHECK(!read_only_mode_);
+  moveTo(GuardState::kBase, GuardState::kClosed, "Writing into closed file.");
+  while (iovcnt > 0) {
+    ssize_t bytes_written = TEMP_FAILURE_RETRY(writev(fd_, iov, iovcnt));
+    if (bytes_written == -1) {
+      return false;
+    }
+    // Skip the fully written buffers and adjust the partially written one.
+    size_t remaining = static_cast<size_t>(bytes_written);
+    while (iovcnt > 0 && remaining >= iov->iov_len) {
+      remaining -= iov->iov_len;
+      ++iov;
+      --iovcnt;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+      iov->iov_len -= remaining;
+    }
+  }
+  return true;
+}
+#endif
+
 bool FdFile::Copy(FdFile* input_file, int64_t offset, int64_t size) {
   DCHECK(!read_only_mode_);
   off_t off = static_cast<off_t>(offset);
@@ -24,6 +24,8 @@
 #include "base/macros.h"
 #include "random_access_file.h"
 
+struct iovec;
+
 namespace unix_file {
 
 // If true, check whether Flush and Close are called before destruction.
@@ -101,6 +103,11 @@ class FdFile : public RandomAccessFile {
   bool PreadFully(void* buffer, size_t byte_count, size_t offset) WARN_UNUSED;
   bool WriteFully(const void* buffer, size_t byte_count) WARN_UNUSED;
   bool PwriteFully(const void* buffer, size_t byte_count, size_t offset) WARN_UNUSED;
+#if !defined(_WIN32)
+  // Writes the `iovcnt` buffers described by `iov` at the current offset, with as few
+  // system calls as possible. The contents of `iov` are changed on partial writes.
+  bool WritevFully(struct iovec* iov, int iovcnt) WARN_UNUSED;
+#endif
 
   // Copy data from another file.
   bool Copy(FdFile* input_file, int64_t offset, int64_t size);
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <sys/uio.h>
+
 #include "base/common_art_test.h"  // For ScratchFile
 #include "base/file_utils.h"
 #include "gtest/gtest.h"
@@ -144,6 +146,36 @@ TEST_F(FdFileTest, ReadWriteFullyWithOffset) {
   ASSERT_EQ(file.Close(), 0);
 }
 
+TEST_F(FdFileTest, WritevFully) {
+  // New scratch file, zero-length.
+  art::ScratchFile tmp;
+  FdFile file(tmp.GetFilename(), O_RDWR, false);
+  ASSERT_GE(file.Fd(), 0);
+  EXPECT_TRUE(file.IsOpened());
+
+  char first[] = "first ";
+  char empty[] = "";
+  char second[] = "second";
+  struct iovec iov[3];
+  iov[0].iov_base = first;
+  iov[0].iov_len = strlen(first);
+  iov[1].iov_base = empty;
+  iov[1].iov_len = 0u;
+  iov[2].iov_base = second;
+  iov[2].iov_len = strlen(second) + 1;
+  EXPECT_TRUE(file.WritevFully(iov, 3));
+  ASSERT_EQ(file.Flush(), 0);
+
+  const char* expected = "first second";
+  size_t length = strlen(expected) + 1;
+  EXPECT_EQ(static_cast<int64_t>(length), file.GetLength());
+  std::unique_ptr<char[]> read_string(new char[length]);
+  EXPECT_TRUE(file.PreadFully(&read_string[0], length, 0u));
+  EXPECT_STREQ(expected, &read_string[0]);
+
+  ASSERT_EQ(file.Close(), 0);
+}
+
 TEST_F(FdFileTest, Copy) {
   art::ScratchFile src_tmp;
   FdFile src(src_tmp.GetFilename(), O_RDWR, false);
@@ -374,4 +374,24 @@ int GetTaskCount() {
   return count;
 }
 
+size_t GetResidentSetSize() {
+  android::base::unique_fd statm(open("/proc/self/statm", O_RDONLY | O_CLOEXEC));
+  if (statm == -1) {
+    return 0u;
+  }
+  char buffer[128];
+  ssize_t length = TEMP_FAILURE_RETRY(read(statm, buffer, sizeof(buffer) - 1u));
+  if (length <= 0) {
+    return 0u;
+  }
+  buffer[length] = '\0';
+  // The second field is the number of resident pages.
+  unsigned long long total_pages = 0u;  // NOLINT(runtime/int)
+  unsigned long long resident_pages = 0u;  // NOLINT(runtime/int)
+  if (sscanf(buffer, "%llu %llu", &total_pages, &resident_pages) != 2) {
+    return 0u;
+  }
+  return static_cast<size_t>(resident_pages) * kPageSize;
+}
+
 }  // namespace art
@@ -74,6 +74,18 @@ class VoidFunctor {
   }
 };
 
+// Hint to the processor that the caller is busy-waiting. Also a compiler barrier, so that
+// spin loops reload what they are waiting for.
+static inline void CpuRelax() {
+#if defined(__i386__) || defined(__x86_64__)
+  __asm__ __volatile__("pause" ::: "memory");
+#elif defined(__arm__) || defined(__aarch64__)
+  __asm__ __volatile__("yield" ::: "memory");
+#else
+  __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
 inline bool TestBitmap(size_t idx, const uint8_t* bitmap) {
   return ((bitmap[idx / kBitsPerByte] >> (idx % kBitsPerByte)) & 0x01) != 0;
 }
@@ -162,6 +174,10 @@ bool IsAddressKnownBackedByFileOrShared(const void* addr);
 // Returns the number of threads running.
 int GetTaskCount();
 
+// Returns the resident set size of the process in bytes, read from "/proc/self/statm",
+// or 0 if it cannot be read.
+size_t GetResidentSetSize();
+
 }  // namespace art
 
 #endif  // ART_LIBARTBASE_BASE_UTILS_H_
@@ -115,4 +115,10 @@ TEST_F(UtilsTest, GetProcessStatus) {
   EXPECT_EQ("<unknown>", GetProcessStatus("Dummy"));
 }
 
+TEST_F(UtilsTest, GetResidentSetSize) {
+  size_t rss = GetResidentSetSize();
+  EXPECT_NE(0u, rss);
+  EXPECT_EQ(0u, rss % kPageSize);
+}
+
 }  // namespace art
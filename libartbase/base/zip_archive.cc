@@ -54,6 +54,10 @@ bool ZipEntry::IsAlignedTo(size_t alignment) const {
   return IsAlignedParam(zip_entry_->offset, static_cast<int>(alignment));
 }
 
+uint64_t ZipEntry::GetOffset() const {
+  return zip_entry_->offset;
+}
+
 ZipEntry::~ZipEntry() {
   delete zip_entry_;
 }
@@ -67,6 +67,8 @@ class ZipEntry {
 
   bool IsUncompressed();
   bool IsAlignedTo(size_t alignment) const;
+  // Offset of the entry data in the zip file.
+  uint64_t GetOffset() const;
 
  private:
   ZipEntry(ZipArchiveHandle handle,
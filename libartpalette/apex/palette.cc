@@ -163,4 +163,9 @@ enum PaletteStatus PaletteAshmemSetProtRegion(int fd, int prot) {
   return m(fd, prot);
 }
 
+enum PaletteStatus PaletteReportGcMetrics(/*in*/const char* metrics, size_t metrics_len) {
+  PaletteReportGcMetricsMethod m = PaletteLoader::Instance().GetPaletteReportGcMetricsMethod();
+  return m(metrics, metrics_len);
+}
+
 }  // extern "C"
@@ -31,6 +31,7 @@
   M(PaletteTraceEnd)                                                        \
   M(PaletteTraceIntegerValue, const char* name, int32_t value)              \
   M(PaletteAshmemCreateRegion, const char* name, size_t size, int* fd)      \
-  M(PaletteAshmemSetProtRegion, int, int)
+  M(PaletteAshmemSetProtRegion, int, int)                                   \
+  M(PaletteReportGcMetrics, const char* metrics, size_t metrics_len)
 
 #endif  // ART_LIBARTPALETTE_INCLUDE_PALETTE_PALETTE_METHOD_LIST_H_
@@ -87,3 +87,8 @@ enum PaletteStatus PaletteAshmemSetProtRegion(int fd ATTRIBUTE_UNUSED,
                                               int prot ATTRIBUTE_UNUSED) {
   return PaletteStatus::kNotSupported;
 }
+
+enum PaletteStatus PaletteReportGcMetrics(const char* metrics ATTRIBUTE_UNUSED,
+                                          size_t metrics_len ATTRIBUTE_UNUSED) {
+  return PaletteStatus::kOkay;
+}
@@ -20,6 +20,7 @@
 
 #include "android-base/stringprintf.h"
 
+#include "base/bit_utils.h"
 #include "base/file_magic.h"
 #include "base/file_utils.h"
 #include "base/mem_map.h"
@@ -37,6 +38,24 @@ namespace art {
 
 namespace {
 
+// Prefetch the header and id sections of dex files mapped directly from a zip file.
+// They are read by the class linker when the dex file is registered at startup,
+// unlike the data section which is mostly accessed randomly.
+constexpr bool kPrefetchIdSectionsOfMappedDexFiles = true;
+
+void PrefetchIdSections(const DexFile& dex_file) {
+#ifdef _WIN32
+  UNUSED(dex_file);
+#else
+  const size_t size = std::min<size_t>(dex_file.GetHeader().data_off_, dex_file.Size());
+  uint8_t* begin = AlignDown(const_cast<uint8_t*>(dex_file.Begin()), kPageSize);
+  uint8_t* end = AlignUp(const_cast<uint8_t*>(dex_file.Begin()) + size, kPageSize);
+  if (begin < end && madvise(begin, end - begin, MADV_WILLNEED) != 0) {
+    PLOG(WARNING) << "madvise(MADV_WILLNEED) failed for " << dex_file.GetLocation();
+  }
+#endif
+}
+
 class MemMapContainer : public DexFileContainer {
  public:
   explicit MemMapContainer(MemMap&& mem_map) : mem_map_(std::move(mem_map)) { }
@@ -399,20 +418,24 @@ std::unique_ptr<const DexFile> ArtDexFileLoader::OpenOneDexFileFromZip(
   }
 
   MemMap map;
+  bool mapped_directly = false;
   if (zip_entry->IsUncompressed()) {
     if (!zip_entry->IsAlignedTo(alignof(DexFile::Header))) {
       // Do not mmap unaligned ZIP entries because
       // doing so would fail dex verification which requires 4 byte alignment.
       LOG(WARNING) << "Can't mmap dex file " << location << "!" << entry_name << " directly; "
+                   << "the entry data is at offset " << zip_entry->GetOffset() << ", "
                    << "please zipalign to " << alignof(DexFile::Header) << " bytes. "
                    << "Falling back to extracting file.";
     } else {
       // Map uncompressed files within zip as file-backed to avoid a dirty copy.
       map = zip_entry->MapDirectlyFromFile(location.c_str(), /*out*/error_msg);
       if (!map.IsValid()) {
-        LOG(WARNING) << "Can't mmap dex file " << location << "!" << entry_name << " directly; "
-                     << "is your ZIP file corrupted? Falling back to extraction.";
+        LOG(WARNING) << "Can't mmap dex file " << location << "!" << entry_name << " directly: "
+                     << *error_msg << "; is your ZIP file corrupted? Falling back to extraction.";
         // Try again with Extraction which still has a chance of recovery.
+      } else {
+        mapped_directly = true;
       }
     }
   }
@@ -467,6 +490,9 @@ std::unique_ptr<const DexFile> ArtDexFileLoader::OpenOneDexFileFromZip(
     *error_code = DexFileLoaderErrorCode::kVerifyError;
     return nullptr;
   }
+  if (kPrefetchIdSectionsOfMappedDexFiles && mapped_directly) {
+    PrefetchIdSections(*dex_file);
+  }
   *error_code = DexFileLoaderErrorCode::kNoError;
   return dex_file;
 }
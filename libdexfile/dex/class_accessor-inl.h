@@ -64,9 +64,11 @@ inline ClassAccessor::ClassAccessor(const DexFile& dex_file,
 }
 
 inline void ClassAccessor::Method::Read() {
-  index_ += DecodeUnsignedLeb128(&ptr_pos_);
-  access_flags_ = DecodeUnsignedLeb128(&ptr_pos_);
-  code_off_ = DecodeUnsignedLeb128(&ptr_pos_);
+  uint32_t values[3];
+  DecodeUnsignedLeb128Batch<3>(&ptr_pos_, values);
+  index_ += values[0];
+  access_flags_ = values[1];
+  code_off_ = values[2];
   if (hiddenapi_ptr_pos_ != nullptr) {
     hiddenapi_flags_ = DecodeUnsignedLeb128(&hiddenapi_ptr_pos_);
     DCHECK(hiddenapi::ApiList(hiddenapi_flags_).IsValid());
@@ -79,8 +81,10 @@ inline MethodReference ClassAccessor::Method::GetReference() const {
 
 
 inline void ClassAccessor::Field::Read() {
-  index_ += DecodeUnsignedLeb128(&ptr_pos_);
-  access_flags_ = DecodeUnsignedLeb128(&ptr_pos_);
+  uint32_t values[2];
+  DecodeUnsignedLeb128Batch<2>(&ptr_pos_, values);
+  index_ += values[0];
+  access_flags_ = values[1];
   if (hiddenapi_ptr_pos_ != nullptr) {
     hiddenapi_flags_ = DecodeUnsignedLeb128(&hiddenapi_ptr_pos_);
     DCHECK(hiddenapi::ApiList(hiddenapi_flags_).IsValid());
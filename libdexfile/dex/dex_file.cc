@@ -131,8 +131,6 @@ DexFile::DexFile(const uint8_t* base,
   // Must be 4-byte aligned to avoid undefined behavior when accessing
   // any of the sections via a pointer.
   CHECK_ALIGNED(begin_, alignof(Header));
-
-  InitializeSectionsFromMapList();
 }
 
 DexFile::~DexFile() {
@@ -173,18 +171,18 @@ bool DexFile::CheckMagicAndVersion(std::string* error_msg) const {
   return true;
 }
 
-void DexFile::InitializeSectionsFromMapList() {
+void DexFile::InitializeSectionsFromMapList() const {
   const MapList* map_list = reinterpret_cast<const MapList*>(DataBegin() + header_->map_off_);
   if (header_->map_off_ == 0 || header_->map_off_ > DataSize()) {
-    // Bad offset. The dex file verifier runs after this method and will reject the file.
+    // Bad offset. The dex file verifier rejects the file.
     return;
   }
   const size_t count = map_list->size_;
 
   size_t map_limit = header_->map_off_ + count * sizeof(MapItem);
   if (header_->map_off_ >= map_limit || map_limit > DataSize()) {
-    // Overflow or out out of bounds. The dex file verifier runs after
-    // this method and will reject the file as it is malformed.
+    // Overflow or out out of bounds. The dex file verifier rejects
+    // the file as it is malformed.
     return;
   }
 
@@ -18,6 +18,7 @@
 #define ART_LIBDEXFILE_DEX_DEX_FILE_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -427,6 +428,7 @@ class DexFile {
   }
 
   uint32_t NumMethodHandles() const {
+    EnsureSectionsFromMapList();
     return num_method_handles_;
   }
 
@@ -436,6 +438,7 @@ class DexFile {
   }
 
   uint32_t NumCallSiteIds() const {
+    EnsureSectionsFromMapList();
     return num_call_site_ids_;
   }
 
@@ -617,11 +620,12 @@ class DexFile {
   }
 
   ALWAYS_INLINE const dex::HiddenapiClassData* GetHiddenapiClassData() const {
+    EnsureSectionsFromMapList();
     return hiddenapi_class_data_;
   }
 
   ALWAYS_INLINE bool HasHiddenapiClassData() const {
-    return hiddenapi_class_data_ != nullptr;
+    return GetHiddenapiClassData() != nullptr;
   }
 
   const dex::AnnotationItem* GetAnnotationItem(const dex::AnnotationSetItem* set_item,
@@ -809,8 +813,13 @@ class DexFile {
   // Returns true if the header magic and version numbers are of the expected values.
   bool CheckMagicAndVersion(std::string* error_msg) const;
 
-  // Initialize section info for sections only found in map. Returns true on success.
-  void InitializeSectionsFromMapList();
+  // Initialize section info for sections only found in map. This is done on first use, as the
+  // map list is at the end of the file and most dex files opened from an oat file at class
+  // loader creation never need these sections, or are not used at all during startup.
+  void EnsureSectionsFromMapList() const {
+    std::call_once(map_list_once_, [this]() { InitializeSectionsFromMapList(); });
+  }
+  void InitializeSectionsFromMapList() const;
 
   // The base address of the memory mapping.
   const uint8_t* const begin_;
@@ -853,21 +862,24 @@ class DexFile {
   // Points to the base of the class definition list.
   const dex::ClassDef* const class_defs_;
 
+  // Guards the lazy initialization of the sections below from the map list.
+  mutable std::once_flag map_list_once_;
+
   // Points to the base of the method handles list.
-  const dex::MethodHandleItem* method_handles_;
+  mutable const dex::MethodHandleItem* method_handles_;
 
   // Number of elements in the method handles list.
-  size_t num_method_handles_;
+  mutable size_t num_method_handles_;
 
   // Points to the base of the call sites id list.
-  const dex::CallSiteIdItem* call_site_ids_;
+  mutable const dex::CallSiteIdItem* call_site_ids_;
 
   // Number of elements in the call sites list.
-  size_t num_call_site_ids_;
+  mutable size_t num_call_site_ids_;
 
   // Points to the base of the hiddenapi class data item_, or nullptr if the dex
   // file does not have one.
-  const dex::HiddenapiClassData* hiddenapi_class_data_;
+  mutable const dex::HiddenapiClassData* hiddenapi_class_data_;
 
   // If this dex file was loaded from an oat file, oat_dex_file_ contains a
   // pointer to the OatDexFile it was loaded from. Otherwise oat_dex_file_ is
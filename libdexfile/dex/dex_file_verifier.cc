@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <limits>
 #include <memory>
 
@@ -46,6 +47,16 @@ namespace {
 
 constexpr uint32_t kTypeIdLimit = std::numeric_limits<uint16_t>::max();
 
+// Returns true if all bytes of `word` are in the range [0x01, 0x7f], i.e. they encode
+// non-null ASCII characters which are valid single-byte MUTF-8 sequences. Subtracting
+// one from each byte sets its high bit only for a zero byte since there is no borrow
+// into the next byte unless the byte is zero.
+constexpr bool IsNonNullAsciiWord(uint64_t word) {
+  constexpr uint64_t kOnes = UINT64_C(0x0101010101010101);
+  constexpr uint64_t kHighBits = UINT64_C(0x8080808080808080);
+  return ((word | (word - kOnes)) & kHighBits) == 0u;
+}
+
 constexpr bool IsValidOrNoTypeId(uint16_t low, uint16_t high) {
   return (high == 0) || ((high == 0xffffU) && (low == 0xffffU));
 }
@@ -1646,6 +1657,22 @@ bool DexFileVerifier::CheckIntraStringDataItem() {
   const uint8_t* file_end = begin_ + size_;
 
   for (uint32_t i = 0; i < size; i++) {
+    // Skip runs of ASCII characters a word at a time, each byte is one UTF-16 code unit.
+    // Words with other bytes are checked byte by byte below to report the same errors.
+    while (size - i >= sizeof(uint64_t) &&
+           static_cast<size_t>(file_end - ptr_) >= sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, ptr_, sizeof(word));
+      if (!IsNonNullAsciiWord(word)) {
+        break;
+      }
+      ptr_ += sizeof(uint64_t);
+      i += sizeof(uint64_t);
+    }
+    if (i == size) {
+      break;
+    }
+
     CHECK_LT(i, size);  // b/15014252 Prevents hitting the impossible case below
     if (UNLIKELY(ptr_ >= file_end)) {
       ErrorStringPrintf("String data would go beyond end-of-file");
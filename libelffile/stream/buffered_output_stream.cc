@@ -31,10 +31,13 @@ BufferedOutputStream::~BufferedOutputStream() {
 
 bool BufferedOutputStream::WriteFully(const void* buffer, size_t byte_count) {
   if (byte_count > kBufferSize) {
-    if (!FlushBuffer()) {
-      return false;
+    if (used_ == 0) {
+      return out_->WriteFully(buffer, byte_count);
     }
-    return out_->WriteFully(buffer, byte_count);
+    // Write the buffered data and the new data together, without copying the new data.
+    size_t used = used_;
+    used_ = 0;
+    return out_->WriteFullyGathered(&buffer_[0], used, buffer, byte_count);
   }
   if (used_ + byte_count > kBufferSize) {
     if (!FlushBuffer()) {
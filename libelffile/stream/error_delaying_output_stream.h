@@ -48,6 +48,23 @@ class ErrorDelayingOutputStream final : public OutputStream {
     return true;
   }
 
+  // This function always succeeds to simplify code.
+  // Use Good() to check the actual status of the output stream.
+  bool WriteFullyGathered(const void* buffer1,
+                          size_t byte_count1,
+                          const void* buffer2,
+                          size_t byte_count2) override {
+    if (output_good_) {
+      if (!output_->WriteFullyGathered(buffer1, byte_count1, buffer2, byte_count2)) {
+        PLOG(ERROR) << "Failed to write " << (byte_count1 + byte_count2)
+                    << " bytes to " << GetLocation() << " at offset " << output_offset_;
+        output_good_ = false;
+      }
+    }
+    output_offset_ += byte_count1 + byte_count2;
+    return true;
+  }
+
   // This function always succeeds to simplify code.
   // Use Good() to check the actual status of the output stream.
   off_t Seek(off_t offset, Whence whence) override {
@@ -17,6 +17,7 @@
 #include "file_output_stream.h"
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "base/unix_file/fd_file.h"
@@ -29,12 +30,27 @@ bool FileOutputStream::WriteFully(const void* buffer, size_t byte_count) {
   return file_->WriteFully(buffer, byte_count);
 }
 
+bool FileOutputStream::WriteFullyGathered(const void* buffer1,
+                                          size_t byte_count1,
+                                          const void* buffer2,
+                                          size_t byte_count2) {
+  struct iovec iov[2];
+  iov[0].iov_base = const_cast<void*>(buffer1);
+  iov[0].iov_len = byte_count1;
+  iov[1].iov_base = const_cast<void*>(buffer2);
+  iov[1].iov_len = byte_count2;
+  return file_->WritevFully(iov, 2);
+}
+
 off_t FileOutputStream::Seek(off_t offset, Whence whence) {
   return lseek(file_->Fd(), offset, static_cast<int>(whence));
 }
 
 bool FileOutputStream::Flush() {
-  return file_->Flush() == 0;
+  // Writes go straight to the file, so there is nothing to flush. Syncing the file to storage
+  // is left to the owner of the file, which does it once when closing it with FlushClose() or
+  // FlushCloseOrErase(), instead of on every flush of the stream.
+  return true;
 }
 
 }  // namespace art
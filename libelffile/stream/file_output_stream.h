@@ -31,6 +31,11 @@ class FileOutputStream final : public OutputStream {
 
   bool WriteFully(const void* buffer, size_t byte_count) override;
 
+  bool WriteFullyGathered(const void* buffer1,
+                          size_t byte_count1,
+                          const void* buffer2,
+                          size_t byte_count2) override;
+
   off_t Seek(off_t offset, Whence whence) override;
 
   bool Flush() override;
@@ -43,6 +43,15 @@ class OutputStream {
 
   virtual bool WriteFully(const void* buffer, size_t byte_count) = 0;
 
+  // Writes `buffer1` followed by `buffer2`. Streams backed by a file override this
+  // to write both with a single gather write.
+  virtual bool WriteFullyGathered(const void* buffer1,
+                                  size_t byte_count1,
+                                  const void* buffer2,
+                                  size_t byte_count2) {
+    return WriteFully(buffer1, byte_count1) && WriteFully(buffer2, byte_count2);
+  }
+
   virtual off_t Seek(off_t offset, Whence whence) = 0;
 
   /*
@@ -334,7 +334,11 @@ NativeLoaderNamespace* LibraryNamespaces::FindNamespaceByClassLoader(JNIEnv* env
                            return env->IsSameObject(value.first, class_loader);
                          });
   if (it != namespaces_.end()) {
-    return &it->second;
+    // A class loader usually loads several libraries in a row, e.g. during app startup. Keep the
+    // last match at the front so that the next lookup does not compare with the other class
+    // loaders. Splicing does not move the elements, so returned pointers stay valid.
+    namespaces_.splice(namespaces_.begin(), namespaces_, it);
+    return &namespaces_.front().second;
   }
 
   return nullptr;
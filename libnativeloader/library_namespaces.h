@@ -64,6 +64,7 @@ class LibraryNamespaces {
 
   bool initialized_;
   NativeLoaderNamespace* app_main_namespace_;
+  // Ordered by most recent lookup, see FindNamespaceByClassLoader().
   std::list<std::pair<jweak, NativeLoaderNamespace>> namespaces_;
 };
 
@@ -829,11 +829,19 @@ bool ProfileCompilationInfo::ReadMethods(
   }
   size_t expected_unread_bytes_after_operation = buffer.CountUnreadBytes()
       - line_header.method_region_size_bytes;
+  if (expected_unread_bytes_after_operation == buffer.CountUnreadBytes()) {
+    return true;
+  }
+  // Look up the dex file data once per line rather than once per method.
+  DexFileData* const data = GetOrAddDexFileData(line_header.profile_key,
+                                                line_header.checksum,
+                                                line_header.num_method_ids);
+  if (data == nullptr) {
+    *error += "Profile data inconsistent for ReadMethods";
+    return false;
+  }
   uint16_t last_method_index = 0;
   while (buffer.CountUnreadBytes() > expected_unread_bytes_after_operation) {
-    DexFileData* const data = GetOrAddDexFileData(line_header.profile_key,
-                                                  line_header.checksum,
-                                                  line_header.num_method_ids);
     uint16_t diff_with_last_method_index;
     READ_UINT(uint16_t, buffer, diff_with_last_method_index, error);
     uint16_t method_index = last_method_index + diff_with_last_method_index;
@@ -867,6 +875,15 @@ bool ProfileCompilationInfo::ReadClasses(SafeBuffer& buffer,
     return false;
   }
 
+  if (line_header.class_set_size == 0u) {
+    return true;
+  }
+  DexFileData* const data = GetOrAddDexFileData(line_header.profile_key,
+                                                line_header.checksum,
+                                                line_header.num_method_ids);
+  if (data == nullptr) {
+    return false;
+  }
   uint16_t last_class_index = 0;
   for (uint16_t i = 0; i < line_header.class_set_size; i++) {
     uint16_t diff_with_last_class_index;
@@ -874,13 +891,8 @@ bool ProfileCompilationInfo::ReadClasses(SafeBuffer& buffer,
     uint16_t type_index = last_class_index + diff_with_last_class_index;
     last_class_index = type_index;
 
-    DexFileData* const data = GetOrAddDexFileData(line_header.profile_key,
-                                                  line_header.checksum,
-                                                  line_header.num_method_ids);
-    if (data == nullptr) {
-       return false;
-    }
-    data->class_set.insert(dex::TypeIndex(type_index));
+    // The classes are stored in increasing order, so they usually go to the end of the set.
+    data->class_set.insert(data->class_set.end(), dex::TypeIndex(type_index));
   }
   size_t total_bytes_read = unread_bytes_before_op - buffer.CountUnreadBytes();
   uint32_t expected_bytes_read = line_header.class_set_size * sizeof(uint16_t);
@@ -2010,9 +2022,10 @@ ProfileCompilationInfo::DexFileData::FindOrAddHotMethod(uint16_t method_index) {
     LOG(ERROR) << "Invalid method index " << method_index << ". num_method_ids=" << num_method_ids;
     return nullptr;
   }
-  return &(method_map.FindOrAdd(
-      method_index,
-      InlineCacheMap(std::less<uint16_t>(), allocator_->Adapter(kArenaAllocProfile)))->second);
+  // Do a single lookup and only create the inline cache map for new methods.
+  return &method_map.GetOrCreate(method_index, [this]() {
+    return InlineCacheMap(std::less<uint16_t>(), allocator_->Adapter(kArenaAllocProfile));
+  });
 }
 
 // Mark a method as executed at least once.
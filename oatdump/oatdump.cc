@@ -17,12 +17,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -76,6 +81,7 @@
 #include "oat.h"
 #include "oat_file-inl.h"
 #include "oat_file_manager.h"
+#include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack.h"
 #include "stack_map.h"
@@ -345,7 +351,10 @@ class OatDumperOptions {
                    const char* export_dex_location,
                    const char* app_image,
                    const char* app_oat,
-                   uint32_t addr2instr)
+                   const char* profile_file,
+                   uint32_t addr2instr,
+                   bool dump_method_sizes,
+                   size_t dump_thread_count)
     : dump_vmap_(dump_vmap),
       dump_code_info_stack_maps_(dump_code_info_stack_maps),
       disassemble_code_(disassemble_code),
@@ -358,7 +367,10 @@ class OatDumperOptions {
       export_dex_location_(export_dex_location),
       app_image_(app_image),
       app_oat_(app_oat),
+      profile_file_(profile_file),
       addr2instr_(addr2instr),
+      dump_method_sizes_(dump_method_sizes),
+      dump_thread_count_(dump_thread_count),
       class_loader_(nullptr) {}
 
   const bool dump_vmap_;
@@ -373,7 +385,10 @@ class OatDumperOptions {
   const char* const export_dex_location_;
   const char* const app_image_;
   const char* const app_oat_;
+  const char* const profile_file_;
   uint32_t addr2instr_;
+  const bool dump_method_sizes_;
+  const size_t dump_thread_count_;
   Handle<mirror::ClassLoader>* class_loader_;
 };
 
@@ -411,6 +426,10 @@ class OatDumper {
   using DexFileUniqV = std::vector<std::unique_ptr<const DexFile>>;
 
   bool Dump(std::ostream& os) {
+    if (options_.dump_method_sizes_) {
+      return DumpMethodSizes(os);
+    }
+
     bool success = true;
     const OatHeader& oat_header = oat_file_.GetOatHeader();
 
@@ -582,6 +601,9 @@ class OatDumper {
           success = false;
         }
       }
+      if (options_.profile_file_ != nullptr && !DumpCodeLayoutGroups(os)) {
+        success = false;
+      }
     }
 
     if (options_.export_dex_location_) {
@@ -875,6 +897,221 @@ class OatDumper {
     offsets_.insert(oat_method.GetVmapTableOffset());
   }
 
+  // Dump the number of methods, the code size and the code range of each group of methods
+  // that OatWriter lays out together, according to the flags in the given profile.
+  bool DumpCodeLayoutGroups(std::ostream& os) {
+    // Boot image profiles have their own version, so try both kinds of profile.
+    std::unique_ptr<ProfileCompilationInfo> profile(
+        new ProfileCompilationInfo(/*for_boot_image=*/ false));
+    if (!profile->Load(options_.profile_file_, /*clear_if_invalid=*/ false)) {
+      profile.reset(new ProfileCompilationInfo(/*for_boot_image=*/ true));
+      if (!profile->Load(options_.profile_file_, /*clear_if_invalid=*/ false)) {
+        os << "Failed to load profile '" << options_.profile_file_ << "'\n";
+        return false;
+      }
+    }
+
+    // The groups in OatWriter's layout order.
+    static constexpr const char* kGroupNames[] = {
+        "startup",
+        "startup post-startup",
+        "hot startup post-startup",
+        "hot startup",
+        "hot post-startup",
+        "hot",
+        "post-startup",
+        "never executed",
+    };
+    struct CodeLayoutGroup {
+      size_t num_methods = 0u;
+      size_t code_size = 0u;
+      uint32_t code_begin = std::numeric_limits<uint32_t>::max();
+      uint32_t code_end = 0u;
+    };
+    CodeLayoutGroup groups[arraysize(kGroupNames)];
+    std::set<uint32_t> seen_code_offsets;
+    for (const OatDexFile* oat_dex_file : oat_dex_files_) {
+      std::string error_msg;
+      const DexFile* const dex_file = OpenDexFile(oat_dex_file, &error_msg);
+      if (dex_file == nullptr) {
+        os << "Failed to open dex file '" << oat_dex_file->GetDexFileLocation() << "': "
+           << error_msg << "\n";
+        return false;
+      }
+      for (ClassAccessor accessor : dex_file->GetClasses()) {
+        const OatFile::OatClass oat_class = oat_dex_file->GetOatClass(accessor.GetClassDefIndex());
+        uint32_t class_method_index = 0;
+        for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+          const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index++);
+          uint32_t code_offset = AlignCodeOffset(oat_method.GetCodeOffset());
+          if (code_offset == 0u || !seen_code_offsets.insert(code_offset).second) {
+            continue;  // Not compiled, or deduplicated with a method already counted.
+          }
+          ProfileCompilationInfo::MethodHotness hotness =
+              profile->GetMethodHotness(MethodReference(dex_file, method.GetIndex()));
+          size_t group;
+          if (hotness.IsStartup()) {
+            group = hotness.IsHot() ? (hotness.IsPostStartup() ? 2u : 3u)
+                                    : (hotness.IsPostStartup() ? 1u : 0u);
+          } else if (hotness.IsHot()) {
+            group = hotness.IsPostStartup() ? 4u : 5u;
+          } else {
+            group = hotness.IsPostStartup() ? 6u : 7u;
+          }
+          uint32_t code_size = oat_method.GetQuickCodeSize();
+          CodeLayoutGroup& layout_group = groups[group];
+          layout_group.num_methods++;
+          layout_group.code_size += code_size;
+          layout_group.code_begin = std::min(layout_group.code_begin, code_offset);
+          layout_group.code_end = std::max(layout_group.code_end, code_offset + code_size);
+        }
+      }
+    }
+
+    os << "CODE LAYOUT BY PROFILE GROUP:\n";
+    for (size_t i = 0; i < arraysize(kGroupNames); ++i) {
+      const CodeLayoutGroup& layout_group = groups[i];
+      if (layout_group.num_methods == 0u) {
+        os << StringPrintf("%s: no compiled methods\n", kGroupNames[i]);
+      } else {
+        os << StringPrintf("%s: %zu methods, %zu bytes of code, in 0x%08x..0x%08x\n",
+                           kGroupNames[i],
+                           layout_group.num_methods,
+                           layout_group.code_size,
+                           layout_group.code_begin,
+                           layout_group.code_end - 1u);
+      }
+    }
+    os << "\n";
+    return true;
+  }
+
+  // Output one JSON object per line for each compiled method. The dex files are dumped on up
+  // to `dump_thread_count_` threads into separate buffers that are written out in dex file
+  // order as soon as they are complete.
+  bool DumpMethodSizes(std::ostream& os) {
+    // Open the dex files up front, OpenDexFile() is not thread-safe.
+    std::vector<const DexFile*> dex_files;
+    for (const OatDexFile* oat_dex_file : oat_dex_files_) {
+      std::string error_msg;
+      const DexFile* dex_file = OpenDexFile(oat_dex_file, &error_msg);
+      if (dex_file == nullptr) {
+        LOG(ERROR) << "Error opening dex file: " << error_msg;
+        return false;
+      }
+      dex_files.push_back(dex_file);
+    }
+    size_t num_threads = std::min(options_.dump_thread_count_, dex_files.size());
+    if (num_threads <= 1u) {
+      for (size_t i = 0; i != dex_files.size(); ++i) {
+        DumpMethodSizes(os, *oat_dex_files_[i], *dex_files[i]);
+        os << std::flush;
+      }
+      return true;
+    }
+
+    std::vector<std::string> outputs(dex_files.size());
+    std::vector<bool> done(dex_files.size(), false);
+    std::mutex lock;
+    std::condition_variable cond;
+    std::atomic<size_t> next_index(0u);
+    auto worker = [&]() {
+      for (size_t i = next_index.fetch_add(1u, std::memory_order_relaxed);
+           i < dex_files.size();
+           i = next_index.fetch_add(1u, std::memory_order_relaxed)) {
+        std::ostringstream oss;
+        DumpMethodSizes(oss, *oat_dex_files_[i], *dex_files[i]);
+        std::lock_guard<std::mutex> guard(lock);
+        outputs[i] = oss.str();
+        done[i] = true;
+        cond.notify_all();
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t i = 0; i != num_threads; ++i) {
+      threads.emplace_back(worker);
+    }
+    for (size_t i = 0; i != dex_files.size(); ++i) {
+      std::string output;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        cond.wait(guard, [&]() { return done[i]; });
+        output = std::move(outputs[i]);
+      }
+      os << output << std::flush;
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    return true;
+  }
+
+  void DumpMethodSizes(std::ostream& os, const OatDexFile& oat_dex_file, const DexFile& dex_file) {
+    const std::string location = JsonEscape(oat_dex_file.GetDexFileLocation());
+    for (ClassAccessor accessor : dex_file.GetClasses()) {
+      const char* descriptor = accessor.GetDescriptor();
+      if (DescriptorToDot(descriptor).find(options_.class_filter_) == std::string::npos) {
+        continue;
+      }
+      const OatFile::OatClass oat_class = oat_dex_file.GetOatClass(accessor.GetClassDefIndex());
+      uint32_t class_method_index = 0;
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        const uint32_t dex_method_idx = method.GetIndex();
+        const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index);
+        ++class_method_index;
+        if (oat_method.GetQuickCode() == nullptr) {
+          continue;
+        }
+        std::string method_name = dex_file.GetMethodName(dex_file.GetMethodId(dex_method_idx));
+        if (method_name.find(options_.method_filter_) == std::string::npos) {
+          continue;
+        }
+        size_t code_info_size = 0u;
+        size_t num_stack_maps = 0u;
+        size_t max_inline_depth = 0u;
+        CodeItemDataAccessor code_item_accessor(dex_file, method.GetCodeItem());
+        if (IsMethodGeneratedByOptimizingCompiler(oat_method, code_item_accessor)) {
+          size_t num_bits = 0u;
+          CodeInfo code_info(oat_method.GetVmapTable(), &num_bits);
+          code_info_size = BitsToBytesRoundUp(num_bits);
+          num_stack_maps = code_info.GetNumberOfStackMaps();
+          for (StackMap stack_map : code_info.GetStackMaps()) {
+            max_inline_depth = std::max(max_inline_depth,
+                                        code_info.GetInlineInfosOf(stack_map).size());
+          }
+        }
+        os << StringPrintf("{\"dex_file\":\"%s\",\"method\":\"%s\",\"dex_method_idx\":%u,"
+                           "\"code_offset\":%u,\"code_size\":%u,\"code_info_size\":%zu,"
+                           "\"stack_maps\":%zu,\"max_inline_depth\":%zu}\n",
+                           location.c_str(),
+                           JsonEscape(dex_file.PrettyMethod(dex_method_idx, true)).c_str(),
+                           dex_method_idx,
+                           oat_method.GetCodeOffset(),
+                           oat_method.GetQuickCodeSize(),
+                           code_info_size,
+                           num_stack_maps,
+                           max_inline_depth);
+      }
+    }
+  }
+
+  static std::string JsonEscape(const std::string& str) {
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str) {
+      if (c == '"' || c == '\\') {
+        result += '\\';
+        result += c;
+      } else if (static_cast<unsigned char>(c) < 0x20u) {
+        result += StringPrintf("\\u%04x", static_cast<unsigned char>(c));
+      } else {
+        result += c;
+      }
+    }
+    return result;
+  }
+
   bool DumpOatDexFile(std::ostream& os, const OatDexFile& oat_dex_file) {
     bool success = true;
     bool stop_analysis = false;
@@ -2374,10 +2611,10 @@ class ImageDumper {
       ImtConflictTable* table = method->GetImtConflictTable(image_header_.GetPointerSize());
       if (table != nullptr) {
         indent_os << "IMT conflict table " << table << " method: ";
-        for (size_t i = 0, count = table->NumEntries(pointer_size); i < count; ++i) {
-          indent_os << ArtMethod::PrettyMethod(table->GetImplementationMethod(i, pointer_size))
-                    << " ";
-        }
+        table->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods) {
+          indent_os << ArtMethod::PrettyMethod(methods.second) << " ";
+          return methods;
+        }, pointer_size);
       }
     } else {
       CodeItemDataAccessor code_item_accessor(method->DexInstructionData());
@@ -3151,15 +3388,11 @@ class IMTDumper {
       std::cerr << "    <No IMT?>" << std::endl;
       return;
     }
-    size_t table_index = 0;
-    for (;;) {
-      ArtMethod* ptr = table->GetInterfaceMethod(table_index, pointer_size);
-      if (ptr == nullptr) {
-        return;
-      }
-      table_index++;
-      std::cerr << "    " << ptr->PrettyMethod(true) << std::endl;
-    }
+    table->Visit([](const std::pair<ArtMethod*, ArtMethod*>& methods)
+                     REQUIRES_SHARED(Locks::mutator_lock_) {
+      std::cerr << "    " << methods.first->PrettyMethod(true) << std::endl;
+      return methods;
+    }, pointer_size);
   }
 
   static ImTable* PrepareAndGetImTable(Runtime* runtime,
@@ -3298,25 +3531,24 @@ class IMTDumper {
           continue;
         }
 
-        size_t table_index = 0;
-        for (;;) {
-          ArtMethod* ptr2 = current_table->GetInterfaceMethod(table_index, pointer_size);
-          if (ptr2 == nullptr) {
-            break;
-          }
-          table_index++;
-
-          std::string p_name = ptr2->PrettyMethod(true);
+        bool found = false;
+        current_table->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods)
+                                 REQUIRES_SHARED(Locks::mutator_lock_) {
+          std::string p_name = methods.first->PrettyMethod(true);
           if (android::base::StartsWith(p_name, method.c_str())) {
-            std::cerr << "  Slot "
-                      << index
-                      << " ("
-                      << current_table->NumEntries(pointer_size)
-                      << ")"
-                      << std::endl;
-            PrintTable(current_table, pointer_size);
-            return;
+            found = true;
           }
+          return methods;
+        }, pointer_size);
+        if (found) {
+          std::cerr << "  Slot "
+                    << index
+                    << " ("
+                    << current_table->NumEntries(pointer_size)
+                    << ")"
+                    << std::endl;
+          PrintTable(current_table, pointer_size);
+          return;
         }
       } else {
         std::string p_name = ptr->PrettyMethod(true);
@@ -3455,10 +3687,22 @@ struct OatdumpArgs : public CmdlineArgs {
       app_image_ = raw_option + strlen("--app-image=");
     } else if (StartsWith(option, "--app-oat=")) {
       app_oat_ = raw_option + strlen("--app-oat=");
+    } else if (StartsWith(option, "--profile=")) {
+      profile_file_ = raw_option + strlen("--profile=");
     } else if (StartsWith(option, "--dump-imt=")) {
       imt_dump_ = std::string(option.substr(strlen("--dump-imt=")));
     } else if (option == "--dump-imt-stats") {
       imt_stat_dump_ = true;
+    } else if (option == "--dump-method-sizes") {
+      dump_method_sizes_ = true;
+    } else if (StartsWith(option, "--dump-threads=")) {
+      if (!android::base::ParseUint(raw_option + strlen("--dump-threads="),
+                                    &dump_thread_count_,
+                                    std::numeric_limits<size_t>::max()) ||
+          dump_thread_count_ == 0u) {
+        *error_msg = "Invalid --dump-threads value";
+        return kParseError;
+      }
     } else {
       return kParseUnknownArgument;
     }
@@ -3485,6 +3729,9 @@ struct OatdumpArgs : public CmdlineArgs {
     } else if (image_location_ != nullptr && oat_filename_ != nullptr) {
       *error_msg = "Either --image or --oat-file must be specified but not both";
       return kParseError;
+    } else if (dump_method_sizes_ && oat_filename_ == nullptr) {
+      *error_msg = "--dump-method-sizes requires --oat-file";
+      return kParseError;
     }
 
     return kParseOk;
@@ -3552,6 +3799,10 @@ struct OatdumpArgs : public CmdlineArgs {
         "  --export-dex-to=<directory>: may be used to export oat embedded dex files.\n"
         "      Example: --export-dex-to=/data/local/tmp\n"
         "\n"
+        "  --profile=<file.prof>: output the number of methods, the size and the range of the\n"
+        "      compiled code of each group of methods with the same flags in the profile.\n"
+        "      Example: --profile=/data/misc/profiles/ref/com.example/primary.prof\n"
+        "\n"
         "  --addr2instr=<address>: output matching method disassembled code from relative\n"
         "                          address (e.g. PC from crash dump)\n"
         "      Example: --addr2instr=0x00001a3b\n"
@@ -3565,6 +3816,15 @@ struct OatdumpArgs : public CmdlineArgs {
         "\n"
         "  --dump-imt-stats: output IMT statistics for the given boot image\n"
         "      Example: --dump-imt-stats"
+        "\n"
+        "\n"
+        "  --dump-method-sizes: instead of the regular output, output one JSON object per line\n"
+        "      for each compiled method of the --oat-file, with its code size, CodeInfo size,\n"
+        "      number of stack maps and maximum inline depth (can be used with filters).\n"
+        "      Example: --dump-method-sizes --class-filter=java.lang\n"
+        "\n"
+        "  --dump-threads=<n>: number of threads dumping the dex files for --dump-method-sizes.\n"
+        "      Example: --dump-threads=4\n"
         "\n";
 
     return usage;
@@ -3587,10 +3847,13 @@ struct OatdumpArgs : public CmdlineArgs {
   bool list_methods_ = false;
   bool dump_header_only_ = false;
   bool imt_stat_dump_ = false;
+  bool dump_method_sizes_ = false;
+  size_t dump_thread_count_ = 1u;
   uint32_t addr2instr_ = 0;
   const char* export_dex_location_ = nullptr;
   const char* app_image_ = nullptr;
   const char* app_oat_ = nullptr;
+  const char* profile_file_ = nullptr;
 };
 
 struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
@@ -3613,7 +3876,10 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
         args_->export_dex_location_,
         args_->app_image_,
         args_->app_oat_,
-        args_->addr2instr_));
+        args_->profile_file_,
+        args_->addr2instr_,
+        args_->dump_method_sizes_,
+        args_->dump_thread_count_));
 
     return (args_->boot_image_location_ != nullptr ||
             args_->image_location_ != nullptr ||
@@ -47,4 +47,18 @@ TEST_F(OatDumpTest, TestOatImageStatic) {
   ASSERT_TRUE(Exec(kStatic, kModeCoreOat, {}, kListAndCode));
 }
 
+TEST_F(OatDumpTest, TestOatImageMethodSizes) {
+  TEST_DISABLED_FOR_ARM_AND_ARM64();
+  std::string error_msg;
+  ASSERT_TRUE(Exec(kDynamic, kModeCoreOat, {"--dump-method-sizes"}, kMethodSizes));
+}
+TEST_F(OatDumpTest, TestOatImageMethodSizesParallel) {
+  TEST_DISABLED_FOR_ARM_AND_ARM64();
+  std::string error_msg;
+  ASSERT_TRUE(Exec(kDynamic,
+                   kModeCoreOat,
+                   {"--dump-method-sizes", "--dump-threads=4"},
+                   kMethodSizes));
+}
+
 }  // namespace art
@@ -101,7 +101,8 @@ class OatDumpTest : public CommonRuntimeTest {
   // Display style.
   enum Display {
     kListOnly,
-    kListAndCode
+    kListAndCode,
+    kMethodSizes
   };
 
   std::string GetAppBaseName() {
@@ -184,9 +185,14 @@ class OatDumpTest : public CommonRuntimeTest {
       exec_argv.push_back("--symbolize=" + core_oat_location_);
       exec_argv.push_back("--output=" + core_oat_location_ + ".symbolize");
     } else {
-      expected_prefixes.push_back("LOCATION:");
-      expected_prefixes.push_back("MAGIC:");
-      expected_prefixes.push_back("DEX FILE COUNT:");
+      if (display == kMethodSizes) {
+        // Only the JSON lines of --dump-method-sizes are printed.
+        expected_prefixes.push_back("{\"dex_file\":");
+      } else {
+        expected_prefixes.push_back("LOCATION:");
+        expected_prefixes.push_back("MAGIC:");
+        expected_prefixes.push_back("DEX FILE COUNT:");
+      }
       if (display == kListAndCode) {
         // Code and dex code do not show up if list only.
         expected_prefixes.push_back("DEX CODE:");
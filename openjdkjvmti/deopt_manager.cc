@@ -35,11 +35,15 @@
 
 #include "deopt_manager.h"
 
+#include "art_field-inl.h"
 #include "art_jvmti.h"
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/mutex-inl.h"
+#include "class_linker.h"
+#include "dex/dex_file-inl.h"
 #include "dex/dex_file_annotations.h"
+#include "dex/dex_instruction-inl.h"
 #include "dex/modifiers.h"
 #include "events-inl.h"
 #include "gc/collector_type.h"
@@ -95,6 +99,9 @@ DeoptManager::DeoptManager()
     deopter_count_(0),
     breakpoint_status_lock_("JVMTI_BreakpointStatusLock",
                             static_cast<art::LockLevel>(art::LockLevel::kAbortLock + 1)),
+    field_watch_status_lock_("JVMTI_FieldWatchStatusLock",
+                             static_cast<art::LockLevel>(
+                                 art::LockLevel::kClassLinkerClassesLock + 1)),
     inspection_callback_(this),
     set_local_variable_called_(false) { }
 
@@ -313,6 +320,121 @@ void DeoptManager::RemoveMethodBreakpoint(art::ArtMethod* method) {
   }
 }
 
+// Returns true if the code of the method might read or write a field with the given name and type.
+// Field references are not resolved, so fields of other classes with the same name and type match
+// too. Quickened field accesses only record an offset, so they are assumed to match any field.
+static bool MethodMightAccessField(art::ArtMethod* method, const char* name, const char* type)
+    REQUIRES_SHARED(art::Locks::mutator_lock_) {
+  const art::DexFile* dex_file = method->GetDexFile();
+  for (const art::DexInstructionPcPair& inst : method->DexInstructions()) {
+    switch (art::Instruction::IndexTypeOf(inst->Opcode())) {
+      case art::Instruction::kIndexFieldRef: {
+        uint32_t field_idx =
+            (art::Instruction::FormatOf(inst->Opcode()) == art::Instruction::k22c)
+                ? inst->VRegC_22c()
+                : inst->VRegB_21c();
+        const art::dex::FieldId& field_id = dex_file->GetFieldId(field_idx);
+        if (strcmp(dex_file->GetFieldName(field_id), name) == 0 &&
+            strcmp(dex_file->GetFieldTypeDescriptor(field_id), type) == 0) {
+          return true;
+        }
+        break;
+      }
+      case art::Instruction::kIndexFieldOffset:
+        return true;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+static void CollectFieldAccessors(art::ObjPtr<art::mirror::Class> klass,
+                                  art::ArtField* field,
+                                  /*out*/ std::vector<art::ArtMethod*>* accessors)
+    REQUIRES_SHARED(art::Locks::mutator_lock_) {
+  if (!klass->IsResolved() || klass->IsErroneous() || klass->IsProxyClass()) {
+    // Methods of unresolved classes are handled when the class is prepared.
+    return;
+  }
+  const char* name = field->GetName();
+  const char* type = field->GetTypeDescriptor();
+  for (art::ArtMethod& method : klass->GetDeclaredMethods(art::kRuntimePointerSize)) {
+    if (method.IsInvokable() &&
+        !method.IsNative() &&
+        !method.IsObsolete() &&
+        MethodMightAccessField(&method, name, type)) {
+      accessors->push_back(&method);
+    }
+  }
+}
+
+void DeoptManager::AddFieldWatch(art::ArtField* field) {
+  art::Thread* self = art::Thread::Current();
+  std::vector<art::ArtMethod*> accessors;
+  {
+    art::MutexLock mu(self, field_watch_status_lock_);
+    auto it = field_watch_status_.find(field);
+    if (it == field_watch_status_.end()) {
+      art::ClassFuncVisitor visitor([&](art::ObjPtr<art::mirror::Class> klass)
+          REQUIRES_SHARED(art::Locks::mutator_lock_) {
+        CollectFieldAccessors(klass, field, &accessors);
+        return true;
+      });
+      art::Runtime::Current()->GetClassLinker()->VisitClasses(&visitor);
+      it = field_watch_status_.emplace(field, FieldWatchStatus{0u, accessors}).first;
+    } else {
+      accessors = it->second.accessors;
+    }
+    it->second.count++;
+  }
+  // The watch only needs the methods that might access the field to be interpreted, which is the
+  // same as what a breakpoint in each of them needs.
+  AddDeoptimizationRequester();
+  for (art::ArtMethod* method : accessors) {
+    AddMethodBreakpoint(method);
+  }
+}
+
+void DeoptManager::RemoveFieldWatch(art::ArtField* field) {
+  art::Thread* self = art::Thread::Current();
+  std::vector<art::ArtMethod*> accessors;
+  {
+    art::MutexLock mu(self, field_watch_status_lock_);
+    auto it = field_watch_status_.find(field);
+    DCHECK(it != field_watch_status_.end()) << "Field watch removed without being present!";
+    accessors = it->second.accessors;
+    if (--it->second.count == 0u) {
+      field_watch_status_.erase(it);
+    }
+  }
+  for (art::ArtMethod* method : accessors) {
+    RemoveMethodBreakpoint(method);
+  }
+  RemoveDeoptimizationRequester();
+}
+
+void DeoptManager::DeoptimizeFieldWatchAccessors(art::ObjPtr<art::mirror::Class> klass) {
+  art::Thread* self = art::Thread::Current();
+  // Pairs of a new accessor and the number of watches on its field.
+  std::vector<std::pair<art::ArtMethod*, uint32_t>> new_accessors;
+  {
+    art::MutexLock mu(self, field_watch_status_lock_);
+    for (auto& [field, status] : field_watch_status_) {
+      size_t old_size = status.accessors.size();
+      CollectFieldAccessors(klass, field, &status.accessors);
+      for (size_t i = old_size; i != status.accessors.size(); ++i) {
+        new_accessors.emplace_back(status.accessors[i], status.count);
+      }
+    }
+  }
+  for (const auto& [method, count] : new_accessors) {
+    for (uint32_t i = 0; i != count; ++i) {
+      AddMethodBreakpoint(method);
+    }
+  }
+}
+
 void DeoptManager::WaitForDeoptimizationToFinishLocked(art::Thread* self) {
   while (performing_deoptimization_) {
     deoptimization_condition_.Wait(self);
@@ -35,13 +35,16 @@
 #include <atomic>
 #include <iosfwd>
 #include <unordered_map>
+#include <vector>
 
 #include "base/mutex.h"
+#include "obj_ptr.h"
 #include "runtime_callbacks.h"
 
 #include <jvmti.h>
 
 namespace art {
+class ArtField;
 class ArtMethod;
 class ScopedObjectAccessUnchecked;
 namespace mirror {
@@ -96,6 +99,27 @@ class DeoptManager {
       REQUIRES(!deoptimization_status_lock_, !art::Roles::uninterruptible_)
       REQUIRES_SHARED(art::Locks::mutator_lock_);
 
+  // Deoptimize the methods that might access the field so that the interpreter reports accesses
+  // to it. Called once for every field access or modification watch set on the field.
+  void AddFieldWatch(art::ArtField* field)
+      REQUIRES(!deoptimization_status_lock_,
+               !field_watch_status_lock_,
+               !art::Roles::uninterruptible_)
+      REQUIRES_SHARED(art::Locks::mutator_lock_);
+
+  void RemoveFieldWatch(art::ArtField* field)
+      REQUIRES(!deoptimization_status_lock_,
+               !field_watch_status_lock_,
+               !art::Roles::uninterruptible_)
+      REQUIRES_SHARED(art::Locks::mutator_lock_);
+
+  // Deoptimize the methods of a newly prepared class that might access a watched field.
+  void DeoptimizeFieldWatchAccessors(art::ObjPtr<art::mirror::Class> klass)
+      REQUIRES(!deoptimization_status_lock_,
+               !field_watch_status_lock_,
+               !art::Roles::uninterruptible_)
+      REQUIRES_SHARED(art::Locks::mutator_lock_);
+
   void AddDeoptimizeAllMethods()
       REQUIRES(!deoptimization_status_lock_, !art::Roles::uninterruptible_)
       REQUIRES_SHARED(art::Locks::mutator_lock_);
@@ -187,6 +211,20 @@ class DeoptManager {
   std::unordered_map<art::ArtMethod*, uint32_t> breakpoint_status_
       GUARDED_BY(breakpoint_status_lock_);
 
+  struct FieldWatchStatus {
+    // Number of watches on the field from all envs.
+    uint32_t count;
+    // Methods that might access the field. Each watch holds a breakpoint reference on each of
+    // them, so that only these methods are interpreted instead of all methods.
+    std::vector<art::ArtMethod*> accessors;
+  };
+
+  // Protects the field-watch-status map. Never held while deoptimizing.
+  art::Mutex field_watch_status_lock_ ACQUIRED_BEFORE(art::Locks::classlinker_classes_lock_);
+  // A map from watched fields to the methods deoptimized for them.
+  std::unordered_map<art::ArtField*, FieldWatchStatus> field_watch_status_
+      GUARDED_BY(field_watch_status_lock_);
+
   // The MethodInspectionCallback we use to tell the runtime if we care about particular methods.
   JvmtiMethodInspectionCallback inspection_callback_;
 
@@ -1141,6 +1141,9 @@ static DeoptRequirement GetDeoptRequirement(ArtJvmtiEvent event, jthread thread)
   switch (event) {
     case ArtJvmtiEvent::kBreakpoint:
     case ArtJvmtiEvent::kException:
+    // Field watches deoptimize the methods that might access the watched fields themselves.
+    case ArtJvmtiEvent::kFieldModification:
+    case ArtJvmtiEvent::kFieldAccess:
       return DeoptRequirement::kLimited;
     // TODO MethodEntry is needed due to inconsistencies between the interpreter and the trampoline
     // in how to handle exceptions.
@@ -1148,8 +1151,6 @@ static DeoptRequirement GetDeoptRequirement(ArtJvmtiEvent event, jthread thread)
     case ArtJvmtiEvent::kExceptionCatch:
       return DeoptRequirement::kFull;
     case ArtJvmtiEvent::kMethodExit:
-    case ArtJvmtiEvent::kFieldModification:
-    case ArtJvmtiEvent::kFieldAccess:
     case ArtJvmtiEvent::kSingleStep:
     case ArtJvmtiEvent::kFramePop:
     case ArtJvmtiEvent::kForceEarlyReturnUpdateReturnValue:
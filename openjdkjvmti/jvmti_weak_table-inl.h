@@ -34,7 +34,9 @@
 
 #include "jvmti_weak_table.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 #include <android-base/logging.h>
 
@@ -225,13 +227,18 @@ ALWAYS_INLINE inline void JvmtiWeakTable<T>::UpdateTableWith(Updater& updater) {
     if (original_obj != target_obj) {
       if (kTargetNull == kIgnoreNull && target_obj == nullptr) {
         // Ignore null target, don't do anything.
+      } else if (target_obj != nullptr) {
+        // Re-key the existing node instead of erasing and re-inserting the element, so that a
+        // moving GC does not free and allocate a node for every tagged object it moved.
+        auto node = tagged_objects_.extract(it++);
+        node.key() = art::GcRoot<art::mirror::Object>(target_obj);
+        tagged_objects_.insert(std::move(node));
+        DCHECK_EQ(original_bucket_count, tagged_objects_.bucket_count());
+        continue;  // Iterator was advanced before the extraction.
       } else {
         T tag = it->second;
         it = tagged_objects_.erase(it);
-        if (target_obj != nullptr) {
-          tagged_objects_.emplace(art::GcRoot<art::mirror::Object>(target_obj), tag);
-          DCHECK_EQ(original_bucket_count, tagged_objects_.bucket_count());
-        } else if (kTargetNull == kCallHandleNull) {
+        if (kTargetNull == kCallHandleNull) {
           HandleNullSweep(tag);
         }
         continue;  // Iterator was implicitly updated by erase.
@@ -346,10 +353,22 @@ jvmtiError JvmtiWeakTable<T>::GetTaggedObjects(jvmtiEnv* jvmti_env,
                                                                          initial_object_size);
   ReleasableContainer<T, JvmtiAllocator<T>> selected_tags(allocator, initial_tag_size);
 
+  // With many tags, look them up in a sorted copy instead of comparing every tagged object
+  // against each of them.
+  constexpr size_t kMaxLinearSearchTags = 8;
+  bool use_sorted_tags = static_cast<size_t>(tag_count) > kMaxLinearSearchTags;
+  std::vector<T> sorted_tags;
+  if (use_sorted_tags) {
+    sorted_tags.assign(tags, tags + tag_count);
+    std::sort(sorted_tags.begin(), sorted_tags.end());
+  }
+
   size_t count = 0;
   for (auto& pair : tagged_objects_) {
     bool select;
-    if (tag_count > 0) {
+    if (use_sorted_tags) {
+      select = std::binary_search(sorted_tags.begin(), sorted_tags.end(), pair.second);
+    } else if (tag_count > 0) {
       select = false;
       for (size_t i = 0; i != static_cast<size_t>(tag_count); ++i) {
         if (tags[i] == pair.second) {
@@ -46,6 +46,7 @@
 #include "class_loader_utils.h"
 #include "class_table-inl.h"
 #include "common_throws.h"
+#include "deopt_manager.h"
 #include "dex/art_dex_file_loader.h"
 #include "dex/dex_file_annotations.h"
 #include "dex/dex_file_loader.h"
@@ -299,6 +300,9 @@ struct ClassCallback : public art::ClassLoadCallback {
   void ClassPrepare(art::Handle<art::mirror::Class> temp_klass,
                     art::Handle<art::mirror::Class> klass)
       override REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    // No code of the class has run yet, so deoptimize the methods that might access watched
+    // fields before anything can see the class.
+    DeoptManager::Get()->DeoptimizeFieldWatchAccessors(klass.Get());
     if (event_handler->IsEventEnabledAnywhere(ArtJvmtiEvent::kClassPrepare)) {
       art::Thread* thread = art::Thread::Current();
       if (temp_klass.Get() != klass.Get()) {
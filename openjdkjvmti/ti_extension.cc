@@ -396,6 +396,44 @@ jvmtiError ExtensionUtil::GetExtensionFunctions(jvmtiEnv* env,
     return error;
   }
 
+  // Allocation sampling
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(HeapExtensions::SetAllocationSamplingInterval),
+      "com.android.art.heap.set_allocation_sampling_interval",
+      "Records roughly one allocation per 'interval' bytes allocated, with its stack trace, into a"
+      " fixed-size buffer that overwrites the oldest samples when full. Only allocations that go"
+      " through the slow path of the allocator (e.g. TLAB refills and large objects) are sampled."
+      " An interval of 0 disables sampling and discards the samples that were not drained.",
+      {
+        { "interval", JVMTI_KIND_IN, JVMTI_TYPE_JLONG, false },
+      },
+      {
+         ERR(ILLEGAL_ARGUMENT),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(HeapExtensions::DrainAllocationSamples),
+      "com.android.art.heap.drain_allocation_samples",
+      "Removes the allocation samples recorded since the last call and passes each of them,"
+      " oldest first, to the given callback: void (*)(jlong class_tag, jlong size, jint"
+      " frame_count, const jvmtiFrameInfo* frames, void* user_data). The frames are only valid"
+      " during the callback, which must not call JNI functions. Must have can_tag_objects"
+      " capability.",
+      {
+        { "callback", JVMTI_KIND_IN_PTR, JVMTI_TYPE_CVOID, false },
+        { "user_data", JVMTI_KIND_IN_PTR, JVMTI_TYPE_CVOID, true },
+      },
+      {
+         ERR(MUST_POSSESS_CAPABILITY),
+         ERR(NULL_POINTER),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
   // These require index-ids and debuggable to function
   art::Runtime* runtime = art::Runtime::Current();
   if (runtime->GetJniIdType() == art::JniIdType::kIndices &&
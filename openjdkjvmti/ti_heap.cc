@@ -18,6 +18,7 @@
 
 #include <ios>
 #include <unordered_map>
+#include <vector>
 
 #include "android-base/logging.h"
 #include "android-base/thread_annotations.h"
@@ -32,6 +33,7 @@
 #include "deopt_manager.h"
 #include "dex/primitive.h"
 #include "events-inl.h"
+#include "gc/allocation_record.h"
 #include "gc/collector_type.h"
 #include "gc/gc_cause.h"
 #include "gc/heap-visit-objects-inl.h"
@@ -39,7 +41,7 @@
 #include "gc/scoped_gc_critical_section.h"
 #include "gc_root-inl.h"
 #include "handle.h"
-#include "handle_scope.h"
+#include "handle_scope-inl.h"
 #include "java_frame_root_info.h"
 #include "jni/jni_env_ext.h"
 #include "jni/jni_id_manager.h"
@@ -760,6 +762,10 @@ static jvmtiError DoIterateThroughHeap(T fn,
   bool stop_reports = false;
   const HeapFilter heap_filter(heap_filter_int);
   art::ObjPtr<art::mirror::Class> filter_klass = soa.Decode<art::mirror::Class>(klass);
+  // The tags of the classes seen so far. Objects do not move during the visit, and the
+  // callbacks may only change the tags of the object they are called for, so an entry only
+  // needs to be dropped when that object is the class itself.
+  std::unordered_map<art::mirror::Class*, jlong> class_tags;
   auto visitor = [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
     // Early return, as we can't really stop visiting.
     if (stop_reports) {
@@ -768,24 +774,30 @@ static jvmtiError DoIterateThroughHeap(T fn,
 
     art::ScopedAssertNoThreadSuspension no_suspension("IterateThroughHeapCallback");
 
+    // Check the class filter first, it does not need any tag table lookup.
+    art::ObjPtr<art::mirror::Class> klass = obj->GetClass();
+    if (filter_klass != nullptr) {
+      if (filter_klass != klass) {
+        return;
+      }
+    }
+
     jlong tag = 0;
     tag_table->GetTag(obj, &tag);
 
-    jlong class_tag = 0;
-    art::ObjPtr<art::mirror::Class> klass = obj->GetClass();
-    tag_table->GetTag(klass.Ptr(), &class_tag);
+    auto class_tag_it = class_tags.find(klass.Ptr());
+    if (class_tag_it == class_tags.end()) {
+      jlong new_class_tag = 0;
+      tag_table->GetTag(klass.Ptr(), &new_class_tag);
+      class_tag_it = class_tags.emplace(klass.Ptr(), new_class_tag).first;
+    }
+    jlong class_tag = class_tag_it->second;
     // For simplicity, even if we find a tag = 0, assume 0 = not tagged.
 
     if (!heap_filter.ShouldReportByHeapFilter(tag, class_tag)) {
       return;
     }
 
-    if (filter_klass != nullptr) {
-      if (filter_klass != klass) {
-        return;
-      }
-    }
-
     jlong size = obj->SizeOf();
 
     jint length = -1;
@@ -815,6 +827,11 @@ static jvmtiError DoIterateThroughHeap(T fn,
     if (!stop_reports) {
       stop_reports = ReportPrimitiveField::Report(obj, tag_table, callbacks, user_data);
     }
+
+    if (obj->IsClass()) {
+      // The callbacks above may have changed the tag of this class.
+      class_tags.erase(obj->AsClass().Ptr());
+    }
   };
   art::Runtime::Current()->GetHeap()->VisitObjects(visitor);
 
@@ -1611,6 +1628,70 @@ jvmtiError HeapExtensions::IterateThroughHeapExt(jvmtiEnv* env,
                               user_data);
 }
 
+jvmtiError HeapExtensions::SetAllocationSamplingInterval(jvmtiEnv* env ATTRIBUTE_UNUSED,
+                                                         jlong interval) {
+  if (interval < 0) {
+    return ERR(ILLEGAL_ARGUMENT);
+  }
+  art::Runtime::Current()->GetHeap()->SetAllocationSamplingInterval(
+      static_cast<size_t>(interval));
+  return OK;
+}
+
+jvmtiError HeapExtensions::DrainAllocationSamples(jvmtiEnv* env,
+                                                  AllocationSampleCallback callback,
+                                                  const void* user_data) {
+  ArtJvmTiEnv* art_env = ArtJvmTiEnv::AsArtJvmTiEnv(env);
+  if (art_env->capabilities.can_tag_objects != 1) {
+    return ERR(MUST_POSSESS_CAPABILITY);
+  }
+  if (callback == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+
+  struct Sample {
+    art::Handle<art::mirror::Class> klass;
+    jlong size;
+    std::vector<jvmtiFrameInfo> frames;
+  };
+  art::Thread* self = art::Thread::Current();
+  art::ScopedObjectAccess soa(self);
+  art::VariableSizedHandleScope hs(self);
+  std::vector<Sample> samples;
+  {
+    art::MutexLock mu(self, *art::Locks::alloc_tracker_lock_);
+    art::gc::AllocRecordSampleBuffer* buffer =
+        art::Runtime::Current()->GetHeap()->GetAllocationSamples();
+    if (buffer != nullptr) {
+      buffer->Drain([&](size_t byte_count,
+                        art::ObjPtr<art::mirror::Class> klass,
+                        const art::gc::AllocRecordStackTrace& trace)
+          REQUIRES_SHARED(art::Locks::mutator_lock_) {
+        std::vector<jvmtiFrameInfo> frames;
+        frames.reserve(trace.GetDepth());
+        for (size_t i = 0, depth = trace.GetDepth(); i != depth; ++i) {
+          const art::gc::AllocRecordStackTraceElement& element = trace.GetStackElement(i);
+          jmethodID method = art::jni::EncodeArtMethod(element.GetMethod());
+          frames.push_back(jvmtiFrameInfo{ method, static_cast<jlocation>(element.GetDexPc()) });
+        }
+        samples.push_back(
+            Sample{ hs.NewHandle(klass), static_cast<jlong>(byte_count), std::move(frames) });
+      });
+    }
+  }
+
+  // The samples are reported without holding the alloc tracker lock, which the allocations of
+  // the callback would need to record new samples.
+  for (const Sample& sample : samples) {
+    callback(art_env->object_tag_table->GetTagOrZero(sample.klass.Get()),
+             sample.size,
+             static_cast<jint>(sample.frames.size()),
+             sample.frames.data(),
+             const_cast<void*>(user_data));
+  }
+  return OK;
+}
+
 namespace {
 
 using ObjectPtr = art::ObjPtr<art::mirror::Object>;
@@ -91,6 +91,19 @@ class HeapExtensions {
 
   static jvmtiError JNICALL ChangeArraySize(jvmtiEnv* env, jobject arr, jsize new_size);
 
+  // Called by DrainAllocationSamples for every sampled allocation, oldest first. The frames are
+  // those of the allocating thread, innermost first.
+  using AllocationSampleCallback = void (*)(jlong class_tag,
+                                            jlong size,
+                                            jint frame_count,
+                                            const jvmtiFrameInfo* frames,
+                                            void* user_data);
+
+  static jvmtiError JNICALL SetAllocationSamplingInterval(jvmtiEnv* env, jlong interval);
+  static jvmtiError JNICALL DrainAllocationSamples(jvmtiEnv* env,
+                                                   AllocationSampleCallback callback,
+                                                   const void* user_data);
+
   static void ReplaceReferences(
       art::Thread* self,
       const std::unordered_map<art::ObjPtr<art::mirror::Object>,
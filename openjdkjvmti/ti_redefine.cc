@@ -52,18 +52,22 @@
 #include "art_method.h"
 #include "base/array_ref.h"
 #include "base/casts.h"
+#include "base/dumpable.h"
 #include "base/enums.h"
 #include "base/globals.h"
 #include "base/iteration_range.h"
 #include "base/length_prefixed_array.h"
 #include "base/locks.h"
 #include "base/stl_util.h"
+#include "base/timing_logger.h"
 #include "base/utils.h"
+#include "catch_handler_cache.h"
 #include "class_linker-inl.h"
 #include "class_linker.h"
 #include "class_root-inl.h"
 #include "class_status.h"
 #include "debugger.h"
+#include "dex/annotation_cache.h"
 #include "dex/art_dex_file_loader.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/class_accessor.h"
@@ -1711,24 +1715,11 @@ bool CompareClasses(art::ObjPtr<art::mirror::Class> l, art::ObjPtr<art::mirror::
   return parents(l.Ptr()) < parents(r.Ptr());
 }
 
-bool Redefiner::ClassRedefinition::CollectAndCreateNewInstances(
+bool Redefiner::ClassRedefinition::CreateNewInstances(
+    const std::vector<art::Handle<art::mirror::Object>>& old_instances,
     /*out*/ RedefinitionDataIter* cur_data) {
-  if (!cur_data->IsInitialStructural()) {
-    // An earlier structural redefinition already remade all the instances.
-    return true;
-  }
-  art::gc::Heap* heap = driver_->runtime_->GetHeap();
+  DCHECK(cur_data->IsInitialStructural());
   art::VariableSizedHandleScope hs(driver_->self_);
-  art::Handle<art::mirror::Class> old_klass(hs.NewHandle(cur_data->GetMirrorClass()));
-  std::vector<art::Handle<art::mirror::Object>> old_instances;
-  auto is_instance = [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    return obj->InstanceOf(old_klass.Get());
-  };
-  heap->VisitObjects([&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    if (is_instance(obj)) {
-      old_instances.push_back(hs.NewHandle(obj));
-    }
-  });
   VLOG(plugin) << "Collected " << old_instances.size() << " instances to recreate!";
   art::Handle<art::mirror::ObjectArray<art::mirror::Class>> old_classes_arr(
       hs.NewHandle(cur_data->GetOldClasses()));
@@ -2202,9 +2193,44 @@ bool Redefiner::EnsureAllClassAllocationsFinished(RedefinitionDataHolder& holder
 }
 
 bool Redefiner::CollectAndCreateNewInstances(RedefinitionDataHolder& holder) {
+  std::vector<RedefinitionDataIter> structural;
   for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
-    // Allocate the data this redefinition requires.
-    if (!data.GetRedefinition().CollectAndCreateNewInstances(&data)) {
+    // Later structural redefinitions of subtypes have their instances remade by the initial one.
+    if (data.IsInitialStructural()) {
+      structural.push_back(data);
+    }
+  }
+  if (structural.empty()) {
+    return true;
+  }
+  art::VariableSizedHandleScope hs(self_);
+  std::vector<art::Handle<art::mirror::Class>> old_klasses;
+  for (const RedefinitionDataIter& data : structural) {
+    old_klasses.push_back(hs.NewHandle(data.GetMirrorClass()));
+  }
+  // Walk the heap only once to collect the old instances of all the redefined classes.
+  std::vector<std::vector<art::Handle<art::mirror::Object>>> old_instances(structural.size());
+  runtime_->GetHeap()->VisitObjects(
+      [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+        for (size_t i = 0; i != old_klasses.size(); ++i) {
+          if (obj->InstanceOf(old_klasses[i].Get())) {
+            old_instances[i].push_back(hs.NewHandle(obj));
+          }
+        }
+      });
+  for (size_t i = 0; i != structural.size(); ++i) {
+    // The instances created for the earlier redefinitions were not there during the heap walk but
+    // may be instances of this class too, if their new class extends it.
+    for (size_t j = 0; j != i; ++j) {
+      art::ObjPtr<art::mirror::ObjectArray<art::mirror::Object>> new_instances(
+          structural[j].GetNewInstanceObjects());
+      for (art::ObjPtr<art::mirror::Object> obj : new_instances->Iterate()) {
+        if (obj->InstanceOf(old_klasses[i].Get())) {
+          old_instances[i].push_back(hs.NewHandle(obj));
+        }
+      }
+    }
+    if (!structural[i].GetRedefinition().CreateNewInstances(old_instances[i], &structural[i])) {
       return false;
     }
   }
@@ -2444,7 +2470,18 @@ class ScopedSuspendAllocations {
 };
 
 jvmtiError Redefiner::Run() {
+  // Time the phases of the whole batch so that agents redefining many classes at once can see
+  // where the time goes with -verbose:plugin.
+  art::TimingLogger timings("Class redefinition", /*precise=*/ true, /*verbose=*/ false);
+  jvmtiError res = RunPhases(&timings);
+  VLOG(plugin) << "Redefined " << redefinitions_.size() << " classes with result " << res << "\n"
+               << art::Dumpable<art::TimingLogger>(timings);
+  return res;
+}
+
+jvmtiError Redefiner::RunPhases(art::TimingLogger* timings) {
   art::StackHandleScope<1> hs(self_);
+  art::TimingLogger::ScopedTiming st("CheckRedefinitions", timings);
   // Sort the redefinitions_ array topologically by class. This makes later steps easier since we
   // know that every class precedes all of its supertypes.
   std::sort(redefinitions_.begin(),
@@ -2469,24 +2506,35 @@ jvmtiError Redefiner::Run() {
   }
   // Mark structural changes.
   MarkStructuralChanges(holder);
+  bool has_structural_changes = std::any_of(
+      holder.begin(), holder.end(), [](auto r) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+        return r.IsInitialStructural();
+      });
   // Now we pause class loading. If we are doing a structural redefinition we will need to get an
   // accurate picture of the classes loaded and having loads in the middle would make that
   // impossible. This only pauses class-loading if we actually have at least one structural
   // redefinition.
+  st.NewTiming("SuspendClassLoading");
   ScopedSuspendClassLoading suspend_class_load(self_, runtime_, holder);
+  st.NewTiming("Allocate");
   if (!EnsureAllClassAllocationsFinished(holder) ||
       !FinishAllRemainingCommonAllocations(holder) ||
-      !FinishAllNewClassAllocations(holder) ||
-      !CheckAllClassesAreVerified(holder)) {
+      !FinishAllNewClassAllocations(holder)) {
+    return result_;
+  }
+  st.NewTiming("Verify");
+  if (!CheckAllClassesAreVerified(holder)) {
     return result_;
   }
 
+  st.NewTiming("CreateNewInstances");
   ScopedSuspendAllocations suspend_alloc(runtime_, holder);
   if (!CollectAndCreateNewInstances(holder)) {
     return result_;
   }
 
   // At this point we can no longer fail without corrupting the runtime state.
+  st.NewTiming("RegisterDexCaches");
   for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
     art::ClassLinker* cl = runtime_->GetClassLinker();
     cl->RegisterExistingDexCache(data.GetNewDexCache(), data.GetSourceClassLoader());
@@ -2499,6 +2547,7 @@ jvmtiError Redefiner::Run() {
   {
     // Disable GC and wait for it to be done if we are a moving GC.  This is fine since we are done
     // allocating so no deadlocks.
+    st.NewTiming("SuspendAll");
     ScopedDisableConcurrentAndMovingGc sdcamgc(runtime_->GetHeap(), self_);
 
     // Do transition to final suspension
@@ -2506,6 +2555,7 @@ jvmtiError Redefiner::Run() {
     // TODO This isn't right. We need to change state without any chance of suspend ideally!
     art::ScopedThreadSuspension sts(self_, art::ThreadState::kNative);
     art::ScopedSuspendAll ssa("Final installation of redefined Classes!", /*long_suspend=*/true);
+    st.NewTiming("UpdateClasses");
     for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
       art::ScopedAssertNoThreadSuspension nts("Updating runtime objects for redefinition");
       ClassRedefinition& redef = data.GetRedefinition();
@@ -2514,6 +2564,10 @@ jvmtiError Redefiner::Run() {
       }
       redef.UpdateClass(data);
     }
+    if (has_structural_changes) {
+      st.NewTiming("InvalidateCaches");
+      InvalidateCachesForStructuralChanges();
+    }
     RestoreObsoleteMethodMapsIfUnneeded(holder);
     // TODO We should check for if any of the redefined methods are intrinsic methods here and, if
     // any are, force a full-world deoptimization before finishing redefinition. If we don't do this
@@ -2522,13 +2576,38 @@ jvmtiError Redefiner::Run() {
     // TODO Do the dex_file release at a more reasonable place. This works but it muddles who really
     // owns the DexFile and when ownership is transferred.
     ReleaseAllDexFiles();
+    st.NewTiming("ResumeAll");
   }
   // By now the class-linker knows about all the classes so we can safetly retry verification and
   // update method flags.
+  st.NewTiming("Reverify");
   ReverifyClasses(holder);
   return OK;
 }
 
+void Redefiner::InvalidateCachesForStructuralChanges() {
+  art::jit::Jit* jit = runtime_->GetJit();
+  if (jit != nullptr) {
+    // Clear jit.
+    // TODO We might want to have some way to tell the JIT not to wait the kJitSamplesBatchSize
+    // invokes to start compiling things again.
+    jit->GetCodeCache()->InvalidateAllCompiledCode();
+  }
+
+  // Clear thread caches
+  {
+    // TODO We might be able to avoid doing this but given the rather unstructured nature of the
+    // interpreter cache it's probably not worth the effort.
+    art::MutexLock mu(self_, *art::Locks::thread_list_lock_);
+    runtime_->GetThreadList()->ForEach(
+        [](art::Thread* t) { t->GetInterpreterCache()->Clear(t); });
+  }
+  // The catch handlers of the redefined methods and the annotations of the redefined classes
+  // may have changed.
+  art::CatchHandlerCache::InvalidateAll();
+  runtime_->GetAnnotationCache()->Clear();
+}
+
 void Redefiner::ReverifyClasses(RedefinitionDataHolder& holder) {
   for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
     data.GetRedefinition().ReverifyClass(data);
@@ -2951,22 +3030,8 @@ void Redefiner::ClassRedefinition::UpdateClassStructurally(const RedefinitionDat
     new_class->GetExtData()->SetObsoleteClass(old_class);
   }
 
-  art::jit::Jit* jit = driver_->runtime_->GetJit();
-  if (jit != nullptr) {
-    // Clear jit.
-    // TODO We might want to have some way to tell the JIT not to wait the kJitSamplesBatchSize
-    // invokes to start compiling things again.
-    jit->GetCodeCache()->InvalidateAllCompiledCode();
-  }
-
-  // Clear thread caches
-  {
-    // TODO We might be able to avoid doing this but given the rather unstructured nature of the
-    // interpreter cache it's probably not worth the effort.
-    art::MutexLock mu(driver_->self_, *art::Locks::thread_list_lock_);
-    driver_->runtime_->GetThreadList()->ForEach(
-        [](art::Thread* t) { t->GetInterpreterCache()->Clear(t); });
-  }
+  // The JIT code and the runtime caches are dropped by the driver once for the whole batch, see
+  // InvalidateCachesForStructuralChanges.
 
   if (art::kIsDebugBuild) {
     // Just make sure we didn't screw up any of the now obsolete methods or fields. We need their
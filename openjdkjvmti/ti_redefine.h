@@ -34,6 +34,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 
 #include <jni.h>
 
@@ -44,6 +45,7 @@
 #include "dex/class_accessor.h"
 #include "dex/dex_file.h"
 #include "dex/dex_file_structs.h"
+#include "handle.h"
 #include "jni/jni_env_ext-inl.h"
 #include "jvmti.h"
 #include "mirror/array.h"
@@ -53,6 +55,7 @@
 
 namespace art {
 class ClassAccessor;
+class TimingLogger;
 namespace dex {
 struct ClassDef;
 }  // namespace dex
@@ -175,7 +178,9 @@ class Redefiner {
     bool FinishNewClassAllocations(RedefinitionDataHolder& holder,
                                    /*out*/RedefinitionDataIter* cur_data)
         REQUIRES_SHARED(art::Locks::mutator_lock_);
-    bool CollectAndCreateNewInstances(/*out*/RedefinitionDataIter* cur_data)
+    // Creates the new instances for the old instances of an initial structural redefinition.
+    bool CreateNewInstances(const std::vector<art::Handle<art::mirror::Object>>& old_instances,
+                            /*out*/RedefinitionDataIter* cur_data)
         REQUIRES_SHARED(art::Locks::mutator_lock_);
 
     bool AllocateAndRememberNewDexFileCookie(
@@ -338,6 +343,7 @@ class Redefiner {
       REQUIRES_SHARED(art::Locks::mutator_lock_);
 
   jvmtiError Run() REQUIRES_SHARED(art::Locks::mutator_lock_);
+  jvmtiError RunPhases(art::TimingLogger* timings) REQUIRES_SHARED(art::Locks::mutator_lock_);
 
   bool CheckAllRedefinitionAreValid() REQUIRES_SHARED(art::Locks::mutator_lock_);
   bool CheckAllClassesAreVerified(RedefinitionDataHolder& holder)
@@ -354,6 +360,9 @@ class Redefiner {
       REQUIRES_SHARED(art::Locks::mutator_lock_);
   void ReleaseAllDexFiles() REQUIRES_SHARED(art::Locks::mutator_lock_);
   void ReverifyClasses(RedefinitionDataHolder& holder) REQUIRES_SHARED(art::Locks::mutator_lock_);
+  // Drops the JIT code and the runtime caches that may refer to the replaced classes once for all
+  // structural redefinitions of the batch.
+  void InvalidateCachesForStructuralChanges() REQUIRES(art::Locks::mutator_lock_);
   void UnregisterAllBreakpoints() REQUIRES_SHARED(art::Locks::mutator_lock_);
   // Restores the old obsolete methods maps if it turns out they weren't needed (ie there were no
   // new obsolete methods).
@@ -365,7 +365,11 @@ static void RunCheckpointAndWait(Data* data, size_t max_frame_count)
     REQUIRES_SHARED(art::Locks::mutator_lock_) {
   // Note: requires the mutator lock as the checkpoint requires the mutator lock.
   GetAllStackTracesVectorClosure<Data> closure(max_frame_count, data);
-  size_t barrier_count = art::Runtime::Current()->GetThreadList()->RunCheckpoint(&closure, nullptr);
+  // The closure only appends to `data` under its lock, so the stack walks of suspended threads
+  // can use the runtime thread pool while it is still around.
+  art::Runtime::ScopedThreadPoolUsage stpu;
+  size_t barrier_count = art::Runtime::Current()->GetThreadList()->RunCheckpoint(
+      &closure, nullptr, stpu.GetThreadPool());
   if (barrier_count == 0) {
     return;
   }
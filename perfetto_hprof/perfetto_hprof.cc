@@ -32,6 +32,7 @@
 #include <time.h>
 
 #include <type_traits>
+#include <unordered_map>
 
 #include "gc/heap-visit-objects-inl.h"
 #include "gc/heap.h"
@@ -342,7 +343,7 @@ class Writer {
 class ReferredObjectsFinder {
  public:
   explicit ReferredObjectsFinder(
-      std::vector<std::pair<std::string, art::mirror::Object*>>* referred_objects)
+      std::vector<std::pair<art::ArtField*, art::mirror::Object*>>* referred_objects)
       : referred_objects_(referred_objects) {}
 
   // For art::mirror::Object::VisitReferences.
@@ -356,11 +357,7 @@ class ReferredObjectsFinder {
     } else {
       field = art::ArtField::FindInstanceFieldWithOffset(obj->GetClass(), offset.Uint32Value());
     }
-    std::string field_name = "";
-    if (field != nullptr) {
-      field_name = field->PrettyField(/*with_type=*/true);
-    }
-    referred_objects_->emplace_back(std::move(field_name), ref);
+    referred_objects_->emplace_back(field, ref);
   }
 
   void VisitRootIfNonNull(art::mirror::CompressedReference<art::mirror::Object>* root
@@ -370,8 +367,34 @@ class ReferredObjectsFinder {
 
  private:
   // We can use a raw Object* pointer here, because there are no concurrent GC threads after the
-  // fork.
-  std::vector<std::pair<std::string, art::mirror::Object*>>* referred_objects_;
+  // fork. The field is null if it could not be found.
+  std::vector<std::pair<art::ArtField*, art::mirror::Object*>>* referred_objects_;
+};
+
+// Maps fields to the intern IDs of their names. The name of each field is only computed
+// the first time the field is seen, rather than for every reference through it.
+class FieldNameInterner {
+ public:
+  explicit FieldNameInterner(std::map<std::string, uint64_t>* interned_field_names)
+      : interned_field_names_(interned_field_names) {}
+
+  uint64_t GetId(art::ArtField* field) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    if (field == nullptr) {
+      return FindOrAppend(interned_field_names_, std::string(""));
+    }
+    auto it = field_ids_.find(field);
+    if (it == field_ids_.end()) {
+      uint64_t id = FindOrAppend(interned_field_names_, field->PrettyField(/*with_type=*/true));
+      it = field_ids_.emplace(field, id).first;
+    }
+    return it->second;
+  }
+
+ private:
+  std::map<std::string, uint64_t>* const interned_field_names_;
+  // Different fields can have the same name (e.g. in classes with the same name loaded by
+  // different class loaders), so this maps to the IDs of the names.
+  std::unordered_map<art::ArtField*, uint64_t> field_ids_;
 };
 
 class RootFinder : public art::SingleRootVisitor {
@@ -536,6 +559,7 @@ void DumpPerfetto(art::Thread* self) {
             std::map<std::string, uint64_t> interned_fields{{"", 0}};
             std::map<std::string, uint64_t> interned_locations{{"", 0}};
             std::map<uintptr_t, uint64_t> interned_classes{{0, 0}};
+            FieldNameInterner field_name_interner(&interned_fields);
 
             std::map<art::RootType, std::vector<art::mirror::Object*>> root_objects;
             RootFinder rcf(&root_objects);
@@ -565,9 +589,11 @@ void DumpPerfetto(art::Thread* self) {
                 new protozero::PackedVarInt);
             std::unique_ptr<protozero::PackedVarInt> reference_object_ids(
                 new protozero::PackedVarInt);
+            // Reused for all the objects to avoid allocating a new vector for each of them.
+            std::vector<std::pair<art::ArtField*, art::mirror::Object*>> referred_objects;
 
             art::Runtime::Current()->GetHeap()->VisitObjectsPaused(
-                [&writer, &interned_fields, &interned_locations,
+                [&writer, &field_name_interner, &interned_locations, &referred_objects,
                 &reference_field_ids, &reference_object_ids, &interned_classes](
                     art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
                   if (obj->IsClass()) {
@@ -608,12 +634,11 @@ void DumpPerfetto(art::Thread* self) {
                   object_proto->set_type_id(class_id);
                   object_proto->set_self_size(obj->SizeOf());
 
-                  std::vector<std::pair<std::string, art::mirror::Object*>>
-                      referred_objects;
+                  referred_objects.clear();
                   ReferredObjectsFinder objf(&referred_objects);
                   obj->VisitReferences(objf, art::VoidFunctor());
                   for (const auto& p : referred_objects) {
-                    reference_field_ids->Append(FindOrAppend(&interned_fields, p.first));
+                    reference_field_ids->Append(field_name_interner.GetId(p.first));
                     reference_object_ids->Append(GetObjectId(p.second));
                   }
                   object_proto->set_reference_field_id(*reference_field_ids);
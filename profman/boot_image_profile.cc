@@ -16,8 +16,10 @@
 
 #include "boot_image_profile.h"
 
+#include <algorithm>
 #include <memory>
 #include <set>
+#include <thread>
 
 #include "android-base/file.h"
 #include "base/unix_file/fd_file.h"
@@ -195,6 +197,29 @@ static bool IncludeInPreloadedClasses(const std::string& class_name,
       max_aggregation_count, options.preloaded_class_threshold, metadata, options);
 }
 
+// Loads the profiles in the range [begin, end) of `profile_files` and merges their data,
+// in order, into `result`. Each profile is released as soon as it has been merged.
+static bool LoadAndMergeProfiles(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+                                 const std::vector<std::string>& profile_files,
+                                 size_t begin,
+                                 size_t end,
+                                 FlattenProfileData* result) {
+  for (size_t i = begin; i != end; ++i) {
+    const std::string& profile_file = profile_files[i];
+    std::unique_ptr<FlattenProfileData> current_data;
+    {
+      ProfileCompilationInfo profile;
+      if (!profile.Load(profile_file, /*clear_if_invalid=*/ false)) {
+        LOG(ERROR) << "Profile is not a valid: " << profile_file;
+        return false;
+      }
+      current_data = profile.ExtractProfileData(dex_files);
+    }
+    result->MergeData(*current_data);
+  }
+  return true;
+}
+
 bool GenerateBootImageProfile(
     const std::vector<std::unique_ptr<const DexFile>>& dex_files,
     const std::vector<std::string>& profile_files,
@@ -209,14 +234,41 @@ bool GenerateBootImageProfile(
   bool generate_preloaded_classes = !preloaded_classes_out_path.empty();
 
   std::unique_ptr<FlattenProfileData> flattend_data(new FlattenProfileData());
-  for (const std::string& profile_file : profile_files) {
-    ProfileCompilationInfo profile;
-    if (!profile.Load(profile_file, /*clear_if_invalid=*/ false)) {
-      LOG(ERROR) << "Profile is not a valid: " << profile_file;
+  size_t num_threads =
+      std::min<size_t>(std::max(options.num_merge_threads, 1u), profile_files.size());
+  if (num_threads <= 1u) {
+    if (!LoadAndMergeProfiles(
+            dex_files, profile_files, 0u, profile_files.size(), flattend_data.get())) {
       return false;
     }
-    std::unique_ptr<FlattenProfileData> currentData = profile.ExtractProfileData(dex_files);
-    flattend_data->MergeData(*currentData);
+  } else {
+    // Give each thread a contiguous range of the inputs and combine the partial results
+    // in input order. This keeps the order of the annotations (and therefore the output)
+    // the same as with the sequential merge.
+    size_t chunk_size = (profile_files.size() + num_threads - 1u) / num_threads;
+    std::vector<std::unique_ptr<FlattenProfileData>> partial_data(num_threads);
+    std::unique_ptr<bool[]> success(new bool[num_threads]());
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t t = 0; t != num_threads; ++t) {
+      size_t begin = std::min(t * chunk_size, profile_files.size());
+      size_t end = std::min(begin + chunk_size, profile_files.size());
+      partial_data[t].reset(new FlattenProfileData());
+      threads.emplace_back([&, t, begin, end]() {
+        success[t] =
+            LoadAndMergeProfiles(dex_files, profile_files, begin, end, partial_data[t].get());
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    for (size_t t = 0; t != num_threads; ++t) {
+      if (!success[t]) {
+        return false;
+      }
+      flattend_data->MergeData(*partial_data[t]);
+      partial_data[t].reset();
+    }
   }
 
   // We want the output sorted by the method/class name.
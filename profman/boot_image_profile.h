@@ -67,6 +67,11 @@ struct BootImageOptions {
 
   // The set of classes that should not be preloaded in Zygote
   std::set<std::string> preloaded_classes_blacklist;
+
+  // The number of threads used to load and merge the input profiles. Each thread merges
+  // a contiguous range of the inputs and the partial results are combined in input order,
+  // so the output does not depend on the number of threads.
+  uint32_t num_merge_threads = 1;
 };
 
 // Generate a boot image profile according to the specified options.
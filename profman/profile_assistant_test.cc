@@ -958,6 +958,62 @@ TEST_F(ProfileAssistantTest, TestBootImageProfileWith2RawProfiles) {
   ASSERT_EQ(output_profile_contents, expected_profile_content);
 }
 
+TEST_F(ProfileAssistantTest, TestBootImageProfileWithMergeThreads) {
+  const std::string core_dex = GetLibCoreDexFileNames()[0];
+
+  const std::string kClass1 = "Ljava/lang/CharSequence;";
+  const std::string kClass2 = "Ljava/lang/Object;";
+  const std::string kMethod1 = "Ljava/lang/Comparable;->compareTo(Ljava/lang/Object;)I";
+  const std::string kMethod2 = "Ljava/lang/Object;->hashCode()I";
+
+  // Three profiles, so that the threads get ranges of different sizes.
+  std::vector<std::vector<std::string>> input_data = {
+      { kClass1, "H" + kMethod1 },
+      { kClass1, kClass2, "H" + kMethod2 },
+      { kClass2, "H" + kMethod1, "H" + kMethod2 },
+  };
+  std::vector<ScratchFile> profiles(input_data.size());
+  for (size_t i = 0; i != input_data.size(); ++i) {
+    ASSERT_TRUE(
+        CreateProfile(JoinProfileLines(input_data[i]), profiles[i].GetFilename(), core_dex));
+  }
+
+  // Everything used by at least one profile makes it into the output.
+  std::vector<std::string> expected_data = {
+      kClass1,
+      kClass2,
+      "H" + kMethod1,
+      "H" + kMethod2
+  };
+  std::string expected_profile_content = JoinProfileLines(expected_data);
+
+  // The output must not depend on the number of merge threads.
+  for (const char* num_threads : { "1", "3", "8" }) {
+    ScratchFile out_profile;
+    std::vector<std::string> args;
+    args.push_back(GetProfmanCmd());
+    args.push_back("--generate-boot-image-profile");
+    args.push_back("--class-threshold=0");
+    args.push_back("--clean-class-threshold=0");
+    args.push_back("--method-threshold=0");
+    args.push_back(std::string("--boot-image-merge-threads=") + num_threads);
+    for (ScratchFile& profile : profiles) {
+      args.push_back("--profile-file=" + profile.GetFilename());
+    }
+    args.push_back("--out-profile-path=" + out_profile.GetFilename());
+    args.push_back("--apk=" + core_dex);
+    args.push_back("--dex-location=" + core_dex);
+
+    std::string error;
+    ASSERT_EQ(ExecAndReturnCode(args, &error), 0) << error;
+
+    std::string output_profile_contents;
+    ASSERT_TRUE(android::base::ReadFileToString(
+        out_profile.GetFilename(), &output_profile_contents));
+    ASSERT_EQ(output_profile_contents, expected_profile_content) << num_threads;
+  }
+}
+
 TEST_F(ProfileAssistantTest, TestProfileCreationOneNotMatched) {
   // Class names put here need to be in sorted order.
   std::vector<std::string> class_names = {
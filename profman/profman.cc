@@ -169,6 +169,8 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("      what threshold to apply to the methods/classes that are used by the given");
   UsageError("      package when deciding whether or not to include it in the final profile.");
   UsageError("  --debug-append-uses=bool: whether or not to append package use as debug info.");
+  UsageError("  --boot-image-merge-threads=number: how many threads to use for loading and");
+  UsageError("      merging the input profiles (default: 1).");
   UsageError("  --out-profile-path=path: boot image profile output path");
   UsageError("  --out-preloaded-classes-path=path: preloaded classes output path");
   UsageError("  --copy-and-update-profile-key: if present, profman will copy the profile from");
@@ -371,6 +373,11 @@ class ProfMan final {
         ParseBoolOption(raw_option,
                         "--debug-append-uses=",
                         &boot_image_options_.append_package_use_list);
+      } else if (StartsWith(option, "--boot-image-merge-threads=")) {
+        ParseUintOption(raw_option,
+                        "--boot-image-merge-threads=",
+                        &boot_image_options_.num_merge_threads,
+                        1u);
       } else if (StartsWith(option, "--out-profile-path=")) {
         boot_profile_out_path_ = std::string(option.substr(strlen("--out-profile-path=")));
       } else if (StartsWith(option, "--out-preloaded-classes-path=")) {
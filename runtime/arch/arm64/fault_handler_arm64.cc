@@ -96,20 +96,21 @@ bool NullPointerHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info, void*
 }
 
 // A suspend check is done using the following instruction sequence:
-//      0xf7223228: f9405640  ldr x0, [x18, #168]
+//      0xf7223228: f9405670  ldr x16, [x19, #168]
 // .. some intervening instructions
-//      0xf7223230: f9400000  ldr x0, [x0]
+//      0xf7223230: f9400210  ldr x16, [x16]
 
-// The offset from r18 is Thread::ThreadSuspendTriggerOffset().
+// The offset from x19 (the thread register) is Thread::ThreadSuspendTriggerOffset().
+// The code generator may use any register for the loaded trigger.
 // To check for a suspend check, we examine the instructions that caused
 // the fault (at PC-4 and PC).
 bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBUTE_UNUSED,
                                void* context) {
-  // These are the instructions to check for.  The first one is the ldr x0,[r18,#xxx]
-  // where xxx is the offset of the suspend trigger.
-  uint32_t checkinst1 = 0xf9400240 |
+  // These are the instructions to check for.  The first one is the ldr xN,[x19,#xxx]
+  // where xxx is the offset of the suspend trigger, the second one is ldr xN,[xN].
+  constexpr uint32_t kLdrImm = 0xf9400000;
+  uint32_t checkinst1 = kLdrImm | (19u << 5) |
       (Thread::ThreadSuspendTriggerOffset<PointerSize::k64>().Int32Value() << 7);
-  uint32_t checkinst2 = 0xf9400000;
 
   struct ucontext *uc = reinterpret_cast<struct ucontext *>(context);
   struct sigcontext *sc = reinterpret_cast<struct sigcontext*>(&uc->uc_mcontext);
@@ -118,6 +119,9 @@ bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBU
   VLOG(signals) << "checking suspend";
 
   uint32_t inst2 = *reinterpret_cast<uint32_t*>(ptr2);
+  uint32_t reg = inst2 & 0x1fu;
+  uint32_t checkinst2 = kLdrImm | (reg << 5) | reg;
+  checkinst1 |= reg;
   VLOG(signals) << "inst2: " << std::hex << inst2 << " checkinst2: " << checkinst2;
   if (inst2 != checkinst2) {
     // Second instruction is not good, not ours.
@@ -142,7 +146,7 @@ bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBU
     // This is a suspend check.  Arrange for the signal handler to return to
     // art_quick_implicit_suspend.  Also set LR so that after the suspend check it
     // will resume the instruction (current PC + 4).  PC points to the
-    // ldr x0,[x0,#0] instruction (r0 will be 0, set by the trigger).
+    // ldr xN,[xN,#0] instruction (xN will be 0, set by the trigger).
 
     sc->regs[30] = sc->pc + 4;
     sc->pc = reinterpret_cast<uintptr_t>(art_quick_implicit_suspend);
@@ -127,6 +127,21 @@ Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromVariant(
   // Currently there are no cpu variants which support SVE.
   bool has_sve = false;
 
+  // Big cores that do not share the variant with a little in-order core.
+  static const char* arm64_out_of_order_variants[] = {
+      "cortex-a57",
+      "cortex-a72",
+      "cortex-a73",
+      "cortex-a75",
+      "cortex-a76",
+      "exynos-m1",
+      "exynos-m2",
+      "exynos-m3",
+  };
+  bool is_out_of_order_core = FindVariantInArray(arm64_out_of_order_variants,
+                                                 arraysize(arm64_out_of_order_variants),
+                                                 variant);
+
   if (!needs_a53_835769_fix) {
     // Check to see if this is an expected variant.
     static const char* arm64_known_variants[] = {
@@ -155,7 +170,8 @@ Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromVariant(
                                                                 has_lse,
                                                                 has_fp16,
                                                                 has_dotprod,
-                                                                has_sve));
+                                                                has_sve,
+                                                                is_out_of_order_core));
 }
 
 Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromBitmap(uint32_t bitmap) {
@@ -419,7 +435,8 @@ Arm64InstructionSetFeatures::AddFeaturesFromSplitString(
                                       has_lse,
                                       has_fp16,
                                       has_dotprod,
-                                      has_sve));
+                                      has_sve,
+                                      is_out_of_order_core_));
 }
 
 std::unique_ptr<const InstructionSetFeatures>
@@ -433,7 +450,8 @@ Arm64InstructionSetFeatures::AddRuntimeDetectedFeatures(
                                       arm64_features->has_lse_,
                                       arm64_features->has_fp16_,
                                       arm64_features->has_dotprod_,
-                                      arm64_features->has_sve_));
+                                      arm64_features->has_sve_,
+                                      is_out_of_order_core_));
 }
 
 }  // namespace art
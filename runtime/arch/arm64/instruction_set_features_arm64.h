@@ -97,6 +97,12 @@ class Arm64InstructionSetFeatures final : public InstructionSetFeatures {
     return has_sve_;
   }
 
+  // Is the CPU variant a big out-of-order core? This only tunes instruction scheduling, so it
+  // is not part of the bitmap or feature string and does not affect code compatibility.
+  bool IsOutOfOrderCore() const {
+    return is_out_of_order_core_;
+  }
+
   virtual ~Arm64InstructionSetFeatures() {}
 
  protected:
@@ -115,7 +121,8 @@ class Arm64InstructionSetFeatures final : public InstructionSetFeatures {
                               bool has_lse,
                               bool has_fp16,
                               bool has_dotprod,
-                              bool has_sve)
+                              bool has_sve,
+                              bool is_out_of_order_core = false)
       : InstructionSetFeatures(),
         fix_cortex_a53_835769_(needs_a53_835769_fix),
         fix_cortex_a53_843419_(needs_a53_843419_fix),
@@ -123,7 +130,8 @@ class Arm64InstructionSetFeatures final : public InstructionSetFeatures {
         has_lse_(has_lse),
         has_fp16_(has_fp16),
         has_dotprod_(has_dotprod),
-        has_sve_(has_sve) {
+        has_sve_(has_sve),
+        is_out_of_order_core_(is_out_of_order_core) {
   }
 
   // Bitmap positions for encoding features as a bitmap.
@@ -143,6 +151,7 @@ class Arm64InstructionSetFeatures final : public InstructionSetFeatures {
   const bool has_fp16_;     // ARMv8.2 FP16 extensions.
   const bool has_dotprod_;  // optional in ARMv8.2, mandatory in ARMv8.4.
   const bool has_sve_;      // optional in ARMv8.2.
+  const bool is_out_of_order_core_;
 
   DISALLOW_COPY_AND_ASSIGN(Arm64InstructionSetFeatures);
 };
@@ -123,6 +123,10 @@ TEST(Arm64InstructionSetFeaturesTest, Arm64Features) {
   EXPECT_TRUE(cortex_a76_features->AsArm64InstructionSetFeatures()->HasFP16());
   EXPECT_TRUE(cortex_a76_features->AsArm64InstructionSetFeatures()->HasDotProd());
   EXPECT_FALSE(cortex_a76_features->AsArm64InstructionSetFeatures()->HasSVE());
+  // Only used for tuning, does not take part in the feature string.
+  EXPECT_TRUE(cortex_a76_features->AsArm64InstructionSetFeatures()->IsOutOfOrderCore());
+  EXPECT_FALSE(cortex_a35_features->AsArm64InstructionSetFeatures()->IsOutOfOrderCore());
+  EXPECT_FALSE(arm64_features->AsArm64InstructionSetFeatures()->IsOutOfOrderCore());
   EXPECT_STREQ("-a53,crc,lse,fp16,dotprod,-sve", cortex_a76_features->GetFeatureString().c_str());
   EXPECT_EQ(cortex_a76_features->AsBitmap(), 30U);
 }
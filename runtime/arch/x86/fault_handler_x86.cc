@@ -364,36 +364,84 @@ bool NullPointerHandler::Action(int, siginfo_t* sig, void* context) {
 // 0xf720f1e6:                   8500      test    eax, [eax]
 // (x86_64)
 // 0x7f579de45d9e: 65488B0425A8000000      movq    rax, gs:[0xa8]  ; suspend_trigger
-// .. some intervening instructions.
-// 0x7f579de45da7:               8500      test    eax, [eax]
-
-// The offset from fs is Thread::ThreadSuspendTriggerOffset().
+// 0x7f579de45da7:               8500      test    eax, [rax]
+//
+// The offset from fs (gs) is Thread::ThreadSuspendTriggerOffset().
+// On x86_64, the code generator may use any register for the trigger, and emits
+// the two instructions next to each other.
 // To check for a suspend check, we examine the instructions that caused
 // the fault.
 bool SuspensionHandler::Action(int, siginfo_t*, void* context) {
-  // These are the instructions to check for.  The first one is the mov eax, fs:[xxx]
-  // where xxx is the offset of the suspend trigger.
   uint32_t trigger = Thread::ThreadSuspendTriggerOffset<kRuntimePointerSize>().Int32Value();
 
   VLOG(signals) << "Checking for suspension point";
+  struct ucontext *uc = reinterpret_cast<struct ucontext*>(context);
+  uint8_t* pc = reinterpret_cast<uint8_t*>(uc->CTX_EIP);
+  uint8_t* sp = reinterpret_cast<uint8_t*>(uc->CTX_ESP);
+
 #if defined(__x86_64__)
-  uint8_t checkinst1[] = {0x65, 0x48, 0x8b, 0x04, 0x25, static_cast<uint8_t>(trigger & 0xff),
-      static_cast<uint8_t>((trigger >> 8) & 0xff), 0, 0};
+  // The faulting instruction is "test r32, [r64]" with an optional REX prefix, where both
+  // operands are the same register.
+  const uint8_t* test = pc;
+  uint8_t rex = 0u;
+  if ((test[0] & 0xf0) == 0x40) {
+    rex = test[0];
+    ++test;
+  }
+  if (test[0] != 0x85) {
+    VLOG(signals) << "Not a suspension point";
+    return false;
+  }
+  uint8_t modrm = test[1];
+  uint8_t mod = modrm >> 6;
+  uint8_t rm = modrm & 7u;
+  uint32_t reg = ((modrm >> 3) & 7u) | ((rex & 0x4u) << 1);
+  uint32_t base = rm | ((rex & 0x1u) << 3);
+  size_t test_size = (test - pc) + 2u;
+  if (mod == 0u && rm == 4u) {
+    // Base r12 needs a SIB byte.
+    if (test[2] != 0x24) {
+      return false;
+    }
+    ++test_size;
+  } else if (mod == 1u && rm == 5u) {
+    // Base rbp or r13 needs a zero 8-bit displacement.
+    if (test[2] != 0u) {
+      return false;
+    }
+    ++test_size;
+  } else if (mod != 0u || rm == 5u) {
+    return false;
+  }
+  if (reg != base) {
+    VLOG(signals) << "Not a suspension point";
+    return false;
+  }
+
+  // The preceding instruction must be "mov r64, gs:[trigger]" into the same register.
+  uint8_t checkinst1[] = {0x65,
+                          static_cast<uint8_t>(0x48 | ((reg & 8u) >> 1)),
+                          0x8b,
+                          static_cast<uint8_t>(0x04 | ((reg & 7u) << 3)),
+                          0x25,
+                          static_cast<uint8_t>(trigger & 0xff),
+                          static_cast<uint8_t>((trigger >> 8) & 0xff),
+                          0,
+                          0};
+  bool found = memcmp(pc - sizeof(checkinst1), checkinst1, sizeof(checkinst1)) == 0;
 #else
+  // These are the instructions to check for.  The first one is the mov eax, fs:[xxx]
+  // where xxx is the offset of the suspend trigger.
   uint8_t checkinst1[] = {0x64, 0x8b, 0x05, static_cast<uint8_t>(trigger & 0xff),
       static_cast<uint8_t>((trigger >> 8) & 0xff), 0, 0};
-#endif
   uint8_t checkinst2[] = {0x85, 0x00};
 
-  struct ucontext *uc = reinterpret_cast<struct ucontext*>(context);
-  uint8_t* pc = reinterpret_cast<uint8_t*>(uc->CTX_EIP);
-  uint8_t* sp = reinterpret_cast<uint8_t*>(uc->CTX_ESP);
-
   if (pc[0] != checkinst2[0] || pc[1] != checkinst2[1]) {
     // Second instruction is not correct (test eax,[eax]).
     VLOG(signals) << "Not a suspension point";
     return false;
   }
+  size_t test_size = sizeof(checkinst2);
 
   // The first instruction can a little bit up the stream due to load hoisting
   // in the compiler.
@@ -407,17 +455,18 @@ bool SuspensionHandler::Action(int, siginfo_t*, void* context) {
     }
     ptr -= 1;
   }
+#endif
 
   if (found) {
     VLOG(signals) << "suspend check match";
 
-    // We need to arrange for the signal handler to return to the null pointer
-    // exception generator.  The return address must be the address of the
-    // next instruction (this instruction + 2).  The return address
-    // is on the stack at the top address of the current frame.
+    // We need to arrange for the signal handler to return to the suspend check
+    // entrypoint.  The return address must be the address of the next instruction
+    // (this instruction + test_size).  The return address is on the stack at the
+    // top address of the current frame.
 
     // Push the return address onto the stack.
-    uintptr_t retaddr = reinterpret_cast<uintptr_t>(pc + 2);
+    uintptr_t retaddr = reinterpret_cast<uintptr_t>(pc + test_size);
     uintptr_t* next_sp = reinterpret_cast<uintptr_t*>(sp - sizeof(uintptr_t));
     *next_sp = retaddr;
     uc->CTX_ESP = reinterpret_cast<uintptr_t>(next_sp);
@@ -74,6 +74,8 @@ enum LockLevel : uint8_t {
   kRosAllocBulkFreeLock,
   kAllocSpaceLock,
   kTaggingLockLevel,
+  kAnnotationCacheLock,
+  kInternTableShardLock,
   kTransactionLogLock,
   kCustomTlsLock,
   kJniFunctionTableLock,
@@ -25,6 +25,7 @@
 
 #include <android-base/logging.h>
 
+#include "base/allocator.h"
 #include "base/arena_allocator-inl.h"
 #include "base/mem_map.h"
 #include "base/systrace.h"
@@ -50,6 +51,7 @@ MemMapArena::MemMapArena(size_t size, bool low_4gb, const char* name)
                 "Arena should not need stronger alignment than kPageSize.");
   DCHECK_ALIGNED(memory_, ArenaAllocator::kArenaAlignment);
   size_ = map_.Size();
+  TrackedAllocators::RegisterAllocation(kAllocatorTagArenaPool, size_);
 }
 
 MemMap MemMapArena::Allocate(size_t size, bool low_4gb, const char* name) {
@@ -67,6 +69,7 @@ MemMap MemMapArena::Allocate(size_t size, bool low_4gb, const char* name) {
 }
 
 MemMapArena::~MemMapArena() {
+  TrackedAllocators::RegisterFree(kAllocatorTagArenaPool, size_);
   // Destroys MemMap via std::unique_ptr<>.
 }
 
@@ -89,6 +92,7 @@ MemMapArenaPool::~MemMapArenaPool() {
 }
 
 void MemMapArenaPool::ReclaimMemory() {
+  ReclaimThreadCaches();
   while (free_arenas_ != nullptr) {
     Arena* arena = free_arenas_;
     free_arenas_ = free_arenas_->next_;
@@ -102,8 +106,8 @@ void MemMapArenaPool::LockReclaimMemory() {
 }
 
 Arena* MemMapArenaPool::AllocArena(size_t size) {
-  Arena* ret = nullptr;
-  {
+  Arena* ret = AllocArenaFromThreadCache(size);
+  if (ret == nullptr) {
     std::lock_guard<std::mutex> lock(lock_);
     if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
       ret = free_arenas_;
@@ -126,7 +130,7 @@ void MemMapArenaPool::TrimMaps() {
 }
 
 size_t MemMapArenaPool::GetBytesAllocated() const {
-  size_t total = 0;
+  size_t total = GetThreadCachesBytesAllocated();
   std::lock_guard<std::mutex> lock(lock_);
   for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
     total += arena->GetBytesAllocated();
@@ -151,6 +155,7 @@ void MemMapArenaPool::FreeArenaChain(Arena* first) {
     return;
   }
 
+  first = FreeArenaChainToThreadCache(first);
   if (first != nullptr) {
     Arena* last = first;
     while (last->next_ != nullptr) {
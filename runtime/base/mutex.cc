@@ -16,15 +16,20 @@
 
 #include "mutex.h"
 
+#include <dlfcn.h>
 #include <errno.h>
 #include <sys/time.h>
 
+#include <algorithm>
+#include <mutex>
 #include <sstream>
 
 #include "android-base/stringprintf.h"
 
 #include "base/atomic.h"
+#include "base/bit_utils.h"
 #include "base/logging.h"
+#include "base/strlcpy.h"
 #include "base/systrace.h"
 #include "base/time_utils.h"
 #include "base/value_object.h"
@@ -45,6 +50,91 @@ struct AllMutexData {
 };
 static struct AllMutexData gAllMutexData[kAllMutexDataSize];
 
+// Sampled contention profiling, see BaseMutex::SetContentionSamplingPeriod().
+static Atomic<uint32_t> gContentionSamplingPeriod(0u);
+
+struct ContentionLevelStats {
+  // Bucket i counts waits shorter than 2^i microseconds, the last bucket all longer waits.
+  static constexpr size_t kNumBuckets = 20u;
+  Atomic<uint64_t> count;
+  Atomic<uint64_t> wait_time;
+  Atomic<uint64_t> buckets[kNumBuckets];
+};
+static ContentionLevelStats gContentionLevelStats[kLockLevelCount];
+
+// A sampled contention. The name is copied as the mutex may be deleted before the log is dumped.
+struct ContentionSample {
+  char name[32];
+  LockLevel level;
+  uint64_t blocked_tid;
+  uint64_t owner_tid;
+  uint64_t wait_time;
+  uintptr_t blocked_pc;
+  uintptr_t owner_unlock_pc;
+};
+static constexpr size_t kContentionSampleLogSize = 32u;
+// A std::mutex as this is used while waiting for any BaseMutex, including the lowest level ones.
+static std::mutex gContentionSampleLogLock;
+static ContentionSample gContentionSampleLog[kContentionSampleLogSize];
+static size_t gContentionSampleCount = 0u;
+
+static bool ShouldSampleContention() {
+  uint32_t period = gContentionSamplingPeriod.load(std::memory_order_relaxed);
+  if (LIKELY(period == 0u)) {
+    return false;
+  }
+  thread_local uint32_t contention_count = 0u;
+  return (++contention_count % period) == 0u;
+}
+
+static void RecordContentionSample(const char* name,
+                                   LockLevel level,
+                                   uint64_t blocked_tid,
+                                   uint64_t owner_tid,
+                                   uint64_t wait_time,
+                                   uintptr_t blocked_pc,
+                                   uintptr_t owner_unlock_pc) {
+  ContentionLevelStats* stats = &gContentionLevelStats[level];
+  stats->count.fetch_add(1u, std::memory_order_relaxed);
+  stats->wait_time.fetch_add(wait_time, std::memory_order_relaxed);
+  uint64_t wait_us = wait_time / 1000u;
+  size_t bucket = (wait_us == 0u) ? 0u : MinimumBitsToStore(wait_us);
+  bucket = std::min(bucket, ContentionLevelStats::kNumBuckets - 1u);
+  stats->buckets[bucket].fetch_add(1u, std::memory_order_relaxed);
+  if (ATraceEnabled()) {
+    ATraceIntegerValue("Lock contention wait (us)",
+                       static_cast<int32_t>(std::min<uint64_t>(wait_us, INT32_MAX)));
+  }
+
+  std::lock_guard<std::mutex> lock(gContentionSampleLogLock);
+  ContentionSample* sample =
+      &gContentionSampleLog[gContentionSampleCount % kContentionSampleLogSize];
+  ++gContentionSampleCount;
+  strlcpy(sample->name, name, sizeof(sample->name));
+  sample->level = level;
+  sample->blocked_tid = blocked_tid;
+  sample->owner_tid = owner_tid;
+  sample->wait_time = wait_time;
+  sample->blocked_pc = blocked_pc;
+  sample->owner_unlock_pc = owner_unlock_pc;
+}
+
+static void DumpCallSite(std::ostream& os, uintptr_t pc) {
+  if (pc == 0u) {
+    os << "<unknown>";
+    return;
+  }
+  Dl_info info = {};
+  if (dladdr(reinterpret_cast<void*>(pc), &info) != 0 && info.dli_sname != nullptr) {
+    os << info.dli_sname << "+" << (pc - reinterpret_cast<uintptr_t>(info.dli_saddr));
+  } else if (info.dli_fname != nullptr) {
+    os << info.dli_fname << "+" << StringPrintf("0x%" PRIxPTR,
+                                               pc - reinterpret_cast<uintptr_t>(info.dli_fbase));
+  } else {
+    os << StringPrintf("0x%" PRIxPTR, pc);
+  }
+}
+
 #if ART_USE_FUTEXES
 static bool ComputeRelativeTimeSpec(timespec* result_ts, const timespec& lhs, const timespec& rhs) {
   const int32_t one_sec = 1000 * 1000 * 1000;  // one second in nanoseconds.
@@ -154,11 +244,16 @@ class ScopedAllMutexesLock final {
 // Scoped class that generates events at the beginning and end of lock contention.
 class ScopedContentionRecorder final : public ValueObject {
  public:
-  ScopedContentionRecorder(BaseMutex* mutex, uint64_t blocked_tid, uint64_t owner_tid)
-      : mutex_(kLogLockContentions ? mutex : nullptr),
-        blocked_tid_(kLogLockContentions ? blocked_tid : 0),
-        owner_tid_(kLogLockContentions ? owner_tid : 0),
-        start_nano_time_(kLogLockContentions ? NanoTime() : 0) {
+  ScopedContentionRecorder(BaseMutex* mutex,
+                           uint64_t blocked_tid,
+                           uint64_t owner_tid,
+                           uintptr_t blocked_pc)
+      : sampled_(ShouldSampleContention()),
+        mutex_((kLogLockContentions || sampled_) ? mutex : nullptr),
+        blocked_tid_((kLogLockContentions || sampled_) ? blocked_tid : 0),
+        owner_tid_((kLogLockContentions || sampled_) ? owner_tid : 0),
+        blocked_pc_(sampled_ ? blocked_pc : 0u),
+        start_nano_time_((kLogLockContentions || sampled_) ? NanoTime() : 0) {
     if (ATraceEnabled()) {
       std::string msg = StringPrintf("Lock contention on %s (owner tid: %" PRIu64 ")",
                                      mutex->GetName(), owner_tid);
@@ -168,23 +263,37 @@ class ScopedContentionRecorder final : public ValueObject {
 
   ~ScopedContentionRecorder() {
     ATraceEnd();
-    if (kLogLockContentions) {
+    if (kLogLockContentions || sampled_) {
       uint64_t end_nano_time = NanoTime();
-      mutex_->RecordContention(blocked_tid_, owner_tid_, end_nano_time - start_nano_time_);
+      if (kLogLockContentions) {
+        mutex_->RecordContention(blocked_tid_, owner_tid_, end_nano_time - start_nano_time_);
+      }
+      if (sampled_) {
+        RecordContentionSample(mutex_->name_,
+                               mutex_->level_,
+                               blocked_tid_,
+                               owner_tid_,
+                               end_nano_time - start_nano_time_,
+                               blocked_pc_,
+                               mutex_->last_unlock_pc_.load(std::memory_order_relaxed));
+      }
     }
   }
 
  private:
+  const bool sampled_;
   BaseMutex* const mutex_;
   const uint64_t blocked_tid_;
   const uint64_t owner_tid_;
+  const uintptr_t blocked_pc_;
   const uint64_t start_nano_time_;
 };
 
 BaseMutex::BaseMutex(const char* name, LockLevel level)
     : name_(name),
       level_(level),
-      should_respond_to_empty_checkpoint_request_(false) {
+      should_respond_to_empty_checkpoint_request_(false),
+      last_unlock_pc_(0u) {
   if (kLogLockContentions) {
     ScopedAllMutexesLock mu(this);
     std::set<BaseMutex*>** all_mutexes_ptr = &gAllMutexData->all_mutexes;
@@ -205,6 +314,7 @@ BaseMutex::~BaseMutex() {
 }
 
 void BaseMutex::DumpAll(std::ostream& os) {
+  DumpContentionSamples(os);
   if (kLogLockContentions) {
     os << "Mutex logging:\n";
     ScopedAllMutexesLock mu(reinterpret_cast<const BaseMutex*>(-1));
@@ -230,6 +340,57 @@ void BaseMutex::DumpAll(std::ostream& os) {
   }
 }
 
+void BaseMutex::SetContentionSamplingPeriod(uint32_t period) {
+  gContentionSamplingPeriod.store(period, std::memory_order_relaxed);
+}
+
+void BaseMutex::DumpContentionSamples(std::ostream& os) {
+  uint32_t period = gContentionSamplingPeriod.load(std::memory_order_relaxed);
+  if (period == 0u) {
+    return;
+  }
+  os << "Mutex contention samples (1 in " << period << " contentions):\n";
+  for (size_t i = 0; i != kLockLevelCount; ++i) {
+    const ContentionLevelStats& stats = gContentionLevelStats[i];
+    uint64_t count = stats.count.load(std::memory_order_relaxed);
+    if (count == 0u) {
+      continue;
+    }
+    uint64_t wait_time = stats.wait_time.load(std::memory_order_relaxed);
+    os << "  " << static_cast<LockLevel>(i) << ": samples=" << count
+       << " total wait " << PrettyDuration(wait_time)
+       << " average " << PrettyDuration(wait_time / count) << "\n   ";
+    for (size_t b = 0; b != ContentionLevelStats::kNumBuckets; ++b) {
+      uint64_t bucket_count = stats.buckets[b].load(std::memory_order_relaxed);
+      if (bucket_count != 0u) {
+        os << ((b + 1u != ContentionLevelStats::kNumBuckets) ? " <" : " >=")
+           << (UINT64_C(1) << std::min(b, ContentionLevelStats::kNumBuckets - 2u)) << "us:"
+           << bucket_count;
+      }
+    }
+    os << "\n";
+  }
+  std::lock_guard<std::mutex> lock(gContentionSampleLogLock);
+  size_t num_samples = std::min(gContentionSampleCount, kContentionSampleLogSize);
+  os << "Recent samples (" << num_samples << " of " << gContentionSampleCount << "):\n";
+  for (size_t i = 0; i != num_samples; ++i) {
+    const ContentionSample& sample =
+        gContentionSampleLog[(gContentionSampleCount - 1u - i) % kContentionSampleLogSize];
+    os << "  \"" << sample.name << "\" (" << sample.level << ") waited "
+       << PrettyDuration(sample.wait_time) << ", tid=" << sample.blocked_tid << " at ";
+    DumpCallSite(os, sample.blocked_pc);
+    os << ", owner tid=" << sample.owner_tid << " last unlocked at ";
+    DumpCallSite(os, sample.owner_unlock_pc);
+    os << "\n";
+  }
+}
+
+void BaseMutex::RecordUnlockPc(uintptr_t pc) {
+  if (UNLIKELY(gContentionSamplingPeriod.load(std::memory_order_relaxed) != 0u)) {
+    last_unlock_pc_.store(pc, std::memory_order_relaxed);
+  }
+}
+
 void BaseMutex::CheckSafeToWait(Thread* self) {
   if (self == nullptr) {
     CheckUnattachedThread(level_);
@@ -430,7 +591,10 @@ void Mutex::ExclusiveLock(Thread* self) {
         done = state_and_contenders_.CompareAndSetWeakAcquire(cur_state, cur_state | kHeldMask);
       } else {
         // Failed to acquire, hang up.
-        ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
+        ScopedContentionRecorder scr(this,
+                                     SafeGetTid(self),
+                                     GetExclusiveOwnerTid(),
+                                     reinterpret_cast<uintptr_t>(__builtin_return_address(0)));
         // Empirically, it appears important to spin again each time through the loop; if we
         // bother to go to sleep and wake up, we should be fairly persistent in trying for the
         // lock.
@@ -585,6 +749,7 @@ void Mutex::ExclusiveUnlock(Thread* self) {
       CHECK(recursion_count_ == 0 || recursive_) << "Unexpected recursion count on mutex: "
           << name_ << " " << recursion_count_;
     }
+    RecordUnlockPc(reinterpret_cast<uintptr_t>(__builtin_return_address(0)));
     RegisterAsUnlocked(self);
 #if ART_USE_FUTEXES
     bool done = false;
@@ -693,7 +858,10 @@ void ReaderWriterMutex::ExclusiveLock(Thread* self) {
       done = state_.CompareAndSetWeakAcquire(0 /* cur_state*/, -1 /* new state */);
     } else {
       // Failed to acquire, hang up.
-      ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
+      ScopedContentionRecorder scr(this,
+                                   SafeGetTid(self),
+                                   GetExclusiveOwnerTid(),
+                                   reinterpret_cast<uintptr_t>(__builtin_return_address(0)));
       if (!WaitBrieflyFor(&state_, self, [](int32_t v) { return v == 0; })) {
         num_contenders_.fetch_add(1);
         if (UNLIKELY(should_respond_to_empty_checkpoint_request_)) {
@@ -724,6 +892,7 @@ void ReaderWriterMutex::ExclusiveLock(Thread* self) {
 void ReaderWriterMutex::ExclusiveUnlock(Thread* self) {
   DCHECK(self == nullptr || self == Thread::Current());
   AssertExclusiveHeld(self);
+  RecordUnlockPc(reinterpret_cast<uintptr_t>(__builtin_return_address(0)));
   RegisterAsUnlocked(self);
   DCHECK_NE(GetExclusiveOwnerTid(), 0);
 #if ART_USE_FUTEXES
@@ -772,7 +941,10 @@ bool ReaderWriterMutex::ExclusiveLockWithTimeout(Thread* self, int64_t ms, int32
       if (ComputeRelativeTimeSpec(&rel_ts, end_abs_ts, now_abs_ts)) {
         return false;  // Timed out.
       }
-      ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
+      ScopedContentionRecorder scr(this,
+                                   SafeGetTid(self),
+                                   GetExclusiveOwnerTid(),
+                                   reinterpret_cast<uintptr_t>(__builtin_return_address(0)));
       if (!WaitBrieflyFor(&state_, self, [](int32_t v) { return v == 0; })) {
         num_contenders_.fetch_add(1);
         if (UNLIKELY(should_respond_to_empty_checkpoint_request_)) {
@@ -816,7 +988,10 @@ bool ReaderWriterMutex::ExclusiveLockWithTimeout(Thread* self, int64_t ms, int32
 #if ART_USE_FUTEXES
 void ReaderWriterMutex::HandleSharedLockContention(Thread* self, int32_t cur_state) {
   // Owner holds it exclusively, hang up.
-  ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
+  ScopedContentionRecorder scr(this,
+                               SafeGetTid(self),
+                               GetExclusiveOwnerTid(),
+                               reinterpret_cast<uintptr_t>(__builtin_return_address(0)));
   if (!WaitBrieflyFor(&state_, self, [](int32_t v) { return v >= 0; })) {
     num_contenders_.fetch_add(1);
     if (UNLIKELY(should_respond_to_empty_checkpoint_request_)) {
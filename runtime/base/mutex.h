@@ -87,6 +87,15 @@ class BaseMutex {
 
   static void DumpAll(std::ostream& os);
 
+  // Sample one in `period` contentions of any mutex, or none if `period` is zero. Unlike
+  // kLogLockContentions this can be switched on in production builds. Sampled contentions are
+  // added to a wait time histogram for the lock level of the mutex and to a log of recent
+  // samples with the call sites of the waiter and of the last owner to unlock the mutex, which
+  // are dumped by DumpAll() on SIGQUIT. When tracing, the wait time is also published as a
+  // trace counter.
+  static void SetContentionSamplingPeriod(uint32_t period);
+  static void DumpContentionSamples(std::ostream& os);
+
   bool ShouldRespondToEmptyCheckpointRequest() const {
     return should_respond_to_empty_checkpoint_request_;
   }
@@ -115,6 +124,9 @@ class BaseMutex {
   void RecordContention(uint64_t blocked_tid, uint64_t owner_tid, uint64_t nano_time_blocked);
   void DumpContention(std::ostream& os) const;
 
+  // Remember the call site of an exclusive unlock while contention sampling is enabled.
+  void RecordUnlockPc(uintptr_t pc);
+
   const char* const name_;
 
   // A log entry that records contention but makes no guarantee that either tid will be held live.
@@ -140,6 +152,8 @@ class BaseMutex {
 
   const LockLevel level_;  // Support for lock hierarchy.
   bool should_respond_to_empty_checkpoint_request_;
+  // The call site of the last exclusive unlock, only recorded while sampling contention.
+  Atomic<uintptr_t> last_unlock_pc_;
 
  public:
   bool HasEverContended() const {
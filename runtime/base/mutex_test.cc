@@ -171,4 +171,42 @@ TEST_F(MutexTest, SharedTryLockUnlock) {
   SharedTryLockUnlockTest();
 }
 
+static void* ContentionSamplingCallback(void* arg) {
+  Mutex* mu = reinterpret_cast<Mutex*>(arg);
+  mu->Lock(Thread::Current());
+  mu->Unlock(Thread::Current());
+  return nullptr;
+}
+
+// GCC has trouble with our mutex tests, so we have to turn off thread safety analysis.
+static void ContentionSamplingTest() NO_THREAD_SAFETY_ANALYSIS {
+  BaseMutex::SetContentionSamplingPeriod(1u);
+  Mutex mu("contention sampling test mutex");
+  mu.Lock(Thread::Current());
+
+  pthread_t pthread;
+  int pthread_create_result = pthread_create(&pthread, nullptr, ContentionSamplingCallback, &mu);
+  ASSERT_EQ(0, pthread_create_result);
+  usleep(10000);
+  mu.Unlock(Thread::Current());
+  EXPECT_EQ(pthread_join(pthread, nullptr), 0);
+
+  std::ostringstream oss;
+  BaseMutex::DumpContentionSamples(oss);
+  BaseMutex::SetContentionSamplingPeriod(0u);
+  std::string dump = oss.str();
+  EXPECT_NE(dump.find("Mutex contention samples (1 in 1 contentions):"), std::string::npos)
+      << dump;
+  EXPECT_NE(dump.find("\"contention sampling test mutex\""), std::string::npos) << dump;
+
+  // Nothing is dumped while sampling is disabled.
+  std::ostringstream disabled_oss;
+  BaseMutex::DumpContentionSamples(disabled_oss);
+  EXPECT_TRUE(disabled_oss.str().empty());
+}
+
+TEST_F(MutexTest, ContentionSampling) {
+  ContentionSamplingTest();
+}
+
 }  // namespace art
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "boot_image_prefetch.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "android-base/file.h"
+#include "android-base/parseint.h"
+#include "android-base/stringprintf.h"
+#include "android-base/strings.h"
+#include "android-base/unique_fd.h"
+
+#include "base/bit_utils.h"
+#include "base/globals.h"
+#include "base/logging.h"
+#include "base/systrace.h"
+#include "gc/heap.h"
+#include "gc/space/image_space.h"
+#include "oat_file.h"
+#include "vdex_file.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+// A page aligned part of a boot image file mapping.
+struct BootImageRegion {
+  std::string name;
+  uint32_t checksum;
+  const uint8_t* begin;
+  size_t size;
+};
+
+static std::vector<BootImageRegion> GetBootImageRegions(gc::Heap* heap) {
+  std::vector<BootImageRegion> regions;
+  for (gc::space::ImageSpace* space : heap->GetBootImageSpaces()) {
+    const OatFile* oat_file = space->GetOatFile();
+    if (oat_file == nullptr) {
+      continue;
+    }
+    const uint32_t checksum = oat_file->GetOatHeader().GetChecksum();
+    auto add_region = [&](const char* kind, const uint8_t* begin, const uint8_t* end) {
+      const uint8_t* aligned_begin = AlignDown(begin, kPageSize);
+      const uint8_t* aligned_end = AlignUp(end, kPageSize);
+      if (aligned_begin < aligned_end) {
+        regions.push_back({oat_file->GetLocation() + "!" + kind,
+                           checksum,
+                           aligned_begin,
+                           static_cast<size_t>(aligned_end - aligned_begin)});
+      }
+    };
+    add_region("art", space->GetMemMap()->Begin(), space->GetMemMap()->End());
+    add_region("oat", oat_file->Begin(), oat_file->End());
+    const VdexFile* vdex_file = oat_file->GetVdexFile();
+    if (vdex_file != nullptr) {
+      add_region("vdex", vdex_file->Begin(), vdex_file->End());
+    }
+  }
+  return regions;
+}
+
+bool WriteBootImagePageRecord(gc::Heap* heap,
+                              const std::string& record_path,
+                              std::string* error_msg) {
+  ScopedTrace trace("WriteBootImagePageRecord");
+  android::base::unique_fd pagemap(open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC));
+  if (pagemap == -1) {
+    *error_msg = StringPrintf("Failed to open pagemap: %s", strerror(errno));
+    return false;
+  }
+
+  // From https://www.kernel.org/doc/Documentation/vm/pagemap.txt:
+  //  * Bit  61    page is file-page or shared-anon (since 3.5)
+  //  * Bit  63    page present
+  // Only file pages can be read ahead, anonymous pages of the .art mapping are skipped.
+  constexpr uint64_t kPresentFilePage = (UINT64_C(1) << 63) | (UINT64_C(1) << 61);
+  std::string record;
+  size_t recorded_pages = 0u;
+  std::vector<uint64_t> entries;
+  for (const BootImageRegion& region : GetBootImageRegions(heap)) {
+    const size_t page_count = region.size / kPageSize;
+    entries.resize(page_count);
+    const off_t offset =
+        (reinterpret_cast<uintptr_t>(region.begin) / kPageSize) * sizeof(uint64_t);
+    if (!android::base::ReadFullyAtOffset(
+            pagemap, entries.data(), page_count * sizeof(uint64_t), offset)) {
+      *error_msg = StringPrintf("Failed to read pagemap for %s: %s",
+                                region.name.c_str(),
+                                strerror(errno));
+      return false;
+    }
+    record += StringPrintf("%s %u %zu", region.name.c_str(), region.checksum, region.size);
+    for (size_t i = 0; i != page_count; ) {
+      if ((entries[i] & kPresentFilePage) != kPresentFilePage) {
+        ++i;
+        continue;
+      }
+      size_t first = i;
+      while (i != page_count && (entries[i] & kPresentFilePage) == kPresentFilePage) {
+        ++i;
+      }
+      record += StringPrintf(" %zu+%zu", first, i - first);
+      recorded_pages += i - first;
+    }
+    record += '\n';
+  }
+
+  if (!android::base::WriteStringToFile(record, record_path)) {
+    *error_msg = StringPrintf("Failed to write %s: %s", record_path.c_str(), strerror(errno));
+    return false;
+  }
+  VLOG(startup) << "Recorded " << recorded_pages << " boot image pages in " << record_path;
+  return true;
+}
+
+bool PrefetchBootImagePages(gc::Heap* heap,
+                            const std::string& record_path,
+                            std::string* error_msg) {
+  ScopedTrace trace("PrefetchBootImagePages");
+  std::string record;
+  if (!android::base::ReadFileToString(record_path, &record)) {
+    *error_msg = StringPrintf("Failed to read %s: %s", record_path.c_str(), strerror(errno));
+    return false;
+  }
+
+  // Ideal blockTransferSize for madvising files, see Runtime::MadviseFileForRange().
+  static constexpr size_t kIdealIoTransferSizeBytes = 128 * KB;
+  const std::vector<BootImageRegion> regions = GetBootImageRegions(heap);
+  size_t prefetched_pages = 0u;
+  for (const std::string& line : android::base::Split(record, "\n")) {
+    if (line.empty()) {
+      continue;
+    }
+    std::vector<std::string> fields = android::base::Split(line, " ");
+    uint32_t checksum;
+    size_t size;
+    if (fields.size() < 3u ||
+        !android::base::ParseUint(fields[1], &checksum) ||
+        !android::base::ParseUint(fields[2], &size)) {
+      *error_msg = StringPrintf("Malformed boot image page record %s", record_path.c_str());
+      return false;
+    }
+    auto it = std::find_if(regions.begin(), regions.end(), [&](const BootImageRegion& region) {
+      return region.name == fields[0];
+    });
+    if (it == regions.end() || it->checksum != checksum || it->size != size) {
+      // The record was written against a different boot image.
+      VLOG(startup) << "Ignoring stale boot image page record for " << fields[0];
+      continue;
+    }
+    const size_t page_count = size / kPageSize;
+    for (size_t i = 3u; i != fields.size(); ++i) {
+      std::vector<std::string> range = android::base::Split(fields[i], "+");
+      size_t first;
+      size_t count;
+      if (range.size() != 2u ||
+          !android::base::ParseUint(range[0], &first) ||
+          !android::base::ParseUint(range[1], &count) ||
+          first > page_count ||
+          count > page_count - first) {
+        *error_msg = StringPrintf("Malformed boot image page record %s", record_path.c_str());
+        return false;
+      }
+      const uint8_t* range_begin = it->begin + first * kPageSize;
+      const uint8_t* range_end = range_begin + count * kPageSize;
+      // madvise(MADV_WILLNEED) reads ahead at most max(fd readahead size, optimal block size
+      // for device) per call, hence the chunks.
+      for (const uint8_t* madvise_start = range_begin;
+           madvise_start < range_end;
+           madvise_start += kIdealIoTransferSizeBytes) {
+        void* madvise_addr = const_cast<void*>(reinterpret_cast<const void*>(madvise_start));
+        size_t madvise_length = std::min(kIdealIoTransferSizeBytes,
+                                         static_cast<size_t>(range_end - madvise_start));
+        if (madvise(madvise_addr, madvise_length, MADV_WILLNEED) != 0) {
+          *error_msg = StringPrintf("Failed to madvise %s: %s", it->name.c_str(), strerror(errno));
+          return false;
+        }
+      }
+      prefetched_pages += count;
+    }
+  }
+  VLOG(startup) << "Prefetched " << prefetched_pages << " boot image pages from " << record_path;
+  return true;
+}
+
+}  // namespace art
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_BOOT_IMAGE_PREFETCH_H_
+#define ART_RUNTIME_BOOT_IMAGE_PREFETCH_H_
+
+#include <string>
+
+namespace art {
+
+namespace gc {
+class Heap;
+}  // namespace gc
+
+// Per-app record of the file backed boot image pages (.art, .oat and .vdex) that the app
+// touched during startup. Pages mapped from the zygote are not inherited by the page tables
+// of a forked app, so every boot image page the app uses is faulted in again, and read from
+// storage if it was evicted from the page cache. Prefetching the recorded pages from a
+// background thread right after fork turns these synchronous reads into readahead.
+//
+// The record is keyed by the checksums of the boot image oat files, so a record written
+// against another boot image is ignored.
+
+// Write the ranges of boot image pages currently mapped by this process to `record_path`.
+bool WriteBootImagePageRecord(gc::Heap* heap,
+                              const std::string& record_path,
+                              std::string* error_msg);
+
+// Madvise MADV_WILLNEED the boot image pages listed in the record at `record_path`.
+bool PrefetchBootImagePages(gc::Heap* heap,
+                            const std::string& record_path,
+                            std::string* error_msg);
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BOOT_IMAGE_PREFETCH_H_
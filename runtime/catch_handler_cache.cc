@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "catch_handler_cache.h"
+
+#include "base/casts.h"
+#include "dex/dex_file_types.h"
+#include "mirror/class.h"
+#include "obj_ptr-inl.h"
+#include "object_callbacks.h"
+
+namespace art {
+
+std::atomic<uint32_t> CatchHandlerCache::invalidation_count_(0u);
+
+void CatchHandlerCache::Validate() {
+  uint32_t invalidation_count = invalidation_count_.load(std::memory_order_seq_cst);
+  if (invalidation_count != seen_invalidation_count_) {
+    entries_.fill(Entry{});
+    seen_invalidation_count_ = invalidation_count;
+  }
+}
+
+bool CatchHandlerCache::Lookup(ArtMethod* method,
+                               uint32_t dex_pc,
+                               ObjPtr<mirror::Class> exception_class,
+                               /*out*/ uint32_t* handler_dex_pc,
+                               /*out*/ bool* has_no_move_exception) {
+  Validate();
+  const Entry& entry = entries_[IndexOf(method, dex_pc, exception_class)];
+  if (entry.method != method ||
+      entry.dex_pc != dex_pc ||
+      entry.exception_class != exception_class.Ptr()) {
+    return false;
+  }
+  *handler_dex_pc = entry.handler_dex_pc;
+  if (entry.handler_dex_pc != dex::kDexNoIndex) {
+    *has_no_move_exception = entry.has_no_move_exception;
+  }
+  return true;
+}
+
+void CatchHandlerCache::Set(ArtMethod* method,
+                            uint32_t dex_pc,
+                            ObjPtr<mirror::Class> exception_class,
+                            uint32_t handler_dex_pc,
+                            bool has_no_move_exception) {
+  DCHECK(method != nullptr);
+  Validate();
+  Entry& entry = entries_[IndexOf(method, dex_pc, exception_class)];
+  entry.method = method;
+  entry.exception_class = exception_class.Ptr();
+  entry.dex_pc = dex_pc;
+  entry.handler_dex_pc = handler_dex_pc;
+  entry.has_no_move_exception = has_no_move_exception;
+}
+
+void CatchHandlerCache::Sweep(IsMarkedVisitor* visitor) {
+  for (Entry& entry : entries_) {
+    if (entry.method == nullptr) {
+      continue;
+    }
+    mirror::Object* new_class = visitor->IsMarked(entry.exception_class);
+    if (new_class == nullptr) {
+      // The class is dead, or the collector does not know; the entry is just a cache.
+      entry = Entry{};
+    } else {
+      entry.exception_class = down_cast<mirror::Class*>(new_class);
+    }
+  }
+}
+
+}  // namespace art
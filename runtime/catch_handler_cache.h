@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CATCH_HANDLER_CACHE_H_
+#define ART_RUNTIME_CATCH_HANDLER_CACHE_H_
+
+#include <array>
+#include <atomic>
+
+#include "base/bit_utils.h"
+#include "base/locks.h"
+#include "base/macros.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+class ArtMethod;
+class IsMarkedVisitor;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+// Thread-local cache of the results of ArtMethod::FindCatchBlock(), so that delivering an
+// exception through frames seen before does not decode the try/catch tables and resolve
+// the catch types again.
+//
+// Entries are keyed by the method, the dex pc and the exception class. The methods are
+// raw pointers, so the caches of all threads are invalidated when the code of a method
+// changes (class redefinition) or ArtMethods are freed (class unloading). The exception
+// classes are weak and updated or removed by Sweep() when the GC sweeps system weaks.
+class CatchHandlerCache {
+ public:
+  // Number of entries, direct-mapped.
+  static constexpr size_t kSize = 64;
+
+  CatchHandlerCache() {}
+
+  // Invalidate the caches of all threads.
+  static void InvalidateAll() {
+    invalidation_count_.fetch_add(1u, std::memory_order_seq_cst);
+  }
+
+  // Returns true and sets the handler dex pc, or dex::kDexNoIndex if there is no handler
+  // for the exception in this method, if the lookup is in the cache. `has_no_move_exception`
+  // is only set if a handler was found, as for ArtMethod::FindCatchBlock().
+  bool Lookup(ArtMethod* method,
+              uint32_t dex_pc,
+              ObjPtr<mirror::Class> exception_class,
+              /*out*/ uint32_t* handler_dex_pc,
+              /*out*/ bool* has_no_move_exception)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  void Set(ArtMethod* method,
+           uint32_t dex_pc,
+           ObjPtr<mirror::Class> exception_class,
+           uint32_t handler_dex_pc,
+           bool has_no_move_exception)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Update the exception classes moved by the GC and remove the entries of dead classes.
+  void Sweep(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  struct Entry {
+    ArtMethod* method = nullptr;
+    mirror::Class* exception_class = nullptr;
+    uint32_t dex_pc = 0u;
+    uint32_t handler_dex_pc = 0u;
+    bool has_no_move_exception = false;
+  };
+
+  static size_t IndexOf(ArtMethod* method, uint32_t dex_pc, ObjPtr<mirror::Class> klass) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    uintptr_t hash = (reinterpret_cast<uintptr_t>(method) >> 3) ^
+                     (reinterpret_cast<uintptr_t>(klass.Ptr()) >> 3) ^
+                     dex_pc;
+    return hash & (kSize - 1u);
+  }
+
+  // Clear the cache if it was invalidated since the last call.
+  void Validate();
+
+  static std::atomic<uint32_t> invalidation_count_;
+
+  std::array<Entry, kSize> entries_;
+  uint32_t seen_invalidation_count_ = 0u;
+
+  DISALLOW_COPY_AND_ASSIGN(CatchHandlerCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CATCH_HANDLER_CACHE_H_
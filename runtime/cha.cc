@@ -16,6 +16,8 @@
 
 #include "cha.h"
 
+#include <ostream>
+
 #include "art_method-inl.h"
 #include "base/logging.h"  // For VLOG
 #include "base/mutex.h"
@@ -77,6 +79,12 @@ void ClassHierarchyAnalysis::RemoveDependentsWithMethodHeaders(
       map_it++;
     }
   }
+  // The freed code must not be invalidated later either.
+  for (MethodAndMethodHeaderPair& pending : pending_invalidations_) {
+    if (method_headers.find(pending.second) != method_headers.end()) {
+      pending.first = nullptr;
+    }
+  }
 }
 
 void ClassHierarchyAnalysis::ResetSingleImplementationInHierarchy(ObjPtr<mirror::Class> klass,
@@ -632,76 +640,114 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
   if (!invalidated_single_impl_methods.empty()) {
     Runtime* const runtime = Runtime::Current();
     Thread *self = Thread::Current();
-    // Method headers for compiled code to be invalidated.
-    std::unordered_set<OatQuickMethodHeader*> dependent_method_headers;
     PointerSize image_pointer_size =
         Runtime::Current()->GetClassLinker()->GetImagePointerSize();
 
-    {
-      // We do this under cha_lock_. Committing code also grabs this lock to
-      // make sure the code is only committed when all single-implementation
-      // assumptions are still true.
-      std::vector<std::pair<ArtMethod*, OatQuickMethodHeader*>> headers;
-      {
-        MutexLock cha_mu(self, *Locks::cha_lock_);
-        // Invalidate compiled methods that assume some virtual calls have only
-        // single implementations.
-        for (ArtMethod* invalidated : invalidated_single_impl_methods) {
-          if (!invalidated->HasSingleImplementation()) {
-            // It might have been invalidated already when other class linking is
-            // going on.
-            continue;
-          }
-          invalidated->SetHasSingleImplementation(false);
-          if (invalidated->IsAbstract()) {
-            // Clear the single implementation method.
-            invalidated->SetSingleImplementation(nullptr, image_pointer_size);
-          }
-
-          if (runtime->IsAotCompiler()) {
-            // No need to invalidate any compiled code as the AotCompiler doesn't
-            // run any code.
-            continue;
-          }
+    // We do this under cha_lock_. Committing code also grabs this lock to
+    // make sure the code is only committed when all single-implementation
+    // assumptions are still true.
+    MutexLock cha_mu(self, *Locks::cha_lock_);
+    // Invalidate compiled methods that assume some virtual calls have only
+    // single implementations.
+    for (ArtMethod* invalidated : invalidated_single_impl_methods) {
+      if (!invalidated->HasSingleImplementation()) {
+        // It might have been invalidated already when other class linking is
+        // going on.
+        continue;
+      }
+      invalidated->SetHasSingleImplementation(false);
+      if (invalidated->IsAbstract()) {
+        // Clear the single implementation method.
+        invalidated->SetSingleImplementation(nullptr, image_pointer_size);
+      }
 
-          // Invalidate all dependents.
-          for (const auto& dependent : GetDependents(invalidated)) {
-            ArtMethod* method = dependent.first;;
-            OatQuickMethodHeader* method_header = dependent.second;
-            VLOG(class_linker) << "CHA invalidated compiled code for " << method->PrettyMethod();
-            DCHECK(runtime->UseJitCompilation());
-            // We need to call JitCodeCache::InvalidateCompiledCodeFor but we cannot do it here
-            // since it would run into problems with lock-ordering. We don't want to re-order the
-            // locks since that would make code-commit racy.
-            headers.push_back({method, method_header});
-            dependent_method_headers.insert(method_header);
-          }
-          RemoveAllDependenciesFor(invalidated);
-        }
+      if (runtime->IsAotCompiler()) {
+        // No need to invalidate any compiled code as the AotCompiler doesn't
+        // run any code.
+        continue;
       }
-      // Since we are still loading the class that invalidated the code it's fine we have this after
-      // getting rid of the dependency. Any calls would need to be with the old version (since the
-      // new one isn't loaded yet) which still works fine. We will deoptimize just after this to
-      // ensure everything gets the new state.
-      jit::Jit* jit = Runtime::Current()->GetJit();
-      if (jit != nullptr) {
-        jit::JitCodeCache* code_cache = jit->GetCodeCache();
-        for (const auto& pair : headers) {
-          code_cache->InvalidateCompiledCodeFor(pair.first, pair.second);
-        }
+
+      // Invalidate all dependents.
+      for (const auto& dependent : GetDependents(invalidated)) {
+        ArtMethod* method = dependent.first;;
+        OatQuickMethodHeader* method_header = dependent.second;
+        VLOG(class_linker) << "CHA invalidated compiled code for " << method->PrettyMethod();
+        DCHECK(runtime->UseJitCompilation());
+        // We need to call JitCodeCache::InvalidateCompiledCodeFor but we cannot do it here
+        // since it would run into problems with lock-ordering. We don't want to re-order the
+        // locks since that would make code-commit racy. Queue it for
+        // ApplyPendingInvalidations() instead.
+        pending_invalidations_.push_back({method, method_header});
+        ++num_invalidated_code_;
+        has_pending_invalidations_.store(true, std::memory_order_relaxed);
       }
+      RemoveAllDependenciesFor(invalidated);
     }
+  }
+}
 
-    if (dependent_method_headers.empty()) {
-      return;
+void ClassHierarchyAnalysis::ApplyPendingInvalidations() {
+  if (!has_pending_invalidations_.load(std::memory_order_acquire)) {
+    return;
+  }
+  Thread* self = Thread::Current();
+  // Copy the pending entries instead of taking them, so that a concurrent caller that finds
+  // no pending entries can rely on them being applied already. Applying an entry twice is
+  // harmless.
+  ListOfDependentPairs headers;
+  uint64_t end;
+  {
+    MutexLock cha_mu(self, *Locks::cha_lock_);
+    headers = pending_invalidations_;
+    end = num_applied_invalidations_ + pending_invalidations_.size();
+  }
+  // Method headers for compiled code to be invalidated.
+  std::unordered_set<OatQuickMethodHeader*> dependent_method_headers;
+  // Since we are still loading the classes that invalidated the code it's fine we have this after
+  // getting rid of the dependency. Any calls would need to be with the old version (since the
+  // new ones aren't initialized yet) which still works fine. We will deoptimize just after this
+  // to ensure everything gets the new state.
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  for (const auto& pair : headers) {
+    if (pair.first == nullptr) {
+      continue;  // Freed since it was queued.
+    }
+    if (jit != nullptr) {
+      jit->GetCodeCache()->InvalidateCompiledCodeFor(pair.first, pair.second);
     }
+    dependent_method_headers.insert(pair.second);
+  }
+
+  if (!dependent_method_headers.empty()) {
     // Deoptimze compiled code on stack that should have been invalidated.
     CHACheckpoint checkpoint(dependent_method_headers);
-    size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
+    size_t threads_running_checkpoint =
+        Runtime::Current()->GetThreadList()->RunCheckpoint(&checkpoint);
     if (threads_running_checkpoint != 0) {
       checkpoint.WaitForThreadsToRunThroughCheckpoint(threads_running_checkpoint);
     }
   }
+
+  MutexLock cha_mu(self, *Locks::cha_lock_);
+  if (end > num_applied_invalidations_) {
+    // Not removed by a concurrent caller yet.
+    size_t count = end - num_applied_invalidations_;
+    DCHECK_LE(count, pending_invalidations_.size());
+    pending_invalidations_.erase(pending_invalidations_.begin(),
+                                 pending_invalidations_.begin() + count);
+    num_applied_invalidations_ = end;
+    ++num_invalidation_batches_;
+    if (pending_invalidations_.empty()) {
+      has_pending_invalidations_.store(false, std::memory_order_release);
+    }
+  }
+}
+
+void ClassHierarchyAnalysis::DumpStats(std::ostream& os) {
+  MutexLock cha_mu(Thread::Current(), *Locks::cha_lock_);
+  os << "cha_invalidations code_count=" << num_invalidated_code_
+     << " batch_count=" << num_invalidation_batches_
+     << " pending_count=" << pending_invalidations_.size() << "\n";
 }
 
 void ClassHierarchyAnalysis::RemoveDependenciesForLinearAlloc(const LinearAlloc* linear_alloc) {
@@ -715,6 +761,11 @@ void ClassHierarchyAnalysis::RemoveDependenciesForLinearAlloc(const LinearAlloc*
       ++it;
     }
   }
+  for (MethodAndMethodHeaderPair& pending : pending_invalidations_) {
+    if (pending.first != nullptr && linear_alloc->ContainsUnsafe(pending.first)) {
+      pending.first = nullptr;
+    }
+  }
 }
 
 }  // namespace art
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_CHA_H_
 #define ART_RUNTIME_CHA_H_
 
+#include <atomic>
+#include <iosfwd>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -88,7 +90,11 @@ class ClassHierarchyAnalysis {
   typedef std::pair<ArtMethod*, OatQuickMethodHeader*> MethodAndMethodHeaderPair;
   typedef std::vector<MethodAndMethodHeaderPair> ListOfDependentPairs;
 
-  ClassHierarchyAnalysis() {}
+  ClassHierarchyAnalysis()
+      : has_pending_invalidations_(false),
+        num_applied_invalidations_(0u),
+        num_invalidated_code_(0u),
+        num_invalidation_batches_(0u) {}
 
   // Add a dependency that compiled code with `dependent_header` for `dependent_method`
   // assumes that virtual `method` has single-implementation.
@@ -122,8 +128,20 @@ class ClassHierarchyAnalysis {
       const REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Update CHA info for methods that `klass` overrides, after loading `klass`.
+  // Compiled code invalidated by the new class is only queued, see ApplyPendingInvalidations().
   void UpdateAfterLoadingOf(Handle<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Remove the compiled code invalidated by loaded classes from the JIT code cache and
+  // method entrypoints, and mark its frames for deoptimization with a single checkpoint.
+  // Until this is done, the code may only run with receivers of classes loaded earlier, so
+  // it must be called before a newly loaded class gets initialized and can have instances.
+  // Invalidations of classes loaded in a burst are thus applied in one batch.
+  void ApplyPendingInvalidations()
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::cha_lock_);
+
+  void DumpStats(std::ostream& os) REQUIRES(!Locks::cha_lock_);
+
   // Remove all of the dependencies for a linear allocator. This is called when dex cache unloading
   // occurs.
   void RemoveDependenciesForLinearAlloc(const LinearAlloc* linear_alloc)
@@ -171,6 +189,19 @@ class ClassHierarchyAnalysis {
   std::unordered_map<ArtMethod*, ListOfDependentPairs> cha_dependency_map_
     GUARDED_BY(Locks::cha_lock_);
 
+  // Compiled code invalidated by loaded classes, waiting for ApplyPendingInvalidations().
+  // Entries for code or methods freed in the meantime have their ArtMethod cleared.
+  ListOfDependentPairs pending_invalidations_ GUARDED_BY(Locks::cha_lock_);
+  // Whether `pending_invalidations_` is not empty. Checked without the lock on class
+  // initialization; an entry is only removed once it has been applied.
+  std::atomic<bool> has_pending_invalidations_;
+  // Number of entries applied and removed from the front of `pending_invalidations_`.
+  uint64_t num_applied_invalidations_ GUARDED_BY(Locks::cha_lock_);
+
+  // Statistics.
+  uint64_t num_invalidated_code_ GUARDED_BY(Locks::cha_lock_);
+  uint64_t num_invalidation_batches_ GUARDED_BY(Locks::cha_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(ClassHierarchyAnalysis);
 };
 
@@ -54,6 +54,7 @@
 #include "base/unix_file/fd_file.h"
 #include "base/utils.h"
 #include "base/value_object.h"
+#include "catch_handler_cache.h"
 #include "cha.h"
 #include "class_linker-inl.h"
 #include "class_loader_utils.h"
@@ -80,6 +81,7 @@
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
 #include "gc/space/space-inl.h"
+#include "gc/task_processor.h"
 #include "gc_root-inl.h"
 #include "handle_scope-inl.h"
 #include "hidden_api.h"
@@ -138,9 +140,11 @@
 #include "runtime.h"
 #include "runtime_callbacks.h"
 #include "scoped_thread_state_change-inl.h"
+#include "stack_trace_frame_cache.h"
 #include "thread-inl.h"
 #include "thread.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "transaction.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
@@ -426,6 +430,10 @@ void ClassLinker::ForceClassInitialized(Thread* self, Handle<mirror::Class> klas
 
 ClassLinker::VisiblyInitializedCallback* ClassLinker::MarkClassInitialized(
     Thread* self, Handle<mirror::Class> klass) {
+  // Classes such as proxies are marked initialized without going through InitializeClass().
+  if (cha_ != nullptr) {
+    cha_->ApplyPendingInvalidations();
+  }
   if (kRuntimeISA == InstructionSet::kX86 || kRuntimeISA == InstructionSet::kX86_64) {
     // Thanks to the x86 memory model, we do not need any memory fences and
     // we can immediately mark the class as visibly initialized.
@@ -628,7 +636,9 @@ static void ShuffleForward(size_t* current_field_idx,
   }
 }
 
-ClassLinker::ClassLinker(InternTable* intern_table, bool fast_class_not_found_exceptions)
+ClassLinker::ClassLinker(InternTable* intern_table,
+                         bool fast_class_not_found_exceptions,
+                         bool lazy_imt)
     : boot_class_table_(new ClassTable()),
       failed_dex_cache_class_lookups_(0),
       class_roots_(nullptr),
@@ -637,6 +647,8 @@ ClassLinker::ClassLinker(InternTable* intern_table, bool fast_class_not_found_ex
       log_new_roots_(false),
       intern_table_(intern_table),
       fast_class_not_found_exceptions_(fast_class_not_found_exceptions),
+      lazy_imt_enabled_(lazy_imt),
+      lazy_imt_(nullptr),
       jni_dlsym_lookup_trampoline_(nullptr),
       jni_dlsym_lookup_critical_trampoline_(nullptr),
       quick_resolution_trampoline_(nullptr),
@@ -646,7 +658,14 @@ ClassLinker::ClassLinker(InternTable* intern_table, bool fast_class_not_found_ex
       image_pointer_size_(kRuntimePointerSize),
       visibly_initialized_callback_lock_("visibly initialized callback lock"),
       visibly_initialized_callback_(nullptr),
-      cha_(Runtime::Current()->IsAotCompiler() ? nullptr : new ClassHierarchyAnalysis()) {
+      cha_(Runtime::Current()->IsAotCompiler() ? nullptr : new ClassHierarchyAnalysis()),
+      pending_class_loaders_lock_("pending class loaders lock"),
+      delete_class_loaders_task_pending_(false),
+      num_unloaded_class_loaders_(0u),
+      num_unloaded_classes_(0u),
+      unloaded_linear_alloc_bytes_(0u),
+      class_loader_unlink_time_ns_(0u),
+      class_loader_delete_time_ns_(0u) {
   // For CHA disabled during Aot, see b/34193647.
 
   CHECK(intern_table_ != nullptr);
@@ -2236,7 +2255,9 @@ bool ClassLinker::ClassInClassTable(ObjPtr<mirror::Class> klass) {
   return class_table != nullptr && class_table->Contains(klass);
 }
 
-void ClassLinker::VisitClassRoots(RootVisitor* visitor, VisitRootFlags flags) {
+void ClassLinker::VisitClassRoots(RootVisitor* visitor,
+                                  VisitRootFlags flags,
+                                  ThreadPool* thread_pool) {
   // Acquire tracing_enabled before locking class linker lock to prevent lock order violation. Since
   // enabling tracing requires the mutator lock, there are no race conditions here.
   const bool tracing_enabled = Trace::IsTracingEnabled();
@@ -2270,12 +2291,17 @@ void ClassLinker::VisitClassRoots(RootVisitor* visitor, VisitRootFlags flags) {
     // ClassTable::TableSlot. The buffered root visiting would access a stale stack location for
     // these objects.
     UnbufferedRootVisitor root_visitor(visitor, RootInfo(kRootStickyClass));
-    boot_class_table_->VisitRoots(root_visitor);
     // If tracing is enabled, then mark all the class loaders to prevent unloading.
-    if ((flags & kVisitRootFlagClassLoader) != 0 || tracing_enabled) {
-      for (const ClassLoaderData& data : class_loaders_) {
-        GcRoot<mirror::Object> root(GcRoot<mirror::Object>(self->DecodeJObject(data.weak_root)));
-        root.VisitRoot(visitor, RootInfo(kRootVMInternal));
+    const bool visit_class_loaders = (flags & kVisitRootFlagClassLoader) != 0 || tracing_enabled;
+    if (visit_class_loaders && thread_pool != nullptr) {
+      VisitClassLoaderRootsInParallel(self, visitor, thread_pool);
+    } else {
+      boot_class_table_->VisitRoots(root_visitor);
+      if (visit_class_loaders) {
+        for (const ClassLoaderData& data : class_loaders_) {
+          GcRoot<mirror::Object> root(GcRoot<mirror::Object>(self->DecodeJObject(data.weak_root)));
+          root.VisitRoot(visitor, RootInfo(kRootVMInternal));
+        }
       }
     }
   } else if (!kUseReadBarrier && (flags & kVisitRootFlagNewRoots) != 0) {
@@ -2315,9 +2341,40 @@ void ClassLinker::VisitClassRoots(RootVisitor* visitor, VisitRootFlags flags) {
 // Keep in sync with InitCallback. Anything we visit, we need to
 // reinit references to when reinitializing a ClassLinker from a
 // mapped image.
-void ClassLinker::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
+void ClassLinker::VisitClassLoaderRootsInParallel(Thread* self,
+                                                  RootVisitor* visitor,
+                                                  ThreadPool* thread_pool) {
+  // Decoding the weak roots may need to wait for weak reference access, so the class loaders are
+  // visited on this thread. The class tables, where the bulk of the work is, are split between
+  // the workers. The class table of a cleared class loader is not visited, as that would keep
+  // its classes alive.
+  std::vector<ClassTable*> class_tables;
+  class_tables.reserve(class_loaders_.size() + 1u);
+  class_tables.push_back(boot_class_table_.get());
+  for (const ClassLoaderData& data : class_loaders_) {
+    GcRoot<mirror::Object> root(GcRoot<mirror::Object>(self->DecodeJObject(data.weak_root)));
+    if (!root.IsNull() && data.class_table != nullptr) {
+      class_tables.push_back(data.class_table);
+    }
+    root.VisitRoot(visitor, RootInfo(kRootVMInternal));
+  }
+  for (ClassTable* class_table : class_tables) {
+    // The tasks run while this thread holds the classlinker_classes_lock_, which keeps the
+    // class tables alive and unchanged apart from their own locking.
+    auto function = [class_table, visitor](Thread*) NO_THREAD_SAFETY_ANALYSIS {
+      UnbufferedRootVisitor root_visitor(visitor, RootInfo(kRootStickyClass));
+      class_table->VisitRoots(root_visitor);
+    };
+    thread_pool->AddTask(self, new FunctionTask(std::move(function)));
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
+}
+
+void ClassLinker::VisitRoots(RootVisitor* visitor, VisitRootFlags flags, ThreadPool* thread_pool) {
   class_roots_.VisitRootIfNonNull(visitor, RootInfo(kRootVMInternal));
-  VisitClassRoots(visitor, flags);
+  VisitClassRoots(visitor, flags, thread_pool);
   // Instead of visiting the find_array_class_cache_ drop it so that it doesn't prevent class
   // unloading if we are marking roots.
   DropFindArrayClassCache();
@@ -2473,6 +2530,8 @@ ClassLinker::~ClassLinker() {
     DeleteClassLoader(self, data, /*cleanup_cha=*/ false);
   }
   class_loaders_.clear();
+  // Free the class loaders unloaded by the last GCs if the heap task daemon did not get to them.
+  DeletePendingClassLoaders(self);
   while (!running_visibly_initialized_callbacks_.empty()) {
     std::unique_ptr<VisiblyInitializedCallback> callback(
         std::addressof(running_visibly_initialized_callbacks_.front()));
@@ -2481,6 +2540,15 @@ ClassLinker::~ClassLinker() {
 }
 
 void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data, bool cleanup_cha) {
+  UnlinkClassLoader(self, data, cleanup_cha);
+  // The ArtMethods are about to be freed, drop the cached data referring to them.
+  StackTraceFrameCache::InvalidateAll();
+  CatchHandlerCache::InvalidateAll();
+  delete data.allocator;
+  delete data.class_table;
+}
+
+void ClassLinker::UnlinkClassLoader(Thread* self, const ClassLoaderData& data, bool cleanup_cha) {
   Runtime* const runtime = Runtime::Current();
   JavaVMExt* const vm = runtime->GetJavaVM();
   vm->DeleteWeakGlobalRef(self, data.weak_root);
@@ -2500,9 +2568,6 @@ void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data, b
     CHAOnDeleteUpdateClassVisitor visitor(data.allocator);
     data.class_table->Visit<CHAOnDeleteUpdateClassVisitor, kWithoutReadBarrier>(visitor);
   }
-
-  delete data.allocator;
-  delete data.class_table;
 }
 
 ObjPtr<mirror::PointerArray> ClassLinker::AllocPointerArray(Thread* self, size_t length) {
@@ -5300,6 +5365,12 @@ bool ClassLinker::InitializeClass(Thread* self, Handle<mirror::Class> klass,
     return false;
   }
 
+  // Apply the CHA invalidations of loaded classes before the class initializer can create
+  // instances of `klass`.
+  if (cha_ != nullptr) {
+    cha_->ApplyPendingInvalidations();
+  }
+
   self->AllowThreadSuspension();
   uint64_t t0;
   {
@@ -6044,6 +6115,11 @@ bool ClassLinker::LinkClass(Thread* self,
         }
       }
     }
+    if (imt == nullptr && lazy_imt_enabled_ && init_done_) {
+      // Many classes are never the receiver of an interface call, defer populating the IMT
+      // until the first interface dispatch on an instance of the class.
+      imt = GetOrCreateLazyImt(self);
+    }
     if (imt == nullptr) {
       LinearAlloc* allocator = GetAllocatorForClassLoader(klass->GetClassLoader());
       imt = reinterpret_cast<ImTable*>(
@@ -6996,6 +7072,63 @@ void ClassLinker::FillIMTAndConflictTables(ObjPtr<mirror::Class> klass) {
   }
 }
 
+ImTable* ClassLinker::GetOrCreateLazyImt(Thread* self) {
+  ImTable* imt = lazy_imt_.load(std::memory_order_acquire);
+  if (imt != nullptr) {
+    return imt;
+  }
+  Runtime* const runtime = Runtime::Current();
+  LinearAlloc* linear_alloc = runtime->GetLinearAlloc();
+  ImTable* new_imt = reinterpret_cast<ImTable*>(
+      linear_alloc->Alloc(self, ImTable::SizeInBytes(image_pointer_size_)));
+  if (new_imt == nullptr) {
+    return nullptr;
+  }
+  ArtMethod* imt_data[ImTable::kSize];
+  std::fill_n(imt_data, arraysize(imt_data), runtime->GetImtConflictMethod());
+  new_imt->Populate(imt_data, image_pointer_size_);
+  // If another thread won the race, we leak the memory of our table in the LinearAlloc.
+  if (!lazy_imt_.compare_exchange_strong(imt, new_imt, std::memory_order_acq_rel)) {
+    return imt;
+  }
+  return new_imt;
+}
+
+ImTable* ClassLinker::PopulateLazyImt(ObjPtr<mirror::Class> klass) {
+  DCHECK(klass->ShouldHaveImt()) << klass->PrettyClass();
+  DCHECK(IsLazyImt(klass->GetImt(image_pointer_size_))) << klass->PrettyClass();
+  Runtime* const runtime = Runtime::Current();
+  ArtMethod* imt_data[ImTable::kSize];
+  std::fill_n(imt_data, arraysize(imt_data), runtime->GetImtUnimplementedMethod());
+  if (klass->GetIfTable() != nullptr) {
+    // Conflict tables are created by artInvokeInterfaceTrampoline() as for eagerly linked IMTs.
+    bool new_conflict = false;
+    FillIMTFromIfTable(klass->GetIfTable(),
+                       runtime->GetImtUnimplementedMethod(),
+                       runtime->GetImtConflictMethod(),
+                       klass,
+                       /*create_conflict_tables=*/ false,
+                       /*ignore_copied_methods=*/ false,
+                       &new_conflict,
+                       &imt_data[0]);
+  }
+  LinearAlloc* linear_alloc = GetAllocatorForClassLoader(klass->GetClassLoader());
+  ImTable* imt = reinterpret_cast<ImTable*>(
+      linear_alloc->Alloc(Thread::Current(), ImTable::SizeInBytes(image_pointer_size_)));
+  if (imt == nullptr) {
+    // Keep dispatching through the runtime.
+    LOG(ERROR) << "Failed to allocate IMT for " << klass->PrettyClass();
+    return klass->GetImt(image_pointer_size_);
+  }
+  imt->Populate(imt_data, image_pointer_size_);
+  // Do a fence to ensure threads see the data in the IMT before it is assigned to the class.
+  // Note that there is a race in the presence of multiple threads and we may leak memory
+  // from the LinearAlloc, but that's a tradeoff compared to using atomic operations.
+  std::atomic_thread_fence(std::memory_order_release);
+  klass->SetImt(imt, image_pointer_size_);
+  return imt;
+}
+
 ImtConflictTable* ClassLinker::CreateImtConflictTable(size_t count,
                                                       LinearAlloc* linear_alloc,
                                                       PointerSize image_pointer_size) {
@@ -7108,9 +7241,7 @@ void ClassLinker::FillIMTFromIfTable(ObjPtr<mirror::IfTable> if_table,
           continue;
         }
         ImtConflictTable* table = imt[imt_index]->GetImtConflictTable(image_pointer_size_);
-        const size_t num_entries = table->NumEntries(image_pointer_size_);
-        table->SetInterfaceMethod(num_entries, image_pointer_size_, interface_method);
-        table->SetImplementationMethod(num_entries, image_pointer_size_, implementation_method);
+        table->AddEntry(interface_method, implementation_method, image_pointer_size_);
       }
     }
   }
@@ -7563,7 +7694,8 @@ void ClassLinker::FillImtFromSuperClass(Handle<mirror::Class> klass,
                                         ArtMethod** imt) {
   DCHECK(klass->HasSuperClass());
   ObjPtr<mirror::Class> super_class = klass->GetSuperClass();
-  if (super_class->ShouldHaveImt()) {
+  // A lazy IMT of the super class holds no information, reconstruct from the iftable instead.
+  if (super_class->ShouldHaveImt() && !IsLazyImt(super_class->GetImt(image_pointer_size_))) {
     ImTable* super_imt = super_class->GetImt(image_pointer_size_);
     for (size_t i = 0; i < ImTable::kSize; ++i) {
       imt[i] = super_imt->Get(i, image_pointer_size_);
@@ -9473,6 +9605,9 @@ void ClassLinker::DumpForSigQuit(std::ostream& os) {
   ReaderMutexLock mu(soa.Self(), *Locks::classlinker_classes_lock_);
   os << "Zygote loaded classes=" << NumZygoteClasses() << " post zygote classes="
      << NumNonZygoteClasses() << "\n";
+  if (mirror::DexCache::kCollectStats) {
+    mirror::DexCache::DumpStats(os);
+  }
   ReaderMutexLock mu2(soa.Self(), *Locks::dex_lock_);
   os << "Dumping registered class loaders\n";
   size_t class_loader_index = 0;
@@ -9516,6 +9651,7 @@ void ClassLinker::DumpForSigQuit(std::ostream& os) {
     }
   }
   os << "Done dumping class loaders\n";
+  DumpClassUnloadingStats(os);
   Runtime* runtime = Runtime::Current();
   os << "Classes initialized: " << runtime->GetStat(KIND_GLOBAL_CLASS_INIT_COUNT) << " in "
      << PrettyDuration(runtime->GetStat(KIND_GLOBAL_CLASS_INIT_TIME)) << "\n";
@@ -9796,6 +9932,15 @@ void ClassLinker::InsertDexFileInToClassLoader(ObjPtr<mirror::Object> dex_file,
   }
 }
 
+class ClassLinker::DeleteClassLoadersTask : public gc::HeapTask {
+ public:
+  explicit DeleteClassLoadersTask(uint64_t target_time) : gc::HeapTask(target_time) {}
+
+  void Run(Thread* self) override {
+    Runtime::Current()->GetClassLinker()->DeletePendingClassLoaders(self);
+  }
+};
+
 void ClassLinker::CleanupClassLoaders() {
   Thread* const self = Thread::Current();
   std::vector<ClassLoaderData> to_delete;
@@ -9816,12 +9961,75 @@ void ClassLinker::CleanupClassLoaders() {
       }
     }
   }
+  if (to_delete.empty()) {
+    return;
+  }
+  // Removing the JIT code and the CHA dependencies must happen before the GC finishes, since the JIT
+  // and CHA may otherwise still reach the unloaded methods. Only freeing the memory is deferred.
+  const uint64_t start_time = NanoTime();
   for (ClassLoaderData& data : to_delete) {
     // CHA unloading analysis and SingleImplementaion cleanups are required.
-    DeleteClassLoader(self, data, /*cleanup_cha=*/ true);
+    UnlinkClassLoader(self, data, /*cleanup_cha=*/ true);
+  }
+  bool add_task;
+  {
+    MutexLock mu(self, pending_class_loaders_lock_);
+    class_loader_unlink_time_ns_ += NanoTime() - start_time;
+    pending_class_loaders_.insert(pending_class_loaders_.end(), to_delete.begin(), to_delete.end());
+    add_task = !delete_class_loaders_task_pending_;
+    delete_class_loaders_task_pending_ = true;
+  }
+  if (add_task) {
+    Runtime* const runtime = Runtime::Current();
+    gc::TaskProcessor* const task_processor = runtime->GetHeap()->GetTaskProcessor();
+    if (runtime->IsFinishedStarting() &&
+        !runtime->IsShuttingDown(self) &&
+        task_processor->IsRunning()) {
+      task_processor->AddTask(self, new DeleteClassLoadersTask(NanoTime()));
+    } else {
+      DeletePendingClassLoaders(self);
+    }
   }
 }
 
+void ClassLinker::DeletePendingClassLoaders(Thread* self) {
+  std::vector<ClassLoaderData> to_delete;
+  {
+    MutexLock mu(self, pending_class_loaders_lock_);
+    to_delete.swap(pending_class_loaders_);
+    delete_class_loaders_task_pending_ = false;
+  }
+  if (to_delete.empty()) {
+    return;
+  }
+  const uint64_t start_time = NanoTime();
+  uint64_t num_classes = 0u;
+  uint64_t linear_alloc_bytes = 0u;
+  for (const ClassLoaderData& data : to_delete) {
+    num_classes +=
+        data.class_table->NumReferencedZygoteClasses() +
+        data.class_table->NumReferencedNonZygoteClasses();
+    linear_alloc_bytes += data.allocator->GetUsedMemory();
+    delete data.allocator;
+    delete data.class_table;
+  }
+  MutexLock mu(self, pending_class_loaders_lock_);
+  num_unloaded_class_loaders_ += to_delete.size();
+  num_unloaded_classes_ += num_classes;
+  unloaded_linear_alloc_bytes_ += linear_alloc_bytes;
+  class_loader_delete_time_ns_ += NanoTime() - start_time;
+}
+
+void ClassLinker::DumpClassUnloadingStats(std::ostream& os) {
+  MutexLock mu(Thread::Current(), pending_class_loaders_lock_);
+  os << "Unloaded class loaders=" << num_unloaded_class_loaders_
+     << " classes=" << num_unloaded_classes_
+     << " linear alloc=" << PrettySize(unloaded_linear_alloc_bytes_)
+     << " pending=" << pending_class_loaders_.size()
+     << " unlink time=" << PrettyDuration(class_loader_unlink_time_ns_)
+     << " delete time=" << PrettyDuration(class_loader_delete_time_ns_) << "\n";
+}
+
 class ClassLinker::FindVirtualMethodHolderVisitor : public ClassVisitor {
  public:
   FindVirtualMethodHolderVisitor(const ArtMethod* method, PointerSize pointer_size)
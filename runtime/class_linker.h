@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_CLASS_LINKER_H_
 #define ART_RUNTIME_CLASS_LINKER_H_
 
+#include <atomic>
 #include <list>
 #include <set>
 #include <string>
@@ -82,6 +83,7 @@ enum class ClassRoot : uint32_t;
 class ClassTable;
 class DexFile;
 template<class T> class Handle;
+class ImTable;
 class ImtConflictTable;
 template<typename T> class LengthPrefixedArray;
 template<class T> class MutableHandle;
@@ -93,6 +95,7 @@ class Runtime;
 class ScopedObjectAccessAlreadyRunnable;
 template<size_t kNumReferences> class PACKED(4) StackHandleScope;
 class Thread;
+class ThreadPool;
 
 enum VisitRootFlags : uint8_t;
 
@@ -147,7 +150,8 @@ class ClassLinker {
   static constexpr bool kAppImageMayContainStrings = true;
 
   explicit ClassLinker(InternTable* intern_table,
-                       bool fast_class_not_found_exceptions = true);
+                       bool fast_class_not_found_exceptions = true,
+                       bool lazy_imt = false);
   virtual ~ClassLinker();
 
   // Initialize class linker by bootstraping from dex files.
@@ -476,10 +480,14 @@ class ClassLinker {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::dex_lock_);
 
-  void VisitClassRoots(RootVisitor* visitor, VisitRootFlags flags)
+  // If `thread_pool` is not null and the class loaders are visited as roots, the class tables are
+  // visited in parallel, one task per class loader. `visitor` must then be thread safe.
+  void VisitClassRoots(RootVisitor* visitor,
+                       VisitRootFlags flags,
+                       ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::classlinker_classes_lock_, !Locks::trace_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
-  void VisitRoots(RootVisitor* visitor, VisitRootFlags flags)
+  void VisitRoots(RootVisitor* visitor, VisitRootFlags flags, ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::dex_lock_, !Locks::classlinker_classes_lock_, !Locks::trace_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
   // Visits all dex-files accessible by any class-loader or the BCP.
@@ -684,11 +692,18 @@ class ClassLinker {
   // entries are roots, but potentially not image classes.
   void DropFindArrayClassCache() REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Clean up class loaders, this needs to happen after JNI weak globals are cleared.
+  // Clean up class loaders, this needs to happen after JNI weak globals are cleared. The memory of
+  // the unloaded class loaders is released later by DeletePendingClassLoaders().
   void CleanupClassLoaders()
-      REQUIRES(!Locks::classlinker_classes_lock_)
+      REQUIRES(!Locks::classlinker_classes_lock_, !pending_class_loaders_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Free the LinearAlloc and class table of the class loaders unloaded by CleanupClassLoaders().
+  // Usually called on the heap task daemon, does not need the mutator lock.
+  void DeletePendingClassLoaders(Thread* self) REQUIRES(!pending_class_loaders_lock_);
+
+  void DumpClassUnloadingStats(std::ostream& os) REQUIRES(!pending_class_loaders_lock_);
+
   // Unlike GetOrCreateAllocatorForClassLoader, GetAllocatorForClassLoader asserts that the
   // allocator for this class loader is already created.
   LinearAlloc* GetAllocatorForClassLoader(ObjPtr<mirror::ClassLoader> class_loader)
@@ -732,6 +747,16 @@ class ClassLinker {
   // Create the IMT and conflict tables for a class.
   void FillIMTAndConflictTables(ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return true if `imt` is the shared IMT of classes whose IMT has not been populated yet.
+  // All its entries are the IMT conflict method, so that the first interface dispatch goes
+  // through artInvokeInterfaceTrampoline() which calls PopulateLazyImt().
+  bool IsLazyImt(ImTable* imt) const {
+    return imt != nullptr && imt == lazy_imt_.load(std::memory_order_relaxed);
+  }
+
+  // Give the class its own IMT in place of the shared lazy IMT and return it.
+  ImTable* PopulateLazyImt(ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Visit all of the class tables. This is used by dex2oat to allow pruning dex caches.
   template <class Visitor>
   void VisitClassTables(const Visitor& visitor)
@@ -841,6 +866,10 @@ class ClassLinker {
     LinearAlloc* allocator;
   };
 
+  void VisitClassLoaderRootsInParallel(Thread* self, RootVisitor* visitor, ThreadPool* thread_pool)
+      REQUIRES(Locks::classlinker_classes_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void VisiblyInitializedCallbackDone(Thread* self, VisiblyInitializedCallback* callback);
   VisiblyInitializedCallback* MarkClassInitialized(Thread* self, Handle<mirror::Class> klass)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -857,6 +886,11 @@ class ClassLinker {
   void DeleteClassLoader(Thread* self, const ClassLoaderData& data, bool cleanup_cha)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Remove everything that may still refer to the methods and classes of the class loader, so that
+  // its memory can be freed later.
+  void UnlinkClassLoader(Thread* self, const ClassLoaderData& data, bool cleanup_cha)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void VisitClassesInternal(ClassVisitor* visitor)
       REQUIRES_SHARED(Locks::classlinker_classes_lock_, Locks::mutator_lock_);
 
@@ -1357,6 +1391,9 @@ class ClassLinker {
                           /*out*/bool* new_conflict,
                           /*out*/ArtMethod** imt) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return the shared lazy IMT, allocating it if needed. Returns null on allocation failure.
+  ImTable* GetOrCreateLazyImt(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
+
   void FillImtFromSuperClass(Handle<mirror::Class> klass,
                              ArtMethod* unimplemented_method,
                              ArtMethod* imt_conflict_method,
@@ -1424,6 +1461,10 @@ class ClassLinker {
 
   const bool fast_class_not_found_exceptions_;
 
+  // Whether classes linked after initialization get the shared lazy IMT instead of their own.
+  const bool lazy_imt_enabled_;
+  std::atomic<ImTable*> lazy_imt_;
+
   // Trampolines within the image the bounce to runtime entrypoints. Done so that there is a single
   // patch point within the image. TODO: make these proper relocations.
   const void* jni_dlsym_lookup_trampoline_;
@@ -1445,6 +1486,20 @@ class ClassLinker {
 
   std::unique_ptr<ClassHierarchyAnalysis> cha_;
 
+  // Class loaders unlinked by CleanupClassLoaders() whose memory has not been freed yet.
+  Mutex pending_class_loaders_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<ClassLoaderData> pending_class_loaders_ GUARDED_BY(pending_class_loaders_lock_);
+  // Whether a DeleteClassLoadersTask is queued on the heap task processor.
+  bool delete_class_loaders_task_pending_ GUARDED_BY(pending_class_loaders_lock_);
+
+  // Class unloading statistics.
+  uint64_t num_unloaded_class_loaders_ GUARDED_BY(pending_class_loaders_lock_);
+  uint64_t num_unloaded_classes_ GUARDED_BY(pending_class_loaders_lock_);
+  uint64_t unloaded_linear_alloc_bytes_ GUARDED_BY(pending_class_loaders_lock_);
+  uint64_t class_loader_unlink_time_ns_ GUARDED_BY(pending_class_loaders_lock_);
+  uint64_t class_loader_delete_time_ns_ GUARDED_BY(pending_class_loaders_lock_);
+
+  class DeleteClassLoadersTask;
   class FindVirtualMethodHolderVisitor;
 
   friend class AppImageLoadingHelper;
@@ -22,15 +22,43 @@
 
 namespace art {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock), lookup_list_(nullptr) {
   Runtime* const runtime = Runtime::Current();
-  classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
-                              runtime->GetHashTableMaxLoadFactor()));
+  WriterMutexLock mu(Thread::Current(), lock_);
+  classes_.push_back(std::make_unique<ClassSet>(runtime->GetHashTableMinLoadFactor(),
+                                                runtime->GetHashTableMaxLoadFactor()));
+  PublishLookupListLocked();
 }
 
 void ClassTable::FreezeSnapshot() {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.push_back(ClassSet());
+  if (classes_.size() > 1u) {
+    size_t num_classes = 0u;
+    for (const std::unique_ptr<ClassSet>& class_set : classes_) {
+      num_classes += class_set->size();
+    }
+    Runtime* const runtime = Runtime::Current();
+    std::unique_ptr<ClassSet> combined = std::make_unique<ClassSet>(
+        runtime->GetHashTableMinLoadFactor(), runtime->GetHashTableMaxLoadFactor());
+    combined->reserve(num_classes);
+    for (const std::unique_ptr<ClassSet>& class_set : classes_) {
+      for (const TableSlot& slot : *class_set) {
+        combined->insert(slot);
+      }
+    }
+    // Keep the sets apart if a descriptor is in more than one of them. Lookups must keep
+    // finding the first one and the others must still be visited as roots.
+    if (combined->size() == num_classes) {
+      for (std::unique_ptr<ClassSet>& class_set : classes_) {
+        retired_classes_.push_back(std::move(class_set));
+      }
+      classes_.clear();
+      classes_.push_back(std::move(combined));
+    }
+  }
+  classes_.push_back(std::make_unique<ClassSet>());
+  PublishLookupListLocked();
 }
 
 bool ClassTable::Contains(ObjPtr<mirror::Class> klass) {
@@ -38,11 +66,10 @@ bool ClassTable::Contains(ObjPtr<mirror::Class> klass) {
 }
 
 ObjPtr<mirror::Class> ClassTable::LookupByDescriptor(ObjPtr<mirror::Class> klass) {
-  ReaderMutexLock mu(Thread::Current(), lock_);
   TableSlot slot(klass);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.find(slot);
-    if (it != class_set.end()) {
+  for (const ClassSet* class_set : *lookup_list_.load(std::memory_order_acquire)) {
+    auto it = class_set->find(slot);
+    if (it != class_set->end()) {
       return it->Read();
     }
   }
@@ -55,10 +82,10 @@ ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
   WriterMutexLock mu(Thread::Current(), lock_);
   // Should only be updating latest table.
   DescriptorHashPair pair(descriptor, hash);
-  auto existing_it = classes_.back().FindWithHash(pair, hash);
-  if (kIsDebugBuild && existing_it == classes_.back().end()) {
-    for (const ClassSet& class_set : classes_) {
-      if (class_set.FindWithHash(pair, hash) != class_set.end()) {
+  auto existing_it = classes_.back()->FindWithHash(pair, hash);
+  if (kIsDebugBuild && existing_it == classes_.back()->end()) {
+    for (const std::unique_ptr<ClassSet>& class_set : classes_) {
+      if (class_set->FindWithHash(pair, hash) != class_set->end()) {
         LOG(FATAL) << "Updating class found in frozen table " << descriptor;
       }
     }
@@ -91,36 +118,35 @@ size_t ClassTable::NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader)
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
   for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += CountDefiningLoaderClasses(defining_loader, classes_[i]);
+    sum += CountDefiningLoaderClasses(defining_loader, *classes_[i]);
   }
   return sum;
 }
 
 size_t ClassTable::NumNonZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  return CountDefiningLoaderClasses(defining_loader, classes_.back());
+  return CountDefiningLoaderClasses(defining_loader, *classes_.back());
 }
 
 size_t ClassTable::NumReferencedZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
   for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += classes_[i].size();
+    sum += classes_[i]->size();
   }
   return sum;
 }
 
 size_t ClassTable::NumReferencedNonZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  return classes_.back().size();
+  return classes_.back()->size();
 }
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
-  ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.FindWithHash(pair, hash);
-    if (it != class_set.end()) {
+  for (const ClassSet* class_set : *lookup_list_.load(std::memory_order_acquire)) {
+    auto it = class_set->FindWithHash(pair, hash);
+    if (it != class_set->end()) {
       return it->Read();
     }
   }
@@ -130,52 +156,85 @@ ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
 ObjPtr<mirror::Class> ClassTable::TryInsert(ObjPtr<mirror::Class> klass) {
   TableSlot slot(klass);
   WriterMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.find(slot);
-    if (it != class_set.end()) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    auto it = class_set->find(slot);
+    if (it != class_set->end()) {
       return it->Read();
     }
   }
-  classes_.back().insert(slot);
+  EnsureCapacityLocked();
+  classes_.back()->insert(slot);
   return klass;
 }
 
 void ClassTable::Insert(ObjPtr<mirror::Class> klass) {
   const uint32_t hash = TableSlot::HashDescriptor(klass);
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  EnsureCapacityLocked();
+  classes_.back()->InsertWithHash(TableSlot(klass, hash), hash);
 }
 
 void ClassTable::CopyWithoutLocks(const ClassTable& source_table) {
   if (kIsDebugBuild) {
-    for (ClassSet& class_set : classes_) {
-      CHECK(class_set.empty());
+    for (std::unique_ptr<ClassSet>& class_set : classes_) {
+      CHECK(class_set->empty());
     }
   }
-  for (const ClassSet& class_set : source_table.classes_) {
-    for (const TableSlot& slot : class_set) {
-      classes_.back().insert(slot);
+  for (const std::unique_ptr<ClassSet>& class_set : source_table.classes_) {
+    for (const TableSlot& slot : *class_set) {
+      EnsureCapacityLocked();
+      classes_.back()->insert(slot);
     }
   }
 }
 
 void ClassTable::InsertWithoutLocks(ObjPtr<mirror::Class> klass) {
   const uint32_t hash = TableSlot::HashDescriptor(klass);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  EnsureCapacityLocked();
+  classes_.back()->InsertWithHash(TableSlot(klass, hash), hash);
 }
 
 void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  EnsureCapacityLocked();
+  classes_.back()->InsertWithHash(TableSlot(klass, hash), hash);
+}
+
+void ClassTable::EnsureCapacityLocked() {
+  const ClassSet& old_set = *classes_.back();
+  if (old_set.size() < old_set.ElementsUntilExpand()) {
+    return;
+  }
+  // Grow as ClassSet::Expand() would, but into a new set, since lookups may be probing the old one.
+  std::unique_ptr<ClassSet> new_set =
+      std::make_unique<ClassSet>(old_set.GetMinLoadFactor(), old_set.GetMaxLoadFactor());
+  new_set->reserve(static_cast<size_t>(
+      old_set.size() * old_set.GetMaxLoadFactor() / old_set.GetMinLoadFactor()) + 1u);
+  for (const TableSlot& slot : old_set) {
+    new_set->insert(slot);
+  }
+  retired_classes_.push_back(std::move(classes_.back()));
+  classes_.back() = std::move(new_set);
+  PublishLookupListLocked();
+}
+
+void ClassTable::PublishLookupListLocked() {
+  std::unique_ptr<LookupList> lookup_list = std::make_unique<LookupList>();
+  lookup_list->reserve(classes_.size());
+  for (const std::unique_ptr<ClassSet>& class_set : classes_) {
+    lookup_list->push_back(class_set.get());
+  }
+  lookup_list_.store(lookup_list.get(), std::memory_order_release);
+  lookup_lists_.push_back(std::move(lookup_list));
 }
 
 bool ClassTable::Remove(const char* descriptor) {
   DescriptorHashPair pair(descriptor, ComputeModifiedUtf8Hash(descriptor));
   WriterMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.find(pair);
-    if (it != class_set.end()) {
-      class_set.erase(it);
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    auto it = class_set->find(pair);
+    if (it != class_set->end()) {
+      class_set->erase(it);
       return true;
     }
   }
@@ -260,8 +319,8 @@ size_t ClassTable::WriteToMemory(uint8_t* ptr) const {
   ClassSet combined;
   // Combine all the class sets in case there are multiple, also adjusts load factor back to
   // default in case classes were pruned.
-  for (const ClassSet& class_set : classes_) {
-    for (const TableSlot& root : class_set) {
+  for (const std::unique_ptr<ClassSet>& class_set : classes_) {
+    for (const TableSlot& root : *class_set) {
       combined.insert(root);
     }
   }
@@ -283,7 +342,8 @@ size_t ClassTable::ReadFromMemory(uint8_t* ptr) {
 
 void ClassTable::AddClassSet(ClassSet&& set) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.insert(classes_.begin(), std::move(set));
+  classes_.insert(classes_.begin(), std::make_unique<ClassSet>(std::move(set)));
+  PublishLookupListLocked();
 }
 
 void ClassTable::ClearStrongRoots() {
@@ -17,11 +17,13 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/hash_set.h"
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -59,8 +61,9 @@ class ClassTable {
 
     TableSlot(ObjPtr<mirror::Class> klass, uint32_t descriptor_hash);
 
+    // Release ordering publishes the class to lookups that do not hold the table lock.
     TableSlot& operator=(const TableSlot& copy) {
-      data_.store(copy.data_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      data_.store(copy.data_.load(std::memory_order_relaxed), std::memory_order_release);
       return *this;
     }
 
@@ -140,11 +143,11 @@ class ClassTable {
 
   // Used by image writer for checking.
   bool Contains(ObjPtr<mirror::Class> klass)
-      REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Freeze the current class tables by allocating a new table and never updating or modifying the
   // existing table. This helps prevents dirty pages after caused by inserting after zygote fork.
+  // The frozen tables are combined into one, so that lookups probe at most two tables.
   void FreezeSnapshot()
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -200,13 +203,13 @@ class ClassTable {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Return the first class that matches the descriptor. Returns null if there are none.
+  // Does not take the lock, see `lookup_list_`.
   ObjPtr<mirror::Class> Lookup(const char* descriptor, size_t hash)
-      REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Return the first class that matches the descriptor of klass. Returns null if there are none.
+  // Does not take the lock, see `lookup_list_`.
   ObjPtr<mirror::Class> LookupByDescriptor(ObjPtr<mirror::Class> klass)
-      REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try to insert a class and return the inserted class if successful. If another class
@@ -223,7 +226,8 @@ class ClassTable {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Returns true if the class was found and removed, false otherwise.
+  // Returns true if the class was found and removed, false otherwise. The class is removed in
+  // place, so this must not race with lookups; it is only used by the image writer.
   bool Remove(const char* descriptor)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -269,10 +273,22 @@ class ClassTable {
   }
 
  private:
+  // The class sets probed by lookups that do not hold `lock_`.
+  using LookupList = std::vector<const ClassSet*>;
+
   // Only copies classes.
   void CopyWithoutLocks(const ClassTable& source_table) NO_THREAD_SAFETY_ANALYSIS;
   void InsertWithoutLocks(ObjPtr<mirror::Class> klass) NO_THREAD_SAFETY_ANALYSIS;
 
+  // Make sure that the latest class set can take one more class without being resized in place,
+  // by replacing a full set with a larger copy.
+  void EnsureCapacityLocked()
+      REQUIRES(lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Publish the current `classes_` to lookups.
+  void PublishLookupListLocked() REQUIRES(lock_);
+
   size_t CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defining_loader,
                                     const ClassSet& set) const
       REQUIRES(lock_)
@@ -286,7 +302,17 @@ class ClassTable {
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
   // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
-  std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // Classes are only inserted into the last set.
+  std::vector<std::unique_ptr<ClassSet>> classes_ GUARDED_BY(lock_);
+  // The sets of `classes_` for lookups, replaced with release semantics whenever a set is added
+  // or replaced. A published list never changes, and the sets it refers to are not resized, so
+  // lookups can probe them without holding `lock_`.
+  Atomic<const LookupList*> lookup_list_;
+  // Every list published in `lookup_list_` and the sets replaced in `classes_`. A lookup may still
+  // be probing them, so they are only freed with the table. Since a full set is replaced with one
+  // twice as large, the replaced sets take at most as much memory as the current ones.
+  std::vector<std::unique_ptr<LookupList>> lookup_lists_ GUARDED_BY(lock_);
+  std::vector<std::unique_ptr<ClassSet>> retired_classes_ GUARDED_BY(lock_);
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
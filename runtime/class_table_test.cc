@@ -159,5 +159,36 @@ TEST_F(ClassTableTest, ClassTable) {
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
+TEST_F(ClassTableTest, FreezeSnapshotCombinesSets) {
+  ScopedObjectAccess soa(Thread::Current());
+  jobject jclass_loader = LoadDex("XandY");
+  VariableSizedHandleScope hs(soa.Self());
+  Handle<ClassLoader> class_loader(hs.NewHandle(soa.Decode<ClassLoader>(jclass_loader)));
+  Handle<mirror::Class> h_X(
+      hs.NewHandle(class_linker_->FindClass(soa.Self(), "LX;", class_loader)));
+  Handle<mirror::Class> h_Y(
+      hs.NewHandle(class_linker_->FindClass(soa.Self(), "LY;", class_loader)));
+  ClassTable table;
+  table.Insert(h_X.Get());
+  table.FreezeSnapshot();
+  table.Insert(h_Y.Get());
+  table.FreezeSnapshot();
+  EXPECT_EQ(table.NumZygoteClasses(class_loader.Get()), 2u);
+  EXPECT_EQ(table.NumNonZygoteClasses(class_loader.Get()), 0u);
+  EXPECT_TRUE(table.Contains(h_X.Get()));
+  EXPECT_TRUE(table.Contains(h_Y.Get()));
+
+  // A class set added in front, like the one of an app image, is combined as well.
+  const size_t count = table.WriteToMemory(nullptr);
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[count]());
+  ASSERT_EQ(table.WriteToMemory(&buffer[0]), count);
+  ClassTable table2;
+  table2.ReadFromMemory(&buffer[0]);
+  table2.FreezeSnapshot();
+  EXPECT_EQ(table2.NumZygoteClasses(class_loader.Get()), 2u);
+  EXPECT_TRUE(table2.Contains(h_X.Get()));
+  EXPECT_TRUE(table2.Contains(h_Y.Get()));
+}
+
 }  // namespace mirror
 }  // namespace art
@@ -32,6 +32,7 @@ bool CompilerFilter::IsAotCompilationEnabled(Filter filter) {
     case CompilerFilter::kSpaceProfile:
     case CompilerFilter::kSpace:
     case CompilerFilter::kSpeedProfile:
+    case CompilerFilter::kSpeedProfileBaseline:
     case CompilerFilter::kSpeed:
     case CompilerFilter::kEverythingProfile:
     case CompilerFilter::kEverything: return true;
@@ -49,6 +50,7 @@ bool CompilerFilter::IsJniCompilationEnabled(Filter filter) {
     case CompilerFilter::kSpaceProfile:
     case CompilerFilter::kSpace:
     case CompilerFilter::kSpeedProfile:
+    case CompilerFilter::kSpeedProfileBaseline:
     case CompilerFilter::kSpeed:
     case CompilerFilter::kEverythingProfile:
     case CompilerFilter::kEverything: return true;
@@ -66,6 +68,7 @@ bool CompilerFilter::IsQuickeningCompilationEnabled(Filter filter) {
     case CompilerFilter::kSpaceProfile:
     case CompilerFilter::kSpace:
     case CompilerFilter::kSpeedProfile:
+    case CompilerFilter::kSpeedProfileBaseline:
     case CompilerFilter::kSpeed:
     case CompilerFilter::kEverythingProfile:
     case CompilerFilter::kEverything: return true;
@@ -89,6 +92,7 @@ bool CompilerFilter::IsVerificationEnabled(Filter filter) {
     case CompilerFilter::kSpaceProfile:
     case CompilerFilter::kSpace:
     case CompilerFilter::kSpeedProfile:
+    case CompilerFilter::kSpeedProfileBaseline:
     case CompilerFilter::kSpeed:
     case CompilerFilter::kEverythingProfile:
     case CompilerFilter::kEverything: return true;
@@ -114,6 +118,7 @@ bool CompilerFilter::DependsOnProfile(Filter filter) {
 
     case CompilerFilter::kSpaceProfile:
     case CompilerFilter::kSpeedProfile:
+    case CompilerFilter::kSpeedProfileBaseline:
     case CompilerFilter::kEverythingProfile: return true;
   }
   UNREACHABLE();
@@ -134,6 +139,7 @@ CompilerFilter::Filter CompilerFilter::GetNonProfileDependentFilterFrom(Filter f
       return CompilerFilter::kSpace;
 
     case CompilerFilter::kSpeedProfile:
+    case CompilerFilter::kSpeedProfileBaseline:
       return CompilerFilter::kSpeed;
 
     case CompilerFilter::kEverythingProfile:
@@ -157,6 +163,7 @@ CompilerFilter::Filter CompilerFilter::GetSafeModeFilterFrom(Filter filter) {
     case CompilerFilter::kEverything:
     case CompilerFilter::kSpaceProfile:
     case CompilerFilter::kSpeedProfile:
+    case CompilerFilter::kSpeedProfileBaseline:
     case CompilerFilter::kEverythingProfile:
       return CompilerFilter::kQuicken;
   }
@@ -180,6 +187,7 @@ std::string CompilerFilter::NameOfFilter(Filter filter) {
     case CompilerFilter::kSpaceProfile: return "space-profile";
     case CompilerFilter::kSpace: return "space";
     case CompilerFilter::kSpeedProfile: return "speed-profile";
+    case CompilerFilter::kSpeedProfileBaseline: return "speed-profile-baseline";
     case CompilerFilter::kSpeed: return "speed";
     case CompilerFilter::kEverythingProfile: return "everything-profile";
     case CompilerFilter::kEverything: return "everything";
@@ -230,6 +238,8 @@ bool CompilerFilter::ParseCompilerFilter(const char* option, Filter* filter) {
     *filter = kSpeed;
   } else if (strcmp(option, "speed-profile") == 0) {
     *filter = kSpeedProfile;
+  } else if (strcmp(option, "speed-profile-baseline") == 0) {
+    *filter = kSpeedProfileBaseline;
   } else if (strcmp(option, "everything") == 0) {
     *filter = kEverything;
   } else if (strcmp(option, "everything-profile") == 0) {
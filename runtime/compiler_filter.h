@@ -30,16 +30,17 @@ class CompilerFilter final {
   // Note: Order here matters. Later filter choices are considered "as good
   // as" earlier filter choices.
   enum Filter {
-    kAssumeVerified,      // Skip verification but mark all classes as verified anyway.
-    kExtract,             // Delay verication to runtime, do not compile anything.
-    kVerify,              // Only verify classes.
-    kQuicken,             // Verify, quicken, and compile JNI stubs.
-    kSpaceProfile,        // Maximize space savings based on profile.
-    kSpace,               // Maximize space savings.
-    kSpeedProfile,        // Maximize runtime performance based on profile.
-    kSpeed,               // Maximize runtime performance.
-    kEverythingProfile,   // Compile everything capable of being compiled based on profile.
-    kEverything,          // Compile everything capable of being compiled.
+    kAssumeVerified,        // Skip verification but mark all classes as verified anyway.
+    kExtract,               // Delay verication to runtime, do not compile anything.
+    kVerify,                // Only verify classes.
+    kQuicken,               // Verify, quicken, and compile JNI stubs.
+    kSpaceProfile,          // Maximize space savings based on profile.
+    kSpace,                 // Maximize space savings.
+    kSpeedProfile,          // Maximize runtime performance based on profile.
+    kSpeedProfileBaseline,  // Like kSpeedProfile, plus baseline code for callees of hot methods.
+    kSpeed,                 // Maximize runtime performance.
+    kEverythingProfile,     // Compile everything capable of being compiled based on profile.
+    kEverything,            // Compile everything capable of being compiled.
   };
 
   static const Filter kDefaultCompilerFilter = kSpeed;
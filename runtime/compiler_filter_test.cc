@@ -47,6 +47,7 @@ TEST(CompilerFilterTest, ParseCompilerFilter) {
   TestCompilerFilterName(CompilerFilter::kSpaceProfile, "space-profile");
   TestCompilerFilterName(CompilerFilter::kSpace, "space");
   TestCompilerFilterName(CompilerFilter::kSpeedProfile, "speed-profile");
+  TestCompilerFilterName(CompilerFilter::kSpeedProfileBaseline, "speed-profile-baseline");
   TestCompilerFilterName(CompilerFilter::kSpeed, "speed");
   TestCompilerFilterName(CompilerFilter::kEverythingProfile, "everything-profile");
   TestCompilerFilterName(CompilerFilter::kEverything, "everything");
@@ -62,6 +63,7 @@ TEST(CompilerFilterTest, SafeModeFilter) {
   TestSafeModeFilter(CompilerFilter::kQuicken, "space-profile");
   TestSafeModeFilter(CompilerFilter::kQuicken, "space");
   TestSafeModeFilter(CompilerFilter::kQuicken, "speed-profile");
+  TestSafeModeFilter(CompilerFilter::kQuicken, "speed-profile-baseline");
   TestSafeModeFilter(CompilerFilter::kQuicken, "speed");
   TestSafeModeFilter(CompilerFilter::kQuicken, "everything-profile");
   TestSafeModeFilter(CompilerFilter::kQuicken, "everything");
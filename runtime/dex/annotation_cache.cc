@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "annotation_cache.h"
+
+#include "base/casts.h"
+#include "dex/dex_file_annotations.h"
+#include "gc_root-inl.h"
+#include "handle_scope-inl.h"
+#include "mirror/class.h"
+#include "mirror/object_array-alloc-inl.h"
+#include "mirror/object_array-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+ObjPtr<mirror::ObjectArray<mirror::Object>> AnnotationCache::Lookup(
+    ObjPtr<mirror::Class> klass) {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, allow_disallow_lock_);
+  Wait(self);
+  auto it = map_.find(klass.Ptr());
+  return (it != map_.end()) ? it->second.Read() : nullptr;
+}
+
+ObjPtr<mirror::ObjectArray<mirror::Object>> AnnotationCache::GetAnnotationsForClass(
+    Handle<mirror::Class> klass) {
+  Thread* self = Thread::Current();
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::ObjectArray<mirror::Object>> annotations(hs.NewHandle(Lookup(klass.Get())));
+  if (annotations == nullptr) {
+    // Decode without holding the lock, this allocates and may run class initializers.
+    annotations.Assign(annotations::GetAnnotationsForClass(klass));
+    if (annotations == nullptr) {
+      return nullptr;
+    }
+    MutexLock mu(self, allow_disallow_lock_);
+    Wait(self);
+    if (map_.size() >= kMaxEntries) {
+      map_.clear();
+    }
+    map_[klass.Get().Ptr()] = GcRoot<mirror::ObjectArray<mirror::Object>>(annotations.Get());
+  }
+  // Return a copy, as the caller may modify the array.
+  return mirror::ObjectArray<mirror::Object>::CopyOf(annotations, self, annotations->GetLength());
+}
+
+void AnnotationCache::Clear() {
+  MutexLock mu(Thread::Current(), allow_disallow_lock_);
+  map_.clear();
+}
+
+void AnnotationCache::Sweep(IsMarkedVisitor* visitor) {
+  MutexLock mu(Thread::Current(), allow_disallow_lock_);
+  std::unordered_map<mirror::Class*, GcRoot<mirror::ObjectArray<mirror::Object>>> swept;
+  for (auto& entry : map_) {
+    mirror::Object* klass = visitor->IsMarked(entry.first);
+    mirror::Object* annotations = visitor->IsMarked(entry.second.Read<kWithoutReadBarrier>());
+    if (klass != nullptr && annotations != nullptr) {
+      swept[down_cast<mirror::Class*>(klass)] = GcRoot<mirror::ObjectArray<mirror::Object>>(
+          down_cast<mirror::ObjectArray<mirror::Object>*>(annotations));
+    }
+  }
+  map_.swap(swept);
+}
+
+}  // namespace art
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_DEX_ANNOTATION_CACHE_H_
+#define ART_RUNTIME_DEX_ANNOTATION_CACHE_H_
+
+#include <unordered_map>
+
+#include "base/locks.h"
+#include "gc/system_weak.h"
+#include "gc_root.h"
+#include "handle.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+namespace mirror {
+class Class;
+class Object;
+template<class T> class ObjectArray;
+}  // namespace mirror
+
+// Cache of the runtime-visible annotations of classes, as returned by
+// annotations::GetAnnotationsForClass(). Decoding the annotation set and creating the
+// annotation instances is expensive, and libraries processing annotations at runtime ask
+// for the annotations of the same classes many times.
+//
+// Both the classes and the cached arrays are weak: an entry only lives until the next GC
+// unless something else keeps its array alive. Callers must not hand out the cached array
+// itself, as arrays are mutable; the annotation instances are immutable and can be shared.
+class AnnotationCache : public gc::SystemWeakHolder {
+ public:
+  // Upper bound on the number of entries. The cache is cleared when it is full.
+  static constexpr size_t kMaxEntries = 1024;
+
+  AnnotationCache() : gc::SystemWeakHolder(kAnnotationCacheLock) {}
+
+  // Returns the annotations of `klass`, decoding and caching them on a miss.
+  ObjPtr<mirror::ObjectArray<mirror::Object>> GetAnnotationsForClass(Handle<mirror::Class> klass)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // Returns the cached annotations of `klass`, or null if they are not cached.
+  ObjPtr<mirror::ObjectArray<mirror::Object>> Lookup(ObjPtr<mirror::Class> klass)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // Remove all entries, e.g. because classes have been redefined.
+  void Clear() REQUIRES(!allow_disallow_lock_);
+
+  void Sweep(IsMarkedVisitor* visitor) override
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+ private:
+  std::unordered_map<mirror::Class*, GcRoot<mirror::ObjectArray<mirror::Object>>> map_
+      GUARDED_BY(allow_disallow_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(AnnotationCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_DEX_ANNOTATION_CACHE_H_
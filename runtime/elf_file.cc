@@ -115,22 +115,16 @@ bool ElfFileImpl<ElfTypes>::Setup(File* file,
   }
 
   if (program_header_only_) {
-    // first just map ELF header to get program header size information
-    size_t elf_header_size = sizeof(Elf_Ehdr);
-    if (!SetMap(file,
-                MemMap::MapFile(elf_header_size,
-                                prot,
-                                flags,
-                                file->Fd(),
-                                0,
-                                low_4gb,
-                                file->GetPath().c_str(),
-                                error_msg),
-                error_msg)) {
+    // First just read the ELF header to get program header size information, then map the
+    // ELF header and the program headers at once.
+    Elf_Ehdr elf_header;
+    if (!file->PreadFully(&elf_header, sizeof(elf_header), /*offset=*/ 0)) {
+      *error_msg = StringPrintf("Failed to read ELF header of '%s': %s",
+                                file->GetPath().c_str(), strerror(errno));
       return false;
     }
-    // then remap to cover program header
-    size_t program_header_size = header_->e_phoff + (header_->e_phentsize * header_->e_phnum);
+    size_t program_header_size =
+        elf_header.e_phoff + (elf_header.e_phentsize * elf_header.e_phnum);
     if (file_length < program_header_size) {
       *error_msg = StringPrintf("File size of %zd bytes not large enough to contain ELF program "
                                 "header of %zd bytes: '%s'", file_length,
@@ -1109,6 +1103,15 @@ bool ElfFileImpl<ElfTypes>::Load(File* file,
     }
   }
 
+  int64_t temp_file_length = file->GetLength();
+  if (temp_file_length < 0) {
+    errno = -temp_file_length;
+    *error_msg = StringPrintf("Failed to get length of file: '%s' fd=%d: %s",
+                              file->GetPath().c_str(), file->Fd(), strerror(errno));
+    return false;
+  }
+  size_t file_length = static_cast<size_t>(temp_file_length);
+
   bool reserved = false;
   for (Elf_Word i = 0; i < GetProgramHeaderNum(); i++) {
     Elf_Phdr* program_header = GetProgramHeader(i);
@@ -1133,14 +1136,6 @@ bool ElfFileImpl<ElfTypes>::Load(File* file,
     // non-zero, the segments require the specific address specified,
     // which either was specified in the file because we already set
     // base_address_ after the first zero segment).
-    int64_t temp_file_length = file->GetLength();
-    if (temp_file_length < 0) {
-      errno = -temp_file_length;
-      *error_msg = StringPrintf("Failed to get length of file: '%s' fd=%d: %s",
-                                file->GetPath().c_str(), file->Fd(), strerror(errno));
-      return false;
-    }
-    size_t file_length = static_cast<size_t>(temp_file_length);
     if (!reserved) {
       uint8_t* vaddr_begin;
       size_t vaddr_size;
@@ -34,6 +34,8 @@ namespace art {
 namespace mirror {
 class Array;
 class Class;
+class ClassLoader;
+class DexCache;
 class MethodHandle;
 class MethodType;
 class Object;
@@ -42,6 +44,7 @@ class String;
 
 class ArtField;
 class ArtMethod;
+class DexFile;
 class HandleScope;
 enum InvokeType : uint32_t;
 class OatQuickMethodHeader;
@@ -174,6 +177,15 @@ ObjPtr<mirror::MethodType> ResolveMethodTypeFromCode(ArtMethod* referrer, dex::P
     REQUIRES_SHARED(Locks::mutator_lock_)
     REQUIRES(!Roles::uninterruptible_);
 
+// Fill the empty .bss slots of `dex_file` for types and strings that can be looked up without
+// resolution, i.e. classes already loaded by `class_loader` or its parents and strings already
+// interned, such as those in the app image. This spares the compiled code the slow path calls
+// that would otherwise fill them on first use. Returns the number of slots filled.
+size_t FillBssEntriesFromLookups(const DexFile& dex_file,
+                                 ObjPtr<mirror::DexCache> dex_cache,
+                                 ObjPtr<mirror::ClassLoader> class_loader)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
 void CheckReferenceResult(Handle<mirror::Object> o, Thread* self)
     REQUIRES_SHARED(Locks::mutator_lock_)
     REQUIRES(!Roles::uninterruptible_);
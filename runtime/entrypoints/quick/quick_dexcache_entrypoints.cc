@@ -14,8 +14,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "base/callee_save_type.h"
+#include "base/length_prefixed_array.h"
 #include "callee_save_frame.h"
 #include "class_linker-inl.h"
 #include "class_table-inl.h"
@@ -23,6 +26,7 @@
 #include "dex/dex_file_types.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "gc/heap.h"
+#include "index_bss_mapping.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "mirror/object-inl.h"
@@ -32,7 +36,8 @@
 
 namespace art {
 
-static void StoreObjectInBss(ArtMethod* outer_method,
+// Returns whether the slot was filled by this call.
+static bool StoreObjectInBss(ObjPtr<mirror::ClassLoader> class_loader,
                              const OatFile* oat_file,
                              size_t bss_offset,
                              ObjPtr<mirror::Object> object) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -45,7 +50,7 @@ static void StoreObjectInBss(ArtMethod* outer_method,
     // There are situations where we execute bytecode tied to an oat file opened
     // as non-executable (i.e. the AOT-compiled code cannot be executed) and we
     // can JIT that bytecode and get here without the .bss being mmapped.
-    return;
+    return false;
   }
   GcRoot<mirror::Object>* slot = reinterpret_cast<GcRoot<mirror::Object>*>(
       const_cast<uint8_t*>(oat_file->BssBegin() + bss_offset));
@@ -58,7 +63,6 @@ static void StoreObjectInBss(ArtMethod* outer_method,
     static_assert(sizeof(*slot) == sizeof(*atomic_slot), "Size check");
     atomic_slot->store(GcRoot<mirror::Object>(object), std::memory_order_release);
     // We need a write barrier for the class loader that holds the GC roots in the .bss.
-    ObjPtr<mirror::ClassLoader> class_loader = outer_method->GetClassLoader();
     Runtime* runtime = Runtime::Current();
     if (kIsDebugBuild) {
       ClassTable* class_table = runtime->GetClassLinker()->ClassTableForClassLoader(class_loader);
@@ -71,9 +75,11 @@ static void StoreObjectInBss(ArtMethod* outer_method,
     } else {
       runtime->GetClassLinker()->WriteBarrierForBootOatFileBssRoots(oat_file);
     }
+    return true;
   } else {
     // Each slot serves to store exactly one Class or String.
     DCHECK_EQ(object, slot->Read());
+    return false;
   }
 }
 
@@ -90,7 +96,10 @@ static inline void StoreTypeInBss(ArtMethod* outer_method,
                                                             dex_file->NumTypeIds(),
                                                             sizeof(GcRoot<mirror::Class>));
     if (bss_offset != IndexBssMappingLookup::npos) {
-      StoreObjectInBss(outer_method, oat_dex_file->GetOatFile(), bss_offset, resolved_type);
+      StoreObjectInBss(outer_method->GetClassLoader(),
+                       oat_dex_file->GetOatFile(),
+                       bss_offset,
+                       resolved_type);
     }
   }
 }
@@ -108,11 +117,72 @@ static inline void StoreStringInBss(ArtMethod* outer_method,
                                                             dex_file->NumStringIds(),
                                                             sizeof(GcRoot<mirror::Class>));
     if (bss_offset != IndexBssMappingLookup::npos) {
-      StoreObjectInBss(outer_method, oat_dex_file->GetOatFile(), bss_offset, resolved_string);
+      StoreObjectInBss(outer_method->GetClassLoader(),
+                       oat_dex_file->GetOatFile(),
+                       bss_offset,
+                       resolved_string);
+    }
+  }
+}
+
+// Call `fn(index, bss_offset)` for each index with a slot in the `mapping`.
+template <typename Fn>
+static void VisitBssMapping(const IndexBssMapping* mapping,
+                            uint32_t number_of_indexes,
+                            size_t slot_size,
+                            const Fn& fn) {
+  if (mapping == nullptr) {
+    return;
+  }
+  size_t index_bits = IndexBssMappingEntry::IndexBits(number_of_indexes);
+  size_t mask_bits = 32u - index_bits;
+  for (const IndexBssMappingEntry& entry : *mapping) {
+    uint32_t highest_index = entry.GetIndex(index_bits);
+    uint32_t span = std::min<uint32_t>(mask_bits, highest_index);
+    for (uint32_t index = highest_index - span; index <= highest_index; ++index) {
+      size_t bss_offset = entry.GetBssOffset(index_bits, index, slot_size);
+      if (bss_offset != IndexBssMappingLookup::npos) {
+        fn(index, bss_offset);
+      }
     }
   }
 }
 
+size_t FillBssEntriesFromLookups(const DexFile& dex_file,
+                                 ObjPtr<mirror::DexCache> dex_cache,
+                                 ObjPtr<mirror::ClassLoader> class_loader) {
+  const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+  if (oat_dex_file == nullptr || !oat_dex_file->GetOatFile()->IsExecutable()) {
+    return 0u;
+  }
+  const OatFile* oat_file = oat_dex_file->GetOatFile();
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  size_t filled = 0u;
+  VisitBssMapping(
+      oat_dex_file->GetTypeBssMapping(),
+      dex_file.NumTypeIds(),
+      sizeof(GcRoot<mirror::Class>),
+      [&](uint32_t index, size_t bss_offset) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ObjPtr<mirror::Class> type =
+            class_linker->LookupResolvedType(dex::TypeIndex(index), dex_cache, class_loader);
+        if (type != nullptr && StoreObjectInBss(class_loader, oat_file, bss_offset, type)) {
+          ++filled;
+        }
+      });
+  VisitBssMapping(
+      oat_dex_file->GetStringBssMapping(),
+      dex_file.NumStringIds(),
+      sizeof(GcRoot<mirror::String>),
+      [&](uint32_t index, size_t bss_offset) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ObjPtr<mirror::String> string =
+            class_linker->LookupString(dex::StringIndex(index), dex_cache);
+        if (string != nullptr && StoreObjectInBss(class_loader, oat_file, bss_offset, string)) {
+          ++filled;
+        }
+      });
+  return filled;
+}
+
 static ALWAYS_INLINE bool CanReferenceBss(ArtMethod* outer_method, ArtMethod* caller)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   // .bss references are used only for AOT-compiled code and only when the instruction
@@ -47,31 +47,44 @@ extern void ReadBarrierJni(mirror::CompressedReference<mirror::Object>* handle_o
   handle_on_stack->Assign(to_ref);
 }
 
-// Called on entry to fast JNI, push a new local reference table only.
-extern uint32_t JniMethodFastStart(Thread* self) {
+// Push a new local reference segment. The cookie returned is the previous segment state and
+// is passed back to the JniMethodEnd* entrypoints by the stub.
+ALWAYS_INLINE static inline uint32_t PushLocalReferences(Thread* self) {
   JNIEnvExt* env = self->GetJniEnv();
   DCHECK(env != nullptr);
   uint32_t saved_local_ref_cookie = bit_cast<uint32_t>(env->GetLocalRefCookie());
   env->SetLocalRefCookie(env->GetLocalsSegmentState());
+  return saved_local_ref_cookie;
+}
 
+// Called on entry to fast JNI, push a new local reference table only.
+extern uint32_t JniMethodFastStart(Thread* self) {
   if (kIsDebugBuild) {
     ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
     CHECK(native_method->IsFastNative()) << native_method->PrettyMethod();
   }
-
-  return saved_local_ref_cookie;
+  return PushLocalReferences(self);
 }
 
 // Called on entry to JNI, transition out of Runnable and release share of mutator_lock_.
+// The stubs use this entrypoint only for normal native methods, so there is no need to
+// look at the method to decide whether to do the transition.
 extern uint32_t JniMethodStart(Thread* self) {
-  JNIEnvExt* env = self->GetJniEnv();
-  DCHECK(env != nullptr);
-  uint32_t saved_local_ref_cookie = bit_cast<uint32_t>(env->GetLocalRefCookie());
-  env->SetLocalRefCookie(env->GetLocalsSegmentState());
-  ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
+  if (kIsDebugBuild) {
+    ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
+    CHECK(!native_method->IsFastNative()) << native_method->PrettyMethod();
+  }
+  uint32_t saved_local_ref_cookie = PushLocalReferences(self);
+  self->TransitionFromRunnableToSuspended(kNative);
+  return saved_local_ref_cookie;
+}
+
+extern uint32_t JniMethodStartSynchronized(jobject to_lock, Thread* self) {
+  self->DecodeJObject(to_lock)->MonitorEnter(self);
   // TODO: Introduce special entrypoint for synchronized @FastNative methods?
   //       Or ban synchronized @FastNative outright to avoid the extra check here?
-  DCHECK(!native_method->IsFastNative() || native_method->IsSynchronized());
+  ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
+  uint32_t saved_local_ref_cookie = PushLocalReferences(self);
   if (!native_method->IsFastNative()) {
     // When not fast JNI we transition out of runnable.
     self->TransitionFromRunnableToSuspended(kNative);
@@ -79,11 +92,7 @@ extern uint32_t JniMethodStart(Thread* self) {
   return saved_local_ref_cookie;
 }
 
-extern uint32_t JniMethodStartSynchronized(jobject to_lock, Thread* self) {
-  self->DecodeJObject(to_lock)->MonitorEnter(self);
-  return JniMethodStart(self);
-}
-
+// Used by the synchronized entrypoints which are shared by normal and @FastNative methods.
 // TODO: NO_THREAD_SAFETY_ANALYSIS due to different control paths depending on fast JNI.
 static void GoToRunnable(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
   ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
@@ -95,6 +104,16 @@ static void GoToRunnable(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
   }
 }
 
+// Used by the entrypoints that the stubs call only for normal native methods.
+// NO_THREAD_SAFETY_ANALYSIS as the mutator lock is acquired here.
+ALWAYS_INLINE static inline void GoToRunnableNormal(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
+  if (kIsDebugBuild) {
+    ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
+    CHECK(!native_method->IsFastNative()) << native_method->PrettyMethod();
+  }
+  self->TransitionFromSuspendedToRunnable();
+}
+
 ALWAYS_INLINE static inline void GoToRunnableFast(Thread* self) {
   if (kIsDebugBuild) {
     // Should only enter here if the method is @FastNative.
@@ -150,7 +169,7 @@ static inline void UnlockJniSynchronizedMethod(jobject locked, Thread* self)
 // Otherwise there's just too much repetitive boilerplate.
 
 extern void JniMethodEnd(uint32_t saved_local_ref_cookie, Thread* self) {
-  GoToRunnable(self);
+  GoToRunnableNormal(self);
   PopLocalReferences(saved_local_ref_cookie, self);
 }
 
@@ -199,7 +218,7 @@ extern mirror::Object* JniMethodFastEndWithReference(jobject result,
 extern mirror::Object* JniMethodEndWithReference(jobject result,
                                                  uint32_t saved_local_ref_cookie,
                                                  Thread* self) {
-  GoToRunnable(self);
+  GoToRunnableNormal(self);
   return JniMethodEndWithReferenceHandleResult(result, saved_local_ref_cookie, self);
 }
 
@@ -225,7 +244,7 @@ extern uint64_t GenericJniMethodEnd(Thread* self,
 
   // @Fast and @CriticalNative do not do a state transition.
   if (LIKELY(normal_native)) {
-    GoToRunnable(self);
+    GoToRunnableNormal(self);
   }
   // We need the mutator lock (i.e., calling GoToRunnable()) before accessing the shorty or the
   // locked object.
@@ -2459,6 +2459,11 @@ extern "C" TwoWordReturn artInvokeInterfaceTrampoline(ArtMethod* interface_metho
   CHECK(interface_method->GetDeclaringClass()->IsInterface());
 
   DCHECK(!interface_method->IsRuntimeMethod());
+  // The first interface dispatch on a class with the shared lazy IMT populates its own IMT.
+  ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+  if (UNLIKELY(class_linker->IsLazyImt(imt))) {
+    imt = class_linker->PopulateLazyImt(cls.Get());
+  }
   // Look whether we have a match in the ImtConflictTable.
   uint32_t imt_index = interface_method->GetImtIndex();
   ArtMethod* conflict_method = imt->Get(imt_index, kRuntimePointerSize);
@@ -2493,15 +2498,16 @@ extern "C" TwoWordReturn artInvokeInterfaceTrampoline(ArtMethod* interface_metho
   // We arrive here if we have found an implementation, and it is not in the ImtConflictTable.
   // We create a new table with the new pair { interface_method, method }.
   DCHECK(conflict_method->IsRuntimeMethod());
-  ArtMethod* new_conflict_method = Runtime::Current()->GetClassLinker()->AddMethodToConflictTable(
+  ArtMethod* new_conflict_method = class_linker->AddMethodToConflictTable(
       cls.Get(),
       conflict_method,
       interface_method,
       method,
       /*force_new_conflict_method=*/false);
-  if (new_conflict_method != conflict_method) {
+  if (new_conflict_method != conflict_method && !class_linker->IsLazyImt(imt)) {
     // Update the IMT if we create a new conflict method. No fence needed here, as the
-    // data is consistent.
+    // data is consistent. The shared lazy IMT is only left if populating the IMT failed.
+    // It must not be updated.
     imt->Set(imt_index,
              new_conflict_method,
              kRuntimePointerSize);
@@ -297,6 +297,15 @@ bool FaultManager::IsInGeneratedCode(siginfo_t* siginfo, void* context, bool che
   // are in architecture specific files in arch/<arch>/fault_handler_<arch>.
   GetMethodAndReturnPcAndSp(siginfo, context, &method_obj, &return_pc, &sp, &is_stack_overflow);
 
+  // Implicit checks other than stack overflow checks fault on an address in the null check
+  // range, including suspend checks which load through the null suspend trigger. Any other
+  // fault cannot be claimed by the generated code handlers, so do not bother verifying the
+  // method and looking up the dex pc.
+  if (check_dex_pc && !is_stack_overflow && !NullPointerHandler::IsValidImplicitCheck(siginfo)) {
+    VLOG(signals) << "not an implicit check";
+    return false;
+  }
+
   // If we don't have a potential method, we're outta here.
   VLOG(signals) << "potential method: " << method_obj;
   // TODO: Check linear alloc and image.
@@ -328,6 +337,10 @@ bool FaultManager::IsInGeneratedCode(siginfo_t* siginfo, void* context, bool che
   }
 
   const OatQuickMethodHeader* method_header = method_obj->GetOatQuickMethodHeader(return_pc);
+  if (method_header == nullptr) {
+    VLOG(signals) << "no compiled code";
+    return false;
+  }
 
   // We can be certain that this is a method now.  Check if we have a GC map
   // at the return PC address.
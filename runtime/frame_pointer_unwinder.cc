@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_pointer_unwinder.h"
+
+#include "base/bit_utils.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "oat_file.h"
+#include "oat_file_manager.h"
+#include "runtime.h"
+
+namespace art {
+
+size_t FramePointerUnwinder::Unwind(uintptr_t pc,
+                                    uintptr_t fp,
+                                    uintptr_t stack_low,
+                                    uintptr_t stack_high,
+                                    /*out*/ uintptr_t* pcs,
+                                    size_t max_pcs) {
+  if (max_pcs == 0u || pc == 0u) {
+    return 0u;
+  }
+  size_t num_pcs = 0u;
+  pcs[num_pcs++] = pc;
+  // Frame records are 16-byte aligned and the stack grows down, so each saved frame pointer
+  // must be higher than the frame record holding it. Anything else ends the chain.
+  while (num_pcs != max_pcs &&
+         IsAligned<kFrameRecordSize>(fp) &&
+         fp >= stack_low &&
+         fp < stack_high &&
+         stack_high - fp >= kFrameRecordSize) {
+    const uintptr_t* record = reinterpret_cast<const uintptr_t*>(fp);
+    uintptr_t next_fp = record[0];
+    uintptr_t return_pc = record[1];
+    if (return_pc == 0u) {
+      break;
+    }
+    pcs[num_pcs++] = return_pc;
+    if (next_fp <= fp) {
+      break;
+    }
+    fp = next_fp;
+  }
+  return num_pcs;
+}
+
+bool FramePointerUnwinder::Symbolize(uintptr_t pc, /*out*/ Symbol* symbol) {
+  *symbol = Symbol();
+  Runtime* runtime = Runtime::Current();
+  jit::Jit* jit = runtime->GetJit();
+  if (jit != nullptr) {
+    ArtMethod* method = jit->GetCodeCache()->LookupMethodForPc(pc);
+    if (method != nullptr) {
+      symbol->method = method;
+      return true;
+    }
+  }
+  const void* code = reinterpret_cast<const void*>(pc);
+  const OatFile* oat_file = runtime->GetOatFileManager().FindOpenedOatFileContainingPc(code);
+  if (oat_file != nullptr) {
+    symbol->oat_file = oat_file;
+    symbol->oat_offset = pc - reinterpret_cast<uintptr_t>(oat_file->Begin());
+    return true;
+  }
+  return false;
+}
+
+}  // namespace art
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_FRAME_POINTER_UNWINDER_H_
+#define ART_RUNTIME_FRAME_POINTER_UNWINDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtMethod;
+class OatFile;
+
+// Low overhead unwinder for sampling profilers. It follows the chain of AAPCS64 frame records
+// {saved fp, return address} that code compiled with --generate-frame-pointers keeps in x29,
+// so a sample costs a few loads per frame instead of a StackVisitor walk under the mutator
+// lock or a DWARF unwind.
+//
+// Unwind() only reads the stack being sampled and is safe to call from a signal handler. The
+// chain ends at the first frame without a frame record (an empty frame, a JNI stub, an OSR
+// frame or code compiled without frame pointers), where the unwinder stops. The collected PCs
+// are mapped to methods later, outside of the signal handler, with Symbolize().
+class FramePointerUnwinder {
+ public:
+  struct Symbol {
+    // The JIT compiled method containing the PC, if any.
+    ArtMethod* method = nullptr;
+    // Otherwise, the oat file containing the PC and the offset of the PC from its Begin().
+    const OatFile* oat_file = nullptr;
+    uintptr_t oat_offset = 0u;
+  };
+
+  // Record `pc` and then the return addresses found by following the frame records starting
+  // at `fp`, into `pcs`. Only frame records within [`stack_low`, `stack_high`) are read.
+  // Returns the number of PCs recorded, at most `max_pcs`.
+  static size_t Unwind(uintptr_t pc,
+                       uintptr_t fp,
+                       uintptr_t stack_low,
+                       uintptr_t stack_high,
+                       /*out*/ uintptr_t* pcs,
+                       size_t max_pcs);
+
+  // Map a PC recorded by Unwind() to JIT or AOT compiled code. Returns false if the PC is not
+  // in compiled code known to the runtime. Not signal safe.
+  static bool Symbolize(uintptr_t pc, /*out*/ Symbol* symbol)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  // Size of a frame record, i.e. the saved frame pointer and the return address.
+  static constexpr size_t kFrameRecordSize = 2 * sizeof(uintptr_t);
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(FramePointerUnwinder);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_FRAME_POINTER_UNWINDER_H_
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_pointer_unwinder.h"
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+class FramePointerUnwinderTest : public testing::Test {
+ protected:
+  static constexpr size_t kStackWords = 16;
+
+  uintptr_t Address(size_t index) const {
+    return reinterpret_cast<uintptr_t>(&stack_[index]);
+  }
+
+  // Write a frame record {fp, return pc} at `stack_[index]`.
+  void SetRecord(size_t index, uintptr_t fp, uintptr_t pc) {
+    stack_[index] = fp;
+    stack_[index + 1] = pc;
+  }
+
+  uintptr_t StackLow() const { return Address(0); }
+  uintptr_t StackHigh() const { return Address(kStackWords); }
+
+  alignas(16) uintptr_t stack_[kStackWords] = {};
+};
+
+TEST_F(FramePointerUnwinderTest, FollowsChain) {
+  SetRecord(2, Address(6), 0x1000);
+  SetRecord(6, Address(10), 0x2000);
+  SetRecord(10, 0u, 0x3000);
+  uintptr_t pcs[8];
+  size_t num_pcs =
+      FramePointerUnwinder::Unwind(0x500, Address(2), StackLow(), StackHigh(), pcs, 8);
+  ASSERT_EQ(4u, num_pcs);
+  EXPECT_EQ(0x500u, pcs[0]);
+  EXPECT_EQ(0x1000u, pcs[1]);
+  EXPECT_EQ(0x2000u, pcs[2]);
+  EXPECT_EQ(0x3000u, pcs[3]);
+}
+
+TEST_F(FramePointerUnwinderTest, RespectsMaxPcs) {
+  SetRecord(2, Address(6), 0x1000);
+  SetRecord(6, Address(10), 0x2000);
+  SetRecord(10, 0u, 0x3000);
+  uintptr_t pcs[2];
+  size_t num_pcs =
+      FramePointerUnwinder::Unwind(0x500, Address(2), StackLow(), StackHigh(), pcs, 2);
+  ASSERT_EQ(2u, num_pcs);
+  EXPECT_EQ(0x500u, pcs[0]);
+  EXPECT_EQ(0x1000u, pcs[1]);
+}
+
+TEST_F(FramePointerUnwinderTest, StopsOnBrokenChain) {
+  // A frame pointer going down the stack ends the chain after its return pc.
+  SetRecord(6, Address(2), 0x2000);
+  SetRecord(2, Address(10), 0x1000);
+  uintptr_t pcs[8];
+  size_t num_pcs =
+      FramePointerUnwinder::Unwind(0x500, Address(6), StackLow(), StackHigh(), pcs, 8);
+  ASSERT_EQ(2u, num_pcs);
+  EXPECT_EQ(0x2000u, pcs[1]);
+
+  // A misaligned or out of bounds frame pointer is never dereferenced.
+  num_pcs = FramePointerUnwinder::Unwind(0x500, Address(3), StackLow(), StackHigh(), pcs, 8);
+  EXPECT_EQ(1u, num_pcs);
+  num_pcs = FramePointerUnwinder::Unwind(0x500, StackHigh(), StackLow(), StackHigh(), pcs, 8);
+  EXPECT_EQ(1u, num_pcs);
+
+  // A null return address ends the chain.
+  SetRecord(2, Address(6), 0u);
+  num_pcs = FramePointerUnwinder::Unwind(0x500, Address(2), StackLow(), StackHigh(), pcs, 8);
+  EXPECT_EQ(1u, num_pcs);
+}
+
+}  // namespace art
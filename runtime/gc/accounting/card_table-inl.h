@@ -19,6 +19,12 @@
 
 #include "card_table.h"
 
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <android-base/logging.h>
 
 #include "base/atomic.h"
@@ -51,6 +57,60 @@ static inline bool byte_cas(uint8_t old_value, uint8_t new_value, uint8_t* addre
 #endif
 }
 
+// Cards are skipped a cache line at a time when looking for non-clean cards.
+static constexpr size_t kCardLineSize = 64;
+
+// Returns true if all the kCardLineSize cards at `line` are clean.
+static inline bool IsCleanCardLineScalar(const uint8_t* line) {
+  static_assert(CardTable::kCardClean == 0);
+  const uintptr_t* words = reinterpret_cast<const uintptr_t*>(line);
+  uintptr_t result = 0;
+  for (size_t i = 0; i < kCardLineSize / sizeof(uintptr_t); ++i) {
+    result |= words[i];
+  }
+  return result == 0;
+}
+
+static inline bool IsCleanCardLine(const uint8_t* line) {
+  static_assert(CardTable::kCardClean == 0);
+#if defined(__aarch64__)
+  uint8x16_t result = vorrq_u8(vorrq_u8(vld1q_u8(line), vld1q_u8(line + 16)),
+                               vorrq_u8(vld1q_u8(line + 32), vld1q_u8(line + 48)));
+  return vmaxvq_u8(result) == 0;
+#elif defined(__SSE2__)
+  const __m128i* vectors = reinterpret_cast<const __m128i*>(line);
+  __m128i result = _mm_or_si128(_mm_or_si128(_mm_load_si128(vectors), _mm_load_si128(vectors + 1)),
+                                _mm_or_si128(_mm_load_si128(vectors + 2),
+                                             _mm_load_si128(vectors + 3)));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(result, _mm_setzero_si128())) == 0xFFFF;
+#else
+  return IsCleanCardLineScalar(line);
+#endif
+}
+
+// Returns the first word in [card_cur, card_end) that contains a non-clean card, or card_end if
+// all the cards are clean. Both pointers must be word aligned. Whole cache lines of cards are
+// checked with vector instructions where available.
+template <bool kUseSimd = true>
+static inline uint8_t* SkipCleanCards(uint8_t* card_cur, uint8_t* card_end) {
+  DCHECK_ALIGNED(card_cur, sizeof(uintptr_t));
+  DCHECK_ALIGNED(card_end, sizeof(uintptr_t));
+  while (!IsAligned<kCardLineSize>(card_cur) && card_cur < card_end) {
+    if (*reinterpret_cast<uintptr_t*>(card_cur) != 0) {
+      return card_cur;
+    }
+    card_cur += sizeof(uintptr_t);
+  }
+  while (static_cast<size_t>(card_end - card_cur) >= kCardLineSize &&
+         (kUseSimd ? IsCleanCardLine(card_cur) : IsCleanCardLineScalar(card_cur))) {
+    card_cur += kCardLineSize;
+  }
+  while (card_cur < card_end && *reinterpret_cast<uintptr_t*>(card_cur) == 0) {
+    card_cur += sizeof(uintptr_t);
+  }
+  return card_cur;
+}
+
 template <bool kClearCard, typename Visitor>
 inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
                               uint8_t* const scan_begin,
@@ -83,11 +143,10 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
   uintptr_t* word_end = reinterpret_cast<uintptr_t*>(aligned_end);
   for (uintptr_t* word_cur = reinterpret_cast<uintptr_t*>(card_cur); word_cur < word_end;
       ++word_cur) {
-    while (LIKELY(*word_cur == 0)) {
-      ++word_cur;
-      if (UNLIKELY(word_cur >= word_end)) {
-        goto exit_for;
-      }
+    word_cur = reinterpret_cast<uintptr_t*>(
+        SkipCleanCards(reinterpret_cast<uint8_t*>(word_cur), aligned_end));
+    if (UNLIKELY(word_cur >= word_end)) {
+      break;
     }
 
     // Find the first dirty card.
@@ -107,7 +166,6 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
       start += kCardSize;
     }
   }
-  exit_for:
 
   // Handle any unaligned cards at the end.
   card_cur = reinterpret_cast<uint8_t*>(word_end);
@@ -179,6 +237,11 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
 
   // TODO: Parallelize.
   while (word_cur < word_end) {
+    word_cur = reinterpret_cast<uintptr_t*>(
+        SkipCleanCards(reinterpret_cast<uint8_t*>(word_cur), card_end));
+    if (word_cur >= word_end) {
+      break;
+    }
     while (true) {
       expected_word = *word_cur;
       static_assert(kCardClean == 0);
@@ -19,12 +19,14 @@
 #include <string>
 
 #include "base/atomic.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
 #include "common_runtime_test.h"
 #include "handle_scope-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
 #include "scoped_thread_state_change-inl.h"
+#include "space_bitmap-inl.h"
 #include "thread_pool.h"
 
 namespace art {
@@ -145,7 +147,97 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
-// TODO: Add test for CardTable::Scan.
+class CountingVisitor {
+ public:
+  explicit CountingVisitor(size_t* count) : count_(count) {}
+  void operator()(mirror::Object* /*obj*/) const {
+    ++*count_;
+  }
+
+ private:
+  size_t* const count_;
+};
+
+TEST_F(CardTableTest, TestScan) {
+  CommonSetup();
+  ContinuousSpaceBitmap bitmap(
+      ContinuousSpaceBitmap::Create("test bitmap", HeapBegin(), HeapLimit() - HeapBegin()));
+  // One object at the start of every card.
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize) {
+    bitmap.Set(reinterpret_cast<mirror::Object*>(addr));
+  }
+  // Dirty sparse cards, with some aged ones in between that must be skipped.
+  size_t expected_cards = 0;
+  size_t card_index = 0;
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize) {
+    if (card_index % 97 == 0) {
+      card_table_->MarkCard(addr);
+      ++expected_cards;
+    } else if (card_index % 89 == 0) {
+      *card_table_->CardFromAddr(addr) = CardTable::kCardDirty - 1;
+    }
+    ++card_index;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  WriterMutexLock mu(soa.Self(), *Locks::heap_bitmap_lock_);
+  size_t visited = 0;
+  size_t cards_scanned = card_table_->Scan</*kClearCard=*/ false>(
+      &bitmap, HeapBegin(), HeapLimit(), CountingVisitor(&visited));
+  EXPECT_EQ(cards_scanned, expected_cards);
+  EXPECT_EQ(visited, expected_cards);
+  // Unaligned bounds.
+  visited = 0;
+  uint8_t* scan_begin = HeapBegin() + 3 * CardTable::kCardSize;
+  cards_scanned = card_table_->Scan</*kClearCard=*/ true>(
+      &bitmap, scan_begin, HeapLimit(), CountingVisitor(&visited));
+  EXPECT_EQ(cards_scanned, expected_cards - 1);
+  EXPECT_EQ(visited, expected_cards - 1);
+  for (uint8_t* addr = scan_begin; addr < HeapLimit(); addr += CardTable::kCardSize) {
+    EXPECT_EQ(*card_table_->CardFromAddr(addr), CardTable::kCardClean);
+  }
+}
+
+// Compares the vectorized search for non-clean cards with the scalar one, and logs how long each
+// takes on a mostly clean card table.
+TEST_F(CardTableTest, BenchmarkSkipCleanCards) {
+  CommonSetup();
+  uint8_t* card_begin = card_table_->CardFromAddr(HeapBegin());
+  uint8_t* card_end = card_table_->CardFromAddr(HeapLimit());
+  ASSERT_TRUE(IsAligned<kCardLineSize>(card_begin));
+  size_t card_index = 0;
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize) {
+    if (card_index % 4099 == 0) {
+      card_table_->MarkCard(addr);
+    }
+    ++card_index;
+  }
+  static constexpr size_t kIterations = 1000;
+  auto count_non_clean_words = [&](auto skip) {
+    size_t count = 0;
+    for (uint8_t* cur = skip(card_begin, card_end); cur < card_end; cur = skip(cur, card_end)) {
+      ++count;
+      cur += sizeof(uintptr_t);
+    }
+    return count;
+  };
+  uint64_t start = NanoTime();
+  size_t scalar_count = 0;
+  for (size_t i = 0; i < kIterations; ++i) {
+    scalar_count += count_non_clean_words(SkipCleanCards</*kUseSimd=*/ false>);
+  }
+  const uint64_t scalar_time = NanoTime() - start;
+  start = NanoTime();
+  size_t simd_count = 0;
+  for (size_t i = 0; i < kIterations; ++i) {
+    simd_count += count_non_clean_words(SkipCleanCards</*kUseSimd=*/ true>);
+  }
+  const uint64_t simd_time = NanoTime() - start;
+  EXPECT_EQ(scalar_count, simd_count);
+  EXPECT_EQ(scalar_count, kIterations * RoundUp(card_index, 4099) / 4099);
+  LOG(INFO) << "Skipping " << card_end - card_begin << " cards " << kIterations << " times: "
+            << "scalar " << PrettyDuration(scalar_time) << ", vector " << PrettyDuration(simd_time);
+}
+
 }  // namespace accounting
 }  // namespace gc
 }  // namespace art
@@ -26,10 +26,113 @@
 #include "base/atomic.h"
 #include "base/bit_utils.h"
 
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace art {
 namespace gc {
 namespace accounting {
 
+// Bitmap words are skipped a cache line at a time when looking for set bits.
+static constexpr size_t kBitmapLineSize = 64;
+static constexpr size_t kBitmapWordsPerLine = kBitmapLineSize / sizeof(uintptr_t);
+
+// Returns true if no bit is set in the kBitmapLineSize bytes of bitmap words at `words`. If
+// kClearMarked, the bits also set in the corresponding `mark` words are ignored, i.e. this checks
+// that the line has no garbage.
+template <bool kUseSimd, bool kClearMarked>
+static inline bool IsEmptyBitmapLine(const Atomic<uintptr_t>* words,
+                                     const Atomic<uintptr_t>* mark) {
+  if (kUseSimd) {
+#if defined(__aarch64__)
+    const uint64_t* w = reinterpret_cast<const uint64_t*>(words);
+    const uint64_t* m = reinterpret_cast<const uint64_t*>(mark);
+    uint64x2_t result = vdupq_n_u64(0);
+    for (size_t i = 0; i < kBitmapLineSize / sizeof(uint64x2_t); ++i) {
+      uint64x2_t v = vld1q_u64(w + 2 * i);
+      if (kClearMarked) {
+        v = vbicq_u64(v, vld1q_u64(m + 2 * i));
+      }
+      result = vorrq_u64(result, v);
+    }
+    return vmaxvq_u32(vreinterpretq_u32_u64(result)) == 0;
+#elif defined(__SSE2__)
+    const __m128i* w = reinterpret_cast<const __m128i*>(words);
+    const __m128i* m = reinterpret_cast<const __m128i*>(mark);
+    __m128i result = _mm_setzero_si128();
+    for (size_t i = 0; i < kBitmapLineSize / sizeof(__m128i); ++i) {
+      __m128i v = _mm_load_si128(w + i);
+      if (kClearMarked) {
+        // The mark bitmap may not have the same alignment as the live bitmap.
+        v = _mm_andnot_si128(_mm_loadu_si128(m + i), v);
+      }
+      result = _mm_or_si128(result, v);
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(result, _mm_setzero_si128())) == 0xFFFF;
+#endif
+  }
+  uintptr_t result = 0;
+  for (size_t i = 0; i < kBitmapWordsPerLine; ++i) {
+    uintptr_t w = words[i].load(std::memory_order_relaxed);
+    if (kClearMarked) {
+      w &= ~mark[i].load(std::memory_order_relaxed);
+    }
+    result |= w;
+  }
+  return result == 0;
+}
+
+template <bool kUseSimd, bool kClearMarked>
+static inline size_t FindNextBitmapWord(const Atomic<uintptr_t>* words,
+                                        const Atomic<uintptr_t>* mark,
+                                        size_t begin,
+                                        size_t end) {
+  auto word = [=](size_t i) {
+    uintptr_t w = words[i].load(std::memory_order_relaxed);
+    return kClearMarked ? (w & ~mark[i].load(std::memory_order_relaxed)) : w;
+  };
+  size_t i = begin;
+  // Check the words up to the next line one at a time. This also keeps dense bitmaps from paying
+  // for the vector loads.
+  while (i < end && !IsAligned<kBitmapLineSize>(&words[i])) {
+    if (word(i) != 0) {
+      return i;
+    }
+    ++i;
+  }
+  while (end - i >= kBitmapWordsPerLine &&
+         IsEmptyBitmapLine<kUseSimd, kClearMarked>(&words[i], &mark[i])) {
+    i += kBitmapWordsPerLine;
+  }
+  while (i < end && word(i) == 0) {
+    ++i;
+  }
+  return i;
+}
+
+// Returns the index of the first non-zero word in [begin, end) of `words`, or `end` if they are
+// all zero. Long runs of zero words are skipped with vector instructions where available.
+template <bool kUseSimd = true>
+static inline size_t FindNextNonZeroBitmapWord(const Atomic<uintptr_t>* words,
+                                               size_t begin,
+                                               size_t end) {
+  // `words` is passed as the unused mark words.
+  return FindNextBitmapWord<kUseSimd, /*kClearMarked=*/ false>(words, words, begin, end);
+}
+
+// Returns the index of the first word in [begin, end) with a bit set in `live` but not in `mark`,
+// or `end` if there is none.
+template <bool kUseSimd = true>
+static inline size_t FindNextGarbageBitmapWord(const Atomic<uintptr_t>* live,
+                                               const Atomic<uintptr_t>* mark,
+                                               size_t begin,
+                                               size_t end) {
+  return FindNextBitmapWord<kUseSimd, /*kClearMarked=*/ true>(live, mark, begin, end);
+}
+
 template<size_t kAlignment>
 inline bool SpaceBitmap<kAlignment>::AtomicTestAndSet(const mirror::Object* obj) {
   uintptr_t addr = reinterpret_cast<uintptr_t>(obj);
@@ -118,18 +221,19 @@ inline void SpaceBitmap<kAlignment>::VisitMarkedRange(uintptr_t visit_begin,
       } while (left_edge != 0);
     }
 
-    // Traverse the middle, full part.
-    for (size_t i = index_start + 1; i < index_end; ++i) {
+    // Traverse the middle, full part, skipping runs of empty words.
+    for (size_t i = FindNextNonZeroBitmapWord(bitmap_begin_, index_start + 1, index_end);
+         i < index_end;
+         i = FindNextNonZeroBitmapWord(bitmap_begin_, i + 1, index_end)) {
+      // Reload the word, it may have changed since it was found non-zero.
       uintptr_t w = bitmap_begin_[i].load(std::memory_order_relaxed);
-      if (w != 0) {
-        const uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
-        // Iterate on the bits set in word `w`, from the least to the most significant bit.
-        do {
-          const size_t shift = CTZ(w);
-          mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
-          visitor(obj);
-          w ^= (static_cast<uintptr_t>(1)) << shift;
-        } while (w != 0);
+      const uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
+      // Iterate on the bits set in word `w`, from the least to the most significant bit.
+      while (w != 0) {
+        const size_t shift = CTZ(w);
+        mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+        visitor(obj);
+        w ^= (static_cast<uintptr_t>(1)) << shift;
       }
     }
 
@@ -190,10 +190,13 @@ void SpaceBitmap<kAlignment>::SweepWalk(const SpaceBitmap<kAlignment>& live_bitm
   mirror::Object** cur_pointer = &pointer_buf[0];
   mirror::Object** pointer_end = cur_pointer + (buffer_size - kBitsPerIntPtrT);
 
-  for (size_t i = start; i <= end; i++) {
+  // Skip the runs of words without garbage, which make most of sparse bitmaps.
+  for (size_t i = FindNextGarbageBitmapWord(live, mark, start, end + 1);
+       i <= end;
+       i = FindNextGarbageBitmapWord(live, mark, i + 1, end + 1)) {
     uintptr_t garbage =
         live[i].load(std::memory_order_relaxed) & ~mark[i].load(std::memory_order_relaxed);
-    if (UNLIKELY(garbage != 0)) {
+    if (LIKELY(garbage != 0)) {
       uintptr_t ptr_base = IndexToOffset(i) + live_bitmap.heap_begin_;
       do {
         const size_t shift = CTZ(garbage);
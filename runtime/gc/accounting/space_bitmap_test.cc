@@ -18,8 +18,10 @@
 
 #include <stdint.h>
 #include <memory>
+#include <set>
 
 #include "base/mutex.h"
+#include "base/time_utils.h"
 #include "common_runtime_test.h"
 #include "runtime_globals.h"
 #include "space_bitmap-inl.h"
@@ -257,6 +259,108 @@ TEST_F(SpaceBitmapTest, OrderPageAlignment) {
   RunTestOrder<kPageSize>();
 }
 
+TEST_F(SpaceBitmapTest, SweepWalk) {
+  uint8_t* heap_begin = reinterpret_cast<uint8_t*>(0x10000000);
+  size_t heap_capacity = 16 * MB;
+  ContinuousSpaceBitmap live(
+      ContinuousSpaceBitmap::Create("live bitmap", heap_begin, heap_capacity));
+  ContinuousSpaceBitmap mark(
+      ContinuousSpaceBitmap::Create("mark bitmap", heap_begin, heap_capacity));
+  RandGen r(0x1234);
+  std::set<mirror::Object*> expected;
+  for (size_t i = 0; i < 10000; ++i) {
+    mirror::Object* obj = reinterpret_cast<mirror::Object*>(
+        heap_begin + RoundDown(r.next() % heap_capacity, kObjectAlignment));
+    live.Set(obj);
+    if (r.next() % 4 == 0) {
+      mark.Set(obj);
+      expected.erase(obj);
+    } else if (!mark.Test(obj)) {
+      expected.insert(obj);
+    }
+  }
+  std::set<mirror::Object*> swept;
+  auto callback = [](size_t num_ptrs, mirror::Object** ptrs, void* arg) {
+    std::set<mirror::Object*>* set = reinterpret_cast<std::set<mirror::Object*>*>(arg);
+    set->insert(ptrs, ptrs + num_ptrs);
+  };
+  ContinuousSpaceBitmap::SweepWalk(live,
+                                   mark,
+                                   reinterpret_cast<uintptr_t>(heap_begin),
+                                   reinterpret_cast<uintptr_t>(heap_begin + heap_capacity),
+                                   callback,
+                                   &swept);
+  EXPECT_EQ(expected, swept);
+}
+
+// Compares the vectorized searches for set bits with the scalar ones, and logs how long each
+// takes on sparse bitmaps.
+TEST_F(SpaceBitmapTest, BenchmarkFindNextBitmapWord) {
+  static constexpr size_t kNumWords = 256 * KB;
+  static constexpr size_t kSparseness = 1021;
+  static constexpr size_t kIterations = 100;
+  std::unique_ptr<Atomic<uintptr_t>[]> live(new Atomic<uintptr_t>[kNumWords + kBitmapWordsPerLine]);
+  std::unique_ptr<Atomic<uintptr_t>[]> mark(new Atomic<uintptr_t>[kNumWords + kBitmapWordsPerLine]);
+  // Start the live words at a line boundary and the mark words one word after one, to cover
+  // mismatched alignments.
+  Atomic<uintptr_t>* live_words = AlignUp(live.get(), kBitmapLineSize);
+  Atomic<uintptr_t>* mark_words = AlignUp(mark.get(), kBitmapLineSize) + 1;
+  size_t expected_non_zero = 0;
+  size_t expected_garbage = 0;
+  for (size_t i = 0; i < kNumWords; ++i) {
+    const bool set = (i % kSparseness) == 0;
+    const bool marked = set && (i % (2 * kSparseness)) == 0;
+    live_words[i].store(set ? 0x10 : 0, std::memory_order_relaxed);
+    mark_words[i].store(marked ? 0x10 : 0, std::memory_order_relaxed);
+    expected_non_zero += set ? 1 : 0;
+    expected_garbage += (set && !marked) ? 1 : 0;
+  }
+  auto count = [](auto find) {
+    size_t found = 0;
+    for (size_t i = find(0); i < kNumWords; i = find(i + 1)) {
+      ++found;
+    }
+    return found;
+  };
+  auto benchmark = [&](const char* name, size_t expected, auto scalar_find, auto simd_find) {
+    uint64_t start = NanoTime();
+    size_t scalar_count = 0;
+    for (size_t i = 0; i < kIterations; ++i) {
+      scalar_count += count(scalar_find);
+    }
+    const uint64_t scalar_time = NanoTime() - start;
+    start = NanoTime();
+    size_t simd_count = 0;
+    for (size_t i = 0; i < kIterations; ++i) {
+      simd_count += count(simd_find);
+    }
+    const uint64_t simd_time = NanoTime() - start;
+    EXPECT_EQ(scalar_count, kIterations * expected) << name;
+    EXPECT_EQ(simd_count, kIterations * expected) << name;
+    LOG(INFO) << name << " over " << kNumWords << " words " << kIterations << " times: "
+              << "scalar " << PrettyDuration(scalar_time) << ", vector "
+              << PrettyDuration(simd_time);
+  };
+  benchmark("Finding non-zero words",
+            expected_non_zero,
+            [&](size_t begin) {
+              return FindNextNonZeroBitmapWord</*kUseSimd=*/ false>(live_words, begin, kNumWords);
+            },
+            [&](size_t begin) {
+              return FindNextNonZeroBitmapWord</*kUseSimd=*/ true>(live_words, begin, kNumWords);
+            });
+  benchmark("Finding garbage words",
+            expected_garbage,
+            [&](size_t begin) {
+              return FindNextGarbageBitmapWord</*kUseSimd=*/ false>(
+                  live_words, mark_words, begin, kNumWords);
+            },
+            [&](size_t begin) {
+              return FindNextGarbageBitmapWord</*kUseSimd=*/ true>(
+                  live_words, mark_words, begin, kNumWords);
+            });
+}
+
 }  // namespace accounting
 }  // namespace gc
 }  // namespace art
@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ACCOUNTING_WORK_STEALING_DEQUE_H_
+#define ART_RUNTIME_GC_ACCOUNTING_WORK_STEALING_DEQUE_H_
+
+#include <sched.h>
+#include <sys/mman.h>  // For the PROT_* and MAP_* constants.
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <android-base/logging.h>
+
+#include "base/atomic.h"
+#include "base/bit_utils.h"
+#include "base/macros.h"
+#include "base/mem_map.h"
+#include "base/mutex.h"
+#include "thread-current-inl.h"
+
+// This implements a fixed-capacity Chase-Lev work-stealing deque ("Dynamic Circular Work-Stealing
+// Deque", Chase and Lev, SPAA 2005, with the C11 memory orderings from "Correct and Efficient
+// Work-Stealing for Weak Memory Models", Le et al., PPoPP 2013). A single owner thread pushes
+// onto and pops from the bottom, while any number of other threads may steal from the top.
+//
+// WorkStealingMarkStacks below combines one deque per GC worker with an overflow list and a
+// termination protocol, so that idle markers steal work instead of waiting for the others.
+
+namespace art {
+namespace gc {
+namespace accounting {
+
+template <typename T>
+class WorkStealingDeque {
+ public:
+  // Capacity is how many elements we can store in the deque. Must be a power of two.
+  static WorkStealingDeque* Create(const std::string& name, size_t capacity) {
+    CHECK(IsPowerOfTwo(capacity)) << capacity;
+    std::unique_ptr<WorkStealingDeque> deque(new WorkStealingDeque(name, capacity));
+    deque->Init();
+    return deque.release();
+  }
+
+  // Must not be called concurrently with any other operation.
+  void Reset() {
+    DCHECK(mem_map_.IsValid());
+    top_.store(0, std::memory_order_relaxed);
+    bottom_.store(0, std::memory_order_relaxed);
+  }
+
+  // Owner only. Returns false if the deque is full.
+  bool PushBottom(T* value) {
+    DCHECK(value != nullptr);
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_acquire);
+    if (UNLIKELY(static_cast<size_t>(b - t) >= capacity_)) {
+      return false;
+    }
+    begin_[b & mask_].store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Owner only. Returns null if the deque is empty.
+  T* PopBottom() {
+    const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      // Empty.
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T* value = begin_[b & mask_].load(std::memory_order_relaxed);
+    if (t == b) {
+      // Last element, race against the thieves.
+      if (!top_.compare_exchange_strong(t, t + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        value = nullptr;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  // Any thread. Returns null if the deque is empty or if we lost a race with the owner or another
+  // thief, in which case the caller may retry.
+  T* Steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+    T* value = begin_[t & mask_].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(t, t + 1,
+                                      std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return value;
+  }
+
+  // Racy when called concurrently with other operations; only a hint in that case.
+  size_t Size() const {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0u;
+  }
+
+  bool IsEmpty() const {
+    return Size() == 0;
+  }
+
+  size_t Capacity() const {
+    return capacity_;
+  }
+
+ private:
+  WorkStealingDeque(const std::string& name, size_t capacity)
+      : name_(name),
+        top_(0),
+        bottom_(0),
+        begin_(nullptr),
+        capacity_(capacity),
+        mask_(capacity - 1) {
+  }
+
+  void Init() {
+    std::string error_msg;
+    mem_map_ = MemMap::MapAnonymous(name_.c_str(),
+                                    capacity_ * sizeof(begin_[0]),
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ false,
+                                    &error_msg);
+    CHECK(mem_map_.IsValid()) << "couldn't allocate work-stealing deque.\n" << error_msg;
+    begin_ = reinterpret_cast<Atomic<T*>*>(mem_map_.Begin());
+    Reset();
+  }
+
+  // Used to keep the indices on separate cache lines.
+  static constexpr size_t kCacheLineSize = 64;
+
+  // Name of the deque.
+  std::string name_;
+  // Memory mapping of the deque.
+  MemMap mem_map_;
+  // Index of the oldest element, advanced by thieves (and by the owner for the last element).
+  // Kept on its own cache line to avoid false sharing with the owner's bottom index.
+  alignas(kCacheLineSize) Atomic<int64_t> top_;
+  // Index after the newest element, only written by the owner.
+  alignas(kCacheLineSize) Atomic<int64_t> bottom_;
+  // Base of the circular buffer.
+  Atomic<T*>* begin_;
+  // Maximum number of elements.
+  const size_t capacity_;
+  const size_t mask_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+// A set of work-stealing deques, one per worker, used to drain a mark stack in parallel. Worker
+// `id` pushes onto its own deque and pops from it. When its deque is empty, it takes work from the
+// shared overflow list and then steals from the other workers. Pop() only returns null once all
+// workers are out of work at the same time.
+template <typename T>
+class WorkStealingMarkStacks {
+ public:
+  WorkStealingMarkStacks(const char* name, size_t num_workers, size_t capacity_per_worker)
+      : overflow_lock_("work-stealing mark stack overflow lock", kMarkSweepMarkStackLock),
+        num_idle_workers_(0),
+        overflow_size_(0) {
+    CHECK_GT(num_workers, 0u);
+    for (size_t i = 0; i < num_workers; ++i) {
+      deques_.emplace_back(WorkStealingDeque<T>::Create(name, capacity_per_worker));
+    }
+  }
+
+  size_t NumWorkers() const {
+    return deques_.size();
+  }
+
+  // Must not be called concurrently with Push() or Pop().
+  void Reset() {
+    for (std::unique_ptr<WorkStealingDeque<T>>& deque : deques_) {
+      deque->Reset();
+    }
+    num_idle_workers_.store(0, std::memory_order_relaxed);
+    MutexLock mu(Thread::Current(), overflow_lock_);
+    overflow_.clear();
+    overflow_size_.store(0, std::memory_order_relaxed);
+  }
+
+  // Push `value` as work for `worker`. Only called by that worker, or before the workers start.
+  void Push(size_t worker, T* value) REQUIRES(!overflow_lock_) {
+    DCHECK_LT(worker, deques_.size());
+    if (UNLIKELY(!deques_[worker]->PushBottom(value))) {
+      MutexLock mu(Thread::Current(), overflow_lock_);
+      overflow_.push_back(value);
+      overflow_size_.store(overflow_.size(), std::memory_order_relaxed);
+    }
+  }
+
+  // Returns the next piece of work for `worker`, or null when there is no work left anywhere.
+  T* Pop(size_t worker) REQUIRES(!overflow_lock_) {
+    DCHECK_LT(worker, deques_.size());
+    T* value = deques_[worker]->PopBottom();
+    if (LIKELY(value != nullptr)) {
+      return value;
+    }
+    while (true) {
+      value = TakeSharedWork(worker);
+      if (value != nullptr) {
+        return value;
+      }
+      // Out of work. Go idle, and terminate once every worker is idle. An idle worker never
+      // pushes, so observing all workers idle means all deques and the overflow list are empty.
+      num_idle_workers_.fetch_add(1, std::memory_order_seq_cst);
+      while (true) {
+        if (num_idle_workers_.load(std::memory_order_seq_cst) == deques_.size()) {
+          return nullptr;
+        }
+        if (HasSharedWork()) {
+          num_idle_workers_.fetch_sub(1, std::memory_order_seq_cst);
+          break;
+        }
+        sched_yield();
+      }
+    }
+  }
+
+ private:
+  T* TakeSharedWork(size_t worker) REQUIRES(!overflow_lock_) {
+    if (overflow_size_.load(std::memory_order_relaxed) != 0) {
+      MutexLock mu(Thread::Current(), overflow_lock_);
+      if (!overflow_.empty()) {
+        T* value = overflow_.back();
+        overflow_.pop_back();
+        overflow_size_.store(overflow_.size(), std::memory_order_relaxed);
+        return value;
+      }
+    }
+    const size_t num_workers = deques_.size();
+    for (size_t i = 1; i < num_workers; ++i) {
+      T* value = deques_[(worker + i) % num_workers]->Steal();
+      if (value != nullptr) {
+        return value;
+      }
+    }
+    return nullptr;
+  }
+
+  bool HasSharedWork() const {
+    if (overflow_size_.load(std::memory_order_relaxed) != 0) {
+      return true;
+    }
+    for (const std::unique_ptr<WorkStealingDeque<T>>& deque : deques_) {
+      if (!deque->IsEmpty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<std::unique_ptr<WorkStealingDeque<T>>> deques_;
+  // Work that did not fit into the deque of the worker that produced it.
+  Mutex overflow_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<T*> overflow_ GUARDED_BY(overflow_lock_);
+  Atomic<size_t> num_idle_workers_;
+  Atomic<size_t> overflow_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingMarkStacks);
+};
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ACCOUNTING_WORK_STEALING_DEQUE_H_
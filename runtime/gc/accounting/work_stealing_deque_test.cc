@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "work_stealing_deque.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/atomic.h"
+#include "common_runtime_test.h"
+#include "thread-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+namespace gc {
+namespace accounting {
+
+class WorkStealingDequeTest : public CommonRuntimeTest {};
+
+TEST_F(WorkStealingDequeTest, OwnerIsLifoThiefIsFifo) {
+  std::unique_ptr<WorkStealingDeque<size_t>> deque(
+      WorkStealingDeque<size_t>::Create("test deque", 4));
+  size_t values[] = {0, 1, 2, 3, 4};
+  EXPECT_TRUE(deque->IsEmpty());
+  EXPECT_EQ(deque->PopBottom(), nullptr);
+  EXPECT_EQ(deque->Steal(), nullptr);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(deque->PushBottom(&values[i]));
+  }
+  // Full.
+  EXPECT_FALSE(deque->PushBottom(&values[4]));
+  EXPECT_EQ(deque->Size(), 4u);
+  EXPECT_EQ(deque->Steal(), &values[0]);
+  EXPECT_EQ(deque->PopBottom(), &values[3]);
+  EXPECT_EQ(deque->Steal(), &values[1]);
+  // Freed slots can be reused, wrapping around the circular buffer.
+  EXPECT_TRUE(deque->PushBottom(&values[4]));
+  EXPECT_EQ(deque->PopBottom(), &values[4]);
+  EXPECT_EQ(deque->PopBottom(), &values[2]);
+  EXPECT_EQ(deque->PopBottom(), nullptr);
+  EXPECT_TRUE(deque->IsEmpty());
+}
+
+// Processes the nodes of an implicit binary tree: node k has children 2k+1 and 2k+2.
+class TreeMarkTask : public Task {
+ public:
+  TreeMarkTask(WorkStealingMarkStacks<size_t>* mark_stacks,
+               std::vector<size_t>* nodes,
+               std::vector<AtomicInteger>* visit_counts,
+               size_t worker_id)
+      : mark_stacks_(mark_stacks),
+        nodes_(nodes),
+        visit_counts_(visit_counts),
+        worker_id_(worker_id) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) override {
+    for (size_t* node = mark_stacks_->Pop(worker_id_);
+         node != nullptr;
+         node = mark_stacks_->Pop(worker_id_)) {
+      ++(*visit_counts_)[*node];
+      for (size_t child = 2 * *node + 1; child <= 2 * *node + 2; ++child) {
+        if (child < nodes_->size()) {
+          mark_stacks_->Push(worker_id_, &(*nodes_)[child]);
+        }
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  WorkStealingMarkStacks<size_t>* const mark_stacks_;
+  std::vector<size_t>* const nodes_;
+  std::vector<AtomicInteger>* const visit_counts_;
+  const size_t worker_id_;
+};
+
+TEST_F(WorkStealingDequeTest, ParallelTreeWalk) {
+  static constexpr size_t kNumThreads = 4;
+  // Small deques so that the overflow list is exercised as well.
+  static constexpr size_t kDequeCapacity = 8;
+  static constexpr size_t kNumNodes = 64 * KB;
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Work-stealing deque test thread pool", kNumThreads - 1);
+  WorkStealingMarkStacks<size_t> mark_stacks("test mark stacks", kNumThreads, kDequeCapacity);
+  std::vector<size_t> nodes(kNumNodes);
+  std::vector<AtomicInteger> visit_counts(kNumNodes);
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    nodes[i] = i;
+    visit_counts[i].store(0, std::memory_order_relaxed);
+  }
+  for (size_t round = 0; round < 2; ++round) {
+    mark_stacks.Reset();
+    // All the work starts on one worker; the others have to steal it.
+    mark_stacks.Push(0, &nodes[0]);
+    for (size_t i = 0; i < kNumThreads; ++i) {
+      thread_pool.AddTask(self, new TreeMarkTask(&mark_stacks, &nodes, &visit_counts, i));
+    }
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, /* do_work= */ true, /* may_hold_locks= */ false);
+    thread_pool.StopWorkers(self);
+    for (size_t i = 0; i < kNumNodes; ++i) {
+      ASSERT_EQ(visit_counts[i].load(std::memory_order_relaxed), static_cast<int32_t>(round + 1))
+          << "node " << i;
+    }
+  }
+}
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
@@ -56,16 +56,17 @@ void AllocRecordObjectMap::VisitRoots(RootVisitor* visitor) {
   size_t count = recent_record_max_;
   // Only visit the last recent_record_max_ number of allocation records in entries_ and mark the
   // klass_ fields as strong roots.
-  for (auto it = entries_.rbegin(), end = entries_.rend(); it != end; ++it) {
+  for (auto it = entries_.rbegin(), end = entries_.rend(); it != end && count > 0; ++it) {
     AllocRecord& record = it->second;
-    if (count > 0) {
-      buffered_visitor.VisitRootIfNonNull(record.GetClassGcRoot());
-      --count;
-    }
-    // Visit all of the stack frames to make sure no methods in the stack traces get unloaded by
-    // class unloading.
-    for (size_t i = 0, depth = record.GetDepth(); i < depth; ++i) {
-      const AllocRecordStackTraceElement& element = record.StackElement(i);
+    buffered_visitor.VisitRootIfNonNull(record.GetClassGcRoot());
+    --count;
+  }
+  // Visit all of the stack frames to make sure no methods in the stack traces get unloaded by
+  // class unloading. Each distinct stack trace only needs to be visited once.
+  for (const auto& entry : stack_traces_) {
+    const AllocRecordStackTrace& trace = entry.first;
+    for (size_t i = 0, depth = trace.GetDepth(); i < depth; ++i) {
+      const AllocRecordStackTraceElement& element = trace.GetStackElement(i);
       DCHECK(element.GetMethod() != nullptr);
       element.GetMethod()->VisitRoots(buffered_visitor, kRuntimePointerSize);
     }
@@ -106,6 +107,7 @@ void AllocRecordObjectMap::SweepAllocationRecords(IsMarkedVisitor* visitor) {
         SweepClassObject(&record, visitor);
         ++it;
       } else {
+        ReleaseStackTrace(record.GetStackTrace());
         it = entries_.erase(it);
         ++count_deleted;
       }
@@ -153,6 +155,7 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
       }
       CHECK(records != nullptr);
       records->SetMaxStackDepth(heap->GetAllocTrackerStackDepth());
+      // Assume the worst case where no two records share a stack trace.
       size_t sz = sizeof(AllocRecordStackTraceElement) * records->max_stack_depth_ +
                   sizeof(AllocRecord) + sizeof(AllocRecordStackTrace);
       LOG(INFO) << "Enabling alloc tracker (" << records->alloc_record_max_ << " entries of "
@@ -182,33 +185,39 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
   }
 }
 
+static void WalkAllocationStack(Thread* self,
+                                ObjPtr<mirror::Object>* obj,
+                                size_t max_stack_depth,
+                                AllocRecordStackTrace* trace)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  StackHandleScope<1> hs(self);
+  auto obj_wrapper = hs.NewHandleWrapper(obj);
+
+  StackVisitor::WalkStack(
+      [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        if (trace->GetDepth() >= max_stack_depth) {
+          return false;
+        }
+        ArtMethod* m = stack_visitor->GetMethod();
+        // m may be null if we have inlined methods of unresolved classes. b/27858645
+        if (m != nullptr && !m->IsRuntimeMethod()) {
+          m = m->GetInterfaceMethodIfProxy(kRuntimePointerSize);
+          trace->AddStackElement(AllocRecordStackTraceElement(m, stack_visitor->GetDexPc()));
+        }
+        return true;
+      },
+      self,
+      /* context= */ nullptr,
+      art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+}
+
 void AllocRecordObjectMap::RecordAllocation(Thread* self,
                                             ObjPtr<mirror::Object>* obj,
                                             size_t byte_count) {
   // Get stack trace outside of lock in case there are allocations during the stack walk.
   // b/27858645.
   AllocRecordStackTrace trace;
-  {
-    StackHandleScope<1> hs(self);
-    auto obj_wrapper = hs.NewHandleWrapper(obj);
-
-    StackVisitor::WalkStack(
-        [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
-          if (trace.GetDepth() >= max_stack_depth_) {
-            return false;
-          }
-          ArtMethod* m = stack_visitor->GetMethod();
-          // m may be null if we have inlined methods of unresolved classes. b/27858645
-          if (m != nullptr && !m->IsRuntimeMethod()) {
-            m = m->GetInterfaceMethodIfProxy(kRuntimePointerSize);
-            trace.AddStackElement(AllocRecordStackTraceElement(m, stack_visitor->GetDexPc()));
-          }
-          return true;
-        },
-        self,
-        /* context= */ nullptr,
-        art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
-  }
+  WalkAllocationStack(self, obj, max_stack_depth_, &trace);
 
   MutexLock mu(self, *Locks::alloc_tracker_lock_);
   Heap* const heap = Runtime::Current()->GetHeap();
@@ -242,16 +251,91 @@ void AllocRecordObjectMap::RecordAllocation(Thread* self,
   trace.SetTid(self->GetTid());
 
   // Add the record.
-  Put(obj->Ptr(), AllocRecord(byte_count, (*obj)->GetClass(), std::move(trace)));
+  Put(obj->Ptr(), (*obj)->GetClass(), byte_count, std::move(trace));
   DCHECK_LE(Size(), alloc_record_max_);
 }
 
+const AllocRecordStackTrace* AllocRecordObjectMap::InternStackTrace(
+    AllocRecordStackTrace&& trace) {
+  auto it = stack_traces_.find(trace);
+  if (it == stack_traces_.end()) {
+    it = stack_traces_.emplace(std::move(trace), 0u).first;
+  }
+  ++it->second;
+  // Elements of an unordered_map are not moved by rehashing.
+  return &it->first;
+}
+
+void AllocRecordObjectMap::ReleaseStackTrace(const AllocRecordStackTrace* trace) {
+  auto it = stack_traces_.find(*trace);
+  DCHECK(it != stack_traces_.end());
+  DCHECK_EQ(&it->first, trace);
+  DCHECK_NE(it->second, 0u);
+  if (--it->second == 0u) {
+    stack_traces_.erase(it);
+  }
+}
+
 void AllocRecordObjectMap::Clear() {
   entries_.clear();
+  stack_traces_.clear();
 }
 
 AllocRecordObjectMap::AllocRecordObjectMap()
     : new_record_condition_("New allocation record condition", *Locks::alloc_tracker_lock_) {}
 
+AllocRecordSampleBuffer::AllocRecordSampleBuffer(size_t capacity) : samples_(capacity) {
+  CHECK_GT(capacity, 0u);
+}
+
+void AllocRecordSampleBuffer::RecordSample(Thread* self,
+                                           ObjPtr<mirror::Object>* obj,
+                                           size_t byte_count,
+                                           size_t max_stack_depth) {
+  // As for RecordAllocation(), walk the stack outside of the lock.
+  AllocRecordStackTrace trace;
+  WalkAllocationStack(self, obj, max_stack_depth, &trace);
+  trace.SetTid(self->GetTid());
+
+  MutexLock mu(self, *Locks::alloc_tracker_lock_);
+  size_t index;
+  if (size_ == samples_.size()) {
+    index = head_;
+    head_ = (head_ + 1) % samples_.size();
+    ++overwritten_samples_;
+  } else {
+    index = (head_ + size_) % samples_.size();
+    ++size_;
+  }
+  Sample& sample = samples_[index];
+  sample.byte_count = byte_count;
+  sample.klass = GcRoot<mirror::Class>((*obj)->GetClass());
+  sample.trace = std::move(trace);
+}
+
+void AllocRecordSampleBuffer::VisitRoots(RootVisitor* visitor) {
+  BufferedRootVisitor<kDefaultBufferedRootCount> buffered_visitor(visitor, RootInfo(kRootDebugger));
+  for (size_t i = 0; i < size_; ++i) {
+    Sample& sample = samples_[(head_ + i) % samples_.size()];
+    buffered_visitor.VisitRootIfNonNull(sample.klass);
+    // Keep the methods on the stack trace from being unloaded before the sample is drained.
+    for (size_t j = 0, depth = sample.trace.GetDepth(); j < depth; ++j) {
+      const AllocRecordStackTraceElement& element = sample.trace.GetStackElement(j);
+      DCHECK(element.GetMethod() != nullptr);
+      element.GetMethod()->VisitRoots(buffered_visitor, kRuntimePointerSize);
+    }
+  }
+}
+
+void AllocRecordSampleBuffer::Clear() {
+  for (size_t i = 0; i < size_; ++i) {
+    Sample& sample = samples_[(head_ + i) % samples_.size()];
+    sample.klass = GcRoot<mirror::Class>(nullptr);
+    sample.trace = AllocRecordStackTrace();
+  }
+  head_ = 0;
+  size_ = 0;
+}
+
 }  // namespace gc
 }  // namespace art
@@ -19,6 +19,8 @@
 
 #include <list>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "base/mutex.h"
 #include "gc_root.h"
@@ -85,6 +87,9 @@ class AllocRecordStackTrace {
       : tid_(r.tid_),
         stack_(r.stack_) {}
 
+  AllocRecordStackTrace& operator=(AllocRecordStackTrace&& r) = default;
+  AllocRecordStackTrace& operator=(const AllocRecordStackTrace& r) = default;
+
   pid_t GetTid() const {
     return tid_;
   }
@@ -155,16 +160,20 @@ template <typename T> struct EqAllocRecordTypesPtr {
 
 class AllocRecord {
  public:
-  // All instances of AllocRecord should be managed by an instance of AllocRecordObjectMap.
-  AllocRecord(size_t count, mirror::Class* klass, AllocRecordStackTrace&& trace)
-      : byte_count_(count), klass_(klass), trace_(std::move(trace)) {}
+  // All instances of AllocRecord should be managed by an instance of AllocRecordObjectMap,
+  // which also owns the (interned) stack trace.
+  AllocRecord(size_t count, mirror::Class* klass, const AllocRecordStackTrace* trace)
+      : byte_count_(count), klass_(klass), trace_(trace) {
+    DCHECK(trace != nullptr);
+  }
 
   size_t GetDepth() const {
-    return trace_.GetDepth();
+    return trace_->GetDepth();
   }
 
+  // Records with identical stack traces share the same AllocRecordStackTrace.
   const AllocRecordStackTrace* GetStackTrace() const {
-    return &trace_;
+    return trace_;
   }
 
   size_t ByteCount() const {
@@ -172,7 +181,7 @@ class AllocRecord {
   }
 
   pid_t GetTid() const {
-    return trace_.GetTid();
+    return trace_->GetTid();
   }
 
   mirror::Class* GetClass() const REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -187,17 +196,19 @@ class AllocRecord {
   }
 
   const AllocRecordStackTraceElement& StackElement(size_t index) const {
-    return trace_.GetStackElement(index);
+    return trace_->GetStackElement(index);
   }
 
  private:
   const size_t byte_count_;
   // The klass_ could be a strong or weak root for GC
   GcRoot<mirror::Class> klass_;
-  // TODO: Share between alloc records with identical stack traces.
-  AllocRecordStackTrace trace_;
+  const AllocRecordStackTrace* trace_;
 };
 
+// Records of tracked allocations, with the stack traces interned per allocation site. This is the
+// DDMS allocation tracker's store and has no streaming export; production profiling streams
+// sampled allocations out of AllocRecordSampleBuffer instead.
 class AllocRecordObjectMap {
  public:
   static constexpr size_t kDefaultNumAllocRecords = 512 * 1024;
@@ -226,19 +237,30 @@ class AllocRecordObjectMap {
   AllocRecordObjectMap() REQUIRES(Locks::alloc_tracker_lock_);
   ~AllocRecordObjectMap();
 
-  void Put(mirror::Object* obj, AllocRecord&& record)
+  void Put(mirror::Object* obj,
+           mirror::Class* klass,
+           size_t byte_count,
+           AllocRecordStackTrace&& trace)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::alloc_tracker_lock_) {
     if (entries_.size() == alloc_record_max_) {
+      ReleaseStackTrace(entries_.front().second.GetStackTrace());
       entries_.pop_front();
     }
-    entries_.push_back(EntryPair(GcRoot<mirror::Object>(obj), std::move(record)));
+    const AllocRecordStackTrace* interned_trace = InternStackTrace(std::move(trace));
+    entries_.push_back(EntryPair(GcRoot<mirror::Object>(obj),
+                                 AllocRecord(byte_count, klass, interned_trace)));
   }
 
   size_t Size() const REQUIRES_SHARED(Locks::alloc_tracker_lock_) {
     return entries_.size();
   }
 
+  // Number of distinct stack traces of the records.
+  size_t GetNumberOfStackTraces() const REQUIRES_SHARED(Locks::alloc_tracker_lock_) {
+    return stack_traces_.size();
+  }
+
   size_t GetRecentAllocationSize() const REQUIRES_SHARED(Locks::alloc_tracker_lock_) {
     CHECK_LE(recent_record_max_, alloc_record_max_);
     size_t sz = entries_.size();
@@ -303,8 +325,88 @@ class AllocRecordObjectMap {
   ConditionVariable new_record_condition_ GUARDED_BY(Locks::alloc_tracker_lock_);
   // see the comment in typedef of EntryList
   EntryList entries_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // The stack traces of the entries_, each with the number of entries referring to it.
+  // Allocations from the same site usually have the same stack trace, so sharing them keeps
+  // the memory use of the records close to the number of distinct allocation sites.
+  std::unordered_map<AllocRecordStackTrace, size_t, HashAllocRecordTypes> stack_traces_
+      GUARDED_BY(Locks::alloc_tracker_lock_);
 
   void SetMaxStackDepth(size_t max_stack_depth) REQUIRES(Locks::alloc_tracker_lock_);
+
+  // Returns the shared copy of `trace`, adding a reference to it.
+  const AllocRecordStackTrace* InternStackTrace(AllocRecordStackTrace&& trace)
+      REQUIRES(Locks::alloc_tracker_lock_);
+  // Removes a reference added by InternStackTrace(), deleting the trace with the last one.
+  void ReleaseStackTrace(const AllocRecordStackTrace* trace)
+      REQUIRES(Locks::alloc_tracker_lock_);
+};
+
+// Fixed-size ring buffer of sampled allocations, filled on the allocation slow path when
+// Heap::SetAllocationSamplingInterval() is non-zero (see -XX:AllocationSamplingInterval), and
+// drained by JVMTI agents through the com.android.art.heap.drain_allocation_samples extension.
+// Unlike AllocRecordObjectMap, the allocated objects are not tracked, so there is nothing to
+// sweep; the classes and the methods on the stack traces are strong roots until the samples are
+// drained or overwritten.
+class AllocRecordSampleBuffer {
+ public:
+  static constexpr size_t kDefaultNumSamples = 4 * 1024;
+
+  explicit AllocRecordSampleBuffer(size_t capacity = kDefaultNumSamples);
+
+  // Walks the stack of `self` and records a sample for `obj`. Overwrites the oldest sample if the
+  // buffer is full.
+  void RecordSample(Thread* self,
+                    ObjPtr<mirror::Object>* obj,
+                    size_t byte_count,
+                    size_t max_stack_depth)
+      REQUIRES(!Locks::alloc_tracker_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Calls `visitor(byte_count, klass, trace)` for every sample, oldest first, then empties the
+  // buffer.
+  template <typename Visitor>
+  void Drain(const Visitor& visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::alloc_tracker_lock_) {
+    for (size_t i = 0; i < size_; ++i) {
+      const Sample& sample = samples_[(head_ + i) % samples_.size()];
+      visitor(sample.byte_count, sample.klass.Read(), sample.trace);
+    }
+    Clear();
+  }
+
+  void VisitRoots(RootVisitor* visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::alloc_tracker_lock_);
+
+  void Clear() REQUIRES(Locks::alloc_tracker_lock_);
+
+  size_t Size() const REQUIRES(Locks::alloc_tracker_lock_) {
+    return size_;
+  }
+
+  size_t Capacity() const {
+    return samples_.size();
+  }
+
+  // Number of samples that were overwritten before being drained.
+  uint64_t GetOverwrittenSamples() const REQUIRES(Locks::alloc_tracker_lock_) {
+    return overwritten_samples_;
+  }
+
+ private:
+  struct Sample {
+    size_t byte_count = 0;
+    GcRoot<mirror::Class> klass;
+    AllocRecordStackTrace trace;
+  };
+
+  // Preallocated at construction so recording a sample only copies the stack trace.
+  std::vector<Sample> samples_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // Index of the oldest sample.
+  size_t head_ GUARDED_BY(Locks::alloc_tracker_lock_) = 0;
+  size_t size_ GUARDED_BY(Locks::alloc_tracker_lock_) = 0;
+  uint64_t overwritten_samples_ GUARDED_BY(Locks::alloc_tracker_lock_) = 0;
 };
 
 }  // namespace gc
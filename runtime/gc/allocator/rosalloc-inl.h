@@ -101,6 +101,12 @@ inline void* RosAlloc::AllocFromThreadLocalRun(Thread* self, size_t size,
 
 inline size_t RosAlloc::MaxBytesBulkAllocatedFor(size_t size) {
   if (UNLIKELY(!IsSizeForThreadLocal(size))) {
+    if (size <= kLargeSizeThreshold && size > kMaxRegularBracketSize) {
+      // A slot cache refill.
+      size_t bracket_size;
+      SizeToIndexAndBracketSize(size, &bracket_size);
+      return kSlotCacheSize * bracket_size;
+    }
     return size;
   }
   size_t bracket_size;
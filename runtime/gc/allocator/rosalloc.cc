@@ -16,6 +16,7 @@
 
 #include "rosalloc-inl.h"
 
+#include <limits>
 #include <list>
 #include <map>
 #include <sstream>
@@ -27,6 +28,7 @@
 #include "base/memory_tool.h"
 #include "base/mem_map.h"
 #include "base/mutex-inl.h"
+#include "base/time_utils.h"
 #include "gc/space/memory_tool_settings.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -736,6 +738,12 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
     }
     *bytes_allocated = bracket_size;
     *usable_size = bracket_size;
+  } else if (idx >= kFirstSlotCacheBracketIndex) {
+    slot_addr = AllocFromSlotCache(self, idx, bytes_tl_bulk_allocated);
+    if (LIKELY(slot_addr != nullptr)) {
+      *bytes_allocated = bracket_size;
+      *usable_size = bracket_size;
+    }
   } else {
     // Use the (shared) current run.
     MutexLock mu(self, *size_bracket_locks_[idx]);
@@ -756,6 +764,34 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
   return slot_addr;
 }
 
+void* RosAlloc::AllocFromSlotCache(Thread* self, size_t idx, size_t* bytes_tl_bulk_allocated) {
+  DCHECK_GE(idx, kFirstSlotCacheBracketIndex);
+  Thread::RosAllocSlotCache* cache = self->GetRosAllocSlotCache(idx - kFirstSlotCacheBracketIndex);
+  if (LIKELY(cache->num_slots != 0)) {
+    // The slot is already counted. Leave it as is.
+    *bytes_tl_bulk_allocated = 0;
+    return cache->slots[--cache->num_slots];
+  }
+  // Take a batch of slots from the current run, so that the following allocations of this size
+  // don't need the bracket lock.
+  {
+    MutexLock mu(self, *size_bracket_locks_[idx]);
+    while (cache->num_slots < kSlotCacheSize) {
+      void* slot_addr = AllocFromCurrentRunUnlocked(self, idx);
+      if (slot_addr == nullptr) {
+        break;
+      }
+      cache->slots[cache->num_slots++] = slot_addr;
+    }
+  }
+  if (UNLIKELY(cache->num_slots == 0)) {
+    return nullptr;
+  }
+  // Account for all the slots taken.
+  *bytes_tl_bulk_allocated = cache->num_slots * bracketSizes[idx];
+  return cache->slots[--cache->num_slots];
+}
+
 size_t RosAlloc::FreeFromRun(Thread* self, void* ptr, Run* run) {
   DCHECK_EQ(run->magic_num_, kMagicNum);
   DCHECK_LT(run, ptr);
@@ -1504,10 +1540,23 @@ void RosAlloc::SetFootprintLimit(size_t new_capacity) {
   }
 }
 
+size_t RosAlloc::RevokeSlotCaches(Thread* thread) {
+  Thread* self = Thread::Current();
+  size_t free_bytes = 0U;
+  for (size_t i = 0; i < kNumSlotCacheBrackets; ++i) {
+    Thread::RosAllocSlotCache* cache = thread->GetRosAllocSlotCache(i);
+    while (cache->num_slots != 0) {
+      free_bytes += Free(self, cache->slots[--cache->num_slots]);
+    }
+  }
+  return free_bytes;
+}
+
 // Below may be called by mutator itself just before thread termination.
 size_t RosAlloc::RevokeThreadLocalRuns(Thread* thread) {
   Thread* self = Thread::Current();
-  size_t free_bytes = 0U;
+  // The cached slots are not thread-local runs, but they are accounted the same way.
+  size_t free_bytes = RevokeSlotCaches(thread);
   for (size_t idx = 0; idx < kNumThreadLocalSizeBrackets; idx++) {
     MutexLock mu(self, *size_bracket_locks_[idx]);
     Run* thread_local_run = reinterpret_cast<Run*>(thread->GetRosAllocRun(idx));
@@ -1604,6 +1653,9 @@ void RosAlloc::AssertThreadLocalRunsAreRevoked(Thread* thread) {
       Run* thread_local_run = reinterpret_cast<Run*>(thread->GetRosAllocRun(idx));
       DCHECK(thread_local_run == nullptr || thread_local_run == dedicated_full_run_);
     }
+    for (size_t i = 0; i < kNumSlotCacheBrackets; ++i) {
+      DCHECK_EQ(thread->GetRosAllocSlotCache(i)->num_slots, 0u);
+    }
   }
 }
 
@@ -1980,13 +2032,29 @@ void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_mem
 }
 
 size_t RosAlloc::ReleasePages() {
-  VLOG(heap) << "RosAlloc::ReleasePages()";
+  size_t page_idx = 0;
+  return ReleasePages(&page_idx, std::numeric_limits<uint64_t>::max());
+}
+
+size_t RosAlloc::ReleasePages(size_t* page_idx, uint64_t deadline_ns) {
+  VLOG(heap) << "RosAlloc::ReleasePages() from page " << *page_idx;
   DCHECK(!DoesReleaseAllPages());
+  // How many pages to walk between deadline checks.
+  static constexpr size_t kDeadlineCheckInterval = 256;
   Thread* self = Thread::Current();
   size_t reclaimed_bytes = 0;
-  size_t i = 0;
+  size_t i = *page_idx;
+  size_t next_deadline_check = i + kDeadlineCheckInterval;
   // Check the page map size which might have changed due to grow/shrink.
   while (i < page_map_size_) {
+    if (i >= next_deadline_check) {
+      if (NanoTime() >= deadline_ns) {
+        // At least kDeadlineCheckInterval pages were visited, so this is not 0.
+        *page_idx = i;
+        return reclaimed_bytes;
+      }
+      next_deadline_check = i + kDeadlineCheckInterval;
+    }
     // Reading the page map without a lock is racy but the race is benign since it should only
     // result in occasionally not releasing pages which we could release.
     uint8_t pm = page_map_[i];
@@ -2032,6 +2100,7 @@ size_t RosAlloc::ReleasePages() {
         UNREACHABLE();
     }
   }
+  *page_idx = 0;
   return reclaimed_bytes;
 }
 
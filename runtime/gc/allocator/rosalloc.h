@@ -671,10 +671,27 @@ class RosAlloc {
   // This should be equal to bracketSizes[kNumThreadLocalSizeBrackets - 1].
   static const size_t kMaxThreadLocalBracketSize = 128;
 
+  // We use per-thread slot caches, refilled in batches of kSlotCacheSize slots from the (shared)
+  // current runs, for the size brackets whose indexes are at least this index, i.e. the 1 KB and
+  // 2 KB brackets. A thread-local run would hold too much memory per thread for these.
+  // Sync these with Thread::rosalloc_slot_caches_.
+  static constexpr size_t kFirstSlotCacheBracketIndex = 40;
+  static constexpr size_t kNumSlotCacheBrackets = 2;
+  static constexpr size_t kSlotCacheSize = 8;
+  static_assert(kNumSlotCacheBrackets == kNumRosAllocSlotCacheBracketsInThread,
+                "Mismatch between kNumSlotCacheBrackets and "
+                "kNumRosAllocSlotCacheBracketsInThread");
+  static_assert(kSlotCacheSize == kRosAllocSlotCacheSize,
+                "Mismatch between kSlotCacheSize and kRosAllocSlotCacheSize");
+
   // We use regular (8 or 16-bytes increment) runs for the size brackets whose indexes are less than
   // this index.
   static const size_t kNumRegularSizeBrackets = 40;
 
+  static_assert(kFirstSlotCacheBracketIndex == kNumRegularSizeBrackets &&
+                kFirstSlotCacheBracketIndex + kNumSlotCacheBrackets == kNumOfSizeBrackets,
+                "The slot caches are for the non-regular brackets");
+
   // The size of the largest regular (8 or 16-byte increment) bracket. Non-regular brackets are the
   // 1 KB and the 2 KB brackets. This should be equal to bracketSizes[kNumRegularSizeBrackets - 1].
   static const size_t kMaxRegularBracketSize = 512;
@@ -792,6 +809,12 @@ class RosAlloc {
                                  size_t* usable_size, size_t* bytes_tl_bulk_allocated)
       REQUIRES(!lock_);
   void* AllocFromCurrentRunUnlocked(Thread* self, size_t idx) REQUIRES(!lock_);
+  // Allocate a slot of a slot cache bracket from the thread's slot cache, refilling the cache from
+  // the current run if it is empty.
+  void* AllocFromSlotCache(Thread* self, size_t idx, size_t* bytes_tl_bulk_allocated)
+      REQUIRES(!lock_);
+  // Give the slots cached by `thread` back to their runs. Returns the number of bytes freed.
+  size_t RevokeSlotCaches(Thread* thread) REQUIRES(!lock_, !bulk_free_lock_);
 
   // Returns the bracket size.
   size_t FreeFromRun(Thread* self, void* ptr, Run* run)
@@ -887,6 +910,10 @@ class RosAlloc {
 
   // Release empty pages.
   size_t ReleasePages() REQUIRES(!lock_);
+  // Release empty pages starting at page `*page_idx`, stopping once NanoTime() reaches
+  // `deadline_ns`. On return `*page_idx` is the page to resume from, or 0 if all the pages have
+  // been visited.
+  size_t ReleasePages(size_t* page_idx, uint64_t deadline_ns) REQUIRES(!lock_);
   // Returns the current footprint.
   size_t Footprint() REQUIRES(!lock_);
   // Returns the current capacity, maximum footprint.
@@ -31,6 +31,7 @@
 #include "gc/accounting/mod_union_table-inl.h"
 #include "gc/accounting/read_barrier_table.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/accounting/work_stealing_deque.h"
 #include "gc/gc_pause_listener.h"
 #include "gc/reference_processor.h"
 #include "gc/space/image_space.h"
@@ -45,6 +46,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -66,6 +68,10 @@ static constexpr size_t kReadBarrierMarkStackSize = 512 * KB;
 static constexpr size_t kSweepArrayChunkFreeSize = 1024;
 // Verify that there are no missing card marks.
 static constexpr bool kVerifyNoMissingCardMarks = kIsDebugBuild;
+// Minimum number of refs on the mark stacks for parallel marking to be worthwhile.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
+// Capacity of each GC worker thread's work-stealing deque during parallel marking.
+static constexpr size_t kWorkStealingDequeCapacity = 16 * KB;
 
 ConcurrentCopying::ConcurrentCopying(Heap* heap,
                                      bool young_gen,
@@ -99,6 +105,8 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       from_space_num_bytes_at_first_pause_(0),
       mark_stack_mode_(kMarkStackModeOff),
       weak_ref_access_enabled_(true),
+      use_parallel_marking_(heap->GetUseParallelCCMarking()),
+      parallel_marking_active_(false),
       copied_live_bytes_ratio_sum_(0.f),
       gc_count_(0),
       reclaimed_bytes_ratio_sum_(0.f),
@@ -112,6 +120,11 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       rb_slow_path_time_histogram_("Mutator time in read barrier slow path", 500, 32),
       rb_slow_path_count_total_(0),
       rb_slow_path_count_gc_total_(0),
+      evacuation_stats_lock_("Evacuation stats lock"),
+      region_live_percent_histogram_("Unevacuated region live percent", 5, 22),
+      copied_kb_histogram_("Copied KB per GC", 256, 64),
+      cumulative_evacuated_bytes_(0),
+      cumulative_unevacuated_bytes_(0),
       rb_table_(heap_->GetReadBarrierTable()),
       force_evacuate_all_(false),
       gc_grays_immune_objects_(false),
@@ -1480,42 +1493,57 @@ void ConcurrentCopying::CopyingPhase() {
       //   which is an immune space.
       // - In the case where we run without a boot image, these classes are allocated in the
       //   non-moving space (see art::ClassLinker::InitWithoutImage).
-      card_table->Scan<false>(
-          space->GetMarkBitmap(),
-          space->Begin(),
-          space->End(),
-          [this, space](mirror::Object* obj)
-              REQUIRES(Locks::heap_bitmap_lock_)
-              REQUIRES_SHARED(Locks::mutator_lock_) {
-            // TODO: This code may be refactored to avoid scanning object while
-            // done_scanning_ is false by setting rb_state to gray, and pushing the
-            // object on mark stack. However, it will also require clearing the
-            // corresponding mark-bit and, for region space objects,
-            // decrementing the object's size from the corresponding region's
-            // live_bytes.
-            if (young_gen_) {
-              // Don't push or gray unevac refs.
-              if (kIsDebugBuild && space == region_space_) {
-                // We may get unevac large objects.
-                if (!region_space_->IsInUnevacFromSpace(obj)) {
-                  CHECK(region_space_bitmap_->Test(obj));
-                  region_space_->DumpRegionForObject(LOG_STREAM(FATAL_WITHOUT_ABORT), obj);
-                  LOG(FATAL) << "Scanning " << obj << " not in unevac space";
-                }
-              }
-              ScanDirtyObject</*kNoUnEvac*/ true>(obj);
-            } else if (space != region_space_) {
-              DCHECK(space == heap_->non_moving_space_);
-              // We need to process un-evac references as they may be unprocessed,
-              // if they skipped the marking phase due to heap mutation.
-              ScanDirtyObject</*kNoUnEvac*/ false>(obj);
-              non_moving_space_inter_region_bitmap_.Clear(obj);
-            } else if (region_space_->IsInUnevacFromSpace(obj)) {
-              ScanDirtyObject</*kNoUnEvac*/ false>(obj);
-              region_space_inter_region_bitmap_.Clear(obj);
+      auto card_visitor = [this, space](mirror::Object* obj)
+          REQUIRES(Locks::heap_bitmap_lock_)
+          REQUIRES_SHARED(Locks::mutator_lock_) {
+        // TODO: This code may be refactored to avoid scanning object while
+        // done_scanning_ is false by setting rb_state to gray, and pushing the
+        // object on mark stack. However, it will also require clearing the
+        // corresponding mark-bit and, for region space objects,
+        // decrementing the object's size from the corresponding region's
+        // live_bytes.
+        if (young_gen_) {
+          // Don't push or gray unevac refs.
+          if (kIsDebugBuild && space == region_space_) {
+            // We may get unevac large objects.
+            if (!region_space_->IsInUnevacFromSpace(obj)) {
+              CHECK(region_space_bitmap_->Test(obj));
+              region_space_->DumpRegionForObject(LOG_STREAM(FATAL_WITHOUT_ABORT), obj);
+              LOG(FATAL) << "Scanning " << obj << " not in unevac space";
             }
-          },
-          accounting::CardTable::kCardAged);
+          }
+          ScanDirtyObject</*kNoUnEvac*/ true>(obj);
+        } else if (space != region_space_) {
+          DCHECK(space == heap_->non_moving_space_);
+          // We need to process un-evac references as they may be unprocessed,
+          // if they skipped the marking phase due to heap mutation.
+          ScanDirtyObject</*kNoUnEvac*/ false>(obj);
+          non_moving_space_inter_region_bitmap_.Clear(obj);
+        } else if (region_space_->IsInUnevacFromSpace(obj)) {
+          ScanDirtyObject</*kNoUnEvac*/ false>(obj);
+          region_space_inter_region_bitmap_.Clear(obj);
+        }
+      };
+      if (young_gen_ && space == region_space_) {
+        // Only unevac regions hold objects that survived a previous GC, so only their cards
+        // can record old-to-young references. Young and free regions are skipped, so that
+        // the scan is proportional to the old part of the region space instead of all of it.
+        region_space_->VisitUnevacFromSpaceRanges(
+            [&](uint8_t* begin, uint8_t* end) REQUIRES(Locks::heap_bitmap_lock_)
+                REQUIRES_SHARED(Locks::mutator_lock_) {
+              card_table->Scan<false>(space->GetMarkBitmap(),
+                                      begin,
+                                      end,
+                                      card_visitor,
+                                      accounting::CardTable::kCardAged);
+            });
+      } else {
+        card_table->Scan<false>(space->GetMarkBitmap(),
+                                space->Begin(),
+                                space->End(),
+                                card_visitor,
+                                accounting::CardTable::kCardAged);
+      }
 
       if (!young_gen_) {
         auto visitor = [this](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -1593,7 +1621,15 @@ void ConcurrentCopying::CopyingPhase() {
 
   {
     TimingLogger::ScopedTiming split2("VisitConcurrentRoots", GetTimings());
-    Runtime::Current()->VisitConcurrentRoots(this, kVisitRootFlagAllRoots);
+    // Marking roots is thread safe, as mutators do it too, so the class tables of class loaders
+    // that are roots can be visited on the GC worker threads.
+    const size_t thread_count = GetParallelMarkingThreadCount();
+    ThreadPool* thread_pool = nullptr;
+    if (thread_count > 1u) {
+      thread_pool = heap_->GetThreadPool();
+      thread_pool->SetMaxActiveWorkers(thread_count - 1);
+    }
+    Runtime::Current()->VisitConcurrentRoots(this, kVisitRootFlagAllRoots, thread_pool);
   }
   {
     // TODO: don't visit the transaction roots if it's not active.
@@ -2087,7 +2123,11 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
   DCHECK(thread_running_gc_->GetThreadLocalMarkStack() == nullptr);
   size_t count = 0;
   MarkStackMode mark_stack_mode = mark_stack_mode_.load(std::memory_order_relaxed);
-  if (mark_stack_mode == kMarkStackModeThreadLocal) {
+  const size_t thread_count = GetParallelMarkingThreadCount();
+  if (mark_stack_mode == kMarkStackModeThreadLocal && thread_count > 1) {
+    // Process the thread-local mark stacks and the GC mark stack with the GC worker threads.
+    count += ProcessMarkStackParallel(thread_count);
+  } else if (mark_stack_mode == kMarkStackModeThreadLocal) {
     // Process the thread-local mark stacks and the GC mark stack.
     count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
                                           /* checkpoint_callback= */ nullptr,
@@ -2154,6 +2194,117 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
   return count == 0;
 }
 
+size_t ConcurrentCopying::GetParallelMarkingThreadCount() const {
+  // Use less threads if we are in a background state (non jank perceptible) since we want to leave
+  // more CPU time for the foreground apps.
+  if (!use_parallel_marking_ ||
+      heap_->GetThreadPool() == nullptr ||
+      !Runtime::Current()->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  return heap_->GetConcGCThreadCount() + 1;
+}
+
+// Processes mark stack refs on a GC worker thread (or on the GC-running thread, which also runs a
+// task while waiting for the thread pool) until all the work-stealing deques are empty. Refs
+// pushed while scanning go to the thread-local mark stack of the worker (or the GC mark stack for
+// the GC-running thread) and are moved to the worker's deque after each ref, so that other
+// workers can steal them.
+class ConcurrentCopying::ParallelMarkTask : public Task {
+ public:
+  ParallelMarkTask(ConcurrentCopying* collector,
+                   accounting::WorkStealingMarkStacks<mirror::Object>* mark_stacks,
+                   size_t worker_id)
+      : collector_(collector), mark_stacks_(mark_stacks), worker_id_(worker_id) {}
+
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    for (mirror::Object* ref = mark_stacks_->Pop(worker_id_);
+         ref != nullptr;
+         ref = mark_stacks_->Pop(worker_id_)) {
+      collector_->ProcessMarkStackRef</*kParallel=*/true>(ref);
+      // Only this thread pushes onto its own mark stack while marking in parallel.
+      accounting::ObjectStack* local_mark_stack = (self == collector_->thread_running_gc_)
+          ? collector_->gc_mark_stack_.get()
+          : self->GetThreadLocalMarkStack();
+      if (local_mark_stack != nullptr) {
+        while (!local_mark_stack->IsEmpty()) {
+          mark_stacks_->Push(worker_id_, local_mark_stack->PopBack());
+        }
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  accounting::WorkStealingMarkStacks<mirror::Object>* const mark_stacks_;
+  const size_t worker_id_;
+};
+
+size_t ConcurrentCopying::ProcessMarkStackParallel(size_t thread_count) {
+  Thread* const self = Thread::Current();
+  DCHECK_EQ(self, thread_running_gc_);
+  DCHECK_EQ(static_cast<uint32_t>(mark_stack_mode_.load(std::memory_order_relaxed)),
+            static_cast<uint32_t>(kMarkStackModeThreadLocal));
+  // Collect the refs of the thread-local mark stacks and the GC mark stack first. The GC worker
+  // threads never touch the GC mark stack, and the GC-running thread pushes onto it only after it
+  // has been drained here.
+  std::vector<mirror::Object*> refs;
+  ProcessThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
+                               /* checkpoint_callback= */ nullptr,
+                               [&refs] (mirror::Object* ref) { refs.push_back(ref); });
+  while (!gc_mark_stack_->IsEmpty()) {
+    refs.push_back(gc_mark_stack_->PopBack());
+  }
+  gc_mark_stack_->Reset();
+  const size_t count = refs.size();
+  if (count < kMinimumParallelMarkStackSize) {
+    for (mirror::Object* ref : refs) {
+      ProcessMarkStackRef(ref);
+    }
+    return count;
+  }
+  TimingLogger::ScopedTiming split("ProcessMarkStackParallel", GetTimings());
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  if (work_stealing_mark_stacks_ == nullptr ||
+      work_stealing_mark_stacks_->NumWorkers() != thread_count) {
+    work_stealing_mark_stacks_.reset(new accounting::WorkStealingMarkStacks<mirror::Object>(
+        "concurrent copying work-stealing mark stack", thread_count, kWorkStealingDequeCapacity));
+  } else {
+    work_stealing_mark_stacks_->Reset();
+  }
+  // Deal the refs out to the workers round-robin. The workers rebalance by stealing.
+  for (size_t i = 0; i < count; ++i) {
+    work_stealing_mark_stacks_->Push(i % thread_count, refs[i]);
+  }
+  parallel_marking_active_.store(true, std::memory_order_seq_cst);
+  // One task per thread, including this one: each task only finishes once all deques are empty.
+  for (size_t i = 0; i < thread_count; ++i) {
+    thread_pool->AddTask(self, new ParallelMarkTask(this, work_stealing_mark_stacks_.get(), i));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
+  parallel_marking_active_.store(false, std::memory_order_seq_cst);
+  // All the workers are done scanning. Finish the refs that lost the race for the mark bit, the
+  // same way the sequential path finishes a ref that was pushed twice.
+  std::vector<mirror::Object*> deferred_refs;
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    deferred_refs.swap(parallel_mark_deferred_refs_);
+  }
+  for (mirror::Object* ref : deferred_refs) {
+    if (ref->GetReadBarrierState() == ReadBarrier::GrayState()) {
+      ProcessMarkStackRef(ref);
+    }
+  }
+  return count;
+}
+
 template <typename Processor>
 size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_access,
                                                        Closure* checkpoint_callback,
@@ -2202,6 +2353,7 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
   return count;
 }
 
+template <bool kParallel>
 inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   DCHECK(!region_space_->IsInFromSpace(to_ref));
   space::RegionSpace::RegionType rtype = region_space_->GetRegionType(to_ref);
@@ -2224,8 +2376,11 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   bool perform_scan = false;
   switch (rtype) {
     case space::RegionSpace::RegionType::kRegionTypeUnevacFromSpace:
-      // Mark the bitmap only in the GC thread here so that we don't need a CAS.
-      if (!kUseBakerReadBarrier || !region_space_bitmap_->Set(to_ref)) {
+      // Mark the bitmap only in the GC thread here so that we don't need a CAS, unless GC worker
+      // threads are marking in parallel.
+      if (!kUseBakerReadBarrier ||
+          !(kParallel ? region_space_bitmap_->AtomicTestAndSet(to_ref)
+                      : region_space_bitmap_->Set(to_ref))) {
         // It may be already marked if we accidentally pushed the same object twice due to the racy
         // bitmap read in MarkUnevacFromSpaceRegion.
         if (use_generational_cc_ && young_gen_) {
@@ -2247,7 +2402,11 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
     case space::RegionSpace::RegionType::kRegionTypeToSpace:
       if (use_generational_cc_) {
         // Copied to to-space, set the bit so that the next GC can scan objects.
-        region_space_bitmap_->Set(to_ref);
+        if (kParallel) {
+          region_space_bitmap_->AtomicTestAndSet(to_ref);
+        } else {
+          region_space_bitmap_->Set(to_ref);
+        }
       }
       perform_scan = true;
       break;
@@ -2278,17 +2437,26 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
               heap_->GetLargeObjectsSpace()->GetMarkBitmap();
           DCHECK(los_bitmap->HasAddress(to_ref));
           // Only the GC thread could be setting the LOS bit map hence doesn't
-          // need to be atomically done.
-          perform_scan = !los_bitmap->Set(to_ref);
+          // need to be atomically done, unless marking in parallel.
+          perform_scan = kParallel ? !los_bitmap->AtomicTestAndSet(to_ref)
+                                   : !los_bitmap->Set(to_ref);
         } else {
           // Only the GC thread could be setting the non-moving space bit map
-          // hence doesn't need to be atomically done.
-          perform_scan = !mark_bitmap->Set(to_ref);
+          // hence doesn't need to be atomically done, unless marking in parallel.
+          perform_scan = kParallel ? !mark_bitmap->AtomicTestAndSet(to_ref)
+                                   : !mark_bitmap->Set(to_ref);
         }
       } else {
         perform_scan = true;
       }
   }
+  if (kParallel && kUseBakerReadBarrier && !perform_scan) {
+    // Another thread won the race for the mark bit and may still be scanning `to_ref`. Do not
+    // touch its read barrier state; the GC-running thread finishes it after the workers are done.
+    MutexLock mu(Thread::Current(), mark_stack_lock_);
+    parallel_mark_deferred_refs_.push_back(to_ref);
+    return;
+  }
   if (perform_scan) {
     if (use_generational_cc_ && young_gen_) {
       Scan<true>(to_ref);
@@ -2335,11 +2503,15 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
 
   if (add_to_live_bytes) {
     // Add to the live bytes per unevacuated from-space. Note this code is always run by the
-    // GC-running thread (no synchronization required).
+    // GC-running thread (no synchronization required), unless marking in parallel.
     DCHECK(region_space_bitmap_->Test(to_ref));
     size_t obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
     size_t alloc_size = RoundUp(obj_size, space::RegionSpace::kAlignment);
-    region_space_->AddLiveBytes(to_ref, alloc_size);
+    if (kParallel) {
+      region_space_->AtomicAddLiveBytes(to_ref, alloc_size);
+    } else {
+      region_space_->AddLiveBytes(to_ref, alloc_size);
+    }
   }
   if (ReadBarrier::kEnableToSpaceInvariantChecks) {
     CHECK(to_ref != nullptr);
@@ -2447,7 +2619,13 @@ void ConcurrentCopying::CheckEmptyMarkStack() {
 void ConcurrentCopying::SweepSystemWeaks(Thread* self) {
   TimingLogger::ScopedTiming split("SweepSystemWeaks", GetTimings());
   ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
-  Runtime::Current()->SweepSystemWeaks(this);
+  // Use less threads if we are in a background state (non jank perceptible) since we want to leave
+  // more CPU time for the foreground apps.
+  const size_t thread_count = (heap_->GetThreadPool() == nullptr ||
+                               !Runtime::Current()->InJankPerceptibleProcessState())
+      ? 1
+      : heap_->GetConcGCThreadCount() + 1;
+  Runtime::Current()->SweepSystemWeaks(this, thread_count);
 }
 
 void ConcurrentCopying::Sweep(bool swap_bitmaps) {
@@ -2723,6 +2901,7 @@ void ConcurrentCopying::ReclaimPhase() {
     const uint64_t unevac_from_objects = region_space_->GetObjectsAllocatedInUnevacFromSpace();
     uint64_t to_bytes = bytes_moved_.load(std::memory_order_relaxed) + bytes_moved_gc_thread_;
     cumulative_bytes_moved_.fetch_add(to_bytes, std::memory_order_relaxed);
+    GetCurrentIteration()->SetCopiedBytes(to_bytes);
     uint64_t to_objects = objects_moved_.load(std::memory_order_relaxed) + objects_moved_gc_thread_;
     cumulative_objects_moved_.fetch_add(to_objects, std::memory_order_relaxed);
     if (kEnableFromSpaceAccountingCheck) {
@@ -2736,6 +2915,15 @@ void ConcurrentCopying::ReclaimPhase() {
       copied_live_bytes_ratio_sum_ += static_cast<float>(to_bytes) / from_bytes;
       gc_count_++;
     }
+    {
+      // The live bytes of the unevacuated regions are lost once ClearFromSpace turns them back
+      // into to-space regions, record them now.
+      MutexLock mu(self, evacuation_stats_lock_);
+      region_space_->AddUnevacFromSpaceLivePercents(&region_live_percent_histogram_);
+      copied_kb_histogram_.AddValue(to_bytes / KB);
+      cumulative_evacuated_bytes_ += from_bytes;
+      cumulative_unevacuated_bytes_ += unevac_from_bytes;
+    }
 
     // Cleared bytes and objects, populated by the call to RegionSpace::ClearFromSpace below.
     uint64_t cleared_bytes;
@@ -3115,7 +3303,7 @@ class ConcurrentCopying::RefFieldsVisitor {
   void operator()(mirror::Object* obj, MemberOffset offset, bool /* is_static */)
       const ALWAYS_INLINE REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES_SHARED(Locks::heap_bitmap_lock_) {
-    collector_->Process<kNoUnEvac>(obj, offset);
+    collector_->Process<kNoUnEvac>(thread_, obj, offset);
   }
 
   void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
@@ -3147,32 +3335,37 @@ template <bool kNoUnEvac>
 inline void ConcurrentCopying::Scan(mirror::Object* to_ref) {
   // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
   DCHECK(!kNoUnEvac || use_generational_cc_);
+  // The GC-running thread, or a GC worker thread during parallel marking.
+  Thread* const self = Thread::Current();
   if (kDisallowReadBarrierDuringScan && !Runtime::Current()->IsActiveTransaction()) {
     // Avoid all read barriers during visit references to help performance.
     // Don't do this in transaction mode because we may read the old value of an field which may
     // trigger read barriers.
-    Thread::Current()->ModifyDebugDisallowReadBarrier(1);
+    self->ModifyDebugDisallowReadBarrier(1);
   }
   DCHECK(!region_space_->IsInFromSpace(to_ref));
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
-  RefFieldsVisitor<kNoUnEvac> visitor(this, thread_running_gc_);
+  DCHECK(IsGcMarkingThread(self));
+  RefFieldsVisitor<kNoUnEvac> visitor(this, self);
   // Disable the read barrier for a performance reason.
   to_ref->VisitReferences</*kVisitNativeRoots=*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
       visitor, visitor);
   if (kDisallowReadBarrierDuringScan && !Runtime::Current()->IsActiveTransaction()) {
-    thread_running_gc_->ModifyDebugDisallowReadBarrier(-1);
+    self->ModifyDebugDisallowReadBarrier(-1);
   }
 }
 
 template <bool kNoUnEvac>
-inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset) {
+inline void ConcurrentCopying::Process(Thread* const self,
+                                      mirror::Object* obj,
+                                      MemberOffset offset) {
   // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
   DCHECK(!kNoUnEvac || use_generational_cc_);
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
+  DCHECK_EQ(Thread::Current(), self);
+  DCHECK(IsGcMarkingThread(self));
   mirror::Object* ref = obj->GetFieldObject<
       mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset);
   mirror::Object* to_ref = Mark</*kGrayImmuneObject=*/false, kNoUnEvac, /*kFromGCThread=*/true>(
-      thread_running_gc_,
+      self,
       ref,
       /*holder=*/ obj,
       offset);
@@ -3830,6 +4023,8 @@ mirror::Object* ConcurrentCopying::MarkFromReadBarrierWithMeasurements(Thread* c
 
 void ConcurrentCopying::DumpPerformanceInfo(std::ostream& os) {
   GarbageCollector::DumpPerformanceInfo(os);
+  // Before taking rb_slow_path_histogram_lock_, both locks are at the same level.
+  DumpEvacuationStats(os);
   size_t num_gc_cycles = GetCumulativeTimings().GetIterations();
   MutexLock mu(Thread::Current(), rb_slow_path_histogram_lock_);
   if (rb_slow_path_time_histogram_.SampleSize() > 0) {
@@ -3865,6 +4060,26 @@ void ConcurrentCopying::DumpPerformanceInfo(std::ostream& os) {
      << ")\n";
 }
 
+void ConcurrentCopying::DumpEvacuationStats(std::ostream& os) {
+  MutexLock mu(Thread::Current(), evacuation_stats_lock_);
+  if (copied_kb_histogram_.SampleSize() == 0) {
+    return;
+  }
+  os << "Cumulative evacuated bytes " << cumulative_evacuated_bytes_ << "\n";
+  os << "Cumulative unevacuated bytes " << cumulative_unevacuated_bytes_ << "\n";
+  os << copied_kb_histogram_.Name() << " mean " << copied_kb_histogram_.Mean() << "KB over "
+     << copied_kb_histogram_.SampleSize() << " GCs ";
+  copied_kb_histogram_.DumpBins(os);
+  os << "\n";
+  if (region_live_percent_histogram_.SampleSize() > 0) {
+    os << region_live_percent_histogram_.Name() << " mean "
+       << region_live_percent_histogram_.Mean() << "% over "
+       << region_live_percent_histogram_.SampleSize() << " regions ";
+    region_live_percent_histogram_.DumpBins(os);
+    os << "\n";
+  }
+}
+
 }  // namespace collector
 }  // namespace gc
 }  // namespace art
@@ -43,6 +43,7 @@ namespace gc {
 namespace accounting {
 template<typename T> class AtomicStack;
 typedef AtomicStack<mirror::Object> ObjectStack;
+template<typename T> class WorkStealingMarkStacks;
 template <size_t kAlignment> class SpaceBitmap;
 typedef SpaceBitmap<kObjectAlignment> ContinuousSpaceBitmap;
 class HeapBitmap;
@@ -180,7 +181,7 @@ class ConcurrentCopying : public GarbageCollector {
       REQUIRES(!mark_stack_lock_);
   // Process a field.
   template <bool kNoUnEvac>
-  void Process(mirror::Object* obj, MemberOffset offset)
+  void Process(Thread* const self, mirror::Object* obj, MemberOffset offset)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_ , !skipped_blocks_lock_, !immune_gray_stack_lock_);
   void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info) override
@@ -201,8 +202,24 @@ class ConcurrentCopying : public GarbageCollector {
   void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   bool ProcessMarkStackOnce() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // If kParallel is true, the ref may be processed by a GC worker thread concurrently with other
+  // refs. Refs that were already marked by another thread are deferred to the GC-running thread.
+  template <bool kParallel = false>
   void ProcessMarkStackRef(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  // Number of threads (including the GC-running thread) to use for parallel marking. Returns 1 if
+  // parallel marking is disabled or not worthwhile in the current process state.
+  size_t GetParallelMarkingThreadCount() const;
+  // Drain the revoked thread-local mark stacks and the GC mark stack using the heap thread pool and
+  // work-stealing deques. Only used in the thread-local mark stack mode. Returns the number of
+  // refs collected from the mark stacks.
+  size_t ProcessMarkStackParallel(size_t thread_count)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Returns true if `self` may scan objects on behalf of the GC, that is, it is the GC-running
+  // thread or a worker thread during parallel marking.
+  bool IsGcMarkingThread(Thread* const self) const {
+    return self == thread_running_gc_ || parallel_marking_active_.load(std::memory_order_relaxed);
+  }
   void GrayAllDirtyImmuneObjects()
       REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
@@ -311,7 +328,11 @@ class ConcurrentCopying : public GarbageCollector {
                                                       mirror::Object* from_ref)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_, !immune_gray_stack_lock_);
-  void DumpPerformanceInfo(std::ostream& os) override REQUIRES(!rb_slow_path_histogram_lock_);
+  void DumpPerformanceInfo(std::ostream& os) override
+      REQUIRES(!rb_slow_path_histogram_lock_, !evacuation_stats_lock_);
+  // Dump the region fragmentation histogram, the evacuated and unevacuated bytes and the bytes
+  // copied per GC cycle. Used by DumpPerformanceInfo() and VMDebug.getRuntimeStat().
+  void DumpEvacuationStats(std::ostream& os) REQUIRES(!evacuation_stats_lock_);
   // Set the read barrier mark entrypoints to non-null.
   void ActivateReadBarrierEntrypoints();
 
@@ -400,6 +421,19 @@ class ConcurrentCopying : public GarbageCollector {
   Atomic<MarkStackMode> mark_stack_mode_;
   bool weak_ref_access_enabled_ GUARDED_BY(Locks::thread_list_lock_);
 
+  // If true, drain the mark stacks with the heap thread pool in the thread-local mark stack mode
+  // (-Xgc:parallel_marking). Set in Heap constructor.
+  const bool use_parallel_marking_;
+  // True while GC worker threads are processing mark stack refs.
+  Atomic<bool> parallel_marking_active_;
+  // Refs that a GC worker thread found already marked by another thread while processing them in
+  // parallel. The GC-running thread finishes them (resets the read barrier state) after the
+  // workers are done, so that a ref is never made non-gray while another thread is still
+  // scanning it.
+  std::vector<mirror::Object*> parallel_mark_deferred_refs_ GUARDED_BY(mark_stack_lock_);
+  // Per-thread deques used to balance the work during parallel marking, created on first use.
+  std::unique_ptr<accounting::WorkStealingMarkStacks<mirror::Object>> work_stealing_mark_stacks_;
+
   // How many objects and bytes we moved. The GC thread moves many more objects
   // than mutators.  Therefore, we separate the two to avoid CAS.  Bytes_moved_ and
   // bytes_moved_gc_thread_ are critical for GC triggering; the others are just informative.
@@ -457,6 +491,15 @@ class ConcurrentCopying : public GarbageCollector {
   uint64_t rb_slow_path_count_total_ GUARDED_BY(rb_slow_path_histogram_lock_);
   uint64_t rb_slow_path_count_gc_total_ GUARDED_BY(rb_slow_path_histogram_lock_);
 
+  // Evacuation statistics, updated in ReclaimPhase and read by DumpEvacuationStats (potentially
+  // from another thread). The region live percentages are those of the unevacuated regions, which
+  // is what kEvacuateLivePercentThreshold in region_space.cc decides on.
+  mutable Mutex evacuation_stats_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  Histogram<uint64_t> region_live_percent_histogram_ GUARDED_BY(evacuation_stats_lock_);
+  Histogram<uint64_t> copied_kb_histogram_ GUARDED_BY(evacuation_stats_lock_);
+  uint64_t cumulative_evacuated_bytes_ GUARDED_BY(evacuation_stats_lock_);
+  uint64_t cumulative_unevacuated_bytes_ GUARDED_BY(evacuation_stats_lock_);
+
   accounting::ReadBarrierTable* rb_table_;
   bool force_evacuate_all_;  // True if all regions are evacuated.
   Atomic<bool> updated_all_immune_objects_;
@@ -490,6 +533,7 @@ class ConcurrentCopying : public GarbageCollector {
   template <bool kConcurrent> class GrayImmuneObjectVisitor;
   class ImmuneSpaceScanObjVisitor;
   class LostCopyVisitor;
+  class ParallelMarkTask;
   template <bool kNoUnEvac> class RefFieldsVisitor;
   class RevokeThreadLocalMarkStackCheckpoint;
   class ScopedGcGraysImmuneObjects;
@@ -56,6 +56,7 @@ void Iteration::Reset(GcCause gc_cause, bool clear_soft_references) {
   freed_ = ObjectBytePair();
   freed_los_ = ObjectBytePair();
   freed_bytes_revoke_ = 0;
+  copied_bytes_ = 0;
 }
 
 uint64_t Iteration::GetEstimatedThroughput() const {
@@ -63,6 +63,13 @@ class Iteration {
   void SetFreedRevoke(uint64_t freed) {
     freed_bytes_revoke_ = freed;
   }
+  // Returns how many bytes a moving collector copied.
+  uint64_t GetCopiedBytes() const {
+    return copied_bytes_;
+  }
+  void SetCopiedBytes(uint64_t copied_bytes) {
+    copied_bytes_ = copied_bytes;
+  }
   void Reset(GcCause gc_cause, bool clear_soft_references);
   // Returns the estimated throughput of the iteration.
   uint64_t GetEstimatedThroughput() const;
@@ -88,6 +95,7 @@ class Iteration {
   ObjectBytePair freed_;
   ObjectBytePair freed_los_;
   uint64_t freed_bytes_revoke_;  // see Heap::num_bytes_freed_revoke_.
+  uint64_t copied_bytes_;
   std::vector<uint64_t> pause_times_;
 
   friend class GarbageCollector;
@@ -35,6 +35,7 @@
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/mod_union_table.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/accounting/work_stealing_deque.h"
 #include "gc/heap.h"
 #include "gc/reference_processor.h"
 #include "gc/space/large_object_space.h"
@@ -65,6 +66,13 @@ static constexpr bool kParallelRecursiveMark = true;
 // ProcessMarkStack with very small mark stacks.
 static constexpr size_t kMinimumParallelMarkStackSize = 128;
 static constexpr bool kParallelProcessMarkStack = true;
+// If true, the parallel mark stack processing uses per-thread work-stealing deques instead of
+// splitting the mark stack into fixed MarkStackTask chunks, so that idle threads steal work from
+// busy ones (e.g. when marking long linked lists) instead of waiting for them.
+static constexpr bool kWorkStealingProcessMarkStack = true;
+// Capacity of each thread's work-stealing deque. Objects that do not fit go to a shared overflow
+// list.
+static constexpr size_t kWorkStealingDequeCapacity = 16 * KB;
 
 // Profiling and information flags.
 static constexpr bool kProfileLargeObjects = false;
@@ -113,6 +121,8 @@ MarkSweep::MarkSweep(Heap* heap, bool is_concurrent, const std::string& name_pre
       << "Couldn't allocate sweep array free buffer: " << error_msg;
 }
 
+MarkSweep::~MarkSweep() {}
+
 void MarkSweep::InitializePhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   mark_stack_ = heap_->GetMarkStack();
@@ -1101,7 +1111,7 @@ void MarkSweep::ReMarkRoots() {
 void MarkSweep::SweepSystemWeaks(Thread* self) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
-  Runtime::Current()->SweepSystemWeaks(this);
+  Runtime::Current()->SweepSystemWeaks(this, GetThreadCount(/* paused= */ !IsConcurrent()));
 }
 
 class MarkSweep::VerifySystemWeakVisitor : public IsMarkedVisitor {
@@ -1389,9 +1399,105 @@ void MarkSweep::ScanObject(mirror::Object* obj) {
   ScanObjectVisit(obj, mark_visitor, ref_visitor);
 }
 
+class MarkSweep::WorkStealingMarkTask : public Task {
+ public:
+  WorkStealingMarkTask(MarkSweep* mark_sweep,
+                       accounting::WorkStealingMarkStacks<mirror::Object>* mark_stacks,
+                       size_t worker_id)
+      : mark_sweep_(mark_sweep), mark_stacks_(mark_stacks), worker_id_(worker_id) {}
+
+  void Finalize() override {
+    delete this;
+  }
+
+  // Scans objects until all the work-stealing deques are empty.
+  void Run(Thread* self ATTRIBUTE_UNUSED) override NO_THREAD_SAFETY_ANALYSIS {
+    MarkObjectVisitor mark_visitor(this);
+    DelayReferenceReferentVisitor ref_visitor(mark_sweep_);
+    for (mirror::Object* obj = mark_stacks_->Pop(worker_id_);
+         obj != nullptr;
+         obj = mark_stacks_->Pop(worker_id_)) {
+      mark_sweep_->ScanObjectVisit(obj, mark_visitor, ref_visitor);
+    }
+  }
+
+ private:
+  class MarkObjectVisitor {
+   public:
+    ALWAYS_INLINE explicit MarkObjectVisitor(WorkStealingMarkTask* task) : task_(task) {}
+
+    ALWAYS_INLINE void operator()(mirror::Object* obj,
+                                  MemberOffset offset,
+                                  bool is_static ATTRIBUTE_UNUSED) const
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      Mark(obj->GetFieldObject<mirror::Object>(offset));
+    }
+
+    void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (!root->IsNull()) {
+        VisitRoot(root);
+      }
+    }
+
+    void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (kCheckLocks) {
+        Locks::mutator_lock_->AssertSharedHeld(Thread::Current());
+        Locks::heap_bitmap_lock_->AssertExclusiveHeld(Thread::Current());
+      }
+      Mark(root->AsMirrorPtr());
+    }
+
+   private:
+    ALWAYS_INLINE void Mark(mirror::Object* ref) const REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (ref != nullptr && task_->mark_sweep_->MarkObjectParallel(ref)) {
+        task_->mark_stacks_->Push(task_->worker_id_, ref);
+      }
+    }
+
+    WorkStealingMarkTask* const task_;
+  };
+
+  MarkSweep* const mark_sweep_;
+  accounting::WorkStealingMarkStacks<mirror::Object>* const mark_stacks_;
+  const size_t worker_id_;
+};
+
+void MarkSweep::ProcessMarkStackWorkStealing(size_t thread_count) {
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = GetHeap()->GetThreadPool();
+  if (work_stealing_mark_stacks_ == nullptr ||
+      work_stealing_mark_stacks_->NumWorkers() != thread_count) {
+    work_stealing_mark_stacks_.reset(new accounting::WorkStealingMarkStacks<mirror::Object>(
+        "mark sweep work-stealing mark stack", thread_count, kWorkStealingDequeCapacity));
+  } else {
+    work_stealing_mark_stacks_->Reset();
+  }
+  // Deal the mark stack out to the workers round-robin. The workers rebalance by stealing.
+  size_t worker = 0;
+  for (auto* it = mark_stack_->Begin(), *end = mark_stack_->End(); it < end; ++it) {
+    work_stealing_mark_stacks_->Push(worker, it->AsMirrorPtr());
+    worker = (worker + 1) % thread_count;
+  }
+  mark_stack_->Reset();
+  // One task per thread, including this one: each task only finishes once all deques are empty.
+  for (size_t i = 0; i < thread_count; ++i) {
+    thread_pool->AddTask(self, new WorkStealingMarkTask(this, work_stealing_mark_stacks_.get(), i));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+}
+
 void MarkSweep::ProcessMarkStackParallel(size_t thread_count) {
   Thread* self = Thread::Current();
   ThreadPool* thread_pool = GetHeap()->GetThreadPool();
+  if (kWorkStealingProcessMarkStack) {
+    ProcessMarkStackWorkStealing(thread_count);
+    return;
+  }
   const size_t chunk_size = std::min(mark_stack_->Size() / thread_count + 1,
                                      static_cast<size_t>(MarkStackTask<false>::kMaxSize));
   CHECK_GT(chunk_size, 0U);
@@ -46,6 +46,7 @@ class Heap;
 
 namespace accounting {
 template<typename T> class AtomicStack;
+template<typename T> class WorkStealingMarkStacks;
 typedef AtomicStack<mirror::Object> ObjectStack;
 }  // namespace accounting
 
@@ -55,7 +56,7 @@ class MarkSweep : public GarbageCollector {
  public:
   MarkSweep(Heap* heap, bool is_concurrent, const std::string& name_prefix = "");
 
-  ~MarkSweep() {}
+  ~MarkSweep();
 
   void RunPhases() override REQUIRES(!mark_stack_lock_);
   void InitializePhase();
@@ -296,6 +297,12 @@ class MarkSweep : public GarbageCollector {
       REQUIRES(!mark_stack_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Drains the mark stack with `thread_count` threads using work-stealing deques.
+  void ProcessMarkStackWorkStealing(size_t thread_count)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES(!mark_stack_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Used to Get around thread safety annotations. The call is from MarkingPhase and is guarded by
   // IsExclusiveHeld.
   void RevokeAllThreadLocalAllocationStacks(Thread* self) NO_THREAD_SAFETY_ANALYSIS;
@@ -314,6 +321,9 @@ class MarkSweep : public GarbageCollector {
 
   accounting::ObjectStack* mark_stack_;
 
+  // Per-thread deques used by ProcessMarkStackWorkStealing, created on first use.
+  std::unique_ptr<accounting::WorkStealingMarkStacks<mirror::Object>> work_stealing_mark_stacks_;
+
   // Every object inside the immune spaces is assumed to be marked. Immune spaces that aren't in the
   // immune region are handled by the normal marking logic.
   ImmuneSpaces immune_spaces_;
@@ -367,6 +377,7 @@ class MarkSweep : public GarbageCollector {
   class VerifyRootMarkedVisitor;
   class VerifyRootVisitor;
   class VerifySystemWeakVisitor;
+  class WorkStealingMarkTask;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkSweep);
 };
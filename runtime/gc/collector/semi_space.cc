@@ -206,6 +206,7 @@ void SemiSpace::MarkingPhase() {
   // Record freed memory.
   const int64_t from_bytes = from_space_->GetBytesAllocated();
   const int64_t to_bytes = bytes_moved_;
+  GetCurrentIteration()->SetCopiedBytes(to_bytes);
   const uint64_t from_objects = from_space_->GetObjectsAllocated();
   const uint64_t to_objects = objects_moved_;
   CHECK_LE(to_objects, from_objects);
@@ -64,6 +64,8 @@ enum GcCause {
   kGcCauseProfileSaver,
   // GC cause for running an empty checkpoint.
   kGcCauseRunEmptyCheckpoint,
+  // Not a real GC cause, used to keep the methods of a staged SIGQUIT dump alive.
+  kGcCauseSigQuitDump,
 };
 
 const char* PrettyCause(GcCause cause);
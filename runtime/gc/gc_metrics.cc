@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gc_metrics.h"
+
+#include <sstream>
+
+#include "base/histogram-inl.h"
+#include "base/time_utils.h"
+#include "collector/iteration.h"
+#include "palette/palette.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace gc {
+
+static constexpr uint64_t kPauseBucketWidthUs = 250;
+static constexpr uint64_t kConcurrentBucketWidthUs = 1000;
+static constexpr size_t kMetricsBucketCount = 32;
+
+GcMetrics::Entry::Entry(const std::string& name)
+    : count(0u),
+      copied_bytes(0u),
+      freed_bytes(0),
+      pause_histogram((name + " pause").c_str(), kPauseBucketWidthUs, kMetricsBucketCount),
+      concurrent_duration_histogram((name + " concurrent").c_str(),
+                                    kConcurrentBucketWidthUs,
+                                    kMetricsBucketCount) {
+}
+
+GcMetrics::GcMetrics()
+    : lock_("gc metrics lock"),
+      last_report_time_ns_(NanoTime()),
+      allocation_stall_count_(0u),
+      allocation_stall_time_ns_(0u),
+      finalizer_batch_count_(0u),
+      finalizer_reference_count_(0u),
+      finalizer_last_batch_size_(0u),
+      finalizer_max_batch_size_(0u) {
+}
+
+void GcMetrics::RecordIteration(const std::string& collector_name,
+                                const collector::Iteration& iteration) {
+  uint64_t total_pause_ns = 0u;
+  for (uint64_t pause_ns : iteration.GetPauseTimes()) {
+    total_pause_ns += pause_ns;
+  }
+  const uint64_t duration_ns = iteration.GetDurationNs();
+  const uint64_t concurrent_ns = duration_ns > total_pause_ns ? duration_ns - total_pause_ns : 0u;
+  const std::pair<std::string, GcCause> key(collector_name, iteration.GetGcCause());
+  MutexLock mu(Thread::Current(), lock_);
+  std::unique_ptr<Entry>& entry = entries_[key];
+  if (entry == nullptr) {
+    entry.reset(new Entry(collector_name));
+  }
+  ++entry->count;
+  entry->copied_bytes += iteration.GetCopiedBytes();
+  entry->freed_bytes += iteration.GetFreedBytes() + iteration.GetFreedLargeObjectBytes();
+  for (uint64_t pause_ns : iteration.GetPauseTimes()) {
+    entry->pause_histogram.AddValue(NsToUs(pause_ns));
+  }
+  entry->concurrent_duration_histogram.AddValue(NsToUs(concurrent_ns));
+}
+
+static void DumpPercentiles(std::ostream& os, const char* prefix, const Histogram<uint64_t>& h) {
+  if (h.SampleSize() == 0) {
+    os << " " << prefix << "_p50_us=0 " << prefix << "_p90_us=0 " << prefix << "_p99_us=0 "
+       << prefix << "_max_us=0";
+    return;
+  }
+  Histogram<uint64_t>::CumulativeData data;
+  h.CreateHistogram(&data);
+  os << " " << prefix << "_p50_us=" << static_cast<uint64_t>(h.Percentile(0.50, data))
+     << " " << prefix << "_p90_us=" << static_cast<uint64_t>(h.Percentile(0.90, data))
+     << " " << prefix << "_p99_us=" << static_cast<uint64_t>(h.Percentile(0.99, data))
+     << " " << prefix << "_max_us=" << h.Max();
+}
+
+void GcMetrics::Dump(std::ostream& os) {
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    for (const auto& pair : entries_) {
+      const Entry& entry = *pair.second;
+      os << "gc collector=\"" << pair.first.first << "\" cause=" << pair.first.second
+         << " count=" << entry.count
+         << " pauses=" << entry.pause_histogram.SampleSize();
+      DumpPercentiles(os, "pause", entry.pause_histogram);
+      DumpPercentiles(os, "concurrent", entry.concurrent_duration_histogram);
+      os << " concurrent_total_us=" << entry.concurrent_duration_histogram.Sum()
+         << " copied_bytes=" << entry.copied_bytes
+         << " freed_bytes=" << entry.freed_bytes << "\n";
+    }
+  }
+  os << "alloc_stall count=" << allocation_stall_count_.load(std::memory_order_relaxed)
+     << " time_us=" << NsToUs(allocation_stall_time_ns_.load(std::memory_order_relaxed)) << "\n";
+  os << "finalizer batches=" << finalizer_batch_count_.load(std::memory_order_relaxed)
+     << " enqueued=" << finalizer_reference_count_.load(std::memory_order_relaxed)
+     << " last_batch=" << finalizer_last_batch_size_.load(std::memory_order_relaxed)
+     << " max_batch=" << finalizer_max_batch_size_.load(std::memory_order_relaxed) << "\n";
+}
+
+void GcMetrics::MaybeReport() {
+  const uint64_t now = NanoTime();
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    if (now - last_report_time_ns_ < kReportIntervalNs) {
+      return;
+    }
+    last_report_time_ns_ = now;
+  }
+  std::ostringstream oss;
+  Dump(oss);
+  const std::string metrics = oss.str();
+  // Not all platforms implement this method, kNotSupported is expected there.
+  PaletteReportGcMetrics(metrics.c_str(), metrics.size());
+}
+
+void GcMetrics::Reset() {
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    entries_.clear();
+    last_report_time_ns_ = NanoTime();
+  }
+  allocation_stall_count_.store(0u, std::memory_order_relaxed);
+  allocation_stall_time_ns_.store(0u, std::memory_order_relaxed);
+  finalizer_batch_count_.store(0u, std::memory_order_relaxed);
+  finalizer_reference_count_.store(0u, std::memory_order_relaxed);
+  finalizer_last_batch_size_.store(0u, std::memory_order_relaxed);
+  finalizer_max_batch_size_.store(0u, std::memory_order_relaxed);
+}
+
+}  // namespace gc
+}  // namespace art
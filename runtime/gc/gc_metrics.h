@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_RUNTIME_GC_GC_METRICS_H_
+#define ART_RUNTIME_GC_GC_METRICS_H_
+
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/atomic.h"
+#include "base/histogram.h"
+#include "base/mutex.h"
+#include "base/time_utils.h"
+#include "gc_cause.h"
+
+namespace art {
+namespace gc {
+
+namespace collector {
+class Iteration;
+}  // namespace collector
+
+// Structured GC statistics, kept per collector and per GC cause. Unlike the SIGQUIT dump, the
+// output of Dump() is meant to be parsed: it is returned by VMDebug.getRuntimeStat() and is
+// periodically pushed to the platform through PaletteReportGcMetrics().
+class GcMetrics {
+ public:
+  // Minimum time between two reports through libartpalette.
+  static constexpr uint64_t kReportIntervalNs = MsToNs(60 * 1000);
+
+  GcMetrics();
+
+  // Record a finished GC iteration of the collector called `collector_name`.
+  void RecordIteration(const std::string& collector_name, const collector::Iteration& iteration)
+      REQUIRES(!lock_);
+
+  // Record a mutator that waited `stall_ns` for a GC to finish before it could allocate.
+  void RecordAllocationStall(uint64_t stall_ns) {
+    allocation_stall_count_.fetch_add(1u, std::memory_order_relaxed);
+    allocation_stall_time_ns_.fetch_add(stall_ns, std::memory_order_relaxed);
+  }
+
+  uint64_t GetAllocationStallTimeNs() const {
+    return allocation_stall_time_ns_.load(std::memory_order_relaxed);
+  }
+
+  // Record that a GC handed `count` finalizable objects to the FinalizerDaemon in one batch.
+  void RecordFinalizerReferences(size_t count) {
+    finalizer_batch_count_.fetch_add(1u, std::memory_order_relaxed);
+    finalizer_reference_count_.fetch_add(count, std::memory_order_relaxed);
+    finalizer_last_batch_size_.store(count, std::memory_order_relaxed);
+    uint64_t max_batch_size = finalizer_max_batch_size_.load(std::memory_order_relaxed);
+    while (count > max_batch_size &&
+           !finalizer_max_batch_size_.CompareAndSetWeakRelaxed(max_batch_size, count)) {
+      max_batch_size = finalizer_max_batch_size_.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Print one line per collector and cause followed by the allocation stall and finalizer
+  // totals, for example:
+  //   gc collector="concurrent copying" cause=Background count=3 pause_p50_us=... ...
+  //   alloc_stall count=1 time_us=1200
+  //   finalizer batches=3 enqueued=250 last_batch=10 max_batch=200
+  // All durations are in microseconds.
+  void Dump(std::ostream& os) REQUIRES(!lock_);
+
+  // Push the metrics through libartpalette if kReportIntervalNs passed since the last report.
+  void MaybeReport() REQUIRES(!lock_);
+
+  void Reset() REQUIRES(!lock_);
+
+ private:
+  struct Entry {
+    explicit Entry(const std::string& name);
+
+    uint64_t count;
+    uint64_t copied_bytes;
+    int64_t freed_bytes;
+    // In microseconds.
+    Histogram<uint64_t> pause_histogram;
+    Histogram<uint64_t> concurrent_duration_histogram;
+  };
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::map<std::pair<std::string, GcCause>, std::unique_ptr<Entry>> entries_ GUARDED_BY(lock_);
+  uint64_t last_report_time_ns_ GUARDED_BY(lock_);
+  Atomic<uint64_t> allocation_stall_count_;
+  Atomic<uint64_t> allocation_stall_time_ns_;
+  // Finalizable objects enqueued by reference processing, see RecordFinalizerReferences().
+  Atomic<uint64_t> finalizer_batch_count_;
+  Atomic<uint64_t> finalizer_reference_count_;
+  Atomic<uint64_t> finalizer_last_batch_size_;
+  Atomic<uint64_t> finalizer_max_batch_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(GcMetrics);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_GC_METRICS_H_
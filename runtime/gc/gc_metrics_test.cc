@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gc_metrics.h"
+
+#include <sstream>
+
+#include "base/time_utils.h"
+#include "collector/iteration.h"
+#include "common_runtime_test.h"
+
+namespace art {
+namespace gc {
+
+class GcMetricsTest : public CommonRuntimeTest {};
+
+TEST_F(GcMetricsTest, RecordIteration) {
+  GcMetrics metrics;
+  collector::Iteration iteration;
+  iteration.Reset(kGcCauseExplicit, /*clear_soft_references=*/ false);
+  iteration.SetCopiedBytes(4 * KB);
+  metrics.RecordIteration("test collector", iteration);
+  metrics.RecordIteration("test collector", iteration);
+  iteration.Reset(kGcCauseBackground, /*clear_soft_references=*/ false);
+  metrics.RecordIteration("test collector", iteration);
+  metrics.RecordAllocationStall(MsToNs(2));
+  metrics.RecordFinalizerReferences(7u);
+  metrics.RecordFinalizerReferences(3u);
+  std::ostringstream oss;
+  metrics.Dump(oss);
+  const std::string output = oss.str();
+  EXPECT_NE(output.find("gc collector=\"test collector\" cause=Explicit count=2 "),
+            std::string::npos) << output;
+  EXPECT_NE(output.find("copied_bytes=8192"), std::string::npos) << output;
+  EXPECT_NE(output.find("gc collector=\"test collector\" cause=Background count=1 "),
+            std::string::npos) << output;
+  EXPECT_NE(output.find("alloc_stall count=1 time_us=2000"), std::string::npos) << output;
+  EXPECT_NE(output.find("finalizer batches=2 enqueued=10 last_batch=3 max_batch=7"),
+            std::string::npos) << output;
+  EXPECT_EQ(metrics.GetAllocationStallTimeNs(), MsToNs(2));
+
+  metrics.Reset();
+  std::ostringstream oss2;
+  metrics.Dump(oss2);
+  EXPECT_EQ(oss2.str(),
+            "alloc_stall count=0 time_us=0\n"
+            "finalizer batches=0 enqueued=0 last_batch=0 max_batch=0\n");
+}
+
+}  // namespace gc
+}  // namespace art
@@ -81,6 +81,7 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   size_t bytes_allocated;
   size_t usable_size;
   size_t new_num_bytes_allocated = 0;
+  bool sample_allocation = false;
   {
     // Do the initial pre-alloc
     pre_object_allocated();
@@ -103,6 +104,9 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
       // non moving space). This can happen if there is significant virtual address space
       // fragmentation.
       pre_object_allocated();
+    } else if (kCheckLargeObject &&
+               UNLIKELY(ShouldAllocNonMovingArray(klass, byte_count, allocator))) {
+      allocator = GetCurrentNonMovingAllocator();
     }
     if (IsTLABAllocator(allocator)) {
       byte_count = RoundUp(byte_count, space::BumpPointerSpace::kAlignment);
@@ -184,6 +188,7 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
         size_t num_bytes_allocated_before =
             num_bytes_allocated_.fetch_add(bytes_tl_bulk_allocated, std::memory_order_relaxed);
         new_num_bytes_allocated = num_bytes_allocated_before + bytes_tl_bulk_allocated;
+        sample_allocation = ShouldSampleAllocation(self, bytes_tl_bulk_allocated);
         // Only trace when we get an increase in the number of bytes allocated. This happens when
         // obtaining a new TLAB and isn't often enough to hurt performance according to golem.
         if (region_space_) {
@@ -230,6 +235,9 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   } else {
     DCHECK(!IsAllocTrackingEnabled());
   }
+  if (UNLIKELY(sample_allocation)) {
+    SampleAllocation(self, &obj, bytes_allocated);
+  }
   if (AllocatorHasAllocationStack(allocator)) {
     PushOnAllocationStack(self, &obj);
   }
@@ -254,6 +262,20 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   return obj.Ptr();
 }
 
+inline bool Heap::ShouldSampleAllocation(Thread* self, size_t bytes_tl_bulk_allocated) {
+  const size_t interval = GetAllocationSamplingInterval();
+  if (LIKELY(interval == 0)) {
+    return false;
+  }
+  const size_t bytes_until_sample = self->GetBytesUntilAllocationSample();
+  if (bytes_tl_bulk_allocated < bytes_until_sample) {
+    self->SetBytesUntilAllocationSample(bytes_until_sample - bytes_tl_bulk_allocated);
+    return false;
+  }
+  self->SetBytesUntilAllocationSample(interval);
+  return true;
+}
+
 // The size of a thread-local allocation stack in the number of references.
 static constexpr size_t kThreadLocalAllocationStackSize = 128;
 
@@ -426,6 +448,14 @@ inline bool Heap::ShouldAllocLargeObject(ObjPtr<mirror::Class> c, size_t byte_co
   return byte_count >= large_object_threshold_ && (c->IsPrimitiveArray() || c->IsStringClass());
 }
 
+inline bool Heap::ShouldAllocNonMovingArray(ObjPtr<mirror::Class> c,
+                                            size_t byte_count,
+                                            AllocatorType allocator) const {
+  return byte_count >= non_moving_array_threshold_ &&
+         allocator != GetCurrentNonMovingAllocator() &&
+         c->IsPrimitiveArray();
+}
+
 inline bool Heap::IsOutOfMemoryOnAllocation(AllocatorType allocator_type,
                                             size_t alloc_size,
                                             bool grow) {
@@ -19,6 +19,9 @@
 
 #include "heap.h"
 
+#include <functional>
+#include <vector>
+
 #include "base/mutex-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/space/bump_pointer_space-walk-inl.h"
@@ -28,6 +31,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -76,27 +80,32 @@ inline void Heap::VisitObjectsPaused(Visitor&& visitor) {
   VisitObjectsInternal(visitor);
 }
 
+inline void Heap::AssertCanVisitRegionSpace(Thread* self) {
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  DCHECK(IsGcConcurrentAndMoving());
+  if (!zygote_creation_lock_.IsExclusiveHeld(self)) {
+    // Exclude the pre-zygote fork time where the semi-space collector
+    // calls VerifyHeapReferences() as part of the zygote compaction
+    // which then would call here without the moving GC disabled,
+    // which is fine.
+    bool is_thread_running_gc = false;
+    if (kIsDebugBuild) {
+      MutexLock mu(self, *gc_complete_lock_);
+      is_thread_running_gc = self == thread_running_gc_;
+    }
+    // If we are not the thread running the GC on in a GC exclusive region, then moving GC
+    // must be disabled.
+    DCHECK(is_thread_running_gc || IsMovingGCDisabled(self));
+  }
+}
+
 // Visit objects in the region spaces.
 template <typename Visitor>
 inline void Heap::VisitObjectsInternalRegionSpace(Visitor&& visitor) {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertExclusiveHeld(self);
   if (region_space_ != nullptr) {
-    DCHECK(IsGcConcurrentAndMoving());
-    if (!zygote_creation_lock_.IsExclusiveHeld(self)) {
-      // Exclude the pre-zygote fork time where the semi-space collector
-      // calls VerifyHeapReferences() as part of the zygote compaction
-      // which then would call here without the moving GC disabled,
-      // which is fine.
-      bool is_thread_running_gc = false;
-      if (kIsDebugBuild) {
-        MutexLock mu(self, *gc_complete_lock_);
-        is_thread_running_gc = self == thread_running_gc_;
-      }
-      // If we are not the thread running the GC on in a GC exclusive region, then moving GC
-      // must be disabled.
-      DCHECK(is_thread_running_gc || IsMovingGCDisabled(self));
-    }
+    AssertCanVisitRegionSpace(self);
     region_space_->Walk(visitor);
   }
 }
@@ -108,8 +117,18 @@ inline void Heap::VisitObjectsInternal(Visitor&& visitor) {
     // Visit objects in bump pointer space.
     bump_pointer_space_->Walk(visitor);
   }
-  // TODO: Switch to standard begin and end to use ranged a based loop.
-  for (auto* it = allocation_stack_->Begin(), *end = allocation_stack_->End(); it < end; ++it) {
+  VisitAllocationStackRange(allocation_stack_->Begin(), allocation_stack_->End(), visitor);
+  {
+    ReaderMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+    GetLiveBitmap()->Visit<Visitor>(visitor);
+  }
+}
+
+template <typename Visitor>
+inline void Heap::VisitAllocationStackRange(StackReference<mirror::Object>* begin,
+                                            StackReference<mirror::Object>* end,
+                                            Visitor&& visitor) {
+  for (StackReference<mirror::Object>* it = begin; it < end; ++it) {
     mirror::Object* const obj = it->AsMirrorPtr();
 
     mirror::Class* kls = nullptr;
@@ -157,10 +176,69 @@ inline void Heap::VisitObjectsInternal(Visitor&& visitor) {
       visitor(obj);
     }
   }
-  {
-    ReaderMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
-    GetLiveBitmap()->Visit<Visitor>(visitor);
+}
+
+template <typename Visitor>
+void Heap::VisitObjectsPausedParallel(Visitor&& visitor) {
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  ThreadPool* thread_pool = GetThreadPool();
+  if (thread_pool == nullptr) {
+    VisitObjectsPaused(visitor);
+    return;
+  }
+  // Sizes of the chunks given to the workers.
+  static constexpr size_t kRegionsPerChunk = 16;
+  static constexpr size_t kAllocationStackEntriesPerChunk = 4 * KB;
+  static constexpr size_t kBitmapBytesPerChunk = 4 * MB;
+  std::vector<std::function<void()>> chunks;
+  if (region_space_ != nullptr) {
+    AssertCanVisitRegionSpace(self);
+    const size_t num_regions = region_space_->GetNumRegions();
+    for (size_t begin = 0; begin < num_regions; begin += kRegionsPerChunk) {
+      const size_t end = std::min(begin + kRegionsPerChunk, num_regions);
+      chunks.push_back([this, begin, end, &visitor]() NO_THREAD_SAFETY_ANALYSIS {
+        region_space_->WalkRegions(begin, end, visitor);
+      });
+    }
+  }
+  if (bump_pointer_space_ != nullptr) {
+    chunks.push_back([this, &visitor]() NO_THREAD_SAFETY_ANALYSIS {
+      bump_pointer_space_->Walk(visitor);
+    });
+  }
+  StackReference<mirror::Object>* const stack_end = allocation_stack_->End();
+  for (StackReference<mirror::Object>* begin = allocation_stack_->Begin();
+       begin < stack_end;
+       begin += kAllocationStackEntriesPerChunk) {
+    StackReference<mirror::Object>* end =
+        std::min(begin + kAllocationStackEntriesPerChunk, stack_end);
+    chunks.push_back([this, begin, end, &visitor]() NO_THREAD_SAFETY_ANALYSIS {
+      VisitAllocationStackRange(begin, end, visitor);
+    });
+  }
+  ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  for (accounting::ContinuousSpaceBitmap* bitmap : live_bitmap_->continuous_space_bitmaps_) {
+    const uintptr_t limit = bitmap->HeapLimit();
+    for (uintptr_t begin = bitmap->HeapBegin(); begin < limit; begin += kBitmapBytesPerChunk) {
+      const uintptr_t end = std::min(begin + kBitmapBytesPerChunk, limit);
+      chunks.push_back([bitmap, begin, end, &visitor]() NO_THREAD_SAFETY_ANALYSIS {
+        bitmap->VisitMarkedRange(begin, end, visitor);
+      });
+    }
+  }
+  for (accounting::LargeObjectBitmap* bitmap : live_bitmap_->large_object_bitmaps_) {
+    chunks.push_back([bitmap, &visitor]() NO_THREAD_SAFETY_ANALYSIS {
+      bitmap->VisitMarkedRange(bitmap->HeapBegin(), bitmap->HeapLimit(), visitor);
+    });
+  }
+  for (const std::function<void()>& chunk : chunks) {
+    thread_pool->AddTask(self, new FunctionTask([&chunk](Thread*) { chunk(); }));
   }
+  thread_pool->SetMaxActiveWorkers(thread_pool->GetThreadCount());
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
 }
 
 }  // namespace gc
@@ -22,9 +22,13 @@
 #include <malloc.h>  // For mallinfo()
 #endif
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "android-base/file.h"
 #include "android-base/stringprintf.h"
+#include "android-base/strings.h"
 
 #include "allocation_listener.h"
 #include "art_field-inl.h"
@@ -58,6 +62,7 @@
 #include "gc/collector/partial_mark_sweep.h"
 #include "gc/collector/semi_space.h"
 #include "gc/collector/sticky_mark_sweep.h"
+#include "gc/gc_metrics.h"
 #include "gc/racing_check.h"
 #include "gc/reference_processor.h"
 #include "gc/scoped_gc_critical_section.h"
@@ -108,6 +113,12 @@ DEFINE_RUNTIME_DEBUG_FLAG(Heap, kStressCollectorTransition);
 // Minimum amount of remaining bytes before a concurrent GC is triggered.
 static constexpr size_t kMinConcurrentRemainingBytes = 128 * KB;
 static constexpr size_t kMaxConcurrentRemainingBytes = 512 * KB;
+// With -Xgc:pacing, how much earlier than the measured allocation rate requires a concurrent GC
+// starts, and the fraction of the heap between concurrent_start_bytes_ and the target footprint
+// after which allocations start being delayed, up to kMaxAllocationPacingDelayNs per allocation.
+static constexpr double kGcPacingHeadroom = 1.5;
+static constexpr double kAllocationPacingStartFraction = 0.5;
+static constexpr uint64_t kMaxAllocationPacingDelayNs = MsToNs(2);
 // Sticky GC throughput adjustment, divided by 4. Increasing this causes sticky GC to occur more
 // relative to partial/full GC. This may be desirable since sticky GCs interfere less with mutator
 // threads (lower pauses, use less memory bandwidth).
@@ -224,6 +235,7 @@ Heap::Heap(size_t initial_size,
            CollectorType background_collector_type,
            space::LargeObjectSpaceType large_object_space_type,
            size_t large_object_threshold,
+           size_t non_moving_array_threshold,
            size_t parallel_gc_threads,
            size_t conc_gc_threads,
            bool low_memory_mode,
@@ -241,9 +253,13 @@ Heap::Heap(size_t initial_size,
            bool measure_gc_performance,
            bool use_homogeneous_space_compaction_for_oom,
            bool use_generational_cc,
+           bool use_parallel_cc_marking,
+           bool use_gc_pacing,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
            bool dump_region_info_after_gc,
+           bool group_zygote_dirty_objects,
+           const std::string& zygote_dirty_classes_profile,
            space::ImageSpaceLoadingOrder image_space_loading_order)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
@@ -268,6 +284,7 @@ Heap::Heap(size_t initial_size,
       zygote_creation_lock_("zygote creation lock", kZygoteCreationLock),
       zygote_space_(nullptr),
       large_object_threshold_(large_object_threshold),
+      non_moving_array_threshold_(non_moving_array_threshold),
       disable_thread_flip_count_(0),
       thread_flip_running_(false),
       collector_type_running_(kCollectorTypeNone),
@@ -288,6 +305,11 @@ Heap::Heap(size_t initial_size,
       num_bytes_allocated_(0),
       native_bytes_registered_(0),
       old_native_bytes_allocated_(0),
+      rss_after_last_gc_(0),
+      java_bytes_after_last_gc_(0),
+      last_rss_sample_time_ns_(0),
+      last_rss_gc_request_time_ns_(0),
+      rss_gc_requests_(0),
       native_objects_notified_(0),
       num_bytes_freed_revoke_(0),
       verify_missing_card_marks_(false),
@@ -335,6 +357,11 @@ Heap::Heap(size_t initial_size,
       pending_heap_trim_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
+      use_parallel_cc_marking_(use_parallel_cc_marking),
+      use_gc_pacing_(use_gc_pacing),
+      last_gc_end_time_ns_(0u),
+      last_gc_bytes_allocated_(0u),
+      total_allocation_pacing_time_ns_(0u),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
       blocking_gc_time_(0U),
@@ -347,12 +374,16 @@ Heap::Heap(size_t initial_size,
                                         kGcCountRateMaxBucketCount),
       alloc_tracking_enabled_(false),
       alloc_record_depth_(AllocRecordObjectMap::kDefaultAllocStackDepth),
+      alloc_sampling_interval_(0u),
       backtrace_lock_(nullptr),
       seen_backtrace_count_(0u),
       unique_backtrace_count_(0u),
       gc_disabled_for_shutdown_(false),
       dump_region_info_before_gc_(dump_region_info_before_gc),
       dump_region_info_after_gc_(dump_region_info_after_gc),
+      group_zygote_dirty_objects_(group_zygote_dirty_objects ||
+                                  !zygote_dirty_classes_profile.empty()),
+      zygote_dirty_classes_profile_(zygote_dirty_classes_profile),
       boot_image_spaces_(),
       boot_images_start_address_(0u),
       boot_images_size_(0u) {
@@ -369,6 +400,7 @@ Heap::Heap(size_t initial_size,
   }
   verification_.reset(new Verification(this));
   CHECK_GE(large_object_threshold, kMinLargeObjectThreshold);
+  CHECK_GE(non_moving_array_threshold, kMinLargeObjectThreshold);
   ScopedTrace trace(__FUNCTION__);
   Runtime* const runtime = Runtime::Current();
   // If we aren't the zygote, switch to the default non zygote allocator. This may update the
@@ -600,6 +632,11 @@ Heap::Heap(size_t initial_size,
   } else if (large_object_space_type == space::LargeObjectSpaceType::kMap) {
     large_object_space_ = space::LargeObjectMapSpace::Create("mem map large object space");
     CHECK(large_object_space_ != nullptr) << "Failed to create large object space";
+  } else if (large_object_space_type == space::LargeObjectSpaceType::kCachedMap) {
+    large_object_space_ = space::LargeObjectMapSpace::Create(
+        "mem map large object space",
+        space::LargeObjectMapSpace::kDefaultMapCacheCapacity);
+    CHECK(large_object_space_ != nullptr) << "Failed to create large object space";
   } else {
     // Disable the large object space by making the cutoff excessively large.
     large_object_threshold_ = std::numeric_limits<size_t>::max();
@@ -670,6 +707,7 @@ Heap::Heap(size_t initial_size,
   thread_flip_cond_.reset(new ConditionVariable("GC thread flip condition variable",
                                                 *thread_flip_lock_));
   task_processor_.reset(new TaskProcessor());
+  gc_metrics_.reset(new GcMetrics());
   reference_processor_.reset(new ReferenceProcessor());
   pending_task_lock_ = new Mutex("Pending task lock");
   if (ignore_target_footprint_) {
@@ -887,6 +925,22 @@ void Heap::DecrementDisableMovingGC(Thread* self) {
   --disable_moving_gc_count_;
 }
 
+bool Heap::TryPinObject(ObjPtr<mirror::Object> obj) {
+  if (!kUseReadBarrier || region_space_ == nullptr || !region_space_->HasAddress(obj.Ptr())) {
+    return false;
+  }
+  region_space_->PinRegion(obj.Ptr());
+  return true;
+}
+
+bool Heap::UnpinObject(ObjPtr<mirror::Object> obj) {
+  if (!kUseReadBarrier || region_space_ == nullptr || !region_space_->HasAddress(obj.Ptr())) {
+    return false;
+  }
+  region_space_->UnpinRegion(obj.Ptr());
+  return true;
+}
+
 void Heap::IncrementDisableThreadFlip(Thread* self) {
   // Supposed to be called by mutators. If thread_flip_running_ is true, block. Otherwise, go ahead.
   CHECK(kUseReadBarrier);
@@ -1172,6 +1226,10 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   }
   os << "Total mutator paused time: " << PrettyDuration(total_paused_time) << "\n";
   os << "Total time waiting for GC to complete: " << PrettyDuration(total_wait_time_) << "\n";
+  if (use_gc_pacing_) {
+    os << "Total allocation pacing time: "
+       << PrettyDuration(total_allocation_pacing_time_ns_.load(std::memory_order_relaxed)) << "\n";
+  }
   os << "Total GC count: " << GetGcCount() << "\n";
   os << "Total GC time: " << PrettyDuration(GetGcTime()) << "\n";
   os << "Total blocking GC count: " << GetBlockingGcCount() << "\n";
@@ -1201,6 +1259,14 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
 
   os << "Total native bytes at last GC: "
      << old_native_bytes_allocated_.load(std::memory_order_relaxed) << "\n";
+  os << "Process RSS at last GC: " << PrettySize(rss_after_last_gc_.load(std::memory_order_relaxed))
+     << " GCs requested for RSS growth: " << rss_gc_requests_.load(std::memory_order_relaxed)
+     << "\n";
+
+  if (region_space_ != nullptr) {
+    os << "Region space TLAB refills: " << region_space_->GetTlabRefillCount()
+       << " wasted TLAB bytes: " << PrettySize(region_space_->GetTlabWastedBytes()) << "\n";
+  }
 
   BaseMutex::DumpAll(os);
 }
@@ -1221,8 +1287,10 @@ void Heap::ResetGcPerformanceInfo() {
   total_bytes_freed_ever_.store(0);
   total_objects_freed_ever_.store(0);
   total_wait_time_ = 0;
+  total_allocation_pacing_time_ns_.store(0u, std::memory_order_relaxed);
   blocking_gc_count_ = 0;
   blocking_gc_time_ = 0;
+  gc_metrics_->Reset();
   gc_count_last_window_ = 0;
   blocking_gc_count_last_window_ = 0;
   last_update_time_gc_count_rate_histograms_ =  // Round down by the window duration.
@@ -1272,6 +1340,21 @@ void Heap::DumpBlockingGcCountRateHistogram(std::ostream& os) const {
   }
 }
 
+void Heap::DumpRegionEvacuationStats(std::ostream& os) const {
+  if (young_concurrent_copying_collector_ != nullptr) {
+    os << "Young GC:\n";
+    young_concurrent_copying_collector_->DumpEvacuationStats(os);
+  }
+  if (concurrent_copying_collector_ != nullptr) {
+    os << "Full GC:\n";
+    concurrent_copying_collector_->DumpEvacuationStats(os);
+  }
+}
+
+void Heap::DumpGcMetrics(std::ostream& os) const {
+  gc_metrics_->Dump(os);
+}
+
 ALWAYS_INLINE
 static inline AllocationListener* GetAndOverwriteAllocationListener(
     Atomic<AllocationListener*>* storage, AllocationListener* new_value) {
@@ -1284,6 +1367,7 @@ Heap::~Heap() {
   // If we don't reset then the mark stack complains in its destructor.
   allocation_stack_->Reset();
   allocation_records_.reset();
+  allocation_samples_.reset();
   live_stack_->Reset();
   STLDeleteValues(&mod_union_tables_);
   STLDeleteValues(&remembered_sets_);
@@ -1426,7 +1510,22 @@ void Heap::DoPendingCollectorTransition() {
 }
 
 void Heap::Trim(Thread* self) {
+  TrimProgress progress;
+  bool finished = Trim(self, std::numeric_limits<uint64_t>::max(), &progress);
+  DCHECK(finished);
+}
+
+bool Heap::Trim(Thread* self, uint64_t deadline_ns, TrimProgress* progress) {
   Runtime* const runtime = Runtime::Current();
+  if (progress->started) {
+    // Resume trimming the spaces, the rest was done by the first slice.
+    if (!TrimSpaces(self, deadline_ns, progress)) {
+      return false;
+    }
+    *progress = TrimProgress();
+    runtime->GetArenaPool()->TrimMaps();
+    return true;
+  }
   if (!CareAboutPauseTimes()) {
     // Deflate the monitors, this can cause a pause but shouldn't matter since we don't care
     // about pauses.
@@ -1440,9 +1539,13 @@ void Heap::Trim(Thread* self) {
         << PrettyDuration(NanoTime() - start_time);
   }
   TrimIndirectReferenceTables(self);
-  TrimSpaces(self);
+  if (!TrimSpaces(self, deadline_ns, progress)) {
+    progress->started = true;
+    return false;
+  }
   // Trim arenas that may have been used by JIT or verifier.
   runtime->GetArenaPool()->TrimMaps();
+  return true;
 }
 
 class TrimIndirectReferenceTableClosure : public Closure {
@@ -1488,7 +1591,7 @@ void Heap::StartGC(Thread* self, GcCause cause, CollectorType collector_type) {
   thread_running_gc_ = self;
 }
 
-void Heap::TrimSpaces(Thread* self) {
+bool Heap::TrimSpaces(Thread* self, uint64_t deadline_ns, TrimProgress* progress) {
   // Pretend we are doing a GC to prevent background compaction from deleting the space we are
   // trimming.
   StartGC(self, kGcCauseTrim, kCollectorTypeHeapTrim);
@@ -1498,20 +1601,46 @@ void Heap::TrimSpaces(Thread* self) {
   uint64_t total_alloc_space_allocated = 0;
   uint64_t total_alloc_space_size = 0;
   uint64_t managed_reclaimed = 0;
+  bool finished = true;
   {
     ScopedObjectAccess soa(self);
+    size_t malloc_space_index = 0;
     for (const auto& space : continuous_spaces_) {
       if (space->IsMallocSpace()) {
         gc::space::MallocSpace* malloc_space = space->AsMallocSpace();
-        if (malloc_space->IsRosAllocSpace() || !CareAboutPauseTimes()) {
-          // Don't trim dlmalloc spaces if we care about pauses since this can hold the space lock
-          // for a long period of time.
-          managed_reclaimed += malloc_space->Trim();
-        }
         total_alloc_space_size += malloc_space->Size();
+        // Skip the spaces trimmed by the previous slices, and the rest once out of time.
+        const size_t index = malloc_space_index++;
+        if (!finished || index < progress->malloc_space_index) {
+          continue;
+        }
+        if (progress->resume_point == 0 && NanoTime() >= deadline_ns) {
+          progress->malloc_space_index = index;
+          finished = false;
+          continue;
+        }
+        // Trim in short chunks and check for suspension in between, so that trimming a large
+        // space does not delay a GC pause or a checkpoint. A chunk holds the space lock for at
+        // most one walk of a dlmalloc space, so dlmalloc spaces such as the CC non-moving space
+        // are trimmed even if we care about pause times.
+        do {
+          const uint64_t chunk_deadline_ns =
+              std::min(deadline_ns, NanoTime() + kHeapTrimChunkBudget);
+          managed_reclaimed +=
+              malloc_space->TrimIncrementally(&progress->resume_point, chunk_deadline_ns);
+          self->AllowThreadSuspension();
+        } while (progress->resume_point != 0 && NanoTime() < deadline_ns);
+        if (progress->resume_point != 0) {
+          progress->malloc_space_index = index;
+          finished = false;
+        }
       }
     }
   }
+  if (finished && large_object_space_ != nullptr) {
+    // Release the mappings the large object space keeps for reuse.
+    managed_reclaimed += large_object_space_->Trim();
+  }
   total_alloc_space_allocated = GetBytesAllocated();
   if (large_object_space_ != nullptr) {
     total_alloc_space_allocated -= large_object_space_->GetBytesAllocated();
@@ -1530,7 +1659,9 @@ void Heap::TrimSpaces(Thread* self) {
 
   VLOG(heap) << "Heap trim of managed (duration=" << PrettyDuration(gc_heap_end_ns - start_ns)
       << ", advised=" << PrettySize(managed_reclaimed) << ") heap. Managed heap utilization of "
-      << static_cast<int>(100 * managed_utilization) << "%.";
+      << static_cast<int>(100 * managed_utilization) << "%."
+      << (finished ? "" : " Trim to be resumed.");
+  return finished;
 }
 
 bool Heap::IsValidObjectAddress(const void* addr) const {
@@ -2193,7 +2324,8 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
       : SemiSpace(heap, "zygote collector"),
         bin_live_bitmap_(nullptr),
         bin_mark_bitmap_(nullptr),
-        is_running_on_memory_tool_(is_running_on_memory_tool) {}
+        is_running_on_memory_tool_(is_running_on_memory_tool),
+        dirty_object_space_(nullptr) {}
 
   void BuildBins(space::ContinuousSpace* space) REQUIRES_SHARED(Locks::mutator_lock_) {
     bin_live_bitmap_ = space->GetLiveBitmap();
@@ -2213,6 +2345,41 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
     AddBin(reinterpret_cast<uintptr_t>(space->End()) - prev, prev);
   }
 
+  void SetDirtyClasses(std::unordered_set<std::string>&& dirty_classes) {
+    dirty_classes_ = std::move(dirty_classes);
+  }
+
+  // Copy the objects IsLikelyDirty() accepts to `dirty_object_space` rather than to the bins or
+  // the target space, while it has room.
+  void SetDirtyObjectSpace(space::BumpPointerSpace* dirty_object_space) {
+    dirty_object_space_ = dirty_object_space;
+  }
+
+  // Whether apps are likely to write to `obj` after fork: classes get initialized and have their
+  // statics written, dex caches get resolved entries, references get cleared and enqueued, and
+  // plain objects and objects with an inflated monitor are used as locks. Objects of the classes
+  // listed in the profile also count.
+  bool IsLikelyDirty(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    ObjPtr<mirror::Class> klass = obj->GetClass<kDefaultVerifyFlags, kWithoutReadBarrier>();
+    if (klass->IsClassClass() ||
+        klass->IsDexCacheClass() ||
+        klass->IsTypeOfReferenceClass() ||
+        klass->IsObjectClass() ||
+        obj->GetLockWord(false).GetState() == LockWord::kFatLocked) {
+      return true;
+    }
+    if (dirty_classes_.empty()) {
+      return false;
+    }
+    auto it = class_is_dirty_.find(klass.Ptr());
+    if (it == class_is_dirty_.end()) {
+      std::string temp;
+      const bool is_dirty = dirty_classes_.count(klass->GetDescriptor(&temp)) != 0u;
+      it = class_is_dirty_.emplace(klass.Ptr(), is_dirty).first;
+    }
+    return it->second;
+  }
+
  private:
   // Maps from bin sizes to locations.
   std::multimap<size_t, uintptr_t> bins_;
@@ -2221,6 +2388,12 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
   // Mark bitmap of the space which contains the bins.
   accounting::ContinuousSpaceBitmap* bin_mark_bitmap_;
   const bool is_running_on_memory_tool_;
+  // Where the likely dirty objects go, null if they are not grouped.
+  space::BumpPointerSpace* dirty_object_space_;
+  // Descriptors of the classes from the dirty classes profile.
+  std::unordered_set<std::string> dirty_classes_;
+  // Cache of the profile lookups by class.
+  std::unordered_map<mirror::Class*, bool> class_is_dirty_;
 
   void AddBin(size_t size, uintptr_t position) {
     if (is_running_on_memory_tool_) {
@@ -2241,10 +2414,19 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
       REQUIRES(Locks::heap_bitmap_lock_, Locks::mutator_lock_) {
     size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
     size_t alloc_size = RoundUp(obj_size, kObjectAlignment);
-    mirror::Object* forward_address;
+    mirror::Object* forward_address = nullptr;
     // Find the smallest bin which we can move obj in.
     auto it = bins_.lower_bound(alloc_size);
-    if (it == bins_.end()) {
+    if (dirty_object_space_ != nullptr && IsLikelyDirty(obj)) {
+      size_t bytes_allocated, dummy;
+      forward_address =
+          dirty_object_space_->Alloc(self_, alloc_size, &bytes_allocated, nullptr, &dummy);
+    }
+    if (forward_address != nullptr) {
+      // The dirty object space follows the end of the non moving space, like the target space.
+      GetHeap()->GetNonMovingSpace()->GetLiveBitmap()->Set(forward_address);
+      GetHeap()->GetNonMovingSpace()->GetMarkBitmap()->Set(forward_address);
+    } else if (it == bins_.end()) {
       // No available space in the bins, place it in the target space instead (grows the zygote
       // space).
       size_t bytes_allocated, dummy;
@@ -2309,6 +2491,56 @@ void Heap::IncrementFreedEver() {
 #  pragma clang diagnostic ignored "-Wframe-larger-than="
 #endif
 // This has a large frame, but shouldn't be run anywhere near the stack limit.
+// Read the class descriptors of a -XX:ZygoteDirtyClassesProfile file: one descriptor per line, or
+// imgdiag "Dirty object count by class" lines, which end with "class descriptor: '<descriptor>')".
+static std::unordered_set<std::string> LoadZygoteDirtyClasses(const std::string& profile) {
+  std::unordered_set<std::string> dirty_classes;
+  if (profile.empty()) {
+    return dirty_classes;
+  }
+  std::string contents;
+  if (!android::base::ReadFileToString(profile, &contents)) {
+    PLOG(WARNING) << "Failed to read zygote dirty classes profile " << profile;
+    return dirty_classes;
+  }
+  static constexpr const char* kImgdiagDescriptorPrefix = "class descriptor: '";
+  for (const std::string& line : android::base::Split(contents, "\n")) {
+    std::string descriptor = android::base::Trim(line);
+    const size_t prefix_pos = descriptor.find(kImgdiagDescriptorPrefix);
+    if (prefix_pos != std::string::npos) {
+      descriptor = descriptor.substr(prefix_pos + strlen(kImgdiagDescriptorPrefix));
+      descriptor = descriptor.substr(0, descriptor.find('\''));
+    }
+    if (!descriptor.empty() && descriptor[0] != '#') {
+      dirty_classes.insert(descriptor);
+    }
+  }
+  return dirty_classes;
+}
+
+// Returns how many bytes of the objects in `from_space` `collector` is going to group as likely
+// dirty.
+static size_t CountZygoteDirtyBytes(ZygoteCompactingCollector* collector,
+                                    space::ContinuousSpace* from_space)
+    NO_THREAD_SAFETY_ANALYSIS {
+  ScopedSuspendAll ssa(__FUNCTION__);
+  size_t dirty_bytes = 0u;
+  auto visitor = [&](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (collector->IsLikelyDirty(obj)) {
+      dirty_bytes += RoundUp(obj->SizeOf<kDefaultVerifyFlags>(), kObjectAlignment);
+    }
+  };
+  if (from_space->IsRegionSpace()) {
+    from_space->AsRegionSpace()->Walk(visitor);
+  } else if (from_space->IsBumpPointerSpace()) {
+    from_space->AsBumpPointerSpace()->Walk(visitor);
+  } else {
+    ReaderMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+    from_space->GetLiveBitmap()->Walk(visitor);
+  }
+  return dirty_bytes;
+}
+
 void Heap::PreZygoteFork() {
   if (!HasZygoteSpace()) {
     // We still want to GC in case there is some unreachable non moving objects that could cause a
@@ -2337,8 +2569,32 @@ void Heap::PreZygoteFork() {
     ScopedDisableRosAllocVerification disable_rosalloc_verif(this);
     ZygoteCompactingCollector zygote_collector(this, is_running_on_memory_tool_);
     zygote_collector.BuildBins(non_moving_space_);
+    uint8_t* target_begin = non_moving_space_->End();
+    std::unique_ptr<space::BumpPointerSpace> dirty_object_space;
+    if (group_zygote_dirty_objects_) {
+      // Reserve whole pages for the likely dirty objects between the end of the non moving space
+      // and the target space. The reservation is an estimate, objects which do not fit are
+      // compacted as usual.
+      space::ContinuousSpace* from_space = main_space_;
+      if (collector_type_ == kCollectorTypeCC) {
+        from_space = region_space_;
+      } else if (IsMovingGc(collector_type_)) {
+        from_space = bump_pointer_space_;
+      }
+      zygote_collector.SetDirtyClasses(LoadZygoteDirtyClasses(zygote_dirty_classes_profile_));
+      const size_t dirty_bytes = CountZygoteDirtyBytes(&zygote_collector, from_space);
+      uint8_t* dirty_begin = AlignUp(non_moving_space_->End(), kPageSize);
+      uint8_t* dirty_end = dirty_begin + RoundUp(dirty_bytes, kPageSize);
+      if (dirty_bytes != 0u && dirty_end <= non_moving_space_->Limit()) {
+        dirty_object_space.reset(
+            new space::BumpPointerSpace("zygote dirty bump space", dirty_begin, dirty_end));
+        zygote_collector.SetDirtyObjectSpace(dirty_object_space.get());
+        target_begin = dirty_end;
+      }
+      VLOG(heap) << "Grouping " << PrettySize(dirty_bytes) << " of likely dirty zygote objects";
+    }
     // Create a new bump pointer space which we will compact into.
-    space::BumpPointerSpace target_space("zygote bump space", non_moving_space_->End(),
+    space::BumpPointerSpace target_space("zygote bump space", target_begin,
                                          non_moving_space_->Limit());
     // Compact the bump pointer space to a new zygote bump pointer space.
     bool reset_main_space = false;
@@ -2522,6 +2778,8 @@ collector::GarbageCollector* Heap::Compact(space::ContinuousMemMapAllocSpace* ta
 
 void Heap::TraceHeapSize(size_t heap_size) {
   ATraceIntegerValue("Heap size (KB)", heap_size / KB);
+  // Native memory of the runtime is sampled at the same points.
+  TrackedAllocators::TraceCounters();
 }
 
 #if defined(__GLIBC__)
@@ -2567,7 +2825,8 @@ size_t Heap::GetNativeBytes() {
   // An alternative would be to get RSS from /proc/self/statm. Empirically, that's no
   // more expensive, and it would allow us to count memory allocated by means other than malloc.
   // However it would change as pages are unmapped and remapped due to memory pressure, among
-  // other things. It seems risky to trigger GCs as a result of such changes.
+  // other things. It seems risky to trigger GCs as a result of such changes, so RSS is only used
+  // as a rate-limited secondary trigger, see NativeRssOverTarget().
 }
 
 collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
@@ -2676,7 +2935,14 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   // Grow the heap so that we know when to perform the next GC.
   GrowForUtilization(collector, bytes_allocated_before_gc);
   LogGC(gc_cause, collector);
+  gc_metrics_->RecordIteration(collector->GetName(), *GetCurrentGcIteration());
+  if (gc_cause == kGcCauseForAlloc) {
+    // The allocating thread ran the GC itself and could not allocate until it finished.
+    gc_metrics_->RecordAllocationStall(GetCurrentGcIteration()->GetDurationNs());
+    self->AddAllocationStallTime(GetCurrentGcIteration()->GetDurationNs());
+  }
   FinishGC(self, gc_type);
+  gc_metrics_->MaybeReport();
   // Actually enqueue all cleared references. Do this after the GC has officially finished since
   // otherwise we can deadlock.
   clear->Run(self);
@@ -2685,6 +2951,8 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   Dbg::GcDidFinish();
 
   old_native_bytes_allocated_.store(GetNativeBytes());
+  rss_after_last_gc_.store(GetResidentSetSize(), std::memory_order_relaxed);
+  java_bytes_after_last_gc_.store(GetBytesAllocated(), std::memory_order_relaxed);
 
   // Unload native libraries for class unloading. We do this after calling FinishGC to prevent
   // deadlocks in case the JNI_OnUnload function does allocations.
@@ -2817,14 +3085,13 @@ class ScanVisitor {
   }
 };
 
-// Verify a reference from an object.
+// Verify a reference from an object. May be used by several threads at once, see
+// Heap::VisitObjectsPausedParallel().
 class VerifyReferenceVisitor : public SingleRootVisitor {
  public:
-  VerifyReferenceVisitor(Thread* self, Heap* heap, size_t* fail_count, bool verify_referent)
+  VerifyReferenceVisitor(Heap* heap, Atomic<size_t>* fail_count, bool verify_referent)
       REQUIRES_SHARED(Locks::mutator_lock_)
-      : self_(self), heap_(heap), fail_count_(fail_count), verify_referent_(verify_referent) {
-    CHECK_EQ(self_, Thread::Current());
-  }
+      : heap_(heap), fail_count_(fail_count), verify_referent_(verify_referent) {}
 
   void operator()(ObjPtr<mirror::Class> klass ATTRIBUTE_UNUSED, ObjPtr<mirror::Reference> ref) const
       REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -2875,9 +3142,7 @@ class VerifyReferenceVisitor : public SingleRootVisitor {
       // Verify that the reference is live.
       return true;
     }
-    CHECK_EQ(self_, Thread::Current());  // fail_count_ is private to the calling thread.
-    *fail_count_ += 1;
-    if (*fail_count_ == 1) {
+    if (fail_count_->fetch_add(1u, std::memory_order_relaxed) == 0u) {
       // Only print message for the first failure to prevent spam.
       LOG(ERROR) << "!!!!!!!!!!!!!!Heap corruption detected!!!!!!!!!!!!!!!!!!!";
     }
@@ -2964,41 +3229,38 @@ class VerifyReferenceVisitor : public SingleRootVisitor {
     return false;
   }
 
-  Thread* const self_;
   Heap* const heap_;
-  size_t* const fail_count_;
+  Atomic<size_t>* const fail_count_;
   const bool verify_referent_;
 };
 
 // Verify all references within an object, for use with HeapBitmap::Visit.
 class VerifyObjectVisitor {
  public:
-  VerifyObjectVisitor(Thread* self, Heap* heap, size_t* fail_count, bool verify_referent)
-      : self_(self), heap_(heap), fail_count_(fail_count), verify_referent_(verify_referent) {}
+  VerifyObjectVisitor(Heap* heap, Atomic<size_t>* fail_count, bool verify_referent)
+      : heap_(heap), fail_count_(fail_count), verify_referent_(verify_referent) {}
 
-  void operator()(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+  void operator()(mirror::Object* obj) const REQUIRES_SHARED(Locks::mutator_lock_) {
     // Note: we are verifying the references in obj but not obj itself, this is because obj must
     // be live or else how did we find it in the live bitmap?
-    VerifyReferenceVisitor visitor(self_, heap_, fail_count_, verify_referent_);
+    VerifyReferenceVisitor visitor(heap_, fail_count_, verify_referent_);
     // The class doesn't count as a reference but we should verify it anyways.
     obj->VisitReferences(visitor, visitor);
   }
 
   void VerifyRoots() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::heap_bitmap_lock_) {
     ReaderMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
-    VerifyReferenceVisitor visitor(self_, heap_, fail_count_, verify_referent_);
+    VerifyReferenceVisitor visitor(heap_, fail_count_, verify_referent_);
     Runtime::Current()->VisitRoots(&visitor);
   }
 
   uint32_t GetFailureCount() const REQUIRES(Locks::mutator_lock_) {
-    CHECK_EQ(self_, Thread::Current());
-    return *fail_count_;
+    return fail_count_->load(std::memory_order_relaxed);
   }
 
  private:
-  Thread* const self_;
   Heap* const heap_;
-  size_t* const fail_count_;
+  Atomic<size_t>* const fail_count_;
   const bool verify_referent_;
 };
 
@@ -3050,14 +3312,16 @@ size_t Heap::VerifyHeapReferences(bool verify_referents) {
   // Since we sorted the allocation stack content, need to revoke all
   // thread-local allocation stacks.
   RevokeAllThreadLocalAllocationStacks(self);
-  size_t fail_count = 0;
-  VerifyObjectVisitor visitor(self, this, &fail_count, verify_referents);
+  Atomic<size_t> fail_count(0u);
+  VerifyObjectVisitor visitor(this, &fail_count, verify_referents);
   // Verify objects in the allocation stack since these will be objects which were:
   // 1. Allocated prior to the GC (pre GC verification).
   // 2. Allocated during the GC (pre sweep GC verification).
   // We don't want to verify the objects in the live stack since they themselves may be
   // pointing to dead objects if they are not reachable.
-  VisitObjectsPaused(visitor);
+  // The checks only read the heap, the sorted stacks and the bitmaps, so the objects are
+  // verified in parallel.
+  VisitObjectsPausedParallel(visitor);
   // Verify the roots:
   visitor.VerifyRoots();
   if (visitor.GetFailureCount() > 0) {
@@ -3425,7 +3689,9 @@ collector::GcType Heap::WaitForGcToCompleteLocked(GcCause cause, Thread* self) {
   collector::GcType last_gc_type = collector::kGcTypeNone;
   GcCause last_gc_cause = kGcCauseNone;
   uint64_t wait_start = NanoTime();
+  bool has_waited = false;
   while (collector_type_running_ != kCollectorTypeNone) {
+    has_waited = true;
     if (self != task_processor_->GetRunningThread()) {
       // The current thread is about to wait for a currently running
       // collection to finish. If the waiting thread is not the heap
@@ -3442,6 +3708,10 @@ collector::GcType Heap::WaitForGcToCompleteLocked(GcCause cause, Thread* self) {
   }
   uint64_t wait_time = NanoTime() - wait_start;
   total_wait_time_ += wait_time;
+  if (has_waited && cause == kGcCauseForAlloc) {
+    gc_metrics_->RecordAllocationStall(wait_time);
+    self->AddAllocationStallTime(wait_time);
+  }
   if (wait_time > long_pause_log_threshold_) {
     LOG(INFO) << "WaitForGcToComplete blocked " << cause << " on " << last_gc_cause << " for "
               << PrettyDuration(wait_time);
@@ -3594,8 +3864,14 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       // Calculate when to perform the next ConcurrentGC.
       // Estimate how many remaining bytes we will have when we need to start the next GC.
       size_t remaining_bytes = bytes_allocated_during_gc;
-      remaining_bytes = std::min(remaining_bytes, kMaxConcurrentRemainingBytes);
-      remaining_bytes = std::max(remaining_bytes, kMinConcurrentRemainingBytes);
+      if (use_gc_pacing_) {
+        remaining_bytes = GetPacedConcurrentRemainingBytes(bytes_allocated_before_gc,
+                                                           bytes_allocated_during_gc,
+                                                           bytes_allocated);
+      } else {
+        remaining_bytes = std::min(remaining_bytes, kMaxConcurrentRemainingBytes);
+        remaining_bytes = std::max(remaining_bytes, kMinConcurrentRemainingBytes);
+      }
       size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
       if (UNLIKELY(remaining_bytes > target_footprint)) {
         // A never going to happen situation that from the estimated allocation rate we will exceed
@@ -3612,6 +3888,69 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   }
 }
 
+size_t Heap::GetPacedConcurrentRemainingBytes(size_t bytes_allocated_before_gc,
+                                              size_t bytes_allocated_during_gc,
+                                              size_t bytes_allocated) {
+  const uint64_t now = NanoTime();
+  const uint64_t gc_duration_ns = std::max<uint64_t>(current_gc_iteration_.GetDurationNs(), 1u);
+  const uint64_t gc_start_time_ns = now - std::min(gc_duration_ns, now);
+  // Allocation rate in bytes per ns, the highest of the one during the GC and the one since the
+  // end of the previous GC.
+  double allocation_rate = static_cast<double>(bytes_allocated_during_gc) / gc_duration_ns;
+  if (last_gc_end_time_ns_ != 0u &&
+      gc_start_time_ns > last_gc_end_time_ns_ &&
+      bytes_allocated_before_gc > last_gc_bytes_allocated_) {
+    allocation_rate = std::max(
+        allocation_rate,
+        static_cast<double>(bytes_allocated_before_gc - last_gc_bytes_allocated_) /
+            (gc_start_time_ns - last_gc_end_time_ns_));
+  }
+  last_gc_end_time_ns_ = now;
+  last_gc_bytes_allocated_ = bytes_allocated;
+  // Leave enough room for the next GC, assuming it takes as long as this one, to finish before
+  // the target footprint is reached.
+  const size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
+  size_t remaining_bytes =
+      static_cast<size_t>(allocation_rate * gc_duration_ns * kGcPacingHeadroom);
+  remaining_bytes = std::min(remaining_bytes, target_footprint / 2);
+  return std::max(remaining_bytes, kMinConcurrentRemainingBytes);
+}
+
+void Heap::PaceAllocation(Thread* self) {
+  if (self == task_processor_->GetRunningThread()) {
+    return;
+  }
+  const size_t concurrent_start_bytes = concurrent_start_bytes_;
+  const size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
+  const size_t bytes_allocated = GetBytesAllocated();
+  if (target_footprint <= concurrent_start_bytes || bytes_allocated <= concurrent_start_bytes) {
+    return;
+  }
+  const double fraction = std::min(
+      1.0,
+      static_cast<double>(bytes_allocated - concurrent_start_bytes) /
+          (target_footprint - concurrent_start_bytes));
+  if (fraction <= kAllocationPacingStartFraction) {
+    return;
+  }
+  // Grow the delay quadratically so that it stays small until the heap is nearly full.
+  const double pressure =
+      (fraction - kAllocationPacingStartFraction) / (1.0 - kAllocationPacingStartFraction);
+  const uint64_t delay_ns =
+      static_cast<uint64_t>(kMaxAllocationPacingDelayNs * pressure * pressure);
+  if (delay_ns == 0u) {
+    return;
+  }
+  {
+    ScopedTrace trace("GC: Allocation pacing");
+    ScopedThreadStateChange tsc(self, kWaitingForGcToComplete);
+    NanoSleep(delay_ns);
+  }
+  total_allocation_pacing_time_ns_.fetch_add(delay_ns, std::memory_order_relaxed);
+  gc_metrics_->RecordAllocationStall(delay_ns);
+  self->AddAllocationStallTime(delay_ns);
+}
+
 void Heap::ClampGrowthLimit() {
   // Use heap bitmap lock to guard against races with BindLiveToMarkBitmap.
   ScopedObjectAccess soa(Thread::Current());
@@ -3673,6 +4012,9 @@ void Heap::RequestConcurrentGCAndSaveObject(Thread* self,
   StackHandleScope<1> hs(self);
   HandleWrapperObjPtr<mirror::Object> wrapper(hs.NewHandleWrapper(obj));
   RequestConcurrentGC(self, kGcCauseBackground, force_full);
+  if (use_gc_pacing_) {
+    PaceAllocation(self);
+  }
 }
 
 class Heap::ConcurrentGCTask : public HeapTask {
@@ -3781,8 +4123,13 @@ class Heap::HeapTrimTask : public HeapTask {
   explicit HeapTrimTask(uint64_t delta_time) : HeapTask(NanoTime() + delta_time) { }
   void Run(Thread* self) override {
     gc::Heap* heap = Runtime::Current()->GetHeap();
-    heap->Trim(self);
-    heap->ClearPendingTrim(self);
+    // Trim for at most one slice, so that the other heap tasks (e.g. a concurrent GC request when
+    // the app comes back to the foreground) never wait long behind a trim.
+    if (heap->Trim(self, NanoTime() + kHeapTrimSliceBudget, &heap->heap_trim_progress_)) {
+      heap->ClearPendingTrim(self);
+    } else {
+      heap->ResumePendingTrim(self);
+    }
   }
 };
 
@@ -3791,6 +4138,15 @@ void Heap::ClearPendingTrim(Thread* self) {
   pending_heap_trim_ = nullptr;
 }
 
+void Heap::ResumePendingTrim(Thread* self) {
+  HeapTrimTask* added_task = new HeapTrimTask(kHeapTrimResumeWait);
+  {
+    MutexLock mu(self, *pending_task_lock_);
+    pending_heap_trim_ = added_task;
+  }
+  task_processor_->AddTask(self, added_task);
+}
+
 void Heap::RequestTrim(Thread* self) {
   if (!CanAddHeapTask(self)) {
     return;
@@ -3924,6 +4280,49 @@ inline float Heap::NativeMemoryOverTarget(size_t current_native_bytes, bool is_g
   }
 }
 
+// Minimum interval between two RSS samples in NativeRssOverTarget().
+static constexpr uint64_t kNativeRssSampleIntervalNs = MsToNs(50);
+
+// Minimum interval between two GCs requested because of RSS growth. A GC cannot reclaim native
+// memory that is not owned by Java objects, so do not keep collecting for it.
+static constexpr uint64_t kNativeRssGcIntervalNs = MsToNs(1000);
+
+// RSS growth since the last GC that is not explained by Java allocations, as a multiple of the
+// native allowance, that triggers a GC. This is deliberately larger than the allowance for counted
+// native bytes, since RSS also changes as pages are unmapped and remapped under memory pressure.
+static constexpr size_t kNativeRssGrowthFactor = 2;
+
+bool Heap::NativeRssOverTarget() {
+  uint64_t now = NanoTime();
+  uint64_t last_sample = last_rss_sample_time_ns_.load(std::memory_order_relaxed);
+  if (now - last_sample < kNativeRssSampleIntervalNs ||
+      now - last_rss_gc_request_time_ns_.load(std::memory_order_relaxed) < kNativeRssGcIntervalNs ||
+      !last_rss_sample_time_ns_.CompareAndSetStrongRelaxed(last_sample, now)) {
+    // Sampled recently, possibly by another thread.
+    return false;
+  }
+  size_t rss_after_gc = rss_after_last_gc_.load(std::memory_order_relaxed);
+  size_t rss = GetResidentSetSize();
+  if (rss == 0u || rss_after_gc == 0u) {
+    // No GC yet, or RSS not available.
+    return false;
+  }
+  size_t java_growth = UnsignedDifference(
+      GetBytesAllocated(), java_bytes_after_last_gc_.load(std::memory_order_relaxed));
+  size_t other_growth = UnsignedDifference(UnsignedDifference(rss, rss_after_gc), java_growth);
+  size_t add_bytes_allowed = static_cast<size_t>(
+      NativeAllocationGcWatermark() * HeapGrowthMultiplier());
+  if (other_growth < kNativeRssGrowthFactor * add_bytes_allowed) {
+    return false;
+  }
+  if (VLOG_IS_ON(heap)) {
+    LOG(INFO) << "Requesting GC for RSS growth of " << PrettySize(other_growth);
+  }
+  last_rss_gc_request_time_ns_.store(now, std::memory_order_relaxed);
+  rss_gc_requests_.fetch_add(1u, std::memory_order_relaxed);
+  return true;
+}
+
 inline void Heap::CheckGCForNative(Thread* self) {
   bool is_gc_concurrent = IsGcConcurrent();
   size_t current_native_bytes = GetNativeBytes();
@@ -3942,6 +4341,10 @@ inline void Heap::CheckGCForNative(Thread* self) {
     } else {
       CollectGarbageInternal(NonStickyGcType(), kGcCauseForNativeAlloc, false);
     }
+  } else if (is_gc_concurrent && NativeRssOverTarget()) {
+    // Native memory that is not accounted for, e.g. by a library that does not register its
+    // allocations, may still be owned by Java objects. Only request a background GC for it.
+    RequestConcurrentGC(self, kGcCauseForNativeAlloc, /*force_full=*/true);
   }
 }
 
@@ -4047,6 +4450,12 @@ void Heap::VisitAllocationRecords(RootVisitor* visitor) const {
       GetAllocationRecords()->VisitRoots(visitor);
     }
   }
+  // A thread that passed ShouldSampleAllocation() before sampling was disabled can still add a
+  // sample after the buffer was cleared, so visit the buffer whenever it exists.
+  MutexLock mu(Thread::Current(), *Locks::alloc_tracker_lock_);
+  if (allocation_samples_ != nullptr) {
+    allocation_samples_->VisitRoots(visitor);
+  }
 }
 
 void Heap::SweepAllocationRecords(IsMarkedVisitor* visitor) const {
@@ -4087,6 +4496,34 @@ void Heap::BroadcastForNewAllocationRecords() const {
   }
 }
 
+void Heap::SetAllocationSamplingInterval(size_t interval) {
+  MutexLock mu(Thread::Current(), *Locks::alloc_tracker_lock_);
+  if (interval != 0) {
+    if (allocation_samples_ == nullptr) {
+      allocation_samples_.reset(new AllocRecordSampleBuffer());
+    }
+    if (GetAllocationSamplingInterval() == 0) {
+      // Drop the samples recorded by allocations that raced with disabling sampling.
+      allocation_samples_->Clear();
+      LOG(INFO) << "Enabling allocation sampling every " << PrettySize(interval) << " ("
+                << allocation_samples_->Capacity() << " samples of up to "
+                << GetAllocTrackerStackDepth() << " frames)";
+    }
+  } else if (GetAllocationSamplingInterval() != 0) {
+    LOG(INFO) << "Disabling allocation sampling";
+    allocation_samples_->Clear();
+  }
+  alloc_sampling_interval_.store(interval, std::memory_order_relaxed);
+}
+
+void Heap::SampleAllocation(Thread* self, ObjPtr<mirror::Object>* obj, size_t bytes_allocated) {
+  // The buffer is never deleted before shutdown once sampling has been enabled, so it can be used
+  // without holding the lock even if sampling was disabled since ShouldSampleAllocation().
+  AllocRecordSampleBuffer* samples = allocation_samples_.get();
+  DCHECK(samples != nullptr);
+  samples->RecordSample(self, obj, bytes_allocated, GetAllocTrackerStackDepth());
+}
+
 void Heap::CheckGcStressMode(Thread* self, ObjPtr<mirror::Object>* obj) {
   DCHECK(gc_stress_mode_);
   auto* const runtime = Runtime::Current();
@@ -4166,6 +4603,24 @@ void Heap::RemoveGcPauseListener() {
   gc_pause_listener_.store(nullptr, std::memory_order_relaxed);
 }
 
+size_t Heap::ComputeAdaptiveTlabSize(Thread* self) {
+  if (!kUseAdaptiveTlabSize) {
+    return kPartialTlabSize;
+  }
+  const uint64_t now = NanoTime();
+  const uint64_t interval = now - self->GetLastTlabRefillTime();
+  size_t tlab_size = std::max(self->GetAdaptiveTlabSize(), kPartialTlabSize);
+  if (interval < kAdaptiveTlabGrowIntervalNs) {
+    // Allocating heavily, take bigger chunks to refill less often.
+    tlab_size = std::min(tlab_size * 2, space::RegionSpace::kRegionSize);
+  } else if (interval > kAdaptiveTlabShrinkIntervalNs) {
+    // Allocating rarely, avoid holding on to memory we won't use soon.
+    tlab_size = std::max(tlab_size / 2, kPartialTlabSize);
+  }
+  self->SetAdaptiveTlabSize(tlab_size, now);
+  return tlab_size;
+}
+
 mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                        size_t alloc_size,
                                        bool grow,
@@ -4180,7 +4635,8 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     const size_t min_expand_size = alloc_size - self->TlabSize();
     const size_t expand_bytes = std::max(
         min_expand_size,
-        std::min(self->TlabRemainingCapacity() - self->TlabSize(), kPartialTlabSize));
+        std::min(self->TlabRemainingCapacity() - self->TlabSize(),
+                 ComputeAdaptiveTlabSize(self)));
     if (UNLIKELY(IsOutOfMemoryOnAllocation(allocator_type, expand_bytes, grow))) {
       return nullptr;
     }
@@ -4208,7 +4664,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
         const size_t new_tlab_size = kUsePartialTlabs
-            ? std::max(alloc_size, kPartialTlabSize)
+            ? std::max(alloc_size, ComputeAdaptiveTlabSize(self))
             : gc::space::RegionSpace::kRegionSize;
         // Try to allocate a tlab.
         if (!region_space_->AllocNewTlab(self, new_tlab_size, bytes_tl_bulk_allocated)) {
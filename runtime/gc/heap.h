@@ -18,6 +18,7 @@
 #define ART_RUNTIME_GC_HEAP_H_
 
 #include <iosfwd>
+#include <limits>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -68,6 +69,8 @@ namespace gc {
 
 class AllocationListener;
 class AllocRecordObjectMap;
+class AllocRecordSampleBuffer;
+class GcMetrics;
 class GcPauseListener;
 class HeapTask;
 class ReferenceProcessor;
@@ -132,6 +135,13 @@ class Heap {
   // How much we grow the TLAB if we can do it.
   static constexpr size_t kPartialTlabSize = 16 * KB;
   static constexpr bool kUsePartialTlabs = true;
+  // If true, the region TLAB size (and the partial TLAB expansion size) is adapted per thread,
+  // between kPartialTlabSize and RegionSpace::kRegionSize, from how often the thread refills it.
+  static constexpr bool kUseAdaptiveTlabSize = true;
+  // A thread refilling its TLAB more often than this doubles its TLAB size.
+  static constexpr uint64_t kAdaptiveTlabGrowIntervalNs = MsToNs(1);
+  // A thread refilling its TLAB less often than this halves its TLAB size.
+  static constexpr uint64_t kAdaptiveTlabShrinkIntervalNs = MsToNs(100);
 
   static constexpr size_t kDefaultStartingSize = kPageSize;
   static constexpr size_t kDefaultInitialSize = 2 * MB;
@@ -147,6 +157,11 @@ class Heap {
   // Primitive arrays larger than this size are put in the large object space.
   static constexpr size_t kMinLargeObjectThreshold = 3 * kPageSize;
   static constexpr size_t kDefaultLargeObjectThreshold = kMinLargeObjectThreshold;
+  // Primitive arrays at least this large that are not put in the large object space are
+  // allocated in the non-moving space, so that JNI can access their elements without a copy.
+  // The compiled code allocation fast paths handle only sizes below kMinLargeObjectThreshold,
+  // so the threshold must not be smaller. Disabled by default.
+  static constexpr size_t kDefaultNonMovingArrayThreshold = std::numeric_limits<size_t>::max();
   // Whether or not parallel GC is enabled. If not, then we never create the thread pool.
   static constexpr bool kDefaultEnableParallelGC = false;
   static uint8_t* const kPreferredAllocSpaceBegin;
@@ -178,6 +193,12 @@ class Heap {
 
   // How often we allow heap trimming to happen (nanoseconds).
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
+  // How long a heap trim task may run before it yields to the other heap tasks, and how long it
+  // then waits before resuming the trim (nanoseconds).
+  static constexpr uint64_t kHeapTrimSliceBudget = MsToNs(10);
+  static constexpr uint64_t kHeapTrimResumeWait = MsToNs(100);
+  // How long a space is trimmed before the trimming thread checks for suspension (nanoseconds).
+  static constexpr uint64_t kHeapTrimChunkBudget = MsToNs(1);
   // How long we wait after a transition request to perform a collector transition (nanoseconds).
   static constexpr uint64_t kCollectorTransitionWait = MsToNs(5000);
   // Whether the transition-wait applies or not. Zero wait will stress the
@@ -204,6 +225,7 @@ class Heap {
        CollectorType background_collector_type,
        space::LargeObjectSpaceType large_object_space_type,
        size_t large_object_threshold,
+       size_t non_moving_array_threshold,
        size_t parallel_gc_threads,
        size_t conc_gc_threads,
        bool low_memory_mode,
@@ -221,9 +243,13 @@ class Heap {
        bool measure_gc_performance,
        bool use_homogeneous_space_compaction,
        bool use_generational_cc,
+       bool use_parallel_cc_marking,
+       bool use_gc_pacing,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
        bool dump_region_info_after_gc,
+       bool group_zygote_dirty_objects,
+       const std::string& zygote_dirty_classes_profile,
        space::ImageSpaceLoadingOrder image_space_loading_order);
 
   ~Heap();
@@ -294,6 +320,12 @@ class Heap {
   template <typename Visitor>
   ALWAYS_INLINE void VisitObjectsPaused(Visitor&& visitor)
       REQUIRES(Locks::mutator_lock_, !Locks::heap_bitmap_lock_, !*gc_complete_lock_);
+  // Same as VisitObjectsPaused(), but splits the spaces, regions and allocation stack in chunks
+  // visited by the heap thread pool and the calling thread. The visitor must be safe to call
+  // concurrently. Falls back to VisitObjectsPaused() without a thread pool.
+  template <typename Visitor>
+  void VisitObjectsPausedParallel(Visitor&& visitor)
+      REQUIRES(Locks::mutator_lock_, !Locks::heap_bitmap_lock_, !*gc_complete_lock_);
 
   void VisitReflectiveTargets(ReflectiveValueVisitor* visitor)
       REQUIRES(Locks::mutator_lock_, !Locks::heap_bitmap_lock_, !*gc_complete_lock_);
@@ -366,6 +398,14 @@ class Heap {
   // Temporarily disable thread flip for JNI critical calls.
   void IncrementDisableThreadFlip(Thread* self) REQUIRES(!*thread_flip_lock_);
   void DecrementDisableThreadFlip(Thread* self) REQUIRES(!*thread_flip_lock_);
+
+  // Pin the region of the region space holding `obj` for a JNI critical call, so that the
+  // concurrent copying collector leaves it in place and keeps collecting everywhere else.
+  // Returns false if the object is not in the region space, in which case the caller has to
+  // disable thread flips or moving GC instead.
+  bool TryPinObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Unpin an object pinned by TryPinObject. Returns false if the object was not pinnable.
+  bool UnpinObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
   void ThreadFlipBegin(Thread* self) REQUIRES(!*thread_flip_lock_);
   void ThreadFlipEnd(Thread* self) REQUIRES(!*thread_flip_lock_);
 
@@ -550,6 +590,14 @@ class Heap {
     return use_generational_cc_;
   }
 
+  bool GetUseParallelCCMarking() const {
+    return use_parallel_cc_marking_;
+  }
+
+  bool GetUseGcPacing() const {
+    return use_gc_pacing_;
+  }
+
   // Returns the number of objects currently allocated.
   size_t GetObjectsAllocated() const
       REQUIRES(!Locks::heap_bitmap_lock_);
@@ -789,6 +837,9 @@ class Heap {
   TaskProcessor* GetTaskProcessor() {
     return task_processor_.get();
   }
+  GcMetrics* GetGcMetrics() {
+    return gc_metrics_.get();
+  }
 
   bool HasZygoteSpace() const {
     return zygote_space_ != nullptr;
@@ -845,6 +896,10 @@ class Heap {
   uint64_t GetBlockingGcTime() const;
   void DumpGcCountRateHistogram(std::ostream& os) const REQUIRES(!*gc_complete_lock_);
   void DumpBlockingGcCountRateHistogram(std::ostream& os) const REQUIRES(!*gc_complete_lock_);
+  // Region fragmentation and evacuation statistics of the concurrent copying collectors.
+  void DumpRegionEvacuationStats(std::ostream& os) const;
+  // Per collector and cause GC metrics in a machine readable format, see GcMetrics::Dump().
+  void DumpGcMetrics(std::ostream& os) const;
 
   // Allocation tracking support
   // Callers to this function use double-checked locking to ensure safety on allocation_records_
@@ -892,6 +947,22 @@ class Heap {
   void BroadcastForNewAllocationRecords() const
       REQUIRES(!Locks::alloc_tracker_lock_);
 
+  // Allocation sampling support. When the interval is non-zero, roughly one allocation per
+  // `interval` bytes is recorded, with its stack trace, into the buffer returned by
+  // GetAllocationSamples(). Samples are only taken on the allocation slow path (e.g. TLAB refills),
+  // so the fast path is unaffected. Setting the interval to 0 disables sampling and discards the
+  // samples that were not drained.
+  void SetAllocationSamplingInterval(size_t interval) REQUIRES(!Locks::alloc_tracker_lock_);
+
+  size_t GetAllocationSamplingInterval() const {
+    return alloc_sampling_interval_.load(std::memory_order_relaxed);
+  }
+
+  // Null until sampling is enabled for the first time.
+  AllocRecordSampleBuffer* GetAllocationSamples() const REQUIRES(Locks::alloc_tracker_lock_) {
+    return allocation_samples_.get();
+  }
+
   void DisableGCForShutdown() REQUIRES(!*gc_complete_lock_);
 
   // Create a new alloc space and compact default alloc space to it.
@@ -987,10 +1058,18 @@ class Heap {
   }
   bool ShouldAllocLargeObject(ObjPtr<mirror::Class> c, size_t byte_count) const
       REQUIRES_SHARED(Locks::mutator_lock_);
+  bool ShouldAllocNonMovingArray(ObjPtr<mirror::Class> c,
+                                 size_t byte_count,
+                                 AllocatorType allocator) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Checks whether we should garbage collect:
   ALWAYS_INLINE bool ShouldConcurrentGCForJava(size_t new_num_bytes_allocated);
   float NativeMemoryOverTarget(size_t current_native_bytes, bool is_gc_concurrent);
+  // Samples the process RSS, at a limited rate, and returns whether its growth since the last GC
+  // that is not explained by Java allocations warrants a GC even though the counted native bytes
+  // are below target.
+  bool NativeRssOverTarget();
   ALWAYS_INLINE void CheckConcurrentGCForJava(Thread* self,
                                               size_t new_num_bytes_allocated,
                                               ObjPtr<mirror::Object>* obj)
@@ -1049,6 +1128,18 @@ class Heap {
                                               size_t* bytes_tl_bulk_allocated)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns the size to use for the next TLAB refill or expansion of `self`, adapted from the time
+  // since its previous one. Only called on the TLAB slow path.
+  size_t ComputeAdaptiveTlabSize(Thread* self);
+
+  // Charges `bytes_tl_bulk_allocated` against the sampling budget of `self` and returns whether the
+  // current allocation should be sampled.
+  ALWAYS_INLINE bool ShouldSampleAllocation(Thread* self, size_t bytes_tl_bulk_allocated);
+
+  void SampleAllocation(Thread* self, ObjPtr<mirror::Object>* obj, size_t bytes_allocated)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::alloc_tracker_lock_);
+
   mirror::Object* AllocWithNewTLAB(Thread* self,
                                    size_t alloc_size,
                                    bool grow,
@@ -1083,6 +1174,15 @@ class Heap {
   void RequestConcurrentGCAndSaveObject(Thread* self, bool force_full, ObjPtr<mirror::Object>* obj)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!*pending_task_lock_);
+  // With -Xgc:pacing, delay an allocating thread in proportion to how far the heap has grown past
+  // concurrent_start_bytes_ towards the target footprint, so that the concurrent GC can catch up
+  // instead of the thread blocking on a GC for alloc later.
+  void PaceAllocation(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Number of bytes to leave between concurrent_start_bytes_ and the target footprint with
+  // -Xgc:pacing, based on the allocation rate and duration of the GC that just finished.
+  size_t GetPacedConcurrentRemainingBytes(size_t bytes_allocated_before_gc,
+                                          size_t bytes_allocated_during_gc,
+                                          size_t bytes_allocated);
   bool IsGCRequestPending() const;
 
   // Sometimes CollectGarbageInternal decides to run a different Gc than you requested. Returns
@@ -1158,6 +1258,8 @@ class Heap {
 
   void ClearConcurrentGCRequest();
   void ClearPendingTrim(Thread* self) REQUIRES(!*pending_task_lock_);
+  // Schedule the rest of an unfinished heap trim.
+  void ResumePendingTrim(Thread* self) REQUIRES(!*pending_task_lock_);
   void ClearPendingCollectorTransition(Thread* self) REQUIRES(!*pending_task_lock_);
 
   // What kind of concurrency behavior is the runtime after? Currently true for concurrent mark
@@ -1168,8 +1270,25 @@ class Heap {
         collector_type_ == kCollectorTypeCCBackground;
   }
 
-  // Trim the managed and native spaces by releasing unused memory back to the OS.
-  void TrimSpaces(Thread* self) REQUIRES(!*gc_complete_lock_);
+  // Where an unfinished trim should resume.
+  struct TrimProgress {
+    // Whether the trim has started, the monitors and reference tables are then already trimmed.
+    bool started = false;
+    // Index of the malloc space being trimmed, in the order of continuous_spaces_.
+    size_t malloc_space_index = 0u;
+    // Where to resume trimming that space, see MallocSpace::TrimIncrementally().
+    size_t resume_point = 0u;
+  };
+
+  // Same as Trim(), but stops once NanoTime() reaches `deadline_ns` and returns false if there is
+  // more to trim. Calling it again with the same `progress` resumes where it stopped.
+  bool Trim(Thread* self, uint64_t deadline_ns, TrimProgress* progress)
+      REQUIRES(!*gc_complete_lock_);
+
+  // Trim the managed and native spaces by releasing unused memory back to the OS. Returns false
+  // if `deadline_ns` was reached before all the spaces were trimmed.
+  bool TrimSpaces(Thread* self, uint64_t deadline_ns, TrimProgress* progress)
+      REQUIRES(!*gc_complete_lock_);
 
   // Trim 0 pages at the end of reference tables.
   void TrimIndirectReferenceTables(Thread* self);
@@ -1181,6 +1300,15 @@ class Heap {
   template <typename Visitor>
   ALWAYS_INLINE void VisitObjectsInternalRegionSpace(Visitor&& visitor)
       REQUIRES(Locks::mutator_lock_, !Locks::heap_bitmap_lock_, !*gc_complete_lock_);
+  // Checks that the region space objects may be visited.
+  ALWAYS_INLINE void AssertCanVisitRegionSpace(Thread* self)
+      REQUIRES(Locks::mutator_lock_, !*gc_complete_lock_);
+  // Visits the valid objects in [begin, end) of the allocation stack.
+  template <typename Visitor>
+  ALWAYS_INLINE void VisitAllocationStackRange(StackReference<mirror::Object>* begin,
+                                               StackReference<mirror::Object>* end,
+                                               Visitor&& visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   void UpdateGcCountRateHistograms() REQUIRES(gc_complete_lock_);
 
@@ -1313,6 +1441,9 @@ class Heap {
   // Minimum allocation size of large object.
   size_t large_object_threshold_;
 
+  // Minimum allocation size of primitive arrays that go to the non-moving space.
+  const size_t non_moving_array_threshold_;
+
   // Guards access to the state of GC, associated conditional variable is used to signal when a GC
   // completes.
   Mutex* gc_complete_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
@@ -1332,6 +1463,9 @@ class Heap {
   // Task processor, proxies heap trim requests to the daemon threads.
   std::unique_ptr<TaskProcessor> task_processor_;
 
+  // Structured GC statistics exported to VMDebug and libartpalette.
+  std::unique_ptr<GcMetrics> gc_metrics_;
+
   // Collector type of the running GC.
   volatile CollectorType collector_type_running_ GUARDED_BY(gc_complete_lock_);
 
@@ -1388,6 +1522,18 @@ class Heap {
   // Approximately the smallest value of GetNativeBytes() we've seen since the last GC.
   Atomic<size_t> old_native_bytes_allocated_;
 
+  // Resident set size of the process and Java bytes allocated right after the last GC. Used to
+  // detect native memory growth that is not visible through GetNativeBytes().
+  Atomic<size_t> rss_after_last_gc_;
+  Atomic<size_t> java_bytes_after_last_gc_;
+
+  // NanoTime() of the last RSS sample in NativeRssOverTarget(), and of the last GC it requested.
+  Atomic<uint64_t> last_rss_sample_time_ns_;
+  Atomic<uint64_t> last_rss_gc_request_time_ns_;
+
+  // Number of GCs requested because of RSS growth.
+  Atomic<uint32_t> rss_gc_requests_;
+
   // Total number of native objects of which we were notified since the beginning of time, mod 2^32.
   // Allows us to check for GC only roughly every kNotifyNativeInterval allocations.
   Atomic<uint32_t> native_objects_notified_;
@@ -1541,6 +1687,10 @@ class Heap {
   CollectorTransitionTask* pending_collector_transition_ GUARDED_BY(pending_task_lock_);
   HeapTrimTask* pending_heap_trim_ GUARDED_BY(pending_task_lock_);
 
+  // Progress of the trim run by the heap trim tasks, which continue it in time slices. Only
+  // accessed by the heap task daemon.
+  TrimProgress heap_trim_progress_;
+
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
 
@@ -1549,6 +1699,20 @@ class Heap {
   // for major collections. Set in Heap constructor.
   const bool use_generational_cc_;
 
+  // If true, the Concurrent Copying (CC) collector drains its mark stacks with
+  // the heap thread pool (see -XX:ConcGCThreads). Set in Heap constructor.
+  const bool use_parallel_cc_marking_;
+
+  // If true, concurrent GCs start based on the measured allocation rate and allocating threads are
+  // delayed when the concurrent GC falls behind (-Xgc:pacing). Set in Heap constructor.
+  const bool use_gc_pacing_;
+  // End time and bytes allocated of the last GC, used to measure the allocation rate between GCs
+  // with -Xgc:pacing. Only accessed in GrowForUtilization() by the thread running the GC.
+  uint64_t last_gc_end_time_ns_;
+  size_t last_gc_bytes_allocated_;
+  // Total time allocating threads were delayed by PaceAllocation().
+  Atomic<uint64_t> total_allocation_pacing_time_ns_;
+
   // True if the currently running collection has made some thread wait.
   bool running_collection_is_blocking_ GUARDED_BY(gc_complete_lock_);
   // The number of blocking GC runs.
@@ -1578,6 +1742,10 @@ class Heap {
   std::unique_ptr<AllocRecordObjectMap> allocation_records_;
   size_t alloc_record_depth_;
 
+  // Allocation sampling support
+  Atomic<size_t> alloc_sampling_interval_;
+  std::unique_ptr<AllocRecordSampleBuffer> allocation_samples_;
+
   // GC stress related data structures.
   Mutex* backtrace_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   // Debugging variables, seen backtraces vs unique backtraces.
@@ -1595,6 +1763,14 @@ class Heap {
   bool dump_region_info_before_gc_;
   bool dump_region_info_after_gc_;
 
+  // Turned on by -XX:GroupZygoteDirtyObjects or -XX:ZygoteDirtyClassesProfile. When compacting
+  // the zygote space, put the objects likely to be written after fork on their own pages, so that
+  // the pages of the other objects stay clean and shared between the apps.
+  const bool group_zygote_dirty_objects_;
+  // File listing the descriptors of the classes whose zygote objects get dirty after fork, one
+  // per line. Lines of the "Dirty object count by class" section of imgdiag are also accepted.
+  const std::string zygote_dirty_classes_profile_;
+
   // Boot image spaces.
   std::vector<space::ImageSpace*> boot_image_spaces_;
 
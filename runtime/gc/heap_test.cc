@@ -16,9 +16,11 @@
 
 #include "class_linker-inl.h"
 #include "common_runtime_test.h"
+#include "gc/allocation_record.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
 #include "handle_scope-inl.h"
+#include "mirror/array-alloc-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-alloc-inl.h"
@@ -94,6 +96,78 @@ TEST_F(HeapTest, HeapBitmapCapacityTest) {
   bitmap.Set(fake_end_of_heap_object);
 }
 
+TEST_F(HeapTest, AllocationSampling) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::Class> c(
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "[Ljava/lang/Object;")));
+  // Sample every bulk allocation.
+  heap->SetAllocationSamplingInterval(1u);
+  for (size_t i = 0; i < 256; ++i) {
+    ASSERT_TRUE(mirror::ObjectArray<mirror::Object>::Alloc(soa.Self(), c.Get(), 2048) != nullptr);
+  }
+  {
+    MutexLock mu(soa.Self(), *Locks::alloc_tracker_lock_);
+    AllocRecordSampleBuffer* samples = heap->GetAllocationSamples();
+    ASSERT_TRUE(samples != nullptr);
+    EXPECT_GT(samples->Size(), 0u);
+    size_t drained = 0;
+    samples->Drain([&](size_t byte_count,
+                       ObjPtr<mirror::Class> klass,
+                       const AllocRecordStackTrace& trace) REQUIRES_SHARED(Locks::mutator_lock_) {
+      EXPECT_GT(byte_count, 0u);
+      EXPECT_EQ(klass, c.Get());
+      EXPECT_EQ(trace.GetTid(), soa.Self()->GetTid());
+      ++drained;
+    });
+    EXPECT_GT(drained, 0u);
+    EXPECT_EQ(samples->Size(), 0u);
+  }
+  heap->SetAllocationSamplingInterval(0u);
+  EXPECT_EQ(heap->GetAllocationSamplingInterval(), 0u);
+}
+
+TEST_F(HeapTest, AllocationSampleAfterDisabling) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::Class> c(
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "[Ljava/lang/Object;")));
+  Handle<mirror::Object> obj(hs.NewHandle<mirror::Object>(
+      mirror::ObjectArray<mirror::Object>::Alloc(soa.Self(), c.Get(), 1)));
+  ASSERT_TRUE(obj != nullptr);
+  heap->SetAllocationSamplingInterval(1u);
+  heap->SetAllocationSamplingInterval(0u);
+  AllocRecordSampleBuffer* samples = heap->GetAllocationSamples();
+  ASSERT_TRUE(samples != nullptr);
+
+  // Record a sample like a thread that passed ShouldSampleAllocation() before sampling was
+  // disabled. The GC must still visit its roots.
+  ObjPtr<mirror::Object> sampled = obj.Get();
+  samples->RecordSample(soa.Self(), &sampled, 16u, heap->GetAllocTrackerStackDepth());
+  heap->CollectGarbage(/* clear_soft_references= */ false);
+  {
+    MutexLock mu(soa.Self(), *Locks::alloc_tracker_lock_);
+    ASSERT_EQ(samples->Size(), 1u);
+    samples->Drain([&](size_t byte_count ATTRIBUTE_UNUSED,
+                       ObjPtr<mirror::Class> klass,
+                       const AllocRecordStackTrace& trace ATTRIBUTE_UNUSED)
+                       REQUIRES_SHARED(Locks::mutator_lock_) {
+      EXPECT_EQ(klass, c.Get());
+    });
+  }
+
+  // Enabling sampling again drops such samples.
+  samples->RecordSample(soa.Self(), &sampled, 16u, heap->GetAllocTrackerStackDepth());
+  heap->SetAllocationSamplingInterval(1u);
+  {
+    MutexLock mu(soa.Self(), *Locks::alloc_tracker_lock_);
+    EXPECT_EQ(samples->Size(), 0u);
+  }
+  heap->SetAllocationSamplingInterval(0u);
+}
+
 TEST_F(HeapTest, DumpGCPerformanceOnShutdown) {
   Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
   Runtime::Current()->SetDumpGCPerformanceOnShutdown(true);
@@ -111,5 +185,22 @@ TEST_F(ZygoteHeapTest, PreZygoteFork) {
   Runtime::Current()->GetHeap()->PreZygoteFork();
 }
 
+class NonMovingArrayHeapTest : public CommonRuntimeTest {
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:LargeObjectThreshold=1m", nullptr));
+    options->push_back(std::make_pair("-XX:NonMovingArrayThreshold=16k", nullptr));
+  }
+};
+
+TEST_F(NonMovingArrayHeapTest, PrimitiveArrayAboveThresholdIsNotMovable) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::ByteArray> array = mirror::ByteArray::Alloc(soa.Self(), 64 * KB);
+  ASSERT_TRUE(array != nullptr);
+  EXPECT_FALSE(heap->IsMovableObject(array));
+  EXPECT_TRUE(heap->GetNonMovingSpace()->Contains(array.Ptr()));
+}
+
 }  // namespace gc
 }  // namespace art
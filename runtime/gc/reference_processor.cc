@@ -22,6 +22,8 @@
 #include "base/utils.h"
 #include "class_root-inl.h"
 #include "collector/garbage_collector.h"
+#include "gc_metrics.h"
+#include "heap.h"
 #include "jni/java_vm_ext.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -39,6 +41,9 @@ namespace gc {
 
 static constexpr bool kAsyncReferenceQueueAdd = false;
 
+// Soft, weak and phantom reference queues shorter than this are cleared by the GC thread alone.
+static constexpr size_t kMinParallelClearReferences = 4 * KB;
+
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
       preserving_references_(false),
@@ -190,8 +195,8 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
     }
   }
   // Clear all remaining soft and weak references with white referents.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteReferences(&soft_reference_queue_, concurrent, collector);
+  ClearWhiteReferences(&weak_reference_queue_, concurrent, collector);
   {
     TimingLogger::ScopedTiming t2(concurrent ? "EnqueueFinalizerReferences" :
         "(Paused)EnqueueFinalizerReferences", timings);
@@ -199,17 +204,22 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
       StartPreservingReferences(self);
     }
     // Preserve all white objects with finalize methods and schedule them for finalization.
-    finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector);
+    size_t finalizable =
+        finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector);
+    Runtime::Current()->GetHeap()->GetGcMetrics()->RecordFinalizerReferences(finalizable);
     collector->ProcessMarkStack();
     if (concurrent) {
       StopPreservingReferences(self);
     }
   }
-  // Clear all finalizer referent reachable soft and weak references with white referents.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  // Clear all finalizer referent reachable soft and weak references with white referents. The
+  // finalizer references above are processed by this thread alone since that marks objects, and
+  // each step only starts once the previous one has finished, so the order of the phases is the
+  // same as for sequential processing.
+  ClearWhiteReferences(&soft_reference_queue_, concurrent, collector);
+  ClearWhiteReferences(&weak_reference_queue_, concurrent, collector);
   // Clear all phantom references with white referents.
-  phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteReferences(&phantom_reference_queue_, concurrent, collector);
   // At this point all reference queues other than the cleared references should be empty.
   DCHECK(soft_reference_queue_.IsEmpty());
   DCHECK(weak_reference_queue_.IsEmpty());
@@ -229,6 +239,55 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
   }
 }
 
+class ReferenceProcessor::ClearWhiteReferencesTask : public Task {
+ public:
+  ClearWhiteReferencesTask(ReferenceQueue* queue,
+                           ReferenceQueue* cleared_references,
+                           collector::GarbageCollector* collector)
+      : queue_(queue), cleared_references_(cleared_references), collector_(collector) {}
+
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    queue_->AtomicClearWhiteReferences(self, cleared_references_, collector_);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ReferenceQueue* const queue_;
+  ReferenceQueue* const cleared_references_;
+  collector::GarbageCollector* const collector_;
+};
+
+void ReferenceProcessor::ClearWhiteReferences(ReferenceQueue* queue,
+                                              bool concurrent,
+                                              collector::GarbageCollector* collector) {
+  Runtime* const runtime = Runtime::Current();
+  Heap* const heap = runtime->GetHeap();
+  ThreadPool* const thread_pool = heap->GetThreadPool();
+  // Use a single thread in a background state to leave CPU time to the foreground apps, and in
+  // transaction mode since the transaction log is not thread safe.
+  const size_t thread_count = (thread_pool == nullptr ||
+                               runtime->IsActiveTransaction() ||
+                               !runtime->InJankPerceptibleProcessState())
+      ? 1
+      : (concurrent ? heap->GetConcGCThreadCount() : heap->GetParallelGCThreadCount()) + 1;
+  if (thread_count == 1 || !queue->HasAtLeast(kMinParallelClearReferences)) {
+    queue->ClearWhiteReferences(&cleared_references_, collector);
+    return;
+  }
+  Thread* const self = Thread::Current();
+  for (size_t i = 0; i < thread_count; ++i) {
+    thread_pool->AddTask(self, new ClearWhiteReferencesTask(queue, &cleared_references_, collector));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
+  DCHECK(queue->IsEmpty());
+}
+
 // Process the "referent" field in a java.lang.ref.Reference.  If the referent has not yet been
 // marked, put it on the appropriate list in the heap for later processing.
 void ReferenceProcessor::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
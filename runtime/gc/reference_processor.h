@@ -80,6 +80,14 @@ class ReferenceProcessor {
       REQUIRES(!Locks::reference_processor_lock_);
 
  private:
+  class ClearWhiteReferencesTask;
+
+  // Clear the white referents of `queue` into cleared_references_, using the heap thread pool
+  // when the queue is long enough.
+  void ClearWhiteReferences(ReferenceQueue* queue,
+                            bool concurrent,
+                            collector::GarbageCollector* collector)
+      REQUIRES_SHARED(Locks::mutator_lock_);
   bool SlowPathEnabled() REQUIRES_SHARED(Locks::mutator_lock_);
   // Called by ProcessReferences.
   void DisableSlowPath(Thread* self) REQUIRES(Locks::reference_processor_lock_)
@@ -72,6 +72,36 @@ ObjPtr<mirror::Reference> ReferenceQueue::DequeuePendingReference() {
   return ref;
 }
 
+size_t ReferenceQueue::AtomicDequeuePendingReferences(Thread* self,
+                                                      ObjPtr<mirror::Reference>* refs,
+                                                      size_t max_count) {
+  MutexLock mu(self, *lock_);
+  size_t count = 0;
+  while (count < max_count && !IsEmpty()) {
+    refs[count++] = DequeuePendingReference();
+  }
+  return count;
+}
+
+void ReferenceQueue::AtomicTransferReferencesFrom(Thread* self, ReferenceQueue* other) {
+  if (other->IsEmpty()) {
+    return;
+  }
+  MutexLock mu(self, *lock_);
+  if (IsEmpty()) {
+    list_ = other->list_;
+  } else {
+    // Splice the two cycles together by swapping the successors of their list_ elements.
+    ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+    ObjPtr<mirror::Reference> other_head = other->list_->GetPendingNext<kWithoutReadBarrier>();
+    DCHECK(head != nullptr);
+    DCHECK(other_head != nullptr);
+    list_->SetPendingNext(other_head);
+    other->list_->SetPendingNext(head);
+  }
+  other->list_ = nullptr;
+}
+
 // This must be called whenever DequeuePendingReference is called.
 void ReferenceQueue::DisableReadBarrierForReference(ObjPtr<mirror::Reference> ref) {
   Heap* heap = Runtime::Current()->GetHeap();
@@ -130,30 +160,72 @@ size_t ReferenceQueue::GetLength() const {
   return count;
 }
 
+bool ReferenceQueue::HasAtLeast(size_t count) const {
+  if (count == 0) {
+    return true;
+  }
+  ObjPtr<mirror::Reference> cur = list_;
+  if (cur == nullptr) {
+    return false;
+  }
+  do {
+    if (--count == 0) {
+      return true;
+    }
+    cur = cur->GetPendingNext<kWithoutReadBarrier>();
+  } while (cur != list_);
+  return false;
+}
+
+void ReferenceQueue::ClearWhiteReference(ObjPtr<mirror::Reference> ref,
+                                         ReferenceQueue* cleared_references,
+                                         collector::GarbageCollector* collector) {
+  mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
+  // do_atomic_update is false because this happens during the reference processing phase where
+  // Reference.clear() would block.
+  if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
+    // Referent is white, clear it.
+    if (Runtime::Current()->IsActiveTransaction()) {
+      ref->ClearReferent<true>();
+    } else {
+      ref->ClearReferent<false>();
+    }
+    cleared_references->EnqueueReference(ref);
+  }
+  // Delay disabling the read barrier until here so that the ClearReferent call above in
+  // transaction mode will trigger the read barrier.
+  DisableReadBarrierForReference(ref);
+}
+
 void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
                                           collector::GarbageCollector* collector) {
   while (!IsEmpty()) {
-    ObjPtr<mirror::Reference> ref = DequeuePendingReference();
-    mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
-    // do_atomic_update is false because this happens during the reference processing phase where
-    // Reference.clear() would block.
-    if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
-      // Referent is white, clear it.
-      if (Runtime::Current()->IsActiveTransaction()) {
-        ref->ClearReferent<true>();
-      } else {
-        ref->ClearReferent<false>();
-      }
-      cleared_references->EnqueueReference(ref);
-    }
-    // Delay disabling the read barrier until here so that the ClearReferent call above in
-    // transaction mode will trigger the read barrier.
-    DisableReadBarrierForReference(ref);
+    ClearWhiteReference(DequeuePendingReference(), cleared_references, collector);
   }
 }
 
-void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
+void ReferenceQueue::AtomicClearWhiteReferences(Thread* self,
+                                                ReferenceQueue* cleared_references,
                                                 collector::GarbageCollector* collector) {
+  // Only used by this thread, so it needs no lock.
+  ReferenceQueue local_cleared_references(nullptr);
+  static constexpr size_t kBatchSize = 64;
+  ObjPtr<mirror::Reference> refs[kBatchSize];
+  while (true) {
+    const size_t count = AtomicDequeuePendingReferences(self, refs, kBatchSize);
+    if (count == 0) {
+      break;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      ClearWhiteReference(refs[i], &local_cleared_references, collector);
+    }
+  }
+  cleared_references->AtomicTransferReferencesFrom(self, &local_cleared_references);
+}
+
+size_t ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
+                                                  collector::GarbageCollector* collector) {
+  size_t enqueued = 0u;
   while (!IsEmpty()) {
     ObjPtr<mirror::FinalizerReference> ref = DequeuePendingReference()->AsFinalizerReference();
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
@@ -170,11 +242,13 @@ void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_referenc
         ref->ClearReferent<false>();
       }
       cleared_references->EnqueueReference(ref);
+      ++enqueued;
     }
     // Delay disabling the read barrier until here so that the ClearReferent call above in
     // transaction mode will trigger the read barrier.
     DisableReadBarrierForReference(ref->AsReference());
   }
+  return enqueued;
 }
 
 void ReferenceQueue::ForwardSoftReferences(MarkObjectVisitor* visitor) {
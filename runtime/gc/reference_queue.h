@@ -71,6 +71,18 @@ class ReferenceQueue {
   // Call DisableReadBarrierForReference for the reference that's returned from this function.
   ObjPtr<mirror::Reference> DequeuePendingReference() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Dequeue up to `max_count` references into `refs` and return how many were dequeued. Thread
+  // safe, used by the GC threads that clear a queue in parallel.
+  size_t AtomicDequeuePendingReferences(Thread* self,
+                                        ObjPtr<mirror::Reference>* refs,
+                                        size_t max_count)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*lock_);
+
+  // Move all the references of `other` to this queue, leaving `other` empty. Thread safe with
+  // respect to other threads operating on this queue.
+  void AtomicTransferReferencesFrom(Thread* self, ReferenceQueue* other)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*lock_);
+
   // If applicable, disable the read barrier for the reference after its referent is handled (see
   // ConcurrentCopying::ProcessMarkStackRef.) This must be called for a reference that's dequeued
   // from pending queue (DequeuePendingReference).
@@ -78,8 +90,8 @@ class ReferenceQueue {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Enqueues finalizer references with white referents.  White referents are blackened, moved to
-  // the zombie field, and the referent field is cleared.
-  void EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
+  // the zombie field, and the referent field is cleared. Returns the number of enqueued references.
+  size_t EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
                                   collector::GarbageCollector* collector)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -95,8 +107,18 @@ class ReferenceQueue {
                             collector::GarbageCollector* collector)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Same as ClearWhiteReferences, but may be called by several threads at once. Each thread takes
+  // batches of references from the queue and hands its cleared references over at the end.
+  void AtomicClearWhiteReferences(Thread* self,
+                                  ReferenceQueue* cleared_references,
+                                  collector::GarbageCollector* collector)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*lock_);
+
   void Dump(std::ostream& os) const REQUIRES_SHARED(Locks::mutator_lock_);
   size_t GetLength() const REQUIRES_SHARED(Locks::mutator_lock_);
+  // Returns whether the queue holds at least `count` references. Does not use read barriers, so it
+  // can be called during reference processing.
+  bool HasAtLeast(size_t count) const REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool IsEmpty() const {
     return list_ == nullptr;
@@ -113,6 +135,12 @@ class ReferenceQueue {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  // Clear the referent of `ref` if it is white and enqueue `ref` to `cleared_references`.
+  void ClearWhiteReference(ObjPtr<mirror::Reference> ref,
+                           ReferenceQueue* cleared_references,
+                           collector::GarbageCollector* collector)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Lock, used for parallel GC reference enqueuing. It allows for multiple threads simultaneously
   // calling AtomicEnqueueIfNotEnqueued.
   Mutex* const lock_;
@@ -62,6 +62,45 @@ TEST_F(ReferenceQueueTest, EnqueueDequeue) {
   ASSERT_EQ(refs, dequeued);
 }
 
+TEST_F(ReferenceQueueTest, AtomicDequeueAndTransfer) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<20> hs(self);
+  Mutex lock("Reference queue lock");
+  Mutex other_lock("Other reference queue lock");
+  ReferenceQueue queue(&lock);
+  ReferenceQueue other(&other_lock);
+  auto ref_class = hs.NewHandle(
+      Runtime::Current()->GetClassLinker()->FindClass(self, "Ljava/lang/ref/WeakReference;",
+                                                      ScopedNullHandle<mirror::ClassLoader>()));
+  ASSERT_TRUE(ref_class != nullptr);
+  std::set<mirror::Reference*> refs;
+  for (size_t i = 0; i < 5; ++i) {
+    Handle<mirror::Reference> ref(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+    ASSERT_TRUE(ref != nullptr);
+    refs.insert(ref.Get());
+    (i < 3 ? &queue : &other)->EnqueueReference(ref.Get());
+  }
+  ASSERT_TRUE(queue.HasAtLeast(3U));
+  ASSERT_FALSE(queue.HasAtLeast(4U));
+  queue.AtomicTransferReferencesFrom(self, &other);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 5U);
+  ASSERT_TRUE(queue.HasAtLeast(5U));
+
+  std::set<mirror::Reference*> dequeued;
+  ObjPtr<mirror::Reference> batch[4];
+  ASSERT_EQ(queue.AtomicDequeuePendingReferences(self, batch, 4U), 4U);
+  for (ObjPtr<mirror::Reference> ref : batch) {
+    dequeued.insert(ref.Ptr());
+  }
+  ASSERT_EQ(queue.AtomicDequeuePendingReferences(self, batch, 4U), 1U);
+  dequeued.insert(batch[0].Ptr());
+  ASSERT_TRUE(queue.IsEmpty());
+  ASSERT_EQ(queue.AtomicDequeuePendingReferences(self, batch, 4U), 0U);
+  ASSERT_EQ(refs, dequeued);
+}
+
 TEST_F(ReferenceQueueTest, Dump) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
@@ -16,6 +16,8 @@
 
 #include "dlmalloc_space-inl.h"
 
+#include <limits>
+
 #include "base/logging.h"  // For VLOG.
 #include "base/time_utils.h"
 #include "base/utils.h"
@@ -281,13 +283,50 @@ size_t DlMallocSpace::FreeList(Thread* self, size_t num_ptrs, mirror::Object** p
 }
 
 size_t DlMallocSpace::Trim() {
+  size_t resume_point = 0;
+  return TrimIncrementally(&resume_point, std::numeric_limits<uint64_t>::max());
+}
+
+namespace {
+
+struct IncrementalTrimContext {
+  // Free chunks below this address were advised by a previous call.
+  uintptr_t resume_point;
+  uint64_t deadline_ns;
+  // Address of the first free chunk not advised because the deadline passed, or 0.
+  uintptr_t stopped_at;
+  size_t reclaimed;
+};
+
+void IncrementalTrimCallback(void* start, void* end, size_t used_bytes, void* arg) {
+  IncrementalTrimContext* context = reinterpret_cast<IncrementalTrimContext*>(arg);
+  uintptr_t chunk_start = reinterpret_cast<uintptr_t>(start);
+  if (used_bytes != 0 || context->stopped_at != 0 || chunk_start < context->resume_point) {
+    return;
+  }
+  if (NanoTime() >= context->deadline_ns) {
+    // The walk cannot be aborted, the remaining chunks are only skipped.
+    context->stopped_at = chunk_start;
+    return;
+  }
+  DlmallocMadviseCallback(start, end, used_bytes, &context->reclaimed);
+}
+
+}  // namespace
+
+size_t DlMallocSpace::TrimIncrementally(size_t* resume_point, uint64_t deadline_ns) {
   MutexLock mu(Thread::Current(), lock_);
-  // Trim to release memory at the end of the space.
-  mspace_trim(mspace_, 0);
-  // Visit space looking for page-sized holes to advise the kernel we don't need.
-  size_t reclaimed = 0;
-  mspace_inspect_all(mspace_, DlmallocMadviseCallback, &reclaimed);
-  return reclaimed;
+  if (*resume_point == 0) {
+    // Trim to release memory at the end of the space.
+    mspace_trim(mspace_, 0);
+  }
+  // Visit space looking for page-sized holes to advise the kernel we don't need. The madvise
+  // calls are the expensive part, so they are skipped once the deadline passes and resume from
+  // the first skipped free chunk on the next call.
+  IncrementalTrimContext context = {*resume_point, deadline_ns, 0u, 0u};
+  mspace_inspect_all(mspace_, IncrementalTrimCallback, &context);
+  *resume_point = context.stopped_at;
+  return context.reclaimed;
 }
 
 void DlMallocSpace::Walk(void(*callback)(void *start, void *end, size_t num_bytes, void* callback_arg),
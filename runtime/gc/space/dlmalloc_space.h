@@ -110,6 +110,7 @@ class DlMallocSpace : public MallocSpace {
   }
 
   size_t Trim() override;
+  size_t TrimIncrementally(size_t* resume_point, uint64_t deadline_ns) override;
 
   // Perform a mspace_inspect_all which calls back for each allocation chunk. The chunk may not be
   // in use, indicated by num_bytes equaling zero.
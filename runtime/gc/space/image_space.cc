@@ -20,7 +20,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <random>
+#include <thread>
 
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
@@ -2763,6 +2765,58 @@ class ImageSpace::BootImageLoader {
     return reinterpret_cast<void**>(reinterpret_cast<uint8_t*>(method) + offset.Uint32Value());
   }
 
+  // Patching the objects of the images with multiple threads pays off only for big images.
+  static constexpr size_t kMinParallelRelocationSize = 4 * MB;
+  static constexpr size_t kRelocationChunkSize = 256 * KB;
+  static constexpr size_t kMaxRelocationThreads = 4u;
+
+  // Calls `patch_object` for every object in the objects sections of the `spaces`, using
+  // `num_threads` threads (including the calling one) that take chunks of the sections in turn.
+  // Objects are found through the live bitmaps, as the chunk boundaries are not object
+  // boundaries. The helper threads are not attached to the runtime, which may not even have
+  // a current thread yet; the calling thread keeps the mutator lock for them.
+  template <typename PatchObject>
+  static void ParallelPatchObjects(ArrayRef<const std::unique_ptr<ImageSpace>> spaces,
+                                   size_t num_threads,
+                                   const PatchObject& patch_object) {
+    struct Chunk {
+      accounting::ContinuousSpaceBitmap* bitmap;
+      uintptr_t begin;
+      uintptr_t end;
+    };
+    std::vector<Chunk> chunks;
+    for (const std::unique_ptr<ImageSpace>& space : spaces) {
+      uintptr_t objects_begin = reinterpret_cast<uintptr_t>(space->Begin() + sizeof(ImageHeader));
+      uintptr_t objects_end = reinterpret_cast<uintptr_t>(
+          space->Begin() + space->GetImageHeader().GetObjectsSection().Size());
+      DCHECK_ALIGNED(objects_end, kObjectAlignment);
+      for (uintptr_t begin = objects_begin; begin != objects_end; ) {
+        uintptr_t end = std::min(begin + kRelocationChunkSize, objects_end);
+        chunks.push_back(Chunk{space->GetLiveBitmap(), begin, end});
+        begin = end;
+      }
+    }
+    std::atomic<size_t> next_chunk(0u);
+    auto worker = [&]() NO_THREAD_SAFETY_ANALYSIS {
+      ScopedTrace trace("Relocate image objects");
+      for (size_t i = next_chunk.fetch_add(1u, std::memory_order_relaxed);
+           i < chunks.size();
+           i = next_chunk.fetch_add(1u, std::memory_order_relaxed)) {
+        const Chunk& chunk = chunks[i];
+        chunk.bitmap->VisitMarkedRange(chunk.begin, chunk.end, patch_object);
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1u);
+    for (size_t i = 1u; i != num_threads; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
   template <PointerSize kPointerSize>
   static void DoRelocateSpaces(ArrayRef<const std::unique_ptr<ImageSpace>>& spaces,
                                int64_t base_diff64) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -2775,19 +2829,25 @@ class ImageSpace::BootImageLoader {
     const ImageHeader& base_header = spaces[0]->GetImageHeader();
     size_t base_image_space_count = base_header.GetImageSpaceCount();
     DCHECK_LE(base_image_space_count, spaces.size());
+    uint64_t start_time = NanoTime();
     DoRelocateSpaces<kPointerSize, /*kExtension=*/ false>(
         spaces.SubArray(/*pos=*/ 0u, base_image_space_count),
         base_diff64,
         &patched_objects);
+    VLOG(image) << "Relocating " << spaces[0]->GetImageLocation() << " took "
+                << PrettyDuration(NanoTime() - start_time);
 
     for (size_t i = base_image_space_count, size = spaces.size(); i != size; ) {
       const ImageHeader& ext_header = spaces[i]->GetImageHeader();
       size_t ext_image_space_count = ext_header.GetImageSpaceCount();
       DCHECK_LE(ext_image_space_count, size - i);
+      start_time = NanoTime();
       DoRelocateSpaces<kPointerSize, /*kExtension=*/ true>(
           spaces.SubArray(/*pos=*/ i, ext_image_space_count),
           base_diff64,
           &patched_objects);
+      VLOG(image) << "Relocating " << spaces[i]->GetImageLocation() << " took "
+                  << PrettyDuration(NanoTime() - start_time);
       i += ext_image_space_count;
     }
   }
@@ -2952,36 +3012,49 @@ class ImageSpace::BootImageLoader {
       }
     }
 
-    for (const std::unique_ptr<ImageSpace>& space : spaces) {
-      const ImageHeader& image_header = space->GetImageHeader();
+    // With all the classes patched, the remaining objects can be patched independently of each
+    // other. Note: use Test() rather than Set() as this is the last time we're checking them.
+    auto patch_object = [&](mirror::Object* object) REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (!patched_objects->Test(object)) {
+        // This is the last pass over objects, so we do not need to Set().
+        main_patch_object_visitor.VisitObject(object);
+        ObjPtr<mirror::Class> klass = object->GetClass<kVerifyNone, kWithoutReadBarrier>();
+        if (klass->IsDexCacheClass<kVerifyNone>()) {
+          // Patch dex cache array pointers and elements.
+          ObjPtr<mirror::DexCache> dex_cache =
+              object->AsDexCache<kVerifyNone, kWithoutReadBarrier>();
+          main_patch_object_visitor.VisitDexCacheArrays(dex_cache);
+        } else if (klass == method_class || klass == constructor_class) {
+          // Patch the ArtMethod* in the mirror::Executable subobject.
+          ObjPtr<mirror::Executable> as_executable =
+              ObjPtr<mirror::Executable>::DownCast(object);
+          ArtMethod* unpatched_method = as_executable->GetArtMethod<kVerifyNone>();
+          ArtMethod* patched_method = main_relocate_visitor(unpatched_method);
+          as_executable->SetArtMethod</*kTransactionActive=*/ false,
+                                      /*kCheckTransaction=*/ true,
+                                      kVerifyNone>(patched_method);
+        }
+      }
+    };
 
-      static_assert(IsAligned<kObjectAlignment>(sizeof(ImageHeader)), "Header alignment check");
-      uint32_t objects_end = image_header.GetObjectsSection().Size();
-      DCHECK_ALIGNED(objects_end, kObjectAlignment);
-      for (uint32_t pos = sizeof(ImageHeader); pos != objects_end; ) {
-        mirror::Object* object = reinterpret_cast<mirror::Object*>(space->Begin() + pos);
-        // Note: use Test() rather than Set() as this is the last time we're checking this object.
-        if (!patched_objects->Test(object)) {
-          // This is the last pass over objects, so we do not need to Set().
-          main_patch_object_visitor.VisitObject(object);
-          ObjPtr<mirror::Class> klass = object->GetClass<kVerifyNone, kWithoutReadBarrier>();
-          if (klass->IsDexCacheClass<kVerifyNone>()) {
-            // Patch dex cache array pointers and elements.
-            ObjPtr<mirror::DexCache> dex_cache =
-                object->AsDexCache<kVerifyNone, kWithoutReadBarrier>();
-            main_patch_object_visitor.VisitDexCacheArrays(dex_cache);
-          } else if (klass == method_class || klass == constructor_class) {
-            // Patch the ArtMethod* in the mirror::Executable subobject.
-            ObjPtr<mirror::Executable> as_executable =
-                ObjPtr<mirror::Executable>::DownCast(object);
-            ArtMethod* unpatched_method = as_executable->GetArtMethod<kVerifyNone>();
-            ArtMethod* patched_method = main_relocate_visitor(unpatched_method);
-            as_executable->SetArtMethod</*kTransactionActive=*/ false,
-                                        /*kCheckTransaction=*/ true,
-                                        kVerifyNone>(patched_method);
-          }
+    static_assert(IsAligned<kObjectAlignment>(sizeof(ImageHeader)), "Header alignment check");
+    size_t total_objects_size = 0u;
+    for (const std::unique_ptr<ImageSpace>& space : spaces) {
+      total_objects_size += space->GetImageHeader().GetObjectsSection().Size();
+    }
+    size_t num_threads = std::min<size_t>(std::thread::hardware_concurrency(),
+                                          kMaxRelocationThreads);
+    if (num_threads > 1u && total_objects_size >= kMinParallelRelocationSize) {
+      ParallelPatchObjects(spaces, num_threads, patch_object);
+    } else {
+      for (const std::unique_ptr<ImageSpace>& space : spaces) {
+        uint32_t objects_end = space->GetImageHeader().GetObjectsSection().Size();
+        DCHECK_ALIGNED(objects_end, kObjectAlignment);
+        for (uint32_t pos = sizeof(ImageHeader); pos != objects_end; ) {
+          mirror::Object* object = reinterpret_cast<mirror::Object*>(space->Begin() + pos);
+          patch_object(object);
+          pos += RoundUp(object->SizeOf<kVerifyNone>(), kObjectAlignment);
         }
-        pos += RoundUp(object->SizeOf<kVerifyNone>(), kObjectAlignment);
       }
     }
     if (kIsDebugBuild && !kExtension) {
@@ -3178,6 +3251,13 @@ class ImageSpace::BootImageLoader {
                                   error_msg->c_str());
         return false;
       }
+      if (executable_ && Runtime::Current()->UseHugePagesForCode()) {
+        // The .text section runs from the executable offset to the end of the oat data.
+        Runtime::MadviseHugePagesForCode(
+            oat_file->Begin() + oat_file->GetOatHeader().GetExecutableOffset(),
+            oat_file->End(),
+            oat_location);
+      }
       const ImageHeader& image_header = space->GetImageHeader();
       uint32_t oat_checksum = oat_file->GetOatHeader().GetChecksum();
       uint32_t image_oat_checksum = image_header.GetOatChecksum();
@@ -18,6 +18,7 @@
 
 #include <sys/mman.h>
 
+#include <iterator>
 #include <memory>
 
 #include <android-base/logging.h>
@@ -42,7 +43,8 @@ namespace space {
 
 class MemoryToolLargeObjectMapSpace final : public LargeObjectMapSpace {
  public:
-  explicit MemoryToolLargeObjectMapSpace(const std::string& name) : LargeObjectMapSpace(name) {
+  explicit MemoryToolLargeObjectMapSpace(const std::string& name)
+      : LargeObjectMapSpace(name, /*map_cache_capacity=*/ 0U) {
   }
 
   ~MemoryToolLargeObjectMapSpace() override {
@@ -122,29 +124,89 @@ void LargeObjectSpace::CopyLiveToMarked() {
   mark_bitmap_.CopyFrom(&live_bitmap_);
 }
 
-LargeObjectMapSpace::LargeObjectMapSpace(const std::string& name)
-    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock") {}
+LargeObjectMapSpace::LargeObjectMapSpace(const std::string& name, size_t map_cache_capacity)
+    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock"),
+      map_cache_capacity_(map_cache_capacity),
+      cached_map_bytes_(0U) {}
 
-LargeObjectMapSpace* LargeObjectMapSpace::Create(const std::string& name) {
+LargeObjectMapSpace* LargeObjectMapSpace::Create(const std::string& name,
+                                                 size_t map_cache_capacity) {
   if (Runtime::Current()->IsRunningOnMemoryTool()) {
+    // Reusing mappings would hide use-after-free bugs from the memory tool.
     return new MemoryToolLargeObjectMapSpace(name);
   } else {
-    return new LargeObjectMapSpace(name);
+    return new LargeObjectMapSpace(name, map_cache_capacity);
   }
 }
 
+MemMap LargeObjectMapSpace::TakeCachedMap(size_t num_bytes) {
+  DCHECK_ALIGNED(num_bytes, kPageSize);
+  const size_t num_pages = num_bytes / kPageSize;
+  if (num_pages > kMaxCachedMapPages || cached_maps_[num_pages].empty()) {
+    return MemMap::Invalid();
+  }
+  // Reuse the most recently freed mapping, its pages are the most likely to be resident.
+  MemMap mem_map = std::move(cached_maps_[num_pages].back());
+  cached_maps_[num_pages].pop_back();
+  DCHECK_EQ(mem_map.BaseSize(), num_bytes);
+  DCHECK_GE(cached_map_bytes_, num_bytes);
+  cached_map_bytes_ -= num_bytes;
+  return mem_map;
+}
+
+void LargeObjectMapSpace::MaybeCacheMap(MemMap* mem_map) {
+  const size_t map_size = mem_map->BaseSize();
+  const size_t num_pages = map_size / kPageSize;
+  if (num_pages <= kMaxCachedMapPages && cached_map_bytes_ + map_size <= map_cache_capacity_) {
+    cached_maps_[num_pages].push_back(std::move(*mem_map));
+    cached_map_bytes_ += map_size;
+  }
+}
+
+size_t LargeObjectMapSpace::Trim() {
+  std::vector<MemMap> released_maps;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    for (std::vector<MemMap>& maps : cached_maps_) {
+      std::move(maps.begin(), maps.end(), std::back_inserter(released_maps));
+      maps.clear();
+    }
+    cached_map_bytes_ = 0U;
+  }
+  // Unmap outside of the lock.
+  size_t released_bytes = 0U;
+  for (MemMap& mem_map : released_maps) {
+    released_bytes += mem_map.BaseSize();
+    mem_map.Reset();
+  }
+  return released_bytes;
+}
+
 mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
                                            size_t* bytes_allocated, size_t* usable_size,
                                            size_t* bytes_tl_bulk_allocated) {
-  std::string error_msg;
-  MemMap mem_map = MemMap::MapAnonymous("large object space allocation",
-                                        num_bytes,
-                                        PROT_READ | PROT_WRITE,
-                                        /*low_4gb=*/ true,
-                                        &error_msg);
-  if (UNLIKELY(!mem_map.IsValid())) {
-    LOG(WARNING) << "Large object allocation failed: " << error_msg;
-    return nullptr;
+  MemMap mem_map;
+  if (map_cache_capacity_ != 0U) {
+    {
+      MutexLock mu(self, lock_);
+      mem_map = TakeCachedMap(RoundUp(num_bytes, kPageSize));
+    }
+    if (mem_map.IsValid()) {
+      // The pages hold a dead object. Allocations must return zeroed memory.
+      memset(mem_map.Begin(), 0, mem_map.BaseSize());
+    }
+  }
+  if (!mem_map.IsValid()) {
+    std::string error_msg;
+    mem_map = MemMap::MapAnonymous("large object space allocation",
+                                   num_bytes,
+                                   PROT_READ | PROT_WRITE,
+                                   /*low_4gb=*/ true,
+                                   &error_msg);
+    if (UNLIKELY(!mem_map.IsValid())) {
+      LOG(WARNING) << "Large object allocation failed: " << error_msg;
+      return nullptr;
+    }
   }
   mirror::Object* const obj = reinterpret_cast<mirror::Object*>(mem_map.Begin());
   const size_t allocation_size = mem_map.BaseSize();
@@ -201,6 +263,9 @@ size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
   size_t allocation_size = map_size;
   num_bytes_allocated_ -= allocation_size;
   --num_objects_allocated_;
+  if (map_cache_capacity_ != 0U) {
+    MaybeCacheMap(&it->second.mem_map);
+  }
   large_objects_.erase(it);
   return allocation_size;
 }
@@ -24,6 +24,7 @@
 #include "space.h"
 #include "thread-current-inl.h"
 
+#include <array>
 #include <set>
 #include <vector>
 
@@ -37,6 +38,8 @@ enum class LargeObjectSpaceType {
   kDisabled,
   kMap,
   kFreeList,
+  // Like kMap, but keeps recently freed mappings for reuse, see LargeObjectMapSpace.
+  kCachedMap,
 };
 
 // Abstraction implemented by all large object spaces.
@@ -112,6 +115,11 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   virtual void SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) = 0;
 
   virtual void ForEachMemMap(std::function<void(const MemMap&)> func) const = 0;
+  // Return memory the space keeps for future allocations to the system. Returns the number of
+  // bytes released.
+  virtual size_t Trim() REQUIRES(!lock_) {
+    return 0U;
+  }
   // GetRangeAtomic returns Begin() and End() atomically, that is, it never returns Begin() and
   // End() from different allocations.
   virtual std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const = 0;
@@ -148,11 +156,21 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
 };
 
 // A discontinuous large object space implemented by individual mmap/munmap calls.
+//
+// If created with a non-zero `map_cache_capacity`, freed mappings of up to kMaxCachedMapPages
+// pages are kept in per page count size classes and reused by later allocations of the same page
+// count, which saves the mmap/munmap calls and the page faults of churning mid-sized objects. At
+// most `map_cache_capacity` bytes are kept this way, until released by Trim().
 class LargeObjectMapSpace : public LargeObjectSpace {
  public:
+  // Largest mapping, in pages, that is kept for reuse.
+  static constexpr size_t kMaxCachedMapPages = 32;
+  // Default map cache capacity for LargeObjectSpaceType::kCachedMap.
+  static constexpr size_t kDefaultMapCacheCapacity = 4 * MB;
+
   // Creates a large object space. Allocations into the large object space use memory maps instead
   // of malloc.
-  static LargeObjectMapSpace* Create(const std::string& name);
+  static LargeObjectMapSpace* Create(const std::string& name, size_t map_cache_capacity = 0U);
   // Return the storage space required by obj.
   size_t AllocationSize(mirror::Object* obj, size_t* usable_size) override REQUIRES(!lock_);
   mirror::Object* Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
@@ -164,15 +182,27 @@ class LargeObjectMapSpace : public LargeObjectSpace {
   bool Contains(const mirror::Object* obj) const override NO_THREAD_SAFETY_ANALYSIS;
   void ForEachMemMap(std::function<void(const MemMap&)> func) const override REQUIRES(!lock_);
   std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const override REQUIRES(!lock_);
+  size_t Trim() override REQUIRES(!lock_);
+  // Number of bytes held in the map cache.
+  size_t GetCachedMapBytes() const REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    return cached_map_bytes_;
+  }
 
  protected:
   struct LargeObject {
     MemMap mem_map;
     bool is_zygote;
   };
-  explicit LargeObjectMapSpace(const std::string& name);
+  LargeObjectMapSpace(const std::string& name, size_t map_cache_capacity);
   virtual ~LargeObjectMapSpace() {}
 
+  // Take a cached mapping of `num_bytes` bytes (a multiple of the page size), or return an invalid
+  // MemMap if there is none.
+  MemMap TakeCachedMap(size_t num_bytes) REQUIRES(lock_);
+  // Keep `mem_map` for reuse if it fits in the cache. Otherwise leave it to be unmapped.
+  void MaybeCacheMap(MemMap* mem_map) REQUIRES(lock_);
+
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const override REQUIRES(!lock_);
   void SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) override
       REQUIRES(!lock_)
@@ -180,6 +210,11 @@ class LargeObjectMapSpace : public LargeObjectSpace {
 
   AllocationTrackingSafeMap<mirror::Object*, LargeObject, kAllocatorTagLOSMaps> large_objects_
       GUARDED_BY(lock_);
+
+  // Freed mappings kept for reuse, indexed by their size in pages.
+  const size_t map_cache_capacity_;
+  std::array<std::vector<MemMap>, kMaxCachedMapPages + 1> cached_maps_ GUARDED_BY(lock_);
+  size_t cached_map_bytes_ GUARDED_BY(lock_);
 };
 
 // A continuous large object space with a free-list to handle holes.
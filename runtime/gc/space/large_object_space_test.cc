@@ -36,11 +36,14 @@ class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
 void LargeObjectSpaceTest::LargeObjectTest() {
   size_t rand_seed = 0;
   Thread* const self = Thread::Current();
-  for (size_t i = 0; i < 2; ++i) {
+  for (size_t i = 0; i < 3; ++i) {
     LargeObjectSpace* los = nullptr;
     const size_t capacity = 128 * MB;
     if (i == 0) {
       los = space::LargeObjectMapSpace::Create("large object space");
+    } else if (i == 1) {
+      los = space::LargeObjectMapSpace::Create("large object space",
+                                               LargeObjectMapSpace::kDefaultMapCacheCapacity);
     } else {
       los = space::FreeListSpace::Create("large object space", capacity);
     }
@@ -152,10 +155,13 @@ class AllocRaceTask : public Task {
 };
 
 void LargeObjectSpaceTest::RaceTest() {
-  for (size_t los_type = 0; los_type < 2; ++los_type) {
+  for (size_t los_type = 0; los_type < 3; ++los_type) {
     LargeObjectSpace* los = nullptr;
     if (los_type == 0) {
       los = space::LargeObjectMapSpace::Create("large object space");
+    } else if (los_type == 1) {
+      los = space::LargeObjectMapSpace::Create("large object space",
+                                               LargeObjectMapSpace::kDefaultMapCacheCapacity);
     } else {
       los = space::FreeListSpace::Create("large object space", 128 * MB);
     }
@@ -182,6 +188,41 @@ TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, MapCache) {
+  Thread* const self = Thread::Current();
+  const size_t capacity = 8 * kPageSize;
+  std::unique_ptr<LargeObjectMapSpace> los(
+      LargeObjectMapSpace::Create("large object space", capacity));
+  size_t bytes_allocated, bytes_tl_bulk_allocated;
+  mirror::Object* obj = los->Alloc(self, 3 * kPageSize, &bytes_allocated, nullptr,
+                                   &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(obj != nullptr);
+  memset(obj, 0xff, bytes_allocated);
+  los->Free(self, obj);
+  EXPECT_EQ(3 * kPageSize, los->GetCachedMapBytes());
+
+  // An allocation of the same page count reuses the mapping, zeroed.
+  mirror::Object* reused = los->Alloc(self, 3 * kPageSize - 8, &bytes_allocated, nullptr,
+                                      &bytes_tl_bulk_allocated);
+  ASSERT_EQ(obj, reused);
+  EXPECT_EQ(0U, los->GetCachedMapBytes());
+  for (size_t i = 0; i < bytes_allocated; ++i) {
+    ASSERT_EQ(0U, reinterpret_cast<const uint8_t*>(reused)[i]);
+  }
+  los->Free(self, reused);
+
+  // Mappings that would exceed the capacity are unmapped.
+  mirror::Object* big = los->Alloc(self, 6 * kPageSize, &bytes_allocated, nullptr,
+                                   &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(big != nullptr);
+  los->Free(self, big);
+  EXPECT_EQ(3 * kPageSize, los->GetCachedMapBytes());
+
+  EXPECT_EQ(3 * kPageSize, los->Trim());
+  EXPECT_EQ(0U, los->GetCachedMapBytes());
+  EXPECT_EQ(0U, los->GetBytesAllocated());
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
@@ -75,6 +75,14 @@ class MallocSpace : public ContinuousMemMapAllocSpace {
   // Hands unused pages back to the system.
   virtual size_t Trim() = 0;
 
+  // Like Trim(), but may stop once NanoTime() reaches `deadline_ns`. `*resume_point` is 0 to start
+  // a trim and is set to where the next call should continue, or to 0 once the trim is complete.
+  // Spaces that cannot trim incrementally do a full Trim().
+  virtual size_t TrimIncrementally(size_t* resume_point, uint64_t deadline_ns ATTRIBUTE_UNUSED) {
+    *resume_point = 0;
+    return Trim();
+  }
+
   // Perform a mspace_inspect_all which calls back for each allocation chunk. The chunk may not be
   // in use, indicated by num_bytes equaling zero.
   virtual void Walk(WalkCallback callback, void* arg) = 0;
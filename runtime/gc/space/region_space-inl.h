@@ -196,9 +196,17 @@ inline uint64_t RegionSpace::GetObjectsAllocatedInternal() {
 template <typename Visitor>
 inline void RegionSpace::ScanUnevacFromSpace(accounting::ContinuousSpaceBitmap* bitmap,
                                              Visitor&& visitor) {
+  VisitUnevacFromSpaceRanges([bitmap, &visitor](uint8_t* begin, uint8_t* end) {
+    bitmap->VisitMarkedRange(
+        reinterpret_cast<uintptr_t>(begin), reinterpret_cast<uintptr_t>(end), visitor);
+  });
+}
+
+template <typename Visitor>
+inline void RegionSpace::VisitUnevacFromSpaceRanges(Visitor&& visitor) {
   const size_t iter_limit = kUseTableLookupReadBarrier
       ? num_regions_ : std::min(num_regions_, non_free_region_index_limit_);
-  // Instead of region-wise scan, find contiguous blocks of un-evac regions and then
+  // Instead of region-wise visits, find contiguous blocks of un-evac regions and then
   // visit them. Everything before visit_block_begin has been processed, while
   // [visit_block_begin, visit_block_end) still needs to be visited.
   uint8_t* visit_block_begin = nullptr;
@@ -213,27 +221,25 @@ inline void RegionSpace::ScanUnevacFromSpace(accounting::ContinuousSpaceBitmap*
       visit_block_end = r->End();
     } else if (visit_block_begin != nullptr) {
       // Visit the block range as r is not adjacent to current visit block.
-      bitmap->VisitMarkedRange(reinterpret_cast<uintptr_t>(visit_block_begin),
-                               reinterpret_cast<uintptr_t>(visit_block_end),
-                               visitor);
+      visitor(visit_block_begin, visit_block_end);
       visit_block_begin = nullptr;
     }
   }
   // Visit last block, if not processed yet.
   if (visit_block_begin != nullptr) {
-    bitmap->VisitMarkedRange(reinterpret_cast<uintptr_t>(visit_block_begin),
-                             reinterpret_cast<uintptr_t>(visit_block_end),
-                             visitor);
+    visitor(visit_block_begin, visit_block_end);
   }
 }
 
 template<bool kToSpaceOnly, typename Visitor>
-inline void RegionSpace::WalkInternal(Visitor&& visitor) {
+inline void RegionSpace::WalkInternal(size_t begin, size_t end, Visitor&& visitor) {
   // TODO: MutexLock on region_lock_ won't work due to lock order
   // issues (the classloader classes lock and the monitor lock). We
   // call this with threads suspended.
   Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
-  for (size_t i = 0; i < num_regions_; ++i) {
+  DCHECK_LE(begin, end);
+  DCHECK_LE(end, num_regions_);
+  for (size_t i = begin; i < end; ++i) {
     Region* r = &regions_[i];
     if (r->IsFree() || (kToSpaceOnly && !r->IsInToSpace())) {
       continue;
@@ -297,11 +303,15 @@ inline void RegionSpace::WalkNonLargeRegion(Visitor&& visitor, const Region* r)
 
 template <typename Visitor>
 inline void RegionSpace::Walk(Visitor&& visitor) {
-  WalkInternal</* kToSpaceOnly= */ false>(visitor);
+  WalkInternal</* kToSpaceOnly= */ false>(0u, num_regions_, visitor);
 }
 template <typename Visitor>
 inline void RegionSpace::WalkToSpace(Visitor&& visitor) {
-  WalkInternal</* kToSpaceOnly= */ true>(visitor);
+  WalkInternal</* kToSpaceOnly= */ true>(0u, num_regions_, visitor);
+}
+template <typename Visitor>
+inline void RegionSpace::WalkRegions(size_t begin, size_t end, Visitor&& visitor) {
+  WalkInternal</* kToSpaceOnly= */ false>(begin, end, visitor);
 }
 
 inline mirror::Object* RegionSpace::GetNextObject(mirror::Object* obj) {
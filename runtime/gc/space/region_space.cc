@@ -18,6 +18,7 @@
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
 #include "base/dumpable.h"
+#include "base/histogram-inl.h"
 #include "base/logging.h"
 #include "gc/accounting/read_barrier_table.h"
 #include "mirror/class-inl.h"
@@ -116,7 +117,9 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
       non_free_region_index_limit_(0U),
       current_region_(&full_region_),
       evac_region_(nullptr),
-      cyclic_alloc_region_index_(0U) {
+      cyclic_alloc_region_index_(0U),
+      tlab_refill_count_(0U),
+      tlab_wasted_bytes_(0U) {
   CHECK_ALIGNED(mem_map_.Size(), kRegionSize);
   CHECK_ALIGNED(mem_map_.Begin(), kRegionSize);
   DCHECK_GT(num_regions_, 0U);
@@ -189,10 +192,10 @@ void RegionSpace::Region::SetAsUnevacFromSpace(bool clear_live_bytes) {
   type_ = RegionType::kRegionTypeUnevacFromSpace;
   if (IsNewlyAllocated()) {
     // A newly allocated region set as unevac from-space must be
-    // a large or large tail region.
-    DCHECK(IsLarge() || IsLargeTail()) << static_cast<uint>(state_);
-    // Always clear the live bytes of a newly allocated (large or
-    // large tail) region.
+    // a large or large tail region, or a pinned region.
+    DCHECK(IsLarge() || IsLargeTail() || IsPinned()) << static_cast<uint>(state_);
+    // Always clear the live bytes of a newly allocated (large,
+    // large tail or pinned) region.
     clear_live_bytes = true;
     // Clear the "newly allocated" status here, as we do not want the
     // GC to see it when encountering (and processing) references in the
@@ -360,7 +363,9 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
+        // Pinned regions hold objects used by JNI critical sections and must not move.
+        bool is_pinned = r->IsPinned();
+        bool should_evacuate = !is_pinned && r->ShouldBeEvacuated(evac_mode);
         bool is_newly_allocated = r->IsNewlyAllocated();
         if (should_evacuate) {
           r->SetAsFromSpace();
@@ -383,6 +388,12 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
           }
           num_expected_large_tails = RoundUp(r->BytesAllocated(), kRegionSize) / kRegionSize - 1;
           DCHECK_GT(num_expected_large_tails, 0U);
+        } else if (UNLIKELY(is_pinned && use_generational_cc_ && is_newly_allocated)) {
+          // Same as for a newly allocated large region above, the objects of a newly
+          // allocated region kept because of pinning may already be marked while its
+          // live bytes are still -1.
+          GetMarkBitmap()->ClearRange(reinterpret_cast<mirror::Object*>(r->Begin()),
+                                      reinterpret_cast<mirror::Object*>(r->End()));
         }
       } else {
         DCHECK(state == RegionState::kRegionStateLargeTail &&
@@ -411,6 +422,19 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   evac_region_ = &full_region_;
 }
 
+void RegionSpace::AddUnevacFromSpaceLivePercents(Histogram<uint64_t>* histogram) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  for (size_t i = 0; i < std::min(num_regions_, non_free_region_index_limit_); ++i) {
+    Region* r = &regions_[i];
+    if (r->IsInUnevacFromSpace() && r->IsAllocated()) {
+      const size_t bytes_allocated = r->BytesAllocated();
+      if (bytes_allocated != 0) {
+        histogram->AddValue(r->LiveBytes() * 100U / bytes_allocated);
+      }
+    }
+  }
+}
+
 static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end) {
   ZeroAndReleasePages(begin, end - begin);
   if (kProtectClearedRegions) {
@@ -871,6 +895,7 @@ bool RegionSpace::AllocNewTlab(Thread* self,
     r->thread_ = self;
     r->SetTop(r->End());
     self->SetTlab(start, start + tlab_size, r->End());
+    tlab_refill_count_.fetch_add(1u, std::memory_order_relaxed);
     return true;
   }
   return false;
@@ -904,6 +929,8 @@ void RegionSpace::RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) {
     size_t remaining_bytes = r->End() - thread->GetTlabPos();
     if (reuse && remaining_bytes >= gc::Heap::kPartialTlabSize) {
       partial_tlabs_.insert(std::make_pair(remaining_bytes, r));
+    } else {
+      tlab_wasted_bytes_.fetch_add(remaining_bytes, std::memory_order_relaxed);
     }
   }
   thread->ResetTlab();
@@ -1001,6 +1028,7 @@ size_t RegionSpace::AllocationSizeNonvirtual(mirror::Object* obj, size_t* usable
 }
 
 void RegionSpace::Region::Clear(bool zero_and_release_pages) {
+  DCHECK(!IsPinned());
   top_.store(begin_, std::memory_order_relaxed);
   state_ = RegionState::kRegionStateFree;
   type_ = RegionType::kRegionTypeNone;
@@ -26,6 +26,9 @@
 #include <map>
 
 namespace art {
+
+template <class Value> class Histogram;
+
 namespace gc {
 
 namespace accounting {
@@ -186,6 +189,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   uint64_t GetObjectsAllocatedInUnevacFromSpace() REQUIRES(!region_lock_) {
     return GetObjectsAllocatedInternal<RegionType::kRegionTypeUnevacFromSpace>();
   }
+  // Add the live percentage of each allocated region of the unevacuated from-space to `histogram`,
+  // i.e. how fragmented the regions that this GC keeps in place are. Large objects are skipped.
+  // Must be called after marking and before ClearFromSpace().
+  void AddUnevacFromSpaceLivePercents(Histogram<uint64_t>* histogram) REQUIRES(!region_lock_);
   size_t GetMaxPeakNumNonFreeRegions() const {
     return max_peak_num_non_free_regions_;
   }
@@ -214,6 +221,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   ALWAYS_INLINE void Walk(Visitor&& visitor) REQUIRES(Locks::mutator_lock_);
   template <typename Visitor>
   ALWAYS_INLINE void WalkToSpace(Visitor&& visitor) REQUIRES(Locks::mutator_lock_);
+  // Same as Walk(), but only for the regions with an index in [begin, end).
+  template <typename Visitor>
+  ALWAYS_INLINE void WalkRegions(size_t begin, size_t end, Visitor&& visitor)
+      REQUIRES(Locks::mutator_lock_);
 
   // Scans regions and calls visitor for objects in unevac-space corresponding
   // to the bits set in 'bitmap'.
@@ -224,6 +235,11 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   ALWAYS_INLINE void ScanUnevacFromSpace(accounting::ContinuousSpaceBitmap* bitmap,
                                          Visitor&& visitor) NO_THREAD_SAFETY_ANALYSIS;
 
+  // Calls visitor(begin, end) for each maximal block of contiguous unevac-space regions.
+  // Same restrictions as ScanUnevacFromSpace().
+  template <typename Visitor>
+  ALWAYS_INLINE void VisitUnevacFromSpaceRanges(Visitor&& visitor) NO_THREAD_SAFETY_ANALYSIS;
+
   accounting::ContinuousSpaceBitmap::SweepCallback* GetSweepCallback() override {
     return nullptr;
   }
@@ -321,6 +337,23 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     reg->AddLiveBytes(alloc_size);
   }
 
+  // Same as AddLiveBytes, but safe to call from multiple GC threads concurrently.
+  void AtomicAddLiveBytes(mirror::Object* ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(ref);
+    reg->AtomicAddLiveBytes(alloc_size);
+  }
+
+  // Pin the region holding `ref` (the head region for a large object), so that it is not
+  // evacuated by RegionSpace::SetFromSpace until it is unpinned. Used by JNI critical
+  // sections, which hold the address of the object's data.
+  void PinRegion(mirror::Object* ref) {
+    RefToRegionUnlocked(ref)->Pin();
+  }
+
+  void UnpinRegion(mirror::Object* ref) {
+    RefToRegionUnlocked(ref)->Unpin();
+  }
+
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_) {
     if (kIsDebugBuild) {
       MutexLock mu(Thread::Current(), region_lock_);
@@ -372,6 +405,17 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   bool AllocNewTlab(Thread* self, const size_t tlab_size, size_t* bytes_tl_bulk_allocated)
       REQUIRES(!region_lock_);
 
+  // Number of TLABs handed out by AllocNewTlab since the space was created.
+  uint64_t GetTlabRefillCount() const {
+    return tlab_refill_count_.load(std::memory_order_relaxed);
+  }
+
+  // Bytes left unused at the end of revoked TLABs that could not be handed out again as partial
+  // TLABs. They are only reclaimed by the next GC.
+  uint64_t GetTlabWastedBytes() const {
+    return tlab_wasted_bytes_.load(std::memory_order_relaxed);
+  }
+
   uint32_t Time() {
     return time_;
   }
@@ -394,6 +438,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
           end_(nullptr),
           objects_allocated_(0),
           alloc_time_(0),
+          pin_count_(0),
           is_newly_allocated_(false),
           is_a_tlab_(false),
           state_(RegionState::kRegionStateAllocated),
@@ -409,6 +454,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       objects_allocated_.store(0, std::memory_order_relaxed);
       alloc_time_ = 0;
       live_bytes_ = static_cast<size_t>(-1);
+      pin_count_.store(0, std::memory_order_relaxed);
       is_newly_allocated_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
@@ -499,6 +545,21 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       return is_a_tlab_;
     }
 
+    // Pinning is done by mutators, which are suspended while the from-space is set up.
+    void Pin() {
+      DCHECK(!IsFree() && !IsLargeTail());
+      pin_count_.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    void Unpin() {
+      size_t old_pin_count = pin_count_.fetch_sub(1u, std::memory_order_relaxed);
+      DCHECK_GT(old_pin_count, 0u);
+    }
+
+    bool IsPinned() const {
+      return pin_count_.load(std::memory_order_relaxed) != 0u;
+    }
+
     bool IsInFromSpace() const {
       return type_ == RegionType::kRegionTypeFromSpace;
     }
@@ -561,6 +622,16 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       DCHECK_LE(live_bytes_, BytesAllocated());
     }
 
+    void AtomicAddLiveBytes(size_t live_bytes) {
+      DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
+      DCHECK(!IsLargeTail());
+      DCHECK_NE(live_bytes_, static_cast<size_t>(-1));
+      static_assert(sizeof(Atomic<size_t>) == sizeof(live_bytes_),
+                    "Atomic<size_t> must have the same size as size_t");
+      reinterpret_cast<Atomic<size_t>*>(&live_bytes_)->fetch_add(
+          IsLarge() ? Top() - begin_ : live_bytes, std::memory_order_relaxed);
+    }
+
     bool AllAllocatedBytesAreLive() const {
       return LiveBytes() == static_cast<size_t>(Top() - Begin());
     }
@@ -621,6 +692,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     // objects_allocated_ is accessed using memory_order_relaxed. Treat as approximate when there
     // are concurrent updates.
     Atomic<size_t> objects_allocated_;  // The number of objects allocated.
+    Atomic<size_t> pin_count_;          // The number of JNI critical sections using the region.
     uint32_t alloc_time_;               // The allocation time of the region.
     // Note that newly allocated and evacuated regions use -1 as
     // special value for `live_bytes_`.
@@ -633,7 +705,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   };
 
   template<bool kToSpaceOnly, typename Visitor>
-  ALWAYS_INLINE void WalkInternal(Visitor&& visitor) NO_THREAD_SAFETY_ANALYSIS;
+  ALWAYS_INLINE void WalkInternal(size_t begin, size_t end, Visitor&& visitor)
+      NO_THREAD_SAFETY_ANALYSIS;
 
   // Visitor will be iterating on objects in increasing address order.
   template<typename Visitor>
@@ -774,6 +847,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // Mark bitmap used by the GC.
   accounting::ContinuousSpaceBitmap mark_bitmap_;
 
+  // TLAB statistics, see GetTlabRefillCount and GetTlabWastedBytes.
+  Atomic<uint64_t> tlab_refill_count_;
+  Atomic<uint64_t> tlab_wasted_bytes_;
+
   DISALLOW_COPY_AND_ASSIGN(RegionSpace);
 };
 
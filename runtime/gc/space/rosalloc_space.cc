@@ -17,6 +17,8 @@
 
 #include "rosalloc_space-inl.h"
 
+#include <limits>
+
 #include "base/logging.h"  // For VLOG.
 #include "base/time_utils.h"
 #include "base/utils.h"
@@ -311,8 +313,13 @@ size_t RosAllocSpace::FreeList(Thread* self, size_t num_ptrs, mirror::Object** p
 }
 
 size_t RosAllocSpace::Trim() {
-  VLOG(heap) << "RosAllocSpace::Trim() ";
-  {
+  size_t resume_point = 0;
+  return TrimIncrementally(&resume_point, std::numeric_limits<uint64_t>::max());
+}
+
+size_t RosAllocSpace::TrimIncrementally(size_t* resume_point, uint64_t deadline_ns) {
+  VLOG(heap) << "RosAllocSpace::TrimIncrementally() from " << *resume_point;
+  if (*resume_point == 0) {
     Thread* const self = Thread::Current();
     // SOA required for Rosalloc::Trim() -> ArtRosAllocMoreCore() -> Heap::GetRosAllocSpace.
     ScopedObjectAccess soa(self);
@@ -322,8 +329,9 @@ size_t RosAllocSpace::Trim() {
   }
   // Attempt to release pages if it does not release all empty pages.
   if (!rosalloc_->DoesReleaseAllPages()) {
-    return rosalloc_->ReleasePages();
+    return rosalloc_->ReleasePages(resume_point, deadline_ns);
   }
+  *resume_point = 0;
   return 0;
 }
 
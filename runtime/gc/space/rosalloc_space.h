@@ -111,6 +111,7 @@ class RosAllocSpace : public MallocSpace {
   }
 
   size_t Trim() override;
+  size_t TrimIncrementally(size_t* resume_point, uint64_t deadline_ns) override;
   void Walk(WalkCallback callback, void* arg) override REQUIRES(!lock_);
   size_t GetFootprint() override;
   size_t GetFootprintLimit() override;
@@ -412,6 +412,16 @@ inline bool ShouldDenyAccessToMember(T* member,
     return false;
   }
 
+  // Exit early, without determining the caller's domain, if neither an application nor a
+  // platform caller could be denied or warned about accessing member. This is the case of
+  // most member accesses by processes with hidden API checks disabled.
+  Runtime* runtime = Runtime::Current();
+  if (runtime->GetHiddenApiEnforcementPolicy() == EnforcementPolicy::kDisabled &&
+      ((runtime_flags & kAccCorePlatformApi) != 0 ||
+       runtime->GetCorePlatformApiEnforcementPolicy() == EnforcementPolicy::kDisabled)) {
+    return false;
+  }
+
   // Determine which domain the caller and callee belong to.
   // This can be *very* expensive. This is why ShouldDenyAccessToMember
   // should not be called on every individual access.
@@ -433,7 +443,7 @@ inline bool ShouldDenyAccessToMember(T* member,
       DCHECK(!callee_context.IsApplicationDomain());
 
       // Exit early if access checks are completely disabled.
-      EnforcementPolicy policy = Runtime::Current()->GetHiddenApiEnforcementPolicy();
+      EnforcementPolicy policy = runtime->GetHiddenApiEnforcementPolicy();
       if (policy == EnforcementPolicy::kDisabled) {
         return false;
       }
@@ -460,7 +470,7 @@ inline bool ShouldDenyAccessToMember(T* member,
       }
 
       // Allow access if access checks are disabled.
-      EnforcementPolicy policy = Runtime::Current()->GetCorePlatformApiEnforcementPolicy();
+      EnforcementPolicy policy = runtime->GetCorePlatformApiEnforcementPolicy();
       if (policy == EnforcementPolicy::kDisabled) {
         return false;
       }
@@ -37,6 +37,8 @@
 
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
+#include <android-base/strings.h>
+#include <zlib.h>
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
@@ -413,6 +415,82 @@ class FileEndianOutput final : public EndianOutputBuffered {
   bool errors_;
 };
 
+// Compresses the records into a gzip stream as they are flushed, so that the whole dump
+// never needs to be held in memory or written out uncompressed.
+class GzipFileEndianOutput final : public EndianOutputBuffered {
+ public:
+  GzipFileEndianOutput(File* fp, size_t reserved_size)
+      : EndianOutputBuffered(reserved_size), fp_(fp), errors_(false), finished_(false) {
+    DCHECK(fp != nullptr);
+    memset(&stream_, 0, sizeof(stream_));
+    // Favor speed: the heap is dumped with all threads suspended.
+    // The window bits of 15 + 16 request a gzip header and trailer.
+    errors_ = deflateInit2(&stream_,
+                           Z_BEST_SPEED,
+                           Z_DEFLATED,
+                           /*windowBits=*/ 15 + 16,
+                           /*memLevel=*/ 8,
+                           Z_DEFAULT_STRATEGY) != Z_OK;
+    initialized_ = !errors_;
+  }
+  ~GzipFileEndianOutput() {
+    if (initialized_) {
+      deflateEnd(&stream_);
+    }
+  }
+
+  // Writes out the rest of the compressed stream. Must be called once all the records
+  // have been written.
+  void Finish() {
+    DCHECK(!finished_);
+    finished_ = true;
+    Deflate(nullptr, 0u, Z_FINISH);
+  }
+
+  bool Errors() {
+    return errors_;
+  }
+
+ protected:
+  void HandleFlush(const uint8_t* buffer, size_t length) override {
+    DCHECK(!finished_);
+    Deflate(buffer, length, Z_NO_FLUSH);
+  }
+
+ private:
+  static constexpr size_t kOutputChunkSize = 64 * KB;
+
+  void Deflate(const uint8_t* buffer, size_t length, int flush) {
+    if (errors_) {
+      return;
+    }
+    stream_.next_in = const_cast<Bytef*>(buffer);
+    stream_.avail_in = dchecked_integral_cast<uInt>(length);
+    do {
+      stream_.next_out = output_chunk_;
+      stream_.avail_out = kOutputChunkSize;
+      int result = deflate(&stream_, flush);
+      if (result == Z_STREAM_ERROR) {
+        errors_ = true;
+        return;
+      }
+      size_t compressed_length = kOutputChunkSize - stream_.avail_out;
+      if (compressed_length != 0u && !fp_->WriteFully(output_chunk_, compressed_length)) {
+        errors_ = true;
+        return;
+      }
+    } while (stream_.avail_out == 0u);
+    DCHECK_EQ(stream_.avail_in, 0u);
+  }
+
+  File* fp_;
+  bool errors_;
+  bool initialized_;
+  bool finished_;
+  z_stream stream_;
+  uint8_t output_chunk_[kOutputChunkSize];
+};
+
 class VectorEndianOuputput final : public EndianOutputBuffered {
  public:
   VectorEndianOuputput(std::vector<uint8_t>& data, size_t reserved_size)
@@ -777,7 +855,21 @@ class Hprof : public SingleRootVisitor {
 
     std::unique_ptr<File> file(new File(out_fd, filename_, true));
     bool okay;
-    {
+    if (android::base::EndsWith(filename_, ".gz")) {
+      // The output chunk is too big for the stack.
+      std::unique_ptr<GzipFileEndianOutput> gzip_output(
+          new GzipFileEndianOutput(file.get(), max_length));
+      output_ = gzip_output.get();
+      ProcessHeap(true);
+      gzip_output->Finish();
+      okay = !gzip_output->Errors();
+
+      if (okay) {
+        // Check for expected uncompressed size, as for the plain file output.
+        DCHECK_LE(gzip_output->SumLength(), overall_size);
+      }
+      output_ = nullptr;
+    } else {
       FileEndianOutput file_output(file.get(), max_length);
       output_ = &file_output;
       ProcessHeap(true);
@@ -1598,6 +1690,7 @@ void Hprof::VisitRoot(mirror::Object* obj, const RootInfo& info) {
 // sent directly to DDMS.
 // If "fd" is >= 0, the output will be written to that file descriptor.
 // Otherwise, "filename" is used to create an output file.
+// If "filename" ends with ".gz", the output is compressed with gzip while it is written.
 void DumpHeap(const char* filename, int fd, bool direct_to_ddms) {
   CHECK(filename != nullptr);
   Thread* self = Thread::Current();
@@ -29,7 +29,7 @@
 namespace art {
 
 const uint8_t ImageHeader::kImageMagic[] = { 'a', 'r', 't', '\n' };
-const uint8_t ImageHeader::kImageVersion[] = { '0', '8', '6', '\0' };  // FP16 Min and Max intrinsic
+const uint8_t ImageHeader::kImageVersion[] = { '0', '8', '8', '\0' };  // Unsigned div intrinsics
 
 ImageHeader::ImageHeader(uint32_t image_reservation_size,
                          uint32_t component_count,
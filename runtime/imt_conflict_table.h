@@ -18,20 +18,30 @@
 #define ART_RUNTIME_IMT_CONFLICT_TABLE_H_
 
 #include <cstddef>
+#include <limits>
 
+#include "art_method.h"
+#include "base/bit_utils.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/macros.h"
 
 namespace art {
 
-class ArtMethod;
-
 // Table to resolve IMT conflicts at runtime. The table is attached to
 // the jni entrypoint of IMT conflict ArtMethods.
-// The table contains a list of pairs of { interface_method, implementation_method }
+//
+// Small tables contain a list of pairs of { interface_method, implementation_method }
 // with the last entry being null to make an assembly implementation of a lookup
 // faster.
+//
+// Tables with at least `kMinHashedEntries` entries use an open-addressed hash layout
+// instead, so that the lookup does not degrade for interfaces with many methods in
+// the same IMT slot. The first entry is a header { kHashedMarker, number_of_slots }
+// and it is followed by a power of two number of slots, with null interface methods
+// in the empty slots. The slot of an interface method is found by linear probing
+// from its dex method index masked by the number of slots minus one. The dex method
+// index survives the relocation of images, unlike the address of the method.
 class ImtConflictTable {
   enum MethodIndex {
     kMethodInterface,
@@ -40,59 +50,96 @@ class ImtConflictTable {
   };
 
  public:
+  static constexpr size_t kMinHashedEntries = 8u;
+  static constexpr uintptr_t kHashedMarker = 1u;
+
   // Build a new table copying `other` and adding the new entry formed of
   // the pair { `interface_method`, `implementation_method` }
   ImtConflictTable(ImtConflictTable* other,
                    ArtMethod* interface_method,
                    ArtMethod* implementation_method,
-                   PointerSize pointer_size) {
-    const size_t count = other->NumEntries(pointer_size);
-    for (size_t i = 0; i < count; ++i) {
-      SetInterfaceMethod(i, pointer_size, other->GetInterfaceMethod(i, pointer_size));
-      SetImplementationMethod(i, pointer_size, other->GetImplementationMethod(i, pointer_size));
-    }
-    SetInterfaceMethod(count, pointer_size, interface_method);
-    SetImplementationMethod(count, pointer_size, implementation_method);
-    // Add the null marker.
-    SetInterfaceMethod(count + 1, pointer_size, nullptr);
-    SetImplementationMethod(count + 1, pointer_size, nullptr);
+                   PointerSize pointer_size)
+      : ImtConflictTable(other->NumEntries(pointer_size) + 1u, pointer_size) {
+    other->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods) {
+      AddEntry(methods.first, methods.second, pointer_size);
+      return methods;
+    }, pointer_size);
+    AddEntry(interface_method, implementation_method, pointer_size);
   }
 
-  // num_entries excludes the header.
+  // num_entries excludes the header. All entries are cleared, they are to be filled
+  // with `AddEntry()` or, when copying a table with the same number of entries, with
+  // the setters below.
   ImtConflictTable(size_t num_entries, PointerSize pointer_size) {
-    SetInterfaceMethod(num_entries, pointer_size, nullptr);
-    SetImplementationMethod(num_entries, pointer_size, nullptr);
+    size_t first_slot = 0u;
+    if (UsesHashedLayout(num_entries)) {
+      first_slot = 1u;
+      SetMethod(kMethodInterface, pointer_size, reinterpret_cast<ArtMethod*>(kHashedMarker));
+      SetMethod(kMethodImplementation,
+                pointer_size,
+                reinterpret_cast<ArtMethod*>(NumHashedSlots(num_entries)));
+    }
+    // Clear the slots, including the null marker of the linear layout.
+    const size_t end = ComputeSize(num_entries, pointer_size) / EntrySize(pointer_size);
+    for (size_t i = first_slot; i != end; ++i) {
+      SetMethod(i * kMethodCount + kMethodInterface, pointer_size, nullptr);
+      SetMethod(i * kMethodCount + kMethodImplementation, pointer_size, nullptr);
+    }
   }
 
-  // Set an entry at an index.
+  // Set an entry at an index. For hashed tables, the index is the slot index.
   void SetInterfaceMethod(size_t index, PointerSize pointer_size, ArtMethod* method) {
-    SetMethod(index * kMethodCount + kMethodInterface, pointer_size, method);
+    SetMethod(MethodIndexOf(index, pointer_size) + kMethodInterface, pointer_size, method);
   }
 
   void SetImplementationMethod(size_t index, PointerSize pointer_size, ArtMethod* method) {
-    SetMethod(index * kMethodCount + kMethodImplementation, pointer_size, method);
+    SetMethod(MethodIndexOf(index, pointer_size) + kMethodImplementation, pointer_size, method);
   }
 
   ArtMethod* GetInterfaceMethod(size_t index, PointerSize pointer_size) const {
-    return GetMethod(index * kMethodCount + kMethodInterface, pointer_size);
+    return GetMethod(MethodIndexOf(index, pointer_size) + kMethodInterface, pointer_size);
   }
 
   ArtMethod* GetImplementationMethod(size_t index, PointerSize pointer_size) const {
-    return GetMethod(index * kMethodCount + kMethodImplementation, pointer_size);
+    return GetMethod(MethodIndexOf(index, pointer_size) + kMethodImplementation, pointer_size);
   }
 
   void** AddressOfInterfaceMethod(size_t index, PointerSize pointer_size) {
-    return AddressOfMethod(index * kMethodCount + kMethodInterface, pointer_size);
+    return AddressOfMethod(MethodIndexOf(index, pointer_size) + kMethodInterface, pointer_size);
   }
 
   void** AddressOfImplementationMethod(size_t index, PointerSize pointer_size) {
-    return AddressOfMethod(index * kMethodCount + kMethodImplementation, pointer_size);
+    return AddressOfMethod(MethodIndexOf(index, pointer_size) + kMethodImplementation,
+                           pointer_size);
+  }
+
+  // Add an entry to a table created with room for it.
+  void AddEntry(ArtMethod* interface_method,
+                ArtMethod* implementation_method,
+                PointerSize pointer_size) {
+    DCHECK(interface_method != nullptr);
+    size_t index;
+    if (IsHashed(pointer_size)) {
+      const size_t mask = NumSlots(pointer_size) - 1u;
+      index = Hash(interface_method) & mask;
+      while (GetInterfaceMethod(index, pointer_size) != nullptr) {
+        index = (index + 1u) & mask;
+      }
+    } else {
+      index = NumEntries(pointer_size);
+    }
+    SetInterfaceMethod(index, pointer_size, interface_method);
+    SetImplementationMethod(index, pointer_size, implementation_method);
   }
 
   // Return true if two conflict tables are the same.
   bool Equals(ImtConflictTable* other, PointerSize pointer_size) const {
-    size_t num = NumEntries(pointer_size);
-    if (num != other->NumEntries(pointer_size)) {
+    if (IsHashed(pointer_size) != other->IsHashed(pointer_size)) {
+      return false;
+    }
+    // Tables with the same entries added in the same order have the same slots.
+    size_t num = NumSlots(pointer_size);
+    if (num != other->NumSlots(pointer_size)) {
       return false;
     }
     for (size_t i = 0; i < num; ++i) {
@@ -107,13 +154,20 @@ class ImtConflictTable {
 
   // Visit all of the entries.
   // NO_THREAD_SAFETY_ANALYSIS for calling with held locks. Visitor is passed a pair of ArtMethod*
-  // and also returns one. The order is <interface, implementation>.
+  // and also returns one. The order is <interface, implementation>. The entries are updated
+  // in place, so an interface method may only be replaced by a method with the same dex
+  // method index, such as its relocated copy.
   template<typename Visitor>
   void Visit(const Visitor& visitor, PointerSize pointer_size) NO_THREAD_SAFETY_ANALYSIS {
-    uint32_t table_index = 0;
-    for (;;) {
+    const bool is_hashed = IsHashed(pointer_size);
+    const size_t num_slots =
+        is_hashed ? NumSlots(pointer_size) : std::numeric_limits<size_t>::max();
+    for (size_t table_index = 0; table_index != num_slots; ++table_index) {
       ArtMethod* interface_method = GetInterfaceMethod(table_index, pointer_size);
       if (interface_method == nullptr) {
+        if (is_hashed) {
+          continue;
+        }
         break;
       }
       ArtMethod* implementation_method = GetImplementationMethod(table_index, pointer_size);
@@ -125,13 +179,27 @@ class ImtConflictTable {
       if (input.second != updated.second) {
         SetImplementationMethod(table_index, pointer_size, updated.second);
       }
-      ++table_index;
     }
   }
 
   // Lookup the implementation ArtMethod associated to `interface_method`. Return null
   // if not found.
   ArtMethod* Lookup(ArtMethod* interface_method, PointerSize pointer_size) const {
+    if (IsHashed(pointer_size)) {
+      // The table always has empty slots, so the probing terminates. An entry left in
+      // the wrong slot by a class redefinition that changed the dex method index is not
+      // found, the runtime then adds an entry with the new index to a new table.
+      const size_t mask = NumSlots(pointer_size) - 1u;
+      for (size_t index = Hash(interface_method) & mask; ; index = (index + 1u) & mask) {
+        ArtMethod* current_interface_method = GetInterfaceMethod(index, pointer_size);
+        if (current_interface_method == nullptr) {
+          return nullptr;
+        }
+        if (current_interface_method == interface_method) {
+          return GetImplementationMethod(index, pointer_size);
+        }
+      }
+    }
     uint32_t table_index = 0;
     for (;;) {
       ArtMethod* current_interface_method = GetInterfaceMethod(table_index, pointer_size);
@@ -148,6 +216,15 @@ class ImtConflictTable {
 
   // Compute the number of entries in this table.
   size_t NumEntries(PointerSize pointer_size) const {
+    if (IsHashed(pointer_size)) {
+      size_t num_entries = 0u;
+      for (size_t i = 0, num_slots = NumSlots(pointer_size); i != num_slots; ++i) {
+        if (GetInterfaceMethod(i, pointer_size) != nullptr) {
+          ++num_entries;
+        }
+      }
+      return num_entries;
+    }
     uint32_t table_index = 0;
     while (GetInterfaceMethod(table_index, pointer_size) != nullptr) {
       ++table_index;
@@ -155,20 +232,36 @@ class ImtConflictTable {
     return table_index;
   }
 
+  // Return the number of slots that the accessors above can index, the number of
+  // entries for tables with the linear layout.
+  size_t NumSlots(PointerSize pointer_size) const {
+    return IsHashed(pointer_size)
+        ? reinterpret_cast<uintptr_t>(GetMethod(kMethodImplementation, pointer_size))
+        : NumEntries(pointer_size);
+  }
+
+  bool IsHashed(PointerSize pointer_size) const {
+    return reinterpret_cast<uintptr_t>(GetMethod(kMethodInterface, pointer_size)) ==
+        kHashedMarker;
+  }
+
   // Compute the size in bytes taken by this table.
   size_t ComputeSize(PointerSize pointer_size) const {
-    // Add the end marker.
-    return ComputeSize(NumEntries(pointer_size), pointer_size);
+    // Add the header or the end marker.
+    return (NumSlots(pointer_size) + 1u) * EntrySize(pointer_size);
   }
 
   // Compute the size in bytes needed for copying the given `table` and add
   // one more entry.
   static size_t ComputeSizeWithOneMoreEntry(ImtConflictTable* table, PointerSize pointer_size) {
-    return table->ComputeSize(pointer_size) + EntrySize(pointer_size);
+    return ComputeSize(table->NumEntries(pointer_size) + 1u, pointer_size);
   }
 
   // Compute size with a fixed number of entries.
   static size_t ComputeSize(size_t num_entries, PointerSize pointer_size) {
+    if (UsesHashedLayout(num_entries)) {
+      return (NumHashedSlots(num_entries) + 1u) * EntrySize(pointer_size);  // Add the header.
+    }
     return (num_entries + 1) * EntrySize(pointer_size);  // Add one for null terminator.
   }
 
@@ -177,6 +270,24 @@ class ImtConflictTable {
   }
 
  private:
+  static constexpr bool UsesHashedLayout(size_t num_entries) {
+    return num_entries >= kMinHashedEntries;
+  }
+
+  // Keep the load factor at or below 1/2 to keep the probe sequences short.
+  static constexpr size_t NumHashedSlots(size_t num_entries) {
+    return RoundUpToPowerOfTwo(2u * num_entries);
+  }
+
+  static uint32_t Hash(ArtMethod* interface_method) {
+    return interface_method->GetDexMethodIndex();
+  }
+
+  // Return the index of the first method of the entry at `index`, skipping the header.
+  size_t MethodIndexOf(size_t index, PointerSize pointer_size) const {
+    return (IsHashed(pointer_size) ? index + 1u : index) * kMethodCount;
+  }
+
   void** AddressOfMethod(size_t index, PointerSize pointer_size) {
     if (pointer_size == PointerSize::k64) {
       return reinterpret_cast<void**>(&data64_[index]);
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "jni.h"
 
@@ -25,6 +26,8 @@
 #include "class_linker.h"
 #include "common_runtime_test.h"
 #include "handle_scope-inl.h"
+#include "imt_conflict_table.h"
+#include "linear_alloc.h"
 #include "mirror/accessible_object.h"
 #include "mirror/class.h"
 #include "mirror/class_loader.h"
@@ -101,4 +104,54 @@ TEST_F(ImTableTest, NewClassBefore) {
   CHECK_EQ(ImTable::GetImtIndex(methods.first), ImTable::GetImtIndex(methods.second));
 }
 
+TEST_F(ImTableTest, HashedConflictTable) {
+  ScopedObjectAccess soa(Thread::Current());
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  LinearAlloc* linear_alloc = Runtime::Current()->GetLinearAlloc();
+  const size_t kNumEntries = 2u * ImtConflictTable::kMinHashedEntries;
+
+  // Use colliding dex method indexes to exercise the probing.
+  std::vector<ArtMethod> interface_methods(kNumEntries + 1u);
+  std::vector<ArtMethod> implementation_methods(kNumEntries + 1u);
+  for (size_t i = 0; i != interface_methods.size(); ++i) {
+    interface_methods[i].SetDexMethodIndex(i * 4u);
+  }
+
+  ImtConflictTable* table = class_linker->CreateImtConflictTable(kNumEntries, linear_alloc);
+  ASSERT_TRUE(table != nullptr);
+  for (size_t i = 0; i != kNumEntries; ++i) {
+    table->AddEntry(&interface_methods[i], &implementation_methods[i], kRuntimePointerSize);
+  }
+  EXPECT_TRUE(table->IsHashed(kRuntimePointerSize));
+  EXPECT_EQ(kNumEntries, table->NumEntries(kRuntimePointerSize));
+  EXPECT_EQ(ImtConflictTable::ComputeSize(kNumEntries, kRuntimePointerSize),
+            table->ComputeSize(kRuntimePointerSize));
+  for (size_t i = 0; i != kNumEntries; ++i) {
+    EXPECT_EQ(&implementation_methods[i],
+              table->Lookup(&interface_methods[i], kRuntimePointerSize));
+  }
+  EXPECT_TRUE(table->Lookup(&interface_methods[kNumEntries], kRuntimePointerSize) == nullptr);
+
+  // Grow the table by one entry.
+  void* data = linear_alloc->Alloc(
+      soa.Self(), ImtConflictTable::ComputeSizeWithOneMoreEntry(table, kRuntimePointerSize));
+  ImtConflictTable* new_table = new (data) ImtConflictTable(table,
+                                                            &interface_methods[kNumEntries],
+                                                            &implementation_methods[kNumEntries],
+                                                            kRuntimePointerSize);
+  EXPECT_EQ(kNumEntries + 1u, new_table->NumEntries(kRuntimePointerSize));
+  for (size_t i = 0; i != kNumEntries + 1u; ++i) {
+    EXPECT_EQ(&implementation_methods[i],
+              new_table->Lookup(&interface_methods[i], kRuntimePointerSize));
+  }
+
+  // Small tables keep the linear layout.
+  ImtConflictTable* small_table = class_linker->CreateImtConflictTable(1u, linear_alloc);
+  ASSERT_TRUE(small_table != nullptr);
+  small_table->AddEntry(&interface_methods[0], &implementation_methods[0], kRuntimePointerSize);
+  EXPECT_FALSE(small_table->IsHashed(kRuntimePointerSize));
+  EXPECT_EQ(&implementation_methods[0],
+            small_table->Lookup(&interface_methods[0], kRuntimePointerSize));
+}
+
 }  // namespace art
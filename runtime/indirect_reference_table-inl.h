@@ -56,7 +56,7 @@ inline bool IndirectReferenceTable::GetChecked(IndirectRef iref) const {
     AbortIfNoCheckJNI(msg);
     return false;
   }
-  if (UNLIKELY(table_[idx].GetReference()->IsNull())) {
+  if (UNLIKELY(GetEntry(idx)->GetReference()->IsNull())) {
     AbortIfNoCheckJNI(android::base::StringPrintf("JNI ERROR (app bug): accessed deleted %s %p",
                                                   GetIndirectRefKindString(kind_),
                                                   iref));
@@ -92,7 +92,7 @@ inline ObjPtr<mirror::Object> IndirectReferenceTable::Get(IndirectRef iref) cons
     return nullptr;
   }
   uint32_t idx = ExtractIndex(iref);
-  ObjPtr<mirror::Object> obj = table_[idx].GetReference()->Read<kReadBarrierOption>();
+  ObjPtr<mirror::Object> obj = GetEntry(idx)->GetReference()->Read<kReadBarrierOption>();
   VerifyObject(obj);
   return obj;
 }
@@ -103,7 +103,7 @@ inline void IndirectReferenceTable::Update(IndirectRef iref, ObjPtr<mirror::Obje
     return;
   }
   uint32_t idx = ExtractIndex(iref);
-  table_[idx].SetReference(obj);
+  GetEntry(idx)->SetReference(obj);
 }
 
 inline void IrtEntry::Add(ObjPtr<mirror::Object> obj) {
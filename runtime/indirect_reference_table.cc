@@ -28,7 +28,10 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <mutex>
 
 namespace art {
 
@@ -38,6 +41,42 @@ static constexpr bool kDebugIRT = false;
 // Maximum table size we allow.
 static constexpr size_t kMaxTableSizeInBytes = 128 * MB;
 
+// Local reference tables are created and destroyed with each thread. Keep the first chunk mem
+// maps of a few destroyed tables so that short-lived threads do not need to map and unmap them.
+static constexpr size_t kMaxPooledLocalTables = 16;
+static std::mutex gPooledLocalTablesLock;
+static std::vector<MemMap>* gPooledLocalTables GUARDED_BY(gPooledLocalTablesLock) = nullptr;
+
+static MemMap TakePooledLocalTable(size_t table_bytes) {
+  std::lock_guard<std::mutex> mu(gPooledLocalTablesLock);
+  if (gPooledLocalTables != nullptr) {
+    for (auto it = gPooledLocalTables->begin(); it != gPooledLocalTables->end(); ++it) {
+      if (it->Size() == table_bytes) {
+        MemMap map = std::move(*it);
+        gPooledLocalTables->erase(it);
+        return map;
+      }
+    }
+  }
+  return MemMap::Invalid();
+}
+
+static void PoolLocalTable(MemMap&& map) {
+  std::lock_guard<std::mutex> mu(gPooledLocalTablesLock);
+  if (gPooledLocalTables == nullptr) {
+    gPooledLocalTables = new std::vector<MemMap>();
+  }
+  if (gPooledLocalTables->size() < kMaxPooledLocalTables) {
+    gPooledLocalTables->push_back(std::move(map));
+  }
+}
+
+void IndirectReferenceTable::ReleasePooledTables() {
+  std::lock_guard<std::mutex> mu(gPooledLocalTablesLock);
+  delete gPooledLocalTables;
+  gPooledLocalTables = nullptr;
+}
+
 const char* GetIndirectRefKindString(const IndirectRefKind& kind) {
   switch (kind) {
     case kHandleScopeOrInvalid:
@@ -70,6 +109,9 @@ IndirectReferenceTable::IndirectReferenceTable(size_t max_count,
     : segment_state_(kIRTFirstSegment),
       kind_(desired_kind),
       max_entries_(max_count),
+      first_chunk_entries_(max_count),
+      first_chunk_shift_(0u),
+      num_chunks_(1u),
       current_num_holes_(0),
       resizable_(resizable) {
   CHECK(error_msg != nullptr);
@@ -78,12 +120,29 @@ IndirectReferenceTable::IndirectReferenceTable(size_t max_count,
   // Overflow and maximum check.
   CHECK_LE(max_count, kMaxTableSizeInBytes / sizeof(IrtEntry));
 
-  const size_t table_bytes = max_count * sizeof(IrtEntry);
-  table_mem_map_ = MemMap::MapAnonymous("indirect ref table",
-                                        table_bytes,
-                                        PROT_READ | PROT_WRITE,
-                                        /*low_4gb=*/ false,
-                                        error_msg);
+  if (resizable == ResizableCapacity::kYes) {
+    // Later chunks double in size, which needs a power of two here. The mapping is at least a
+    // page anyway.
+    max_entries_ = RoundUpToPowerOfTwo(std::max(max_count, kPageSize / sizeof(IrtEntry)));
+    first_chunk_entries_ = max_entries_;
+    first_chunk_shift_ = static_cast<size_t>(WhichPowerOf2(first_chunk_entries_));
+  }
+
+  const size_t table_bytes = max_entries_ * sizeof(IrtEntry);
+  if (desired_kind == kLocal) {
+    table_mem_map_ = TakePooledLocalTable(table_bytes);
+    if (table_mem_map_.IsValid()) {
+      // Match the zeroed memory of a new mapping.
+      memset(table_mem_map_.Begin(), 0, table_bytes);
+    }
+  }
+  if (!table_mem_map_.IsValid()) {
+    table_mem_map_ = MemMap::MapAnonymous("indirect ref table",
+                                          table_bytes,
+                                          PROT_READ | PROT_WRITE,
+                                          /*low_4gb=*/ false,
+                                          error_msg);
+  }
   if (!table_mem_map_.IsValid() && error_msg->empty()) {
     *error_msg = "Unable to map memory for indirect ref table";
   }
@@ -93,11 +152,16 @@ IndirectReferenceTable::IndirectReferenceTable(size_t max_count,
   } else {
     table_ = nullptr;
   }
+  std::fill_n(chunks_, kMaxChunks, nullptr);
+  chunks_[0] = table_;
   segment_state_ = kIRTFirstSegment;
   last_known_previous_state_ = kIRTFirstSegment;
 }
 
 IndirectReferenceTable::~IndirectReferenceTable() {
+  if (kind_ == kLocal && table_mem_map_.IsValid()) {
+    PoolLocalTable(std::move(table_mem_map_));
+  }
 }
 
 void IndirectReferenceTable::ConstexprChecks() {
@@ -167,10 +231,10 @@ bool IndirectReferenceTable::IsValid() const {
 // equal to the current previous state, and smaller than the current state (top index). The
 // condition is conservative as it adds O(1) overhead to operations on an empty segment.
 
-static size_t CountNullEntries(const IrtEntry* table, size_t from, size_t to) {
+size_t IndirectReferenceTable::CountNullEntries(size_t from, size_t to) const {
   size_t count = 0;
   for (size_t index = from; index != to; ++index) {
-    if (table[index].GetReference()->IsNull()) {
+    if (GetEntry(index)->GetReference()->IsNull()) {
       count++;
     }
   }
@@ -181,7 +245,7 @@ void IndirectReferenceTable::RecoverHoles(IRTSegmentState prev_state) {
   if (last_known_previous_state_.top_index >= segment_state_.top_index ||
       last_known_previous_state_.top_index < prev_state.top_index) {
     const size_t top_index = segment_state_.top_index;
-    size_t count = CountNullEntries(table_, prev_state.top_index, top_index);
+    size_t count = CountNullEntries(prev_state.top_index, top_index);
 
     if (kDebugIRT) {
       LOG(INFO) << "+++ Recovered holes: "
@@ -199,12 +263,11 @@ void IndirectReferenceTable::RecoverHoles(IRTSegmentState prev_state) {
 }
 
 ALWAYS_INLINE
-static inline void CheckHoleCount(IrtEntry* table,
-                                  size_t exp_num_holes,
-                                  IRTSegmentState prev_state,
-                                  IRTSegmentState cur_state) {
+inline void IndirectReferenceTable::CheckHoleCount(size_t exp_num_holes,
+                                                   IRTSegmentState prev_state,
+                                                   IRTSegmentState cur_state) const {
   if (kIsDebugBuild) {
-    size_t count = CountNullEntries(table, prev_state.top_index, cur_state.top_index);
+    size_t count = CountNullEntries(prev_state.top_index, cur_state.top_index);
     CHECK_EQ(exp_num_holes, count) << "prevState=" << prev_state.top_index
                                    << " topIndex=" << cur_state.top_index;
   }
@@ -219,22 +282,31 @@ bool IndirectReferenceTable::Resize(size_t new_size, std::string* error_msg) {
     return false;
   }
   // Note: the above check also ensures that there is no overflow below.
+  DCHECK(IsPowerOfTwo(first_chunk_entries_));
 
-  const size_t table_bytes = new_size * sizeof(IrtEntry);
-  MemMap new_map = MemMap::MapAnonymous("indirect ref table",
-                                        table_bytes,
-                                        PROT_READ | PROT_WRITE,
-                                        /*low_4gb=*/ false,
-                                        error_msg);
-  if (!new_map.IsValid()) {
-    return false;
+  while (max_entries_ < new_size) {
+    DCHECK_EQ(max_entries_, ((static_cast<size_t>(1u) << num_chunks_) - 1u) << first_chunk_shift_);
+    if (num_chunks_ == kMaxChunks) {
+      *error_msg = android::base::StringPrintf("Too many chunks for size: %zu", new_size);
+      return false;
+    }
+    // The last chunk may be cut short by the maximum size, its missing entries are never used.
+    const size_t chunk_entries =
+        std::min(first_chunk_entries_ << num_chunks_, kMaxEntries - max_entries_);
+    MemMap new_map = MemMap::MapAnonymous("indirect ref table",
+                                          chunk_entries * sizeof(IrtEntry),
+                                          PROT_READ | PROT_WRITE,
+                                          /*low_4gb=*/ false,
+                                          error_msg);
+    if (!new_map.IsValid()) {
+      return false;
+    }
+    chunks_[num_chunks_] = reinterpret_cast<IrtEntry*>(new_map.Begin());
+    chunk_mem_maps_.push_back(std::move(new_map));
+    ++num_chunks_;
+    max_entries_ += chunk_entries;
   }
 
-  memcpy(new_map.Begin(), table_mem_map_.Begin(), table_mem_map_.Size());
-  table_mem_map_ = std::move(new_map);
-  table_ = reinterpret_cast<IrtEntry*>(table_mem_map_.Begin());
-  max_entries_ = new_size;
-
   return true;
 }
 
@@ -288,7 +360,7 @@ IndirectRef IndirectReferenceTable::Add(IRTSegmentState previous_state,
   }
 
   RecoverHoles(previous_state);
-  CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
+  CheckHoleCount(current_num_holes_, previous_state, segment_state_);
 
   // We know there's enough room in the table.  Now we just need to find
   // the right spot.  If there's a hole, find it and fill it; otherwise,
@@ -298,21 +370,21 @@ IndirectRef IndirectReferenceTable::Add(IRTSegmentState previous_state,
   if (current_num_holes_ > 0) {
     DCHECK_GT(top_index, 1U);
     // Find the first hole; likely to be near the end of the list.
-    IrtEntry* p_scan = &table_[top_index - 1];
-    DCHECK(!p_scan->GetReference()->IsNull());
-    --p_scan;
-    while (!p_scan->GetReference()->IsNull()) {
-      DCHECK_GE(p_scan, table_ + previous_state.top_index);
-      --p_scan;
+    size_t scan_index = top_index - 1;
+    DCHECK(!GetEntry(scan_index)->GetReference()->IsNull());
+    --scan_index;
+    while (!GetEntry(scan_index)->GetReference()->IsNull()) {
+      DCHECK_GE(scan_index, previous_state.top_index);
+      --scan_index;
     }
-    index = p_scan - table_;
+    index = scan_index;
     current_num_holes_--;
   } else {
     // Add to the end.
     index = top_index++;
     segment_state_.top_index = top_index;
   }
-  table_[index].Add(obj);
+  GetEntry(index)->Add(obj);
   result = ToIndirectRef(index);
   if (kDebugIRT) {
     LOG(INFO) << "+++ added at " << ExtractIndex(result) << " top=" << segment_state_.top_index
@@ -325,7 +397,7 @@ IndirectRef IndirectReferenceTable::Add(IRTSegmentState previous_state,
 
 void IndirectReferenceTable::AssertEmpty() {
   for (size_t i = 0; i < Capacity(); ++i) {
-    if (!table_[i].GetReference()->IsNull()) {
+    if (!GetEntry(i)->GetReference()->IsNull()) {
       LOG(FATAL) << "Internal Error: non-empty local reference table\n"
                  << MutatorLockedDumpable<IndirectReferenceTable>(*this);
       UNREACHABLE();
@@ -384,7 +456,7 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
   }
 
   RecoverHoles(previous_state);
-  CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
+  CheckHoleCount(current_num_holes_, previous_state, segment_state_);
 
   if (idx == top_index - 1) {
     // Top-most entry.  Scan up and consume holes.
@@ -393,7 +465,7 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
       return false;
     }
 
-    *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
+    *GetEntry(idx)->GetReference() = GcRoot<mirror::Object>(nullptr);
     if (current_num_holes_ != 0) {
       uint32_t collapse_top_index = top_index;
       while (--collapse_top_index > bottom_index && current_num_holes_ != 0) {
@@ -401,9 +473,9 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
           ScopedObjectAccess soa(Thread::Current());
           LOG(INFO) << "+++ checking for hole at " << collapse_top_index - 1
                     << " (previous_state=" << bottom_index << ") val="
-                    << table_[collapse_top_index - 1].GetReference()->Read<kWithoutReadBarrier>();
+                    << GetEntry(collapse_top_index - 1)->GetReference()->Read<kWithoutReadBarrier>();
         }
-        if (!table_[collapse_top_index - 1].GetReference()->IsNull()) {
+        if (!GetEntry(collapse_top_index - 1)->GetReference()->IsNull()) {
           break;
         }
         if (kDebugIRT) {
@@ -413,7 +485,7 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
       }
       segment_state_.top_index = collapse_top_index;
 
-      CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
+      CheckHoleCount(current_num_holes_, previous_state, segment_state_);
     } else {
       segment_state_.top_index = top_index - 1;
       if (kDebugIRT) {
@@ -423,7 +495,7 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
   } else {
     // Not the top-most entry.  This creates a hole.  We null out the entry to prevent somebody
     // from deleting it twice and screwing up the hole count.
-    if (table_[idx].GetReference()->IsNull()) {
+    if (GetEntry(idx)->GetReference()->IsNull()) {
       LOG(INFO) << "--- WEIRD: removing null entry " << idx;
       return false;
     }
@@ -431,9 +503,9 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
       return false;
     }
 
-    *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
+    *GetEntry(idx)->GetReference() = GcRoot<mirror::Object>(nullptr);
     current_num_holes_++;
-    CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
+    CheckHoleCount(current_num_holes_, previous_state, segment_state_);
     if (kDebugIRT) {
       LOG(INFO) << "+++ left hole at " << idx << ", holes=" << current_num_holes_;
     }
@@ -445,9 +517,21 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
 void IndirectReferenceTable::Trim() {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   const size_t top_index = Capacity();
-  auto* release_start = AlignUp(reinterpret_cast<uint8_t*>(&table_[top_index]), kPageSize);
-  uint8_t* release_end = table_mem_map_.End();
-  madvise(release_start, release_end - release_start, MADV_DONTNEED);
+  size_t chunk_begin = 0u;
+  for (size_t chunk = 0; chunk != num_chunks_; ++chunk) {
+    const MemMap& mem_map = (chunk == 0u) ? table_mem_map_ : chunk_mem_maps_[chunk - 1u];
+    const size_t chunk_entries = mem_map.Size() / sizeof(IrtEntry);
+    if (chunk_begin + chunk_entries > top_index) {
+      const size_t first_unused = std::max(top_index, chunk_begin) - chunk_begin;
+      auto* release_start =
+          AlignUp(reinterpret_cast<uint8_t*>(&chunks_[chunk][first_unused]), kPageSize);
+      uint8_t* release_end = mem_map.End();
+      if (release_start < release_end) {
+        madvise(release_start, release_end - release_start, MADV_DONTNEED);
+      }
+    }
+    chunk_begin += chunk_entries;
+  }
 }
 
 void IndirectReferenceTable::VisitRoots(RootVisitor* visitor, const RootInfo& root_info) {
@@ -464,9 +548,9 @@ void IndirectReferenceTable::Dump(std::ostream& os) const {
   os << kind_ << " table dump:\n";
   ReferenceTable::Table entries;
   for (size_t i = 0; i < Capacity(); ++i) {
-    ObjPtr<mirror::Object> obj = table_[i].GetReference()->Read<kWithoutReadBarrier>();
+    ObjPtr<mirror::Object> obj = GetEntry(i)->GetReference()->Read<kWithoutReadBarrier>();
     if (obj != nullptr) {
-      obj = table_[i].GetReference()->Read();
+      obj = GetEntry(i)->GetReference()->Read();
       entries.push_back(GcRoot<mirror::Object>(obj));
     }
   }
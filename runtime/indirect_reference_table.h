@@ -22,6 +22,7 @@
 #include <iosfwd>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <android-base/logging.h>
 
@@ -182,9 +183,12 @@ static_assert(sizeof(IrtEntry) == (1 + kIRTPrevCount) * sizeof(uint32_t),
               "Unexpected sizeof(IrtEntry)");
 static_assert(IsPowerOfTwo(sizeof(IrtEntry)), "Unexpected sizeof(IrtEntry)");
 
+class IndirectReferenceTable;
+
 class IrtIterator {
  public:
-  IrtIterator(IrtEntry* table, size_t i, size_t capacity) REQUIRES_SHARED(Locks::mutator_lock_)
+  IrtIterator(const IndirectReferenceTable* table, size_t i, size_t capacity)
+      REQUIRES_SHARED(Locks::mutator_lock_)
       : table_(table), i_(i), capacity_(capacity) {
     // capacity_ is used in some target; has warning with unused attribute.
     UNUSED(capacity_);
@@ -195,17 +199,14 @@ class IrtIterator {
     return *this;
   }
 
-  GcRoot<mirror::Object>* operator*() REQUIRES_SHARED(Locks::mutator_lock_) {
-    // This does not have a read barrier as this is used to visit roots.
-    return table_[i_].GetReference();
-  }
+  inline GcRoot<mirror::Object>* operator*() REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool equals(const IrtIterator& rhs) const {
     return (i_ == rhs.i_ && table_ == rhs.table_);
   }
 
  private:
-  IrtEntry* const table_;
+  const IndirectReferenceTable* const table_;
   size_t i_;
   const size_t capacity_;
 };
@@ -237,6 +238,10 @@ class IndirectReferenceTable {
 
   ~IndirectReferenceTable();
 
+  // Unmap the local reference tables that were kept for reuse by new threads. Must be called
+  // before MemMap::Shutdown().
+  static void ReleasePooledTables();
+
   /*
    * Checks whether construction of the IndirectReferenceTable succeeded.
    *
@@ -300,11 +305,11 @@ class IndirectReferenceTable {
 
   // Note IrtIterator does not have a read barrier as it's used to visit roots.
   IrtIterator begin() {
-    return IrtIterator(table_, 0, Capacity());
+    return IrtIterator(this, 0, Capacity());
   }
 
   IrtIterator end() {
-    return IrtIterator(table_, Capacity(), Capacity());
+    return IrtIterator(this, Capacity(), Capacity());
   }
 
   void VisitRoots(RootVisitor* visitor, const RootInfo& root_info)
@@ -377,15 +382,38 @@ class IndirectReferenceTable {
 
   IndirectRef ToIndirectRef(uint32_t table_index) const {
     DCHECK_LT(table_index, max_entries_);
-    uint32_t serial = table_[table_index].GetSerial();
+    uint32_t serial = GetEntry(table_index)->GetSerial();
     return reinterpret_cast<IndirectRef>(EncodeIndirectRef(table_index, serial));
   }
 
-  // Resize the backing table. Currently must be larger than the current size.
+  // Return the entry at `index`. Entries never move, the table grows by adding chunks.
+  ALWAYS_INLINE IrtEntry* GetEntry(size_t index) const {
+    DCHECK_LT(index, max_entries_);
+    if (LIKELY(index < first_chunk_entries_)) {
+      return &table_[index];
+    }
+    return GetEntryInLaterChunk(index);
+  }
+
+  // Chunk `n` > 0 holds `first_chunk_entries_ << n` entries and starts at index
+  // `first_chunk_entries_ * (2^n - 1)`, so the chunk of an index is found with a shift and a CLZ.
+  IrtEntry* GetEntryInLaterChunk(size_t index) const {
+    const size_t chunk = MostSignificantBit((index >> first_chunk_shift_) + 1u);
+    DCHECK_LT(chunk, num_chunks_);
+    const size_t chunk_begin = ((static_cast<size_t>(1u) << chunk) - 1u) << first_chunk_shift_;
+    return &chunks_[chunk][index - chunk_begin];
+  }
+
+  // Grow the table by adding chunks until it holds at least `new_size` entries. Existing entries
+  // are not moved. Currently must be larger than the current size.
   bool Resize(size_t new_size, std::string* error_msg);
 
   void RecoverHoles(IRTSegmentState from);
 
+  size_t CountNullEntries(size_t from, size_t to) const REQUIRES_SHARED(Locks::mutator_lock_);
+  void CheckHoleCount(size_t exp_num_holes, IRTSegmentState prev_state, IRTSegmentState cur_state)
+      const REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Abort if check_jni is not enabled. Otherwise, just log as an error.
   static void AbortIfNoCheckJNI(const std::string& msg);
 
@@ -396,7 +424,10 @@ class IndirectReferenceTable {
   /// semi-public - read/write by jni down calls.
   IRTSegmentState segment_state_;
 
-  // Mem map where we store the indirect refs.
+  // Enough chunks for the largest table allowed, as a resizable table starts with at least a page.
+  static constexpr size_t kMaxChunks = 16;
+
+  // Mem map where we store the indirect refs of the first chunk.
   MemMap table_mem_map_;
   // bottom of the stack. Do not directly access the object references
   // in this as they are roots. Use Get() that has a read barrier.
@@ -407,6 +438,14 @@ class IndirectReferenceTable {
   // max #of entries allowed (modulo resizing).
   size_t max_entries_;
 
+  // Size of the first chunk, a power of two if the table is resizable, and its log2.
+  size_t first_chunk_entries_;
+  size_t first_chunk_shift_;
+  // The chunks of the table, starting with `table_`, and the mem maps of the later chunks.
+  size_t num_chunks_;
+  IrtEntry* chunks_[kMaxChunks];
+  std::vector<MemMap> chunk_mem_maps_;
+
   // Some values to retain old behavior with holes. Description of the algorithm is in the .cc
   // file.
   // TODO: Consider other data structures for compact tables, e.g., free lists.
@@ -416,8 +455,15 @@ class IndirectReferenceTable {
   // Whether the table's capacity may be resized. As there are no locks used, it is the caller's
   // responsibility to ensure thread-safety.
   ResizableCapacity resizable_;
+
+  friend class IrtIterator;
 };
 
+inline GcRoot<mirror::Object>* IrtIterator::operator*() {
+  // This does not have a read barrier as this is used to visit roots.
+  return table_->GetEntry(i_)->GetReference();
+}
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_INDIRECT_REFERENCE_TABLE_H_
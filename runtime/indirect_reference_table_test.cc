@@ -514,4 +514,54 @@ TEST_F(IndirectReferenceTableTest, Resize) {
   EXPECT_EQ(irt.Capacity(), kTableMax + 1);
 }
 
+// Test that growing a resizable table by several chunks keeps the existing references valid.
+TEST_F(IndirectReferenceTableTest, GrowByChunks) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableInitial = 16;
+
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::Class> c = hs.NewHandle(
+      class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(c != nullptr);
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+
+  std::string error_msg;
+  IndirectReferenceTable irt(kTableInitial,
+                             kLocal,
+                             IndirectReferenceTable::ResizableCapacity::kYes,
+                             &error_msg);
+  ASSERT_TRUE(irt.IsValid()) << error_msg;
+  const IRTSegmentState cookie = kIRTFirstSegment;
+
+  // The first chunk is at least a page, so adding this many references needs several chunks.
+  const size_t num_refs = 8 * kPageSize / sizeof(IrtEntry) + 1;
+  std::vector<IndirectRef> irefs;
+  for (size_t i = 0; i != num_refs; ++i) {
+    IndirectRef iref = irt.Add(cookie, obj0.Get(), &error_msg);
+    ASSERT_TRUE(iref != nullptr) << error_msg;
+    irefs.push_back(iref);
+  }
+  EXPECT_EQ(num_refs, irt.Capacity());
+  for (IndirectRef iref : irefs) {
+    EXPECT_OBJ_PTR_EQ(obj0.Get(), irt.Get(iref));
+  }
+  CheckDump(&irt, num_refs, 1);
+
+  // Holes in later chunks are filled like in the first one.
+  EXPECT_TRUE(irt.Remove(cookie, irefs[num_refs / 2]));
+  IndirectRef iref = irt.Add(cookie, obj0.Get(), &error_msg);
+  ASSERT_TRUE(iref != nullptr) << error_msg;
+  EXPECT_EQ(num_refs, irt.Capacity());
+  EXPECT_OBJ_PTR_EQ(obj0.Get(), irt.Get(iref));
+
+  EXPECT_TRUE(irt.EnsureFreeCapacity(num_refs, &error_msg)) << error_msg;
+  EXPECT_LE(num_refs, irt.FreeCapacity());
+  irt.Trim();
+  for (size_t i = 0; i != num_refs; ++i) {
+    EXPECT_TRUE(irt.Remove(cookie, (i == num_refs / 2) ? iref : irefs[i]));
+  }
+  EXPECT_EQ(0u, irt.Capacity());
+}
+
 }  // namespace art
@@ -1010,6 +1010,30 @@ bool Instrumentation::IsDeoptimizedMethodsEmpty() const {
   return deoptimized_methods_.empty();
 }
 
+// Returns whether `thread` is executing compiled code of `method`, including code where it has
+// been inlined.
+static bool HasCompiledFramesOf(Thread* thread, ArtMethod* method)
+    REQUIRES(Locks::mutator_lock_) {
+  ArtMethod* non_obsolete_method = method->GetNonObsoleteMethod();
+  bool found = false;
+  StackVisitor::WalkStack(
+      [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ArtMethod* m = stack_visitor->GetMethod();
+        if (m != nullptr &&
+            stack_visitor->GetCurrentQuickFrame() != nullptr &&
+            !m->IsRuntimeMethod() &&
+            m->GetNonObsoleteMethod() == non_obsolete_method) {
+          found = true;
+          return false;
+        }
+        return true;
+      },
+      thread,
+      /* context= */ nullptr,
+      art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+  return found;
+}
+
 void Instrumentation::Deoptimize(ArtMethod* method) {
   CHECK(!method->IsNative());
   CHECK(!method->IsProxyMethod());
@@ -1026,10 +1050,18 @@ void Instrumentation::Deoptimize(ArtMethod* method) {
     UpdateEntrypoints(method, GetQuickInstrumentationEntryPoint());
 
     // Install instrumentation exit stub and instrumentation frames. We may already have installed
-    // these previously so it will only cover the newly created frames.
+    // these previously so it will only cover the newly created frames. New calls of the method
+    // go to the interpreter, so only threads that are executing compiled code of the method need
+    // exit stubs to deoptimize it when returning to it. The other threads keep running compiled
+    // code without instrumentation frames.
     instrumentation_stubs_installed_ = true;
     MutexLock mu(self, *Locks::thread_list_lock_);
-    Runtime::Current()->GetThreadList()->ForEach(InstrumentationInstallStack, this);
+    Runtime::Current()->GetThreadList()->ForEach([&](Thread* thread) {
+      Locks::mutator_lock_->AssertExclusiveHeld(self);
+      if (HasCompiledFramesOf(thread, method)) {
+        InstrumentationInstallStack(thread, this);
+      }
+    });
   }
 }
 
@@ -38,22 +38,52 @@ namespace art {
 InternTable::InternTable()
     : log_new_roots_(false),
       weak_intern_condition_("New intern condition", *Locks::intern_table_lock_),
-      weak_root_state_(gc::kWeakRootStateNormal) {
+      weak_root_state_(gc::kWeakRootStateNormal),
+      shards_blocked_(false) {
+}
+
+InternTable::ScopedExclusiveAccess::ScopedExclusiveAccess(Thread* self,
+                                                          const InternTable& intern_table)
+    : self_(self), intern_table_(intern_table) {
+  Locks::intern_table_lock_->ExclusiveLock(self_);
+  DCHECK(!intern_table_.shards_blocked_.load(std::memory_order_relaxed));
+  intern_table_.shards_blocked_.store(true, std::memory_order_relaxed);
+  // Wait for the threads that took a shard lock before they could see `shards_blocked_`.
+  for (const Shard& shard : intern_table_.shards_) {
+    MutexLock mu(self_, shard.lock_);
+  }
+}
+
+InternTable::ScopedExclusiveAccess::~ScopedExclusiveAccess() {
+  intern_table_.shards_blocked_.store(false, std::memory_order_release);
+  Locks::intern_table_lock_->ExclusiveUnlock(self_);
 }
 
 size_t InternTable::Size() const {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.Size() + weak_interns_.Size();
+  ScopedExclusiveAccess sea(Thread::Current(), *this);
+  size_t size = image_interns_.Size();
+  for (const Shard& shard : shards_) {
+    size += shard.strong_interns_.Size() + shard.weak_interns_.Size();
+  }
+  return size;
 }
 
 size_t InternTable::StrongSize() const {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.Size();
+  ScopedExclusiveAccess sea(Thread::Current(), *this);
+  size_t size = image_interns_.Size();
+  for (const Shard& shard : shards_) {
+    size += shard.strong_interns_.Size();
+  }
+  return size;
 }
 
 size_t InternTable::WeakSize() const {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return weak_interns_.Size();
+  ScopedExclusiveAccess sea(Thread::Current(), *this);
+  size_t size = 0u;
+  for (const Shard& shard : shards_) {
+    size += shard.weak_interns_.Size();
+  }
+  return size;
 }
 
 void InternTable::DumpForSigQuit(std::ostream& os) const {
@@ -61,42 +91,80 @@ void InternTable::DumpForSigQuit(std::ostream& os) const {
 }
 
 void InternTable::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+  ScopedExclusiveAccess sea(Thread::Current(), *this);
   if ((flags & kVisitRootFlagAllRoots) != 0) {
-    strong_interns_.VisitRoots(visitor);
+    image_interns_.VisitRoots(visitor);
+    for (Shard& shard : shards_) {
+      shard.strong_interns_.VisitRoots(visitor);
+    }
   } else if ((flags & kVisitRootFlagNewRoots) != 0) {
-    for (auto& root : new_strong_intern_roots_) {
-      ObjPtr<mirror::String> old_ref = root.Read<kWithoutReadBarrier>();
-      root.VisitRoot(visitor, RootInfo(kRootInternedString));
-      ObjPtr<mirror::String> new_ref = root.Read<kWithoutReadBarrier>();
-      if (new_ref != old_ref) {
-        // The GC moved a root in the log. Need to search the strong interns and update the
-        // corresponding object. This is slow, but luckily for us, this may only happen with a
-        // concurrent moving GC.
-        strong_interns_.Remove(old_ref);
-        strong_interns_.Insert(new_ref);
+    for (Shard& shard : shards_) {
+      for (auto& root : shard.new_strong_intern_roots_) {
+        ObjPtr<mirror::String> old_ref = root.Read<kWithoutReadBarrier>();
+        root.VisitRoot(visitor, RootInfo(kRootInternedString));
+        ObjPtr<mirror::String> new_ref = root.Read<kWithoutReadBarrier>();
+        if (new_ref != old_ref) {
+          // The GC moved a root in the log. Need to search the strong interns and update the
+          // corresponding object. This is slow, but luckily for us, this may only happen with a
+          // concurrent moving GC. The new interns of a shard are in its strong table.
+          shard.strong_interns_.Remove(old_ref);
+          shard.strong_interns_.Insert(new_ref);
+        }
       }
     }
   }
   if ((flags & kVisitRootFlagClearRootLog) != 0) {
-    new_strong_intern_roots_.clear();
+    for (Shard& shard : shards_) {
+      shard.new_strong_intern_roots_.clear();
+    }
   }
   if ((flags & kVisitRootFlagStartLoggingNewRoots) != 0) {
     log_new_roots_ = true;
   } else if ((flags & kVisitRootFlagStopLoggingNewRoots) != 0) {
     log_new_roots_ = false;
   }
-  // Note: we deliberately don't visit the weak_interns_ table and the immutable image roots.
+  // Note: we deliberately don't visit the weak_interns_ tables.
+}
+
+ObjPtr<mirror::String> InternTable::LookupStrongInShard(Shard* shard, ObjPtr<mirror::String> s) {
+  // The image tables come first, like they did when they were in front of the strong tables.
+  ObjPtr<mirror::String> image_string = image_interns_.Find(s);
+  if (image_string != nullptr) {
+    return image_string;
+  }
+  return shard->strong_interns_.Find(s);
+}
+
+ObjPtr<mirror::String> InternTable::LookupStrongInShard(Shard* shard, const Utf8String& string) {
+  ObjPtr<mirror::String> image_string = image_interns_.Find(string);
+  if (image_string != nullptr) {
+    return image_string;
+  }
+  return shard->strong_interns_.Find(string);
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeak(Thread* self, ObjPtr<mirror::String> s) {
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return LookupWeakLocked(s);
+  Shard* const shard = GetShard(s->GetHashCode());
+  {
+    MutexLock mu(self, shard->lock_);
+    if (LIKELY(!shards_blocked_.load(std::memory_order_acquire))) {
+      return shard->weak_interns_.Find(s);
+    }
+  }
+  ScopedExclusiveAccess sea(self, *this);
+  return shard->weak_interns_.Find(s);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::String> s) {
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return LookupStrongLocked(s);
+  Shard* const shard = GetShard(s->GetHashCode());
+  {
+    MutexLock mu(self, shard->lock_);
+    if (LIKELY(!shards_blocked_.load(std::memory_order_acquire))) {
+      return LookupStrongInShard(shard, s);
+    }
+  }
+  ScopedExclusiveAccess sea(self, *this);
+  return LookupStrongInShard(shard, s);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
@@ -106,76 +174,97 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
   Utf8String string(utf16_length,
                     utf8_data,
                     ComputeUtf16HashFromModifiedUtf8(utf8_data, utf16_length));
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(string);
+  Shard* const shard = GetShard(string.GetHash());
+  {
+    MutexLock mu(self, shard->lock_);
+    if (LIKELY(!shards_blocked_.load(std::memory_order_acquire))) {
+      return LookupStrongInShard(shard, string);
+    }
+  }
+  ScopedExclusiveAccess sea(self, *this);
+  return LookupStrongInShard(shard, string);
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
-  return weak_interns_.Find(s);
+  Shard* const shard = GetShard(s->GetHashCode());
+  MutexLock mu(Thread::Current(), shard->lock_);
+  return shard->weak_interns_.Find(s);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrongLocked(ObjPtr<mirror::String> s) {
-  return strong_interns_.Find(s);
+  Shard* const shard = GetShard(s->GetHashCode());
+  MutexLock mu(Thread::Current(), shard->lock_);
+  return LookupStrongInShard(shard, s);
 }
 
 void InternTable::AddNewTable() {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  weak_interns_.AddNewTable();
-  strong_interns_.AddNewTable();
+  ScopedExclusiveAccess sea(Thread::Current(), *this);
+  for (Shard& shard : shards_) {
+    shard.weak_interns_.AddNewTable();
+    shard.strong_interns_.AddNewTable();
+  }
 }
 
-ObjPtr<mirror::String> InternTable::InsertStrong(ObjPtr<mirror::String> s) {
+ObjPtr<mirror::String> InternTable::InsertStrong(Shard* shard, ObjPtr<mirror::String> s) {
   Runtime* runtime = Runtime::Current();
   if (runtime->IsActiveTransaction()) {
+    // Insert() takes exclusive access during a transaction.
+    Locks::intern_table_lock_->AssertHeld(Thread::Current());
     runtime->RecordStrongStringInsertion(s);
   }
   if (log_new_roots_) {
-    new_strong_intern_roots_.push_back(GcRoot<mirror::String>(s));
+    shard->new_strong_intern_roots_.push_back(GcRoot<mirror::String>(s));
   }
-  strong_interns_.Insert(s);
+  shard->strong_interns_.Insert(s);
   return s;
 }
 
-ObjPtr<mirror::String> InternTable::InsertWeak(ObjPtr<mirror::String> s) {
+ObjPtr<mirror::String> InternTable::InsertWeak(Shard* shard, ObjPtr<mirror::String> s) {
   Runtime* runtime = Runtime::Current();
   if (runtime->IsActiveTransaction()) {
+    Locks::intern_table_lock_->AssertHeld(Thread::Current());
     runtime->RecordWeakStringInsertion(s);
   }
-  weak_interns_.Insert(s);
+  shard->weak_interns_.Insert(s);
   return s;
 }
 
-void InternTable::RemoveStrong(ObjPtr<mirror::String> s) {
-  strong_interns_.Remove(s);
-}
-
-void InternTable::RemoveWeak(ObjPtr<mirror::String> s) {
+void InternTable::RemoveWeak(Shard* shard, ObjPtr<mirror::String> s) {
   Runtime* runtime = Runtime::Current();
   if (runtime->IsActiveTransaction()) {
+    Locks::intern_table_lock_->AssertHeld(Thread::Current());
     runtime->RecordWeakStringRemoval(s);
   }
-  weak_interns_.Remove(s);
+  shard->weak_interns_.Remove(s);
 }
 
 // Insert/remove methods used to undo changes made during an aborted transaction.
 ObjPtr<mirror::String> InternTable::InsertStrongFromTransaction(ObjPtr<mirror::String> s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  return InsertStrong(s);
+  Shard* const shard = GetShard(s->GetHashCode());
+  MutexLock mu(Thread::Current(), shard->lock_);
+  return InsertStrong(shard, s);
 }
 
 ObjPtr<mirror::String> InternTable::InsertWeakFromTransaction(ObjPtr<mirror::String> s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  return InsertWeak(s);
+  Shard* const shard = GetShard(s->GetHashCode());
+  MutexLock mu(Thread::Current(), shard->lock_);
+  return InsertWeak(shard, s);
 }
 
 void InternTable::RemoveStrongFromTransaction(ObjPtr<mirror::String> s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  RemoveStrong(s);
+  Shard* const shard = GetShard(s->GetHashCode());
+  MutexLock mu(Thread::Current(), shard->lock_);
+  shard->strong_interns_.Remove(s);
 }
 
 void InternTable::RemoveWeakFromTransaction(ObjPtr<mirror::String> s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  RemoveWeak(s);
+  Shard* const shard = GetShard(s->GetHashCode());
+  MutexLock mu(Thread::Current(), shard->lock_);
+  RemoveWeak(shard, s);
 }
 
 void InternTable::BroadcastForNewInterns() {
@@ -184,17 +273,26 @@ void InternTable::BroadcastForNewInterns() {
   weak_intern_condition_.Broadcast(self);
 }
 
-void InternTable::WaitUntilAccessible(Thread* self) {
-  Locks::intern_table_lock_->ExclusiveUnlock(self);
-  {
-    ScopedThreadSuspension sts(self, kWaitingWeakGcRootRead);
-    MutexLock mu(self, *Locks::intern_table_lock_);
-    while ((!kUseReadBarrier && weak_root_state_ == gc::kWeakRootStateNoReadsOrWrites) ||
-           (kUseReadBarrier && !self->GetWeakRefAccessEnabled())) {
-      weak_intern_condition_.Wait(self);
+bool InternTable::IsWeakAccessible(Thread* self) const {
+  return (!kUseReadBarrier && weak_root_state_ != gc::kWeakRootStateNoReadsOrWrites) ||
+         (kUseReadBarrier && self->GetWeakRefAccessEnabled());
+}
+
+ObjPtr<mirror::String> InternTable::InsertInShard(Shard* shard,
+                                                  ObjPtr<mirror::String> s,
+                                                  bool is_strong) {
+  // There is no match in the strong table, check the weak table.
+  ObjPtr<mirror::String> weak = shard->weak_interns_.Find(s);
+  if (weak != nullptr) {
+    if (is_strong) {
+      // A match was found in the weak table. Promote to the strong table.
+      RemoveWeak(shard, weak);
+      return InsertStrong(shard, weak);
     }
+    return weak;
   }
-  Locks::intern_table_lock_->ExclusiveLock(self);
+  // No match in the strong table or the weak table. Insert into the strong / weak table.
+  return is_strong ? InsertStrong(shard, s) : InsertWeak(shard, s);
 }
 
 ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
@@ -204,27 +302,48 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
     return nullptr;
   }
   Thread* const self = Thread::Current();
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  if (kDebugLocking && !holding_locks) {
-    Locks::mutator_lock_->AssertSharedHeld(self);
-    CHECK_EQ(2u, self->NumberOfHeldMutexes()) << "may only safely hold the mutator lock";
+  Shard* const shard = GetShard(s->GetHashCode());
+  // Fast path, holding only the lock of the shard. Changes made in a transaction are recorded
+  // with exclusive access, see InsertStrong().
+  if (LIKELY(!Runtime::Current()->IsActiveTransaction())) {
+    MutexLock mu(self, shard->lock_);
+    if (LIKELY(!shards_blocked_.load(std::memory_order_acquire))) {
+      if (kDebugLocking && !holding_locks) {
+        Locks::mutator_lock_->AssertSharedHeld(self);
+        CHECK_EQ(2u, self->NumberOfHeldMutexes()) << "may only safely hold the mutator lock";
+      }
+      // Check the strong table for a match.
+      ObjPtr<mirror::String> strong = LookupStrongInShard(shard, s);
+      if (strong != nullptr) {
+        return strong;
+      }
+      if (IsWeakAccessible(self)) {
+        return InsertInShard(shard, s, is_strong);
+      }
+    }
   }
   while (true) {
-    if (holding_locks) {
-      if (!kUseReadBarrier) {
-        CHECK_EQ(weak_root_state_, gc::kWeakRootStateNormal);
-      } else {
-        CHECK(self->GetWeakRefAccessEnabled());
+    {
+      ScopedExclusiveAccess sea(self, *this);
+      if (kDebugLocking && !holding_locks) {
+        Locks::mutator_lock_->AssertSharedHeld(self);
+        CHECK_EQ(2u, self->NumberOfHeldMutexes()) << "may only safely hold the mutator lock";
+      }
+      if (holding_locks) {
+        if (!kUseReadBarrier) {
+          CHECK_EQ(weak_root_state_, gc::kWeakRootStateNormal);
+        } else {
+          CHECK(self->GetWeakRefAccessEnabled());
+        }
+      }
+      // Check the strong table for a match.
+      ObjPtr<mirror::String> strong = LookupStrongInShard(shard, s);
+      if (strong != nullptr) {
+        return strong;
+      }
+      if (IsWeakAccessible(self)) {
+        return InsertInShard(shard, s, is_strong);
       }
-    }
-    // Check the strong table for a match.
-    ObjPtr<mirror::String> strong = LookupStrongLocked(s);
-    if (strong != nullptr) {
-      return strong;
-    }
-    if ((!kUseReadBarrier && weak_root_state_ != gc::kWeakRootStateNoReadsOrWrites) ||
-        (kUseReadBarrier && self->GetWeakRefAccessEnabled())) {
-      break;
     }
     // weak_root_state_ is set to gc::kWeakRootStateNoReadsOrWrites in the GC pause but is only
     // cleared after SweepSystemWeaks has completed. This is why we need to wait until it is
@@ -232,25 +351,12 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
     CHECK(!holding_locks);
     StackHandleScope<1> hs(self);
     auto h = hs.NewHandleWrapper(&s);
-    WaitUntilAccessible(self);
-  }
-  if (!kUseReadBarrier) {
-    CHECK_EQ(weak_root_state_, gc::kWeakRootStateNormal);
-  } else {
-    CHECK(self->GetWeakRefAccessEnabled());
-  }
-  // There is no match in the strong table, check the weak table.
-  ObjPtr<mirror::String> weak = LookupWeakLocked(s);
-  if (weak != nullptr) {
-    if (is_strong) {
-      // A match was found in the weak table. Promote to the strong table.
-      RemoveWeak(weak);
-      return InsertStrong(weak);
+    ScopedThreadSuspension sts(self, kWaitingWeakGcRootRead);
+    MutexLock mu(self, *Locks::intern_table_lock_);
+    while (!IsWeakAccessible(self)) {
+      weak_intern_condition_.Wait(self);
     }
-    return weak;
   }
-  // No match in the strong table or the weak table. Insert into the strong / weak table.
-  return is_strong ? InsertStrong(s) : InsertWeak(s);
 }
 
 ObjPtr<mirror::String> InternTable::InternStrong(int32_t utf16_length, const char* utf8_data) {
@@ -276,13 +382,15 @@ ObjPtr<mirror::String> InternTable::InternStrongImageString(ObjPtr<mirror::Strin
 }
 
 void InternTable::PromoteWeakToStrong() {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  DCHECK_EQ(weak_interns_.tables_.size(), 1u);
-  for (GcRoot<mirror::String>& entry : weak_interns_.tables_.front().set_) {
-    DCHECK(LookupStrongLocked(entry.Read()) == nullptr);
-    InsertStrong(entry.Read());
+  ScopedExclusiveAccess sea(Thread::Current(), *this);
+  for (Shard& shard : shards_) {
+    DCHECK_EQ(shard.weak_interns_.tables_.size(), 1u);
+    for (GcRoot<mirror::String>& entry : shard.weak_interns_.tables_.front().set_) {
+      DCHECK(LookupStrongInShard(&shard, entry.Read()) == nullptr);
+      InsertStrong(&shard, entry.Read());
+    }
+    shard.weak_interns_.tables_.front().set_.clear();
   }
-  weak_interns_.tables_.front().set_.clear();
 }
 
 ObjPtr<mirror::String> InternTable::InternStrong(ObjPtr<mirror::String> s) {
@@ -303,13 +411,21 @@ bool InternTable::ContainsWeak(ObjPtr<mirror::String> s) {
 }
 
 void InternTable::SweepInternTableWeaks(IsMarkedVisitor* visitor) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  weak_interns_.SweepWeaks(visitor);
+  ScopedExclusiveAccess sea(Thread::Current(), *this);
+  for (Shard& shard : shards_) {
+    shard.weak_interns_.SweepWeaks(visitor);
+  }
 }
 
 size_t InternTable::WriteToMemory(uint8_t* ptr) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.WriteToMemory(ptr);
+  ScopedExclusiveAccess sea(Thread::Current(), *this);
+  // Combine the image tables and the strong tables of all shards.
+  UnorderedSet combined;
+  image_interns_.AddToSet(&combined);
+  for (Shard& shard : shards_) {
+    shard.strong_interns_.AddToSet(&combined);
+  }
+  return combined.WriteToMemory(ptr);
 }
 
 std::size_t InternTable::StringHashEquals::operator()(const GcRoot<mirror::String>& root) const {
@@ -358,23 +474,12 @@ bool InternTable::StringHashEquals::operator()(const GcRoot<mirror::String>& a,
   }
 }
 
-size_t InternTable::Table::WriteToMemory(uint8_t* ptr) {
-  if (tables_.empty()) {
-    return 0;
-  }
-  UnorderedSet* table_to_write;
-  UnorderedSet combined;
-  if (tables_.size() > 1) {
-    table_to_write = &combined;
-    for (InternalTable& table : tables_) {
-      for (GcRoot<mirror::String>& string : table.set_) {
-        combined.insert(string);
-      }
+void InternTable::Table::AddToSet(UnorderedSet* set) {
+  for (InternalTable& table : tables_) {
+    for (GcRoot<mirror::String>& string : table.set_) {
+      set->insert(string);
     }
-  } else {
-    table_to_write = &tables_.back().set_;
   }
-  return table_to_write->WriteToMemory(ptr);
 }
 
 void InternTable::Table::Remove(ObjPtr<mirror::String> s) {
@@ -389,7 +494,6 @@ void InternTable::Table::Remove(ObjPtr<mirror::String> s) {
 }
 
 ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s) {
-  Locks::intern_table_lock_->AssertHeld(Thread::Current());
   for (InternalTable& table : tables_) {
     auto it = table.set_.find(GcRoot<mirror::String>(s));
     if (it != table.set_.end()) {
@@ -400,7 +504,6 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s) {
 }
 
 ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string) {
-  Locks::intern_table_lock_->AssertHeld(Thread::Current());
   for (InternalTable& table : tables_) {
     auto it = table.set_.find(string);
     if (it != table.set_.end()) {
@@ -461,7 +564,7 @@ size_t InternTable::Table::Size() const {
 }
 
 void InternTable::ChangeWeakRootState(gc::WeakRootState new_state) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+  ScopedExclusiveAccess sea(Thread::Current(), *this);
   ChangeWeakRootStateLocked(new_state);
 }
 
@@ -481,4 +584,6 @@ InternTable::Table::Table() {
   tables_.push_back(std::move(initial_table));
 }
 
+InternTable::Shard::Shard() : lock_("InternTable shard lock", kInternTableShardLock) {}
+
 }  // namespace art
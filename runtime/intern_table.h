@@ -18,6 +18,7 @@
 #define ART_RUNTIME_INTERN_TABLE_H_
 
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/hash_set.h"
 #include "base/mutex.h"
 #include "gc/weak_root_state.h"
@@ -171,7 +172,8 @@ class InternTable {
   void VisitRoots(RootVisitor* visitor, VisitRootFlags flags)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::intern_table_lock_);
 
-  // Visit all of the interns in the table.
+  // Visit all of the interns in the table. This and CountInterns() require exclusive access to
+  // the tables, like the visitor of AddImageStringsToTable() has, or no concurrent interning.
   template <typename Visitor>
   void VisitInterns(const Visitor& visitor,
                     bool visit_boot_images,
@@ -210,7 +212,8 @@ class InternTable {
 
  private:
   // Table which holds pre zygote and post zygote interned strings. There is one instance for
-  // weak interns and strong interns.
+  // weak interns and strong interns in each shard, and one for the image interns. The caller
+  // synchronizes, see `Shard`.
   class Table {
    public:
     class InternalTable {
@@ -241,40 +244,25 @@ class InternTable {
     };
 
     Table();
-    ObjPtr<mirror::String> Find(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_)
-        REQUIRES(Locks::intern_table_lock_);
-    ObjPtr<mirror::String> Find(const Utf8String& string) REQUIRES_SHARED(Locks::mutator_lock_)
-        REQUIRES(Locks::intern_table_lock_);
-    void Insert(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_)
-        REQUIRES(Locks::intern_table_lock_);
-    void Remove(ObjPtr<mirror::String> s)
-        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    void VisitRoots(RootVisitor* visitor)
-        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    void SweepWeaks(IsMarkedVisitor* visitor)
-        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+    ObjPtr<mirror::String> Find(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_);
+    ObjPtr<mirror::String> Find(const Utf8String& string) REQUIRES_SHARED(Locks::mutator_lock_);
+    void Insert(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_);
+    void Remove(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_);
+    void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
+    void SweepWeaks(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
     // Add a new intern table that will only be inserted into from now on.
-    void AddNewTable() REQUIRES(Locks::intern_table_lock_);
-    size_t Size() const REQUIRES(Locks::intern_table_lock_);
-    // Read and add an intern table from ptr.
-    // Tables read are inserted at the front of the table array. Only checks for conflicts in
-    // debug builds. Returns how many bytes were read.
-    // NO_THREAD_SAFETY_ANALYSIS for the visitor that may require locks.
-    template <typename Visitor>
-    size_t AddTableFromMemory(const uint8_t* ptr, const Visitor& visitor, bool is_boot_image)
-        REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
-    // Write the intern tables to ptr, if there are multiple tables they are combined into a single
-    // one. Returns how many bytes were written.
-    size_t WriteToMemory(uint8_t* ptr)
-        REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+    void AddNewTable();
+    size_t Size() const;
+    // Add all of the strings of the tables to `set`.
+    void AddToSet(UnorderedSet* set) REQUIRES_SHARED(Locks::mutator_lock_);
 
    private:
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
-        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+        REQUIRES_SHARED(Locks::mutator_lock_);
 
     // Add a table to the front of the tables vector.
     void AddInternStrings(UnorderedSet&& intern_strings, bool is_boot_image)
-        REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+        REQUIRES_SHARED(Locks::mutator_lock_);
 
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
@@ -285,25 +273,77 @@ class InternTable {
     ART_FRIEND_TEST(InternTableTest, CrossHash);
   };
 
+  // The interns that are not in an image are spread over shards by hash, each with its own lock,
+  // so that threads interning different strings do not contend. The tables of a shard are accessed
+  // either holding the lock of the shard or with exclusive access, see ScopedExclusiveAccess.
+  class Shard {
+   public:
+    Shard();
+
+   private:
+    mutable Mutex lock_;
+    Table strong_interns_;
+    Table weak_interns_;
+    std::vector<GcRoot<mirror::String>> new_strong_intern_roots_;
+
+    friend class InternTable;
+    ART_FRIEND_TEST(InternTableTest, CrossHash);
+  };
+
+  // Holds the intern table lock and keeps other threads from using the shards without it, for
+  // operations that access all of the tables or that must not race with new interns.
+  class SCOPED_CAPABILITY ScopedExclusiveAccess {
+   public:
+    ScopedExclusiveAccess(Thread* self, const InternTable& intern_table)
+        ACQUIRE(Locks::intern_table_lock_);
+    ~ScopedExclusiveAccess() RELEASE();
+
+   private:
+    Thread* const self_;
+    const InternTable& intern_table_;
+  };
+
+  static constexpr size_t kNumShardBits = 3u;
+  static constexpr size_t kNumShards = 1u << kNumShardBits;
+
+  Shard* GetShard(int32_t hash) {
+    // Use the high bits of a multiplicative hash, the sets of a shard index buckets by the low
+    // bits of the plain hash.
+    return &shards_[(static_cast<uint32_t>(hash) * 0x9e3779b9u) >> (32u - kNumShardBits)];
+  }
+
+  // Lookups in the image tables and the tables of `shard`.
+  ObjPtr<mirror::String> LookupStrongInShard(Shard* shard, ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  ObjPtr<mirror::String> LookupStrongInShard(Shard* shard, const Utf8String& string)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Whether the weak interns can be read and written.
+  bool IsWeakAccessible(Thread* self) const;
+
   // Insert if non null, otherwise return null. Must be called holding the mutator lock.
   // If holding_locks is true, then we may also hold other locks. If holding_locks is true, then we
   // require GC is not running since it is not safe to wait while holding locks.
   ObjPtr<mirror::String> Insert(ObjPtr<mirror::String> s, bool is_strong, bool holding_locks)
       REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Insert `s` into `shard` after checking the weak interns, once there is no strong match and
+  // the weak interns are accessible.
+  ObjPtr<mirror::String> InsertInShard(Shard* shard, ObjPtr<mirror::String> s, bool is_strong)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Add a table from memory to the strong interns.
   template <typename Visitor>
   size_t AddTableFromMemory(const uint8_t* ptr, const Visitor& visitor, bool is_boot_image)
       REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
-  ObjPtr<mirror::String> InsertStrong(ObjPtr<mirror::String> s)
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  ObjPtr<mirror::String> InsertWeak(ObjPtr<mirror::String> s)
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  void RemoveStrong(ObjPtr<mirror::String> s)
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  void RemoveWeak(ObjPtr<mirror::String> s)
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+  // Recording changes in an active transaction requires the intern table lock.
+  ObjPtr<mirror::String> InsertStrong(Shard* shard, ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  ObjPtr<mirror::String> InsertWeak(Shard* shard, ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void RemoveWeak(Shard* shard, ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Transaction rollback access.
   ObjPtr<mirror::String> InsertStrongFromTransaction(ObjPtr<mirror::String> s)
@@ -319,25 +359,25 @@ class InternTable {
   void ChangeWeakRootStateLocked(gc::WeakRootState new_state)
       REQUIRES(Locks::intern_table_lock_);
 
-  // Wait until we can read weak roots.
-  void WaitUntilAccessible(Thread* self)
-      REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
-
-  bool log_new_roots_ GUARDED_BY(Locks::intern_table_lock_);
+  // Written with exclusive access, read holding a shard lock or the intern table lock.
+  bool log_new_roots_;
   ConditionVariable weak_intern_condition_ GUARDED_BY(Locks::intern_table_lock_);
-  // Since this contains (strong) roots, they need a read barrier to
+  // The strong interns of the images, inserted at the front when an image is added and otherwise
+  // read-only. Read holding a shard lock or with exclusive access, and only modified with
+  // exclusive access. Since this contains (strong) roots, they need a read barrier to
   // enable concurrent intern table (strong) root scan. Do not
   // directly access the strings in it. Use functions that contain
   // read barriers.
-  Table strong_interns_ GUARDED_BY(Locks::intern_table_lock_);
-  std::vector<GcRoot<mirror::String>> new_strong_intern_roots_
-      GUARDED_BY(Locks::intern_table_lock_);
-  // Since this contains (weak) roots, they need a read barrier. Do
-  // not directly access the strings in it. Use functions that contain
-  // read barriers.
-  Table weak_interns_ GUARDED_BY(Locks::intern_table_lock_);
-  // Weak root state, used for concurrent system weak processing and more.
-  gc::WeakRootState weak_root_state_ GUARDED_BY(Locks::intern_table_lock_);
+  Table image_interns_;
+  // Since these contain roots, they need a read barrier. Do not directly access the strings in
+  // them. Use functions that contain read barriers.
+  Shard shards_[kNumShards];
+  // Weak root state, used for concurrent system weak processing and more. Written with exclusive
+  // access, read holding a shard lock or the intern table lock.
+  gc::WeakRootState weak_root_state_;
+  // Set while a thread has exclusive access. Threads that find it set after taking a shard lock
+  // release the shard lock and wait for the intern table lock instead.
+  mutable Atomic<bool> shards_blocked_;
 
   friend class gc::space::ImageSpace;
   friend class linker::ImageWriter;
@@ -15,6 +15,9 @@
  */
 
 #include "interpreter_cache.h"
+
+#include <ostream>
+
 #include "thread-inl.h"
 
 namespace art {
@@ -29,4 +32,43 @@ bool InterpreterCache::IsCalledFromOwningThread() {
   return Thread::Current()->GetInterpreterCache() == this;
 }
 
+bool InterpreterCache::GetFromOtherWays(const void* key, /* out */ size_t* value) {
+  // If weak ref accesses are disabled, the GC is processing the cache and may update the
+  // entries concurrently, so we cannot move entries around. Report a miss.
+  if (kAssociativity != 1u && Thread::Current()->GetWeakRefAccessEnabled()) {
+    size_t index = IndexOf(key);
+    for (size_t way = 1; way != kAssociativity; ++way) {
+      if (data_[way * kSize + index].first == key) {
+        if (kIsDebugBuild) {
+          ++num_other_way_hits_;
+        }
+        *value = data_[way * kSize + index].second;
+        // Move the entry to the first way so that the assembly fast paths find it.
+        Entry entry = data_[way * kSize + index];
+        for (; way != 0; --way) {
+          data_[way * kSize + index] = data_[(way - 1) * kSize + index];
+        }
+        data_[index] = entry;
+        return true;
+      }
+    }
+  }
+  if (kIsDebugBuild) {
+    ++num_misses_;
+  }
+  return false;
+}
+
+void InterpreterCache::DumpStats(std::ostream& os) const {
+  size_t num_lookups = num_first_way_hits_ + num_other_way_hits_ + num_misses_;
+  os << "Interpreter cache lookups=" << num_lookups
+     << " first way hits=" << num_first_way_hits_
+     << " other way hits=" << num_other_way_hits_
+     << " misses=" << num_misses_;
+  if (num_lookups != 0u) {
+    os << " hit rate="
+       << (100.0 * (num_first_way_hits_ + num_other_way_hits_) / num_lookups) << "%";
+  }
+}
+
 }  // namespace art
@@ -19,8 +19,10 @@
 
 #include <array>
 #include <atomic>
+#include <iosfwd>
 
 #include "base/bit_utils.h"
+#include "base/globals.h"
 #include "base/macros.h"
 
 namespace art {
@@ -42,6 +44,12 @@ class Thread;
 // We ensure consistency of the cache by clearing it
 // whenever any dex file is unloaded.
 //
+// The cache is set-associative. The first way of all sets is laid out like a direct-mapped
+// cache of `kSize` entries at the start of the cache, which is the only part the assembly
+// fast paths look at. The other ways hold the entries most recently evicted from the first
+// way and are looked up by the runtime before doing a slow resolution. A hit in another way
+// moves the entry back to the first way.
+//
 // Aligned to 16-bytes to make it easier to get the address of the cache
 // from assembly (it ensures that the offset is valid immediate value).
 class ALIGNED(16) InterpreterCache {
@@ -49,10 +57,14 @@ class ALIGNED(16) InterpreterCache {
   // Aligned since we load the whole entry in single assembly instruction.
   typedef std::pair<const void*, size_t> Entry ALIGNED(2 * sizeof(size_t));
 
+  // Number of sets, i.e. entries in the first way.
   // 2x size increase/decrease corresponds to ~0.5% interpreter performance change.
   // Value of 256 has around 75% cache hit rate.
   static constexpr size_t kSize = 256;
 
+  // Number of entries per set.
+  static constexpr size_t kAssociativity = 2;
+
   InterpreterCache() {
     // We can not use the Clear() method since the constructor will not
     // be called from the owning thread.
@@ -66,24 +78,39 @@ class ALIGNED(16) InterpreterCache {
     DCHECK(IsCalledFromOwningThread());
     Entry& entry = data_[IndexOf(key)];
     if (LIKELY(entry.first == key)) {
+      if (kIsDebugBuild) {
+        ++num_first_way_hits_;
+      }
       *value = entry.second;
       return true;
     }
-    return false;
+    return GetFromOtherWays(key, value);
   }
 
+  // Insert the entry in the first way. The entry it replaces moves to the next way.
   ALWAYS_INLINE void Set(const void* key, size_t value) {
     DCHECK(IsCalledFromOwningThread());
-    data_[IndexOf(key)] = Entry{key, value};
+    size_t index = IndexOf(key);
+    if (data_[index].first != key) {
+      for (size_t way = kAssociativity - 1; way != 0; --way) {
+        data_[way * kSize + index] = data_[(way - 1) * kSize + index];
+      }
+    }
+    data_[index] = Entry{key, value};
   }
 
-  std::array<Entry, kSize>& GetArray() {
+  std::array<Entry, kSize * kAssociativity>& GetArray() {
     return data_;
   }
 
+  // Dump the hit and miss counts of Get(). Only counted in debug builds.
+  void DumpStats(std::ostream& os) const;
+
  private:
   bool IsCalledFromOwningThread();
 
+  bool GetFromOtherWays(const void* key, /* out */ size_t* value);
+
   static ALWAYS_INLINE size_t IndexOf(const void* key) {
     static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
     size_t index = (reinterpret_cast<uintptr_t>(key) >> 2) & (kSize - 1);
@@ -91,7 +118,12 @@ class ALIGNED(16) InterpreterCache {
     return index;
   }
 
-  std::array<Entry, kSize> data_;
+  // Way-major: the entry of way `w` for set `i` is at `w * kSize + i`.
+  std::array<Entry, kSize * kAssociativity> data_;
+
+  size_t num_first_way_hits_ = 0u;
+  size_t num_other_way_hits_ = 0u;
+  size_t num_misses_ = 0u;
 };
 
 }  // namespace art
@@ -1950,58 +1950,81 @@ void ExecuteSwitchImplCpp(SwitchImplContext* ctx) {
       << "Entered interpreter from invoke without retry instruction being handled!";
 
   bool const interpret_one_instruction = ctx->interpret_one_instruction;
-  while (true) {
-    const Instruction* const inst = next;
-    dex_pc = inst->GetDexPc(insns);
-    shadow_frame.SetDexPC(dex_pc);
-    TraceExecution(shadow_frame, inst, dex_pc);
-    uint16_t inst_data = inst->Fetch16(0);
-    bool exit = false;
-    if (InstructionHandler<do_access_check, transaction_active, Instruction::kInvalidFormat>(
-            ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit).
-            Preamble()) {
-      switch (inst->Opcode(inst_data)) {
+
+  // Threaded dispatch: every handler ends with its own copy of the code that fetches the next
+  // instruction and jumps to its handler through `handlers`, instead of going back to a single
+  // switch. The indirect jump of each handler then gets its own branch prediction history.
+  static const void* const handlers[kNumPackedOpcodes] = {
+#define OPCODE_LABEL(OPCODE, OPCODE_NAME, NAME, FORMAT, i, a, e, v) &&op_##OPCODE_NAME,
+  DEX_INSTRUCTION_LIST(OPCODE_LABEL)
+#undef OPCODE_LABEL
+  };
+  const Instruction* inst = nullptr;
+  uint16_t inst_data = 0u;
+  bool exit = false;
+
+#define DISPATCH_NEXT_INSTRUCTION()                                                               \
+  do {                                                                                            \
+    inst = next;                                                                                  \
+    dex_pc = inst->GetDexPc(insns);                                                               \
+    shadow_frame.SetDexPC(dex_pc);                                                                \
+    TraceExecution(shadow_frame, inst, dex_pc);                                                   \
+    inst_data = inst->Fetch16(0);                                                                 \
+    exit = false;                                                                                 \
+    if (UNLIKELY(!InstructionHandler<do_access_check,                                             \
+                                     transaction_active,                                          \
+                                     Instruction::kInvalidFormat>(                                \
+            ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit)         \
+            .Preamble())) {                                                                       \
+      goto preamble_failed;                                                                       \
+    }                                                                                             \
+    goto *handlers[inst->Opcode(inst_data)];                                                      \
+  } while (false)
+
+  DISPATCH_NEXT_INSTRUCTION();
+
 #define OPCODE_CASE(OPCODE, OPCODE_NAME, NAME, FORMAT, i, a, e, v)                                \
-        case OPCODE: {                                                                            \
-          DCHECK_EQ(self->IsExceptionPending(), (OPCODE == Instruction::MOVE_EXCEPTION));         \
-          next = inst->RelativeAt(Instruction::SizeInCodeUnits(Instruction::FORMAT));             \
-          bool success = OP_##OPCODE_NAME<do_access_check, transaction_active>(                   \
-              ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit);     \
-          if (success && LIKELY(!interpret_one_instruction)) {                                    \
-            DCHECK(!exit) << NAME;                                                                \
-            continue;                                                                             \
-          }                                                                                       \
-          if (exit) {                                                                             \
-            shadow_frame.SetDexPC(dex::kDexNoIndex);                                              \
-            return;                                                                               \
-          }                                                                                       \
-          break;                                                                                  \
-        }
+ op_##OPCODE_NAME: {                                                                              \
+    DCHECK_EQ(self->IsExceptionPending(), (OPCODE == Instruction::MOVE_EXCEPTION));               \
+    next = inst->RelativeAt(Instruction::SizeInCodeUnits(Instruction::FORMAT));                   \
+    bool success = OP_##OPCODE_NAME<do_access_check, transaction_active>(                         \
+        ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit);           \
+    if (success && LIKELY(!interpret_one_instruction)) {                                          \
+      DCHECK(!exit) << NAME;                                                                      \
+      DISPATCH_NEXT_INSTRUCTION();                                                                \
+    }                                                                                             \
+    if (exit) {                                                                                   \
+      shadow_frame.SetDexPC(dex::kDexNoIndex);                                                    \
+      return;                                                                                     \
+    }                                                                                             \
+    goto instruction_done;                                                                        \
+  }
   DEX_INSTRUCTION_LIST(OPCODE_CASE)
 #undef OPCODE_CASE
-      }
-    } else {
-      // Preamble returned false due to debugger event.
-      if (exit) {
-        shadow_frame.SetDexPC(dex::kDexNoIndex);
-        return;  // Return statement or debugger forced exit.
-      }
-    }
-    if (self->IsExceptionPending()) {
-      if (!InstructionHandler<do_access_check, transaction_active, Instruction::kInvalidFormat>(
-              ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit).
-              HandlePendingException()) {
-        shadow_frame.SetDexPC(dex::kDexNoIndex);
-        return;  // Locally unhandled exception - return to caller.
-      }
-      // Continue execution in the catch block.
-    }
-    if (interpret_one_instruction) {
-      shadow_frame.SetDexPC(next->GetDexPc(insns));  // Record where we stopped.
-      ctx->result = ctx->result_register;
-      return;
+
+ preamble_failed:
+  // Preamble returned false due to debugger event.
+  if (exit) {
+    shadow_frame.SetDexPC(dex::kDexNoIndex);
+    return;  // Return statement or debugger forced exit.
+  }
+ instruction_done:
+  if (self->IsExceptionPending()) {
+    if (!InstructionHandler<do_access_check, transaction_active, Instruction::kInvalidFormat>(
+            ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit).
+            HandlePendingException()) {
+      shadow_frame.SetDexPC(dex::kDexNoIndex);
+      return;  // Locally unhandled exception - return to caller.
     }
+    // Continue execution in the catch block.
+  }
+  if (interpret_one_instruction) {
+    shadow_frame.SetDexPC(next->GetDexPc(insns));  // Record where we stopped.
+    ctx->result = ctx->result_register;
+    return;
   }
+  DISPATCH_NEXT_INSTRUCTION();
+#undef DISPATCH_NEXT_INSTRUCTION
 }  // NOLINT(readability/fn_size)
 
 }  // namespace interpreter
@@ -119,6 +119,12 @@ inline void UpdateCache(Thread* self, uint16_t* dex_pc_ptr, T* value) {
   UpdateCache(self, dex_pc_ptr, reinterpret_cast<size_t>(value));
 }
 
+// The assembly fast paths only look at the first way of the cache. Look at the other ways
+// before doing the slow resolution.
+inline bool FindInCache(Thread* self, uint16_t* dex_pc_ptr, /* out */ size_t* value) {
+  return self->GetInterpreterCache()->Get(dex_pc_ptr, value);
+}
+
 extern "C" const dex::CodeItem* NterpGetCodeItem(ArtMethod* method)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   ScopedAssertNoThreadSuspension sants("In nterp");
@@ -162,6 +168,10 @@ extern "C" const char* NterpGetShortyFromInvokeCustom(ArtMethod* caller, uint16_
 extern "C" size_t NterpGetMethod(Thread* self, ArtMethod* caller, uint16_t* dex_pc_ptr)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (FindInCache(self, dex_pc_ptr, &cached_value)) {
+    return cached_value;
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   InvokeType invoke_type = kStatic;
   uint16_t method_index = 0;
@@ -354,6 +364,10 @@ static ArtField* ResolveFieldWithAccessChecks(Thread* self,
 extern "C" size_t NterpGetStaticField(Thread* self, ArtMethod* caller, uint16_t* dex_pc_ptr)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (FindInCache(self, dex_pc_ptr, &cached_value)) {
+    return cached_value;
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   uint16_t field_index = inst->VRegB_21c();
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
@@ -395,6 +409,10 @@ extern "C" uint32_t NterpGetInstanceFieldOffset(Thread* self,
                                                 uint16_t* dex_pc_ptr)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (FindInCache(self, dex_pc_ptr, &cached_value)) {
+    return static_cast<uint32_t>(cached_value);
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   uint16_t field_index = inst->VRegC_22c();
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
@@ -424,6 +442,16 @@ extern "C" mirror::Object* NterpGetClassOrAllocateObject(Thread* self,
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
   const Instruction* inst = Instruction::At(dex_pc_ptr);
+  size_t cached_value;
+  if (FindInCache(self, dex_pc_ptr, &cached_value)) {
+    ObjPtr<mirror::Class> c = reinterpret_cast<mirror::Class*>(cached_value);
+    if (inst->Opcode() == Instruction::NEW_INSTANCE) {
+      // Only non-finalizable instantiable classes are cached for new-instance.
+      gc::AllocatorType allocator_type = Runtime::Current()->GetHeap()->GetCurrentAllocator();
+      return AllocObjectFromCode(c, self, allocator_type).Ptr();
+    }
+    return c.Ptr();
+  }
   dex::TypeIndex index;
   switch (inst->Opcode()) {
     case Instruction::NEW_INSTANCE:
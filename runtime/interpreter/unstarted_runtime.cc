@@ -20,6 +20,7 @@
 #include <errno.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cmath>
 #include <initializer_list>
 #include <limits>
@@ -36,6 +37,7 @@
 #include "base/quasi_atomic.h"
 #include "base/zip_archive.h"
 #include "class_linker.h"
+#include "class_root-inl.h"
 #include "common_throws.h"
 #include "dex/descriptors_names.h"
 #include "entrypoints/entrypoint_utils-inl.h"
@@ -499,6 +501,56 @@ void UnstartedRuntime::UnstartedClassGetInnerClassFlags(
   result->SetI(mirror::Class::GetInnerClassFlags(klass, default_value));
 }
 
+void UnstartedRuntime::UnstartedClassGetInnerClassName(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Class> klass(hs.NewHandle(
+      reinterpret_cast<mirror::Class*>(shadow_frame->GetVRegReference(arg_offset))));
+  if (klass->IsProxyClass() || klass->GetDexCache() == nullptr) {
+    result->SetL(nullptr);
+    return;
+  }
+  ObjPtr<mirror::String> class_name = nullptr;
+  if (!annotations::GetInnerClass(klass, &class_name)) {
+    result->SetL(nullptr);
+    return;
+  }
+  result->SetL(class_name);
+}
+
+void UnstartedRuntime::UnstartedClassGetInterfacesInternal(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Class> klass(hs.NewHandle(
+      reinterpret_cast<mirror::Class*>(shadow_frame->GetVRegReference(arg_offset))));
+  if (klass->IsProxyClass()) {
+    AbortTransactionOrFail(self, "Class.getInterfacesInternal() of proxy class %s",
+                           klass->PrettyDescriptor().c_str());
+    return;
+  }
+  const dex::TypeList* iface_list = klass->GetInterfaceTypeList();
+  if (iface_list == nullptr) {
+    result->SetL(nullptr);
+    return;
+  }
+  ClassLinker* linker = Runtime::Current()->GetClassLinker();
+  const uint32_t num_ifaces = iface_list->Size();
+  ObjPtr<mirror::ObjectArray<mirror::Class>> ifaces = mirror::ObjectArray<mirror::Class>::Alloc(
+      self, GetClassRoot<mirror::ObjectArray<mirror::Class>>(linker), num_ifaces);
+  if (ifaces == nullptr) {
+    DCHECK(self->IsExceptionPending());
+    return;
+  }
+  // The array was allocated in the transaction, so the stores need not be recorded.
+  for (uint32_t i = 0; i < num_ifaces; ++i) {
+    const dex::TypeIndex type_idx = iface_list->GetTypeItem(i).type_idx_;
+    ObjPtr<mirror::Class> interface = linker->LookupResolvedType(type_idx, klass.Get());
+    DCHECK(interface != nullptr);
+    ifaces->SetWithoutChecks</* kTransactionActive= */ false>(i, interface);
+  }
+  result->SetL(ifaces);
+}
+
 void UnstartedRuntime::UnstartedClassGetSignatureAnnotation(
     Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
   StackHandleScope<1> hs(self);
@@ -894,6 +946,16 @@ void UnstartedRuntime::UnstartedSystemArraycopy(
     PrimitiveArrayCopy<uint16_t>(self, src_array, src_pos, dst_array, dst_pos, length);
   } else if (src_type->IsPrimitiveInt()) {
     PrimitiveArrayCopy<int32_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveBoolean()) {
+    PrimitiveArrayCopy<uint8_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveShort()) {
+    PrimitiveArrayCopy<int16_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveLong()) {
+    PrimitiveArrayCopy<int64_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveFloat()) {
+    PrimitiveArrayCopy<float>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveDouble()) {
+    PrimitiveArrayCopy<double>(self, src_array, src_pos, dst_array, dst_pos, length);
   } else {
     AbortTransactionOrFail(self, "Unimplemented System.arraycopy for type '%s'",
                            src_type->PrettyDescriptor().c_str());
@@ -918,6 +980,36 @@ void UnstartedRuntime::UnstartedSystemArraycopyInt(
   UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
 }
 
+void UnstartedRuntime::UnstartedSystemArraycopyBoolean(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyShort(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyLong(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyFloat(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyDouble(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
 void UnstartedRuntime::UnstartedSystemGetSecurityManager(
     Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame ATTRIBUTE_UNUSED,
     JValue* result, size_t arg_offset ATTRIBUTE_UNUSED) {
@@ -1172,6 +1264,37 @@ void UnstartedRuntime::UnstartedMathPow(
                    shadow_frame->GetVRegDouble(arg_offset + 2)));
 }
 
+void UnstartedRuntime::UnstartedMathSqrt(
+    Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  result->SetD(sqrt(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
+void UnstartedRuntime::UnstartedMathRint(
+    Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  result->SetD(rint(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
+void UnstartedRuntime::UnstartedMathTan(
+    Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  result->SetD(tan(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
+void UnstartedRuntime::UnstartedMathAtan(
+    Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  result->SetD(atan(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
+void UnstartedRuntime::UnstartedMathAtan2(
+    Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  result->SetD(atan2(shadow_frame->GetVRegDouble(arg_offset),
+                     shadow_frame->GetVRegDouble(arg_offset + 2)));
+}
+
+void UnstartedRuntime::UnstartedMathLog10(
+    Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  result->SetD(log10(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
 void UnstartedRuntime::UnstartedObjectHashCode(
     Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
   mirror::Object* obj = shadow_frame->GetVRegReference(arg_offset);
@@ -1336,6 +1459,26 @@ void UnstartedRuntime::UnstartedStringCharAt(
   result->SetC(string->CharAt(index));
 }
 
+void UnstartedRuntime::UnstartedStringConcat(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  StackHandleScope<2> hs(self);
+  Handle<mirror::String> h_this(
+      hs.NewHandle(shadow_frame->GetVRegReference(arg_offset)->AsString()));
+  mirror::Object* arg = shadow_frame->GetVRegReference(arg_offset + 1);
+  if (arg == nullptr) {
+    AbortTransactionOrFail(self, "String.concat with null object");
+    return;
+  }
+  Handle<mirror::String> h_arg(hs.NewHandle(arg->AsString()));
+  if (h_this->GetLength() == 0) {
+    result->SetL(h_arg.Get());
+  } else if (h_arg->GetLength() == 0) {
+    result->SetL(h_this.Get());
+  } else {
+    result->SetL(mirror::String::DoConcat(self, h_this, h_arg));
+  }
+}
+
 // This allows creating String objects with replaced characters during compilation.
 // String.doReplace(char, char) is called from String.replace(char, char) when there is a match.
 void UnstartedRuntime::UnstartedStringDoReplace(
@@ -2015,6 +2158,9 @@ using JNIHandler = void(*)(Thread* self,
 static bool tables_initialized_ = false;
 static std::unordered_map<std::string, InvokeHandler> invoke_handlers_;
 static std::unordered_map<std::string, JNIHandler> jni_handlers_;
+// Number of transactions aborted by each native method without a handler. Only updated
+// while a transaction is active, which is single-threaded.
+static std::unordered_map<std::string, size_t> unsupported_native_counts_;
 
 void UnstartedRuntime::InitializeInvokeHandlers() {
 #define UNSTARTED_DIRECT(ShortName, Sig) \
@@ -2079,6 +2225,7 @@ void UnstartedRuntime::Jni(Thread* self, ArtMethod* method, mirror::Object* rece
     result->SetL(nullptr);
     (*iter->second)(self, method, receiver, args, result);
   } else if (Runtime::Current()->IsActiveTransaction()) {
+    ++unsupported_native_counts_[name];
     AbortTransactionF(self, "Attempt to invoke native method in non-started runtime: %s",
                       name.c_str());
   } else {
@@ -2087,5 +2234,24 @@ void UnstartedRuntime::Jni(Thread* self, ArtMethod* method, mirror::Object* rece
   }
 }
 
+void UnstartedRuntime::DumpUnsupportedNativeMethods(std::ostream& os, size_t max_entries) {
+  std::vector<std::pair<size_t, const std::string*>> entries;
+  entries.reserve(unsupported_native_counts_.size());
+  for (const auto& entry : unsupported_native_counts_) {
+    entries.emplace_back(entry.second, &entry.first);
+  }
+  std::sort(entries.begin(),
+            entries.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs.first != rhs.first ? lhs.first > rhs.first : *lhs.second < *rhs.second;
+            });
+  if (entries.size() > max_entries) {
+    entries.resize(max_entries);
+  }
+  for (const auto& entry : entries) {
+    os << entry.first << " " << *entry.second << "\n";
+  }
+}
+
 }  // namespace interpreter
 }  // namespace art
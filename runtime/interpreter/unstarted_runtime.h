@@ -19,6 +19,8 @@
 
 #include "interpreter.h"
 
+#include <iosfwd>
+
 #include "dex/dex_file.h"
 #include "jvalue.h"
 
@@ -62,6 +64,11 @@ class UnstartedRuntime {
                   JValue* result)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Dump the native methods without an implementation here that most often aborted a
+  // transaction, with their abort counts, at most `max_entries` of them. Gives the most
+  // useful candidates for new implementations when class initialization fails at build time.
+  static void DumpUnsupportedNativeMethods(std::ostream& os, size_t max_entries);
+
  private:
   // Methods that intercept available libcore implementations.
 #define UNSTARTED_DIRECT(ShortName, SigIgnored)                 \
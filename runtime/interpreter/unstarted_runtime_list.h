@@ -32,6 +32,8 @@
   V(ClassGetDeclaringClass, "java.lang.Class java.lang.Class.getDeclaringClass()") \
   V(ClassGetEnclosingClass, "java.lang.Class java.lang.Class.getEnclosingClass()") \
   V(ClassGetInnerClassFlags, "int java.lang.Class.getInnerClassFlags(int)") \
+  V(ClassGetInnerClassName, "java.lang.String java.lang.Class.getInnerClassName()") \
+  V(ClassGetInterfacesInternal, "java.lang.Class[] java.lang.Class.getInterfacesInternal()") \
   V(ClassGetSignatureAnnotation, "java.lang.String[] java.lang.Class.getSignatureAnnotation()") \
   V(ClassIsAnonymousClass, "boolean java.lang.Class.isAnonymousClass()") \
   V(ClassLoaderGetResourceAsStream, "java.io.InputStream java.lang.ClassLoader.getResourceAsStream(java.lang.String)") \
@@ -41,6 +43,11 @@
   V(SystemArraycopyByte, "void java.lang.System.arraycopy(byte[], int, byte[], int, int)") \
   V(SystemArraycopyChar, "void java.lang.System.arraycopy(char[], int, char[], int, int)") \
   V(SystemArraycopyInt, "void java.lang.System.arraycopy(int[], int, int[], int, int)") \
+  V(SystemArraycopyBoolean, "void java.lang.System.arraycopy(boolean[], int, boolean[], int, int)") \
+  V(SystemArraycopyShort, "void java.lang.System.arraycopy(short[], int, short[], int, int)") \
+  V(SystemArraycopyLong, "void java.lang.System.arraycopy(long[], int, long[], int, int)") \
+  V(SystemArraycopyFloat, "void java.lang.System.arraycopy(float[], int, float[], int, int)") \
+  V(SystemArraycopyDouble, "void java.lang.System.arraycopy(double[], int, double[], int, int)") \
   V(SystemGetSecurityManager, "java.lang.SecurityManager java.lang.System.getSecurityManager()") \
   V(SystemGetProperty, "java.lang.String java.lang.System.getProperty(java.lang.String)") \
   V(SystemGetPropertyWithDefault, "java.lang.String java.lang.System.getProperty(java.lang.String, java.lang.String)") \
@@ -50,6 +57,12 @@
   V(MathSin, "double java.lang.Math.sin(double)") \
   V(MathCos, "double java.lang.Math.cos(double)") \
   V(MathPow, "double java.lang.Math.pow(double, double)") \
+  V(MathSqrt, "double java.lang.Math.sqrt(double)") \
+  V(MathRint, "double java.lang.Math.rint(double)") \
+  V(MathTan, "double java.lang.Math.tan(double)") \
+  V(MathAtan, "double java.lang.Math.atan(double)") \
+  V(MathAtan2, "double java.lang.Math.atan2(double, double)") \
+  V(MathLog10, "double java.lang.Math.log10(double)") \
   V(ObjectHashCode, "int java.lang.Object.hashCode()") \
   V(DoubleDoubleToRawLongBits, "long java.lang.Double.doubleToRawLongBits(double)") \
   V(MemoryPeekByte, "byte libcore.io.Memory.peekByte(long)") \
@@ -62,6 +75,7 @@
   V(RuntimeAvailableProcessors, "int java.lang.Runtime.availableProcessors()") \
   V(StringGetCharsNoCheck, "void java.lang.String.getCharsNoCheck(int, int, char[], int)") \
   V(StringCharAt, "char java.lang.String.charAt(int)") \
+  V(StringConcat, "java.lang.String java.lang.String.concat(java.lang.String)") \
   V(StringDoReplace, "java.lang.String java.lang.String.doReplace(char, char)") \
   V(StringFactoryNewStringFromChars, "java.lang.String java.lang.StringFactory.newStringFromChars(int, int, char[])") \
   V(StringFactoryNewStringFromString, "java.lang.String java.lang.StringFactory.newStringFromString(java.lang.String)") \
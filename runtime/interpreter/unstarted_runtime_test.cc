@@ -877,6 +877,40 @@ TEST_F(UnstartedRuntimeTest, Pow) {
   EXPECT_EQ(UINT64_C(0x3f8c5c51326aa7ee), lresult);
 }
 
+TEST_F(UnstartedRuntimeTest, Atan2) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  UniqueDeoptShadowFramePtr tmp = CreateShadowFrame(10, nullptr, nullptr, 0);
+
+  tmp->SetVRegDouble(0, 1.0);
+  tmp->SetVRegDouble(2, -1.0);
+
+  JValue result;
+  UnstartedMathAtan2(self, tmp.get(), &result, 0);
+  EXPECT_DOUBLE_EQ(atan2(1.0, -1.0), result.GetD());
+}
+
+TEST_F(UnstartedRuntimeTest, StringConcat) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  StackHandleScope<2> hs(self);
+  Handle<mirror::String> first = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "abc"));
+  Handle<mirror::String> second = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "de"));
+  ASSERT_TRUE(first != nullptr);
+  ASSERT_TRUE(second != nullptr);
+
+  UniqueDeoptShadowFramePtr tmp = CreateShadowFrame(10, nullptr, nullptr, 0);
+  tmp->SetVRegReference(0, first.Get());
+  tmp->SetVRegReference(1, second.Get());
+
+  JValue result;
+  UnstartedStringConcat(self, tmp.get(), &result, 0);
+  ASSERT_TRUE(result.GetL() != nullptr);
+  EXPECT_TRUE(result.GetL()->AsString()->Equals("abcde"));
+}
+
 TEST_F(UnstartedRuntimeTest, IsAnonymousClass) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
@@ -18,15 +18,22 @@
 
 #include <dlfcn.h>
 
+#include <algorithm>
+#include <thread>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/memfd.h"
 #include "base/memory_tool.h"
+#include "base/os.h"
 #include "base/runtime_debug.h"
 #include "base/scoped_flock.h"
+#include "base/systrace.h"
 #include "base/utils.h"
+#include "cha.h"
+#include "class_linker.h"
 #include "class_root-inl.h"
 #include "compilation_kind.h"
 #include "debugger.h"
@@ -80,6 +87,9 @@ static constexpr uint32_t kJitStressDefaultWarmUpThreshold = kJitStressDefaultCo
 static constexpr uint32_t kJitSlowStressDefaultWarmUpThreshold =
     kJitSlowStressDefaultCompileThreshold / 2;
 
+// Number of optimized compilations between two publications to the shared JIT cache.
+static constexpr uint32_t kSharedCachePublishInterval = 32;
+
 DEFINE_RUNTIME_DEBUG_FLAG(Jit, kSlowMode);
 
 // JIT compiler
@@ -103,6 +113,15 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::ProfileSaverOpts);
   jit_options->thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
+  jit_options->thread_pool_thread_count_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadCount);
+  jit_options->persistent_cache_path_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPersistentCache);
+  jit_options->shared_cache_path_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITSharedCache);
+  jit_options->commit_batch_size_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITCommitBatchSize);
+  jit_options->prefill_bss_ = options.GetOrDefault(RuntimeArgumentMap::JITPrefillBss);
 
   // Set default compile threshold to aide with sanity checking defaults.
   jit_options->compile_threshold_ =
@@ -203,6 +222,21 @@ void Jit::DumpInfo(std::ostream& os) {
   memory_use_.PrintMemoryUse(os);
 }
 
+void Jit::DumpStats(std::ostream& os) {
+  stats_.Dump(os);
+  code_cache_->DumpStats(os);
+  Runtime* runtime = Runtime::Current();
+  for (size_t i = 0; i <= static_cast<size_t>(DeoptimizationKind::kLast); ++i) {
+    DeoptimizationKind kind = static_cast<DeoptimizationKind>(i);
+    os << "jit_deopt kind=\"" << GetDeoptimizationKindName(kind) << "\" count="
+       << runtime->GetDeoptimizationCount(kind) << "\n";
+  }
+  ClassHierarchyAnalysis* cha = runtime->GetClassLinker()->GetClassHierarchyAnalysis();
+  if (cha != nullptr) {
+    cha->DumpStats(os);
+  }
+}
+
 void Jit::DumpForSigQuit(std::ostream& os) {
   DumpInfo(os);
   ProfileSaver::DumpInstanceInfo(os);
@@ -215,6 +249,7 @@ void Jit::AddTimingLogger(const TimingLogger& logger) {
 Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
     : code_cache_(code_cache),
       options_(options),
+      shared_cache_lock_("Jit::shared_cache_lock_"),
       boot_completed_lock_("Jit::boot_completed_lock_"),
       cumulative_timings_("JIT timings"),
       memory_use_("Memory used for compilation", 16),
@@ -341,8 +376,21 @@ bool Jit::CompileMethod(ArtMethod* method,
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
             << " kind=" << compilation_kind;
+  if (thread_pool_ != nullptr) {
+    stats_.RecordQueueDepth(GetCompileQueueDepth(self));
+  }
+  const uint64_t start_ns = NanoTime();
   bool success = jit_compiler_->CompileMethod(self, region, method_to_compile, compilation_kind);
+  stats_.RecordCompilation(compilation_kind, NanoTime() - start_ns, success);
   code_cache_->DoneCompiling(method_to_compile, self, compilation_kind);
+  if (success && compilation_kind == CompilationKind::kOptimized) {
+    MaybePublishSharedCache(self);
+  }
+  if (options_->GetCommitBatchSize() > 1u) {
+    // Publish a partial batch once the queue drains, so that it does not wait for more work.
+    bool queue_drained = (thread_pool_ == nullptr) || (GetCompileQueueDepth(self) == 0u);
+    code_cache_->PublishPendingCommits(self, /*force=*/ queue_drained);
+  }
   if (!success) {
     VLOG(jit) << "Failed to compile method "
               << ArtMethod::PrettyMethod(method_to_compile)
@@ -594,6 +642,7 @@ bool Jit::MaybeDoOnStackReplacement(Thread* thread,
   if (osr_data == nullptr) {
     return false;
   }
+  jit->GetStats()->RecordOsrTransition();
 
   {
     thread->PopShadowFrame();
@@ -766,14 +815,28 @@ class JitCompileTask final : public Task {
   };
 
   JitCompileTask(ArtMethod* method, TaskKind task_kind, CompilationKind compilation_kind)
-      : method_(method), kind_(task_kind), compilation_kind_(compilation_kind), klass_(nullptr) {
+      : method_(method),
+        kind_(task_kind),
+        compilation_kind_(compilation_kind),
+        klass_(nullptr),
+        priority_(0u),
+        enqueue_time_ns_(NanoTime()),
+        enqueue_hotness_count_(0u) {
     ScopedObjectAccess soa(Thread::Current());
+    if (kind_ == TaskKind::kCompile) {
+      // OSR requests come first, as the method is stuck in a loop, then optimized and then
+      // baseline compilations. Within a kind, hotter methods come first. Pre-compilation and
+      // profile allocation tasks keep the default priority, and therefore their FIFO order.
+      enqueue_hotness_count_ = method->GetCounter();
+      priority_ = (GetCompilationKindRank(compilation_kind_) << 16) | enqueue_hotness_count_;
+    }
     // For a non-bootclasspath class, add a global ref to the class to prevent class unloading
     // until compilation is done.
-    // When we precompile, this is either with boot classpath methods, or main
-    // class loader methods, so we don't need to keep a global reference.
+    // When we precompile from a profile, this is either with boot classpath methods, or main
+    // class loader methods, so we don't need to keep a global reference. Methods from the
+    // persistent JIT cache can come from any class loader.
     if (method->GetDeclaringClass()->GetClassLoader() != nullptr &&
-        kind_ != TaskKind::kPreCompile) {
+        (kind_ != TaskKind::kPreCompile || !method->IsPreCompiled())) {
       klass_ = soa.Vm()->AddGlobalRef(soa.Self(), method_->GetDeclaringClass());
       CHECK(klass_ != nullptr);
     }
@@ -789,6 +852,11 @@ class JitCompileTask final : public Task {
   void Run(Thread* self) override {
     {
       ScopedObjectAccess soa(self);
+      if (IsStale()) {
+        VLOG(jit) << "Dropping stale compilation of " << ArtMethod::PrettyMethod(method_)
+                  << " kind=" << compilation_kind_;
+        return;
+      }
       switch (kind_) {
         case TaskKind::kCompile:
         case TaskKind::kPreCompile: {
@@ -814,11 +882,51 @@ class JitCompileTask final : public Task {
     delete this;
   }
 
+  uint32_t GetPriority() const override {
+    return priority_;
+  }
+
  private:
+  // How long a compilation request may wait in the queue before we check whether the method
+  // is still being executed.
+  static constexpr uint64_t kStaleTaskTimeNs = MsToNs(2000);
+
+  static uint32_t GetCompilationKindRank(CompilationKind compilation_kind) {
+    switch (compilation_kind) {
+      case CompilationKind::kOsr:
+        return 3u;
+      case CompilationKind::kOptimized:
+        return 2u;
+      case CompilationKind::kBaseline:
+        return 1u;
+    }
+    UNREACHABLE();
+  }
+
+  // A request that waited long in the queue is dropped if the method has not been executed
+  // since: it is not hot anymore, and will be requested again if it heats up. OSR requests
+  // and methods already running compiled code do not report samples, so they are kept.
+  bool IsStale() REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (kind_ != TaskKind::kCompile || compilation_kind_ == CompilationKind::kOsr) {
+      return false;
+    }
+    if (NanoTime() - enqueue_time_ns_ < kStaleTaskTimeNs) {
+      return false;
+    }
+    if (Runtime::Current()->GetJit()->GetCodeCache()->ContainsPc(
+            method_->GetEntryPointFromQuickCompiledCode())) {
+      return false;
+    }
+    return method_->GetCounter() == enqueue_hotness_count_;
+  }
+
   ArtMethod* const method_;
   const TaskKind kind_;
   const CompilationKind compilation_kind_;
   jobject klass_;
+  uint32_t priority_;
+  const uint64_t enqueue_time_ns_;
+  uint16_t enqueue_hotness_count_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
@@ -974,8 +1082,12 @@ class ZygoteTask final : public Task {
 
 class JitProfileTask final : public Task {
  public:
+  // If `persistent_cache` is not empty, compile the methods listed in that persistent JIT
+  // cache file instead of the profiles next to the dex files.
   JitProfileTask(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
-                 jobject class_loader) {
+                 jobject class_loader,
+                 const std::string& persistent_cache = "")
+      : persistent_cache_(persistent_cache) {
     ScopedObjectAccess soa(Thread::Current());
     StackHandleScope<1> hs(soa.Self());
     Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
@@ -997,11 +1109,18 @@ class JitProfileTask final : public Task {
     Handle<mirror::ClassLoader> loader = hs.NewHandle<mirror::ClassLoader>(
         soa.Decode<mirror::ClassLoader>(class_loader_));
 
+    Jit* jit = Runtime::Current()->GetJit();
+
+    if (!persistent_cache_.empty()) {
+      uint32_t added_to_queue =
+          jit->CompileMethodsFromPersistentCache(self, dex_files_, persistent_cache_, loader);
+      VLOG(jit) << "Added " << added_to_queue << " methods from " << persistent_cache_;
+      return;
+    }
+
     std::string profile = GetProfileFile(dex_files_[0]->GetLocation());
     std::string boot_profile = GetBootProfileFile(profile);
 
-    Jit* jit = Runtime::Current()->GetJit();
-
     jit->CompileMethodsFromBootProfile(
         self,
         dex_files_,
@@ -1029,10 +1148,102 @@ class JitProfileTask final : public Task {
  private:
   std::vector<const DexFile*> dex_files_;
   jobject class_loader_;
+  const std::string persistent_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(JitProfileTask);
 };
 
+// Fills the .bss slots of newly loaded oat files for types and strings that are already known,
+// mostly those of the app image that the profile put there, so that the first uses from compiled
+// code on the loading thread do not go through the resolution entrypoints.
+class JitBssPrefillTask final : public Task {
+ public:
+  JitBssPrefillTask(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+                    jobject class_loader) {
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+        soa.Decode<mirror::ClassLoader>(class_loader)));
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    for (const auto& dex_file : dex_files) {
+      dex_files_.push_back(dex_file.get());
+      // Register the dex file so that we can guarantee it doesn't get deleted
+      // while reading it during the task.
+      class_linker->RegisterDexFile(*dex_file.get(), h_loader.Get());
+    }
+    class_loader_ = soa.Vm()->AddGlobalRef(soa.Self(), h_loader.Get());
+  }
+
+  void Run(Thread* self) override {
+    ScopedTrace trace("Prefill .bss");
+    ScopedObjectAccess soa(self);
+    StackHandleScope<2> hs(self);
+    Handle<mirror::ClassLoader> loader = hs.NewHandle<mirror::ClassLoader>(
+        soa.Decode<mirror::ClassLoader>(class_loader_));
+    MutableHandle<mirror::DexCache> dex_cache = hs.NewHandle<mirror::DexCache>(nullptr);
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    size_t filled = 0u;
+    for (const DexFile* dex_file : dex_files_) {
+      dex_cache.Assign(class_linker->FindDexCache(self, *dex_file));
+      CHECK(dex_cache != nullptr) << "Could not find dex cache for " << dex_file->GetLocation();
+      filled += FillBssEntriesFromLookups(*dex_file, dex_cache.Get(), loader.Get());
+    }
+    VLOG(jit) << "Prefilled " << filled << " .bss entries for " << dex_files_[0]->GetLocation();
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+  ~JitBssPrefillTask() {
+    ScopedObjectAccess soa(Thread::Current());
+    soa.Vm()->DeleteGlobalRef(soa.Self(), class_loader_);
+  }
+
+ private:
+  std::vector<const DexFile*> dex_files_;
+  jobject class_loader_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitBssPrefillTask);
+};
+
+class JitPublishSharedCacheTask final : public SelfDeletingTask {
+ public:
+  JitPublishSharedCacheTask() {}
+
+  void Run(Thread* self) override {
+    Runtime::Current()->GetJit()->PublishSharedCache(self);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(JitPublishSharedCacheTask);
+};
+
+class JitSavePersistentCacheTask final : public SelfDeletingTask {
+ public:
+  JitSavePersistentCacheTask() {}
+
+  void Run(Thread* self) override {
+    Runtime::Current()->GetJit()->SavePersistentCache(self);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(JitSavePersistentCacheTask);
+};
+
+void Jit::MaybePublishSharedCache(Thread* self) {
+  if (thread_pool_ == nullptr ||
+      options_->GetSharedCachePath().empty() ||
+      Runtime::Current()->IsZygote()) {
+    return;
+  }
+  if (optimized_since_publish_.fetch_add(1u, std::memory_order_relaxed) + 1u ==
+          kSharedCachePublishInterval) {
+    optimized_since_publish_.store(0u, std::memory_order_relaxed);
+    thread_pool_->AddTask(self, new JitPublishSharedCacheTask());
+  }
+}
+
 static void CopyIfDifferent(void* s1, const void* s2, size_t n) {
   if (memcmp(s1, s2, n) != 0) {
     memcpy(s1, s2, n);
@@ -1205,7 +1416,7 @@ void Jit::CreateThreadPool() {
 
   // We need peers as we may report the JIT thread, e.g., in the debugger.
   constexpr bool kJitPoolNeedsPeers = true;
-  thread_pool_.reset(new ThreadPool("Jit thread pool", 1, kJitPoolNeedsPeers));
+  thread_pool_.reset(new ThreadPool("Jit thread pool", GetThreadPoolSize(), kJitPoolNeedsPeers));
 
   thread_pool_->SetPthreadPriority(options_->GetThreadPoolPthreadPriority());
   Start();
@@ -1314,9 +1525,237 @@ void Jit::RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& de
       UseJitCompilation() && HasImageWithProfile() &&
       !runtime->IsJavaDebuggable()) {
     thread_pool_->AddTask(Thread::Current(), new JitProfileTask(dex_files, class_loader));
+  } else if (!options_->GetPersistentCachePath().empty() &&
+             UseJitCompilation() &&
+             !runtime->IsZygote() &&
+             !runtime->IsJavaDebuggable() &&
+             OS::FileExists(options_->GetPersistentCachePath().c_str())) {
+    thread_pool_->AddTask(
+        Thread::Current(),
+        new JitProfileTask(dex_files, class_loader, options_->GetPersistentCachePath()));
+  }
+  const std::string& shared_cache = options_->GetSharedCachePath();
+  if (!shared_cache.empty() &&
+      UseJitCompilation() &&
+      !runtime->IsZygote() &&
+      !runtime->IsJavaDebuggable()) {
+    Thread* self = Thread::Current();
+    {
+      ScopedObjectAccess soa(self);
+      std::vector<const DexFile*> registered_dex_files;
+      for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+        registered_dex_files.push_back(dex_file.get());
+      }
+      ObjPtr<mirror::ClassLoader> loader = soa.Decode<mirror::ClassLoader>(class_loader);
+      if (loader != nullptr) {
+        jweak weak_loader = soa.Vm()->AddWeakGlobalRef(self, loader);
+        MutexLock mu(self, shared_cache_lock_);
+        shared_cache_loaders_.emplace_back(std::move(registered_dex_files), weak_loader);
+      }
+    }
+    if (OS::FileExists(shared_cache.c_str())) {
+      thread_pool_->AddTask(self, new JitProfileTask(dex_files, class_loader, shared_cache));
+    }
+  }
+  if (options_->PrefillBss() && thread_pool_ != nullptr && !runtime->IsZygote()) {
+    bool has_executable_oat_file = std::any_of(
+        dex_files.begin(),
+        dex_files.end(),
+        [](const std::unique_ptr<const DexFile>& dex_file) {
+          const OatDexFile* oat_dex_file = dex_file->GetOatDexFile();
+          return oat_dex_file != nullptr && oat_dex_file->GetOatFile()->IsExecutable();
+        });
+    if (has_executable_oat_file) {
+      thread_pool_->AddTask(Thread::Current(), new JitBssPrefillTask(dex_files, class_loader));
+    }
+  }
+}
+
+uint32_t Jit::CompileMethodsFromPersistentCache(Thread* self,
+                                                const std::vector<const DexFile*>& dex_files,
+                                                const std::string& cache_file,
+                                                Handle<mirror::ClassLoader> class_loader) {
+  unix_file::FdFile file(cache_file.c_str(), O_RDONLY, true);
+  if (file.Fd() == -1) {
+    PLOG(WARNING) << "Could not open persistent JIT cache " << cache_file;
+    return 0u;
+  }
+  ProfileCompilationInfo cache_info;
+  if (!cache_info.Load(file.Fd())) {
+    LOG(WARNING) << "Could not load persistent JIT cache " << cache_file;
+    return 0u;
+  }
+
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::DexCache> dex_cache = hs.NewHandle<mirror::DexCache>(nullptr);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  uint32_t added_to_queue = 0u;
+  for (const DexFile* dex_file : dex_files) {
+    std::set<dex::TypeIndex> class_types;
+    std::set<uint16_t> hot_methods;
+    std::set<uint16_t> startup_methods;
+    std::set<uint16_t> post_startup_methods;
+    // This also checks the dex file checksum, so that we do not compile methods from an
+    // older version of the app.
+    if (!cache_info.GetClassesAndMethods(*dex_file,
+                                         &class_types,
+                                         &hot_methods,
+                                         &startup_methods,
+                                         &post_startup_methods)) {
+      continue;
+    }
+    dex_cache.Assign(class_linker->FindDexCache(self, *dex_file));
+    CHECK(dex_cache != nullptr) << "Could not find dex cache for " << dex_file->GetLocation();
+    for (uint16_t method_idx : hot_methods) {
+      ArtMethod* method = class_linker->ResolveMethodWithoutInvokeType(
+          method_idx, dex_cache, class_loader);
+      if (method == nullptr) {
+        self->ClearException();
+        continue;
+      }
+      // Methods needing a class initialization check get compiled once they are hot, as
+      // we could not install their code before the class is initialized.
+      if (!method->IsCompilable() ||
+          !method->IsInvokable() ||
+          method->IsNative() ||
+          NeedsClinitCheckBeforeCall(method) ||
+          GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+        continue;
+      }
+      thread_pool_->AddTask(self,
+                            new JitCompileTask(method,
+                                               JitCompileTask::TaskKind::kPreCompile,
+                                               CompilationKind::kOptimized));
+      ++added_to_queue;
+    }
+  }
+  return added_to_queue;
+}
+
+// Add the methods that currently have optimized JIT code to `cache_info`.
+static bool AddOptimizedMethodsToCache(Thread* self,
+                                       JitCodeCache* code_cache,
+                                       ProfileCompilationInfo* cache_info) {
+  ScopedObjectAccess soa(self);
+  std::vector<MethodReference> methods;
+  code_cache->GetOptimizedMethods(&methods);
+  for (const MethodReference& ref : methods) {
+    if (!cache_info->AddMethodsForDex(ProfileCompilationInfo::MethodHotness::kFlagHot,
+                                      ref.dex_file,
+                                      &ref.index,
+                                      &ref.index + 1)) {
+      LOG(WARNING) << "Could not add " << ref.PrettyMethod() << " to the JIT cache";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Write to a temporary file first, so that a concurrent launch of the app never reads
+// a partially written cache.
+static bool WriteJitCacheFile(ProfileCompilationInfo* cache_info, const std::string& cache_file) {
+  std::string temp_file = cache_file + ".tmp";
+  std::unique_ptr<File> file(OS::CreateEmptyFileWriteOnly(temp_file.c_str()));
+  if (file == nullptr) {
+    PLOG(WARNING) << "Could not create " << temp_file;
+    return false;
+  }
+  if (!cache_info->Save(file->Fd())) {
+    LOG(WARNING) << "Could not write JIT cache " << temp_file;
+    file->Erase(/*unlink=*/ true);
+    return false;
+  }
+  if (file->FlushCloseOrErase() != 0 || rename(temp_file.c_str(), cache_file.c_str()) != 0) {
+    PLOG(WARNING) << "Could not save JIT cache " << cache_file;
+    unlink(temp_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+void Jit::SavePersistentCache(Thread* self) {
+  const std::string& cache_file = options_->GetPersistentCachePath();
+  if (cache_file.empty()) {
+    return;
+  }
+  ProfileCompilationInfo cache_info;
+  if (!AddOptimizedMethodsToCache(self, GetCodeCache(), &cache_info) ||
+      cache_info.GetNumberOfMethods() == 0u) {
+    return;
+  }
+  if (WriteJitCacheFile(&cache_info, cache_file)) {
+    VLOG(jit) << "Saved " << cache_info.GetNumberOfMethods() << " methods to " << cache_file;
   }
 }
 
+void Jit::PublishSharedCache(Thread* self) {
+  const std::string& cache_file = options_->GetSharedCachePath();
+  if (cache_file.empty()) {
+    return;
+  }
+  // Serialize the processes of the app publishing at the same time, so that none of them
+  // drops the methods another one just published. Readers do not take the lock, as the
+  // file is replaced atomically.
+  std::string error_msg;
+  ScopedFlock lock = LockedFile::Open((cache_file + ".lock").c_str(), &error_msg);
+  if (lock == nullptr) {
+    LOG(WARNING) << "Could not lock shared JIT cache " << cache_file << ": " << error_msg;
+    return;
+  }
+  ProfileCompilationInfo cache_info;
+  if (OS::FileExists(cache_file.c_str())) {
+    unix_file::FdFile file(cache_file.c_str(), O_RDONLY, /*check_usage=*/ false);
+    ProfileCompilationInfo published_info;
+    if (file.Fd() != -1 && published_info.Load(file.Fd())) {
+      cache_info.MergeWith(published_info);
+    } else {
+      // Overwrite an unreadable file with our own methods.
+      LOG(WARNING) << "Could not load shared JIT cache " << cache_file;
+    }
+  }
+  uint32_t published_methods = cache_info.GetNumberOfMethods();
+  if (!AddOptimizedMethodsToCache(self, GetCodeCache(), &cache_info)) {
+    return;
+  }
+  uint32_t merged_methods = cache_info.GetNumberOfMethods();
+  if (merged_methods != published_methods && !WriteJitCacheFile(&cache_info, cache_file)) {
+    return;
+  }
+  lock.reset();
+
+  bool siblings_published;
+  std::vector<std::pair<std::vector<const DexFile*>, jweak>> loaders;
+  {
+    MutexLock mu(self, shared_cache_lock_);
+    siblings_published = published_methods > shared_cache_methods_;
+    shared_cache_methods_ = merged_methods;
+    if (siblings_published) {
+      loaders = shared_cache_loaders_;
+    }
+  }
+  VLOG(jit) << "Published " << (merged_methods - published_methods) << " methods to "
+            << cache_file;
+  if (!siblings_published) {
+    return;
+  }
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::ClassLoader> loader = hs.NewHandle<mirror::ClassLoader>(nullptr);
+  uint32_t added_to_queue = 0u;
+  for (const auto& [dex_files, weak_loader] : loaders) {
+    loader.Assign(ObjPtr<mirror::ClassLoader>::DownCast(
+        soa.Vm()->DecodeWeakGlobal(self, weak_loader)));
+    if (loader == nullptr) {
+      // The class loader and its dex files were unloaded.
+      continue;
+    }
+    added_to_queue += CompileMethodsFromPersistentCache(self, dex_files, cache_file, loader);
+  }
+  VLOG(jit) << "Added " << added_to_queue << " methods published by other processes to "
+            << cache_file;
+}
+
 bool Jit::CompileMethodFromProfile(Thread* self,
                                    ClassLinker* class_linker,
                                    uint32_t method_idx,
@@ -1565,13 +2004,44 @@ bool Jit::MaybeCompileMethod(Thread* self,
     }
   }
   if (UseJitCompilation()) {
-    if (old_count < HotMethodThreshold() && new_count >= HotMethodThreshold()) {
+    bool compile = false;
+    if (options_->UseTieredJitCompilation()) {
+      // Baseline compilation is cheap, so compile warm methods right away while the compiler
+      // threads are idle; this gets startup code out of the interpreter sooner. Under load,
+      // wait for the hot threshold, and once the queue is deep, defer to one later sample.
+      const size_t queue_depth = GetCompileQueueDepth(self);
+      if (old_count < WarmMethodThreshold() && new_count >= WarmMethodThreshold()) {
+        compile |= !method->IsNative() && queue_depth <= kJitShallowQueueDepth;
+      }
+      if (old_count < HotMethodThreshold() && new_count >= HotMethodThreshold()) {
+        compile |= queue_depth < kJitDeepQueueDepth;
+        if (!compile) {
+          VLOG(jit) << "Deferring compilation of " << method->PrettyMethod()
+                    << ", compile queue depth " << queue_depth;
+        }
+      }
+      if (old_count < DeferredHotMethodThreshold() && new_count >= DeferredHotMethodThreshold()) {
+        compile = true;
+      }
+    } else {
+      compile = old_count < HotMethodThreshold() && new_count >= HotMethodThreshold();
+    }
+    if (compile) {
       if (!code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
         DCHECK(thread_pool_ != nullptr);
         CompilationKind compilation_kind =
             (options_->UseTieredJitCompilation() || options_->UseBaselineCompiler())
                 ? CompilationKind::kBaseline
                 : CompilationKind::kOptimized;
+        if (compilation_kind == CompilationKind::kOptimized &&
+            with_backedges &&
+            !code_cache_->IsOsrCompiled(method)) {
+          // The method became hot in a loop that the interpreter is still running. Compile it
+          // with OSR entries at its loop headers, so that the same body serves both as the
+          // entry point and for jumping out of the interpreter, and no separate OSR compilation
+          // is needed when the loop reaches the OSR threshold.
+          compilation_kind = CompilationKind::kOsr;
+        }
         thread_pool_->AddTask(
             self,
             new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, compilation_kind));
@@ -1593,6 +2063,47 @@ bool Jit::MaybeCompileMethod(Thread* self,
   return true;
 }
 
+size_t Jit::GetThreadPoolSize() const {
+  if (Runtime::Current()->IsZygote()) {
+    // The zygote compiles its profile in order and forks in-between compilations, keep
+    // a single thread there. Children get their own thread count after the fork.
+    return 1u;
+  }
+  size_t count = options_->GetThreadPoolThreadCount();
+  if (count == 0u) {
+    count = std::thread::hardware_concurrency() / kJitCoresPerPoolThread;
+  }
+  return std::clamp(count, static_cast<size_t>(1u), kJitMaxPoolThreads);
+}
+
+void Jit::UpdateProcessState(ProcessState process_state) {
+  if (thread_pool_ == nullptr) {
+    return;
+  }
+  if (process_state == kProcessStateJankImperceptible &&
+      !options_->GetPersistentCachePath().empty() &&
+      !Runtime::Current()->IsZygote()) {
+    // The app may be killed while in the background, so this is the last good chance to
+    // record what we compiled.
+    thread_pool_->AddTask(Thread::Current(), new JitSavePersistentCacheTask());
+  }
+  if (process_state == kProcessStateJankImperceptible &&
+      !options_->GetSharedCachePath().empty() &&
+      !Runtime::Current()->IsZygote()) {
+    thread_pool_->AddTask(Thread::Current(), new JitPublishSharedCacheTask());
+  }
+  if (thread_pool_->GetThreadCount() <= 1u) {
+    return;
+  }
+  thread_pool_->SetMaxActiveWorkers(
+      process_state == kProcessStateJankPerceptible ? thread_pool_->GetThreadCount() : 1u);
+}
+
+size_t Jit::GetCompileQueueDepth(Thread* self) {
+  DCHECK(thread_pool_ != nullptr);
+  return thread_pool_->GetTaskCount(self);
+}
+
 void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   if (thread_pool_ == nullptr) {
     return;
@@ -1601,6 +2112,12 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   // hotness threshold. If tiered compilation is enabled, enqueue a compilation
   // task that will compile optimize the method.
   if (options_->UseTieredJitCompilation()) {
+    if (GetCompileQueueDepth(self) >= kJitDeepQueueDepth) {
+      // The baseline code keeps filling the inline caches, and will call us again
+      // the next time its hotness counter wraps around.
+      VLOG(jit) << "Deferring optimized compilation of " << method->PrettyMethod();
+      return;
+    }
     thread_pool_->AddTask(
         self,
         new JitCompileTask(method,
@@ -1813,6 +2330,9 @@ void Jit::PostZygoteFork() {
     NotifyZygoteCompilationDone();
     CHECK(code_cache_->GetZygoteMap()->IsCompilationNotified());
   }
+  if (!Runtime::Current()->IsZygote()) {
+    thread_pool_->SetThreadCount(GetThreadPoolSize());
+  }
   thread_pool_->CreateThreads();
   thread_pool_->SetPthreadPriority(options_->GetThreadPoolPthreadPriority());
 }
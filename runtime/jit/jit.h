@@ -29,8 +29,10 @@
 #include "offsets.h"
 #include "interpreter/mterp/nterp.h"
 #include "jit/debugger_interface.h"
+#include "jit/jit_stats.h"
 #include "jit/profile_saver_options.h"
 #include "obj_ptr.h"
+#include "process_state.h"
 #include "thread_pool.h"
 
 namespace art {
@@ -61,9 +63,21 @@ static constexpr int16_t kJitHotnessDisabled = -2;
 // At what priority to schedule jit threads. 9 is the lowest foreground priority on device.
 // See android/os/Process.java.
 static constexpr int kJitPoolThreadPthreadDefaultPriority = 9;
+// Upper bound on the number of JIT compiler threads. Each thread has its own arena memory
+// budget for a compilation, so this also bounds the peak memory used by the compiler.
+static constexpr size_t kJitMaxPoolThreads = 4;
+// When picking the number of JIT compiler threads from the number of cores, use one thread
+// for this many cores.
+static constexpr size_t kJitCoresPerPoolThread = 4;
 // We check whether to jit-compile the method every Nth invoke.
 // The tests often use threshold of 1000 (and thus 500 to start profiling).
 static constexpr uint32_t kJitSamplesBatchSize = 512;  // Must be power of 2.
+// With tiered compilation, the depth of the compile queue decides how eagerly we compile:
+// while at most `kJitShallowQueueDepth` tasks are pending, warm methods are already compiled
+// baseline, and once `kJitDeepQueueDepth` tasks are pending, new requests are deferred to a
+// later sample so that the compiler threads can catch up with the hottest methods first.
+static constexpr size_t kJitShallowQueueDepth = 2;
+static constexpr size_t kJitDeepQueueDepth = 32;
 
 class JitOptions {
  public:
@@ -113,6 +127,38 @@ class JitOptions {
     return thread_pool_pthread_priority_;
   }
 
+  // Number of JIT compiler threads requested on the command line, or 0 to pick it from the
+  // number of cores.
+  size_t GetThreadPoolThreadCount() const {
+    return thread_pool_thread_count_;
+  }
+
+  // File listing the methods the previous runs of the app had optimized JIT code for, or
+  // empty if the persistent JIT cache is disabled.
+  const std::string& GetPersistentCachePath() const {
+    return persistent_cache_path_;
+  }
+
+  // File through which the processes of an app running under the same UID share the methods
+  // they have optimized JIT code for, or empty if sharing is disabled. Each process compiles
+  // the methods its siblings published, as JIT code itself refers to process-local ArtMethods
+  // and roots and cannot be mapped into another process.
+  const std::string& GetSharedCachePath() const {
+    return shared_cache_path_;
+  }
+
+  // Number of committed methods whose entry points are published together, after a single
+  // flush of the instruction pipelines. 0 or 1 publishes every method as soon as it is committed.
+  size_t GetCommitBatchSize() const {
+    return commit_batch_size_;
+  }
+
+  // Whether to fill the .bss slots of newly loaded oat files in the background for the types
+  // and strings that are already loaded or interned.
+  bool PrefillBss() const {
+    return prefill_bss_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -169,6 +215,11 @@ class JitOptions {
   uint16_t invoke_transition_weight_;
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
+  size_t thread_pool_thread_count_;
+  std::string persistent_cache_path_;
+  std::string shared_cache_path_;
+  size_t commit_batch_size_;
+  bool prefill_bss_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
@@ -183,7 +234,10 @@ class JitOptions {
         priority_thread_weight_(0),
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
-        thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority) {}
+        thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
+        thread_pool_thread_count_(0),
+        commit_batch_size_(0),
+        prefill_bss_(false) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -261,11 +315,20 @@ class Jit {
 
   void CreateThreadPool();
   void DeleteThreadPool();
+
+  // Use fewer compiler threads while the process is not in a jank perceptible state, and
+  // save the persistent JIT cache when the process goes to the background.
+  void UpdateProcessState(ProcessState process_state);
   void WaitForWorkersToBeCreated();
 
   // Dump interesting info: #methods compiled, code vs data size, compile / verify cumulative
   // loggers.
   void DumpInfo(std::ostream& os) REQUIRES(!lock_);
+  // Dump the structured statistics returned by VMDebug.getRuntimeStat(), see JitStats.
+  void DumpStats(std::ostream& os);
+  JitStats* GetStats() {
+    return &stats_;
+  }
   // Add a timing logger to cumulative_timings_.
   void AddTimingLogger(const TimingLogger& logger);
 
@@ -425,6 +488,23 @@ class Jit {
                                          Handle<mirror::ClassLoader> class_loader,
                                          bool add_to_queue);
 
+  // Queue optimized compilations of the methods of `dex_files` listed in the persistent JIT
+  // cache file. Entries for dex files with a different checksum are ignored.
+  // Return the number of methods added to the queue.
+  uint32_t CompileMethodsFromPersistentCache(Thread* self,
+                                             const std::vector<const DexFile*>& dex_files,
+                                             const std::string& cache_file,
+                                             Handle<mirror::ClassLoader> class_loader);
+
+  // Write the methods that currently have optimized JIT code to the persistent JIT cache
+  // file, replacing its previous content.
+  void SavePersistentCache(Thread* self);
+
+  // Merge the methods that currently have optimized JIT code into the shared JIT cache file
+  // of the app, and queue compilations of the methods sibling processes published since the
+  // last call.
+  void PublishSharedCache(Thread* self);
+
   // Register the dex files to the JIT. This is to perform any compilation/optimization
   // at the point of loading the dex files.
   void RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
@@ -448,7 +528,8 @@ class Jit {
   // class path methods.
   void NotifyZygoteCompilationDone();
 
-  void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self);
+  void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   void EnqueueCompilationFromNterp(ArtMethod* method, Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -471,6 +552,18 @@ class Jit {
                                 bool compile_after_boot)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Number of compilation tasks waiting for a compiler thread.
+  size_t GetCompileQueueDepth(Thread* self);
+
+  // Number of compiler threads to use in this process.
+  size_t GetThreadPoolSize() const;
+
+  // With tiered compilation, the sample count past the hot threshold at which we retry a
+  // compilation that was deferred because the compile queue was deep.
+  uint32_t DeferredHotMethodThreshold() const {
+    return (static_cast<uint32_t>(HotMethodThreshold()) + OSRMethodThreshold()) / 2;
+  }
+
   // Compile the method if the number of samples passes a threshold.
   // Returns false if we can not compile now - don't increment the counter and retry later.
   bool MaybeCompileMethod(Thread* self,
@@ -482,6 +575,11 @@ class Jit {
 
   static bool BindCompilerMethods(std::string* error_msg);
 
+  // Called after each successful optimized compilation. Publishes to the shared JIT cache
+  // every few compilations, so that sibling processes can pick up
+  // hot methods while this process keeps running.
+  void MaybePublishSharedCache(Thread* self);
+
   // JIT compiler
   static void* jit_library_handle_;
   static JitCompilerInterface* jit_compiler_;
@@ -495,6 +593,16 @@ class Jit {
   std::unique_ptr<ThreadPool> thread_pool_;
   std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_;
 
+  // Dex files and weak class loader references registered while the shared JIT cache is
+  // enabled, so that methods published later by sibling processes can be resolved.
+  Mutex shared_cache_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<std::pair<std::vector<const DexFile*>, jweak>> shared_cache_loaders_
+      GUARDED_BY(shared_cache_lock_);
+  // Number of methods in the shared JIT cache file after our last publication.
+  uint32_t shared_cache_methods_ GUARDED_BY(shared_cache_lock_) = 0u;
+  // Number of optimized compilations since the last publication to the shared JIT cache.
+  std::atomic<uint32_t> optimized_since_publish_ = 0u;
+
   Mutex boot_completed_lock_;
   bool boot_completed_ GUARDED_BY(boot_completed_lock_) = false;
   std::deque<Task*> tasks_after_boot_ GUARDED_BY(boot_completed_lock_);
@@ -503,6 +611,7 @@ class Jit {
   CumulativeLogger cumulative_timings_;
   Histogram<uint64_t> memory_use_ GUARDED_BY(lock_);
   Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  JitStats stats_;
 
   // In the JIT zygote configuration, after all compilation is done, the zygote
   // will copy its contents of the boot image to the zygote_mapping_methods_,
@@ -16,6 +16,7 @@
 
 #include "jit_code_cache.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <android-base/logging.h>
@@ -55,6 +56,7 @@
 #include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack.h"
+#include "stack_trace_frame_cache.h"
 #include "thread-current-inl.h"
 #include "thread_list.h"
 
@@ -266,16 +268,29 @@ JitCodeCache::JitCodeCache()
       lock_cond_("Jit code cache condition variable", *Locks::jit_lock_),
       collection_in_progress_(false),
       last_collection_increased_code_cache_(false),
+      code_index_(nullptr),
+      code_index_is_stale_(false),
+      sync_cores_lock_("Jit sync cores lock", kGenericBottomLock),
+      sync_cores_requests_(0u),
+      sync_cores_done_(0u),
+      next_pending_commit_sequence_(0u),
       garbage_collect_code_(true),
       number_of_compilations_(0),
       number_of_osr_compilations_(0),
       number_of_collections_(0),
+      recompilations_since_last_collection_(0),
+      total_recompilations_after_collection_(0),
       histogram_stack_map_memory_use_("Memory used for stack maps", 16),
       histogram_code_memory_use_("Memory used for compiled code", 16),
       histogram_profiling_info_memory_use_("Memory used for profiling info", 16) {
 }
 
-JitCodeCache::~JitCodeCache() {}
+JitCodeCache::~JitCodeCache() {
+  delete code_index_.load(std::memory_order_relaxed);
+  for (const CodeIndex* index : retired_code_indexes_) {
+    delete index;
+  }
+}
 
 bool JitCodeCache::PrivateRegionContainsPc(const void* ptr) const {
   return private_region_.IsInExecSpace(ptr);
@@ -457,12 +472,24 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
       }
     }
   }
-  // Walk over inline caches to clear entries containing unloaded classes.
+  // Walk over inline and type check caches to clear entries containing unloaded classes.
   for (ProfilingInfo* info : profiling_infos_) {
     for (size_t i = 0; i < info->number_of_inline_caches_; ++i) {
       InlineCache* cache = &info->cache_[i];
       for (size_t j = 0; j < InlineCache::kIndividualCacheSize; ++j) {
         Runtime::ProcessWeakClass(&cache->classes_[j], visitor, nullptr);
+        if (cache->classes_[j].IsNull()) {
+          cache->counts_[j] = 0u;
+        }
+      }
+    }
+    TypeCheckCache* type_check_caches = info->GetTypeCheckCaches();
+    for (size_t i = 0; i < info->number_of_type_check_caches_; ++i) {
+      TypeCheckCache* cache = &type_check_caches[i];
+      Runtime::ProcessWeakClass(&cache->class_, visitor, nullptr);
+      if (cache->class_.IsNull()) {
+        cache->hits_ = 0u;
+        cache->misses_ = 0u;
       }
     }
   }
@@ -479,6 +506,8 @@ void JitCodeCache::FreeCodeAndData(const void* code_ptr) {
     data = GetRootTable(code_ptr);
   }  // else this is a JNI stub without any data.
 
+  // The memory may be reused for other code, drop the stack trace frames decoded from it.
+  StackTraceFrameCache::InvalidateAll();
   FreeLocked(&private_region_, reinterpret_cast<uint8_t*>(allocation), data);
 }
 
@@ -551,7 +580,23 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
         if (alloc.ContainsUnsafe(it->second)) {
           method_headers.insert(OatQuickMethodHeader::FromCodePointer(it->first));
           VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
+          RemoveCodeAge(it->first);
           it = method_code_map_.erase(it);
+          InvalidateCodeIndex();
+        } else {
+          ++it;
+        }
+      }
+      for (auto it = methods_collected_last_.begin(); it != methods_collected_last_.end();) {
+        if (alloc.ContainsUnsafe(*it)) {
+          it = methods_collected_last_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      for (auto it = pending_commits_.begin(); it != pending_commits_.end();) {
+        if (alloc.ContainsUnsafe(it->method)) {
+          it = pending_commits_.erase(it);
         } else {
           ++it;
         }
@@ -615,7 +660,8 @@ void JitCodeCache::DisallowInlineCacheAccess() {
 }
 
 void JitCodeCache::CopyInlineCacheInto(const InlineCache& ic,
-                                       Handle<mirror::ObjectArray<mirror::Class>> array) {
+                                       Handle<mirror::ObjectArray<mirror::Class>> array,
+                                       /*out*/ uint32_t* counts) {
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
@@ -624,6 +670,9 @@ void JitCodeCache::CopyInlineCacheInto(const InlineCache& ic,
        ++in_cache) {
     mirror::Class* object = ic.classes_[in_cache].Read();
     if (object != nullptr) {
+      if (counts != nullptr) {
+        counts[in_array] = ic.counts_[in_cache];
+      }
       array->Set(in_array++, object);
     }
   }
@@ -654,6 +703,29 @@ void JitCodeCache::WaitForPotentialCollectionToCompleteRunnable(Thread* self) {
   }
 }
 
+void JitCodeCache::SyncCores(Thread* self) {
+  // Ensure CPU instruction pipelines are flushed for all cores. This is necessary for
+  // correctness as code may still be in instruction pipelines despite the i-cache flush. It is
+  // not safe to assume that changing permissions with mprotect (RX->RWX->RX) will cause a TLB
+  // shootdown (incidentally invalidating the CPU pipelines by sending an IPI to all cores to
+  // notify them of the TLB invalidation). Some architectures, notably ARM and ARM64, have
+  // hardware support that broadcasts TLB invalidations and so their kernels have no software
+  // based TLB shootdown. The sync-core flavor of membarrier was introduced in Linux 4.16 to
+  // address this (see mbarrier(2)). The membarrier here will fail on prior kernels and on
+  // platforms lacking the appropriate support.
+  //
+  // The membarrier interrupts all cores, so concurrent callers share one: a caller takes a
+  // ticket once its code is written, and any membarrier issued after that covers its code.
+  uint64_t ticket = sync_cores_requests_.fetch_add(1u, std::memory_order_seq_cst) + 1u;
+  MutexLock mu(self, sync_cores_lock_);
+  if (sync_cores_done_ >= ticket) {
+    return;
+  }
+  uint64_t covered = sync_cores_requests_.load(std::memory_order_seq_cst);
+  art::membarrier(art::MembarrierCommand::kPrivateExpeditedSyncCore);
+  sync_cores_done_ = covered;
+}
+
 bool JitCodeCache::Commit(Thread* self,
                           JitMemoryRegion* region,
                           ArtMethod* method,
@@ -679,15 +751,37 @@ bool JitCodeCache::Commit(Thread* self,
   size_t root_table_size = ComputeRootTableSize(roots.size());
   const uint8_t* stack_map_data = roots_data + root_table_size;
 
+  // Code that does not depend on CHA can be published later, with the rest of its batch.
+  const bool defer_publication =
+      Runtime::Current()->GetJITOptions()->GetCommitBatchSize() > 1u &&
+      !method->IsNative() &&
+      compilation_kind != CompilationKind::kOsr &&
+      cha_single_implementation_list.empty();
+
+  const uint8_t* code_ptr = nullptr;
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    // We need to make sure that there will be no jit-gcs going on and wait for any ongoing one
+    // to finish.
+    WaitForPotentialCollectionToCompleteRunnable(self);
+    code_ptr = region->CommitCode(
+        reserved_code, code, stack_map_data, has_should_deoptimize_flag);
+    if (code_ptr == nullptr) {
+      return false;
+    }
+  }
+
+  // The code is not reachable until it is added to the maps below, so we can flush the
+  // instruction pipelines without holding the lock, and share the flush with other
+  // compiler threads committing at the same time. Deferred code is flushed when published.
+  if (!defer_publication) {
+    SyncCores(self);
+  }
+
   MutexLock mu(self, *Locks::jit_lock_);
-  // We need to make sure that there will be no jit-gcs going on and wait for any ongoing one to
-  // finish.
+  // A collection may have started while we were not holding the lock. It cannot free our
+  // code, which is not in the maps yet, but we must not add code while it runs.
   WaitForPotentialCollectionToCompleteRunnable(self);
-  const uint8_t* code_ptr = region->CommitCode(
-      reserved_code, code, stack_map_data, has_should_deoptimize_flag);
-  if (code_ptr == nullptr) {
-    return false;
-  }
   OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
 
   // Commit roots and stack maps before updating the entry point.
@@ -749,10 +843,27 @@ bool JitCodeCache::Commit(Thread* self,
         zygote_map_.Put(code_ptr, method);
       } else {
         method_code_map_.Put(code_ptr, method);
+        code_index_is_stale_ = true;
+        if (methods_collected_last_.erase(method) != 0u) {
+          ++recompilations_since_last_collection_;
+          ++total_recompilations_after_collection_;
+        }
       }
       if (compilation_kind == CompilationKind::kOsr) {
         number_of_osr_compilations_++;
         osr_code_map_.Put(method, code_ptr);
+        // OSR code is a complete optimized body that can also be entered normally. Use it as
+        // the entry point unless the method already has optimized code.
+        const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+        bool has_optimized_code = ContainsPc(entry_point) &&
+            !CodeInfo::IsBaseline(
+                OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr());
+        if (!has_optimized_code &&
+            (!NeedsClinitCheckBeforeCall(method) ||
+             method->GetDeclaringClass()->IsVisiblyInitialized())) {
+          Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
+              method, method_header->GetEntryPoint());
+        }
       } else if (NeedsClinitCheckBeforeCall(method) &&
                  !method->GetDeclaringClass()->IsVisiblyInitialized()) {
         // This situation currently only occurs in the jit-zygote mode.
@@ -763,6 +874,9 @@ bool JitCodeCache::Commit(Thread* self,
         if (!IsSharedRegion(*region)) {
           saved_compiled_methods_map_.Put(method, code_ptr);
         }
+      } else if (defer_publication) {
+        pending_commits_.push_back(
+            PendingCommit{method, code_ptr, next_pending_commit_sequence_++});
       } else {
         Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
             method, method_header->GetEntryPoint());
@@ -786,6 +900,49 @@ bool JitCodeCache::Commit(Thread* self,
   return true;
 }
 
+void JitCodeCache::PublishPendingCommits(Thread* self, bool force) {
+  uint64_t sequence;
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    if (pending_commits_.empty() ||
+        (!force &&
+         pending_commits_.size() < Runtime::Current()->GetJITOptions()->GetCommitBatchSize())) {
+      return;
+    }
+    sequence = next_pending_commit_sequence_;
+  }
+
+  // The code of every commit numbered below `sequence` is written, so one flush covers it all.
+  SyncCores(self);
+
+  MutexLock mu(self, *Locks::jit_lock_);
+  WaitForPotentialCollectionToCompleteRunnable(self);
+  instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+  size_t kept = 0u;
+  for (size_t i = 0; i != pending_commits_.size(); ++i) {
+    const PendingCommit& commit = pending_commits_[i];
+    if (commit.sequence >= sequence) {
+      // Committed after we read `sequence`, so not covered by the flush above.
+      pending_commits_[kept++] = commit;
+      continue;
+    }
+    const OatQuickMethodHeader* method_header =
+        OatQuickMethodHeader::FromCodePointer(commit.code_ptr);
+    instrumentation->UpdateMethodsCode(commit.method, method_header->GetEntryPoint());
+  }
+  VLOG(jit) << "JIT published " << (pending_commits_.size() - kept) << " methods";
+  pending_commits_.resize(kept);
+}
+
+bool JitCodeCache::IsPendingCommit(ArtMethod* method) {
+  for (const PendingCommit& commit : pending_commits_) {
+    if (commit.method == method) {
+      return true;
+    }
+  }
+  return false;
+}
+
 size_t JitCodeCache::CodeCacheSize() {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   return CodeCacheSizeLocked();
@@ -847,7 +1004,9 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
           FreeCodeAndData(it->first);
         }
         VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
+        RemoveCodeAge(it->first);
         it = method_code_map_.erase(it);
+        InvalidateCodeIndex();
       } else {
         ++it;
       }
@@ -857,6 +1016,11 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
     if (osr_it != osr_code_map_.end()) {
       osr_code_map_.erase(osr_it);
     }
+    pending_commits_.erase(
+        std::remove_if(pending_commits_.begin(),
+                       pending_commits_.end(),
+                       [method](const PendingCommit& commit) { return commit.method == method; }),
+        pending_commits_.end());
   }
 
   return in_cache;
@@ -903,6 +1067,7 @@ void JitCodeCache::MoveObsoleteMethod(ArtMethod* old_method, ArtMethod* new_meth
   for (auto& it : method_code_map_) {
     if (it.second == old_method) {
       it.second = new_method;
+      InvalidateCodeIndex();
     }
   }
   // Update osr_code_map_ to point to the new method.
@@ -911,6 +1076,11 @@ void JitCodeCache::MoveObsoleteMethod(ArtMethod* old_method, ArtMethod* new_meth
     osr_code_map_.Put(new_method, code_map->second);
     osr_code_map_.erase(old_method);
   }
+  for (PendingCommit& commit : pending_commits_) {
+    if (commit.method == old_method) {
+      commit.method = new_method;
+    }
+  }
 }
 
 void JitCodeCache::TransitionToDebuggable() {
@@ -928,6 +1098,8 @@ void JitCodeCache::TransitionToDebuggable() {
     }
     // Not strictly necessary, but this map is useless now.
     saved_compiled_methods_map_.clear();
+    // The pending code was compiled for a non-debuggable runtime, do not publish it.
+    pending_commits_.clear();
   }
   if (kIsDebugBuild) {
     for (const auto& entry : zygote_map_) {
@@ -1126,6 +1298,12 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
       return;
     } else {
       number_of_collections_++;
+      if (number_of_collections_ > 1u) {
+        VLOG(jit) << "Methods compiled again since the last code cache collection: "
+                  << recompilations_since_last_collection_;
+      }
+      recompilations_since_last_collection_ = 0u;
+      methods_collected_last_.clear();
       live_bitmap_.reset(CodeCacheBitmap::Create(
           "code-cache-bitmap",
           reinterpret_cast<uintptr_t>(private_region_.GetExecPages()->Begin()),
@@ -1160,6 +1338,11 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
     {
       MutexLock mu(self, *Locks::jit_lock_);
 
+      // Only full collections check the liveness of compiled code, so only they age it.
+      if (do_full_collection) {
+        AgeSurvivingCode();
+      }
+
       // Increase the code cache only when we do partial collections.
       // TODO: base this strategy on how full the code cache is?
       if (do_full_collection) {
@@ -1183,7 +1366,9 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
           // interpreter will update its entry point to the compiled code and call it.
           for (ProfilingInfo* info : profiling_infos_) {
             const void* entry_point = info->GetMethod()->GetEntryPointFromQuickCompiledCode();
-            if (!IsInZygoteDataSpace(info) && ContainsPc(entry_point)) {
+            if (!IsInZygoteDataSpace(info) &&
+                ContainsPc(entry_point) &&
+                !IsTenured(OatQuickMethodHeader::FromEntryPoint(entry_point)->GetCode())) {
               info->SetSavedEntryPoint(entry_point);
               // Don't call Instrumentation::UpdateMethodsCode(), as it can check the declaring
               // class of the method. We may be concurrently running a GC which makes accessing
@@ -1249,13 +1434,36 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         OatQuickMethodHeader* header = OatQuickMethodHeader::FromCodePointer(code_ptr);
         method_headers.insert(header);
         VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
+        RemoveCodeAge(code_ptr);
+        methods_collected_last_.insert(it->second);
         it = method_code_map_.erase(it);
+        InvalidateCodeIndex();
       }
     }
   }
   FreeAllMethodHeaders(method_headers);
 }
 
+bool JitCodeCache::IsTenured(const void* code_ptr) const {
+  auto it = code_survived_collections_.find(code_ptr);
+  return it != code_survived_collections_.end() && it->second >= kTenureCollections;
+}
+
+void JitCodeCache::AgeSurvivingCode() {
+  for (const auto& entry : method_code_map_) {
+    const void* code_ptr = entry.first;
+    if (IsInZygoteExecSpace(code_ptr)) {
+      continue;
+    }
+    auto it = code_survived_collections_.find(code_ptr);
+    if (it == code_survived_collections_.end()) {
+      code_survived_collections_.Put(code_ptr, 1u);
+    } else if (it->second < kTenureCollections) {
+      ++it->second;
+    }
+  }
+}
+
 bool JitCodeCache::GetGarbageCollectCode() {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   return garbage_collect_code_;
@@ -1342,7 +1550,8 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
           if (ContainsPc(entry_point)) {
             OatQuickMethodHeader* method_header =
                 OatQuickMethodHeader::FromEntryPoint(entry_point);
-            if (CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr())) {
+            if (CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr()) &&
+                !IsTenured(method_header->GetCode())) {
               info->GetMethod()->SetEntryPointFromQuickCompiledCode(GetQuickToInterpreterBridge());
             }
           }
@@ -1358,6 +1567,7 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
           const void* ptr = info->GetMethod()->GetEntryPointFromQuickCompiledCode();
           if (!ContainsPc(ptr) &&
               !IsMethodBeingCompiled(info->GetMethod()) &&
+              !IsPendingCommit(info->GetMethod()) &&
               !info->IsInUseByCompiler() &&
               !IsInZygoteDataSpace(info)) {
             info->GetMethod()->SetProfilingInfo(nullptr);
@@ -1409,15 +1619,39 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
         GetLiveBitmap()->AtomicTestAndSet(FromCodeToAllocation(code_ptr));
       }
     }
+    // Code waiting to be published is about to become an entrypoint.
+    for (const PendingCommit& commit : pending_commits_) {
+      GetLiveBitmap()->AtomicTestAndSet(FromCodeToAllocation(commit.code_ptr));
+    }
 
     // Empty osr method map, as osr compiled code will be deleted (except the ones
-    // on thread stacks).
-    osr_code_map_.clear();
+    // on thread stacks). OSR code that is also the entry point of its method stays.
+    for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
+      const OatQuickMethodHeader* method_header =
+          OatQuickMethodHeader::FromCodePointer(it->second);
+      if (method_header->GetEntryPoint() == it->first->GetEntryPointFromQuickCompiledCode()) {
+        ++it;
+      } else {
+        it = osr_code_map_.erase(it);
+      }
+    }
+  }
+
+  // Indexes retired so far can be deleted once every thread has gone through the
+  // checkpoint below, as lock-free lookups do not span suspend points.
+  std::vector<const CodeIndex*> retired_code_indexes;
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    retired_code_indexes.swap(retired_code_indexes_);
   }
 
   // Run a checkpoint on all threads to mark the JIT compiled code they are running.
   MarkCompiledCodeOnThreadStacks(self);
 
+  for (const CodeIndex* index : retired_code_indexes) {
+    delete index;
+  }
+
   // At this point, mutator threads are still running, and entrypoints of methods can
   // change. We do know they cannot change to a code cache entry that is not marked,
   // therefore we can safely remove those entries.
@@ -1464,7 +1698,15 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
     CHECK(method != nullptr);
   }
 
+  if (method == nullptr || LIKELY(!method->IsNative())) {
+    OatQuickMethodHeader* method_header = LookupCodeIndex(pc, method);
+    if (method_header != nullptr) {
+      return method_header;
+    }
+  }
+
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+  MaybeRebuildCodeIndex();
   OatQuickMethodHeader* method_header = nullptr;
   ArtMethod* found_method = nullptr;  // Only for DCHECK(), not for JNI stubs.
   if (method != nullptr && UNLIKELY(method->IsNative())) {
@@ -1518,6 +1760,97 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
   return method_header;
 }
 
+ArtMethod* JitCodeCache::LookupMethodForPc(uintptr_t pc) {
+  static_assert(kRuntimeISA != InstructionSet::kThumb2, "kThumb2 cannot be a runtime ISA");
+  if (kRuntimeISA == InstructionSet::kArm) {
+    // On Thumb-2, the pc is offset by one.
+    --pc;
+  }
+  if (!PrivateRegionContainsPc(reinterpret_cast<const void*>(pc))) {
+    return nullptr;
+  }
+  MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+  auto it = method_code_map_.lower_bound(reinterpret_cast<const void*>(pc));
+  if (it != method_code_map_.begin()) {
+    --it;
+    if (OatQuickMethodHeader::FromCodePointer(it->first)->Contains(pc)) {
+      return it->second;
+    }
+  }
+  for (auto&& entry : jni_stubs_map_) {
+    const JniStubData& data = entry.second;
+    if (data.IsCompiled() &&
+        OatQuickMethodHeader::FromCodePointer(data.GetCode())->Contains(pc)) {
+      DCHECK(!data.GetMethods().empty());
+      return data.GetMethods()[0];
+    }
+  }
+  return nullptr;
+}
+
+OatQuickMethodHeader* JitCodeCache::LookupCodeIndex(uintptr_t pc, ArtMethod* method) {
+  // Zygote compiled code is in a map that is never resized after the fork, and that
+  // supports concurrent readers.
+  if (method != nullptr &&
+      shared_region_.IsInExecSpace(reinterpret_cast<const void*>(pc)) &&
+      !Runtime::Current()->IsZygote()) {
+    const void* code_ptr = zygote_map_.GetCodeFor(method, pc);
+    if (code_ptr != nullptr) {
+      return OatQuickMethodHeader::FromCodePointer(code_ptr);
+    }
+  }
+  const CodeIndex* index = code_index_.load(std::memory_order_acquire);
+  if (index == nullptr) {
+    return nullptr;
+  }
+  auto it = std::upper_bound(
+      index->begin(),
+      index->end(),
+      reinterpret_cast<const void*>(pc),
+      [](const void* code_ptr, const std::pair<const void*, ArtMethod*>& entry) {
+        return code_ptr < entry.first;
+      });
+  if (it == index->begin()) {
+    return nullptr;
+  }
+  --it;
+  OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(it->first);
+  if (!method_header->Contains(pc)) {
+    return nullptr;
+  }
+  if (kIsDebugBuild && method != nullptr) {
+    DCHECK_EQ(it->second, method)
+        << ArtMethod::PrettyMethod(method) << " "
+        << ArtMethod::PrettyMethod(it->second) << " "
+        << std::hex << pc;
+  }
+  return method_header;
+}
+
+void JitCodeCache::InvalidateCodeIndex() {
+  const CodeIndex* index = code_index_.exchange(nullptr, std::memory_order_relaxed);
+  if (index != nullptr) {
+    retired_code_indexes_.push_back(index);
+  }
+}
+
+void JitCodeCache::MaybeRebuildCodeIndex() {
+  if (code_index_.load(std::memory_order_relaxed) != nullptr && !code_index_is_stale_) {
+    return;
+  }
+  if (retired_code_indexes_.size() >= kMaxRetiredCodeIndexes) {
+    // Keep using the locked lookup until the next collection deletes the retired indexes.
+    return;
+  }
+  // `method_code_map_` is sorted by code pointer, so is the index.
+  CodeIndex* index = new CodeIndex(method_code_map_.begin(), method_code_map_.end());
+  const CodeIndex* old_index = code_index_.exchange(index, std::memory_order_release);
+  if (old_index != nullptr) {
+    retired_code_indexes_.push_back(old_index);
+  }
+  code_index_is_stale_ = false;
+}
+
 OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   auto it = osr_code_map_.find(method);
@@ -1530,6 +1863,8 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
 ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
                                               ArtMethod* method,
                                               const std::vector<uint32_t>& entries,
+                                              const std::vector<uint32_t>& branch_entries,
+                                              const std::vector<uint32_t>& type_check_entries,
                                               bool retry_allocation)
     // No thread safety analysis as we are using TryLock/Unlock explicitly.
     NO_THREAD_SAFETY_ANALYSIS {
@@ -1539,29 +1874,35 @@ ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
     // If we are allocating for the interpreter, just try to lock, to avoid
     // lock contention with the JIT.
     if (Locks::jit_lock_->ExclusiveTryLock(self)) {
-      info = AddProfilingInfoInternal(self, method, entries);
+      info = AddProfilingInfoInternal(
+          self, method, entries, branch_entries, type_check_entries);
       Locks::jit_lock_->ExclusiveUnlock(self);
     }
   } else {
     {
       MutexLock mu(self, *Locks::jit_lock_);
-      info = AddProfilingInfoInternal(self, method, entries);
+      info = AddProfilingInfoInternal(
+          self, method, entries, branch_entries, type_check_entries);
     }
 
     if (info == nullptr) {
       GarbageCollectCache(self);
       MutexLock mu(self, *Locks::jit_lock_);
-      info = AddProfilingInfoInternal(self, method, entries);
+      info = AddProfilingInfoInternal(
+          self, method, entries, branch_entries, type_check_entries);
     }
   }
   return info;
 }
 
-ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNUSED,
-                                                      ArtMethod* method,
-                                                      const std::vector<uint32_t>& entries) {
+ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(
+    Thread* self ATTRIBUTE_UNUSED,
+    ArtMethod* method,
+    const std::vector<uint32_t>& entries,
+    const std::vector<uint32_t>& branch_entries,
+    const std::vector<uint32_t>& type_check_entries) {
   size_t profile_info_size = RoundUp(
-      sizeof(ProfilingInfo) + sizeof(InlineCache) * entries.size(),
+      ProfilingInfo::ComputeSize(entries.size(), branch_entries.size(), type_check_entries.size()),
       sizeof(void*));
 
   // Check whether some other thread has concurrently created it.
@@ -1575,7 +1916,8 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNU
     return nullptr;
   }
   uint8_t* writable_data = private_region_.GetWritableDataAddress(data);
-  info = new (writable_data) ProfilingInfo(method, entries);
+  info = new (writable_data)
+      ProfilingInfo(method, entries, branch_entries, type_check_entries);
 
   // Make sure other threads see the data in the profiling info object before the
   // store in the ArtMethod's ProfilingInfo pointer.
@@ -1677,6 +2019,23 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
   }
 }
 
+void JitCodeCache::GetOptimizedMethods(std::vector<MethodReference>* methods) {
+  MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+  for (const auto& it : method_code_map_) {
+    ArtMethod* method = it.second;
+    if (method->IsNative() ||
+        method->GetDeclaringClass()->IsBootStrapClassLoaded() ||
+        NeedsClinitCheckBeforeCall(method)) {
+      continue;
+    }
+    const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(it.first);
+    if (CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr())) {
+      continue;
+    }
+    methods->push_back(MethodReference(method->GetDexFile(), method->GetDexMethodIndex()));
+  }
+}
+
 bool JitCodeCache::IsOsrCompiled(ArtMethod* method) {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   return osr_code_map_.find(method) != osr_code_map_.end();
@@ -1783,6 +2142,19 @@ bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
     if (IsMethodBeingCompiled(method, compilation_kind)) {
       return false;
     }
+    if (compilation_kind != CompilationKind::kOsr) {
+      bool is_baseline = (compilation_kind == CompilationKind::kBaseline);
+      for (const PendingCommit& commit : pending_commits_) {
+        if (commit.method == method &&
+            CodeInfo::IsBaseline(OatQuickMethodHeader::FromCodePointer(commit.code_ptr)
+                                     ->GetOptimizedCodeInfoPtr()) == is_baseline) {
+          VLOG(jit) << "Not compiling " << method->PrettyMethod()
+                    << " because its compiled code is about to be published"
+                    << " kind=" << compilation_kind;
+          return false;
+        }
+      }
+    }
     AddMethodBeingCompiled(method, compilation_kind);
     return true;
   }
@@ -1844,6 +2216,7 @@ void JitCodeCache::InvalidateAllCompiledCode() {
     }
   }
   osr_code_map_.clear();
+  pending_commits_.clear();
   VLOG(jit) << "Invalidated the compiled code of " << (cnt - osr_size) << " methods and "
             << osr_size << " OSRs.";
 }
@@ -1869,7 +2242,9 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
     Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
         method, GetQuickToInterpreterBridge());
     ClearMethodCounter(method, /*was_warm=*/ profiling_info != nullptr);
-  } else {
+  }
+  {
+    // OSR code can also be the entry point, so check the OSR map in both cases.
     MutexLock mu(Thread::Current(), *Locks::jit_lock_);
     auto it = osr_code_map_.find(method);
     if (it != osr_code_map_.end() && OatQuickMethodHeader::FromCodePointer(it->second) == header) {
@@ -1885,6 +2260,16 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
   }
 }
 
+void JitCodeCache::DumpStats(std::ostream& os) {
+  MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+  os << "jit_code_cache code_used_bytes=" << GetCurrentRegion()->GetUsedMemoryForCode()
+     << " data_used_bytes=" << GetCurrentRegion()->GetUsedMemoryForData()
+     << " capacity_bytes=" << GetCurrentRegion()->GetCurrentCapacity()
+     << " max_capacity_bytes=" << GetCurrentRegion()->GetMaxCapacity()
+     << " entries=" << method_code_map_.size()
+     << " collections=" << number_of_collections_ << "\n";
+}
+
 void JitCodeCache::Dump(std::ostream& os) {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   os << "Current JIT code cache size (used / resident): "
@@ -1908,7 +2293,16 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Total number of JIT compilations: " << number_of_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
         << number_of_osr_compilations_ << "\n"
-     << "Total number of JIT code cache collections: " << number_of_collections_ << std::endl;
+     << "Total number of JIT code cache collections: " << number_of_collections_ << "\n"
+     << "Current number of tenured JIT code cache entries: "
+        << std::count_if(code_survived_collections_.begin(),
+                         code_survived_collections_.end(),
+                         [](const auto& entry) { return entry.second >= kTenureCollections; })
+        << "\n"
+     << "Methods compiled again since the last JIT code cache collection: "
+        << recompilations_since_last_collection_ << "\n"
+     << "Total number of methods compiled again after a JIT code cache collection: "
+        << total_recompilations_after_collection_ << std::endl;
   histogram_stack_map_memory_use_.PrintMemoryUse(os);
   histogram_code_memory_use_.PrintMemoryUse(os);
   histogram_profiling_info_memory_use_.PrintMemoryUse(os);
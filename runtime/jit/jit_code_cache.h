@@ -43,6 +43,7 @@ class LinearAlloc;
 class InlineCache;
 class IsMarkedVisitor;
 class JitJniStubTestHelper;
+class MethodReference;
 class OatQuickMethodHeader;
 struct ProfileMethodInfo;
 class ProfilingInfo;
@@ -178,6 +179,9 @@ class ZygoteMap {
 
 class JitCodeCache {
  public:
+  // Sorted (code pointer, method) pairs of non-native compiled code.
+  using CodeIndex = std::vector<std::pair<const void*, ArtMethod*>>;
+
   static constexpr size_t kMaxCapacity = 64 * MB;
   // Put the default to a very low amount for debug builds to stress the code cache
   // collection.
@@ -186,6 +190,13 @@ class JitCodeCache {
   // By default, do not GC until reaching 256KB.
   static constexpr size_t kReservedCapacity = kInitialCapacity * 4;
 
+  // Number of full collections compiled code must survive to be tenured. We stop polling
+  // the liveness of tenured code, so that collections only drop young code.
+  static constexpr uint32_t kTenureCollections = 2;
+
+  // Maximum number of replaced lock-free lookup indexes kept alive between two collections.
+  static constexpr size_t kMaxRetiredCodeIndexes = 8;
+
   // Create the code cache with a code + data capacity equal to "capacity", error message is passed
   // in the out arg error_msg.
   static JitCodeCache* Create(bool used_only_for_profile_data,
@@ -258,6 +269,10 @@ class JitCodeCache {
   // single-implementation assumptions are violated later. This needs to be done
   // even if `has_should_deoptimize_flag` is false, which can happen due to CHA
   // guard elimination.
+  //
+  // With a JIT commit batch size above 1, the entry point of a method that does not depend on
+  // CHA is not updated here. It is published by PublishPendingCommits() together with the
+  // other methods of its batch, after a single flush of the instruction pipelines.
   bool Commit(Thread* self,
               JitMemoryRegion* region,
               ArtMethod* method,
@@ -274,6 +289,12 @@ class JitCodeCache {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::jit_lock_);
 
+  // Flush the instruction pipelines once and update the entry points of the methods whose
+  // publication Commit() deferred. Unless `force` is set, this waits until the batch is full.
+  void PublishPendingCommits(Thread* self, bool force)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::jit_lock_, !sync_cores_lock_);
+
   // Free the previously allocated memory regions.
   void Free(Thread* self, JitMemoryRegion* region, const uint8_t* code, const uint8_t* data)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -294,6 +315,14 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Given the 'pc', find the method whose JIT compiled code contains it, for symbolizing the
+  // PCs collected by FramePointerUnwinder. Return null if 'pc' is not in the code cache or if
+  // it is in zygote compiled code, which can only be looked up for a known method. For JNI
+  // stubs shared by several methods, return any of them.
+  ArtMethod* LookupMethodForPc(uintptr_t pc)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   OatQuickMethodHeader* LookupOsrMethodHeader(ArtMethod* method)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -310,7 +339,11 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void CopyInlineCacheInto(const InlineCache& ic, Handle<mirror::ObjectArray<mirror::Class>> array)
+  // Copy the non-null classes of `ic` into `array`. If `counts` is not null, it receives the
+  // receiver count of each copied class, at the same index as in `array`.
+  void CopyInlineCacheInto(const InlineCache& ic,
+                           Handle<mirror::ObjectArray<mirror::Class>> array,
+                           /*out*/ uint32_t* counts = nullptr)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -319,6 +352,8 @@ class JitCodeCache {
   ProfilingInfo* AddProfilingInfo(Thread* self,
                                   ArtMethod* method,
                                   const std::vector<uint32_t>& entries,
+                                  const std::vector<uint32_t>& branch_entries,
+                                  const std::vector<uint32_t>& type_check_entries,
                                   bool retry_allocation)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -335,6 +370,12 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Adds to `methods` all non-boot class path methods with optimized code in the cache whose
+  // entry point can be updated without a class initialization check.
+  void GetOptimizedMethods(std::vector<MethodReference>* methods)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void InvalidateAllCompiledCode()
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -345,6 +386,9 @@ class JitCodeCache {
 
   void Dump(std::ostream& os) REQUIRES(!Locks::jit_lock_);
 
+  // Print the code cache occupancy and collection counts as one parseable line, see JitStats.
+  void DumpStats(std::ostream& os) REQUIRES(!Locks::jit_lock_);
+
   bool IsOsrCompiled(ArtMethod* method) REQUIRES(!Locks::jit_lock_);
 
   void SweepRootTables(IsMarkedVisitor* visitor)
@@ -415,7 +459,9 @@ class JitCodeCache {
 
   ProfilingInfo* AddProfilingInfoInternal(Thread* self,
                                           ArtMethod* method,
-                                          const std::vector<uint32_t>& entries)
+                                          const std::vector<uint32_t>& entries,
+                                          const std::vector<uint32_t>& branch_entries,
+                                          const std::vector<uint32_t>& type_check_entries)
       REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -475,6 +521,32 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return whether the compiled code has survived enough full collections to be tenured.
+  bool IsTenured(const void* code_ptr) const REQUIRES(Locks::jit_lock_);
+
+  // Age the compiled code that survived a full collection.
+  void AgeSurvivingCode() REQUIRES(Locks::jit_lock_);
+
+  // Flush the instruction pipelines of all cores after writing new code.
+  void SyncCores(Thread* self) REQUIRES(!sync_cores_lock_);
+
+  // Look up `pc` in `code_index_` without taking `Locks::jit_lock_`. Returns null if the
+  // index is missing or does not contain `pc`.
+  OatQuickMethodHeader* LookupCodeIndex(uintptr_t pc, ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Retire `code_index_` after entries of `method_code_map_` were removed or changed.
+  void InvalidateCodeIndex() REQUIRES(Locks::jit_lock_);
+
+  // Rebuild `code_index_` if it is missing or stale, unless too many retired indexes are
+  // waiting to be deleted.
+  void MaybeRebuildCodeIndex() REQUIRES(Locks::jit_lock_);
+
+  // Forget about compiled code that is being removed from `method_code_map_`.
+  void RemoveCodeAge(const void* code_ptr) REQUIRES(Locks::jit_lock_) {
+    code_survived_collections_.erase(code_ptr);
+  }
+
   void RemoveUnmarkedCode(Thread* self)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -511,6 +583,9 @@ class JitCodeCache {
   // Return whether `method` is being compiled in any mode.
   bool IsMethodBeingCompiled(ArtMethod* method) REQUIRES(Locks::jit_lock_);
 
+  // Return whether `method` has committed code whose entry point is not published yet.
+  bool IsPendingCommit(ArtMethod* method) REQUIRES(Locks::jit_lock_);
+
   class JniStubKey;
   class JniStubData;
 
@@ -538,6 +613,35 @@ class JitCodeCache {
   // Holds compiled code associated to the ArtMethod.
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(Locks::jit_lock_);
 
+  // Immutable sorted copy of `method_code_map_`, so that LookupMethodHeader() does not need
+  // to take `Locks::jit_lock_`. Null when entries were removed from `method_code_map_`; it
+  // is then rebuilt by the next lookup that needs the lock.
+  Atomic<const CodeIndex*> code_index_;
+
+  // Whether code was added to `method_code_map_` since `code_index_` was built.
+  bool code_index_is_stale_ GUARDED_BY(Locks::jit_lock_);
+
+  // Replaced indexes that lock-free lookups may still be reading. They are deleted once all
+  // threads have gone through a checkpoint.
+  std::vector<const CodeIndex*> retired_code_indexes_ GUARDED_BY(Locks::jit_lock_);
+
+  // Serializes membarrier calls in SyncCores(), so that concurrent callers can share one.
+  Mutex sync_cores_lock_;
+  // Number of SyncCores() calls.
+  Atomic<uint64_t> sync_cores_requests_;
+  // Number of SyncCores() calls whose code was covered by a completed membarrier.
+  uint64_t sync_cores_done_ GUARDED_BY(sync_cores_lock_);
+
+  // Committed code whose entry point is published by the next PublishPendingCommits().
+  struct PendingCommit {
+    ArtMethod* method;
+    const void* code_ptr;
+    // Commits with a sequence number below the one read before a SyncCores() are covered by it.
+    uint64_t sequence;
+  };
+  std::vector<PendingCommit> pending_commits_ GUARDED_BY(Locks::jit_lock_);
+  uint64_t next_pending_commit_sequence_ GUARDED_BY(Locks::jit_lock_);
+
   // Holds compiled code associated to the ArtMethod. Used when pre-jitting
   // methods whose entrypoints have the resolution stub.
   SafeMap<ArtMethod*, const void*> saved_compiled_methods_map_ GUARDED_BY(Locks::jit_lock_);
@@ -574,6 +678,14 @@ class JitCodeCache {
   // Whether we can do garbage collection. Not 'const' as tests may override this.
   bool garbage_collect_code_ GUARDED_BY(Locks::jit_lock_);
 
+  // Number of full collections survived by the compiled code in `method_code_map_`. Code
+  // that has not survived any is not in the map.
+  SafeMap<const void*, uint32_t> code_survived_collections_ GUARDED_BY(Locks::jit_lock_);
+
+  // Methods whose compiled code was dropped by the last collection. Used to count the methods
+  // that get compiled again before the next collection.
+  std::set<ArtMethod*> methods_collected_last_ GUARDED_BY(Locks::jit_lock_);
+
   // ---------------- JIT statistics -------------------------------------- //
 
   // Number of compilations done throughout the lifetime of the JIT.
@@ -585,6 +697,11 @@ class JitCodeCache {
   // Number of code cache collections done throughout the lifetime of the JIT.
   size_t number_of_collections_ GUARDED_BY(Locks::jit_lock_);
 
+  // Number of methods compiled again after the last collection dropped their code, and
+  // the same since the start of the JIT.
+  size_t recompilations_since_last_collection_ GUARDED_BY(Locks::jit_lock_);
+  size_t total_recompilations_after_collection_ GUARDED_BY(Locks::jit_lock_);
+
   // Histograms for keeping track of stack map size statistics.
   Histogram<uint64_t> histogram_stack_map_memory_use_ GUARDED_BY(Locks::jit_lock_);
 
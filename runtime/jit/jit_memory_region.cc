@@ -20,16 +20,17 @@
 #include <unistd.h>
 
 #include <android-base/unique_fd.h>
+#include "base/allocator.h"
 #include "base/bit_utils.h"  // For RoundDown, RoundUp
 #include "base/globals.h"
 #include "base/logging.h"  // For VLOG.
-#include "base/membarrier.h"
 #include "base/memfd.h"
 #include "base/systrace.h"
 #include "gc/allocator/dlmalloc.h"
 #include "jit/jit_scoped_code_cache_write.h"
 #include "oat_quick_method_header.h"
 #include "palette/palette.h"
+#include "runtime.h"
 
 using android::base::unique_fd;
 
@@ -246,6 +247,12 @@ bool JitMemoryRegion::Initialize(size_t initial_capacity,
         return false;
       }
     }
+    Runtime* runtime = Runtime::Current();
+    if (runtime != nullptr && runtime->UseHugePagesForCode()) {
+      // Only the executable view is fetched from; the writable view is for updates. The
+      // views share the memory file, so with the dual view this needs shmem huge pages.
+      Runtime::MadviseHugePagesForCode(exec_pages.Begin(), exec_pages.End(), exec_cache_name);
+    }
   } else {
     // Profiling only. No memory for code required.
   }
@@ -418,17 +425,8 @@ const uint8_t* JitMemoryRegion::CommitCode(ArrayRef<const uint8_t> reserved_code
     return nullptr;
   }
 
-  // Ensure CPU instruction pipelines are flushed for all cores. This is necessary for
-  // correctness as code may still be in instruction pipelines despite the i-cache flush. It is
-  // not safe to assume that changing permissions with mprotect (RX->RWX->RX) will cause a TLB
-  // shootdown (incidentally invalidating the CPU pipelines by sending an IPI to all cores to
-  // notify them of the TLB invalidation). Some architectures, notably ARM and ARM64, have
-  // hardware support that broadcasts TLB invalidations and so their kernels have no software
-  // based TLB shootdown. The sync-core flavor of membarrier was introduced in Linux 4.16 to
-  // address this (see mbarrier(2)). The membarrier here will fail on prior kernels and on
-  // platforms lacking the appropriate support.
-  art::membarrier(art::MembarrierCommand::kPrivateExpeditedSyncCore);
-
+  // Note that the caller still needs to flush the CPU instruction pipelines of all cores,
+  // see JitCodeCache::SyncCores(), before the code can be executed.
   return result;
 }
 
@@ -487,7 +485,9 @@ const uint8_t* JitMemoryRegion::AllocateData(size_t data_size) {
   if (UNLIKELY(result == nullptr)) {
     return nullptr;
   }
-  used_memory_for_data_ += mspace_usable_size(result);
+  size_t usable_size = mspace_usable_size(result);
+  used_memory_for_data_ += usable_size;
+  TrackedAllocators::RegisterAllocation(kAllocatorTagJitData, usable_size);
   return reinterpret_cast<uint8_t*>(GetNonWritableDataAddress(result));
 }
 
@@ -496,7 +496,9 @@ void JitMemoryRegion::FreeData(const uint8_t* data) {
 }
 
 void JitMemoryRegion::FreeWritableData(uint8_t* writable_data) REQUIRES(Locks::jit_lock_) {
-  used_memory_for_data_ -= mspace_usable_size(writable_data);
+  size_t usable_size = mspace_usable_size(writable_data);
+  used_memory_for_data_ -= usable_size;
+  TrackedAllocators::RegisterFree(kAllocatorTagJitData, usable_size);
   mspace_free(data_mspace_, writable_data);
 }
 
@@ -88,6 +88,7 @@ class JitMemoryRegion {
 
   // Emit header and code into the memory pointed by `reserved_code` (despite it being const).
   // Returns pointer to copied code (within reserved_code region; after OatQuickMethodHeader).
+  // The code must not be executed before the instruction pipelines of all cores are flushed.
   const uint8_t* CommitCode(ArrayRef<const uint8_t> reserved_code,
                             ArrayRef<const uint8_t> code,
                             const uint8_t* stack_map,
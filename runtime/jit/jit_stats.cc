@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_stats.h"
+
+#include <ostream>
+
+#include "base/histogram-inl.h"
+#include "base/systrace.h"
+#include "base/time_utils.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace jit {
+
+static constexpr uint64_t kLatencyBucketWidthUs = 100;
+static constexpr uint64_t kQueueDepthBucketWidth = 1;
+static constexpr size_t kStatsBucketCount = 32;
+
+JitStats::Entry::Entry()
+    : count(0u),
+      failures(0u),
+      latency_histogram("JIT compilation latency", kLatencyBucketWidthUs, kStatsBucketCount) {
+}
+
+JitStats::JitStats()
+    : lock_("jit stats lock"),
+      queue_depth_histogram_("JIT queue depth", kQueueDepthBucketWidth, kStatsBucketCount),
+      osr_transitions_(0u) {
+}
+
+void JitStats::RecordCompilation(CompilationKind kind, uint64_t duration_ns, bool success) {
+  MutexLock mu(Thread::Current(), lock_);
+  Entry& entry = entries_[static_cast<size_t>(kind)];
+  ++entry.count;
+  if (!success) {
+    ++entry.failures;
+  }
+  entry.latency_histogram.AddValue(NsToUs(duration_ns));
+}
+
+void JitStats::RecordQueueDepth(size_t depth) {
+  ATraceIntegerValue("JIT queue depth", static_cast<int32_t>(depth));
+  MutexLock mu(Thread::Current(), lock_);
+  queue_depth_histogram_.AddValue(depth);
+}
+
+static void DumpPercentiles(std::ostream& os,
+                            const char* prefix,
+                            const char* suffix,
+                            const Histogram<uint64_t>& h) {
+  uint64_t p50 = 0u;
+  uint64_t p90 = 0u;
+  uint64_t p99 = 0u;
+  uint64_t max = 0u;
+  if (h.SampleSize() != 0) {
+    Histogram<uint64_t>::CumulativeData data;
+    h.CreateHistogram(&data);
+    p50 = static_cast<uint64_t>(h.Percentile(0.50, data));
+    p90 = static_cast<uint64_t>(h.Percentile(0.90, data));
+    p99 = static_cast<uint64_t>(h.Percentile(0.99, data));
+    max = h.Max();
+  }
+  os << " " << prefix << "_p50" << suffix << "=" << p50
+     << " " << prefix << "_p90" << suffix << "=" << p90
+     << " " << prefix << "_p99" << suffix << "=" << p99
+     << " " << prefix << "_max" << suffix << "=" << max;
+}
+
+void JitStats::Dump(std::ostream& os) {
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    for (size_t i = 0; i < kNumberOfCompilationKinds; ++i) {
+      const Entry& entry = entries_[i];
+      os << "jit_compile kind=" << static_cast<CompilationKind>(i)
+         << " count=" << entry.count
+         << " failures=" << entry.failures;
+      DumpPercentiles(os, "latency", "_us", entry.latency_histogram);
+      os << " latency_total_us=" << entry.latency_histogram.Sum() << "\n";
+    }
+    os << "jit_queue samples=" << queue_depth_histogram_.SampleSize();
+    DumpPercentiles(os, "depth", "", queue_depth_histogram_);
+    os << "\n";
+  }
+  os << "jit_osr transitions=" << osr_transitions_.load(std::memory_order_relaxed) << "\n";
+}
+
+void JitStats::Reset() {
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    for (Entry& entry : entries_) {
+      entry.count = 0u;
+      entry.failures = 0u;
+      entry.latency_histogram.Reset();
+    }
+    queue_depth_histogram_.Reset();
+  }
+  osr_transitions_.store(0u, std::memory_order_relaxed);
+}
+
+}  // namespace jit
+}  // namespace art
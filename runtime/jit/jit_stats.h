@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_STATS_H_
+#define ART_RUNTIME_JIT_JIT_STATS_H_
+
+#include <iosfwd>
+
+#include "base/atomic.h"
+#include "base/histogram.h"
+#include "base/mutex.h"
+#include "compilation_kind.h"
+
+namespace art {
+namespace jit {
+
+// Structured JIT statistics for the process. Unlike Jit::DumpInfo(), the output of Dump() is meant
+// to be parsed: it is returned by VMDebug.getRuntimeStat(). The queue depth is also published as
+// a trace counter for perfetto.
+class JitStats {
+ public:
+  static constexpr size_t kNumberOfCompilationKinds =
+      static_cast<size_t>(CompilationKind::kOptimized) + 1u;
+
+  JitStats();
+
+  // Record a compilation of kind `kind` that took `duration_ns`.
+  void RecordCompilation(CompilationKind kind, uint64_t duration_ns, bool success)
+      REQUIRES(!lock_);
+
+  // Record the number of tasks waiting in the compilation queue.
+  void RecordQueueDepth(size_t depth) REQUIRES(!lock_);
+
+  // Record a transition from the interpreter to OSR compiled code.
+  void RecordOsrTransition() {
+    osr_transitions_.fetch_add(1u, std::memory_order_relaxed);
+  }
+
+  // Print one line per compilation kind followed by the queue and OSR lines, for example:
+  //   jit_compile kind=Optimized count=10 failures=1 latency_p50_us=... latency_max_us=...
+  //   jit_queue samples=11 depth_p50=0 depth_p90=2 depth_p99=3 depth_max=3
+  //   jit_osr transitions=2
+  // All durations are in microseconds.
+  void Dump(std::ostream& os) REQUIRES(!lock_);
+
+  void Reset() REQUIRES(!lock_);
+
+ private:
+  struct Entry {
+    Entry();
+
+    uint64_t count;
+    uint64_t failures;
+    // In microseconds.
+    Histogram<uint64_t> latency_histogram;
+  };
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  Entry entries_[kNumberOfCompilationKinds] GUARDED_BY(lock_);
+  Histogram<uint64_t> queue_depth_histogram_ GUARDED_BY(lock_);
+  Atomic<uint64_t> osr_transitions_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitStats);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_STATS_H_
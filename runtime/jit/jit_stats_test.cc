@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_stats.h"
+
+#include <sstream>
+
+#include "base/time_utils.h"
+#include "common_runtime_test.h"
+
+namespace art {
+namespace jit {
+
+class JitStatsTest : public CommonRuntimeTest {};
+
+TEST_F(JitStatsTest, Dump) {
+  JitStats stats;
+  stats.RecordCompilation(CompilationKind::kOptimized, MsToNs(2), /*success=*/ true);
+  stats.RecordCompilation(CompilationKind::kOptimized, MsToNs(2), /*success=*/ false);
+  stats.RecordCompilation(CompilationKind::kBaseline, MsToNs(1), /*success=*/ true);
+  stats.RecordQueueDepth(3u);
+  stats.RecordOsrTransition();
+  std::ostringstream oss;
+  stats.Dump(oss);
+  const std::string output = oss.str();
+  EXPECT_NE(output.find("jit_compile kind=Optimized count=2 failures=1 "),
+            std::string::npos) << output;
+  EXPECT_NE(output.find("latency_total_us=4000"), std::string::npos) << output;
+  EXPECT_NE(output.find("jit_compile kind=Baseline count=1 failures=0 "),
+            std::string::npos) << output;
+  EXPECT_NE(output.find("jit_compile kind=Osr count=0 failures=0 "), std::string::npos) << output;
+  EXPECT_NE(output.find("jit_queue samples=1 "), std::string::npos) << output;
+  EXPECT_NE(output.find("depth_max=3\n"), std::string::npos) << output;
+  EXPECT_NE(output.find("jit_osr transitions=1\n"), std::string::npos) << output;
+
+  stats.Reset();
+  std::ostringstream oss2;
+  stats.Dump(oss2);
+  EXPECT_NE(oss2.str().find("jit_compile kind=Optimized count=0 failures=0 "),
+            std::string::npos) << oss2.str();
+  EXPECT_NE(oss2.str().find("jit_osr transitions=0\n"), std::string::npos) << oss2.str();
+}
+
+}  // namespace jit
+}  // namespace art
@@ -95,6 +95,7 @@ ProfileSaver::ProfileSaver(const ProfileSaverOptions& options,
       total_number_of_writes_(0),
       total_number_of_code_cache_queries_(0),
       total_number_of_skipped_writes_(0),
+      total_number_of_skipped_loads_(0),
       total_number_of_failed_writes_(0),
       total_ms_of_sleep_(0),
       total_ns_of_work_(0),
@@ -511,6 +512,19 @@ void ProfileSaver::FetchAndCacheResolvedClassesAndMethods(bool startup) {
                  << PrettyDuration(NanoTime() - start_time);
 }
 
+bool ProfileSaver::GetProfileFileStamp(const std::string& filename,
+                                       /*out*/ ProfileFileStamp* stamp) {
+  struct stat st;
+  if (stat(filename.c_str(), &st) != 0) {
+    return false;
+  }
+  stamp->inode = static_cast<uint64_t>(st.st_ino);
+  stamp->size = static_cast<uint64_t>(st.st_size);
+  stamp->mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * INT64_C(1000000000) +
+                    st.st_mtim.tv_nsec;
+  return true;
+}
+
 bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number_of_new_methods) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
 
@@ -553,22 +567,41 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
       total_number_of_code_cache_queries_++;
     }
     {
-      ProfileCompilationInfo info(Runtime::Current()->GetArenaPool());
-      if (!info.Load(filename, /*clear_if_invalid=*/ true)) {
-        LOG(WARNING) << "Could not forcefully load profile " << filename;
-        continue;
+      // Reuse the data from the last load or save if nobody has modified the file since.
+      // Otherwise, (re)load the file.
+      std::unique_ptr<ProfileCompilationInfo> info;
+      ProfileFileStamp stamp;
+      bool has_stamp = GetProfileFileStamp(filename, &stamp);
+      uint64_t last_save_number_of_methods = 0u;
+      uint64_t last_save_number_of_classes = 0u;
+      auto saved_it = saved_profiles_.find(filename);
+      if (saved_it != saved_profiles_.end()) {
+        if (has_stamp && saved_it->second.stamp == stamp) {
+          info = std::move(saved_it->second.info);
+          last_save_number_of_methods = saved_it->second.number_of_methods;
+          last_save_number_of_classes = saved_it->second.number_of_classes;
+          total_number_of_skipped_loads_++;
+        }
+        saved_profiles_.erase(saved_it);
       }
-      if (options_.GetProfileBootClassPath() != info.IsForBootImage()) {
-        // If we enabled boot class path profiling but the profile is a regular one,
-        // (or the opposite), clear the profile. We do not support cross-version merges.
-        LOG(WARNING) << "Adjust profile version: for_boot_classpath="
-            << options_.GetProfileBootClassPath();
-        info.ClearDataAndAdjustVersion(options_.GetProfileBootClassPath());
-        // For saving to ensure we persist the new version.
-        force_save = true;
+      if (info == nullptr) {
+        info.reset(new ProfileCompilationInfo(Runtime::Current()->GetArenaPool()));
+        if (!info->Load(filename, /*clear_if_invalid=*/ true)) {
+          LOG(WARNING) << "Could not forcefully load profile " << filename;
+          continue;
+        }
+        if (options_.GetProfileBootClassPath() != info->IsForBootImage()) {
+          // If we enabled boot class path profiling but the profile is a regular one,
+          // (or the opposite), clear the profile. We do not support cross-version merges.
+          LOG(WARNING) << "Adjust profile version: for_boot_classpath="
+              << options_.GetProfileBootClassPath();
+          info->ClearDataAndAdjustVersion(options_.GetProfileBootClassPath());
+          // For saving to ensure we persist the new version.
+          force_save = true;
+        }
+        last_save_number_of_methods = info->GetNumberOfMethods();
+        last_save_number_of_classes = info->GetNumberOfResolvedClasses();
       }
-      uint64_t last_save_number_of_methods = info.GetNumberOfMethods();
-      uint64_t last_save_number_of_classes = info.GetNumberOfResolvedClasses();
       VLOG(profiler) << "last_save_number_of_methods=" << last_save_number_of_methods
                      << " last_save_number_of_classes=" << last_save_number_of_classes
                      << " number of profiled methods=" << profile_methods.size();
@@ -576,21 +609,21 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
       // Try to add the method data. Note this may fail is the profile loaded from disk contains
       // outdated data (e.g. the previous profiled dex files might have been updated).
       // If this happens we clear the profile data and for the save to ensure the file is cleared.
-      if (!info.AddMethods(
+      if (!info->AddMethods(
               profile_methods,
               AnnotateSampleFlags(Hotness::kFlagHot | Hotness::kFlagPostStartup),
               GetProfileSampleAnnotation())) {
         LOG(WARNING) << "Could not add methods to the existing profiler. "
             << "Clearing the profile data.";
-        info.ClearData();
+        info->ClearData();
         force_save = true;
       }
 
       auto profile_cache_it = profile_cache_.find(filename);
       if (profile_cache_it != profile_cache_.end()) {
-        if (!info.MergeWith(*(profile_cache_it->second))) {
+        if (!info->MergeWith(*(profile_cache_it->second))) {
           LOG(WARNING) << "Could not merge the profile. Clearing the profile data.";
-          info.ClearData();
+          info->ClearData();
           force_save = true;
         }
       } else if (VLOG_IS_ON(profiler)) {
@@ -601,9 +634,9 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
       }
 
       int64_t delta_number_of_methods =
-          info.GetNumberOfMethods() - last_save_number_of_methods;
+          info->GetNumberOfMethods() - last_save_number_of_methods;
       int64_t delta_number_of_classes =
-          info.GetNumberOfResolvedClasses() - last_save_number_of_classes;
+          info->GetNumberOfResolvedClasses() - last_save_number_of_classes;
 
       if (!force_save &&
           delta_number_of_methods < options_.GetMinMethodsToSave() &&
@@ -612,6 +645,13 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
                        << " Number of methods: " << delta_number_of_methods
                        << " Number of classes: " << delta_number_of_classes;
         total_number_of_skipped_writes_++;
+        if (has_stamp) {
+          // Keep the data, including what has not been written yet, for the next attempt.
+          saved_profiles_.Put(filename, SavedProfileInfo{std::move(info),
+                                                         stamp,
+                                                         last_save_number_of_methods,
+                                                         last_save_number_of_classes});
+        }
         continue;
       }
 
@@ -623,7 +663,7 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
       uint64_t bytes_written;
       // Force the save. In case the profile data is corrupted or the the profile
       // has the wrong version this will "fix" the file to the correct format.
-      if (info.Save(filename, &bytes_written)) {
+      if (info->Save(filename, &bytes_written)) {
         // We managed to save the profile. Clear the cache stored during startup.
         if (profile_cache_it != profile_cache_.end()) {
           ProfileCompilationInfo *cached_info = profile_cache_it->second;
@@ -641,6 +681,13 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
           // in the file.
           total_number_of_skipped_writes_++;
         }
+        if (GetProfileFileStamp(filename, &stamp)) {
+          uint64_t number_of_methods = info->GetNumberOfMethods();
+          uint64_t number_of_classes = info->GetNumberOfResolvedClasses();
+          saved_profiles_.Put(
+              filename,
+              SavedProfileInfo{std::move(info), stamp, number_of_methods, number_of_classes});
+        }
       } else {
         LOG(WARNING) << "Could not save profiling info to " << filename;
         total_number_of_failed_writes_++;
@@ -903,6 +950,7 @@ void ProfileSaver::DumpInfo(std::ostream& os) {
      << "ProfileSaver total_number_of_code_cache_queries="
      << total_number_of_code_cache_queries_ << '\n'
      << "ProfileSaver total_number_of_skipped_writes=" << total_number_of_skipped_writes_ << '\n'
+     << "ProfileSaver total_number_of_skipped_loads=" << total_number_of_skipped_loads_ << '\n'
      << "ProfileSaver total_number_of_failed_writes=" << total_number_of_failed_writes_ << '\n'
      << "ProfileSaver total_ms_of_sleep=" << total_ms_of_sleep_ << '\n'
      << "ProfileSaver total_ms_of_work=" << NsToMs(total_ns_of_work_) << '\n'
@@ -138,6 +138,37 @@ class ProfileSaver {
   // to just a few hundreds entries in the ProfileCompilationInfo objects.
   SafeMap<std::string, ProfileCompilationInfo*> profile_cache_;
 
+  // Identifies a version of a profile file on disk. Two versions with the same stamp
+  // are assumed to have the same contents.
+  struct ProfileFileStamp {
+    uint64_t inode;
+    uint64_t size;
+    int64_t mtime_ns;
+
+    bool operator==(const ProfileFileStamp& other) const {
+      return inode == other.inode && size == other.size && mtime_ns == other.mtime_ns;
+    }
+  };
+
+  // The profile data of a tracked file as of the last time it was loaded or saved, together
+  // with all the data collected since then that has not been written yet.
+  struct SavedProfileInfo {
+    std::unique_ptr<ProfileCompilationInfo> info;
+    // The stamp of the file the data was loaded from or saved to.
+    ProfileFileStamp stamp;
+    // The number of methods and classes in the file itself.
+    uint64_t number_of_methods;
+    uint64_t number_of_classes;
+  };
+
+  // Returns false if the file cannot be stat'ed.
+  static bool GetProfileFileStamp(const std::string& filename, /*out*/ ProfileFileStamp* stamp);
+
+  // The profile data of each tracked file. As long as the file is not modified by someone
+  // else, this lets the saver work out how much new data there is without reading the file
+  // again, so the file is only read and written when there is enough data to save.
+  SafeMap<std::string, SavedProfileInfo> saved_profiles_;
+
   // Save period condition support.
   Mutex wait_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable period_condition_ GUARDED_BY(wait_lock_);
@@ -146,6 +177,7 @@ class ProfileSaver {
   uint64_t total_number_of_writes_;
   uint64_t total_number_of_code_cache_queries_;
   uint64_t total_number_of_skipped_writes_;
+  uint64_t total_number_of_skipped_loads_;
   uint64_t total_number_of_failed_writes_;
   uint64_t total_ms_of_sleep_;
   uint64_t total_ns_of_work_;
@@ -16,6 +16,8 @@
 
 #include "profiling_info.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "dex/dex_instruction.h"
 #include "jit/jit.h"
@@ -25,16 +27,32 @@
 
 namespace art {
 
-ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries)
+ProfilingInfo::ProfilingInfo(ArtMethod* method,
+                             const std::vector<uint32_t>& entries,
+                             const std::vector<uint32_t>& branch_entries,
+                             const std::vector<uint32_t>& type_check_entries)
       : baseline_hotness_count_(0),
         method_(method),
         saved_entry_point_(nullptr),
         number_of_inline_caches_(entries.size()),
+        number_of_branch_caches_(branch_entries.size()),
+        number_of_type_check_caches_(type_check_entries.size()),
         current_inline_uses_(0) {
+  memset(speculation_failures_, 0, sizeof(speculation_failures_));
   memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
     cache_[i].dex_pc_ = entries[i];
   }
+  BranchCache* branch_caches = GetBranchCaches();
+  memset(branch_caches, 0, number_of_branch_caches_ * sizeof(BranchCache));
+  for (size_t i = 0; i < number_of_branch_caches_; ++i) {
+    branch_caches[i].dex_pc_ = branch_entries[i];
+  }
+  TypeCheckCache* type_check_caches = GetTypeCheckCaches();
+  memset(type_check_caches, 0, number_of_type_check_caches_ * sizeof(TypeCheckCache));
+  for (size_t i = 0; i < number_of_type_check_caches_; ++i) {
+    type_check_caches[i].dex_pc_ = type_check_entries[i];
+  }
 }
 
 bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocation) {
@@ -43,6 +61,8 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
   DCHECK(!method->IsNative());
 
   std::vector<uint32_t> entries;
+  std::vector<uint32_t> branch_entries;
+  std::vector<uint32_t> type_check_entries;
   for (const DexInstructionPcPair& inst : method->DexInstructions()) {
     switch (inst->Opcode()) {
       case Instruction::INVOKE_VIRTUAL:
@@ -54,6 +74,26 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
         entries.push_back(inst.DexPc());
         break;
 
+      case Instruction::IF_EQ:
+      case Instruction::IF_EQZ:
+      case Instruction::IF_NE:
+      case Instruction::IF_NEZ:
+      case Instruction::IF_LT:
+      case Instruction::IF_LTZ:
+      case Instruction::IF_GE:
+      case Instruction::IF_GEZ:
+      case Instruction::IF_GT:
+      case Instruction::IF_GTZ:
+      case Instruction::IF_LE:
+      case Instruction::IF_LEZ:
+        branch_entries.push_back(inst.DexPc());
+        break;
+
+      case Instruction::INSTANCE_OF:
+      case Instruction::CHECK_CAST:
+        type_check_entries.push_back(inst.DexPc());
+        break;
+
       default:
         break;
     }
@@ -64,7 +104,31 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
 
   // Allocate the `ProfilingInfo` object int the JIT's data space.
   jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
-  return code_cache->AddProfilingInfo(self, method, entries, retry_allocation) != nullptr;
+  return code_cache->AddProfilingInfo(
+      self, method, entries, branch_entries, type_check_entries, retry_allocation) != nullptr;
+}
+
+BranchCache* ProfilingInfo::GetBranchCache(uint32_t dex_pc) {
+  BranchCache* begin = GetBranchCaches();
+  BranchCache* end = begin + number_of_branch_caches_;
+  BranchCache* it = std::lower_bound(
+      begin, end, dex_pc, [](const BranchCache& cache, uint32_t pc) { return cache.dex_pc_ < pc; });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
+}
+
+TypeCheckCache* ProfilingInfo::GetTypeCheckCache(uint32_t dex_pc) {
+  TypeCheckCache* begin = GetTypeCheckCaches();
+  TypeCheckCache* end = begin + number_of_type_check_caches_;
+  TypeCheckCache* it = std::lower_bound(
+      begin,
+      end,
+      dex_pc,
+      [](const TypeCheckCache& cache, uint32_t pc) { return cache.dex_pc_ < pc; });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
+}
+
+mirror::Class* TypeCheckCache::GetClass() {
+  return class_.Read();
 }
 
 InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
@@ -84,7 +148,8 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
     mirror::Class* existing = cache->classes_[i].Read<kWithoutReadBarrier>();
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
     if (marked == cls) {
-      // Receiver type is already in the cache, nothing else to do.
+      // Receiver type is already in the cache, just count it.
+      ++cache->counts_[i];
       return;
     } else if (marked == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -99,13 +164,23 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         // entry in case the entry contains `cls`.
         --i;
       } else {
-        // We successfully set `cls`, just return.
+        // We successfully set `cls`, count it and return.
+        ++cache->counts_[i];
         return;
       }
     }
   }
   // Unsuccessfull - cache is full, making it megamorphic. We do not DCHECK it though,
   // as the garbage collector might clear the entries concurrently.
+  // Use the last entry for a majority vote of the remaining receiver types, like
+  // art_quick_update_inline_cache does.
+  constexpr size_t kLast = InlineCache::kIndividualCacheSize - 1;
+  if (cache->counts_[kLast] != 0u) {
+    --cache->counts_[kLast];
+  } else {
+    cache->classes_[kLast] = GcRoot<mirror::Class>(cls);
+    cache->counts_[kLast] = 1u;
+  }
 }
 
 }  // namespace art
@@ -17,9 +17,11 @@
 #ifndef ART_RUNTIME_JIT_PROFILING_INFO_H_
 #define ART_RUNTIME_JIT_PROFILING_INFO_H_
 
+#include <limits>
 #include <vector>
 
 #include "base/macros.h"
+#include "deoptimization_kind.h"
 #include "gc_root.h"
 #include "offsets.h"
 
@@ -38,6 +40,9 @@ class Class;
 
 // Structure to store the classes seen at runtime for a specific instruction.
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
+// Each class comes with a count of how often it was seen as a receiver. When the cache is
+// megamorphic, the last entry keeps a majority vote of the receivers not in the first entries,
+// so that dominant receiver types can still be identified.
 class InlineCache {
  public:
   // This is hard coded in the assembly stub art_quick_update_inline_cache.
@@ -47,9 +52,25 @@ class InlineCache {
     return MemberOffset(OFFSETOF_MEMBER(InlineCache, classes_));
   }
 
+  static constexpr MemberOffset CountsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, counts_));
+  }
+
+  // Approximate number of times the INVOKE was executed, from the receiver counts.
+  uint64_t GetApproximateCount() const {
+    uint64_t total = 0u;
+    for (uint32_t count : counts_) {
+      total += count;
+    }
+    return total;
+  }
+
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  // Approximate number of times the corresponding class was seen. Updated without
+  // synchronization, so only to be used as a heuristic.
+  uint32_t counts_[kIndividualCacheSize];
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -57,6 +78,77 @@ class InlineCache {
   DISALLOW_COPY_AND_ASSIGN(InlineCache);
 };
 
+// Structure to store the outcomes of a conditional branch (if-* instruction), updated by
+// baseline compiled code. Like the inline cache counts, they are only a heuristic.
+class BranchCache {
+ public:
+  static constexpr MemberOffset TakenOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, taken_));
+  }
+
+  static constexpr MemberOffset NotTakenOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, not_taken_));
+  }
+
+  uint32_t GetTaken() const {
+    return taken_;
+  }
+
+  uint32_t GetNotTaken() const {
+    return not_taken_;
+  }
+
+ private:
+  uint32_t dex_pc_;
+  uint32_t taken_;
+  uint32_t not_taken_;
+
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(BranchCache);
+};
+
+// Structure to store the classes of the objects checked by an instance-of or check-cast
+// instruction, updated by baseline compiled code. The first class seen is recorded and the
+// objects of that class are counted as hits, objects of other classes as misses. Like the
+// other counts, they are only a heuristic.
+class TypeCheckCache {
+ public:
+  static constexpr MemberOffset ClassOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(TypeCheckCache, class_));
+  }
+
+  static constexpr MemberOffset HitsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(TypeCheckCache, hits_));
+  }
+
+  static constexpr MemberOffset MissesOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(TypeCheckCache, misses_));
+  }
+
+  // The recorded class, or null if none was recorded or it was unloaded.
+  mirror::Class* GetClass() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  uint32_t GetHits() const {
+    return hits_;
+  }
+
+  uint32_t GetMisses() const {
+    return misses_;
+  }
+
+ private:
+  uint32_t dex_pc_;
+  GcRoot<mirror::Class> class_;
+  uint32_t hits_;
+  uint32_t misses_;
+
+  friend class jit::JitCodeCache;
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(TypeCheckCache);
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
@@ -79,6 +171,23 @@ class ProfilingInfo {
     return method_;
   }
 
+  // Return the branch cache of the if-* instruction at `dex_pc`, or null if there is none.
+  BranchCache* GetBranchCache(uint32_t dex_pc);
+
+  // Return the type check cache of the instance-of or check-cast instruction at `dex_pc`,
+  // or null if there is none.
+  TypeCheckCache* GetTypeCheckCache(uint32_t dex_pc);
+
+  // Size of a ProfilingInfo with the given number of inline, branch and type check caches.
+  static size_t ComputeSize(size_t number_of_inline_caches,
+                            size_t number_of_branch_caches,
+                            size_t number_of_type_check_caches) {
+    return sizeof(ProfilingInfo) +
+        sizeof(InlineCache) * number_of_inline_caches +
+        sizeof(BranchCache) * number_of_branch_caches +
+        sizeof(TypeCheckCache) * number_of_type_check_caches;
+  }
+
   // Mutator lock only required for debugging output.
   InlineCache* GetInlineCache(uint32_t dex_pc)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -123,8 +232,43 @@ class ProfilingInfo {
     return baseline_hotness_count_;
   }
 
+  // Number of deoptimizations of one kind after which the compiler stops emitting
+  // speculations of that kind in this method.
+  static constexpr uint8_t kMaxSpeculationFailures = 3;
+
+  // Record that compiled code of this method deoptimized because a speculation failed.
+  // Like the other counters here, this is racy but only used as a heuristic.
+  void AddSpeculationFailure(DeoptimizationKind kind) {
+    uint8_t& count = speculation_failures_[static_cast<size_t>(kind)];
+    if (count != std::numeric_limits<uint8_t>::max()) {
+      ++count;
+    }
+  }
+
+  // Return a bit mask of the DeoptimizationKinds that failed too often in this method.
+  uint32_t GetDisabledSpeculations() const {
+    uint32_t kinds = 0u;
+    for (size_t i = 0; i != arraysize(speculation_failures_); ++i) {
+      if (speculation_failures_[i] >= kMaxSpeculationFailures) {
+        kinds |= 1u << i;
+      }
+    }
+    return kinds;
+  }
+
  private:
-  ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
+  ProfilingInfo(ArtMethod* method,
+                const std::vector<uint32_t>& entries,
+                const std::vector<uint32_t>& branch_entries,
+                const std::vector<uint32_t>& type_check_entries);
+
+  BranchCache* GetBranchCaches() {
+    return reinterpret_cast<BranchCache*>(&cache_[number_of_inline_caches_]);
+  }
+
+  TypeCheckCache* GetTypeCheckCaches() {
+    return reinterpret_cast<TypeCheckCache*>(GetBranchCaches() + number_of_branch_caches_);
+  }
 
   // Hotness count for methods compiled with the JIT baseline compiler. Once
   // a threshold is hit (currentily the maximum value of uint16_t), we will
@@ -143,11 +287,24 @@ class ProfilingInfo {
   // Number of instructions we are profiling in the ArtMethod.
   const uint32_t number_of_inline_caches_;
 
+  // Number of conditional branches we are profiling in the ArtMethod.
+  const uint32_t number_of_branch_caches_;
+
+  // Number of instance-of and check-cast instructions we are profiling in the ArtMethod.
+  const uint32_t number_of_type_check_caches_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
-  // Dynamically allocated array of size `number_of_inline_caches_`.
+  // Number of deoptimizations of compiled code of this method, per DeoptimizationKind.
+  uint8_t speculation_failures_[static_cast<size_t>(DeoptimizationKind::kLast) + 1];
+  static_assert(static_cast<size_t>(DeoptimizationKind::kLast) < 32u,
+                "GetDisabledSpeculations() returns a 32-bit mask");
+
+  // Dynamically allocated array of size `number_of_inline_caches_`, followed by
+  // `number_of_branch_caches_` BranchCache entries and `number_of_type_check_caches_`
+  // TypeCheckCache entries, both sorted by dex pc.
   InlineCache cache_[0];
 
   friend class jit::JitCodeCache;
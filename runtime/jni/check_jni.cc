@@ -36,6 +36,7 @@
 #include "dex/dex_file-inl.h"
 #include "gc/space/space.h"
 #include "java_vm_ext.h"
+#include "jni_env_ext.h"
 #include "jni_internal.h"
 #include "mirror/class-inl.h"
 #include "mirror/field.h"
@@ -316,7 +317,11 @@ bool CheckAttachedThread(const char* function_name) {
 class ScopedCheck {
  public:
   ScopedCheck(uint16_t flags, const char* functionName, bool has_method = true)
-      : function_name_(functionName), indent_(0), flags_(flags), has_method_(has_method) {
+      : function_name_(functionName),
+        indent_(0),
+        flags_(flags),
+        has_method_(has_method),
+        thorough_(ShouldCheckThoroughly(flags)) {
   }
 
   ~ScopedCheck() {}
@@ -386,6 +391,9 @@ class ScopedCheck {
   bool CheckMethodAndSig(ScopedObjectAccess& soa, jobject jobj, jclass jc,
                          jmethodID mid, Primitive::Type type, InvokeType invoke)
       REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (!thorough_) {
+      return true;
+    }
     ArtMethod* m = CheckMethodID(mid);
     if (m == nullptr) {
       return false;
@@ -570,10 +578,11 @@ class ScopedCheck {
       }
     }
 
-    // We always do the thorough checks on entry, and never on exit...
+    // We always do the thorough checks on entry, and never on exit... Calls skipped
+    // by sampling check only the JNIEnv*, i.e. the thread, critical and exception state.
     if (entry) {
       for (size_t i = 0; fmt[i] != '\0'; ++i) {
-        if (!CheckPossibleHeapValue(soa, fmt[i], args[i])) {
+        if ((thorough_ || fmt[i] == 'E') && !CheckPossibleHeapValue(soa, fmt[i], args[i])) {
           return false;
         }
       }
@@ -750,6 +759,9 @@ class ScopedCheck {
   bool CheckFieldAccess(ScopedObjectAccess& soa, jobject obj, jfieldID fid, bool is_static,
                         Primitive::Type type)
       REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (!thorough_) {
+      return true;
+    }
     if (is_static && !CheckStaticFieldID(soa, down_cast<jclass>(obj), fid)) {
       return false;
     }
@@ -1472,6 +1484,17 @@ class ScopedCheck {
     va_end(args);
   }
 
+  // With -XX:CheckJniSampleRate=N, only one in N calls on each thread gets the thorough checks.
+  // The invocation interface is rarely used and always checked thoroughly.
+  static bool ShouldCheckThoroughly(uint16_t flags) {
+    uint32_t sample_rate = Runtime::Current()->GetJavaVM()->GetCheckJniSampleRate();
+    if (LIKELY(sample_rate == 1u) || (flags & kFlag_Invocation) != 0) {
+      return true;
+    }
+    Thread* self = Thread::Current();
+    return self == nullptr || self->GetJniEnv()->SampleCheckJniCall(sample_rate);
+  }
+
   // The name of the JNI function being checked.
   const char* const function_name_;
 
@@ -1481,6 +1504,9 @@ class ScopedCheck {
 
   const bool has_method_;
 
+  // Whether to do the argument checks that are skipped by sampling.
+  const bool thorough_;
+
   DISALLOW_COPY_AND_ASSIGN(ScopedCheck);
 };
 
@@ -16,6 +16,7 @@
 
 #include "java_vm_ext.h"
 
+#include <algorithm>
 #include <dlfcn.h>
 #include <string_view>
 
@@ -492,7 +493,10 @@ JavaVMExt::JavaVMExt(Runtime* runtime,
       check_jni_abort_hook_(nullptr),
       check_jni_abort_hook_data_(nullptr),
       check_jni_(false),  // Initialized properly in the constructor body below.
+      check_jni_sample_rate_(
+          std::max(runtime_options.GetOrDefault(RuntimeArgumentMap::CheckJniSampleRate), 1u)),
       force_copy_(runtime_options.Exists(RuntimeArgumentMap::JniOptsForceCopy)),
+      warn_only_(runtime_options.Exists(RuntimeArgumentMap::JniOptsWarnOnly)),
       tracing_enabled_(runtime_options.Exists(RuntimeArgumentMap::JniTrace)
                        || VLOG_IS_ON(third_party_jni)),
       trace_(runtime_options.GetOrDefault(RuntimeArgumentMap::JniTrace)),
@@ -571,6 +575,11 @@ void JavaVMExt::JniAbort(const char* jni_function_name, const char* msg) {
 
   if (check_jni_abort_hook_ != nullptr) {
     check_jni_abort_hook_(check_jni_abort_hook_data_, os.str());
+  } else if (warn_only_) {
+    // Report the error with the managed stack of the caller and let the checked call fail.
+    os << "\n";
+    self->DumpJavaStack(os, /* check_suspended= */ false, /* dump_locks= */ false);
+    LOG(ERROR) << os.str();
   } else {
     // Ensure that we get a native stack trace for this thread.
     ScopedThreadSuspension sts(self, kNative);
@@ -62,6 +62,12 @@ class JavaVMExt : public JavaVM {
     return check_jni_;
   }
 
+  // CheckJNI does the thorough argument checks only for one in this many JNI calls on each
+  // thread. The thread, critical section and pending exception checks are done for every call.
+  uint32_t GetCheckJniSampleRate() const {
+    return check_jni_sample_rate_;
+  }
+
   bool IsTracingEnabled() const {
     return tracing_enabled_;
   }
@@ -75,9 +81,9 @@ class JavaVMExt : public JavaVM {
     check_jni_abort_hook_data_ = data;
   }
 
-  // Aborts execution unless there is an abort handler installed in which case it will return. Its
-  // therefore important that callers return after aborting as otherwise code following the abort
-  // will be executed in the abort handler case.
+  // Aborts execution unless there is an abort handler installed or -Xjniopts:warnonly was given,
+  // in which case it will return. Its therefore important that callers return after aborting as
+  // otherwise code following the abort will be executed in the abort handler case.
   void JniAbort(const char* jni_function_name, const char* msg);
 
   void JniAbortV(const char* jni_function_name, const char* fmt, va_list ap);
@@ -231,7 +237,10 @@ class JavaVMExt : public JavaVM {
 
   // Extra checking.
   bool check_jni_;
+  const uint32_t check_jni_sample_rate_;
   const bool force_copy_;
+  // Log CheckJNI errors instead of aborting.
+  const bool warn_only_;
   const bool tracing_enabled_;
 
   // Extra diagnostics.
@@ -36,9 +36,9 @@ namespace mirror {
 class Object;
 }  // namespace mirror
 
-// Number of local references in the indirect reference table. The value is arbitrary but
-// low enough that it forces sanity checks.
-static constexpr size_t kLocalsInitial = 512;
+// Initial number of local references in the indirect reference table. The table grows by adding
+// chunks without moving references, so start small; the first chunk is rounded up to a page.
+static constexpr size_t kLocalsInitial = 64;
 
 class JNIEnvExt : public JNIEnv {
  public:
@@ -114,6 +114,16 @@ class JNIEnvExt : public JNIEnv {
   bool IsRuntimeDeleted() const { return runtime_deleted_.load(std::memory_order_relaxed); }
   bool IsCheckJniEnabled() const { return check_jni_; }
 
+  // Returns true for one in `sample_rate` calls, selecting the JNI calls that get the thorough
+  // CheckJNI checks.
+  bool SampleCheckJniCall(uint32_t sample_rate) {
+    ++check_jni_sample_count_;
+    if (check_jni_sample_count_ < sample_rate) {
+      return false;
+    }
+    check_jni_sample_count_ = 0u;
+    return true;
+  }
 
   // Functions to keep track of monitor lock and unlock operations. Used to ensure proper locking
   // rules in CheckJNI mode.
@@ -206,6 +216,9 @@ class JNIEnvExt : public JNIEnv {
   // Frequently-accessed fields cached from JavaVM.
   bool check_jni_;
 
+  // Number of JNI calls since the last one that was checked thoroughly by sampled CheckJNI.
+  uint32_t check_jni_sample_count_;
+
   // If we are a JNI env for a daemon thread with a deleted runtime.
   std::atomic<bool> runtime_deleted_;
 
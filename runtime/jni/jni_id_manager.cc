@@ -51,8 +51,29 @@ namespace jni {
 
 constexpr bool kTraceIds = false;
 
-// TODO This whole thing could be done lock & wait free (since we never remove anything from the
-// ids list). It's not clear this would be worthwile though.
+template <typename ArtType>
+JniIdTable<ArtType>::~JniIdTable() {
+  for (std::atomic<std::atomic<ArtType*>*>& chunk : chunks_) {
+    delete[] chunk.load(std::memory_order_relaxed);
+  }
+}
+
+template <typename ArtType>
+void JniIdTable<ArtType>::Set(size_t index, ArtType* value) {
+  size_t chunk_index;
+  size_t offset = GetChunkOffset(index, &chunk_index);
+  std::atomic<ArtType*>* chunk = chunks_[chunk_index].load(std::memory_order_relaxed);
+  if (chunk == nullptr) {
+    size_t chunk_size = static_cast<size_t>(1u) << (kFirstChunkShift + chunk_index);
+    chunk = new std::atomic<ArtType*>[chunk_size]();
+    // Publish the zero-initialized chunk before any id that refers to it.
+    chunks_[chunk_index].store(chunk, std::memory_order_release);
+  }
+  chunk[offset].store(value, std::memory_order_release);
+  if (index >= size_.load(std::memory_order_relaxed)) {
+    size_.store(index + 1u, std::memory_order_release);
+  }
+}
 
 namespace {
 
@@ -242,12 +263,12 @@ uintptr_t JniIdManager::GetNextId<ArtMethod>(JniIdType type) {
   return res;
 }
 template <>
-std::vector<ArtField*>& JniIdManager::GetGenericMap<ArtField>() {
+JniIdTable<ArtField>& JniIdManager::GetGenericMap<ArtField>() {
   return field_id_map_;
 }
 
 template <>
-std::vector<ArtMethod*>& JniIdManager::GetGenericMap<ArtMethod>() {
+JniIdTable<ArtMethod>& JniIdManager::GetGenericMap<ArtMethod>() {
   return method_id_map_;
 }
 template <>
@@ -325,34 +346,20 @@ uintptr_t JniIdManager::EncodeGenericId(ReflectiveHandle<ArtType> t) {
         << "deferred_allocation_refcount_: " << deferred_allocation_refcount_
         << " t: " << PrettyGeneric(t);
     // Check to see if we raced and lost to another thread.
-    const std::vector<ArtType*>& vec = GetGenericMap<ArtType>();
-    bool found = false;
-    // simple count-while.
-    size_t search_start_index = IdToIndex(GetLinearSearchStartId(t));
-    size_t index = std::count_if(vec.cbegin() + search_start_index,
-                                 vec.cend(),
-                                 [&found, &self, t](const ArtType* candidate) {
-                                   Locks::mutator_lock_->AssertSharedHeld(self);
-                                   found = found || candidate == t.Get();
-                                   return !found;
-                                 }) +
-                   search_start_index;
-    if (found) {
-      // We were either racing some other thread and lost or this thread was asked to encode the
-      // same method multiple times while holding the mutator lock.
-      DCHECK_EQ(vec[index], t.Get())
-          << "Expected: " << PrettyGeneric(vec[index]) << " got " << PrettyGeneric(t)
-          << " at index " << index << " (id: " << IndexToId(index) << ").";
-      return IndexToId(index);
+    const JniIdTable<ArtType>& map = GetGenericMap<ArtType>();
+    for (size_t index = IdToIndex(GetLinearSearchStartId(t)), size = map.Size();
+         index < size;
+         ++index) {
+      if (map.Get(index) == t.Get()) {
+        // We were either racing some other thread and lost or this thread was asked to encode the
+        // same method multiple times while holding the mutator lock.
+        return IndexToId(index);
+      }
     }
   }
   cur_id = GetNextId<ArtType>(id_type);
   DCHECK_EQ(cur_id % 2, 1u);
-  size_t cur_index = IdToIndex(cur_id);
-  std::vector<ArtType*>& vec = GetGenericMap<ArtType>();
-  vec.reserve(cur_index + 1);
-  vec.resize(std::max(vec.size(), cur_index + 1), nullptr);
-  vec[cur_index] = t.Get();
+  GetGenericMap<ArtType>().Set(IdToIndex(cur_id), t.Get());
   if (ids.IsNull()) {
     if (kIsDebugBuild && !IsObsolete(t)) {
       CHECK_NE(deferred_allocation_refcount_, 0u)
@@ -416,13 +423,13 @@ void JniIdManager::Init(Thread* self) {
 
 void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
   art::WriterMutexLock mu(Thread::Current(), *Locks::jni_id_lock_);
-  for (auto it = field_id_map_.begin(); it != field_id_map_.end(); ++it) {
-    ArtField* old_field = *it;
-    uintptr_t id = IndexToId(std::distance(field_id_map_.begin(), it));
+  for (size_t index = 0, size = field_id_map_.Size(); index != size; ++index) {
+    ArtField* old_field = field_id_map_.Get(index);
+    uintptr_t id = IndexToId(index);
     ArtField* new_field =
         rvv->VisitField(old_field, JniIdReflectiveSourceInfo(reinterpret_cast<jfieldID>(id)));
     if (old_field != new_field) {
-      *it = new_field;
+      field_id_map_.Set(index, new_field);
       ObjPtr<mirror::Class> old_class(old_field->GetDeclaringClass());
       ObjPtr<mirror::Class> new_class(new_field->GetDeclaringClass());
       ObjPtr<mirror::ClassExt> old_ext_data(old_class->GetExtData());
@@ -469,13 +476,13 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
       }
     }
   }
-  for (auto it = method_id_map_.begin(); it != method_id_map_.end(); ++it) {
-    ArtMethod* old_method = *it;
-    uintptr_t id = IndexToId(std::distance(method_id_map_.begin(), it));
+  for (size_t index = 0, size = method_id_map_.Size(); index != size; ++index) {
+    ArtMethod* old_method = method_id_map_.Get(index);
+    uintptr_t id = IndexToId(index);
     ArtMethod* new_method =
         rvv->VisitMethod(old_method, JniIdReflectiveSourceInfo(reinterpret_cast<jmethodID>(id)));
     if (old_method != new_method) {
-      *it = new_method;
+      method_id_map_.Set(index, new_method);
       ObjPtr<mirror::Class> old_class(old_method->GetDeclaringClass());
       ObjPtr<mirror::Class> new_class(new_method->GetDeclaringClass());
       ObjPtr<mirror::ClassExt> old_ext_data(old_class->GetExtData());
@@ -504,10 +511,8 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
 
 template <typename ArtType> ArtType* JniIdManager::DecodeGenericId(uintptr_t t) {
   if (Runtime::Current()->GetJniIdType() == JniIdType::kIndices && (t % 2) == 1) {
-    ReaderMutexLock mu(Thread::Current(), *Locks::jni_id_lock_);
-    size_t index = IdToIndex(t);
-    DCHECK_GT(GetGenericMap<ArtType>().size(), index);
-    return GetGenericMap<ArtType>().at(index);
+    // No lock needed, the table can be read concurrently with additions.
+    return GetGenericMap<ArtType>().Get(IdToIndex(t));
   } else {
     DCHECK_EQ((t % 2), 0u) << "id: " << t;
     return reinterpret_cast<ArtType*>(t);
@@ -657,7 +662,17 @@ void JniIdManager::EndDefer() {
   {
     ReaderMutexLock mu(self, *Locks::jni_id_lock_);
     ScopedAssertNoThreadSuspension sants(__FUNCTION__);
-    jidsrs.Initialize(method_id_map_, field_id_map_);
+    std::vector<ArtMethod*> methods;
+    methods.reserve(method_id_map_.Size());
+    for (size_t index = 0, size = method_id_map_.Size(); index != size; ++index) {
+      methods.push_back(method_id_map_.Get(index));
+    }
+    std::vector<ArtField*> fields;
+    fields.reserve(field_id_map_.Size());
+    for (size_t index = 0, size = field_id_map_.Size(); index != size; ++index) {
+      fields.push_back(field_id_map_.Get(index));
+    }
+    jidsrs.Initialize(methods, fields);
     method_start_id = deferred_allocation_method_id_start_;
     field_start_id = deferred_allocation_field_id_start_;
   }
@@ -687,5 +702,8 @@ ScopedEnableSuspendAllJniIdQueries::~ScopedEnableSuspendAllJniIdQueries() {
   manager_->EndDefer();
 }
 
+template class JniIdTable<ArtMethod>;
+template class JniIdTable<ArtField>;
+
 };  // namespace jni
 };  // namespace art
@@ -24,6 +24,7 @@
 
 #include "art_field.h"
 #include "art_method.h"
+#include "base/bit_utils.h"
 #include "base/mutex.h"
 #include "gc_root.h"
 #include "jni_id_type.h"
@@ -39,6 +40,52 @@ template<typename RT> class ReflectiveHandle;
 namespace jni {
 
 class ScopedEnableSuspendAllJniIdQueries;
+
+// The id->method/field map. Entries can be read without holding the jni_id_lock_, so decoding an
+// index id costs about the same as decoding a pointer id. The entries are stored in chunks that
+// double in size and are never moved or freed, so growing the table does not disturb readers.
+// Writers must hold the jni_id_lock_.
+template <typename ArtType>
+class JniIdTable {
+ public:
+  JniIdTable() : size_(0u), chunks_() {}
+  ~JniIdTable();
+
+  size_t Size() const {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  ArtType* Get(size_t index) const {
+    DCHECK_LT(index, Size());
+    size_t chunk_index;
+    size_t offset = GetChunkOffset(index, &chunk_index);
+    std::atomic<ArtType*>* chunk = chunks_[chunk_index].load(std::memory_order_acquire);
+    DCHECK(chunk != nullptr);
+    return chunk[offset].load(std::memory_order_acquire);
+  }
+
+  // Sets the entry, growing the table to include `index` if needed.
+  void Set(size_t index, ArtType* value) REQUIRES(Locks::jni_id_lock_);
+
+ private:
+  // The first chunk has 2^kFirstChunkShift entries, chunk `n` has 2^(kFirstChunkShift + n).
+  static constexpr size_t kFirstChunkShift = 10u;
+  static constexpr size_t kMaxChunks = BitSizeOf<size_t>() - kFirstChunkShift;
+
+  static size_t GetChunkOffset(size_t index, /*out*/ size_t* chunk_index) {
+    // Chunk `n` starts at index 2^kFirstChunkShift * (2^n - 1).
+    size_t biased_index = index + (static_cast<size_t>(1u) << kFirstChunkShift);
+    size_t msb = static_cast<size_t>(MostSignificantBit(biased_index));
+    *chunk_index = msb - kFirstChunkShift;
+    return biased_index - (static_cast<size_t>(1u) << msb);
+  }
+
+  std::atomic<size_t> size_;
+  std::atomic<std::atomic<ArtType*>*> chunks_[kMaxChunks];
+
+  DISALLOW_COPY_AND_ASSIGN(JniIdTable);
+};
+
 class JniIdManager {
  public:
   template <typename T,
@@ -74,8 +121,7 @@ class JniIdManager {
       REQUIRES_SHARED(Locks::mutator_lock_);
   template <typename ArtType>
   ArtType* DecodeGenericId(uintptr_t input) REQUIRES(!Locks::jni_id_lock_);
-  template <typename ArtType> std::vector<ArtType*>& GetGenericMap()
-      REQUIRES(Locks::jni_id_lock_);
+  template <typename ArtType> JniIdTable<ArtType>& GetGenericMap();
   template <typename ArtType> uintptr_t GetNextId(JniIdType id)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::jni_id_lock_);
@@ -88,9 +134,9 @@ class JniIdManager {
   void EndDefer() REQUIRES(!Locks::jni_id_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
   uintptr_t next_method_id_ GUARDED_BY(Locks::jni_id_lock_) = 1u;
-  std::vector<ArtMethod*> method_id_map_ GUARDED_BY(Locks::jni_id_lock_);
+  JniIdTable<ArtMethod> method_id_map_;
   uintptr_t next_field_id_ GUARDED_BY(Locks::jni_id_lock_) = 1u;
-  std::vector<ArtField*> field_id_map_ GUARDED_BY(Locks::jni_id_lock_);
+  JniIdTable<ArtField> field_id_map_;
 
   // If non-zero indicates that some thread is trying to allocate ids without being able to update
   // the method->id mapping (due to not being able to allocate or something). In this case decode
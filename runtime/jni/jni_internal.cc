@@ -2049,7 +2049,9 @@ class JNI {
     if (heap->IsMovableObject(s)) {
       StackHandleScope<1> hs(soa.Self());
       HandleWrapperObjPtr<mirror::String> h(hs.NewHandleWrapper(&s));
-      if (!kUseReadBarrier) {
+      if (heap->TryPinObject(s)) {
+        // The CC collector does not evacuate the pinned region and keeps running meanwhile.
+      } else if (!kUseReadBarrier) {
         heap->IncrementDisableMovingGC(soa.Self());
       } else {
         // For the CC collector, we only need to wait for the thread flip rather than the whole GC
@@ -2084,7 +2086,9 @@ class JNI {
     gc::Heap* heap = Runtime::Current()->GetHeap();
     ObjPtr<mirror::String> s = soa.Decode<mirror::String>(java_string);
     if (heap->IsMovableObject(s)) {
-      if (!kUseReadBarrier) {
+      if (heap->UnpinObject(s)) {
+        // Unpinned the region pinned by GetStringCritical.
+      } else if (!kUseReadBarrier) {
         heap->DecrementDisableMovingGC(soa.Self());
       } else {
         heap->DecrementDisableThreadFlip(soa.Self());
@@ -2246,7 +2250,9 @@ class JNI {
     }
     gc::Heap* heap = Runtime::Current()->GetHeap();
     if (heap->IsMovableObject(array)) {
-      if (!kUseReadBarrier) {
+      if (heap->TryPinObject(array)) {
+        // The CC collector does not evacuate the pinned region and keeps running meanwhile.
+      } else if (!kUseReadBarrier) {
         heap->IncrementDisableMovingGC(soa.Self());
       } else {
         // For the CC collector, we only need to wait for the thread flip rather than the whole GC
@@ -2810,8 +2816,11 @@ class JNI {
       if (is_copy) {
         delete[] reinterpret_cast<uint64_t*>(elements);
       } else if (heap->IsMovableObject(array)) {
-        // Non copy to a movable object must means that we had disabled the moving GC.
-        if (!kUseReadBarrier) {
+        // Non copy to a movable object must means that we had pinned it or disabled the
+        // moving GC.
+        if (heap->UnpinObject(array)) {
+          // Unpinned the region pinned by GetPrimitiveArrayCritical.
+        } else if (!kUseReadBarrier) {
           heap->DecrementDisableMovingGC(soa.Self());
         } else {
           heap->DecrementDisableThreadFlip(soa.Self());
@@ -24,6 +24,7 @@
 #include "indirect_reference_table.h"
 #include "java_vm_ext.h"
 #include "jni_env_ext.h"
+#include "mirror/array-inl.h"
 #include "mirror/string-inl.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "scoped_thread_state_change-inl.h"
@@ -1492,6 +1493,23 @@ TEST_F(JniInternalTest, StaleWeakGlobal) {
   EXPECT_EQ(new_local_ref, nullptr);
 }
 
+TEST_F(JniInternalTest, PrimitiveArrayCriticalAcrossGc) {
+  jbyteArray array = env_->NewByteArray(16);
+  ASSERT_NE(array, nullptr);
+  void* elements = env_->GetPrimitiveArrayCritical(array, nullptr);
+  ASSERT_NE(elements, nullptr);
+  if (kUseReadBarrier) {
+    // The array's region is pinned instead of blocking the thread flip, so the concurrent
+    // copying collector can run a full cycle during the critical section.
+    Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  {
+    ScopedObjectAccess soa(env_);
+    EXPECT_EQ(elements, soa.Decode<mirror::ByteArray>(array)->GetData());
+  }
+  env_->ReleasePrimitiveArrayCritical(array, elements, 0);
+}
+
 TEST_F(JniInternalTest, NewStringUTF) {
   EXPECT_EQ(env_->NewStringUTF(nullptr), nullptr);
   jstring s;
@@ -16,31 +16,112 @@
 
 #include "linear_alloc.h"
 
+#include "base/allocator.h"
 #include "thread-current-inl.h"
 
 namespace art {
 
-LinearAlloc::LinearAlloc(ArenaPool* pool) : lock_("linear alloc"), allocator_(pool) {
+LinearAlloc::LinearAlloc(ArenaPool* pool)
+    : lock_("linear alloc"),
+      allocator_(pool),
+      chunk_pos_(nullptr),
+      chunk_end_(nullptr),
+      tracked_bytes_(0u) {
+}
+
+LinearAlloc::~LinearAlloc() {
+  TrackedAllocators::RegisterFree(kAllocatorTagLinearAlloc, tracked_bytes_);
+}
+
+inline void LinearAlloc::RegisterAllocation(size_t bytes) {
+  tracked_bytes_ += bytes;
+  TrackedAllocators::RegisterAllocation(kAllocatorTagLinearAlloc, bytes);
+}
+
+inline void* LinearAlloc::TryAllocFromChunk(size_t size, size_t alignment) {
+  uint8_t* pos = chunk_pos_.load(std::memory_order_acquire);
+  while (pos != nullptr) {
+    uint8_t* end = chunk_end_.load(std::memory_order_acquire);
+    uint8_t* ret = AlignUp(pos, alignment);
+    if (ret > end || size > static_cast<size_t>(end - ret)) {
+      return nullptr;
+    }
+    if (chunk_pos_.compare_exchange_weak(pos, ret + size, std::memory_order_acq_rel)) {
+      return ret;
+    }
+  }
+  return nullptr;
+}
+
+void* LinearAlloc::AllocSlowPath(Thread* self, size_t size, size_t alignment) {
+  MutexLock mu(self, lock_);
+  if (UNLIKELY(allocator_.IsRunningOnMemoryTool()) || size > kMaxChunkAllocationSize) {
+    RegisterAllocation(size);
+    return (alignment == 16u) ? allocator_.AllocAlign16(size) : allocator_.Alloc(size);
+  }
+  // Another thread may have replaced the chunk while we were waiting for the lock.
+  void* ret = TryAllocFromChunk(size, alignment);
+  if (ret != nullptr) {
+    return ret;
+  }
+  // Stop allocations from the old chunk while the new chunk is installed. The rest of the old
+  // chunk is wasted.
+  chunk_pos_.store(nullptr, std::memory_order_release);
+  uint8_t* chunk = reinterpret_cast<uint8_t*>(allocator_.AllocAlign16(kChunkSize));
+  RegisterAllocation(kChunkSize);
+  chunk_end_.store(chunk + kChunkSize, std::memory_order_release);
+  DCHECK_ALIGNED_PARAM(chunk, alignment);
+  chunk_pos_.store(chunk + size, std::memory_order_release);
+  return chunk;
 }
 
 void* LinearAlloc::Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size) {
+  DCHECK_GE(new_size, old_size);
+  // Extend in place if nothing else was allocated from the chunk after `ptr`.
+  const size_t aligned_old_size = RoundUp(old_size, ArenaAllocator::kAlignment);
+  const size_t aligned_new_size = RoundUp(new_size, ArenaAllocator::kAlignment);
+  uint8_t* old_end = reinterpret_cast<uint8_t*>(ptr) + aligned_old_size;
+  uint8_t* pos = old_end;
+  if (ptr != nullptr &&
+      old_end <= chunk_end_.load(std::memory_order_acquire) &&
+      aligned_new_size - aligned_old_size <=
+          static_cast<size_t>(chunk_end_.load(std::memory_order_acquire) - old_end) &&
+      chunk_pos_.compare_exchange_strong(pos,
+                                         reinterpret_cast<uint8_t*>(ptr) + aligned_new_size,
+                                         std::memory_order_acq_rel)) {
+    return ptr;
+  }
+  if (!allocator_.IsRunningOnMemoryTool() && new_size <= kMaxChunkAllocationSize) {
+    void* new_ptr = Alloc(self, new_size);
+    memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+  }
   MutexLock mu(self, lock_);
+  RegisterAllocation(new_size);
   return allocator_.Realloc(ptr, old_size, new_size);
 }
 
 void* LinearAlloc::Alloc(Thread* self, size_t size) {
-  MutexLock mu(self, lock_);
-  return allocator_.Alloc(size);
+  size = RoundUp(size, ArenaAllocator::kAlignment);
+  void* ret = TryAllocFromChunk(size, ArenaAllocator::kAlignment);
+  return (ret != nullptr) ? ret : AllocSlowPath(self, size, ArenaAllocator::kAlignment);
 }
 
 void* LinearAlloc::AllocAlign16(Thread* self, size_t size) {
-  MutexLock mu(self, lock_);
-  return allocator_.AllocAlign16(size);
+  // It is an error to request 16-byte aligned allocation of unaligned size.
+  DCHECK_ALIGNED(size, 16);
+  void* ret = TryAllocFromChunk(size, 16u);
+  return (ret != nullptr) ? ret : AllocSlowPath(self, size, 16u);
 }
 
 size_t LinearAlloc::GetUsedMemory() const {
   MutexLock mu(Thread::Current(), lock_);
-  return allocator_.BytesUsed();
+  // The unused part of the current chunk does not count as used. It cannot be replaced while
+  // we hold `lock_`, but it can still shrink.
+  uint8_t* pos = chunk_pos_.load(std::memory_order_acquire);
+  uint8_t* end = chunk_end_.load(std::memory_order_acquire);
+  size_t unused = (pos != nullptr) ? static_cast<size_t>(end - pos) : 0u;
+  return allocator_.BytesUsed() - unused;
 }
 
 ArenaPool* LinearAlloc::GetArenaPool() {
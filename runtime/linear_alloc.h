@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_LINEAR_ALLOC_H_
 #define ART_RUNTIME_LINEAR_ALLOC_H_
 
+#include <atomic>
+
 #include "base/arena_allocator.h"
 #include "base/mutex.h"
 
@@ -28,6 +30,7 @@ class ArenaPool;
 class LinearAlloc {
  public:
   explicit LinearAlloc(ArenaPool* pool);
+  ~LinearAlloc();
 
   void* Alloc(Thread* self, size_t size) REQUIRES(!lock_);
   void* AllocAlign16(Thread* self, size_t size) REQUIRES(!lock_);
@@ -54,9 +57,33 @@ class LinearAlloc {
   bool ContainsUnsafe(void* ptr) const NO_THREAD_SAFETY_ANALYSIS;
 
  private:
+  // Small allocations are bump-allocated with a compare-and-swap from a chunk carved out of
+  // `allocator_`, so that threads loading classes in parallel do not serialize on `lock_`.
+  // Larger allocations, and all allocations when running on a memory tool, go directly to
+  // `allocator_` under `lock_`.
+  static constexpr size_t kChunkSize = 16 * KB;
+  static constexpr size_t kMaxChunkAllocationSize = kChunkSize / 8u;
+
+  // Try to allocate from the current chunk without taking `lock_`. Returns null on failure.
+  void* TryAllocFromChunk(size_t size, size_t alignment);
+  // Allocate from a new chunk, or from `allocator_` if the allocation is large.
+  void* AllocSlowPath(Thread* self, size_t size, size_t alignment) REQUIRES(!lock_);
+  // Count memory taken from `allocator_` for kAllocatorTagLinearAlloc.
+  void RegisterAllocation(size_t bytes) REQUIRES(lock_);
+
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ArenaAllocator allocator_ GUARDED_BY(lock_);
 
+  // The unused part of the current chunk. `chunk_pos_` is null while the chunk is replaced,
+  // which is done with `lock_` held. Chunks are carved out of `allocator_` in address order and
+  // never overlap, so a successful compare-and-swap of `chunk_pos_` always returns memory from
+  // the chunk that is current at that time.
+  std::atomic<uint8_t*> chunk_pos_;
+  std::atomic<uint8_t*> chunk_end_;
+
+  // Bytes registered for kAllocatorTagLinearAlloc, released when the allocator is deleted.
+  size_t tracked_bytes_ GUARDED_BY(lock_);
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(LinearAlloc);
 };
 
@@ -76,9 +76,15 @@ inline uint32_t DexCache::ClassSize(PointerSize pointer_size) {
   return Class::ComputeClassSize(true, vtable_entries, 0, 0, 0, 0, 0, pointer_size);
 }
 
+inline void DexCache::RecordLookup(CacheKind kind, bool hit) {
+  if (kCollectStats) {
+    CountLookup(kind, hit);
+  }
+}
+
 inline uint32_t DexCache::StringSlotIndex(dex::StringIndex string_idx) {
   DCHECK_LT(string_idx.index_, GetDexFile()->NumStringIds());
-  const uint32_t slot_idx = string_idx.index_ % kDexCacheStringCacheSize;
+  const uint32_t slot_idx = SlotIndexForIds(string_idx.index_, NumStrings());
   DCHECK_LT(slot_idx, NumStrings());
   return slot_idx;
 }
@@ -98,8 +104,10 @@ inline String* DexCache::GetResolvedString(dex::StringIndex string_idx) {
       }
     }
   }
-  return GetStrings()[StringSlotIndex(string_idx)].load(
+  String* string = GetStrings()[StringSlotIndex(string_idx)].load(
       std::memory_order_relaxed).GetObjectForIndex(string_idx.index_);
+  RecordLookup(CacheKind::kStrings, string != nullptr);
+  return string;
 }
 
 inline void DexCache::SetResolvedString(dex::StringIndex string_idx, ObjPtr<String> resolved) {
@@ -150,7 +158,7 @@ inline void DexCache::ClearString(dex::StringIndex string_idx) {
 
 inline uint32_t DexCache::TypeSlotIndex(dex::TypeIndex type_idx) {
   DCHECK_LT(type_idx.index_, GetDexFile()->NumTypeIds());
-  const uint32_t slot_idx = type_idx.index_ % kDexCacheTypeCacheSize;
+  const uint32_t slot_idx = SlotIndexForIds(type_idx.index_, NumResolvedTypes());
   DCHECK_LT(slot_idx, NumResolvedTypes());
   return slot_idx;
 }
@@ -158,8 +166,10 @@ inline uint32_t DexCache::TypeSlotIndex(dex::TypeIndex type_idx) {
 inline Class* DexCache::GetResolvedType(dex::TypeIndex type_idx) {
   // It is theorized that a load acquire is not required since obtaining the resolved class will
   // always have an address dependency or a lock.
-  return GetResolvedTypes()[TypeSlotIndex(type_idx)].load(
+  Class* type = GetResolvedTypes()[TypeSlotIndex(type_idx)].load(
       std::memory_order_relaxed).GetObjectForIndex(type_idx.index_);
+  RecordLookup(CacheKind::kTypes, type != nullptr);
+  return type;
 }
 
 inline void DexCache::SetResolvedType(dex::TypeIndex type_idx, ObjPtr<Class> resolved) {
@@ -189,14 +199,16 @@ inline void DexCache::ClearResolvedType(dex::TypeIndex type_idx) {
 inline uint32_t DexCache::MethodTypeSlotIndex(dex::ProtoIndex proto_idx) {
   DCHECK(Runtime::Current()->IsMethodHandlesEnabled());
   DCHECK_LT(proto_idx.index_, GetDexFile()->NumProtoIds());
-  const uint32_t slot_idx = proto_idx.index_ % kDexCacheMethodTypeCacheSize;
+  const uint32_t slot_idx = SlotIndexForIds(proto_idx.index_, NumResolvedMethodTypes());
   DCHECK_LT(slot_idx, NumResolvedMethodTypes());
   return slot_idx;
 }
 
 inline MethodType* DexCache::GetResolvedMethodType(dex::ProtoIndex proto_idx) {
-  return GetResolvedMethodTypes()[MethodTypeSlotIndex(proto_idx)].load(
+  MethodType* method_type = GetResolvedMethodTypes()[MethodTypeSlotIndex(proto_idx)].load(
       std::memory_order_relaxed).GetObjectForIndex(proto_idx.index_);
+  RecordLookup(CacheKind::kMethodTypes, method_type != nullptr);
+  return method_type;
 }
 
 inline void DexCache::SetResolvedMethodType(dex::ProtoIndex proto_idx, MethodType* resolved) {
@@ -239,7 +251,7 @@ inline ObjPtr<CallSite> DexCache::SetResolvedCallSite(uint32_t call_site_idx,
 
 inline uint32_t DexCache::FieldSlotIndex(uint32_t field_idx) {
   DCHECK_LT(field_idx, GetDexFile()->NumFieldIds());
-  const uint32_t slot_idx = field_idx % kDexCacheFieldCacheSize;
+  const uint32_t slot_idx = SlotIndexForIds(field_idx, NumResolvedFields());
   DCHECK_LT(slot_idx, NumResolvedFields());
   return slot_idx;
 }
@@ -247,7 +259,9 @@ inline uint32_t DexCache::FieldSlotIndex(uint32_t field_idx) {
 inline ArtField* DexCache::GetResolvedField(uint32_t field_idx, PointerSize ptr_size) {
   DCHECK_EQ(Runtime::Current()->GetClassLinker()->GetImagePointerSize(), ptr_size);
   auto pair = GetNativePairPtrSize(GetResolvedFields(), FieldSlotIndex(field_idx), ptr_size);
-  return pair.GetObjectForIndex(field_idx);
+  ArtField* field = pair.GetObjectForIndex(field_idx);
+  RecordLookup(CacheKind::kFields, field != nullptr);
+  return field;
 }
 
 inline void DexCache::SetResolvedField(uint32_t field_idx, ArtField* field, PointerSize ptr_size) {
@@ -279,7 +293,9 @@ inline uint32_t DexCache::MethodSlotIndex(uint32_t method_idx) {
 inline ArtMethod* DexCache::GetResolvedMethod(uint32_t method_idx, PointerSize ptr_size) {
   DCHECK_EQ(Runtime::Current()->GetClassLinker()->GetImagePointerSize(), ptr_size);
   auto pair = GetNativePairPtrSize(GetResolvedMethods(), MethodSlotIndex(method_idx), ptr_size);
-  return pair.GetObjectForIndex(method_idx);
+  ArtMethod* method = pair.GetObjectForIndex(method_idx);
+  RecordLookup(CacheKind::kMethods, method != nullptr);
+  return method;
 }
 
 inline void DexCache::SetResolvedMethod(uint32_t method_idx,
@@ -16,6 +16,8 @@
 
 #include "dex_cache-inl.h"
 
+#include <ostream>
+
 #include "art_method-inl.h"
 #include "class_linker.h"
 #include "gc/accounting/card_table-inl.h"
@@ -68,18 +70,9 @@ void DexCache::InitializeDexCache(Thread* self,
   FieldDexCacheType* fields = (dex_file->NumFieldIds() == 0u) ? nullptr :
       reinterpret_cast<FieldDexCacheType*>(raw_arrays + layout.FieldsOffset());
 
-  size_t num_strings = kDexCacheStringCacheSize;
-  if (dex_file->NumStringIds() < num_strings) {
-    num_strings = dex_file->NumStringIds();
-  }
-  size_t num_types = kDexCacheTypeCacheSize;
-  if (dex_file->NumTypeIds() < num_types) {
-    num_types = dex_file->NumTypeIds();
-  }
-  size_t num_fields = kDexCacheFieldCacheSize;
-  if (dex_file->NumFieldIds() < num_fields) {
-    num_fields = dex_file->NumFieldIds();
-  }
+  size_t num_strings = CacheSizeForIds(dex_file->NumStringIds(), kDexCacheStringCacheSize);
+  size_t num_types = CacheSizeForIds(dex_file->NumTypeIds(), kDexCacheTypeCacheSize);
+  size_t num_fields = CacheSizeForIds(dex_file->NumFieldIds(), kDexCacheFieldCacheSize);
   size_t num_methods = kDexCacheMethodCacheSize;
   if (dex_file->NumMethodIds() < num_methods) {
     num_methods = dex_file->NumMethodIds();
@@ -94,11 +87,7 @@ void DexCache::InitializeDexCache(Thread* self,
   MethodTypeDexCacheType* method_types = nullptr;
   size_t num_method_types = 0;
 
-  if (dex_file->NumProtoIds() < kDexCacheMethodTypeCacheSize) {
-    num_method_types = dex_file->NumProtoIds();
-  } else {
-    num_method_types = kDexCacheMethodTypeCacheSize;
-  }
+  num_method_types = CacheSizeForIds(dex_file->NumProtoIds(), kDexCacheMethodTypeCacheSize);
 
   if (num_method_types > 0) {
     method_types = reinterpret_cast<MethodTypeDexCacheType*>(
@@ -285,6 +274,27 @@ void DexCache::SetClassLoader(ObjPtr<ClassLoader> class_loader) {
   SetFieldObject<false>(OFFSET_OF_OBJECT_MEMBER(DexCache, class_loader_), class_loader);
 }
 
+static constexpr size_t kNumCacheKinds = static_cast<size_t>(DexCache::CacheKind::kLast) + 1u;
+static std::atomic<uint64_t> gLookupHits[kNumCacheKinds];
+static std::atomic<uint64_t> gLookupMisses[kNumCacheKinds];
+
+void DexCache::CountLookup(CacheKind kind, bool hit) {
+  std::atomic<uint64_t>* counters = hit ? gLookupHits : gLookupMisses;
+  counters[static_cast<size_t>(kind)].fetch_add(1u, std::memory_order_relaxed);
+}
+
+void DexCache::DumpStats(std::ostream& os) {
+  static const char* const kCacheNames[kNumCacheKinds] = {
+      "types", "strings", "fields", "methods", "method types"
+  };
+  os << "Dex cache lookups (hits/misses):";
+  for (size_t i = 0; i != kNumCacheKinds; ++i) {
+    os << " " << kCacheNames[i] << " " << gLookupHits[i].load(std::memory_order_relaxed)
+       << "/" << gLookupMisses[i].load(std::memory_order_relaxed);
+  }
+  os << "\n";
+}
+
 #if !defined(__aarch64__) && !defined(__x86_64__)
 static pthread_mutex_t dex_cache_slow_atomic_mutex = PTHREAD_MUTEX_INITIALIZER;
 
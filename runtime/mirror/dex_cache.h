@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_MIRROR_DEX_CACHE_H_
 #define ART_RUNTIME_MIRROR_DEX_CACHE_H_
 
+#include <algorithm>
+#include <iosfwd>
+
 #include "array.h"
 #include "base/bit_utils.h"
 #include "base/locks.h"
@@ -135,17 +138,17 @@ class MANAGED DexCache final : public Object {
   // Size of java.lang.DexCache.class.
   static uint32_t ClassSize(PointerSize pointer_size);
 
-  // Size of type dex cache. Needs to be a power of 2 for entrypoint assumptions to hold.
+  // Minimum size of type dex cache for dex files with more type ids, see CacheSizeForIds().
   static constexpr size_t kDexCacheTypeCacheSize = 1024;
   static_assert(IsPowerOfTwo(kDexCacheTypeCacheSize),
                 "Type dex cache size is not a power of 2.");
 
-  // Size of string dex cache. Needs to be a power of 2 for entrypoint assumptions to hold.
+  // Minimum size of string dex cache for dex files with more string ids, see CacheSizeForIds().
   static constexpr size_t kDexCacheStringCacheSize = 1024;
   static_assert(IsPowerOfTwo(kDexCacheStringCacheSize),
                 "String dex cache size is not a power of 2.");
 
-  // Size of field dex cache. Needs to be a power of 2 for entrypoint assumptions to hold.
+  // Minimum size of field dex cache for dex files with more field ids, see CacheSizeForIds().
   static constexpr size_t kDexCacheFieldCacheSize = 1024;
   static_assert(IsPowerOfTwo(kDexCacheFieldCacheSize),
                 "Field dex cache size is not a power of 2.");
@@ -155,12 +158,51 @@ class MANAGED DexCache final : public Object {
   static_assert(IsPowerOfTwo(kDexCacheMethodCacheSize),
                 "Method dex cache size is not a power of 2.");
 
-  // Size of method type dex cache. Needs to be a power of 2 for entrypoint assumptions
-  // to hold.
+  // Minimum size of method type dex cache for dex files with more proto ids,
+  // see CacheSizeForIds().
   static constexpr size_t kDexCacheMethodTypeCacheSize = 1024;
   static_assert(IsPowerOfTwo(kDexCacheMethodTypeCacheSize),
                 "MethodType dex cache size is not a power of 2.");
 
+  // The type, string, field and method type caches of large dex files get a slot for every
+  // kDexCacheIdsPerSlot ids, up to kDexCacheMaxCacheSize slots. The method cache keeps its
+  // fixed size since the IMT conflict trampolines rely on it.
+  static constexpr size_t kDexCacheIdsPerSlot = 8u;
+  static constexpr size_t kDexCacheMaxCacheSize = 16 * 1024;
+  static_assert(IsPowerOfTwo(kDexCacheMaxCacheSize), "Max dex cache size is not a power of 2.");
+
+  // Returns the number of slots of a cache for `num_ids` ids with the minimum size `cache_size`.
+  // Dex files with at most `cache_size` ids get a direct array with a slot for each id, larger
+  // ones get a hashed cache with a power of 2 number of slots.
+  static constexpr size_t CacheSizeForIds(size_t num_ids, size_t cache_size) {
+    return (num_ids <= cache_size)
+        ? num_ids
+        : std::max(cache_size,
+                   std::min(RoundUpToPowerOfTwo(num_ids / kDexCacheIdsPerSlot),
+                            kDexCacheMaxCacheSize));
+  }
+
+  // Returns the slot of `idx` in a cache with `num_slots` slots, see CacheSizeForIds().
+  static constexpr uint32_t SlotIndexForIds(uint32_t idx, size_t num_slots) {
+    // Direct arrays have a slot for each index. For hashed caches, indexes below the size map
+    // to themselves either way.
+    return (idx < num_slots) ? idx : idx & static_cast<uint32_t>(num_slots - 1u);
+  }
+
+  // Whether to count the lookups that hit and miss in the caches, see DumpStats().
+  static constexpr bool kCollectStats = false;
+
+  enum class CacheKind : size_t {
+    kTypes,
+    kStrings,
+    kFields,
+    kMethods,
+    kMethodTypes,
+    kLast = kMethodTypes,
+  };
+
+  static void DumpStats(std::ostream& os);
+
   static constexpr size_t StaticTypeSize() {
     return kDexCacheTypeCacheSize;
   }
@@ -469,6 +511,8 @@ class MANAGED DexCache final : public Object {
     return sizeof(GcRoot<mirror::String>) * num_strings;
   }
 
+  ALWAYS_INLINE static void RecordLookup(CacheKind kind, bool hit);
+
   uint32_t StringSlotIndex(dex::StringIndex string_idx) REQUIRES_SHARED(Locks::mutator_lock_);
   uint32_t TypeSlotIndex(dex::TypeIndex type_idx) REQUIRES_SHARED(Locks::mutator_lock_);
   uint32_t FieldSlotIndex(uint32_t field_idx) REQUIRES_SHARED(Locks::mutator_lock_);
@@ -483,6 +527,8 @@ class MANAGED DexCache final : public Object {
   void SetClassLoader(ObjPtr<ClassLoader> class_loader) REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  static void CountLookup(CacheKind kind, bool hit);
+
   void Init(const DexFile* dex_file,
             ObjPtr<String> location,
             StringDexCacheType* strings,
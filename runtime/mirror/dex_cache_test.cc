@@ -50,16 +50,36 @@ TEST_F(DexCacheTest, Open) {
           Runtime::Current()->GetLinearAlloc())));
   ASSERT_TRUE(dex_cache != nullptr);
 
-  EXPECT_TRUE(dex_cache->StaticStringSize() == dex_cache->NumStrings()
-      || java_lang_dex_file_->NumStringIds() == dex_cache->NumStrings());
-  EXPECT_TRUE(dex_cache->StaticTypeSize() == dex_cache->NumResolvedTypes()
-      || java_lang_dex_file_->NumTypeIds() == dex_cache->NumResolvedTypes());
+  EXPECT_EQ(DexCache::CacheSizeForIds(java_lang_dex_file_->NumStringIds(),
+                                      DexCache::kDexCacheStringCacheSize),
+            dex_cache->NumStrings());
+  EXPECT_EQ(DexCache::CacheSizeForIds(java_lang_dex_file_->NumTypeIds(),
+                                      DexCache::kDexCacheTypeCacheSize),
+            dex_cache->NumResolvedTypes());
   EXPECT_TRUE(dex_cache->StaticMethodSize() == dex_cache->NumResolvedMethods()
       || java_lang_dex_file_->NumMethodIds() == dex_cache->NumResolvedMethods());
-  EXPECT_TRUE(dex_cache->StaticArtFieldSize() == dex_cache->NumResolvedFields()
-      || java_lang_dex_file_->NumFieldIds() ==  dex_cache->NumResolvedFields());
-  EXPECT_TRUE(dex_cache->StaticMethodTypeSize() == dex_cache->NumResolvedMethodTypes()
-      || java_lang_dex_file_->NumProtoIds() == dex_cache->NumResolvedMethodTypes());
+  EXPECT_EQ(DexCache::CacheSizeForIds(java_lang_dex_file_->NumFieldIds(),
+                                      DexCache::kDexCacheFieldCacheSize),
+            dex_cache->NumResolvedFields());
+  EXPECT_EQ(DexCache::CacheSizeForIds(java_lang_dex_file_->NumProtoIds(),
+                                      DexCache::kDexCacheMethodTypeCacheSize),
+            dex_cache->NumResolvedMethodTypes());
+}
+
+TEST_F(DexCacheTest, CacheSizeForIds) {
+  // Small dex files get a slot for each id.
+  EXPECT_EQ(0u, DexCache::CacheSizeForIds(0u, DexCache::kDexCacheTypeCacheSize));
+  EXPECT_EQ(100u, DexCache::CacheSizeForIds(100u, DexCache::kDexCacheTypeCacheSize));
+  EXPECT_EQ(1024u, DexCache::CacheSizeForIds(1024u, DexCache::kDexCacheTypeCacheSize));
+  // Larger ones get a power of 2 number of slots between the minimum and maximum size.
+  EXPECT_EQ(1024u, DexCache::CacheSizeForIds(1025u, DexCache::kDexCacheTypeCacheSize));
+  EXPECT_EQ(4096u, DexCache::CacheSizeForIds(30000u, DexCache::kDexCacheTypeCacheSize));
+  EXPECT_EQ(DexCache::kDexCacheMaxCacheSize,
+            DexCache::CacheSizeForIds(1000000u, DexCache::kDexCacheTypeCacheSize));
+
+  EXPECT_EQ(5u, DexCache::SlotIndexForIds(5u, 100u));
+  EXPECT_EQ(5u, DexCache::SlotIndexForIds(5u, 4096u));
+  EXPECT_EQ(29000u - 7u * 4096u, DexCache::SlotIndexForIds(29000u, 4096u));
 }
 
 TEST_F(DexCacheMethodHandlesTest, Open) {
@@ -72,8 +92,9 @@ TEST_F(DexCacheMethodHandlesTest, Open) {
           *java_lang_dex_file_,
           Runtime::Current()->GetLinearAlloc())));
 
-  EXPECT_TRUE(dex_cache->StaticMethodTypeSize() == dex_cache->NumResolvedMethodTypes()
-      || java_lang_dex_file_->NumProtoIds() == dex_cache->NumResolvedMethodTypes());
+  EXPECT_EQ(DexCache::CacheSizeForIds(java_lang_dex_file_->NumProtoIds(),
+                                      DexCache::kDexCacheMethodTypeCacheSize),
+            dex_cache->NumResolvedMethodTypes());
 }
 
 TEST_F(DexCacheTest, LinearAlloc) {
@@ -181,6 +181,19 @@ void Object::SetHashCodeSeed(uint32_t new_seed) {
   hash_code_seed.store(new_seed, std::memory_order_relaxed);
 }
 
+bool Object::HasAddressIdentityHashCode() {
+  Runtime* runtime = Runtime::Current();
+  return runtime->UseAddressIdentityHash() && !runtime->GetHeap()->IsMovableObject(this);
+}
+
+uint32_t Object::AddressIdentityHashCode() {
+  // Multiplicative hashing of the aligned address; distinct for objects less than 2GiB apart.
+  uint32_t hash =
+      static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this) >> kObjectAlignmentShift);
+  hash = (hash * 2654435761u) & LockWord::kHashMask;
+  return (hash != 0u) ? hash : 1u;
+}
+
 int32_t Object::IdentityHashCode() {
   ObjPtr<Object> current_this = this;  // The this pointer may get invalidated by thread suspension.
   while (true) {
@@ -189,7 +202,10 @@ int32_t Object::IdentityHashCode() {
       case LockWord::kUnlocked: {
         // Try to compare and swap in a new hash, if we succeed we will return the hash on the next
         // loop iteration.
-        LockWord hash_word = LockWord::FromHashCode(GenerateIdentityHashCode(), lw.GCState());
+        uint32_t hash_code = current_this->HasAddressIdentityHashCode()
+            ? current_this->AddressIdentityHashCode()
+            : GenerateIdentityHashCode();
+        LockWord hash_word = LockWord::FromHashCode(hash_code, lw.GCState());
         DCHECK_EQ(hash_word.GetState(), LockWord::kHashCode);
         // Use a strong CAS to prevent spurious failures since these can make the boot image
         // non-deterministic.
@@ -199,6 +215,10 @@ int32_t Object::IdentityHashCode() {
         break;
       }
       case LockWord::kThinLocked: {
+        if (current_this->HasAddressIdentityHashCode()) {
+          // The hash code does not need to be stored, keep the lock thin.
+          return current_this->AddressIdentityHashCode();
+        }
         // Inflate the thin lock to a monitor and stick the hash code inside of the monitor. May
         // fail spuriously.
         Thread* self = Thread::Current();
@@ -653,6 +653,12 @@ class MANAGED LOCKABLE Object {
   // Generate an identity hash code. Public for object test.
   static uint32_t GenerateIdentityHashCode();
 
+  // Returns whether the identity hash code of this object is AddressIdentityHashCode(). That
+  // is the case for objects that never move, see Runtime::UseAddressIdentityHash(). Such hash
+  // code may be dropped from the lock word when the object gets thin locked.
+  bool HasAddressIdentityHashCode() REQUIRES_SHARED(Locks::mutator_lock_);
+  uint32_t AddressIdentityHashCode();
+
   // Returns a human-readable form of the name of the *class* of the given object.
   // So given an instance of java.lang.String, the output would
   // be "java.lang.String". Given an array of int, the output would be "int[]".
@@ -19,6 +19,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <memory>
+#include <vector>
 
 #include "array-alloc-inl.h"
 #include "array-inl.h"
@@ -517,6 +518,53 @@ TEST_F(ObjectTest, StringCompareTo) {
   EXPECT_GT(0, string_5->CompareTo(string.Get()));
 }
 
+// Long strings exercise the vectorized paths in String; the length and the mismatch positions
+// straddle the 8- and 16-character blocks.
+TEST_F(ObjectTest, StringCompareToAndIndexOfLong) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<3> hs(soa.Self());
+  constexpr int32_t kLength = 37;
+  std::vector<uint16_t> chars(kLength);
+  for (int32_t i = 0; i != kLength; ++i) {
+    chars[i] = 'a' + (i % 26);
+  }
+  Handle<String> string(
+      hs.NewHandle(String::AllocFromUtf16(soa.Self(), kLength, chars.data())));
+  ASSERT_EQ(kUseStringCompression, string->IsCompressed());
+  for (int32_t i = 0; i != kLength; ++i) {
+    EXPECT_EQ(i % 26, string->FastIndexOf(chars[i], 0));
+    EXPECT_EQ(i, string->FastIndexOf(chars[i], i));
+  }
+  EXPECT_EQ(-1, string->FastIndexOf('A', 0));
+  EXPECT_EQ(-1, string->FastIndexOf('a' + 0x100, 0));
+  EXPECT_EQ(-1, string->FastIndexOf('a', 27));
+
+  Handle<CharArray> array(hs.NewHandle(String::ToCharArray(string, soa.Self())));
+  ASSERT_TRUE(array != nullptr);
+  ASSERT_EQ(kLength, array->GetLength());
+  for (int32_t i = 0; i != kLength; ++i) {
+    EXPECT_EQ(chars[i], array->Get(i));
+  }
+
+  MutableHandle<String> other(hs.NewHandle<String>(nullptr));
+  for (int32_t i = 0; i != kLength; ++i) {
+    std::vector<uint16_t> other_chars = chars;
+    other_chars[i] = 'A';
+    other.Assign(String::AllocFromUtf16(soa.Self(), kLength, other_chars.data()));
+    EXPECT_EQ(chars[i] - 'A', string->CompareTo(other.Get()));
+    EXPECT_EQ('A' - chars[i], other->CompareTo(string.Get()));
+
+    // A non-ASCII character makes `other` uncompressed.
+    other_chars[i] = 0x3b1;
+    other.Assign(String::AllocFromUtf16(soa.Self(), kLength, other_chars.data()));
+    EXPECT_FALSE(other->IsCompressed());
+    EXPECT_EQ(chars[i] - 0x3b1, string->CompareTo(other.Get()));
+    EXPECT_EQ(0x3b1 - chars[i], other->CompareTo(string.Get()));
+    EXPECT_EQ(i, other->FastIndexOf(0x3b1, 0));
+    EXPECT_EQ(-1, other->FastIndexOf('A', 0));
+  }
+}
+
 TEST_F(ObjectTest, StringLength) {
   ScopedObjectAccess soa(Thread::Current());
   StackHandleScope<1> hs(soa.Self());
@@ -69,10 +69,9 @@ class SetStringCountAndBytesVisitor {
     int32_t length = String::GetLengthFromCount(count_);
     const uint8_t* const src = reinterpret_cast<uint8_t*>(src_array_->GetData()) + offset_;
     if (string->IsCompressed()) {
-      uint8_t* valueCompressed = string->GetValueCompressed();
-      for (int i = 0; i < length; i++) {
-        valueCompressed[i] = (src[i] & 0xFF);
-      }
+      memcpy(string->GetValueCompressed(), src, length * sizeof(uint8_t));
+    } else if (high_byte_ == 0) {
+      String::InflateChars(string->GetValue(), src, length);
     } else {
       uint16_t* value = string->GetValue();
       for (int i = 0; i < length; i++) {
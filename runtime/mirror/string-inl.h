@@ -18,8 +18,17 @@
 
 #include "string.h"
 
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <limits>
+
 #include "android-base/stringprintf.h"
 
+#include "base/bit_utils.h"
 #include "class-inl.h"
 #include "common_throws.h"
 #include "dex/utf.h"
@@ -57,14 +66,150 @@ inline uint16_t String::CharAt(int32_t index) {
 
 template <typename MemoryType>
 int32_t String::FastIndexOf(MemoryType* chars, int32_t ch, int32_t start) {
-  const MemoryType* p = chars + start;
+  if (static_cast<uint32_t>(ch) > std::numeric_limits<MemoryType>::max()) {
+    return -1;  // Not representable in `MemoryType`, e.g. a non-Latin-1 char in a compressed string.
+  }
   const MemoryType* end = chars + GetLength();
-  while (p < end) {
-    if (*p++ == ch) {
-      return (p - 1) - chars;
+  const MemoryType* p = FindChar(chars + start, end, static_cast<MemoryType>(ch));
+  return (p != end) ? p - chars : -1;
+}
+
+// The helpers below process 16 bytes per iteration with NEON or SSE2 and finish with a scalar
+// loop. Lane 0 always maps to the lowest bits of the comparison mask, so the first matching
+// (or mismatching) lane is found with CTZ.
+
+inline const uint8_t* String::FindChar(const uint8_t* p, const uint8_t* end, uint8_t ch) {
+#if defined(__aarch64__)
+  const uint8x16_t needle = vdupq_n_u8(ch);
+  for (; end - p >= 16; p += 16) {
+    uint8x16_t eq = vceqq_u8(vld1q_u8(p), needle);
+    // Narrow each 0x00/0xff byte to a nibble of a 64-bit mask.
+    uint64_t mask =
+        vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+    if (mask != 0u) {
+      return p + CTZ(mask) / 4u;
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi8(static_cast<char>(ch));
+  for (; end - p >= 16; p += 16) {
+    __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), needle);
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+    if (mask != 0u) {
+      return p + CTZ(mask);
+    }
+  }
+#endif
+  for (; p != end; ++p) {
+    if (*p == ch) {
+      return p;
+    }
+  }
+  return end;
+}
+
+inline const uint16_t* String::FindChar(const uint16_t* p, const uint16_t* end, uint16_t ch) {
+#if defined(__aarch64__)
+  const uint16x8_t needle = vdupq_n_u16(ch);
+  for (; end - p >= 8; p += 8) {
+    uint16x8_t eq = vceqq_u16(vld1q_u16(p), needle);
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(eq)), 0);
+    if (mask != 0u) {
+      return p + CTZ(mask) / 8u;
     }
   }
-  return -1;
+#elif defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi16(static_cast<int16_t>(ch));
+  for (; end - p >= 8; p += 8) {
+    __m128i eq = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), needle);
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+    if (mask != 0u) {
+      return p + CTZ(mask) / 2u;
+    }
+  }
+#endif
+  for (; p != end; ++p) {
+    if (*p == ch) {
+      return p;
+    }
+  }
+  return end;
+}
+
+inline int32_t String::CommonPrefixLength(const uint8_t* lhs, const uint8_t* rhs, int32_t count) {
+  int32_t i = 0;
+#if defined(__aarch64__)
+  for (; count - i >= 16; i += 16) {
+    uint8x16_t eq = vceqq_u8(vld1q_u8(lhs + i), vld1q_u8(rhs + i));
+    uint64_t mask =
+        ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+    if (mask != 0u) {
+      return i + static_cast<int32_t>(CTZ(mask) / 4u);
+    }
+  }
+#elif defined(__SSE2__)
+  for (; count - i >= 16; i += 16) {
+    __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i)),
+                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(eq)) ^ 0xffffu;
+    if (mask != 0u) {
+      return i + static_cast<int32_t>(CTZ(mask));
+    }
+  }
+#endif
+  while (i < count && lhs[i] == rhs[i]) {
+    ++i;
+  }
+  return i;
+}
+
+inline int32_t String::CommonPrefixLength(const uint8_t* lhs, const uint16_t* rhs, int32_t count) {
+  int32_t i = 0;
+#if defined(__aarch64__)
+  for (; count - i >= 8; i += 8) {
+    uint16x8_t eq = vceqq_u16(vmovl_u8(vld1_u8(lhs + i)), vld1q_u16(rhs + i));
+    uint64_t mask = ~vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(eq)), 0);
+    if (mask != 0u) {
+      return i + static_cast<int32_t>(CTZ(mask) / 8u);
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; count - i >= 8; i += 8) {
+    __m128i wide =
+        _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(lhs + i)), zero);
+    __m128i eq = _mm_cmpeq_epi16(wide, _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(eq)) ^ 0xffffu;
+    if (mask != 0u) {
+      return i + static_cast<int32_t>(CTZ(mask) / 2u);
+    }
+  }
+#endif
+  while (i < count && lhs[i] == rhs[i]) {
+    ++i;
+  }
+  return i;
+}
+
+inline void String::InflateChars(uint16_t* dest, const uint8_t* src, int32_t length) {
+  int32_t i = 0;
+#if defined(__aarch64__)
+  for (; length - i >= 16; i += 16) {
+    uint8x16_t v = vld1q_u8(src + i);
+    vst1q_u16(dest + i, vmovl_u8(vget_low_u8(v)));
+    vst1q_u16(dest + i + 8, vmovl_high_u8(v));
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; length - i >= 16; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_unpacklo_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 8), _mm_unpackhi_epi8(v, zero));
+  }
+#endif
+  for (; i < length; ++i) {
+    dest[i] = src[i];
+  }
 }
 
 inline int32_t String::GetHashCode() {
@@ -139,18 +139,12 @@ ObjPtr<String> String::DoConcat(Thread* self, Handle<String> h_this, Handle<Stri
     } else {
       uint16_t* new_value = new_string->GetValue();
       if (h_this->IsCompressed()) {
-        const uint8_t* value_this = h_this->GetValueCompressed();
-        for (int i = 0; i < length_this; ++i) {
-          new_value[i] = value_this[i];
-        }
+        InflateChars(new_value, h_this->GetValueCompressed(), length_this);
       } else {
         memcpy(new_value, h_this->GetValue(), length_this * sizeof(uint16_t));
       }
       if (h_arg->IsCompressed()) {
-        const uint8_t* value_arg = h_arg->GetValueCompressed();
-        for (int i = 0; i < length_arg; ++i) {
-          new_value[i + length_this] = value_arg[i];
-        }
+        InflateChars(new_value + length_this, h_arg->GetValueCompressed(), length_arg);
       } else {
         memcpy(new_value + length_this, h_arg->GetValue(), length_arg * sizeof(uint16_t));
       }
@@ -297,22 +291,19 @@ int32_t String::CompareTo(ObjPtr<String> rhs) {
   if (lhs->IsCompressed() && rhs->IsCompressed()) {
     const uint8_t* lhs_chars = lhs->GetValueCompressed();
     const uint8_t* rhs_chars = rhs->GetValueCompressed();
-    for (int32_t i = 0; i < min_count; ++i) {
-      int32_t char_diff = static_cast<int32_t>(lhs_chars[i]) - static_cast<int32_t>(rhs_chars[i]);
-      if (char_diff != 0) {
-        return char_diff;
-      }
+    int32_t i = CommonPrefixLength(lhs_chars, rhs_chars, min_count);
+    if (i != min_count) {
+      return static_cast<int32_t>(lhs_chars[i]) - static_cast<int32_t>(rhs_chars[i]);
     }
   } else if (lhs->IsCompressed() || rhs->IsCompressed()) {
     const uint8_t* compressed_chars =
         lhs->IsCompressed() ? lhs->GetValueCompressed() : rhs->GetValueCompressed();
     const uint16_t* uncompressed_chars = lhs->IsCompressed() ? rhs->GetValue() : lhs->GetValue();
-    for (int32_t i = 0; i < min_count; ++i) {
+    int32_t i = CommonPrefixLength(compressed_chars, uncompressed_chars, min_count);
+    if (i != min_count) {
       int32_t char_diff =
           static_cast<int32_t>(compressed_chars[i]) - static_cast<int32_t>(uncompressed_chars[i]);
-      if (char_diff != 0) {
-        return lhs->IsCompressed() ? char_diff : -char_diff;
-      }
+      return lhs->IsCompressed() ? char_diff : -char_diff;
     }
   } else {
     const uint16_t* lhs_chars = lhs->GetValue();
@@ -331,12 +322,7 @@ ObjPtr<CharArray> String::ToCharArray(Handle<String> h_this, Thread* self) {
   ObjPtr<CharArray> result = CharArray::Alloc(self, h_this->GetLength());
   if (result != nullptr) {
     if (h_this->IsCompressed()) {
-      int32_t length = h_this->GetLength();
-      const uint8_t* src = h_this->GetValueCompressed();
-      uint16_t* dest = result->GetData();
-      for (int i = 0; i < length; ++i) {
-        dest[i] = src[i];
-      }
+      InflateChars(result->GetData(), h_this->GetValueCompressed(), h_this->GetLength());
     } else {
       memcpy(result->GetData(), h_this->GetValue(), h_this->GetLength() * sizeof(uint16_t));
     }
@@ -351,10 +337,7 @@ void String::GetChars(int32_t start, int32_t end, Handle<CharArray> array, int32
   DCHECK_LE(start, end);
   int32_t length = end - start;
   if (IsCompressed()) {
-    const uint8_t* value = GetValueCompressed() + start;
-    for (int i = 0; i < length; ++i) {
-      data[i] = value[i];
-    }
+    InflateChars(data, GetValueCompressed() + start, length);
   } else {
     uint16_t* value = GetValue() + start;
     memcpy(data, value, length * sizeof(uint16_t));
@@ -62,6 +62,10 @@ class MANAGED String final : public Object {
     return OFFSET_OF_OBJECT_MEMBER(String, value_);
   }
 
+  static constexpr MemberOffset HashCodeOffset() {
+    return OFFSET_OF_OBJECT_MEMBER(String, hash_code_);
+  }
+
   uint16_t* GetValue() REQUIRES_SHARED(Locks::mutator_lock_) {
     return &value_[0];
   }
@@ -204,6 +208,9 @@ class MANAGED String final : public Object {
 
   static bool DexFileStringAllASCII(const char* chars, const int length);
 
+  // Copy `length` compressed characters from `src` to `dest`, zero-extending them to UTF-16.
+  ALWAYS_INLINE static void InflateChars(uint16_t* dest, const uint8_t* src, int32_t length);
+
   ALWAYS_INLINE static bool IsCompressed(int32_t count) {
     return GetCompressionFlagFromCount(count) == StringCompressionFlag::kCompressed;
   }
@@ -244,6 +251,20 @@ class MANAGED String final : public Object {
  private:
   static bool AllASCIIExcept(const uint16_t* chars, int32_t length, uint16_t non_ascii);
 
+  // Return a pointer to the first occurrence of `ch` in [p, end), or `end` if there is none.
+  ALWAYS_INLINE static const uint8_t* FindChar(const uint8_t* p, const uint8_t* end, uint8_t ch);
+  ALWAYS_INLINE static const uint16_t* FindChar(const uint16_t* p,
+                                                const uint16_t* end,
+                                                uint16_t ch);
+
+  // Return the length of the longest common prefix of `lhs` and `rhs`, at most `count`.
+  ALWAYS_INLINE static int32_t CommonPrefixLength(const uint8_t* lhs,
+                                                  const uint8_t* rhs,
+                                                  int32_t count);
+  ALWAYS_INLINE static int32_t CommonPrefixLength(const uint8_t* lhs,
+                                                  const uint16_t* rhs,
+                                                  int32_t count);
+
   void SetHashCode(int32_t new_hash_code) REQUIRES_SHARED(Locks::mutator_lock_) {
     // Hash code is invariant so use non-transactional mode. Also disable check as we may run inside
     // a transaction.
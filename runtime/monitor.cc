@@ -27,6 +27,7 @@
 #include "base/stl_util.h"
 #include "base/systrace.h"
 #include "base/time_utils.h"
+#include "base/utils.h"
 #include "class_linker.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
@@ -49,6 +50,36 @@ using android::base::StringPrintf;
 static constexpr uint64_t kDebugThresholdFudgeFactor = kIsDebugBuild ? 10 : 1;
 static constexpr uint64_t kLongWaitMs = 100 * kDebugThresholdFudgeFactor;
 
+// Bounds for the number of CpuRelax() rounds a contending thread spins for before it yields or
+// blocks. The budget doubles when the lock is released during a spin and halves otherwise, so
+// that we stop spinning on locks held for long or by threads that are not running.
+static constexpr uint32_t kMinSpinBudget = 16;
+static constexpr uint32_t kMaxSpinBudget = 1024;
+static constexpr uint32_t kInitialSpinBudget = 128;
+
+// Thin locks have no monitor to keep a budget in, so they share one.
+static std::atomic<uint32_t> gThinLockSpinBudget(kInitialSpinBudget);
+
+// Spin until `pred` holds or `budget` runs out. Returns whether `pred` held.
+template <typename Pred>
+static bool AdaptiveSpinUntil(Thread* self, std::atomic<uint32_t>* budget, Pred pred)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  const uint32_t limit = budget->load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i != limit; ++i) {
+    CpuRelax();
+    if (pred()) {
+      budget->store(std::min(2 * limit, kMaxSpinBudget), std::memory_order_relaxed);
+      return true;
+    }
+    if (self->TestAllFlags()) {
+      // Do not delay suspension or checkpoint requests, and do not learn from this spin.
+      return false;
+    }
+  }
+  budget->store(std::max(limit / 2, kMinSpinBudget), std::memory_order_relaxed);
+  return false;
+}
+
 /*
  * Every Object has a monitor associated with it, but not every Object is actually locked.  Even
  * the ones that are locked do not need a full-fledged monitor until a) there is actual contention
@@ -78,6 +109,7 @@ static constexpr uint64_t kLongWaitMs = 100 * kDebugThresholdFudgeFactor;
  */
 
 uint32_t Monitor::lock_profiling_threshold_ = 0;
+std::atomic<uint64_t> Monitor::hash_code_inflation_count_(0u);
 uint32_t Monitor::stack_dump_lock_profiling_threshold_ = 0;
 
 void Monitor::Init(uint32_t lock_profiling_threshold,
@@ -93,6 +125,7 @@ void Monitor::Init(uint32_t lock_profiling_threshold,
 Monitor::Monitor(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, int32_t hash_code)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      spin_budget_(kInitialSpinBudget),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -122,6 +155,7 @@ Monitor::Monitor(Thread* self,
                  MonitorId id)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      spin_budget_(kInitialSpinBudget),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -146,9 +180,13 @@ Monitor::Monitor(Thread* self,
 int32_t Monitor::GetHashCode() {
   int32_t hc = hash_code_.load(std::memory_order_relaxed);
   if (!HasHashCode()) {
+    ObjPtr<mirror::Object> obj = GetObject();
+    uint32_t new_hash_code = obj->HasAddressIdentityHashCode()
+        ? obj->AddressIdentityHashCode()
+        : mirror::Object::GenerateIdentityHashCode();
     // Use a strong CAS to prevent spurious failures since these can make the boot image
     // non-deterministic.
-    hash_code_.CompareAndSetStrongRelaxed(0, mirror::Object::GenerateIdentityHashCode());
+    hash_code_.CompareAndSetStrongRelaxed(0, new_hash_code);
     hc = hash_code_.load(std::memory_order_relaxed);
   }
   DCHECK(HasHashCode());
@@ -422,8 +460,7 @@ bool Monitor::TryLock(Thread* self, bool spin) {
     lock_count_++;
     CHECK_NE(lock_count_, 0u);  // Abort on overflow.
   } else {
-    bool success = spin ? monitor_lock_.ExclusiveTryLockWithSpinning(self)
-        : monitor_lock_.ExclusiveTryLock(self);
+    bool success = spin ? TryLockWithSpinning(self) : monitor_lock_.ExclusiveTryLock(self);
     if (!success) {
       return false;
     }
@@ -439,6 +476,25 @@ bool Monitor::TryLock(Thread* self, bool spin) {
   return true;
 }
 
+bool Monitor::TryLockWithSpinning(Thread* self) {
+  // Spin again if another contender grabbed the lock as it was released, but not forever.
+  static constexpr size_t kMaxSpinRounds = 4;
+  if (monitor_lock_.ExclusiveTryLock(self)) {
+    return true;
+  }
+  for (size_t i = 0; i != kMaxSpinRounds; ++i) {
+    if (!AdaptiveSpinUntil(self, &spin_budget_, [this]() {
+          return owner_.load(std::memory_order_relaxed) == nullptr;
+        })) {
+      return false;
+    }
+    if (monitor_lock_.ExclusiveTryLock(self)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 template <LockReason reason>
 void Monitor::Lock(Thread* self) {
   bool called_monitors_callback = false;
@@ -1005,7 +1061,9 @@ bool Monitor::Deflate(Thread* self, ObjPtr<mirror::Object> obj) {
     }
     DCHECK_EQ(monitor->lock_count_, 0u);
     DCHECK_EQ(monitor->owner_.load(std::memory_order_relaxed), static_cast<Thread*>(nullptr));
-    if (monitor->HasHashCode()) {
+    if (monitor->HasHashCode() &&
+        !(obj->HasAddressIdentityHashCode() &&
+          static_cast<uint32_t>(monitor->GetHashCode()) == obj->AddressIdentityHashCode())) {
       LockWord new_lw = LockWord::FromHashCode(monitor->GetHashCode(), lw.GCState());
       // Assume no concurrent read barrier state changes as mutators are suspended.
       obj->SetLockWord(new_lw, false);
@@ -1042,6 +1100,9 @@ void Monitor::Inflate(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, i
     }
     Runtime::Current()->GetMonitorList()->Add(m);
     CHECK_EQ(obj->GetLockWord(true).GetState(), LockWord::kFatLocked);
+    if (hash_code != 0) {
+      hash_code_inflation_count_.fetch_add(1u, std::memory_order_relaxed);
+    }
   } else {
     MonitorPool::ReleaseMonitor(self, m);
   }
@@ -1167,15 +1228,19 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
           contention_count++;
           Runtime* runtime = Runtime::Current();
           if (contention_count <= runtime->GetMaxSpinsBeforeThinLockInflation()) {
-            // TODO: Consider switching the thread state to kWaitingForLockInflation when we are
-            // yielding.  Use sched_yield instead of NanoSleep since NanoSleep can wait much longer
-            // than the parameter you pass in. This can cause thread suspension to take excessively
-            // long and make long pauses. See b/16307460.
-            // TODO: We should literally spin first, without sched_yield. Sched_yield either does
-            // nothing (at significant expense), or guarantees that we wait at least microseconds.
-            // If the owner is running, I would expect the median lock hold time to be hundreds
-            // of nanoseconds or less.
-            sched_yield();
+            // Spin first. If the owner is running, the median lock hold time is expected to be
+            // hundreds of nanoseconds or less, while sched_yield either does nothing (at
+            // significant expense), or guarantees that we wait at least microseconds.
+            auto lock_word_changed = [&]() REQUIRES_SHARED(Locks::mutator_lock_) {
+              return !LockWord::Equal<false>(h_obj->GetLockWord(true), lock_word);
+            };
+            if (!AdaptiveSpinUntil(self, &gThinLockSpinBudget, lock_word_changed)) {
+              // TODO: Consider switching the thread state to kWaitingForLockInflation when we are
+              // yielding.  Use sched_yield instead of NanoSleep since NanoSleep can wait much
+              // longer than the parameter you pass in. This can cause thread suspension to take
+              // excessively long and make long pauses. See b/16307460.
+              sched_yield();
+            }
           } else {
 #if ART_USE_FUTEXES
             contention_count = 0;
@@ -1205,6 +1270,17 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
         }
       }
       case LockWord::kHashCode:
+        if (h_obj->HasAddressIdentityHashCode() &&
+            lock_word.GetHashCode() == h_obj->AddressIdentityHashCode()) {
+          // The hash code can be recomputed from the address, so replace it with a thin lock.
+          LockWord thin_locked(LockWord::FromThinLockId(thread_id, 0, lock_word.GCState()));
+          if (h_obj->CasLockWord(
+                  lock_word, thin_locked, CASMode::kWeak, std::memory_order_acquire)) {
+            AtraceMonitorLock(self, h_obj.Get(), /* is_wait= */ false);
+            return h_obj.Get();  // Success!
+          }
+          continue;  // Go again.
+        }
         // Inflate with the existing hashcode.
         // Again no ordering required for initial lockword read, since we don't rely
         // on the visibility of any prior computation.
@@ -65,6 +65,12 @@ class Monitor {
 
   static void Init(uint32_t lock_profiling_threshold, uint32_t stack_dump_lock_profiling_threshold);
 
+  // Number of monitors installed to hold an identity hash code, i.e. for locking a hashed
+  // object or hashing a thin locked one.
+  static uint64_t GetHashCodeInflationCount() {
+    return hash_code_inflation_count_.load(std::memory_order_relaxed);
+  }
+
   // Return the thread id of the lock owner or 0 when there is no owner.
   static uint32_t GetLockOwnerThreadId(ObjPtr<mirror::Object> obj)
       NO_THREAD_SAFETY_ANALYSIS;  // TODO: Reading lock owner without holding lock is racy.
@@ -135,7 +141,7 @@ class Monitor {
     return owner_.load(std::memory_order_relaxed);
   }
 
-  int32_t GetHashCode();
+  int32_t GetHashCode() REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Is the monitor currently locked? Debug only, provides no memory ordering guarantees.
   bool IsLocked() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!monitor_lock_);
@@ -225,6 +231,11 @@ class Monitor {
       TRY_ACQUIRE(true, monitor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to lock, spinning while the lock is held for up to the monitor's spin budget.
+  bool TryLockWithSpinning(Thread* self)
+      TRY_ACQUIRE(true, monitor_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   template<LockReason reason = LockReason::kForLock>
   void Lock(Thread* self)
       ACQUIRE(monitor_lock_)
@@ -307,6 +318,7 @@ class Monitor {
   static uint32_t lock_profiling_threshold_;
   static uint32_t stack_dump_lock_profiling_threshold_;
   static bool capture_method_eagerly_;
+  static std::atomic<uint64_t> hash_code_inflation_count_;
 
   // Holding the monitor N times is represented by holding monitor_lock_ N times.
   Mutex monitor_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
@@ -318,9 +330,13 @@ class Monitor {
   // monitor acquisition. Prevents deflation.
   std::atomic<size_t> num_waiters_;
 
+  // Number of CpuRelax() rounds contenders spin for before blocking, learned from whether
+  // the lock got released during past spins.
+  std::atomic<uint32_t> spin_budget_;
+
   // Which thread currently owns the lock? monitor_lock_ only keeps the tid.
   // Only set while holding monitor_lock_. Non-locking readers only use it to
-  // compare to self or for debugging.
+  // compare to self, to spin until it is released, or for debugging.
   std::atomic<Thread*> owner_;
 
   // Owner's recursive lock depth. Owner_ non-null, and lock_count_ == 0 ==> held once.
@@ -23,6 +23,7 @@
 
 #include "nativehelper/jni_macros.h"
 
+#include "base/allocator.h"
 #include "base/file_utils.h"
 #include "base/histogram-inl.h"
 #include "base/time_utils.h"
@@ -36,6 +37,7 @@
 #include "gc/space/zygote_space.h"
 #include "handle_scope-inl.h"
 #include "hprof/hprof.h"
+#include "jit/jit.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
 #include "mirror/array-alloc-inl.h"
@@ -461,6 +463,11 @@ enum class VMDebugRuntimeStatId {
   kArtGcBlockingGcTime,
   kArtGcGcCountRateHistogram,
   kArtGcBlockingGcCountRateHistogram,
+  kArtGcRegionEvacuationStats,
+  kArtGcMetrics,
+  kArtJitStats,
+  kArtStartupTimeline,
+  kArtNativeAllocations,
   kNumRuntimeStats,
 };
 
@@ -501,6 +508,34 @@ static jstring VMDebug_getRuntimeStatInternal(JNIEnv* env, jclass, jint statId)
       heap->DumpBlockingGcCountRateHistogram(output);
       return env->NewStringUTF(output.str().c_str());
     }
+    case VMDebugRuntimeStatId::kArtGcRegionEvacuationStats: {
+      std::ostringstream output;
+      heap->DumpRegionEvacuationStats(output);
+      return env->NewStringUTF(output.str().c_str());
+    }
+    case VMDebugRuntimeStatId::kArtGcMetrics: {
+      std::ostringstream output;
+      heap->DumpGcMetrics(output);
+      return env->NewStringUTF(output.str().c_str());
+    }
+    case VMDebugRuntimeStatId::kArtJitStats: {
+      jit::Jit* jit = Runtime::Current()->GetJit();
+      std::ostringstream output;
+      if (jit != nullptr) {
+        jit->DumpStats(output);
+      }
+      return env->NewStringUTF(output.str().c_str());
+    }
+    case VMDebugRuntimeStatId::kArtStartupTimeline: {
+      std::ostringstream output;
+      Runtime::Current()->GetStartupTimeline()->Dump(output);
+      return env->NewStringUTF(output.str().c_str());
+    }
+    case VMDebugRuntimeStatId::kArtNativeAllocations: {
+      std::ostringstream output;
+      TrackedAllocators::Dump(output);
+      return env->NewStringUTF(output.str().c_str());
+    }
     default:
       return nullptr;
   }
@@ -567,6 +602,47 @@ static jobjectArray VMDebug_getRuntimeStatsInternal(JNIEnv* env, jclass) {
       return nullptr;
     }
   }
+  {
+    std::ostringstream output;
+    heap->DumpRegionEvacuationStats(output);
+    if (!SetRuntimeStatValue(env, result, VMDebugRuntimeStatId::kArtGcRegionEvacuationStats,
+                             output.str())) {
+      return nullptr;
+    }
+  }
+  {
+    std::ostringstream output;
+    heap->DumpGcMetrics(output);
+    if (!SetRuntimeStatValue(env, result, VMDebugRuntimeStatId::kArtGcMetrics, output.str())) {
+      return nullptr;
+    }
+  }
+  {
+    jit::Jit* jit = Runtime::Current()->GetJit();
+    std::ostringstream output;
+    if (jit != nullptr) {
+      jit->DumpStats(output);
+    }
+    if (!SetRuntimeStatValue(env, result, VMDebugRuntimeStatId::kArtJitStats, output.str())) {
+      return nullptr;
+    }
+  }
+  {
+    std::ostringstream output;
+    Runtime::Current()->GetStartupTimeline()->Dump(output);
+    if (!SetRuntimeStatValue(env, result, VMDebugRuntimeStatId::kArtStartupTimeline,
+                             output.str())) {
+      return nullptr;
+    }
+  }
+  {
+    std::ostringstream output;
+    TrackedAllocators::Dump(output);
+    if (!SetRuntimeStatValue(env, result, VMDebugRuntimeStatId::kArtNativeAllocations,
+                             output.str())) {
+      return nullptr;
+    }
+  }
   return result;
 }
 
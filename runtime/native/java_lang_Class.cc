@@ -24,6 +24,7 @@
 #include "class_linker-inl.h"
 #include "class_root-inl.h"
 #include "common_throws.h"
+#include "dex/annotation_cache.h"
 #include "dex/descriptors_names.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_annotations.h"
@@ -60,9 +61,9 @@ namespace art {
 // Corresponds to a bug id.
 static constexpr uint64_t kPreventMetaReflectionBlacklistAccess = 142365358;
 
-// Walks the stack, finds the caller of this reflective call and returns
-// a hiddenapi AccessContext formed from its declaring class.
-static hiddenapi::AccessContext GetReflectionCaller(Thread* self)
+// Walks the stack and returns the caller of this reflective call, or null if it
+// cannot be determined, e.g. for unattached threads.
+static ArtMethod* GetReflectionCallerMethod(Thread* self)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   // Walk the stack and find the first frame not from java.lang.Class,
   // java.lang.invoke or java.lang.reflect. This is very expensive.
@@ -120,18 +121,37 @@ static hiddenapi::AccessContext GetReflectionCaller(Thread* self)
 
   FirstExternalCallerVisitor visitor(self);
   visitor.WalkStack();
+  return visitor.caller;
+}
 
-  // Construct AccessContext from the calling class found on the stack.
+// Returns a hiddenapi AccessContext formed from the declaring class of `caller`.
+static hiddenapi::AccessContext GetReflectionCallerContext(ArtMethod* caller)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
   // If the calling class cannot be determined, e.g. unattached threads,
   // we conservatively assume the caller is trusted.
-  ObjPtr<mirror::Class> caller = (visitor.caller == nullptr)
-      ? nullptr : visitor.caller->GetDeclaringClass();
-  return caller.IsNull() ? hiddenapi::AccessContext(/* is_trusted= */ true)
-                         : hiddenapi::AccessContext(caller);
+  return (caller == nullptr) ? hiddenapi::AccessContext(/* is_trusted= */ true)
+                             : hiddenapi::AccessContext(caller->GetDeclaringClass());
+}
+
+// Walks the stack, finds the caller of this reflective call and returns
+// a hiddenapi AccessContext formed from its declaring class.
+static hiddenapi::AccessContext GetReflectionCaller(Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  return GetReflectionCallerContext(GetReflectionCallerMethod(self));
 }
 
+// Returns a function computing the access context of the reflection caller. The stack is
+// walked at most once, however many members the function is used to check; the caller's
+// ArtMethod stays valid across thread suspension, unlike the AccessContext.
 static std::function<hiddenapi::AccessContext()> GetHiddenapiAccessContextFunction(Thread* self) {
-  return [=]() REQUIRES_SHARED(Locks::mutator_lock_) { return GetReflectionCaller(self); };
+  return [=, walked = false, caller = static_cast<ArtMethod*>(nullptr)]() mutable
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (!walked) {
+      caller = GetReflectionCallerMethod(self);
+      walked = true;
+    }
+    return GetReflectionCallerContext(caller);
+  };
 }
 
 // Returns true if the first non-ClassClass caller up the stack should not be
@@ -689,6 +709,17 @@ static jobject Class_getDeclaredAnnotation(JNIEnv* env, jobject javaThis, jclass
     return nullptr;
   }
   Handle<mirror::Class> annotation_class(hs.NewHandle(soa.Decode<mirror::Class>(annotationClass)));
+  // If all the annotations of the class are cached, pick the one asked for from them.
+  ObjPtr<mirror::ObjectArray<mirror::Object>> cached_annotations =
+      Runtime::Current()->GetAnnotationCache()->Lookup(klass.Get());
+  if (cached_annotations != nullptr) {
+    for (ObjPtr<mirror::Object> annotation : cached_annotations->Iterate()) {
+      if (annotation != nullptr && annotation_class->IsAssignableFrom(annotation->GetClass())) {
+        return soa.AddLocalReference<jobject>(annotation);
+      }
+    }
+    return nullptr;
+  }
   return soa.AddLocalReference<jobject>(
       annotations::GetAnnotationForClass(klass, annotation_class));
 }
@@ -711,7 +742,8 @@ static jobjectArray Class_getDeclaredAnnotations(JNIEnv* env, jobject javaThis)
                                                    /* length= */ 0);
     return soa.AddLocalReference<jobjectArray>(empty_array);
   }
-  return soa.AddLocalReference<jobjectArray>(annotations::GetAnnotationsForClass(klass));
+  return soa.AddLocalReference<jobjectArray>(
+      Runtime::Current()->GetAnnotationCache()->GetAnnotationsForClass(klass));
 }
 
 static jobjectArray Class_getDeclaredClasses(JNIEnv* env, jobject javaThis) {
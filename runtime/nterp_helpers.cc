@@ -94,10 +94,23 @@ static constexpr size_t NterpGetFrameEntrySize() {
   return (POPCOUNT(core_spills) + POPCOUNT(fp_spills)) * kPointerSize;
 }
 
+static uint16_t GetNumberOfOutRegs(const CodeItemDataAccessor& accessor) {
+  uint16_t out_regs = accessor.OutsSize();
+  if (kRuntimeISA == InstructionSet::kX86) {
+    // On x86, nterp uses the first three out slots as temporaries, and the
+    // slot right below the dex pc to keep the shorty of the method it calls.
+    if (out_regs < 3) {
+      out_regs = 3;
+    }
+    out_regs += 1;
+  }
+  return out_regs;
+}
+
 size_t NterpGetFrameSize(ArtMethod* method) {
   CodeItemDataAccessor accessor(method->DexInstructionData());
   const uint16_t num_regs = accessor.RegistersSize();
-  const uint16_t out_regs = accessor.OutsSize();
+  const uint16_t out_regs = GetNumberOfOutRegs(accessor);
 
   // Note: There may be two pieces of alignment but there is no need to align
   // out args to `kPointerSize` separately before aligning to kStackAlignment.
@@ -131,7 +144,7 @@ uintptr_t NterpGetRegistersArray(ArtMethod** frame) {
 
 uintptr_t NterpGetReferenceArray(ArtMethod** frame) {
   CodeItemDataAccessor accessor((*frame)->DexInstructionData());
-  const uint16_t out_regs = accessor.OutsSize();
+  const uint16_t out_regs = GetNumberOfOutRegs(accessor);
   // The references array is just above the saved frame pointer.
   return reinterpret_cast<uintptr_t>(frame) +
       kPointerSize +  // method
@@ -142,7 +155,7 @@ uintptr_t NterpGetReferenceArray(ArtMethod** frame) {
 
 uint32_t NterpGetDexPC(ArtMethod** frame) {
   CodeItemDataAccessor accessor((*frame)->DexInstructionData());
-  const uint16_t out_regs = accessor.OutsSize();
+  const uint16_t out_regs = GetNumberOfOutRegs(accessor);
   uintptr_t dex_pc_ptr = reinterpret_cast<uintptr_t>(frame) +
       kPointerSize +  // method
       RoundUp(out_regs * kVRegSize, kPointerSize);  // out arguments and pointer alignment
@@ -1636,59 +1636,67 @@ OatFile* OatFile::Open(int zip_fd,
     return nullptr;
   }
 
-  // Try dlopen first, as it is required for native debuggability. This will fail fast if dlopen is
-  // disabled.
-  OatFile* with_dlopen = OatFileBase::OpenOatFile<DlOpenOatFile>(zip_fd,
-                                                                 vdex_filename,
-                                                                 oat_filename,
-                                                                 oat_location,
-                                                                 /*writable=*/ false,
-                                                                 executable,
-                                                                 low_4gb,
-                                                                 dex_filenames,
-                                                                 reservation,
-                                                                 error_msg);
-  if (with_dlopen != nullptr) {
-    Runtime* runtime = Runtime::Current();
-    // The runtime might not be available at this point if we're running
-    // dex2oat or oatdump.
-    if (runtime != nullptr) {
-      size_t madvise_size_limit = runtime->GetMadviseWillNeedSizeOdex();
-      Runtime::MadviseFileForRange(madvise_size_limit,
-                                   with_dlopen->Size(),
-                                   with_dlopen->Begin(),
-                                   with_dlopen->End(),
-                                   oat_location);
+  // Try dlopen first, as it is required for native debuggability, unless the runtime prefers our
+  // own ELF loader. This will fail fast if dlopen is disabled.
+  Runtime* runtime = Runtime::Current();
+  // The runtime might not be available at this point if we're running
+  // dex2oat or oatdump.
+  const bool use_dlopen = (runtime == nullptr) || runtime->UseDlopenForOatFiles();
+  OatFile* oat_file = nullptr;
+  if (use_dlopen) {
+    oat_file = OatFileBase::OpenOatFile<DlOpenOatFile>(zip_fd,
+                                                       vdex_filename,
+                                                       oat_filename,
+                                                       oat_location,
+                                                       /*writable=*/ false,
+                                                       executable,
+                                                       low_4gb,
+                                                       dex_filenames,
+                                                       reservation,
+                                                       error_msg);
+    if (oat_file == nullptr && kPrintDlOpenErrorMessage) {
+      LOG(ERROR) << "Failed to dlopen: " << oat_filename << " with error " << *error_msg;
     }
-    return with_dlopen;
-  }
-  if (kPrintDlOpenErrorMessage) {
-    LOG(ERROR) << "Failed to dlopen: " << oat_filename << " with error " << *error_msg;
-  }
-  // If we aren't trying to execute, we just use our own ElfFile loader for a couple reasons:
-  //
-  // On target, dlopen may fail when compiling due to selinux restrictions on installd.
-  //
-  // We use our own ELF loader for Quick to deal with legacy apps that
-  // open a generated dex file by name, remove the file, then open
-  // another generated dex file with the same name. http://b/10614658
-  //
-  // On host, dlopen is expected to fail when cross compiling, so fall back to ElfOatFile.
-  //
-  //
-  // Another independent reason is the absolute placement of boot.oat. dlopen on the host usually
-  // does honor the virtual address encoded in the ELF file only for ET_EXEC files, not ET_DYN.
-  OatFile* with_internal = OatFileBase::OpenOatFile<ElfOatFile>(zip_fd,
-                                                                vdex_filename,
-                                                                oat_filename,
-                                                                oat_location,
-                                                                /*writable=*/ false,
-                                                                executable,
-                                                                low_4gb,
-                                                                dex_filenames,
-                                                                reservation,
-                                                                error_msg);
-  return with_internal;
+  }
+  if (oat_file == nullptr) {
+    // If we aren't trying to execute, we just use our own ElfFile loader for a couple reasons:
+    //
+    // On target, dlopen may fail when compiling due to selinux restrictions on installd.
+    //
+    // We use our own ELF loader for Quick to deal with legacy apps that
+    // open a generated dex file by name, remove the file, then open
+    // another generated dex file with the same name. http://b/10614658
+    //
+    // On host, dlopen is expected to fail when cross compiling, so fall back to ElfOatFile.
+    //
+    //
+    // Another independent reason is the absolute placement of boot.oat. dlopen on the host usually
+    // does honor the virtual address encoded in the ELF file only for ET_EXEC files, not ET_DYN.
+    //
+    // Our loader maps each segment with one mmap and does no relocations, so it avoids the
+    // dynamic linker work and locks entirely. The segments are file mappings, so unwinders
+    // that read /proc/self/maps still find the oat file; only the dynamic linker's list of
+    // loaded objects used by gdb misses it.
+    oat_file = OatFileBase::OpenOatFile<ElfOatFile>(zip_fd,
+                                                    vdex_filename,
+                                                    oat_filename,
+                                                    oat_location,
+                                                    /*writable=*/ false,
+                                                    executable,
+                                                    low_4gb,
+                                                    dex_filenames,
+                                                    reservation,
+                                                    error_msg);
+  }
+  if (oat_file != nullptr && runtime != nullptr) {
+    size_t madvise_size_limit = runtime->GetMadviseWillNeedSizeOdex();
+    Runtime::MadviseFileForRange(madvise_size_limit,
+                                 oat_file->Size(),
+                                 oat_file->Begin(),
+                                 oat_file->End(),
+                                 oat_location);
+  }
+  return oat_file;
 }
 
 OatFile* OatFile::Open(int zip_fd,
@@ -16,7 +16,9 @@
 
 #include "oat_file_assistant.h"
 
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 #include <sys/stat.h>
 #include "zlib.h"
@@ -53,6 +55,68 @@ using android::base::StringPrintf;
 static constexpr const char* kAnonymousDexPrefix = "Anonymous-DexFile@";
 static constexpr const char* kVdexExtension = ".vdex";
 
+// Process-wide caches of the expensive parts of the status computation, shared by all
+// OatFileAssistant instances. dexoptanalyzer and the runtime create a new OatFileAssistant
+// for every query, so the per-instance caches alone do not help repeated queries for the same
+// dex location or for oat files compiled against the same boot class path.
+static std::mutex gStatusCacheLock;
+
+// The multidex checksums of a dex location, keyed by the location and valid as long as the
+// identity of the file (device, inode, size and mtime) does not change.
+struct CachedDexChecksums {
+  dev_t dev;
+  ino_t ino;
+  off_t size;
+  int64_t mtime_ns;
+  std::vector<uint32_t> checksums;
+  bool only_contains_uncompressed_dex;
+};
+static constexpr size_t kMaxCachedDexChecksums = 256;
+static std::unordered_map<std::string, CachedDexChecksums>* gCachedDexChecksums
+    GUARDED_BY(gStatusCacheLock) = nullptr;
+
+// Boot class path and checksum pairs from oat headers that have been verified against the
+// boot class path of the current runtime, which does not change for the life of the process.
+static constexpr size_t kMaxValidatedBootClassPaths = 8;
+static std::vector<std::pair<std::string, std::string>>* gValidatedBootClassPaths
+    GUARDED_BY(gStatusCacheLock) = nullptr;
+
+void OatFileAssistant::ClearStatusCaches() {
+  std::lock_guard<std::mutex> mu(gStatusCacheLock);
+  delete gCachedDexChecksums;
+  gCachedDexChecksums = nullptr;
+  delete gValidatedBootClassPaths;
+  gValidatedBootClassPaths = nullptr;
+}
+
+static int64_t GetMtimeNs(const struct stat& s) {
+  return static_cast<int64_t>(s.st_mtim.tv_sec) * 1000000000 + s.st_mtim.tv_nsec;
+}
+
+static bool IsValidatedBootClassPath(std::string_view boot_class_path,
+                                     std::string_view boot_class_path_checksums) {
+  std::lock_guard<std::mutex> mu(gStatusCacheLock);
+  if (gValidatedBootClassPaths != nullptr) {
+    for (const std::pair<std::string, std::string>& entry : *gValidatedBootClassPaths) {
+      if (entry.first == boot_class_path && entry.second == boot_class_path_checksums) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void AddValidatedBootClassPath(std::string_view boot_class_path,
+                                      std::string_view boot_class_path_checksums) {
+  std::lock_guard<std::mutex> mu(gStatusCacheLock);
+  if (gValidatedBootClassPaths == nullptr) {
+    gValidatedBootClassPaths = new std::vector<std::pair<std::string, std::string>>();
+  }
+  if (gValidatedBootClassPaths->size() < kMaxValidatedBootClassPaths) {
+    gValidatedBootClassPaths->emplace_back(boot_class_path, boot_class_path_checksums);
+  }
+}
+
 std::ostream& operator << (std::ostream& stream, const OatFileAssistant::OatStatus status) {
   switch (status) {
     case OatFileAssistant::kOatCannotOpen:
@@ -571,13 +635,17 @@ const std::vector<uint32_t>* OatFileAssistant::GetRequiredDexChecksums() {
     cached_required_dex_checksums_.clear();
     std::string error_msg;
     const ArtDexFileLoader dex_file_loader;
-    if (dex_file_loader.GetMultiDexChecksums(dex_location_.c_str(),
-                                             &cached_required_dex_checksums_,
-                                             &error_msg,
-                                             zip_fd_,
-                                             &zip_file_only_contains_uncompressed_dex_)) {
+    if (LookupCachedDexChecksums()) {
+      required_dex_checksums_found_ = true;
+      has_original_dex_files_ = true;
+    } else if (dex_file_loader.GetMultiDexChecksums(dex_location_.c_str(),
+                                                    &cached_required_dex_checksums_,
+                                                    &error_msg,
+                                                    zip_fd_,
+                                                    &zip_file_only_contains_uncompressed_dex_)) {
       required_dex_checksums_found_ = true;
       has_original_dex_files_ = true;
+      CacheDexChecksums();
     } else {
       // This can happen if the original dex file has been stripped from the
       // apk.
@@ -603,6 +671,62 @@ const std::vector<uint32_t>* OatFileAssistant::GetRequiredDexChecksums() {
   return required_dex_checksums_found_ ? &cached_required_dex_checksums_ : nullptr;
 }
 
+bool OatFileAssistant::LookupCachedDexChecksums() {
+  if (UseFdToReadFiles()) {
+    return false;
+  }
+  struct stat s;
+  if (TEMP_FAILURE_RETRY(stat(dex_location_.c_str(), &s)) != 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> mu(gStatusCacheLock);
+  if (gCachedDexChecksums == nullptr) {
+    return false;
+  }
+  auto it = gCachedDexChecksums->find(dex_location_);
+  if (it == gCachedDexChecksums->end()) {
+    return false;
+  }
+  const CachedDexChecksums& cached = it->second;
+  if (cached.dev != s.st_dev ||
+      cached.ino != s.st_ino ||
+      cached.size != s.st_size ||
+      cached.mtime_ns != GetMtimeNs(s)) {
+    gCachedDexChecksums->erase(it);
+    return false;
+  }
+  cached_required_dex_checksums_ = cached.checksums;
+  zip_file_only_contains_uncompressed_dex_ = cached.only_contains_uncompressed_dex;
+  return true;
+}
+
+void OatFileAssistant::CacheDexChecksums() {
+  if (UseFdToReadFiles()) {
+    return;
+  }
+  // Note: The file could have changed since the checksums were read. The racing writer would
+  // have to preserve the size and the mtime for a stale entry to be used, which the package
+  // manager never does.
+  struct stat s;
+  if (TEMP_FAILURE_RETRY(stat(dex_location_.c_str(), &s)) != 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> mu(gStatusCacheLock);
+  if (gCachedDexChecksums == nullptr) {
+    gCachedDexChecksums = new std::unordered_map<std::string, CachedDexChecksums>();
+  }
+  if (gCachedDexChecksums->size() >= kMaxCachedDexChecksums) {
+    gCachedDexChecksums->clear();
+  }
+  (*gCachedDexChecksums)[dex_location_] = CachedDexChecksums{
+      s.st_dev,
+      s.st_ino,
+      s.st_size,
+      GetMtimeNs(s),
+      cached_required_dex_checksums_,
+      zip_file_only_contains_uncompressed_dex_};
+}
+
 bool OatFileAssistant::ValidateBootClassPathChecksums(const OatFile& oat_file) {
   // Get the checksums and the BCP from the oat file.
   const char* oat_boot_class_path_checksums =
@@ -618,6 +742,11 @@ bool OatFileAssistant::ValidateBootClassPathChecksums(const OatFile& oat_file) {
       oat_boot_class_path_checksums_view == cached_boot_class_path_checksums_) {
     return true;
   }
+  if (IsValidatedBootClassPath(oat_boot_class_path_view, oat_boot_class_path_checksums_view)) {
+    cached_boot_class_path_ = oat_boot_class_path_view;
+    cached_boot_class_path_checksums_ = oat_boot_class_path_checksums_view;
+    return true;
+  }
 
   Runtime* runtime = Runtime::Current();
   std::string error_msg;
@@ -652,6 +781,7 @@ bool OatFileAssistant::ValidateBootClassPathChecksums(const OatFile& oat_file) {
   // This checksum has been validated, so save it.
   cached_boot_class_path_ = oat_boot_class_path_view;
   cached_boot_class_path_checksums_ = oat_boot_class_path_checksums_view;
+  AddValidatedBootClassPath(oat_boot_class_path_view, oat_boot_class_path_checksums_view);
   return true;
 }
 
@@ -260,6 +260,11 @@ class OatFileAssistant {
   // anonymous dex file(s) created by AnonymousDexVdexLocation.
   static bool IsAnonymousVdexBasename(const std::string& basename);
 
+  // Clears the process-wide caches of dex checksums and validated boot class
+  // paths. Called when the runtime shuts down, since validated boot class
+  // paths are only valid for the boot image of the current runtime.
+  static void ClearStatusCaches();
+
  private:
   class OatFileInfo {
    public:
@@ -400,6 +405,15 @@ class OatFileAssistant {
   // dex_location_ dex file.
   const std::vector<uint32_t>* GetRequiredDexChecksums();
 
+  // Looks up the dex checksums of dex_location_ in the process-wide cache, which holds the
+  // checksums of dex locations whose file identity has not changed since they were read.
+  // Returns true and sets cached_required_dex_checksums_ and
+  // zip_file_only_contains_uncompressed_dex_ on a hit.
+  bool LookupCachedDexChecksums();
+
+  // Adds cached_required_dex_checksums_ to the process-wide cache.
+  void CacheDexChecksums();
+
   // Validates the boot class path checksum of an OatFile.
   bool ValidateBootClassPathChecksums(const OatFile& oat_file);
 
@@ -27,11 +27,13 @@
 #include "art_field-inl.h"
 #include "base/bit_vector-inl.h"
 #include "base/file_utils.h"
+#include "base/os.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex-inl.h"
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
+#include "base/unix_file/fd_file.h"
 #include "class_linker.h"
 #include "class_loader_context.h"
 #include "dex/art_dex_file_loader.h"
@@ -46,9 +48,11 @@
 #include "jni/jni_internal.h"
 #include "mirror/class_loader.h"
 #include "mirror/object-inl.h"
+#include "oat.h"
 #include "oat_file.h"
 #include "oat_file_assistant.h"
 #include "obj_ptr-inl.h"
+#include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
 #include "thread_list.h"
@@ -125,6 +129,16 @@ const OatFile* OatFileManager::FindOpenedOatFileFromOatLocationLocked(
   return nullptr;
 }
 
+const OatFile* OatFileManager::FindOpenedOatFileContainingPc(const void* pc) const {
+  ReaderMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+  for (const std::unique_ptr<const OatFile>& oat_file : oat_files_) {
+    if (oat_file->Contains(pc)) {
+      return oat_file.get();
+    }
+  }
+  return nullptr;
+}
+
 std::vector<const OatFile*> OatFileManager::GetBootOatFiles() const {
   std::vector<gc::space::ImageSpace*> image_spaces =
       Runtime::Current()->GetHeap()->GetBootImageSpaces();
@@ -399,6 +413,34 @@ OatFileManager::CheckCollisionResult OatFileManager::CheckCollision(
     return CheckCollisionResult::kSkippedVerificationDisabled;
   }
 
+  // The result only depends on the oat file and on the dex files of the context, look for
+  // a previous check of the same module in the same context.
+  std::string cache_key = StringPrintf("%08x", oat_file->GetOatHeader().GetChecksum()) +
+      oat_file->GetLocation() + '*' + context->EncodeContextForOatFile("");
+  {
+    MutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+    auto it = collision_check_cache_.find(cache_key);
+    if (it != collision_check_cache_.end()) {
+      *error_msg = it->second.second;
+      return it->second.first;
+    }
+  }
+
+  CheckCollisionResult check_result = CheckCollisionUncached(oat_file, context, error_msg);
+  {
+    MutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+    if (collision_check_cache_.size() == kMaxCollisionCheckCacheSize) {
+      collision_check_cache_.clear();
+    }
+    collision_check_cache_.emplace(std::move(cache_key), std::make_pair(check_result, *error_msg));
+  }
+  return check_result;
+}
+
+OatFileManager::CheckCollisionResult OatFileManager::CheckCollisionUncached(
+    const OatFile* oat_file,
+    const ClassLoaderContext* context,
+    /*out*/ std::string* error_msg) const {
   // If the oat file loading context matches the context used during compilation then we accept
   // the oat file without addition checks
   ClassLoaderContext::VerificationResult result = context->VerifyClassLoaderContextMatch(
@@ -656,6 +698,15 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     Runtime::Current()->GetJit()->RegisterDexFiles(dex_files, class_loader);
   }
 
+  // Classes outside of the app image get resolved and linked on first use. Load the classes the
+  // profile lists for startup in the background so that the main thread finds them linked.
+  // Without a verified oat or vdex file, also verify them.
+  if (class_loader != nullptr && !dex_files.empty()) {
+    bool verify = source_oat_file == nullptr ||
+        !CompilerFilter::IsVerificationEnabled(source_oat_file->GetCompilerFilter());
+    PreloadStartupClasses(dex_files, class_loader, std::string(dex_location) + ".prof", verify);
+  }
+
   // Verify if any of the dex files being loaded is already in the class path.
   // If so, report an error with the current stack trace.
   // Most likely the developer didn't intend to do this because it will waste
@@ -1010,6 +1061,166 @@ class BackgroundVerificationTask final : public Task {
   DISALLOW_COPY_AND_ASSIGN(BackgroundVerificationTask);
 };
 
+class StartupClassTask final : public Task {
+ public:
+  StartupClassTask(jobject class_loader,
+                   std::vector<std::pair<const DexFile*, dex::TypeIndex>>&& classes,
+                   bool verify)
+      : classes_(std::move(classes)), verify_(verify) {
+    Thread* const self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    // Create a global ref for `class_loader` because it will be accessed from a different thread.
+    class_loader_ = soa.Vm()->AddGlobalRef(self, soa.Decode<mirror::ClassLoader>(class_loader));
+    CHECK(class_loader_ != nullptr);
+  }
+
+  ~StartupClassTask() {
+    Thread* const self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    soa.Vm()->DeleteGlobalRef(self, class_loader_);
+  }
+
+  void Run(Thread* self) override {
+    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+    for (const std::pair<const DexFile*, dex::TypeIndex>& entry : classes_) {
+      const DexFile* dex_file = entry.first;
+      // Take handles inside the loop, like the background verification, to avoid blocking
+      // anyone else for long.
+      ScopedObjectAccess soa(self);
+      StackHandleScope<2> hs(self);
+      Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+          soa.Decode<mirror::ClassLoader>(class_loader_)));
+      Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
+          self,
+          dex_file->StringByTypeIdx(entry.second),
+          h_loader)));
+      if (h_class == nullptr) {
+        // The class loader may not list the dex files yet, or the class fails to load.
+        CHECK(self->IsExceptionPending());
+        self->ClearException();
+        continue;
+      }
+      // Finding the class resolves and links it. Class initializers are not run here.
+      if (!verify_ || &h_class->GetDexFile() != dex_file || h_class->IsVerified()) {
+        continue;
+      }
+      class_linker->VerifyClass(self, h_class);
+      if (h_class->IsErroneous()) {
+        // ClassLinker::VerifyClass throws, which isn't useful here.
+        CHECK(self->IsExceptionPending());
+        self->ClearException();
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::vector<std::pair<const DexFile*, dex::TypeIndex>> classes_;
+  const bool verify_;
+  jobject class_loader_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupClassTask);
+};
+
+ThreadPool* OatFileManager::GetVerificationThreadPool(Thread* self) {
+  if (verification_thread_pool_ == nullptr) {
+    verification_thread_pool_.reset(
+        new ThreadPool("Verification thread pool", kNumVerificationThreads));
+    verification_thread_pool_->StartWorkers(self);
+  }
+  return verification_thread_pool_.get();
+}
+
+void OatFileManager::PreloadStartupClasses(
+    const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+    jobject class_loader,
+    const std::string& profile_file,
+    bool verify) {
+  Runtime* const runtime = Runtime::Current();
+  Thread* const self = Thread::Current();
+
+  verify = verify && runtime->IsVerificationEnabled();
+
+  if (runtime->IsJavaDebuggable()) {
+    // Runtime threads are not allowed to load classes when debuggable, see
+    // RunBackgroundVerification().
+    return;
+  }
+
+  if (!IsSdkVersionSetAndAtLeast(runtime->GetTargetSdkVersion(), SdkVersion::kQ)) {
+    // Do not run for legacy apps as they may depend on the previous class loader behaviour.
+    return;
+  }
+
+  if (runtime->IsShuttingDown(self) || !OS::FileExists(profile_file.c_str())) {
+    return;
+  }
+
+  ProfileCompilationInfo profile;
+  unix_file::FdFile file(profile_file.c_str(), O_RDONLY, /* check_usage= */ true);
+  if (file.Fd() == -1 || !profile.Load(file.Fd())) {
+    LOG(WARNING) << "Could not load profile " << profile_file << " for startup class loading";
+    return;
+  }
+
+  // Collect the classes defined in the dex files that the profile lists as resolved during
+  // startup or that declare startup methods.
+  std::vector<std::pair<const DexFile*, dex::TypeIndex>> classes;
+  for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+    std::set<dex::TypeIndex> class_types;
+    std::set<uint16_t> hot_methods;
+    std::set<uint16_t> startup_methods;
+    std::set<uint16_t> post_startup_methods;
+    // This also checks the dex file checksum.
+    if (!profile.GetClassesAndMethods(*dex_file,
+                                      &class_types,
+                                      &hot_methods,
+                                      &startup_methods,
+                                      &post_startup_methods)) {
+      continue;
+    }
+    for (uint16_t method_idx : startup_methods) {
+      class_types.insert(dex_file->GetMethodId(method_idx).class_idx_);
+    }
+    for (dex::TypeIndex type_idx : class_types) {
+      if (dex_file->FindClassDef(type_idx) != nullptr) {
+        classes.emplace_back(dex_file.get(), type_idx);
+      }
+    }
+  }
+  if (classes.empty()) {
+    return;
+  }
+  VLOG(oat) << (verify ? "Verifying " : "Loading ") << classes.size() << " startup classes of "
+            << profile_file;
+
+  {
+    // Register the dex files so that they are not deleted while the tasks use them.
+    ScopedObjectAccess soa(self);
+    ObjPtr<mirror::ClassLoader> loader = soa.Decode<mirror::ClassLoader>(class_loader);
+    ClassLinker* const class_linker = runtime->GetClassLinker();
+    for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+      class_linker->RegisterDexFile(*dex_file, loader);
+    }
+  }
+
+  // Spread the classes over the threads, keeping the profile order within each task.
+  std::vector<std::pair<const DexFile*, dex::TypeIndex>> task_classes[kNumVerificationThreads];
+  for (size_t i = 0; i != classes.size(); ++i) {
+    task_classes[i % kNumVerificationThreads].push_back(classes[i]);
+  }
+  ThreadPool* thread_pool = GetVerificationThreadPool(self);
+  for (std::vector<std::pair<const DexFile*, dex::TypeIndex>>& task_class_list : task_classes) {
+    if (!task_class_list.empty()) {
+      thread_pool->AddTask(
+          self, new StartupClassTask(class_loader, std::move(task_class_list), verify));
+    }
+  }
+}
+
 void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>& dex_files,
                                                jobject class_loader,
                                                const char* class_loader_context) {
@@ -1041,12 +1252,7 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
                                                  &location_checksum,
                                                  &dex_location,
                                                  &vdex_path)) {
-    if (verification_thread_pool_ == nullptr) {
-      verification_thread_pool_.reset(
-          new ThreadPool("Verification thread pool", /* num_threads= */ 1));
-      verification_thread_pool_->StartWorkers(self);
-    }
-    verification_thread_pool_->AddTask(self, new BackgroundVerificationTask(
+    GetVerificationThreadPool(self)->AddTask(self, new BackgroundVerificationTask(
         dex_files,
         class_loader,
         class_loader_context,
@@ -21,6 +21,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "base/locks.h"
@@ -39,6 +40,7 @@ class ClassLoaderContext;
 class DexFile;
 class MemMap;
 class OatFile;
+class Thread;
 class ThreadPool;
 
 // Class for dealing with oat file management.
@@ -67,6 +69,10 @@ class OatFileManager {
   const OatFile* FindOpenedOatFileFromDexLocation(const std::string& dex_base_location) const
       REQUIRES(!Locks::oat_file_manager_lock_);
 
+  // Find the opened oat file whose mapping contains `pc`, returns null if there are none.
+  const OatFile* FindOpenedOatFileContainingPc(const void* pc) const
+      REQUIRES(!Locks::oat_file_manager_lock_);
+
   // Returns the boot image oat files.
   std::vector<const OatFile*> GetBootOatFiles() const;
 
@@ -127,6 +133,15 @@ class OatFileManager {
                                  jobject class_loader,
                                  const char* class_loader_context);
 
+  // Resolve and link the classes that the profile at `profile_file` lists for startup in the
+  // background, without initializing them. With `verify`, used for dex files opened without a
+  // verified oat or vdex file, also verify them.
+  void PreloadStartupClasses(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+                             jobject class_loader,
+                             const std::string& profile_file,
+                             bool verify)
+      REQUIRES(!Locks::mutator_lock_);
+
   // Wait for thread pool workers to be created. This is used during shutdown as
   // threads are not allowed to attach while runtime is in shutdown lock.
   void WaitForWorkersToBeCreated();
@@ -172,6 +187,12 @@ class OatFileManager {
                                       /*out*/ std::string* error_msg) const
       REQUIRES(!Locks::oat_file_manager_lock_);
 
+  // Performs the checks of `CheckCollision()` for a non-null context, without the cache.
+  CheckCollisionResult CheckCollisionUncached(const OatFile* oat_file,
+                                              const ClassLoaderContext* context,
+                                              /*out*/ std::string* error_msg) const
+      REQUIRES(!Locks::oat_file_manager_lock_);
+
   const OatFile* FindOpenedOatFileFromOatLocationLocked(const std::string& oat_location) const
       REQUIRES(Locks::oat_file_manager_lock_);
 
@@ -184,15 +205,30 @@ class OatFileManager {
                           ClassLoaderContext* context,
                           std::string* error_msg);
 
+  // Create the verification thread pool if needed.
+  ThreadPool* GetVerificationThreadPool(Thread* self);
+
+  // Number of threads verifying classes in the background.
+  static constexpr size_t kNumVerificationThreads = 2u;
+
+  // Maximum number of memoized collision check results, the cache is cleared when full.
+  static constexpr size_t kMaxCollisionCheckCacheSize = 64u;
+
   std::set<std::unique_ptr<const OatFile>> oat_files_ GUARDED_BY(Locks::oat_file_manager_lock_);
 
   // Only use the compiled code in an OAT file when the file is on /system. If the OAT file
   // is not on /system, don't load it "executable".
   bool only_use_system_oat_files_;
 
-  // Single-thread pool used to run the verifier in the background.
+  // Thread pool used to run the verifier in the background.
   std::unique_ptr<ThreadPool> verification_thread_pool_;
 
+  // Results of `CheckCollision()` with the error message, keyed by the oat file checksum and
+  // location and the encoded class loader context including the dex checksums. Apps creating
+  // many class loaders for the same modules repeat the same checks.
+  mutable std::unordered_map<std::string, std::pair<CheckCollisionResult, std::string>>
+      collision_check_cache_ GUARDED_BY(Locks::oat_file_manager_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(OatFileManager);
 };
 
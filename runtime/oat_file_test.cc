@@ -20,6 +20,7 @@
 
 #include <gtest/gtest.h>
 
+#include "base/time_utils.h"
 #include "common_runtime_test.h"
 #include "dexopt_test.h"
 #include "scoped_thread_state_change-inl.h"
@@ -93,4 +94,45 @@ TEST_F(OatFileTest, ChangingMultiDexUncompressed) {
       << error_msg;
 }
 
+TEST_F(OatFileTest, BenchmarkDlopenAndElfFileLoading) {
+  static constexpr size_t kIterations = 20;
+  std::string dex_location = GetScratchDir() + "/BenchmarkLoading.jar";
+
+  Copy(GetDexSrc1(), dex_location);
+  GenerateOatForTest(dex_location.c_str(), CompilerFilter::kSpeed);
+
+  std::string oat_location;
+  std::string error_msg;
+  ASSERT_TRUE(OatFileAssistant::DexLocationToOatFilename(
+        dex_location, kRuntimeISA, &oat_location, &error_msg)) << error_msg;
+
+  Runtime* runtime = Runtime::Current();
+  const bool use_dlopen = runtime->UseDlopenForOatFiles();
+  auto benchmark = [&](bool dlopen) {
+    runtime->SetUseDlopenForOatFiles(dlopen);
+    uint64_t start = NanoTime();
+    for (size_t i = 0; i < kIterations; ++i) {
+      std::unique_ptr<OatFile> oat_file(OatFile::Open(/*zip_fd=*/ -1,
+                                                      oat_location,
+                                                      oat_location,
+                                                      /*executable=*/ true,
+                                                      /*low_4gb=*/ false,
+                                                      dex_location,
+                                                      &error_msg));
+      EXPECT_TRUE(oat_file != nullptr) << error_msg;
+      if (oat_file != nullptr) {
+        EXPECT_TRUE(oat_file->IsExecutable());
+        EXPECT_EQ(1u, oat_file->GetOatDexFiles().size());
+      }
+    }
+    return NanoTime() - start;
+  };
+  const uint64_t dlopen_time = benchmark(/*dlopen=*/ true);
+  const uint64_t elf_file_time = benchmark(/*dlopen=*/ false);
+  runtime->SetUseDlopenForOatFiles(use_dlopen);
+  LOG(INFO) << "Opening " << oat_location << " " << kIterations << " times: "
+            << "dlopen " << PrettyDuration(dlopen_time) << ", ElfFile "
+            << PrettyDuration(elf_file_time);
+}
+
 }  // namespace art
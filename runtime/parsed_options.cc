@@ -110,6 +110,11 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::CheckJni)
       .Define("-Xjniopts:forcecopy")
           .IntoKey(M::JniOptsForceCopy)
+      .Define("-Xjniopts:warnonly")
+          .IntoKey(M::JniOptsWarnOnly)
+      .Define("-XX:CheckJniSampleRate=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::CheckJniSampleRate)
       .Define("-XjdwpProvider:_")
           .WithType<JdwpProvider>()
           .IntoKey(M::JdwpProvider)
@@ -165,6 +170,10 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:MaxSpinsBeforeThinLockInflation=_")
           .WithType<unsigned int>()
           .IntoKey(M::MaxSpinsBeforeThinLockInflation)
+      .Define("-XX:AddressIdentityHash:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::AddressIdentityHash)
       .Define("-XX:LongPauseLogThreshold=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::LongPauseLogThreshold)
@@ -177,6 +186,11 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::DumpRegionInfoBeforeGC)
       .Define("-XX:DumpRegionInfoAfterGC")
           .IntoKey(M::DumpRegionInfoAfterGC)
+      .Define("-XX:GroupZygoteDirtyObjects")
+          .IntoKey(M::GroupZygoteDirtyObjects)
+      .Define("-XX:ZygoteDirtyClassesProfile:_")
+          .WithType<std::string>()
+          .IntoKey(M::ZygoteDirtyClassesProfile)
       .Define("-XX:DumpJITInfoOnShutdown")
           .IntoKey(M::DumpJITInfoOnShutdown)
       .Define("-XX:IgnoreMaxFootprint")
@@ -193,10 +207,22 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::DumpNativeStackOnSigQuit)
+      .Define("-XX:StagedSigQuitDump:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::StagedSigQuitDump)
+      .Define("-XX:ImplicitSuspendChecks:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::ImplicitSuspendChecks)
       .Define("-XX:MadviseRandomAccess:_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::MadviseRandomAccess)
+      .Define("-XX:UseDlopenForOatFiles:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::UseDlopenForOatFiles)
       .Define("-XMadviseWillNeedVdexFileSize:_")
           .WithType<unsigned int>()
           .IntoKey(M::MadviseWillNeedVdexFileSize)
@@ -206,6 +232,14 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XMadviseWillNeedArtFileSize:_")
           .WithType<unsigned int>()
           .IntoKey(M::MadviseWillNeedArtFileSize)
+      .Define("-Xusehugepagesforcode:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::UseHugePagesForCode)
+      .Define("-Xprefetchbootimagepages:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::PrefetchBootImagePages)
       .Define("-Xusejit:_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -238,6 +272,22 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitpthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITPoolThreadPthreadPriority)
+      .Define("-Xjitthreads:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITPoolThreadCount)
+      .Define("-Xjitpersistentcache:_")
+          .WithType<std::string>()
+          .IntoKey(M::JITPersistentCache)
+      .Define("-Xjitsharedcache:_")
+          .WithType<std::string>()
+          .IntoKey(M::JITSharedCache)
+      .Define("-Xjitcommitbatch:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITCommitBatchSize)
+      .Define("-Xjitprefillbss:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITPrefillBss)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -271,11 +321,15 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<gc::space::LargeObjectSpaceType>()
           .WithValueMap({{"disabled", gc::space::LargeObjectSpaceType::kDisabled},
                          {"freelist", gc::space::LargeObjectSpaceType::kFreeList},
-                         {"map",      gc::space::LargeObjectSpaceType::kMap}})
+                         {"map",      gc::space::LargeObjectSpaceType::kMap},
+                         {"cachedmap", gc::space::LargeObjectSpaceType::kCachedMap}})
           .IntoKey(M::LargeObjectSpace)
       .Define("-XX:LargeObjectThreshold=_")
           .WithType<Memory<1>>()
           .IntoKey(M::LargeObjectThreshold)
+      .Define("-XX:NonMovingArrayThreshold=_")
+          .WithType<Memory<1>>()
+          .IntoKey(M::NonMovingArrayThreshold)
       .Define("-XX:BackgroundGC=_")
           .WithType<BackgroundGcOption>()
           .IntoKey(M::BackgroundGc)
@@ -290,6 +344,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xstackdumplockprofthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::StackDumpLockProfThreshold)
+      .Define("-Xmutexcontentionsampling:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::MutexContentionSamplingPeriod)
       .Define("-Xmethod-trace")
           .IntoKey(M::MethodTrace)
       .Define("-Xmethod-trace-file:_")
@@ -355,6 +412,12 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:GlobalRefAllocStackTraceLimit=_")  // Number of free slots to enable tracing.
           .WithType<unsigned int>()
           .IntoKey(M::GlobalRefAllocStackTraceLimit)
+      .Define("-XX:AllocationSamplingInterval=_")  // Bytes allocated per sample, 0 for off.
+          .WithType<Memory<1>>()
+          .IntoKey(M::AllocationSamplingInterval)
+      .Define("-XX:MaxStackTraceDepth=_")  // Number of frames recorded, 0 for no limit.
+          .WithType<unsigned int>()
+          .IntoKey(M::MaxStackTraceDepth)
       .Define("-XX:SlowDebug=_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -381,6 +444,10 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::FastClassNotFoundException)
+      .Define("-XX:LazyImt=_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::LazyImt)
       .Define("-Xopaque-jni-ids:_")
           .WithType<JniIdType>()
           .WithValueMap({{"true", JniIdType::kIndices},
@@ -745,6 +812,7 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "The following Dalvik options are supported:\n");
   UsageMessage(stream, "  -Xzygote\n");
   UsageMessage(stream, "  -Xjnitrace:substring (eg NativeClass or nativeMethod)\n");
+  UsageMessage(stream, "  -Xjniopts:{warnonly,forcecopy}\n");
   UsageMessage(stream, "  -Xgc:[no]preverify\n");
   UsageMessage(stream, "  -Xgc:[no]postverify\n");
   UsageMessage(stream, "  -XX:HeapGrowthLimit=N\n");
@@ -764,6 +832,8 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xgc:[no]postverify_rosalloc\n");
   UsageMessage(stream, "  -Xgc:[no]presweepingverify\n");
   UsageMessage(stream, "  -Xgc:[no]generational_cc\n");
+  UsageMessage(stream, "  -Xgc:[no]parallel_marking\n");
+  UsageMessage(stream, "  -Xgc:[no]pacing\n");
   UsageMessage(stream, "  -Ximage:filename\n");
   UsageMessage(stream, "  -Xbootclasspath-locations:bootclasspath\n"
                        "     (override the dex locations of the -Xbootclasspath files)\n");
@@ -771,20 +841,38 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -XX:ParallelGCThreads=integervalue\n");
   UsageMessage(stream, "  -XX:ConcGCThreads=integervalue\n");
   UsageMessage(stream, "  -XX:FinalizerTimeoutMs=integervalue\n");
+  UsageMessage(stream, "  -XX:CheckJniSampleRate=integervalue\n"
+                       "     (with -Xcheck:jni, do the thorough checks for one in N JNI calls)\n");
   UsageMessage(stream, "  -XX:MaxSpinsBeforeThinLockInflation=integervalue\n");
+  UsageMessage(stream, "  -XX:AddressIdentityHash:{false,true}\n"
+                       "     (derive identity hash codes of non-moving objects from their\n"
+                       "     address)\n");
   UsageMessage(stream, "  -XX:LongPauseLogThreshold=integervalue\n");
   UsageMessage(stream, "  -XX:LongGCLogThreshold=integervalue\n");
   UsageMessage(stream, "  -XX:ThreadSuspendTimeout=integervalue\n");
+  UsageMessage(stream, "  -XX:AllocationSamplingInterval=N\n"
+                       "     (record one allocation per N bytes allocated, for JVMTI agents)\n");
+  UsageMessage(stream, "  -XX:MaxStackTraceDepth=integervalue\n"
+                       "     (record at most N frames in exception stack traces, 0 for no\n"
+                       "     limit)\n");
   UsageMessage(stream, "  -XX:DumpGCPerformanceOnShutdown\n");
   UsageMessage(stream, "  -XX:DumpJITInfoOnShutdown\n");
   UsageMessage(stream, "  -XX:IgnoreMaxFootprint\n");
   UsageMessage(stream, "  -XX:UseTLAB\n");
+  UsageMessage(stream, "  -XX:GroupZygoteDirtyObjects\n");
+  UsageMessage(stream, "  -XX:ZygoteDirtyClassesProfile:filename\n");
   UsageMessage(stream, "  -XX:BackgroundGC=none\n");
-  UsageMessage(stream, "  -XX:LargeObjectSpace={disabled,map,freelist}\n");
+  UsageMessage(stream, "  -XX:LargeObjectSpace={disabled,map,cachedmap,freelist}\n");
   UsageMessage(stream, "  -XX:LargeObjectThreshold=N\n");
+  UsageMessage(stream, "  -XX:NonMovingArrayThreshold=N\n"
+                       "     (allocate primitive arrays of at least N bytes in the non-moving\n"
+                       "     space for direct JNI access, N >= 3 pages)\n");
   UsageMessage(stream, "  -XX:StopForNativeAllocs=N\n");
   UsageMessage(stream, "  -XX:DumpNativeStackOnSigQuit=booleanvalue\n");
+  UsageMessage(stream, "  -XX:StagedSigQuitDump=booleanvalue\n");
+  UsageMessage(stream, "  -XX:ImplicitSuspendChecks=booleanvalue\n");
   UsageMessage(stream, "  -XX:MadviseRandomAccess:booleanvalue\n");
+  UsageMessage(stream, "  -XX:UseDlopenForOatFiles:booleanvalue\n");
   UsageMessage(stream, "  -XX:SlowDebug={false,true}\n");
   UsageMessage(stream, "  -Xmethod-trace\n");
   UsageMessage(stream, "  -Xmethod-trace-file:filename\n");
@@ -800,12 +888,19 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xcompiler:filename\n");
   UsageMessage(stream, "  -Xcompiler-option dex2oat-option\n");
   UsageMessage(stream, "  -Ximage-compiler-option dex2oat-option\n");
+  UsageMessage(stream, "  -Xusehugepagesforcode:booleanvalue\n");
+  UsageMessage(stream, "  -Xprefetchbootimagepages:booleanvalue\n");
   UsageMessage(stream, "  -Xusejit:booleanvalue\n");
   UsageMessage(stream, "  -Xjitinitialsize:N\n");
   UsageMessage(stream, "  -Xjitmaxsize:N\n");
   UsageMessage(stream, "  -Xjitwarmupthreshold:integervalue\n");
   UsageMessage(stream, "  -Xjitosrthreshold:integervalue\n");
   UsageMessage(stream, "  -Xjitprithreadweight:integervalue\n");
+  UsageMessage(stream, "  -Xjitthreads:integervalue (0 to scale to the number of cores)\n");
+  UsageMessage(stream, "  -Xjitpersistentcache:file-path\n");
+  UsageMessage(stream, "  -Xjitsharedcache:file-path\n");
+  UsageMessage(stream, "  -Xjitcommitbatch:integervalue\n");
+  UsageMessage(stream, "  -Xjitprefillbss:booleanvalue\n");
   UsageMessage(stream, "  -X[no]relocate\n");
   UsageMessage(stream, "  -X[no]dex2oat (Whether to invoke dex2oat on the application)\n");
   UsageMessage(stream, "  -X[no]image-dex2oat (Whether to create and use a boot image)\n");
@@ -833,7 +928,6 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xint:portable, -Xint:fast, -Xint:jit\n");
   UsageMessage(stream, "  -Xdexopt:{none,verified,all,full}\n");
   UsageMessage(stream, "  -Xnoquithandler\n");
-  UsageMessage(stream, "  -Xjniopts:{warnonly,forcecopy}\n");
   UsageMessage(stream, "  -Xjnigreflimit:integervalue\n");
   UsageMessage(stream, "  -Xgc:[no]precise\n");
   UsageMessage(stream, "  -Xgc:[no]verifycardtable\n");
@@ -60,6 +60,9 @@ TEST_F(ParsedOptionsTest, ParsedOptions) {
   options.push_back(std::make_pair(class_path.c_str(), nullptr));
   options.push_back(std::make_pair("-Ximage:boot_image", nullptr));
   options.push_back(std::make_pair("-Xcheck:jni", nullptr));
+  options.push_back(std::make_pair("-XX:CheckJniSampleRate=100", nullptr));
+  options.push_back(std::make_pair("-XX:MaxStackTraceDepth=64", nullptr));
+  options.push_back(std::make_pair("-Xjniopts:warnonly", nullptr));
   options.push_back(std::make_pair("-Xms2048", nullptr));
   options.push_back(std::make_pair("-Xmx4k", nullptr));
   options.push_back(std::make_pair("-Xss1m", nullptr));
@@ -88,6 +91,9 @@ TEST_F(ParsedOptionsTest, ParsedOptions) {
   EXPECT_PARSED_EQ(class_path, Opt::ClassPath);
   EXPECT_PARSED_EQ(std::string("boot_image"), Opt::Image);
   EXPECT_PARSED_EXISTS(Opt::CheckJni);
+  EXPECT_PARSED_EQ(100U, Opt::CheckJniSampleRate);
+  EXPECT_PARSED_EQ(64U, Opt::MaxStackTraceDepth);
+  EXPECT_PARSED_EXISTS(Opt::JniOptsWarnOnly);
   EXPECT_PARSED_EQ(2048U, Opt::MemoryInitialSize);
   EXPECT_PARSED_EQ(4 * KB, Opt::MemoryMaximumSize);
   EXPECT_PARSED_EQ(1 * MB, Opt::StackSize);
@@ -150,6 +156,42 @@ TEST_F(ParsedOptionsTest, ParsedOptionsGenerationalCC) {
   ASSERT_TRUE(xgc.generational_cc);
 }
 
+TEST_F(ParsedOptionsTest, ParsedOptionsParallelMarking) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xgc:CC,parallel_marking", nullptr));
+
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+  ASSERT_NE(0u, map.Size());
+
+  using Opt = RuntimeArgumentMap;
+
+  EXPECT_TRUE(map.Exists(Opt::GcOption));
+
+  XGcOption xgc = map.GetOrDefault(Opt::GcOption);
+  EXPECT_EQ(gc::kCollectorTypeCC, xgc.collector_type_);
+  ASSERT_TRUE(xgc.parallel_marking_);
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsGcPacing) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xgc:CC,pacing", nullptr));
+
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+  ASSERT_NE(0u, map.Size());
+
+  using Opt = RuntimeArgumentMap;
+
+  EXPECT_TRUE(map.Exists(Opt::GcOption));
+
+  XGcOption xgc = map.GetOrDefault(Opt::GcOption);
+  EXPECT_EQ(gc::kCollectorTypeCC, xgc.collector_type_);
+  ASSERT_TRUE(xgc.pacing_);
+}
+
 TEST_F(ParsedOptionsTest, ParsedOptionsInstructionSet) {
   using Opt = RuntimeArgumentMap;
 
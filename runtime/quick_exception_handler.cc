@@ -21,6 +21,7 @@
 #include "base/enums.h"
 #include "base/logging.h"  // For VLOG_IS_ON.
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "dex/dex_file_types.h"
 #include "dex/dex_instruction.h"
 #include "entrypoints/entrypoint_utils.h"
@@ -30,11 +31,14 @@
 #include "interpreter/shadow_frame-inl.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
+#include "jit/profiling_info.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "mirror/throwable.h"
 #include "nterp_helpers.h"
 #include "oat_quick_method_header.h"
+#include "runtime.h"
+#include "runtime_stats.h"
 #include "stack.h"
 #include "stack_map.h"
 
@@ -145,6 +149,7 @@ class CatchBlockStackVisitor final : public StackVisitor {
 // Note that this might change the exception being thrown.
 void QuickExceptionHandler::FindCatch(ObjPtr<mirror::Throwable> exception) {
   DCHECK(!is_deoptimization_);
+  const uint64_t start_ns = NanoTime();
   instrumentation::InstrumentationStackPopper popper(self_);
   // The number of total frames we have so far popped.
   uint32_t already_popped = 0;
@@ -200,6 +205,17 @@ void QuickExceptionHandler::FindCatch(ObjPtr<mirror::Throwable> exception) {
     // Put exception back in root set with clear throw location.
     self_->SetException(exception_ref.Get());
   }
+  RuntimeStats* global_stats = Runtime::Current()->GetStats();
+  RuntimeStats* thread_stats = self_->GetStats();
+  const uint64_t delivery_time_ns = NanoTime() - start_ns;
+  ++global_stats->exception_throw_count;
+  ++thread_stats->exception_throw_count;
+  if (GetHandlerMethod() != nullptr) {
+    ++global_stats->exception_catch_count;
+    ++thread_stats->exception_catch_count;
+  }
+  global_stats->exception_delivery_time_ns += delivery_time_ns;
+  thread_stats->exception_delivery_time_ns += delivery_time_ns;
 }
 
 static VRegKind ToVRegKind(DexRegisterLocation::Kind kind) {
@@ -593,6 +609,11 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
     DumpFramesWithType(self_, /* details= */ true);
   }
   if (Runtime::Current()->UseJitCompilation()) {
+    // Let the next compilation of the method know that this speculation failed.
+    ProfilingInfo* profiling_info = deopt_method->GetProfilingInfo(kRuntimePointerSize);
+    if (profiling_info != nullptr) {
+      profiling_info->AddSpeculationFailure(kind);
+    }
     Runtime::Current()->GetJit()->GetCodeCache()->InvalidateCompiledCodeFor(
         deopt_method, visitor.GetSingleFrameDeoptQuickMethodHeader());
   } else {
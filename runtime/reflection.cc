@@ -41,6 +41,30 @@ namespace {
 
 using android::base::StringPrintf;
 
+// Returns the primitive type boxed by `o` and stores the boxed value in `value`, or returns
+// kPrimNot if `o` is not a boxed primitive. The boxing classes are recognized by comparing with
+// the declaring classes of their valueOf() methods rather than by comparing descriptors.
+Primitive::Type GetBoxedTypeAndValue(ObjPtr<mirror::Object> o, JValue* value)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ObjPtr<mirror::Class> klass = o->GetClass();
+#define CASE_BOXED(primitive, value_of, get_fn, set_fn)                                     \
+  if (klass == jni::DecodeArtMethod(WellKnownClasses::value_of)->GetDeclaringClass()) {     \
+    value->set_fn(klass->GetIFieldsPtr()->At(0).get_fn(o));                                 \
+    return primitive;                                                                       \
+  }
+  // Ordered by how likely the types are to be seen in reflective calls.
+  CASE_BOXED(Primitive::kPrimInt, java_lang_Integer_valueOf, GetInt, SetI)
+  CASE_BOXED(Primitive::kPrimLong, java_lang_Long_valueOf, GetLong, SetJ)
+  CASE_BOXED(Primitive::kPrimBoolean, java_lang_Boolean_valueOf, GetBoolean, SetZ)
+  CASE_BOXED(Primitive::kPrimDouble, java_lang_Double_valueOf, GetDouble, SetD)
+  CASE_BOXED(Primitive::kPrimFloat, java_lang_Float_valueOf, GetFloat, SetF)
+  CASE_BOXED(Primitive::kPrimChar, java_lang_Character_valueOf, GetChar, SetC)
+  CASE_BOXED(Primitive::kPrimShort, java_lang_Short_valueOf, GetShort, SetS)
+  CASE_BOXED(Primitive::kPrimByte, java_lang_Byte_valueOf, GetByte, SetB)
+#undef CASE_BOXED
+  return Primitive::kPrimNot;
+}
+
 class ArgArray {
  public:
   ArgArray(const char* shorty, uint32_t shorty_len)
@@ -238,120 +262,62 @@ class ArgArray {
         hs.NewHandle<mirror::ObjectArray<mirror::Object>>(raw_args));
     for (size_t i = 1, args_offset = 0; i < shorty_len_; ++i, ++args_offset) {
       arg.Assign(args->Get(args_offset));
-      if (((shorty_[i] == 'L') && (arg != nullptr)) ||
-          ((arg == nullptr && shorty_[i] != 'L'))) {
-        // TODO: The method's parameter's type must have been previously resolved, yet
-        // we've seen cases where it's not b/34440020.
-        ObjPtr<mirror::Class> dst_class(
-            m->ResolveClassFromTypeIndex(classes->GetTypeItem(args_offset).type_idx_));
-        if (dst_class == nullptr) {
-          CHECK(self->IsExceptionPending());
-          return false;
-        }
-        if (UNLIKELY(arg == nullptr || !arg->InstanceOf(dst_class))) {
-          ThrowIllegalArgumentException(
-              StringPrintf("method %s argument %zd has type %s, got %s",
-                  m->PrettyMethod(false).c_str(),
-                  args_offset + 1,  // Humans don't count from 0.
-                  mirror::Class::PrettyDescriptor(dst_class).c_str(),
-                  mirror::Object::PrettyTypeOf(arg.Get()).c_str()).c_str());
-          return false;
+      if (shorty_[i] == 'L') {
+        if (arg != nullptr) {
+          // TODO: The method's parameter's type must have been previously resolved, yet
+          // we've seen cases where it's not b/34440020.
+          ObjPtr<mirror::Class> dst_class(
+              m->ResolveClassFromTypeIndex(classes->GetTypeItem(args_offset).type_idx_));
+          if (dst_class == nullptr) {
+            CHECK(self->IsExceptionPending());
+            return false;
+          }
+          if (UNLIKELY(!arg->InstanceOf(dst_class))) {
+            ThrowIllegalArgumentException(
+                StringPrintf("method %s argument %zd has type %s, got %s",
+                    m->PrettyMethod(false).c_str(),
+                    args_offset + 1,  // Humans don't count from 0.
+                    mirror::Class::PrettyDescriptor(dst_class).c_str(),
+                    mirror::Object::PrettyTypeOf(arg.Get()).c_str()).c_str());
+            return false;
+          }
         }
+        Append(arg.Get());
+        continue;
       }
 
-#define DO_FIRST_ARG(match_descriptor, get_fn, append) { \
-          if (LIKELY(arg != nullptr && \
-              arg->GetClass()->DescriptorEquals(match_descriptor))) { \
-            ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
-            append(primitive_field-> get_fn(arg.Get()));
-
-#define DO_ARG(match_descriptor, get_fn, append) \
-          } else if (LIKELY(arg != nullptr && \
-                            arg->GetClass<>()->DescriptorEquals(match_descriptor))) { \
-            ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
-            append(primitive_field-> get_fn(arg.Get()));
-
-#define DO_FAIL(expected) \
-          } else { \
-            if (arg->GetClass<>()->IsPrimitive()) { \
-              std::string temp; \
-              ThrowIllegalPrimitiveArgumentException(expected, \
-                                                     arg->GetClass<>()->GetDescriptor(&temp)); \
-            } else { \
-              ThrowIllegalArgumentException(\
-                  StringPrintf("method %s argument %zd has type %s, got %s", \
-                      ArtMethod::PrettyMethod(m, false).c_str(), \
-                      args_offset + 1, \
-                      expected, \
-                      mirror::Object::PrettyTypeOf(arg.Get()).c_str()).c_str()); \
-            } \
-            return false; \
-          } }
-
-      switch (shorty_[i]) {
-        case 'L':
-          Append(arg.Get());
-          break;
-        case 'Z':
-          DO_FIRST_ARG("Ljava/lang/Boolean;", GetBoolean, Append)
-          DO_FAIL("boolean")
-          break;
-        case 'B':
-          DO_FIRST_ARG("Ljava/lang/Byte;", GetByte, Append)
-          DO_FAIL("byte")
-          break;
-        case 'C':
-          DO_FIRST_ARG("Ljava/lang/Character;", GetChar, Append)
-          DO_FAIL("char")
-          break;
-        case 'S':
-          DO_FIRST_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
-          DO_FAIL("short")
-          break;
-        case 'I':
-          DO_FIRST_ARG("Ljava/lang/Integer;", GetInt, Append)
-          DO_ARG("Ljava/lang/Character;", GetChar, Append)
-          DO_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
-          DO_FAIL("int")
+      // Unbox the argument and apply a widening primitive conversion if needed. The type of
+      // the parameter is known from the shorty, so it does not need to be resolved.
+      Primitive::Type dst_type = Primitive::GetType(shorty_[i]);
+      DCHECK(dst_type != Primitive::kPrimNot && dst_type != Primitive::kPrimVoid) << shorty_[i];
+      JValue boxed_value;
+      JValue value;
+      Primitive::Type src_type =
+          (arg != nullptr) ? GetBoxedTypeAndValue(arg.Get(), &boxed_value) : Primitive::kPrimNot;
+      if (UNLIKELY(src_type == Primitive::kPrimNot ||
+                   !ConvertPrimitiveValueNoThrow(src_type, dst_type, boxed_value, &value))) {
+        ThrowIllegalArgumentException(
+            StringPrintf("method %s argument %zd has type %s, got %s",
+                ArtMethod::PrettyMethod(m, false).c_str(),
+                args_offset + 1,  // Humans don't count from 0.
+                Primitive::PrettyDescriptor(dst_type),
+                mirror::Object::PrettyTypeOf(arg.Get()).c_str()).c_str());
+        return false;
+      }
+      switch (dst_type) {
+        case Primitive::kPrimLong:
+          AppendWide(value.GetJ());
           break;
-        case 'J':
-          DO_FIRST_ARG("Ljava/lang/Long;", GetLong, AppendWide)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendWide)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendWide)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendWide)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendWide)
-          DO_FAIL("long")
+        case Primitive::kPrimFloat:
+          AppendFloat(value.GetF());
           break;
-        case 'F':
-          DO_FIRST_ARG("Ljava/lang/Float;", GetFloat, AppendFloat)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendFloat)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendFloat)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendFloat)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendFloat)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendFloat)
-          DO_FAIL("float")
+        case Primitive::kPrimDouble:
+          AppendDouble(value.GetD());
           break;
-        case 'D':
-          DO_FIRST_ARG("Ljava/lang/Double;", GetDouble, AppendDouble)
-          DO_ARG("Ljava/lang/Float;", GetFloat, AppendDouble)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendDouble)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendDouble)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendDouble)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendDouble)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendDouble)
-          DO_FAIL("double")
-          break;
-#ifndef NDEBUG
         default:
-          LOG(FATAL) << "Unexpected shorty character: " << shorty_[i];
-          UNREACHABLE();
-#endif
+          Append(value.GetI());
+          break;
       }
-#undef DO_FIRST_ARG
-#undef DO_ARG
-#undef DO_FAIL
     }
     return true;
   }
@@ -928,34 +894,8 @@ static bool UnboxPrimitive(ObjPtr<mirror::Object> o,
   }
 
   JValue boxed_value;
-  ObjPtr<mirror::Class> klass = o->GetClass();
-  Primitive::Type primitive_type;
-  ArtField* primitive_field = &klass->GetIFieldsPtr()->At(0);
-  if (klass->DescriptorEquals("Ljava/lang/Boolean;")) {
-    primitive_type = Primitive::kPrimBoolean;
-    boxed_value.SetZ(primitive_field->GetBoolean(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Byte;")) {
-    primitive_type = Primitive::kPrimByte;
-    boxed_value.SetB(primitive_field->GetByte(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Character;")) {
-    primitive_type = Primitive::kPrimChar;
-    boxed_value.SetC(primitive_field->GetChar(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Float;")) {
-    primitive_type = Primitive::kPrimFloat;
-    boxed_value.SetF(primitive_field->GetFloat(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Double;")) {
-    primitive_type = Primitive::kPrimDouble;
-    boxed_value.SetD(primitive_field->GetDouble(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Integer;")) {
-    primitive_type = Primitive::kPrimInt;
-    boxed_value.SetI(primitive_field->GetInt(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Long;")) {
-    primitive_type = Primitive::kPrimLong;
-    boxed_value.SetJ(primitive_field->GetLong(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Short;")) {
-    primitive_type = Primitive::kPrimShort;
-    boxed_value.SetS(primitive_field->GetShort(o));
-  } else {
+  Primitive::Type primitive_type = GetBoxedTypeAndValue(o, &boxed_value);
+  if (primitive_type == Primitive::kPrimNot) {
     std::string temp;
     ThrowIllegalArgumentException(
         StringPrintf("%s has type %s, got %s", UnboxingFailureKind(f).c_str(),
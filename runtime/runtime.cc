@@ -67,10 +67,12 @@
 #include "base/systrace.h"
 #include "base/unix_file/fd_file.h"
 #include "base/utils.h"
+#include "boot_image_prefetch.h"
 #include "class_linker-inl.h"
 #include "class_root-inl.h"
 #include "compiler_callbacks.h"
 #include "debugger.h"
+#include "dex/annotation_cache.h"
 #include "dex/art_dex_file_loader.h"
 #include "dex/dex_file_loader.h"
 #include "elf_file.h"
@@ -87,6 +89,7 @@
 #include "handle_scope-inl.h"
 #include "hidden_api.h"
 #include "image-inl.h"
+#include "indirect_reference_table.h"
 #include "instrumentation.h"
 #include "intern_table-inl.h"
 #include "interpreter/interpreter.h"
@@ -147,6 +150,7 @@
 #include "nativehelper/scoped_local_ref.h"
 #include "oat.h"
 #include "oat_file.h"
+#include "oat_file_assistant.h"
 #include "oat_file_manager.h"
 #include "oat_quick_method_header.h"
 #include "object_callbacks.h"
@@ -163,6 +167,7 @@
 #include "signal_set.h"
 #include "thread.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "ti/agent.h"
 #include "trace.h"
 #include "transaction.h"
@@ -241,6 +246,7 @@ Runtime::Runtime()
       default_stack_size_(0),
       heap_(nullptr),
       max_spins_before_thin_lock_inflation_(Monitor::kDefaultMaxSpinsBeforeThinLockInflation),
+      use_address_identity_hash_(false),
       monitor_list_(nullptr),
       monitor_pool_(nullptr),
       thread_list_(nullptr),
@@ -284,9 +290,12 @@ Runtime::Runtime()
       experimental_flags_(ExperimentalFlags::kNone),
       oat_file_manager_(nullptr),
       is_low_memory_mode_(false),
+      use_dlopen_for_oat_files_(true),
       madvise_willneed_vdex_filesize_(0),
       madvise_willneed_odex_filesize_(0),
       madvise_willneed_art_filesize_(0),
+      use_huge_pages_for_code_(false),
+      prefetch_boot_image_pages_(false),
       safe_mode_(false),
       hidden_api_policy_(hiddenapi::EnforcementPolicy::kDisabled),
       core_platform_api_policy_(hiddenapi::EnforcementPolicy::kDisabled),
@@ -294,11 +303,13 @@ Runtime::Runtime()
       dedupe_hidden_api_warnings_(true),
       hidden_api_access_event_log_rate_(0),
       dump_native_stack_on_sig_quit_(true),
+      staged_sig_quit_dump_(false),
       pruned_dalvik_cache_(false),
       // Initially assume we perceive jank in case the process state is never updated.
       process_state_(kProcessStateJankPerceptible),
       zygote_no_threads_(false),
       verifier_logging_threshold_ms_(100),
+      max_stack_trace_depth_(0u),
       verifier_missing_kthrow_fatal_(false),
       perfetto_hprof_enabled_(false) {
   static_assert(Runtime::kCalleeSaveSize ==
@@ -495,6 +506,7 @@ Runtime::~Runtime() {
   Thread::Shutdown();
   QuasiAtomic::Shutdown();
   verifier::ClassVerifier::Shutdown();
+  OatFileAssistant::ClearStatusCaches();
 
   // Destroy allocators before shutting down the MemMap because they may use it.
   java_vm_.reset();
@@ -503,6 +515,7 @@ Runtime::~Runtime() {
   arena_pool_.reset();
   jit_arena_pool_.reset();
   protected_fault_page_.Reset();
+  IndirectReferenceTable::ReleasePooledTables();
   MemMap::Shutdown();
 
   // TODO: acquire a static mutex on Runtime to avoid racing.
@@ -710,25 +723,57 @@ void Runtime::CallExitHook(jint status) {
   }
 }
 
-void Runtime::SweepSystemWeaks(IsMarkedVisitor* visitor) {
-  GetInternTable()->SweepInternTableWeaks(visitor);
-  GetMonitorList()->SweepMonitorList(visitor);
-  GetJavaVM()->SweepJniWeakGlobals(visitor);
-  GetHeap()->SweepAllocationRecords(visitor);
+void Runtime::SweepSystemWeaks(IsMarkedVisitor* visitor, size_t thread_count) {
+  // Each of these tables is protected by its own lock, so they can be swept independently.
+  std::vector<std::function<void()>> sweepers;
+  sweepers.push_back([&]() NO_THREAD_SAFETY_ANALYSIS {
+    GetMonitorList()->SweepMonitorList(visitor);
+  });
+  sweepers.push_back([&]() NO_THREAD_SAFETY_ANALYSIS {
+    GetJavaVM()->SweepJniWeakGlobals(visitor);
+  });
+  sweepers.push_back([&]() NO_THREAD_SAFETY_ANALYSIS {
+    GetHeap()->SweepAllocationRecords(visitor);
+  });
   if (GetJit() != nullptr) {
     // Visit JIT literal tables. Objects in these tables are classes and strings
     // and only classes can be affected by class unloading. The strings always
     // stay alive as they are strongly interned.
     // TODO: Move this closer to CleanupClassLoaders, to avoid blocking weak accesses
     // from mutators. See b/32167580.
-    GetJit()->GetCodeCache()->SweepRootTables(visitor);
+    sweepers.push_back([&]() NO_THREAD_SAFETY_ANALYSIS {
+      GetJit()->GetCodeCache()->SweepRootTables(visitor);
+    });
   }
-  thread_list_->SweepInterpreterCaches(visitor);
-
+  sweepers.push_back([&]() NO_THREAD_SAFETY_ANALYSIS {
+    thread_list_->SweepInterpreterCaches(visitor);
+  });
   // All other generic system-weak holders.
   for (gc::AbstractSystemWeakHolder* holder : system_weak_holders_) {
-    holder->Sweep(visitor);
+    sweepers.push_back([visitor, holder]() NO_THREAD_SAFETY_ANALYSIS {
+      holder->Sweep(visitor);
+    });
   }
+
+  ThreadPool* const thread_pool = GetHeap()->GetThreadPool();
+  if (thread_pool == nullptr || thread_count <= 1) {
+    GetInternTable()->SweepInternTableWeaks(visitor);
+    for (const std::function<void()>& sweeper : sweepers) {
+      sweeper();
+    }
+    return;
+  }
+  Thread* const self = Thread::Current();
+  for (const std::function<void()>& sweeper : sweepers) {
+    thread_pool->AddTask(self, new FunctionTask([&sweeper](Thread*) { sweeper(); }));
+  }
+  thread_pool->SetMaxActiveWorkers(std::min(thread_count, sweepers.size() + 1) - 1);
+  thread_pool->StartWorkers(self);
+  // The intern table is usually the largest of the tables, and hashing its strings requires the
+  // mutator lock in debug builds, so this thread sweeps it while the workers do the rest.
+  GetInternTable()->SweepInternTableWeaks(visitor);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
 }
 
 bool Runtime::ParseOptions(const RuntimeOptions& raw_options,
@@ -853,6 +898,7 @@ void Runtime::RunRootClinits(Thread* self) {
 
 bool Runtime::Start() {
   VLOG(startup) << "Runtime::Start entering";
+  size_t start_phase = startup_timeline_.BeginPhase("Start");
 
   CHECK(!no_sig_chain_) << "A started runtime should have sig chain enabled";
 
@@ -894,14 +940,10 @@ bool Runtime::Start() {
   // it touches will have methods linked to the oat file if necessary.
   {
     ScopedTrace trace2("InitNativeMethods");
+    ScopedStartupPhase phase(&startup_timeline_, "InitNativeMethods");
     InitNativeMethods();
   }
 
-  // IntializeIntrinsics needs to be called after the WellKnownClasses::Init in InitNativeMethods
-  // because in checking the invocation types of intrinsic methods ArtMethod::GetInvokeType()
-  // needs the SignaturePolymorphic annotation class which is initialized in WellKnownClasses::Init.
-  InitializeIntrinsics();
-
   // InitializeCorePlatformApiPrivateFields() needs to be called after well known class
   // initializtion in InitNativeMethods().
   art::hiddenapi::InitializeCorePlatformApiPrivateFields();
@@ -919,6 +961,7 @@ bool Runtime::Start() {
   // recoding profiles. Maybe we should consider changing the name to be more clear it's
   // not only about compiling. b/28295073.
   if (jit_options_->UseJitCompilation() || jit_options_->GetSaveProfilingInfo()) {
+    ScopedStartupPhase phase(&startup_timeline_, "CreateJit");
     // Try to load compiler pre zygote to reduce PSS. b/27744947
     std::string error_msg;
     if (!jit::Jit::LoadCompilerLibrary(&error_msg)) {
@@ -935,7 +978,10 @@ bool Runtime::Start() {
     callbacks_->NextRuntimePhase(RuntimePhaseCallback::RuntimePhase::kStart);
   }
 
-  system_class_loader_ = CreateSystemClassLoader(this);
+  {
+    ScopedStartupPhase phase(&startup_timeline_, "CreateSystemClassLoader");
+    system_class_loader_ = CreateSystemClassLoader(this);
+  }
 
   if (!is_zygote_) {
     if (is_native_bridge_loaded_) {
@@ -951,7 +997,10 @@ bool Runtime::Start() {
                             GetInstructionSetString(kRuntimeISA));
   }
 
-  StartDaemonThreads();
+  {
+    ScopedStartupPhase phase(&startup_timeline_, "StartDaemonThreads");
+    StartDaemonThreads();
+  }
 
   // Make sure the environment is still clean (no lingering local refs from starting daemon
   // threads).
@@ -974,6 +1023,8 @@ bool Runtime::Start() {
 
   VLOG(startup) << "Runtime::Start exiting";
   finished_starting_ = true;
+  startup_timeline_.EndPhase(start_phase);
+  LOG(INFO) << Dumpable<StartupTimeline>(startup_timeline_);
 
   if (trace_config_.get() != nullptr && trace_config_->trace_file != "") {
     ScopedThreadStateChange tsc(self, kWaitingForMethodTracingStart);
@@ -1200,6 +1251,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   using Opt = RuntimeArgumentMap;
   Opt runtime_options(std::move(runtime_options_in));
   ScopedTrace trace(__FUNCTION__);
+  ScopedStartupPhase init_phase(&startup_timeline_, "Init");
   CHECK_EQ(sysconf(_SC_PAGE_SIZE), kPageSize);
 
   // Early override for logging output.
@@ -1248,6 +1300,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   Thread::SetSensitiveThreadHook(runtime_options.GetOrDefault(Opt::HookIsSensitiveThread));
   Monitor::Init(runtime_options.GetOrDefault(Opt::LockProfThreshold),
                 runtime_options.GetOrDefault(Opt::StackDumpLockProfThreshold));
+  BaseMutex::SetContentionSamplingPeriod(
+      runtime_options.GetOrDefault(Opt::MutexContentionSamplingPeriod));
 
   image_location_ = runtime_options.GetOrDefault(Opt::Image);
 
@@ -1297,6 +1351,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   is_explicit_gc_disabled_ = runtime_options.Exists(Opt::DisableExplicitGC);
   image_dex2oat_enabled_ = runtime_options.GetOrDefault(Opt::ImageDex2Oat);
   dump_native_stack_on_sig_quit_ = runtime_options.GetOrDefault(Opt::DumpNativeStackOnSigQuit);
+  staged_sig_quit_dump_ = runtime_options.GetOrDefault(Opt::StagedSigQuitDump);
 
   vfprintf_ = runtime_options.GetOrDefault(Opt::HookVfprintf);
   exit_ = runtime_options.GetOrDefault(Opt::HookExit);
@@ -1317,6 +1372,10 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   finalizer_timeout_ms_ = runtime_options.GetOrDefault(Opt::FinalizerTimeoutMs);
   max_spins_before_thin_lock_inflation_ =
       runtime_options.GetOrDefault(Opt::MaxSpinsBeforeThinLockInflation);
+  // Hash codes stored in an image must not depend on addresses in the compiler's heap, as that
+  // would make the image non-deterministic.
+  use_address_identity_hash_ =
+      runtime_options.GetOrDefault(Opt::AddressIdentityHash) && !IsAotCompiler();
 
   monitor_list_ = new MonitorList;
   monitor_pool_ = MonitorPool::Create();
@@ -1359,9 +1418,12 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   experimental_flags_ = runtime_options.GetOrDefault(Opt::Experimental);
   is_low_memory_mode_ = runtime_options.Exists(Opt::LowMemoryMode);
   madvise_random_access_ = runtime_options.GetOrDefault(Opt::MadviseRandomAccess);
+  use_dlopen_for_oat_files_ = runtime_options.GetOrDefault(Opt::UseDlopenForOatFiles);
   madvise_willneed_vdex_filesize_ = runtime_options.GetOrDefault(Opt::MadviseWillNeedVdexFileSize);
   madvise_willneed_odex_filesize_ = runtime_options.GetOrDefault(Opt::MadviseWillNeedOdexFileSize);
   madvise_willneed_art_filesize_ = runtime_options.GetOrDefault(Opt::MadviseWillNeedArtFileSize);
+  use_huge_pages_for_code_ = runtime_options.GetOrDefault(Opt::UseHugePagesForCode);
+  prefetch_boot_image_pages_ = runtime_options.GetOrDefault(Opt::PrefetchBootImagePages);
 
   jni_ids_indirection_ = runtime_options.GetOrDefault(Opt::OpaqueJniIds);
   automatically_set_jni_ids_indirection_ =
@@ -1390,6 +1452,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   image_space_loading_order_ = runtime_options.GetOrDefault(Opt::ImageSpaceLoadingOrder);
 
+  size_t heap_phase = startup_timeline_.BeginPhase("CreateHeap");
   heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
                        runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
                        runtime_options.GetOrDefault(Opt::HeapMinFree),
@@ -1409,6 +1472,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                                        : runtime_options.GetOrDefault(Opt::BackgroundGc),
                        runtime_options.GetOrDefault(Opt::LargeObjectSpace),
                        runtime_options.GetOrDefault(Opt::LargeObjectThreshold),
+                       runtime_options.GetOrDefault(Opt::NonMovingArrayThreshold),
                        runtime_options.GetOrDefault(Opt::ParallelGCThreads),
                        runtime_options.GetOrDefault(Opt::ConcGCThreads),
                        runtime_options.Exists(Opt::LowMemoryMode),
@@ -1426,10 +1490,15 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        xgc_option.measure_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
                        use_generational_cc,
+                       xgc_option.parallel_marking_,
+                       xgc_option.pacing_,
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
                        runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
                        runtime_options.Exists(Opt::DumpRegionInfoAfterGC),
+                       runtime_options.Exists(Opt::GroupZygoteDirtyObjects),
+                       runtime_options.GetOrDefault(Opt::ZygoteDirtyClassesProfile),
                        image_space_loading_order_);
+  startup_timeline_.EndPhase(heap_phase);
 
   if (!heap_->HasBootImageSpace() && !allow_dex_file_fallback_) {
     LOG(ERROR) << "Dex file fallback disabled, cannot continue without image.";
@@ -1508,6 +1577,12 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
       implicit_null_checks_ = true;
       // Historical note: Installing stack protection was not playing well with Valgrind.
       implicit_so_checks_ = true;
+      // Compiled code on ARM64 and x86-64 may use the load from the suspend trigger
+      // instead of testing the thread flags, see CompilerOptions::GetImplicitSuspendChecks().
+      // This is off unless requested, and the JIT follows this setting.
+      implicit_suspend_checks_ =
+          runtime_options.GetOrDefault(Opt::ImplicitSuspendChecks) &&
+          (kRuntimeISA == InstructionSet::kArm64 || kRuntimeISA == InstructionSet::kX86_64);
       break;
     default:
       // Keep the defaults.
@@ -1543,6 +1618,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   }
 
   verifier_logging_threshold_ms_ = runtime_options.GetOrDefault(Opt::VerifierLoggingThreshold);
+  max_stack_trace_depth_ = runtime_options.GetOrDefault(Opt::MaxStackTraceDepth);
 
   std::string error_msg;
   java_vm_ = JavaVMExt::Create(this, runtime_options, &error_msg);
@@ -1571,6 +1647,11 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Now we're attached, we can take the heap locks and validate the heap.
   GetHeap()->EnableObjectValidation();
+  size_t allocation_sampling_interval =
+      runtime_options.GetOrDefault(Opt::AllocationSamplingInterval);
+  if (allocation_sampling_interval != 0u) {
+    GetHeap()->SetAllocationSamplingInterval(allocation_sampling_interval);
+  }
 
   CHECK_GE(GetHeap()->GetContinuousSpaces().size(), 1U);
 
@@ -1579,8 +1660,12 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   } else {
     class_linker_ = new ClassLinker(
         intern_table_,
-        runtime_options.GetOrDefault(Opt::FastClassNotFoundException));
+        runtime_options.GetOrDefault(Opt::FastClassNotFoundException),
+        runtime_options.GetOrDefault(Opt::LazyImt));
   }
+  annotation_cache_.reset(new AnnotationCache());
+  AddSystemWeakHolder(annotation_cache_.get());
+  size_t class_linker_phase = startup_timeline_.BeginPhase("InitClassLinker");
   if (GetHeap()->HasBootImageSpace()) {
     bool result = class_linker_->InitFromBootImage(&error_msg);
     if (!result) {
@@ -1643,6 +1728,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
       }
     }
   }
+  startup_timeline_.EndPhase(class_linker_phase);
 
   CHECK(class_linker_ != nullptr);
 
@@ -1724,6 +1810,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   // We load plugins first since that can modify the runtime state slightly.
   // Load all plugins
   {
+    ScopedStartupPhase plugins_phase(&startup_timeline_, "LoadPlugins");
     // The init method of plugins expect the state of the thread to be non runnable.
     ScopedThreadSuspension sts(self, ThreadState::kNative);
     for (auto& plugin : plugins_) {
@@ -1768,6 +1855,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Startup agents
   // TODO Maybe we should start a new thread to run these on. Investigate RI behavior more.
+  size_t agents_phase = startup_timeline_.BeginPhase("LoadAgents");
   for (auto& agent_spec : agent_specs_) {
     // TODO Check err
     int res = 0;
@@ -1795,6 +1883,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     LOG(FATAL) << "Unreachable";
     UNREACHABLE();
   }
+  startup_timeline_.EndPhase(agents_phase);
   {
     ScopedObjectAccess soa(self);
     callbacks_->NextRuntimePhase(RuntimePhaseCallback::RuntimePhase::kInitialAgents);
@@ -1894,12 +1983,39 @@ void Runtime::InitNativeMethods() {
   // Must be in the kNative state for calling native methods (JNI_OnLoad code).
   CHECK_EQ(self->GetState(), kNative);
 
-  // Set up the native methods provided by the runtime itself.
-  RegisterRuntimeNativeMethods(env);
+  // Set up the native methods provided by the runtime itself. Meanwhile, look up the classes
+  // used in JNI and the intrinsic methods on another thread. The lookups only load classes, so
+  // they do not depend on the native methods or on each other's results.
+  std::vector<IntrinsicMethod> intrinsics;
+  {
+    ScopedStartupPhase phase(&startup_timeline_, "RegisterNativesAndLookups");
+    std::thread lookup_thread([this, &intrinsics]() {
+      CHECK(AttachCurrentThread("Startup lookups",
+                                /*as_daemon=*/ true,
+                                /*thread_group=*/ nullptr,
+                                /*create_peer=*/ false));
+      Thread* lookup_self = Thread::Current();
+      WellKnownClasses::InitClassesOnly(lookup_self->GetJniEnv());
+      {
+        ScopedObjectAccess soa(lookup_self);
+        intrinsics = FindUninitializedIntrinsics(soa.Self());
+      }
+      DetachCurrentThread();
+    });
+    RegisterRuntimeNativeMethods(env);
+    lookup_thread.join();
+  }
+
+  // Mark the intrinsics here rather than on the lookup thread, as setting the intrinsic bits
+  // is not atomic with other updates of the method access flags.
+  {
+    ScopedObjectAccess soa(self);
+    InitializeIntrinsics(ArrayRef<const IntrinsicMethod>(intrinsics));
+  }
 
   // Initialize classes used in JNI. The initialization requires runtime native
   // methods to be loaded first.
-  WellKnownClasses::Init(env);
+  WellKnownClasses::InitFieldsAndMethodsOnly(env);
 
   // Then set up libjavacore / libopenjdk / libicu_jni ,which are just
   // a regular JNI libraries with a regular JNI_OnLoad. Most JNI libraries can
@@ -2034,6 +2150,8 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
     os << "Running non JIT\n";
   }
   DumpDeoptimizations(os);
+  os << "Lock inflations for identity hash codes: " << Monitor::GetHashCodeInflationCount()
+     << "\n";
   TrackedAllocators::Dump(os);
   os << "\n";
 
@@ -2105,6 +2223,12 @@ uint64_t Runtime::GetStat(int kind) {
     return stats->class_init_count;
   case KIND_CLASS_INIT_TIME:
     return stats->class_init_time_ns;
+  case KIND_EXCEPTION_THROW_COUNT:
+    return stats->exception_throw_count;
+  case KIND_EXCEPTION_CATCH_COUNT:
+    return stats->exception_catch_count;
+  case KIND_EXCEPTION_DELIVERY_TIME:
+    return stats->exception_delivery_time_ns;
   case KIND_EXT_ALLOCATED_OBJECTS:
   case KIND_EXT_ALLOCATED_BYTES:
   case KIND_EXT_FREED_OBJECTS:
@@ -2129,12 +2253,16 @@ void Runtime::BlockSignals() {
 bool Runtime::AttachCurrentThread(const char* thread_name, bool as_daemon, jobject thread_group,
                                   bool create_peer) {
   ScopedTrace trace(__FUNCTION__);
+  const uint64_t start_time = NanoTime();
   Thread* self = Thread::Attach(thread_name, as_daemon, thread_group, create_peer);
   // Run ThreadGroup.add to notify the group that this thread is now started.
   if (self != nullptr && create_peer && !IsAotCompiler()) {
     ScopedObjectAccess soa(self);
     self->NotifyThreadGroup(soa, thread_group);
   }
+  if (self != nullptr) {
+    thread_list_->RecordThreadAttachTime(NanoTime() - start_time);
+  }
   return self != nullptr;
 }
 
@@ -2204,9 +2332,11 @@ void Runtime::VisitConstantRoots(RootVisitor* visitor) {
   }
 }
 
-void Runtime::VisitConcurrentRoots(RootVisitor* visitor, VisitRootFlags flags) {
+void Runtime::VisitConcurrentRoots(RootVisitor* visitor,
+                                   VisitRootFlags flags,
+                                   ThreadPool* thread_pool) {
   intern_table_->VisitRoots(visitor, flags);
-  class_linker_->VisitRoots(visitor, flags);
+  class_linker_->VisitRoots(visitor, flags, thread_pool);
   jni_id_manager_->VisitRoots(visitor);
   heap_->VisitAllocationRecords(visitor);
   if ((flags & kVisitRootFlagNewRoots) == 0) {
@@ -2420,6 +2550,10 @@ void Runtime::ClearCalleeSaveMethods() {
 
 void Runtime::RegisterAppInfo(const std::vector<std::string>& code_paths,
                               const std::string& profile_output_filename) {
+  if (prefetch_boot_image_pages_ && !profile_output_filename.empty()) {
+    StartBootImagePrefetch(profile_output_filename + ".bootpages");
+  }
+
   if (jit_.get() == nullptr) {
     // We are not JITing. Nothing to do.
     return;
@@ -2444,6 +2578,25 @@ void Runtime::RegisterAppInfo(const std::vector<std::string>& code_paths,
   jit_->StartProfileSaver(profile_output_filename, code_paths);
 }
 
+void Runtime::StartBootImagePrefetch(const std::string& record_path) {
+  boot_image_page_record_ = record_path;
+  if (!OS::FileExists(record_path.c_str())) {
+    // First startup of the app, the record is written once the startup completes.
+    return;
+  }
+  ScopedThreadPoolUsage stpu;
+  ThreadPool* const pool = stpu.GetThreadPool();
+  if (pool == nullptr) {
+    return;
+  }
+  pool->AddTask(Thread::Current(), new FunctionTask([record_path](Thread*) {
+    std::string error_msg;
+    if (!PrefetchBootImagePages(Runtime::Current()->GetHeap(), record_path, &error_msg)) {
+      LOG(WARNING) << "Failed to prefetch boot image pages: " << error_msg;
+    }
+  }));
+}
+
 // Transaction support.
 bool Runtime::IsActiveTransaction() const {
   return !preinitialization_transactions_.empty() && !GetTransaction()->IsRollingBack();
@@ -2788,6 +2941,9 @@ void Runtime::UpdateProcessState(ProcessState process_state) {
   ProcessState old_process_state = process_state_;
   process_state_ = process_state;
   GetHeap()->UpdateProcessState(old_process_state, process_state);
+  if (jit_ != nullptr) {
+    jit_->UpdateProcessState(process_state);
+  }
 }
 
 void Runtime::RegisterSensitiveThread() const {
@@ -3003,6 +3159,15 @@ class Runtime::NotifyStartupCompletedTask : public gc::HeapTask {
       }
     }
 
+    if (!runtime->boot_image_page_record_.empty()) {
+      std::string error_msg;
+      if (!WriteBootImagePageRecord(runtime->GetHeap(),
+                                    runtime->boot_image_page_record_,
+                                    &error_msg)) {
+        LOG(WARNING) << "Failed to record boot image pages: " << error_msg;
+      }
+    }
+
     {
       // Delete the thread pool used for app image loading since startup is assumed to be completed.
       ScopedTrace trace2("Delete thread pool");
@@ -3123,4 +3288,25 @@ void Runtime::MadviseFileForRange(size_t madvise_size_limit_bytes,
   }
 }
 
+void Runtime::MadviseHugePagesForCode(const uint8_t* code_begin,
+                                      const uint8_t* code_end,
+                                      const std::string& name) {
+#ifdef MADV_HUGEPAGE
+  // PMD size with 4KiB pages, the only huge page size transparent huge pages use.
+  static constexpr size_t kHugePageSize = 2 * MB;
+  uint8_t* begin = AlignUp(const_cast<uint8_t*>(code_begin), kHugePageSize);
+  uint8_t* end = AlignDown(const_cast<uint8_t*>(code_end), kHugePageSize);
+  if (begin >= end) {
+    VLOG(startup) << "No huge page aligned code to madvise in " << name;
+    return;
+  }
+  ScopedTrace trace("madvising huge pages for " + name);
+  if (madvise(begin, end - begin, MADV_HUGEPAGE) != 0) {
+    PLOG(WARNING) << "Failed to madvise huge pages for " << name;
+  }
+#else
+  UNUSED(code_begin, code_end, name);
+#endif
+}
+
 }  // namespace art
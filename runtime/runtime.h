@@ -46,6 +46,7 @@
 #include "quick/quick_method_frame_info.h"
 #include "reflective_value_visitor.h"
 #include "runtime_stats.h"
+#include "startup_timeline.h"
 
 namespace art {
 
@@ -82,6 +83,7 @@ namespace verifier {
 class MethodVerifier;
 enum class VerifyMode : int8_t;
 }  // namespace verifier
+class AnnotationCache;
 class ArenaPool;
 class ArtMethod;
 enum class CalleeSaveType: uint32_t;
@@ -296,6 +298,10 @@ class Runtime {
     return jni_id_manager_.get();
   }
 
+  AnnotationCache* GetAnnotationCache() const {
+    return annotation_cache_.get();
+  }
+
   size_t GetDefaultStackSize() const {
     return default_stack_size_;
   }
@@ -321,6 +327,13 @@ class Runtime {
     return max_spins_before_thin_lock_inflation_;
   }
 
+  // Whether objects that never move get identity hash codes derived from their address. Such
+  // hash codes can be recomputed at any time, so hashing a thin locked object or locking a
+  // hashed one does not need to inflate the lock to keep the hash code in a monitor.
+  bool UseAddressIdentityHash() const {
+    return use_address_identity_hash_;
+  }
+
   MonitorList* GetMonitorList() const {
     return monitor_list_;
   }
@@ -378,9 +391,11 @@ class Runtime {
   // instead.
   void VisitImageRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Visit all of the roots we can safely visit concurrently.
+  // Visit all of the roots we can safely visit concurrently. See ClassLinker::VisitClassRoots()
+  // for the use of `thread_pool`.
   void VisitConcurrentRoots(RootVisitor* visitor,
-                            VisitRootFlags flags = kVisitRootFlagAllRoots)
+                            VisitRootFlags flags = kVisitRootFlagAllRoots,
+                            ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::classlinker_classes_lock_, !Locks::trace_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -392,8 +407,10 @@ class Runtime {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Sweep system weaks, the system weak is deleted if the visitor return null. Otherwise, the
-  // system weak is updated to be the visitor's returned value.
-  void SweepSystemWeaks(IsMarkedVisitor* visitor)
+  // system weak is updated to be the visitor's returned value. If `thread_count` is greater than
+  // one, the independent system weak tables are swept concurrently by the heap thread pool, so
+  // the visitor must then be safe to call from several threads at once.
+  void SweepSystemWeaks(IsMarkedVisitor* visitor, size_t thread_count = 1)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Walk all reflective objects and visit their targets as well as any method/fields held by the
@@ -501,6 +518,14 @@ class Runtime {
     return jit_code_cache_.get();
   }
 
+  StartupTimeline* GetStartupTimeline() {
+    return &startup_timeline_;
+  }
+
+  const StartupTimeline* GetStartupTimeline() const {
+    return &startup_timeline_;
+  }
+
   // Returns true if JIT compilations are enabled. GetJit() will be not null in this case.
   bool UseJitCompilation() const;
 
@@ -580,6 +605,10 @@ class Runtime {
     return !implicit_so_checks_;
   }
 
+  bool ExplicitSuspendChecks() const {
+    return !implicit_suspend_checks_;
+  }
+
   void DisableVerifier();
   bool IsVerificationEnabled() const;
   bool IsVerificationSoftFail() const;
@@ -824,6 +853,10 @@ class Runtime {
     return dump_native_stack_on_sig_quit_;
   }
 
+  bool GetStagedSigQuitDump() const {
+    return staged_sig_quit_dump_;
+  }
+
   bool GetPrunedDalvikCache() const {
     return pruned_dalvik_cache_;
   }
@@ -889,6 +922,11 @@ class Runtime {
     deoptimization_counts_[static_cast<size_t>(kind)]++;
   }
 
+  uint32_t GetDeoptimizationCount(DeoptimizationKind kind) const {
+    DCHECK_LE(kind, DeoptimizationKind::kLast);
+    return deoptimization_counts_[static_cast<size_t>(kind)];
+  }
+
   uint32_t GetNumberOfDeoptimizations() const {
     uint32_t result = 0;
     for (size_t i = 0; i <= static_cast<size_t>(DeoptimizationKind::kLast); ++i) {
@@ -903,6 +941,16 @@ class Runtime {
     return madvise_random_access_;
   }
 
+  // Whether OatFile::Open tries dlopen before our own ELF loader. Native debuggable runtimes
+  // always use dlopen, so that oat files are registered with the dynamic linker for debuggers.
+  bool UseDlopenForOatFiles() const {
+    return use_dlopen_for_oat_files_ || IsNativeDebuggable();
+  }
+
+  void SetUseDlopenForOatFiles(bool value) {
+    use_dlopen_for_oat_files_ = value;
+  }
+
   size_t GetMadviseWillNeedSizeVdex() const {
     return madvise_willneed_vdex_filesize_;
   }
@@ -915,6 +963,18 @@ class Runtime {
     return madvise_willneed_art_filesize_;
   }
 
+  // Whether the executable code of boot image oat files and the JIT code cache is madvised
+  // MADV_HUGEPAGE to reduce i-TLB misses.
+  bool UseHugePagesForCode() const {
+    return use_huge_pages_for_code_;
+  }
+
+  // Whether the boot image pages an app touched during its last startup are prefetched with
+  // MADV_WILLNEED after fork. See boot_image_prefetch.h.
+  bool PrefetchBootImagePagesAfterFork() const {
+    return prefetch_boot_image_pages_;
+  }
+
   const std::string& GetJdwpOptions() {
     return jdwp_options_;
   }
@@ -939,6 +999,11 @@ class Runtime {
     return verifier_logging_threshold_ms_;
   }
 
+  // Maximum number of frames recorded in an exception stack trace, 0 if unlimited.
+  uint32_t GetMaxStackTraceDepth() const {
+    return max_stack_trace_depth_;
+  }
+
   // Atomically delete the thread pool if the reference count is 0.
   bool DeleteThreadPool() REQUIRES(!Locks::runtime_thread_pool_lock_);
 
@@ -1001,6 +1066,13 @@ class Runtime {
                                   const uint8_t* map_end,
                                   const std::string& file_name);
 
+  // Madvise MADV_HUGEPAGE the huge page aligned part of the code in [`code_begin`, `code_end`).
+  // The kernel backs it with huge pages on faults or when khugepaged collapses it, if
+  // transparent huge pages are enabled for the kind of mapping (anonymous, shmem or file).
+  static void MadviseHugePagesForCode(const uint8_t* code_begin,
+                                      const uint8_t* code_end,
+                                      const std::string& name);
+
  private:
   static void InitPlatformSignalHandlers();
 
@@ -1040,6 +1112,11 @@ class Runtime {
   ThreadPool* AcquireThreadPool() REQUIRES(!Locks::runtime_thread_pool_lock_);
   void ReleaseThreadPool() REQUIRES(!Locks::runtime_thread_pool_lock_);
 
+  // Prefetch the boot image pages recorded at `record_path` by an earlier startup of the app
+  // from the runtime thread pool, and record the pages again once this startup completes.
+  void StartBootImagePrefetch(const std::string& record_path)
+      REQUIRES(!Locks::runtime_thread_pool_lock_);
+
   // A pointer to the active runtime or null.
   static Runtime* instance_;
 
@@ -1111,6 +1188,7 @@ class Runtime {
 
   // The number of spins that are done before thread suspension is used to forcibly inflate.
   size_t max_spins_before_thin_lock_inflation_;
+  bool use_address_identity_hash_;
   MonitorList* monitor_list_;
   MonitorPool* monitor_pool_;
 
@@ -1124,12 +1202,18 @@ class Runtime {
 
   std::unique_ptr<jni::JniIdManager> jni_id_manager_;
 
+  // Weak cache of decoded class annotations, registered as a system weak holder.
+  std::unique_ptr<AnnotationCache> annotation_cache_;
+
   std::unique_ptr<JavaVMExt> java_vm_;
 
   std::unique_ptr<jit::Jit> jit_;
   std::unique_ptr<jit::JitCodeCache> jit_code_cache_;
   std::unique_ptr<jit::JitOptions> jit_options_;
 
+  // Timeline of the phases of Init() and Start().
+  StartupTimeline startup_timeline_;
+
   // Runtime thread pool. The pool is only for startup and gets deleted after.
   std::unique_ptr<ThreadPool> thread_pool_ GUARDED_BY(Locks::runtime_thread_pool_lock_);
   size_t thread_pool_ref_count_ GUARDED_BY(Locks::runtime_thread_pool_lock_);
@@ -1267,6 +1351,9 @@ class Runtime {
   // This is beneficial for low RAM devices since it reduces page cache thrashing.
   bool madvise_random_access_;
 
+  // Whether OatFile::Open tries dlopen before our own ELF loader.
+  bool use_dlopen_for_oat_files_;
+
   // Limiting size (in bytes) for applying MADV_WILLNEED on vdex files
   // A 0 for this will turn off madvising to MADV_WILLNEED
   size_t madvise_willneed_vdex_filesize_;
@@ -1279,6 +1366,14 @@ class Runtime {
   // A 0 for this will turn off madvising to MADV_WILLNEED
   size_t madvise_willneed_art_filesize_;
 
+  // Whether to madvise MADV_HUGEPAGE the boot image oat file code and the JIT code cache.
+  bool use_huge_pages_for_code_;
+
+  // Whether to prefetch the recorded boot image pages of the app after fork, and the path of
+  // the record, next to the primary profile of the app. Empty if there is no record to write.
+  bool prefetch_boot_image_pages_;
+  std::string boot_image_page_record_;
+
   // Whether the application should run in safe mode, that is, interpreter only.
   bool safe_mode_;
 
@@ -1312,6 +1407,10 @@ class Runtime {
   // Whether threads should dump their native stack on SIGQUIT.
   bool dump_native_stack_on_sig_quit_;
 
+  // Whether threads only record a snapshot of their stack on SIGQUIT, leaving the formatting
+  // to the signal catcher.
+  bool staged_sig_quit_dump_;
+
   // Whether the dalvik cache was pruned when initializing the runtime.
   bool pruned_dalvik_cache_;
 
@@ -1361,6 +1460,8 @@ class Runtime {
 
   uint32_t verifier_logging_threshold_ms_;
 
+  uint32_t max_stack_trace_depth_;
+
   bool load_app_image_startup_cache_ = false;
 
   // If startup has completed, must happen at most once.
@@ -50,14 +50,15 @@ ArtMethod* FindIntrinsicMethod(Thread* self,
   return method;
 }
 
-// Initialize an intrinsic. Returns true if the intrinsic is already
-// initialized, false otherwise.
-bool InitializeIntrinsic(Thread* self,
-                         Intrinsics intrinsic,
-                         InvokeType invoke_type,
-                         const char* class_name,
-                         const char* method_name,
-                         const char* signature)
+// Look up an intrinsic. Returns true if the intrinsic is already initialized, false
+// otherwise, in which case its method is added to `methods`.
+bool FindIntrinsic(Thread* self,
+                   Intrinsics intrinsic,
+                   InvokeType invoke_type,
+                   const char* class_name,
+                   const char* method_name,
+                   const char* signature,
+                   /*out*/ std::vector<IntrinsicMethod>* methods)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   ArtMethod* method = FindIntrinsicMethod(self, class_name, method_name, signature);
 
@@ -66,7 +67,7 @@ bool InitializeIntrinsic(Thread* self,
     CHECK_EQ(method->GetIntrinsic(), static_cast<uint32_t>(intrinsic));
     return true;
   } else {
-    method->SetIntrinsic(static_cast<uint32_t>(intrinsic));
+    methods->push_back(IntrinsicMethod{method, intrinsic});
     return false;
   }
 }
@@ -106,20 +107,34 @@ bool AreAllIntrinsicsInitialized() {
 
 }  // namespace
 
+std::vector<IntrinsicMethod> FindUninitializedIntrinsics(Thread* self) {
+  std::vector<IntrinsicMethod> methods;
+  // The lookup uses the short-circuit operator || to stop at the first
+  // already initialized intrinsic.
+#define FIND_INTRINSIC(Name, InvokeType, _, __, ___, ClassName, MethodName, Signature) \
+  FindIntrinsic(self,                                                                 \
+                Intrinsics::k##Name,                                                  \
+                InvokeType,                                                           \
+                ClassName,                                                            \
+                MethodName,                                                           \
+                Signature,                                                            \
+                &methods) ||
+  INTRINSICS_LIST(FIND_INTRINSIC) true;
+#undef FIND_INTRINSIC
+  return methods;
+}
+
+void InitializeIntrinsics(ArrayRef<const IntrinsicMethod> methods) {
+  for (const IntrinsicMethod& method : methods) {
+    method.method->SetIntrinsic(static_cast<uint32_t>(method.intrinsic));
+  }
+  DCHECK(AreAllIntrinsicsInitialized());
+}
+
 void InitializeIntrinsics() {
   ScopedObjectAccess soa(Thread::Current());
-  // Initialization here uses the short-circuit operator || to stop
-  // initializing if there's an already initialized intrinsic.
-#define INITIALIZE_INTRINSIC(Name, InvokeType, _, __, ___, ClassName, MethodName, Signature) \
-  InitializeIntrinsic(soa.Self(),                                                            \
-                      Intrinsics::k##Name,                                                   \
-                      InvokeType,                                                            \
-                      ClassName,                                                             \
-                      MethodName,                                                            \
-                      Signature) ||
-  INTRINSICS_LIST(INITIALIZE_INTRINSIC) true;
-#undef INITIALIZE_INTRINSIC
-  DCHECK(AreAllIntrinsicsInitialized());
+  std::vector<IntrinsicMethod> methods = FindUninitializedIntrinsics(soa.Self());
+  InitializeIntrinsics(ArrayRef<const IntrinsicMethod>(methods));
 }
 
 }  // namespace art
@@ -17,8 +17,31 @@
 #ifndef ART_RUNTIME_RUNTIME_INTRINSICS_H_
 #define ART_RUNTIME_RUNTIME_INTRINSICS_H_
 
+#include <vector>
+
+#include "base/array_ref.h"
+#include "base/locks.h"
+#include "intrinsics_enum.h"
+
 namespace art {
 
+class ArtMethod;
+class Thread;
+
+struct IntrinsicMethod {
+  ArtMethod* method;
+  Intrinsics intrinsic;
+};
+
+// Look up the methods of the intrinsics that are not initialized yet. This only loads
+// classes, so it can run on another thread while the caller initializes classes.
+std::vector<IntrinsicMethod> FindUninitializedIntrinsics(Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+// Mark the methods found by FindUninitializedIntrinsics() as intrinsics.
+void InitializeIntrinsics(ArrayRef<const IntrinsicMethod> methods)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
 void InitializeIntrinsics();
 
 }  // namespace art
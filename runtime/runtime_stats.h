@@ -30,6 +30,10 @@ enum StatKinds {
   KIND_GC_INVOCATIONS         = 1<<4,
   KIND_CLASS_INIT_COUNT       = 1<<5,
   KIND_CLASS_INIT_TIME        = 1<<6,
+  // Exception delivery statistics, with no named constant in dalvik.system.VMDebug yet.
+  KIND_EXCEPTION_THROW_COUNT  = 1<<7,
+  KIND_EXCEPTION_CATCH_COUNT  = 1<<8,
+  KIND_EXCEPTION_DELIVERY_TIME = 1<<9,
 
   // These values exist for backward compatibility.
   KIND_EXT_ALLOCATED_OBJECTS = 1<<12,
@@ -44,6 +48,9 @@ enum StatKinds {
   KIND_GLOBAL_GC_INVOCATIONS      = KIND_GC_INVOCATIONS,
   KIND_GLOBAL_CLASS_INIT_COUNT    = KIND_CLASS_INIT_COUNT,
   KIND_GLOBAL_CLASS_INIT_TIME     = KIND_CLASS_INIT_TIME,
+  KIND_GLOBAL_EXCEPTION_THROW_COUNT   = KIND_EXCEPTION_THROW_COUNT,
+  KIND_GLOBAL_EXCEPTION_CATCH_COUNT   = KIND_EXCEPTION_CATCH_COUNT,
+  KIND_GLOBAL_EXCEPTION_DELIVERY_TIME = KIND_EXCEPTION_DELIVERY_TIME,
 
   KIND_THREAD_ALLOCATED_OBJECTS   = KIND_ALLOCATED_OBJECTS << 16,
   KIND_THREAD_ALLOCATED_BYTES     = KIND_ALLOCATED_BYTES << 16,
@@ -86,6 +93,15 @@ struct PACKED(4) RuntimeStats {
     if ((flags & KIND_CLASS_INIT_TIME) != 0) {
       class_init_time_ns = 0;
     }
+    if ((flags & KIND_EXCEPTION_THROW_COUNT) != 0) {
+      exception_throw_count = 0;
+    }
+    if ((flags & KIND_EXCEPTION_CATCH_COUNT) != 0) {
+      exception_catch_count = 0;
+    }
+    if ((flags & KIND_EXCEPTION_DELIVERY_TIME) != 0) {
+      exception_delivery_time_ns = 0;
+    }
   }
 
   // Number of objects allocated.
@@ -106,6 +122,13 @@ struct PACKED(4) RuntimeStats {
   // Cumulative time spent in class initialization.
   uint64_t class_init_time_ns;
 
+  // Number of exceptions delivered to compiled code frames.
+  uint64_t exception_throw_count;
+  // Number of those exceptions caught by a managed handler rather than returned to an upcall.
+  uint64_t exception_catch_count;
+  // Cumulative time spent searching for the handlers of those exceptions.
+  uint64_t exception_delivery_time_ns;
+
   DISALLOW_COPY_AND_ASSIGN(RuntimeStats);
 };
 
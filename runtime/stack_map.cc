@@ -16,6 +16,7 @@
 
 #include "stack_map.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <stdint.h>
 
@@ -87,22 +88,247 @@ CodeInfo CodeInfo::DecodeInlineInfoOnly(const OatQuickMethodHeader* header) {
   return copy;
 }
 
+// The back-reference offset takes space so dedupe is not worth it for tiny tables.
+static constexpr size_t kMinDedupSize = 32;  // Assume 32-bit offset on average.
+
+// Rows need to be used by at least this many CodeInfos to be put in the dictionary.
+static constexpr uint32_t kMinDictionaryUses = 2;
+
+// Cap the dictionary size so that the re-encoded index columns stay reasonably narrow.
+static constexpr size_t kMaxDictionarySize = 1u << 12;
+
+static size_t VarintSizeInBits(uint32_t value) {
+  return value > kVarintMax
+      ? kVarintBits + BitsToBytesRoundUp(MinimumBitsToStore(value)) * kBitsPerByte
+      : kVarintBits;
+}
+
+// Encode the rows the same way as BitTableBuilderBase::Encode().
+template<size_t kNumColumns>
+static void EncodeBitTable(BitMemoryWriter<std::vector<uint8_t>>& out,
+                           const std::vector<std::array<uint32_t, kNumColumns>>& rows) {
+  constexpr uint32_t kValueBias = BitTableBase<kNumColumns>::kValueBias;
+  std::array<uint32_t, 1 + kNumColumns> header;
+  header[0] = rows.size();
+  uint32_t* column_bits = header.data() + 1;
+  std::fill_n(column_bits, kNumColumns, 0u);
+  for (const std::array<uint32_t, kNumColumns>& row : rows) {
+    for (size_t c = 0; c < kNumColumns; c++) {
+      column_bits[c] |= row[c] - kValueBias;
+    }
+  }
+  for (size_t c = 0; c < kNumColumns; c++) {
+    column_bits[c] = MinimumBitsToStore(column_bits[c]);
+  }
+  out.WriteInterleavedVarints(header);
+  for (const std::array<uint32_t, kNumColumns>& row : rows) {
+    for (size_t c = 0; c < kNumColumns; c++) {
+      out.WriteBits(row[c] - kValueBias, column_bits[c]);
+    }
+  }
+}
+
+template<typename Accessor>
+static std::array<uint32_t, Accessor::kNumColumns> GetBitTableRow(const BitTable<Accessor>& table,
+                                                                  uint32_t row) {
+  std::array<uint32_t, Accessor::kNumColumns> values;
+  for (size_t c = 0; c < Accessor::kNumColumns; c++) {
+    values[c] = table.Get(row, c);
+  }
+  return values;
+}
+
+// Check that the re-encoded user table references the same rows as the original one.
+template<typename Accessor, typename UserAccessor>
+static void CheckSameDereferencedRows(const BitTable<Accessor>& old_table,
+                                      const BitTable<UserAccessor>& old_user_table,
+                                      const BitTable<Accessor>& new_table,
+                                      const BitTable<UserAccessor>& new_user_table,
+                                      uint32_t column) {
+  constexpr uint32_t kNoValue = BitTableBase<UserAccessor::kNumColumns>::kNoValue;
+  DCHECK_EQ(old_user_table.NumRows(), new_user_table.NumRows());
+  for (size_t r = 0; r < old_user_table.NumRows(); r++) {
+    for (size_t c = 0; c < UserAccessor::kNumColumns; c++) {
+      uint32_t old_value = old_user_table.Get(r, c);
+      uint32_t new_value = new_user_table.Get(r, c);
+      if (c != column || old_value == kNoValue) {
+        DCHECK_EQ(old_value, new_value);
+      } else {
+        DCHECK(GetBitTableRow(old_table, old_value) == GetBitTableRow(new_table, new_value));
+      }
+    }
+  }
+}
+
+template<typename Accessor>
+void CodeInfo::Deduper::Dictionary<Accessor>::Add(const BitTable<Accessor>& table) {
+  // The rows are already unique within the table, so this counts the users of each row.
+  for (size_t r = 0; r < table.NumRows(); r++) {
+    rows_[GetBitTableRow(table, r)]++;
+  }
+}
+
+template<typename Accessor>
+void CodeInfo::Deduper::Dictionary<Accessor>::Write(BitMemoryWriter<std::vector<uint8_t>>& writer) {
+  // Give the most used rows the lowest indices so that the re-encoded index columns of
+  // typical CodeInfos stay narrow. The std::map order keeps the output deterministic.
+  std::vector<std::pair<Row, uint32_t>> rows;
+  for (const auto& entry : rows_) {
+    if (entry.second >= kMinDictionaryUses) {
+      rows.push_back(entry);
+    }
+  }
+  std::stable_sort(rows.begin(), rows.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second > rhs.second;
+  });
+  if (rows.size() > kMaxDictionarySize) {
+    rows.resize(kMaxDictionarySize);
+  }
+
+  rows_.clear();
+  if (rows.empty()) {
+    return;
+  }
+  std::vector<Row> table;
+  table.reserve(rows.size());
+  for (const auto& entry : rows) {
+    rows_.emplace(entry.first, table.size());
+    table.push_back(entry.first);
+  }
+  bit_offset_ = writer.NumberOfWrittenBits();
+  EncodeBitTable(writer, table);
+}
+
+template<typename Accessor>
+uint32_t CodeInfo::Deduper::Dictionary<Accessor>::Find(const Row& row) const {
+  auto it = rows_.find(row);
+  return (it != rows_.end()) ? it->second : BitTableBase<Accessor::kNumColumns>::kNoValue;
+}
+
+size_t CodeInfo::Deduper::GetEncodedSize(BitMemoryRegion region) const {
+  auto it = dedupe_map_.find(region);
+  if (it != dedupe_map_.end() && it->second != 0 && region.size_in_bits() > kMinDedupSize) {
+    return VarintSizeInBits(writer_.NumberOfWrittenBits() - it->second);
+  }
+  return region.size_in_bits();
+}
+
+template<typename Accessor, typename UserAccessor>
+bool CodeInfo::Deduper::UseDictionary(const Dictionary<Accessor>& dictionary,
+                                      const BitTable<Accessor>& table,
+                                      BitMemoryRegion table_region,
+                                      const BitTable<UserAccessor>& user_table,
+                                      uint32_t column,
+                                      /*inout*/ BitMemoryRegion* user_table_region) {
+  constexpr uint32_t kNoValue = BitTableBase<UserAccessor::kNumColumns>::kNoValue;
+  if (dictionary.IsEmpty()) {
+    return false;
+  }
+  std::vector<uint32_t> dictionary_index(table.NumRows());
+  for (size_t r = 0; r < table.NumRows(); r++) {
+    dictionary_index[r] = dictionary.Find(GetBitTableRow(table, r));
+    if (dictionary_index[r] == kNoValue) {
+      return false;
+    }
+  }
+
+  std::vector<std::array<uint32_t, UserAccessor::kNumColumns>> user_rows;
+  user_rows.reserve(user_table.NumRows());
+  for (size_t r = 0; r < user_table.NumRows(); r++) {
+    user_rows.push_back(GetBitTableRow(user_table, r));
+    uint32_t& index = user_rows.back()[column];
+    if (index != kNoValue) {
+      index = dictionary_index[index];
+    }
+  }
+  std::vector<uint8_t>& buffer = reencoded_tables_.emplace_back();
+  BitMemoryWriter<std::vector<uint8_t>> user_table_writer(&buffer);
+  EncodeBitTable(user_table_writer, user_rows);
+  BitMemoryRegion new_user_table_region = user_table_writer.GetWrittenRegion();
+
+  // The wider indices are only worth it if they cost less than the table they replace.
+  size_t old_size = GetEncodedSize(table_region) + GetEncodedSize(*user_table_region);
+  size_t new_size =
+      VarintSizeInBits(writer_.NumberOfWrittenBits() - dictionary.GetBitOffset()) +
+      GetEncodedSize(new_user_table_region);
+  if (new_size >= old_size) {
+    reencoded_tables_.pop_back();
+    return false;
+  }
+  *user_table_region = new_user_table_region;
+  return true;
+}
+
+void CodeInfo::Deduper::AddToDictionary(const uint8_t* code_info_data) {
+  DCHECK(!dictionaries_written_);
+  CodeInfo code_info(code_info_data);
+  dex_register_catalog_.Add(code_info.dex_register_catalog_);
+  method_infos_.Add(code_info.method_infos_);
+}
+
 size_t CodeInfo::Deduper::Dedupe(const uint8_t* code_info_data) {
+  if (!dictionaries_written_) {
+    // The CodeInfos reference the dictionaries backwards, so they are written first.
+    dex_register_catalog_.Write(writer_);
+    method_infos_.Write(writer_);
+    dictionaries_written_ = true;
+  }
+
   writer_.ByteAlign();
   size_t deduped_offset = writer_.NumberOfWrittenBits() / kBitsPerByte;
 
-  // The back-reference offset takes space so dedupe is not worth it for tiny tables.
-  constexpr size_t kMinDedupSize = 32;  // Assume 32-bit offset on average.
+  // Read the existing code info and record the memory region of each table.
+  std::array<BitMemoryRegion, kNumBitTables> regions;
+  CodeInfo code_info(code_info_data, nullptr, [&regions](size_t i, auto*, BitMemoryRegion region) {
+    regions[i] = region;
+  });
+
+  // Replace tables by references to the dictionaries, if that makes the CodeInfo smaller.
+  // The tables which index into them are re-encoded with the dictionary row indices.
+  std::array<uint32_t, kNumBitTables> dictionary_offset = {};
+  std::array<bool, kNumBitTables> uses_dictionary = {};
+  std::array<bool, kNumBitTables> reencoded = {};
+  auto try_use_dictionary = [&](const auto& dictionary,
+                                auto table_member,
+                                auto user_table_member,
+                                uint32_t column) {
+    size_t i = GetBitTableIndex(table_member);
+    size_t user = GetBitTableIndex(user_table_member);
+    if (code_info.HasBitTable(i) &&
+        code_info.HasBitTable(user) &&
+        UseDictionary(dictionary,
+                      code_info.*table_member,
+                      regions[i],
+                      code_info.*user_table_member,
+                      column,
+                      &regions[user])) {
+      dictionary_offset[i] = dictionary.GetBitOffset();
+      uses_dictionary[i] = true;
+      reencoded[i] = true;
+      reencoded[user] = true;
+      code_info.SetBitTableDeduped(i);  // Mark as deduped before we write header.
+    }
+  };
+  try_use_dictionary(dex_register_catalog_,
+                     &CodeInfo::dex_register_catalog_,
+                     &CodeInfo::dex_register_maps_,
+                     DexRegisterMapInfo::kCatalogueIndex);
+  try_use_dictionary(method_infos_,
+                     &CodeInfo::method_infos_,
+                     &CodeInfo::inline_infos_,
+                     InlineInfo::kMethodInfoIndex);
 
-  // Read the existing code info and find (and keep) dedup-map iterator for each table.
+  // Find (and keep) dedup-map iterator for each of the other tables.
   // The iterator stores BitMemoryRegion and bit_offset of previous identical BitTable.
   std::map<BitMemoryRegion, uint32_t, BitMemoryRegion::Less>::iterator it[kNumBitTables];
-  CodeInfo code_info(code_info_data, nullptr, [&](size_t i, auto*, BitMemoryRegion region) {
-    it[i] = dedupe_map_.emplace(region, /*bit_offset=*/0).first;
-    if (it[i]->second != 0 && region.size_in_bits() > kMinDedupSize) {  // Seen before and large?
-      code_info.SetBitTableDeduped(i);  // Mark as deduped before we write header.
+  for (size_t i = 0; i < kNumBitTables; i++) {
+    if (code_info.HasBitTable(i) && !uses_dictionary[i]) {
+      it[i] = dedupe_map_.emplace(regions[i], /*bit_offset=*/0).first;
+      if (it[i]->second != 0 && regions[i].size_in_bits() > kMinDedupSize) {  // Seen and large?
+        code_info.SetBitTableDeduped(i);  // Mark as deduped before we write header.
+      }
     }
-  });
+  }
 
   // Write the code info back, but replace deduped tables with relative offsets.
   std::array<uint32_t, kNumHeaders> header;
@@ -110,8 +336,12 @@ size_t CodeInfo::Deduper::Dedupe(const uint8_t* code_info_data) {
     header[i] = code_info.*member_pointer;
   });
   writer_.WriteInterleavedVarints(header);
-  ForEachBitTableField([this, &code_info, &it](size_t i, auto) {
+  ForEachBitTableField([&](size_t i, auto) {
     if (code_info.HasBitTable(i)) {
+      if (uses_dictionary[i]) {
+        writer_.WriteVarint(writer_.NumberOfWrittenBits() - dictionary_offset[i]);
+        return;
+      }
       uint32_t& bit_offset = it[i]->second;
       if (code_info.IsBitTableDeduped(i)) {
         DCHECK_NE(bit_offset, 0u);
@@ -131,10 +361,26 @@ size_t CodeInfo::Deduper::Dedupe(const uint8_t* code_info_data) {
         DCHECK_EQ(old_code_info.*member_pointer, new_code_info.*member_pointer);
       }
     });
-    ForEachBitTableField([&old_code_info, &new_code_info](size_t i, auto member_pointer) {
+    ForEachBitTableField([&](size_t i, auto member_pointer) {
       DCHECK_EQ(old_code_info.HasBitTable(i), new_code_info.HasBitTable(i));
-      DCHECK((old_code_info.*member_pointer).Equals(new_code_info.*member_pointer));
+      if (!reencoded[i]) {
+        DCHECK((old_code_info.*member_pointer).Equals(new_code_info.*member_pointer));
+      }
     });
+    if (uses_dictionary[GetBitTableIndex(&CodeInfo::dex_register_catalog_)]) {
+      CheckSameDereferencedRows(old_code_info.dex_register_catalog_,
+                                old_code_info.dex_register_maps_,
+                                new_code_info.dex_register_catalog_,
+                                new_code_info.dex_register_maps_,
+                                DexRegisterMapInfo::kCatalogueIndex);
+    }
+    if (uses_dictionary[GetBitTableIndex(&CodeInfo::method_infos_)]) {
+      CheckSameDereferencedRows(old_code_info.method_infos_,
+                                old_code_info.inline_infos_,
+                                new_code_info.method_infos_,
+                                new_code_info.inline_infos_,
+                                InlineInfo::kMethodInfoIndex);
+    }
   }
 
   return deduped_offset;
@@ -142,18 +388,31 @@ size_t CodeInfo::Deduper::Dedupe(const uint8_t* code_info_data) {
 
 StackMap CodeInfo::GetStackMapForNativePcOffset(uint32_t pc, InstructionSet isa) const {
   uint32_t packed_pc = StackMap::PackNativePc(pc, isa);
+  // The kind and the native pc are adjacent columns, so each probe reads both at once.
+  auto get_kind_and_packed_pc = [this](uint32_t row) {
+    return stack_maps_.GetColumns<StackMap::kKind, StackMap::kPackedNativePc>(row);
+  };
   // Binary search.  All catch stack maps are stored separately at the end.
-  auto it = std::partition_point(
-      stack_maps_.begin(),
-      stack_maps_.end(),
-      [packed_pc](const StackMap& sm) {
-        return sm.GetPackedNativePc() < packed_pc && sm.GetKind() != StackMap::Kind::Catch;
-      });
+  uint32_t low = 0u;
+  uint32_t high = stack_maps_.NumRows();
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2u;
+    std::array<uint32_t, 2> values = get_kind_and_packed_pc(mid);
+    if (values[1] < packed_pc && values[0] != static_cast<uint32_t>(StackMap::Kind::Catch)) {
+      low = mid + 1u;
+    } else {
+      high = mid;
+    }
+  }
   // Start at the lower bound and iterate over all stack maps with the given native pc.
-  for (; it != stack_maps_.end() && (*it).GetNativePcOffset(isa) == pc; ++it) {
-    StackMap::Kind kind = static_cast<StackMap::Kind>((*it).GetKind());
+  for (uint32_t row = low; row < stack_maps_.NumRows(); ++row) {
+    std::array<uint32_t, 2> values = get_kind_and_packed_pc(row);
+    if (values[1] != packed_pc) {
+      break;
+    }
+    StackMap::Kind kind = static_cast<StackMap::Kind>(values[0]);
     if (kind == StackMap::Kind::Default || kind == StackMap::Kind::OSR) {
-      return *it;
+      return GetStackMapAt(row);
     }
   }
   return stack_maps_.GetInvalidRow();
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_STACK_MAP_H_
 #define ART_RUNTIME_STACK_MAP_H_
 
+#include <deque>
 #include <limits>
 
 #include "arch/instruction_set.h"
@@ -190,8 +191,9 @@ class InlineInfo : public BitTableAccessor<6> {
   }
 
   ArtMethod* GetArtMethod() const {
-    uint64_t lo = GetArtMethodLo();
-    uint64_t hi = GetArtMethodHi();
+    std::array<uint32_t, 2> values = table_->GetColumns<kArtMethodHi, kArtMethodLo>(row_);
+    uint64_t hi = values[0];
+    uint64_t lo = values[1];
     return reinterpret_cast<ArtMethod*>((hi << 32) | lo);
   }
 
@@ -280,15 +282,64 @@ class CodeInfo {
       DCHECK_EQ(output->size(), 0u);
     }
 
+    // Record the dex register catalogue and method info rows of the given CodeInfo.
+    // Rows used by many CodeInfos are written once to a shared dictionary table ahead
+    // of all CodeInfos, which can then reference it instead of storing their own copy.
+    // Optional, but all calls must precede the first call to Dedupe().
+    void AddToDictionary(const uint8_t* code_info);
+
     // Copy CodeInfo into output while de-duplicating the internal bit tables.
     // It returns the byte offset of the copied CodeInfo within the output.
     size_t Dedupe(const uint8_t* code_info);
 
    private:
+    // Table rows shared by all CodeInfos in the output.
+    template<typename Accessor>
+    class Dictionary {
+     public:
+      using Row = std::array<uint32_t, Accessor::kNumColumns>;
+
+      void Add(const BitTable<Accessor>& table);
+
+      // Select the frequently used rows and write them as a BitTable.
+      void Write(BitMemoryWriter<std::vector<uint8_t>>& writer);
+
+      // Return the dictionary index of the given row, or kNoValue if it was not selected.
+      uint32_t Find(const Row& row) const;
+
+      bool IsEmpty() const { return rows_.empty(); }
+      uint32_t GetBitOffset() const { return bit_offset_; }
+
+     private:
+      std::map<Row, uint32_t> rows_;  // Use count before Write(), the row index after.
+      uint32_t bit_offset_ = 0;
+    };
+
+    // Try to replace `table` by a reference to `dictionary`. On success, re-encode
+    // `user_table`, which indexes `table` through `column`, with the dictionary indices.
+    template<typename Accessor, typename UserAccessor>
+    bool UseDictionary(const Dictionary<Accessor>& dictionary,
+                       const BitTable<Accessor>& table,
+                       BitMemoryRegion table_region,
+                       const BitTable<UserAccessor>& user_table,
+                       uint32_t column,
+                       /*inout*/ BitMemoryRegion* user_table_region);
+
+    // Estimate the size of the table in the output, taking whole-table dedupe into account.
+    size_t GetEncodedSize(BitMemoryRegion region) const;
+
     BitMemoryWriter<std::vector<uint8_t>> writer_;
 
     // Deduplicate at BitTable level. The value is bit offset within the output.
     std::map<BitMemoryRegion, uint32_t, BitMemoryRegion::Less> dedupe_map_;
+
+    // Deduplicate at row level for the tables which are only referenced by index.
+    Dictionary<DexRegisterInfo> dex_register_catalog_;
+    Dictionary<MethodInfo> method_infos_;
+    bool dictionaries_written_ = false;
+
+    // Backing storage for the tables re-encoded to index into the dictionaries.
+    std::deque<std::vector<uint8_t>> reencoded_tables_;
   };
 
   ALWAYS_INLINE CodeInfo() {}
@@ -375,9 +426,10 @@ class CodeInfo {
   BitTableRange<InlineInfo> GetInlineInfosOf(StackMap stack_map) const {
     uint32_t index = stack_map.GetInlineInfoIndex();
     if (index != StackMap::kNoValue) {
+      uint32_t last = inline_infos_.FindInColumn(InlineInfo::kIsLast, index, InlineInfo::kLast);
+      DCHECK_LT(last, inline_infos_.NumRows());
       auto begin = inline_infos_.begin() + index;
-      auto end = begin;
-      while ((*end++).GetIsLast() == InlineInfo::kMore) { }
+      auto end = inline_infos_.begin() + (last + 1);
       return BitTableRange<InlineInfo>(begin, end);
     } else {
       return BitTableRange<InlineInfo>();
@@ -470,6 +522,21 @@ class CodeInfo {
     DCHECK_EQ(index, kNumBitTables);
   }
 
+  // Returns the index of the given BitTable field in the ForEachBitTableField order.
+  template<typename Accessor>
+  static size_t GetBitTableIndex(BitTable<Accessor> CodeInfo::* member) {
+    size_t result = kNumBitTables;
+    ForEachBitTableField([member, &result](size_t i, auto member_pointer) {
+      if constexpr (std::is_same_v<decltype(member_pointer), decltype(member)>) {
+        if (member_pointer == member) {
+          result = i;
+        }
+      }
+    });
+    DCHECK_LT(result, kNumBitTables);
+    return result;
+  }
+
   bool HasBitTable(size_t i) { return ((bit_table_flags_ >> i) & 1) != 0; }
   bool IsBitTableDeduped(size_t i) { return ((bit_table_flags_ >> (kNumBitTables + i)) & 1) != 0; }
   void SetBitTableDeduped(size_t i) { bit_table_flags_ |= 1 << (kNumBitTables + i); }
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack_trace_frame_cache.h"
+
+#include <algorithm>
+
+#include "art_method-inl.h"
+#include "entrypoints/entrypoint_utils-inl.h"
+#include "oat_quick_method_header.h"
+#include "stack_map.h"
+
+namespace art {
+
+std::atomic<uint32_t> StackTraceFrameCache::invalidation_count_(0u);
+
+void StackTraceFrameCache::Validate() {
+  uint32_t invalidation_count = invalidation_count_.load(std::memory_order_seq_cst);
+  if (invalidation_count != seen_invalidation_count_) {
+    entries_.fill(Entry{});
+    seen_invalidation_count_ = invalidation_count;
+  }
+}
+
+void StackTraceFrameCache::DecodeFrames(ArtMethod* outer_method,
+                                        uintptr_t pc,
+                                        const OatQuickMethodHeader* header,
+                                        /*out*/ std::vector<Frame>* frames) {
+  DCHECK(header->IsOptimized());
+  frames->clear();
+  CodeInfo code_info = CodeInfo::DecodeInlineInfoOnly(header);
+  StackMap stack_map = code_info.GetStackMapForNativePcOffset(header->NativeQuickPcOffset(pc));
+  if (stack_map.IsValid() && stack_map.HasInlineInfo()) {
+    // Visit the inlined frames the same way as StackVisitor::WalkStack().
+    for (BitTableRange<InlineInfo> inline_frames = code_info.GetInlineInfosOf(stack_map);
+         !inline_frames.empty();
+         inline_frames.pop_back()) {
+      frames->emplace_back(GetResolvedMethod(outer_method, code_info, inline_frames),
+                           inline_frames.back().GetDexPc());
+    }
+  }
+  frames->emplace_back(outer_method, stack_map.GetDexPc());
+}
+
+ArrayRef<const StackTraceFrameCache::Frame> StackTraceFrameCache::Lookup(
+    ArtMethod* outer_method, uintptr_t pc, const OatQuickMethodHeader* header) {
+  DCHECK_NE(pc, 0u);
+  Entry& entry = entries_[IndexOf(outer_method, pc)];
+  if (entry.pc == pc && entry.outer_method == outer_method) {
+    return ArrayRef<const Frame>(entry.frames.data(), entry.num_frames);
+  }
+  DecodeFrames(outer_method, pc, header, &decoded_frames_);
+  if (decoded_frames_.size() > kMaxFramesPerEntry) {
+    return ArrayRef<const Frame>(decoded_frames_);
+  }
+  entry.outer_method = outer_method;
+  entry.pc = pc;
+  entry.num_frames = decoded_frames_.size();
+  std::copy(decoded_frames_.begin(), decoded_frames_.end(), entry.frames.begin());
+  return ArrayRef<const Frame>(entry.frames.data(), entry.num_frames);
+}
+
+}  // namespace art
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STACK_TRACE_FRAME_CACHE_H_
+#define ART_RUNTIME_STACK_TRACE_FRAME_CACHE_H_
+
+#include <array>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "base/array_ref.h"
+#include "base/bit_utils.h"
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtMethod;
+class OatQuickMethodHeader;
+
+// Thread-local cache of the managed frames at a native PC of optimized code, used when
+// capturing exception stack traces. An entry holds the (method, dex pc) pairs of the
+// inlined frames and of the outer frame, so that walking a frame seen before does not need
+// to decode the stack map and inline info from the CodeInfo and resolve inlined methods.
+//
+// Entries are keyed by the outer method and the native PC, since identical compiled code
+// can be shared by several methods. They refer to ArtMethods and compiled code, so the
+// caches of all threads are invalidated whenever compiled code or class loaders are freed.
+// The owning thread checks for invalidation with Validate() before each stack walk; code
+// on the stack being walked cannot be freed while the walk is in progress.
+class StackTraceFrameCache {
+ public:
+  using Frame = std::pair<ArtMethod*, uint32_t>;
+
+  // Number of entries, direct-mapped.
+  static constexpr size_t kSize = 128;
+
+  // Maximum number of frames (outer and inlined) in an entry. Deeper inlining is decoded
+  // on every lookup.
+  static constexpr size_t kMaxFramesPerEntry = 4;
+
+  StackTraceFrameCache() {}
+
+  // Invalidate the caches of all threads. Must be called before freed compiled code or
+  // ArtMethods can be reused.
+  static void InvalidateAll() {
+    invalidation_count_.fetch_add(1u, std::memory_order_seq_cst);
+  }
+
+  // Clear the cache if it was invalidated since the last call.
+  void Validate();
+
+  // Returns the frames for the optimized `outer_method` at the return `pc` in stack walk
+  // order, i.e. the innermost inlined frame first and the outer frame last. The result is
+  // valid until the next call.
+  ArrayRef<const Frame> Lookup(ArtMethod* outer_method,
+                               uintptr_t pc,
+                               const OatQuickMethodHeader* header)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  struct Entry {
+    ArtMethod* outer_method = nullptr;
+    uintptr_t pc = 0u;
+    size_t num_frames = 0u;
+    std::array<Frame, kMaxFramesPerEntry> frames;
+  };
+
+  static size_t IndexOf(ArtMethod* outer_method, uintptr_t pc) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    return (pc ^ (reinterpret_cast<uintptr_t>(outer_method) >> 4)) & (kSize - 1u);
+  }
+
+  static void DecodeFrames(ArtMethod* outer_method,
+                           uintptr_t pc,
+                           const OatQuickMethodHeader* header,
+                           /*out*/ std::vector<Frame>* frames)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  static std::atomic<uint32_t> invalidation_count_;
+
+  std::array<Entry, kSize> entries_;
+  uint32_t seen_invalidation_count_ = 0u;
+  // Frames decoded on a miss. Keeps its capacity to avoid allocations.
+  std::vector<Frame> decoded_frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(StackTraceFrameCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STACK_TRACE_FRAME_CACHE_H_
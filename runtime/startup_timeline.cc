@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timeline.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "base/time_utils.h"
+
+namespace art {
+
+StartupTimeline::StartupTimeline() : creation_ns_(NanoTime()), num_phases_(0u) {}
+
+size_t StartupTimeline::BeginPhase(const char* name) {
+  size_t index = num_phases_.fetch_add(1u, std::memory_order_relaxed);
+  if (index >= kMaxPhases) {
+    return kMaxPhases;
+  }
+  phases_[index].name = name;
+  phases_[index].start_ns = NanoTime();
+  return index;
+}
+
+void StartupTimeline::EndPhase(size_t index) {
+  if (index < kMaxPhases) {
+    // Publishes the name and start time to Dump().
+    phases_[index].end_ns.store(NanoTime(), std::memory_order_release);
+  }
+}
+
+size_t StartupTimeline::GetNumPhases() const {
+  return num_phases_.load(std::memory_order_relaxed);
+}
+
+void StartupTimeline::Dump(std::ostream& os) const {
+  size_t num_phases = GetNumPhases();
+  size_t recorded = std::min(num_phases, kMaxPhases);
+  os << "startup_timeline phases=" << recorded << " dropped=" << (num_phases - recorded);
+  for (size_t i = 0; i != recorded; ++i) {
+    const Phase& phase = phases_[i];
+    uint64_t end_ns = phase.end_ns.load(std::memory_order_acquire);
+    if (end_ns == 0u) {
+      continue;
+    }
+    os << " " << phase.name << "=" << NsToUs(phase.start_ns - creation_ns_)
+       << "+" << NsToUs(end_ns - phase.start_ns) << "us";
+  }
+}
+
+}  // namespace art
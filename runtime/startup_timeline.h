@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STARTUP_TIMELINE_H_
+#define ART_RUNTIME_STARTUP_TIMELINE_H_
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <iosfwd>
+
+#include "base/macros.h"
+
+namespace art {
+
+// Always-on timeline of the phases of runtime initialization. Phases are recorded with
+// their start and end times in a fixed buffer, so that recording does not allocate and the
+// timeline can be dumped at any time, e.g. as a single log record at the end of
+// Runtime::Start() or through VMDebug.getRuntimeStat(). Phases beyond the capacity of the
+// buffer are counted but not recorded.
+class StartupTimeline {
+ public:
+  // Maximum number of recorded phases.
+  static constexpr size_t kMaxPhases = 32;
+
+  StartupTimeline();
+
+  // Record the start of a phase. `name` must be a string literal. Returns the index to pass
+  // to EndPhase(), or kMaxPhases if the buffer is full.
+  size_t BeginPhase(const char* name);
+
+  // Record the end of the phase started with BeginPhase().
+  void EndPhase(size_t index);
+
+  size_t GetNumPhases() const;
+
+  // Write the timeline as a single line. Times are in microseconds relative to the creation
+  // of the timeline, phases that have not ended yet are omitted.
+  void Dump(std::ostream& os) const;
+
+ private:
+  struct Phase {
+    const char* name = nullptr;
+    uint64_t start_ns = 0u;
+    std::atomic<uint64_t> end_ns{0u};
+  };
+
+  const uint64_t creation_ns_;
+  std::atomic<size_t> num_phases_;
+  std::array<Phase, kMaxPhases> phases_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTimeline);
+};
+
+// Records a phase of the timeline for the duration of the scope.
+class ScopedStartupPhase {
+ public:
+  ScopedStartupPhase(StartupTimeline* timeline, const char* name)
+      : timeline_(timeline), index_(timeline->BeginPhase(name)) {}
+
+  ~ScopedStartupPhase() {
+    timeline_->EndPhase(index_);
+  }
+
+ private:
+  StartupTimeline* const timeline_;
+  const size_t index_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedStartupPhase);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STARTUP_TIMELINE_H_
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timeline.h"
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(StartupTimelineTest, RecordPhases) {
+  StartupTimeline timeline;
+  {
+    ScopedStartupPhase outer(&timeline, "Outer");
+    ScopedStartupPhase inner(&timeline, "Inner");
+  }
+  size_t open = timeline.BeginPhase("Open");
+  EXPECT_EQ(timeline.GetNumPhases(), 3u);
+  std::ostringstream oss;
+  timeline.Dump(oss);
+  const std::string output = oss.str();
+  EXPECT_EQ(output.rfind("startup_timeline phases=3 dropped=0 Outer=", 0), 0u) << output;
+  EXPECT_NE(output.find(" Inner="), std::string::npos) << output;
+  EXPECT_EQ(output.find(" Open="), std::string::npos) << output;
+  timeline.EndPhase(open);
+  std::ostringstream oss2;
+  timeline.Dump(oss2);
+  EXPECT_NE(oss2.str().find(" Open="), std::string::npos) << oss2.str();
+}
+
+TEST(StartupTimelineTest, Overflow) {
+  StartupTimeline timeline;
+  for (size_t i = 0; i != StartupTimeline::kMaxPhases + 2u; ++i) {
+    ScopedStartupPhase phase(&timeline, "Phase");
+  }
+  std::ostringstream oss;
+  timeline.Dump(oss);
+  EXPECT_EQ(oss.str().rfind("startup_timeline phases=32 dropped=2 ", 0), 0u) << oss.str();
+}
+
+}  // namespace art
@@ -211,6 +211,14 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
   const uint32_t* current_arg = args_;
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
+    if (static_cast<Argument>(f & kArgMask) == Argument::kNextFormat) {
+      // Continue with the chained format word stored in the next argument slot.
+      DCHECK_EQ(f, static_cast<uint32_t>(Argument::kNextFormat));
+      f = *current_arg;
+      ++current_arg;
+      DCHECK_NE(f & kArgMask, static_cast<uint32_t>(Argument::kEnd));
+      DCHECK_NE(f & kArgMask, static_cast<uint32_t>(Argument::kNextFormat));
+    }
     switch (static_cast<Argument>(f & kArgMask)) {
       case Argument::kString: {
         Handle<mirror::String> str =
@@ -279,6 +287,14 @@ inline void StringBuilderAppend::Builder::StoreData(ObjPtr<mirror::String> new_s
   const uint32_t* current_arg = args_;
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
+    if (static_cast<Argument>(f & kArgMask) == Argument::kNextFormat) {
+      // Continue with the chained format word stored in the next argument slot.
+      DCHECK_EQ(f, static_cast<uint32_t>(Argument::kNextFormat));
+      f = *current_arg;
+      ++current_arg;
+      DCHECK_NE(f & kArgMask, static_cast<uint32_t>(Argument::kEnd));
+      DCHECK_NE(f & kArgMask, static_cast<uint32_t>(Argument::kNextFormat));
+    }
     switch (static_cast<Argument>(f & kArgMask)) {
       case Argument::kString: {
         ObjPtr<mirror::String> str =
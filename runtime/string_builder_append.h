@@ -46,15 +46,21 @@ class StringBuilderAppend {
     kLong,
     kFloat,
     kDouble,
-    kLast = kDouble
+    // The next argument slot holds the format word for the remaining arguments.
+    kNextFormat,
+    kLast = kNextFormat
   };
 
   static constexpr size_t kBitsPerArg =
       MinimumBitsToStore(static_cast<size_t>(Argument::kLast));
-  static constexpr size_t kMaxArgs = BitSizeOf<uint32_t>() / kBitsPerArg;
-  static_assert(kMaxArgs * kBitsPerArg == BitSizeOf<uint32_t>(), "Expecting no extra bits.");
+  static constexpr size_t kMaxArgsPerFormat = BitSizeOf<uint32_t>() / kBitsPerArg;
+  static_assert(kMaxArgsPerFormat * kBitsPerArg == BitSizeOf<uint32_t>(),
+                "Expecting no extra bits.");
   static constexpr uint32_t kArgMask = MaxInt<uint32_t>(kBitsPerArg);
 
+  // Maximum number of appended values, not counting the chained format words.
+  static constexpr size_t kMaxArgs = 32u;
+
   static ObjPtr<mirror::String> AppendF(uint32_t format, const uint32_t* args, Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -32,6 +32,7 @@
 #include <bitset>
 #include <cerrno>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <sstream>
 
@@ -55,6 +56,7 @@
 #include "base/timing_logger.h"
 #include "base/to_str.h"
 #include "base/utils.h"
+#include "catch_handler_cache.h"
 #include "class_linker-inl.h"
 #include "class_root-inl.h"
 #include "debugger.h"
@@ -106,6 +108,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "stack.h"
 #include "stack_map.h"
+#include "stack_trace_frame_cache.h"
 #include "thread-inl.h"
 #include "thread_list.h"
 #include "verifier/method_verifier.h"
@@ -595,6 +598,7 @@ void Thread::DeleteJPeer(JNIEnv* env) {
 }
 
 void* Thread::CreateCallback(void* arg) {
+  const uint64_t start_time = NanoTime();
   Thread* self = reinterpret_cast<Thread*>(arg);
   Runtime* runtime = Runtime::Current();
   if (runtime == nullptr) {
@@ -648,6 +652,7 @@ void* Thread::CreateCallback(void* arg) {
     if (should_unpark) {
       self->Unpark();
     }
+    runtime->GetThreadList()->RecordThreadAttachTime(NanoTime() - start_time);
     // Invoke the 'run' method of our java.lang.Thread.
     ObjPtr<mirror::Object> receiver = self->tlsPtr_.opeer;
     jmethodID mid = WellKnownClasses::java_lang_Thread_run;
@@ -1506,6 +1511,7 @@ bool Thread::PassActiveSuspendBarriers(Thread* self) {
     }
     AtomicClearFlag(kActiveSuspendBarrier);
   }
+  suspend_barrier_pass_time_ns_.store(NanoTime(), std::memory_order_relaxed);
 
   uint32_t barrier_count = 0;
   for (uint32_t i = 0; i < kMaxSuspendBarriers; i++) {
@@ -1948,6 +1954,9 @@ void Thread::DumpState(std::ostream& os, const Thread* thread, pid_t tid) {
     os << "  | stack=" << reinterpret_cast<void*>(thread->tlsPtr_.stack_begin) << "-"
         << reinterpret_cast<void*>(thread->tlsPtr_.stack_end) << " stackSize="
         << PrettySize(thread->tlsPtr_.stack_size) << "\n";
+    if (thread->allocation_stall_time_ns_ != 0u) {
+      os << "  | allocation stall=" << PrettyDuration(thread->allocation_stall_time_ns_) << "\n";
+    }
     // Dump the held mutexes.
     os << "  | held mutexes=";
     for (size_t i = 0; i < kLockLevelCount; ++i) {
@@ -2112,9 +2121,8 @@ struct StackDumpVisitor : public MonitorObjectsStackVisitor {
   size_t repetition_count;
 };
 
-static bool ShouldShowNativeStack(const Thread* thread)
-    REQUIRES_SHARED(Locks::mutator_lock_) {
-  ThreadState state = thread->GetState();
+bool Thread::ShouldShowNativeStack() const {
+  ThreadState state = GetState();
 
   // In native code somewhere in the VM (one of the kWaitingFor* states)? That's interesting.
   if (state > kWaiting && state < kStarting) {
@@ -2127,7 +2135,7 @@ static bool ShouldShowNativeStack(const Thread* thread)
   }
 
   // Threads with no managed stack frames should be shown.
-  if (!thread->HasManagedStack()) {
+  if (!HasManagedStack()) {
     return true;
   }
 
@@ -2135,7 +2143,7 @@ static bool ShouldShowNativeStack(const Thread* thread)
   // We don't just check kNative because native methods will be in state kSuspended if they're
   // calling back into the VM, or kBlocked if they're blocked on a monitor, or one of the
   // thread-startup states if it's early enough in their life cycle (http://b/7432159).
-  ArtMethod* current_method = thread->GetCurrentMethod(nullptr);
+  ArtMethod* current_method = GetCurrentMethod(nullptr);
   return current_method != nullptr && current_method->IsNative();
 }
 
@@ -2181,7 +2189,7 @@ void Thread::DumpStack(std::ostream& os,
   }
   if (safe_to_dump || force_dump_stack) {
     // If we're currently in native code, dump that stack before dumping the managed stack.
-    if (dump_native_stack && (dump_for_abort || force_dump_stack || ShouldShowNativeStack(this))) {
+    if (dump_native_stack && (dump_for_abort || force_dump_stack || ShouldShowNativeStack())) {
       ArtMethod* method =
           GetCurrentMethod(nullptr,
                            /*check_suspended=*/ !force_dump_stack,
@@ -2394,6 +2402,12 @@ void Thread::Destroy() {
   Thread* self = this;
   DCHECK_EQ(self, Thread::Current());
 
+  if (kIsDebugBuild && VLOG_IS_ON(interpreter)) {
+    std::ostringstream oss;
+    interpreter_cache_.DumpStats(oss);
+    VLOG(interpreter) << *self << ": " << oss.str();
+  }
+
   if (tlsPtr_.jni_env != nullptr) {
     {
       ScopedObjectAccess soa(self);
@@ -2664,22 +2678,59 @@ void Thread::SetClassLoaderOverride(jobject class_loader_override) {
 
 using ArtMethodDexPcPair = std::pair<ArtMethod*, uint32_t>;
 
-// Counts the stack trace depth and also fetches the first max_saved_frames frames.
+// Counts the stack trace depth, up to max_depth if non-zero, and also fetches the first
+// max_saved_frames frames. The frames of optimized code are walked as a whole and their
+// inlined frames are looked up in the StackTraceFrameCache of the current thread, which
+// avoids decoding the same stack maps and inline infos for every exception thrown.
 class FetchStackTraceVisitor : public StackVisitor {
  public:
   explicit FetchStackTraceVisitor(Thread* thread,
                                   ArtMethodDexPcPair* saved_frames = nullptr,
-                                  size_t max_saved_frames = 0)
+                                  size_t max_saved_frames = 0,
+                                  uint32_t max_depth = 0u)
       REQUIRES_SHARED(Locks::mutator_lock_)
-      : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
+      : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kSkipInlinedFrames),
         saved_frames_(saved_frames),
-        max_saved_frames_(max_saved_frames) {}
+        max_saved_frames_(max_saved_frames),
+        max_depth_(max_depth != 0u ? max_depth : std::numeric_limits<uint32_t>::max()),
+        frame_cache_(Thread::Current()->GetStackTraceFrameCache()) {
+    frame_cache_->Validate();
+  }
 
   bool VisitFrame() override REQUIRES_SHARED(Locks::mutator_lock_) {
+    ArtMethod* m = GetMethod();
+    const OatQuickMethodHeader* header = GetCurrentOatQuickMethodHeader();
+    if (GetCurrentQuickFrame() != nullptr &&
+        header != nullptr &&
+        header->IsOptimized() &&
+        !m->IsNative() &&
+        !m->IsProxyMethod()) {
+      for (const ArtMethodDexPcPair& frame :
+           frame_cache_->Lookup(m, GetCurrentQuickFramePc(), header)) {
+        if (!AddFrame(frame.first, frame.second)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    bool no_dex_pc = m->IsRuntimeMethod() || m->IsProxyMethod();
+    return AddFrame(m, no_dex_pc ? dex::kDexNoIndex : GetDexPc());
+  }
+
+  uint32_t GetDepth() const {
+    return depth_;
+  }
+
+  uint32_t GetSkipDepth() const {
+    return skip_depth_;
+  }
+
+ private:
+  // Returns false when the maximum depth has been reached.
+  bool AddFrame(ArtMethod* m, uint32_t dex_pc) REQUIRES_SHARED(Locks::mutator_lock_) {
     // We want to skip frames up to and including the exception's constructor.
     // Note we also skip the frame if it doesn't have a method (namely the callee
     // save frame)
-    ArtMethod* m = GetMethod();
     if (skipping_ && !m->IsRuntimeMethod() &&
         !GetClassRoot<mirror::Throwable>()->IsAssignableFrom(m->GetDeclaringClass())) {
       skipping_ = false;
@@ -2688,9 +2739,12 @@ class FetchStackTraceVisitor : public StackVisitor {
       if (!m->IsRuntimeMethod()) {  // Ignore runtime frames (in particular callee save).
         if (depth_ < max_saved_frames_) {
           saved_frames_[depth_].first = m;
-          saved_frames_[depth_].second = m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc();
+          saved_frames_[depth_].second = dex_pc;
         }
         ++depth_;
+        if (depth_ == max_depth_) {
+          return false;
+        }
       }
     } else {
       ++skip_depth_;
@@ -2698,20 +2752,13 @@ class FetchStackTraceVisitor : public StackVisitor {
     return true;
   }
 
-  uint32_t GetDepth() const {
-    return depth_;
-  }
-
-  uint32_t GetSkipDepth() const {
-    return skip_depth_;
-  }
-
- private:
   uint32_t depth_ = 0;
   uint32_t skip_depth_ = 0;
   bool skipping_ = true;
   ArtMethodDexPcPair* saved_frames_;
   const size_t max_saved_frames_;
+  const uint32_t max_depth_;
+  StackTraceFrameCache* const frame_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(FetchStackTraceVisitor);
 };
@@ -2754,6 +2801,7 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
     }
     trace->Set(0, methods_and_pcs);
     trace_ = trace.Get();
+    depth_ = depth;
     // If We are called from native, use non-transactional mode.
     CHECK(last_no_suspend_cause == nullptr) << last_no_suspend_cause;
     return true;
@@ -2776,7 +2824,7 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
       return true;  // Ignore runtime frames (in particular callee save).
     }
     AddFrame(m, m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc());
-    return true;
+    return count_ != depth_;  // Stop at the depth of the trace, which may be limited.
   }
 
   void AddFrame(ArtMethod* method, uint32_t dex_pc) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -2806,6 +2854,8 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
   int32_t skip_depth_;
   // Current position down stack trace.
   uint32_t count_ = 0;
+  // Number of frames in the stack trace.
+  uint32_t depth_ = 0;
   // An object array where the first element is a pointer array that contains the ArtMethod
   // pointers on the stack and dex PCs. The rest of the elements are the declaring
   // class of the ArtMethod pointers. trace_[i+1] contains the declaring class of the ArtMethod of
@@ -2824,7 +2874,8 @@ jobject Thread::CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable
   std::unique_ptr<ArtMethodDexPcPair[]> saved_frames(new ArtMethodDexPcPair[kMaxSavedFrames]);
   FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this),
                                        &saved_frames[0],
-                                       kMaxSavedFrames);
+                                       kMaxSavedFrames,
+                                       Runtime::Current()->GetMaxStackTraceDepth());
   count_visitor.WalkStack();
   const uint32_t depth = count_visitor.GetDepth();
   const uint32_t skip_depth = count_visitor.GetSkipDepth();
@@ -2865,7 +2916,10 @@ template jobject Thread::CreateInternalStackTrace<true>(
 
 bool Thread::IsExceptionThrownByCurrentMethod(ObjPtr<mirror::Throwable> exception) const {
   // Only count the depth since we do not pass a stack frame array as an argument.
-  FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this));
+  FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this),
+                                       /* saved_frames= */ nullptr,
+                                       /* max_saved_frames= */ 0u,
+                                       Runtime::Current()->GetMaxStackTraceDepth());
   count_visitor.WalkStack();
   return count_visitor.GetDepth() == static_cast<uint32_t>(exception->GetStackDepth());
 }
@@ -4105,6 +4159,9 @@ void Thread::SweepInterpreterCache(IsMarkedVisitor* visitor) {
       }
     }
   }
+  if (catch_handler_cache_ != nullptr) {
+    catch_handler_cache_->Sweep(visitor);
+  }
 }
 
 void Thread::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
@@ -4311,6 +4368,21 @@ void Thread::ClearAllInterpreterCaches() {
   Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
 }
 
+StackTraceFrameCache* Thread::GetStackTraceFrameCache() {
+  DCHECK_EQ(this, Thread::Current());
+  if (stack_trace_frame_cache_ == nullptr) {
+    stack_trace_frame_cache_.reset(new StackTraceFrameCache());
+  }
+  return stack_trace_frame_cache_.get();
+}
+
+CatchHandlerCache* Thread::GetCatchHandlerCache() {
+  DCHECK_EQ(this, Thread::Current());
+  if (catch_handler_cache_ == nullptr) {
+    catch_handler_cache_.reset(new CatchHandlerCache());
+  }
+  return catch_handler_cache_.get();
+}
 
 void Thread::ReleaseLongJumpContextInternal() {
   // Each QuickExceptionHandler gets a long jump context and uses
@@ -82,6 +82,7 @@ class VerifierDeps;
 
 class ArtMethod;
 class BaseMutex;
+class CatchHandlerCache;
 class ClassLinker;
 class Closure;
 class Context;
@@ -95,7 +96,9 @@ class Monitor;
 class RootVisitor;
 class ScopedObjectAccessAlreadyRunnable;
 class ShadowFrame;
+class StackTraceFrameCache;
 class StackedShadowFrameRecord;
+class TraceThreadBuffer;
 enum class SuspendReason : char;
 class Thread;
 class ThreadList;
@@ -139,6 +142,9 @@ enum class DeoptimizationMethodType {
 
 // This should match RosAlloc::kNumThreadLocalSizeBrackets.
 static constexpr size_t kNumRosAllocThreadLocalSizeBracketsInThread = 16;
+// These should match RosAlloc::kNumSlotCacheBrackets and RosAlloc::kSlotCacheSize.
+static constexpr size_t kNumRosAllocSlotCacheBracketsInThread = 2;
+static constexpr size_t kRosAllocSlotCacheSize = 8;
 
 // Thread's stack layout for implicit stack overflow checks:
 //
@@ -229,6 +235,9 @@ class Thread {
                      bool dump_locks = true) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns whether the native stack is interesting enough to be included in a SIGQUIT dump.
+  bool ShouldShowNativeStack() const REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Dumps the SIGQUIT per-thread header. 'thread' can be null for a non-attached thread, in which
   // case we use 'tid' to identify the thread, and we'll include as much information as we can.
   static void DumpState(std::ostream& os, const Thread* thread, pid_t tid)
@@ -1108,6 +1117,14 @@ class Thread {
     return tls64_.trace_clock_base;
   }
 
+  TraceThreadBuffer* GetMethodTraceBuffer() const {
+    return tlsPtr_.method_trace_buffer;
+  }
+
+  void SetMethodTraceBuffer(TraceThreadBuffer* buffer) {
+    tlsPtr_.method_trace_buffer = buffer;
+  }
+
   void SetTraceClockBase(uint64_t clock_base) {
     tls64_.trace_clock_base = clock_base;
   }
@@ -1175,6 +1192,24 @@ class Thread {
   uint8_t* GetTlabEnd() {
     return tlsPtr_.thread_local_end;
   }
+  // Adaptive TLAB sizing state, see Heap::ComputeAdaptiveTlabSize.
+  size_t GetAdaptiveTlabSize() const {
+    return adaptive_tlab_size_;
+  }
+  uint64_t GetLastTlabRefillTime() const {
+    return last_tlab_refill_time_ns_;
+  }
+  void SetAdaptiveTlabSize(size_t tlab_size, uint64_t refill_time_ns) {
+    adaptive_tlab_size_ = tlab_size;
+    last_tlab_refill_time_ns_ = refill_time_ns;
+  }
+  // Allocation sampling state, see Heap::ShouldSampleAllocation.
+  size_t GetBytesUntilAllocationSample() const {
+    return bytes_until_allocation_sample_;
+  }
+  void SetBytesUntilAllocationSample(size_t bytes) {
+    bytes_until_allocation_sample_ = bytes;
+  }
   // Remove the suspend trigger for this thread by making the suspend_trigger_ TLS value
   // equal to a valid pointer.
   // TODO: does this need to atomic?  I don't think so.
@@ -1217,6 +1252,34 @@ class Thread {
     tlsPtr_.rosalloc_runs[index] = run;
   }
 
+  // Free slots of a RosAlloc size bracket taken in bulk by this thread, see
+  // RosAlloc::AllocFromSlotCache.
+  struct RosAllocSlotCache {
+    size_t num_slots = 0;
+    void* slots[kRosAllocSlotCacheSize];
+  };
+
+  RosAllocSlotCache* GetRosAllocSlotCache(size_t index) {
+    DCHECK_LT(index, kNumRosAllocSlotCacheBracketsInThread);
+    return &rosalloc_slot_caches_[index];
+  }
+
+  // Time at which this thread last passed an active suspend barrier. Compared to the time of a
+  // suspend request, it gives the time the thread took to reach a suspend point.
+  uint64_t GetSuspendBarrierPassTimeNs() const {
+    return suspend_barrier_pass_time_ns_.load(std::memory_order_relaxed);
+  }
+
+  // Time this thread could not allocate because it waited for, or ran, a GC for alloc, or was
+  // delayed by allocation pacing.
+  uint64_t GetAllocationStallTimeNs() const {
+    return allocation_stall_time_ns_;
+  }
+
+  void AddAllocationStallTime(uint64_t stall_ns) {
+    allocation_stall_time_ns_ += stall_ns;
+  }
+
   bool ProtectStack(bool fatal_on_error = true);
   bool UnprotectStack();
 
@@ -1333,6 +1396,14 @@ class Thread {
   // called if the pre-conditions might no longer hold true.
   static void ClearAllInterpreterCaches();
 
+  // Returns the cache of decoded compiled frames used when capturing stack traces, allocating
+  // it on first use. Only to be used by the thread itself.
+  StackTraceFrameCache* GetStackTraceFrameCache();
+
+  // Returns the cache of catch handler lookups used when delivering exceptions, allocating
+  // it on first use. Only to be used by the thread itself.
+  CatchHandlerCache* GetCatchHandlerCache();
+
   template<PointerSize pointer_size>
   static constexpr ThreadOffset<pointer_size> InterpreterCacheOffset() {
     return ThreadOffset<pointer_size>(OFFSETOF_MEMBER(Thread, interpreter_cache_));
@@ -1687,7 +1758,8 @@ class Thread {
       thread_local_objects(0), mterp_current_ibase(nullptr), thread_local_alloc_stack_top(nullptr),
       thread_local_alloc_stack_end(nullptr),
       flip_function(nullptr), method_verifier(nullptr), thread_local_mark_stack(nullptr),
-      async_exception(nullptr), top_reflective_handle_scope(nullptr) {
+      async_exception(nullptr), top_reflective_handle_scope(nullptr),
+      method_trace_buffer(nullptr) {
       std::fill(held_mutexes, held_mutexes + kLockLevelCount, nullptr);
     }
 
@@ -1846,6 +1918,9 @@ class Thread {
 
     // Top of the linked-list for reflective-handle scopes or null if none.
     BaseReflectiveHandleScope* top_reflective_handle_scope;
+
+    // Buffer of method trace events not yet written out, or null. Owned by the Trace.
+    TraceThreadBuffer* method_trace_buffer;
   } tlsPtr_;
 
   // Small thread-local cache to be used from the interpreter.
@@ -1870,6 +1945,25 @@ class Thread {
   // Note that it is not in the packed struct, may not be accessed for cross compilation.
   uintptr_t poison_object_cookie_ = 0;
 
+  // Size of the next TLAB refill or expansion and time of the last one. Only accessed by the
+  // thread itself, on the TLAB allocation slow path.
+  size_t adaptive_tlab_size_ = 0;
+  uint64_t last_tlab_refill_time_ns_ = 0;
+
+  // Bytes this thread may still allocate in bulk (TLABs, runs, large objects) before its next
+  // allocation is sampled. Only accessed by the thread itself.
+  size_t bytes_until_allocation_sample_ = 0;
+
+  // RosAlloc slot caches for the brackets too large for thread-local runs. Accessed by the thread
+  // itself, and by the thread revoking its RosAlloc runs while it cannot allocate.
+  RosAllocSlotCache rosalloc_slot_caches_[kNumRosAllocSlotCacheBracketsInThread];
+
+  // See GetAllocationStallTimeNs(). Only written by the thread itself, read racily by thread dumps.
+  uint64_t allocation_stall_time_ns_ = 0;
+
+  // See GetSuspendBarrierPassTimeNs(). Only written by the thread itself.
+  std::atomic<uint64_t> suspend_barrier_pass_time_ns_{0u};
+
   // Pending extra checkpoints if checkpoint_function_ is already used.
   std::list<Closure*> checkpoint_overflow_ GUARDED_BY(Locks::thread_suspend_count_lock_);
 
@@ -1889,6 +1983,12 @@ class Thread {
   // the caller is allowed to access all fields and methods in the Core Platform API.
   uint32_t core_platform_api_cookie_ = 0;
 
+  // See GetStackTraceFrameCache(). Allocated lazily, as most threads never throw.
+  std::unique_ptr<StackTraceFrameCache> stack_trace_frame_cache_;
+
+  // See GetCatchHandlerCache(). Allocated lazily, as most threads never throw.
+  std::unique_ptr<CatchHandlerCache> catch_handler_cache_;
+
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
   friend class QuickExceptionHandler;  // For dumping the stack.
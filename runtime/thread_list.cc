@@ -20,6 +20,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <vector>
 
@@ -28,6 +30,8 @@
 #include "nativehelper/scoped_local_ref.h"
 #include "nativehelper/scoped_utf_chars.h"
 
+#include "arch/context.h"
+#include "art_method-inl.h"
 #include "base/aborting.h"
 #include "base/histogram-inl.h"
 #include "base/mutex-inl.h"
@@ -35,17 +39,22 @@
 #include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "debugger.h"
+#include "dex/dex_file_annotations.h"
 #include "gc/collector/concurrent_copying.h"
 #include "gc/gc_pause_listener.h"
 #include "gc/heap.h"
 #include "gc/reference_processor.h"
+#include "gc/scoped_gc_critical_section.h"
 #include "gc_root.h"
 #include "jni/jni_internal.h"
 #include "lock_word.h"
+#include "mirror/dex_cache-inl.h"
 #include "monitor.h"
 #include "native_stack_dump.h"
 #include "scoped_thread_state_change-inl.h"
+#include "stack.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "well_known_classes.h"
 
@@ -75,6 +84,10 @@ ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
     : suspend_all_count_(0),
       unregistering_count_(0),
       suspend_all_historam_("suspend all histogram", 16, 64),
+      attach_count_(0u),
+      attach_time_ns_(0u),
+      detach_count_(0u),
+      detach_time_ns_(0u),
       long_suspend_(false),
       shut_down_(false),
       thread_suspend_timeout_ns_(thread_suspend_timeout_ns),
@@ -151,8 +164,24 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_historam_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
   }
+  uint64_t attach_count = attach_count_.load(std::memory_order_relaxed);
+  uint64_t detach_count = detach_count_.load(std::memory_order_relaxed);
+  if (attach_count != 0u || detach_count != 0u) {
+    uint64_t attach_time_ns = attach_time_ns_.load(std::memory_order_relaxed);
+    uint64_t detach_time_ns = detach_time_ns_.load(std::memory_order_relaxed);
+    os << "Thread attaches: " << attach_count << " total time: " << PrettyDuration(attach_time_ns)
+       << " mean time: " << PrettyDuration(attach_count != 0u ? attach_time_ns / attach_count : 0u)
+       << "\n"
+       << "Thread detaches: " << detach_count << " total time: " << PrettyDuration(detach_time_ns)
+       << " mean time: " << PrettyDuration(detach_count != 0u ? detach_time_ns / detach_count : 0u)
+       << "\n";
+  }
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
-  Dump(os, dump_native_stack);
+  if (Runtime::Current()->GetStagedSigQuitDump()) {
+    DumpStaged(os, dump_native_stack);
+  } else {
+    Dump(os, dump_native_stack);
+  }
   DumpUnattachedThreads(os, dump_native_stack && kDumpUnattachedThreadNativeStackForSigQuit);
 }
 
@@ -273,6 +302,181 @@ void ThreadList::Dump(std::ostream& os, bool dump_native_stack) {
   }
 }
 
+// A closure used by ThreadList::DumpStaged(). Each thread only records its state and the
+// (method, dex pc) pairs of its managed frames; the requesting thread formats them afterwards.
+class StackSnapshotCheckpoint final : public Closure {
+ public:
+  explicit StackSnapshotCheckpoint(bool dump_native_stack)
+      : lock_("stack snapshot checkpoint lock", kGenericBottomLock),
+        // Avoid verifying count in case a thread doesn't end up passing through the barrier.
+        // This avoids a SIGABRT that would otherwise happen in the destructor.
+        barrier_(0, /*verify_count_on_shutdown=*/false),
+        dump_native_stack_(dump_native_stack) {}
+
+  void Run(Thread* thread) override {
+    // Note thread and self may not be equal if thread was already suspended at the point of the
+    // request.
+    Thread* self = Thread::Current();
+    CHECK(self != nullptr);
+    Snapshot snapshot;
+    snapshot.tid = thread->GetTid();
+    {
+      ScopedObjectAccess soa(self);
+      std::ostringstream header_os;
+      thread->DumpState(header_os);
+      snapshot.header = header_os.str();
+      snapshot.dump_native_stack = dump_native_stack_ && thread->ShouldShowNativeStack();
+      std::unique_ptr<Context> context(Context::Create());
+      StackVisitor::WalkStack(
+          [&snapshot](const StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+            ArtMethod* m = stack_visitor->GetMethod();
+            if (!m->IsRuntimeMethod()) {
+              snapshot.frames.emplace_back(m, stack_visitor->GetDexPc(/*abort_on_failure=*/ false));
+            }
+            return true;
+          },
+          thread,
+          context.get(),
+          StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+    }
+    {
+      MutexLock mu(self, lock_);
+      snapshots_.push_back(std::move(snapshot));
+    }
+    barrier_.Pass(self);
+  }
+
+  void WaitForThreadsToRunThroughCheckpoint(size_t threads_running_checkpoint) {
+    Thread* self = Thread::Current();
+    ScopedThreadStateChange tsc(self, kWaitingForCheckPointsToRun);
+    bool timed_out = barrier_.Increment(self, threads_running_checkpoint, kDumpWaitTimeout);
+    if (timed_out) {
+      // Avoid a recursive abort.
+      LOG((kIsDebugBuild && (gAborting == 0)) ? ::android::base::FATAL : ::android::base::ERROR)
+          << "Unexpected time out during stack snapshot checkpoint.";
+    }
+  }
+
+  // Formats the recorded snapshots. The managed frames are formatted first, then the native
+  // stacks are unwound without holding the mutator lock.
+  void Dump(std::ostream& os) REQUIRES(!Locks::mutator_lock_, !lock_) {
+    Thread* self = Thread::Current();
+    std::vector<Snapshot> snapshots;
+    {
+      MutexLock mu(self, lock_);
+      snapshots.swap(snapshots_);
+    }
+    std::vector<std::string> java_stacks;
+    java_stacks.reserve(snapshots.size());
+    {
+      ScopedObjectAccess soa(self);
+      for (const Snapshot& snapshot : snapshots) {
+        std::ostringstream java_os;
+        DumpFrames(java_os, snapshot.frames);
+        java_stacks.push_back(java_os.str());
+      }
+    }
+    std::unique_ptr<BacktraceMap> backtrace_map;
+    if (dump_native_stack_) {
+      backtrace_map.reset(BacktraceMap::Create(getpid()));
+      if (backtrace_map != nullptr) {
+        backtrace_map->SetSuffixesToIgnore(std::vector<std::string> { "oat", "odex" });
+      }
+    }
+    for (size_t i = 0; i != snapshots.size(); ++i) {
+      const Snapshot& snapshot = snapshots[i];
+      os << snapshot.header;
+      if (snapshot.dump_native_stack) {
+        DumpNativeStack(os, snapshot.tid, backtrace_map.get(), "  native: ");
+      }
+      os << java_stacks[i] << std::endl;
+    }
+  }
+
+ private:
+  struct Snapshot {
+    pid_t tid;
+    std::string header;
+    bool dump_native_stack;
+    std::vector<std::pair<ArtMethod*, uint32_t>> frames;
+  };
+
+  // Formats the frames the same way as the StackDumpVisitor in thread.cc.
+  static void DumpFrames(std::ostream& os,
+                         const std::vector<std::pair<ArtMethod*, uint32_t>>& frames)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    static constexpr size_t kMaxRepetition = 3u;
+    ArtMethod* last_method = nullptr;
+    int last_line_number = 0;
+    size_t repetition_count = 0u;
+    for (const std::pair<ArtMethod*, uint32_t>& frame : frames) {
+      ArtMethod* m = frame.first->GetInterfaceMethodIfProxy(kRuntimePointerSize);
+      ObjPtr<mirror::DexCache> dex_cache = m->GetDexCache();
+      int line_number = -1;
+      if (dex_cache != nullptr) {  // be tolerant of bad input
+        line_number = annotations::GetLineNumFromPC(dex_cache->GetDexFile(), m, frame.second);
+      }
+      if (line_number == last_line_number && last_method == m) {
+        ++repetition_count;
+      } else {
+        if (repetition_count >= kMaxRepetition) {
+          os << "  ... repeated " << (repetition_count - kMaxRepetition) << " times\n";
+        }
+        repetition_count = 0u;
+        last_line_number = line_number;
+        last_method = m;
+      }
+      if (repetition_count >= kMaxRepetition) {
+        continue;
+      }
+      os << "  at " << m->PrettyMethod(false);
+      if (m->IsNative()) {
+        os << "(Native method)";
+      } else {
+        const char* source_file(m->GetDeclaringClassSourceFile());
+        os << "(" << (source_file != nullptr ? source_file : "unavailable")
+           << ":" << line_number << ")";
+      }
+      os << "\n";
+    }
+    if (frames.empty()) {
+      os << "  (no managed stack frames)\n";
+    }
+  }
+
+  // Guards the snapshots, which are added by the threads running the checkpoint.
+  Mutex lock_;
+  std::vector<Snapshot> snapshots_ GUARDED_BY(lock_);
+  // The barrier to be passed through and for the requestor to wait upon.
+  Barrier barrier_;
+  // Whether we should dump the native stack.
+  const bool dump_native_stack_;
+};
+
+void ThreadList::DumpStaged(std::ostream& os, bool dump_native_stack) {
+  Thread* self = Thread::Current();
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    os << "DALVIK THREADS (" << list_.size() << "):\n";
+  }
+  // The recorded methods are only used after the threads resume. Class unloading only happens
+  // during GC, so keep GCs from starting until the snapshots have been formatted. Formatting does
+  // not allocate managed objects.
+  gc::ScopedInterruptibleGCCriticalSection gcs(
+      self, gc::kGcCauseSigQuitDump, gc::kCollectorTypeCriticalSection);
+  StackSnapshotCheckpoint checkpoint(dump_native_stack);
+  size_t threads_running_checkpoint;
+  {
+    // Use SOA to prevent deadlocks if multiple threads are calling Dump() at the same time.
+    ScopedObjectAccess soa(self);
+    threads_running_checkpoint = RunCheckpoint(&checkpoint);
+  }
+  if (threads_running_checkpoint != 0) {
+    checkpoint.WaitForThreadsToRunThroughCheckpoint(threads_running_checkpoint);
+  }
+  checkpoint.Dump(os);
+}
+
 void ThreadList::AssertThreadsAreSuspended(Thread* self, Thread* ignore1, Thread* ignore2) {
   MutexLock mu(self, *Locks::thread_list_lock_);
   MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
@@ -317,7 +521,113 @@ static void ThreadSuspendSleep(useconds_t delay_us) {
   }
 }
 
-size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback) {
+// Runs the checkpoint for suspended threads claimed from a shared index and lowers their suspend
+// count afterwards. Shared by the thread requesting the checkpoint and the pool tasks below.
+class SuspendedThreadsCheckpoint {
+ public:
+  SuspendedThreadsCheckpoint(Closure* checkpoint_function,
+                             const std::vector<Thread*>& threads,
+                             size_t start_index)
+      : checkpoint_function_(checkpoint_function),
+        threads_(threads),
+        next_index_(start_index),
+        barrier_(0) {}
+
+  void Run(Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::thread_suspend_count_lock_) {
+    while (true) {
+      size_t index = next_index_.fetch_add(1u, std::memory_order_relaxed);
+      if (index >= threads_.size()) {
+        break;
+      }
+      RunFor(self, checkpoint_function_, threads_[index]);
+    }
+  }
+
+  static void RunFor(Thread* self, Closure* checkpoint_function, Thread* thread)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::thread_suspend_count_lock_) {
+    // We know for sure that the thread is suspended at this point.
+    DCHECK(thread->IsSuspended());
+    checkpoint_function->Run(thread);
+    MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+    bool updated = thread->ModifySuspendCount(self, -1, nullptr, SuspendReason::kInternal);
+    DCHECK(updated);
+  }
+
+  // Passed once by each pool task when it is done.
+  Barrier& GetBarrier() {
+    return barrier_;
+  }
+
+ private:
+  Closure* const checkpoint_function_;
+  const std::vector<Thread*>& threads_;
+  std::atomic<size_t> next_index_;
+  Barrier barrier_;
+};
+
+class SuspendedThreadsCheckpointTask final : public SelfDeletingTask {
+ public:
+  explicit SuspendedThreadsCheckpointTask(SuspendedThreadsCheckpoint* checkpoint)
+      : checkpoint_(checkpoint) {}
+
+  void Run(Thread* self) override {
+    {
+      ScopedObjectAccess soa(self);
+      checkpoint_->Run(self);
+    }
+    checkpoint_->GetBarrier().Pass(self);
+  }
+
+ private:
+  SuspendedThreadsCheckpoint* const checkpoint_;
+};
+
+void ThreadList::RunCheckpointOnSuspendedThreadsInParallel(Thread* self,
+                                                           Closure* checkpoint_function,
+                                                           std::vector<Thread*>* threads,
+                                                           ThreadPool* thread_pool) {
+  Locks::mutator_lock_->AssertSharedHeld(self);
+  // The pool workers are attached threads and are usually suspended waiting for tasks, in which
+  // case their suspend count was raised as well and they cannot become runnable to help. Run
+  // their checkpoints first and let them resume.
+  const std::vector<ThreadPoolWorker*>& workers = thread_pool->GetWorkers();
+  auto is_worker = [&workers](Thread* thread) {
+    return std::any_of(workers.begin(),
+                       workers.end(),
+                       [thread](ThreadPoolWorker* worker) { return worker->GetThread() == thread; });
+  };
+  auto workers_end = std::stable_partition(threads->begin(), threads->end(), is_worker);
+  size_t num_workers = std::distance(threads->begin(), workers_end);
+  for (size_t i = 0; i != num_workers; ++i) {
+    SuspendedThreadsCheckpoint::RunFor(self, checkpoint_function, (*threads)[i]);
+  }
+  if (num_workers != 0u) {
+    MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+    Thread::resume_cond_->Broadcast(self);
+  }
+
+  // The calling thread takes a share of the remaining threads as well. A worker of the pool must
+  // not wait for other tasks of the same pool, so it does all the work itself.
+  SuspendedThreadsCheckpoint checkpoint(checkpoint_function, *threads, num_workers);
+  size_t num_remaining = threads->size() - num_workers;
+  size_t num_tasks = (num_remaining > 1u && !is_worker(self))
+      ? std::min(thread_pool->GetThreadCount(), num_remaining - 1u)
+      : 0u;
+  for (size_t i = 0; i != num_tasks; ++i) {
+    thread_pool->AddTask(self, new SuspendedThreadsCheckpointTask(&checkpoint));
+  }
+  checkpoint.Run(self);
+  if (num_tasks != 0u) {
+    // The tasks need the mutator lock, so do not hold it while waiting for them.
+    ScopedThreadSuspension sts(self, kWaitingForCheckPointsToRun);
+    checkpoint.GetBarrier().Increment(self, num_tasks);
+  }
+}
+
+size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
+                                 Closure* callback,
+                                 ThreadPool* thread_pool) {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
   Locks::thread_list_lock_->AssertNotHeld(self);
@@ -382,15 +692,23 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback
   // Run the checkpoint on ourself while we wait for threads to suspend.
   checkpoint_function->Run(self);
 
-  // Run the checkpoint on the suspended threads.
-  for (const auto& thread : suspended_count_modified_threads) {
-    // We know for sure that the thread is suspended at this point.
-    DCHECK(thread->IsSuspended());
-    checkpoint_function->Run(thread);
-    {
-      MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
-      bool updated = thread->ModifySuspendCount(self, -1, nullptr, SuspendReason::kInternal);
-      DCHECK(updated);
+  // Run the checkpoint on the suspended threads. Spreading the work across the thread pool needs
+  // a runnable caller, so that waiting for the pool cannot block a suspend-all request.
+  if (thread_pool != nullptr &&
+      suspended_count_modified_threads.size() > 1u &&
+      self->GetState() == kRunnable) {
+    RunCheckpointOnSuspendedThreadsInParallel(
+        self, checkpoint_function, &suspended_count_modified_threads, thread_pool);
+  } else {
+    for (const auto& thread : suspended_count_modified_threads) {
+      // We know for sure that the thread is suspended at this point.
+      DCHECK(thread->IsSuspended());
+      checkpoint_function->Run(thread);
+      {
+        MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+        bool updated = thread->ModifySuspendCount(self, -1, nullptr, SuspendReason::kInternal);
+        DCHECK(updated);
+      }
     }
   }
 
@@ -689,6 +1007,7 @@ void ThreadList::SuspendAllInternal(Thread* self,
 
   // The atomic counter for number of threads that need to pass the barrier.
   AtomicInteger pending_threads;
+  const uint64_t request_time = NanoTime();
   uint32_t num_ignored = 0;
   if (ignore1 != nullptr) {
     ++num_ignored;
@@ -769,6 +1088,57 @@ void ThreadList::SuspendAllInternal(Thread* self,
       break;
     }
   }
+
+  // Name the threads that delayed the suspension the most in traces and logs.
+  const uint64_t time_to_suspend = NanoTime() - request_time;
+  const bool is_long_suspend = time_to_suspend > kLongThreadSuspendThreshold;
+  if (UNLIKELY(ATraceEnabled() || VLOG_IS_ON(threads) || is_long_suspend)) {
+    std::string slowest_threads =
+        DescribeSlowestThreadsToSuspend(self, request_time, ignore1, ignore2);
+    ScopedTrace trace(slowest_threads);
+    if (is_long_suspend) {
+      LOG(WARNING) << "Threads took " << PrettyDuration(time_to_suspend) << " to suspend. "
+                   << slowest_threads;
+    } else {
+      VLOG(threads) << slowest_threads;
+    }
+  }
+}
+
+std::string ThreadList::DescribeSlowestThreadsToSuspend(Thread* self,
+                                                        uint64_t request_time_ns,
+                                                        Thread* ignore1,
+                                                        Thread* ignore2) {
+  static constexpr size_t kMaxReportedThreads = 3;
+  std::vector<std::pair<uint64_t, Thread*>> times_to_suspend;
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  for (Thread* thread : list_) {
+    if (thread == ignore1 || thread == ignore2) {
+      continue;
+    }
+    // Threads that were already suspended did not have to pass the barrier.
+    uint64_t pass_time = thread->GetSuspendBarrierPassTimeNs();
+    if (pass_time >= request_time_ns) {
+      times_to_suspend.emplace_back(pass_time - request_time_ns, thread);
+    }
+  }
+  size_t num_reported = std::min(times_to_suspend.size(), kMaxReportedThreads);
+  std::partial_sort(times_to_suspend.begin(),
+                    times_to_suspend.begin() + num_reported,
+                    times_to_suspend.end(),
+                    [](const std::pair<uint64_t, Thread*>& lhs,
+                       const std::pair<uint64_t, Thread*>& rhs) {
+                      return lhs.first > rhs.first;
+                    });
+  std::ostringstream oss;
+  oss << "Slowest of " << times_to_suspend.size() << " threads to suspend:";
+  for (size_t i = 0; i != num_reported; ++i) {
+    std::string name;
+    times_to_suspend[i].second->GetThreadName(name);
+    oss << " \"" << name << "\" tid=" << times_to_suspend[i].second->GetTid()
+        << " " << PrettyDuration(times_to_suspend[i].first);
+  }
+  return oss.str();
 }
 
 void ThreadList::ResumeAll() {
@@ -1297,6 +1667,7 @@ void ThreadList::Unregister(Thread* self) {
 
   VLOG(threads) << "ThreadList::Unregister() " << *self;
 
+  const uint64_t start_time = NanoTime();
   {
     MutexLock mu(self, *Locks::thread_list_lock_);
     ++unregistering_count_;
@@ -1355,6 +1726,9 @@ void ThreadList::Unregister(Thread* self) {
   Thread::self_tls_ = nullptr;
 #endif
 
+  detach_count_.fetch_add(1u, std::memory_order_relaxed);
+  detach_time_ns_.fetch_add(NanoTime() - start_time, std::memory_order_relaxed);
+
   // Signal that a thread just detached.
   MutexLock mu(nullptr, *Locks::thread_list_lock_);
   --unregistering_count_;
@@ -40,6 +40,7 @@ class Closure;
 class IsMarkedVisitor;
 class RootVisitor;
 class Thread;
+class ThreadPool;
 class TimingLogger;
 enum VisitRootFlags : uint8_t;
 
@@ -61,6 +62,13 @@ class ThreadList {
   // For thread suspend timeout dumps.
   void Dump(std::ostream& os, bool dump_native_stack = true)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
+  // Like Dump() but threads only record their state and managed frames at the checkpoint, and
+  // the frames are symbolized and formatted by the calling thread afterwards. Lock info is not
+  // included and native stacks are unwound after the thread has resumed.
+  void DumpStaged(std::ostream& os, bool dump_native_stack)
+      REQUIRES(!Locks::thread_list_lock_,
+               !Locks::thread_suspend_count_lock_,
+               !Locks::mutator_lock_);
   pid_t GetLockOwner();  // For SignalCatcher.
 
   // Thread suspension support.
@@ -109,8 +117,13 @@ class ThreadList {
   // of the suspend check. Returns how many checkpoints that are expected to run, including for
   // already suspended threads for b/24191051. Run the callback, if non-null, inside the
   // thread_list_lock critical section after determining the runnable/suspended states of the
-  // threads.
-  size_t RunCheckpoint(Closure* checkpoint_function, Closure* callback = nullptr)
+  // threads. If `thread_pool` is non-null and its workers are started, the checkpoints of the
+  // suspended threads are spread across the pool; the checkpoint function must then be safe to
+  // run concurrently for different threads, and a runnable caller may be suspended while it
+  // waits for the pool.
+  size_t RunCheckpoint(Closure* checkpoint_function,
+                       Closure* callback = nullptr,
+                       ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
   // Run an empty checkpoint on threads. Wait until threads pass the next suspend point or are
@@ -153,6 +166,14 @@ class ThreadList {
                !Locks::thread_list_lock_,
                !Locks::thread_suspend_count_lock_);
 
+  // Record how long it took a thread to attach, from the start of the native thread or the
+  // AttachCurrentThread call until it can run managed code. Reported in SIGQUIT dumps along with
+  // the time spent in Unregister().
+  void RecordThreadAttachTime(uint64_t attach_time_ns) {
+    attach_count_.fetch_add(1u, std::memory_order_relaxed);
+    attach_time_ns_.fetch_add(attach_time_ns, std::memory_order_relaxed);
+  }
+
   void VisitRoots(RootVisitor* visitor, VisitRootFlags flags) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -190,6 +211,14 @@ class ThreadList {
   size_t RunCheckpoint(Closure* checkpoint_function, bool includeSuspended)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Run the checkpoint for the threads whose suspend count RunCheckpoint() raised, using the
+  // workers of `thread_pool` as well as `self`.
+  void RunCheckpointOnSuspendedThreadsInParallel(Thread* self,
+                                                 Closure* checkpoint_function,
+                                                 std::vector<Thread*>* threads,
+                                                 ThreadPool* thread_pool)
+      REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
+
   void DumpUnattachedThreads(std::ostream& os, bool dump_native_stack)
       REQUIRES(!Locks::thread_list_lock_);
 
@@ -202,6 +231,14 @@ class ThreadList {
                           SuspendReason reason = SuspendReason::kInternal)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Describe the threads that took the longest to pass the suspend barrier of a suspend all
+  // requested at `request_time_ns`.
+  std::string DescribeSlowestThreadsToSuspend(Thread* self,
+                                              uint64_t request_time_ns,
+                                              Thread* ignore1,
+                                              Thread* ignore2)
+      REQUIRES(!Locks::thread_list_lock_);
+
   void AssertThreadsAreSuspended(Thread* self, Thread* ignore1, Thread* ignore2 = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
@@ -220,6 +257,12 @@ class ThreadList {
   // by mutator lock ensures no thread can read when another thread is modifying it.
   Histogram<uint64_t> suspend_all_historam_ GUARDED_BY(Locks::mutator_lock_);
 
+  // Number of thread attaches and detaches, and the total time they took.
+  Atomic<uint64_t> attach_count_;
+  Atomic<uint64_t> attach_time_ns_;
+  Atomic<uint64_t> detach_count_;
+  Atomic<uint64_t> detach_time_ns_;
+
   // Whether or not the current thread suspension is long.
   bool long_suspend_;
 
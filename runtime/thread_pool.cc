@@ -17,6 +17,7 @@
 
 #include "thread_pool.h"
 
+#include <sched.h>
 #include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/time.h>
@@ -46,10 +47,13 @@ static constexpr bool kUseCustomThreadPoolStack = false;
 static constexpr bool kUseCustomThreadPoolStack = true;
 #endif
 
-ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name,
-                                   size_t stack_size)
+ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool,
+                                   const std::string& name,
+                                   size_t stack_size,
+                                   size_t index)
     : thread_pool_(thread_pool),
-      name_(name) {
+      name_(name),
+      index_(index) {
   std::string error_msg;
   // On Bionic, we know pthreads will give us a big-enough stack with
   // a guard page, so don't do anything special on Bionic libc.
@@ -106,11 +110,34 @@ int ThreadPoolWorker::GetPthreadPriority() {
 #endif
 }
 
+bool ThreadPoolWorker::SetCpuAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    CHECK_GE(cpu, 0);
+    CHECK_LT(cpu, CPU_SETSIZE);
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(thread_->GetTid(), sizeof(cpu_set), &cpu_set) != 0) {
+    PLOG(WARNING) << "Failed to set the CPU affinity of " << name_;
+    return false;
+  }
+  return true;
+#else
+  UNUSED(cpus);
+  return false;
+#endif
+}
+
 void ThreadPoolWorker::Run() {
   Thread* self = Thread::Current();
   Task* task = nullptr;
+  if (thread_pool_->work_stealing_) {
+    thread_pool_->worker_queues_[index_]->owner.store(self, std::memory_order_relaxed);
+  }
   thread_pool_->creation_barier_.Pass(self);
-  while ((task = thread_pool_->GetTask(self)) != nullptr) {
+  while ((task = thread_pool_->GetTask(self, index_)) != nullptr) {
     task->Run(self);
     task->Finalize();
   }
@@ -139,9 +166,50 @@ void* ThreadPoolWorker::Callback(void* arg) {
   return nullptr;
 }
 
+ThreadPool::WorkerQueue* ThreadPool::SelectWorkerQueue(Thread* self, CoreAffinity affinity) {
+  const size_t num_queues = worker_queues_.size();
+  // Tasks added by a worker are likely to run next on the same worker.
+  for (const std::unique_ptr<WorkerQueue>& queue : worker_queues_) {
+    if (queue->owner.load(std::memory_order_relaxed) == self &&
+        (affinity == CoreAffinity::kAny ||
+         queue->affinity.load(std::memory_order_relaxed) == affinity)) {
+      return queue.get();
+    }
+  }
+  const size_t start = next_worker_queue_.fetch_add(1u, std::memory_order_relaxed);
+  if (affinity != CoreAffinity::kAny) {
+    for (size_t i = 0; i != num_queues; ++i) {
+      WorkerQueue* queue = worker_queues_[(start + i) % num_queues].get();
+      if (queue->affinity.load(std::memory_order_relaxed) == affinity) {
+        return queue;
+      }
+    }
+  }
+  return worker_queues_[start % num_queues].get();
+}
+
 void ThreadPool::AddTask(Thread* self, Task* task) {
+  const uint32_t priority = task->GetPriority();
+  if (work_stealing_ && priority == 0u && !worker_queues_.empty()) {
+    WorkerQueue* queue = SelectWorkerQueue(self, task->GetAffinityHint());
+    // Count the task first, the count may overestimate the queued tasks but never miss one.
+    num_worker_queue_tasks_.fetch_add(1u, std::memory_order_seq_cst);
+    {
+      MutexLock mu(self, queue->lock);
+      queue->tasks.push_back(task);
+    }
+    MutexLock mu(self, task_queue_lock_);
+    if (started_ && waiting_count_ != 0) {
+      task_queue_condition_.Signal(self);
+    }
+    return;
+  }
   MutexLock mu(self, task_queue_lock_);
-  tasks_.push_back(task);
+  if (priority == 0u) {
+    tasks_.push_back(task);
+  } else {
+    prioritized_tasks_.emplace(priority, task);
+  }
   // If we have any waiters, signal one.
   if (started_ && waiting_count_ != 0) {
     task_queue_condition_.Signal(self);
@@ -155,8 +223,14 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
   while ((task = TryGetTask(self)) != nullptr) {
     task->Finalize();
   }
+  for (const std::unique_ptr<WorkerQueue>& queue : worker_queues_) {
+    MutexLock mu(self, queue->lock);
+    num_worker_queue_tasks_.fetch_sub(queue->tasks.size(), std::memory_order_seq_cst);
+    queue->tasks.clear();
+  }
   MutexLock mu(self, task_queue_lock_);
   tasks_.clear();
+  prioritized_tasks_.clear();
 }
 
 ThreadPool::ThreadPool(const char* name,
@@ -175,23 +249,42 @@ ThreadPool::ThreadPool(const char* name,
     creation_barier_(0),
     max_active_workers_(num_threads),
     create_peers_(create_peers),
-    worker_stack_size_(worker_stack_size) {
+    worker_stack_size_(worker_stack_size),
+    work_stealing_(work_stealing),
+    num_worker_queue_tasks_(0u),
+    num_stealing_workers_(0u),
+    next_worker_queue_(0u) {
   CreateThreads();
 }
 
 void ThreadPool::CreateThreads() {
   CHECK(threads_.empty());
   Thread* self = Thread::Current();
+  // Tasks left in the queues of deleted workers continue from the shared queue.
+  std::vector<Task*> leftover_tasks;
+  for (const std::unique_ptr<WorkerQueue>& queue : worker_queues_) {
+    MutexLock mu(self, queue->lock);
+    leftover_tasks.insert(leftover_tasks.end(), queue->tasks.begin(), queue->tasks.end());
+    queue->tasks.clear();
+  }
+  worker_queues_.clear();
+  num_worker_queue_tasks_.store(0u, std::memory_order_seq_cst);
   {
     MutexLock mu(self, task_queue_lock_);
     shutting_down_ = false;
+    tasks_.insert(tasks_.begin(), leftover_tasks.begin(), leftover_tasks.end());
+    if (work_stealing_) {
+      while (worker_queues_.size() < max_active_workers_) {
+        worker_queues_.emplace_back(new WorkerQueue());
+      }
+    }
     // Add one since the caller of constructor waits on the barrier too.
     creation_barier_.Init(self, max_active_workers_);
     while (GetThreadCount() < max_active_workers_) {
       const std::string worker_name = StringPrintf("%s worker thread %zu", name_.c_str(),
                                                    GetThreadCount());
       threads_.push_back(
-          new ThreadPoolWorker(this, worker_name, worker_stack_size_));
+          new ThreadPoolWorker(this, worker_name, worker_stack_size_, GetThreadCount()));
     }
   }
 }
@@ -212,6 +305,7 @@ void ThreadPool::DeleteThreads() {
     MutexLock mu(self, task_queue_lock_);
     // Tell any remaining workers to shut down.
     shutting_down_ = true;
+    num_stealing_workers_.store(0u, std::memory_order_release);
     // Broadcast to everyone waiting.
     task_queue_condition_.Broadcast(self);
     completion_condition_.Broadcast(self);
@@ -222,10 +316,20 @@ void ThreadPool::DeleteThreads() {
   STLDeleteElements(&threads_);
 }
 
+void ThreadPool::SetThreadCount(size_t num_threads) {
+  CHECK(threads_.empty());
+  CHECK_GT(num_threads, 0u);
+  MutexLock mu(Thread::Current(), task_queue_lock_);
+  max_active_workers_ = num_threads;
+}
+
 void ThreadPool::SetMaxActiveWorkers(size_t max_workers) {
   MutexLock mu(Thread::Current(), task_queue_lock_);
   CHECK_LE(max_workers, GetThreadCount());
   max_active_workers_ = max_workers;
+  if (started_) {
+    num_stealing_workers_.store(max_workers, std::memory_order_release);
+  }
 }
 
 ThreadPool::~ThreadPool() {
@@ -236,6 +340,7 @@ ThreadPool::~ThreadPool() {
 void ThreadPool::StartWorkers(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
   started_ = true;
+  num_stealing_workers_.store(max_active_workers_, std::memory_order_release);
   task_queue_condition_.Broadcast(self);
   start_time_ = NanoTime();
   total_wait_time_ = 0;
@@ -244,11 +349,26 @@ void ThreadPool::StartWorkers(Thread* self) {
 void ThreadPool::StopWorkers(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
   started_ = false;
+  num_stealing_workers_.store(0u, std::memory_order_release);
 }
 
-Task* ThreadPool::GetTask(Thread* self) {
-  MutexLock mu(self, task_queue_lock_);
-  while (!IsShuttingDown()) {
+Task* ThreadPool::GetTask(Thread* self, size_t worker_index) {
+  // Whether the last check under the lock says that this worker may take a queued task.
+  bool checked_active = false;
+  while (true) {
+    if (work_stealing_ &&
+        (checked_active ||
+         worker_index < num_stealing_workers_.load(std::memory_order_acquire))) {
+      Task* task = TryGetWorkerQueueTask(self, worker_index);
+      if (task != nullptr) {
+        return task;
+      }
+    }
+    checked_active = false;
+    MutexLock mu(self, task_queue_lock_);
+    if (IsShuttingDown()) {
+      break;
+    }
     const size_t thread_count = GetThreadCount();
     // Ensure that we don't use more threads than the maximum active workers.
     const size_t active_threads = thread_count - waiting_count_;
@@ -258,6 +378,13 @@ Task* ThreadPool::GetTask(Thread* self) {
       if (task != nullptr) {
         return task;
       }
+      if (work_stealing_ &&
+          started_ &&
+          num_worker_queue_tasks_.load(std::memory_order_seq_cst) != 0u) {
+        // There are tasks in the worker queues, take one without holding the lock.
+        checked_active = true;
+        continue;
+      }
     }
 
     ++waiting_count_;
@@ -279,15 +406,55 @@ Task* ThreadPool::GetTask(Thread* self) {
 }
 
 Task* ThreadPool::TryGetTask(Thread* self) {
+  if (work_stealing_ && num_stealing_workers_.load(std::memory_order_acquire) != 0u) {
+    Task* task = TryGetWorkerQueueTask(self, /*start_index=*/ 0u);
+    if (task != nullptr) {
+      return task;
+    }
+  }
   MutexLock mu(self, task_queue_lock_);
   return TryGetTaskLocked();
 }
 
 Task* ThreadPool::TryGetTaskLocked() {
   if (HasOutstandingTasks()) {
-    Task* task = tasks_.front();
-    tasks_.pop_front();
-    return task;
+    if (!prioritized_tasks_.empty()) {
+      auto it = prioritized_tasks_.begin();
+      Task* task = it->second;
+      prioritized_tasks_.erase(it);
+      return task;
+    }
+    // The outstanding tasks may all be in the worker queues.
+    if (!tasks_.empty()) {
+      Task* task = tasks_.front();
+      tasks_.pop_front();
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+Task* ThreadPool::TryGetWorkerQueueTask(Thread* self, size_t start_index) {
+  if (num_worker_queue_tasks_.load(std::memory_order_seq_cst) == 0u) {
+    return nullptr;
+  }
+  const size_t num_queues = worker_queues_.size();
+  for (size_t i = 0; i != num_queues; ++i) {
+    WorkerQueue* queue = worker_queues_[(start_index + i) % num_queues].get();
+    MutexLock mu(self, queue->lock);
+    if (!queue->tasks.empty()) {
+      Task* task;
+      if (i == 0u) {
+        task = queue->tasks.front();
+        queue->tasks.pop_front();
+      } else {
+        // Steal the most recently added task, the owner is furthest from running it.
+        task = queue->tasks.back();
+        queue->tasks.pop_back();
+      }
+      num_worker_queue_tasks_.fetch_sub(1u, std::memory_order_seq_cst);
+      return task;
+    }
   }
   return nullptr;
 }
@@ -314,7 +481,9 @@ void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
 
 size_t ThreadPool::GetTaskCount(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  return tasks_.size();
+  return tasks_.size() +
+      prioritized_tasks_.size() +
+      num_worker_queue_tasks_.load(std::memory_order_seq_cst);
 }
 
 void ThreadPool::SetPthreadPriority(int priority) {
@@ -323,6 +492,20 @@ void ThreadPool::SetPthreadPriority(int priority) {
   }
 }
 
+bool ThreadPool::SetWorkerAffinity(size_t worker_index,
+                                   CoreAffinity affinity,
+                                   const std::vector<int>& cpus) {
+  const std::vector<ThreadPoolWorker*>& workers = GetWorkers();
+  CHECK_LT(worker_index, workers.size());
+  if (!workers[worker_index]->SetCpuAffinity(cpus)) {
+    return false;
+  }
+  if (worker_index < worker_queues_.size()) {
+    worker_queues_[worker_index]->affinity.store(affinity, std::memory_order_relaxed);
+  }
+  return true;
+}
+
 void ThreadPool::CheckPthreadPriority(int priority) {
 #if defined(ART_TARGET_ANDROID)
   for (ThreadPoolWorker* worker : threads_) {
@@ -17,8 +17,11 @@
 #ifndef ART_RUNTIME_THREAD_POOL_H_
 #define ART_RUNTIME_THREAD_POOL_H_
 
+#include <atomic>
 #include <deque>
 #include <functional>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "barrier.h"
@@ -46,10 +49,30 @@ class FunctionClosure : public Closure {
   std::function<void(Thread*)> func_;
 };
 
+// Which kind of core a task would rather run on, see ThreadPool::SetWorkerAffinity.
+enum class CoreAffinity : uint8_t {
+  kAny,
+  kBigCore,
+  kLittleCore,
+};
+
 class Task : public Closure {
  public:
   // Called after Closure::Run has been called.
   virtual void Finalize() { }
+
+  // Tasks with a higher priority are taken from the queue first. Tasks of equal priority are
+  // run in the order they were added. Called once, when the task is added to a pool.
+  virtual uint32_t GetPriority() const {
+    return 0u;
+  }
+
+  // Work-stealing pools queue the task on a worker with a matching affinity, if there is one.
+  // This is only a hint, other workers may still steal the task. Called once, when the task is
+  // added to a pool.
+  virtual CoreAffinity GetAffinityHint() const {
+    return CoreAffinity::kAny;
+  }
 };
 
 class SelfDeletingTask : public Task {
@@ -89,15 +112,23 @@ class ThreadPoolWorker {
   // Get the "nice" priority for this worker.
   int GetPthreadPriority();
 
+  // Restrict this worker to the given CPUs. Returns false if the affinity could not be set.
+  bool SetCpuAffinity(const std::vector<int>& cpus);
+
   Thread* GetThread() const { return thread_; }
 
  protected:
-  ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name, size_t stack_size);
+  ThreadPoolWorker(ThreadPool* thread_pool,
+                   const std::string& name,
+                   size_t stack_size,
+                   size_t index);
   static void* Callback(void* arg) REQUIRES(!Locks::mutator_lock_);
   virtual void Run();
 
   ThreadPool* const thread_pool_;
   const std::string name_;
+  // Index of this worker in the pool, also the index of its queue in work-stealing mode.
+  const size_t index_;
   MemMap stack_;
   pthread_t pthread_;
   Thread* thread_;
@@ -135,10 +166,17 @@ class ThreadPool {
   // If create_peers is true, all worker threads will have a Java peer object. Note that if the
   // pool is asked to do work on the current thread (see Wait), a peer may not be available. Wait
   // will conservatively abort if create_peers and do_work are true.
+  //
+  // If work_stealing is true, tasks of the default priority go to per-worker queues instead of
+  // the shared queue, and idle workers steal from the queues of the others. Workers then only
+  // take the shared lock to wait, at the cost of not running tasks in the order they were added.
+  // Tasks with a non-default priority stay in the shared queue, which workers check once the
+  // worker queues are empty.
   ThreadPool(const char* name,
              size_t num_threads,
              bool create_peers = false,
-             size_t worker_stack_size = ThreadPoolWorker::kDefaultStackSize);
+             size_t worker_stack_size = ThreadPoolWorker::kDefaultStackSize,
+             bool work_stealing = false);
   virtual ~ThreadPool();
 
   // Create the threads of this pool.
@@ -147,6 +185,10 @@ class ThreadPool {
   // Stops and deletes all threads in this pool.
   void DeleteThreads();
 
+  // Change the number of threads that the next CreateThreads() creates. Only valid while the
+  // pool has no threads, that is before CreateThreads() or after DeleteThreads().
+  void SetThreadCount(size_t num_threads) REQUIRES(!task_queue_lock_);
+
   // Wait for all tasks currently on queue to get completed. If the pool has been stopped, only
   // wait till all already running tasks are done.
   // When the pool was created with peers for workers, do_work must not be true (see ThreadPool()).
@@ -170,12 +212,21 @@ class ThreadPool {
   // `priority`.
   void CheckPthreadPriority(int priority);
 
+  // Pin the worker to `cpus` and record that it runs on cores of the given kind, so that
+  // work-stealing pools queue tasks with a matching affinity hint on it. Returns false if the
+  // worker could not be pinned.
+  bool SetWorkerAffinity(size_t worker_index, CoreAffinity affinity, const std::vector<int>& cpus);
+
+  bool IsWorkStealing() const {
+    return work_stealing_;
+  }
+
   // Wait for workers to be created.
   void WaitForWorkersToBeCreated();
 
  protected:
   // get a task to run, blocks if there are no tasks left
-  virtual Task* GetTask(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual Task* GetTask(Thread* self, size_t worker_index) REQUIRES(!task_queue_lock_);
 
   // Try to get a task, returning null if there is none available.
   Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
@@ -187,9 +238,31 @@ class ThreadPool {
   }
 
   bool HasOutstandingTasks() const REQUIRES(task_queue_lock_) {
-    return started_ && !tasks_.empty();
+    return started_ &&
+        (!tasks_.empty() ||
+         !prioritized_tasks_.empty() ||
+         num_worker_queue_tasks_.load(std::memory_order_seq_cst) != 0u);
   }
 
+  // The queue of one worker in work-stealing mode. The owner takes tasks from the front, other
+  // workers steal from the back.
+  struct WorkerQueue {
+    WorkerQueue()
+        : lock("thread pool worker queue lock"), owner(nullptr), affinity(CoreAffinity::kAny) {}
+
+    Mutex lock;
+    std::deque<Task*> tasks GUARDED_BY(lock);
+    std::atomic<Thread*> owner;
+    std::atomic<CoreAffinity> affinity;
+  };
+
+  // Pick the queue for a new task, preferring the queue of `self` if it is a worker of this pool.
+  WorkerQueue* SelectWorkerQueue(Thread* self, CoreAffinity affinity);
+
+  // Take a task from the worker queues, starting with the queue at `start_index`. Does not
+  // block, and does not take `task_queue_lock_`.
+  Task* TryGetWorkerQueueTask(Thread* self, size_t start_index) REQUIRES(!task_queue_lock_);
+
   const std::string name_;
   Mutex task_queue_lock_;
   ConditionVariable task_queue_condition_ GUARDED_BY(task_queue_lock_);
@@ -198,7 +271,12 @@ class ThreadPool {
   volatile bool shutting_down_ GUARDED_BY(task_queue_lock_);
   // How many worker threads are waiting on the condition.
   volatile size_t waiting_count_ GUARDED_BY(task_queue_lock_);
+  // Tasks with the default priority, in FIFO order.
   std::deque<Task*> tasks_ GUARDED_BY(task_queue_lock_);
+  // Tasks with a non-default priority, highest first. A multimap keeps equal keys in insertion
+  // order, so tasks of the same priority stay FIFO.
+  std::multimap<uint32_t, Task*, std::greater<uint32_t>> prioritized_tasks_
+      GUARDED_BY(task_queue_lock_);
   std::vector<ThreadPoolWorker*> threads_;
   // Work balance detection.
   uint64_t start_time_ GUARDED_BY(task_queue_lock_);
@@ -207,6 +285,16 @@ class ThreadPool {
   size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
   const bool create_peers_;
   const size_t worker_stack_size_;
+  const bool work_stealing_;
+  // Per-worker queues in work-stealing mode, created with the threads.
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  // Number of tasks in all worker queues.
+  std::atomic<size_t> num_worker_queue_tasks_;
+  // Workers with an index below this may take tasks from the worker queues without taking
+  // `task_queue_lock_`. Zero while the pool is stopped, `max_active_workers_` otherwise.
+  std::atomic<size_t> num_stealing_workers_;
+  // Round-robin position for tasks added by threads that are not workers of this pool.
+  std::atomic<size_t> next_worker_queue_;
 
  private:
   friend class ThreadPoolWorker;
@@ -17,6 +17,7 @@
 #include "thread_pool.h"
 
 #include <string>
+#include <vector>
 
 #include "base/atomic.h"
 #include "common_runtime_test.h"
@@ -160,6 +161,75 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
 }
 
+// Test that a work-stealing pool runs the tasks added from within tasks, and the tasks added by
+// the main thread while the workers are stopped.
+TEST_F(ThreadPoolTest, WorkStealingTest) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Thread pool test thread pool",
+                         num_threads,
+                         /*create_peers=*/ false,
+                         ThreadPoolWorker::kDefaultStackSize,
+                         /*work_stealing=*/ true);
+  ASSERT_TRUE(thread_pool.IsWorkStealing());
+  AtomicInteger count(0);
+  static const int depth = 8;
+  thread_pool.AddTask(self, new TreeTask(&thread_pool, &count, depth));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
+
+  thread_pool.StopWorkers(self);
+  AtomicInteger stopped_count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new CountTask(&stopped_count));
+  }
+  EXPECT_EQ(static_cast<size_t>(num_tasks), thread_pool.GetTaskCount(self));
+  usleep(200);
+  EXPECT_EQ(0, stopped_count.load(std::memory_order_seq_cst));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, false, false);
+  EXPECT_EQ(num_tasks, stopped_count.load(std::memory_order_seq_cst));
+  EXPECT_EQ(0u, thread_pool.GetTaskCount(self));
+}
+
+class PriorityTask : public Task {
+ public:
+  PriorityTask(std::vector<uint32_t>* order, uint32_t priority)
+      : order_(order), priority_(priority) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) override {
+    // Only one worker, no need for synchronization.
+    order_->push_back(priority_);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+  uint32_t GetPriority() const override {
+    return priority_;
+  }
+
+ private:
+  std::vector<uint32_t>* const order_;
+  const uint32_t priority_;
+};
+
+// Test that tasks are run by decreasing priority, and in FIFO order for equal priorities.
+TEST_F(ThreadPoolTest, PriorityTest) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Thread pool test thread pool", 1);
+  std::vector<uint32_t> order;
+  for (uint32_t priority : {0u, 2u, 1u, 0u, 3u, 2u}) {
+    thread_pool.AddTask(self, new PriorityTask(&order, priority));
+  }
+  EXPECT_EQ(6u, thread_pool.GetTaskCount(self));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, false, false);
+  EXPECT_EQ(std::vector<uint32_t>({3u, 2u, 2u, 1u, 0u, 0u}), order);
+}
+
 class PeerTask : public Task {
  public:
   PeerTask() {}
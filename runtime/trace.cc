@@ -23,6 +23,8 @@
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
+#include "base/array_ref.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/os.h"
@@ -73,11 +75,65 @@ TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
 
+// Method tracing events of one thread that have not been written to the main buffer yet. They are
+// recorded by the owning thread without locking; writing them out needs the streaming_lock_.
+class TraceThreadBuffer {
+ public:
+  explicit TraceThreadBuffer(pid_t tid) : tid_(tid), num_events_(0u), exited_(false) {}
+
+  // Returns true if the buffer is full after adding the event.
+  bool AddEvent(ArtMethod* method,
+                TraceAction action,
+                uint32_t thread_clock_diff,
+                uint32_t wall_clock_diff) {
+    DCHECK_LT(num_events_, kNumEvents);
+    events_[num_events_] = {method, action, thread_clock_diff, wall_clock_diff};
+    ++num_events_;
+    return num_events_ == kNumEvents;
+  }
+
+  struct Event {
+    ArtMethod* method;
+    TraceAction action;
+    uint32_t thread_clock_diff;
+    uint32_t wall_clock_diff;
+  };
+
+  ArrayRef<const Event> GetEvents() const {
+    return ArrayRef<const Event>(events_, num_events_);
+  }
+
+  void Clear() {
+    num_events_ = 0u;
+  }
+
+  pid_t GetTid() const {
+    return tid_;
+  }
+
+  bool HasExited() const {
+    return exited_;
+  }
+
+  void SetExited() {
+    exited_ = true;
+  }
+
+ private:
+  static constexpr size_t kNumEvents = 256u;
+
+  const pid_t tid_;
+  size_t num_events_;
+  bool exited_;
+  Event events_[kNumEvents];
+
+  DISALLOW_COPY_AND_ASSIGN(TraceThreadBuffer);
+};
+
 static TraceAction DecodeTraceAction(uint32_t tmid) {
   return static_cast<TraceAction>(tmid & kTraceMethodActionMask);
 }
@@ -110,13 +166,11 @@ uint32_t Trace::EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action
 }
 
 std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
+  return new std::vector<ArtMethod*>();
 }
 
 void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
-  stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
+  delete stack_trace;
 }
 
 void Trace::SetDefaultClockSource(TraceClockSource clock_source) {
@@ -222,6 +276,28 @@ static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_
   the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
 }
 
+// Takes a sample of each thread at its next suspend point, or right away on the sampling thread
+// for threads that are suspended, instead of suspending all threads for every sample.
+class SampleCheckpoint final : public Closure {
+ public:
+  explicit SampleCheckpoint(Trace* trace) : trace_(trace), barrier_(0) {}
+
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    GetSample(thread, trace_);
+    barrier_.Pass(Thread::Current());
+  }
+
+  void WaitForThreads(Thread* self, size_t threads_running_checkpoint) {
+    if (threads_running_checkpoint != 0) {
+      barrier_.Increment(self, threads_running_checkpoint);
+    }
+  }
+
+ private:
+  Trace* const trace_;
+  Barrier barrier_;
+};
+
 static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUTE_UNUSED) {
   thread->SetTraceClockBase(0);
   std::vector<ArtMethod*>* stack_trace = thread->GetStackTraceSample();
@@ -229,9 +305,16 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUT
   delete stack_trace;
 }
 
+static void ClearThreadTraceBuffer(Thread* thread, void* arg ATTRIBUTE_UNUSED) {
+  // The buffer itself is owned and written out by the Trace.
+  thread->SetMethodTraceBuffer(nullptr);
+}
+
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
+  // Called from a checkpoint, either by the sampled thread itself or by the sampling thread
+  // while the sampled thread is suspended, so the sample of the thread is not accessed
+  // concurrently.
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -290,15 +373,12 @@ void* Trace::RunSamplingThread(void* arg) {
       }
     }
     {
-      // Avoid a deadlock between a thread doing garbage collection
-      // and the profile sampling thread, by blocking GC when sampling
-      // thread stacks (see b/73624630).
-      gc::ScopedGCCriticalSection gcs(self,
-                                      art::gc::kGcCauseInstrumentation,
-                                      art::gc::kCollectorTypeInstrumentation);
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+      // Only the sampled threads stop, each for the duration of its own stack walk.
+      ScopedObjectAccess soa(self);
+      SampleCheckpoint checkpoint(the_trace);
+      size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
+      ScopedThreadStateChange tsc(self, kWaitingForCheckPointsToRun);
+      checkpoint.WaitForThreads(self, threads_running_checkpoint);
     }
   }
 
@@ -484,6 +564,10 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
             instrumentation::Instrumentation::kMethodExited |
             instrumentation::Instrumentation::kMethodUnwind);
         runtime->GetInstrumentation()->DisableMethodTracing(kTracerInstrumentationKey);
+        if (the_trace->use_thread_buffers_) {
+          MutexLock mu(self, *Locks::thread_list_lock_);
+          runtime->GetThreadList()->ForEach(ClearThreadTraceBuffer, nullptr);
+        }
       }
     }
     // At this point, code may read buf_ as it's writers are shutdown
@@ -558,7 +642,10 @@ Trace::Trace(File* trace_file,
       clock_source_(default_clock_source_),
       buffer_size_(std::max(kMinBufSize, buffer_size)),
       start_time_(MicroTime()), clock_overhead_ns_(GetClockOverheadNanoSeconds()),
-      overflow_(false), interval_us_(0), streaming_lock_(nullptr),
+      overflow_(false), interval_us_(0),
+      use_thread_buffers_(output_mode == TraceOutputMode::kStreaming &&
+                          trace_mode == TraceMode::kMethodTracing),
+      streaming_lock_(nullptr),
       unique_methods_lock_(new Mutex("unique methods lock", kTracingUniqueMethodsLock)) {
   CHECK(trace_file != nullptr || output_mode == TraceOutputMode::kDDMS);
 
@@ -616,8 +703,13 @@ void Trace::FinishTracing() {
   size_t final_offset = 0;
   std::set<ArtMethod*> visited_methods;
   if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    // Clean up.
     MutexLock mu(Thread::Current(), *streaming_lock_);
+    // Write out the events still held in the per-thread buffers. The writers have been shut down.
+    for (const std::unique_ptr<TraceThreadBuffer>& buffer : thread_buffers_) {
+      FlushThreadBuffer(buffer.get());
+    }
+    thread_buffers_.clear();
+    // Clean up.
     STLDeleteValues(&seen_methods_);
   } else {
     final_offset = cur_offset_.load(std::memory_order_relaxed);
@@ -877,13 +969,96 @@ void Trace::FlushBuf() {
   cur_offset_.store(0, std::memory_order_relaxed);
 }
 
+void Trace::WriteThreadInfo(Thread* thread) {
+  if (RegisterThread(thread)) {
+    // It might be better to postpone this. Threads might not have received names...
+    std::string thread_name;
+    thread->GetThreadName(thread_name);
+    uint8_t buf[7];
+    Append2LE(buf, 0);
+    buf[2] = kOpNewThread;
+    Append2LE(buf + 3, static_cast<uint16_t>(thread->GetTid()));
+    Append2LE(buf + 5, static_cast<uint16_t>(thread_name.length()));
+    WriteToBuf(buf, sizeof(buf));
+    WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
+  }
+}
+
+void Trace::WriteStreamingRecord(pid_t tid,
+                                 ArtMethod* method,
+                                 TraceAction action,
+                                 uint32_t thread_clock_diff,
+                                 uint32_t wall_clock_diff) {
+  if (RegisterMethod(method)) {
+    // Write a special block with the name.
+    std::string method_line(GetMethodLine(method));
+    uint8_t buf[5];
+    Append2LE(buf, 0);
+    buf[2] = kOpNewMethod;
+    Append2LE(buf + 3, static_cast<uint16_t>(method_line.length()));
+    WriteToBuf(buf, sizeof(buf));
+    WriteToBuf(reinterpret_cast<const uint8_t*>(method_line.c_str()), method_line.length());
+  }
+
+  static constexpr size_t kPacketSize = 14U;  // The maximum size of data in a packet.
+  uint8_t packet[kPacketSize];
+  uint8_t* ptr = packet;
+  Append2LE(ptr, tid);
+  Append4LE(ptr + 2, EncodeTraceMethodAndAction(method, action));
+  ptr += 6;
+  if (UseThreadCpuClock()) {
+    Append4LE(ptr, thread_clock_diff);
+    ptr += 4;
+  }
+  if (UseWallClock()) {
+    Append4LE(ptr, wall_clock_diff);
+  }
+  static_assert(kPacketSize == 2 + 4 + 4 + 4, "Packet size incorrect.");
+  WriteToBuf(packet, sizeof(packet));
+}
+
+TraceThreadBuffer* Trace::CreateThreadBuffer(Thread* thread) {
+  DCHECK(use_thread_buffers_);
+  DCHECK(thread->GetMethodTraceBuffer() == nullptr);
+  MutexLock mu(Thread::Current(), *streaming_lock_);
+  thread_buffers_.push_back(std::make_unique<TraceThreadBuffer>(thread->GetTid()));
+  TraceThreadBuffer* buffer = thread_buffers_.back().get();
+  thread->SetMethodTraceBuffer(buffer);
+  // The thread name precedes any of its events.
+  WriteThreadInfo(thread);
+  return buffer;
+}
+
+void Trace::FlushThreadBuffer(TraceThreadBuffer* buffer) {
+  for (const TraceThreadBuffer::Event& event : buffer->GetEvents()) {
+    WriteStreamingRecord(buffer->GetTid(),
+                         event.method,
+                         event.action,
+                         event.thread_clock_diff,
+                         event.wall_clock_diff);
+  }
+  buffer->Clear();
+}
+
+void Trace::ReleaseExitedThreadBuffers() {
+  auto it = thread_buffers_.begin();
+  while (it != thread_buffers_.end()) {
+    if ((*it)->HasExited()) {
+      FlushThreadBuffer(it->get());
+      it = thread_buffers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
                                 instrumentation::Instrumentation::InstrumentationEvent event,
                                 uint32_t thread_clock_diff, uint32_t wall_clock_diff) {
   // This method is called in both tracing modes (method and
-  // sampling). In sampling mode, this method is only called by the
-  // sampling thread. In method tracing mode, it can be called
-  // concurrently.
+  // sampling) and can be called concurrently in both. In sampling
+  // mode, the events of a thread are logged from a checkpoint, which
+  // runs either on that thread or on the sampling thread.
 
   // Ensure we always use the non-obsolete version of the method so that entry/exit events have the
   // same pointer value.
@@ -926,25 +1101,39 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
       UNIMPLEMENTED(FATAL) << "Unexpected event: " << event;
   }
 
+  if (use_thread_buffers_) {
+    // Only the current thread records events in its buffer, so no locking is needed until the
+    // buffer is full.
+    DCHECK_EQ(thread, Thread::Current());
+    TraceThreadBuffer* buffer = thread->GetMethodTraceBuffer();
+    if (UNLIKELY(buffer == nullptr)) {
+      buffer = CreateThreadBuffer(thread);
+    }
+    if (UNLIKELY(buffer->AddEvent(method, action, thread_clock_diff, wall_clock_diff))) {
+      MutexLock mu(thread, *streaming_lock_);
+      FlushThreadBuffer(buffer);
+      ReleaseExitedThreadBuffers();
+    }
+    return;
+  }
+
+  if (trace_output_mode_ == TraceOutputMode::kStreaming) {
+    // Sampling mode.
+    MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
+    WriteThreadInfo(thread);
+    WriteStreamingRecord(thread->GetTid(), method, action, thread_clock_diff, wall_clock_diff);
+    return;
+  }
+
   uint32_t method_value = EncodeTraceMethodAndAction(method, action);
 
-  // Write data into the tracing buffer (if not streaming) or into a
-  // small buffer on the stack (if streaming) which we'll put into the
-  // tracing buffer below.
+  // Write data into the tracing buffer.
   //
   // These writes to the tracing buffer are synchronised with the
   // future reads that (only) occur under FinishTracing(). The callers
   // of FinishTracing() acquire locks and (implicitly) synchronise
   // the buffer memory.
-  uint8_t* ptr;
-  static constexpr size_t kPacketSize = 14U;  // The maximum size of data in a packet.
-  uint8_t stack_buf[kPacketSize];             // Space to store a packet when in streaming mode.
-  if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    ptr = stack_buf;
-  } else {
-    ptr = buf_.get() + old_offset;
-  }
-
+  uint8_t* ptr = buf_.get() + old_offset;
   Append2LE(ptr, thread->GetTid());
   Append4LE(ptr + 2, method_value);
   ptr += 6;
@@ -956,34 +1145,6 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
   if (UseWallClock()) {
     Append4LE(ptr, wall_clock_diff);
   }
-  static_assert(kPacketSize == 2 + 4 + 4 + 4, "Packet size incorrect.");
-
-  if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
-    if (RegisterMethod(method)) {
-      // Write a special block with the name.
-      std::string method_line(GetMethodLine(method));
-      uint8_t buf2[5];
-      Append2LE(buf2, 0);
-      buf2[2] = kOpNewMethod;
-      Append2LE(buf2 + 3, static_cast<uint16_t>(method_line.length()));
-      WriteToBuf(buf2, sizeof(buf2));
-      WriteToBuf(reinterpret_cast<const uint8_t*>(method_line.c_str()), method_line.length());
-    }
-    if (RegisterThread(thread)) {
-      // It might be better to postpone this. Threads might not have received names...
-      std::string thread_name;
-      thread->GetThreadName(thread_name);
-      uint8_t buf2[7];
-      Append2LE(buf2, 0);
-      buf2[2] = kOpNewThread;
-      Append2LE(buf2 + 3, static_cast<uint16_t>(thread->GetTid()));
-      Append2LE(buf2 + 5, static_cast<uint16_t>(thread_name.length()));
-      WriteToBuf(buf2, sizeof(buf2));
-      WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
-    }
-    WriteToBuf(stack_buf, sizeof(stack_buf));
-  }
 }
 
 void Trace::GetVisitedMethods(size_t buf_size,
@@ -1024,6 +1185,15 @@ void Trace::DumpThreadList(std::ostream& os) {
 
 void Trace::StoreExitingThreadInfo(Thread* thread) {
   MutexLock mu(thread, *Locks::trace_lock_);
+  TraceThreadBuffer* buffer = thread->GetMethodTraceBuffer();
+  if (buffer != nullptr) {
+    // Leave the buffer to be written out by another thread, or when tracing finishes.
+    thread->SetMethodTraceBuffer(nullptr);
+    if (the_trace_ != nullptr) {
+      MutexLock mu2(thread, *the_trace_->streaming_lock_);
+      buffer->SetExited();
+    }
+  }
   if (the_trace_ != nullptr) {
     std::string name;
     thread->GetThreadName(name);
@@ -46,6 +46,7 @@ class DexFile;
 class LOCKABLE Mutex;
 class ShadowFrame;
 class Thread;
+class TraceThreadBuffer;
 
 using DexIndexBitSet = std::bitset<65536>;
 
@@ -226,9 +227,9 @@ class Trace final : public instrumentation::InstrumentationListener {
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!unique_methods_lock_) override;
   void WatchedFramePop(Thread* thread, const ShadowFrame& frame)
       REQUIRES_SHARED(Locks::mutator_lock_) override;
-  // Reuse an old stack trace if it exists, otherwise allocate a new one.
+  // Allocate and free the stack traces of samples. Samples of different threads can be taken
+  // concurrently.
   static std::vector<ArtMethod*>* AllocStackTrace();
-  // Clear and store an old stack trace for later use.
   static void FreeStackTrace(std::vector<ArtMethod*>* stack_trace);
   // Save id and name of a thread before it exits.
   static void StoreExitingThreadInfo(Thread* thread);
@@ -289,6 +290,28 @@ class Trace final : public instrumentation::InstrumentationListener {
   void FlushBuf()
       REQUIRES(streaming_lock_);
 
+  // Write the name of the thread to the main buffer if it has not been seen yet. Used for
+  // streaming.
+  void WriteThreadInfo(Thread* thread)
+      REQUIRES(streaming_lock_);
+  // Write a record to the main buffer, preceded by the name of the method if it has not been seen
+  // yet. Used for streaming.
+  void WriteStreamingRecord(pid_t tid,
+                            ArtMethod* method,
+                            TraceAction action,
+                            uint32_t thread_clock_diff,
+                            uint32_t wall_clock_diff)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(streaming_lock_, !unique_methods_lock_);
+
+  // Methods for the per-thread buffers used for method tracing in streaming mode.
+  TraceThreadBuffer* CreateThreadBuffer(Thread* thread)
+      REQUIRES(!streaming_lock_);
+  void FlushThreadBuffer(TraceThreadBuffer* buffer)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(streaming_lock_, !unique_methods_lock_);
+  // Flush and delete the buffers of threads that have exited.
+  void ReleaseExitedThreadBuffers()
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(streaming_lock_, !unique_methods_lock_);
+
   uint32_t EncodeTraceMethod(ArtMethod* method) REQUIRES(!unique_methods_lock_);
   uint32_t EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action)
       REQUIRES(!unique_methods_lock_);
@@ -308,9 +331,6 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
-
   // File to write trace data out to, null if direct to ddms.
   std::unique_ptr<File> trace_file_;
 
@@ -353,9 +373,8 @@ class Trace final : public instrumentation::InstrumentationListener {
   // so cur_offset_ can move forwards and backwards.
   //
   // When not in streaming mode, the buf_ writes can come from
-  // multiple threads when the trace mode is kMethodTracing. When
-  // trace mode is kSampling, writes only come from the sampling
-  // thread.
+  // multiple threads in both trace modes. When trace mode is
+  // kSampling, each thread's samples are taken in a checkpoint.
   //
   // Reads to the buffer happen after the event sources writing to the
   // buffer have been shutdown and all stores have completed. The
@@ -372,10 +391,18 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Sampling profiler sampling interval.
   int interval_us_;
 
+  // Whether method tracing events are first recorded in per-thread buffers. This is the case in
+  // streaming mode, where writing to the main buffer needs the streaming_lock_. Each thread then
+  // only takes the lock to flush its full buffer.
+  const bool use_thread_buffers_;
+
   // Streaming mode data.
   Mutex* streaming_lock_;
   std::map<const DexFile*, DexIndexBitSet*> seen_methods_ GUARDED_BY(streaming_lock_);
   std::unique_ptr<ThreadIDBitSet> seen_threads_ GUARDED_BY(streaming_lock_);
+  // The per-thread buffers. They are owned here so that the buffers of threads that exit while
+  // tracing is being stopped are still written out.
+  std::vector<std::unique_ptr<TraceThreadBuffer>> thread_buffers_ GUARDED_BY(streaming_lock_);
 
   // Bijective map from ArtMethod* to index.
   // Map from ArtMethod* to index in unique_methods_;
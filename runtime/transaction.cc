@@ -19,6 +19,7 @@
 #include <android-base/logging.h>
 
 #include "aot_class_linker.h"
+#include "base/casts.h"
 #include "base/mutex-inl.h"
 #include "base/stl_util.h"
 #include "gc/accounting/card_table-inl.h"
@@ -32,7 +33,7 @@
 #include "obj_ptr-inl.h"
 #include "runtime.h"
 
-#include <list>
+#include <vector>
 
 namespace art {
 
@@ -41,6 +42,12 @@ static constexpr bool kEnableTransactionStats = false;
 
 Transaction::Transaction(bool strict, mirror::Class* root)
     : log_lock_("transaction log lock", kTransactionLogLock),
+      arena_stack_(Runtime::Current()->GetArenaPool()),
+      allocator_(&arena_stack_),
+      object_logs_(allocator_.Adapter(kArenaAllocTransaction)),
+      array_logs_(allocator_.Adapter(kArenaAllocTransaction)),
+      intern_string_logs_(allocator_.Adapter(kArenaAllocTransaction)),
+      resolve_string_logs_(allocator_.Adapter(kArenaAllocTransaction)),
       aborted_(false),
       rolling_back_(false),
       heap_(Runtime::Current()->GetHeap()),
@@ -53,23 +60,14 @@ Transaction::Transaction(bool strict, mirror::Class* root)
 Transaction::~Transaction() {
   if (kEnableTransactionStats) {
     MutexLock mu(Thread::Current(), log_lock_);
-    size_t objects_count = object_logs_.size();
-    size_t field_values_count = 0;
-    for (const auto& it : object_logs_) {
-      field_values_count += it.second.Size();
-    }
-    size_t array_count = array_logs_.size();
-    size_t array_values_count = 0;
-    for (const auto& it : array_logs_) {
-      array_values_count += it.second.Size();
-    }
+    size_t field_values_count = object_logs_.size();
+    size_t array_values_count = array_logs_.size();
     size_t intern_string_count = intern_string_logs_.size();
     size_t resolve_string_count = resolve_string_logs_.size();
     LOG(INFO) << "Transaction::~Transaction"
-              << ": objects_count=" << objects_count
-              << ", field_values_count=" << field_values_count
-              << ", array_count=" << array_count
+              << ": field_values_count=" << field_values_count
               << ", array_values_count=" << array_values_count
+              << ", arena_bytes=" << allocator_.ApproximatePeakBytes()
               << ", intern_string_count=" << intern_string_count
               << ", resolve_string_count=" << resolve_string_count;
   }
@@ -169,33 +167,21 @@ void Transaction::RecordWriteFieldBoolean(mirror::Object* obj,
                                           MemberOffset field_offset,
                                           uint8_t value,
                                           bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogBooleanValue(field_offset, value, is_volatile);
+  LogFieldValue(obj, field_offset, kBoolean, value, is_volatile);
 }
 
 void Transaction::RecordWriteFieldByte(mirror::Object* obj,
                                        MemberOffset field_offset,
                                        int8_t value,
                                        bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogByteValue(field_offset, value, is_volatile);
+  LogFieldValue(obj, field_offset, kByte, value, is_volatile);
 }
 
 void Transaction::RecordWriteFieldChar(mirror::Object* obj,
                                        MemberOffset field_offset,
                                        uint16_t value,
                                        bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogCharValue(field_offset, value, is_volatile);
+  LogFieldValue(obj, field_offset, kChar, value, is_volatile);
 }
 
 
@@ -203,11 +189,7 @@ void Transaction::RecordWriteFieldShort(mirror::Object* obj,
                                         MemberOffset field_offset,
                                         int16_t value,
                                         bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogShortValue(field_offset, value, is_volatile);
+  LogFieldValue(obj, field_offset, kShort, value, is_volatile);
 }
 
 
@@ -215,33 +197,38 @@ void Transaction::RecordWriteField32(mirror::Object* obj,
                                      MemberOffset field_offset,
                                      uint32_t value,
                                      bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.Log32BitsValue(field_offset, value, is_volatile);
+  LogFieldValue(obj, field_offset, k32Bits, value, is_volatile);
 }
 
 void Transaction::RecordWriteField64(mirror::Object* obj,
                                      MemberOffset field_offset,
                                      uint64_t value,
                                      bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.Log64BitsValue(field_offset, value, is_volatile);
+  LogFieldValue(obj, field_offset, k64Bits, value, is_volatile);
 }
 
 void Transaction::RecordWriteFieldReference(mirror::Object* obj,
                                             MemberOffset field_offset,
                                             mirror::Object* value,
                                             bool is_volatile) {
+  LogFieldValue(obj, field_offset, kReference, reinterpret_cast<uintptr_t>(value), is_volatile);
+}
+
+void Transaction::LogFieldValue(mirror::Object* obj,
+                                MemberOffset field_offset,
+                                FieldValueKind kind,
+                                uint64_t value,
+                                bool is_volatile) {
   DCHECK(obj != nullptr);
   MutexLock mu(Thread::Current(), log_lock_);
   DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogReferenceValue(field_offset, value, is_volatile);
+  // Only the value before the first write needs to be restored, so later writes to the same
+  // field are not recorded; `insert()` does not replace an existing entry.
+  FieldValue field_value;
+  field_value.value = value;
+  field_value.kind = kind;
+  field_value.is_volatile = is_volatile;
+  object_logs_.insert(std::make_pair(LogKey{obj, field_offset.Uint32Value()}, field_value));
 }
 
 void Transaction::RecordWriteArray(mirror::Array* array, size_t index, uint64_t value) {
@@ -250,12 +237,7 @@ void Transaction::RecordWriteArray(mirror::Array* array, size_t index, uint64_t
   DCHECK(!array->IsObjectArray());
   MutexLock mu(Thread::Current(), log_lock_);
   DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  auto it = array_logs_.find(array);
-  if (it == array_logs_.end()) {
-    ArrayLog log;
-    it = array_logs_.emplace(array, std::move(log)).first;
-  }
-  it->second.LogValue(index, value);
+  array_logs_.insert(std::make_pair(LogKey{array, index}, value));
 }
 
 void Transaction::RecordResolveString(ObjPtr<mirror::DexCache> dex_cache,
@@ -291,7 +273,7 @@ void Transaction::LogInternedString(InternStringLog&& log) {
   Locks::intern_table_lock_->AssertExclusiveHeld(Thread::Current());
   MutexLock mu(Thread::Current(), log_lock_);
   DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  intern_string_logs_.push_front(std::move(log));
+  intern_string_logs_.push_back(std::move(log));
 }
 
 void Transaction::Rollback() {
@@ -312,7 +294,20 @@ void Transaction::UndoObjectModifications() {
   // TODO we may not need to restore objects allocated during this transaction. Or we could directly
   // remove them from the heap.
   for (const auto& it : object_logs_) {
-    it.second.Undo(it.first);
+    // Garbage collector needs to access object's class and array's length. So we don't rollback
+    // these values.
+    mirror::Object* obj = it.first.obj;
+    MemberOffset field_offset(it.first.offset_or_index);
+    if (field_offset.Uint32Value() == mirror::Class::ClassOffset().Uint32Value()) {
+      // Skip Object::class field.
+      continue;
+    }
+    if (obj->IsArrayInstance() &&
+        field_offset.Uint32Value() == mirror::Array::LengthOffset().Uint32Value()) {
+      // Skip Array::length field.
+      continue;
+    }
+    UndoFieldWrite(obj, field_offset, it.second);
   }
   object_logs_.clear();
 }
@@ -321,17 +316,19 @@ void Transaction::UndoArrayModifications() {
   // TODO we may not need to restore array allocated during this transaction. Or we could directly
   // remove them from the heap.
   for (const auto& it : array_logs_) {
-    it.second.Undo(it.first);
+    mirror::Array* array = down_cast<mirror::Array*>(it.first.obj);
+    DCHECK(array->IsArrayInstance());
+    Primitive::Type type = array->GetClass()->GetComponentType()->GetPrimitiveType();
+    UndoArrayWrite(array, type, it.first.offset_or_index, it.second);
   }
   array_logs_.clear();
 }
 
 void Transaction::UndoInternStringTableModifications() {
   InternTable* const intern_table = Runtime::Current()->GetInternTable();
-  // We want to undo each operation from the most recent to the oldest. List has been filled so the
-  // most recent operation is at list begin so just have to iterate over it.
-  for (const InternStringLog& string_log : intern_string_logs_) {
-    string_log.Undo(intern_table);
+  // We want to undo each operation from the most recent to the oldest.
+  for (auto it = intern_string_logs_.rbegin(); it != intern_string_logs_.rend(); ++it) {
+    it->Undo(intern_table);
   }
   intern_string_logs_.clear();
 }
@@ -352,59 +349,49 @@ void Transaction::VisitRoots(RootVisitor* visitor) {
   VisitResolveStringLogs(visitor);
 }
 
-void Transaction::VisitObjectLogs(RootVisitor* visitor) {
-  // List of moving roots.
-  using ObjectPair = std::pair<mirror::Object*, mirror::Object*>;
-  std::list<ObjectPair> moving_roots;
-
-  // Visit roots.
-  for (auto& it : object_logs_) {
-    it.second.VisitRoots(visitor);
-    mirror::Object* old_root = it.first;
+template <typename Logs>
+void Transaction::VisitLogKeys(Logs* logs, RootVisitor* visitor) {
+  // The hash of an entry depends on the object, so the entries of moved objects are collected
+  // first and re-inserted with the new key after the visit.
+  std::vector<std::pair<LogKey, LogKey>> moving_roots;
+  for (const auto& it : *logs) {
+    mirror::Object* old_root = it.first.obj;
     mirror::Object* new_root = old_root;
     visitor->VisitRoot(&new_root, RootInfo(kRootUnknown));
     if (new_root != old_root) {
-      moving_roots.push_back(std::make_pair(old_root, new_root));
+      moving_roots.emplace_back(it.first, LogKey{new_root, it.first.offset_or_index});
     }
   }
 
-  // Update object logs with moving roots.
-  for (const ObjectPair& pair : moving_roots) {
-    mirror::Object* old_root = pair.first;
-    mirror::Object* new_root = pair.second;
-    auto old_root_it = object_logs_.find(old_root);
-    CHECK(old_root_it != object_logs_.end());
-    CHECK(object_logs_.find(new_root) == object_logs_.end());
-    object_logs_.emplace(new_root, std::move(old_root_it->second));
-    object_logs_.erase(old_root_it);
+  // Update logs with moving roots.
+  for (const auto& pair : moving_roots) {
+    auto old_root_it = logs->find(pair.first);
+    CHECK(old_root_it != logs->end());
+    CHECK(logs->find(pair.second) == logs->end());
+    auto value = std::move(old_root_it->second);
+    logs->erase(old_root_it);
+    logs->insert(std::make_pair(pair.second, std::move(value)));
   }
 }
 
-void Transaction::VisitArrayLogs(RootVisitor* visitor) {
-  // List of moving roots.
-  using ArrayPair = std::pair<mirror::Array*, mirror::Array*>;
-  std::list<ArrayPair> moving_roots;
-
-  for (auto& it : array_logs_) {
-    mirror::Array* old_root = it.first;
-    CHECK(!old_root->IsObjectArray());
-    mirror::Array* new_root = old_root;
-    visitor->VisitRoot(reinterpret_cast<mirror::Object**>(&new_root), RootInfo(kRootUnknown));
-    if (new_root != old_root) {
-      moving_roots.push_back(std::make_pair(old_root, new_root));
+void Transaction::VisitObjectLogs(RootVisitor* visitor) {
+  for (auto& it : object_logs_) {
+    FieldValue& field_value = it.second;
+    if (field_value.kind == kReference) {
+      visitor->VisitRootIfNonNull(reinterpret_cast<mirror::Object**>(&field_value.value),
+                                  RootInfo(kRootUnknown));
     }
   }
+  VisitLogKeys(&object_logs_, visitor);
+}
 
-  // Update array logs with moving roots.
-  for (const ArrayPair& pair : moving_roots) {
-    mirror::Array* old_root = pair.first;
-    mirror::Array* new_root = pair.second;
-    auto old_root_it = array_logs_.find(old_root);
-    CHECK(old_root_it != array_logs_.end());
-    CHECK(array_logs_.find(new_root) == array_logs_.end());
-    array_logs_.emplace(new_root, std::move(old_root_it->second));
-    array_logs_.erase(old_root_it);
+void Transaction::VisitArrayLogs(RootVisitor* visitor) {
+  if (kIsDebugBuild) {
+    for (const auto& it : array_logs_) {
+      CHECK(!it.first.obj->IsObjectArray());
+    }
   }
+  VisitLogKeys(&array_logs_, visitor);
 }
 
 void Transaction::VisitInternStringLogs(RootVisitor* visitor) {
@@ -419,72 +406,9 @@ void Transaction::VisitResolveStringLogs(RootVisitor* visitor) {
   }
 }
 
-void Transaction::ObjectLog::LogBooleanValue(MemberOffset offset, uint8_t value, bool is_volatile) {
-  LogValue(ObjectLog::kBoolean, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::LogByteValue(MemberOffset offset, int8_t value, bool is_volatile) {
-  LogValue(ObjectLog::kByte, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::LogCharValue(MemberOffset offset, uint16_t value, bool is_volatile) {
-  LogValue(ObjectLog::kChar, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::LogShortValue(MemberOffset offset, int16_t value, bool is_volatile) {
-  LogValue(ObjectLog::kShort, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::Log32BitsValue(MemberOffset offset, uint32_t value, bool is_volatile) {
-  LogValue(ObjectLog::k32Bits, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::Log64BitsValue(MemberOffset offset, uint64_t value, bool is_volatile) {
-  LogValue(ObjectLog::k64Bits, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::LogReferenceValue(MemberOffset offset,
-                                               mirror::Object* obj,
-                                               bool is_volatile) {
-  LogValue(ObjectLog::kReference, offset, reinterpret_cast<uintptr_t>(obj), is_volatile);
-}
-
-void Transaction::ObjectLog::LogValue(ObjectLog::FieldValueKind kind,
-                                      MemberOffset offset,
-                                      uint64_t value,
-                                      bool is_volatile) {
-  auto it = field_values_.find(offset.Uint32Value());
-  if (it == field_values_.end()) {
-    ObjectLog::FieldValue field_value;
-    field_value.value = value;
-    field_value.is_volatile = is_volatile;
-    field_value.kind = kind;
-    field_values_.emplace(offset.Uint32Value(), std::move(field_value));
-  }
-}
-
-void Transaction::ObjectLog::Undo(mirror::Object* obj) const {
-  for (auto& it : field_values_) {
-    // Garbage collector needs to access object's class and array's length. So we don't rollback
-    // these values.
-    MemberOffset field_offset(it.first);
-    if (field_offset.Uint32Value() == mirror::Class::ClassOffset().Uint32Value()) {
-      // Skip Object::class field.
-      continue;
-    }
-    if (obj->IsArrayInstance() &&
-        field_offset.Uint32Value() == mirror::Array::LengthOffset().Uint32Value()) {
-      // Skip Array::length field.
-      continue;
-    }
-    const FieldValue& field_value = it.second;
-    UndoFieldWrite(obj, field_offset, field_value);
-  }
-}
-
-void Transaction::ObjectLog::UndoFieldWrite(mirror::Object* obj,
-                                            MemberOffset field_offset,
-                                            const FieldValue& field_value) const {
+void Transaction::UndoFieldWrite(mirror::Object* obj,
+                                 MemberOffset field_offset,
+                                 const FieldValue& field_value) {
   // TODO We may want to abort a transaction while still being in transaction mode. In this case,
   // we'd need to disable the check.
   constexpr bool kCheckTransaction = false;
@@ -568,16 +492,6 @@ void Transaction::ObjectLog::UndoFieldWrite(mirror::Object* obj,
   }
 }
 
-void Transaction::ObjectLog::VisitRoots(RootVisitor* visitor) {
-  for (auto& it : field_values_) {
-    FieldValue& field_value = it.second;
-    if (field_value.kind == ObjectLog::kReference) {
-      visitor->VisitRootIfNonNull(reinterpret_cast<mirror::Object**>(&field_value.value),
-                                  RootInfo(kRootUnknown));
-    }
-  }
-}
-
 void Transaction::InternStringLog::Undo(InternTable* intern_table) const {
   DCHECK(intern_table != nullptr);
   switch (string_op_) {
@@ -644,26 +558,10 @@ Transaction::InternStringLog::InternStringLog(ObjPtr<mirror::String> s,
   DCHECK(s != nullptr);
 }
 
-void Transaction::ArrayLog::LogValue(size_t index, uint64_t value) {
-  auto it = array_values_.find(index);
-  if (it == array_values_.end()) {
-    array_values_.insert(std::make_pair(index, value));
-  }
-}
-
-void Transaction::ArrayLog::Undo(mirror::Array* array) const {
-  DCHECK(array != nullptr);
-  DCHECK(array->IsArrayInstance());
-  Primitive::Type type = array->GetClass()->GetComponentType()->GetPrimitiveType();
-  for (auto it : array_values_) {
-    UndoArrayWrite(array, type, it.first, it.second);
-  }
-}
-
-void Transaction::ArrayLog::UndoArrayWrite(mirror::Array* array,
-                                           Primitive::Type array_type,
-                                           size_t index,
-                                           uint64_t value) const {
+void Transaction::UndoArrayWrite(mirror::Array* array,
+                                 Primitive::Type array_type,
+                                 size_t index,
+                                 uint64_t value) {
   // TODO We may want to abort a transaction while still being in transaction mode. In this case,
   // we'd need to disable the check.
   constexpr bool kCheckTransaction = false;
@@ -17,17 +17,19 @@
 #ifndef ART_RUNTIME_TRANSACTION_H_
 #define ART_RUNTIME_TRANSACTION_H_
 
+#include "base/arena_allocator.h"
 #include "base/macros.h"
 #include "base/mutex.h"
-#include "base/safe_map.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
 #include "base/value_object.h"
 #include "dex/dex_file_types.h"
 #include "dex/primitive.h"
 #include "gc_root.h"
 #include "offsets.h"
+#include "runtime_globals.h"
 
-#include <list>
-#include <map>
+#include <utility>
 
 namespace art {
 namespace gc {
@@ -153,86 +155,58 @@ class Transaction final {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
-  class ObjectLog : public ValueObject {
-   public:
-    void LogBooleanValue(MemberOffset offset, uint8_t value, bool is_volatile);
-    void LogByteValue(MemberOffset offset, int8_t value, bool is_volatile);
-    void LogCharValue(MemberOffset offset, uint16_t value, bool is_volatile);
-    void LogShortValue(MemberOffset offset, int16_t value, bool is_volatile);
-    void Log32BitsValue(MemberOffset offset, uint32_t value, bool is_volatile);
-    void Log64BitsValue(MemberOffset offset, uint64_t value, bool is_volatile);
-    void LogReferenceValue(MemberOffset offset, mirror::Object* obj, bool is_volatile);
-
-    void Undo(mirror::Object* obj) const REQUIRES_SHARED(Locks::mutator_lock_);
-    void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
-
-    size_t Size() const {
-      return field_values_.size();
+  // A modified object field or primitive array element: the object and the field offset or
+  // the array index. The logs are flat hash maps keyed by it, so that recording a write needs
+  // neither a per-object log nor node allocations.
+  struct LogKey {
+    mirror::Object* obj = nullptr;
+    size_t offset_or_index = 0u;
+
+    bool operator==(const LogKey& other) const {
+      return obj == other.obj && offset_or_index == other.offset_or_index;
     }
-
-    ObjectLog() = default;
-    ObjectLog(ObjectLog&& log) = default;
-
-   private:
-    enum FieldValueKind {
-      kBoolean,
-      kByte,
-      kChar,
-      kShort,
-      k32Bits,
-      k64Bits,
-      kReference
-    };
-    struct FieldValue : public ValueObject {
-      // TODO use JValue instead ?
-      uint64_t value;
-      FieldValueKind kind;
-      bool is_volatile;
-
-      FieldValue() : value(0), kind(FieldValueKind::kBoolean), is_volatile(false) {}
-      FieldValue(FieldValue&& log) = default;
-
-     private:
-      DISALLOW_COPY_AND_ASSIGN(FieldValue);
-    };
-
-    void LogValue(FieldValueKind kind, MemberOffset offset, uint64_t value, bool is_volatile);
-    void UndoFieldWrite(mirror::Object* obj,
-                        MemberOffset field_offset,
-                        const FieldValue& field_value) const REQUIRES_SHARED(Locks::mutator_lock_);
-
-    // Maps field's offset to its value.
-    std::map<uint32_t, FieldValue> field_values_;
-
-    DISALLOW_COPY_AND_ASSIGN(ObjectLog);
   };
 
-  class ArrayLog : public ValueObject {
-   public:
-    void LogValue(size_t index, uint64_t value);
-
-    void Undo(mirror::Array* obj) const REQUIRES_SHARED(Locks::mutator_lock_);
-
-    size_t Size() const {
-      return array_values_.size();
+  struct LogKeyHash {
+    size_t operator()(const LogKey& key) const {
+      return (reinterpret_cast<uintptr_t>(key.obj) >> kObjectAlignmentShift) * 31u +
+             key.offset_or_index;
     }
+  };
 
-    ArrayLog() = default;
-    ArrayLog(ArrayLog&& log) = default;
+  template <typename Value>
+  struct LogEmptyFn {
+    void MakeEmpty(std::pair<LogKey, Value>& item) const {
+      item.first.obj = nullptr;
+    }
+    bool IsEmpty(const std::pair<LogKey, Value>& item) const {
+      return item.first.obj == nullptr;
+    }
+  };
 
-   private:
-    void UndoArrayWrite(mirror::Array* array,
-                        Primitive::Type array_type,
-                        size_t index,
-                        uint64_t value) const REQUIRES_SHARED(Locks::mutator_lock_);
+  enum FieldValueKind {
+    kBoolean,
+    kByte,
+    kChar,
+    kShort,
+    k32Bits,
+    k64Bits,
+    kReference
+  };
 
-    // Maps index to value.
+  struct FieldValue {
     // TODO use JValue instead ?
-    std::map<size_t, uint64_t> array_values_;
-
-    DISALLOW_COPY_AND_ASSIGN(ArrayLog);
+    uint64_t value = 0u;
+    FieldValueKind kind = kBoolean;
+    bool is_volatile = false;
   };
 
+  // Maps a modified field to its value before the first write in this transaction.
+  using FieldLogs = ScopedArenaHashMap<LogKey, FieldValue, LogEmptyFn<FieldValue>, LogKeyHash>;
+  // Maps a modified primitive array element to its value before the first write.
+  // TODO use JValue instead ?
+  using ArrayLogs = ScopedArenaHashMap<LogKey, uint64_t, LogEmptyFn<uint64_t>, LogKeyHash>;
+
   class InternStringLog : public ValueObject {
    public:
     enum StringKind {
@@ -269,6 +243,8 @@ class Transaction final {
 
     void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
 
+    ResolveStringLog(ResolveStringLog&& log) = default;
+
    private:
     GcRoot<mirror::DexCache> dex_cache_;
     const dex::StringIndex string_idx_;
@@ -276,6 +252,13 @@ class Transaction final {
     DISALLOW_COPY_AND_ASSIGN(ResolveStringLog);
   };
 
+  void LogFieldValue(mirror::Object* obj,
+                     MemberOffset field_offset,
+                     FieldValueKind kind,
+                     uint64_t value,
+                     bool is_volatile)
+      REQUIRES(!log_lock_);
+
   void LogInternedString(InternStringLog&& log)
       REQUIRES(Locks::intern_table_lock_)
       REQUIRES(!log_lock_);
@@ -294,6 +277,21 @@ class Transaction final {
       REQUIRES(log_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  static void UndoFieldWrite(mirror::Object* obj,
+                             MemberOffset field_offset,
+                             const FieldValue& field_value)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  static void UndoArrayWrite(mirror::Array* array,
+                             Primitive::Type array_type,
+                             size_t index,
+                             uint64_t value)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Visit the objects used as keys of `logs` and re-insert the entries of moved objects.
+  template <typename Logs>
+  static void VisitLogKeys(Logs* logs, RootVisitor* visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void VisitObjectLogs(RootVisitor* visitor)
       REQUIRES(log_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -310,10 +308,15 @@ class Transaction final {
   const std::string& GetAbortMessage() REQUIRES(!log_lock_);
 
   Mutex log_lock_ ACQUIRED_AFTER(Locks::intern_table_lock_);
-  std::map<mirror::Object*, ObjectLog> object_logs_ GUARDED_BY(log_lock_);
-  std::map<mirror::Array*, ArrayLog> array_logs_  GUARDED_BY(log_lock_);
-  std::list<InternStringLog> intern_string_logs_ GUARDED_BY(log_lock_);
-  std::list<ResolveStringLog> resolve_string_logs_ GUARDED_BY(log_lock_);
+  // The logs are allocated from the transaction's own arena, released all at once when the
+  // transaction is committed or rolled back.
+  ArenaStack arena_stack_ GUARDED_BY(log_lock_);
+  ScopedArenaAllocator allocator_ GUARDED_BY(log_lock_);
+  FieldLogs object_logs_ GUARDED_BY(log_lock_);
+  ArrayLogs array_logs_ GUARDED_BY(log_lock_);
+  // In the order of recording; undone from the most recent to the oldest.
+  ScopedArenaVector<InternStringLog> intern_string_logs_ GUARDED_BY(log_lock_);
+  ScopedArenaVector<ResolveStringLog> resolve_string_logs_ GUARDED_BY(log_lock_);
   bool aborted_ GUARDED_BY(log_lock_);
   bool rolling_back_;  // Single thread, no race.
   gc::Heap* const heap_;
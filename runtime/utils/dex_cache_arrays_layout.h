@@ -65,8 +65,6 @@ class DexCacheArraysLayout {
     return types_offset_;
   }
 
-  size_t TypeOffset(dex::TypeIndex type_idx) const;
-
   size_t TypesSize(size_t num_elements) const;
 
   size_t TypesAlignment() const;
@@ -85,8 +83,6 @@ class DexCacheArraysLayout {
     return strings_offset_;
   }
 
-  size_t StringOffset(uint32_t string_idx) const;
-
   size_t StringsSize(size_t num_elements) const;
 
   size_t StringsAlignment() const;
@@ -95,8 +91,6 @@ class DexCacheArraysLayout {
     return fields_offset_;
   }
 
-  size_t FieldOffset(uint32_t field_idx) const;
-
   size_t FieldsSize(size_t num_elements) const;
 
   size_t FieldsAlignment() const;
@@ -18,15 +18,18 @@
 
 #include <cstring>
 #include <sstream>
+#include <unordered_map>
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/indenter.h"
 #include "base/leb128.h"
 #include "base/mutex-inl.h"
+#include "class_linker.h"
 #include "compiler_callbacks.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/dex_file-inl.h"
+#include "handle_scope-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "oat_file.h"
@@ -714,6 +717,29 @@ static inline void DecodeStringVector(const uint8_t** in,
   }
 }
 
+// Skip helpers for reading only part of the encoded data in place, without decoding the
+// skipped entries into containers.
+static inline void SkipStringVector(const uint8_t** in, const uint8_t* end) {
+  size_t num_strings = DecodeUint32WithOverflowCheck(in, end);
+  for (size_t i = 0; i < num_strings; ++i) {
+    CHECK_LT(*in, end);
+    const void* nul = memchr(*in, 0, end - *in);
+    CHECK(nul != nullptr);
+    *in = reinterpret_cast<const uint8_t*>(nul) + 1;
+  }
+}
+
+static inline void SkipSet(const uint8_t** in, const uint8_t* end, size_t tuple_size) {
+  size_t num_entries = DecodeUint32WithOverflowCheck(in, end);
+  for (size_t i = 0, num_values = num_entries * tuple_size; i < num_values; ++i) {
+    DecodeUint32WithOverflowCheck(in, end);
+  }
+}
+
+static inline void SkipUint16SparseBitVector(const uint8_t** in, const uint8_t* end) {
+  SkipSet(in, end, /* tuple_size= */ 1u);
+}
+
 static inline std::string ToHex(uint32_t value) {
   std::stringstream ss;
   ss << std::hex << value << std::dec;
@@ -783,13 +809,26 @@ std::vector<std::vector<bool>> VerifierDeps::ParseVerifiedClasses(
   std::vector<std::vector<bool>> verified_classes_per_dex;
   verified_classes_per_dex.reserve(dex_files.size());
 
+  // Read the data in place and skip everything but the verified classes, so that loading
+  // a vdex file does not build the sets of dependencies only to discard them.
   const uint8_t* data_start = data.data();
   const uint8_t* data_end = data_start + data.size();
   for (const DexFile* dex_file : dex_files) {
-    DexFileDeps deps(dex_file->NumClassDefs());
-    DecodeDexFileDeps(deps, &data_start, data_end);
-    verified_classes_per_dex.push_back(std::move(deps.verified_classes_));
+    SkipStringVector(&data_start, data_end);
+    SkipSet(&data_start, data_end, std::tuple_size<TypeAssignabilityBase>::value);
+    SkipSet(&data_start, data_end, std::tuple_size<TypeAssignabilityBase>::value);
+    SkipSet(&data_start, data_end, std::tuple_size<ClassResolutionBase>::value);
+    SkipSet(&data_start, data_end, std::tuple_size<FieldResolutionBase>::value);
+    SkipSet(&data_start, data_end, std::tuple_size<MethodResolutionBase>::value);
+    std::vector<bool> verified_classes(dex_file->NumClassDefs());
+    DecodeUint16SparseBitVector(&data_start,
+                                data_end,
+                                &verified_classes,
+                                /* sparse_value= */ false);
+    SkipUint16SparseBitVector(&data_start, data_end);
+    verified_classes_per_dex.push_back(std::move(verified_classes));
   }
+  CHECK_LE(data_start, data_end);
   return verified_classes_per_dex;
 }
 
@@ -926,18 +965,6 @@ void VerifierDeps::Dump(VariableIndentationOutputStream* vios) const {
   }
 }
 
-bool VerifierDeps::ValidateDependencies(Thread* self,
-                                        Handle<mirror::ClassLoader> class_loader,
-                                        const std::vector<const DexFile*>& classpath,
-                                        /* out */ std::string* error_msg) const {
-  for (const auto& entry : dex_deps_) {
-    if (!VerifyDexFile(class_loader, *entry.first, *entry.second, classpath, self, error_msg)) {
-      return false;
-    }
-  }
-  return true;
-}
-
 // TODO: share that helper with other parts of the compiler that have
 // the same lookup pattern.
 static ObjPtr<mirror::Class> FindClassAndClearException(ClassLinker* class_linker,
@@ -953,24 +980,62 @@ static ObjPtr<mirror::Class> FindClassAndClearException(ClassLinker* class_linke
   return result;
 }
 
-bool VerifierDeps::VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
+// Resolves each descriptor through the class loader only once per validation. The same
+// classes, boot classpath classes in particular, are recorded many times across the
+// assignability, class, field and method dependencies of all the dex files.
+class VerifierDeps::ClassCache {
+ public:
+  ClassCache(Thread* self, Handle<mirror::ClassLoader> class_loader)
+      : self_(self), class_loader_(class_loader), handles_(self), classes_() {}
+
+  // Returns null if the class cannot be resolved.
+  ObjPtr<mirror::Class> FindClass(const std::string& descriptor)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    auto it = classes_.find(descriptor);
+    if (it == classes_.end()) {
+      ObjPtr<mirror::Class> klass = FindClassAndClearException(
+          Runtime::Current()->GetClassLinker(), self_, descriptor, class_loader_);
+      it = classes_.emplace(descriptor, handles_.NewHandle(klass)).first;
+    }
+    return it->second.Get();
+  }
+
+ private:
+  Thread* const self_;
+  const Handle<mirror::ClassLoader> class_loader_;
+  // Keeps the classes live and updated across suspend points in FindClass().
+  VariableSizedHandleScope handles_;
+  std::unordered_map<std::string, Handle<mirror::Class>> classes_;
+};
+
+bool VerifierDeps::ValidateDependencies(Thread* self,
+                                        Handle<mirror::ClassLoader> class_loader,
+                                        const std::vector<const DexFile*>& classpath,
+                                        /* out */ std::string* error_msg) const {
+  ClassCache class_cache(self, class_loader);
+  for (const auto& entry : dex_deps_) {
+    if (!VerifyDexFile(&class_cache, *entry.first, *entry.second, classpath, self, error_msg)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool VerifierDeps::VerifyAssignability(ClassCache* class_cache,
                                        const DexFile& dex_file,
                                        const std::set<TypeAssignability>& assignables,
                                        bool expected_assignability,
                                        Thread* self,
                                        /* out */ std::string* error_msg) const {
   StackHandleScope<2> hs(self);
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   MutableHandle<mirror::Class> source(hs.NewHandle<mirror::Class>(nullptr));
   MutableHandle<mirror::Class> destination(hs.NewHandle<mirror::Class>(nullptr));
 
   for (const auto& entry : assignables) {
     const std::string& destination_desc = GetStringFromId(dex_file, entry.GetDestination());
-    destination.Assign(
-        FindClassAndClearException(class_linker, self, destination_desc.c_str(), class_loader));
+    destination.Assign(class_cache->FindClass(destination_desc));
     const std::string& source_desc = GetStringFromId(dex_file, entry.GetSource());
-    source.Assign(
-        FindClassAndClearException(class_linker, self, source_desc.c_str(), class_loader));
+    source.Assign(class_cache->FindClass(source_desc));
 
     if (destination == nullptr) {
       *error_msg = "Could not resolve class " + destination_desc;
@@ -992,17 +1057,16 @@ bool VerifierDeps::VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
   return true;
 }
 
-bool VerifierDeps::VerifyClasses(Handle<mirror::ClassLoader> class_loader,
+bool VerifierDeps::VerifyClasses(ClassCache* class_cache,
                                  const DexFile& dex_file,
                                  const std::set<ClassResolution>& classes,
                                  Thread* self,
                                  /* out */ std::string* error_msg) const {
   StackHandleScope<1> hs(self);
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   MutableHandle<mirror::Class> cls(hs.NewHandle<mirror::Class>(nullptr));
   for (const auto& entry : classes) {
     std::string descriptor = dex_file.StringByTypeIdx(entry.GetDexTypeIndex());
-    cls.Assign(FindClassAndClearException(class_linker, self, descriptor, class_loader));
+    cls.Assign(class_cache->FindClass(descriptor));
 
     if (entry.IsResolved()) {
       if (cls == nullptr) {
@@ -1031,14 +1095,13 @@ static std::string GetFieldDescription(const DexFile& dex_file, uint32_t index)
       + dex_file.GetFieldTypeDescriptor(field_id);
 }
 
-bool VerifierDeps::VerifyFields(Handle<mirror::ClassLoader> class_loader,
+bool VerifierDeps::VerifyFields(ClassCache* class_cache,
                                 const DexFile& dex_file,
                                 const std::set<FieldResolution>& fields,
                                 Thread* self,
                                 /* out */ std::string* error_msg) const {
   // Check recorded fields are resolved the same way, have the same recorded class,
   // and have the same recorded flags.
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   for (const auto& entry : fields) {
     const dex::FieldId& field_id = dex_file.GetFieldId(entry.GetDexFieldIndex());
     std::string_view name(dex_file.StringDataByIdx(field_id.name_idx_));
@@ -1049,8 +1112,7 @@ bool VerifierDeps::VerifyFields(Handle<mirror::ClassLoader> class_loader,
     std::string expected_decl_klass = entry.IsResolved()
         ? GetStringFromId(dex_file, entry.GetDeclaringClassIndex())
         : dex_file.StringByTypeIdx(field_id.class_idx_);
-    ObjPtr<mirror::Class> cls = FindClassAndClearException(
-        class_linker, self, expected_decl_klass.c_str(), class_loader);
+    ObjPtr<mirror::Class> cls = class_cache->FindClass(expected_decl_klass);
     if (cls == nullptr) {
       *error_msg = "Could not resolve class " + expected_decl_klass;
       return false;
@@ -1094,10 +1156,9 @@ static std::string GetMethodDescription(const DexFile& dex_file, uint32_t index)
       + dex_file.GetMethodSignature(method_id).ToString();
 }
 
-bool VerifierDeps::VerifyMethods(Handle<mirror::ClassLoader> class_loader,
+bool VerifierDeps::VerifyMethods(ClassCache* class_cache,
                                  const DexFile& dex_file,
                                  const std::set<MethodResolution>& methods,
-                                 Thread* self,
                                  /* out */ std::string* error_msg) const {
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   PointerSize pointer_size = class_linker->GetImagePointerSize();
@@ -1113,8 +1174,7 @@ bool VerifierDeps::VerifyMethods(Handle<mirror::ClassLoader> class_loader,
         ? GetStringFromId(dex_file, entry.GetDeclaringClassIndex())
         : dex_file.StringByTypeIdx(method_id.class_idx_);
 
-    ObjPtr<mirror::Class> cls = FindClassAndClearException(
-        class_linker, self, expected_decl_klass.c_str(), class_loader);
+    ObjPtr<mirror::Class> cls = class_cache->FindClass(expected_decl_klass);
     if (cls == nullptr) {
       *error_msg = "Could not resolve class " + expected_decl_klass;
       return false;
@@ -1208,7 +1268,7 @@ bool VerifierDeps::VerifyInternalClasses(const DexFile& dex_file,
   return true;
 }
 
-bool VerifierDeps::VerifyDexFile(Handle<mirror::ClassLoader> class_loader,
+bool VerifierDeps::VerifyDexFile(ClassCache* class_cache,
                                  const DexFile& dex_file,
                                  const DexFileDeps& deps,
                                  const std::vector<const DexFile*>& classpath,
@@ -1219,21 +1279,21 @@ bool VerifierDeps::VerifyDexFile(Handle<mirror::ClassLoader> class_loader,
                                deps.verified_classes_,
                                deps.redefined_classes_,
                                error_msg) &&
-         VerifyAssignability(class_loader,
+         VerifyAssignability(class_cache,
                              dex_file,
                              deps.assignable_types_,
                              /* expected_assignability= */ true,
                              self,
                              error_msg) &&
-         VerifyAssignability(class_loader,
+         VerifyAssignability(class_cache,
                              dex_file,
                              deps.unassignable_types_,
                              /* expected_assignability= */ false,
                              self,
                              error_msg) &&
-         VerifyClasses(class_loader, dex_file, deps.classes_, self, error_msg) &&
-         VerifyFields(class_loader, dex_file, deps.fields_, self, error_msg) &&
-         VerifyMethods(class_loader, dex_file, deps.methods_, self, error_msg);
+         VerifyClasses(class_cache, dex_file, deps.classes_, self, error_msg) &&
+         VerifyFields(class_cache, dex_file, deps.fields_, self, error_msg) &&
+         VerifyMethods(class_cache, dex_file, deps.methods_, error_msg);
 }
 
 }  // namespace verifier
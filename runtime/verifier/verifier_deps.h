@@ -154,6 +154,9 @@ class VerifierDeps {
  private:
   static constexpr uint16_t kUnresolvedMarker = static_cast<uint16_t>(-1);
 
+  // Caches class lookups across the checks of one ValidateDependencies() call.
+  class ClassCache;
+
   using ClassResolutionBase = std::tuple<dex::TypeIndex, uint16_t>;
   struct ClassResolution : public ClassResolutionBase {
     ClassResolution() = default;
@@ -326,7 +329,7 @@ class VerifierDeps {
   // Verify `dex_file` according to the `deps`, that is going over each
   // `DexFileDeps` field, and checking that the recorded information still
   // holds.
-  bool VerifyDexFile(Handle<mirror::ClassLoader> class_loader,
+  bool VerifyDexFile(ClassCache* class_cache,
                      const DexFile& dex_file,
                      const DexFileDeps& deps,
                      const std::vector<const DexFile*>& classpath,
@@ -355,7 +358,7 @@ class VerifierDeps {
                              /* out */ std::string* error_msg) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  bool VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
+  bool VerifyAssignability(ClassCache* class_cache,
                            const DexFile& dex_file,
                            const std::set<TypeAssignability>& assignables,
                            bool expected_assignability,
@@ -365,7 +368,7 @@ class VerifierDeps {
 
   // Verify that the set of resolved classes at the point of creation
   // of this `VerifierDeps` is still the same.
-  bool VerifyClasses(Handle<mirror::ClassLoader> class_loader,
+  bool VerifyClasses(ClassCache* class_cache,
                      const DexFile& dex_file,
                      const std::set<ClassResolution>& classes,
                      Thread* self,
@@ -375,7 +378,7 @@ class VerifierDeps {
   // Verify that the set of resolved fields at the point of creation
   // of this `VerifierDeps` is still the same, and each field resolves to the
   // same field holder and access flags.
-  bool VerifyFields(Handle<mirror::ClassLoader> class_loader,
+  bool VerifyFields(ClassCache* class_cache,
                     const DexFile& dex_file,
                     const std::set<FieldResolution>& classes,
                     Thread* self,
@@ -386,10 +389,9 @@ class VerifierDeps {
   // Verify that the set of resolved methods at the point of creation
   // of this `VerifierDeps` is still the same, and each method resolves to the
   // same method holder, access flags, and invocation kind.
-  bool VerifyMethods(Handle<mirror::ClassLoader> class_loader,
+  bool VerifyMethods(ClassCache* class_cache,
                      const DexFile& dex_file,
                      const std::set<MethodResolution>& methods,
-                     Thread* self,
                      /* out */ std::string* error_msg) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -325,6 +325,11 @@ uint32_t WellKnownClasses::StringInitToEntryPoint(ArtMethod* string_init) {
 #undef STRING_INIT_LIST
 
 void WellKnownClasses::Init(JNIEnv* env) {
+  InitClassesOnly(env);
+  InitFieldsAndMethodsOnly(env);
+}
+
+void WellKnownClasses::InitClassesOnly(JNIEnv* env) {
   hiddenapi::ScopedHiddenApiEnforcementPolicySetting hiddenapi_exemption(
       hiddenapi::EnforcementPolicy::kDisabled);
 
@@ -373,8 +378,6 @@ void WellKnownClasses::Init(JNIEnv* env) {
   libcore_util_EmptyArray = CacheClass(env, "libcore/util/EmptyArray");
   org_apache_harmony_dalvik_ddmc_Chunk = CacheClass(env, "org/apache/harmony/dalvik/ddmc/Chunk");
   org_apache_harmony_dalvik_ddmc_DdmServer = CacheClass(env, "org/apache/harmony/dalvik/ddmc/DdmServer");
-
-  InitFieldsAndMethodsOnly(env);
 }
 
 void WellKnownClasses::InitFieldsAndMethodsOnly(JNIEnv* env) {
@@ -35,6 +35,10 @@ struct WellKnownClasses {
  public:
   // Run before native methods are registered.
   static void Init(JNIEnv* env);
+  // The two steps of Init(). Looking up the classes does not initialize them, so it can
+  // run on another thread while native methods are being registered.
+  static void InitClassesOnly(JNIEnv* env);
+  static void InitFieldsAndMethodsOnly(JNIEnv* env);
   // Run after native methods are registered.
   static void LateInit(JNIEnv* env);
 
@@ -50,10 +54,6 @@ struct WellKnownClasses {
 
   static ObjPtr<mirror::Class> ToClass(jclass global_jclass) REQUIRES_SHARED(Locks::mutator_lock_);
 
- private:
-  static void InitFieldsAndMethodsOnly(JNIEnv* env);
-
- public:
   static jclass dalvik_annotation_optimization_CriticalNative;
   static jclass dalvik_annotation_optimization_FastNative;
   static jclass dalvik_system_BaseDexClassLoader;
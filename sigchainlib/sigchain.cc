@@ -164,19 +164,6 @@ static void SetHandlingSignal(bool value) {
                       reinterpret_cast<void*>(static_cast<uintptr_t>(value)));
 }
 
-class ScopedHandlingSignal {
- public:
-  ScopedHandlingSignal() : original_value_(GetHandlingSignal()) {
-  }
-
-  ~ScopedHandlingSignal() {
-    SetHandlingSignal(original_value_);
-  }
-
- private:
-  bool original_value_;
-};
-
 class SignalChain {
  public:
   SignalChain() : claimed_(false) {
@@ -305,19 +292,27 @@ void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
       // Avoid setting the thread local flag in this case, since we'll never
       // get a chance to restore it.
       bool handler_noreturn = (handler.sc_flags & SIGCHAIN_ALLOW_NORETURN);
-      sigset_t previous_mask;
-      linked_sigprocmask(SIG_SETMASK, &handler.sc_mask, &previous_mask);
 
-      ScopedHandlingSignal restorer;
+      // There is no need to save and restore the previous mask. If the handler claims the
+      // signal, the kernel restores the mask from the ucontext on return; otherwise the next
+      // special handler or the forwarding below installs its own mask.
+      linked_sigprocmask(SIG_SETMASK, &handler.sc_mask, nullptr);
+
+      // We only get here if we weren't already handling a signal, so the previous value of
+      // the thread local flag is known to be false.
       if (!handler_noreturn) {
         SetHandlingSignal(true);
       }
 
-      if (handler.sc_sigaction(signo, siginfo, ucontext_raw)) {
-        return;
+      bool handled = handler.sc_sigaction(signo, siginfo, ucontext_raw);
+
+      if (!handler_noreturn) {
+        SetHandlingSignal(false);
       }
 
-      linked_sigprocmask(SIG_SETMASK, &previous_mask, nullptr);
+      if (handled) {
+        return;
+      }
     }
   }
 
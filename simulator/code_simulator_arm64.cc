@@ -60,6 +60,13 @@ void CodeSimulatorArm64::RunFrom(intptr_t code_buffer) {
   simulator_->RunFrom(reinterpret_cast<const Instruction*>(code_buffer));
 }
 
+void CodeSimulatorArm64::SetVectorLengthInBits(size_t vector_length) {
+  DCHECK(kCanSimulate);
+  DCHECK_EQ(vector_length % kZRegMinSize, 0u);
+  DCHECK_LE(vector_length, static_cast<size_t>(kZRegMaxSize));
+  simulator_->SetVectorLengthInBits(vector_length);
+}
+
 bool CodeSimulatorArm64::GetCReturnBool() const {
   DCHECK(kCanSimulate);
   return simulator_->ReadWRegister(0);
@@ -38,6 +38,8 @@ class CodeSimulatorArm64 : public CodeSimulator {
 
   void RunFrom(intptr_t code_buffer) override;
 
+  void SetVectorLengthInBits(size_t vector_length) override;
+
   bool GetCReturnBool() const override;
   int32_t GetCReturnInt32() const override;
   int64_t GetCReturnInt64() const override;
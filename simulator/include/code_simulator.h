@@ -30,6 +30,9 @@ class CodeSimulator {
 
   virtual void RunFrom(intptr_t code_buffer) = 0;
 
+  // Set the length of the scalable vector registers (e.g. ARM64 SVE), in bits.
+  virtual void SetVectorLengthInBits(size_t vector_length) = 0;
+
   // Get return value according to C ABI.
   virtual bool GetCReturnBool() const = 0;
   virtual int32_t GetCReturnInt32() const = 0;
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Arrays;
+
+public class Main {
+
+  /// CHECK-START: int Main.$noinline$hashInts(int[]) builder (after)
+  /// CHECK: InvokeStaticOrDirect intrinsic:ArraysHashCodeInt
+  static int $noinline$hashInts(int[] a) {
+    return Arrays.hashCode(a);
+  }
+
+  /// CHECK-START: int Main.$noinline$hashBytes(byte[]) builder (after)
+  /// CHECK: InvokeStaticOrDirect intrinsic:ArraysHashCodeByte
+  static int $noinline$hashBytes(byte[] a) {
+    return Arrays.hashCode(a);
+  }
+
+  /// CHECK-START: boolean Main.$noinline$equalsInts(int[], int[]) builder (after)
+  /// CHECK: InvokeStaticOrDirect intrinsic:ArraysEqualsInt
+  static boolean $noinline$equalsInts(int[] a, int[] b) {
+    return Arrays.equals(a, b);
+  }
+
+  /// CHECK-START: boolean Main.$noinline$equalsBytes(byte[], byte[]) builder (after)
+  /// CHECK: InvokeStaticOrDirect intrinsic:ArraysEqualsByte
+  static boolean $noinline$equalsBytes(byte[] a, byte[] b) {
+    return Arrays.equals(a, b);
+  }
+
+  /// CHECK-START: void Main.$noinline$fillInts(int[], int) builder (after)
+  /// CHECK: InvokeStaticOrDirect intrinsic:ArraysFillInt
+  static void $noinline$fillInts(int[] a, int value) {
+    Arrays.fill(a, value);
+  }
+
+  /// CHECK-START: int Main.$noinline$hashString(java.lang.String) builder (after)
+  /// CHECK: InvokeVirtual intrinsic:StringHashCode
+  static int $noinline$hashString(String s) {
+    return s.hashCode();
+  }
+
+  static int referenceHash(int[] a) {
+    int h = 1;
+    for (int x : a) {
+      h = 31 * h + x;
+    }
+    return h;
+  }
+
+  static int referenceHash(byte[] a) {
+    int h = 1;
+    for (byte x : a) {
+      h = 31 * h + x;
+    }
+    return h;
+  }
+
+  static int referenceHash(String s) {
+    int h = 0;
+    for (int i = 0; i < s.length(); ++i) {
+      h = 31 * h + s.charAt(i);
+    }
+    return h;
+  }
+
+  // Lengths around the vector widths and the tails of the different kernels.
+  static final int[] LENGTHS = { 0, 1, 2, 3, 4, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100 };
+
+  static void testInts() {
+    expectEquals(0, $noinline$hashInts(null));
+    expectTrue($noinline$equalsInts(null, null));
+    expectFalse($noinline$equalsInts(new int[0], null));
+    expectFalse($noinline$equalsInts(null, new int[0]));
+    expectFalse($noinline$equalsInts(new int[1], new int[2]));
+    for (int length : LENGTHS) {
+      int[] a = new int[length];
+      $noinline$fillInts(a, 0x12345678);
+      for (int i = 0; i < length; ++i) {
+        expectEquals(0x12345678, a[i]);
+      }
+      for (int i = 0; i < length; ++i) {
+        a[i] = i * 0x9e3779b9 - 7;
+      }
+      expectEquals(referenceHash(a), $noinline$hashInts(a));
+      int[] b = a.clone();
+      expectTrue($noinline$equalsInts(a, a));
+      expectTrue($noinline$equalsInts(a, b));
+      for (int i = 0; i < length; ++i) {
+        b[i] ^= 0x80000000;
+        expectFalse($noinline$equalsInts(a, b));
+        b[i] = a[i];
+      }
+    }
+    try {
+      $noinline$fillInts(null, 0);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+      // Expected.
+    }
+  }
+
+  static void testBytes() {
+    expectEquals(0, $noinline$hashBytes(null));
+    expectTrue($noinline$equalsBytes(null, null));
+    expectFalse($noinline$equalsBytes(new byte[0], null));
+    expectFalse($noinline$equalsBytes(new byte[3], new byte[4]));
+    for (int length : LENGTHS) {
+      byte[] a = new byte[length];
+      for (int i = 0; i < length; ++i) {
+        a[i] = (byte) (i * 37 + 100);  // Includes negative values.
+      }
+      expectEquals(referenceHash(a), $noinline$hashBytes(a));
+      byte[] b = a.clone();
+      expectTrue($noinline$equalsBytes(a, b));
+      for (int i = 0; i < length; ++i) {
+        b[i] ^= 1;
+        expectFalse($noinline$equalsBytes(a, b));
+        b[i] = a[i];
+      }
+    }
+  }
+
+  static void testStrings() {
+    for (int length : LENGTHS) {
+      StringBuilder compressible = new StringBuilder();
+      StringBuilder uncompressible = new StringBuilder();
+      for (int i = 0; i < length; ++i) {
+        compressible.append((char) ('a' + i % 26));
+        uncompressible.append((char) (0x3b1 + i * 7919 % 0xc000));
+      }
+      String s1 = compressible.toString();
+      String s2 = uncompressible.toString();
+      expectEquals(referenceHash(s1), $noinline$hashString(s1));
+      expectEquals(referenceHash(s2), $noinline$hashString(s2));
+      // Second calls use the cached hash.
+      expectEquals(referenceHash(s1), $noinline$hashString(s1));
+      expectEquals(referenceHash(s2), $noinline$hashString(s2));
+    }
+  }
+
+  public static void main(String[] args) {
+    testInts();
+    testBytes();
+    testStrings();
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectTrue(boolean result) {
+    if (!result) {
+      throw new Error("Expected true");
+    }
+  }
+
+  private static void expectFalse(boolean result) {
+    if (result) {
+      throw new Error("Expected false");
+    }
+  }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static int sValue;
+
+  int f1;
+  int f2;
+
+  /// CHECK-START: void Main.$noinline$threadLocalLock(int) monitor_elimination (before)
+  /// CHECK:     MonitorOperation kind:enter
+  /// CHECK:     MonitorOperation kind:exit
+
+  /// CHECK-START: void Main.$noinline$threadLocalLock(int) monitor_elimination (after)
+  /// CHECK-NOT: MonitorOperation
+
+  // No other thread can see `lock`, so it does not need to be locked.
+  static void $noinline$threadLocalLock(int value) {
+    Object lock = new Object();
+    synchronized (lock) {
+      sValue += value;
+    }
+  }
+
+  /// CHECK-START: void Main.$noinline$escapingLock(int) monitor_elimination (after)
+  /// CHECK:     MonitorOperation kind:enter
+  /// CHECK:     MonitorOperation kind:exit
+
+  static void $noinline$escapingLock(int value) {
+    Object lock = new Object();
+    sLock = lock;
+    synchronized (lock) {
+      sValue += value;
+    }
+  }
+
+  /// CHECK-START: void Main.$noinline$adjacentRegions(Main) monitor_elimination (before)
+  /// CHECK:     MonitorOperation kind:enter
+  /// CHECK:     MonitorOperation kind:enter
+
+  /// CHECK-START: void Main.$noinline$adjacentRegions(Main) monitor_elimination (after)
+  /// CHECK:     MonitorOperation kind:enter
+  /// CHECK-NOT: MonitorOperation kind:enter
+
+  // The two regions lock the same object back to back and are merged.
+  static void $noinline$adjacentRegions(Main m) {
+    synchronized (m) {
+      m.f1 = 1;
+    }
+    synchronized (m) {
+      m.f2 = 2;
+    }
+  }
+
+  /// CHECK-START: void Main.$noinline$separatedRegions(Main) monitor_elimination (after)
+  /// CHECK:     MonitorOperation kind:enter
+  /// CHECK:     MonitorOperation kind:enter
+
+  // The call between the regions must run without holding the monitor.
+  static void $noinline$separatedRegions(Main m) {
+    synchronized (m) {
+      m.f1 = 1;
+    }
+    $noinline$call();
+    synchronized (m) {
+      m.f2 = 2;
+    }
+  }
+
+  static void $noinline$call() {
+    sValue++;
+  }
+
+  static Object sLock;
+
+  public static void main(String[] args) {
+    sValue = 0;
+    $noinline$threadLocalLock(1);
+    $noinline$escapingLock(2);
+    expectEquals(3, sValue);
+
+    Main m = new Main();
+    $noinline$adjacentRegions(m);
+    expectEquals(1, m.f1);
+    expectEquals(2, m.f2);
+    m = new Main();
+    $noinline$separatedRegions(m);
+    expectEquals(1, m.f1);
+    expectEquals(2, m.f2);
+    expectEquals(4, sValue);
+
+    // The monitor must be free again after the merged region.
+    expectFalse(Thread.holdsLock(m));
+    try {
+      $noinline$adjacentRegions(null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+      // Expected.
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectFalse(boolean result) {
+    if (result) {
+      throw new Error("Expected false");
+    }
+  }
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.invoke.WrongMethodTypeException;
+import java.lang.reflect.InvocationTargetException;
+import java.lang.reflect.Method;
+
+public class Main {
+  public static void main(String[] args) throws Exception {
+    Class<?> c = Class.forName("ConstantMethodHandle");
+    assertEquals(42, call(c, "invokeExactAddOne", 41));
+    assertEquals(42, call(c, "invokeAddOne", 41));
+    assertEquals(42L, call(c, "invokeWithConversion", 41));
+    try {
+      call(c, "invokeExactWrongType", 41);
+      throw new Error("Expected WrongMethodTypeException");
+    } catch (InvocationTargetException e) {
+      if (!(e.getCause() instanceof WrongMethodTypeException)) {
+        throw new Error("Unexpected exception", e.getCause());
+      }
+    }
+    System.out.println("passed");
+  }
+
+  private static Object call(Class<?> c, String name, int arg) throws Exception {
+    Method m = c.getMethod(name, int.class);
+    return m.invoke(null, arg);
+  }
+
+  private static void assertEquals(Object expected, Object actual) {
+    if (!expected.equals(actual)) {
+      throw new Error("Expected: " + expected + ", found: " + actual);
+    }
+  }
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.VarHandle;
+
+public class Main {
+  static class Sub extends Main {}
+
+  int intField;
+  long longField;
+  double doubleField;
+  byte byteField;
+  static int staticIntField;
+  static final int staticFinalIntField = 42;
+
+  static final VarHandle INT_FIELD;
+  static final VarHandle LONG_FIELD;
+  static final VarHandle DOUBLE_FIELD;
+  static final VarHandle BYTE_FIELD;
+  static final VarHandle STATIC_INT_FIELD;
+  static final VarHandle STATIC_FINAL_INT_FIELD;
+
+  static {
+    try {
+      MethodHandles.Lookup lookup = MethodHandles.lookup();
+      INT_FIELD = lookup.findVarHandle(Main.class, "intField", int.class);
+      LONG_FIELD = lookup.findVarHandle(Main.class, "longField", long.class);
+      DOUBLE_FIELD = lookup.findVarHandle(Main.class, "doubleField", double.class);
+      BYTE_FIELD = lookup.findVarHandle(Main.class, "byteField", byte.class);
+      STATIC_INT_FIELD = lookup.findStaticVarHandle(Main.class, "staticIntField", int.class);
+      STATIC_FINAL_INT_FIELD =
+          lookup.findStaticVarHandle(Main.class, "staticFinalIntField", int.class);
+    } catch (Exception e) {
+      throw new Error(e);
+    }
+  }
+
+  /// CHECK-START: int Main.$noinline$getInt(Main) builder (after)
+  /// CHECK: InvokePolymorphic intrinsic:VarHandleGet
+  private static int $noinline$getInt(Main m) {
+    return (int) INT_FIELD.get(m);
+  }
+
+  /// CHECK-START: void Main.$noinline$setInt(Main, int) builder (after)
+  /// CHECK: InvokePolymorphic intrinsic:VarHandleSet
+  private static void $noinline$setInt(Main m, int value) {
+    INT_FIELD.set(m, value);
+  }
+
+  /// CHECK-START: long Main.$noinline$getLongVolatile(Main) builder (after)
+  /// CHECK: InvokePolymorphic intrinsic:VarHandleGetVolatile
+  private static long $noinline$getLongVolatile(Main m) {
+    return (long) LONG_FIELD.getVolatile(m);
+  }
+
+  /// CHECK-START: void Main.$noinline$setLongVolatile(Main, long) builder (after)
+  /// CHECK: InvokePolymorphic intrinsic:VarHandleSetVolatile
+  private static void $noinline$setLongVolatile(Main m, long value) {
+    LONG_FIELD.setVolatile(m, value);
+  }
+
+  private static double $noinline$getDoubleAcquire(Main m) {
+    return (double) DOUBLE_FIELD.getAcquire(m);
+  }
+
+  private static void $noinline$setDoubleRelease(Main m, double value) {
+    DOUBLE_FIELD.setRelease(m, value);
+  }
+
+  private static byte $noinline$getByteOpaque(Main m) {
+    return (byte) BYTE_FIELD.getOpaque(m);
+  }
+
+  private static void $noinline$setByteOpaque(Main m, byte value) {
+    BYTE_FIELD.setOpaque(m, value);
+  }
+
+  private static int $noinline$getStaticInt() {
+    return (int) STATIC_INT_FIELD.get();
+  }
+
+  private static void $noinline$setStaticInt(int value) {
+    STATIC_INT_FIELD.set(value);
+  }
+
+  // The call site type differs from the variable type, so the value needs a conversion.
+  private static long $noinline$getIntAsLong(Main m) {
+    return (long) INT_FIELD.get(m);
+  }
+
+  private static int $noinline$getStaticFinalInt() {
+    return (int) STATIC_FINAL_INT_FIELD.get();
+  }
+
+  private static void $noinline$setStaticFinalInt(int value) {
+    STATIC_FINAL_INT_FIELD.set(value);
+  }
+
+  public static void main(String[] args) {
+    Main m = new Main();
+    $noinline$setInt(m, 1);
+    assertEquals(1, m.intField);
+    assertEquals(1, $noinline$getInt(m));
+    $noinline$setLongVolatile(m, 1L << 40);
+    assertEquals(1L << 40, $noinline$getLongVolatile(m));
+    $noinline$setDoubleRelease(m, 2.5);
+    assertEquals(2.5, $noinline$getDoubleAcquire(m));
+    $noinline$setByteOpaque(m, (byte) -3);
+    assertEquals((byte) -3, $noinline$getByteOpaque(m));
+    $noinline$setStaticInt(5);
+    assertEquals(5, staticIntField);
+    assertEquals(5, $noinline$getStaticInt());
+    assertEquals(1L, $noinline$getIntAsLong(m));
+    assertEquals(42, $noinline$getStaticFinalInt());
+
+    // A receiver of a subclass of the coordinate type.
+    Sub sub = new Sub();
+    $noinline$setInt(sub, 7);
+    assertEquals(7, $noinline$getInt(sub));
+
+    try {
+      $noinline$getInt(null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    try {
+      $noinline$setStaticFinalInt(1);
+      throw new Error("Expected UnsupportedOperationException");
+    } catch (UnsupportedOperationException expected) {
+    }
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(long expected, long actual) {
+    if (expected != actual) {
+      throw new Error("Expected: " + expected + ", found: " + actual);
+    }
+  }
+
+  private static void assertEquals(double expected, double actual) {
+    if (expected != actual) {
+      throw new Error("Expected: " + expected + ", found: " + actual);
+    }
+  }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Base.<clinit> is trivial, so Base is initialized once any subclass started initializing.
+class Base {
+  static int sBaseValue = 1;
+}
+
+class Derived extends Base {
+  static int sDerivedValue;
+
+  static {
+    sDerivedValue = Main.$noinline$getValue();
+  }
+
+  static int $inline$getBaseValue() {
+    return Helper.$inline$getBaseValue();
+  }
+}
+
+class Helper {
+  static int sHelperValue;
+
+  static {
+    sHelperValue = Main.$noinline$getValue();
+  }
+
+  static int $inline$getBaseValue() {
+    return Base.sBaseValue + sHelperValue;
+  }
+}
+
+// Unrelated.<clinit> is not trivial, so a check of Derived says nothing about it.
+class Unrelated {
+  static int sUnrelatedValue;
+
+  static {
+    sUnrelatedValue = Main.$noinline$getValue();
+  }
+}
+
+public class Main {
+  /// CHECK-START: int Main.$noinline$subclassThenSuperclass() clinit_check_elimination$after_inlining (before)
+  /// CHECK:     ClinitCheck
+  /// CHECK:     ClinitCheck
+
+  /// CHECK-START: int Main.$noinline$subclassThenSuperclass() clinit_check_elimination$after_inlining (after)
+  /// CHECK:     ClinitCheck
+  /// CHECK-NOT: ClinitCheck
+
+  static int $noinline$subclassThenSuperclass() {
+    return Derived.sDerivedValue + Base.sBaseValue;
+  }
+
+  /// CHECK-START: int Main.$noinline$checkBeforeLoop(int) clinit_check_elimination$after_inlining (after)
+  /// CHECK:     ClinitCheck
+  /// CHECK-NOT: ClinitCheck
+
+  // The check of Base in the loop body is dominated by the check of Derived.
+  static int $noinline$checkBeforeLoop(int n) {
+    int sum = Derived.sDerivedValue;
+    for (int i = 0; i < n; ++i) {
+      sum += Base.sBaseValue;
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.$noinline$inlinedIntoSubclass() inliner (after)
+  /// CHECK-NOT: InvokeStaticOrDirect method_name:{{.*}}getBaseValue
+
+  /// CHECK-START: int Main.$noinline$inlinedIntoSubclass() clinit_check_elimination$after_inlining (before)
+  /// CHECK-DAG: <<Derived:l\d+>> LoadClass class_name:Derived
+  /// CHECK-DAG:                  ClinitCheck [<<Derived>>]
+  /// CHECK-DAG: <<Helper:l\d+>>  LoadClass class_name:Helper
+  /// CHECK-DAG:                  ClinitCheck [<<Helper>>]
+  /// CHECK-DAG: <<Base:l\d+>>    LoadClass class_name:Base
+  /// CHECK-DAG:                  ClinitCheck [<<Base>>]
+
+  /// CHECK-START: int Main.$noinline$inlinedIntoSubclass() clinit_check_elimination$after_inlining (after)
+  /// CHECK-DAG: <<Base:l\d+>>    LoadClass class_name:Base
+  /// CHECK-NOT:                  ClinitCheck [<<Base>>]
+
+  // Base.sBaseValue is read in Helper code inlined into a static method of Derived.
+  static int $noinline$inlinedIntoSubclass() {
+    return Derived.$inline$getBaseValue();
+  }
+
+  /// CHECK-START: int Main.$noinline$unrelatedClass() clinit_check_elimination$after_inlining (after)
+  /// CHECK:     ClinitCheck
+  /// CHECK:     ClinitCheck
+
+  static int $noinline$unrelatedClass() {
+    return Derived.sDerivedValue + Unrelated.sUnrelatedValue;
+  }
+
+  public static void main(String[] args) {
+    expectEquals(3, $noinline$subclassThenSuperclass());
+    expectEquals(5, $noinline$checkBeforeLoop(3));
+    expectEquals(3, $noinline$inlinedIntoSubclass());
+    expectEquals(4, $noinline$unrelatedClass());
+    System.out.println("passed");
+  }
+
+  static int $noinline$getValue() {
+    return 2;
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  /// CHECK-START: int Main.$noinline$divideUnsigned(int, int) builder (after)
+  /// CHECK:     InvokeStaticOrDirect intrinsic:IntegerDivideUnsigned
+
+  static int $noinline$divideUnsigned(int a, int b) {
+    return Integer.divideUnsigned(a, b);
+  }
+
+  /// CHECK-START: int Main.$noinline$remainderUnsigned(int, int) builder (after)
+  /// CHECK:     InvokeStaticOrDirect intrinsic:IntegerRemainderUnsigned
+
+  static int $noinline$remainderUnsigned(int a, int b) {
+    return Integer.remainderUnsigned(a, b);
+  }
+
+  /// CHECK-START: long Main.$noinline$divideUnsigned(long, long) builder (after)
+  /// CHECK:     InvokeStaticOrDirect intrinsic:LongDivideUnsigned
+
+  static long $noinline$divideUnsigned(long a, long b) {
+    return Long.divideUnsigned(a, b);
+  }
+
+  /// CHECK-START: long Main.$noinline$remainderUnsigned(long, long) builder (after)
+  /// CHECK:     InvokeStaticOrDirect intrinsic:LongRemainderUnsigned
+
+  static long $noinline$remainderUnsigned(long a, long b) {
+    return Long.remainderUnsigned(a, b);
+  }
+
+  /// CHECK-START: int Main.$noinline$divideUnsignedBy8(int) instruction_simplifier (after)
+  /// CHECK-DAG: <<Arg:i\d+>>   ParameterValue
+  /// CHECK-DAG: <<Const3:i\d+>> IntConstant 3
+  /// CHECK-DAG: <<UShr:i\d+>>  UShr [<<Arg>>,<<Const3>>]
+  /// CHECK-DAG:                Return [<<UShr>>]
+
+  /// CHECK-START: int Main.$noinline$divideUnsignedBy8(int) instruction_simplifier (after)
+  /// CHECK-NOT: InvokeStaticOrDirect
+
+  static int $noinline$divideUnsignedBy8(int a) {
+    return Integer.divideUnsigned(a, 8);
+  }
+
+  /// CHECK-START: int Main.$noinline$remainderUnsignedByMinValue(int) instruction_simplifier (after)
+  /// CHECK-DAG: <<Arg:i\d+>>   ParameterValue
+  /// CHECK-DAG: <<Mask:i\d+>>  IntConstant 2147483647
+  /// CHECK-DAG: <<And:i\d+>>   And [<<Arg>>,<<Mask>>]
+  /// CHECK-DAG:                Return [<<And>>]
+
+  /// CHECK-START: int Main.$noinline$remainderUnsignedByMinValue(int) instruction_simplifier (after)
+  /// CHECK-NOT: InvokeStaticOrDirect
+
+  static int $noinline$remainderUnsignedByMinValue(int a) {
+    return Integer.remainderUnsigned(a, Integer.MIN_VALUE);
+  }
+
+  /// CHECK-START: long Main.$noinline$divideUnsignedBy2To40(long) instruction_simplifier (after)
+  /// CHECK-DAG: <<Arg:j\d+>>    ParameterValue
+  /// CHECK-DAG: <<Const40:i\d+>> IntConstant 40
+  /// CHECK-DAG: <<UShr:j\d+>>   UShr [<<Arg>>,<<Const40>>]
+  /// CHECK-DAG:                 Return [<<UShr>>]
+
+  static long $noinline$divideUnsignedBy2To40(long a) {
+    return Long.divideUnsigned(a, 1L << 40);
+  }
+
+  /// CHECK-START: long Main.$noinline$remainderUnsignedBy16(long) instruction_simplifier (after)
+  /// CHECK-DAG: <<Arg:j\d+>>   ParameterValue
+  /// CHECK-DAG: <<Mask:j\d+>>  LongConstant 15
+  /// CHECK-DAG: <<And:j\d+>>   And [<<Arg>>,<<Mask>>]
+  /// CHECK-DAG:                Return [<<And>>]
+
+  static long $noinline$remainderUnsignedBy16(long a) {
+    return Long.remainderUnsigned(a, 16L);
+  }
+
+  /// CHECK-START: int Main.$noinline$divideUnsignedBy10(int) instruction_simplifier (after)
+  /// CHECK:     InvokeStaticOrDirect intrinsic:IntegerDivideUnsigned
+
+  static int $noinline$divideUnsignedBy10(int a) {
+    return Integer.divideUnsigned(a, 10);
+  }
+
+  public static void main(String[] args) {
+    expectEquals(0x7fffffff, $noinline$divideUnsigned(-1, 2));
+    expectEquals(1, $noinline$divideUnsigned(-1, -1));
+    expectEquals(0, $noinline$divideUnsigned(5, -1));
+    expectEquals(3, $noinline$divideUnsigned(10, 3));
+    expectEquals(1, $noinline$remainderUnsigned(-1, 2));
+    expectEquals(5, $noinline$remainderUnsigned(5, -1));
+    expectEquals(1, $noinline$remainderUnsigned(10, 3));
+
+    expectEquals(0x7fffffffffffffffL, $noinline$divideUnsigned(-1L, 2L));
+    expectEquals(1L, $noinline$divideUnsigned(-1L, -1L));
+    expectEquals(0L, $noinline$divideUnsigned(5L, -1L));
+    expectEquals(1L, $noinline$remainderUnsigned(-1L, 2L));
+    expectEquals(5L, $noinline$remainderUnsigned(5L, -1L));
+
+    expectEquals(0x1fffffff, $noinline$divideUnsignedBy8(-1));
+    expectEquals(0x7fffffff, $noinline$remainderUnsignedByMinValue(-1));
+    expectEquals(0, $noinline$remainderUnsignedByMinValue(Integer.MIN_VALUE));
+    expectEquals(0xffffffL, $noinline$divideUnsignedBy2To40(-1L));
+    expectEquals(15L, $noinline$remainderUnsignedBy16(-1L));
+    expectEquals(429496729, $noinline$divideUnsignedBy10(-1));
+
+    try {
+      $noinline$divideUnsigned(1, 0);
+      throw new Error("Expected ArithmeticException");
+    } catch (ArithmeticException expected) {
+    }
+    try {
+      $noinline$remainderUnsigned(1L, 0L);
+      throw new Error("Expected ArithmeticException");
+    } catch (ArithmeticException expected) {
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
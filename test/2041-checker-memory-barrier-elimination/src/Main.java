@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.invoke.VarHandle;
+
+public class Main {
+  static class Holder {
+    final int value;
+
+    Holder(int value) {
+      this.value = value;
+    }
+  }
+
+  int f1;
+  Holder holder;
+
+  /// CHECK-START: void Main.$noinline$fullFences() memory_barrier_elimination (before)
+  /// CHECK:     MemoryBarrier kind:AnyAny
+  /// CHECK:     MemoryBarrier kind:AnyAny
+
+  /// CHECK-START: void Main.$noinline$fullFences() memory_barrier_elimination (after)
+  /// CHECK:     MemoryBarrier kind:AnyAny
+  /// CHECK-NOT: MemoryBarrier
+
+  static void $noinline$fullFences() {
+    VarHandle.fullFence();
+    VarHandle.fullFence();
+  }
+
+  /// CHECK-START: void Main.$noinline$releaseAndStoreStoreFences() memory_barrier_elimination (before)
+  /// CHECK:     MemoryBarrier kind:AnyStore
+  /// CHECK:     MemoryBarrier kind:StoreStore
+
+  /// CHECK-START: void Main.$noinline$releaseAndStoreStoreFences() memory_barrier_elimination (after)
+  /// CHECK:     MemoryBarrier kind:AnyStore
+  /// CHECK-NOT: MemoryBarrier
+
+  // A release fence already orders stores with respect to later stores.
+  static void $noinline$releaseAndStoreStoreFences() {
+    VarHandle.releaseFence();
+    VarHandle.storeStoreFence();
+  }
+
+  /// CHECK-START-{ARM,ARM64}: void Main.$noinline$acquireAndReleaseFences() memory_barrier_elimination (after)
+  /// CHECK:     MemoryBarrier kind:AnyAny
+  /// CHECK-NOT: MemoryBarrier
+
+  /// CHECK-START-{X86,X86_64}: void Main.$noinline$acquireAndReleaseFences() memory_barrier_elimination (after)
+  /// CHECK:     MemoryBarrier kind:LoadAny
+  /// CHECK:     MemoryBarrier kind:AnyStore
+
+  // Only ARM and ARM64 combine two different barriers into a stronger one.
+  static void $noinline$acquireAndReleaseFences() {
+    VarHandle.acquireFence();
+    VarHandle.releaseFence();
+  }
+
+  /// CHECK-START: void Main.$noinline$constructorFenceAndReleaseFence(Main, int) memory_barrier_elimination (before)
+  /// CHECK:     ConstructorFence
+  /// CHECK:     MemoryBarrier kind:AnyStore
+
+  /// CHECK-START: void Main.$noinline$constructorFenceAndReleaseFence(Main, int) memory_barrier_elimination (after)
+  /// CHECK-NOT: ConstructorFence
+
+  /// CHECK-START: void Main.$noinline$constructorFenceAndReleaseFence(Main, int) memory_barrier_elimination (after)
+  /// CHECK:     MemoryBarrier kind:AnyStore
+  /// CHECK-NOT: MemoryBarrier
+
+  // The release fence orders the final field store before the publishing store.
+  static void $noinline$constructorFenceAndReleaseFence(Main m, int value) {
+    Holder h = new Holder(value);
+    VarHandle.releaseFence();
+    m.holder = h;
+  }
+
+  /// CHECK-START: void Main.$noinline$separatedFences(Main) memory_barrier_elimination (after)
+  /// CHECK:     MemoryBarrier kind:AnyAny
+  /// CHECK:     InstanceFieldSet
+  /// CHECK:     MemoryBarrier kind:AnyAny
+
+  // The store between the fences must stay ordered by both of them.
+  static void $noinline$separatedFences(Main m) {
+    VarHandle.fullFence();
+    m.f1 = 1;
+    VarHandle.fullFence();
+  }
+
+  public static void main(String[] args) {
+    $noinline$fullFences();
+    $noinline$releaseAndStoreStoreFences();
+    $noinline$acquireAndReleaseFences();
+
+    Main m = new Main();
+    $noinline$constructorFenceAndReleaseFence(m, 42);
+    expectEquals(42, m.holder.value);
+    $noinline$separatedFences(m);
+    expectEquals(1, m.f1);
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
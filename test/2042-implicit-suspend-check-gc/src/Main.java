@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static class Node {
+    final int value;
+
+    Node(int value) {
+      this.value = value;
+    }
+  }
+
+  static volatile boolean sStop;
+  static Object sGarbage;
+
+  // The nodes are live across the loop and, with no calls in it, are kept in registers,
+  // typically caller-save ones, over the implicit suspend check at the back edge. A moving
+  // GC during that check must update the registers.
+  static int $noinline$loop(Node a, Node b, Node c, Node d, int iterations) {
+    int sum = 0;
+    for (int i = 0; i != iterations; ++i) {
+      sum = (sum * 31) ^ i;
+    }
+    return (sum & 0x100) + a.value + b.value + c.value + d.value;
+  }
+
+  static Node $noinline$newNode(int value) {
+    // Surround the node with garbage so that its region is mostly dead and gets evacuated.
+    sGarbage = new int[64];
+    Node node = new Node(value);
+    sGarbage = new int[64];
+    return node;
+  }
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    ensureJitCompiled(Main.class, "$noinline$loop");
+
+    Thread gcThread = new Thread(() -> {
+      while (!sStop) {
+        Runtime.getRuntime().gc();
+      }
+    });
+    gcThread.start();
+    try {
+      for (int round = 0; round != 200; ++round) {
+        Node a = $noinline$newNode(1);
+        Node b = $noinline$newNode(2);
+        Node c = $noinline$newNode(4);
+        Node d = $noinline$newNode(8);
+        int result = $noinline$loop(a, b, c, d, 1_000_000) & 0xff;
+        if (result != 15) {
+          throw new Error("Expected: 15, found: " + result);
+        }
+      }
+    } finally {
+      sStop = true;
+      gcThread.join();
+    }
+    System.out.println("passed");
+  }
+
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
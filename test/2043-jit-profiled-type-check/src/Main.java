@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Base {
+}
+
+class Other implements Itf {
+}
+
+public class Main {
+  // Profiled with mostly Derived objects. The result has bit 0 set for a Base and bit 1 set
+  // for an Itf.
+  static int $noinline$kind(Object o) {
+    int kind = 0;
+    if (o instanceof Base) {
+      kind |= 1;
+    }
+    if (Helper.isItf(o)) {
+      kind |= 2;
+    }
+    return kind;
+  }
+
+  static Base $noinline$cast(Object o) {
+    try {
+      return (Base) o;
+    } catch (ClassCastException expected) {
+      return null;
+    }
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+
+    // Fill the type check profiles with Derived objects from baseline code.
+    ensureJitBaselineCompiled(Main.class, "$noinline$kind");
+    ensureJitBaselineCompiled(Main.class, "$noinline$cast");
+    Derived derived = new Derived();
+    for (int i = 0; i != 10000; ++i) {
+      expectEquals(3, $noinline$kind(derived));
+      expectSame(derived, $noinline$cast(derived));
+    }
+
+    // Use the profiles in optimized code.
+    ensureJitCompiled(Main.class, "$noinline$kind");
+    ensureJitCompiled(Main.class, "$noinline$cast");
+    expectEquals(3, $noinline$kind(derived));
+    expectEquals(1, $noinline$kind(new Base()));
+    expectEquals(2, $noinline$kind(new Other()));
+    expectEquals(0, $noinline$kind(new Object()));
+    expectEquals(0, $noinline$kind(null));
+    expectSame(derived, $noinline$cast(derived));
+    Base base = new Base();
+    expectSame(base, $noinline$cast(base));
+    expectSame(null, $noinline$cast(new Other()));
+    expectSame(null, $noinline$cast(new Object()));
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectSame(Object expected, Object result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
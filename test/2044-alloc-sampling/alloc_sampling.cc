@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <string>
+
+#include "android-base/macros.h"
+
+#include "jni.h"
+#include "jvmti.h"
+#include "scoped_local_ref.h"
+
+// Test infrastructure
+#include "jvmti_helper.h"
+#include "test_env.h"
+
+namespace art {
+namespace Test2044AllocSampling {
+
+using SetAllocationSamplingInterval = jvmtiError (*)(jvmtiEnv* env, jlong interval);
+using AllocationSampleCallback = void (*)(jlong class_tag,
+                                          jlong size,
+                                          jint frame_count,
+                                          const jvmtiFrameInfo* frames,
+                                          void* user_data);
+using DrainAllocationSamples = jvmtiError (*)(jvmtiEnv* env,
+                                              AllocationSampleCallback callback,
+                                              const void* user_data);
+
+template <typename T> static void Dealloc(T* t) {
+  jvmti_env->Deallocate(reinterpret_cast<unsigned char*>(t));
+}
+
+template <typename T, typename... Rest> static void Dealloc(T* t, Rest... rs) {
+  Dealloc(t);
+  Dealloc(rs...);
+}
+
+static void DeallocParams(jvmtiParamInfo* params, jint n_params) {
+  for (jint i = 0; i < n_params; i++) {
+    Dealloc(params[i].name);
+  }
+}
+
+static jvmtiExtensionFunction FindExtensionMethod(JNIEnv* env, const std::string& name) {
+  jint n_ext;
+  jvmtiExtensionFunctionInfo* infos;
+  if (JvmtiErrorToException(env, jvmti_env, jvmti_env->GetExtensionFunctions(&n_ext, &infos))) {
+    return nullptr;
+  }
+  jvmtiExtensionFunction res = nullptr;
+  for (jint i = 0; i < n_ext; i++) {
+    jvmtiExtensionFunctionInfo* cur_info = &infos[i];
+    if (strcmp(name.c_str(), cur_info->id) == 0) {
+      res = cur_info->func;
+    }
+    // Cleanup the cur_info
+    DeallocParams(cur_info->params, cur_info->param_count);
+    Dealloc(cur_info->id, cur_info->short_description, cur_info->params, cur_info->errors);
+  }
+  // Cleanup the array.
+  Dealloc(infos);
+  if (res == nullptr) {
+    ScopedLocalRef<jclass> rt_exception(env, env->FindClass("java/lang/RuntimeException"));
+    env->ThrowNew(rt_exception.get(), (name + " extensions not found").c_str());
+    return nullptr;
+  }
+  return res;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_art_Test2044_setAllocationSamplingInterval(
+    JNIEnv* env, jclass klass ATTRIBUTE_UNUSED, jlong interval) {
+  SetAllocationSamplingInterval set_interval = reinterpret_cast<SetAllocationSamplingInterval>(
+      FindExtensionMethod(env, "com.android.art.heap.set_allocation_sampling_interval"));
+  if (set_interval == nullptr) {
+    return;
+  }
+  JvmtiErrorToException(env, jvmti_env, set_interval(jvmti_env, interval));
+}
+
+struct SampleFilter {
+  jlong class_tag;
+  jlong min_size;
+  jmethodID method;
+  jint count;
+};
+
+extern "C" JNIEXPORT jint JNICALL Java_art_Test2044_drainSamples(JNIEnv* env,
+                                                                 jclass klass ATTRIBUTE_UNUSED,
+                                                                 jlong class_tag,
+                                                                 jlong min_size,
+                                                                 jobject method) {
+  DrainAllocationSamples drain_samples = reinterpret_cast<DrainAllocationSamples>(
+      FindExtensionMethod(env, "com.android.art.heap.drain_allocation_samples"));
+  if (drain_samples == nullptr) {
+    return -1;
+  }
+  SampleFilter filter = { class_tag, min_size, env->FromReflectedMethod(method), 0 };
+  auto callback = [](jlong sample_class_tag,
+                     jlong size,
+                     jint frame_count,
+                     const jvmtiFrameInfo* frames,
+                     void* user_data) {
+    SampleFilter* sample_filter = reinterpret_cast<SampleFilter*>(user_data);
+    if (sample_class_tag == sample_filter->class_tag &&
+        size >= sample_filter->min_size &&
+        frame_count > 0 &&
+        frames[0].method == sample_filter->method) {
+      ++sample_filter->count;
+    }
+  };
+  if (JvmtiErrorToException(env, jvmti_env, drain_samples(jvmti_env, callback, &filter))) {
+    return -1;
+  }
+  return filter.count;
+}
+
+}  // namespace Test2044AllocSampling
+}  // namespace art
@@ -0,0 +1 @@
+../../../jvmti-common/Main.java
\ No newline at end of file
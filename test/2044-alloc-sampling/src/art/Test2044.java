@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package art;
+
+import java.lang.reflect.Method;
+
+public class Test2044 {
+  private static final long INT_ARRAY_TAG = 2044;
+  // Large enough for the large object space, so that every array is allocated on the slow path
+  // of the allocator, where allocations are sampled.
+  private static final int ARRAY_LENGTH = 64 * 1024;
+  private static final int NUM_ARRAYS = 8;
+
+  public static void run() throws Exception {
+    Main.setTag(int[].class, INT_ARRAY_TAG);
+    Method allocate_arrays = Test2044.class.getDeclaredMethod("allocateArrays");
+    // Sample every allocation of the slow path.
+    setAllocationSamplingInterval(1);
+    try {
+      int[][] arrays = allocateArrays();
+      System.out.println("Allocated " + arrays.length + " arrays");
+      int sampled = drainSamples(INT_ARRAY_TAG, 4L * ARRAY_LENGTH, allocate_arrays);
+      System.out.println("Sampled " + sampled + " int[] allocations in allocateArrays");
+      System.out.println("Samples left after draining: " +
+          drainSamples(INT_ARRAY_TAG, 4L * ARRAY_LENGTH, allocate_arrays));
+    } finally {
+      setAllocationSamplingInterval(0);
+    }
+  }
+
+  public static int[][] allocateArrays() {
+    int[][] arrays = new int[NUM_ARRAYS][];
+    for (int i = 0; i < NUM_ARRAYS; i++) {
+      arrays[i] = new int[ARRAY_LENGTH];
+    }
+    return arrays;
+  }
+
+  public static native void setAllocationSamplingInterval(long interval);
+  // Drains the samples and returns how many of them are of objects of the class tagged with
+  // `class_tag`, of at least `min_size` bytes, allocated directly by `method`.
+  public static native int drainSamples(long class_tag, long min_size, Method method);
+}
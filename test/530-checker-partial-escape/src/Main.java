@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Point {
+  int x;
+  int y;
+}
+
+public class Main {
+
+  /// CHECK-START: int Main.$noinline$escapeOnColdPath(int, boolean) partial_escape_analysis (before)
+  /// CHECK:     NewInstance
+  /// CHECK-NOT: NewInstance
+
+  /// CHECK-START: int Main.$noinline$escapeOnColdPath(int, boolean) partial_escape_analysis (after)
+  /// CHECK:     NewInstance
+  /// CHECK:     NewInstance
+  /// CHECK:     StaticFieldSet
+
+  /// CHECK-START: int Main.$noinline$escapeOnColdPath(int, boolean) load_store_elimination (after)
+  /// CHECK:     NewInstance
+  /// CHECK-NOT: NewInstance
+
+  /// CHECK-START: int Main.$noinline$escapeOnColdPath(int, boolean) load_store_elimination (after)
+  /// CHECK-NOT: InstanceFieldGet
+
+  // The allocation only escapes when `cold` is true, so it is only kept on that path.
+  static int $noinline$escapeOnColdPath(int v, boolean cold) {
+    Point p = new Point();
+    p.x = v;
+    p.y = v + 1;
+    if (cold) {
+      sEscaped = p;
+      return 0;
+    }
+    return p.x + p.y;
+  }
+
+  /// CHECK-START: int Main.$noinline$useAfterEscape(int, boolean) partial_escape_analysis (after)
+  /// CHECK:     NewInstance
+  /// CHECK-NOT: NewInstance
+
+  // The object is read after it escaped, so it must be the same object on all paths.
+  static int $noinline$useAfterEscape(int v, boolean cold) {
+    Point p = new Point();
+    p.x = v;
+    if (cold) {
+      sEscaped = p;
+    }
+    return p.x;
+  }
+
+  public static void assertIntEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void main(String[] args) {
+    assertIntEquals(11, $noinline$escapeOnColdPath(5, false));
+    if (sEscaped != null) {
+      throw new Error("Unexpected escape");
+    }
+    assertIntEquals(0, $noinline$escapeOnColdPath(5, true));
+    assertIntEquals(5, sEscaped.x);
+    assertIntEquals(6, sEscaped.y);
+
+    assertIntEquals(7, $noinline$useAfterEscape(7, false));
+    assertIntEquals(8, $noinline$useAfterEscape(8, true));
+    assertIntEquals(8, sEscaped.x);
+  }
+
+  static Point sEscaped;
+}
@@ -66,6 +66,20 @@ public class Main {
     }
   }
 
+  // Needs both an a != b and an a != c runtime test.
+  //
+  /// CHECK-START-ARM64: void Main.twoSources(int[], int[], int[], int) loop_optimization (after)
+  /// CHECK-DAG: <<Phi:i\d+>>   Phi                                   loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Get1:d\d+>>  VecLoad                               loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Get2:d\d+>>  VecLoad                               loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Add:d\d+>>   VecAdd [<<Get1>>,<<Get2>>]            loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                VecStore [{{l\d+}},<<Phi>>,<<Add>>]  loop:<<Loop>>      outer_loop:none
+  private static void twoSources(int[] a, int[] b, int[] c, int n) {
+    for (int i = 0; i < n; i++) {
+      a[i] = b[i + 1] + c[i + 2];
+    }
+  }
+
   private static void stencilAddInt(int[] a, int[] b, int n) {
     try {
       Class<?> c = Class.forName("Smali");
@@ -235,6 +249,26 @@ public class Main {
     }
   }
 
+  static void testTwoSources() {
+    int[] a = new int[102];
+    int[] b = new int[102];
+    int[] c = new int[102];
+    for (int i = 0; i < 102; i++) {
+      a[i] = i;
+      b[i] = i;
+      c[i] = i;
+    }
+    twoSources(a, b, c, 100);
+    for (int i = 0; i < 100; i++) {
+      expectEquals(i + 1 + i + 2, a[i]);
+    }
+    // Aliased arrays take the sequential path.
+    twoSources(b, b, c, 100);
+    for (int i = 0; i < 100; i++) {
+      expectEquals(i + 1 + i + 2, b[i]);
+    }
+  }
+
   static void testTypes() {
     int[] a = new int[100];
     int[] b = new int[100];
@@ -255,6 +289,7 @@ public class Main {
     testStencil1();
     testStencil2();
     testStencil3();
+    testTwoSources();
     testTypes();
     System.out.println("passed");
   }
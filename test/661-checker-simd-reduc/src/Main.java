@@ -353,6 +353,65 @@ public class Main {
     return sum;
   }
 
+  /// CHECK-START: int Main.reductionMinInt(int[]) loop_optimization (before)
+  /// CHECK-DAG: <<Phi2:i\d+>>   Phi [{{i\d+}},{{i\d+}}]      loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Phi1:i\d+>>   Phi [{{i\d+}},{{i\d+}}]      loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Get:i\d+>>    ArrayGet [{{l\d+}},<<Phi1>>]  loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 Min [<<Phi2>>,<<Get>>]        loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 Return [<<Phi2>>]             loop:none
+  //
+  /// CHECK-START-{ARM,ARM64}: int Main.reductionMinInt(int[]) loop_optimization (after)
+  /// CHECK-DAG: <<Rep:d\d+>>    VecReplicateScalar [{{i\d+}}] loop:none
+  /// CHECK-DAG: <<Phi:d\d+>>    Phi [<<Rep>>,{{d\d+}}]        loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},{{i\d+}}] loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 VecMin [<<Phi>>,<<Load>>]     loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Red:d\d+>>    VecReduce [<<Phi>>]           loop:none
+  /// CHECK-DAG:                 VecExtractScalar [<<Red>>]    loop:none
+  private static int reductionMinInt(int[] x) {
+    int min = Integer.MAX_VALUE;
+    for (int i = 0; i < x.length; i++) {
+      min = Math.min(min, x[i]);
+    }
+    return min;
+  }
+
+  /// CHECK-START-{ARM,ARM64}: int Main.reductionMaxInt(int[]) loop_optimization (after)
+  /// CHECK-DAG: <<Rep:d\d+>>    VecReplicateScalar [{{i\d+}}] loop:none
+  /// CHECK-DAG: <<Phi:d\d+>>    Phi [<<Rep>>,{{d\d+}}]        loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},{{i\d+}}] loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 VecMax [<<Phi>>,<<Load>>]     loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Red:d\d+>>    VecReduce [<<Phi>>]           loop:none
+  /// CHECK-DAG:                 VecExtractScalar [<<Red>>]    loop:none
+  private static int reductionMaxInt(int[] x) {
+    int max = Integer.MIN_VALUE;
+    for (int i = 0; i < x.length; i++) {
+      max = Math.max(max, x[i]);
+    }
+    return max;
+  }
+
+  // Long min/max has no vector equivalent everywhere, and stays sequential.
+  private static long reductionMinLong(long[] x) {
+    long min = Long.MAX_VALUE;
+    for (int i = 0; i < x.length; i++) {
+      min = Math.min(min, x[i]);
+    }
+    return min;
+  }
+
+  // A fixed trip count permits unrolling, which splits the sum over several accumulators.
+  private static int reductionIntFixed() {
+    int[] x = new int[N];
+    for (int i = 0; i < N; i++) {
+      x[i] = i - 17;
+    }
+    int sum = 0;
+    for (int i = 0; i < N; i++) {
+      sum += x[i];
+    }
+    return sum;
+  }
+
   //
   // A few special cases.
   //
@@ -456,6 +515,17 @@ public class Main {
     expectEquals(-365750, reductionMinusInt(xi));
     expectEquals(-365750L, reductionMinusLong(xl));
 
+    // Test min/max reductions.
+    expectEquals(-17, reductionMinInt(xi));
+    expectEquals(3, reductionMinInt(xpi));
+    expectEquals(-103, reductionMinInt(xni));
+    expectEquals(1480, reductionMaxInt(xi));
+    expectEquals(102, reductionMaxInt(xpi));
+    expectEquals(-4, reductionMaxInt(xni));
+    expectEquals(-17L, reductionMinLong(xl));
+    expectEquals(-103L, reductionMinLong(xnl));
+    expectEquals(116250, reductionIntFixed());
+
     // Test special cases.
     expectEquals(13, reductionInt10(xi));
     expectEquals(-13, reductionMinusInt10(xi));
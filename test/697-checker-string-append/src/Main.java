@@ -23,6 +23,8 @@ public class Main {
         testNoArgs();
         testInline();
         testEquals();
+        testLongChains();
+        testStringAsObjectAndCharSequence();
         System.out.println("passed");
     }
 
@@ -291,6 +293,60 @@ public class Main {
       }
     }
 
+    /// CHECK-START: java.lang.String Main.$noinline$appendNineArgs(java.lang.String, int, long, char, boolean, java.lang.String, int, long, char) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$appendNineArgs(String s1,
+                                                  int i1,
+                                                  long l1,
+                                                  char c1,
+                                                  boolean b,
+                                                  String s2,
+                                                  int i2,
+                                                  long l2,
+                                                  char c2) {
+        return new StringBuilder().append(s1)
+                                  .append(i1)
+                                  .append(l1)
+                                  .append(c1)
+                                  .append(b)
+                                  .append(s2)
+                                  .append(i2)
+                                  .append(l2)
+                                  .append(c2).toString();
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendSixteenArgs(java.lang.String, int, long) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$appendSixteenArgs(String s, int i, long l) {
+        return new StringBuilder().append(s).append(i).append(l).append('/')
+                                  .append(s).append(i).append(l).append('/')
+                                  .append(s).append(i).append(l).append('/')
+                                  .append(s).append(i).append(l).append('/').toString();
+    }
+
+    public static void testLongChains() {
+        assertEquals("x1-2ytrueabc34z",
+                     $noinline$appendNineArgs("x", 1, -2L, 'y', true, "abc", 3, 4L, 'z'));
+        assertEquals("null1-2\u0131falsenull34\u0131",
+                     $noinline$appendNineArgs(
+                         null, 1, -2L, '\u0131', false, null, 3, 4L, '\u0131'));
+        assertEquals("s42-1/s42-1/s42-1/s42-1/", $noinline$appendSixteenArgs("s", 42, -1L));
+        assertEquals("null0123456789/null0123456789/null0123456789/null0123456789/",
+                     $noinline$appendSixteenArgs(null, 0, 123456789L));
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendStringAsObjectAndCharSequence(java.lang.String, java.lang.String) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$appendStringAsObjectAndCharSequence(String s1, String s2) {
+        return new StringBuilder().append((Object) s1).append((CharSequence) s2).toString();
+    }
+
+    public static void testStringAsObjectAndCharSequence() {
+        assertEquals("abcDEF", $noinline$appendStringAsObjectAndCharSequence("abc", "DEF"));
+        assertEquals("nullnull", $noinline$appendStringAsObjectAndCharSequence(null, null));
+        assertEquals("\u0131x", $noinline$appendStringAsObjectAndCharSequence("\u0131", "x"));
+    }
+
     public static void assertEquals(String expected, String actual) {
         if (!expected.equals(actual)) {
             throw new AssertionError("Expected: " + expected + ", actual: " + actual);
@@ -224,7 +224,10 @@ extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasJitCompiledCode(JNIEnv* env,
   return jit->GetCodeCache()->ContainsMethod(method);
 }
 
-static void ForceJitCompiled(Thread* self, ArtMethod* method) REQUIRES(!Locks::mutator_lock_) {
+static void ForceJitCompiled(Thread* self,
+                             ArtMethod* method,
+                             CompilationKind kind = CompilationKind::kOptimized)
+    REQUIRES(!Locks::mutator_lock_) {
   bool native = false;
   {
     ScopedObjectAccess soa(self);
@@ -277,9 +280,9 @@ static void ForceJitCompiled(Thread* self, ArtMethod* method) REQUIRES(!Locks::m
       }
       // Will either ensure it's compiled or do the compilation itself. We do
       // this before checking if we will execute JIT code to make sure the
-      // method is compiled 'optimized' and not baseline (tests expect optimized
-      // compilation).
-      jit->CompileMethod(method, self, CompilationKind::kOptimized, /*prejit=*/ false);
+      // method is compiled with the requested kind, which is 'optimized' and
+      // not baseline unless asked otherwise (tests expect optimized compilation).
+      jit->CompileMethod(method, self, kind, /*prejit=*/ false);
       if (code_cache->WillExecuteJitCode(method)) {
         break;
       }
@@ -322,6 +325,27 @@ extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitCompiled(JNIEnv* env,
   ForceJitCompiled(self, method);
 }
 
+// Compile the method with baseline code, which fills its ProfilingInfo when executed.
+extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitBaselineCompiled(JNIEnv* env,
+                                                                     jclass,
+                                                                     jclass cls,
+                                                                     jstring method_name) {
+  jit::Jit* jit = GetJitIfEnabled();
+  if (jit == nullptr) {
+    return;
+  }
+
+  Thread* self = Thread::Current();
+  ArtMethod* method = nullptr;
+  {
+    ScopedObjectAccess soa(self);
+
+    ScopedUtfChars chars(env, method_name);
+    method = GetMethod(soa, cls, chars);
+  }
+  ForceJitCompiled(self, method, CompilationKind::kBaseline);
+}
+
 extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasSingleImplementation(JNIEnv* env,
                                                                         jclass,
                                                                         jclass cls,